@@ -70,8 +70,12 @@ namespace AppInstaller::CLI
             return Argument{ "arg", 'a', Args::Type::SourceArg, Resource::String::SourceArgArgumentDescription, ArgumentType::Positional, true };
         case Args::Type::SourceType:
             return Argument{ "type", 't', Args::Type::SourceType, Resource::String::SourceTypeArgumentDescription, ArgumentType::Positional };
+        case Args::Type::SourceBackgroundUpdate:
+            return Argument{ "background-update", NoAlias, Args::Type::SourceBackgroundUpdate, Resource::String::SourceBackgroundUpdateArgumentDescription, ArgumentType::Flag, Argument::Visibility::Hidden };
         case Args::Type::ValidateManifest:
             return Argument{ "manifest", NoAlias, Args::Type::ValidateManifest, Resource::String::ValidateManifestArgumentDescription, ArgumentType::Positional, true };
+        case Args::Type::ValidateRecurse:
+            return Argument{ "recurse", NoAlias, Args::Type::ValidateRecurse, Resource::String::ValidateRecurseArgumentDescription, ArgumentType::Flag };
         case Args::Type::NoVT:
             return Argument{ "no-vt", NoAlias, Args::Type::NoVT, Resource::String::NoVTArgumentDescription, ArgumentType::Flag, Argument::Visibility::Hidden };
         case Args::Type::RainbowStyle:
@@ -80,10 +84,18 @@ namespace AppInstaller::CLI
             return Argument{ "retro", NoAlias, Args::Type::RetroStyle, Resource::String::RetroArgumentDescription, ArgumentType::Flag, Argument::Visibility::Hidden };
         case Args::Type::VerboseLogs:
             return Argument{ "verbose-logs", NoAlias, Args::Type::VerboseLogs, Resource::String::VerboseLogsArgumentDescription, ArgumentType::Flag };
+        case Args::Type::Timings:
+            return Argument{ "timings", NoAlias, Args::Type::Timings, Resource::String::TimingsArgumentDescription, ArgumentType::Flag, Argument::Visibility::Help };
+        case Args::Type::StartupTrace:
+            return Argument{ "startup-trace", NoAlias, Args::Type::StartupTrace, Resource::String::StartupTraceArgumentDescription, ArgumentType::Standard, Argument::Visibility::Hidden };
+        case Args::Type::ResourceReport:
+            return Argument{ "resource-report", NoAlias, Args::Type::ResourceReport, Resource::String::ResourceReportArgumentDescription, ArgumentType::Flag, Argument::Visibility::Hidden };
         case Args::Type::CustomHeader:
             return Argument{ "header", NoAlias, Args::Type::CustomHeader, Resource::String::HeaderArgumentDescription, ArgumentType::Standard, Argument::Visibility::Help };
         case Args::Type::AcceptSourceAgreements:
             return Argument{ "accept-source-agreements", NoAlias, Args::Type::AcceptSourceAgreements, Resource::String::AcceptSourceAgreementsArgumentDescription, ArgumentType::Flag };
+        case Args::Type::OutputFormat:
+            return Argument{ "output", NoAlias, Args::Type::OutputFormat, Resource::String::OutputFormatArgumentDescription, ArgumentType::Standard };
         case Args::Type::ExperimentalArg:
             return Argument{ "arg", NoAlias, Args::Type::ExperimentalArg, Resource::String::ExperimentalArgumentDescription, ArgumentType::Flag, ExperimentalFeature::Feature::ExperimentalArg };
         default:
@@ -98,6 +110,9 @@ namespace AppInstaller::CLI
         args.push_back(ForType(Args::Type::RainbowStyle));
         args.push_back(ForType(Args::Type::RetroStyle));
         args.push_back(ForType(Args::Type::VerboseLogs));
+        args.push_back(ForType(Args::Type::Timings));
+        args.push_back(ForType(Args::Type::StartupTrace));
+        args.push_back(ForType(Args::Type::ResourceReport));
     }
 
     Argument::Visibility Argument::GetVisibility() const
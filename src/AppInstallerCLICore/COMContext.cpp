@@ -7,6 +7,9 @@ namespace AppInstaller::CLI::Execution
 {
     static constexpr std::string_view s_comLogFileNamePrefix = "WPM"sv;
 
+    // Old log files are only removed this often, rather than for every context, as the server is long lived.
+    static constexpr std::chrono::hours s_comLogFileCleanupInterval{ 24 };
+
     NullStream::NullStream()
     {
         m_nullOut.reset(new std::ostream(&m_nullStreamBuf));
@@ -36,6 +39,11 @@ namespace AppInstaller::CLI::Execution
 
     void COMContext::OnProgress(uint64_t current, uint64_t maximum, ProgressType progressType)
     {
+        if (m_progressGate)
+        {
+            m_progressGate(current, maximum, progressType);
+        }
+
         FireCallbacks(ReportType::Progressing, current, maximum, progressType, m_executionStage);
     }
 
@@ -44,6 +52,19 @@ namespace AppInstaller::CLI::Execution
         FireCallbacks(ReportType::EndProgress, 0, 0, ProgressType::None, m_executionStage);
     };
 
+    bool COMContext::IsPauseRequested()
+    {
+        return m_isPauseRequested && m_isPauseRequested();
+    }
+
+    void COMContext::WaitWhilePaused()
+    {
+        if (m_waitWhilePaused)
+        {
+            m_waitWhilePaused();
+        }
+    }
+
     void COMContext::SetExecutionStage(CLI::Workflow::ExecutionStage executionStage)
     {
         m_executionStage = executionStage;
@@ -75,10 +96,20 @@ namespace AppInstaller::CLI::Execution
 
         // TODO: Log to file for COM API calls only when debugging in visual studio
         Logging::AddFileLogger(s_comLogFileNamePrefix);
-        Logging::BeginLogFileCleanup();
 
         Logging::AddTraceLogger();
 
-        Logging::EnableWilFailureTelemetry();
+        // The rest is for the whole process, so it does not need repeating for each context.
+        static std::once_flag s_enableWilFailureTelemetry;
+        std::call_once(s_enableWilFailureTelemetry, []() { Logging::EnableWilFailureTelemetry(); });
+
+        static std::atomic<std::chrono::steady_clock::rep> s_lastLogFileCleanup{ 0 };
+        auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        auto lastCleanup = s_lastLogFileCleanup.load();
+        if ((lastCleanup == 0 || std::chrono::steady_clock::duration{ now - lastCleanup } >= s_comLogFileCleanupInterval) &&
+            s_lastLogFileCleanup.compare_exchange_strong(lastCleanup, now))
+        {
+            Logging::BeginLogFileCleanup();
+        }
     }
 }
@@ -54,6 +54,8 @@ namespace AppInstaller::CLI::Execution
         void BeginProgress() override;
         void OnProgress(uint64_t current, uint64_t maximum, ProgressType type) override;
         void EndProgress(bool) override;
+        bool IsPauseRequested() override;
+        void WaitWhilePaused() override;
 
         //Execution::Context
         void SetExecutionStage(CLI::Workflow::ExecutionStage executionPhase);
@@ -62,6 +64,17 @@ namespace AppInstaller::CLI::Execution
 
         void AddProgressCallbackFunction(ProgressCallBackFunction&& f);
 
+        // Sets a function that is called each time progress is made, before the progress is reported.
+        // The work that is making progress does not continue until the function returns.
+        void SetProgressGate(std::function<void(uint64_t current, uint64_t maximum, ProgressType type)>&& f) { m_progressGate = std::move(f); }
+
+        // Sets the functions that work which can stop at a safe point uses to decide whether to pause there, and to wait while paused.
+        void SetPauseGate(std::function<bool()>&& isPauseRequested, std::function<void()>&& waitWhilePaused)
+        {
+            m_isPauseRequested = std::move(isPauseRequested);
+            m_waitWhilePaused = std::move(waitWhilePaused);
+        }
+
         // Set Diagnostic and Telemetry loggers, Wil failure callback
         // This should be called only once per COM Server instance
         static void SetLoggers();
@@ -77,6 +90,9 @@ namespace AppInstaller::CLI::Execution
 
         CLI::Workflow::ExecutionStage m_executionStage = CLI::Workflow::ExecutionStage::Initial;
         std::vector<ProgressCallBackFunction> m_comProgressCallbacks;
+        std::function<void(uint64_t current, uint64_t maximum, ProgressType type)> m_progressGate;
+        std::function<bool()> m_isPauseRequested;
+        std::function<void()> m_waitWhilePaused;
         std::wstring m_correlationData = L"";
         std::mutex m_callbackLock;
     };
@@ -3,14 +3,84 @@
 #include "pch.h"
 #include "ChannelStreams.h"
 
+#include <cstring>
+
 
 namespace AppInstaller::CLI::Execution
 {
     using namespace Settings;
     using namespace VirtualTerminal;
 
+    namespace
+    {
+        // The amount of output collected before it is written even without a line end.
+        constexpr size_t s_MaximumBufferedOutput = 4096;
+    }
+
+    namespace details
+    {
+        LineBufferedStreamBuf::LineBufferedStreamBuf(std::streambuf* target) :
+            m_target(target)
+        {
+            m_buffer.reserve(s_MaximumBufferedOutput);
+        }
+
+        LineBufferedStreamBuf::~LineBufferedStreamBuf()
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+            WriteBuffer();
+        }
+
+        LineBufferedStreamBuf::int_type LineBufferedStreamBuf::overflow(int_type c)
+        {
+            if (traits_type::eq_int_type(c, traits_type::eof()))
+            {
+                return traits_type::not_eof(c);
+            }
+
+            char ch = traits_type::to_char_type(c);
+            return (xsputn(&ch, 1) == 1 ? c : traits_type::eof());
+        }
+
+        std::streamsize LineBufferedStreamBuf::xsputn(const char* s, std::streamsize count)
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+
+            m_buffer.append(s, static_cast<size_t>(count));
+
+            if (m_buffer.size() >= s_MaximumBufferedOutput || std::memchr(s, '\n', static_cast<size_t>(count)))
+            {
+                if (!WriteBuffer())
+                {
+                    return 0;
+                }
+            }
+
+            return count;
+        }
+
+        int LineBufferedStreamBuf::sync()
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+            return (WriteBuffer() && m_target->pubsync() == 0) ? 0 : -1;
+        }
+
+        bool LineBufferedStreamBuf::WriteBuffer()
+        {
+            if (m_buffer.empty())
+            {
+                return true;
+            }
+
+            std::streamsize size = static_cast<std::streamsize>(m_buffer.size());
+            bool result = (m_target->sputn(m_buffer.data(), size) == size);
+            m_buffer.clear();
+            return result;
+        }
+    }
+
     BaseStream::BaseStream(std::ostream& out, bool enabled, bool VTEnabled) :
-        m_out(out), m_enabled(enabled), m_VTEnabled(VTEnabled) {}
+        m_buffer(out.rdbuf()), m_out(&m_buffer), m_enabled(enabled), m_VTEnabled(VTEnabled) {}
 
     BaseStream& BaseStream::operator<<(std::ostream& (__cdecl* f)(std::ostream&))
     {
@@ -52,13 +122,22 @@ namespace AppInstaller::CLI::Execution
         {
             Write(TextFormat::Default, true);
         }
+
+        Flush();
     }
 
     void BaseStream::Disable()
     {
+        // What was written before is still output
+        Flush();
         m_enabled = false;
     }
 
+    void BaseStream::Flush()
+    {
+        m_out.flush();
+    }
+
     OutputStream::OutputStream(BaseStream& out, bool enabled, bool VTEnabled) :
         m_out(out),
         m_enabled(enabled),
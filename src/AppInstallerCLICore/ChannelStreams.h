@@ -5,7 +5,9 @@
 #include "VTSupport.h"
 #include <winget/LocIndependent.h>
 
+#include <mutex>
 #include <ostream>
+#include <streambuf>
 #include <string>
 
 
@@ -39,6 +41,32 @@ namespace AppInstaller::CLI::Execution
         // Normalized strings come from user data and should therefore already by localized
         // by how they are chosen (or there is no localized version).
         WINGET_CREATE_ISAPPROVEDFOROUTPUT_SPECIALIZATION(Utility::NormalizedString);
+
+        // Collects the fragments written to it, including VT sequences, and writes them to the target in one go
+        // at the end of each line, on flush, or when enough has been collected.
+        // Writes are serialized, as progress is drawn from another thread.
+        struct LineBufferedStreamBuf : public std::streambuf
+        {
+            LineBufferedStreamBuf(std::streambuf* target);
+
+            LineBufferedStreamBuf(const LineBufferedStreamBuf&) = delete;
+            LineBufferedStreamBuf& operator=(const LineBufferedStreamBuf&) = delete;
+
+            ~LineBufferedStreamBuf();
+
+        protected:
+            int_type overflow(int_type c) override;
+            std::streamsize xsputn(const char* s, std::streamsize count) override;
+            int sync() override;
+
+        private:
+            // Writes the collected output to the target; the lock must be held.
+            bool WriteBuffer();
+
+            std::streambuf* m_target;
+            std::mutex m_lock;
+            std::string m_buffer;
+        };
     }
 
     // The base stream for all channels.
@@ -63,6 +91,9 @@ namespace AppInstaller::CLI::Execution
 
         void Disable();
 
+        // Writes everything that has been collected to the underlying stream.
+        void Flush();
+
     private:
         template <typename T>
         void Write(const T& t, bool bypass)
@@ -73,7 +104,8 @@ namespace AppInstaller::CLI::Execution
             }
         };
 
-        std::ostream& m_out;
+        details::LineBufferedStreamBuf m_buffer;
+        std::ostream m_out;
         std::atomic_bool m_enabled;
         std::atomic_bool m_VTUpdated;
         bool m_VTEnabled;
@@ -3,7 +3,9 @@
 #include "pch.h"
 #include "Command.h"
 #include "Resources.h"
+#include "StructuredOutput.h"
 #include <winget/UserSettings.h>
+#include <winget/Timing.h>
 
 using namespace std::string_view_literals;
 using namespace AppInstaller::Utility::literals;
@@ -329,13 +331,13 @@ namespace AppInstaller::CLI
     // and determine the likely state of the word to be completed.
     struct ParseArgumentsStateMachine
     {
-        ParseArgumentsStateMachine(Invocation& inv, Execution::Args& execArgs, std::vector<CLI::Argument> arguments);
+        ParseArgumentsStateMachine(Invocation& inv, Execution::Args& execArgs, const std::vector<CLI::Argument>& arguments);
 
         ParseArgumentsStateMachine(const ParseArgumentsStateMachine&) = delete;
         ParseArgumentsStateMachine& operator=(const ParseArgumentsStateMachine&) = delete;
 
         ParseArgumentsStateMachine(ParseArgumentsStateMachine&&) = default;
-        ParseArgumentsStateMachine& operator=(ParseArgumentsStateMachine&&) = default;
+        ParseArgumentsStateMachine& operator=(ParseArgumentsStateMachine&&) = delete;
 
         // Processes the next argument from the invocation.
         // Returns true if there was an argument to process;
@@ -384,19 +386,19 @@ namespace AppInstaller::CLI
 
         Invocation& m_invocation;
         Execution::Args& m_executionArgs;
-        std::vector<CLI::Argument> m_arguments;
+        const std::vector<CLI::Argument>& m_arguments;
 
         Invocation::iterator m_invocationItr;
-        std::vector<CLI::Argument>::iterator m_positionalSearchItr;
+        std::vector<CLI::Argument>::const_iterator m_positionalSearchItr;
         bool m_onlyPositionalArgumentsRemain = false;
 
         State m_state;
     };
 
-    ParseArgumentsStateMachine::ParseArgumentsStateMachine(Invocation& inv, Execution::Args& execArgs, std::vector<CLI::Argument> arguments) :
+    ParseArgumentsStateMachine::ParseArgumentsStateMachine(Invocation& inv, Execution::Args& execArgs, const std::vector<CLI::Argument>& arguments) :
         m_invocation(inv),
         m_executionArgs(execArgs),
-        m_arguments(std::move(arguments)),
+        m_arguments(arguments),
         m_invocationItr(m_invocation.begin()),
         m_positionalSearchItr(m_arguments.begin())
     {
@@ -611,10 +613,7 @@ namespace AppInstaller::CLI
 
     void Command::ParseArguments(Invocation& inv, Execution::Args& execArgs) const
     {
-        auto definedArgs = GetArguments();
-        Argument::GetCommon(definedArgs);
-
-        ParseArgumentsStateMachine stateMachine{ inv, execArgs, std::move(definedArgs) };
+        ParseArgumentsStateMachine stateMachine{ inv, execArgs, GetDefinedArguments() };
 
         while (stateMachine.Step())
         {
@@ -630,8 +629,11 @@ namespace AppInstaller::CLI
             return;
         }
 
-        for (const auto& arg : GetArguments())
+        const auto& definedArgs = GetDefinedArguments();
+        for (size_t i = 0; i < m_commandArgumentCount; ++i)
         {
+            const Argument& arg = definedArgs[i];
+
             if (!Settings::GroupPolicies().IsEnabled(arg.GroupPolicy()) && execArgs.Contains(arg.ExecArgType()))
             {
                 auto policy = TogglePolicy::GetPolicy(arg.GroupPolicy());
@@ -691,6 +693,11 @@ namespace AppInstaller::CLI
             }
         }
 
+        if (execArgs.Contains(Execution::Args::Type::OutputFormat) && Execution::GetOutputFormat(execArgs) == Execution::OutputFormat::Unknown)
+        {
+            throw CommandException(Resource::String::InvalidArgumentValueError, Argument::ForType(Execution::Args::Type::OutputFormat).Name(), { "table"_lis, "json"_lis, "csv"_lis });
+        }
+
         ValidateArgumentsInternal(execArgs);
     }
 
@@ -716,10 +723,7 @@ namespace AppInstaller::CLI
         }
 
         // Consume what remains, if any, of the preceding values to determine what type the word is.
-        auto definedArgs = GetArguments();
-        Argument::GetCommon(definedArgs);
-
-        ParseArgumentsStateMachine stateMachine{ data.BeforeWord(), context.Args, std::move(definedArgs) };
+        ParseArgumentsStateMachine stateMachine{ data.BeforeWord(), context.Args, GetDefinedArguments() };
 
         // We don't care if there are errors along the way, just do the best that can be done and try to
         // complete whatever would be next if the bad strings were simply ignored. To do that we just spin
@@ -866,6 +870,31 @@ namespace AppInstaller::CLI
         return arguments;
     }
 
+    const std::vector<Argument>& Command::GetDefinedArguments() const
+    {
+        if (!m_definedArguments)
+        {
+            std::vector<Argument> arguments = GetArguments();
+            m_commandArgumentCount = arguments.size();
+            Argument::GetCommon(arguments);
+            m_definedArguments = std::move(arguments);
+        }
+
+        return m_definedArguments.value();
+    }
+
+    void OutputTimings(Execution::Reporter& reporter)
+    {
+        reporter.Info() << Resource::String::TimingsHeader << std::endl;
+
+        for (const auto& total : Timing::GetTotals())
+        {
+            auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(total.Duration);
+            reporter.Info() << "  "_liv << Utility::LocIndString{ Timing::ToString(total.Phase) } << ": "_liv <<
+                milliseconds.count() << " ms ("_liv << total.Count << ')' << std::endl;
+        }
+    }
+
     int Execute(Execution::Context& context, std::unique_ptr<Command>& command)
     {
         try
@@ -882,6 +911,11 @@ namespace AppInstaller::CLI
             context.SetTerminationHR(Workflow::HandleException(context, std::current_exception()));
         }
 
+        if (context.Args.Contains(Execution::Args::Type::Timings))
+        {
+            OutputTimings(context.Reporter);
+        }
+
         if (SUCCEEDED(context.GetTerminationHR()))
         {
             Logging::Telemetry().LogCommandSuccess(command->FullName());
@@ -88,6 +88,10 @@ namespace AppInstaller::CLI
         std::vector<std::unique_ptr<Command>> GetVisibleCommands() const;
         std::vector<Argument> GetVisibleArguments() const;
 
+        // Gets the arguments of this command followed by the common arguments.
+        // The list is built on first use and reused by parsing, validation and completion.
+        const std::vector<Argument>& GetDefinedArguments() const;
+
         virtual Resource::LocString ShortDescription() const { return {}; }
         virtual Resource::LocString LongDescription() const { return {}; }
 
@@ -114,6 +118,8 @@ namespace AppInstaller::CLI
         Command::Visibility m_visibility;
         Settings::ExperimentalFeature::Feature m_feature;
         Settings::TogglePolicy::Policy m_groupPolicy;
+        mutable std::optional<std::vector<Argument>> m_definedArguments;
+        mutable size_t m_commandArgumentCount = 0;
     };
 
     template <typename Container>
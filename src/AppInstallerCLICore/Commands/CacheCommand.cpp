@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "CacheCommand.h"
+#include "Workflows/SourceFlow.h"
+#include "Workflows/UpdateFlow.h"
+#include "Workflows/WorkflowBase.h"
+#include "Resources.h"
+
+namespace AppInstaller::CLI
+{
+    using namespace AppInstaller::CLI::Execution;
+    using namespace std::string_view_literals;
+
+    static constexpr std::string_view s_CacheCommand_HelpLink = "https://aka.ms/winget-settings"sv;
+
+    std::vector<std::unique_ptr<Command>> CacheCommand::GetCommands() const
+    {
+        return InitializeFromMoveOnly<std::vector<std::unique_ptr<Command>>>({
+            std::make_unique<CacheWarmCommand>(FullName()),
+            });
+    }
+
+    Resource::LocString CacheCommand::ShortDescription() const
+    {
+        return { Resource::String::CacheCommandShortDescription };
+    }
+
+    Resource::LocString CacheCommand::LongDescription() const
+    {
+        return { Resource::String::CacheCommandLongDescription };
+    }
+
+    std::string CacheCommand::HelpLink() const
+    {
+        return std::string{ s_CacheCommand_HelpLink };
+    }
+
+    void CacheCommand::ExecuteInternal(Context& context) const
+    {
+        OutputHelp(context.Reporter);
+    }
+
+    std::vector<Argument> CacheWarmCommand::GetArguments() const
+    {
+        return {
+            Argument::ForType(Args::Type::AcceptSourceAgreements),
+        };
+    }
+
+    Resource::LocString CacheWarmCommand::ShortDescription() const
+    {
+        return { Resource::String::CacheWarmCommandShortDescription };
+    }
+
+    Resource::LocString CacheWarmCommand::LongDescription() const
+    {
+        return { Resource::String::CacheWarmCommandLongDescription };
+    }
+
+    std::string CacheWarmCommand::HelpLink() const
+    {
+        return std::string{ s_CacheCommand_HelpLink };
+    }
+
+    void CacheWarmCommand::ExecuteInternal(Context& context) const
+    {
+        // No one is waiting on this, so it gives way to everything else on the system, including its disk and memory use.
+        LOG_IF_WIN32_BOOL_FALSE(SetPriorityClass(GetCurrentProcess(), PROCESS_MODE_BACKGROUND_BEGIN));
+        auto endBackgroundMode = wil::scope_exit([]()
+            {
+                LOG_IF_WIN32_BOOL_FALSE(SetPriorityClass(GetCurrentProcess(), PROCESS_MODE_BACKGROUND_END));
+            });
+
+        context <<
+            Workflow::GetSourceList <<
+            Workflow::UpdateSources;
+
+        // The sources were just updated, and one that failed to update should not hold up the rest.
+        context.SetFlags(ContextFlag::DisableBackgroundSourceUpdate | ContextFlag::TreatSourceFailuresAsWarning);
+
+        // Opening the installed source refreshes its snapshot, and searching it correlates the packages with the sources.
+        context <<
+            Workflow::OpenSource() <<
+            Workflow::OpenCompositeSource(Repository::PredefinedSource::Installed) <<
+            Workflow::SearchSourceForMany <<
+            Workflow::HandleSearchResultFailures <<
+            Workflow::PrefetchUpgradeManifests;
+    }
+}
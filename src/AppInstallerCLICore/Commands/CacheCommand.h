@@ -0,0 +1,38 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "Command.h"
+#include <winget/UserSettings.h>
+
+namespace AppInstaller::CLI
+{
+    struct CacheCommand final : public Command
+    {
+        CacheCommand(std::string_view parent) : Command("cache", parent, Settings::ExperimentalFeature::Feature::CacheCommand) {}
+
+        std::vector<std::unique_ptr<Command>> GetCommands() const override;
+
+        Resource::LocString ShortDescription() const override;
+        Resource::LocString LongDescription() const override;
+
+        std::string HelpLink() const override;
+
+    protected:
+        void ExecuteInternal(Execution::Context& context) const override;
+    };
+
+    struct CacheWarmCommand final : public Command
+    {
+        CacheWarmCommand(std::string_view parent) : Command("warm", parent) {}
+
+        std::vector<Argument> GetArguments() const override;
+
+        Resource::LocString ShortDescription() const override;
+        Resource::LocString LongDescription() const override;
+
+        std::string HelpLink() const override;
+
+    protected:
+        void ExecuteInternal(Execution::Context& context) const override;
+    };
+}
@@ -60,6 +60,9 @@ namespace AppInstaller::CLI
             subContext.Reporter.SetChannel(Execution::Reporter::Channel::Completion);
             subContext.Add<Data::CompletionData>(std::move(data));
 
+            // Completion runs on each keypress, so it must not wait for sources to update.
+            subContext.SetFlags(ContextFlag::DisableBackgroundSourceUpdate);
+
             // Disable all telemetry while doing a completion
             Logging::DisableTelemetryScope disable;
 
@@ -6,16 +6,189 @@
 #include "Resources.h"
 
 #include <AppInstallerMsixInfo.h>
+#include <winget/ThreadGlobals.h>
+#include <winget/Yaml.h>
+
+#include <thread>
 
 namespace AppInstaller::CLI
 {
     using namespace std::string_view_literals;
     using namespace Utility::literals;
+    using namespace AppInstaller::ThreadLocalStorage;
+
+    namespace
+    {
+        // The number of files that may be given to the command at once.
+        constexpr size_t s_MaximumHashFileCount = 1000;
+
+        struct FileHashResult
+        {
+            std::filesystem::path Path;
+            HRESULT Result = S_OK;
+            Utility::SHA256::HashBuffer Sha256;
+            std::optional<Utility::SHA256::HashBuffer> SignatureSha256;
+        };
+
+        // Expands the file arguments, replacing each directory with the regular files directly within it.
+        std::vector<FileHashResult> GetFilesToHash(Execution::Context& context)
+        {
+            std::vector<FileHashResult> files;
+
+            for (const auto& arg : *context.Args.GetArgs(Execution::Args::Type::HashFile))
+            {
+                std::filesystem::path path = Utility::ConvertToUTF16(arg);
+
+                if (!std::filesystem::exists(path))
+                {
+                    context.Reporter.Error() << Resource::String::VerifyFileFailedNotExist << ' ' << path.u8string() << std::endl;
+                    AICLI_TERMINATE_CONTEXT_RETURN(HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND), {});
+                }
+
+                if (std::filesystem::is_directory(path))
+                {
+                    std::vector<std::filesystem::path> directoryFiles;
+                    for (const auto& entry : std::filesystem::directory_iterator{ path })
+                    {
+                        if (entry.is_regular_file())
+                        {
+                            directoryFiles.emplace_back(entry.path());
+                        }
+                    }
+
+                    std::sort(directoryFiles.begin(), directoryFiles.end());
+                    for (auto& file : directoryFiles)
+                    {
+                        files.emplace_back().Path = std::move(file);
+                    }
+                }
+                else
+                {
+                    files.emplace_back().Path = std::move(path);
+                }
+            }
+
+            return files;
+        }
+
+        void HashFile(FileHashResult& file, bool includeSignature)
+        {
+            try
+            {
+                file.Sha256 = Utility::SHA256::ComputeHashFromFile(file.Path);
+
+                if (includeSignature)
+                {
+                    auto signature = Msix::GetPackageSignature(file.Path.u8string());
+                    file.SignatureSha256 = Utility::SHA256::ComputeHash(signature.data(), static_cast<uint32_t>(signature.size()));
+                }
+            }
+            catch (...)
+            {
+                file.Result = wil::ResultFromCaughtException();
+            }
+        }
+
+        // Hashes the files on a pool of threads; the files are large and mostly independent reads,
+        // so this is bound by the disk rather than a single core.
+        void HashFiles(std::vector<FileHashResult>& files, bool includeSignature)
+        {
+            size_t threadCount = std::min<size_t>(files.size(), std::max(1u, std::thread::hardware_concurrency()));
+            std::atomic<size_t> nextFile = 0;
+
+            ThreadGlobals* parentThreadGlobals = ThreadGlobals::GetForCurrentThread();
+
+            auto worker = [&](std::shared_ptr<ThreadGlobals> threadGlobals)
+            {
+                std::unique_ptr<PreviousThreadGlobals> previousThreadGlobals;
+                if (threadGlobals)
+                {
+                    previousThreadGlobals = threadGlobals->SetForCurrentThread();
+                }
+
+                for (size_t i = nextFile++; i < files.size(); i = nextFile++)
+                {
+                    HashFile(files[i], includeSignature);
+                }
+            };
+
+            std::vector<std::thread> threads;
+            threads.reserve(threadCount);
+
+            for (size_t i = 0; i < threadCount; ++i)
+            {
+                std::shared_ptr<ThreadGlobals> threadGlobals;
+                if (parentThreadGlobals)
+                {
+                    threadGlobals = std::make_shared<ThreadGlobals>(*parentThreadGlobals, ThreadGlobals::create_sub_thread_globals_t{});
+                }
+
+                threads.emplace_back(worker, std::move(threadGlobals));
+            }
+
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+        }
+
+        // Hashes every file given and writes the results as YAML that can be pasted into the installers of a manifest.
+        void HashMultipleFiles(Execution::Context& context)
+        {
+            std::vector<FileHashResult> files = GetFilesToHash(context);
+            if (context.IsTerminated())
+            {
+                return;
+            }
+
+            bool includeSignature = context.Args.Contains(Execution::Args::Type::Msix);
+            HashFiles(files, includeSignature);
+
+            YAML::Emitter out;
+            out << YAML::BeginSeq;
+
+            HRESULT firstFailure = S_OK;
+
+            for (const auto& file : files)
+            {
+                if (FAILED(file.Result))
+                {
+                    context.Reporter.Error() << Resource::String::HashFileFailed << ' ' << file.Path.u8string() << std::endl;
+                    AICLI_LOG(CLI, Error, << "Failed to hash file " << file.Path.u8string() << " with error: " << WINGET_OSTREAM_FORMAT_HRESULT(file.Result));
+
+                    if (SUCCEEDED(firstFailure))
+                    {
+                        firstFailure = file.Result;
+                    }
+
+                    continue;
+                }
+
+                out << YAML::BeginMap;
+                out << YAML::Key << "File"sv << YAML::Value << file.Path.filename().u8string();
+                out << YAML::Key << "InstallerSha256"sv << YAML::Value << Utility::SHA256::ConvertToString(file.Sha256);
+                if (file.SignatureSha256)
+                {
+                    out << YAML::Key << "SignatureSha256"sv << YAML::Value << Utility::SHA256::ConvertToString(file.SignatureSha256.value());
+                }
+                out << YAML::EndMap;
+            }
+
+            out << YAML::EndSeq;
+
+            context.Reporter.Info() << Utility::LocIndString{ out.str() } << std::endl;
+
+            if (FAILED(firstFailure))
+            {
+                AICLI_TERMINATE_CONTEXT(firstFailure);
+            }
+        }
+    }
 
     std::vector<Argument> HashCommand::GetArguments() const
     {
         return {
-            Argument::ForType(Execution::Args::Type::HashFile),
+            Argument::ForType(Execution::Args::Type::HashFile).SetCountLimit(s_MaximumHashFileCount),
             Argument::ForType(Execution::Args::Type::Msix),
         };
     }
@@ -37,21 +210,28 @@ namespace AppInstaller::CLI
 
     void HashCommand::ExecuteInternal(Execution::Context& context) const
     {
+        // A single file keeps the original output so that existing scripts are not broken.
+        const auto& inputFiles = *context.Args.GetArgs(Execution::Args::Type::HashFile);
+        if (inputFiles.size() > 1 || std::filesystem::is_directory(Utility::ConvertToUTF16(inputFiles[0])))
+        {
+            context << HashMultipleFiles;
+            return;
+        }
+
         context <<
             Workflow::VerifyFile(Execution::Args::Type::HashFile) <<
             [](Execution::Context& context)
         {
             auto inputFile = context.Args.GetArg(Execution::Args::Type::HashFile);
-            std::ifstream inStream{ Utility::ConvertToUTF16(inputFile), std::ifstream::binary };
+            auto fileHash = Utility::SHA256::ComputeHashFromFile(Utility::ConvertToUTF16(inputFile));
 
-            context.Reporter.Info() << "Sha256: "_liv << Utility::LocIndString{ Utility::SHA256::ConvertToString(Utility::SHA256::ComputeHash(inStream)) } << std::endl;
+            context.Reporter.Info() << "Sha256: "_liv << Utility::LocIndString{ Utility::SHA256::ConvertToString(fileHash) } << std::endl;
 
             if (context.Args.Contains(Execution::Args::Type::Msix))
             {
                 try
                 {
-                    Msix::MsixInfo msixInfo{ inputFile };
-                    auto signature = msixInfo.GetSignature();
+                    auto signature = Msix::GetPackageSignature(inputFile);
                     auto signatureHash = Utility::SHA256::ComputeHash(signature.data(), static_cast<uint32_t>(signature.size()));
 
                     context.Reporter.Info() << "SignatureSha256: "_liv << Utility::LocIndString{ Utility::SHA256::ConvertToString(signatureHash) } << std::endl;
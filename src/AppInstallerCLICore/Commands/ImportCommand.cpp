@@ -17,6 +17,7 @@ namespace AppInstaller::CLI
             Argument{ "import-file", 'i', Execution::Args::Type::ImportFile, Resource::String::ImportFileArgumentDescription, ArgumentType::Positional, true },
             Argument{ "ignore-unavailable", Argument::NoAlias, Execution::Args::Type::IgnoreUnavailable, Resource::String::ImportIgnoreUnavailableArgumentDescription, ArgumentType::Flag },
             Argument{ "ignore-versions", Argument::NoAlias, Execution::Args::Type::IgnoreVersions, Resource::String::ImportIgnorePackageVersionsArgumentDescription, ArgumentType::Flag },
+            Argument{ "stream", Argument::NoAlias, Execution::Args::Type::ImportStream, Resource::String::ImportStreamArgumentDescription, ArgumentType::Flag },
             Argument::ForType(Execution::Args::Type::AcceptPackageAgreements),
             Argument::ForType(Execution::Args::Type::AcceptSourceAgreements),
         };
@@ -44,9 +45,21 @@ namespace AppInstaller::CLI
             Workflow::VerifyFile(Execution::Args::Type::ImportFile) <<
             Workflow::ReadImportFile <<
             Workflow::OpenSourcesForImport <<
-            Workflow::OpenPredefinedSource(Repository::PredefinedSource::Installed) <<
-            Workflow::SearchPackagesForImport <<
-            Workflow::ReportExecutionStage(Workflow::ExecutionStage::Execution) <<
-            Workflow::InstallImportedPackages;
+            Workflow::OpenPredefinedSource(Repository::PredefinedSource::Installed);
+
+        if (context.Args.Contains(Execution::Args::Type::ImportStream))
+        {
+            // Packages are installed as they are found, so the search is part of the execution.
+            context <<
+                Workflow::ReportExecutionStage(Workflow::ExecutionStage::Execution) <<
+                Workflow::SearchAndInstallPackagesForImport;
+        }
+        else
+        {
+            context <<
+                Workflow::SearchPackagesForImport <<
+                Workflow::ReportExecutionStage(Workflow::ExecutionStage::Execution) <<
+                Workflow::InstallImportedPackages;
+        }
     }
 }
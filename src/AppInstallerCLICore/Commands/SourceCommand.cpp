@@ -126,6 +126,7 @@ namespace AppInstaller::CLI
     {
         return {
             Argument::ForType(Args::Type::SourceName),
+            Argument::ForType(Args::Type::SourceBackgroundUpdate),
         };
     }
 
@@ -14,11 +14,17 @@ using AppInstaller::CLI::Workflow::ExecutionStage;
 
 namespace AppInstaller::CLI
 {
+    namespace
+    {
+        // The maximum number of packages that can be uninstalled by a single command.
+        constexpr size_t s_MaximumUninstallQueryCount = 100;
+    }
+
     std::vector<Argument> UninstallCommand::GetArguments() const
     {
         return
         {
-            Argument::ForType(Args::Type::Query),
+            Argument::ForType(Args::Type::Query).SetCountLimit(s_MaximumUninstallQueryCount),
             Argument::ForType(Args::Type::Manifest),
             Argument::ForType(Args::Type::Id),
             Argument::ForType(Args::Type::Name),
@@ -109,6 +115,14 @@ namespace AppInstaller::CLI
             Workflow::OpenSource() <<
             Workflow::OpenCompositeSource(Repository::PredefinedSource::Installed);
 
+        if (context.Args.GetCount(Execution::Args::Type::Query) > 1)
+        {
+            // uninstall each of the packages found for the queries
+            context <<
+                Workflow::UninstallMultiplePackages;
+            return;
+        }
+
         // find the uninstaller
         if (context.Args.Contains(Execution::Args::Type::Manifest))
         {
@@ -17,11 +17,11 @@ namespace AppInstaller::CLI
 {
     namespace
     {
-        bool ShouldListUpgrade(Context& context)
+        bool ShouldListUpgrade(const Execution::Args& args)
         {
-            for (Execution::Args::Type type : context.Args.GetTypes())
+            for (Execution::Args::Type type : args.GetTypes())
             {
-                if (type != Execution::Args::Type::Source && type != Execution::Args::Type::IncludeUnknown)
+                if (type != Execution::Args::Type::Source && type != Execution::Args::Type::IncludeUnknown && type != Execution::Args::Type::UpgradeSummary && type != Execution::Args::Type::OutputFormat)
                 {
                     return false;
                 }
@@ -52,7 +52,9 @@ namespace AppInstaller::CLI
             Argument::ForType(Args::Type::AcceptSourceAgreements),
             Argument::ForType(Execution::Args::Type::CustomHeader),
             Argument{ "all", Argument::NoAlias, Args::Type::All, Resource::String::UpdateAllArgumentDescription, ArgumentType::Flag },
-            Argument{ "include-unknown", Argument::NoAlias, Args::Type::IncludeUnknown, Resource::String::IncludeUnknownArgumentDescription, ArgumentType::Flag }
+            Argument{ "include-unknown", Argument::NoAlias, Args::Type::IncludeUnknown, Resource::String::IncludeUnknownArgumentDescription, ArgumentType::Flag },
+            Argument{ "summary", Argument::NoAlias, Args::Type::UpgradeSummary, Resource::String::UpgradeSummaryArgumentDescription, ArgumentType::Flag },
+            Argument::ForType(Args::Type::OutputFormat),
         };
     }
 
@@ -121,6 +123,16 @@ namespace AppInstaller::CLI
         {
             throw CommandException(Resource::String::BothManifestAndSearchQueryProvided, "");
         }
+
+        if (execArgs.Contains(Execution::Args::Type::UpgradeSummary) && !ShouldListUpgrade(execArgs))
+        {
+            throw CommandException(Resource::String::UpgradeSummaryOnlyWhenListing, "");
+        }
+
+        if (execArgs.Contains(Execution::Args::Type::OutputFormat) && !ShouldListUpgrade(execArgs))
+        {
+            throw CommandException(Resource::String::OutputFormatOnlyWhenListing, "");
+        }
     }
 
     void UpgradeCommand::ExecuteInternal(Execution::Context& context) const
@@ -129,7 +141,7 @@ namespace AppInstaller::CLI
 
         // Only allow for source failures when doing a list of available upgrades.
         // We have to set it now to allow for source open failures to also just warn.
-        if (ShouldListUpgrade(context))
+        if (ShouldListUpgrade(context.Args))
         {
             context.SetFlags(Execution::ContextFlag::TreatSourceFailuresAsWarning);
         }
@@ -139,14 +151,24 @@ namespace AppInstaller::CLI
             Workflow::OpenSource() <<
             Workflow::OpenCompositeSource(Repository::PredefinedSource::Installed);
 
-        if (ShouldListUpgrade(context))
+        if (ShouldListUpgrade(context.Args))
         {
-            // Upgrade with no args list packages with updates available
             context <<
                 SearchSourceForMany <<
-                HandleSearchResultFailures <<
-                EnsureMatchesFromSearchResult(true) <<
-                ReportListResult(true);
+                HandleSearchResultFailures;
+
+            if (context.Args.Contains(Execution::Args::Type::UpgradeSummary))
+            {
+                // Only the ids and count are output, so none of the other properties of the packages are read.
+                context << ReportUpgradeSummary;
+            }
+            else
+            {
+                // Upgrade with no args list packages with updates available
+                context <<
+                    EnsureMatchesFromSearchResult(true) <<
+                    ReportListResult(true);
+            }
         }
         else if (context.Args.Contains(Execution::Args::Type::All))
         {
@@ -6,15 +6,239 @@
 #include "Workflows/DependenciesFlow.h"
 #include "Resources.h"
 
+#include <AppInstallerSynchronization.h>
+#include <json.h>
+
+#include <mutex>
+
 namespace AppInstaller::CLI
 {
     using namespace std::string_view_literals;
     using namespace AppInstaller::Manifest;
 
+    namespace
+    {
+        // The number of paths that may be given to the command at once.
+        constexpr size_t s_MaximumManifestPathCount = 1000;
+
+        struct ManifestValidationResult
+        {
+            std::filesystem::path Path;
+            HRESULT Result = S_OK;
+            std::string Message;
+            // The dependencies of the installers, when the dependencies feature is enabled.
+            DependencyList Dependencies;
+        };
+
+        // A manifest directory holds the files of one manifest, and so contains files but no directories.
+        bool IsManifestDirectory(const std::filesystem::path& path)
+        {
+            bool hasFile = false;
+
+            for (const auto& entry : std::filesystem::directory_iterator{ path })
+            {
+                if (entry.is_directory())
+                {
+                    return false;
+                }
+
+                hasFile = hasFile || entry.is_regular_file();
+            }
+
+            return hasFile;
+        }
+
+        // Expands the manifest arguments; with recursion, each directory is replaced with every manifest directory under it.
+        std::vector<ManifestValidationResult> GetManifestsToValidate(Execution::Context& context)
+        {
+            bool recurse = context.Args.Contains(Execution::Args::Type::ValidateRecurse);
+            std::vector<ManifestValidationResult> manifests;
+
+            for (const auto& arg : *context.Args.GetArgs(Execution::Args::Type::ValidateManifest))
+            {
+                std::filesystem::path path = Utility::ConvertToUTF16(arg);
+
+                if (!std::filesystem::exists(path))
+                {
+                    context.Reporter.Error() << Resource::String::VerifyFileFailedNotExist << ' ' << path.u8string() << std::endl;
+                    AICLI_TERMINATE_CONTEXT_RETURN(HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND), {});
+                }
+
+                if (recurse && std::filesystem::is_directory(path) && !IsManifestDirectory(path))
+                {
+                    std::vector<std::filesystem::path> directories;
+                    for (const auto& entry : std::filesystem::recursive_directory_iterator{ path })
+                    {
+                        if (entry.is_directory() && IsManifestDirectory(entry.path()))
+                        {
+                            directories.emplace_back(entry.path());
+                        }
+                    }
+
+                    std::sort(directories.begin(), directories.end());
+                    for (auto& directory : directories)
+                    {
+                        manifests.emplace_back().Path = std::move(directory);
+                    }
+                }
+                else
+                {
+                    manifests.emplace_back().Path = std::move(path);
+                }
+            }
+
+            return manifests;
+        }
+
+        // Validates the manifest and gets its dependencies, as is done for a single manifest by GetInstallersDependenciesFromManifest.
+        void ValidateManifestPath(ManifestValidationResult& manifest, bool getDependencies)
+        {
+            try
+            {
+                ManifestValidateOption validateOption;
+                validateOption.FullValidation = true;
+                validateOption.ThrowOnWarning = true;
+                auto parsed = YamlParser::CreateFromPath(manifest.Path, validateOption);
+
+                if (getDependencies)
+                {
+                    for (const auto& installer : parsed.Installers)
+                    {
+                        manifest.Dependencies.Add(installer.Dependencies);
+                    }
+                }
+            }
+            catch (const ManifestException& e)
+            {
+                manifest.Result = e.IsWarningOnly() ? APPINSTALLER_CLI_ERROR_MANIFEST_VALIDATION_WARNING : APPINSTALLER_CLI_ERROR_MANIFEST_VALIDATION_FAILURE;
+                manifest.Message = e.GetManifestErrorMessage();
+            }
+            catch (...)
+            {
+                manifest.Result = wil::ResultFromCaughtException();
+            }
+        }
+
+        Json::Value GetDependencyIds(const DependencyList& dependencies, DependencyType type)
+        {
+            Json::Value result{ Json::ValueType::arrayValue };
+            dependencies.ApplyToType(type, [&](const Dependency& dependency) { result.append(dependency.Id); });
+            return result;
+        }
+
+        // The dependencies in the form of the manifest, so that the report of a single manifest can be matched with it.
+        Json::Value GetDependenciesJson(const DependencyList& dependencies)
+        {
+            Json::Value result{ Json::ValueType::objectValue };
+
+            if (dependencies.HasAnyOf(DependencyType::WindowsFeature))
+            {
+                result["WindowsFeatures"] = GetDependencyIds(dependencies, DependencyType::WindowsFeature);
+            }
+
+            if (dependencies.HasAnyOf(DependencyType::WindowsLibrary))
+            {
+                result["WindowsLibraries"] = GetDependencyIds(dependencies, DependencyType::WindowsLibrary);
+            }
+
+            if (dependencies.HasAnyOf(DependencyType::Package))
+            {
+                Json::Value packages{ Json::ValueType::arrayValue };
+                dependencies.ApplyToType(DependencyType::Package, [&](const Dependency& dependency)
+                    {
+                        Json::Value package{ Json::ValueType::objectValue };
+                        package["PackageIdentifier"] = dependency.Id;
+                        if (dependency.MinVersion)
+                        {
+                            package["MinimumVersion"] = dependency.MinVersion.value().ToString();
+                        }
+                        packages.append(std::move(package));
+                    });
+                result["PackageDependencies"] = std::move(packages);
+            }
+
+            if (dependencies.HasAnyOf(DependencyType::External))
+            {
+                result["ExternalDependencies"] = GetDependencyIds(dependencies, DependencyType::External);
+            }
+
+            return result;
+        }
+
+        std::string_view GetResultName(HRESULT result)
+        {
+            switch (result)
+            {
+            case S_OK: return "Success"sv;
+            case APPINSTALLER_CLI_ERROR_MANIFEST_VALIDATION_WARNING: return "Warning"sv;
+            default: return "Failure"sv;
+            }
+        }
+
+        // Validates every manifest on a pool of threads, in one process so that the compiled schemas are shared,
+        // and writes each result as a line of JSON as soon as it is known.
+        void ValidateMultipleManifests(Execution::Context& context)
+        {
+            std::vector<ManifestValidationResult> manifests = GetManifestsToValidate(context);
+            if (context.IsTerminated())
+            {
+                return;
+            }
+
+            // The dependencies are reported as they are for a single manifest; they are read from the manifest only,
+            // as there is no index here to check the package dependencies against.
+            bool getDependencies = Settings::ExperimentalFeature::IsEnabled(Settings::ExperimentalFeature::Feature::Dependencies);
+
+            std::mutex outputLock;
+            Json::StreamWriterBuilder writerBuilder;
+            writerBuilder.settings_["indentation"] = "";
+
+            Synchronization::RunConcurrently(manifests.size(), [&](size_t i)
+                {
+                    ManifestValidationResult& manifest = manifests[i];
+                    ValidateManifestPath(manifest, getDependencies);
+
+                    Json::Value json{ Json::ValueType::objectValue };
+                    json["path"] = manifest.Path.u8string();
+                    json["result"] = std::string{ GetResultName(manifest.Result) };
+                    json["hresult"] = static_cast<Json::Int>(manifest.Result);
+                    if (!manifest.Message.empty())
+                    {
+                        json["message"] = manifest.Message;
+                    }
+                    if (manifest.Dependencies.HasAny())
+                    {
+                        json["dependencies"] = GetDependenciesJson(manifest.Dependencies);
+                    }
+
+                    std::string line = Json::writeString(writerBuilder, json);
+
+                    std::lock_guard<std::mutex> lock{ outputLock };
+                    context.Reporter.Info() << Utility::LocIndString{ std::move(line) } << std::endl;
+                });
+
+            // Failures take precedence over warnings in the result of the command.
+            HRESULT result = S_OK;
+            for (const auto& manifest : manifests)
+            {
+                if (manifest.Result != S_OK && (result == S_OK || result == APPINSTALLER_CLI_ERROR_MANIFEST_VALIDATION_WARNING))
+                {
+                    result = manifest.Result;
+                }
+            }
+
+            if (result != S_OK)
+            {
+                AICLI_TERMINATE_CONTEXT(result);
+            }
+        }
+    }
+
     std::vector<Argument> ValidateCommand::GetArguments() const
     {
         return {
-            Argument::ForType(Execution::Args::Type::ValidateManifest),
+            Argument::ForType(Execution::Args::Type::ValidateManifest).SetCountLimit(s_MaximumManifestPathCount),
+            Argument::ForType(Execution::Args::Type::ValidateRecurse),
         };
     }
 
@@ -35,6 +259,13 @@ namespace AppInstaller::CLI
 
     void ValidateCommand::ExecuteInternal(Execution::Context& context) const
     {
+        if (context.Args.Contains(Execution::Args::Type::ValidateRecurse) ||
+            context.Args.GetCount(Execution::Args::Type::ValidateManifest) > 1)
+        {
+            context << ValidateMultipleManifests;
+            return;
+        }
+
         context <<
             Workflow::VerifyPath(Execution::Args::Type::ValidateManifest) <<
             [](Execution::Context& context)
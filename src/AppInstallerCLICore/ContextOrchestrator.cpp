@@ -6,23 +6,194 @@
 #include "COMContext.h"
 #include "Commands/COMInstallCommand.h"
 #include "winget/UserSettings.h"
+#include <winget/GroupPolicy.h>
 #include <Commands/RootCommand.h>
+#include <atomic>
 
 namespace AppInstaller::CLI::Execution
 {
     namespace
     {
+        using namespace std::chrono_literals;
+
         // Callback function used by worker threads in the queue.
-        // context must be a pointer to a queue item.
+        // context must be a pointer to the queue.
+        // A work item is submitted for each item that is queued, but each one runs whichever item the queue
+        // selects, so that the items run in priority order rather than in the order that they were queued.
         void CALLBACK OrchestratorQueueWorkCallback(PTP_CALLBACK_INSTANCE, PVOID context, PTP_WORK)
         {
-            auto queueItem = reinterpret_cast<OrchestratorQueueItem*>(context);
-            auto queue = queueItem->GetCurrentQueue();
-            if (queue)
+            reinterpret_cast<OrchestratorQueue*>(context)->RunNextItem();
+        }
+
+        // The default for the most downloads that may run at once, when it is not set by policy.
+        constexpr UINT32 s_DefaultMaximumDownloadThreads = 6;
+
+        // While a raise made no clear difference, this many periods pass before the next is tried.
+        constexpr UINT32 s_ConcurrencyHoldPeriods = 6;
+
+        // Gets the host that the item downloads its installer from, if it is known.
+        std::string GetDownloadHost(const OrchestratorQueueItem& item)
+        {
+            const auto& context = item.GetContext();
+            if (!context.Contains(Data::Installer) || !context.Get<Data::Installer>())
             {
-                queue->RunItem(queueItem->GetId());
+                return {};
             }
+
+            std::string_view url = context.Get<Data::Installer>()->Url;
+            auto schemeEnd = url.find("://");
+            if (schemeEnd != std::string_view::npos)
+            {
+                url = url.substr(schemeEnd + 3);
+            }
+
+            return Utility::ToLower(url.substr(0, url.find_first_of("/:?#")));
+        }
+
+        // The lock statistics of all of the queues.
+        std::atomic<uint64_t> s_lockAcquisitions = 0;
+        std::atomic<uint64_t> s_contendedLockAcquisitions = 0;
+        std::atomic<uint64_t> s_lockWaitMicroseconds = 0;
+        std::atomic<uint64_t> s_maximumLockWaitMicroseconds = 0;
+    }
+
+    OrchestratorLockStatistics GetOrchestratorLockStatistics()
+    {
+        OrchestratorLockStatistics result;
+        result.Acquisitions = s_lockAcquisitions.load();
+        result.ContendedAcquisitions = s_contendedLockAcquisitions.load();
+        result.TotalWait = std::chrono::microseconds{ s_lockWaitMicroseconds.load() };
+        result.MaximumWait = std::chrono::microseconds{ s_maximumLockWaitMicroseconds.load() };
+        return result;
+    }
+
+    void OrchestratorQueueMutex::lock()
+    {
+        ++s_lockAcquisitions;
+
+        if (m_mutex.try_lock())
+        {
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        m_mutex.lock();
+        uint64_t waited = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+
+        ++s_contendedLockAcquisitions;
+        s_lockWaitMicroseconds += waited;
+
+        uint64_t maximum = s_maximumLockWaitMicroseconds.load(std::memory_order_relaxed);
+        while (waited > maximum && !s_maximumLockWaitMicroseconds.compare_exchange_weak(maximum, waited, std::memory_order_relaxed)) {}
+    }
+
+    bool OrchestratorQueueMutex::try_lock()
+    {
+        if (!m_mutex.try_lock())
+        {
+            return false;
+        }
+
+        ++s_lockAcquisitions;
+        return true;
+    }
+
+    void OrchestratorQueueMutex::unlock()
+    {
+        m_mutex.unlock();
+    }
+
+    DownloadConcurrencyController::DownloadConcurrencyController(UINT32 initialLimit, UINT32 maximumLimit, clock::time_point now) :
+        m_limit(std::max<UINT32>(1, std::min(initialLimit, maximumLimit))), m_maximumLimit(std::max<UINT32>(1, maximumLimit)), m_periodStart(now)
+    {
+    }
+
+    void DownloadConcurrencyController::RecordProgress(DownloadId id, std::string_view host, uint64_t bytesReceived)
+    {
+        auto& download = m_downloads[id];
+        if (download.Host.empty())
+        {
+            download.Host = host;
+        }
+
+        // A download that is restarted reports from where it restarted.
+        if (bytesReceived > download.BytesReceived)
+        {
+            m_periodBytes += bytesReceived - download.BytesReceived;
         }
+
+        download.BytesReceived = bytesReceived;
+    }
+
+    void DownloadConcurrencyController::RemoveDownload(DownloadId id)
+    {
+        m_downloads.erase(id);
+    }
+
+    UINT32 DownloadConcurrencyController::GetActiveHostCount() const
+    {
+        std::set<std::string_view> hosts;
+        for (const auto& download : m_downloads)
+        {
+            hosts.emplace(download.second.Host);
+        }
+
+        return static_cast<UINT32>(hosts.size());
+    }
+
+    bool DownloadConcurrencyController::IsHostLimitReached() const
+    {
+        return m_downloads.size() >= MaximumDownloadsPerHost && GetActiveHostCount() == 1;
+    }
+
+    std::optional<UINT32> DownloadConcurrencyController::Evaluate(bool hasWaitingDownloads, clock::time_point now)
+    {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_periodStart);
+        if (now - m_periodStart < SamplePeriod)
+        {
+            return {};
+        }
+
+        uint64_t bytesPerSecond = m_periodBytes * 1000 / std::max<uint64_t>(1, elapsed.count());
+        uint64_t previousBytesPerSecond = m_lastBytesPerSecond;
+
+        m_periodStart = now;
+        m_periodBytes = 0;
+        m_lastBytesPerSecond = bytesPerSecond;
+
+        UINT32 newLimit = m_limit;
+        bool wasRaise = m_lastChangeWasRaise;
+        m_lastChangeWasRaise = false;
+
+        if (wasRaise && bytesPerSecond * 10 < previousBytesPerSecond * 9)
+        {
+            // The last raise made the throughput worse, so undo it and hold there for a while.
+            newLimit = m_limit - 1;
+            m_holdPeriods = s_ConcurrencyHoldPeriods;
+        }
+        else if (wasRaise && bytesPerSecond * 10 < previousBytesPerSecond * 11)
+        {
+            // The last raise made no clear difference; keep it, but do not try another for a while.
+            m_holdPeriods = s_ConcurrencyHoldPeriods;
+        }
+        else if (m_holdPeriods > 0)
+        {
+            --m_holdPeriods;
+        }
+        else if (hasWaitingDownloads && m_downloads.size() >= m_limit && m_limit < m_maximumLimit && !IsHostLimitReached())
+        {
+            // Downloads are waiting for the running ones, which are not obviously limited; try running one more.
+            newLimit = m_limit + 1;
+            m_lastChangeWasRaise = true;
+        }
+
+        if (newLimit == m_limit)
+        {
+            return {};
+        }
+
+        m_limit = newLimit;
+        return newLimit;
     }
 
     ContextOrchestrator& ContextOrchestrator::Instance()
@@ -46,45 +217,37 @@ namespace AppInstaller::CLI::Execution
         const UINT32 installThreads = 1;
         const UINT32 downloadThreads = std::min(supportedConcurrentThreads ? supportedConcurrentThreads - 1 : 1, maxDownloadThreads);
 
-        AddCommandQueue(COMDownloadCommand::CommandName, downloadThreads);
-        AddCommandQueue(COMInstallCommand::CommandName, installThreads);
-    }
+        // The number of downloads starts there, and is adjusted to their throughput up to this limit.
+        const UINT32 maximumDownloadThreads = Settings::GroupPolicies().GetValue<Settings::ValuePolicy::MaximumConcurrentDownloads>().value_or(s_DefaultMaximumDownloadThreads);
 
-    void ContextOrchestrator::AddCommandQueue(std::string_view commandName, UINT32 allowedThreads)
-    {
-        m_commandQueues.emplace(commandName, std::make_unique<OrchestratorQueue>(commandName, allowedThreads));
+        // Downloads can pause between chunks, but an installer that has started cannot.
+        AddCommandQueue(COMDownloadCommand::CommandName, std::min(downloadThreads, maximumDownloadThreads), true, maximumDownloadThreads);
+        AddCommandQueue(COMInstallCommand::CommandName, installThreads, false);
     }
 
-    _Requires_lock_held_(m_queueLock)
-    std::shared_ptr<OrchestratorQueueItem> ContextOrchestrator::FindById(const OrchestratorQueueItemId& comparisonQueueItemId)
+    void ContextOrchestrator::AddCommandQueue(std::string_view commandName, UINT32 allowedThreads, bool allowsPreemption, UINT32 maximumThreads)
     {
-        for (const auto& queue : m_commandQueues)
-        {
-            auto item = queue.second->FindById(comparisonQueueItemId);
-            if (item)
-            {
-                return item;
-            }
-        }
-
-        return {};
+        m_commandQueues.emplace(commandName, std::make_unique<OrchestratorQueue>(commandName, allowedThreads, allowsPreemption, maximumThreads));
     }
 
     void ContextOrchestrator::EnqueueAndRunItem(std::shared_ptr<OrchestratorQueueItem> item)
     {
-        std::lock_guard<std::mutex> lockQueue{ m_queueLock };
-
         if (item->IsOnFirstCommand())
         {
-            THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INSTALL_ALREADY_RUNNING), FindById(item->GetId()));
-        }
+            THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INSTALL_ALREADY_RUNNING), !m_items.Add(item));
 
-        m_commandQueues.at(std::string(item->GetNextCommand().Name()))->EnqueueAndRunItem(item);
+            auto removeOnFailure = wil::scope_exit([&]() { m_items.Remove(*item); });
+            m_commandQueues.at(std::string(item->GetNextCommand().Name()))->EnqueueAndRunItem(item);
+            removeOnFailure.release();
+        }
+        else
+        {
+            m_commandQueues.at(std::string(item->GetNextCommand().Name()))->EnqueueAndRunItem(item);
+        }
     }
 
     void ContextOrchestrator::RemoveItemInState(const OrchestratorQueueItem& item, OrchestratorQueueItemState state)
     {
-        std::lock_guard<std::mutex> lockQueue{ m_queueLock };
         for (const auto& queue : m_commandQueues)
         {
             if (queue.second->RemoveItemInState(item, state, true))
@@ -104,9 +267,7 @@ namespace AppInstaller::CLI::Execution
 
     std::shared_ptr<OrchestratorQueueItem> ContextOrchestrator::GetQueueItem(const OrchestratorQueueItemId& queueItemId)
     {
-        std::lock_guard<std::mutex> lock{ m_queueLock };
-
-        return FindById(queueItemId);
+        return m_items.Find(queueItemId);
     }
 
     void ContextOrchestrator::AddItemManifestToInstallingSource(const OrchestratorQueueItem& queueItem)
@@ -121,29 +282,56 @@ namespace AppInstaller::CLI::Execution
         m_installingWriteableSource.RemovePackageVersion(manifest, std::filesystem::path{ manifest.Id + '.' + manifest.Version });
     }
 
-    _Requires_lock_held_(m_queueLock)
-    std::deque<std::shared_ptr<OrchestratorQueueItem>>::iterator OrchestratorQueue::FindIteratorById(const OrchestratorQueueItemId& comparisonQueueItemId)
+    void ContextOrchestrator::OnItemRemoved(const OrchestratorQueueItem& queueItem)
     {
-        return std::find_if(m_queueItems.begin(), m_queueItems.end(), [&comparisonQueueItemId](const std::shared_ptr<OrchestratorQueueItem>& item) {return (item->GetId().IsSame(comparisonQueueItemId)); });
+        RemoveItemManifestFromInstallingSource(queueItem);
+        m_items.Remove(queueItem);
     }
 
-    _Requires_lock_held_(m_queueLock)
-    std::shared_ptr<OrchestratorQueueItem> OrchestratorQueue::FindById(const OrchestratorQueueItemId& comparisonQueueItemId)
+    bool OrchestratorQueueItemIndex::Add(std::shared_ptr<OrchestratorQueueItem> item)
+    {
+        auto lock = m_lock.lock_exclusive();
+        OrchestratorQueueItemId id = item->GetId();
+        return m_items.emplace(std::move(id), std::move(item)).second;
+    }
+
+    void OrchestratorQueueItemIndex::Remove(const OrchestratorQueueItem& item)
     {
-        auto itr = FindIteratorById(comparisonQueueItemId);
-        if (itr != m_queueItems.end())
+        auto lock = m_lock.lock_exclusive();
+        auto itr = m_items.find(item.GetId());
+        if (itr != m_items.end() && itr->second.get() == &item)
         {
-            return *itr;
+            m_items.erase(itr);
         }
+    }
+
+    std::shared_ptr<OrchestratorQueueItem> OrchestratorQueueItemIndex::Find(const OrchestratorQueueItemId& id) const
+    {
+        auto lock = m_lock.lock_shared();
+        auto itr = m_items.find(id);
+        return (itr == m_items.end() ? nullptr : itr->second);
+    }
+
+    size_t OrchestratorQueueItemIndex::Size() const
+    {
+        auto lock = m_lock.lock_shared();
+        return m_items.size();
+    }
 
-        return {};
+    _Requires_lock_held_(m_queueLock)
+    OrchestratorQueue::QueueItems::iterator OrchestratorQueue::FindIteratorById(const OrchestratorQueueItemId& comparisonQueueItemId)
+    {
+        auto itr = m_queueItemsById.find(comparisonQueueItemId);
+        return (itr == m_queueItemsById.end() ? m_queueItems.end() : itr->second);
     }
 
     void OrchestratorQueue::EnqueueItem(std::shared_ptr<OrchestratorQueueItem> item)
     {
         {
-            std::lock_guard<std::mutex> lockQueue{ m_queueLock };
+            std::lock_guard<OrchestratorQueueMutex> lockQueue{ m_queueLock };
             m_queueItems.push_back(item);
+            m_queueItemsById.emplace(item->GetId(), std::prev(m_queueItems.end()));
+            m_scheduler.OnItemQueued(*item);
         }
 
         // Add the package to the Installing source so that it can be queried using the Source interface.
@@ -154,14 +342,19 @@ namespace AppInstaller::CLI::Execution
         }
 
         {
-            std::lock_guard<std::mutex> lockQueue{ m_queueLock };
+            std::lock_guard<OrchestratorQueueMutex> lockQueue{ m_queueLock };
             item->SetState(OrchestratorQueueItemState::Queued);
         }
     }
 
-    OrchestratorQueue::OrchestratorQueue(std::string_view commandName, UINT32 allowedThreads) :
-        m_commandName(commandName), m_allowedThreads(allowedThreads)
+    OrchestratorQueue::OrchestratorQueue(std::string_view commandName, UINT32 allowedThreads, bool allowsPreemption, UINT32 maximumThreads) :
+        m_commandName(commandName), m_allowedThreads(allowedThreads), m_allowsPreemption(allowsPreemption)
     {
+        if (maximumThreads > allowedThreads)
+        {
+            m_concurrencyController.emplace(allowedThreads, maximumThreads);
+        }
+
         m_threadPool.reset(CreateThreadpool(nullptr));
         THROW_LAST_ERROR_IF_NULL(m_threadPool);
         m_threadPoolCleanupGroup.reset(CreateThreadpoolCleanupGroup());
@@ -184,44 +377,213 @@ namespace AppInstaller::CLI::Execution
         EnqueueItem(item);
 
         item->SetCurrentQueue(this);
-        auto work = CreateThreadpoolWork(OrchestratorQueueWorkCallback, item.get(), &m_threadPoolCallbackEnviron);
+        auto work = CreateThreadpoolWork(OrchestratorQueueWorkCallback, this, &m_threadPoolCallbackEnviron);
         SubmitThreadpoolWork(work);
     }
 
-    void OrchestratorQueue::RunItem(const OrchestratorQueueItemId& itemId)
+    void OrchestratorQueueScheduler::OnItemQueued(OrchestratorQueueItem& item) const
+    {
+        item.SetQueuedRunSequence(m_runSequence);
+    }
+
+    std::shared_ptr<OrchestratorQueueItem> OrchestratorQueueScheduler::SelectNextItem(const std::list<std::shared_ptr<OrchestratorQueueItem>>& items) const
+    {
+        std::shared_ptr<OrchestratorQueueItem> result;
+        uint64_t resultPriority = 0;
+
+        for (const auto& item : items)
+        {
+            // Cancelled items are removed before running anything else.
+            if (item->GetState() == OrchestratorQueueItemState::Cancelled)
+            {
+                return item;
+            }
+
+            if (item->GetState() != OrchestratorQueueItemState::Queued)
+            {
+                continue;
+            }
+
+            // Prefer higher priorities, then the caller that has waited the longest for a turn, then the order they were queued in.
+            uint64_t priority = GetEffectivePriority(*item);
+            if (!result ||
+                priority > resultPriority ||
+                (priority == resultPriority && GetCallerLastRun(*item) < GetCallerLastRun(*result)))
+            {
+                result = item;
+                resultPriority = priority;
+            }
+        }
+
+        return result;
+    }
+
+    void OrchestratorQueueScheduler::OnItemStarted(const OrchestratorQueueItem& item)
+    {
+        m_callerLastRun[item.GetCallerProcessId()] = ++m_runSequence;
+    }
+
+    uint64_t OrchestratorQueueScheduler::GetEffectivePriority(const OrchestratorQueueItem& item) const
+    {
+        uint64_t startedAhead = m_runSequence - item.GetQueuedRunSequence();
+        return static_cast<uint64_t>(item.GetPriority()) + startedAhead / AgingRunCount;
+    }
+
+    bool OrchestratorQueueScheduler::ShouldPause(const std::list<std::shared_ptr<OrchestratorQueueItem>>& items, const OrchestratorQueueItem& running, UINT32 allowedThreads, UINT32 pausedCount) const
+    {
+        bool higherPriorityQueued = std::any_of(items.begin(), items.end(), [&](const std::shared_ptr<OrchestratorQueueItem>& item)
+            {
+                return item->GetState() == OrchestratorQueueItemState::Queued && item->GetPriority() > running.GetPriority();
+            });
+
+        if (!higherPriorityQueued)
+        {
+            return false;
+        }
+
+        // An item only pauses if the waiting one cannot have a thread of its own.
+        auto runningCount = std::count_if(items.begin(), items.end(), [](const std::shared_ptr<OrchestratorQueueItem>& item)
+            {
+                return item->GetState() == OrchestratorQueueItemState::Running;
+            });
+
+        return static_cast<UINT32>(runningCount) - pausedCount >= allowedThreads;
+    }
+
+    uint64_t OrchestratorQueueScheduler::GetCallerLastRun(const OrchestratorQueueItem& item) const
+    {
+        auto itr = m_callerLastRun.find(item.GetCallerProcessId());
+        return (itr == m_callerLastRun.end() ? 0 : itr->second);
+    }
+
+    _Requires_lock_held_(m_queueLock)
+    bool OrchestratorQueue::IsHigherPriorityItemQueued(OrchestratorQueueItemPriority priority) const
+    {
+        return std::any_of(m_queueItems.begin(), m_queueItems.end(), [&](const std::shared_ptr<OrchestratorQueueItem>& item)
+            {
+                return item->GetState() == OrchestratorQueueItemState::Queued && item->GetPriority() > priority;
+            });
+    }
+
+    _Requires_lock_held_(m_queueLock)
+    bool OrchestratorQueue::AreAllThreadsBusy() const
+    {
+        auto running = std::count_if(m_queueItems.begin(), m_queueItems.end(), [](const std::shared_ptr<OrchestratorQueueItem>& item)
+            {
+                return item->GetState() == OrchestratorQueueItemState::Running;
+            });
+
+        return static_cast<UINT32>(running) - m_preemptedItems >= m_allowedThreads;
+    }
+
+    bool OrchestratorQueue::IsPreemptionRequested(const OrchestratorQueueItem& item)
+    {
+        std::lock_guard<OrchestratorQueueMutex> lockQueue{ m_queueLock };
+        return m_scheduler.ShouldPause(m_queueItems, item, m_allowedThreads, m_preemptedItems);
+    }
+
+    void OrchestratorQueue::WaitWhilePreempted(const OrchestratorQueueItem& item)
+    {
+        std::unique_lock<OrchestratorQueueMutex> lockQueue{ m_queueLock };
+
+        // The waiting item may have started on another thread since the pause was requested.
+        if (!m_scheduler.ShouldPause(m_queueItems, item, m_allowedThreads, m_preemptedItems))
+        {
+            return;
+        }
+
+        AICLI_LOG(CLI, Info, << "Pausing " << Utility::ConvertToUTF8(item.GetId().GetPackageId()) << " for a waiting item of a higher priority");
+
+        // Lend the thread of the paused item to the waiting one.
+        ++m_preemptedItems;
+        SetThreadpoolThreadMaximum(m_threadPool.get(), m_allowedThreads + m_preemptedItems);
+
+        while (!item.GetContext().IsTerminated() && (IsHigherPriorityItemQueued(item.GetPriority()) || AreAllThreadsBusy()))
+        {
+            m_preemptionChanged.wait_for(lockQueue, 1s);
+        }
+
+        --m_preemptedItems;
+        SetThreadpoolThreadMaximum(m_threadPool.get(), m_allowedThreads + m_preemptedItems);
+
+        AICLI_LOG(CLI, Info, << "Resuming " << Utility::ConvertToUTF8(item.GetId().GetPackageId()));
+    }
+
+    void OrchestratorQueue::OnItemProgress(const OrchestratorQueueItem& item, uint64_t current, ProgressType type)
+    {
+        if (m_concurrencyController && type == ProgressType::Bytes)
+        {
+            std::lock_guard<OrchestratorQueueMutex> lockQueue{ m_queueLock };
+            AdjustConcurrency(item, current);
+        }
+    }
+
+    _Requires_lock_held_(m_queueLock)
+    void OrchestratorQueue::AdjustConcurrency(const OrchestratorQueueItem& item, uint64_t bytesReceived)
+    {
+        m_concurrencyController->RecordProgress(reinterpret_cast<DownloadConcurrencyController::DownloadId>(&item), GetDownloadHost(item), bytesReceived);
+
+        bool hasWaitingItems = std::any_of(m_queueItems.begin(), m_queueItems.end(), [](const std::shared_ptr<OrchestratorQueueItem>& queueItem)
+            {
+                return queueItem->GetState() == OrchestratorQueueItemState::Queued;
+            });
+
+        auto newLimit = m_concurrencyController->Evaluate(hasWaitingItems);
+        if (newLimit)
+        {
+            Logging::Telemetry().LogDownloadConcurrencyChange(m_allowedThreads, *newLimit, m_concurrencyController->GetLastBytesPerSecond(),
+                m_concurrencyController->GetActiveDownloadCount(), m_concurrencyController->GetActiveHostCount());
+
+            m_allowedThreads = *newLimit;
+            SetThreadpoolThreadMaximum(m_threadPool.get(), m_allowedThreads + m_preemptedItems);
+            m_preemptionChanged.notify_all();
+        }
+    }
+
+    void OrchestratorQueue::RunNextItem()
     {
         try
         {
             std::shared_ptr<OrchestratorQueueItem> item;
-            bool isCancelled = false;
 
-            // Try to find the item in the queue.
             {
-                std::lock_guard<std::mutex> lockQueue{ m_queueLock };
-                item = FindById(itemId);
+                std::lock_guard<OrchestratorQueueMutex> lockQueue{ m_queueLock };
+                item = m_scheduler.SelectNextItem(m_queueItems);
 
                 if (!item)
                 {
-                    // Item should be in the queue; this shouldn't happen.
+                    // A work item is submitted for each queued item; this shouldn't happen.
                     return;
                 }
 
-                // Only run if the item is queued and not cancelled.
                 if (item->GetState() == OrchestratorQueueItemState::Queued)
                 {
                     // Mark it as running so that it cannot be cancelled by other threads.
                     item->SetState(OrchestratorQueueItemState::Running);
-                }
-                else if (item->GetState() == OrchestratorQueueItemState::Cancelled)
-                {
-                    isCancelled = true;
+                    m_scheduler.OnItemStarted(*item);
+                    m_preemptionChanged.notify_all();
                 }
             }
 
-            if (isCancelled)
+            if (item->GetState() == OrchestratorQueueItemState::Cancelled)
             {
                 // Do this separate from above block as the Remove function needs to manage the lock.
                 RemoveItemInState(*item, OrchestratorQueueItemState::Cancelled, true);
+                return;
+            }
+
+            if (m_concurrencyController)
+            {
+                item->GetContext().SetProgressGate([this, rawItem = item.get()](uint64_t current, uint64_t, ProgressType type) { OnItemProgress(*rawItem, current, type); });
+            }
+
+            // The item is only paused where its work can stop and later continue, rather than holding its progress callback;
+            // that would leave installers and other work running, and their network connections open and timing out.
+            if (m_allowsPreemption)
+            {
+                item->GetContext().SetPauseGate(
+                    [this, rawItem = item.get()]() { return IsPreemptionRequested(*rawItem); },
+                    [this, rawItem = item.get()]() { WaitWhilePreempted(*rawItem); });
             }
 
             // Get the item's command and execute it.
@@ -241,6 +603,15 @@ namespace AppInstaller::CLI::Execution
             }
             WINGET_CATCH_STORE(terminationHR, APPINSTALLER_CLI_ERROR_COMMAND_FAILED);
 
+            item->GetContext().SetProgressGate({});
+            item->GetContext().SetPauseGate({}, {});
+
+            if (m_concurrencyController)
+            {
+                std::lock_guard<OrchestratorQueueMutex> lockQueue{ m_queueLock };
+                m_concurrencyController->RemoveDownload(reinterpret_cast<DownloadConcurrencyController::DownloadId>(item.get()));
+            }
+
             if (FAILED(terminationHR))
             {
                 // ::Execute sometimes catches exceptions and returns hresults based on those exceptions without the context
@@ -275,7 +646,7 @@ namespace AppInstaller::CLI::Execution
         bool foundItem = false;
 
         {
-            std::lock_guard<std::mutex> lockQueue{ m_queueLock };
+            std::lock_guard<OrchestratorQueueMutex> lockQueue{ m_queueLock };
 
             // Look for the item. It's ok if the item is not found since multiple listeners may try to remove the same item.
             auto itr = FindIteratorById(item.GetId());
@@ -289,7 +660,9 @@ namespace AppInstaller::CLI::Execution
                 if (state == OrchestratorQueueItemState::Running || state == OrchestratorQueueItemState::Cancelled)
                 {
                     (*itr)->SetCurrentQueue(nullptr);
+                    m_queueItemsById.erase(item.GetId());
                     m_queueItems.erase(itr);
+                    m_preemptionChanged.notify_all();
                 }
                 else if (state == OrchestratorQueueItemState::Queued)
                 {
@@ -300,7 +673,7 @@ namespace AppInstaller::CLI::Execution
 
         if (foundItem && isGlobalRemove)
         {
-            ContextOrchestrator::Instance().RemoveItemManifestFromInstallingSource(item);
+            ContextOrchestrator::Instance().OnItemRemoved(item);
             item.GetCompletedEvent().SetEvent();
         }
 
@@ -313,6 +686,11 @@ namespace AppInstaller::CLI::Execution
                 (GetSourceId() == comparedId.GetSourceId()));
     }
 
+    size_t OrchestratorQueueItemIdHash::operator()(const OrchestratorQueueItemId& id) const
+    {
+        return std::hash<std::wstring_view>{}(id.GetPackageId()) ^ (std::hash<std::wstring_view>{}(id.GetSourceId()) << 1);
+    }
+
     std::unique_ptr<OrchestratorQueueItem> OrchestratorQueueItemFactory::CreateItemForInstall(std::wstring packageId, std::wstring sourceId, std::unique_ptr<COMContext> context)
     {
         std::unique_ptr<OrchestratorQueueItem> item = std::make_unique<OrchestratorQueueItem>(OrchestratorQueueItemId(std::move(packageId), std::move(sourceId)), std::move(context));
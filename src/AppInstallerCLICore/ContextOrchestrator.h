@@ -9,8 +9,15 @@
 #include "CompletionData.h"
 #include "Command.h"
 #include "COMContext.h"
+#include "ContextOrchestratorLock.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <list>
+#include <optional>
 #include <string_view>
+#include <unordered_map>
 
 namespace AppInstaller::CLI::Execution
 {
@@ -26,6 +33,14 @@ namespace AppInstaller::CLI::Execution
         Cancelled
     };
 
+    // The order in which waiting items are run; items with a higher priority run first.
+    enum class OrchestratorQueueItemPriority
+    {
+        Low,
+        Normal,
+        High,
+    };
+
     struct OrchestratorQueueItemId
     {
         OrchestratorQueueItemId(std::wstring packageId, std::wstring sourceId) : m_packageId(std::move(packageId)), m_sourceId(std::move(sourceId)) {}
@@ -33,11 +48,69 @@ namespace AppInstaller::CLI::Execution
         std::wstring_view GetSourceId() const { return m_sourceId; }
 
         bool IsSame(const OrchestratorQueueItemId& comparisonQueueItemId) const;
+        bool operator==(const OrchestratorQueueItemId& other) const { return IsSame(other); }
     private:
         std::wstring m_packageId;
         std::wstring m_sourceId;
     };
 
+    struct OrchestratorQueueItemIdHash
+    {
+        size_t operator()(const OrchestratorQueueItemId& id) const;
+    };
+
+    // Decides how many downloads should run at once, from the throughput that the running downloads achieve.
+    // Each period, the limit is raised while doing so raises the total throughput and downloads are waiting,
+    // and lowered again when the last raise made the throughput worse.
+    struct DownloadConcurrencyController
+    {
+        using DownloadId = uintptr_t;
+        using clock = std::chrono::steady_clock;
+
+        // The length of the period over which throughput is measured.
+        static constexpr clock::duration SamplePeriod = std::chrono::seconds(5);
+
+        // The number of downloads from one host that are worth running at once; beyond this, a host is assumed to throttle them.
+        static constexpr UINT32 MaximumDownloadsPerHost = 4;
+
+        DownloadConcurrencyController(UINT32 initialLimit, UINT32 maximumLimit, clock::time_point now = clock::now());
+
+        UINT32 GetLimit() const { return m_limit; }
+
+        // Records the total bytes that a running download has received so far.
+        void RecordProgress(DownloadId id, std::string_view host, uint64_t bytesReceived);
+
+        // Forgets a download that is no longer running.
+        void RemoveDownload(DownloadId id);
+
+        // At the end of a period, decides whether the limit should change, returning the new limit if so.
+        std::optional<UINT32> Evaluate(bool hasWaitingDownloads, clock::time_point now = clock::now());
+
+        // The measurements from the last period that was evaluated.
+        uint64_t GetLastBytesPerSecond() const { return m_lastBytesPerSecond; }
+        UINT32 GetActiveDownloadCount() const { return static_cast<UINT32>(m_downloads.size()); }
+        UINT32 GetActiveHostCount() const;
+
+    private:
+        struct Download
+        {
+            std::string Host;
+            uint64_t BytesReceived = 0;
+        };
+
+        // Determines whether the running downloads are all from one host that already has as many as it is worth.
+        bool IsHostLimitReached() const;
+
+        UINT32 m_limit;
+        UINT32 m_maximumLimit;
+        std::map<DownloadId, Download> m_downloads;
+        clock::time_point m_periodStart;
+        uint64_t m_periodBytes = 0;
+        uint64_t m_lastBytesPerSecond = 0;
+        bool m_lastChangeWasRaise = false;
+        UINT32 m_holdPeriods = 0;
+    };
+
     struct OrchestratorQueue;
 
     struct OrchestratorQueueItem
@@ -54,6 +127,17 @@ namespace AppInstaller::CLI::Execution
         const wil::unique_event& GetCompletedEvent() const { return m_completedEvent; }
         const OrchestratorQueueItemId& GetId() const { return m_id; }
 
+        OrchestratorQueueItemPriority GetPriority() const { return m_priority; }
+        void SetPriority(OrchestratorQueueItemPriority priority) { m_priority = priority; }
+
+        // The process that requested the item; waiting items of the same priority take turns between processes.
+        DWORD GetCallerProcessId() const { return m_callerProcessId; }
+        void SetCallerProcessId(DWORD callerProcessId) { m_callerProcessId = callerProcessId; }
+
+        // The number of items that its current queue had started when the item was queued.
+        uint64_t GetQueuedRunSequence() const { return m_queuedRunSequence; }
+        void SetQueuedRunSequence(uint64_t queuedRunSequence) { m_queuedRunSequence = queuedRunSequence; }
+
         void AddCommand(std::unique_ptr<Command> command) { m_commands.push_back(std::move(command)); }
         const Command& GetNextCommand() const { return *m_commands.front(); }
         std::unique_ptr<Command> PopNextCommand()
@@ -75,6 +159,62 @@ namespace AppInstaller::CLI::Execution
         std::deque<std::unique_ptr<Command>> m_commands;
         bool m_isOnFirstCommand = true;
         OrchestratorQueue* m_currentQueue = nullptr;
+        OrchestratorQueueItemPriority m_priority = OrchestratorQueueItemPriority::Normal;
+        DWORD m_callerProcessId = 0;
+        uint64_t m_queuedRunSequence = 0;
+    };
+
+    // Chooses which of the waiting items in a queue runs next.
+    // Items run in priority order, taking turns between the processes that requested them, then in the order they were queued.
+    // So that a steady stream of items cannot starve those of a lower priority, a waiting item is treated as one priority
+    // higher for every AgingRunCount items that start ahead of it.
+    struct OrchestratorQueueScheduler
+    {
+        // The number of items that start ahead of a waiting item before its priority is raised.
+        static constexpr uint64_t AgingRunCount = 8;
+
+        // Records that an item is waiting to run.
+        void OnItemQueued(OrchestratorQueueItem& item) const;
+
+        // Selects the item that should run next, if there is one; cancelled items are selected first so that they can be removed.
+        std::shared_ptr<OrchestratorQueueItem> SelectNextItem(const std::list<std::shared_ptr<OrchestratorQueueItem>>& items) const;
+
+        // Records that an item has started running.
+        void OnItemStarted(const OrchestratorQueueItem& item);
+
+        // The priority that a waiting item is treated as having, once it is raised for the items that started ahead of it.
+        uint64_t GetEffectivePriority(const OrchestratorQueueItem& item) const;
+
+        // Determines whether a running item should pause at its next safe point, so that its thread can be lent to a waiting
+        // item of a higher priority; pausedCount is the number of running items that are already paused.
+        bool ShouldPause(const std::list<std::shared_ptr<OrchestratorQueueItem>>& items, const OrchestratorQueueItem& running, UINT32 allowedThreads, UINT32 pausedCount) const;
+
+    private:
+        uint64_t GetCallerLastRun(const OrchestratorQueueItem& item) const;
+
+        // For each caller, the sequence number of the last item it had started, so callers can take turns.
+        uint64_t m_runSequence = 0;
+        std::map<DWORD, uint64_t> m_callerLastRun;
+    };
+
+    // An index of the items in the orchestrator by their id.
+    // Lookups only take a shared lock, so that callers polling for progress do not contend with each other
+    // or with the queues as they run items.
+    struct OrchestratorQueueItemIndex
+    {
+        // Adds an item, returning false if an item with the same id is already in the index.
+        bool Add(std::shared_ptr<OrchestratorQueueItem> item);
+
+        // Removes the item, if it is the one in the index for its id.
+        void Remove(const OrchestratorQueueItem& item);
+
+        std::shared_ptr<OrchestratorQueueItem> Find(const OrchestratorQueueItemId& id) const;
+
+        size_t Size() const;
+
+    private:
+        mutable wil::srwlock m_lock;
+        std::unordered_map<OrchestratorQueueItemId, std::shared_ptr<OrchestratorQueueItem>, OrchestratorQueueItemIdHash> m_items;
     };
 
     struct OrchestratorQueueItemFactory
@@ -95,24 +235,33 @@ namespace AppInstaller::CLI::Execution
         void AddItemManifestToInstallingSource(const OrchestratorQueueItem& queueItem);
         void RemoveItemManifestFromInstallingSource(const OrchestratorQueueItem& queueItem);
 
+        // Called by a queue when an item has been removed from the orchestrator.
+        void OnItemRemoved(const OrchestratorQueueItem& queueItem);
+
     private:
-        std::mutex m_queueLock;
-        void AddCommandQueue(std::string_view commandName, UINT32 allowedThreads);
+        void AddCommandQueue(std::string_view commandName, UINT32 allowedThreads, bool allowsPreemption, UINT32 maximumThreads = 0);
         void RemoveItemInState(const OrchestratorQueueItem& item, OrchestratorQueueItemState state);
 
-        _Requires_lock_held_(m_queueLock)
-        std::shared_ptr<OrchestratorQueueItem> FindById(const OrchestratorQueueItemId& queueItemId);
-
         Repository::Source m_installingWriteableSource;
+
+        // The queues are only added to by the constructor, so they can be read without a lock.
         std::map<std::string, std::unique_ptr<OrchestratorQueue>> m_commandQueues;
+
+        // Every item that is in one of the queues, or is moving between them.
+        OrchestratorQueueItemIndex m_items;
     };
 
     // One of the queues used by the orchestrator.
     // All items in the queue execute the same command.
     // The queue allows multiple items to run at the same time, up to a limit.
+    // Waiting items run in the order chosen by an OrchestratorQueueScheduler.
+    // If the queue allows preemption, a running item pauses at its next safe point (a download between chunks, with its
+    // connection closed) while an item of a higher priority is waiting for a thread, and its thread is lent to that item
+    // until there is room for both.
     struct OrchestratorQueue
     {
-        OrchestratorQueue(std::string_view commandName, UINT32 allowedThreads);
+        // If maximumThreads is larger than allowedThreads, the number of threads is adjusted to the throughput of the items' downloads.
+        OrchestratorQueue(std::string_view commandName, UINT32 allowedThreads, bool allowsPreemption, UINT32 maximumThreads = 0);
         ~OrchestratorQueue();
 
         // Name of the command this queue can execute
@@ -126,24 +275,49 @@ namespace AppInstaller::CLI::Execution
         // The item can be removed globally from the orchestrator, or from just this queue.
         bool RemoveItemInState(const OrchestratorQueueItem& item, OrchestratorQueueItemState state, bool isGlobalRemove);
 
-        // Finds an item by id, if it is in the queue.
+        // Runs the next item from the queue.
+        void RunNextItem();
+
+    private:
+        // Determines whether an item of a higher priority is waiting to run.
         _Requires_lock_held_(m_queueLock)
-        std::shared_ptr<OrchestratorQueueItem> FindById(const OrchestratorQueueItemId& queueItemId);
+        bool IsHigherPriorityItemQueued(OrchestratorQueueItemPriority priority) const;
 
-        // Runs a single item from the queue.
-        void RunItem(const OrchestratorQueueItemId& itemId);
+        // Determines whether all of the threads are taken by items that are running and not paused.
+        _Requires_lock_held_(m_queueLock)
+        bool AreAllThreadsBusy() const;
+
+        // Determines whether the running item should pause at its next safe point.
+        bool IsPreemptionRequested(const OrchestratorQueueItem& item);
+
+        // Pauses the running item, which is at a safe point, while an item of a higher priority needs its thread.
+        void WaitWhilePreempted(const OrchestratorQueueItem& item);
+
+        // Called as a running item makes progress.
+        void OnItemProgress(const OrchestratorQueueItem& item, uint64_t current, ProgressType type);
+
+        // Adjusts the number of threads to the throughput that the running downloads achieve.
+        _Requires_lock_held_(m_queueLock)
+        void AdjustConcurrency(const OrchestratorQueueItem& item, uint64_t bytesReceived);
 
-    private:
         // Enqueues an item.
         void EnqueueItem(std::shared_ptr<OrchestratorQueueItem> item);
 
+        using QueueItems = std::list<std::shared_ptr<OrchestratorQueueItem>>;
+
         _Requires_lock_held_(m_queueLock)
-        std::deque<std::shared_ptr<OrchestratorQueueItem>>::iterator FindIteratorById(const OrchestratorQueueItemId& comparisonQueueItemId);
+        QueueItems::iterator FindIteratorById(const OrchestratorQueueItemId& comparisonQueueItemId);
 
         std::string_view m_commandName;
 
         // Number of threads allowed to run items in this queue.
-        const UINT32 m_allowedThreads;
+        UINT32 m_allowedThreads;
+
+        // Adjusts m_allowedThreads, if the queue's concurrency is adaptive.
+        std::optional<DownloadConcurrencyController> m_concurrencyController;
+
+        // Whether running items can be paused for items of a higher priority.
+        const bool m_allowsPreemption;
 
         // Thread pool for this queue, and associated objects.
         // All work items will be added to the callback environment, and the cleanup group
@@ -153,7 +327,17 @@ namespace AppInstaller::CLI::Execution
         wil::unique_any<PTP_POOL, decltype(CloseThreadpool), CloseThreadpool> m_threadPool;
         wil::unique_any<PTP_CLEANUP_GROUP, decltype(CloseThreadpoolCleanupGroup), CloseThreadpoolCleanupGroup> m_threadPoolCleanupGroup;
 
-        std::mutex m_queueLock;
-        std::deque<std::shared_ptr<OrchestratorQueueItem>> m_queueItems;
+        OrchestratorQueueMutex m_queueLock;
+
+        // The items in the order that they were queued, and an index into them by id.
+        QueueItems m_queueItems;
+        std::unordered_map<OrchestratorQueueItemId, QueueItems::iterator, OrchestratorQueueItemIdHash> m_queueItemsById;
+
+        // Chooses the order that the waiting items run in.
+        OrchestratorQueueScheduler m_scheduler;
+
+        // The number of running items that are paused, and the signal that one may be able to continue.
+        UINT32 m_preemptedItems = 0;
+        std::condition_variable_any m_preemptionChanged;
     };
 }
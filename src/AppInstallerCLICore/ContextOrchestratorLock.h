@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace AppInstaller::CLI::Execution
+{
+    // The time that threads have waited for the queue locks of the orchestrator, across all of its queues.
+    struct OrchestratorLockStatistics
+    {
+        uint64_t Acquisitions = 0;
+        // The acquisitions that had to wait for another thread to release the lock.
+        uint64_t ContendedAcquisitions = 0;
+        std::chrono::microseconds TotalWait{};
+        std::chrono::microseconds MaximumWait{};
+    };
+
+    // Gets the statistics since the process started.
+    // This header does not depend on the rest of the orchestrator, so that test hosts can include it to read them.
+    OrchestratorLockStatistics GetOrchestratorLockStatistics();
+
+    // The lock of an orchestrator queue, which records how long threads wait for it in the statistics.
+    // Only a contended acquisition reads the clock.
+    struct OrchestratorQueueMutex
+    {
+        OrchestratorQueueMutex() = default;
+
+        OrchestratorQueueMutex(const OrchestratorQueueMutex&) = delete;
+        OrchestratorQueueMutex& operator=(const OrchestratorQueueMutex&) = delete;
+
+        void lock();
+        bool try_lock();
+        void unlock();
+
+    private:
+        std::mutex m_mutex;
+    };
+}
@@ -8,6 +8,14 @@
 #include <winget/UserSettings.h>
 #include "Commands/InstallCommand.h"
 #include "COMContext.h"
+#include <winget/AllocationTracking.h>
+#include <winget/MemoryTrim.h>
+#include <winget/Timing.h>
+#include <AppInstallerFileLogger.h>
+#include <ShlObj.h>
+#include <json.h>
+#include <wil/resource.h>
+#include <wil/win32_helpers.h>
 
 #ifndef AICLI_DISABLE_TEST_HOOKS
 #include <winget/Debugging.h>
@@ -22,6 +30,9 @@ namespace AppInstaller::CLI
 {
     namespace
     {
+        // How long the server waits without calls before it releases the memory its caches hold.
+        constexpr std::chrono::minutes s_ServerIdleTrimPeriod = std::chrono::minutes(5);
+
         // RAII class to restore the console output codepage.
         struct ConsoleOutputCPRestore
         {
@@ -45,11 +56,181 @@ namespace AppInstaller::CLI
         private:
             UINT m_previousCP = 0;
         };
+
+        // Quotes an argument so that CommandLineToArgvW yields it unchanged.
+        std::wstring QuoteCommandLineArgument(std::wstring_view argument)
+        {
+            std::wstring result{ L'"' };
+            size_t backslashes = 0;
+
+            for (wchar_t c : argument)
+            {
+                if (c == L'\\')
+                {
+                    ++backslashes;
+                    continue;
+                }
+
+                // Backslashes are only special before a quote, where each must be doubled.
+                result.append(c == L'"' ? backslashes * 2 + 1 : backslashes, L'\\');
+                backslashes = 0;
+                result += c;
+            }
+
+            result.append(backslashes * 2, L'\\');
+            result += L'"';
+            return result;
+        }
+
+        // Gets the executable to start for another invocation of this program.
+        std::filesystem::path GetExecutablePathForNewProcess()
+        {
+            if (Runtime::IsRunningInPackagedContext())
+            {
+                // The package's own executable does not run with package identity; its alias does.
+                wil::unique_cotaskmem_string localAppData;
+                THROW_IF_FAILED(SHGetKnownFolderPath(FOLDERID_LocalAppData, KF_FLAG_DONT_VERIFY, NULL, &localAppData));
+                return std::filesystem::path{ localAppData.get() } / L"Microsoft\\WindowsApps\\winget.exe";
+            }
+
+            return std::filesystem::path{ wil::GetModuleFileNameW<std::wstring>(nullptr) };
+        }
+
+        // Updates the source in a new process, as the data of the source can only be replaced once this one stops reading it.
+        void UpdateSourceInNewProcess(const Repository::SourceDetails& details)
+        {
+            std::wstring commandLine = QuoteCommandLineArgument(GetExecutablePathForNewProcess().native());
+            commandLine += L" source update --name ";
+            commandLine += QuoteCommandLineArgument(Utility::ConvertToUTF16(details.Name));
+            commandLine += L" --background-update";
+
+            STARTUPINFOW startupInfo{};
+            startupInfo.cb = sizeof(startupInfo);
+            wil::unique_process_information processInfo;
+
+            THROW_IF_WIN32_BOOL_FALSE(CreateProcessW(nullptr, &commandLine[0], nullptr, nullptr, FALSE,
+                CREATE_NO_WINDOW | CREATE_NEW_PROCESS_GROUP, nullptr, nullptr, &startupInfo, &processInfo));
+
+            AICLI_LOG(CLI, Info, << "Started process " << processInfo.dwProcessId << " to update source: " << details.Name);
+        }
+
+        // Writes the time at which each startup step completed, as JSON, for the startup measurement script to collect.
+        void WriteStartupTrace(const std::filesystem::path& path)
+        {
+            Json::Value steps{ Json::ValueType::objectValue };
+            for (const auto& step : Timing::GetStartupSteps())
+            {
+                steps[std::string{ Timing::ToString(step.Step) }] = static_cast<Json::Int64>(step.SinceProcessCreation.count());
+            }
+
+            Json::Value json{ Json::ValueType::objectValue };
+            json["formatVersion"] = 1;
+            json["processId"] = static_cast<Json::UInt>(GetCurrentProcessId());
+            json["stepMicroseconds"] = std::move(steps);
+
+            Json::StreamWriterBuilder writerBuilder;
+            std::ofstream stream{ path, std::ios_base::out | std::ios_base::trunc };
+            stream << Json::writeString(writerBuilder, json) << std::endl;
+        }
+
+        // Writes the resources used by the command, as JSON, next to the log file of the command.
+        void WriteResourceReport(const std::filesystem::path& logFilePath, std::string_view command, HRESULT result, std::chrono::microseconds duration)
+        {
+            Timing::ResourceUsage usage = Timing::GetUsage();
+
+            Json::Value tasks{ Json::ValueType::arrayValue };
+            for (const auto& task : usage.WorkflowTasks)
+            {
+                Json::Value value{ Json::ValueType::objectValue };
+                value["name"] = task.Name;
+                value["count"] = static_cast<Json::UInt64>(task.Count);
+                value["durationMicroseconds"] = static_cast<Json::Int64>(task.Duration.count());
+                tasks.append(std::move(value));
+            }
+
+            Json::Value phases{ Json::ValueType::objectValue };
+            for (const auto& total : Timing::GetTotals())
+            {
+                Json::Value value{ Json::ValueType::objectValue };
+                value["count"] = static_cast<Json::UInt64>(total.Count);
+                value["durationMicroseconds"] = static_cast<Json::Int64>(total.Duration.count());
+                phases[std::string{ Timing::ToString(total.Phase) }] = std::move(value);
+            }
+
+            Json::Value sql{ Json::ValueType::objectValue };
+            sql["executions"] = static_cast<Json::UInt64>(usage.SqlExecutions);
+            sql["steps"] = static_cast<Json::UInt64>(usage.SqlSteps);
+            sql["stepMicroseconds"] = static_cast<Json::Int64>(usage.SqlStepTime.count());
+
+            Json::Value downloadedBytes{ Json::ValueType::objectValue };
+            for (const auto& download : usage.DownloadedBytes)
+            {
+                downloadedBytes[download.first] = static_cast<Json::UInt64>(download.second);
+            }
+
+            Json::Value httpRequests{ Json::ValueType::objectValue };
+            for (const auto& host : usage.HttpRequests)
+            {
+                httpRequests[host.first] = static_cast<Json::UInt64>(host.second);
+            }
+
+            Json::Value caches{ Json::ValueType::objectValue };
+            for (const auto& cache : usage.Caches)
+            {
+                uint64_t lookups = cache.second.Hits + cache.second.Misses;
+
+                Json::Value value{ Json::ValueType::objectValue };
+                value["hits"] = static_cast<Json::UInt64>(cache.second.Hits);
+                value["misses"] = static_cast<Json::UInt64>(cache.second.Misses);
+                value["hitRate"] = lookups ? static_cast<double>(cache.second.Hits) / lookups : 0.0;
+                caches[cache.first] = std::move(value);
+            }
+
+            // Only instrumented builds track allocations.
+            Json::Value allocations{ Json::ValueType::objectValue };
+            for (const auto& counts : Memory::GetAllocationCounts())
+            {
+                Json::Value value{ Json::ValueType::objectValue };
+                value["allocations"] = static_cast<Json::UInt64>(counts.Allocations);
+                value["frees"] = static_cast<Json::UInt64>(counts.Frees);
+                value["liveBytes"] = static_cast<Json::Int64>(counts.LiveBytes);
+                value["peakLiveBytes"] = static_cast<Json::Int64>(counts.PeakLiveBytes);
+                allocations[std::string{ Memory::ToString(counts.Subsystem) }] = std::move(value);
+            }
+
+            Json::Value json{ Json::ValueType::objectValue };
+            json["formatVersion"] = 1;
+            json["processId"] = static_cast<Json::UInt>(GetCurrentProcessId());
+            json["command"] = std::string{ command };
+            json["result"] = static_cast<Json::Int>(result);
+            json["durationMicroseconds"] = static_cast<Json::Int64>(duration.count());
+            json["peakWorkingSetBytes"] = static_cast<Json::UInt64>(usage.PeakWorkingSetBytes);
+            json["bytesReceived"] = static_cast<Json::UInt64>(Utility::GetBytesReceived());
+            json["workflowTasks"] = std::move(tasks);
+            json["phases"] = std::move(phases);
+            json["sql"] = std::move(sql);
+            json["downloadedBytes"] = std::move(downloadedBytes);
+            json["httpRequests"] = std::move(httpRequests);
+            json["caches"] = std::move(caches);
+            json["allocations"] = std::move(allocations);
+
+            std::filesystem::path path = logFilePath;
+            path.replace_extension(L".resources.json");
+
+            Json::StreamWriterBuilder writerBuilder;
+            std::ofstream stream{ path, std::ios_base::out | std::ios_base::trunc };
+            stream << Json::writeString(writerBuilder, json) << std::endl;
+
+            AICLI_LOG(CLI, Info, << "Wrote the resources report to: " << path.u8string());
+        }
     }
 
     int CoreMain(int argc, wchar_t const** argv) try
     {
+        Timing::RecordStartupStep(Timing::StartupStep::CoreMainEntered);
+
         init_apartment();
+        Timing::RecordStartupStep(Timing::StartupStep::ApartmentInitialized);
 
 #ifndef AICLI_DISABLE_TEST_HOOKS
         if (Settings::User().Get<Settings::Setting::EnableSelfInitiatedMinidump>())
@@ -60,24 +241,52 @@ namespace AppInstaller::CLI
 
         Logging::UseGlobalTelemetryLoggerActivityIdOnly();
 
+        // Shells run the complete command on each keypress, so it skips the setup that only matters
+        // to the other commands: it writes no log file and sends no telemetry.
+        const bool isCompletion = (argc > 1 && std::wstring_view{ argv[1] } == L"complete");
+
         Execution::Context context{ std::cout, std::cin };
         auto previousThreadGlobals = context.SetForCurrentThread();
         context.EnableCtrlHandler();
+        Timing::RecordStartupStep(Timing::StartupStep::ContextCreated);
+
+        std::optional<Logging::DisableTelemetryScope> disableTelemetry;
+        if (isCompletion)
+        {
+            disableTelemetry.emplace();
+        }
 
         // Enable all logging for this phase; we will update once we have the arguments
         Logging::Log().EnableChannel(Logging::Channel::All);
         Logging::Log().SetLevel(Logging::Level::Info);
-        Logging::AddFileLogger();
-        Logging::EnableWilFailureTelemetry();
+
+        // The path of the log is kept for the resources report, which is written next to it.
+        std::filesystem::path logFilePath;
+
+        if (!isCompletion)
+        {
+            auto fileLogger = std::make_unique<Logging::FileLogger>();
+            logFilePath = fileLogger->GetFilePath();
+            Logging::Log().AddLogger(std::move(fileLogger));
+            Logging::EnableWilFailureTelemetry();
+        }
+        Timing::RecordStartupStep(Timing::StartupStep::LoggingInitialized);
 
         // Set output to UTF8
         ConsoleOutputCPRestore utf8CP(CP_UTF8);
 
-        Logging::Telemetry().SetCaller("winget-cli");
-        Logging::Telemetry().LogStartup();
+        if (!isCompletion)
+        {
+            Logging::Telemetry().SetCaller("winget-cli");
+            Logging::Telemetry().LogStartup();
+
+            // Initiate the background cleanup of the log file location.
+            Logging::BeginLogFileCleanup();
 
-        // Initiate the background cleanup of the log file location.
-        Logging::BeginLogFileCleanup();
+            // A thread in this process would not outlive the command, so stale sources are updated by another process.
+            Repository::Source::SetBackgroundUpdateHandler(UpdateSourceInNewProcess);
+        }
+        Timing::RecordStartupStep(Timing::StartupStep::TelemetryInitialized);
 
         context << Workflow::ReportExecutionStage(Workflow::ExecutionStage::ParseArgs);
 
@@ -111,6 +320,7 @@ namespace AppInstaller::CLI
                 subCommand = command->FindSubCommand(invocation);
             }
             Logging::Telemetry().LogCommand(command->FullName());
+            Timing::RecordStartupStep(Timing::StartupStep::CommandFound);
 
             command->ParseArguments(invocation, context.Args);
 
@@ -120,9 +330,21 @@ namespace AppInstaller::CLI
                 Logging::Log().SetLevel(Logging::Level::Verbose);
             }
 
+            if (context.Args.Contains(Execution::Args::Type::Timings))
+            {
+                Timing::EnableTotals();
+            }
+
+            if (context.Args.Contains(Execution::Args::Type::ResourceReport))
+            {
+                Timing::EnableTotals();
+                Timing::EnableUsage();
+            }
+
             context.UpdateForArgs();
 
             command->ValidateArguments(context.Args);
+            Timing::RecordStartupStep(Timing::StartupStep::ArgumentsValidated);
         }
         // Exceptions specific to parsing the arguments of a command
         catch (const CommandException& ce)
@@ -140,7 +362,33 @@ namespace AppInstaller::CLI
             return APPINSTALLER_CLI_ERROR_BLOCKED_BY_POLICY;
         }
 
-        return Execute(context, command);
+        auto executeStart = std::chrono::steady_clock::now();
+        int result = Execute(context, command);
+        auto executeDuration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - executeStart);
+        Timing::RecordStartupStep(Timing::StartupStep::CommandExecuted);
+        Memory::TraceAllocationCounts();
+
+        if (context.Args.Contains(Execution::Args::Type::StartupTrace))
+        {
+            try
+            {
+                WriteStartupTrace(Utility::ConvertToUTF16(context.Args.GetArg(Execution::Args::Type::StartupTrace)));
+            }
+            CATCH_LOG();
+        }
+
+        if (context.Args.Contains(Execution::Args::Type::ResourceReport) && !logFilePath.empty())
+        {
+            try
+            {
+                WriteResourceReport(logFilePath, command->FullName(), result, executeDuration);
+            }
+            CATCH_LOG();
+        }
+
+        Repository::Source::WaitForBackgroundUpdates();
+
+        return result;
     }
     // End of the line exceptions that are not ever expected.
     // Telemetry cannot be reliable beyond this point, so don't let these happen.
@@ -152,5 +400,24 @@ namespace AppInstaller::CLI
     void ServerInitialize()
     {
         AppInstaller::CLI::Execution::COMContext::SetLoggers();
+
+        // The server is long lived, so pick up changes to the settings while it runs.
+        try
+        {
+            Settings::UserSettings::ReloadOnFileChange();
+        }
+        CATCH_LOG();
+
+        // Clients may hold the server for a long time without using it, as with many sessions on one host.
+        try
+        {
+            Memory::EnableIdleTrim(s_ServerIdleTrimPeriod);
+        }
+        CATCH_LOG();
+    }
+
+    void ServerShutdown()
+    {
+        Repository::Source::WaitForBackgroundUpdates();
     }
 }
@@ -47,6 +47,7 @@ namespace AppInstaller::CLI::Execution
             SourceType,
             SourceArg,
             ForceSourceReset,
+            SourceBackgroundUpdate, // Runs a background update that another invocation handed to this one
 
             //Hash Command
             HashFile,
@@ -54,6 +55,7 @@ namespace AppInstaller::CLI::Execution
 
             //Validate Command
             ValidateManifest,
+            ValidateRecurse, // Validates every manifest directory under the given paths
 
             // Complete Command
             Word,
@@ -68,6 +70,7 @@ namespace AppInstaller::CLI::Execution
             ImportFile,
             IgnoreUnavailable,
             IgnoreVersions,
+            ImportStream,
 
             // Setting Command
             AdminSettingEnable,
@@ -82,10 +85,15 @@ namespace AppInstaller::CLI::Execution
             Help, // Show command usage
             Info, // Show general info about WinGet
             VerboseLogs, // Increases winget logging level to verbose
+            Timings, // Displays the time spent in each phase of the command
+            StartupTrace, // Writes the time at which each step of startup completed to a file
+            ResourceReport, // Writes the resources used by the command to a file next to the log
             DependencySource, // Index source to be queried against for finding dependencies
             CustomHeader, // Optional Rest source header
             AcceptSourceAgreements, // Accept all source agreements
             IncludeUnknown, // Used in Upgrade command to allow upgrades of packages with unknown versions
+            UpgradeSummary, // Used in Upgrade command to list only the ids and count of the available upgrades
+            OutputFormat, // The format for the results of list, search and upgrade: table, json or csv
 
             // Used for demonstration purposes
             ExperimentalArg,
@@ -142,7 +150,7 @@ namespace AppInstaller::CLI::Execution
             return m_parsedArgs.size();
         }
 
-        std::vector<Type> GetTypes()
+        std::vector<Type> GetTypes() const
         {
             std::vector<Type> types;
 
@@ -4,6 +4,7 @@
 #include "ExecutionContext.h"
 #include "COMContext.h"
 #include "winget/UserSettings.h"
+#include <AppInstallerFileLogger.h>
 
 namespace AppInstaller::CLI::Execution
 {
@@ -88,6 +89,12 @@ namespace AppInstaller::CLI::Execution
                     }
                 }
 
+                if (force)
+                {
+                    // The process may be ended soon after this returns, so write out the log records now.
+                    Logging::FileLogger::FlushAll(std::chrono::seconds(1));
+                }
+
                 return TRUE;
             }
 
@@ -191,6 +198,9 @@ namespace AppInstaller::CLI::Execution
     {
         Terminate(exitIfStuck ? APPINSTALLER_CLI_ERROR_CTRL_SIGNAL_RECEIVED : E_ABORT);
         Reporter.CancelInProgressTask(bypassUser);
+
+        // Interrupts the long running operations, like queries, of the work on this context's threads.
+        m_threadGlobals.Cancel();
     }
 
     void Context::SetExecutionStage(Workflow::ExecutionStage stage)
@@ -59,6 +59,10 @@ namespace AppInstaller::CLI::Execution
         // TODO: Remove when the source interface is refactored.
         TreatSourceFailuresAsWarning = 0x10,
         ShowSearchResultsOnPartialFailure = 0x20,
+        // Keeps sources from being updated when they are opened, even if they are past their update interval.
+        DisableBackgroundSourceUpdate = 0x40,
+        // The MSIX installer has been staged ahead of its install, which then only registers it.
+        InstallerStaged = 0x80,
     };
 
     DEFINE_ENUM_FLAG_OPERATORS(ContextFlag);
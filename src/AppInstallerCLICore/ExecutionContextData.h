@@ -14,6 +14,11 @@
 #include <variant>
 #include <vector>
 
+namespace AppInstaller::CLI::Workflow
+{
+    struct ARPEntriesCache;
+    struct StagedMsixPackage;
+}
 
 namespace AppInstaller::CLI::Execution
 {
@@ -47,9 +52,17 @@ namespace AppInstaller::CLI::Execution
         // On import: Sources for the imported packages
         Sources,
         ARPSnapshot,
+        // On install of an MSI: The product code of the installer and whether it was installed before
+        MsiProductSnapshot,
+        // On install of multiple packages: The ARP entries shared by the packages while ARP is unchanged
+        ARPEntriesCache,
         Dependencies,
         DependencySource,
         AllowedArchitectures,
+        // On dependencies install: The level in the dependency graph of each of the PackagesToInstall
+        PackagesToInstallLevels,
+        // On install of an MSIX that was staged ahead of it: The staged package, removed unless it is registered
+        StagedMsixPackage,
         Max
     };
 
@@ -190,6 +203,19 @@ namespace AppInstaller::CLI::Execution
             using value_t = std::vector<std::tuple<Utility::LocIndString, Utility::LocIndString, Utility::LocIndString>>;
         };
 
+        template <>
+        struct DataMapping<Data::MsiProductSnapshot>
+        {
+            // Contains the { ProductCode, WasInstalled }
+            using value_t = std::pair<std::string, bool>;
+        };
+
+        template <>
+        struct DataMapping<Data::ARPEntriesCache>
+        {
+            using value_t = std::shared_ptr<Workflow::ARPEntriesCache>;
+        };
+
         template <>
         struct DataMapping<Data::Dependencies>
         {
@@ -207,5 +233,17 @@ namespace AppInstaller::CLI::Execution
         {
             using value_t = std::vector<Utility::Architecture>;
         };
+
+        template <>
+        struct DataMapping<Data::PackagesToInstallLevels>
+        {
+            using value_t = std::vector<size_t>;
+        };
+
+        template <>
+        struct DataMapping<Data::StagedMsixPackage>
+        {
+            using value_t = std::shared_ptr<Workflow::StagedMsixPackage>;
+        };
     }
 }
@@ -11,6 +11,9 @@ namespace AppInstaller::CLI::Execution
 
     namespace
     {
+        // The time between redraws of the progress bar.
+        constexpr DWORD s_ProgressRenderIntervalMilliseconds = 100;
+
         struct BytesFormatData
         {
             uint64_t PowerOfTwo;
@@ -213,13 +216,78 @@ namespace AppInstaller::CLI::Execution
             {
                 m_out << Progress::Construct(Progress::State::None);
             }
+
+            m_out << std::flush;
         }
 
         m_canceled = false;
         m_spinnerRunning = false;
     }
 
+    ProgressBar::~ProgressBar()
+    {
+        try
+        {
+            StopRendering();
+        }
+        CATCH_LOG();
+    }
+
     void ProgressBar::ShowProgress(uint64_t current, uint64_t maximum, ProgressType type)
+    {
+        m_current = current;
+        m_maximum = maximum;
+        m_type = type;
+        m_updateCount.fetch_add(1);
+
+        if (!m_rendering)
+        {
+            std::lock_guard<std::mutex> lock{ m_renderJobLock };
+            if (!m_rendering)
+            {
+                m_stopRendering.ResetEvent();
+                m_renderJob = std::async(std::launch::async, &ProgressBar::RenderLoop, this);
+                m_rendering = true;
+            }
+        }
+    }
+
+    void ProgressBar::RenderLoop()
+    {
+        do
+        {
+            RenderPendingUpdate();
+        } while (!m_stopRendering.wait(s_ProgressRenderIntervalMilliseconds));
+    }
+
+    void ProgressBar::StopRendering()
+    {
+        std::lock_guard<std::mutex> lock{ m_renderJobLock };
+        if (m_rendering)
+        {
+            m_stopRendering.SetEvent();
+            m_rendering = false;
+            m_renderJob.get();
+        }
+    }
+
+    void ProgressBar::RenderPendingUpdate()
+    {
+        std::lock_guard<std::mutex> lock{ m_renderLock };
+
+        uint64_t updateCount = m_updateCount;
+        if (updateCount == m_renderedUpdateCount)
+        {
+            return;
+        }
+
+        // The values are read separately, so a frame drawn during an update may mix it with the one
+        // before; the next frame draws the update completely.
+        Render(m_current, m_maximum, m_type);
+        m_renderedUpdateCount = updateCount;
+    }
+
+    void ProgressBar::Render(uint64_t current, uint64_t maximum, ProgressType type)
     {
         if (current < m_lastCurrent)
         {
@@ -235,12 +303,23 @@ namespace AppInstaller::CLI::Execution
             ShowProgressNoVT(current, maximum, type);
         }
 
+        // Each redraw is written as a whole, so that it does not tear
+        m_out << std::flush;
+
         m_lastCurrent = current;
         m_isVisible = true;
     }
 
     void ProgressBar::EndProgress(bool hideProgressWhenDone)
     {
+        StopRendering();
+
+        if (!hideProgressWhenDone)
+        {
+            // Draw the final values, so that the bar left behind shows where progress ended.
+            RenderPendingUpdate();
+        }
+
         if (m_isVisible)
         {
             if (hideProgressWhenDone)
@@ -260,6 +339,7 @@ namespace AppInstaller::CLI::Execution
                 m_out << Progress::Construct(Progress::State::None);
             }
 
+            m_out << std::flush;
             m_isVisible = false;
         }
     }
@@ -387,4 +467,175 @@ namespace AppInstaller::CLI::Execution
             }
         }
     }
+
+    void MultiLineProgress::Line::OnProgress(uint64_t current, uint64_t maximum, ProgressType type)
+    {
+        Current = current;
+        Maximum = maximum;
+        Type = type;
+    }
+
+    MultiLineProgress::MultiLineProgress(BaseStream& stream, bool enableVT, const std::vector<std::string>& labels) :
+        details::ProgressVisualizerBase(stream, enableVT)
+    {
+        for (const auto& label : labels)
+        {
+            m_lines.emplace_back(std::make_unique<Line>(label));
+            m_labelWidth = std::max(m_labelWidth, Utility::UTF8Length(label));
+        }
+    }
+
+    MultiLineProgress::~MultiLineProgress()
+    {
+        try
+        {
+            StopRendering();
+        }
+        CATCH_LOG();
+    }
+
+    void MultiLineProgress::Begin()
+    {
+        if (UseVT() && !m_renderJob.valid())
+        {
+            m_renderJob = std::async(std::launch::async, &MultiLineProgress::RenderLoop, this);
+        }
+    }
+
+    ProgressCallback& MultiLineProgress::GetCallback(size_t index)
+    {
+        return m_lines.at(index)->Callback;
+    }
+
+    void MultiLineProgress::Complete(size_t index, std::string result)
+    {
+        std::lock_guard<std::mutex> lock{ m_renderLock };
+
+        Line& line = *m_lines.at(index);
+        line.Result = std::move(result);
+
+        if (!UseVT())
+        {
+            // Nothing is redrawn without VT, so each line is only written once it has its result.
+            RenderLine(line);
+            m_out << std::flush;
+        }
+    }
+
+    void MultiLineProgress::Cancel()
+    {
+        for (auto& line : m_lines)
+        {
+            line->Callback.Cancel();
+        }
+    }
+
+    void MultiLineProgress::End()
+    {
+        StopRendering();
+
+        if (UseVT())
+        {
+            // Draw the final state, so that the lines left behind show where each operation ended.
+            std::lock_guard<std::mutex> lock{ m_renderLock };
+            Render();
+        }
+    }
+
+    void MultiLineProgress::RenderLoop()
+    {
+        do
+        {
+            std::lock_guard<std::mutex> lock{ m_renderLock };
+            Render();
+        } while (!m_stopRendering.wait(s_ProgressRenderIntervalMilliseconds));
+    }
+
+    void MultiLineProgress::StopRendering()
+    {
+        if (m_renderJob.valid())
+        {
+            m_stopRendering.SetEvent();
+            m_renderJob.get();
+        }
+    }
+
+    void MultiLineProgress::Render()
+    {
+        if (m_isVisible)
+        {
+            // Return to the first line to draw over the previous frame.
+            for (size_t i = 0; i < m_lines.size(); ++i)
+            {
+                m_out << Cursor::Position::UpOne;
+            }
+        }
+
+        for (const auto& line : m_lines)
+        {
+            m_out << '\r' << TextModification::EraseLineEntirely;
+            RenderLine(*line);
+        }
+
+        // Each redraw is written as a whole, so that it does not tear
+        m_out << std::flush;
+
+        m_isVisible = true;
+        ++m_frame;
+    }
+
+    void MultiLineProgress::RenderLine(const Line& line)
+    {
+        m_out << "  " << line.Label << std::string(m_labelWidth - Utility::UTF8Length(line.Label) + 2, ' ');
+
+        if (line.Result)
+        {
+            m_out << line.Result.value() << '\n';
+            return;
+        }
+
+        uint64_t current = line.Current;
+        uint64_t maximum = line.Maximum;
+        ProgressType type = line.Type;
+
+        if (maximum)
+        {
+            const char* const blockOn = u8"\x2588";
+            constexpr size_t blockWidth = 20;
+
+            double percentage = static_cast<double>(std::min(current, maximum)) / maximum;
+            size_t blocksOn = static_cast<size_t>(std::floor(percentage * blockWidth));
+
+            for (size_t i = 0; i < blockWidth; ++i)
+            {
+                ApplyStyle(i, blockWidth, i < blocksOn);
+                m_out << blockOn;
+            }
+
+            m_out << TextFormat::Default << "  ";
+
+            if (type == ProgressType::Bytes)
+            {
+                OutputBytes(m_out, current);
+                m_out << " / ";
+                OutputBytes(m_out, maximum);
+            }
+            else
+            {
+                m_out << static_cast<int>(percentage * 100) << '%';
+            }
+        }
+        else if (type == ProgressType::Bytes)
+        {
+            OutputBytes(m_out, current);
+        }
+        else
+        {
+            // Nothing measurable has been reported yet.
+            constexpr char spinnerChars[] = { '-', '\\', '|', '/' };
+            m_out << spinnerChars[m_frame % ARRAYSIZE(spinnerChars)];
+        }
+
+        m_out << '\n';
+    }
 }
@@ -11,6 +11,9 @@
 #include <atomic>
 #include <future>
 #include <istream>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -59,22 +62,55 @@ namespace AppInstaller::CLI::Execution
         void ShowSpinnerInternal();
     };
 
-    // Displays progress 
+    // Displays progress.
+    // Updates only record the latest values; a renderer thread draws them at a fixed rate so that
+    // the thread reporting progress never waits on console output.
     class ProgressBar : public details::ProgressVisualizerBase
     {
     public:
         ProgressBar(BaseStream& stream, bool enableVT) :
             details::ProgressVisualizerBase(stream, enableVT) {}
 
+        ProgressBar(const ProgressBar&) = delete;
+        ProgressBar& operator=(const ProgressBar&) = delete;
+
+        ~ProgressBar();
+
         void ShowProgress(uint64_t current, uint64_t maximum, ProgressType type);
 
         void EndProgress(bool hideProgressWhenDone);
 
         void SetStyle(AppInstaller::Settings::VisualStyle style) { m_style = style; }
 
+        // Whether the renderer thread is running; it starts with the first update and stops when progress ends.
+        bool IsRendering() const { return m_rendering; }
+
     private:
-        std::atomic<bool> m_isVisible = false;
+        // The latest values reported; written by the producer and read by the renderer.
+        std::atomic<uint64_t> m_current = 0;
+        std::atomic<uint64_t> m_maximum = 0;
+        std::atomic<ProgressType> m_type = ProgressType::None;
+        std::atomic<uint64_t> m_updateCount = 0;
+
+        // Only used while holding m_renderLock.
+        std::mutex m_renderLock;
+        uint64_t m_renderedUpdateCount = 0;
         uint64_t m_lastCurrent = 0;
+        std::atomic<bool> m_isVisible = false;
+
+        std::mutex m_renderJobLock;
+        std::atomic<bool> m_rendering = false;
+        wil::unique_event m_stopRendering{ wil::EventOptions::ManualReset };
+        std::future<void> m_renderJob;
+
+        void RenderLoop();
+
+        void StopRendering();
+
+        // Draws the latest values if they have not been drawn yet.
+        void RenderPendingUpdate();
+
+        void Render(uint64_t current, uint64_t maximum, ProgressType type);
 
         void ClearLine();
 
@@ -82,4 +118,73 @@ namespace AppInstaller::CLI::Execution
 
         void ShowProgressWithVT(uint64_t current, uint64_t maximum, ProgressType type);
     };
+
+    // Displays the progress of several operations that run at the same time, one labeled line each.
+    // With VT, a renderer thread redraws all of the lines in place; without it, each line is written once its operation completes.
+    class MultiLineProgress : public details::ProgressVisualizerBase
+    {
+    public:
+        MultiLineProgress(BaseStream& stream, bool enableVT, const std::vector<std::string>& labels);
+
+        MultiLineProgress(const MultiLineProgress&) = delete;
+        MultiLineProgress& operator=(const MultiLineProgress&) = delete;
+
+        ~MultiLineProgress();
+
+        // Starts showing the progress.
+        void Begin();
+
+        // Gets the callback that reports the progress of the operation on the given line.
+        ProgressCallback& GetCallback(size_t index);
+
+        // Marks the operation on the given line as complete, replacing its progress with the result.
+        void Complete(size_t index, std::string result);
+
+        // Cancels all of the operations.
+        void Cancel();
+
+        // Stops rendering, leaving the final state of every line behind.
+        void End();
+
+    private:
+        struct Line : public IProgressSink
+        {
+            Line(std::string label) : Label(std::move(label)), Callback(this) {}
+
+            void OnProgress(uint64_t current, uint64_t maximum, ProgressType type) override;
+            void BeginProgress() override {}
+            void EndProgress(bool) override {}
+
+            std::string Label;
+            ProgressCallback Callback;
+
+            // The latest values reported; written by the operation and read by the renderer.
+            std::atomic<uint64_t> Current = 0;
+            std::atomic<uint64_t> Maximum = 0;
+            std::atomic<ProgressType> Type = ProgressType::None;
+
+            // Only used while holding m_renderLock.
+            std::optional<std::string> Result;
+        };
+
+        std::vector<std::unique_ptr<Line>> m_lines;
+        size_t m_labelWidth = 0;
+
+        // Only used while holding m_renderLock.
+        std::mutex m_renderLock;
+        bool m_isVisible = false;
+        size_t m_frame = 0;
+
+        wil::unique_event m_stopRendering{ wil::EventOptions::ManualReset };
+        std::future<void> m_renderJob;
+
+        void RenderLoop();
+
+        void StopRendering();
+
+        // Redraws every line in place.
+        void Render();
+
+        void RenderLine(const Line& line);
+    };
 }
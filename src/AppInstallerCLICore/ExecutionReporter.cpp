@@ -18,6 +18,19 @@ namespace AppInstaller::CLI::Execution
     const Sequence& UrlEmphasis = TextFormat::Foreground::BrightBlue;
     const Sequence& PromptEmphasis = TextFormat::Foreground::Bright;
 
+    namespace
+    {
+        // Receives the progress of redirected output, which is not shown.
+        struct NullProgressSink : public IProgressSink
+        {
+            void OnProgress(uint64_t, uint64_t, ProgressType) override {}
+            void BeginProgress() override {}
+            void EndProgress(bool) override {}
+        };
+
+        NullProgressSink s_nullProgressSink;
+    }
+
     Reporter::Reporter(std::ostream& outStream, std::istream& inStream) :
         Reporter(std::make_shared<BaseStream>(outStream, true, ConsoleModeRestore::Instance().IsVTEnabled()), inStream)
     {
@@ -135,6 +148,9 @@ namespace AppInstaller::CLI::Execution
                 }
             }
 
+            // The options do not end the line, so they must be flushed to be seen before reading the response
+            out << std::flush;
+
             // Read the response
             std::string response;
             if (!std::getline(m_in, response))
@@ -195,6 +211,25 @@ namespace AppInstaller::CLI::Execution
         GetBasicOutputStream() << VirtualTerminal::Cursor::Visibility::EnableShow;
     };
 
+    std::unique_ptr<MultiLineProgress> Reporter::BeginMultiLineProgress(const std::vector<std::string>& labels)
+    {
+        auto result = std::make_unique<MultiLineProgress>(*m_out, ConsoleModeRestore::Instance().IsVTEnabled(), labels);
+        if (m_style.has_value())
+        {
+            result->SetStyle(*m_style);
+        }
+
+        GetBasicOutputStream() << VirtualTerminal::Cursor::Visibility::DisableShow;
+        result->Begin();
+        return result;
+    }
+
+    void Reporter::EndMultiLineProgress(MultiLineProgress& progress)
+    {
+        progress.End();
+        GetBasicOutputStream() << VirtualTerminal::Cursor::Visibility::EnableShow;
+    }
+
     void Reporter::SetProgressCallback(ProgressCallback* callback)
     {
         auto lock = m_progressCallbackLock.lock_exclusive();
@@ -221,4 +256,22 @@ namespace AppInstaller::CLI::Execution
         }
         m_out->RestoreDefault();
     }
+
+    void Reporter::RedirectOutput(std::ostream& out)
+    {
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), m_redirectedOut != nullptr);
+
+        m_redirectedOut = std::exchange(m_out, std::make_shared<BaseStream>(out, true, ConsoleModeRestore::Instance().IsVTEnabled()));
+        m_redirectedProgressSink = m_progressSink.exchange(&s_nullProgressSink);
+    }
+
+    void Reporter::RestoreOutput()
+    {
+        if (m_redirectedOut)
+        {
+            m_out = std::move(m_redirectedOut);
+            m_progressSink = m_redirectedProgressSink;
+            m_redirectedProgressSink = nullptr;
+        }
+    }
 }
\ No newline at end of file
@@ -125,6 +125,24 @@ namespace AppInstaller::CLI::Execution
             return f(callback);
         }
 
+        // Runs the given callable of type: auto(MultiLineProgress&), showing the progress of each operation on its own line.
+        // Cancelling the in progress task cancels all of the operations.
+        template <typename F>
+        auto ExecuteWithMultiLineProgress(const std::vector<std::string>& labels, F&& f)
+        {
+            std::unique_ptr<MultiLineProgress> progress = BeginMultiLineProgress(labels);
+            ProgressCallback callback;
+            auto removeCancellation = callback.SetCancellationFunction([&progress]() { progress->Cancel(); });
+            SetProgressCallback(&callback);
+
+            auto endProgress = wil::scope_exit([this, &progress]()
+                {
+                    SetProgressCallback(nullptr);
+                    EndMultiLineProgress(*progress);
+                });
+            return f(*progress);
+        }
+
         // Sets the in progress callback.
         void SetProgressCallback(ProgressCallback* callback);
 
@@ -138,12 +156,23 @@ namespace AppInstaller::CLI::Execution
             m_progressSink = sink;
         }
 
+        // Sends the output to the given stream and stops showing progress until RestoreOutput is called.
+        // This lets work run in the background and show its output later, rather than interleaving it with the foreground.
+        void RedirectOutput(std::ostream& out);
+
+        // Restores the output that was replaced by RedirectOutput.
+        void RestoreOutput();
+
     private:
         Reporter(std::shared_ptr<BaseStream> outStream, std::istream& inStream);
 
         // Gets a stream for output for internal use.
         OutputStream GetBasicOutputStream();
 
+        std::unique_ptr<MultiLineProgress> BeginMultiLineProgress(const std::vector<std::string>& labels);
+
+        void EndMultiLineProgress(MultiLineProgress& progress);
+
         Channel m_channel = Channel::Output;
         std::shared_ptr<BaseStream> m_out;
         std::istream& m_in;
@@ -153,6 +182,8 @@ namespace AppInstaller::CLI::Execution
         wil::srwlock m_progressCallbackLock;
         std::atomic<ProgressCallback*> m_progressCallback;
         std::atomic<IProgressSink*> m_progressSink;
+        std::shared_ptr<BaseStream> m_redirectedOut;
+        IProgressSink* m_redirectedProgressSink = nullptr;
     };
 
     // Indirection to enable change without tracking down every place
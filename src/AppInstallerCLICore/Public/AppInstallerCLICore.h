@@ -9,4 +9,7 @@ namespace AppInstaller::CLI
 
     // Initializes the Windows Package Manager COM server.
     void ServerInitialize();
+
+    // Finishes the work of the Windows Package Manager COM server once it has no more clients.
+    void ServerShutdown();
 }
@@ -36,10 +36,22 @@ namespace AppInstaller::CLI::Resource
         }
     }
 
-    std::string Loader::ResolveString(
+    const std::string& Loader::ResolveString(
         std::wstring_view resKey) const
     {
-        return Utility::ConvertToUTF8(m_wingetLoader.GetString(resKey));
+        {
+            std::shared_lock<std::shared_mutex> lock{ m_cacheLock };
+            auto itr = m_cache.find(resKey);
+            if (itr != m_cache.end())
+            {
+                return itr->second;
+            }
+        }
+
+        std::string value = Utility::ConvertToUTF8(m_wingetLoader.GetString(resKey));
+
+        std::unique_lock<std::shared_mutex> lock{ m_cacheLock };
+        return m_cache.emplace(std::wstring{ resKey }, std::move(value)).first->second;
     }
 
     Utility::LocIndView GetFixedString(FixedString fs)
@@ -7,6 +7,8 @@
 #include <winrt/Windows.ApplicationModel.Resources.h>
 
 #include <iostream>
+#include <map>
+#include <shared_mutex>
 
 namespace AppInstaller::CLI::Resource
 {
@@ -34,6 +36,11 @@ namespace AppInstaller::CLI::Resource
         WINGET_DEFINE_RESOURCE_STRINGID(AvailableSubcommands);
         WINGET_DEFINE_RESOURCE_STRINGID(AvailableUpgrades);
         WINGET_DEFINE_RESOURCE_STRINGID(BothManifestAndSearchQueryProvided);
+        WINGET_DEFINE_RESOURCE_STRINGID(CacheCommandLongDescription);
+        WINGET_DEFINE_RESOURCE_STRINGID(CacheCommandShortDescription);
+        WINGET_DEFINE_RESOURCE_STRINGID(CacheWarmCommandLongDescription);
+        WINGET_DEFINE_RESOURCE_STRINGID(CacheWarmCommandShortDescription);
+        WINGET_DEFINE_RESOURCE_STRINGID(CacheWarmUpgradeManifests);
         WINGET_DEFINE_RESOURCE_STRINGID(Cancelled);
         WINGET_DEFINE_RESOURCE_STRINGID(ChannelArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(Command);
@@ -86,6 +93,7 @@ namespace AppInstaller::CLI::Resource
         WINGET_DEFINE_RESOURCE_STRINGID(GetManifestResultVersionNotFound);
         WINGET_DEFINE_RESOURCE_STRINGID(HashCommandLongDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(HashCommandShortDescription);
+        WINGET_DEFINE_RESOURCE_STRINGID(HashFileFailed);
         WINGET_DEFINE_RESOURCE_STRINGID(HeaderArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(HeaderArgumentNotApplicableForNonRestSourceWarning);
         WINGET_DEFINE_RESOURCE_STRINGID(HeaderArgumentNotApplicableWithoutSource);
@@ -104,6 +112,7 @@ namespace AppInstaller::CLI::Resource
         WINGET_DEFINE_RESOURCE_STRINGID(ImportPackageAlreadyInstalled);
         WINGET_DEFINE_RESOURCE_STRINGID(ImportSearchFailed);
         WINGET_DEFINE_RESOURCE_STRINGID(ImportSourceNotInstalled);
+        WINGET_DEFINE_RESOURCE_STRINGID(ImportStreamArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(IncludeUnknownArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(InstallAndUpgradeCommandsReportDependencies);
         WINGET_DEFINE_RESOURCE_STRINGID(InstallArchitectureArgumentDescription);
@@ -194,6 +203,8 @@ namespace AppInstaller::CLI::Resource
         WINGET_DEFINE_RESOURCE_STRINGID(OpenSourceFailedNoSourceDefined);
         WINGET_DEFINE_RESOURCE_STRINGID(Options);
         WINGET_DEFINE_RESOURCE_STRINGID(OutputFileArgumentDescription);
+        WINGET_DEFINE_RESOURCE_STRINGID(OutputFormatArgumentDescription);
+        WINGET_DEFINE_RESOURCE_STRINGID(OutputFormatOnlyWhenListing);
         WINGET_DEFINE_RESOURCE_STRINGID(OverrideArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(Package);
         WINGET_DEFINE_RESOURCE_STRINGID(PackageAgreementsNotAgreedTo);
@@ -212,6 +223,7 @@ namespace AppInstaller::CLI::Resource
         WINGET_DEFINE_RESOURCE_STRINGID(RainbowArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(ReportIdentityFound);
         WINGET_DEFINE_RESOURCE_STRINGID(RequiredArgError);
+        WINGET_DEFINE_RESOURCE_STRINGID(ResourceReportArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(RetroArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(SearchCommandLongDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(SearchCommandShortDescription);
@@ -277,6 +289,7 @@ namespace AppInstaller::CLI::Resource
         WINGET_DEFINE_RESOURCE_STRINGID(SourceAgreementsPrompt);
         WINGET_DEFINE_RESOURCE_STRINGID(SourceAgreementsTitle);
         WINGET_DEFINE_RESOURCE_STRINGID(SourceArgArgumentDescription);
+        WINGET_DEFINE_RESOURCE_STRINGID(SourceBackgroundUpdateArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(SourceArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(DependencySourceArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(SourceCommandLongDescription);
@@ -316,10 +329,15 @@ namespace AppInstaller::CLI::Resource
         WINGET_DEFINE_RESOURCE_STRINGID(SourceUpdateAll);
         WINGET_DEFINE_RESOURCE_STRINGID(SourceUpdateCommandLongDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(SourceUpdateCommandShortDescription);
+        WINGET_DEFINE_RESOURCE_STRINGID(SourceUpdateFailed);
+        WINGET_DEFINE_RESOURCE_STRINGID(SourceUpdateFailedResult);
         WINGET_DEFINE_RESOURCE_STRINGID(SourceUpdateOne);
+        WINGET_DEFINE_RESOURCE_STRINGID(StartupTraceArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(TagArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(ThankYou);
         WINGET_DEFINE_RESOURCE_STRINGID(ThirdPartSoftwareNotices);
+        WINGET_DEFINE_RESOURCE_STRINGID(TimingsArgumentDescription);
+        WINGET_DEFINE_RESOURCE_STRINGID(TimingsHeader);
         WINGET_DEFINE_RESOURCE_STRINGID(ToolDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(ToolInfoArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(ToolVersionArgumentDescription);
@@ -341,6 +359,8 @@ namespace AppInstaller::CLI::Resource
         WINGET_DEFINE_RESOURCE_STRINGID(UpgradeCommandShortDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(UpgradeDifferentInstallTechnology);
         WINGET_DEFINE_RESOURCE_STRINGID(UpgradeDifferentInstallTechnologyInNewerVersions);
+        WINGET_DEFINE_RESOURCE_STRINGID(UpgradeSummaryArgumentDescription);
+        WINGET_DEFINE_RESOURCE_STRINGID(UpgradeSummaryOnlyWhenListing);
         WINGET_DEFINE_RESOURCE_STRINGID(UpgradeUnknownCount);
         WINGET_DEFINE_RESOURCE_STRINGID(UpgradeUnknownCountSingle);
         WINGET_DEFINE_RESOURCE_STRINGID(UpgradeUnknownVersionExplanation);
@@ -349,6 +369,7 @@ namespace AppInstaller::CLI::Resource
         WINGET_DEFINE_RESOURCE_STRINGID(ValidateCommandReportDependencies);
         WINGET_DEFINE_RESOURCE_STRINGID(ValidateCommandShortDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(ValidateManifestArgumentDescription);
+        WINGET_DEFINE_RESOURCE_STRINGID(ValidateRecurseArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(VerboseLogsArgumentDescription);
         WINGET_DEFINE_RESOURCE_STRINGID(VerifyFileFailedIsDirectory);
         WINGET_DEFINE_RESOURCE_STRINGID(VerifyFileFailedNotExist);
@@ -386,11 +407,16 @@ namespace AppInstaller::CLI::Resource
         static const Loader& Instance();
 
         // Gets the the string resource value.
-        std::string ResolveString(std::wstring_view resKey) const;
+        // Each value is loaded once and kept for the life of the process, so the reference remains valid.
+        const std::string& ResolveString(std::wstring_view resKey) const;
 
     private:
         winrt::Windows::ApplicationModel::Resources::ResourceLoader m_wingetLoader;
 
+        // The same strings (table headers, progress labels, per item messages) are resolved many times.
+        mutable std::shared_mutex m_cacheLock;
+        mutable std::map<std::wstring, std::string, std::less<>> m_cache;
+
         Loader();
     };
 
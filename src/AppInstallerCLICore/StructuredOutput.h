@@ -0,0 +1,176 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "ExecutionArgs.h"
+#include "ExecutionReporter.h"
+#include <AppInstallerStrings.h>
+#include <json.h>
+
+#include <array>
+#include <string>
+#include <string_view>
+
+
+namespace AppInstaller::CLI::Execution
+{
+    // The formats that results can be output in.
+    enum class OutputFormat
+    {
+        // A table with localized headers, sized to the console.
+        Table,
+        // A JSON array with an object for each result.
+        Json,
+        // Comma separated values, with a header line.
+        Csv,
+        Unknown,
+    };
+
+    // Converts the value of the output argument to the format, or Unknown if it is not one.
+    inline OutputFormat ConvertToOutputFormat(std::string_view value)
+    {
+        if (Utility::CaseInsensitiveEquals(value, "table"))
+        {
+            return OutputFormat::Table;
+        }
+        else if (Utility::CaseInsensitiveEquals(value, "json"))
+        {
+            return OutputFormat::Json;
+        }
+        else if (Utility::CaseInsensitiveEquals(value, "csv"))
+        {
+            return OutputFormat::Csv;
+        }
+
+        return OutputFormat::Unknown;
+    }
+
+    // Gets the output format requested by the arguments; the table is the default.
+    inline OutputFormat GetOutputFormat(const Args& args)
+    {
+        return args.Contains(Args::Type::OutputFormat) ? ConvertToOutputFormat(args.GetArg(Args::Type::OutputFormat)) : OutputFormat::Table;
+    }
+
+    namespace details
+    {
+        // Appends the value as a CSV field, quoting it only if it contains a separator, quote or line break.
+        inline void AppendCsvField(std::string& output, std::string_view value)
+        {
+            if (value.find_first_of(",\"\r\n") == std::string_view::npos)
+            {
+                output += value;
+                return;
+            }
+
+            output += '"';
+            for (char c : value)
+            {
+                if (c == '"')
+                {
+                    output += '"';
+                }
+                output += c;
+            }
+            output += '"';
+        }
+    }
+
+    // Outputs results in a machine readable format, writing each line as soon as it is given.
+    // Nothing is buffered for sizing and values are never truncated, so output of any length takes constant memory.
+    template <size_t FieldCount>
+    struct StructuredOutput
+    {
+        // The names of the fields are part of the format, and thus are not localized.
+        using header_t = std::array<std::string_view, FieldCount>;
+        using line_t = std::array<std::string, FieldCount>;
+
+        StructuredOutput(Reporter& reporter, OutputFormat format, header_t header) :
+            m_reporter(reporter), m_format(format), m_header(header)
+        {
+            THROW_HR_IF(E_INVALIDARG, format != OutputFormat::Json && format != OutputFormat::Csv);
+        }
+
+        void OutputLine(line_t&& line)
+        {
+            std::string output;
+
+            if (m_format == OutputFormat::Json)
+            {
+                output += (m_empty ? "[\n{" : ",\n{");
+
+                for (size_t i = 0; i < FieldCount; ++i)
+                {
+                    if (i)
+                    {
+                        output += ',';
+                    }
+                    output += Json::valueToQuotedString(std::string{ m_header[i] }.c_str());
+                    output += ':';
+                    output += Json::valueToQuotedString(line[i].c_str());
+                }
+
+                output += '}';
+            }
+            else
+            {
+                if (m_empty)
+                {
+                    AppendCsvHeader(output);
+                }
+                AppendCsvLine(output, line);
+            }
+
+            m_empty = false;
+            m_reporter.Info() << output << std::flush;
+        }
+
+        void Complete()
+        {
+            std::string output;
+
+            if (m_format == OutputFormat::Json)
+            {
+                output = (m_empty ? "[]\n" : "\n]\n");
+            }
+            else if (m_empty)
+            {
+                AppendCsvHeader(output);
+            }
+
+            m_reporter.Info() << output << std::flush;
+        }
+
+        bool IsEmpty()
+        {
+            return m_empty;
+        }
+
+    private:
+        void AppendCsvHeader(std::string& output)
+        {
+            line_t headerLine;
+            for (size_t i = 0; i < FieldCount; ++i)
+            {
+                headerLine[i] = m_header[i];
+            }
+            AppendCsvLine(output, headerLine);
+        }
+
+        void AppendCsvLine(std::string& output, const line_t& line)
+        {
+            for (size_t i = 0; i < FieldCount; ++i)
+            {
+                if (i)
+                {
+                    output += ',';
+                }
+                details::AppendCsvField(output, line[i]);
+            }
+            output += '\n';
+        }
+
+        Reporter& m_reporter;
+        OutputFormat m_format;
+        header_t m_header;
+        bool m_empty = true;
+    };
+}
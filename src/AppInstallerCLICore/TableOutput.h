@@ -27,6 +27,12 @@ namespace AppInstaller::CLI::Execution
                 return 120;
             }
         }
+
+        // Gets the column width of the value, without normalizing a copy of it when every byte is known to take one column.
+        inline size_t GetColumnWidth(const std::string& value)
+        {
+            return Utility::IsPrintableASCII(value) ? value.size() : Utility::UTF8ColumnWidth(value);
+        }
     }
 
     // Enables output data in a table format.
@@ -36,6 +42,7 @@ namespace AppInstaller::CLI::Execution
     {
         using header_t = std::array<Resource::LocString, FieldCount>;
         using line_t = std::array<std::string, FieldCount>;
+        using widths_t = std::array<size_t, FieldCount>;
 
         TableOutput(Reporter& reporter, header_t&& header, size_t sizingBuffer = 50) :
             m_reporter(reporter), m_sizingBuffer(sizingBuffer)
@@ -52,14 +59,24 @@ namespace AppInstaller::CLI::Execution
         {
             m_empty = false;
 
+            // The widths are measured once, for both sizing the columns and padding the values.
+            widths_t widths;
+            for (size_t i = 0; i < FieldCount; ++i)
+            {
+                widths[i] = details::GetColumnWidth(line[i]);
+            }
+
             if (m_buffer.size() < m_sizingBuffer)
             {
-                m_buffer.emplace_back(std::move(line));
+                m_buffer.emplace_back(std::move(line), widths);
             }
             else
             {
                 EvaluateAndFlushBuffer();
-                OutputLineToStream(line);
+
+                std::string output;
+                AppendLine(output, line, widths);
+                m_reporter.Info() << output << std::flush;
             }
         }
 
@@ -89,7 +106,7 @@ namespace AppInstaller::CLI::Execution
         Reporter& m_reporter;
         std::array<Column, FieldCount> m_columns;
         size_t m_sizingBuffer;
-        std::vector<line_t> m_buffer;
+        std::vector<std::pair<line_t, widths_t>> m_buffer;
         bool m_bufferEvaluated = false;
         bool m_empty = true;
 
@@ -105,7 +122,7 @@ namespace AppInstaller::CLI::Execution
             {
                 for (size_t i = 0; i < FieldCount; ++i)
                 {
-                    m_columns[i].MaxLength = std::max(m_columns[i].MaxLength, Utility::UTF8ColumnWidth(line[i]));
+                    m_columns[i].MaxLength = std::max(m_columns[i].MaxLength, line.second[i]);
                 }
             }
 
@@ -171,67 +188,75 @@ namespace AppInstaller::CLI::Execution
                 totalRequired = consoleWidth - 1;
             }
 
-            // Header line
+            // The header, separator and buffered lines are written to the stream as a single block.
+            std::string output;
+
             line_t headerLine;
+            widths_t headerWidths;
 
             for (size_t i = 0; i < FieldCount; ++i)
             {
                 headerLine[i] = m_columns[i].Name.get();
+                headerWidths[i] = m_columns[i].MinLength;
             }
 
-            OutputLineToStream(headerLine);
+            AppendLine(output, headerLine, headerWidths);
 
-            m_reporter.Info() << std::string(totalRequired, '-') << std::endl;
+            output.append(totalRequired, '-');
+            output += '\n';
 
             for (const auto& line : m_buffer)
             {
-                OutputLineToStream(line);
+                AppendLine(output, line.first, line.second);
             }
 
+            m_reporter.Info() << output << std::flush;
+
+            m_buffer.clear();
             m_bufferEvaluated = true;
         }
 
-        void OutputLineToStream(const line_t& line)
+        // Appends the line to the output, with each value padded or trimmed to the width of its column.
+        void AppendLine(std::string& output, const line_t& line, const widths_t& widths)
         {
-            auto out = m_reporter.Info();
-
             for (size_t i = 0; i < FieldCount; ++i)
             {
                 const auto& col = m_columns[i];
 
                 if (col.MaxLength)
                 {
-                    size_t valueLength = Utility::UTF8ColumnWidth(line[i]);
+                    size_t valueLength = widths[i];
 
                     if (valueLength > col.MaxLength)
                     {
                         size_t actualWidth;
-                        out << Utility::UTF8TrimRightToColumnWidth(line[i], col.MaxLength - 1, actualWidth) << "\xE2\x80\xA6"; // UTF8 encoding of ellipsis (…) character
+                        output += Utility::UTF8TrimRightToColumnWidth(line[i], col.MaxLength - 1, actualWidth);
+                        output += "\xE2\x80\xA6"; // UTF8 encoding of ellipsis (…) character
 
                         // Some characters take 2 unit space, the trimmed string length might be 1 less than the expected length.
                         if (actualWidth != col.MaxLength - 1)
                         {
-                            out << ' ';
+                            output += ' ';
                         }
 
                         if (col.SpaceAfter)
                         {
-                            out << ' ';
+                            output += ' ';
                         }
                     }
                     else
                     {
-                        out << line[i];
+                        output += line[i];
 
                         if (col.SpaceAfter)
                         {
-                            out << std::string(col.MaxLength - valueLength + 1, ' ');
+                            output.append(col.MaxLength - valueLength + 1, ' ');
                         }
                     }
                 }
             }
 
-            out << std::endl;
+            output += '\n';
         }
     };
 }
@@ -22,6 +22,56 @@ namespace AppInstaller::CLI::Workflow
                 stream << value << std::endl;
             }
         }
+
+        // Completes the value from the completion indexes of the sources, which does not need them to be opened.
+        // Returns false if the value must be completed by searching the sources instead.
+        bool TryCompleteWithCompletionIndex(Execution::Context& context, const std::vector<Repository::PackageMatchField>& fields)
+        {
+            // Other values on the command line filter the results, which requires a search.
+            for (auto type : { Args::Type::Id, Args::Type::Name, Args::Type::Moniker, Args::Type::Tag, Args::Type::Command })
+            {
+                if (context.Args.Contains(type))
+                {
+                    return false;
+                }
+            }
+
+            try
+            {
+                std::string_view sourceName;
+                if (context.Args.Contains(Args::Type::Source))
+                {
+                    sourceName = context.Args.GetArg(Args::Type::Source);
+                }
+
+                Repository::Source source{ sourceName };
+                if (!source)
+                {
+                    return false;
+                }
+
+                auto values = source.GetCompletionValues(fields, context.Get<Data::CompletionData>().Word());
+                if (!values)
+                {
+                    return false;
+                }
+
+                auto stream = context.Reporter.Completion();
+                for (const auto& value : values.value())
+                {
+                    OutputCompletionString(stream, value);
+                }
+
+                return true;
+            }
+            catch (...)
+            {
+                LOG_CAUGHT_EXCEPTION();
+                AICLI_LOG(CLI, Info, << "Failed to complete from the completion index, searching the source instead");
+            }
+
+            return false;
+        }
     }
 
     void CompleteSourceName(Execution::Context& context)
@@ -103,6 +153,35 @@ namespace AppInstaller::CLI::Workflow
 
     void CompleteWithSingleSemanticsForValue::operator()(Execution::Context& context) const
     {
+        switch (m_type)
+        {
+        case Execution::Args::Type::Query:
+            if (!context.Get<Data::CompletionData>().Word().empty() &&
+                TryCompleteWithCompletionIndex(context, { Repository::PackageMatchField::Id, Repository::PackageMatchField::Name, Repository::PackageMatchField::Moniker }))
+            {
+                return;
+            }
+            break;
+        case Execution::Args::Type::Id:
+            if (TryCompleteWithCompletionIndex(context, { Repository::PackageMatchField::Id }))
+            {
+                return;
+            }
+            break;
+        case Execution::Args::Type::Name:
+            if (TryCompleteWithCompletionIndex(context, { Repository::PackageMatchField::Name }))
+            {
+                return;
+            }
+            break;
+        case Execution::Args::Type::Moniker:
+            if (TryCompleteWithCompletionIndex(context, { Repository::PackageMatchField::Moniker }))
+            {
+                return;
+            }
+            break;
+        }
+
         switch (m_type)
         {
         case Execution::Args::Type::Query:
@@ -201,45 +201,51 @@ namespace AppInstaller::CLI::Workflow
             context.Reporter.Warn() << Resource::String::DependenciesFlowContainsLoop;
         }
 
-        const auto& installationOrder = dependencyGraph.GetInstallationOrder();
+        const auto& installationLevels = dependencyGraph.GetInstallationLevels();
 
         std::vector<std::unique_ptr<Execution::Context>> dependencyPackageContexts;
+        std::vector<size_t> dependencyPackageLevels;
 
-        for (auto const& node : installationOrder)
+        for (size_t level = 0; level < installationLevels.size(); ++level)
         {
-            auto itr = idToPackageMap.find(node.Id);
-            // if the package was already installed (with a useful version) or is the root
-            // then there will be no installer for it on the map.
-            if (itr != idToPackageMap.end())
+            for (auto const& node : installationLevels[level])
             {
-                auto dependencyContextPtr = context.CreateSubContext();
-                Execution::Context& dependencyContext = *dependencyContextPtr;
-                auto previousThreadGlobals = dependencyContext.SetForCurrentThread();
-
-                Logging::Telemetry().LogSelectedInstaller(
-                    static_cast<int>(itr->second.Installer.Arch),
-                    itr->second.Installer.Url,
-                    Manifest::InstallerTypeToString(itr->second.Installer.InstallerType),
-                    Manifest::ScopeToString(itr->second.Installer.Scope),
-                    itr->second.Installer.Locale);
-
-                Logging::Telemetry().LogManifestFields(
-                    itr->second.Manifest.Id,
-                    itr->second.Manifest.DefaultLocalization.Get<Manifest::Localization::PackageName>(),
-                    itr->second.Manifest.Version);
-
-                // Extract the data needed for installing
-                dependencyContext.Add<Execution::Data::PackageVersion>(itr->second.PackageVersion);
-                dependencyContext.Add<Execution::Data::Manifest>(itr->second.Manifest);
-                dependencyContext.Add<Execution::Data::InstalledPackageVersion>(itr->second.InstalledPackageVersion);
-                dependencyContext.Add<Execution::Data::Installer>(itr->second.Installer);
-
-                dependencyPackageContexts.emplace_back(std::move(dependencyContextPtr));
+                auto itr = idToPackageMap.find(node.Id);
+                // if the package was already installed (with a useful version) or is the root
+                // then there will be no installer for it on the map.
+                if (itr != idToPackageMap.end())
+                {
+                    auto dependencyContextPtr = context.CreateSubContext();
+                    Execution::Context& dependencyContext = *dependencyContextPtr;
+                    auto previousThreadGlobals = dependencyContext.SetForCurrentThread();
+
+                    Logging::Telemetry().LogSelectedInstaller(
+                        static_cast<int>(itr->second.Installer.Arch),
+                        itr->second.Installer.Url,
+                        Manifest::InstallerTypeToString(itr->second.Installer.InstallerType),
+                        Manifest::ScopeToString(itr->second.Installer.Scope),
+                        itr->second.Installer.Locale);
+
+                    Logging::Telemetry().LogManifestFields(
+                        itr->second.Manifest.Id,
+                        itr->second.Manifest.DefaultLocalization.Get<Manifest::Localization::PackageName>(),
+                        itr->second.Manifest.Version);
+
+                    // Extract the data needed for installing
+                    dependencyContext.Add<Execution::Data::PackageVersion>(itr->second.PackageVersion);
+                    dependencyContext.Add<Execution::Data::Manifest>(itr->second.Manifest);
+                    dependencyContext.Add<Execution::Data::InstalledPackageVersion>(itr->second.InstalledPackageVersion);
+                    dependencyContext.Add<Execution::Data::Installer>(itr->second.Installer);
+
+                    dependencyPackageContexts.emplace_back(std::move(dependencyContextPtr));
+                    dependencyPackageLevels.push_back(level);
+                }
             }
         }
 
-        // Install dependencies in the correct order
+        // Install dependencies in the correct order; those of the same level do not depend on each other
         context.Add<Execution::Data::PackagesToInstall>(std::move(dependencyPackageContexts));
+        context.Add<Execution::Data::PackagesToInstallLevels>(std::move(dependencyPackageLevels));
         context << Workflow::InstallMultiplePackages(m_dependencyReportMessage, APPINSTALLER_CLI_ERROR_INSTALL_DEPENDENCIES, {}, false, true);
     }
 }
\ No newline at end of file
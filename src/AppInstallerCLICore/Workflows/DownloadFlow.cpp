@@ -3,13 +3,17 @@
 #include "pch.h"
 #include "DownloadFlow.h"
 
+#include <AppInstallerDeployment.h>
 #include <AppInstallerMsixInfo.h>
+#include <winget/InstallerCache.h>
+#include <winget/ThreadGlobals.h>
 
 namespace AppInstaller::CLI::Workflow
 {
     using namespace AppInstaller::Manifest;
     using namespace AppInstaller::Repository;
     using namespace AppInstaller::Utility;
+    using namespace AppInstaller::ThreadLocalStorage;
     using namespace std::string_view_literals;
 
     namespace
@@ -104,11 +108,17 @@ namespace AppInstaller::CLI::Workflow
         // If the hash does not match, deletes the file.
         bool ExistingInstallerFileHasHashMatch(const SHA256::HashBuffer& expectedHash, const std::filesystem::path& filePath, SHA256::HashBuffer& fileHash)
         {
+            if (Utility::HasPartialDownload(filePath))
+            {
+                // Keep the file so that downloading it again continues where it left off.
+                AICLI_LOG(CLI, Info, << "Found partially downloaded installer file at '" << filePath << "'.");
+                return false;
+            }
+
             if (std::filesystem::exists(filePath))
             {
                 AICLI_LOG(CLI, Info, << "Found existing installer file at '" << filePath << "'. Verifying file hash.");
-                std::ifstream inStream{ filePath, std::ifstream::binary };
-                fileHash = SHA256::ComputeHash(inStream);
+                fileHash = SHA256::ComputeHashFromFile(filePath);
 
                 if (SHA256::AreEqual(expectedHash, fileHash))
                 {
@@ -183,6 +193,23 @@ namespace AppInstaller::CLI::Workflow
             // but it is better to succeed the operation and leave a file around than to fail.
             std::filesystem::copy_file(from, to, std::filesystem::copy_options::overwrite_existing);
         }
+
+        // Discards everything written to it; used to hash a download without storing it.
+        struct DiscardStreamBuffer : public std::streambuf
+        {
+        protected:
+            int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+            std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+        };
+
+        // Determines whether the MSIX installer should be staged from its url while its hash is computed.
+        bool ShouldStageMsixWhileHashing(const Manifest::ManifestInstaller& installer)
+        {
+            // A cached installer is verified without any network access, which is better still.
+            return Settings::ExperimentalFeature::IsEnabled(Settings::ExperimentalFeature::Feature::StreamingMsix) &&
+                Utility::IsUrlRemote(installer.Url) &&
+                !InstallerCache::GetDefault();
+        }
     }
 
     void DownloadInstaller(Execution::Context& context)
@@ -213,7 +240,11 @@ namespace AppInstaller::CLI::Workflow
                 context << DownloadInstallerFile;
                 break;
             case InstallerTypeEnum::Msix:
-                if (installer.SignatureSha256.empty())
+                if (installer.SignatureSha256.empty() && ShouldStageMsixWhileHashing(installer))
+                {
+                    context << StageMsixAndComputeHash;
+                }
+                else if (installer.SignatureSha256.empty())
                 {
                     context << DownloadInstallerFile;
                 }
@@ -233,6 +264,7 @@ namespace AppInstaller::CLI::Workflow
 
         context <<
             VerifyInstallerHash <<
+            AddInstallerToCache <<
             UpdateInstallerFileMotwIfApplicable <<
             RenameDownloadedInstaller;
     }
@@ -292,6 +324,22 @@ namespace AppInstaller::CLI::Workflow
         // Use the SHA256 hash of the installer as the identifier for the download
         downloadInfo.ContentId = SHA256::ConvertToString(installer.Sha256);
 
+        // The cached copy is verified against the manifest hash, so it is used without any network access.
+        std::optional<InstallerCache> installerCache = InstallerCache::GetDefault();
+        if (installerCache)
+        {
+            try
+            {
+                if (installerCache->TryGet(installer.Sha256, installerPath))
+                {
+                    AICLI_LOG(CLI, Info, << "Using installer from the installer cache.");
+                    context.Add<Execution::Data::HashPair>(std::make_pair(installer.Sha256, installer.Sha256));
+                    return;
+                }
+            }
+            CATCH_LOG();
+        }
+
         context.Reporter.Info() << "Downloading " << Execution::UrlEmphasis << installer.Url << std::endl;
 
         std::optional<std::vector<BYTE>> hash;
@@ -349,8 +397,8 @@ namespace AppInstaller::CLI::Workflow
         {
             const auto& installer = context.Get<Execution::Data::Installer>().value();
 
-            Msix::MsixInfo msixInfo(installer.Url);
-            auto signature = msixInfo.GetSignature();
+            // Only the signature is read, so a package that fails the hash check is not downloaded
+            auto signature = Msix::GetPackageSignature(installer.Url);
 
             auto signatureHash = SHA256::ComputeHash(signature.data(), static_cast<uint32_t>(signature.size()));
 
@@ -376,6 +424,77 @@ namespace AppInstaller::CLI::Workflow
         }
     }
 
+    void StageMsixAndComputeHash(Execution::Context& context)
+    {
+        const auto& installer = context.Get<Execution::Data::Installer>().value();
+        std::string url = installer.Url;
+
+        // The hash is computed from a download of our own that runs while the deployment stages the package,
+        // so this takes as long as the longer of the two rather than their sum.
+        ProgressCallback hashProgress;
+
+        std::shared_ptr<ThreadGlobals> threadGlobals;
+        ThreadGlobals* parentThreadGlobals = ThreadGlobals::GetForCurrentThread();
+        if (parentThreadGlobals)
+        {
+            threadGlobals = std::make_shared<ThreadGlobals>(*parentThreadGlobals, ThreadGlobals::create_sub_thread_globals_t{});
+        }
+
+        std::future<std::optional<std::vector<BYTE>>> hashFuture = std::async(std::launch::async, [&url, &hashProgress, threadGlobals]()
+            {
+                std::unique_ptr<PreviousThreadGlobals> previousThreadGlobals;
+                if (threadGlobals)
+                {
+                    previousThreadGlobals = threadGlobals->SetForCurrentThread();
+                }
+
+                DiscardStreamBuffer discardBuffer;
+                std::ostream discardStream{ &discardBuffer };
+                return Utility::DownloadToStream(url, discardStream, Utility::DownloadType::Installer, hashProgress, true);
+            });
+
+        auto stopHash = wil::scope_exit([&]()
+            {
+                hashProgress.Cancel();
+                hashFuture.wait();
+            });
+
+        context.Reporter.Info() << "Downloading " << Execution::UrlEmphasis << installer.Url << std::endl;
+
+        try
+        {
+            context.Reporter.ExecuteWithProgress([&](IProgressCallback& callback)
+                {
+                    Deployment::StagePackage(url, callback);
+                });
+        }
+        catch (const wil::ResultException& re)
+        {
+            // Downloading the package is what would have happened without staging it, so do that instead.
+            AICLI_LOG(CLI, Warning, << "Failed to stage the package, downloading it instead: " << WINGET_OSTREAM_FORMAT_HRESULT(re.GetErrorCode()));
+            stopHash.reset();
+            context << DownloadInstallerFile;
+            return;
+        }
+
+        stopHash.release();
+        std::optional<std::vector<BYTE>> hash = hashFuture.get();
+        THROW_HR_IF(E_UNEXPECTED, !hash);
+
+        context.Add<Execution::Data::HashPair>(std::make_pair(installer.Sha256, hash.value()));
+
+        if (!SHA256::AreEqual(installer.Sha256, hash.value()))
+        {
+            // Content that failed verification is not left staged; if the mismatch is overridden, installing stages it again.
+            try
+            {
+                ProgressCallback removeProgress;
+                Deployment::RemovePackage(Msix::MsixInfo{ url }.GetPackageFullName(), removeProgress);
+            }
+            CATCH_LOG();
+        }
+    }
+
     void VerifyInstallerHash(Execution::Context& context)
     {
         const auto& hashPair = context.Get<Execution::Data::HashPair>();
@@ -470,8 +589,7 @@ namespace AppInstaller::CLI::Workflow
         {
             // Get the hash from the installer file
             const auto& installerPath = context.Get<Execution::Data::InstallerPath>();
-            std::ifstream inStream{ installerPath, std::ifstream::binary };
-            auto existingFileHash = SHA256::ComputeHash(inStream);
+            auto existingFileHash = SHA256::ComputeHashFromFile(installerPath);
             context.Add<Execution::Data::HashPair>(std::make_pair(installer.Sha256, existingFileHash));
         }
         else if (installer.InstallerType == InstallerTypeEnum::MSStore)
@@ -492,6 +610,33 @@ namespace AppInstaller::CLI::Workflow
         }
     }
 
+    void AddInstallerToCache(Execution::Context& context)
+    {
+        if (!context.Contains(Execution::Data::InstallerPath) || !context.Contains(Execution::Data::HashPair))
+        {
+            return;
+        }
+
+        const auto& installer = context.Get<Execution::Data::Installer>().value();
+        const auto& hashPair = context.Get<Execution::Data::HashPair>();
+
+        // Only installers whose hash was verified are cached; this excludes MSIX signature hashes and overridden mismatches.
+        if (!SHA256::AreEqual(hashPair.first, installer.Sha256) || !SHA256::AreEqual(hashPair.first, hashPair.second))
+        {
+            return;
+        }
+
+        std::optional<InstallerCache> installerCache = InstallerCache::GetDefault();
+        if (installerCache)
+        {
+            try
+            {
+                installerCache->Add(installer.Sha256, context.Get<Execution::Data::InstallerPath>());
+            }
+            CATCH_LOG();
+        }
+    }
+
     void RenameDownloadedInstaller(Execution::Context& context)
     {
         if (!context.Contains(Execution::Data::InstallerPath))
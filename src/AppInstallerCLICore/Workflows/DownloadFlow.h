@@ -35,6 +35,13 @@ namespace AppInstaller::CLI::Workflow
     // Outputs: HashPair
     void GetMsixSignatureHash(Execution::Context& context);
 
+    // Stages the MSIX package from its url while computing the installer hash from a concurrent download.
+    // The package is then installed from the url, which uses the staged package.
+    // Required Args: None
+    // Inputs: Installer
+    // Outputs: HashPair
+    void StageMsixAndComputeHash(Execution::Context& context);
+
     // Gets the hash of the downloaded installer.
     // Downloading already computes the hash, so this is only needed to re-verify the installer hash.
     // Required Args: None
@@ -48,6 +55,12 @@ namespace AppInstaller::CLI::Workflow
     // Outputs: None
     void VerifyInstallerHash(Execution::Context& context);
 
+    // Adds the verified installer to the installer cache, if it is enabled.
+    // Required Args: None
+    // Inputs: Installer, HashPair, InstallerPath
+    // Outputs: None
+    void AddInstallerToCache(Execution::Context& context);
+
     // Update Motw of the downloaded installer if applicable
     // Required Args: None
     // Inputs: HashPair, InstallerPath?, SourceId?
@@ -14,6 +14,9 @@ namespace AppInstaller::CLI::Workflow
 
     namespace
     {
+        // The most packages that a streaming import looks up and installs together.
+        constexpr size_t MaximumImportBatchSize = 16;
+
         SourceDetails GetSourceDetails(const SourceDetails& source)
         {
             return source;
@@ -90,6 +93,175 @@ namespace AppInstaller::CLI::Workflow
 
             return availablePackageVersion;
         }
+
+        // Searches the source for all of the requested packages at once, so that the correlation with the installed
+        // packages is done once for the whole set, and splits the matches into a search result for each package.
+        std::vector<SearchResult> SearchForPackages(Repository::Source& source, const std::vector<PackageCollection::Package>& packages)
+        {
+            std::vector<SearchResult> results(packages.size());
+            if (packages.empty())
+            {
+                return results;
+            }
+
+            SearchRequest searchRequest;
+            std::map<std::string, std::vector<size_t>> packageIndices;
+
+            for (size_t i = 0; i < packages.size(); ++i)
+            {
+                auto& indices = packageIndices[Utility::FoldCase(packages[i].Id.get())];
+                if (indices.empty())
+                {
+                    searchRequest.Inclusions.emplace_back(PackageMatchFilter(PackageMatchField::Id, MatchType::CaseInsensitive, packages[i].Id.get()));
+                }
+
+                indices.push_back(i);
+            }
+
+            SearchResult searchResult = source.Search(searchRequest);
+
+            for (auto& match : searchResult.Matches)
+            {
+                auto itr = packageIndices.find(Utility::FoldCase(match.Package->GetProperty(PackageProperty::Id).get()));
+                if (itr == packageIndices.end() && match.MatchCriteria.Field == PackageMatchField::Id)
+                {
+                    // Fall back to the inclusion that the source reports as having matched.
+                    itr = packageIndices.find(Utility::FoldCase(match.MatchCriteria.Value));
+                }
+
+                if (itr == packageIndices.end())
+                {
+                    continue;
+                }
+
+                for (size_t i : itr->second)
+                {
+                    results[i].Matches.emplace_back(match);
+                }
+            }
+
+            // A failure of the search is a failure for every package in it.
+            for (auto& result : results)
+            {
+                result.Truncated = searchResult.Truncated;
+                result.Failures = searchResult.Failures;
+            }
+
+            return results;
+        }
+
+        // Finds the package versions to install for the requests, which are all for the source, adding a context ready
+        // to install each one to packagesToInstall and the ids of the packages that were not found to notFound.
+        // Returns false if the overall operation was cancelled.
+        bool FindPackagesForImport(
+            Execution::Context& context,
+            Repository::Source& source,
+            const std::vector<PackageCollection::Package>& packageRequests,
+            std::vector<std::unique_ptr<Execution::Context>>& packagesToInstall,
+            std::vector<Utility::LocIndString>& notFound)
+        {
+            // All of the packages are found first, so that the manifests of the requested versions can be retrieved together.
+            // Each search is done in a sub context to search everything regardless of previous failures.
+            std::vector<SearchResult> searchResults = SearchForPackages(source, packageRequests);
+            std::vector<std::unique_ptr<Execution::Context>> searchContexts;
+            std::vector<std::shared_ptr<IPackageVersion>> requestedVersions;
+            for (size_t i = 0; i < packageRequests.size(); ++i)
+            {
+                const auto& packageRequest = packageRequests[i];
+                AICLI_LOG(CLI, Info, << "Searching for package [" << packageRequest.Id << "]");
+
+                auto searchContextPtr = context.CreateSubContext();
+                Execution::Context& searchContext = *searchContextPtr;
+                auto previousThreadGlobals = searchContext.SetForCurrentThread();
+
+                searchContext.Add<Execution::Data::Source>(source);
+                searchContext.Add<Execution::Data::SearchResult>(std::move(searchResults[i]));
+
+                // TODO: In the future, it would be better to not have to convert back and forth from a string
+                searchContext.Args.AddArg(Execution::Args::Type::InstallScope, ScopeToString(packageRequest.Scope));
+
+                searchContext <<
+                    Workflow::HandleSearchResultFailures <<
+                    Workflow::EnsureOneMatchFromSearchResult(false);
+
+                if (!searchContext.IsTerminated())
+                {
+                    PackageVersionKey key("", packageRequest.VersionAndChannel.GetVersion().ToString(), packageRequest.VersionAndChannel.GetChannel().ToString());
+                    requestedVersions.emplace_back(searchContext.Get<Execution::Data::Package>()->GetAvailableVersion(key));
+                }
+
+                searchContexts.emplace_back(std::move(searchContextPtr));
+            }
+
+            PrefetchManifests(requestedVersions);
+
+            for (size_t i = 0; i < packageRequests.size(); ++i)
+            {
+                const auto& packageRequest = packageRequests[i];
+                auto searchContextPtr = std::move(searchContexts[i]);
+                Execution::Context& searchContext = *searchContextPtr;
+                auto previousThreadGlobals = searchContext.SetForCurrentThread();
+
+                // Find the single version we want is available
+                searchContext <<
+                    Workflow::GetManifestWithVersionFromPackage(packageRequest.VersionAndChannel) <<
+                    Workflow::GetInstalledPackageVersion <<
+                    Workflow::SelectInstaller <<
+                    Workflow::EnsureApplicableInstaller;
+
+                if (searchContext.Contains(Execution::Data::InstalledPackageVersion) && searchContext.Get<Execution::Data::InstalledPackageVersion>())
+                {
+                    searchContext << Workflow::EnsureUpdateVersionApplicable;
+                }
+
+                if (searchContext.IsTerminated())
+                {
+                    if (context.IsTerminated() && context.GetTerminationHR() == E_ABORT)
+                    {
+                        // This means that the subcontext being terminated is due to an overall abort
+                        context.Reporter.Info() << Resource::String::Cancelled << std::endl;
+                        return false;
+                    }
+                    else if (searchContext.GetTerminationHR() == APPINSTALLER_CLI_ERROR_UPDATE_NOT_APPLICABLE)
+                    {
+                        AICLI_LOG(CLI, Info, << "Package is already installed: [" << packageRequest.Id << "]");
+                        context.Reporter.Info() << Resource::String::ImportPackageAlreadyInstalled << ' ' << packageRequest.Id << std::endl;
+                        continue;
+                    }
+                    else
+                    {
+                        // Keep searching for the remaining packages and only fail at the end.
+                        AICLI_LOG(CLI, Info, << "Package not found for import: [" << packageRequest.Id << "], Version " << packageRequest.VersionAndChannel.ToString());
+                        context.Reporter.Info() << Resource::String::ImportSearchFailed << ' ' << packageRequest.Id << std::endl;
+                        notFound.emplace_back(packageRequest.Id);
+                        continue;
+                    }
+                }
+
+                packagesToInstall.emplace_back(std::move(searchContextPtr));
+            }
+
+            return true;
+        }
+
+        // Fails the import if any packages could not be found, unless unavailable packages are ignored.
+        void ReportPackagesNotFoundForImport(Execution::Context& context, const std::vector<Utility::LocIndString>& notFound)
+        {
+            if (notFound.empty())
+            {
+                return;
+            }
+
+            AICLI_LOG(CLI, Info, << "Could not find " << notFound.size() << " package(s) for import");
+            if (context.Args.Contains(Execution::Args::Type::IgnoreUnavailable))
+            {
+                AICLI_LOG(CLI, Info, << "Ignoring unavailable packages due to command line argument");
+            }
+            else
+            {
+                AICLI_TERMINATE_CONTEXT(APPINSTALLER_CLI_ERROR_NOT_ALL_PACKAGES_FOUND);
+            }
+        }
     }
 
     void SelectVersionsToExport(Execution::Context& context)
@@ -99,6 +271,11 @@ namespace AppInstaller::CLI::Workflow
         PackageCollection exportedPackages;
         exportedPackages.ClientVersion = Runtime::GetClientVersion().get();
         auto& exportedSources = exportedPackages.Sources;
+
+        // The manifests of the available versions are needed to check for agreements, so all of the
+        // versions are found first and their manifests are retrieved together.
+        std::vector<std::shared_ptr<IPackageVersion>> installedPackageVersions;
+        std::vector<std::shared_ptr<IPackageVersion>> availablePackageVersions;
         for (const auto& packageMatch : searchResult.Matches)
         {
             auto installedPackageVersion = packageMatch.Package->GetInstalledVersion();
@@ -115,6 +292,19 @@ namespace AppInstaller::CLI::Workflow
                 continue;
             }
 
+            installedPackageVersions.emplace_back(std::move(installedPackageVersion));
+            availablePackageVersions.emplace_back(std::move(availablePackageVersion));
+        }
+
+        PrefetchManifests(availablePackageVersions);
+
+        for (size_t i = 0; i < availablePackageVersions.size(); ++i)
+        {
+            const auto& installedPackageVersion = installedPackageVersions[i];
+            const auto& availablePackageVersion = availablePackageVersions[i];
+            auto version = installedPackageVersion->GetProperty(PackageVersionProperty::Version);
+            auto channel = installedPackageVersion->GetProperty(PackageVersionProperty::Channel);
+
             const auto& sourceDetails = availablePackageVersion->GetSource().GetDetails();
             AICLI_LOG(CLI, Info,
                 << "Installed package is available. Package Id [" << availablePackageVersion->GetProperty(PackageVersionProperty::Id) << "], Source [" << sourceDetails.Identifier << "]");
@@ -247,7 +437,7 @@ namespace AppInstaller::CLI::Workflow
     {
         const auto& sources = context.Get<Execution::Data::Sources>();
         std::vector<std::unique_ptr<Execution::Context>> packagesToInstall;
-        bool foundAll = true;
+        std::vector<Utility::LocIndString> notFound;
 
         // Look for the packages needed from each source independently.
         // If a package is available from multiple sources, this ensures we will get it from the right one.
@@ -260,95 +450,111 @@ namespace AppInstaller::CLI::Workflow
                 AICLI_TERMINATE_CONTEXT(APPINSTALLER_CLI_ERROR_INTERNAL_ERROR);
             }
 
-            // Search for all the packages in the source.
-            // Each search is done in a sub context to search everything regardless of previous failures.
             Repository::Source source{ context.Get<Execution::Data::Source>(), *sourceItr, CompositeSearchBehavior::AllPackages };
             AICLI_LOG(CLI, Info, << "Searching for packages requested from source [" << requiredSource.Details.Identifier << "]");
-            for (const auto& packageRequest : requiredSource.Packages)
+
+            if (!FindPackagesForImport(context, source, requiredSource.Packages, packagesToInstall, notFound))
             {
-                AICLI_LOG(CLI, Info, << "Searching for package [" << packageRequest.Id << "]");
+                return;
+            }
+        }
 
-                // Search for the current package
-                SearchRequest searchRequest;
-                searchRequest.Filters.emplace_back(PackageMatchFilter(PackageMatchField::Id, MatchType::CaseInsensitive, packageRequest.Id.get()));
+        ReportPackagesNotFoundForImport(context, notFound);
+        if (context.IsTerminated())
+        {
+            return;
+        }
 
-                auto searchContextPtr = context.CreateSubContext();
-                Execution::Context& searchContext = *searchContextPtr;
-                auto previousThreadGlobals = searchContext.SetForCurrentThread();
+        context.Add<Execution::Data::PackagesToInstall>(std::move(packagesToInstall));
+    }
 
-                searchContext.Add<Execution::Data::Source>(source);
-                searchContext.Add<Execution::Data::SearchResult>(source.Search(searchRequest));
+    void InstallImportedPackages(Execution::Context& context)
+    {
+        context << Workflow::InstallMultiplePackages(
+            Resource::String::ImportCommandReportDependencies, APPINSTALLER_CLI_ERROR_IMPORT_INSTALL_FAILED, {}, true, true);
 
-                // TODO: In the future, it would be better to not have to convert back and forth from a string
-                searchContext.Args.AddArg(Execution::Args::Type::InstallScope, ScopeToString(packageRequest.Scope));
+        if (context.GetTerminationHR() == APPINSTALLER_CLI_ERROR_IMPORT_INSTALL_FAILED)
+        {
+            context.Reporter.Error() << Resource::String::ImportInstallFailed << std::endl;
+        }
+    }
 
-                // Find the single version we want is available
-                searchContext <<
-                    Workflow::HandleSearchResultFailures <<
-                    Workflow::EnsureOneMatchFromSearchResult(false) <<
-                    Workflow::GetManifestWithVersionFromPackage(packageRequest.VersionAndChannel) <<
-                    Workflow::GetInstalledPackageVersion <<
-                    Workflow::SelectInstaller <<
-                    Workflow::EnsureApplicableInstaller;
+    void SearchAndInstallPackagesForImport(Execution::Context& context)
+    {
+        const auto& sources = context.Get<Execution::Data::Sources>();
+        std::vector<Utility::LocIndString> notFound;
+        bool allInstalled = true;
 
-                if (searchContext.Contains(Execution::Data::InstalledPackageVersion) && searchContext.Get<Execution::Data::InstalledPackageVersion>())
+        // The first batch is a single package, so that its install starts as soon as it is found. The batches then grow,
+        // so that the later ones still look up their packages together and download ahead while installing.
+        size_t batchSize = 1;
+
+        for (auto& requiredSource : context.Get<Execution::Data::PackageCollection>().Sources)
+        {
+            auto sourceItr = FindSource(sources, requiredSource.Details);
+            if (sourceItr == sources.end())
+            {
+                AICLI_TERMINATE_CONTEXT(APPINSTALLER_CLI_ERROR_INTERNAL_ERROR);
+            }
+
+            Repository::Source source{ context.Get<Execution::Data::Source>(), *sourceItr, CompositeSearchBehavior::AllPackages };
+            AICLI_LOG(CLI, Info, << "Searching for packages to install as they are found from source [" << requiredSource.Details.Identifier << "]");
+
+            const auto& packageRequests = requiredSource.Packages;
+            for (size_t batchStart = 0; batchStart < packageRequests.size();)
+            {
+                size_t batchEnd = std::min(batchStart + batchSize, packageRequests.size());
+                std::vector<PackageCollection::Package> batch{ packageRequests.begin() + batchStart, packageRequests.begin() + batchEnd };
+                batchStart = batchEnd;
+                batchSize = std::min(batchSize * 2, MaximumImportBatchSize);
+
+                std::vector<std::unique_ptr<Execution::Context>> packagesToInstall;
+                if (!FindPackagesForImport(context, source, batch, packagesToInstall, notFound))
                 {
-                    searchContext << Workflow::EnsureUpdateVersionApplicable;
+                    return;
                 }
 
-                if (searchContext.IsTerminated())
+                if (packagesToInstall.empty())
                 {
-                    if (context.IsTerminated() && context.GetTerminationHR() == E_ABORT)
-                    {
-                        // This means that the subcontext being terminated is due to an overall abort
-                        context.Reporter.Info() << Resource::String::Cancelled << std::endl;
-                        return;
-                    }
-                    else if (searchContext.GetTerminationHR() == APPINSTALLER_CLI_ERROR_UPDATE_NOT_APPLICABLE)
-                    {
-                        AICLI_LOG(CLI, Info, << "Package is already installed: [" << packageRequest.Id << "]");
-                        context.Reporter.Info() << Resource::String::ImportPackageAlreadyInstalled << ' ' << packageRequest.Id << std::endl;
-                        continue;
-                    }
-                    else
-                    {
-                        AICLI_LOG(CLI, Info, << "Package not found for import: [" << packageRequest.Id << "], Version " << packageRequest.VersionAndChannel.ToString());
-                        context.Reporter.Info() << Resource::String::ImportSearchFailed << ' ' << packageRequest.Id << std::endl;
+                    continue;
+                }
 
-                        // Keep searching for the remaining packages and only fail at the end.
-                        foundAll = false;
-                        continue;
-                    }
+                // Each batch is installed in a context of its own, so that a failed install does not stop the next batches.
+                auto installContextPtr = context.CreateSubContext();
+                Execution::Context& installContext = *installContextPtr;
+                installContext.Args = context.Args;
+                installContext.Add<Execution::Data::PackagesToInstall>(std::move(packagesToInstall));
+
+                installContext << Workflow::InstallMultiplePackages(
+                    Resource::String::ImportCommandReportDependencies, APPINSTALLER_CLI_ERROR_IMPORT_INSTALL_FAILED, {}, true, true);
+
+                if (context.IsTerminated())
+                {
+                    return;
                 }
 
-                packagesToInstall.emplace_back(std::move(searchContextPtr));
-            }
-        }
+                if (installContext.IsTerminated())
+                {
+                    if (installContext.GetTerminationHR() != APPINSTALLER_CLI_ERROR_IMPORT_INSTALL_FAILED)
+                    {
+                        // Such as the package agreements not being accepted
+                        AICLI_TERMINATE_CONTEXT(installContext.GetTerminationHR());
+                    }
 
-        if (!foundAll)
-        {
-            AICLI_LOG(CLI, Info, << "Could not find one or more packages for import");
-            if (context.Args.Contains(Execution::Args::Type::IgnoreUnavailable))
-            {
-                AICLI_LOG(CLI, Info, << "Ignoring unavailable packages due to command line argument");
-            }
-            else
-            {
-                AICLI_TERMINATE_CONTEXT(APPINSTALLER_CLI_ERROR_NOT_ALL_PACKAGES_FOUND);
+                    allInstalled = false;
+                }
             }
         }
 
-        context.Add<Execution::Data::PackagesToInstall>(std::move(packagesToInstall));
-    }
+        ReportPackagesNotFoundForImport(context, notFound);
 
-    void InstallImportedPackages(Execution::Context& context)
-    {
-        context << Workflow::InstallMultiplePackages(
-            Resource::String::ImportCommandReportDependencies, APPINSTALLER_CLI_ERROR_IMPORT_INSTALL_FAILED, {}, true, true);
-
-        if (context.GetTerminationHR() == APPINSTALLER_CLI_ERROR_IMPORT_INSTALL_FAILED)
+        if (!allInstalled)
         {
             context.Reporter.Error() << Resource::String::ImportInstallFailed << std::endl;
+            if (!context.IsTerminated())
+            {
+                AICLI_TERMINATE_CONTEXT(APPINSTALLER_CLI_ERROR_IMPORT_INSTALL_FAILED);
+            }
         }
     }
 }
\ No newline at end of file
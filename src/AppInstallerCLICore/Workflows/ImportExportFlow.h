@@ -41,4 +41,11 @@ namespace AppInstaller::CLI::Workflow
     // Inputs: PackagesToInstall
     // Outputs: None
     void InstallImportedPackages(Execution::Context& context);
+
+    // Finds and installs the packages of an import file in batches, so that the first packages are installed without
+    // waiting for the rest to be found. The packages that could not be found are reported at the end.
+    // Required Args: None
+    // Inputs: PackageCollection, Sources, Source
+    // Outputs: None
+    void SearchAndInstallPackagesForImport(Execution::Context& context);
 }
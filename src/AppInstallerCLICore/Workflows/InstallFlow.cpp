@@ -12,6 +12,8 @@
 #include "WorkflowBase.h"
 #include "Workflows/DependenciesFlow.h"
 #include <AppInstallerDeployment.h>
+#include <AppInstallerMsixInfo.h>
+#include <winget/Timing.h>
 
 using namespace winrt::Windows::ApplicationModel::Store::Preview::InstallControl;
 using namespace winrt::Windows::Foundation;
@@ -44,6 +46,12 @@ namespace AppInstaller::CLI::Workflow
             }
         }
 
+        // Determines whether the installer is an MSI, so that its product code can stand in for an ARP snapshot.
+        bool IsMsiDatabase(InstallerTypeEnum type)
+        {
+            return type == InstallerTypeEnum::Msi || type == InstallerTypeEnum::Wix;
+        }
+
         bool ShouldUseDirectMSIInstall(InstallerTypeEnum type, bool isSilentInstall)
         {
             switch (type)
@@ -104,6 +112,94 @@ namespace AppInstaller::CLI::Workflow
             HRESULT HResult;
             Resource::StringId Message;
         };
+
+        // The maximum number of MSIX and Store packages that are installed at the same time by InstallMultiplePackages.
+        constexpr size_t MaximumConcurrentInstalls = 4;
+
+        // The maximum number of MSIX packages that are staged ahead of their turn by InstallMultiplePackages.
+        constexpr size_t MaximumConcurrentStages = 4;
+
+        // What the background work on a package does.
+        enum class BackgroundWorkKind
+        {
+            Download,
+            // For an MSIX installer, staging it as well, so that only its registration is left for its turn.
+            DownloadAndStage,
+            Install,
+        };
+
+        // The work on a package that runs while an earlier package installs; the download of its installer,
+        // and for packages that can be installed concurrently, the execution of the installer as well.
+        // Its output is kept until it is the package's turn so that it does not interleave with the foreground.
+        struct BackgroundWork
+        {
+            std::ostringstream Output;
+            std::future<void> Result;
+            bool IncludesInstall = false;
+        };
+
+        std::unique_ptr<BackgroundWork> StartBackgroundWork(Execution::Context& packageContext, BackgroundWorkKind kind)
+        {
+            auto result = std::make_unique<BackgroundWork>();
+            result->IncludesInstall = (kind == BackgroundWorkKind::Install);
+            packageContext.Reporter.RedirectOutput(result->Output);
+
+            result->Result = std::async(std::launch::async, [&packageContext, kind]()
+                {
+                    auto restoreOutput = wil::scope_exit([&]() { packageContext.Reporter.RestoreOutput(); });
+                    auto previousThreadGlobals = packageContext.SetForCurrentThread();
+
+                    switch (kind)
+                    {
+                    case BackgroundWorkKind::Install:
+                        // The identity is reported here so that it still leads the output if the install fails
+                        packageContext <<
+                            Workflow::ReportIdentityAndInstallationDisclaimer <<
+                            Workflow::DownloadInstaller <<
+                            Workflow::ExecutePackageInstaller;
+                        break;
+                    case BackgroundWorkKind::DownloadAndStage:
+                        packageContext <<
+                            Workflow::DownloadInstaller <<
+                            Workflow::StageMsixInstaller;
+                        break;
+                    default:
+                        packageContext << Workflow::DownloadInstaller;
+                        break;
+                    }
+                });
+
+            return result;
+        }
+
+        bool IsMsixInstaller(Execution::Context& packageContext)
+        {
+            const auto& installer = packageContext.Get<Execution::Data::Installer>();
+            return installer && installer->InstallerType == InstallerTypeEnum::Msix;
+        }
+
+        // MSIX deployments are transactional and handled by the system, and Store installs are queued and run by the Store client,
+        // so both can run alongside each other and alongside other installers. Packages with dependencies to install stay in order behind them.
+        // MSIX packages that are staged ahead are not, so that their registrations stay in the order of the packages.
+        bool CanInstallConcurrently(Execution::Context& packageContext, bool ignorePackageDependencies, bool stageMsix)
+        {
+            const auto& installer = packageContext.Get<Execution::Data::Installer>();
+            return installer &&
+                ((installer->InstallerType == InstallerTypeEnum::Msix && !stageMsix) || installer->InstallerType == InstallerTypeEnum::MSStore) &&
+                (ignorePackageDependencies || !installer->Dependencies.HasAny());
+        }
+
+        std::string GetMsixInstallerUri(Execution::Context& context)
+        {
+            if (context.Contains(Execution::Data::InstallerPath))
+            {
+                return context.Get<Execution::Data::InstallerPath>().u8string();
+            }
+            else
+            {
+                return context.Get<Execution::Data::Installer>()->Url;
+            }
+        }
     }
 
     void EnsureApplicableInstaller(Execution::Context& context)
@@ -215,6 +311,7 @@ namespace AppInstaller::CLI::Workflow
 
     void ExecuteInstaller(Execution::Context& context)
     {
+        Timing::Span span{ Timing::Phase::Install };
         const auto& installer = context.Get<Execution::Data::Installer>().value();
 
         bool isUpdate = WI_IsFlagSet(context.GetFlags(), Execution::ContextFlag::InstallerExecutionUseUpdate);
@@ -274,26 +371,42 @@ namespace AppInstaller::CLI::Workflow
 
     void MsixInstall(Execution::Context& context)
     {
-        std::string uri;
-        if (context.Contains(Execution::Data::InstallerPath))
-        {
-            uri = context.Get<Execution::Data::InstallerPath>().u8string();
-        }
-        else
-        {
-            uri = context.Get<Execution::Data::Installer>()->Url;
-        }
+        std::string uri = GetMsixInstallerUri(context);
 
         context.Reporter.Info() << Resource::String::InstallFlowStartingPackageInstall << std::endl;
 
         bool registrationDeferred = false;
+        bool skipSmartScreen = WI_IsFlagSet(context.GetFlags(), Execution::ContextFlag::InstallerTrusted);
+
+        std::shared_ptr<StagedMsixPackage> stagedPackage;
+        if (context.Contains(Execution::Data::StagedMsixPackage))
+        {
+            stagedPackage = context.Get<Execution::Data::StagedMsixPackage>();
+        }
 
         try
         {
             registrationDeferred = context.Reporter.ExecuteWithProgress([&](IProgressCallback& callback)
             {
-                return Deployment::AddPackageWithDeferredFallback(uri, WI_IsFlagSet(context.GetFlags(), Execution::ContextFlag::InstallerTrusted), callback);
+                // SmartScreen is only checked by adding the package, which then finds it staged and only registers it.
+                if (skipSmartScreen && WI_IsFlagSet(context.GetFlags(), Execution::ContextFlag::InstallerStaged))
+                {
+                    // Which removes the package itself if registering it fails
+                    if (stagedPackage)
+                    {
+                        stagedPackage->Release();
+                    }
+
+                    return Deployment::RegisterStagedPackage(uri, callback);
+                }
+
+                return Deployment::AddPackageWithDeferredFallback(uri, skipSmartScreen, callback);
             });
+
+            if (stagedPackage)
+            {
+                stagedPackage->Release();
+            }
         }
         catch (const wil::ResultException& re)
         {
@@ -312,6 +425,40 @@ namespace AppInstaller::CLI::Workflow
         }
     }
 
+    void StageMsixInstaller(Execution::Context& context)
+    {
+        // An installer whose hash did not match is only deployed if the mismatch is overridden when it is installed.
+        if (!WI_IsFlagSet(context.GetFlags(), Execution::ContextFlag::InstallerHashMatched))
+        {
+            return;
+        }
+
+        std::string uri = GetMsixInstallerUri(context);
+
+        try
+        {
+            // A package that is already registered for the user is only staged again, and must be left as it is.
+            std::string packageFullName = Msix::MsixInfo{ uri }.GetPackageFullName();
+            bool isRegistered = static_cast<bool>(winrt::Windows::Management::Deployment::PackageManager{}.FindPackageForUser({}, Utility::ConvertToUTF16(packageFullName)));
+
+            context.Reporter.ExecuteWithProgress([&](IProgressCallback& callback)
+                {
+                    Deployment::StagePackage(uri, callback);
+                });
+            context.SetFlags(Execution::ContextFlag::InstallerStaged);
+
+            if (!isRegistered)
+            {
+                context.Add<Execution::Data::StagedMsixPackage>(std::make_shared<StagedMsixPackage>(std::move(packageFullName)));
+            }
+        }
+        catch (const wil::ResultException& re)
+        {
+            // Such as for a package whose dependencies are installed by an earlier package
+            AICLI_LOG(CLI, Warning, << "Failed to stage the package ahead of its install: " << WINGET_OSTREAM_FORMAT_HRESULT(re.GetErrorCode()));
+        }
+    }
+
     void ReportInstallerResult::operator()(Execution::Context& context) const
     {
         DWORD installResult = context.Get<Execution::Data::InstallerReturnCode>();
@@ -361,19 +508,31 @@ namespace AppInstaller::CLI::Workflow
             Workflow::ShowInstallationDisclaimer;
     }
 
-    void InstallPackageInstaller(Execution::Context& context)
+    void ExecutePackageInstaller(Execution::Context& context)
     {
         context <<
             Workflow::ReportExecutionStage(ExecutionStage::PreExecution) <<
             Workflow::SnapshotARPEntries <<
             Workflow::ReportExecutionStage(ExecutionStage::Execution) <<
-            Workflow::ExecuteInstaller <<
+            Workflow::ExecuteInstaller;
+    }
+
+    void CompletePackageInstall(Execution::Context& context)
+    {
+        context <<
             Workflow::ReportExecutionStage(ExecutionStage::PostExecution) <<
             Workflow::ReportARPChanges <<
             Workflow::RecordInstall <<
             Workflow::RemoveInstaller;
     }
 
+    void InstallPackageInstaller(Execution::Context& context)
+    {
+        context <<
+            Workflow::ExecutePackageInstaller <<
+            Workflow::CompletePackageInstall;
+    }
+
     void DownloadSinglePackage(Execution::Context& context)
     {
         context <<
@@ -419,25 +578,166 @@ namespace AppInstaller::CLI::Workflow
         }
 
         bool allSucceeded = true;
-        size_t packagesCount = context.Get<Execution::Data::PackagesToInstall>().size();
-        size_t packagesProgress = 0;
-        
-        for (auto& packageContext : context.Get<Execution::Data::PackagesToInstall>())
+        auto& packagesToInstall = context.Get<Execution::Data::PackagesToInstall>();
+        size_t packagesCount = packagesToInstall.size();
+
+        // Until an installer changes ARP, each package can compare against the entries read for the one before it
+        auto arpEntriesCache = std::make_shared<ARPEntriesCache>();
+        for (auto& packageContext : packagesToInstall)
         {
-            packagesProgress++;
-            context.Reporter.Info() << "(" << packagesProgress << "/" << packagesCount << ") ";
+            packageContext->Add<Execution::Data::ARPEntriesCache>(arpEntriesCache);
+        }
+
+        // Installs are done one at a time, but the installers of the next packages are downloaded while a package installs.
+        // Packages that can be installed concurrently are installed in the background as well, in their own lane.
+        // Either way, the results are reported in the order of the packages.
+        size_t downloadAhead = User().Get<Setting::NetworkDownloadAhead>();
+        std::vector<std::unique_ptr<BackgroundWork>> backgroundWork(packagesCount);
+
+        // Most of the time of an MSIX deployment is spent staging the package, so when there are several of them,
+        // they are staged ahead of their turn and only registered when it comes, one at a time in the order of the packages.
+        std::vector<bool> isMsix(packagesCount);
+        for (size_t packageIndex = 0; packageIndex < packagesCount; ++packageIndex)
+        {
+            isMsix[packageIndex] = IsMsixInstaller(*packagesToInstall[packageIndex]);
+        }
+
+        bool stageMsix = std::count(isMsix.begin(), isMsix.end(), true) > 1;
+
+        std::vector<bool> installConcurrently(packagesCount);
+        for (size_t packageIndex = 0; packageIndex < packagesCount; ++packageIndex)
+        {
+            installConcurrently[packageIndex] = CanInstallConcurrently(*packagesToInstall[packageIndex], m_ignorePackageDependencies, stageMsix);
+        }
+
+        auto downloadKind = [&](size_t packageIndex)
+            {
+                return (stageMsix && isMsix[packageIndex]) ? BackgroundWorkKind::DownloadAndStage : BackgroundWorkKind::Download;
+            };
+
+        // When the packages are levels of a dependency graph, a package can only be installed once the levels before it are.
+        // This is the index of the first package of its level; the packages are in the order of their levels.
+        std::vector<size_t> levelStart(packagesCount);
+        if (context.Contains(Execution::Data::PackagesToInstallLevels))
+        {
+            const auto& levels = context.Get<Execution::Data::PackagesToInstallLevels>();
+            for (size_t packageIndex = 1; packageIndex < packagesCount; ++packageIndex)
+            {
+                levelStart[packageIndex] = (levels[packageIndex] == levels[packageIndex - 1] ? levelStart[packageIndex - 1] : packageIndex);
+            }
+        }
+
+        // The background work uses the package contexts, so any still running must finish before leaving.
+        auto waitForBackgroundWork = wil::scope_exit([&]()
+            {
+                for (const auto& work : backgroundWork)
+                {
+                    if (work && work->Result.valid())
+                    {
+                        work->Result.wait();
+                    }
+                }
+            });
+
+        for (size_t packageIndex = 0; packageIndex < packagesCount; ++packageIndex)
+        {
+            // Keep the concurrent lane full with the next packages that can be installed in it
+            size_t concurrentInstalls = 0;
+            for (size_t nextIndex = packageIndex; nextIndex < packagesCount && concurrentInstalls < MaximumConcurrentInstalls && !context.IsTerminated(); ++nextIndex)
+            {
+                if (levelStart[nextIndex] > packageIndex)
+                {
+                    // The packages before this one are not all installed yet, and neither are those of the next levels
+                    break;
+                }
+
+                if (!installConcurrently[nextIndex])
+                {
+                    continue;
+                }
+
+                if (!backgroundWork[nextIndex])
+                {
+                    backgroundWork[nextIndex] = StartBackgroundWork(*packagesToInstall[nextIndex], BackgroundWorkKind::Install);
+                }
+
+                if (backgroundWork[nextIndex]->IncludesInstall)
+                {
+                    ++concurrentInstalls;
+                }
+            }
+
+            // Keep the next MSIX packages staging, regardless of the levels as staging does not register anything
+            size_t stagingPackages = 0;
+            for (size_t nextIndex = packageIndex; stageMsix && nextIndex < packagesCount && stagingPackages < MaximumConcurrentStages && !context.IsTerminated(); ++nextIndex)
+            {
+                if (!isMsix[nextIndex])
+                {
+                    continue;
+                }
+
+                if (!backgroundWork[nextIndex])
+                {
+                    backgroundWork[nextIndex] = StartBackgroundWork(*packagesToInstall[nextIndex], BackgroundWorkKind::DownloadAndStage);
+                }
+
+                ++stagingPackages;
+            }
+
+            context.Reporter.Info() << "(" << (packageIndex + 1) << "/" << packagesCount << ") ";
 
             // We want to do best effort to install all packages regardless of previous failures
-            Execution::Context& installContext = *packageContext;
+            Execution::Context& installContext = *packagesToInstall[packageIndex];
+
+            // The context is not used here until the background work is done with it
+            std::unique_ptr<BackgroundWork>& work = backgroundWork[packageIndex];
+            if (work)
+            {
+                work->Result.wait();
+            }
+
             auto previousThreadGlobals = installContext.SetForCurrentThread();
 
-            installContext << Workflow::ReportIdentityAndInstallationDisclaimer;
-            if (!m_ignorePackageDependencies)
+            // Packages installed in the background have no dependencies to manage
+            if (!work || !work->IncludesInstall)
             {
-                installContext << Workflow::ManagePackageDependencies(m_dependenciesReportMessage);
+                installContext << Workflow::ReportIdentityAndInstallationDisclaimer;
+                if (!m_ignorePackageDependencies)
+                {
+                    installContext << Workflow::ManagePackageDependencies(m_dependenciesReportMessage);
+                }
+            }
+
+            if (work)
+            {
+                installContext.Reporter.Info() << Utility::LocIndString{ work->Output.str() };
+
+                // Rethrows anything thrown by the background work, as it would have been if done here
+                work->Result.get();
+            }
+            else
+            {
+                installContext << Workflow::DownloadInstaller;
+            }
+
+            // Start the next downloads only once this one is done, so that it is not competing with them
+            for (size_t nextIndex = packageIndex + 1; nextIndex < packagesCount && nextIndex <= packageIndex + downloadAhead; ++nextIndex)
+            {
+                if (!backgroundWork[nextIndex] && !context.IsTerminated())
+                {
+                    backgroundWork[nextIndex] = StartBackgroundWork(*packagesToInstall[nextIndex], downloadKind(nextIndex));
+                }
+            }
+
+            // The install is completed here even when the installer ran in the background, as recording it is not safe to do concurrently
+            if (work && work->IncludesInstall)
+            {
+                installContext << Workflow::CompletePackageInstall;
+            }
+            else
+            {
+                installContext << Workflow::InstallPackageInstaller;
             }
-            installContext << Workflow::DownloadInstaller;
-            installContext << Workflow::InstallPackageInstaller;
 
             installContext.Reporter.Info() << std::endl;
 
@@ -463,6 +763,82 @@ namespace AppInstaller::CLI::Workflow
         }
     }
 
+    StagedMsixPackage::~StagedMsixPackage()
+    {
+        if (m_released)
+        {
+            return;
+        }
+
+        AICLI_LOG(CLI, Info, << "Removing the package that was staged but not registered: " << m_packageFullName);
+
+        try
+        {
+            ProgressCallback progress;
+            Deployment::RemovePackage(m_packageFullName, progress);
+        }
+        CATCH_LOG();
+    }
+
+    ARPEntriesCache::Watch::Watch()
+    {
+        try
+        {
+            m_changed.create(wil::EventOptions::ManualReset);
+
+            const std::wstring uninstallKeyPath{ L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall" };
+            const std::pair<HKEY, REGSAM> uninstallKeys[] =
+            {
+                { HKEY_LOCAL_MACHINE, KEY_WOW64_64KEY },
+                { HKEY_LOCAL_MACHINE, KEY_WOW64_32KEY },
+                { HKEY_CURRENT_USER, 0 },
+            };
+
+            for (const auto& [root, view] : uninstallKeys)
+            {
+                wil::unique_hkey key;
+                THROW_IF_WIN32_ERROR(RegOpenKeyExW(root, uninstallKeyPath.c_str(), 0, KEY_NOTIFY | view, &key));
+
+                // The notification stays armed after this thread exits, for as long as the key is open
+                THROW_IF_WIN32_ERROR(RegNotifyChangeKeyValue(
+                    key.get(), TRUE, REG_NOTIFY_CHANGE_NAME | REG_NOTIFY_CHANGE_LAST_SET | REG_NOTIFY_THREAD_AGNOSTIC, m_changed.get(), TRUE));
+
+                m_keys.emplace_back(std::move(key));
+            }
+        }
+        catch (...)
+        {
+            // A key that cannot be watched (or does not exist yet) means changes cannot be detected, so treat ARP as always changed
+            LOG_CAUGHT_EXCEPTION();
+            m_keys.clear();
+        }
+    }
+
+    bool ARPEntriesCache::Watch::HasChanged() const
+    {
+        return m_keys.empty() || m_changed.is_signaled();
+    }
+
+    std::optional<ARPEntriesCache::Entries> ARPEntriesCache::Get() const
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+
+        if (m_watch && !m_watch->HasChanged())
+        {
+            return m_entries;
+        }
+
+        return {};
+    }
+
+    void ARPEntriesCache::Set(Entries entries, std::unique_ptr<Watch> watch)
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+
+        m_entries = std::move(entries);
+        m_watch = std::move(watch);
+    }
+
     void SnapshotARPEntries(Execution::Context& context) try
     {
         // Ensure that installer type might actually write to ARP, otherwise this is a waste of time
@@ -470,6 +846,36 @@ namespace AppInstaller::CLI::Workflow
 
         if (installer && MightWriteToARP(installer->InstallerType))
         {
+            // For an MSI, the entry it writes can be found by its product code afterward, so the full snapshot is not needed
+            if (IsMsiDatabase(installer->InstallerType) && context.Contains(Execution::Data::InstallerPath))
+            {
+                std::optional<std::string> productCode = ReadMsiProductCode(context.Get<Execution::Data::InstallerPath>());
+                if (productCode)
+                {
+                    bool wasInstalled = IsMsiProductInstalled(productCode.value());
+                    context.Add<Execution::Data::MsiProductSnapshot>(std::make_pair(std::move(productCode).value(), wasInstalled));
+                    return;
+                }
+            }
+
+            // Another package of the same operation may have read ARP since it last changed
+            std::shared_ptr<ARPEntriesCache> cache;
+            std::unique_ptr<ARPEntriesCache::Watch> watch;
+            if (context.Contains(Execution::Data::ARPEntriesCache))
+            {
+                cache = context.Get<Execution::Data::ARPEntriesCache>();
+
+                std::optional<ARPEntriesCache::Entries> cachedEntries = cache->Get();
+                if (cachedEntries)
+                {
+                    AICLI_LOG(CLI, Verbose, << "Using the ARP entries read by a previous package");
+                    context.Add<Execution::Data::ARPSnapshot>(std::move(cachedEntries).value());
+                    return;
+                }
+
+                watch = std::make_unique<ARPEntriesCache::Watch>();
+            }
+
             Source arpSource = context.Reporter.ExecuteWithProgress(
                 [](IProgressCallback& progress)
                 {
@@ -478,7 +884,7 @@ namespace AppInstaller::CLI::Workflow
                     return result;
                 }, true);
 
-            std::vector<std::tuple<Utility::LocIndString, Utility::LocIndString, Utility::LocIndString>> entries;
+            ARPEntriesCache::Entries entries;
 
             for (const auto& entry : arpSource.Search({}).Matches)
             {
@@ -494,6 +900,11 @@ namespace AppInstaller::CLI::Workflow
 
             std::sort(entries.begin(), entries.end());
 
+            if (cache)
+            {
+                cache->Set(entries, std::move(watch));
+            }
+
             context.Add<Execution::Data::ARPSnapshot>(std::move(entries));
         }
     }
@@ -501,9 +912,16 @@ namespace AppInstaller::CLI::Workflow
 
     void ReportARPChanges(Execution::Context& context) try
     {
-        if (context.Contains(Execution::Data::ARPSnapshot))
+        if (context.Contains(Execution::Data::ARPSnapshot) || context.Contains(Execution::Data::MsiProductSnapshot))
         {
-            const auto& entries = context.Get<Execution::Data::ARPSnapshot>();
+            // The entries read here are current for the next package of the operation, until ARP changes again
+            std::shared_ptr<ARPEntriesCache> cache;
+            std::unique_ptr<ARPEntriesCache::Watch> watch;
+            if (context.Contains(Execution::Data::ARPSnapshot) && context.Contains(Execution::Data::ARPEntriesCache))
+            {
+                cache = context.Get<Execution::Data::ARPEntriesCache>();
+                watch = std::make_unique<ARPEntriesCache::Watch>();
+            }
 
             // Open it again to get the (potentially) changed ARP entries
             Source arpSource = context.Reporter.ExecuteWithProgress(
@@ -516,23 +934,52 @@ namespace AppInstaller::CLI::Workflow
 
             std::vector<ResultMatch> changes;
 
-            for (auto& entry : arpSource.Search({}).Matches)
+            if (context.Contains(Execution::Data::MsiProductSnapshot))
             {
-                auto installed = entry.Package->GetInstalledVersion();
+                const auto& [productCode, wasInstalled] = context.Get<Execution::Data::MsiProductSnapshot>();
 
-                if (installed)
+                // The product is only a change if the install is what put it there
+                if (!wasInstalled && IsMsiProductInstalled(productCode))
                 {
-                    auto entryKey = std::make_tuple(
-                        entry.Package->GetProperty(PackageProperty::Id),
-                        installed->GetProperty(PackageVersionProperty::Version),
-                        installed->GetProperty(PackageVersionProperty::Channel));
+                    SearchRequest productCodeRequest;
+                    productCodeRequest.Inclusions.emplace_back(PackageMatchFilter(PackageMatchField::ProductCode, MatchType::CaseInsensitive, productCode));
+                    changes = std::move(arpSource.Search(productCodeRequest).Matches);
+                }
+            }
+            else
+            {
+                const auto& entries = context.Get<Execution::Data::ARPSnapshot>();
+                ARPEntriesCache::Entries currentEntries;
+
+                for (auto& entry : arpSource.Search({}).Matches)
+                {
+                    auto installed = entry.Package->GetInstalledVersion();
 
-                    auto itr = std::lower_bound(entries.begin(), entries.end(), entryKey);
-                    if (itr == entries.end() || *itr != entryKey)
+                    if (installed)
                     {
-                        changes.emplace_back(std::move(entry));
+                        auto entryKey = std::make_tuple(
+                            entry.Package->GetProperty(PackageProperty::Id),
+                            installed->GetProperty(PackageVersionProperty::Version),
+                            installed->GetProperty(PackageVersionProperty::Channel));
+
+                        if (cache)
+                        {
+                            currentEntries.emplace_back(entryKey);
+                        }
+
+                        auto itr = std::lower_bound(entries.begin(), entries.end(), entryKey);
+                        if (itr == entries.end() || *itr != entryKey)
+                        {
+                            changes.emplace_back(std::move(entry));
+                        }
                     }
                 }
+
+                if (cache)
+                {
+                    std::sort(currentEntries.begin(), currentEntries.end());
+                    cache->Set(std::move(currentEntries), std::move(watch));
+                }
             }
 
             // Also attempt to find the entry based on the manifest data
@@ -84,6 +84,13 @@ namespace AppInstaller::CLI::Workflow
     // Outputs: None
     void MsixInstall(Execution::Context& context);
 
+    // Stages the MSIX once its hash is verified, so that installing it only has to register it.
+    // A failure to stage is not an error; the install then deploys the package as usual.
+    // Required Args: None
+    // Inputs: Installer || InstallerPath
+    // Outputs: StagedMsixPackage?
+    void StageMsixInstaller(Execution::Context& context);
+
     // Reports the return code returned by the installer.
     // Required Args: None
     // Inputs: Manifest, Installer, InstallerResult
@@ -119,6 +126,18 @@ namespace AppInstaller::CLI::Workflow
     // Outputs: None
     void InstallPackageInstaller(Execution::Context& context);
 
+    // Runs a specific package installer; the first part of InstallPackageInstaller.
+    // Required Args: None
+    // Inputs: InstallerPath, Manifest, Installer
+    // Outputs: None
+    void ExecutePackageInstaller(Execution::Context& context);
+
+    // Records and cleans up after a package installer has run; the second part of InstallPackageInstaller.
+    // Required Args: None
+    // Inputs: InstallerPath, Manifest, Installer, PackageVersion, InstalledPackageVersion?
+    // Outputs: None
+    void CompletePackageInstall(Execution::Context& context);
+
     // Downloads the installer for a single package. This also does all the reporting and user interaction needed.
     // Required Args: None
     // Inputs: Manifest, Installer
@@ -161,15 +180,65 @@ namespace AppInstaller::CLI::Workflow
         bool m_ensurePackageAgreements;
     };
 
-    // Stores the existing set of packages in ARP.
+    // Holds the ARP entries last read by one of the packages of a multi-package operation, along with a
+    // notification on the ARP registry keys, so that the next package can use them while ARP is unchanged.
+    struct ARPEntriesCache
+    {
+        // Contains the { Id, Version, Channel }, sorted
+        using Entries = std::vector<std::tuple<Utility::LocIndString, Utility::LocIndString, Utility::LocIndString>>;
+
+        // Watches the ARP registry keys for changes; created before reading the entries that it guards.
+        struct Watch
+        {
+            Watch();
+
+            // Determines whether ARP has changed since the watch was created.
+            bool HasChanged() const;
+
+        private:
+            std::vector<wil::unique_hkey> m_keys;
+            wil::unique_event m_changed;
+        };
+
+        // Gets the entries if ARP has not changed since they were read.
+        std::optional<Entries> Get() const;
+
+        // Stores the entries that were read after the watch was created.
+        void Set(Entries entries, std::unique_ptr<Watch> watch);
+
+    private:
+        mutable std::mutex m_mutex;
+        Entries m_entries;
+        std::unique_ptr<Watch> m_watch;
+    };
+
+    // An MSIX package that was staged ahead of its install, which is removed again unless it gets registered.
+    // It is held by the context of its package, so that every way in which the install can end without registering it removes it.
+    struct StagedMsixPackage
+    {
+        StagedMsixPackage(std::string packageFullName) : m_packageFullName(std::move(packageFullName)) {}
+        ~StagedMsixPackage();
+
+        StagedMsixPackage(const StagedMsixPackage&) = delete;
+        StagedMsixPackage& operator=(const StagedMsixPackage&) = delete;
+
+        // Leaves the package on the system; for once it is registered, or an operation that removes it on failure has taken it over.
+        void Release() { m_released = true; }
+
+    private:
+        std::string m_packageFullName;
+        std::atomic<bool> m_released = false;
+    };
+
+    // Stores the existing set of packages in ARP, or for an MSI, its product code and whether it is installed.
     // Required Args: None
-    // Inputs: Installer
-    // Outputs: ARPSnapshot
+    // Inputs: Installer, InstallerPath?, ARPEntriesCache?
+    // Outputs: ARPSnapshot or MsiProductSnapshot
     void SnapshotARPEntries(Execution::Context& context);
 
     // Reports on the changes between the stored ARPSnapshot and the current values.
     // Required Args: None
-    // Inputs: ARPSnapshot?, Manifest, PackageVersion
+    // Inputs: ARPSnapshot? or MsiProductSnapshot?, ARPEntriesCache?, Manifest, PackageVersion
     // Outputs: None
     void ReportARPChanges(Execution::Context& context);
 
@@ -13,6 +13,9 @@ namespace AppInstaller::CLI::Workflow
 
     namespace
     {
+        // The longest time to go without reading the status of the install items when none of their events are raised.
+        constexpr DWORD s_StatusRefreshTimeoutMilliseconds = 1000;
+
         HRESULT WaitForMSStoreOperation(Execution::Context& context, IVectorView<AppInstallItem>& installItems)
         {
             for (auto const& installItem : installItems)
@@ -26,19 +29,33 @@ namespace AppInstaller::CLI::Workflow
             context.Reporter.ExecuteWithProgress(
                 [&](IProgressCallback& progress)
                 {
+                    // The Store client raises events as the items progress, so the status is only read again when one of them changes.
+                    wil::unique_event statusChanged{ wil::EventOptions::None };
+                    auto onStatusChanged = [&statusChanged](const AppInstallItem&, const IInspectable&) { statusChanged.SetEvent(); };
+
+                    std::vector<AppInstallItem::StatusChanged_revoker> statusChangedRevokers;
+                    std::vector<AppInstallItem::Completed_revoker> completedRevokers;
+                    for (auto const& installItem : installItems)
+                    {
+                        statusChangedRevokers.emplace_back(installItem.StatusChanged(winrt::auto_revoke, onStatusChanged));
+                        completedRevokers.emplace_back(installItem.Completed(winrt::auto_revoke, onStatusChanged));
+                    }
+
+                    auto removeCancellation = progress.SetCancellationFunction([&statusChanged]() { statusChanged.SetEvent(); });
+                    bool cancelRequested = false;
+
                     // We are aggregating all AppInstallItem progresses into one.
                     // Averaging every progress for now until we have a better way to find overall progress.
                     uint64_t overallProgressMax = 100 * static_cast<uint64_t>(installItems.Size());
-                    uint64_t currentProgress = 0;
 
-                    while (currentProgress < overallProgressMax)
+                    while (true)
                     {
-                        currentProgress = 0;
+                        uint64_t currentProgress = 0;
+                        bool allCompleted = true;
 
                         for (auto const& installItem : installItems)
                         {
                             const auto& status = installItem.GetCurrentStatus();
-                            currentProgress += static_cast<uint64_t>(status.PercentComplete());
 
                             errorCode = status.ErrorCode();
 
@@ -46,6 +63,25 @@ namespace AppInstaller::CLI::Workflow
                             {
                                 return;
                             }
+
+                            switch (status.InstallState())
+                            {
+                            case AppInstallState::Completed:
+                                currentProgress += 100;
+                                break;
+                            case AppInstallState::Canceled:
+                                errorCode = E_ABORT;
+                                return;
+                            default:
+                                currentProgress += static_cast<uint64_t>(status.PercentComplete());
+                                allCompleted = false;
+                                break;
+                            }
+                        }
+
+                        if (allCompleted || currentProgress >= overallProgressMax)
+                        {
+                            return;
                         }
 
                         // It may take a while for Store client to pick up the install request.
@@ -55,15 +91,19 @@ namespace AppInstaller::CLI::Workflow
                             progress.OnProgress(currentProgress, overallProgressMax, ProgressType::Percent);
                         }
 
-                        if (progress.IsCancelled())
+                        if (progress.IsCancelled() && !cancelRequested)
                         {
                             for (auto const& installItem : installItems)
                             {
                                 installItem.Cancel();
                             }
+
+                            cancelRequested = true;
                         }
 
-                        Sleep(100);
+                        // A change between reading the status and waiting still sets the event, so it is not missed;
+                        // the timeout only guards against an item that stops raising events.
+                        statusChanged.wait(s_StatusRefreshTimeoutMilliseconds);
                     }
                 });
 
@@ -193,15 +233,20 @@ namespace AppInstaller::CLI::Workflow
         constexpr std::wstring_view s_StoreClientPublisher = L"CN=Microsoft Corporation, O=Microsoft Corporation, L=Redmond, S=Washington, C=US"sv;
 
         // Policy check
+        // Both checks are started before waiting on either, so that they are made at the same time.
         AppInstallManager installManager;
-        if (installManager.IsStoreBlockedByPolicyAsync(s_StoreClientName, s_StoreClientPublisher).get())
+        auto storeBlockedOperation = installManager.IsStoreBlockedByPolicyAsync(s_StoreClientName, s_StoreClientPublisher);
+        auto appAllowedOperation = installManager.GetIsAppAllowedToInstallAsync(productId);
+
+        if (storeBlockedOperation.get())
         {
+            appAllowedOperation.Cancel();
             context.Reporter.Error() << Resource::String::MSStoreStoreClientBlocked << std::endl;
             AICLI_LOG(CLI, Error, << "Store client is blocked by policy. MSStore execution failed.");
             AICLI_TERMINATE_CONTEXT(APPINSTALLER_CLI_ERROR_MSSTORE_BLOCKED_BY_POLICY);
         }
 
-        if (!installManager.GetIsAppAllowedToInstallAsync(productId).get())
+        if (!appAllowedOperation.get())
         {
             context.Reporter.Error() << Resource::String::MSStoreAppBlocked << std::endl;
             AICLI_LOG(CLI, Error, << "App is blocked by policy. MSStore execution failed. ProductId: " << Utility::ConvertToUTF8(productId));
@@ -4,6 +4,7 @@
 #include "WorkflowBase.h"
 #include "ExecutionContext.h"
 #include "ManifestComparator.h"
+#include <winget/ManifestInstallerSummary.h>
 #include <winget/UserSettings.h>
 
 using namespace AppInstaller::CLI;
@@ -28,7 +29,7 @@ namespace AppInstaller::CLI::Workflow
 
             InapplicabilityFlags IsApplicable(const Manifest::ManifestInstaller& installer) override
             {
-                if (installer.MinOSVersion.empty() || Runtime::IsCurrentOSVersionGreaterThanOrEqual(Utility::Version(installer.MinOSVersion)))
+                if (installer.MinOSVersion.empty() || IsCurrentOSVersionGreaterThanOrEqual(installer.MinOSVersion))
                 {
                     return InapplicabilityFlags::None;
                 }
@@ -42,16 +43,35 @@ namespace AppInstaller::CLI::Workflow
                 result += installer.MinOSVersion;
                 return result;
             }
+
+        private:
+            // The installers of a manifest nearly always share the same few minimum versions, so each is only parsed and checked once.
+            bool IsCurrentOSVersionGreaterThanOrEqual(const std::string& minOSVersion)
+            {
+                auto itr = m_results.find(minOSVersion);
+                if (itr == m_results.end())
+                {
+                    itr = m_results.emplace(minOSVersion, Runtime::IsCurrentOSVersionGreaterThanOrEqual(Utility::Version(minOSVersion))).first;
+                }
+
+                return itr->second;
+            }
+
+            std::map<std::string, bool, std::less<>> m_results;
         };
 
         struct MachineArchitectureComparator : public details::ComparisonField
         {
-            MachineArchitectureComparator() : details::ComparisonField("Machine Architecture") {}
+            MachineArchitectureComparator() : details::ComparisonField("Machine Architecture")
+            {
+                InitializeRanks();
+            }
 
             MachineArchitectureComparator(std::vector<Utility::Architecture> allowedArchitectures) :
                 details::ComparisonField("Machine Architecture"), m_allowedArchitectures(std::move(allowedArchitectures))
             {
                 AICLI_LOG(CLI, Verbose, << "Architecture Comparator created with allowed architectures: " << GetAllowedArchitecturesString());
+                InitializeRanks();
             }
 
             // TODO: At some point we can do better about matching the currently installed architecture
@@ -141,18 +161,33 @@ namespace AppInstaller::CLI::Workflow
             }
 
         private:
-            int CheckAllowedArchitecture(Utility::Architecture architecture)
+            // Each architecture value starting at Unknown, so that the enum value plus one is the index.
+            static constexpr size_t s_ArchitectureCount = static_cast<size_t>(Utility::Architecture::Arm64) + 2;
+
+            // The rank of every architecture is computed once, so that checking an installer is a lookup.
+            void InitializeRanks()
             {
-                if (m_allowedArchitectures.empty())
+                for (size_t i = 0; i < s_ArchitectureCount; ++i)
                 {
-                    return Utility::IsApplicableArchitecture(architecture);
-                }
-                else
-                {
-                    return Utility::IsApplicableArchitecture(architecture, m_allowedArchitectures);
+                    Utility::Architecture architecture = static_cast<Utility::Architecture>(static_cast<int>(i) - 1);
+
+                    if (m_allowedArchitectures.empty())
+                    {
+                        m_ranks[i] = Utility::IsApplicableArchitecture(architecture);
+                    }
+                    else
+                    {
+                        m_ranks[i] = Utility::IsApplicableArchitecture(architecture, m_allowedArchitectures);
+                    }
                 }
             }
 
+            int CheckAllowedArchitecture(Utility::Architecture architecture) const
+            {
+                size_t index = static_cast<size_t>(static_cast<int>(architecture) + 1);
+                return (index < s_ArchitectureCount ? m_ranks[index] : Utility::InapplicableArchitecture);
+            }
+
             std::string GetAllowedArchitecturesString()
             {
                 std::stringstream result;
@@ -170,6 +205,7 @@ namespace AppInstaller::CLI::Workflow
             }
 
             std::vector<Utility::Architecture> m_allowedArchitectures;
+            std::array<int, s_ArchitectureCount> m_ranks{};
         };
 
         struct InstalledTypeComparator : public details::ComparisonField
@@ -582,6 +618,33 @@ namespace AppInstaller::CLI::Workflow
         return inapplicabilityResult;
     }
 
+    std::optional<std::vector<InapplicabilityFlags>> ManifestComparator::GetSummaryInapplicabilities(std::string_view installerSummary)
+    {
+        std::vector<Manifest::ManifestInstaller> installers = Manifest::ParseInstallerSummary(installerSummary);
+        if (installers.empty())
+        {
+            return {};
+        }
+
+        std::vector<InapplicabilityFlags> result;
+
+        for (const auto& installer : installers)
+        {
+            // The summary does not hold the locale, so the locale filters cannot rule out any installer.
+            auto inapplicability = IsApplicable(installer);
+            WI_ClearAllFlags(inapplicability, InapplicabilityFlags::Locale | InapplicabilityFlags::InstalledLocale);
+
+            if (inapplicability == InapplicabilityFlags::None)
+            {
+                return {};
+            }
+
+            result.push_back(inapplicability);
+        }
+
+        return result;
+    }
+
     bool ManifestComparator::IsFirstBetter(
         const Manifest::ManifestInstaller& first,
         const Manifest::ManifestInstaller& second)
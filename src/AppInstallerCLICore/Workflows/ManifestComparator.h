@@ -6,6 +6,7 @@
 #include <winget/RepositorySearch.h>
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -79,6 +80,10 @@ namespace AppInstaller::CLI::Workflow
         // Determines if an installer is applicable.
         InapplicabilityFlags IsApplicable(const Manifest::ManifestInstaller& installer);
 
+        // Gets the reasons that each installer in an installer summary is not applicable, ignoring the values that the summary does not hold.
+        // Returns an empty value if the summary is not present or if any of its installers may be applicable, in which case the manifest is needed.
+        std::optional<std::vector<InapplicabilityFlags>> GetSummaryInapplicabilities(std::string_view installerSummary);
+
         // Determines if the first installer is a better choice.
         bool IsFirstBetter(
             const Manifest::ManifestInstaller& first,
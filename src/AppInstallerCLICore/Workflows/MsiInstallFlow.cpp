@@ -3,6 +3,7 @@
 #include "pch.h"
 #include "MsiInstallFlow.h"
 #include "winget/MsiExecArguments.h"
+#include <MsiQuery.h>
 
 namespace AppInstaller::CLI::Workflow
 {
@@ -28,6 +29,51 @@ namespace AppInstaller::CLI::Workflow
         }
     }
 
+    std::optional<std::string> ReadMsiProductCode(const std::filesystem::path& msiPath)
+    {
+        PMSIHANDLE database;
+        UINT result = MsiOpenDatabaseW(msiPath.c_str(), MSIDBOPEN_READONLY, &database);
+        if (result != ERROR_SUCCESS)
+        {
+            AICLI_LOG(CLI, Info, << "Unable to open MSI database: " << result);
+            return {};
+        }
+
+        PMSIHANDLE view;
+        result = MsiDatabaseOpenViewW(database, L"SELECT `Value` FROM `Property` WHERE `Property` = 'ProductCode'", &view);
+        if (result == ERROR_SUCCESS)
+        {
+            result = MsiViewExecute(view, 0);
+        }
+
+        PMSIHANDLE record;
+        if (result == ERROR_SUCCESS)
+        {
+            result = MsiViewFetch(view, &record);
+        }
+
+        std::wstring productCode(39, L'\0');
+        DWORD productCodeLength = static_cast<DWORD>(productCode.size());
+        if (result == ERROR_SUCCESS)
+        {
+            result = MsiRecordGetStringW(record, 1, &productCode[0], &productCodeLength);
+        }
+
+        if (result != ERROR_SUCCESS || productCodeLength == 0)
+        {
+            AICLI_LOG(CLI, Info, << "Unable to read ProductCode from MSI database: " << result);
+            return {};
+        }
+
+        productCode.resize(productCodeLength);
+        return Utility::ConvertToUTF8(productCode);
+    }
+
+    bool IsMsiProductInstalled(const std::string& productCode)
+    {
+        return MsiQueryProductStateW(Utility::ConvertToUTF16(productCode).c_str()) == INSTALLSTATE_DEFAULT;
+    }
+
     void DirectMSIInstallImpl(Execution::Context& context)
     {
         context.Reporter.Info() << Resource::String::InstallFlowStartingPackageInstall << std::endl;
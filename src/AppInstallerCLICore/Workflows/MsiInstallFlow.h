@@ -10,4 +10,11 @@ namespace AppInstaller::CLI::Workflow
     // Inputs: InstallerArgs, Installer, InstallerPath, Manifest
     // Outputs: InstallerReturnCode
     void DirectMSIInstallImpl(Execution::Context& context);
+
+    // Reads the ProductCode property from the database of the MSI at the given path.
+    // Returns an empty value if the database cannot be read.
+    std::optional<std::string> ReadMsiProductCode(const std::filesystem::path& msiPath);
+
+    // Determines whether the product with the given product code is installed for the current user or the machine.
+    bool IsMsiProductInstalled(const std::string& productCode);
 }
@@ -204,7 +204,18 @@ namespace AppInstaller::CLI::Workflow
 
     void ShowAppVersions(Execution::Context& context)
     {
-        auto versions = context.Get<Execution::Data::Package>()->GetAvailableVersionKeys();
+        const auto& package = context.Get<Execution::Data::Package>();
+
+        // With a count, only the newest versions are retrieved rather than every one of them
+        std::vector<PackageVersionKey> versions;
+        if (context.Args.Contains(Execution::Args::Type::Count))
+        {
+            versions = package->GetLatestAvailableVersionKeys(std::stoul(std::string{ context.Args.GetArg(Execution::Args::Type::Count) }));
+        }
+        else
+        {
+            versions = package->GetAvailableVersionKeys();
+        }
 
         Execution::TableOutput<2> table(context.Reporter, { Resource::String::ShowVersion, Resource::String::ShowChannel });
         for (const auto& version : versions)
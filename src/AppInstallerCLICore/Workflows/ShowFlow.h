@@ -29,7 +29,7 @@ namespace AppInstaller::CLI::Workflow
     // Outputs: None
     void ShowManifestVersion(Execution::Context& context);
 
-    // Shows all versions for an application.
+    // Shows all versions for an application, or only the newest of them when a count is given.
     // Required Args: None
     // Inputs: SearchResult [only operates on first match]
     // Outputs: None
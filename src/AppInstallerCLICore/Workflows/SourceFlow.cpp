@@ -186,12 +186,35 @@ namespace AppInstaller::CLI::Workflow
 
     void UpdateSources(Execution::Context& context)
     {
+        // A background update started by another invocation has no window to report to, and may find nothing to do.
+        if (context.Args.Contains(Args::Type::SourceBackgroundUpdate))
+        {
+            for (const auto& sd : context.Get<Data::SourceList>())
+            {
+                Repository::Source source{ sd.Name };
+                auto updateFunction = [&](IProgressCallback& progress) { return source.RunBackgroundUpdate(progress); };
+                if (!context.Reporter.ExecuteWithProgress(updateFunction).empty())
+                {
+                    context.Reporter.Error() << Resource::String::SourceUpdateFailed << ' ' << sd.Name << std::endl;
+                }
+            }
+
+            return;
+        }
+
         if (!context.Args.Contains(Args::Type::SourceName))
         {
             context.Reporter.Info() << Resource::String::SourceUpdateAll << std::endl;
         }
 
         const std::vector<Repository::SourceDetails>& sources = context.Get<Data::SourceList>();
+
+        if (sources.size() > 1)
+        {
+            UpdateSourcesConcurrently(context);
+            return;
+        }
+
         for (const auto& sd : sources)
         {
             Repository::Source source{ sd.Name };
@@ -208,6 +231,50 @@ namespace AppInstaller::CLI::Workflow
         }
     }
 
+    void UpdateSourcesConcurrently(Execution::Context& context)
+    {
+        const std::vector<Repository::SourceDetails>& sources = context.Get<Data::SourceList>();
+
+        std::vector<std::string> labels;
+        for (const auto& sd : sources)
+        {
+            labels.emplace_back(sd.Name);
+        }
+
+        // Every current source is in the list, so the source with all of them updates the same set.
+        Repository::Source source{ std::string_view{} };
+
+        std::vector<Repository::SourceDetails> failedSources = context.Reporter.ExecuteWithMultiLineProgress(labels, [&](MultiLineProgress& progress)
+            {
+                auto getLine = [&](const Repository::SourceDetails& details)
+                {
+                    auto itr = std::find(labels.begin(), labels.end(), details.Name);
+                    THROW_HR_IF(E_UNEXPECTED, itr == labels.end());
+                    return static_cast<size_t>(itr - labels.begin());
+                };
+
+                return source.UpdateConcurrently(
+                    [&](const Repository::SourceDetails& details) -> IProgressCallback& { return progress.GetCallback(getLine(details)); },
+                    [&](const Repository::SourceDetails& details, bool updated)
+                    {
+                        size_t line = getLine(details);
+                        Resource::StringId result = Resource::String::Done;
+                        if (!updated)
+                        {
+                            result = progress.GetCallback(line).IsCancelled() ? Resource::String::Cancelled : Resource::String::SourceUpdateFailedResult;
+                        }
+
+                        progress.Complete(line, Resource::LocString{ result }.get());
+                    });
+            });
+
+        // The failures are reported by name once the progress is done, so that they are not lost among the lines.
+        for (const auto& failed : failedSources)
+        {
+            context.Reporter.Error() << Resource::String::SourceUpdateFailed << ' ' << failed.Name << std::endl;
+        }
+    }
+
     void RemoveSources(Execution::Context& context)
     {
         // TODO: We currently only allow removing a single source. If that changes,
@@ -48,6 +48,12 @@ namespace AppInstaller::CLI::Workflow
     // Outputs: None
     void UpdateSources(Execution::Context& context);
 
+    // Updates all of the sources in SourceList at the same time, showing the progress of each on its own line.
+    // Required Args: None
+    // Inputs: SourceList
+    // Outputs: None
+    void UpdateSourcesConcurrently(Execution::Context& context);
+
     // Removes the sources in SourceList.
     // Required Args: None
     // Inputs: SourceList
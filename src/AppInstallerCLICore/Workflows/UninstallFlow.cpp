@@ -5,6 +5,7 @@
 #include "WorkflowBase.h"
 #include "ShellExecuteInstallerHandler.h"
 #include "AppInstallerMsixInfo.h"
+#include "DependenciesFlow.h"
 
 #include <AppInstallerDeployment.h>
 
@@ -17,38 +18,114 @@ namespace AppInstaller::CLI::Workflow
 {
     namespace
     {
+        // The maximum number of MSIX packages that are removed at the same time by UninstallMultiplePackages.
+        constexpr size_t MaximumConcurrentUninstalls = 4;
+
         // Helper for RecordUninstall
         struct UninstallCorrelatedSources
         {
             struct Item
             {
-                Utility::LocIndString Identifier;
                 Source FromSource;
                 std::string SourceIdentifier;
+                std::vector<Utility::LocIndString> Identifiers;
             };
 
-            void AddIfRemoteAndNotPresent(const std::shared_ptr<IPackageVersion>& packageVersion)
+            // Adds the identifiers of the package in every source it is correlated with.
+            void AddPackage(const std::shared_ptr<IPackage>& package)
+            {
+                std::set<std::string> packageSources;
+
+                // Start with the installed version
+                AddIfRemoteAndNotPresent(package->GetInstalledVersion(), packageSources);
+
+                // Then look through all available versions
+                for (const auto& versionKey : package->GetAvailableVersionKeys())
+                {
+                    AddIfRemoteAndNotPresent(package->GetAvailableVersion(versionKey), packageSources);
+                }
+            }
+
+            // Records the uninstalls to each tracking catalog, with a single write for all of the packages in it.
+            void RecordUninstalls()
+            {
+                for (const auto& item : Items)
+                {
+                    auto trackingCatalog = item.FromSource.GetTrackingCatalog();
+                    trackingCatalog.RecordUninstalls(item.Identifiers);
+                }
+            }
+
+            std::vector<Item> Items;
+
+        private:
+            void AddIfRemoteAndNotPresent(const std::shared_ptr<IPackageVersion>& packageVersion, std::set<std::string>& packageSources)
             {
                 auto source = packageVersion->GetSource();
                 const auto details = source.GetDetails();
-                if (!source.ContainsAvailablePackages())
+                if (!source.ContainsAvailablePackages() || !packageSources.insert(details.Identifier).second)
                 {
                     return;
                 }
 
-                for (const auto& item : Items)
+                auto identifier = packageVersion->GetProperty(PackageVersionProperty::Id);
+
+                for (auto& item : Items)
                 {
                     if (item.SourceIdentifier == details.Identifier)
                     {
+                        item.Identifiers.emplace_back(std::move(identifier));
                         return;
                     }
                 }
 
-                Items.emplace_back(Item{ packageVersion->GetProperty(PackageVersionProperty::Id), std::move(source), details.Identifier });
+                Items.emplace_back(Item{ std::move(source), details.Identifier, { std::move(identifier) } });
             }
+        };
 
-            std::vector<Item> Items;
+        // The removal of an MSIX package that runs while other packages are uninstalled.
+        // Its output is kept until it is the package's turn so that it does not interleave with the foreground.
+        struct BackgroundUninstall
+        {
+            std::ostringstream Output;
+            std::future<void> Result;
         };
+
+        std::unique_ptr<BackgroundUninstall> StartBackgroundUninstall(Execution::Context& packageContext)
+        {
+            auto result = std::make_unique<BackgroundUninstall>();
+            packageContext.Reporter.RedirectOutput(result->Output);
+
+            result->Result = std::async(std::launch::async, [&packageContext]()
+                {
+                    auto restoreOutput = wil::scope_exit([&]() { packageContext.Reporter.RestoreOutput(); });
+                    auto previousThreadGlobals = packageContext.SetForCurrentThread();
+
+                    packageContext << Workflow::ExecuteUninstaller;
+                });
+
+            return result;
+        }
+
+        // MSIX removals are transactional and handled by the system, so they can run alongside each other and alongside other uninstallers.
+        // MSI and other uninstallers are left to run one at a time, as they generally cannot run at the same time as another.
+        bool CanUninstallConcurrently(Execution::Context& packageContext)
+        {
+            if (packageContext.IsTerminated())
+            {
+                return false;
+            }
+
+            const std::string installedTypeString = packageContext.Get<Execution::Data::InstalledPackageVersion>()->GetMetadata()[PackageVersionMetadata::InstalledType];
+            switch (ConvertToInstallerTypeEnum(installedTypeString))
+            {
+            case InstallerTypeEnum::Msix:
+            case InstallerTypeEnum::MSStore:
+                return true;
+            default:
+                return false;
+            }
+        }
     }
 
     void GetUninstallInfo(Execution::Context& context)
@@ -165,23 +242,156 @@ namespace AppInstaller::CLI::Workflow
     void RecordUninstall(Context& context)
     {
         // In order to report an uninstall to every correlated tracking catalog, we first need to find them all.
-        auto package = context.Get<Data::Package>();
         UninstallCorrelatedSources correlatedSources;
+        correlatedSources.AddPackage(context.Get<Data::Package>());
 
-        // Start with the installed version
-        correlatedSources.AddIfRemoteAndNotPresent(package->GetInstalledVersion());
+        // Then record the uninstall for each found value
+        correlatedSources.RecordUninstalls();
+    }
 
-        // Then look through all available versions
-        for (const auto& versionKey : package->GetAvailableVersionKeys())
+    void UninstallMultiplePackages(Execution::Context& context)
+    {
+        const auto& queries = *context.Args.GetArgs(Execution::Args::Type::Query);
+        size_t packagesCount = queries.size();
+
+        // Every package is found in the composite source that is already open, so they all share its one snapshot of the installed packages.
+        std::vector<std::unique_ptr<Execution::Context>> packageContexts;
+        for (const auto& query : queries)
         {
-            correlatedSources.AddIfRemoteAndNotPresent(package->GetAvailableVersion(versionKey));
+            auto packageContextPtr = context.CreateSubContext();
+            Execution::Context& packageContext = *packageContextPtr;
+            auto previousThreadGlobals = packageContext.SetForCurrentThread();
+
+            // Each package is searched for with its own query, and all of the other arguments
+            for (auto type : context.Args.GetTypes())
+            {
+                if (type != Execution::Args::Type::Query)
+                {
+                    for (const auto& value : *context.Args.GetArgs(type))
+                    {
+                        packageContext.Args.AddArg(type, value);
+                    }
+                }
+            }
+
+            packageContext.Args.AddArg(Execution::Args::Type::Query, query);
+            packageContext.Add<Execution::Data::Source>(context.Get<Execution::Data::Source>());
+
+            packageContext <<
+                Workflow::SearchSourceForSingle <<
+                Workflow::HandleSearchResultFailures <<
+                Workflow::EnsureOneMatchFromSearchResult(true) <<
+                Workflow::ReportPackageIdentity <<
+                Workflow::GetInstalledPackageVersion <<
+                Workflow::GetUninstallInfo <<
+                Workflow::GetDependenciesInfoForUninstall <<
+                Workflow::ReportDependencies(Resource::String::UninstallCommandReportDependencies);
+
+            packageContexts.emplace_back(std::move(packageContextPtr));
         }
 
-        // Finally record the uninstall for each found value
-        for (const auto& item : correlatedSources.Items)
+        if (context.IsTerminated())
+        {
+            return;
+        }
+
+        context << Workflow::ReportExecutionStage(ExecutionStage::Execution);
+
+        std::vector<bool> uninstallConcurrently(packagesCount);
+        for (size_t packageIndex = 0; packageIndex < packagesCount; ++packageIndex)
+        {
+            uninstallConcurrently[packageIndex] = CanUninstallConcurrently(*packageContexts[packageIndex]);
+        }
+
+        // The background removals use the package contexts, so any still running must finish before leaving.
+        std::vector<std::unique_ptr<BackgroundUninstall>> backgroundUninstalls(packagesCount);
+        auto waitForBackgroundUninstalls = wil::scope_exit([&]()
+            {
+                for (const auto& uninstall : backgroundUninstalls)
+                {
+                    if (uninstall && uninstall->Result.valid())
+                    {
+                        uninstall->Result.wait();
+                    }
+                }
+            });
+
+        bool allSucceeded = true;
+        UninstallCorrelatedSources correlatedSources;
+
+        for (size_t packageIndex = 0; packageIndex < packagesCount; ++packageIndex)
+        {
+            // Keep the next MSIX removals running while this package is uninstalled
+            size_t concurrentUninstalls = 0;
+            for (size_t nextIndex = packageIndex; nextIndex < packagesCount && concurrentUninstalls < MaximumConcurrentUninstalls && !context.IsTerminated(); ++nextIndex)
+            {
+                if (uninstallConcurrently[nextIndex])
+                {
+                    if (!backgroundUninstalls[nextIndex])
+                    {
+                        backgroundUninstalls[nextIndex] = StartBackgroundUninstall(*packageContexts[nextIndex]);
+                    }
+
+                    ++concurrentUninstalls;
+                }
+            }
+
+            // We want to do best effort to uninstall all packages regardless of previous failures
+            Execution::Context& packageContext = *packageContexts[packageIndex];
+
+            if (!packageContext.IsTerminated())
+            {
+                context.Reporter.Info() << "(" << (packageIndex + 1) << "/" << packagesCount << ") " <<
+                    packageContext.Get<Execution::Data::Package>()->GetProperty(PackageProperty::Name) << std::endl;
+
+                // The context is not used here until the background removal is done with it
+                std::unique_ptr<BackgroundUninstall>& uninstall = backgroundUninstalls[packageIndex];
+                if (uninstall)
+                {
+                    uninstall->Result.wait();
+                }
+
+                auto previousThreadGlobals = packageContext.SetForCurrentThread();
+
+                if (uninstall)
+                {
+                    packageContext.Reporter.Info() << Utility::LocIndString{ uninstall->Output.str() };
+
+                    // Rethrows anything thrown by the background removal, as it would have been if done here
+                    uninstall->Result.get();
+                }
+                else
+                {
+                    packageContext << Workflow::ExecuteUninstaller;
+                }
+
+                packageContext.Reporter.Info() << std::endl;
+            }
+
+            if (packageContext.IsTerminated())
+            {
+                if (context.IsTerminated() && context.GetTerminationHR() == E_ABORT)
+                {
+                    // This means that the subcontext being terminated is due to an overall abort
+                    context.Reporter.Info() << Resource::String::Cancelled << std::endl;
+                    return;
+                }
+
+                allSucceeded = false;
+            }
+            else
+            {
+                correlatedSources.AddPackage(packageContext.Get<Execution::Data::Package>());
+            }
+        }
+
+        // The uninstalls are all recorded together, so that each tracking catalog is written to once
+        context << Workflow::ReportExecutionStage(ExecutionStage::PostExecution);
+        correlatedSources.RecordUninstalls();
+
+        if (!allSucceeded)
         {
-            auto trackingCatalog = item.FromSource.GetTrackingCatalog();
-            trackingCatalog.RecordUninstall(item.Identifier);
+            AICLI_TERMINATE_CONTEXT(APPINSTALLER_CLI_ERROR_MULTIPLE_UNINSTALL_FAILED);
         }
     }
 }
@@ -28,4 +28,11 @@ namespace AppInstaller::CLI::Workflow
     // Inputs: Package
     // Outputs: None
     void RecordUninstall(Execution::Context& context);
+
+    // Uninstalls the package found for each of the queries, recording them all in the tracking catalogs at the end.
+    // MSIX packages are removed concurrently with each other and with the other uninstallers, which run one at a time.
+    // Required Args: Query
+    // Inputs: Source
+    // Outputs: None
+    void UninstallMultiplePackages(Execution::Context& context);
 }
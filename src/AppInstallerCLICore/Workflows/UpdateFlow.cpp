@@ -19,6 +19,19 @@ namespace AppInstaller::CLI::Workflow
             return (installedVersion < updateVersion || updateVersion.IsLatest());
         }
 
+        // Determines if at least one installer was not applicable only because of the installed type.
+        bool HasInstalledTypeOnlyInapplicability(const std::vector<InapplicabilityFlags>& inapplicabilities)
+        {
+            return std::find(inapplicabilities.begin(), inapplicabilities.end(), InapplicabilityFlags::InstalledType) != inapplicabilities.end();
+        }
+
+        // Determines if the installer summary of the version rules out all of its installers, without retrieving the manifest.
+        bool IsRuledOutBySummary(const Execution::Context& context, const std::shared_ptr<IPackageVersion>& installedVersion, const std::shared_ptr<IPackageVersion>& updateVersion)
+        {
+            ManifestComparator manifestComparator(context, installedVersion->GetMetadata());
+            return manifestComparator.GetSummaryInapplicabilities(updateVersion->GetProperty(PackageVersionProperty::InstallerSummary)).has_value();
+        }
+
         void AddToPackagesToInstallIfNotPresent(std::vector<std::unique_ptr<Execution::Context>>& packagesToInstall, std::unique_ptr<Execution::Context> packageContext)
         {
             for (auto const& existing : packagesToInstall)
@@ -54,6 +67,19 @@ namespace AppInstaller::CLI::Workflow
                 if (IsUpdateVersionApplicable(installedVersion, Utility::Version(key.Version)))
                 {
                     auto packageVersion = package->GetAvailableVersion(key);
+
+                    // When the source has a summary of the installers, versions that it rules out are skipped without retrieving their manifest.
+                    auto summaryInapplicabilities = manifestComparator.GetSummaryInapplicabilities(packageVersion->GetProperty(PackageVersionProperty::InstallerSummary));
+                    if (summaryInapplicabilities)
+                    {
+                        if (HasInstalledTypeOnlyInapplicability(summaryInapplicabilities.value()))
+                        {
+                            installedTypeInapplicable = true;
+                        }
+
+                        continue;
+                    }
+
                     auto manifest = packageVersion->GetManifest();
 
                     // Check applicable Installer
@@ -61,8 +87,7 @@ namespace AppInstaller::CLI::Workflow
                     if (!installer.has_value())
                     {
                         // If there is at least one installer whose only reason is InstalledType.
-                        auto onlyInstalledType = std::find(inapplicabilities.begin(), inapplicabilities.end(), InapplicabilityFlags::InstalledType);
-                        if (onlyInstalledType != inapplicabilities.end())
+                        if (HasInstalledTypeOnlyInapplicability(inapplicabilities))
                         {
                             installedTypeInapplicable = true;
                         }
@@ -145,6 +170,26 @@ namespace AppInstaller::CLI::Workflow
         bool updateAllFoundUpdate = false;
         int unknownPackagesCount = 0;
 
+        // The manifests of the updates are needed to check them one package at a time, so they are retrieved together first.
+        // Those that the installer summary already rules out are not retrieved; an older version may still be checked later.
+        std::vector<std::shared_ptr<IPackageVersion>> updateVersions;
+        for (const auto& match : matches)
+        {
+            bool includeUnknown = context.Args.Contains(Execution::Args::Type::IncludeUnknown);
+            auto installedVersion = match.Package->GetInstalledVersion();
+
+            if (installedVersion && match.Package->IsUpdateAvailable() &&
+                (includeUnknown || !Utility::Version(installedVersion->GetProperty(PackageVersionProperty::Version)).IsUnknown()))
+            {
+                auto updateVersion = match.Package->GetLatestAvailableVersion();
+                if (!IsRuledOutBySummary(context, installedVersion, updateVersion))
+                {
+                    updateVersions.emplace_back(std::move(updateVersion));
+                }
+            }
+        }
+        PrefetchManifests(updateVersions);
+
         for (const auto& match : matches)
         {
             // We want to do best effort to update all applicable updates regardless on previous update failure
@@ -199,4 +244,34 @@ namespace AppInstaller::CLI::Workflow
             context.Reporter.Info() << unknownPackagesCount << " " << (unknownPackagesCount == 1 ? Resource::String::UpgradeUnknownCountSingle : Resource::String::UpgradeUnknownCount) << std::endl;
         }
     }
+
+    void PrefetchUpgradeManifests(Execution::Context& context)
+    {
+        std::vector<std::shared_ptr<IPackageVersion>> updateVersions;
+        for (const auto& match : context.Get<Execution::Data::SearchResult>().Matches)
+        {
+            if (match.Package->GetInstalledVersion() && match.Package->IsUpdateAvailable())
+            {
+                updateVersions.emplace_back(match.Package->GetLatestAvailableVersion());
+            }
+        }
+
+        context.Reporter.Info() << Resource::String::CacheWarmUpgradeManifests << ' ' << updateVersions.size() << std::endl;
+
+        if (updateVersions.size() == 1)
+        {
+            // Prefetching leaves a single manifest to the caller, which is this.
+            try
+            {
+                (void)updateVersions[0]->GetManifest();
+            }
+            CATCH_LOG();
+        }
+        else
+        {
+            PrefetchManifests(updateVersions);
+        }
+
+        context.Reporter.Info() << Resource::String::Done << std::endl;
+    }
 }
@@ -32,4 +32,10 @@ namespace AppInstaller::CLI::Workflow
     // Inputs: SearchResult
     // Outputs: None
     void UpdateAllApplicable(Execution::Context& context);
+
+    // Retrieves the manifests of the upgrades available for the packages from SearchResult, so that they are cached for later commands.
+    // Required Args: None
+    // Inputs: SearchResult
+    // Outputs: None
+    void PrefetchUpgradeManifests(Execution::Context& context);
 }
\ No newline at end of file
@@ -4,13 +4,22 @@
 #include "WorkflowBase.h"
 #include "ExecutionContext.h"
 #include "ManifestComparator.h"
+#include "StructuredOutput.h"
 #include "TableOutput.h"
 #include <winget/ManifestYamlParser.h>
+#include <winget/Timing.h>
+#include <AppInstallerSynchronization.h>
+#include <wil/resource.h>
+#include <wil/win32_helpers.h>
+
+#include <condition_variable>
+#include <mutex>
 
 
 namespace AppInstaller::CLI::Workflow
 {
     using namespace std::string_literals;
+    using namespace std::string_view_literals;
     using namespace AppInstaller::Utility::literals;
     using namespace AppInstaller::Repository;
 
@@ -73,6 +82,11 @@ namespace AppInstaller::CLI::Workflow
                     }
                 }
 
+                if (WI_IsFlagSet(context.GetFlags(), Execution::ContextFlag::DisableBackgroundSourceUpdate))
+                {
+                    source.DisableBackgroundUpdate();
+                }
+
                 if (context.Args.Contains(Execution::Args::Type::CustomHeader))
                 {
                     std::string customHeader{ context.Args.GetArg(Execution::Args::Type::CustomHeader) };
@@ -213,6 +227,33 @@ namespace AppInstaller::CLI::Workflow
 
             return accepted;
         }
+
+        // Outputs the lines of a result as a table, or in the machine readable format requested by the arguments.
+        // The output is given to outputLines, which calls OutputLine on it for each line; returns true if no lines were output.
+        template <size_t FieldCount, typename OutputLines>
+        bool OutputResultLines(
+            Execution::Context& context,
+            typename Execution::TableOutput<FieldCount>::header_t&& tableHeader,
+            typename Execution::StructuredOutput<FieldCount>::header_t structuredHeader,
+            OutputLines&& outputLines)
+        {
+            Execution::OutputFormat format = Execution::GetOutputFormat(context.Args);
+
+            if (format == Execution::OutputFormat::Table)
+            {
+                Execution::TableOutput<FieldCount> table(context.Reporter, std::move(tableHeader));
+                outputLines(table);
+                table.Complete();
+                return table.IsEmpty();
+            }
+            else
+            {
+                Execution::StructuredOutput<FieldCount> output(context.Reporter, format, structuredHeader);
+                outputLines(output);
+                output.Complete();
+                return output.IsEmpty();
+            }
+        }
     }
 
     bool WorkflowTask::operator==(const WorkflowTask& other) const
@@ -237,6 +278,26 @@ namespace AppInstaller::CLI::Workflow
         m_func(context);
     }
 
+    std::string WorkflowTask::GetReportName() const
+    {
+        if (!m_isFunc)
+        {
+            return m_name;
+        }
+
+        HMODULE module = nullptr;
+        if (!GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+            reinterpret_cast<LPCWSTR>(m_func), &module))
+        {
+            return "Unknown";
+        }
+
+        std::ostringstream stream;
+        stream << std::filesystem::path{ wil::GetModuleFileNameW<std::wstring>(module) }.stem().u8string() << "+0x" << std::hex <<
+            (reinterpret_cast<uintptr_t>(m_func) - reinterpret_cast<uintptr_t>(module));
+        return stream.str();
+    }
+
     HRESULT HandleException(Execution::Context& context, std::exception_ptr exception)
     {
         try
@@ -294,6 +355,255 @@ namespace AppInstaller::CLI::Workflow
         return E_UNEXPECTED;
     }
 
+    void PrefetchManifests(const std::vector<std::shared_ptr<Repository::IPackageVersion>>& packageVersions)
+    {
+        if (packageVersions.size() < 2)
+        {
+            return;
+        }
+
+        AICLI_LOG(CLI, Info, << "Prefetching " << packageVersions.size() << " manifests");
+
+        Synchronization::RunConcurrently(packageVersions.size(), [&](size_t i)
+            {
+                try
+                {
+                    if (packageVersions[i])
+                    {
+                        (void)packageVersions[i]->GetManifest();
+                    }
+                }
+                catch (...)
+                {
+                    // The properties of the version are not read here, as the source may not allow it concurrently.
+                    AICLI_LOG(CLI, Info, << "Failed to prefetch manifest " << i);
+                }
+            });
+    }
+
+    TaskGraph& TaskGraph::AddNode(std::shared_ptr<WorkflowTask> task, std::vector<Execution::Data> inputs, std::vector<Execution::Data> outputs, Synchronization::WorkLane lane)
+    {
+        auto intersects = [](const std::vector<Execution::Data>& a, const std::vector<Execution::Data>& b)
+        {
+            return std::any_of(a.begin(), a.end(), [&](Execution::Data data) { return std::find(b.begin(), b.end(), data) != b.end(); });
+        };
+
+        Node node{ std::move(task), std::move(inputs), std::move(outputs), lane, {}, {} };
+        size_t index = m_nodes.size();
+
+        for (size_t i = 0; i < m_nodes.size(); ++i)
+        {
+            Node& earlier = m_nodes[i];
+            if (intersects(node.Inputs, earlier.Outputs) || intersects(node.Outputs, earlier.Outputs) || intersects(node.Outputs, earlier.Inputs))
+            {
+                node.Dependencies.emplace_back(i);
+                earlier.Dependents.emplace_back(index);
+            }
+        }
+
+        m_nodes.emplace_back(std::move(node));
+        return *this;
+    }
+
+    void TaskGraph::operator()(Execution::Context& context) const
+    {
+        // The tasks on the work lanes only report that they are done; the context is only used by this thread,
+        // which moves their outputs back and starts the tasks that were waiting on them.
+        struct FinishedTasks
+        {
+            std::mutex Lock;
+            std::condition_variable Changed;
+            std::vector<size_t> Indices;
+        };
+
+        struct RunningTask
+        {
+            std::unique_ptr<Execution::Context> SubContext;
+            std::exception_ptr Exception;
+        };
+
+        auto finished = std::make_shared<FinishedTasks>();
+        std::vector<RunningTask> running(m_nodes.size());
+        size_t runningCount = 0;
+        std::exception_ptr exception;
+        bool stopped = false;
+
+        std::vector<size_t> waitingOn(m_nodes.size());
+        std::vector<size_t> ready;
+        for (size_t i = 0; i < m_nodes.size(); ++i)
+        {
+            waitingOn[i] = m_nodes[i].Dependencies.size();
+            if (waitingOn[i] == 0)
+            {
+                ready.emplace_back(i);
+            }
+        }
+
+        auto stop = [&]()
+        {
+            if (!stopped)
+            {
+                stopped = true;
+                for (auto& task : running)
+                {
+                    if (task.SubContext)
+                    {
+                        task.SubContext->Cancel();
+                    }
+                }
+            }
+        };
+
+        auto complete = [&](size_t index)
+        {
+            for (size_t dependent : m_nodes[index].Dependents)
+            {
+                if (--waitingOn[dependent] == 0)
+                {
+                    ready.emplace_back(dependent);
+                }
+            }
+        };
+
+        auto start = [&](size_t index)
+        {
+            RunningTask& task = running[index];
+
+            try
+            {
+                task.SubContext = context.CreateSubContext();
+                task.SubContext->Args = context.Args;
+
+                for (Execution::Data input : m_nodes[index].Inputs)
+                {
+                    task.SubContext->CopyFrom(context, input);
+                }
+
+                Synchronization::SubmitWork(m_nodes[index].Lane,
+                    [finished, index, subContext = task.SubContext.get(), exceptionResult = &task.Exception, workflowTask = m_nodes[index].Task]()
+                    {
+                        try
+                        {
+                            auto previousThreadGlobals = subContext->SetForCurrentThread();
+                            *subContext << *workflowTask;
+                        }
+                        catch (...)
+                        {
+                            *exceptionResult = std::current_exception();
+                        }
+
+                        std::lock_guard<std::mutex> lock{ finished->Lock };
+                        finished->Indices.emplace_back(index);
+                        finished->Changed.notify_all();
+                    });
+
+                ++runningCount;
+            }
+            catch (...)
+            {
+                task.SubContext.reset();
+                if (!exception)
+                {
+                    exception = std::current_exception();
+                }
+                stop();
+            }
+        };
+
+        while (!ready.empty() || runningCount > 0)
+        {
+            if (context.IsTerminated())
+            {
+                stop();
+            }
+
+            if (stopped)
+            {
+                ready.clear();
+            }
+            else if (runningCount == 0 && ready.size() == 1)
+            {
+                size_t index = ready.back();
+                ready.clear();
+
+                context << *m_nodes[index].Task;
+
+                if (!context.IsTerminated())
+                {
+                    complete(index);
+                }
+
+                continue;
+            }
+            else
+            {
+                AICLI_LOG(CLI, Verbose, << "Starting " << ready.size() << " workflow tasks alongside " << runningCount << " running");
+
+                std::vector<size_t> starting;
+                starting.swap(ready);
+                for (size_t index : starting)
+                {
+                    start(index);
+                }
+            }
+
+            if (runningCount == 0)
+            {
+                continue;
+            }
+
+            std::vector<size_t> done;
+            {
+                std::unique_lock<std::mutex> lock{ finished->Lock };
+                // Wake up now and then to notice that the context was terminated, such as by CTRL+C.
+                finished->Changed.wait_for(lock, 100ms, [&]() { return !finished->Indices.empty(); });
+                done.swap(finished->Indices);
+            }
+
+            for (size_t index : done)
+            {
+                --runningCount;
+                RunningTask& task = running[index];
+
+                if (task.Exception)
+                {
+                    if (!exception)
+                    {
+                        exception = task.Exception;
+                    }
+                    stop();
+                }
+                else if (task.SubContext->IsTerminated())
+                {
+                    if (!context.IsTerminated())
+                    {
+                        context.Terminate(task.SubContext->GetTerminationHR());
+                    }
+                    stop();
+                }
+                else if (!stopped)
+                {
+                    for (Execution::Data output : m_nodes[index].Outputs)
+                    {
+                        if (task.SubContext->Contains(output))
+                        {
+                            context.MoveFrom(*task.SubContext, output);
+                        }
+                    }
+
+                    complete(index);
+                }
+
+                task.SubContext.reset();
+            }
+        }
+
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+
     void OpenSource::operator()(Execution::Context& context) const
     {
         std::string_view sourceName;
@@ -487,6 +797,12 @@ namespace AppInstaller::CLI::Workflow
 
         SearchSourceApplyFilters(context, searchRequest, matchType);
 
+        // Whether the one package asked for is ambiguous depends on all of the matches; a count limits what is shown of the package instead.
+        searchRequest.MaximumResults = 0;
+
+        // An exact match on the id in a higher priority source is the package being asked for, so lower priority sources need not be searched.
+        searchRequest.StopAtUniqueIdMatch = (matchType == MatchType::Exact);
+
         Logging::Telemetry().LogSearchRequest(
             "single",
             args.GetArg(Execution::Args::Type::Query),
@@ -546,32 +862,36 @@ namespace AppInstaller::CLI::Workflow
     {
         auto& searchResult = context.Get<Execution::Data::SearchResult>();
 
-        bool sourceIsComposite = context.Get<Execution::Data::Source>().IsComposite();
-        Execution::TableOutput<5> table(context.Reporter,
+        // Machine readable output always has the source, so that its fields do not depend on the sources that are open.
+        bool isTable = Execution::GetOutputFormat(context.Args) == Execution::OutputFormat::Table;
+        bool showSource = !isTable || context.Get<Execution::Data::Source>().IsComposite();
+
+        OutputResultLines<5>(context,
             {
                 Resource::String::SearchName,
                 Resource::String::SearchId,
                 Resource::String::SearchVersion,
                 Resource::String::SearchMatch,
                 Resource::String::SearchSource
+            },
+            { "Name"sv, "Id"sv, "Version"sv, "Match"sv, "Source"sv },
+            [&](auto& output)
+            {
+                for (size_t i = 0; i < searchResult.Matches.size(); ++i)
+                {
+                    auto latestVersion = searchResult.Matches[i].Package->GetLatestAvailableVersion();
+
+                    output.OutputLine({
+                        latestVersion->GetProperty(PackageVersionProperty::Name),
+                        latestVersion->GetProperty(PackageVersionProperty::Id),
+                        latestVersion->GetProperty(PackageVersionProperty::Version),
+                        GetMatchCriteriaDescriptor(searchResult.Matches[i]),
+                        showSource ? static_cast<std::string>(latestVersion->GetProperty(PackageVersionProperty::SourceName)) : ""s
+                        });
+                }
             });
 
-        for (size_t i = 0; i < searchResult.Matches.size(); ++i)
-        {
-            auto latestVersion = searchResult.Matches[i].Package->GetLatestAvailableVersion();
-
-            table.OutputLine({
-                latestVersion->GetProperty(PackageVersionProperty::Name),
-                latestVersion->GetProperty(PackageVersionProperty::Id),
-                latestVersion->GetProperty(PackageVersionProperty::Version),
-                GetMatchCriteriaDescriptor(searchResult.Matches[i]),
-                sourceIsComposite ? static_cast<std::string>(latestVersion->GetProperty(PackageVersionProperty::SourceName)) : ""s
-                });
-        }
-
-        table.Complete();
-
-        if (searchResult.Truncated)
+        if (searchResult.Truncated && isTable)
         {
             context.Reporter.Info() << '<' << Resource::String::SearchTruncated << '>' << std::endl;
         }
@@ -698,67 +1018,77 @@ namespace AppInstaller::CLI::Workflow
     {
         auto& searchResult = context.Get<Execution::Data::SearchResult>();
 
-        Execution::TableOutput<5> table(context.Reporter,
+        int availableUpgradesCount = 0;
+        int unknownPackagesCount = 0;
+        auto &source = context.Get<Execution::Data::Source>();
+
+        // Machine readable output always has the source, so that its fields do not depend on the sources that are open.
+        bool isTable = Execution::GetOutputFormat(context.Args) == Execution::OutputFormat::Table;
+        bool shouldShowSource = !isTable || (source.IsComposite() && source.GetAvailableSources().size() > 1);
+
+        bool isEmpty = OutputResultLines<5>(context,
             {
                 Resource::String::SearchName,
                 Resource::String::SearchId,
                 Resource::String::SearchVersion,
                 Resource::String::AvailableHeader,
                 Resource::String::SearchSource
-            });
-
-        int availableUpgradesCount = 0;
-        int unknownPackagesCount = 0;
-        auto &source = context.Get<Execution::Data::Source>();
-        bool shouldShowSource = source.IsComposite() && source.GetAvailableSources().size() > 1;
-
-        for (const auto& match : searchResult.Matches)
-        {
-            auto installedVersion = match.Package->GetInstalledVersion();
-
-            if (installedVersion)
+            },
+            { "Name"sv, "Id"sv, "Version"sv, "Available"sv, "Source"sv },
+            [&](auto& output)
             {
-                auto latestVersion = match.Package->GetLatestAvailableVersion();
-                bool updateAvailable = match.Package->IsUpdateAvailable();
-
-                if (m_onlyShowUpgrades && !context.Args.Contains(Execution::Args::Type::IncludeUnknown) && Utility::Version(installedVersion->GetProperty(PackageVersionProperty::Version)).IsUnknown())
-                {
-                    // We are only showing upgrades, and the user did not request to include packages with unknown versions.
-                    unknownPackagesCount++;
-                    continue;
-                }
-
-                // The only time we don't want to output a line is when filtering and no update is available.
-                if (updateAvailable || !m_onlyShowUpgrades)
+                for (const auto& match : searchResult.Matches)
                 {
-                    Utility::LocIndString availableVersion, sourceName;
+                    auto installedVersion = match.Package->GetInstalledVersion();
 
-                    if (latestVersion)
+                    if (installedVersion)
                     {
-                        if (updateAvailable)
+                        auto latestVersion = match.Package->GetLatestAvailableVersion();
+                        bool updateAvailable = match.Package->IsUpdateAvailable();
+
+                        if (m_onlyShowUpgrades && !context.Args.Contains(Execution::Args::Type::IncludeUnknown) && Utility::Version(installedVersion->GetProperty(PackageVersionProperty::Version)).IsUnknown())
                         {
-                            availableVersion = latestVersion->GetProperty(PackageVersionProperty::Version);
-                            availableUpgradesCount++;
+                            // We are only showing upgrades, and the user did not request to include packages with unknown versions.
+                            unknownPackagesCount++;
+                            continue;
                         }
 
-                        // Always show the source for correlated packages
-                        sourceName = latestVersion->GetProperty(PackageVersionProperty::SourceName);
+                        // The only time we don't want to output a line is when filtering and no update is available.
+                        if (updateAvailable || !m_onlyShowUpgrades)
+                        {
+                            Utility::LocIndString availableVersion, sourceName;
+
+                            if (latestVersion)
+                            {
+                                if (updateAvailable)
+                                {
+                                    availableVersion = latestVersion->GetProperty(PackageVersionProperty::Version);
+                                    availableUpgradesCount++;
+                                }
+
+                                // Always show the source for correlated packages
+                                sourceName = latestVersion->GetProperty(PackageVersionProperty::SourceName);
+                            }
+
+                            output.OutputLine({
+                                match.Package->GetProperty(PackageProperty::Name),
+                                match.Package->GetProperty(PackageProperty::Id),
+                                installedVersion->GetProperty(PackageVersionProperty::Version),
+                                availableVersion,
+                                shouldShowSource ? sourceName : ""s
+                                });
+                        }
                     }
-
-                    table.OutputLine({
-                        match.Package->GetProperty(PackageProperty::Name),
-                        match.Package->GetProperty(PackageProperty::Id),
-                        installedVersion->GetProperty(PackageVersionProperty::Version),
-                        availableVersion,
-                        shouldShowSource ? sourceName : ""s
-                        });
                 }
-            }
-        }
+            });
 
-        table.Complete();
+        // The machine readable formats contain only the results.
+        if (!isTable)
+        {
+            return;
+        }
 
-        if (table.IsEmpty())
+        if (isEmpty)
         {
             context.Reporter.Info() << Resource::String::NoInstalledPackageFound << std::endl;
         }
@@ -781,6 +1111,24 @@ namespace AppInstaller::CLI::Workflow
 
     }
 
+    void ReportUpgradeSummary(Execution::Context& context)
+    {
+        bool includeUnknown = context.Args.Contains(Execution::Args::Type::IncludeUnknown);
+        auto summary = Repository::GetUpgradeSummary(context.Get<Execution::Data::SearchResult>(), includeUnknown);
+
+        for (const auto& packageId : summary.PackageIds)
+        {
+            context.Reporter.Info() << packageId << std::endl;
+        }
+
+        context.Reporter.Info() << summary.PackageIds.size() << ' ' << Resource::String::AvailableUpgrades << std::endl;
+
+        if (!includeUnknown && summary.UnknownVersionCount > 0)
+        {
+            context.Reporter.Info() << summary.UnknownVersionCount << " " << (summary.UnknownVersionCount == 1 ? Resource::String::UpgradeUnknownCountSingle : Resource::String::UpgradeUnknownCount) << std::endl;
+        }
+    }
+
     void EnsureMatchesFromSearchResult::operator()(Execution::Context& context) const
     {
         auto& searchResult = context.Get<Execution::Data::SearchResult>();
@@ -1143,7 +1491,21 @@ AppInstaller::CLI::Execution::Context& operator<<(AppInstaller::CLI::Execution::
         if (context.ShouldExecuteWorkflowTask(task))
 #endif
         {
-            task(context);
+            if (AppInstaller::Timing::IsUsageEnabled())
+            {
+                auto start = std::chrono::steady_clock::now();
+                auto recordTime = wil::scope_exit([&]()
+                    {
+                        AppInstaller::Timing::RecordWorkflowTask(task.GetReportName(),
+                            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start));
+                    });
+
+                task(context);
+            }
+            else
+            {
+                task(context);
+            }
         }
     }
     return context;
@@ -2,16 +2,21 @@
 // Licensed under the MIT License.
 #pragma once
 #include "ExecutionArgs.h"
+#include <AppInstallerSynchronization.h>
 #include <winget/ExperimentalFeature.h>
 #include <winget/RepositorySearch.h>
 
+#include <memory>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <vector>
 
 
 namespace AppInstaller::CLI::Execution
 {
     struct Context;
+    enum class Data : size_t;
 }
 
 namespace AppInstaller::CLI::Workflow
@@ -50,6 +55,9 @@ namespace AppInstaller::CLI::Workflow
 
         const std::string& GetName() const { return m_name; }
 
+        // Gets the name of the task for reports; a function has no name, so it is named by its offset in its module.
+        std::string GetReportName() const;
+
     private:
         bool m_isFunc = false;
         Func m_func = nullptr;
@@ -59,6 +67,63 @@ namespace AppInstaller::CLI::Workflow
     // Helper to report exceptions and return the HRESULT.
     HRESULT HandleException(Execution::Context& context, std::exception_ptr exception);
 
+    // Gets the manifests of the given package versions concurrently, so that the sources already have them when they are used.
+    // Failures are only logged, as they will be reported when the manifest is used.
+    void PrefetchManifests(const std::vector<std::shared_ptr<Repository::IPackageVersion>>& packageVersions);
+
+    // Runs tasks that declare the data they read and write, starting each one as soon as the tasks it depends on are done,
+    // so that the ones that do not depend on each other run concurrently.
+    // A task depends on an earlier one if it reads or writes data that the earlier one writes, or writes data that it reads.
+    // A task that becomes ready while no other is running runs on the context itself, as if it had been added to it in order.
+    // Otherwise it runs on its work lane with a sub-context holding a copy of the args and its inputs, and its outputs are
+    // moved back to the context when it is done.
+    // When a task terminates its sub-context or throws, or the context is terminated, no more tasks are started and the
+    // running ones are cancelled. The context is terminated with the first failure, and a task's exception is rethrown
+    // once every running task has returned.
+    // Required Args: those of the tasks
+    // Inputs: the inputs of the tasks
+    // Outputs: the outputs of the tasks
+    struct TaskGraph : public WorkflowTask
+    {
+        TaskGraph() : WorkflowTask("TaskGraph") {}
+
+        // Adds a task along with the data that it reads and writes, and the lane that it runs on when it runs alongside others.
+        TaskGraph& Add(WorkflowTask::Func f, std::vector<Execution::Data> inputs, std::vector<Execution::Data> outputs,
+            Synchronization::WorkLane lane = Synchronization::WorkLane::Io)
+        {
+            return AddNode(std::make_shared<WorkflowTask>(f), std::move(inputs), std::move(outputs), lane);
+        }
+
+        template <typename Task, std::enable_if_t<std::is_base_of_v<WorkflowTask, Task>, int> = 0>
+        TaskGraph& Add(Task task, std::vector<Execution::Data> inputs, std::vector<Execution::Data> outputs,
+            Synchronization::WorkLane lane = Synchronization::WorkLane::Io)
+        {
+            return AddNode(std::make_shared<Task>(std::move(task)), std::move(inputs), std::move(outputs), lane);
+        }
+
+        // Gets the indices of the earlier tasks that the task at the given index depends on.
+        const std::vector<size_t>& GetDependencies(size_t index) const { return m_nodes.at(index).Dependencies; }
+
+        void operator()(Execution::Context& context) const override;
+
+    private:
+        struct Node
+        {
+            std::shared_ptr<WorkflowTask> Task;
+            std::vector<Execution::Data> Inputs;
+            std::vector<Execution::Data> Outputs;
+            Synchronization::WorkLane Lane;
+            // The indices of the earlier nodes that this one depends on.
+            std::vector<size_t> Dependencies;
+            // The indices of the later nodes that depend on this one.
+            std::vector<size_t> Dependents;
+        };
+
+        TaskGraph& AddNode(std::shared_ptr<WorkflowTask> task, std::vector<Execution::Data> inputs, std::vector<Execution::Data> outputs, Synchronization::WorkLane lane);
+
+        std::vector<Node> m_nodes;
+    };
+
     // Creates the source object.
     // Required Args: None
     // Inputs: None
@@ -177,6 +242,12 @@ namespace AppInstaller::CLI::Workflow
         bool m_onlyShowUpgrades;
     };
 
+    // Outputs only the ids of the packages in the search results that have an upgrade available, and their count.
+    // Required Args: None
+    // Inputs: SearchResult
+    // Outputs: None
+    void ReportUpgradeSummary(Execution::Context& context);
+
     // Handles failures in the SearchResult either by warning or failing.
     // Required Args: None
     // Inputs: SearchResult
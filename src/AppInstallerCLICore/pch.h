@@ -22,6 +22,7 @@
 #include <future>
 #include <functional>
 #include <iterator>
+#include <map>
 #include <memory>
 #include <numeric>
 #include <optional>
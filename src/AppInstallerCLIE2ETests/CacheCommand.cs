@@ -0,0 +1,41 @@
+﻿// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+namespace AppInstallerCLIE2ETests
+{
+    using NUnit.Framework;
+
+    public class CacheCommand : BaseCommand
+    {
+        [SetUp]
+        public void Setup()
+        {
+            InitializeAllFeatures(false);
+        }
+
+        [TearDown]
+        public void TearDown()
+        {
+            InitializeAllFeatures(false);
+        }
+
+        [Test]
+        public void CacheWarmRequiresFeature()
+        {
+            // The command is rejected like any argument error until the experimental feature is enabled.
+            var result = TestCommon.RunAICLICommand("cache warm", string.Empty);
+            Assert.AreEqual(Constants.ErrorCode.ERROR_INVALID_CL_ARGUMENTS, result.ExitCode);
+            Assert.True(result.StdOut.Contains("cacheCommand"));
+        }
+
+        [Test]
+        public void CacheWarm()
+        {
+            ConfigureFeature("cacheCommand", true);
+            var result = TestCommon.RunAICLICommand("cache warm", string.Empty);
+            Assert.AreEqual(Constants.ErrorCode.S_OK, result.ExitCode);
+            Assert.True(result.StdOut.Contains("Retrieving the manifests of available upgrades"));
+            Assert.True(result.StdOut.Contains("Done"));
+        }
+    }
+}
@@ -17,6 +17,11 @@ namespace AppInstallerCLIE2ETests
         public const string MsiInstallerPathParameter = "MsiTestInstallerPath";
         public const string MsixInstallerPathParameter = "MsixTestInstallerPath";
         public const string PackageCertificatePathParameter = "PackageCertificatePath";
+        public const string PerfPackageCountParameter = "PerfPackageCount";
+        public const string PerfArpEntryCountParameter = "PerfArpEntryCount";
+        public const string PerfBaselinePathParameter = "PerfBaselinePath";
+        public const string PerfResultsPathParameter = "PerfResultsPath";
+        public const string PerfRegressionThresholdParameter = "PerfRegressionThreshold";
         public const string AppInstallerTestCert = "AppInstallerTest.cer";
         public const string AppInstallerTestCertThumbprint = "d03e7a688b388b1edde8476a627531c49db88017";
 
@@ -27,6 +32,11 @@ namespace AppInstallerCLIE2ETests
         public const string DefaultMSStoreSourceUrl = @"https://storeedgefd.dsx.mp.microsoft.com/v9.0";
         public const string TestSourceName = @"TestSource";
         public const string TestSourceUrl = @"https://localhost:5001/TestKit";
+        public const string RestTestSourceName = @"RestTestSource";
+        public const string RestTestSourceUrl = @"https://localhost:5001/api";
+        public const string RestSourceType = "Microsoft.Rest";
+        public const string RestTestPackageIdPrefix = "RestSourceEmulator.Package";
+        public const int RestTestCatalogSize = 1000;
 
         public const string AICLIPackageFamilyName = "WinGetDevCLI_8wekyb3d8bbwe";
         public const string AICLIPackageName = "WinGetDevCLI";
@@ -48,6 +58,14 @@ namespace AppInstallerCLIE2ETests
         public const string MsiInstallerPackageId = "AppInstallerTest.TestMsiInstaller";
         public const string MsixInstallerPackageId = "AppInstallerTest.TestMsixInstaller";
 
+        // Synthetic packages of the perf tests
+        public const string PerfPackageIdPrefix = "PerfTest.Package";
+        public const string PerfPackageNamePrefix = "PerfTest Package ";
+        public const string PerfPackagePublisher = "PerfTest";
+        public const string PerfProductCodePrefix = "PerfTest.Product";
+        public const string PerfPackageVersion = "2.0.0";
+        public const string PerfInstalledVersion = "1.0.0";
+
         public const string MsiInstallerProductCode = "{A5D36CF1-1993-4F63-BFB4-3ACD910D36A1}";
         public const string MsixInstallerPackageFamilyName = "6c6338fe-41b7-46ca-8ba6-b5ad5312bb0e_8wekyb3d8bbwe";
 
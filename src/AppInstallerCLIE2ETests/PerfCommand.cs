@@ -0,0 +1,105 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+namespace AppInstallerCLIE2ETests
+{
+    using Microsoft.Win32;
+    using NUnit.Framework;
+
+    // Measures the common commands against the test index grown by PerfPackageCount synthetic packages, with
+    // PerfArpEntryCount of them registered as installed at an older version. See PerfMeasurement for what is measured.
+    [Category("Perf")]
+    public class PerfCommand : BaseCommand
+    {
+        private const string UninstallKeyPath = @"Software\Microsoft\Windows\CurrentVersion\Uninstall";
+
+        private readonly PerfMeasurement measurement = new PerfMeasurement();
+
+        [OneTimeSetUp]
+        public void AddArpEntries()
+        {
+            if (TestCommon.PerfPackageCount == 0)
+            {
+                Assert.Ignore("The perf tests need the PerfPackageCount test parameter");
+            }
+
+            if (TestCommon.InvokeCommandInDesktopPackage)
+            {
+                Assert.Ignore("The perf tests need to start winget directly to measure it");
+            }
+
+            using RegistryKey uninstallKey = Registry.CurrentUser.CreateSubKey(UninstallKeyPath);
+            for (int i = 0; i < TestCommon.PerfArpEntryCount; ++i)
+            {
+                string suffix = i.ToString("D4");
+                using RegistryKey entry = uninstallKey.CreateSubKey(Constants.PerfProductCodePrefix + suffix);
+                entry.SetValue("DisplayName", Constants.PerfPackageNamePrefix + suffix);
+                entry.SetValue("Publisher", Constants.PerfPackagePublisher);
+                entry.SetValue("DisplayVersion", Constants.PerfInstalledVersion);
+                entry.SetValue("UninstallString", "cmd.exe /c exit 0");
+            }
+        }
+
+        [OneTimeTearDown]
+        public void RemoveArpEntries()
+        {
+            if (TestCommon.PerfPackageCount == 0)
+            {
+                return;
+            }
+
+            using RegistryKey uninstallKey = Registry.CurrentUser.OpenSubKey(UninstallKeyPath, true);
+            for (int i = 0; uninstallKey != null && i < TestCommon.PerfArpEntryCount; ++i)
+            {
+                uninstallKey.DeleteSubKeyTree(Constants.PerfProductCodePrefix + i.ToString("D4"), false);
+            }
+
+            this.measurement.WriteResults();
+        }
+
+        [Test]
+        public void PerfSearchAll()
+        {
+            var result = this.measurement.Measure(nameof(PerfSearchAll), "search", $"-s {Constants.TestSourceName}");
+            Assert.AreEqual(Constants.ErrorCode.S_OK, result.ExitCode);
+            this.measurement.AssertNoRegression(nameof(PerfSearchAll));
+        }
+
+        [Test]
+        public void PerfSearchByTag()
+        {
+            var result = this.measurement.Measure(nameof(PerfSearchByTag), "search", $"--tag perftest3 -s {Constants.TestSourceName}");
+            Assert.AreEqual(Constants.ErrorCode.S_OK, result.ExitCode);
+            Assert.True(result.StdOut.Contains(Constants.PerfPackageIdPrefix + "0003"));
+            this.measurement.AssertNoRegression(nameof(PerfSearchByTag));
+        }
+
+        [Test]
+        public void PerfShow()
+        {
+            string id = Constants.PerfPackageIdPrefix + (TestCommon.PerfPackageCount - 1).ToString("D4");
+            var result = this.measurement.Measure(nameof(PerfShow), "show", $"--id {id} --exact");
+            Assert.AreEqual(Constants.ErrorCode.S_OK, result.ExitCode);
+            Assert.True(result.StdOut.Contains(id));
+            this.measurement.AssertNoRegression(nameof(PerfShow));
+        }
+
+        [Test]
+        public void PerfList()
+        {
+            var result = this.measurement.Measure(nameof(PerfList), "list", string.Empty);
+            Assert.AreEqual(Constants.ErrorCode.S_OK, result.ExitCode);
+            Assert.True(result.StdOut.Contains(Constants.PerfPackageIdPrefix + "0000"));
+            this.measurement.AssertNoRegression(nameof(PerfList));
+        }
+
+        [Test]
+        public void PerfUpgradeAvailable()
+        {
+            var result = this.measurement.Measure(nameof(PerfUpgradeAvailable), "upgrade", string.Empty);
+            Assert.AreEqual(Constants.ErrorCode.S_OK, result.ExitCode);
+            Assert.True(result.StdOut.Contains(Constants.PerfPackageIdPrefix + "0000"));
+            this.measurement.AssertNoRegression(nameof(PerfUpgradeAvailable));
+        }
+    }
+}
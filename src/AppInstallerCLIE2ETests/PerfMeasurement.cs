@@ -0,0 +1,185 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+namespace AppInstallerCLIE2ETests
+{
+    using System;
+    using System.Collections.Generic;
+    using System.Diagnostics;
+    using System.IO;
+    using System.Linq;
+    using Newtonsoft.Json;
+    using NUnit.Framework;
+
+    /// <summary>
+    /// Runs winget for the perf tests and measures each run: the wall time and peak working set of the process,
+    /// and, from its verbose log, the number of SQL statements executed and HTTP requests sent.
+    /// </summary>
+    public class PerfMeasurement
+    {
+        // Lines of the verbose log that are written once per SQL statement execution and per HTTP request.
+        private static readonly string[] SqlStatementMarkers = { "Preparing statement #", "Reusing prepared statement #" };
+        private static readonly string[] HttpRequestMarkers = { "Sending http ", "Download request " };
+
+        private readonly Dictionary<string, PerfResult> results = new Dictionary<string, PerfResult>();
+
+        public class PerfResult
+        {
+            public int Runs { get; set; }
+
+            public long WallTimeMilliseconds { get; set; }
+
+            public long PeakWorkingSetBytes { get; set; }
+
+            public int SqlStatements { get; set; }
+
+            public int HttpRequests { get; set; }
+        }
+
+        /// <summary>
+        /// Runs a command a number of times and records the median of each measurement under the scenario name.
+        /// </summary>
+        /// <param name="scenario">The name of the scenario.</param>
+        /// <param name="command">The winget command.</param>
+        /// <param name="parameters">The parameters of the command.</param>
+        /// <param name="runs">The number of measured runs; a first warm up run is not measured.</param>
+        /// <returns>The result of the last run.</returns>
+        public TestCommon.RunCommandResult Measure(string scenario, string command, string parameters, int runs = 5)
+        {
+            var samples = new List<PerfResult>();
+            TestCommon.RunCommandResult result = Run(command, parameters, out _);
+
+            for (int i = 0; i < runs; ++i)
+            {
+                result = Run(command, parameters, out PerfResult sample);
+                samples.Add(sample);
+            }
+
+            var median = new PerfResult
+            {
+                Runs = runs,
+                WallTimeMilliseconds = Median(samples.Select(s => s.WallTimeMilliseconds)),
+                PeakWorkingSetBytes = Median(samples.Select(s => s.PeakWorkingSetBytes)),
+                SqlStatements = (int)Median(samples.Select(s => (long)s.SqlStatements)),
+                HttpRequests = (int)Median(samples.Select(s => (long)s.HttpRequests)),
+            };
+
+            this.results[scenario] = median;
+            TestContext.Out.WriteLine($"{scenario}: {median.WallTimeMilliseconds} ms, {median.PeakWorkingSetBytes / 1024} KB peak working set, {median.SqlStatements} SQL statements, {median.HttpRequests} HTTP requests");
+
+            return result;
+        }
+
+        /// <summary>
+        /// Fails the test when the scenario regressed against the baseline. Wall time and peak working set may grow
+        /// by the regression threshold to absorb noise; the counts are deterministic and may not grow at all.
+        /// </summary>
+        /// <param name="scenario">The name of the scenario.</param>
+        public void AssertNoRegression(string scenario)
+        {
+            if (string.IsNullOrEmpty(TestCommon.PerfBaselinePath))
+            {
+                return;
+            }
+
+            var baseline = JsonConvert.DeserializeObject<Dictionary<string, PerfResult>>(File.ReadAllText(TestCommon.PerfBaselinePath));
+            if (!baseline.TryGetValue(scenario, out PerfResult previous))
+            {
+                TestContext.Out.WriteLine($"{scenario} is not in the baseline");
+                return;
+            }
+
+            PerfResult current = this.results[scenario];
+            double allowed = 1 + (TestCommon.PerfRegressionThreshold / 100);
+
+            Assert.LessOrEqual(current.WallTimeMilliseconds, previous.WallTimeMilliseconds * allowed, $"{scenario} wall time regressed");
+            Assert.LessOrEqual(current.PeakWorkingSetBytes, previous.PeakWorkingSetBytes * allowed, $"{scenario} peak working set regressed");
+            Assert.LessOrEqual(current.SqlStatements, previous.SqlStatements, $"{scenario} executes more SQL statements");
+            Assert.LessOrEqual(current.HttpRequests, previous.HttpRequests, $"{scenario} sends more HTTP requests");
+        }
+
+        /// <summary>
+        /// Writes the results of every measured scenario, in the format read as a baseline.
+        /// </summary>
+        public void WriteResults()
+        {
+            File.WriteAllText(TestCommon.PerfResultsPath, JsonConvert.SerializeObject(this.results, Formatting.Indented));
+        }
+
+        private static TestCommon.RunCommandResult Run(string command, string parameters, out PerfResult sample)
+        {
+            sample = new PerfResult { Runs = 1 };
+            var result = new TestCommon.RunCommandResult();
+            DateTime start = DateTime.Now;
+
+            Process p = new Process();
+            p.StartInfo = new ProcessStartInfo(TestCommon.AICLIPath, $"{command} {parameters} --verbose-logs");
+            p.StartInfo.UseShellExecute = false;
+            p.StartInfo.RedirectStandardOutput = true;
+            p.StartInfo.RedirectStandardError = true;
+
+            var stopwatch = Stopwatch.StartNew();
+            p.Start();
+
+            var stdOut = p.StandardOutput.ReadToEndAsync();
+            var stdErr = p.StandardError.ReadToEndAsync();
+
+            // The peak working set can no longer be read once the process has exited, so it is sampled until then.
+            while (!p.WaitForExit(20))
+            {
+                try
+                {
+                    p.Refresh();
+                    sample.PeakWorkingSetBytes = Math.Max(sample.PeakWorkingSetBytes, p.PeakWorkingSet64);
+                }
+                catch (InvalidOperationException)
+                {
+                }
+            }
+
+            sample.WallTimeMilliseconds = stopwatch.ElapsedMilliseconds;
+            result.ExitCode = p.ExitCode;
+            result.StdOut = stdOut.Result;
+            result.StdErr = stdErr.Result;
+
+            string log = ReadLatestLog(start);
+            if (log != null)
+            {
+                sample.SqlStatements = CountLines(log, SqlStatementMarkers);
+                sample.HttpRequests = CountLines(log, HttpRequestMarkers);
+            }
+
+            return result;
+        }
+
+        private static string ReadLatestLog(DateTime start)
+        {
+            string logDirectory = TestCommon.PackagedContext ?
+                Path.Combine(Environment.GetEnvironmentVariable(Constants.LocalAppData), Constants.E2ETestLogsPath) :
+                Path.Combine(Path.GetTempPath(), "WinGet");
+
+            if (!Directory.Exists(logDirectory))
+            {
+                return null;
+            }
+
+            FileInfo latest = new DirectoryInfo(logDirectory).GetFiles("*.log")
+                .Where(f => f.LastWriteTime >= start)
+                .OrderByDescending(f => f.LastWriteTime)
+                .FirstOrDefault();
+
+            return latest == null ? null : File.ReadAllText(latest.FullName);
+        }
+
+        private static int CountLines(string log, string[] markers)
+        {
+            return log.Split('\n').Count(line => markers.Any(m => line.Contains(m)));
+        }
+
+        private static long Median(IEnumerable<long> values)
+        {
+            var sorted = values.OrderBy(v => v).ToList();
+            return sorted.Count == 0 ? 0 : sorted[sorted.Count / 2];
+        }
+    }
+}
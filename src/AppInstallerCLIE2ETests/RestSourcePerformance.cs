@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+namespace AppInstallerCLIE2ETests
+{
+    using System.Diagnostics;
+    using NUnit.Framework;
+
+    // These tests need LocalhostWebServer to be started with RestCatalogSize of at least RestTestCatalogSize.
+    // The time of each scenario is written to the test output so that runs can be compared.
+    public class RestSourcePerformance : BaseCommand
+    {
+        [OneTimeSetUp]
+        public void AddRestSource()
+        {
+            TestCommon.RunAICLICommand("source add", $"{Constants.RestTestSourceName} {Constants.RestTestSourceUrl} --type {Constants.RestSourceType}");
+        }
+
+        [OneTimeTearDown]
+        public void RemoveRestSource()
+        {
+            TestCommon.RunAICLICommand("source remove", Constants.RestTestSourceName);
+        }
+
+        [Test]
+        public void SearchAcrossAllPages()
+        {
+            // Every package of the catalog matches, so the search reads every page of results.
+            var result = RunTimed("search", $"\"Emulated Package\" -s {Constants.RestTestSourceName}");
+            Assert.AreEqual(Constants.ErrorCode.S_OK, result.ExitCode);
+            Assert.True(result.StdOut.Contains(Constants.RestTestPackageIdPrefix + "000000"));
+        }
+
+        [Test]
+        public void SearchWithCount()
+        {
+            var result = RunTimed("search", $"\"Emulated Package\" -s {Constants.RestTestSourceName} --count 10");
+            Assert.AreEqual(Constants.ErrorCode.S_OK, result.ExitCode);
+            Assert.True(result.StdOut.Contains(Constants.RestTestPackageIdPrefix + "000009"));
+            Assert.False(result.StdOut.Contains(Constants.RestTestPackageIdPrefix + "000010"));
+        }
+
+        [Test]
+        public void ShowPackage()
+        {
+            string id = Constants.RestTestPackageIdPrefix + (Constants.RestTestCatalogSize - 1).ToString("D6");
+            var result = RunTimed("show", $"--id {id} -s {Constants.RestTestSourceName} --exact");
+            Assert.AreEqual(Constants.ErrorCode.S_OK, result.ExitCode);
+            Assert.True(result.StdOut.Contains(id));
+        }
+
+        [Test]
+        public void ShowPackageRepeatedly()
+        {
+            // The later runs revalidate the cached manifest instead of downloading it again.
+            string id = Constants.RestTestPackageIdPrefix + "000001";
+            for (int i = 0; i < 3; ++i)
+            {
+                var result = RunTimed("show", $"--id {id} -s {Constants.RestTestSourceName} --exact");
+                Assert.AreEqual(Constants.ErrorCode.S_OK, result.ExitCode);
+            }
+        }
+
+        private static TestCommon.RunCommandResult RunTimed(string command, string parameters)
+        {
+            var stopwatch = Stopwatch.StartNew();
+            var result = TestCommon.RunAICLICommand(command, parameters);
+            TestContext.Out.WriteLine($"{TestContext.CurrentContext.Test.Name}: {command} {parameters} took {stopwatch.ElapsedMilliseconds} ms");
+            return result;
+        }
+    }
+}
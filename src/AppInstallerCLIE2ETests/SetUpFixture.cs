@@ -98,6 +98,8 @@ namespace AppInstallerCLIE2ETests
 
             ReadTestInstallerPaths();
 
+            ReadPerfParameters();
+
             TestIndexSetup.GenerateTestDirectory();
 
             InitializeWingetSettings();
@@ -199,6 +201,15 @@ namespace AppInstallerCLIE2ETests
             }
         }
 
+        private void ReadPerfParameters()
+        {
+            TestCommon.PerfPackageCount = TestContext.Parameters.Get(Constants.PerfPackageCountParameter, 0);
+            TestCommon.PerfArpEntryCount = TestContext.Parameters.Get(Constants.PerfArpEntryCountParameter, Math.Min(TestCommon.PerfPackageCount, 300));
+            TestCommon.PerfBaselinePath = TestContext.Parameters.Get(Constants.PerfBaselinePathParameter, string.Empty);
+            TestCommon.PerfResultsPath = TestContext.Parameters.Get(Constants.PerfResultsPathParameter, Path.Combine(Path.GetTempPath(), "E2EPerfResults.json"));
+            TestCommon.PerfRegressionThreshold = TestContext.Parameters.Get(Constants.PerfRegressionThresholdParameter, 20.0);
+        }
+
         public void InitializeWingetSettings()
         {
             string localAppDataPath = Environment.GetEnvironmentVariable(Constants.LocalAppData);
@@ -211,6 +222,7 @@ namespace AppInstallerCLIE2ETests
                     experimentalCmd = false,
                     dependencies = false,
                     directMSI = false,
+                    cacheCommand = false,
                 },
                 debugging = new
                 {
@@ -34,6 +34,16 @@ namespace AppInstallerCLIE2ETests
         
         public static string PackageCertificatePath { get; set; }
 
+        public static int PerfPackageCount { get; set; }
+
+        public static int PerfArpEntryCount { get; set; }
+
+        public static string PerfBaselinePath { get; set; }
+
+        public static string PerfResultsPath { get; set; }
+
+        public static double PerfRegressionThreshold { get; set; }
+
         public static string SettingsJsonFilePath {
             get
             {
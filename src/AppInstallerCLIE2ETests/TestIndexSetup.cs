@@ -41,6 +41,11 @@ namespace AppInstallerCLIE2ETests
                 CopyMsixInstallerToTestDirectory();
             }
 
+            if (TestCommon.PerfPackageCount > 0)
+            {
+                GeneratePerfManifests(TestCommon.PerfPackageCount);
+            }
+
             TestHashHelper.HashInstallers();
 
             string manifestDirectoryPath = Path.Combine(TestCommon.StaticFileRootPath, ManifestsName);
@@ -85,6 +90,37 @@ namespace AppInstallerCLIE2ETests
             }
         }
 
+        /// <summary>
+        /// Writes the manifests of the synthetic packages used by the perf tests.
+        /// Package i is correlated with the ARP entry PerfProductCodePrefix{i} through its product code.
+        /// </summary>
+        /// <param name="count">The number of packages.</param>
+        private static void GeneratePerfManifests(int count)
+        {
+            string manifestDirectoryPath = Path.Combine(TestCommon.StaticFileRootPath, ManifestsName);
+
+            for (int i = 0; i < count; ++i)
+            {
+                string suffix = i.ToString("D4");
+                string manifest =
+                    $"Id: {Constants.PerfPackageIdPrefix}{suffix}\n" +
+                    $"Name: {Constants.PerfPackageNamePrefix}{suffix}\n" +
+                    $"Version: {Constants.PerfPackageVersion}\n" +
+                    $"Publisher: {Constants.PerfPackagePublisher}\n" +
+                    "License: Test\n" +
+                    $"Tags: \"perftest, perftest{i % 10}\"\n" +
+                    "Installers:\n" +
+                    "  - Arch: x86\n" +
+                    "    Url: https://localhost:5001/TestKit/AppInstallerTestExeInstaller/AppInstallerTestExeInstaller.exe\n" +
+                    "    Sha256: <EXEHASH>\n" +
+                    "    InstallerType: exe\n" +
+                    $"    ProductCode: '{Constants.PerfProductCodePrefix}{suffix}'\n" +
+                    "ManifestVersion: 0.1.0\n";
+
+                File.WriteAllText(Path.Combine(manifestDirectoryPath, $"{Constants.PerfPackageIdPrefix}{suffix}.yaml"), manifest);
+            }
+        }
+
         private static void CopyExeInstallerToTestDirectory()
         {
             // Set Exe Test Installer Path
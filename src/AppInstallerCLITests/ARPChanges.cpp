@@ -16,6 +16,7 @@ using namespace AppInstaller::CLI::Execution;
 using namespace AppInstaller::CLI::Workflow;
 using namespace AppInstaller::Logging;
 using namespace AppInstaller::Repository;
+using namespace std::string_literals;
 
 struct TestTelemetry : public TelemetryTraceLogger
 {
@@ -218,6 +219,21 @@ TEST_CASE("ARPChanges_MSIX_Ignored", "[ARPChanges][workflow]")
     REQUIRE(!context.Logger->WasLogSuccessfulInstallARPChangeCalled);
 }
 
+TEST_CASE("ARPChanges_MSI_NotADatabase", "[ARPChanges][workflow]")
+{
+    TestContext context(Manifest::InstallerTypeEnum::Msi);
+
+    TempFile installer{ "NotAnMsi"s, ".msi"s };
+    std::ofstream{ installer.GetPath() } << "Not an MSI database";
+    context.Add<Data::InstallerPath>(installer.GetPath());
+
+    // Without a product code from the installer, the full snapshot is taken
+    context << SnapshotARPEntries;
+
+    REQUIRE(!context.Contains(Data::MsiProductSnapshot));
+    REQUIRE(context.Contains(Data::ARPSnapshot));
+}
+
 TEST_CASE("ARPChanges_CheckSnapshot", "[ARPChanges][workflow]")
 {
     TestContext context;
@@ -290,6 +306,24 @@ TEST_CASE("ARPChanges_NoChange_MultiMatch", "[ARPChanges][workflow]")
     context.ExpectEvent(0, 2, 0);
 }
 
+TEST_CASE("ARPChanges_SharedCache_NextSnapshot", "[ARPChanges][workflow]")
+{
+    TestContext context;
+    context.Add<Data::ARPEntriesCache>(std::make_shared<ARPEntriesCache>());
+
+    context << SnapshotARPEntries;
+    REQUIRE(context.Contains(Data::ARPSnapshot));
+
+    context.AddEverythingResult("EverythingId1", "EverythingName1", "EverythingPublisher1", "EverythingVersion1");
+
+    context << ReportARPChanges;
+    context.ExpectEvent(1, 0, 0, context.EverythingResult.Matches.back().Package.get());
+
+    // The next package starts from the entries as they were after the install, whether read again or not
+    context << SnapshotARPEntries;
+    REQUIRE(context.Get<Data::ARPSnapshot>().size() == context.EverythingResult.Matches.size());
+}
+
 TEST_CASE("ARPChanges_SingleChange_NoMatch", "[ARPChanges][workflow]")
 {
     TestContext context;
@@ -0,0 +1,82 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include <winget/BandwidthSchedule.h>
+
+using namespace std::chrono_literals;
+using namespace AppInstaller::Utility;
+
+using ScheduleClock = BandwidthSchedule::clock;
+
+TEST_CASE("BandwidthSchedule_CapsThroughput", "[bandwidth]")
+{
+    BandwidthSchedule schedule;
+    constexpr uint64_t rate = 100000;
+
+    // A receiver that gets its bytes as soon as it is allowed to continue.
+    ScheduleClock::time_point start{};
+    ScheduleClock::time_point now = start;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        now = std::max(now, schedule.Schedule(10000, rate, now));
+    }
+
+    // The million bytes took ten seconds at the rate, less the burst that was allowed ahead of it.
+    REQUIRE(now - start == 10s - BandwidthSchedule::AllowedBurst);
+}
+
+TEST_CASE("BandwidthSchedule_BurstIsAllowedAhead", "[bandwidth]")
+{
+    BandwidthSchedule schedule;
+    constexpr uint64_t rate = 100000;
+
+    ScheduleClock::time_point start{};
+    REQUIRE(schedule.Schedule(50000, rate, start) == start);
+    REQUIRE(schedule.Schedule(100000, rate, start) == start + 1s);
+}
+
+TEST_CASE("BandwidthSchedule_ReceiversShareTheRate", "[bandwidth]")
+{
+    BandwidthSchedule schedule;
+    constexpr uint64_t rate = 100000;
+
+    ScheduleClock::time_point start{};
+    ScheduleClock::time_point first = start;
+    ScheduleClock::time_point second = start;
+    for (size_t i = 0; i < 50; ++i)
+    {
+        first = std::max(first, schedule.Schedule(10000, rate, first));
+        second = std::max(second, schedule.Schedule(10000, rate, second));
+    }
+
+    // Together they received a million bytes, which is as long at the rate as one receiver alone.
+    REQUIRE(std::max(first, second) - start == 10s - BandwidthSchedule::AllowedBurst);
+}
+
+TEST_CASE("BandwidthSchedule_UnusedTimeIsNotSaved", "[bandwidth]")
+{
+    BandwidthSchedule schedule;
+    constexpr uint64_t rate = 100000;
+
+    ScheduleClock::time_point start{};
+    REQUIRE(schedule.Schedule(100000, rate, start) == start + 500ms);
+
+    // Nothing was received for an hour, which does not allow more than the burst ahead of the rate afterward.
+    ScheduleClock::time_point later = start + 1h;
+    REQUIRE(schedule.Schedule(100000, rate, later) == later + 500ms);
+}
+
+TEST_CASE("BandwidthSchedule_ZeroIsUnlimited", "[bandwidth]")
+{
+    BandwidthSchedule schedule;
+
+    ScheduleClock::time_point start{};
+    for (size_t i = 0; i < 100; ++i)
+    {
+        REQUIRE(schedule.Schedule(1024 * 1024 * 1024, 0, start) == start);
+    }
+
+    // The unlimited bytes were not scheduled, so they do not delay bytes received under a limit.
+    REQUIRE(schedule.Schedule(100000, 100000, start) == start + 500ms);
+}
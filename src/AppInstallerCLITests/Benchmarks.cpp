@@ -0,0 +1,405 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include "TestSource.h"
+#include <AppInstallerSHA256.h>
+#include <AppInstallerStrings.h>
+#include <AppInstallerSynchronization.h>
+#include <AppInstallerVersions.h>
+#include <Command.h>
+#include <Commands/RootCommand.h>
+#include <CompositeSource.h>
+#include <Microsoft/SQLiteIndex.h>
+#include <winget/ManifestYamlParser.h>
+#include <winget/NameNormalization.h>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+using namespace TestCommon;
+using namespace AppInstaller;
+using namespace AppInstaller::Repository;
+using namespace AppInstaller::Repository::Microsoft;
+using namespace AppInstaller::Utility;
+
+// These skipped test cases measure the hot paths of the repository core. Run them with:
+//      AppInstallerCLITests.exe [benchmark] -benchout <file>
+// to also write the results as JSON, which can be compared against the results of a previous release.
+
+namespace
+{
+    Manifest::Manifest CreateBenchmarkManifest(size_t i)
+    {
+        std::string index = std::to_string(i);
+
+        Manifest::Manifest manifest;
+        manifest.Id = "Benchmark.Package" + index;
+        manifest.DefaultLocalization.Add<Manifest::Localization::PackageName>("Benchmark Package " + index);
+        manifest.DefaultLocalization.Add<Manifest::Localization::Publisher>("Benchmark Publisher " + std::to_string(i % 100));
+        manifest.Moniker = "benchmark" + index;
+        manifest.Version = "1.0." + index;
+        manifest.DefaultLocalization.Add<Manifest::Localization::Tags>({ "benchmark", "tag" + std::to_string(i % 10) });
+        manifest.Installers.push_back({});
+        manifest.Installers[0].ProductCode = "{benchmark-product-code-" + index + "}";
+        manifest.Installers[0].Commands = { "bench" + index };
+        return manifest;
+    }
+}
+
+TEST_CASE("Benchmark_SQLiteIndex_Search", "[.][benchmark]")
+{
+    constexpr size_t s_PackageCount = 10000;
+
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    {
+        SQLiteIndex index = SQLiteIndex::CreateNew(tempFile, Schema::Version::Latest());
+
+        std::vector<std::pair<Manifest::Manifest, std::filesystem::path>> manifests;
+        for (size_t i = 0; i < s_PackageCount; ++i)
+        {
+            manifests.emplace_back(CreateBenchmarkManifest(i), "manifests/benchmark/" + std::to_string(i) + ".yaml");
+        }
+
+        index.AddManifests(manifests);
+        index.PrepareForPackaging();
+    }
+
+    SQLiteIndex index = SQLiteIndex::Open(tempFile, SQLiteIndex::OpenDisposition::Read);
+
+    std::vector<std::pair<MatchType, std::string_view>> queries
+    {
+        { MatchType::Exact, "Benchmark.Package1234"sv },
+        { MatchType::CaseInsensitive, "benchmark.package1234"sv },
+        { MatchType::StartsWith, "benchmark.package12"sv },
+        { MatchType::Substring, "package12"sv },
+        { MatchType::Wildcard, "benchmark.package12*"sv },
+        { MatchType::Fuzzy, "benchmrk package 1234"sv },
+        { MatchType::FuzzySubstring, "packge 12"sv },
+    };
+
+    for (const auto& query : queries)
+    {
+        SearchRequest request;
+        request.Query = RequestMatch(query.first, query.second);
+
+        BenchmarkResults::Measure("SQLiteIndex_Search_"s + std::string{ ToString(query.first) }, 20, 1, [&]()
+            {
+                (void)index.Search(request);
+            });
+    }
+}
+
+TEST_CASE("Benchmark_SQLiteIndex_Build", "[.][benchmark]")
+{
+    constexpr size_t s_PackageCount = 1000;
+
+    std::vector<Manifest::Manifest> manifests;
+    for (size_t i = 0; i < s_PackageCount; ++i)
+    {
+        manifests.emplace_back(CreateBenchmarkManifest(i));
+    }
+
+    // Each manifest is added as its own change, as the publishing pipeline does when it updates an existing index.
+    for (auto writeMode : { SQLiteIndex::WriteMode::Default, SQLiteIndex::WriteMode::Build })
+    {
+        std::string name = "SQLiteIndex_Build_"s + (writeMode == SQLiteIndex::WriteMode::Build ? "BuildWriteMode" : "DefaultWriteMode");
+
+        BenchmarkResults::Measure(name, 3, s_PackageCount, [&]()
+            {
+                TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+                SQLiteIndex index = SQLiteIndex::CreateNew(tempFile, Schema::Version::Latest());
+                index.SetWriteMode(writeMode);
+
+                for (size_t i = 0; i < manifests.size(); ++i)
+                {
+                    index.AddManifest(manifests[i], "manifests/benchmark/" + std::to_string(i) + ".yaml");
+                }
+
+                index.PrepareForPackaging();
+            });
+    }
+}
+
+TEST_CASE("Benchmark_CompositeSource_SearchInstalled", "[.][benchmark]")
+{
+    constexpr size_t s_InstalledCount = 2000;
+
+    // Every other installed package is correlated to an available package by its product code.
+    SearchResult installedResult;
+    std::map<std::string, std::shared_ptr<IPackage>> availableByProductCode;
+
+    for (size_t i = 0; i < s_InstalledCount; ++i)
+    {
+        Manifest::Manifest manifest = CreateBenchmarkManifest(i);
+        installedResult.Matches.emplace_back(TestPackage::Make(manifest, TestPackage::MetadataMap{}), PackageMatchFilter(PackageMatchField::Id, MatchType::Wildcard, ""sv));
+
+        if (i % 2 == 0)
+        {
+            std::string productCode = FoldCase(std::string_view{ manifest.Installers[0].ProductCode });
+            manifest.Version = "2.0";
+            availableByProductCode.emplace(std::move(productCode), TestPackage::Make(std::vector<Manifest::Manifest>{ manifest }));
+        }
+    }
+
+    auto installed = std::make_shared<TestSource>();
+    installed->Details.Identifier = "InstalledBenchmarkSource";
+    installed->SearchFunction = [&](const SearchRequest&) { return installedResult; };
+
+    auto available = std::make_shared<TestSource>();
+    available->Details.Identifier = "AvailableBenchmarkSource";
+    available->SearchFunction = [&](const SearchRequest& request)
+    {
+        SearchResult result;
+
+        for (const auto& inclusion : request.Inclusions)
+        {
+            if (inclusion.Field == PackageMatchField::ProductCode)
+            {
+                auto itr = availableByProductCode.find(FoldCase(std::string_view{ inclusion.Value }));
+                if (itr != availableByProductCode.end())
+                {
+                    result.Matches.emplace_back(itr->second, PackageMatchFilter(PackageMatchField::ProductCode, MatchType::Exact, inclusion.Value));
+                }
+            }
+        }
+
+        return result;
+    };
+
+    BenchmarkResults::Measure("CompositeSource_SearchInstalled", 10, s_InstalledCount, [&]()
+        {
+            CompositeSource composite("*Benchmark");
+            composite.SetInstalledSource(Source{ installed });
+            composite.AddAvailableSource(Source{ available });
+
+            SearchResult result = composite.Search({});
+            REQUIRE(result.Matches.size() == s_InstalledCount);
+        });
+}
+
+TEST_CASE("Benchmark_NameNormalizer", "[.][benchmark]")
+{
+    std::ifstream namesStream(TestDataFile("InputNames.txt").GetPath());
+    REQUIRE(namesStream);
+    std::ifstream publishersStream(TestDataFile("InputPublishers.txt").GetPath());
+    REQUIRE(publishersStream);
+
+    std::vector<std::pair<std::string, std::string>> values;
+    std::string name;
+    std::string publisher;
+
+    while (std::getline(namesStream, name) && std::getline(publishersStream, publisher))
+    {
+        values.emplace_back(std::move(name), std::move(publisher));
+    }
+
+    // A new normalizer is created for each run so that its cache does not serve the values.
+    BenchmarkResults::Measure("NameNormalizer_Normalize", 5, values.size(), [&]()
+        {
+            NameNormalizer normer(NormalizationVersion::Initial);
+            for (const auto& value : values)
+            {
+                (void)normer.Normalize(value.first, value.second);
+            }
+        });
+}
+
+TEST_CASE("Benchmark_Version", "[.][benchmark]")
+{
+    constexpr size_t s_VersionCount = 10000;
+
+    std::vector<std::string> strings;
+    for (size_t i = 0; i < s_VersionCount; ++i)
+    {
+        strings.emplace_back(std::to_string(i % 7) + "." + std::to_string((i * 31) % 100) + "." + std::to_string(i) + (i % 3 == 0 ? "-beta" : ""));
+    }
+
+    BenchmarkResults::Measure("Version_Parse", 20, s_VersionCount, [&]()
+        {
+            for (const auto& string : strings)
+            {
+                (void)Version{ string };
+            }
+        });
+
+    std::vector<Version> versions;
+    for (const auto& string : strings)
+    {
+        versions.emplace_back(string);
+    }
+
+    BenchmarkResults::Measure("Version_Sort", 20, s_VersionCount, [&]()
+        {
+            std::vector<Version> toSort = versions;
+            std::sort(toSort.begin(), toSort.end());
+        });
+}
+
+TEST_CASE("Benchmark_UTF8ColumnWidth", "[.][benchmark]")
+{
+    constexpr size_t s_ValueCount = 10000;
+
+    // Mostly ASCII values, as package identifiers and versions are, with some names that are not.
+    std::vector<NormalizedUTF8<NormalizationC>> values;
+    for (size_t i = 0; i < s_ValueCount; ++i)
+    {
+        switch (i % 4)
+        {
+        case 0: values.emplace_back("Benchmark.Package" + std::to_string(i)); break;
+        case 1: values.emplace_back("1.0." + std::to_string(i)); break;
+        case 2: values.emplace_back("Benchmark Package " + std::to_string(i)); break;
+        default: values.emplace_back("Benchmark Paket K\xC3\xA4se \xe6\xb5\x8b\xe8\xaf\x95 " + std::to_string(i)); break;
+        }
+    }
+
+    BenchmarkResults::Measure("UTF8ColumnWidth", 20, s_ValueCount, [&]()
+        {
+            for (const auto& value : values)
+            {
+                (void)UTF8ColumnWidth(value);
+            }
+        });
+
+    BenchmarkResults::Measure("UTF8TrimRightToColumnWidth", 20, s_ValueCount, [&]()
+        {
+            for (const auto& value : values)
+            {
+                size_t actualWidth = 0;
+                (void)UTF8TrimRightToColumnWidth(value, 20, actualWidth);
+            }
+        });
+}
+
+TEST_CASE("Benchmark_CommandDispatch", "[.][benchmark]")
+{
+    constexpr size_t s_DispatchCount = 1000;
+
+    // Everything the CLI does with the command line before a command starts executing.
+    std::vector<std::pair<std::string_view, std::vector<std::string>>> commandLines
+    {
+        { "Version"sv, { "--version" } },
+        { "InstallId"sv, { "install", "--id", "Benchmark.Package" } },
+    };
+
+    for (const auto& commandLine : commandLines)
+    {
+        BenchmarkResults::Measure("CommandDispatch_"s + std::string{ commandLine.first }, 20, s_DispatchCount, [&]()
+            {
+                for (size_t i = 0; i < s_DispatchCount; ++i)
+                {
+                    CLI::Invocation invocation{ std::vector<std::string>(commandLine.second) };
+                    CLI::Execution::Args args;
+
+                    std::unique_ptr<CLI::Command> command = std::make_unique<CLI::RootCommand>();
+                    std::unique_ptr<CLI::Command> subCommand = command->FindSubCommand(invocation);
+                    while (subCommand)
+                    {
+                        command = std::move(subCommand);
+                        subCommand = command->FindSubCommand(invocation);
+                    }
+
+                    command->ParseArguments(invocation, args);
+                    command->ValidateArguments(args);
+                }
+            });
+    }
+}
+
+TEST_CASE("Benchmark_YamlManifest", "[.][benchmark]")
+{
+    for (std::string_view file : { "Manifest-Good.yaml"sv, "ManifestV1_1-Singleton.yaml"sv })
+    {
+        std::filesystem::path path = TestDataFile(file).GetPath();
+
+        BenchmarkResults::Measure("YamlManifest_CreateFromPath_"s + std::string{ file }, 50, 1, [&]()
+            {
+                (void)Manifest::YamlParser::CreateFromPath(path);
+            });
+    }
+}
+
+TEST_CASE("Benchmark_SHA256", "[.][benchmark]")
+{
+    constexpr size_t s_BufferSize = 16 * 1024 * 1024;
+
+    std::string buffer(s_BufferSize, '\0');
+    for (size_t i = 0; i < buffer.size(); ++i)
+    {
+        buffer[i] = static_cast<char>(i * 2654435761u >> 24);
+    }
+
+    BenchmarkResults::Measure("SHA256_ComputeHash", 10, s_BufferSize, [&]()
+        {
+            (void)SHA256::ComputeHash(buffer);
+        });
+
+    // The file is larger than a single mapped view; the stream is the previous way to hash a file.
+    TempFile tempFile{ "benchmark_sha256"s, ".bin"s };
+    {
+        std::ofstream file{ tempFile.GetPath(), std::ofstream::binary };
+        for (size_t i = 0; i < 6; ++i)
+        {
+            file.write(buffer.data(), buffer.size());
+        }
+    }
+
+    BenchmarkResults::Measure("SHA256_ComputeHash_Stream", 5, 6 * s_BufferSize, [&]()
+        {
+            std::ifstream stream{ tempFile.GetPath(), std::ifstream::binary };
+            (void)SHA256::ComputeHash(stream);
+        });
+
+    BenchmarkResults::Measure("SHA256_ComputeHashFromFile", 5, 6 * s_BufferSize, [&]()
+        {
+            (void)SHA256::ComputeHashFromFile(tempFile.GetPath());
+        });
+}
+
+TEST_CASE("Benchmark_CrossProcessReaderWriteLock_Contention", "[.][benchmark]")
+{
+    constexpr size_t s_ThreadCount = 32;
+    constexpr size_t s_LocksPerThread = 200;
+
+    // Each thread stands in for a separate winget process; one of every 50 locks taken is exclusive when writers are included.
+    auto runContention = [&](bool includeWriters)
+    {
+        std::atomic<size_t> failedCount = 0;
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < s_ThreadCount; ++i)
+        {
+            threads.emplace_back([i, includeWriters, &failedCount]()
+                {
+                    for (size_t j = 0; j < s_LocksPerThread; ++j)
+                    {
+                        bool exclusive = includeWriters && ((i * s_LocksPerThread + j) % 50 == 0);
+                        auto lock = exclusive ?
+                            Synchronization::CrossProcessReaderWriteLock::LockExclusive("AppInstCPRWLBenchmark") :
+                            Synchronization::CrossProcessReaderWriteLock::LockShared("AppInstCPRWLBenchmark");
+                        if (!lock)
+                        {
+                            ++failedCount;
+                        }
+                    }
+                });
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        REQUIRE(failedCount == 0);
+    };
+
+    BenchmarkResults::Measure("CrossProcessReaderWriteLock_SharedContention", 5, s_ThreadCount * s_LocksPerThread, [&]()
+        {
+            runContention(false);
+        });
+
+    BenchmarkResults::Measure("CrossProcessReaderWriteLock_MixedContention", 5, s_ThreadCount * s_LocksPerThread, [&]()
+        {
+            runContention(true);
+        });
+}
@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include <ChannelStreams.h>
+
+using namespace AppInstaller::CLI::Execution;
+using namespace AppInstaller::Utility::literals;
+
+TEST_CASE("BaseStream_WritesWholeLines", "[ChannelStreams]")
+{
+    std::ostringstream output;
+    BaseStream stream{ output, true, false };
+
+    stream << "Partial"_liv << ' ' << 42;
+    REQUIRE(output.str().empty());
+
+    stream << " line"_liv << '\n' << "Next"_liv;
+    REQUIRE(output.str() == "Partial 42 line\nNext");
+}
+
+TEST_CASE("BaseStream_FlushWritesPartialLine", "[ChannelStreams]")
+{
+    std::ostringstream output;
+    BaseStream stream{ output, true, false };
+
+    stream << "Prompt: "_liv << std::flush;
+    REQUIRE(output.str() == "Prompt: ");
+
+    stream << "Ended"_liv << std::endl;
+    REQUIRE(output.str() == "Prompt: Ended\n");
+}
+
+TEST_CASE("BaseStream_DisableKeepsEarlierOutput", "[ChannelStreams]")
+{
+    std::ostringstream output;
+
+    {
+        BaseStream stream{ output, true, false };
+
+        stream << "Before"_liv;
+        stream.Disable();
+        stream << "After"_liv << std::endl;
+    }
+
+    REQUIRE(output.str() == "Before");
+}
+
+TEST_CASE("BaseStream_LongOutputWithoutLineEnd", "[ChannelStreams]")
+{
+    std::ostringstream output;
+    BaseStream stream{ output, true, false };
+
+    std::string longValue(10000, 'x');
+    stream << Utility::LocIndView{ longValue };
+
+    // Output is not held indefinitely when there is no line end
+    REQUIRE(output.str() == longValue);
+}
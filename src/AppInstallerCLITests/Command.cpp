@@ -498,3 +498,28 @@ TEST_CASE("ParseArguments_UnknownName", "[command]")
 
     REQUIRE_COMMAND_EXCEPTION(command.ParseArguments(inv, args), values[1]);
 }
+
+TEST_CASE("Command_DefinedArguments", "[command]")
+{
+    TestCommand command({
+            Argument{ "pos1", 'p', Args::Type::Channel, DefaultDesc, ArgumentType::Positional },
+            Argument{ "flag1", 'f', Args::Type::Exact, DefaultDesc, ArgumentType::Flag },
+        });
+
+    std::vector<Argument> common;
+    Argument::GetCommon(common);
+
+    const auto& definedArgs = command.GetDefinedArguments();
+    REQUIRE(definedArgs.size() == command.m_args.size() + common.size());
+    REQUIRE(definedArgs[0].ExecArgType() == Args::Type::Channel);
+    REQUIRE(definedArgs[2].ExecArgType() == common[0].ExecArgType());
+
+    // The list is built once and reused
+    REQUIRE(&command.GetDefinedArguments() == &definedArgs);
+
+    // Validation still only applies to the arguments of the command itself
+    Args args;
+    args.AddArg(Args::Type::VerboseLogs, std::string{});
+    args.AddArg(Args::Type::VerboseLogs, std::string{});
+    REQUIRE_NOTHROW(command.ValidateArguments(args));
+}
@@ -7,6 +7,7 @@
 #include <CompositeSource.h>
 #include <Microsoft/SQLiteIndexSource.h>
 #include <PackageTrackingCatalogSourceFactory.h>
+#include <winget/ThreadGlobals.h>
 
 using namespace std::string_literals;
 using namespace std::string_view_literals;
@@ -534,6 +535,46 @@ TEST_CASE("CompositePackage_AvailableVersions_ChannelFilteredOut", "[CompositeSo
     REQUIRE(!result.Matches[0].Package->IsUpdateAvailable());
 }
 
+TEST_CASE("CompositePackage_LatestAvailableVersionKeys_ChannelFilteredOut", "[CompositeSource]")
+{
+    std::string pfn = "sortof_apfn";
+    std::string channel = "Channel";
+
+    CompositeTestSetup setup;
+    setup.Installed->Everything.Matches.emplace_back(MakeInstalled().WithPFN(pfn), Criteria());
+    setup.Available->SearchFunction = [&](const SearchRequest&)
+    {
+        Manifest::Manifest newest = MakeDefaultManifest();
+        newest.Version = "3.0";
+
+        Manifest::Manifest hasChannel = MakeDefaultManifest();
+        hasChannel.Channel = channel;
+        hasChannel.Version = "2.0";
+
+        Manifest::Manifest oldest = MakeDefaultManifest();
+        oldest.Version = "1.0";
+
+        SearchResult result;
+        result.Matches.emplace_back(TestPackage::Make(std::vector<Manifest::Manifest>{ newest, hasChannel, oldest }), Criteria());
+        return result;
+    };
+
+    SearchResult result = setup.Search();
+    REQUIRE(result.Matches.size() == 1);
+
+    auto newestKeys = result.Matches[0].Package->GetLatestAvailableVersionKeys(1);
+    REQUIRE(newestKeys.size() == 1);
+    REQUIRE(newestKeys[0].Version == "3.0");
+
+    // The version in the other channel is skipped without shortening the result
+    auto versionKeys = result.Matches[0].Package->GetLatestAvailableVersionKeys(2);
+    REQUIRE(versionKeys.size() == 2);
+    REQUIRE(versionKeys[0].Version == "3.0");
+    REQUIRE(versionKeys[1].Version == "1.0");
+
+    REQUIRE(result.Matches[0].Package->GetLatestAvailableVersionKeys(5).size() == 2);
+}
+
 TEST_CASE("CompositePackage_AvailableVersions_NoChannelFilteredOut", "[CompositeSource]")
 {
     std::string pfn = "sortof_apfn";
@@ -727,6 +768,204 @@ TEST_CASE("CompositeSource_AvailableSearchFailure", "[CompositeSource]")
     REQUIRE(searchFailure == expectedHR);
 }
 
+TEST_CASE("CompositeSource_AvailableSearchTimeout", "[CompositeSource]")
+{
+    std::string pfn = "sortof_apfn";
+
+    TestUserSettings settings;
+    settings.Set<Settings::Setting::NetworkSearchTimeoutInSeconds>(1s);
+
+    std::shared_ptr<ComponentTestSource> AvailableSucceeds = std::make_shared<ComponentTestSource>("AvailableSucceeds");
+    AvailableSucceeds->SearchFunction = [&](const SearchRequest&)
+    {
+        SearchResult result;
+        result.Matches.emplace_back(MakeAvailable().WithPFN(pfn), Criteria());
+        return result;
+    };
+
+    // The slow search runs until it is cancelled, which happens once it has timed out.
+    std::atomic<size_t> slowSearches{ 0 };
+    std::atomic<bool> slowSearchRunning{ false };
+    std::shared_ptr<ComponentTestSource> AvailableSlow = std::make_shared<ComponentTestSource>("AvailableSlow");
+    AvailableSlow->SearchFunction = [&](const SearchRequest&)
+    {
+        ++slowSearches;
+        slowSearchRunning = true;
+        for (size_t i = 0; i < 1000 && !ThreadLocalStorage::IsCurrentThreadCancelled(); ++i)
+        {
+            std::this_thread::sleep_for(10ms);
+        }
+        slowSearchRunning = false;
+        return SearchResult{};
+    };
+    AvailableSlow->Details.Name = "The one that is slow";
+
+    CompositeSource Composite("*CompositeSource_AvailableSearchTimeout");
+    Composite.AddAvailableSource(Source{ AvailableSucceeds });
+    Composite.AddAvailableSource(Source{ AvailableSlow });
+
+    auto requireTimeoutFailure = [&](const SearchResult& result)
+    {
+        REQUIRE(result.Matches.size() == 1);
+        REQUIRE(result.Failures.size() == 1);
+        REQUIRE(result.Failures[0].SourceName == AvailableSlow->Details.Name);
+
+        HRESULT searchFailure = S_OK;
+        try
+        {
+            std::rethrow_exception(result.Failures[0].Exception);
+        }
+        catch (const wil::ResultException& re)
+        {
+            searchFailure = re.GetErrorCode();
+        }
+        catch (...) {}
+
+        REQUIRE(searchFailure == APPINSTALLER_CLI_ERROR_SOURCE_SEARCH_TIMEOUT);
+    };
+
+    requireTimeoutFailure(Composite.Search({}));
+
+    // The search that timed out was cancelled, and stops soon after the results were returned
+    REQUIRE(slowSearches == 1);
+    for (size_t i = 0; i < 500 && slowSearchRunning; ++i)
+    {
+        std::this_thread::sleep_for(10ms);
+    }
+    REQUIRE_FALSE(slowSearchRunning);
+
+    // A source that timed out is not searched again
+    requireTimeoutFailure(Composite.Search({}));
+    REQUIRE(slowSearches == 1);
+}
+
+TEST_CASE("CompositeSource_AvailableSearchTimeout_IgnoresCancellation", "[CompositeSource]")
+{
+    std::string pfn = "sortof_apfn";
+
+    TestUserSettings settings;
+    settings.Set<Settings::Setting::NetworkSearchTimeoutInSeconds>(1s);
+
+    std::shared_ptr<ComponentTestSource> AvailableSucceeds = std::make_shared<ComponentTestSource>("AvailableSucceeds");
+    AvailableSucceeds->SearchFunction = [&](const SearchRequest&)
+    {
+        SearchResult result;
+        result.Matches.emplace_back(MakeAvailable().WithPFN(pfn), Criteria());
+        return result;
+    };
+
+    // Like a REST source, the slow search does not check for cancellation, and runs until it is released.
+    // Its state is shared, as it may still be running after the test has returned.
+    struct SlowSearchState
+    {
+        std::mutex Lock;
+        std::condition_variable Changed;
+        bool Released = false;
+        bool Finished = false;
+    };
+    auto slowState = std::make_shared<SlowSearchState>();
+
+    std::shared_ptr<ComponentTestSource> AvailableSlow = std::make_shared<ComponentTestSource>("AvailableSlow");
+    AvailableSlow->SearchFunction = [slowState](const SearchRequest&)
+    {
+        std::unique_lock<std::mutex> lock{ slowState->Lock };
+        slowState->Changed.wait_for(lock, 60s, [&]() { return slowState->Released; });
+        slowState->Finished = true;
+        slowState->Changed.notify_all();
+        return SearchResult{};
+    };
+    AvailableSlow->Details.Name = "The one that ignores cancellation";
+
+    auto releaseSlowSearch = wil::scope_exit([&]()
+        {
+            std::unique_lock<std::mutex> lock{ slowState->Lock };
+            slowState->Released = true;
+            slowState->Changed.notify_all();
+            slowState->Changed.wait_for(lock, 60s, [&]() { return slowState->Finished; });
+        });
+
+    CompositeSource Composite("*CompositeSource_AvailableSearchTimeout_IgnoresCancellation");
+    Composite.AddAvailableSource(Source{ AvailableSucceeds });
+    Composite.AddAvailableSource(Source{ AvailableSlow });
+
+    // The results are returned at the timeout, without waiting for the search that did not stop.
+    auto start = std::chrono::steady_clock::now();
+    SearchResult result = Composite.Search({});
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    REQUIRE(elapsed < 30s);
+    REQUIRE(result.Matches.size() == 1);
+    REQUIRE(result.Failures.size() == 1);
+    REQUIRE(result.Failures[0].SourceName == AvailableSlow->Details.Name);
+
+    {
+        std::lock_guard<std::mutex> lock{ slowState->Lock };
+        REQUIRE_FALSE(slowState->Finished);
+    }
+
+    // Once released, the search that was left running finishes on its own.
+    releaseSlowSearch.reset();
+    std::lock_guard<std::mutex> lock{ slowState->Lock };
+    REQUIRE(slowState->Finished);
+}
+
+TEST_CASE("CompositeSource_AvailableSearchStopAtUniqueIdMatch", "[CompositeSource]")
+{
+    std::string id = "Test.Id";
+    PackageMatchFilter exactId{ PackageMatchField::Id, MatchType::Exact, id };
+    PackageMatchFilter exactName{ PackageMatchField::Name, MatchType::Exact, id };
+
+    PackageMatchFilter firstCriteria = exactId;
+    std::shared_ptr<ComponentTestSource> First = std::make_shared<ComponentTestSource>();
+    First->SearchFunction = [&](const SearchRequest&)
+    {
+        SearchResult result;
+        result.Matches.emplace_back(MakeAvailable().WithId(id), firstCriteria);
+        return result;
+    };
+
+    bool secondSearched = false;
+    std::shared_ptr<ComponentTestSource> Second = std::make_shared<ComponentTestSource>();
+    Second->SearchFunction = [&](const SearchRequest&)
+    {
+        secondSearched = true;
+        SearchResult result;
+        result.Matches.emplace_back(MakeAvailable().WithId(id), exactId);
+        return result;
+    };
+
+    CompositeSource Composite("*CompositeSource_AvailableSearchStopAtUniqueIdMatch");
+    Composite.AddAvailableSource(Source{ First });
+    Composite.AddAvailableSource(Source{ Second });
+
+    SearchRequest request;
+    request.Inclusions.emplace_back(exactId);
+    request.StopAtUniqueIdMatch = true;
+
+    SECTION("Unique id match")
+    {
+        SearchResult result = Composite.Search(request);
+        REQUIRE(result.Matches.size() == 1);
+        REQUIRE(!secondSearched);
+    }
+    SECTION("Match on another field")
+    {
+        firstCriteria = exactName;
+
+        SearchResult result = Composite.Search(request);
+        REQUIRE(result.Matches.size() == 2);
+        REQUIRE(secondSearched);
+    }
+    SECTION("Not requested")
+    {
+        request.StopAtUniqueIdMatch = false;
+
+        SearchResult result = Composite.Search(request);
+        REQUIRE(result.Matches.size() == 2);
+        REQUIRE(secondSearched);
+    }
+}
+
 TEST_CASE("CompositeSource_InstalledToAvailableCorrelationSearchFailure", "[CompositeSource]")
 {
     HRESULT expectedHR = E_BLUETOOTH_ATT_ATTRIBUTE_NOT_LONG;
@@ -942,3 +1181,253 @@ TEST_CASE("CompositeSource_TrackingFound_NotInstalled", "[CompositeSource]")
 
     REQUIRE(result.Matches.empty());
 }
+
+TEST_CASE("CompositeSource_Batched_CorrelatesEachInstalled", "[CompositeSource]")
+{
+    std::string pfn = "sortof_apfn";
+    std::string pc = "thiscouldbeapc";
+
+    auto installedByPFN = MakeInstalled().WithPFN(pfn).WithDefaultName("PFN Package");
+    auto installedByPC = MakeInstalled().WithPC(pc).WithDefaultName("PC Package");
+    auto installedNoMatch = MakeInstalled().WithPC("nomatch").WithDefaultName("Unmatched Package");
+
+    auto availableByPFN = MakeAvailable().WithPFN(pfn).WithId("PFN.ID").WithDefaultName("PFN Package");
+    auto availableByPC = MakeAvailable().WithPC(pc).WithId("PC.ID").WithDefaultName("PC Package");
+
+    CompositeTestSetup setup;
+    setup.Installed->SearchFunction = [&](const SearchRequest& request)
+    {
+        REQUIRE(request.IsForEverything());
+
+        SearchResult result;
+        result.Matches.emplace_back(installedByPFN, Criteria());
+        result.Matches.emplace_back(installedByPC, Criteria());
+        result.Matches.emplace_back(installedNoMatch, Criteria());
+        return result;
+    };
+
+    size_t availableSearchCount = 0;
+    setup.Available->SearchFunction = [&](const SearchRequest& request)
+    {
+        ++availableSearchCount;
+        RequireIncludes(request.Inclusions, PackageMatchField::PackageFamilyName, MatchType::Exact, pfn);
+        RequireIncludes(request.Inclusions, PackageMatchField::ProductCode, MatchType::Exact, pc);
+
+        SearchResult result;
+        result.Matches.emplace_back(availableByPC, Criteria(PackageMatchField::ProductCode));
+        result.Matches.emplace_back(availableByPFN, Criteria(PackageMatchField::PackageFamilyName));
+        return result;
+    };
+
+    SearchResult result = setup.Composite.Search({});
+
+    REQUIRE(availableSearchCount == 1);
+    REQUIRE(result.Matches.size() == 3);
+
+    for (const auto& match : result.Matches)
+    {
+        std::string installedName = match.Package->GetInstalledVersion()->GetProperty(PackageVersionProperty::Name);
+        auto latest = match.Package->GetLatestAvailableVersion();
+
+        if (installedName == "PFN Package")
+        {
+            REQUIRE(latest);
+            REQUIRE(latest->GetProperty(PackageVersionProperty::Id).get() == "PFN.ID");
+        }
+        else if (installedName == "PC Package")
+        {
+            REQUIRE(latest);
+            REQUIRE(latest->GetProperty(PackageVersionProperty::Id).get() == "PC.ID");
+        }
+        else
+        {
+            REQUIRE(!latest);
+        }
+    }
+}
+
+TEST_CASE("CompositeSource_Batched_PackageInSeveralBatches", "[CompositeSource]")
+{
+    // Enough installed packages that their correlation takes more than one request
+    constexpr size_t packageCount = 150;
+
+    std::vector<std::shared_ptr<IPackage>> installedPackages;
+    std::vector<std::shared_ptr<TestPackage>> availablePackages;
+    size_t differentIdComparisons = 0;
+
+    for (size_t i = 0; i < packageCount; ++i)
+    {
+        std::string index = std::to_string(i);
+        installedPackages.emplace_back(MakeInstalled().WithPFN("pfn_" + index).WithDefaultName("Package " + index));
+
+        std::shared_ptr<IPackage> availablePackage = MakeAvailable().WithPFN("pfn_" + index).WithId("Available." + index).WithDefaultName("Package " + index);
+        auto testPackage = std::dynamic_pointer_cast<TestPackage>(availablePackage);
+        testPackage->IsSameOverride = [&](const IPackage* package, const IPackage* other)
+        {
+            if (package->GetProperty(PackageProperty::Id).get() != other->GetProperty(PackageProperty::Id).get())
+            {
+                ++differentIdComparisons;
+            }
+
+            return package == other;
+        };
+        availablePackages.emplace_back(std::move(testPackage));
+    }
+
+    CompositeTestSetup setup;
+    setup.Installed->SearchFunction = [&](const SearchRequest&)
+    {
+        SearchResult result;
+        for (const auto& package : installedPackages)
+        {
+            result.Matches.emplace_back(package, Criteria());
+        }
+        return result;
+    };
+
+    // Every request finds the packages of the family names in it, and the first package regardless
+    size_t availableSearchCount = 0;
+    setup.Available->SearchFunction = [&](const SearchRequest& request)
+    {
+        ++availableSearchCount;
+
+        SearchResult result;
+        result.Matches.emplace_back(availablePackages[0], Criteria(PackageMatchField::PackageFamilyName));
+
+        for (size_t i = 1; i < packageCount; ++i)
+        {
+            std::string pfn = "pfn_" + std::to_string(i);
+            if (std::any_of(request.Inclusions.begin(), request.Inclusions.end(), [&](const PackageMatchFilter& filter) { return filter.Value == pfn; }))
+            {
+                result.Matches.emplace_back(availablePackages[i], Criteria(PackageMatchField::PackageFamilyName));
+            }
+        }
+
+        return result;
+    };
+
+    SearchResult result = setup.Composite.Search({});
+
+    REQUIRE(availableSearchCount > 1);
+    REQUIRE(result.Matches.size() == packageCount);
+
+    // The first package is only correlated if finding it in each request did not make it ambiguous
+    for (const auto& match : result.Matches)
+    {
+        auto latest = match.Package->GetLatestAvailableVersion();
+        REQUIRE(latest);
+
+        std::string installedName = match.Package->GetInstalledVersion()->GetProperty(PackageVersionProperty::Name);
+        REQUIRE(installedName.substr(installedName.find(' ') + 1) == latest->GetProperty(PackageVersionProperty::Id).get().substr(10));
+    }
+
+    // Packages are only compared with those that share their identifier
+    REQUIRE(differentIdComparisons == 0);
+}
+
+TEST_CASE("CompositeSource_Batched_TrackingFound", "[CompositeSource]")
+{
+    std::string availableID = "Available.ID";
+    std::string pfn = "sortof_apfn";
+
+    auto installedTracked = MakeInstalled().WithPFN(pfn).WithDefaultName("Tracked Package");
+    auto installedOther = MakeInstalled().WithPFN("other_pfn").WithDefaultName("Other Package");
+    auto availablePackage = MakeAvailable().WithPFN(pfn).WithId(availableID);
+
+    CompositeWithTrackingTestSetup setup;
+    setup.Installed->SearchFunction = [&](const SearchRequest&)
+    {
+        SearchResult result;
+        result.Matches.emplace_back(installedTracked, Criteria());
+        result.Matches.emplace_back(installedOther, Criteria());
+        return result;
+    };
+
+    setup.Available->SearchFunction = [&](const SearchRequest& request)
+    {
+        SearchResult result;
+
+        if (!request.Inclusions.empty() && request.Inclusions[0].Field == PackageMatchField::Id)
+        {
+            RequireIncludes(request.Inclusions, PackageMatchField::Id, MatchType::CaseInsensitive, availableID);
+            result.Matches.emplace_back(availablePackage, Criteria());
+        }
+
+        return result;
+    };
+
+    setup.Tracking->GetIndex().AddManifest(availablePackage);
+
+    SearchResult result = setup.Composite.Search({});
+
+    REQUIRE(result.Matches.size() == 2);
+
+    for (const auto& match : result.Matches)
+    {
+        auto installedVersion = match.Package->GetInstalledVersion();
+        if (installedVersion->GetProperty(PackageVersionProperty::Name) == "Tracked Package")
+        {
+            REQUIRE(installedVersion->GetSource().GetIdentifier() == setup.Available->Details.Identifier);
+            REQUIRE(match.Package->GetLatestAvailableVersion());
+        }
+        else
+        {
+            REQUIRE(!match.Package->GetLatestAvailableVersion());
+        }
+    }
+}
+
+TEST_CASE("Benchmark_CompositeSource_MergeResults", "[.][benchmark]")
+{
+    constexpr size_t s_PackageCount = 700;
+
+    std::vector<std::shared_ptr<IPackage>> installed;
+    std::map<std::string, std::shared_ptr<IPackage>> availableByProductCode;
+
+    CompositeTestSetup setup;
+
+    for (size_t i = 0; i < s_PackageCount; ++i)
+    {
+        std::string index = std::to_string(i);
+        std::string pc = "{benchmark-product-code-" + index + "}";
+
+        installed.emplace_back(MakeInstalled().WithId("Installed.Package" + index).WithPC(pc).WithDefaultName("Benchmark Package " + index));
+
+        std::shared_ptr<IPackage> available = MakeAvailable().WithId("Benchmark.Package" + index).WithPC(pc).WithDefaultName("Benchmark Package " + index);
+        availableByProductCode.emplace(pc, available);
+
+        setup.Installed->Everything.Matches.emplace_back(installed.back(), Criteria());
+        setup.Available->Everything.Matches.emplace_back(available, Criteria());
+    }
+
+    // Correlation looks up the one package with the product code of the package being correlated.
+    auto correlate = [](const std::map<std::string, std::shared_ptr<IPackage>>& packages, const SearchRequest& request)
+    {
+        SearchResult result;
+        for (const auto& inclusion : request.Inclusions)
+        {
+            auto itr = packages.find(inclusion.Value);
+            if (inclusion.Field == PackageMatchField::ProductCode && itr != packages.end())
+            {
+                result.Matches.emplace_back(itr->second, Criteria(PackageMatchField::ProductCode));
+                break;
+            }
+        }
+        return result;
+    };
+
+    std::map<std::string, std::shared_ptr<IPackage>> installedByProductCode;
+    for (size_t i = 0; i < s_PackageCount; ++i)
+    {
+        installedByProductCode.emplace("{benchmark-product-code-" + std::to_string(i) + "}", installed[i]);
+    }
+
+    setup.Installed->SearchFunction = [&](const SearchRequest& request) { return correlate(installedByProductCode, request); };
+    setup.Available->SearchFunction = [&](const SearchRequest& request) { return correlate(availableByProductCode, request); };
+
+    BenchmarkResults::Measure("CompositeSource_MergeResults", 5, s_PackageCount, [&]()
+        {
+            SearchResult result = setup.Search();
+            REQUIRE(result.Matches.size() == s_PackageCount);
+        });
+}
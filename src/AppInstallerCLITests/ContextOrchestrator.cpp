@@ -0,0 +1,360 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include <ContextOrchestrator.h>
+#include <COMContext.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace std::chrono_literals;
+using namespace TestCommon;
+using namespace AppInstaller::CLI::Execution;
+
+namespace
+{
+    // Drives a controller through periods of simulated downloads.
+    struct TestController
+    {
+        TestController(UINT32 initialLimit, UINT32 maximumLimit) : Now(DownloadConcurrencyController::clock::now()), Controller(initialLimit, maximumLimit, Now) {}
+
+        // Runs one period in which each of the downloads receives the given number of bytes.
+        std::optional<UINT32> RunPeriod(std::vector<DownloadConcurrencyController::DownloadId> downloads, uint64_t bytesPerDownload, bool hasWaitingDownloads = true, std::string_view host = "host")
+        {
+            for (auto id : downloads)
+            {
+                Received[id] += bytesPerDownload;
+                Controller.RecordProgress(id, host, Received[id]);
+            }
+
+            Now += DownloadConcurrencyController::SamplePeriod;
+            return Controller.Evaluate(hasWaitingDownloads, Now);
+        }
+
+        DownloadConcurrencyController::clock::time_point Now;
+        DownloadConcurrencyController Controller;
+        std::map<DownloadConcurrencyController::DownloadId, uint64_t> Received;
+    };
+
+    std::shared_ptr<OrchestratorQueueItem> CreateTestItem(size_t index)
+    {
+        return std::make_shared<OrchestratorQueueItem>(OrchestratorQueueItemId(L"Package." + std::to_wstring(index), L"TestSource"), std::make_unique<COMContext>());
+    }
+
+    // The waiting items of a queue, run one at a time by a scheduler.
+    struct TestScheduler
+    {
+        std::shared_ptr<OrchestratorQueueItem> Enqueue(OrchestratorQueueItemPriority priority, DWORD callerProcessId = 1)
+        {
+            auto item = CreateTestItem(m_nextIndex++);
+            item->SetPriority(priority);
+            item->SetCallerProcessId(callerProcessId);
+            item->SetState(OrchestratorQueueItemState::Queued);
+            Scheduler.OnItemQueued(*item);
+            Items.push_back(item);
+            return item;
+        }
+
+        // Starts the next item, and removes it from the waiting items as if it had finished.
+        std::shared_ptr<OrchestratorQueueItem> RunNext()
+        {
+            auto item = Scheduler.SelectNextItem(Items);
+            REQUIRE(item);
+            REQUIRE(item->GetState() == OrchestratorQueueItemState::Queued);
+
+            item->SetState(OrchestratorQueueItemState::Running);
+            Scheduler.OnItemStarted(*item);
+            Items.remove(item);
+            return item;
+        }
+
+        OrchestratorQueueScheduler Scheduler;
+        std::list<std::shared_ptr<OrchestratorQueueItem>> Items;
+
+    private:
+        size_t m_nextIndex = 0;
+    };
+}
+
+TEST_CASE("OrchestratorQueueMutex_RecordsContention", "[orchestrator]")
+{
+    OrchestratorQueueMutex mutex;
+    OrchestratorLockStatistics before = GetOrchestratorLockStatistics();
+
+    std::unique_lock<OrchestratorQueueMutex> lock{ mutex };
+    std::thread waiter{ [&]() { std::lock_guard<OrchestratorQueueMutex> waiting{ mutex }; } };
+
+    // Give the waiter time to block on the lock before it is released.
+    std::this_thread::sleep_for(50ms);
+    lock.unlock();
+    waiter.join();
+
+    OrchestratorLockStatistics after = GetOrchestratorLockStatistics();
+    REQUIRE(after.Acquisitions >= before.Acquisitions + 2);
+    REQUIRE(after.ContendedAcquisitions > before.ContendedAcquisitions);
+    REQUIRE(after.TotalWait > before.TotalWait);
+    REQUIRE(after.MaximumWait >= 10ms);
+}
+
+TEST_CASE("OrchestratorQueueItemIndex_AddFindRemove", "[orchestrator]")
+{
+    OrchestratorQueueItemIndex index;
+
+    auto item = CreateTestItem(1);
+    REQUIRE(index.Add(item));
+    REQUIRE(index.Find(OrchestratorQueueItemId(L"Package.1", L"TestSource")) == item);
+    REQUIRE(!index.Find(OrchestratorQueueItemId(L"Package.1", L"OtherSource")));
+
+    // Another item with the same id is refused, and removing it leaves the first in place.
+    auto duplicate = CreateTestItem(1);
+    REQUIRE(!index.Add(duplicate));
+    index.Remove(*duplicate);
+    REQUIRE(index.Find(item->GetId()) == item);
+
+    index.Remove(*item);
+    REQUIRE(!index.Find(item->GetId()));
+    REQUIRE(index.Size() == 0);
+}
+
+TEST_CASE("OrchestratorQueueItemIndex_Stress", "[orchestrator]")
+{
+    constexpr size_t itemCount = 500;
+    constexpr size_t readerCount = 8;
+
+    OrchestratorQueueItemIndex index;
+    std::vector<std::shared_ptr<OrchestratorQueueItem>> items;
+    for (size_t i = 0; i < itemCount; ++i)
+    {
+        items.emplace_back(CreateTestItem(i));
+    }
+
+    // Readers poll for every item while the items are added and removed, as progress callers do.
+    std::atomic_bool done = false;
+    std::atomic<size_t> mismatches = 0;
+    std::vector<std::thread> readers;
+    for (size_t r = 0; r < readerCount; ++r)
+    {
+        readers.emplace_back([&]()
+            {
+                while (!done)
+                {
+                    for (const auto& item : items)
+                    {
+                        auto found = index.Find(item->GetId());
+                        if (found && found != item)
+                        {
+                            ++mismatches;
+                        }
+                    }
+                }
+            });
+    }
+
+    for (const auto& item : items)
+    {
+        REQUIRE(index.Add(item));
+    }
+
+    REQUIRE(index.Size() == itemCount);
+
+    for (size_t i = 0; i < itemCount; i += 2)
+    {
+        index.Remove(*items[i]);
+    }
+
+    done = true;
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+
+    REQUIRE(mismatches == 0);
+    REQUIRE(index.Size() == itemCount / 2);
+
+    for (size_t i = 0; i < itemCount; ++i)
+    {
+        REQUIRE(static_cast<bool>(index.Find(items[i]->GetId())) == (i % 2 == 1));
+    }
+}
+
+TEST_CASE("DownloadConcurrency_RaisesWhileThroughputImproves", "[orchestrator]")
+{
+    TestController test{ 1, 3 };
+
+    // Nothing is decided before the end of the period.
+    test.Controller.RecordProgress(1, "host", 100);
+    REQUIRE(!test.Controller.Evaluate(true, test.Now + 1s));
+
+    auto change = test.RunPeriod({ 1 }, 1000);
+    REQUIRE(change);
+    REQUIRE(*change == 2);
+
+    change = test.RunPeriod({ 1, 2 }, 1000);
+    REQUIRE(change);
+    REQUIRE(*change == 3);
+
+    // The maximum is never exceeded.
+    REQUIRE(!test.RunPeriod({ 1, 2, 3 }, 1000));
+    REQUIRE(test.Controller.GetLimit() == 3);
+}
+
+TEST_CASE("DownloadConcurrency_UndoesRaiseThatHurts", "[orchestrator]")
+{
+    TestController test{ 1, 3 };
+
+    REQUIRE(test.RunPeriod({ 1 }, 10000) == 2u);
+
+    // The two downloads together get less than the one did alone.
+    auto change = test.RunPeriod({ 1, 2 }, 2000);
+    REQUIRE(change);
+    REQUIRE(*change == 1);
+    test.Controller.RemoveDownload(2);
+
+    // It then holds, rather than trying again straight away.
+    REQUIRE(!test.RunPeriod({ 1 }, 10000));
+}
+
+TEST_CASE("DownloadConcurrency_OnlyRaisesWhenDownloadsWait", "[orchestrator]")
+{
+    TestController test{ 1, 3 };
+
+    REQUIRE(!test.RunPeriod({ 1 }, 1000, false));
+    REQUIRE(test.Controller.GetLimit() == 1);
+}
+
+TEST_CASE("DownloadConcurrency_RespectsHostLimit", "[orchestrator]")
+{
+    UINT32 limit = DownloadConcurrencyController::MaximumDownloadsPerHost;
+    TestController test{ limit, limit + 2 };
+
+    std::vector<DownloadConcurrencyController::DownloadId> downloads;
+    for (UINT32 i = 0; i < limit; ++i)
+    {
+        downloads.push_back(100 + i);
+    }
+
+    REQUIRE(!test.RunPeriod(downloads, 1000, true, "onehost"));
+    REQUIRE(test.Controller.GetActiveHostCount() == 1);
+    REQUIRE(test.Controller.GetLimit() == limit);
+}
+
+TEST_CASE("OrchestratorQueueScheduler_HigherPriorityFirst", "[orchestrator]")
+{
+    TestScheduler test;
+    auto low = test.Enqueue(OrchestratorQueueItemPriority::Low);
+    auto normal = test.Enqueue(OrchestratorQueueItemPriority::Normal);
+    auto high = test.Enqueue(OrchestratorQueueItemPriority::High);
+    auto secondNormal = test.Enqueue(OrchestratorQueueItemPriority::Normal);
+
+    // Items of the same priority run in the order they were queued.
+    REQUIRE(test.RunNext() == high);
+    REQUIRE(test.RunNext() == normal);
+    REQUIRE(test.RunNext() == secondNormal);
+    REQUIRE(test.RunNext() == low);
+    REQUIRE(!test.Scheduler.SelectNextItem(test.Items));
+}
+
+TEST_CASE("OrchestratorQueueScheduler_SkipsItemsNotWaiting", "[orchestrator]")
+{
+    TestScheduler test;
+    auto running = test.Enqueue(OrchestratorQueueItemPriority::High);
+    running->SetState(OrchestratorQueueItemState::Running);
+    auto queued = test.Enqueue(OrchestratorQueueItemPriority::Normal);
+
+    REQUIRE(test.Scheduler.SelectNextItem(test.Items) == queued);
+
+    // Cancelled items are selected ahead of everything else, so that they are removed.
+    auto cancelled = test.Enqueue(OrchestratorQueueItemPriority::Low);
+    cancelled->SetState(OrchestratorQueueItemState::Cancelled);
+
+    REQUIRE(test.Scheduler.SelectNextItem(test.Items) == cancelled);
+}
+
+TEST_CASE("OrchestratorQueueScheduler_CallersTakeTurns", "[orchestrator]")
+{
+    TestScheduler test;
+    auto first1 = test.Enqueue(OrchestratorQueueItemPriority::Normal, 1);
+    auto second1 = test.Enqueue(OrchestratorQueueItemPriority::Normal, 1);
+    auto third1 = test.Enqueue(OrchestratorQueueItemPriority::Normal, 1);
+    auto first2 = test.Enqueue(OrchestratorQueueItemPriority::Normal, 2);
+    auto second2 = test.Enqueue(OrchestratorQueueItemPriority::Normal, 2);
+
+    // One caller queueing many items does not hold up another caller.
+    REQUIRE(test.RunNext() == first1);
+    REQUIRE(test.RunNext() == first2);
+    REQUIRE(test.RunNext() == second1);
+    REQUIRE(test.RunNext() == second2);
+    REQUIRE(test.RunNext() == third1);
+}
+
+TEST_CASE("OrchestratorQueueScheduler_LowPriorityNotStarved", "[orchestrator]")
+{
+    TestScheduler test;
+    auto low = test.Enqueue(OrchestratorQueueItemPriority::Low);
+    test.Enqueue(OrchestratorQueueItemPriority::Normal);
+
+    // A new item of a higher priority arrives every time one starts, so there is always one waiting ahead of the low priority item.
+    size_t started = 0;
+    for (; started < 10 * OrchestratorQueueScheduler::AgingRunCount; ++started)
+    {
+        auto item = test.RunNext();
+        if (item == low)
+        {
+            break;
+        }
+
+        REQUIRE(item->GetPriority() == OrchestratorQueueItemPriority::Normal);
+        test.Enqueue(OrchestratorQueueItemPriority::Normal);
+    }
+
+    // It runs once it has been raised to the priority of the items arriving, as it has waited longer than any of them.
+    REQUIRE(started == OrchestratorQueueScheduler::AgingRunCount);
+    REQUIRE(low->GetState() == OrchestratorQueueItemState::Running);
+}
+
+TEST_CASE("OrchestratorQueueScheduler_AgingRaisesPriority", "[orchestrator]")
+{
+    TestScheduler test;
+    auto low = test.Enqueue(OrchestratorQueueItemPriority::Low);
+    REQUIRE(test.Scheduler.GetEffectivePriority(*low) == static_cast<uint64_t>(OrchestratorQueueItemPriority::Low));
+
+    for (uint64_t i = 0; i < 2 * OrchestratorQueueScheduler::AgingRunCount; ++i)
+    {
+        test.Enqueue(OrchestratorQueueItemPriority::High);
+        REQUIRE(test.RunNext() != low);
+    }
+
+    // After waiting through enough items, it is even level with new items of the highest priority, and ahead of them as it is older.
+    REQUIRE(test.Scheduler.GetEffectivePriority(*low) == static_cast<uint64_t>(OrchestratorQueueItemPriority::High));
+    test.Enqueue(OrchestratorQueueItemPriority::High);
+    REQUIRE(test.RunNext() == low);
+}
+
+TEST_CASE("OrchestratorQueueScheduler_PausesForHigherPriority", "[orchestrator]")
+{
+    TestScheduler test;
+    auto running = test.Enqueue(OrchestratorQueueItemPriority::Normal);
+    running->SetState(OrchestratorQueueItemState::Running);
+
+    // Nothing is waiting, or only items that are not ahead of the running one.
+    REQUIRE(!test.Scheduler.ShouldPause(test.Items, *running, 1, 0));
+    test.Enqueue(OrchestratorQueueItemPriority::Normal);
+    test.Enqueue(OrchestratorQueueItemPriority::Low);
+    REQUIRE(!test.Scheduler.ShouldPause(test.Items, *running, 1, 0));
+
+    // An item of a higher priority only takes the thread of the running one if it cannot have its own.
+    auto high = test.Enqueue(OrchestratorQueueItemPriority::High);
+    REQUIRE(test.Scheduler.ShouldPause(test.Items, *running, 1, 0));
+    REQUIRE(!test.Scheduler.ShouldPause(test.Items, *running, 2, 0));
+
+    // Once a paused item has lent its thread, another one does not also pause.
+    auto otherRunning = test.Enqueue(OrchestratorQueueItemPriority::Normal);
+    otherRunning->SetState(OrchestratorQueueItemState::Running);
+    REQUIRE(test.Scheduler.ShouldPause(test.Items, *otherRunning, 2, 0));
+    REQUIRE(!test.Scheduler.ShouldPause(test.Items, *otherRunning, 2, 1));
+
+    // The waiting item runs next, ahead of those queued before it, and the running items no longer need to pause.
+    REQUIRE(test.RunNext() == high);
+    REQUIRE(!test.Scheduler.ShouldPause(test.Items, *running, 1, 0));
+}
@@ -128,6 +128,79 @@ TEST_CASE("DependencyGraph_EasyToSeeLoop", "[dependencyGraph][dependencies]")
     REQUIRE(installationOrder.at(1).Id == "EasyToSeeLoop");
 }
 
+TEST_CASE("DependencyGraph_InstallationLevels", "[dependencyGraph][dependencies]")
+{
+    const auto& manifest = CreateFakeManifestWithDependencies("DependencyAlreadyInStackButNoLoop");
+    const Dependency& rootAsDependency = Dependency(DependencyType::Package, manifest.Id);
+    DependencyList rootDependencies;
+    std::for_each(manifest.Installers.begin(), manifest.Installers.end(), [&](ManifestInstaller installer) { rootDependencies.Add(installer.Dependencies); });
+
+    DependencyGraph graph(rootAsDependency, rootDependencies, [&](Dependency node)
+        {
+            DependencyList dependencyList;
+            auto dependencyManifest = CreateFakeManifestWithDependencies(node.Id);
+
+            for (auto installer : dependencyManifest.Installers)
+            {
+                dependencyList.Add(installer.Dependencies);
+            }
+
+            return dependencyList;
+        });
+
+    graph.BuildGraph();
+
+    REQUIRE(!graph.HasLoop());
+
+    // C and F both depend on B, but not on each other
+    auto installationLevels = graph.GetInstallationLevels();
+    REQUIRE(installationLevels.size() == 3);
+    REQUIRE(installationLevels.at(0).size() == 1);
+    REQUIRE(installationLevels.at(0).at(0).Id == "B");
+    REQUIRE(installationLevels.at(1).size() == 2);
+    REQUIRE(installationLevels.at(1).at(0).Id == "C");
+    REQUIRE(installationLevels.at(1).at(1).Id == "F");
+    REQUIRE(installationLevels.at(2).size() == 1);
+    REQUIRE(installationLevels.at(2).at(0).Id == "DependencyAlreadyInStackButNoLoop");
+}
+
+TEST_CASE("DependencyGraph_SharedDependencies", "[dependencyGraph][dependencies]")
+{
+    // A chain of diamonds, where every level depends on both nodes of the next; there are 2^levels paths
+    // from the root to the end, but each node should only be visited once.
+    constexpr int s_levelCount = 40;
+    auto nodeId = [](int level, char side) { return "Level" + std::to_string(level) + side; };
+
+    Dependency rootAsDependency(DependencyType::Package, "Root");
+
+    DependencyGraph graph(rootAsDependency, [&](const Dependency& node)
+        {
+            DependencyList dependencyList;
+            int nextLevel = (node.Id == "Root" ? 0 : std::stoi(node.Id.substr(5)) + 1);
+
+            if (nextLevel < s_levelCount)
+            {
+                dependencyList.Add(Dependency(DependencyType::Package, nodeId(nextLevel, 'A')));
+                dependencyList.Add(Dependency(DependencyType::Package, nodeId(nextLevel, 'B')));
+            }
+
+            return dependencyList;
+        });
+
+    graph.BuildGraph();
+
+    REQUIRE(!graph.HasLoop());
+
+    auto installationOrder = graph.GetInstallationOrder();
+    REQUIRE(installationOrder.size() == s_levelCount * 2 + 1);
+    REQUIRE(installationOrder.back().Id == "Root");
+
+    auto installationLevels = graph.GetInstallationLevels();
+    REQUIRE(installationLevels.size() == s_levelCount + 1);
+    REQUIRE(installationLevels.at(0).size() == 2);
+    REQUIRE(installationLevels.at(0).at(0).Id == nodeId(s_levelCount - 1, 'A'));
+}
+
 TEST_CASE("DependencyNodeProcessor_SkipInstalled", "[dependencies]")
 {
     TestCommon::TempFile installResultPath("TestExeInstalled.txt");
@@ -2,12 +2,15 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "TestCommon.h"
+#include "TestHttpServer.h"
 #include "AppInstallerDownloader.h"
 #include "AppInstallerSHA256.h"
+#include "AppInstallerStrings.h"
 
 using namespace AppInstaller;
 using namespace AppInstaller::Utility;
 using namespace std::string_literals;
+using namespace std::chrono_literals;
 
 TEST_CASE("DownloadValidFileAndVerifyHash", "[Downloader]")
 {
@@ -28,6 +31,7 @@ TEST_CASE("DownloadValidFileAndVerifyHash", "[Downloader]")
         resultHash.begin()));
 
     REQUIRE(std::filesystem::file_size(tempFile.GetPath()) > 0);
+    REQUIRE(!HasPartialDownload(tempFile.GetPath()));
 
     // Verify motw content
     std::filesystem::path motwFile(tempFile);
@@ -39,6 +43,632 @@ TEST_CASE("DownloadValidFileAndVerifyHash", "[Downloader]")
     REQUIRE(motwContentStr.find("ZoneId=3") != std::string::npos);
 }
 
+TEST_CASE("DownloadSameContentConcurrently", "[Downloader]")
+{
+    TestCommon::TempFile tempFile("downloader_test"s, ".test"s);
+    TestCommon::TempFile otherTempFile("downloader_test"s, ".test"s);
+
+    const std::string url = "https://raw.githubusercontent.com/microsoft/msix-packaging/master/LICENSE";
+    auto expectedHash = SHA256::ConvertToBytes("d2a45116709136462ee7a1c42f0e75f0efa258fe959b1504dc8ea4573451b759");
+
+    ProgressCallback callback;
+    ProgressCallback otherCallback;
+
+    std::optional<std::vector<BYTE>> otherResult;
+    std::thread otherThread([&]
+        {
+            otherResult = Download(url, otherTempFile.GetPath(), DownloadType::Manifest, otherCallback, true);
+        });
+
+    auto result = Download(url, tempFile.GetPath(), DownloadType::Manifest, callback, true);
+    otherThread.join();
+
+    // Whether or not the downloads overlapped, both requests get the whole content.
+    REQUIRE(result.has_value());
+    REQUIRE(otherResult.has_value());
+    REQUIRE(result.value() == expectedHash);
+    REQUIRE(otherResult.value() == expectedHash);
+    REQUIRE(std::filesystem::file_size(tempFile.GetPath()) == std::filesystem::file_size(otherTempFile.GetPath()));
+    REQUIRE(!HasPartialDownload(otherTempFile.GetPath()));
+}
+
+namespace
+{
+    // Creates content that differs at every offset within a short distance, so that misplaced bytes change its hash.
+    std::string CreateTestBody(size_t size)
+    {
+        std::string body(size, '\0');
+        for (size_t i = 0; i < body.size(); ++i)
+        {
+            body[i] = static_cast<char>(i % 251);
+        }
+
+        return body;
+    }
+
+    // Reports that it is waiting on a download through IsCancelled, and blocks in OnProgress until released.
+    struct BlockingProgress : public IProgressCallback
+    {
+        void BeginProgress() override {}
+
+        void OnProgress(uint64_t, uint64_t, ProgressType) override
+        {
+            std::unique_lock<std::mutex> lock{ m_lock };
+            m_entered = true;
+            m_changed.notify_all();
+            m_changed.wait(lock, [&]() { return m_released; });
+        }
+
+        void EndProgress(bool) override {}
+
+        bool IsCancelled() override
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+            m_waiting = true;
+            m_changed.notify_all();
+            return false;
+        }
+
+        CancelFunctionRemoval SetCancellationFunction(std::function<void()>&&) override { return {}; }
+
+        template <typename Predicate>
+        bool WaitFor(Predicate predicate)
+        {
+            std::unique_lock<std::mutex> lock{ m_lock };
+            return m_changed.wait_for(lock, 30s, [&]() { return predicate(*this); });
+        }
+
+        void Release()
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+            m_released = true;
+            m_changed.notify_all();
+        }
+
+        bool m_waiting = false;
+        bool m_entered = false;
+        bool m_released = false;
+
+    private:
+        std::mutex m_lock;
+        std::condition_variable m_changed;
+    };
+}
+
+TEST_CASE("DownloadSameContent_BlockingProgressDoesNotBlockOtherDownloads", "[Downloader]")
+{
+    TestCommon::TestHttpServer server;
+
+    std::string body = CreateTestBody(4 * 1024 * 1024);
+
+    // The shared download is held at its start until the second request is waiting on it.
+    std::mutex gateLock;
+    std::condition_variable gateChanged;
+    bool gateOpen = false;
+
+    TestCommon::TestHttpServer::Content shared;
+    shared.Body = body;
+    shared.BeforeSend = [&](size_t)
+    {
+        std::unique_lock<std::mutex> lock{ gateLock };
+        return gateChanged.wait_for(lock, 30s, [&]() { return gateOpen; });
+    };
+    server.SetContent("/shared", shared);
+
+    TestCommon::TestHttpServer::Content other;
+    other.Body = body;
+    server.SetContent("/other", other);
+
+    TestCommon::TempFile tempFile("downloader_test"s, ".test"s);
+    TestCommon::TempFile waiterTempFile("downloader_test"s, ".test"s);
+    TestCommon::TempFile otherTempFile("downloader_test"s, ".test"s);
+
+    ProgressCallback callback;
+    std::optional<std::vector<BYTE>> result;
+    std::thread downloadThread([&]
+        {
+            result = Download(server.GetUrl("/shared"), tempFile.GetPath(), DownloadType::Manifest, callback, true);
+        });
+
+    auto openGate = wil::scope_exit([&]()
+        {
+            {
+                std::lock_guard<std::mutex> lock{ gateLock };
+                gateOpen = true;
+            }
+            gateChanged.notify_all();
+        });
+
+    // The first request has reached the server before the second is made, so the second waits on it.
+    for (size_t i = 0; i < 300 && server.GetRequests().empty(); ++i)
+    {
+        std::this_thread::sleep_for(100ms);
+    }
+    REQUIRE(!server.GetRequests().empty());
+
+    BlockingProgress blockingProgress;
+    auto releaseProgress = wil::scope_exit([&]() { blockingProgress.Release(); });
+
+    std::optional<std::vector<BYTE>> waiterResult;
+    std::thread waiterThread([&]
+        {
+            waiterResult = Download(server.GetUrl("/shared"), waiterTempFile.GetPath(), DownloadType::Manifest, blockingProgress, true);
+        });
+
+    REQUIRE(blockingProgress.WaitFor([](const BlockingProgress& p) { return p.m_waiting; }));
+    openGate.reset();
+    REQUIRE(blockingProgress.WaitFor([](const BlockingProgress& p) { return p.m_entered; }));
+
+    // While the waiter's progress is blocked, another download still starts and completes.
+    auto otherDownload = std::async(std::launch::async, [&]()
+        {
+            ProgressCallback otherCallback;
+            return Download(server.GetUrl("/other"), otherTempFile.GetPath(), DownloadType::Manifest, otherCallback, true);
+        });
+    REQUIRE(otherDownload.wait_for(30s) == std::future_status::ready);
+
+    releaseProgress.reset();
+    downloadThread.join();
+    waiterThread.join();
+
+    auto expectedHash = SHA256::ComputeHash(body);
+    auto otherResult = otherDownload.get();
+    REQUIRE(result.has_value());
+    REQUIRE(waiterResult.has_value());
+    REQUIRE(otherResult.has_value());
+    REQUIRE(result.value() == expectedHash);
+    REQUIRE(waiterResult.value() == expectedHash);
+    REQUIRE(otherResult.value() == expectedHash);
+    REQUIRE(std::filesystem::file_size(waiterTempFile.GetPath()) == body.size());
+}
+
+namespace
+{
+    // Requests a pause once the download has received enough bytes, and calls a function while it is paused.
+    struct PausingProgress : public IProgressCallback
+    {
+        PausingProgress(uint64_t pauseAt, std::function<void()> whilePaused) : m_pauseAt(pauseAt), m_whilePaused(std::move(whilePaused)) {}
+
+        void BeginProgress() override {}
+
+        void OnProgress(uint64_t current, uint64_t, ProgressType) override { m_current = current; }
+
+        void EndProgress(bool) override {}
+
+        bool IsPauseRequested() override { return m_pauseCount == 0 && m_current >= m_pauseAt; }
+
+        void WaitWhilePaused() override
+        {
+            ++m_pauseCount;
+            m_whilePaused();
+        }
+
+        bool IsCancelled() override { return false; }
+
+        CancelFunctionRemoval SetCancellationFunction(std::function<void()>&&) override { return {}; }
+
+        size_t m_pauseCount = 0;
+
+    private:
+        uint64_t m_pauseAt;
+        std::function<void()> m_whilePaused;
+        std::atomic<uint64_t> m_current = 0;
+    };
+}
+
+TEST_CASE("Download_PausesBetweenChunksAndContinues", "[Downloader]")
+{
+    TestCommon::TestUserSettings settings;
+    settings.Set<AppInstaller::Settings::Setting::NetworkDownloader>(AppInstaller::Settings::InstallerDownloader::WinInet);
+    settings.Set<AppInstaller::Settings::Setting::NetworkDownloadSegments>(1);
+
+    TestCommon::TestHttpServer server;
+    std::string body = CreateTestBody(4 * 1024 * 1024);
+
+    TestCommon::TestHttpServer::Content content;
+    content.Body = body;
+    content.ETag = "\"pause\"";
+    server.SetContent("/installer", content);
+
+    TestCommon::TempFile tempFile("downloader_test"s, ".test"s);
+
+    std::vector<TestCommon::TestHttpServer::Request> requestsWhilePaused;
+    PausingProgress progress{ 1024 * 1024, [&]() { requestsWhilePaused = server.GetRequests(); } };
+
+    auto result = Download(server.GetUrl("/installer"), tempFile.GetPath(), DownloadType::Installer, progress, true);
+
+    // The download stopped between chunks and waited without making another request.
+    REQUIRE(progress.m_pauseCount == 1);
+    REQUIRE(requestsWhilePaused.size() == 1);
+
+    // It then continued with a new request for the rest of the content, rather than starting over.
+    auto requests = server.GetRequests();
+    REQUIRE(requests.size() == 2);
+    REQUIRE(requests[0].Range.empty());
+    REQUIRE(CaseInsensitiveStartsWith(requests[1].Range, "bytes="));
+    REQUIRE(requests[1].Range != "bytes=0-");
+    REQUIRE(requests[1].IfRange == content.ETag);
+
+    REQUIRE(result.has_value());
+    REQUIRE(result.value() == SHA256::ComputeHash(body));
+    REQUIRE(std::filesystem::file_size(tempFile.GetPath()) == body.size());
+    REQUIRE(!HasPartialDownload(tempFile.GetPath()));
+}
+
+namespace
+{
+    // Cancels the download once it has received enough bytes, leaving a partial download behind.
+    struct CancellingProgress : public IProgressCallback
+    {
+        CancellingProgress(uint64_t cancelAt) : m_cancelAt(cancelAt) {}
+
+        void BeginProgress() override {}
+
+        void OnProgress(uint64_t current, uint64_t, ProgressType) override { m_current = current; }
+
+        void EndProgress(bool) override {}
+
+        bool IsCancelled() override { return m_current >= m_cancelAt; }
+
+        CancelFunctionRemoval SetCancellationFunction(std::function<void()>&&) override { return {}; }
+
+    private:
+        uint64_t m_cancelAt;
+        std::atomic<uint64_t> m_current = 0;
+    };
+
+    // Downloads the content at the url until it is cancelled, and returns the size of the partial download.
+    uintmax_t CreatePartialDownload(const std::string& url, const std::filesystem::path& dest, size_t contentSize)
+    {
+        CancellingProgress progress{ 1 };
+        auto result = Download(url, dest, DownloadType::Installer, progress, true);
+
+        REQUIRE(!result.has_value());
+        REQUIRE(HasPartialDownload(dest));
+
+        uintmax_t size = std::filesystem::file_size(dest);
+        REQUIRE(size > 0);
+        REQUIRE(size < contentSize);
+        return size;
+    }
+}
+
+TEST_CASE("Download_ContinuesPartialDownload", "[Downloader]")
+{
+    TestCommon::TestUserSettings settings;
+    settings.Set<AppInstaller::Settings::Setting::NetworkDownloader>(AppInstaller::Settings::InstallerDownloader::WinInet);
+    settings.Set<AppInstaller::Settings::Setting::NetworkDownloadSegments>(1);
+
+    TestCommon::TestHttpServer server;
+    std::string body = CreateTestBody(4 * 1024 * 1024);
+
+    TestCommon::TestHttpServer::Content content;
+    content.Body = body;
+    content.ETag = "\"partial\"";
+    server.SetContent("/installer", content);
+
+    TestCommon::TempFile tempFile("downloader_test"s, ".test"s);
+    uintmax_t partialSize = CreatePartialDownload(server.GetUrl("/installer"), tempFile.GetPath(), body.size());
+
+    ProgressCallback progress;
+    auto result = Download(server.GetUrl("/installer"), tempFile.GetPath(), DownloadType::Installer, progress, true);
+
+    // Only the content after the partial download was requested.
+    auto requests = server.GetRequests();
+    REQUIRE(requests.size() == 2);
+    REQUIRE(requests[1].Range == "bytes=" + std::to_string(partialSize) + "-");
+    REQUIRE(requests[1].IfRange == content.ETag);
+
+    REQUIRE(result.has_value());
+    REQUIRE(result.value() == SHA256::ComputeHash(body));
+    REQUIRE(std::filesystem::file_size(tempFile.GetPath()) == body.size());
+    REQUIRE(!HasPartialDownload(tempFile.GetPath()));
+}
+
+TEST_CASE("Download_PartialDownloadOfChangedContentStartsOver", "[Downloader]")
+{
+    TestCommon::TestUserSettings settings;
+    settings.Set<AppInstaller::Settings::Setting::NetworkDownloader>(AppInstaller::Settings::InstallerDownloader::WinInet);
+    settings.Set<AppInstaller::Settings::Setting::NetworkDownloadSegments>(1);
+
+    TestCommon::TestHttpServer server;
+
+    TestCommon::TestHttpServer::Content content;
+    content.Body = CreateTestBody(4 * 1024 * 1024);
+
+    TestCommon::TestHttpServer::Content changed;
+    changed.Body = CreateTestBody(3 * 1024 * 1024);
+    std::reverse(changed.Body.begin(), changed.Body.end());
+
+    std::string validator;
+    SECTION("ETag")
+    {
+        content.ETag = "\"original\"";
+        changed.ETag = "\"changed\"";
+        validator = content.ETag;
+    }
+    SECTION("Last-Modified")
+    {
+        content.LastModified = "Mon, 05 Oct 2026 10:00:00 GMT";
+        changed.LastModified = "Tue, 06 Oct 2026 10:00:00 GMT";
+        validator = content.LastModified;
+    }
+
+    server.SetContent("/installer", content);
+
+    TestCommon::TempFile tempFile("downloader_test"s, ".test"s);
+    CreatePartialDownload(server.GetUrl("/installer"), tempFile.GetPath(), content.Body.size());
+
+    server.SetContent("/installer", changed);
+
+    ProgressCallback progress;
+    auto result = Download(server.GetUrl("/installer"), tempFile.GetPath(), DownloadType::Installer, progress, true);
+
+    // The range was not honored for the old validator, so the entire new content replaced the partial download.
+    auto requests = server.GetRequests();
+    REQUIRE(requests.size() == 2);
+    REQUIRE(!requests[1].Range.empty());
+    REQUIRE(requests[1].IfRange == validator);
+
+    REQUIRE(result.has_value());
+    REQUIRE(result.value() == SHA256::ComputeHash(changed.Body));
+    REQUIRE(std::filesystem::file_size(tempFile.GetPath()) == changed.Body.size());
+    REQUIRE(!HasPartialDownload(tempFile.GetPath()));
+}
+
+TEST_CASE("Download_ContinuesPartialDownload_ServerIgnoresRange", "[Downloader]")
+{
+    TestCommon::TestUserSettings settings;
+    settings.Set<AppInstaller::Settings::Setting::NetworkDownloader>(AppInstaller::Settings::InstallerDownloader::WinInet);
+    settings.Set<AppInstaller::Settings::Setting::NetworkDownloadSegments>(1);
+
+    TestCommon::TestHttpServer server;
+    std::string body = CreateTestBody(4 * 1024 * 1024);
+
+    TestCommon::TestHttpServer::Content content;
+    content.Body = body;
+    content.ETag = "\"norange\"";
+    content.SupportsRange = false;
+    server.SetContent("/installer", content);
+
+    TestCommon::TempFile tempFile("downloader_test"s, ".test"s);
+    CreatePartialDownload(server.GetUrl("/installer"), tempFile.GetPath(), body.size());
+
+    ProgressCallback progress;
+    auto result = Download(server.GetUrl("/installer"), tempFile.GetPath(), DownloadType::Installer, progress, true);
+
+    // The entire content was returned for the range, and the part already downloaded was skipped rather than written again.
+    auto requests = server.GetRequests();
+    REQUIRE(requests.size() == 2);
+    REQUIRE(!requests[1].Range.empty());
+
+    REQUIRE(result.has_value());
+    REQUIRE(result.value() == SHA256::ComputeHash(body));
+    REQUIRE(std::filesystem::file_size(tempFile.GetPath()) == body.size());
+    REQUIRE(!HasPartialDownload(tempFile.GetPath()));
+}
+
+namespace
+{
+    // Large enough to be downloaded in segments, and divided evenly into four of them.
+    constexpr size_t s_SegmentedContentSize = 17 * 1024 * 1024;
+
+    std::string ReadFileContents(const std::filesystem::path& path)
+    {
+        std::ifstream stream{ path, std::ios_base::in | std::ios_base::binary };
+        return ReadEntireStream(stream);
+    }
+}
+
+TEST_CASE("Download_Segmented_SplitsAndReassembles", "[Downloader]")
+{
+    TestCommon::TestUserSettings settings;
+    settings.Set<AppInstaller::Settings::Setting::NetworkDownloader>(AppInstaller::Settings::InstallerDownloader::WinInet);
+    settings.Set<AppInstaller::Settings::Setting::NetworkDownloadSegments>(4);
+
+    TestCommon::TestHttpServer server;
+    std::string body = CreateTestBody(s_SegmentedContentSize);
+
+    TestCommon::TestHttpServer::Content content;
+    content.Body = body;
+    content.ETag = "\"segmented\"";
+    server.SetContent("/installer", content);
+
+    TestCommon::TempFile tempFile("downloader_test"s, ".test"s);
+
+    ProgressCallback progress;
+    auto result = Download(server.GetUrl("/installer"), tempFile.GetPath(), DownloadType::Installer, progress, true);
+
+    REQUIRE(result.has_value());
+    REQUIRE(result.value() == SHA256::ComputeHash(body));
+    REQUIRE(ReadFileContents(tempFile.GetPath()) == body);
+    REQUIRE(!HasPartialDownload(tempFile.GetPath()));
+
+    // The first byte is requested to find the length, then each segment is requested as a range of the same content.
+    auto requests = server.GetRequests();
+    REQUIRE(requests.size() == 5);
+    REQUIRE(requests[0].Range == "bytes=0-0");
+
+    std::set<std::string> segmentRanges;
+    for (size_t i = 1; i < requests.size(); ++i)
+    {
+        REQUIRE(requests[i].IfRange == content.ETag);
+        segmentRanges.emplace(requests[i].Range);
+    }
+
+    const size_t segmentSize = s_SegmentedContentSize / 4;
+    std::set<std::string> expectedRanges;
+    for (size_t begin = 0; begin < s_SegmentedContentSize; begin += segmentSize)
+    {
+        expectedRanges.emplace("bytes=" + std::to_string(begin) + "-" + std::to_string(begin + segmentSize - 1));
+    }
+
+    REQUIRE(segmentRanges == expectedRanges);
+}
+
+TEST_CASE("Download_Segmented_FailedSegmentFallsBackToSingleStream", "[Downloader]")
+{
+    TestCommon::TestUserSettings settings;
+    settings.Set<AppInstaller::Settings::Setting::NetworkDownloader>(AppInstaller::Settings::InstallerDownloader::WinInet);
+    settings.Set<AppInstaller::Settings::Setting::NetworkDownloadSegments>(4);
+
+    TestCommon::TestHttpServer server;
+    std::string body = CreateTestBody(s_SegmentedContentSize);
+
+    // The connection for the second segment is closed partway through it, once.
+    const size_t failAt = s_SegmentedContentSize / 4 + 1024 * 1024;
+    std::atomic_bool failed = false;
+
+    TestCommon::TestHttpServer::Content content;
+    content.Body = body;
+    content.ETag = "\"failsegment\"";
+    content.BeforeSend = [&](size_t offset) { return offset != failAt || failed.exchange(true); };
+    server.SetContent("/installer", content);
+
+    TestCommon::TempFile tempFile("downloader_test"s, ".test"s);
+
+    ProgressCallback progress;
+    auto result = Download(server.GetUrl("/installer"), tempFile.GetPath(), DownloadType::Installer, progress, true);
+
+    REQUIRE(failed);
+
+    // The whole content was then downloaded again as a single stream, over the segments written before the failure.
+    auto requests = server.GetRequests();
+    REQUIRE(requests.size() == 6);
+    REQUIRE(requests.back().Range.empty());
+
+    REQUIRE(result.has_value());
+    REQUIRE(result.value() == SHA256::ComputeHash(body));
+    REQUIRE(ReadFileContents(tempFile.GetPath()) == body);
+    REQUIRE(!HasPartialDownload(tempFile.GetPath()));
+}
+
+TEST_CASE("Download_Segmented_ServerWithoutRangeSupport", "[Downloader]")
+{
+    TestCommon::TestUserSettings settings;
+    settings.Set<AppInstaller::Settings::Setting::NetworkDownloader>(AppInstaller::Settings::InstallerDownloader::WinInet);
+    settings.Set<AppInstaller::Settings::Setting::NetworkDownloadSegments>(4);
+
+    TestCommon::TestHttpServer server;
+    std::string body = CreateTestBody(s_SegmentedContentSize);
+
+    TestCommon::TestHttpServer::Content content;
+    content.Body = body;
+    content.ETag = "\"norangesegments\"";
+    content.SupportsRange = false;
+    server.SetContent("/installer", content);
+
+    TestCommon::TempFile tempFile("downloader_test"s, ".test"s);
+
+    ProgressCallback progress;
+    auto result = Download(server.GetUrl("/installer"), tempFile.GetPath(), DownloadType::Installer, progress, true);
+
+    // The first byte was not returned as a range, so the content was downloaded as a single stream instead.
+    auto requests = server.GetRequests();
+    REQUIRE(requests.size() == 2);
+    REQUIRE(requests[0].Range == "bytes=0-0");
+    REQUIRE(requests[1].Range.empty());
+
+    REQUIRE(result.has_value());
+    REQUIRE(result.value() == SHA256::ComputeHash(body));
+    REQUIRE(ReadFileContents(tempFile.GetPath()) == body);
+}
+
+TEST_CASE("Download_StreamedHashMatchesFile", "[Downloader]")
+{
+    TestCommon::TestUserSettings settings;
+    settings.Set<AppInstaller::Settings::Setting::NetworkDownloader>(AppInstaller::Settings::InstallerDownloader::WinInet);
+    settings.Set<AppInstaller::Settings::Setting::NetworkDownloadSegments>(1);
+
+    TestCommon::TestHttpServer server;
+
+    // Not a whole number of chunks, so that the last one is partly filled.
+    std::string body = CreateTestBody(5 * 1024 * 1024 + 12345);
+
+    TestCommon::TestHttpServer::Content content;
+    content.Body = body;
+    server.SetContent("/installer", content);
+
+    SECTION("File")
+    {
+        TestCommon::TempFile tempFile("downloader_test"s, ".test"s);
+
+        ProgressCallback progress;
+        auto result = Download(server.GetUrl("/installer"), tempFile.GetPath(), DownloadType::Installer, progress, true);
+
+        // The hash computed as the chunks were received is that of the file they were written to.
+        REQUIRE(result.has_value());
+        REQUIRE(result.value() == SHA256::ComputeHashFromFile(tempFile.GetPath()));
+        REQUIRE(result.value() == SHA256::ComputeHash(body));
+    }
+    SECTION("Stream")
+    {
+        std::ostringstream stream;
+
+        ProgressCallback progress;
+        auto result = DownloadToStream(server.GetUrl("/installer"), stream, DownloadType::Installer, progress, true);
+
+        REQUIRE(result.has_value());
+        REQUIRE(stream.str() == body);
+        REQUIRE(result.value() == SHA256::ComputeHash(stream.str()));
+    }
+}
+
+namespace
+{
+    // Accepts a number of bytes, then fails every write after them.
+    struct FailingStreamBuffer : public std::streambuf
+    {
+        FailingStreamBuffer(size_t capacity) : m_capacity(capacity) {}
+
+        size_t m_written = 0;
+
+    protected:
+        std::streamsize xsputn(const char*, std::streamsize count) override
+        {
+            size_t accepted = std::min(static_cast<size_t>(count), m_capacity - m_written);
+            m_written += accepted;
+            return static_cast<std::streamsize>(accepted);
+        }
+
+        int_type overflow(int_type ch) override
+        {
+            if (traits_type::eq_int_type(ch, traits_type::eof()) || m_written == m_capacity)
+            {
+                return traits_type::eof();
+            }
+
+            ++m_written;
+            return ch;
+        }
+
+    private:
+        size_t m_capacity;
+    };
+}
+
+TEST_CASE("Download_WriterFailsPartway", "[Downloader]")
+{
+    TestCommon::TestHttpServer server;
+    std::string body = CreateTestBody(8 * 1024 * 1024);
+
+    TestCommon::TestHttpServer::Content content;
+    content.Body = body;
+    content.ETag = "\"writerfails\"";
+    server.SetContent("/installer", content);
+
+    // The writer fails in the second chunk, while later chunks are still being received and hashed.
+    FailingStreamBuffer buffer{ 3 * 1024 * 1024 / 2 };
+    std::ostream stream{ &buffer };
+
+    ProgressCallback progress;
+    REQUIRE_THROWS_HR(DownloadToStream(server.GetUrl("/installer"), stream, DownloadType::Installer, progress, true), E_FAIL);
+
+    // The error of the writer is the error of the download, which is not continued, as the hash no longer matches what was written.
+    REQUIRE(buffer.m_written == 3 * 1024 * 1024 / 2);
+    REQUIRE(server.GetRequests().size() == 1);
+}
+
 TEST_CASE("DownloadValidFileAndCancel", "[Downloader]")
 {
     TestCommon::TempFile tempFile("downloader_test"s, ".test"s);
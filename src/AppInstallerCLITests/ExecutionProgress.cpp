@@ -0,0 +1,172 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include <ChannelStreams.h>
+#include <ExecutionProgress.h>
+
+using namespace std::chrono_literals;
+using namespace AppInstaller;
+using namespace AppInstaller::CLI::Execution;
+
+namespace
+{
+    // Collects the output, which the renderer thread writes while the test reads it.
+    struct SynchronizedBuffer : public std::streambuf
+    {
+        std::string GetOutput() const
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+            return m_output;
+        }
+
+        // Waits for the output to contain the value, returning whether it did in time.
+        bool WaitFor(std::string_view value, std::chrono::milliseconds timeout = 5s) const
+        {
+            auto end = std::chrono::steady_clock::now() + timeout;
+            while (GetOutput().find(value) == std::string::npos)
+            {
+                if (std::chrono::steady_clock::now() > end)
+                {
+                    return false;
+                }
+
+                std::this_thread::sleep_for(10ms);
+            }
+
+            return true;
+        }
+
+    protected:
+        int_type overflow(int_type ch) override
+        {
+            if (!traits_type::eq_int_type(ch, traits_type::eof()))
+            {
+                std::lock_guard<std::mutex> lock{ m_lock };
+                m_output.push_back(traits_type::to_char_type(ch));
+            }
+
+            return traits_type::not_eof(ch);
+        }
+
+        std::streamsize xsputn(const char_type* s, std::streamsize count) override
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+            m_output.append(s, static_cast<size_t>(count));
+            return count;
+        }
+
+    private:
+        mutable std::mutex m_lock;
+        std::string m_output;
+    };
+
+    struct TestProgressBar
+    {
+        TestProgressBar() : Out(&Buffer), Stream(Out, true, false), Bar(Stream, false) {}
+
+        SynchronizedBuffer Buffer;
+        std::ostream Out;
+        BaseStream Stream;
+        ProgressBar Bar;
+    };
+}
+
+TEST_CASE("ProgressBar_StartsRenderingOnFirstUpdate", "[progress]")
+{
+    TestProgressBar test;
+    REQUIRE_FALSE(test.Bar.IsRendering());
+
+    test.Bar.ShowProgress(1, 10, ProgressType::Percent);
+    REQUIRE(test.Bar.IsRendering());
+    REQUIRE(test.Buffer.WaitFor("10%"));
+
+    // Later updates are drawn by the same renderer.
+    test.Bar.ShowProgress(5, 10, ProgressType::Percent);
+    REQUIRE(test.Buffer.WaitFor("50%"));
+    REQUIRE(test.Bar.IsRendering());
+
+    test.Bar.EndProgress(false);
+}
+
+TEST_CASE("ProgressBar_EndStopsRendering", "[progress]")
+{
+    TestProgressBar test;
+
+    test.Bar.ShowProgress(1, 10, ProgressType::Percent);
+    test.Bar.ShowProgress(3, 10, ProgressType::Percent);
+    test.Bar.EndProgress(false);
+    REQUIRE_FALSE(test.Bar.IsRendering());
+
+    // The final values are drawn before the bar is left behind, even if the renderer had not reached them.
+    std::string output = test.Buffer.GetOutput();
+    REQUIRE(output.find("30%") != std::string::npos);
+    REQUIRE(output.back() == '\n');
+
+    // Nothing more is drawn once progress has ended.
+    std::this_thread::sleep_for(300ms);
+    REQUIRE(test.Buffer.GetOutput() == output);
+
+    // A new update starts rendering again.
+    test.Bar.ShowProgress(7, 10, ProgressType::Percent);
+    REQUIRE(test.Bar.IsRendering());
+    REQUIRE(test.Buffer.WaitFor("70%"));
+
+    test.Bar.EndProgress(true);
+    REQUIRE_FALSE(test.Bar.IsRendering());
+
+    output = test.Buffer.GetOutput();
+    std::this_thread::sleep_for(300ms);
+    REQUIRE(test.Buffer.GetOutput() == output);
+}
+
+TEST_CASE("ProgressBar_ConcurrentUpdates", "[progress]")
+{
+    TestProgressBar test;
+
+    // Updates from several threads at once start a single renderer.
+    std::vector<std::thread> reporters;
+    for (uint64_t reporter = 0; reporter < 4; ++reporter)
+    {
+        reporters.emplace_back([&]()
+            {
+                for (uint64_t i = 0; i <= 1000; ++i)
+                {
+                    test.Bar.ShowProgress(i, 1000, ProgressType::Bytes);
+                }
+            });
+    }
+
+    for (auto& reporter : reporters)
+    {
+        reporter.join();
+    }
+
+    REQUIRE(test.Bar.IsRendering());
+
+    test.Bar.ShowProgress(1000, 1000, ProgressType::Percent);
+    test.Bar.EndProgress(false);
+    REQUIRE_FALSE(test.Bar.IsRendering());
+    REQUIRE(test.Buffer.GetOutput().find("100%") != std::string::npos);
+}
+
+TEST_CASE("ProgressBar_DestroyedWhileRendering", "[progress]")
+{
+    SynchronizedBuffer buffer;
+    std::ostream out{ &buffer };
+    BaseStream stream{ out, true, false };
+
+    {
+        ProgressBar bar{ stream, false };
+        bar.ShowProgress(2, 10, ProgressType::Percent);
+        REQUIRE(buffer.WaitFor("20%"));
+
+        // Progress is never ended, as when the reporting operation throws.
+        bar.ShowProgress(4, 10, ProgressType::Percent);
+    }
+
+    // The renderer was stopped by the destructor, so nothing writes to the stream anymore.
+    std::string output = buffer.GetOutput();
+    std::this_thread::sleep_for(300ms);
+    REQUIRE(buffer.GetOutput() == output);
+}
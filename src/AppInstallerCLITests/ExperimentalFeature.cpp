@@ -26,6 +26,38 @@ TEST_CASE("ExperimentalFeature None", "[experimentalFeature]")
     REQUIRE(ExperimentalFeature::IsEnabled(ExperimentalFeature::Feature::None));
 }
 
+TEST_CASE("ExperimentalFeature CacheCommand", "[experimentalFeature]")
+{
+    DeleteUserSettingsFiles();
+
+    SECTION("Feature off default")
+    {
+        UserSettingsTest userSettingTest;
+
+        REQUIRE_FALSE(ExperimentalFeature::IsEnabled(ExperimentalFeature::Feature::CacheCommand, userSettingTest));
+    }
+    SECTION("Feature on")
+    {
+        std::string_view json = R"({ "experimentalFeatures": { "cacheCommand": true } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(ExperimentalFeature::IsEnabled(ExperimentalFeature::Feature::CacheCommand, userSettingTest));
+    }
+    SECTION("Disabled by group policy")
+    {
+        auto policiesKey = RegCreateVolatileTestRoot();
+        SetRegistryValue(policiesKey.get(), ExperimentalFeaturesPolicyValueName, false);
+        GroupPolicyTestOverride policies{ policiesKey.get() };
+
+        std::string_view json = R"({ "experimentalFeatures": { "cacheCommand": true } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE_FALSE(ExperimentalFeature::IsEnabled(ExperimentalFeature::Feature::CacheCommand, userSettingTest));
+    }
+}
+
 TEST_CASE("ExperimentalFeature ExperimentalCmd", "[experimentalFeature]")
 {
     DeleteUserSettingsFiles();
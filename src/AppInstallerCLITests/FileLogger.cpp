@@ -0,0 +1,141 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include <AppInstallerFileLogger.h>
+
+using namespace std::string_literals;
+using namespace TestCommon;
+using namespace AppInstaller::Logging;
+
+namespace
+{
+    std::vector<std::string> ReadLines(const std::filesystem::path& path)
+    {
+        std::vector<std::string> result;
+        std::ifstream file{ path };
+        std::string line;
+        while (std::getline(file, line))
+        {
+            result.emplace_back(std::move(line));
+        }
+        return result;
+    }
+
+    std::string MakeRecord(size_t writer, size_t index)
+    {
+        return std::to_string(writer) + ':' + std::to_string(index);
+    }
+}
+
+TEST_CASE("FileLogger_ConcurrentWriters", "[logging]")
+{
+    TempFile tempFile{ "FileLogger"s, ".log"s };
+
+    constexpr size_t writerCount = 8;
+    constexpr size_t recordsPerWriter = 2000;
+
+    {
+        FileLogger logger{ tempFile.GetPath() };
+
+        std::vector<std::thread> writers;
+        for (size_t writer = 0; writer < writerCount; ++writer)
+        {
+            writers.emplace_back([&, writer]()
+                {
+                    for (size_t i = 0; i < recordsPerWriter; ++i)
+                    {
+                        logger.WriteDirect(MakeRecord(writer, i));
+                    }
+                });
+        }
+
+        for (auto& writer : writers)
+        {
+            writer.join();
+        }
+    }
+
+    std::vector<std::string> lines = ReadLines(tempFile.GetPath());
+    REQUIRE(lines.size() == writerCount * recordsPerWriter);
+
+    // Every record is written whole, and the records of each writer are in the order that it added them.
+    std::vector<size_t> nextIndex(writerCount, 0);
+    for (const auto& line : lines)
+    {
+        size_t separator = line.find(':');
+        REQUIRE(separator != std::string::npos);
+
+        size_t writer = std::stoul(line.substr(0, separator));
+        REQUIRE(writer < writerCount);
+        REQUIRE(line == MakeRecord(writer, nextIndex[writer]));
+        ++nextIndex[writer];
+    }
+
+    for (size_t writer = 0; writer < writerCount; ++writer)
+    {
+        REQUIRE(nextIndex[writer] == recordsPerWriter);
+    }
+}
+
+TEST_CASE("FileLogger_WrapsAround", "[logging]")
+{
+    TempFile tempFile{ "FileLogger"s, ".log"s };
+
+    // Many more records than the buffer holds, of varying lengths so that slots are reused by both longer and shorter records.
+    constexpr size_t recordCount = 10 * 1024;
+    auto makeRecord = [](size_t index) { return std::string(index % 97, 'x') + std::to_string(index); };
+
+    {
+        FileLogger logger{ tempFile.GetPath() };
+
+        for (size_t i = 0; i < recordCount; ++i)
+        {
+            logger.WriteDirect(makeRecord(i));
+        }
+    }
+
+    // A full buffer makes the writer wait for room rather than drop or overwrite records.
+    std::vector<std::string> lines = ReadLines(tempFile.GetPath());
+    REQUIRE(lines.size() == recordCount);
+
+    for (size_t i = 0; i < recordCount; ++i)
+    {
+        REQUIRE(lines[i] == makeRecord(i));
+    }
+}
+
+TEST_CASE("FileLogger_Flush", "[logging]")
+{
+    TempFile tempFile{ "FileLogger"s, ".log"s };
+
+    {
+        FileLogger logger{ tempFile.GetPath() };
+
+        for (size_t i = 0; i < 100; ++i)
+        {
+            logger.WriteDirect(MakeRecord(0, i));
+        }
+
+        logger.Write(Channel::CLI, Level::Info, "channel record");
+
+        // Flushing makes every record added so far visible in the file while the logger is still running.
+        FileLogger::FlushAll(std::chrono::seconds{ 5 });
+
+        std::vector<std::string> lines = ReadLines(tempFile.GetPath());
+        REQUIRE(lines.size() == 101);
+        REQUIRE(lines[99] == MakeRecord(0, 99));
+        REQUIRE(lines[100].find("[CLI") != std::string::npos);
+        REQUIRE(lines[100].rfind("channel record") == lines[100].size() - "channel record"s.size());
+
+        // Records added just before the logger is destroyed are written before it stops.
+        for (size_t i = 0; i < 100; ++i)
+        {
+            logger.WriteDirect(MakeRecord(1, i));
+        }
+    }
+
+    std::vector<std::string> lines = ReadLines(tempFile.GetPath());
+    REQUIRE(lines.size() == 201);
+    REQUIRE(lines[200] == MakeRecord(1, 99));
+}
@@ -28,6 +28,11 @@ TEST_CASE("GroupPolicy_NoPolicies", "[groupPolicy]")
     REQUIRE(!groupPolicy.GetValue<ValuePolicy::SourceAutoUpdateIntervalInMinutes>().has_value());
     REQUIRE(!groupPolicy.GetValue<ValuePolicy::AdditionalSources>().has_value());
     REQUIRE(!groupPolicy.GetValue<ValuePolicy::AllowedSources>().has_value());
+    REQUIRE(!groupPolicy.GetValue<ValuePolicy::InstallerCacheLocation>().has_value());
+    REQUIRE(!groupPolicy.GetValue<ValuePolicy::InstallerCacheMaximumSizeInMB>().has_value());
+    REQUIRE(!groupPolicy.GetValue<ValuePolicy::MaximumConcurrentDownloads>().has_value());
+    REQUIRE(!groupPolicy.GetValue<ValuePolicy::DownloadBandwidthLimitInKBps>().has_value());
+    REQUIRE(!groupPolicy.GetValue<ValuePolicy::BackgroundDownloads>().has_value());
 
     // Everything should be not configured
     for (const auto& policy : TogglePolicy::GetAllPolicies())
@@ -60,6 +65,102 @@ TEST_CASE("GroupPolicy_UpdateInterval", "[groupPolicy]")
     }
 }
 
+TEST_CASE("GroupPolicy_InstallerCache", "[groupPolicy]")
+{
+    auto policiesKey = RegCreateVolatileTestRoot();
+
+    SECTION("Good values")
+    {
+        SetRegistryValue(policiesKey.get(), InstallerCacheLocationPolicyValueName, L"D:\\InstallerCache");
+        SetRegistryValue(policiesKey.get(), InstallerCacheMaximumSizePolicyValueName, 100);
+        GroupPolicy groupPolicy{ policiesKey.get() };
+
+        auto location = groupPolicy.GetValue<ValuePolicy::InstallerCacheLocation>();
+        REQUIRE(location.has_value());
+        REQUIRE(*location == "D:\\InstallerCache");
+
+        auto size = groupPolicy.GetValue<ValuePolicy::InstallerCacheMaximumSizeInMB>();
+        REQUIRE(size.has_value());
+        REQUIRE(*size == 100);
+    }
+
+    SECTION("Empty values")
+    {
+        SetRegistryValue(policiesKey.get(), InstallerCacheLocationPolicyValueName, L"");
+        SetRegistryValue(policiesKey.get(), InstallerCacheMaximumSizePolicyValueName, (DWORD)0);
+        GroupPolicy groupPolicy{ policiesKey.get() };
+
+        REQUIRE(!groupPolicy.GetValue<ValuePolicy::InstallerCacheLocation>().has_value());
+        REQUIRE(!groupPolicy.GetValue<ValuePolicy::InstallerCacheMaximumSizeInMB>().has_value());
+    }
+}
+
+TEST_CASE("GroupPolicy_MaximumConcurrentDownloads", "[groupPolicy]")
+{
+    auto policiesKey = RegCreateVolatileTestRoot();
+
+    SECTION("Good value")
+    {
+        SetRegistryValue(policiesKey.get(), MaximumConcurrentDownloadsPolicyValueName, 2);
+        GroupPolicy groupPolicy{ policiesKey.get() };
+
+        auto policy = groupPolicy.GetValue<ValuePolicy::MaximumConcurrentDownloads>();
+        REQUIRE(policy.has_value());
+        REQUIRE(*policy == 2);
+    }
+
+    SECTION("Zero")
+    {
+        SetRegistryValue(policiesKey.get(), MaximumConcurrentDownloadsPolicyValueName, (DWORD)0);
+        GroupPolicy groupPolicy{ policiesKey.get() };
+
+        REQUIRE(!groupPolicy.GetValue<ValuePolicy::MaximumConcurrentDownloads>().has_value());
+    }
+}
+
+TEST_CASE("GroupPolicy_DownloadPolicies", "[groupPolicy]")
+{
+    auto policiesKey = RegCreateVolatileTestRoot();
+
+    SECTION("Bandwidth limit")
+    {
+        SetRegistryValue(policiesKey.get(), DownloadBandwidthLimitPolicyValueName, 512);
+        GroupPolicy groupPolicy{ policiesKey.get() };
+
+        auto policy = groupPolicy.GetValue<ValuePolicy::DownloadBandwidthLimitInKBps>();
+        REQUIRE(policy.has_value());
+        REQUIRE(*policy == 512);
+    }
+
+    SECTION("Background enabled")
+    {
+        SetRegistryValue(policiesKey.get(), BackgroundDownloadsPolicyValueName, 1);
+        GroupPolicy groupPolicy{ policiesKey.get() };
+
+        auto policy = groupPolicy.GetValue<ValuePolicy::BackgroundDownloads>();
+        REQUIRE(policy.has_value());
+        REQUIRE(*policy);
+    }
+
+    SECTION("Background disabled")
+    {
+        SetRegistryValue(policiesKey.get(), BackgroundDownloadsPolicyValueName, (DWORD)0);
+        GroupPolicy groupPolicy{ policiesKey.get() };
+
+        auto policy = groupPolicy.GetValue<ValuePolicy::BackgroundDownloads>();
+        REQUIRE(policy.has_value());
+        REQUIRE_FALSE(*policy);
+    }
+
+    SECTION("Wrong type")
+    {
+        SetRegistryValue(policiesKey.get(), BackgroundDownloadsPolicyValueName, L"Wrong");
+        GroupPolicy groupPolicy{ policiesKey.get() };
+
+        REQUIRE(!groupPolicy.GetValue<ValuePolicy::BackgroundDownloads>().has_value());
+    }
+}
+
 TEST_CASE("GroupPolicy_Sources", "[groupPolicy]")
 {
     auto policiesKey = RegCreateVolatileTestRoot();
@@ -20,4 +20,74 @@ TEST_CASE("HashCommandWithTestMsix", "[Sha256Hash]")
 
     REQUIRE(hashOutput.str().find("Sha256: 6a2d3683fa19bf00e58e07d1313d20a5f5735ebbd6a999d33381d28740ee07ea") != std::string::npos);
     REQUIRE(hashOutput.str().find("SignatureSha256: 138781c3e6f635240353f3d14d1d57bdcb89413e49be63b375e6a5d7b93b0d07") != std::string::npos);
-}
\ No newline at end of file
+}
+
+namespace
+{
+    void WriteTestFile(const std::filesystem::path& path, std::string_view content)
+    {
+        std::ofstream file{ path, std::ofstream::binary };
+        file << content;
+    }
+}
+
+TEST_CASE("HashCommandWithMultipleFiles", "[Sha256Hash]")
+{
+    TempDirectory tempDirectory{ "HashCommandTest" };
+    std::filesystem::path first = tempDirectory.GetPath() / "first.bin";
+    std::filesystem::path second = tempDirectory.GetPath() / "second.bin";
+    WriteTestFile(first, "abc");
+    WriteTestFile(second, "hello");
+
+    std::ostringstream hashOutput;
+    Execution::Context context{ hashOutput, std::cin };
+    context.Args.AddArg(Execution::Args::Type::HashFile, first.u8string());
+    context.Args.AddArg(Execution::Args::Type::HashFile, second.u8string());
+    HashCommand hashCommand({});
+
+    hashCommand.Execute(context);
+
+    REQUIRE(!context.IsTerminated());
+    REQUIRE(hashOutput.str().find("InstallerSha256: ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad") != std::string::npos);
+    REQUIRE(hashOutput.str().find("InstallerSha256: 2cf24dba5fb0a30e26e83b2ac5b9e29e1b161e5c1fa7425e73043362938b9824") != std::string::npos);
+    REQUIRE(hashOutput.str().find("File: first.bin") < hashOutput.str().find("File: second.bin"));
+}
+
+TEST_CASE("HashCommandWithDirectory", "[Sha256Hash]")
+{
+    TempDirectory tempDirectory{ "HashCommandTest" };
+    WriteTestFile(tempDirectory.GetPath() / "a.bin", "abc");
+    WriteTestFile(tempDirectory.GetPath() / "b.bin", "hello");
+    std::filesystem::create_directory(tempDirectory.GetPath() / "nested");
+    WriteTestFile(tempDirectory.GetPath() / "nested" / "c.bin", "ignored");
+
+    std::ostringstream hashOutput;
+    Execution::Context context{ hashOutput, std::cin };
+    context.Args.AddArg(Execution::Args::Type::HashFile, tempDirectory.GetPath().u8string());
+    HashCommand hashCommand({});
+
+    hashCommand.Execute(context);
+
+    REQUIRE(!context.IsTerminated());
+    REQUIRE(hashOutput.str().find("File: a.bin") != std::string::npos);
+    REQUIRE(hashOutput.str().find("File: b.bin") != std::string::npos);
+    REQUIRE(hashOutput.str().find("c.bin") == std::string::npos);
+}
+
+TEST_CASE("HashCommandWithMissingFile", "[Sha256Hash]")
+{
+    TempDirectory tempDirectory{ "HashCommandTest" };
+    std::filesystem::path first = tempDirectory.GetPath() / "first.bin";
+    WriteTestFile(first, "abc");
+
+    std::ostringstream hashOutput;
+    Execution::Context context{ hashOutput, std::cin };
+    context.Args.AddArg(Execution::Args::Type::HashFile, first.u8string());
+    context.Args.AddArg(Execution::Args::Type::HashFile, (tempDirectory.GetPath() / "missing.bin").u8string());
+    HashCommand hashCommand({});
+
+    hashCommand.Execute(context);
+
+    REQUIRE(context.IsTerminated());
+    REQUIRE(context.GetTerminationHR() == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND));
+}
@@ -5,6 +5,8 @@
 #include "TestRestRequestHandler.h"
 #include <AppInstallerErrors.h>
 #include <Rest/Schema/HttpClientHelper.h>
+#include <Rest/Schema/HttpResponseCache.h>
+#include <Rest/Schema/JsonHelper.h>
 
 using namespace AppInstaller::Repository::Rest::Schema;
 
@@ -14,6 +16,15 @@ TEST_CASE("ExtractJsonResponse_UnsupportedMimeType", "[RestSource][RestSearch]")
     REQUIRE_THROWS_HR(helper.HandleGet(L"https://testUri"), APPINSTALLER_CLI_ERROR_RESTSOURCE_UNSUPPORTED_MIME_TYPE);
 }
 
+TEST_CASE("ExtractJsonResponse_UTF8", "[RestSource]")
+{
+    HttpClientHelper helper{ GetTestRestRequestHandler(web::http::status_codes::OK, L"{ \"Value\": \"f\u00F6ld\" }", L"application/json; charset=utf-8") };
+    auto result = helper.HandleGet(L"https://testUri");
+
+    REQUIRE(result);
+    REQUIRE(JsonHelper::GetRawStringValueFromJsonNode(result.value(), L"Value") == "f\xC3\xB6ld");
+}
+
 TEST_CASE("ValidateAndExtractResponse_ServiceUnavailable", "[RestSource]")
 {
     HttpClientHelper helper{ GetTestRestRequestHandler(web::http::status_codes::ServiceUnavailable) };
@@ -25,3 +36,192 @@ TEST_CASE("ValidateAndExtractResponse_NotFound", "[RestSource]")
     HttpClientHelper helper{ GetTestRestRequestHandler(web::http::status_codes::NotFound) };
     REQUIRE_THROWS_HR(helper.HandleGet(L"https://testUri"), APPINSTALLER_CLI_ERROR_RESTSOURCE_ENDPOINT_NOT_FOUND);
 }
+
+TEST_CASE("HttpClientHelper_PooledClientRequestUri", "[RestSource]")
+{
+    std::vector<utility::string_t> requestedUris;
+    auto handler = std::make_shared<TestRestRequestHandler>([&](web::http::http_request request) -> pplx::task<web::http::http_response>
+        {
+            requestedUris.emplace_back(request.absolute_uri().to_string());
+
+            web::http::http_response response;
+            response.set_body(web::json::value::parse(L"{}"));
+            response.headers().set_content_type(web::http::details::mime_types::application_json);
+            response.set_status_code(web::http::status_codes::OK);
+            return pplx::task_from_result(response);
+        });
+
+    // Both requests go through the same pooled client for the server, but must still reach their own paths.
+    HttpClientHelper helper{ handler };
+    helper.HandleGet(L"https://testuri/api/information");
+    helper.HandlePost(L"https://testuri/api/manifestSearch?a=b", web::json::value::object());
+
+    REQUIRE(requestedUris.size() == 2);
+    REQUIRE(requestedUris[0] == L"https://testuri/api/information");
+    REQUIRE(requestedUris[1] == L"https://testuri/api/manifestSearch?a=b");
+}
+
+TEST_CASE("HttpClientHelper_ResponseCache_ETag", "[RestSource]")
+{
+    TestCommon::TempDirectory cacheDirectory{ "ResponseCache" };
+
+    int requestCount = 0;
+    int notModifiedCount = 0;
+    auto handler = std::make_shared<TestRestRequestHandler>([&](web::http::http_request request) -> pplx::task<web::http::http_response>
+        {
+            ++requestCount;
+
+            web::http::http_response response;
+            response.headers().add(web::http::header_names::etag, L"\"v1\"");
+
+            if (request.headers().has(web::http::header_names::if_none_match) && request.headers()[web::http::header_names::if_none_match] == L"\"v1\"")
+            {
+                ++notModifiedCount;
+                response.set_status_code(web::http::status_codes::NotModified);
+            }
+            else
+            {
+                response.set_body(web::json::value::parse(L"{ \"Data\": \"value\" }"));
+                response.headers().set_content_type(web::http::details::mime_types::application_json);
+                response.set_status_code(web::http::status_codes::OK);
+            }
+
+            return pplx::task_from_result(response);
+        });
+
+    HttpClientHelper helper{ handler };
+    helper.SetResponseCache(std::make_shared<HttpResponseCache>(cacheDirectory.GetPath()));
+
+    for (int i = 0; i < 2; ++i)
+    {
+        std::optional<web::json::value> result = helper.HandleGet(L"https://testuri/api/information");
+        REQUIRE(result);
+        REQUIRE(result->at(L"Data").as_string() == L"value");
+    }
+
+    // The second request is revalidated rather than downloaded again.
+    REQUIRE(requestCount == 2);
+    REQUIRE(notModifiedCount == 1);
+}
+
+TEST_CASE("HttpClientHelper_ResponseCache_MaxAge", "[RestSource]")
+{
+    TestCommon::TempDirectory cacheDirectory{ "ResponseCache" };
+
+    int requestCount = 0;
+    utility::string_t cacheControl;
+    auto handler = std::make_shared<TestRestRequestHandler>([&](web::http::http_request) -> pplx::task<web::http::http_response>
+        {
+            ++requestCount;
+
+            web::http::http_response response;
+            response.headers().add(web::http::header_names::cache_control, cacheControl);
+            response.set_body(web::json::value::parse(L"{ \"Data\": \"value\" }"));
+            response.headers().set_content_type(web::http::details::mime_types::application_json);
+            response.set_status_code(web::http::status_codes::OK);
+            return pplx::task_from_result(response);
+        });
+
+    HttpClientHelper helper{ handler };
+    helper.SetResponseCache(std::make_shared<HttpResponseCache>(cacheDirectory.GetPath()));
+
+    SECTION("Fresh")
+    {
+        cacheControl = L"public, max-age=3600";
+        helper.HandlePost(L"https://testuri/api/manifestSearch", web::json::value::object());
+        helper.HandlePost(L"https://testuri/api/manifestSearch", web::json::value::object());
+        REQUIRE(requestCount == 1);
+
+        // A different body is a different request.
+        web::json::value otherBody;
+        otherBody[L"Query"] = web::json::value::string(L"other");
+        helper.HandlePost(L"https://testuri/api/manifestSearch", otherBody);
+        REQUIRE(requestCount == 2);
+    }
+    SECTION("No store")
+    {
+        cacheControl = L"max-age=3600, no-store";
+        helper.HandleGet(L"https://testuri/api/information");
+        helper.HandleGet(L"https://testuri/api/information");
+        REQUIRE(requestCount == 2);
+    }
+}
+
+TEST_CASE("HttpResponseCache_Trim", "[RestSource]")
+{
+    TestCommon::TempDirectory cacheDirectory{ "ResponseCache" };
+
+    web::http::http_response response;
+    response.headers().add(web::http::header_names::etag, L"\"v1\"");
+    web::json::value body = web::json::value::parse(L"{ \"Data\": \"value\" }");
+
+    std::vector<std::string> keys;
+    for (int i = 0; i < 3; ++i)
+    {
+        keys.emplace_back(HttpResponseCache::GetKey(web::http::methods::GET, L"https://testuri/api/packageManifests/" + std::to_wstring(i), {}));
+    }
+
+    auto getEntryFiles = [&]()
+    {
+        std::vector<std::filesystem::path> result;
+        for (const auto& file : std::filesystem::directory_iterator{ cacheDirectory.GetPath() })
+        {
+            result.emplace_back(file.path());
+        }
+        return result;
+    };
+
+    // The entries all have the same size, so measure one to set a maximum that only two fit in.
+    uint64_t entrySize = 0;
+    {
+        HttpResponseCache measure{ cacheDirectory.GetPath() };
+        measure.Store(keys[0], response, body);
+
+        auto files = getEntryFiles();
+        REQUIRE(files.size() == 1);
+        entrySize = std::filesystem::file_size(files[0]);
+        std::filesystem::remove(files[0]);
+    }
+
+    HttpResponseCache cache{ cacheDirectory.GetPath(), entrySize * 2 + entrySize / 2 };
+
+    SECTION("Least recently used")
+    {
+        for (const auto& key : keys)
+        {
+            cache.Store(key, response, body);
+
+            // Use the first entry after storing each one so that it is the most recently used.
+            Sleep(20);
+            REQUIRE(cache.Get(keys[0]));
+            Sleep(20);
+        }
+
+        cache.Trim();
+
+        REQUIRE(getEntryFiles().size() == 2);
+        REQUIRE(cache.Get(keys[0]));
+        REQUIRE(!cache.Get(keys[1]));
+        REQUIRE(cache.Get(keys[2]));
+    }
+    SECTION("Unused")
+    {
+        cache.Store(keys[0], response, body);
+        cache.Store(keys[1], response, body);
+
+        // An entry that has not been used for a long time is removed even though the cache is within its maximum size.
+        for (const auto& file : getEntryFiles())
+        {
+            if (file.filename().string().rfind(keys[0], 0) == 0)
+            {
+                std::filesystem::last_write_time(file, std::filesystem::file_time_type::clock::now() - std::chrono::hours{ 24 * 60 });
+            }
+        }
+
+        cache.Trim();
+
+        REQUIRE(getEntryFiles().size() == 1);
+        REQUIRE(!cache.Get(keys[0]));
+        REQUIRE(cache.Get(keys[1]));
+    }
+}
@@ -0,0 +1,86 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include <winget/InstallerCache.h>
+
+using namespace std::string_literals;
+using namespace TestCommon;
+using namespace AppInstaller::Utility;
+
+namespace
+{
+    // Writes the content to a new file in the directory and returns its hash.
+    SHA256::HashBuffer WriteInstaller(const std::filesystem::path& path, const std::string& content)
+    {
+        std::ofstream file{ path, std::ofstream::binary };
+        file << content;
+        return SHA256::ComputeHash(content);
+    }
+
+    std::string ReadFile(const std::filesystem::path& path)
+    {
+        std::ifstream file{ path, std::ifstream::binary };
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+}
+
+TEST_CASE("InstallerCache_AddAndGet", "[installerCache]")
+{
+    TempDirectory tempDirectory{ "InstallerCache" };
+    InstallerCache cache{ tempDirectory.GetPath() / "cache", 1024 };
+
+    std::filesystem::path source = tempDirectory.GetPath() / "source.exe";
+    SHA256::HashBuffer hash = WriteInstaller(source, "installer content");
+
+    std::filesystem::path target = tempDirectory.GetPath() / "target.exe";
+    REQUIRE(!cache.TryGet(hash, target));
+
+    cache.Add(hash, source);
+    REQUIRE(cache.TryGet(hash, target));
+    REQUIRE(ReadFile(target) == "installer content");
+}
+
+TEST_CASE("InstallerCache_HashMismatch", "[installerCache]")
+{
+    TempDirectory tempDirectory{ "InstallerCache" };
+    InstallerCache cache{ tempDirectory.GetPath() / "cache", 1024 };
+
+    std::filesystem::path source = tempDirectory.GetPath() / "source.exe";
+    SHA256::HashBuffer hash = WriteInstaller(source, "installer content");
+    cache.Add(hash, source);
+
+    // Change the cached file so that it no longer matches its hash.
+    WriteInstaller(cache.GetRoot() / SHA256::ConvertToString(hash), "modified content");
+
+    std::filesystem::path target = tempDirectory.GetPath() / "target.exe";
+    REQUIRE(!cache.TryGet(hash, target));
+    REQUIRE(!std::filesystem::exists(target));
+    REQUIRE(!std::filesystem::exists(cache.GetRoot() / SHA256::ConvertToString(hash)));
+}
+
+TEST_CASE("InstallerCache_TrimLeastRecentlyUsed", "[installerCache]")
+{
+    TempDirectory tempDirectory{ "InstallerCache" };
+    InstallerCache cache{ tempDirectory.GetPath() / "cache", 40 };
+
+    std::vector<SHA256::HashBuffer> hashes;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        std::filesystem::path source = tempDirectory.GetPath() / ("source" + std::to_string(i) + ".exe");
+        hashes.emplace_back(WriteInstaller(source, "installer content " + std::to_string(i)));
+        cache.Add(hashes.back(), source);
+
+        // Use the first installer after adding each one so that it is the most recently used.
+        Sleep(20);
+        REQUIRE(cache.TryGet(hashes[0], tempDirectory.GetPath() / "target.exe"));
+        Sleep(20);
+    }
+
+    // Each installer is 19 bytes, so only two fit; the second was the least recently used when the third was added.
+    REQUIRE(cache.TryGet(hashes[0], tempDirectory.GetPath() / "target.exe"));
+    REQUIRE(!cache.TryGet(hashes[1], tempDirectory.GetPath() / "target.exe"));
+    REQUIRE(cache.TryGet(hashes[2], tempDirectory.GetPath() / "target.exe"));
+}
@@ -27,6 +27,8 @@ TEST_CASE("GetUtilityString", "[RestSource]")
 {
     REQUIRE(JsonHelper::GetUtilityString("cpprest") == L"cpprest");
     REQUIRE(JsonHelper::GetUtilityString("  ") == L"  ");
+    REQUIRE(JsonHelper::GetUtilityString(std::string_view{ "cpprest", 3 }) == L"cpp");
+    REQUIRE(JsonHelper::GetUtilityString(u8"\u00e9t\u00e9") == L"\u00e9t\u00e9");
 }
 
 TEST_CASE("GetJsonValueFromNode", "[RestSource]")
@@ -42,6 +44,9 @@ TEST_CASE("GetJsonValueFromNode", "[RestSource]")
     web::json::value emptyObject;
     std::optional<std::reference_wrapper<const web::json::value>> empty = JsonHelper::GetJsonValueFromNode(emptyObject, L"Key1");
     REQUIRE(!empty);
+
+    std::optional<std::reference_wrapper<const web::json::value>> notObject = JsonHelper::GetJsonValueFromNode(jsonObject.at(L"Array"), L"Key1");
+    REQUIRE(!notObject);
 }
 
 TEST_CASE("GetRawStringValueFromJsonValue", "[RestSource]")
@@ -82,6 +82,25 @@ TEST_CASE("ManifestComparator_OSFilter_High", "[manifest_comparator]")
     REQUIRE(inapplicabilities.size() == 0);
 }
 
+TEST_CASE("ManifestComparator_OSFilter_SharedVersions", "[manifest_comparator]")
+{
+    Manifest manifest;
+    AddInstaller(manifest, Architecture::Neutral, InstallerTypeEnum::Exe, ScopeEnum::Unknown, "10.0.99999.0");
+    AddInstaller(manifest, Architecture::Neutral, InstallerTypeEnum::Msi, ScopeEnum::Unknown, "10.0.0.0");
+    AddInstaller(manifest, Architecture::Neutral, InstallerTypeEnum::Inno, ScopeEnum::Unknown, "10.0.99999.0");
+    ManifestInstaller expected = AddInstaller(manifest, Architecture::Neutral, InstallerTypeEnum::Msi, ScopeEnum::Unknown, "10.0.0.0");
+
+    // Comparing a second manifest with the same comparator gives the same results for the same versions
+    ManifestComparator mc(ManifestComparatorTestContext{}, {});
+    for (size_t i = 0; i < 2; ++i)
+    {
+        auto [result, inapplicabilities] = mc.GetPreferredInstaller(manifest);
+
+        RequireInstaller(result, expected);
+        RequireInapplicabilities(inapplicabilities, { InapplicabilityFlags::OSVersion, InapplicabilityFlags::OSVersion });
+    }
+}
+
 TEST_CASE("ManifestComparator_InstalledScopeFilter_Uknown", "[manifest_comparator]")
 {
     Manifest manifest;
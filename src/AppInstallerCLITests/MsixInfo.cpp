@@ -64,3 +64,63 @@ TEST_CASE("MsixInfo_WriteFile", "[msixinfo]")
 
     REQUIRE(1 == std::filesystem::file_size(file));
 }
+
+TEST_CASE("MsixInfo_UpdateFile", "[msixinfo]")
+{
+    TestDataFile index(s_MsixFile_1);
+    Msix::MsixInfo msix(index.GetPath().u8string());
+
+    TempFile file{ "msixtest_file"s, ".bin"s };
+    ProgressCallback callback;
+
+    // Nothing to update from
+    REQUIRE(!msix.UpdateFile("Public\\index.db", file, callback));
+
+    // Every block is the same
+    msix.WriteToFile("Public\\index.db", file, callback);
+    REQUIRE(msix.UpdateFile("Public\\index.db", file, callback));
+    REQUIRE(1 == std::filesystem::file_size(file));
+
+    // Most of the blocks differ, so the file should be written in full
+    {
+        std::ofstream stream{ file.GetPath(), std::ios_base::binary | std::ios_base::trunc };
+        stream << "different";
+    }
+    REQUIRE(!msix.UpdateFile("Public\\index.db", file, callback));
+}
+
+TEST_CASE("MsixInfo_UpdateFile_ToDestination", "[msixinfo]")
+{
+    TestDataFile index(s_MsixFile_1);
+    Msix::MsixInfo msix(index.GetPath().u8string());
+
+    TempFile existing{ "msixtest_existing"s, ".bin"s };
+    TempFile destination{ "msixtest_destination"s, ".bin"s };
+    ProgressCallback callback;
+
+    // Every block is the same, so there is nothing to write
+    msix.WriteToFile("Public\\index.db", existing, callback);
+    REQUIRE(msix.UpdateFile("Public\\index.db", existing, destination, callback));
+    REQUIRE(!std::filesystem::exists(destination.GetPath()));
+
+    // Most of the blocks differ, so neither file is written and the destination is left for the caller
+    {
+        std::ofstream stream{ existing.GetPath(), std::ios_base::binary | std::ios_base::trunc };
+        stream << "different";
+    }
+    REQUIRE(!msix.UpdateFile("Public\\index.db", existing, destination, callback));
+    REQUIRE(!std::filesystem::exists(destination.GetPath()));
+    REQUIRE(9 == std::filesystem::file_size(existing));
+}
+
+TEST_CASE("MsixInfo_GetPackageSignature", "[msixinfo]")
+{
+    TestDataFile package("TestSignedApp.msix");
+    Msix::MsixInfo msix(package.GetPath().u8string());
+
+    std::vector<byte> expected = msix.GetSignature();
+    std::vector<byte> actual = Msix::GetPackageSignature(package.GetPath().u8string());
+
+    REQUIRE(!actual.empty());
+    REQUIRE(expected == actual);
+}
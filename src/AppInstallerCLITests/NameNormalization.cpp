@@ -103,6 +103,59 @@ TEST_CASE("NameNorm_Database_Initial", "[name_norm]")
     }
 }
 
+// This skipped test case measures normalization throughput over the test database, which was taken from real ARP data.
+// The second pass over the same values is served from the normalizer's cache.
+TEST_CASE("NameNorm_Benchmark_Database_Initial", "[.]")
+{
+    std::ifstream namesStream(TestCommon::TestDataFile("InputNames.txt").GetPath());
+    REQUIRE(namesStream);
+    std::ifstream publishersStream(TestCommon::TestDataFile("InputPublishers.txt").GetPath());
+    REQUIRE(publishersStream);
+
+    std::vector<std::pair<std::string, std::string>> values;
+    std::string name;
+    std::string publisher;
+
+    while (std::getline(namesStream, name) && std::getline(publishersStream, publisher))
+    {
+        values.emplace_back(std::move(name), std::move(publisher));
+    }
+
+    NameNormalizer normer(NormalizationVersion::Initial);
+
+    auto measure = [&](std::string_view pass)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& value : values)
+        {
+            (void)normer.Normalize(value.first, value.second);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        WARN(pass << ": " << values.size() << " values in " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms");
+    };
+
+    measure("First pass");
+    measure("Cached pass");
+}
+
+TEST_CASE("NameNorm_Cache", "[name_norm]")
+{
+    NameNormalizer normer(NormalizationVersion::Initial);
+
+    // Cached results must match and must not be confused between the name and publisher.
+    auto first = normer.Normalize("Name x64 en-US", "Publisher Inc.");
+    auto second = normer.Normalize("Name x64 en-US", "Publisher Inc.");
+    REQUIRE(first.Name() == second.Name());
+    REQUIRE(first.Publisher() == second.Publisher());
+    REQUIRE(first.Architecture() == second.Architecture());
+    REQUIRE(first.Locale() == second.Locale());
+
+    REQUIRE(normer.Normalize("ab", "c").Name() != normer.Normalize("a", "bc").Name());
+    REQUIRE(normer.NormalizeName("Name x64 en-US").Name() == first.Name());
+    REQUIRE(normer.NormalizePublisher("Publisher Inc.") == first.Publisher());
+}
+
 TEST_CASE("NameNorm_Architecture", "[name_norm]")
 {
     NameNormalizer normer(NormalizationVersion::Initial);
@@ -131,3 +184,15 @@ TEST_CASE("NameNorm_KBNumbers", "[name_norm]")
 
     REQUIRE(normer.Normalize("Fix for (KB42)", {}).Name() == "FixforKB42");
 }
+
+TEST_CASE("NameNorm_CharacterSets", "[name_norm]")
+{
+    NameNormalizer normer(NormalizationVersion::Initial);
+
+    REQUIRE(normer.Normalize("--Name++--", {}).Name() == "Name");
+    REQUIRE(normer.Normalize("Name & Inc Other", {}).Name() == "NameOther");
+    REQUIRE(normer.NormalizePublisher("Contoso, Ltd.") == "Contoso");
+
+    // Supplementary code points are classified whole, rather than as surrogates
+    REQUIRE(normer.Normalize(u8"\U0001D400pp \U0001F600", {}).Name() == u8"\U0001D400pp");
+}
@@ -186,3 +186,65 @@ TEST_CASE("TrackingCatalog_Uninstall", "[tracking_catalog]")
     SearchResult resultAfter = catalog.Search(request);
     REQUIRE(resultAfter.Matches.size() == 0);
 }
+
+TEST_CASE("TrackingCatalog_UninstallMultiple", "[tracking_catalog]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SourceDetails details;
+    Manifest manifest;
+    std::string relativePath;
+    auto source = SimpleTestSetup(tempFile, details, manifest, relativePath);
+
+    PackageTrackingCatalog catalog = CreatePackageTrackingCatalogForSource(source);
+
+    Manifest secondManifest = manifest;
+    secondManifest.Id = manifest.Id + ".Second";
+
+    Manifest thirdManifest = manifest;
+    thirdManifest.Id = manifest.Id + ".Third";
+
+    catalog.RecordInstall(manifest, manifest.Installers[0], false);
+    catalog.RecordInstall(secondManifest, secondManifest.Installers[0], false);
+    catalog.RecordInstall(thirdManifest, thirdManifest.Installers[0], false);
+
+    catalog.RecordUninstalls({ LocIndString{ manifest.Id }, LocIndString{ thirdManifest.Id } });
+
+    auto countMatches = [&](const std::string& id)
+    {
+        SearchRequest request;
+        request.Filters.emplace_back(PackageMatchField::Id, MatchType::Exact, id);
+        return catalog.Search(request).Matches.size();
+    };
+
+    REQUIRE(countMatches(manifest.Id) == 0);
+    REQUIRE(countMatches(secondManifest.Id) == 1);
+    REQUIRE(countMatches(thirdManifest.Id) == 0);
+}
+
+TEST_CASE("TrackingCatalog_SeparateCatalogsSeeWrites", "[tracking_catalog]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SourceDetails details;
+    Manifest manifest;
+    std::string relativePath;
+    auto source = SimpleTestSetup(tempFile, details, manifest, relativePath);
+
+    // The reading catalog is opened before any write, and never writes itself
+    PackageTrackingCatalog readingCatalog = CreatePackageTrackingCatalogForSource(source);
+    PackageTrackingCatalog writingCatalog = CreatePackageTrackingCatalogForSource(source);
+
+    SearchRequest request;
+    request.Filters.emplace_back(PackageMatchField::Id, MatchType::Exact, manifest.Id);
+
+    REQUIRE(readingCatalog.Search(request).Matches.size() == 0);
+
+    writingCatalog.RecordInstall(manifest, manifest.Installers[0], false);
+    REQUIRE(readingCatalog.Search(request).Matches.size() == 1);
+
+    writingCatalog.RecordUninstall(LocIndString{ manifest.Id });
+    REQUIRE(readingCatalog.Search(request).Matches.size() == 0);
+}
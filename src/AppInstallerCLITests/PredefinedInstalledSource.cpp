@@ -20,6 +20,7 @@ using namespace AppInstaller::Utility;
 using SQLiteIndex = AppInstaller::Repository::Microsoft::SQLiteIndex;
 using Factory = AppInstaller::Repository::Microsoft::PredefinedInstalledSourceFactory;
 using ARPHelper = AppInstaller::Repository::Microsoft::ARPHelper;
+using InstalledSearchFilter = AppInstaller::Repository::Microsoft::InstalledSearchFilter;
 
 constexpr std::string_view s_TestScope = "TestScope"sv;
 
@@ -163,7 +164,7 @@ TEST_CASE("ARPHelper_GetBoolValue_DoesNotExist", "[arphelper][list]")
 
     ARPHelper helper;
 
-    REQUIRE_FALSE(helper.GetBoolValue(key, valueName));
+    REQUIRE_FALSE(helper.GetBoolValue(key.ReadValues(), valueName));
 }
 
 TEST_CASE("ARPHelper_GetBoolValue_NotDword", "[arphelper][list]")
@@ -176,7 +177,7 @@ TEST_CASE("ARPHelper_GetBoolValue_NotDword", "[arphelper][list]")
 
     ARPHelper helper;
 
-    REQUIRE_FALSE(helper.GetBoolValue(key, valueName));
+    REQUIRE_FALSE(helper.GetBoolValue(key.ReadValues(), valueName));
 }
 
 TEST_CASE("ARPHelper_GetBoolValue_Zero", "[arphelper][list]")
@@ -189,7 +190,7 @@ TEST_CASE("ARPHelper_GetBoolValue_Zero", "[arphelper][list]")
 
     ARPHelper helper;
 
-    REQUIRE_FALSE(helper.GetBoolValue(key, valueName));
+    REQUIRE_FALSE(helper.GetBoolValue(key.ReadValues(), valueName));
 }
 
 TEST_CASE("ARPHelper_GetBoolValue_One", "[arphelper][list]")
@@ -202,7 +203,7 @@ TEST_CASE("ARPHelper_GetBoolValue_One", "[arphelper][list]")
 
     ARPHelper helper;
 
-    REQUIRE(helper.GetBoolValue(key, valueName));
+    REQUIRE(helper.GetBoolValue(key.ReadValues(), valueName));
 }
 
 TEST_CASE("ARPHelper_GetBoolValue_FortyTwo", "[arphelper][list]")
@@ -215,7 +216,7 @@ TEST_CASE("ARPHelper_GetBoolValue_FortyTwo", "[arphelper][list]")
 
     ARPHelper helper;
 
-    REQUIRE(helper.GetBoolValue(key, valueName));
+    REQUIRE(helper.GetBoolValue(key.ReadValues(), valueName));
 }
 
 TEST_CASE("ARPHelper_DetermineVersion_DisplayVersion", "[arphelper][list]")
@@ -230,7 +231,7 @@ TEST_CASE("ARPHelper_DetermineVersion_DisplayVersion", "[arphelper][list]")
     SetRegistryValue(root.get(), helper.VersionMajor, 3);
     SetRegistryValue(root.get(), helper.VersionMinor, 14);
 
-    auto result = helper.DetermineVersion(key);
+    auto result = helper.DetermineVersion(key.ReadValues());
     REQUIRE(result == "1.0");
 }
 
@@ -245,7 +246,7 @@ TEST_CASE("ARPHelper_DetermineVersion_Version", "[arphelper][list]")
     SetRegistryValue(root.get(), helper.VersionMajor, 3);
     SetRegistryValue(root.get(), helper.VersionMinor, 14);
 
-    auto result = helper.DetermineVersion(key);
+    auto result = helper.DetermineVersion(key.ReadValues());
     REQUIRE(result == "3.14");
 }
 
@@ -259,7 +260,7 @@ TEST_CASE("ARPHelper_DetermineVersion_VersionMajorMinor", "[arphelper][list]")
     SetRegistryValue(root.get(), helper.VersionMajor, 3);
     SetRegistryValue(root.get(), helper.VersionMinor, 14);
 
-    auto result = helper.DetermineVersion(key);
+    auto result = helper.DetermineVersion(key.ReadValues());
     REQUIRE(result == "3.14");
 }
 
@@ -270,7 +271,7 @@ TEST_CASE("ARPHelper_DetermineVersion_Unknown", "[arphelper][list]")
 
     ARPHelper helper;
 
-    auto result = helper.DetermineVersion(key);
+    auto result = helper.DetermineVersion(key.ReadValues());
     REQUIRE(result == Version::CreateUnknown().ToString());
 }
 
@@ -385,6 +386,175 @@ TEST_CASE("ARPHelper_PopulateIndexFromKey_Two", "[arphelper][list]")
     VerifyEntryAgainstIndex(index, result.Matches[0].first, entry2);
 }
 
+TEST_CASE("ARPHelper_AddMatchingEntriesToIndex", "[arphelper][list]")
+{
+    auto root = RegCreateVolatileTestRoot();
+    Registry::Key key(root.get());
+
+    ARPHelper helper;
+
+    AddARPEntriesToKey(root.get(), helper, {
+        ARPEntry{ "FirstEntry", "Test Name", "1.2" },
+        ARPEntry{ "SecondEntry", "Different Name", "31.4" },
+        ARPEntry{ "ThirdEntry", "Other Test Name", "2.0" },
+        });
+
+    std::vector<ARPHelper::Entry> entries = helper.ReadEntriesFromKey(key, s_TestScope, "TestArchitecture");
+    REQUIRE(entries.size() == 3);
+
+    // A later duplicate of the first entry, which a full index ignores
+    ARPHelper::Entry duplicate = entries[0];
+    duplicate.PackageManifest.DefaultLocalization.Add<Localization::PackageName>("Hidden Duplicate");
+    entries.emplace_back(std::move(duplicate));
+
+    auto fullIndex = SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET);
+    helper.AddEntriesToIndex(fullIndex, entries);
+
+    std::vector<SearchRequest> requests;
+
+    requests.emplace_back();
+    requests.back().Query = RequestMatch(MatchType::Substring, "test");
+
+    requests.emplace_back();
+    requests.back().Query = RequestMatch(MatchType::Substring, "Hidden");
+
+    requests.emplace_back();
+    requests.back().Filters.emplace_back(PackageMatchField::Id, MatchType::CaseInsensitive, "secondentry");
+
+    requests.emplace_back();
+    requests.back().Inclusions.emplace_back(PackageMatchField::ProductCode, MatchType::Exact, "THIRDENTRY");
+
+    requests.emplace_back();
+    requests.back().Query = RequestMatch(MatchType::StartsWith, "arp");
+    requests.back().Filters.emplace_back(PackageMatchField::Name, MatchType::Substring, "Name");
+
+    for (const auto& request : requests)
+    {
+        INFO(request.ToString());
+
+        auto filter = InstalledSearchFilter::Create(request);
+        REQUIRE(filter);
+
+        std::vector<ARPHelper::Entry> remaining = entries;
+        auto filteredIndex = SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET);
+        helper.AddMatchingEntriesToIndex(filteredIndex, remaining, filter.value());
+
+        auto expected = fullIndex.Search(request);
+        auto actual = filteredIndex.Search(request);
+
+        REQUIRE(expected.Matches.size() == actual.Matches.size());
+        for (size_t i = 0; i < expected.Matches.size(); ++i)
+        {
+            REQUIRE(fullIndex.GetPropertyByManifestId(expected.Matches[i].first, PackageVersionProperty::Id) ==
+                filteredIndex.GetPropertyByManifestId(actual.Matches[i].first, PackageVersionProperty::Id));
+            REQUIRE(fullIndex.GetPropertyByManifestId(expected.Matches[i].first, PackageVersionProperty::Name) ==
+                filteredIndex.GetPropertyByManifestId(actual.Matches[i].first, PackageVersionProperty::Name));
+        }
+
+        // Adding what was left completes the index
+        helper.AddEntriesToIndex(filteredIndex, remaining);
+        REQUIRE(fullIndex.Search({}).Matches.size() == filteredIndex.Search({}).Matches.size());
+    }
+}
+
+TEST_CASE("ARPHelper_AddMatchingEntriesToIndex_LeavesOutTheRest", "[arphelper][list]")
+{
+    auto root = RegCreateVolatileTestRoot();
+    Registry::Key key(root.get());
+
+    ARPHelper helper;
+
+    AddARPEntriesToKey(root.get(), helper, {
+        ARPEntry{ "FirstEntry", "Test Name", "1.2" },
+        ARPEntry{ "SecondEntry", "Different Name", "31.4" },
+        ARPEntry{ "ThirdEntry", "Other Name", "2.0" },
+        });
+
+    std::vector<ARPHelper::Entry> entries = helper.ReadEntriesFromKey(key, s_TestScope, "TestArchitecture");
+    REQUIRE(entries.size() == 3);
+
+    SearchRequest request;
+    request.Filters.emplace_back(PackageMatchField::Id, MatchType::CaseInsensitive, "secondentry");
+
+    auto filter = InstalledSearchFilter::Create(request);
+    REQUIRE(filter);
+
+    auto index = SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET);
+    helper.AddMatchingEntriesToIndex(index, entries, filter.value());
+
+    // Only the matching entry is in the index; the others were never added, and are left to be added later
+    auto everything = index.Search({});
+    REQUIRE(everything.Matches.size() == 1);
+    REQUIRE(index.GetPropertyByManifestId(everything.Matches[0].first, PackageVersionProperty::Id) == "SecondEntry");
+
+    REQUIRE(entries.size() == 2);
+    for (const auto& entry : entries)
+    {
+        REQUIRE_FALSE(filter->CouldMatch(entry.PackageManifest));
+
+        SearchRequest entryRequest;
+        entryRequest.Filters.emplace_back(PackageMatchField::Id, MatchType::Exact, entry.PackageManifest.Id);
+        REQUIRE(index.Search(entryRequest).Matches.empty());
+    }
+}
+
+TEST_CASE("InstalledSearchFilter_Create", "[installed][list]")
+{
+    SearchRequest request;
+    REQUIRE_FALSE(InstalledSearchFilter::Create(request));
+
+    request.Query = RequestMatch(MatchType::Wildcard, "test");
+    REQUIRE_FALSE(InstalledSearchFilter::Create(request));
+
+    request.Query = RequestMatch(MatchType::Substring, "test");
+    REQUIRE(InstalledSearchFilter::Create(request));
+
+    request.Inclusions.emplace_back(PackageMatchField::NormalizedNameAndPublisher, MatchType::Exact, "name", "publisher");
+    REQUIRE_FALSE(InstalledSearchFilter::Create(request));
+}
+
+TEST_CASE("InstalledSearchFilter_ExaminesField", "[installed][list]")
+{
+    SearchRequest request;
+    request.Inclusions.emplace_back(PackageMatchField::PackageFamilyName, MatchType::Exact, "family_name");
+
+    auto filter = InstalledSearchFilter::Create(request);
+    REQUIRE(filter);
+    REQUIRE(filter->ExaminesField(PackageMatchField::PackageFamilyName));
+    REQUIRE_FALSE(filter->ExaminesField(PackageMatchField::Name));
+
+    // A query searches every field.
+    request.Query = RequestMatch(MatchType::Substring, "test");
+
+    filter = InstalledSearchFilter::Create(request);
+    REQUIRE(filter);
+    REQUIRE(filter->ExaminesField(PackageMatchField::Name));
+}
+
+TEST_CASE("ARPHelper_EntryStates_RoundTrip", "[arphelper][list]")
+{
+    std::vector<ARPHelper::EntryState> states;
+
+    ARPHelper::EntryState first;
+    first.Scope = ScopeEnum::Machine;
+    first.Architecture = GetSystemArchitecture();
+    first.ProductCode = "{0E2BA2D5-5CDD-4C4A-9A55-E7E4F5F1D71E}";
+    first.LastWriteTime = 132801234567890123;
+    states.emplace_back(first);
+
+    ARPHelper::EntryState second;
+    second.Scope = ScopeEnum::User;
+    second.Architecture = Architecture::X86;
+    second.ProductCode = "Product|With|Separators";
+    second.LastWriteTime = 1;
+    states.emplace_back(second);
+
+    auto result = ARPHelper::DeserializeEntryStates(ARPHelper::SerializeEntryStates(states));
+
+    REQUIRE(result == states);
+    REQUIRE(ARPHelper::DeserializeEntryStates(ARPHelper::SerializeEntryStates({})).empty());
+}
+
 TEST_CASE("PredefinedInstalledSource_Create", "[installed][list]")
 {
     auto source = CreatePredefinedInstalledSource();
@@ -400,3 +570,60 @@ TEST_CASE("PredefinedInstalledSource_Search", "[installed][list]")
 
     REQUIRE_FALSE(results.Matches.empty());
 }
+
+TEST_CASE("PredefinedInstalledSource_SearchWithoutSnapshot", "[installed][list]")
+{
+    SearchRequest request;
+    std::vector<std::string> expectedIds;
+
+    {
+        auto source = CreatePredefinedInstalledSource(Factory::Filter::ARP);
+        auto everything = source->Search({});
+        REQUIRE_FALSE(everything.Matches.empty());
+
+        request.Filters.emplace_back(PackageMatchField::Id, MatchType::Substring, everything.Matches[0].Package->GetProperty(PackageProperty::Id).get());
+
+        for (const auto& match : source->Search(request).Matches)
+        {
+            expectedIds.emplace_back(match.Package->GetProperty(PackageProperty::Id).get());
+        }
+    }
+
+    // Without a snapshot, a narrow first search only indexes the packages that it could find, and must find the same ones
+    std::filesystem::remove(GetPathTo(PathName::LocalState) / "InstalledSnapshot" / "ARP.db");
+
+    auto source = CreatePredefinedInstalledSource(Factory::Filter::ARP);
+    auto results = source->Search(request);
+
+    REQUIRE(expectedIds.size() == results.Matches.size());
+    for (size_t i = 0; i < expectedIds.size(); ++i)
+    {
+        REQUIRE(expectedIds[i] == results.Matches[i].Package->GetProperty(PackageProperty::Id).get());
+    }
+
+    // A later search adds the rest to the same index, so a package found by the first search is the same in it
+    auto everything = source->Search({});
+    REQUIRE(everything.Matches.size() >= results.Matches.size());
+    for (const auto& match : results.Matches)
+    {
+        REQUIRE(std::any_of(everything.Matches.begin(), everything.Matches.end(),
+            [&](const ResultMatch& other) { return match.Package->IsSame(other.Package.get()); }));
+    }
+}
+
+TEST_CASE("PredefinedInstalledSource_Snapshot", "[installed][list]")
+{
+    // The second open should be able to use the snapshot saved by the first, and must return the same packages.
+    auto source = CreatePredefinedInstalledSource(Factory::Filter::ARP);
+    auto results = source->Search({});
+    source.reset();
+
+    auto snapshot = CreatePredefinedInstalledSource(Factory::Filter::ARP);
+    auto snapshotResults = snapshot->Search({});
+
+    REQUIRE(results.Matches.size() == snapshotResults.Matches.size());
+    for (size_t i = 0; i < results.Matches.size(); ++i)
+    {
+        REQUIRE(results.Matches[i].Package->GetProperty(PackageProperty::Id) == snapshotResults.Matches[i].Package->GetProperty(PackageProperty::Id));
+    }
+}
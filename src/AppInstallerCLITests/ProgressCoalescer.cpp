@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include <winget/ProgressCoalescer.h>
+
+using namespace std::chrono_literals;
+using namespace AppInstaller;
+
+using TestCoalescer = ProgressCoalescer<int>;
+
+TEST_CASE("ProgressCoalescer_FirstUpdateIsImmediate", "[progress]")
+{
+    TestCoalescer coalescer{ 100ms };
+    coalescer.Post(1, false);
+
+    auto updates = coalescer.TakeUpdates();
+    REQUIRE(updates == std::vector<int>{ 1 });
+    REQUIRE(coalescer.TakeUpdates().empty());
+}
+
+TEST_CASE("ProgressCoalescer_ThrottlesWithinInterval", "[progress]")
+{
+    TestCoalescer coalescer{ 100ms };
+    auto now = TestCoalescer::clock::now();
+
+    coalescer.Post(1, false);
+    REQUIRE(coalescer.TakeUpdates(now) == std::vector<int>{ 1 });
+
+    // Only the latest of the updates within the interval is kept, and it is due at the end of the interval.
+    coalescer.Post(2, false);
+    coalescer.Post(3, false);
+    REQUIRE(coalescer.TakeUpdates(now + 10ms).empty());
+
+    auto wait = coalescer.GetTimeUntilNextUpdate(now + 10ms);
+    REQUIRE(wait);
+    REQUIRE(*wait == 90ms);
+
+    REQUIRE(coalescer.TakeUpdates(now + 100ms) == std::vector<int>{ 3 });
+    REQUIRE(!coalescer.GetTimeUntilNextUpdate(now + 100ms));
+}
+
+TEST_CASE("ProgressCoalescer_TransitionsAreAlwaysDelivered", "[progress]")
+{
+    TestCoalescer coalescer{ 100ms };
+    auto now = TestCoalescer::clock::now();
+
+    coalescer.Post(1, false);
+    REQUIRE(coalescer.TakeUpdates(now) == std::vector<int>{ 1 });
+
+    // A transition replaces the progress that was waiting, and is not held back.
+    coalescer.Post(2, false);
+    coalescer.Post(10, true);
+    coalescer.Post(20, true);
+    coalescer.Post(21, false);
+    REQUIRE(coalescer.TakeUpdates(now + 1ms) == std::vector<int>{ 10, 20, 21 });
+}
+
+TEST_CASE("ProgressCoalescer_SignalsEvent", "[progress]")
+{
+    TestCoalescer coalescer{ 100ms };
+    REQUIRE(WaitForSingleObject(coalescer.GetEvent(), 0) == WAIT_TIMEOUT);
+
+    coalescer.Post(1, false);
+    REQUIRE(WaitForSingleObject(coalescer.GetEvent(), 0) == WAIT_OBJECT_0);
+}
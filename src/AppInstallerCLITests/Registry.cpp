@@ -169,3 +169,54 @@ TEST_CASE("Values_DWORD", "[registry]")
     REQUIRE(value->GetType() == Value::Type::DWord);
     REQUIRE(value->GetValue<Value::Type::DWord>() == valueValue);
 }
+
+TEST_CASE("Values_ReadValues", "[registry]")
+{
+    std::wstring stringName = L"StringValue";
+    std::wstring stringValue = L"TestValueValue";
+    std::wstring expandName = L"ExpandValue";
+    std::wstring expandValue = L"%TEMP%";
+    std::wstring binaryName = L"BinaryValue";
+    std::vector<BYTE> binaryValue = { 2, 7, 3, 14, 42 };
+    std::wstring dwordName = L"DWordValue";
+    DWORD dwordValue = 42;
+
+    wil::unique_hkey root = RegCreateVolatileTestRoot();
+    SetRegistryValue(root.get(), stringName, stringValue);
+    SetRegistryValue(root.get(), expandName, expandValue, REG_EXPAND_SZ);
+    SetRegistryValue(root.get(), binaryName, binaryValue);
+    SetRegistryValue(root.get(), dwordName, dwordValue);
+
+    Key key{ root.get(), L"" };
+
+    ValueSet values = key.ReadValues();
+    REQUIRE(values.size() == 4);
+
+    auto string = values["stringvalue"];
+    REQUIRE(string);
+    REQUIRE(string->GetType() == Value::Type::String);
+    REQUIRE(string->GetValue<Value::Type::String>() == ConvertToUTF8(stringValue));
+
+    auto expand = values[expandName];
+    REQUIRE(expand);
+    REQUIRE(expand->GetType() == Value::Type::ExpandString);
+    REQUIRE(expand->GetValue<Value::Type::String>() == ConvertToUTF8(expandValue));
+
+    auto binary = values[L"BINARYVALUE"];
+    REQUIRE(binary);
+    REQUIRE(binary->GetType() == Value::Type::Binary);
+    REQUIRE(binary->GetValue<Value::Type::Binary>() == binaryValue);
+
+    auto dword = values[dwordName];
+    REQUIRE(dword);
+    REQUIRE(dword->GetType() == Value::Type::DWord);
+    REQUIRE(dword->GetValue<Value::Type::DWord>() == dwordValue);
+
+    REQUIRE_FALSE(values[L"MissingValue"]);
+
+    // Reading again into the same set replaces its contents
+    SetRegistryValue(root.get(), dwordName, DWORD{ 7 });
+    key.ReadValues(values);
+    REQUIRE(values.size() == 4);
+    REQUIRE(values[dwordName]->GetValue<Value::Type::DWord>() == 7);
+}
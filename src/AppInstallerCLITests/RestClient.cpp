@@ -49,7 +49,7 @@ TEST_CASE("GetSupportedInterface", "[RestSource]")
     Version version{ "1.0.0" };
     REQUIRE(RestClient::GetSupportedInterface(utility::conversions::to_utf8string(TestRestUri), {}, info, version)->GetVersion() == version);
 
-    Version invalid{ "1.2.0" };
+    Version invalid{ "2.0.0" };
     REQUIRE_THROWS(RestClient::GetSupportedInterface(utility::conversions::to_utf8string(TestRestUri), {}, info, invalid));
 }
 
@@ -136,7 +136,7 @@ TEST_CASE("RestClientCreate_UnsupportedVersion", "[RestSource]")
             "Data" : {
               "SourceIdentifier": "Source123",
               "ServerSupportedVersions": [
-                "1.2.0",
+                "3.0.0",
                 "2.0.0"]
         }})delimiter");
 
@@ -210,3 +210,26 @@ TEST_CASE("RestClientCreate_1.1_Success", "[RestSource]")
     REQUIRE(information.UnsupportedPackageMatchFields.size() == 1);
     REQUIRE(information.UnsupportedPackageMatchFields.at(0) == "Moniker");
 }
+
+TEST_CASE("RestClientCreate_1.2_Success", "[RestSource]")
+{
+    utility::string_t sample = _XPLATSTR(
+        R"delimiter({
+            "Data" : {
+              "SourceIdentifier": "Source123",
+              "ServerSupportedVersions": [
+                "1.1.0",
+                "1.2.0"],
+              "ServerCapabilities": [
+                "ManifestBatch"
+              ]
+        }})delimiter");
+
+    HttpClientHelper helper{ GetTestRestRequestHandler(web::http::status_codes::OK, sample) };
+    RestClient client = RestClient::Create(utility::conversions::to_utf8string(TestRestUri), {}, std::move(helper));
+    REQUIRE(client.GetSourceIdentifier() == "Source123");
+    REQUIRE(client.SupportsManifestBatch());
+    auto information = client.GetSourceInformation();
+    REQUIRE(information.ServerCapabilities.size() == 1);
+    REQUIRE(information.ServerCapabilities.at(0) == "ManifestBatch");
+}
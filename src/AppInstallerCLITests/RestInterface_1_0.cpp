@@ -297,6 +297,43 @@ TEST_CASE("Search_GoodResponse", "[RestSource][Interface_1_0]")
     REQUIRE(package.Versions.at(1).VersionAndChannel.GetVersion().ToString().compare("2.0.0") == 0);
 }
 
+TEST_CASE("Search_GoodResponse_DeferredVersions", "[RestSource][Interface_1_0]")
+{
+    utility::string_t sample = _XPLATSTR(
+        R"delimiter({
+            "Data" : [
+               {
+              "PackageIdentifier": "git.package",
+              "PackageName": "package",
+              "Publisher": "git",
+              "Versions": [
+                {   "PackageVersion": "1.0.0" },
+                {   "PackageVersion": "3.0.0", "ProductCodes" : [ "code1" ] },
+                {   "PackageVersion": "2.0.0"}]
+            }]
+        })delimiter");
+
+    HttpClientHelper helper{ GetTestRestRequestHandler(web::http::status_codes::OK, std::move(sample)) };
+    Interface v1{ TestRestUriString, std::move(helper) };
+    Schema::IRestClient::SearchResult searchResponse = v1.Search({}, true);
+    REQUIRE(searchResponse.Matches.size() == 1);
+    Schema::IRestClient::Package package = searchResponse.Matches.at(0);
+    REQUIRE(package.PackageInformation.PackageIdentifier.compare("git.package") == 0);
+
+    // Only the latest version is deserialized by the search.
+    REQUIRE(package.Versions.size() == 1);
+    REQUIRE(package.Versions.at(0).VersionAndChannel.GetVersion().ToString().compare("3.0.0") == 0);
+    REQUIRE(package.Versions.at(0).ProductCodes.size() == 1);
+    REQUIRE(package.Versions.at(0).ProductCodes.at(0).compare("code1") == 0);
+
+    REQUIRE(package.DeferredVersions);
+    std::vector<Schema::IRestClient::VersionInfo> versions = package.DeferredVersions();
+    REQUIRE(versions.size() == 3);
+    REQUIRE(versions.at(0).VersionAndChannel.GetVersion().ToString().compare("1.0.0") == 0);
+    REQUIRE(versions.at(1).VersionAndChannel.GetVersion().ToString().compare("3.0.0") == 0);
+    REQUIRE(versions.at(2).VersionAndChannel.GetVersion().ToString().compare("2.0.0") == 0);
+}
+
 TEST_CASE("Search_GoodResponse_AllFields", "[RestSource][Interface_1_0]")
 {
     utility::string_t sample = _XPLATSTR(
@@ -374,6 +411,81 @@ TEST_CASE("Search_ContinuationToken", "[RestSource][Interface_1_0]")
     REQUIRE(resultsWithSize1.Matches.size() == requestWithSize1.MaximumResults);
 }
 
+TEST_CASE("Search_ContinuationToken_Pipelined", "[RestSource][Interface_1_0]")
+{
+    // Serves three pages of two packages each, chained by continuation tokens.
+    std::atomic<int> requestCount = 0;
+    auto handler = std::make_shared<TestRestRequestHandler>([&](web::http::http_request request) -> pplx::task<web::http::http_response>
+        {
+            ++requestCount;
+
+            int page = 0;
+            if (request.headers().has(L"ContinuationToken"))
+            {
+                page = std::stoi(request.headers()[L"ContinuationToken"]);
+            }
+
+            web::json::value data = web::json::value::array();
+            for (int i = 0; i < 2; ++i)
+            {
+                web::json::value package;
+                package[L"PackageIdentifier"] = web::json::value::string(L"package." + std::to_wstring(page * 2 + i));
+                package[L"PackageName"] = web::json::value::string(L"package");
+                package[L"Publisher"] = web::json::value::string(L"publisher");
+                package[L"Versions"][0][L"PackageVersion"] = web::json::value::string(L"1.0.0");
+                data[i] = package;
+            }
+
+            web::json::value body;
+            body[L"Data"] = data;
+            if (page < 2)
+            {
+                body[L"ContinuationToken"] = web::json::value::string(std::to_wstring(page + 1));
+            }
+
+            web::http::http_response response;
+            response.set_body(body);
+            response.headers().set_content_type(web::http::details::mime_types::application_json);
+            response.set_status_code(web::http::status_codes::OK);
+            return pplx::task_from_result(response);
+        });
+
+    HttpClientHelper helper{ handler };
+    Interface v1{ TestRestUriString, std::move(helper) };
+
+    SECTION("All pages")
+    {
+        Schema::IRestClient::SearchResult results = v1.Search({});
+        REQUIRE(results.Matches.size() == 6);
+        REQUIRE(!results.Truncated);
+        REQUIRE(requestCount == 3);
+
+        for (size_t i = 0; i < results.Matches.size(); ++i)
+        {
+            REQUIRE(results.Matches[i].PackageInformation.PackageIdentifier == "package." + std::to_string(i));
+        }
+    }
+    SECTION("Maximum reached on a page boundary")
+    {
+        SearchRequest request{};
+        request.MaximumResults = 4;
+        Schema::IRestClient::SearchResult results = v1.Search(request);
+        REQUIRE(results.Matches.size() == 4);
+        REQUIRE(results.Truncated);
+        // The page after the maximum is reached is never requested.
+        REQUIRE(requestCount == 2);
+    }
+    SECTION("Maximum reached within a page")
+    {
+        SearchRequest request{};
+        request.MaximumResults = 3;
+        Schema::IRestClient::SearchResult results = v1.Search(request);
+        REQUIRE(results.Matches.size() == 3);
+        REQUIRE(results.Truncated);
+        REQUIRE(requestCount == 2);
+    }
+}
+
 TEST_CASE("Search_BadResponse_NoVersions", "[RestSource][Interface_1_0]")
 {
     utility::string_t sample = _XPLATSTR(
@@ -383,6 +383,37 @@ TEST_CASE("Search_BadRequest_UnsupportedPackageMatchFields", "[RestSource][Inter
     REQUIRE_THROWS_HR(v1_1.Search(request), APPINSTALLER_CLI_ERROR_UNSUPPORTED_SOURCE_REQUEST);
 }
 
+TEST_CASE("Search_Request_OnlyUnsupportedInclusions", "[RestSource][Interface_1_1]")
+{
+    std::atomic<int> requestCount = 0;
+    auto handler = std::make_shared<TestRestRequestHandler>([&](web::http::http_request) -> pplx::task<web::http::http_response>
+        {
+            ++requestCount;
+
+            web::http::http_response response;
+            response.set_body(web::json::value::parse(_XPLATSTR(R"delimiter({ "Data" : [] })delimiter")));
+            response.headers().set_content_type(web::http::details::mime_types::application_json);
+            response.set_status_code(web::http::status_codes::OK);
+            return pplx::task_from_result(response);
+        });
+
+    HttpClientHelper helper{ handler };
+    Interface v1_1{ TestRestUriString, GetTestSourceInformation(), {}, std::move(helper) };
+
+    // Without its only inclusion, the request would select every package by its filter alone.
+    AppInstaller::Repository::SearchRequest request;
+    request.Inclusions.emplace_back(PackageMatchField::Moniker, MatchType::Exact, "Foo");
+    request.Filters.emplace_back(PackageMatchField::Name, MatchType::Substring, "Foo");
+    Schema::IRestClient::SearchResult searchResponse = v1_1.Search(request);
+    REQUIRE(searchResponse.Matches.empty());
+    REQUIRE(requestCount == 0);
+
+    // A supported inclusion is still sent.
+    request.Inclusions.emplace_back(PackageMatchField::ProductCode, MatchType::Exact, "{Foo}");
+    v1_1.Search(request);
+    REQUIRE(requestCount == 1);
+}
+
 TEST_CASE("Search_GoodRequest_OnlyMarketRequired", "[RestSource][Interface_1_1]")
 {
     utility::string_t sample = _XPLATSTR(
@@ -0,0 +1,143 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include "TestRestRequestHandler.h"
+#include <Rest/Schema/1_2/Interface.h>
+#include <Rest/Schema/IRestClient.h>
+#include <AppInstallerVersions.h>
+#include <AppInstallerErrors.h>
+
+using namespace TestCommon;
+using namespace AppInstaller::Utility;
+using namespace AppInstaller::Manifest;
+using namespace AppInstaller::Repository;
+using namespace AppInstaller::Repository::Rest;
+using namespace AppInstaller::Repository::Rest::Schema;
+using namespace AppInstaller::Repository::Rest::Schema::V1_2;
+
+namespace
+{
+    const std::string TestRestUriString = "http://restsource.com/api";
+
+    utility::string_t GetPackageManifestData(std::string_view id, std::string_view version)
+    {
+        std::string result = R"delimiter({
+            "PackageIdentifier": ")delimiter" + std::string{ id } + R"delimiter(",
+            "Versions": [
+                {
+                    "PackageVersion": ")delimiter" + std::string{ version } + R"delimiter(",
+                    "DefaultLocale": {
+                        "PackageLocale": "en-us",
+                        "Publisher": "Foo",
+                        "PackageName": "Bar",
+                        "License": "Foo bar license",
+                        "ShortDescription": "Foo bar description"
+                    },
+                    "Installers": [
+                        {
+                            "Architecture": "x64",
+                            "InstallerSha256": "011048877dfaef109801b3f3ab2b60afc74f3fc4f7b3430e0c897f5da1df84b6",
+                            "InstallerType": "exe",
+                            "InstallerUrl": "https://installer.example.com/foobar.exe"
+                        }
+                    ]
+                }
+            ]
+        })delimiter";
+
+        return utility::conversions::to_string_t(result);
+    }
+
+    web::http::http_response GetJsonResponse(const utility::string_t& body)
+    {
+        web::http::http_response response;
+        response.set_body(web::json::value::parse(body));
+        response.headers().set_content_type(web::http::details::mime_types::application_json);
+        response.set_status_code(web::http::status_codes::OK);
+        return response;
+    }
+}
+
+TEST_CASE("GetManifestsByVersion_Batch", "[RestSource][Interface_1_2]")
+{
+    IRestClient::Information info{ "Source123", { "1.2.0" } };
+    info.ServerCapabilities.emplace_back("ManifestBatch");
+
+    int requestCount = 0;
+    size_t requestedManifests = 0;
+    auto handler = std::make_shared<TestRestRequestHandler>([&](web::http::http_request request) -> pplx::task<web::http::http_response>
+        {
+            ++requestCount;
+            REQUIRE(request.method() == web::http::methods::POST);
+            REQUIRE(request.request_uri().path() == L"/api/packageManifestsBatch");
+            REQUIRE(request.headers()[L"Version"] == L"1.2.0");
+
+            web::json::value body = request.extract_json().get();
+            requestedManifests = body.at(L"Manifests").as_array().size();
+
+            return pplx::task_from_result(GetJsonResponse(
+                L"{ \"Data\": [" + GetPackageManifestData("Foo.Bar", "1.0.0") + L", " + GetPackageManifestData("Foo.Baz", "2.0.0") + L"] }"));
+        });
+
+    HttpClientHelper helper{ handler };
+    Interface v1_2{ TestRestUriString, info, {}, std::move(helper) };
+    REQUIRE(v1_2.GetVersion() == Version_1_2_0);
+    REQUIRE(v1_2.SupportsManifestBatch());
+
+    std::vector<IRestClient::ManifestKey> keys
+    {
+        { "Foo.Baz", "2.0.0", "" },
+        { "Foo.Missing", "1.0.0", "" },
+        { "foo.bar", "1.0.0", "" },
+    };
+
+    std::vector<std::optional<Manifest>> manifests = v1_2.GetManifestsByVersion(keys);
+
+    REQUIRE(requestCount == 1);
+    REQUIRE(requestedManifests == 3);
+    REQUIRE(manifests.size() == 3);
+    REQUIRE(manifests[0]);
+    REQUIRE(manifests[0]->Id == "Foo.Baz");
+    REQUIRE(manifests[0]->Version == "2.0.0");
+    REQUIRE(!manifests[1]);
+    REQUIRE(manifests[2]);
+    REQUIRE(manifests[2]->Id == "Foo.Bar");
+    REQUIRE(manifests[2]->Installers.size() == 1);
+}
+
+TEST_CASE("GetManifestsByVersion_NoBatchCapability", "[RestSource][Interface_1_2]")
+{
+    IRestClient::Information info{ "Source123", { "1.2.0" } };
+
+    int requestCount = 0;
+    auto handler = std::make_shared<TestRestRequestHandler>([&](web::http::http_request request) -> pplx::task<web::http::http_response>
+        {
+            ++requestCount;
+            REQUIRE(request.method() == web::http::methods::GET);
+
+            std::string path = utility::conversions::to_utf8string(request.request_uri().path());
+            std::string id = path.substr(path.rfind('/') + 1);
+
+            return pplx::task_from_result(GetJsonResponse(L"{ \"Data\": " + GetPackageManifestData(id, "1.0.0") + L" }"));
+        });
+
+    HttpClientHelper helper{ handler };
+    Interface v1_2{ TestRestUriString, info, {}, std::move(helper) };
+    REQUIRE(!v1_2.SupportsManifestBatch());
+
+    std::vector<IRestClient::ManifestKey> keys
+    {
+        { "Foo.Bar", "1.0.0", "" },
+        { "Foo.Baz", "1.0.0", "" },
+    };
+
+    std::vector<std::optional<Manifest>> manifests = v1_2.GetManifestsByVersion(keys);
+
+    REQUIRE(requestCount == 2);
+    REQUIRE(manifests.size() == 2);
+    REQUIRE(manifests[0]);
+    REQUIRE(manifests[0]->Id == "Foo.Bar");
+    REQUIRE(manifests[1]);
+    REQUIRE(manifests[1]->Id == "Foo.Baz");
+}
@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include <AppInstallerSHA256.h>
+
+using namespace std::string_literals;
+using namespace TestCommon;
+using namespace AppInstaller::Utility;
+
+namespace
+{
+    void WriteFile(const std::filesystem::path& path, const std::string& content)
+    {
+        std::ofstream file{ path, std::ofstream::binary };
+        file << content;
+    }
+}
+
+TEST_CASE("SHA256_ComputeHash", "[sha256]")
+{
+    REQUIRE(SHA256::ConvertToString(SHA256::ComputeHash(""s)) == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    REQUIRE(SHA256::ConvertToString(SHA256::ComputeHash("abc"s)) == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+
+    SHA256 hasher;
+    hasher.Add(reinterpret_cast<const uint8_t*>("a"), 1);
+    hasher.Add(reinterpret_cast<const uint8_t*>("bc"), 2);
+    REQUIRE(SHA256::ConvertToString(hasher.Get()) == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+}
+
+TEST_CASE("SHA256_ComputeHashFromFile", "[sha256]")
+{
+    TempFile tempFile{ "sha256"s, ".bin"s };
+
+    SECTION("Empty")
+    {
+        WriteFile(tempFile, "");
+        REQUIRE(SHA256::ComputeHashFromFile(tempFile) == SHA256::ComputeHash(""s));
+    }
+    SECTION("Content")
+    {
+        std::string content(3 * 1024 * 1024 + 7, '\0');
+        for (size_t i = 0; i < content.size(); ++i)
+        {
+            content[i] = static_cast<char>(i * 31);
+        }
+
+        WriteFile(tempFile, content);
+
+        std::ifstream stream{ tempFile.GetPath(), std::ifstream::binary };
+        REQUIRE(SHA256::ComputeHashFromFile(tempFile) == SHA256::ComputeHash(stream));
+        REQUIRE(SHA256::ComputeHashFromFile(tempFile) == SHA256::ComputeHash(content));
+    }
+    SECTION("Missing")
+    {
+        REQUIRE_THROWS_HR(SHA256::ComputeHashFromFile(tempFile), HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND));
+    }
+}
@@ -5,7 +5,9 @@
 #include <SQLiteWrapper.h>
 #include <PackageDependenciesValidation.h>
 #include <Microsoft/SQLiteIndex.h>
+#include <Microsoft/SQLiteIndexDiff.h>
 #include <winget/Manifest.h>
+#include <winget/ManifestInstallerSummary.h>
 #include <AppInstallerStrings.h>
 
 #include <Microsoft/Schema/1_0/IdTable.h>
@@ -19,6 +21,10 @@
 #include <Microsoft/Schema/1_0/CommandsTable.h>
 #include <Microsoft/Schema/1_0/SearchResultsTable.h>
 #include <Microsoft/Schema/1_4/DependenciesTable.h>
+#include <Microsoft/Schema/1_5/SearchResultsTable.h>
+#include <Microsoft/Schema/1_5/TrigramTable.h>
+#include <Microsoft/Schema/1_6/LatestManifestTable.h>
+#include <Microsoft/Schema/1_9/SystemReferenceFilterTable.h>
 
 using namespace std::string_literals;
 using namespace std::string_view_literals;
@@ -34,7 +40,7 @@ SQLiteIndex CreateTestIndex(const std::string& filePath, std::optional<Schema::V
     // If no specific version requested, then use generator to run against the last 3 versions.
     if (!version)
     {
-        version = GENERATE(Schema::Version{ 1, 2 }, Schema::Version{ 1, 3 }, Schema::Version::Latest());
+        version = GENERATE(Schema::Version{ 1, 3 }, Schema::Version{ 1, 4 }, Schema::Version::Latest());
     }
 
     return SQLiteIndex::CreateNew(filePath, version.value());
@@ -72,6 +78,56 @@ Schema::Version TestPrepareForRead(SQLiteIndex& index)
             return version;
         }
     }
+    else if (index.GetVersion() == Schema::Version{ 1, 5 })
+    {
+        Schema::Version version = GENERATE(Schema::Version{ 1, 2 }, Schema::Version{ 1, 3 }, Schema::Version{ 1, 4 }, Schema::Version{ 1, 5 });
+
+        if (version != Schema::Version{ 1, 5 })
+        {
+            index.ForceVersion(version);
+            return version;
+        }
+    }
+    else if (index.GetVersion() == Schema::Version{ 1, 6 })
+    {
+        Schema::Version version = GENERATE(Schema::Version{ 1, 2 }, Schema::Version{ 1, 3 }, Schema::Version{ 1, 4 }, Schema::Version{ 1, 5 }, Schema::Version{ 1, 6 });
+
+        if (version != Schema::Version{ 1, 6 })
+        {
+            index.ForceVersion(version);
+            return version;
+        }
+    }
+    else if (index.GetVersion() == Schema::Version{ 1, 7 })
+    {
+        Schema::Version version = GENERATE(Schema::Version{ 1, 2 }, Schema::Version{ 1, 3 }, Schema::Version{ 1, 4 }, Schema::Version{ 1, 5 }, Schema::Version{ 1, 6 }, Schema::Version{ 1, 7 });
+
+        if (version != Schema::Version{ 1, 7 })
+        {
+            index.ForceVersion(version);
+            return version;
+        }
+    }
+    else if (index.GetVersion() == Schema::Version{ 1, 8 })
+    {
+        Schema::Version version = GENERATE(Schema::Version{ 1, 2 }, Schema::Version{ 1, 3 }, Schema::Version{ 1, 4 }, Schema::Version{ 1, 5 }, Schema::Version{ 1, 6 }, Schema::Version{ 1, 7 }, Schema::Version{ 1, 8 });
+
+        if (version != Schema::Version{ 1, 8 })
+        {
+            index.ForceVersion(version);
+            return version;
+        }
+    }
+    else if (index.GetVersion() == Schema::Version{ 1, 9 })
+    {
+        Schema::Version version = GENERATE(Schema::Version{ 1, 2 }, Schema::Version{ 1, 3 }, Schema::Version{ 1, 4 }, Schema::Version{ 1, 5 }, Schema::Version{ 1, 6 }, Schema::Version{ 1, 7 }, Schema::Version{ 1, 8 }, Schema::Version{ 1, 9 });
+
+        if (version != Schema::Version{ 1, 9 })
+        {
+            index.ForceVersion(version);
+            return version;
+        }
+    }
 
     return index.GetVersion();
 }
@@ -380,6 +436,67 @@ TEST_CASE("SQLiteIndexCreateAndAddManifestDuplicate", "[sqliteindex]")
     REQUIRE_THROWS_HR(index.AddManifest(manifest, relativePath), HRESULT_FROM_WIN32(ERROR_ALREADY_EXISTS));
 }
 
+TEST_CASE("SQLiteIndex_AddManifests", "[sqliteindex]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = CreateTestIndex(tempFile);
+
+    std::vector<std::pair<Manifest, std::filesystem::path>> manifests;
+    for (const auto& version : { "1.0.0", "2.0.0", "3.0.0" })
+    {
+        Manifest manifest;
+        CreateFakeManifest(manifest, "Test", version);
+        std::filesystem::path relativePath = GetPathFromManifest(manifest);
+        manifests.emplace_back(std::move(manifest), std::move(relativePath));
+    }
+
+    auto ids = index.AddManifests(manifests);
+    REQUIRE(ids.size() == manifests.size());
+
+    for (size_t i = 0; i < manifests.size(); ++i)
+    {
+        auto id = index.GetManifestIdByManifest(manifests[i].first);
+        REQUIRE(id);
+        REQUIRE(id.value() == ids[i]);
+    }
+
+    // A failure part way through leaves none of the new manifests in the index.
+    Manifest added;
+    CreateFakeManifest(added, "Other");
+    std::vector<std::pair<Manifest, std::filesystem::path>> failing{ { added, GetPathFromManifest(added) }, manifests[0] };
+
+    REQUIRE_THROWS_HR(index.AddManifests(failing), HRESULT_FROM_WIN32(ERROR_ALREADY_EXISTS));
+    REQUIRE(!index.GetManifestIdByManifest(added));
+    REQUIRE(index.CheckConsistency(true));
+}
+
+TEST_CASE("SQLiteIndex_AddManifestsFromFiles", "[sqliteindex]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = CreateTestIndex(tempFile);
+
+    TestDataFile manifestFile{ "Manifest-Good.yaml" };
+    std::filesystem::path manifestPath{ "microsoft/msixsdk/microsoft.msixsdk-1.7.32.yaml" };
+
+    // A manifest that cannot be parsed fails the whole set, even though the good one was parsed first.
+    std::vector<std::pair<std::filesystem::path, std::filesystem::path>> paths{
+        { manifestFile.GetPath(), manifestPath },
+        { manifestFile.GetPath().parent_path() / "DoesNotExist.yaml", "does/not/exist.yaml" },
+    };
+    size_t added = 0;
+    REQUIRE_THROWS(index.AddManifests(paths, [&](size_t count) { added = count; }));
+    REQUIRE(added == 1);
+
+    paths.pop_back();
+    auto ids = index.AddManifests(paths);
+    REQUIRE(ids.size() == 1);
+    REQUIRE(index.CheckConsistency(true));
+}
+
 TEST_CASE("SQLiteIndex_VersionReferencedByDependenciesClearsUnusedVersionAndKeepUsedVersion", "[sqliteindex][V1_4]")
 {
     TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
@@ -686,6 +803,40 @@ TEST_CASE("SQLiteIndex_ValidateManifestWithDependencies", "[sqliteindex][V1_4]")
     REQUIRE(PackageDependenciesValidation::ValidateManifestDependencies(&index, topLevelManifest));
 }
 
+TEST_CASE("SQLiteIndex_ValidateManifestDependenciesBatch", "[sqliteindex][V1_4]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    Manifest levelOneManifest, levelTwoManifest, topLevelManifest, missingNodeManifest, minVersionManifest;
+    SQLiteIndex index = SimpleTestSetup(tempFile, levelTwoManifest, Schema::Version::Latest());
+
+    constexpr std::string_view levelOneManifestPublisher = "LevelOneManifest";
+    CreateFakeManifest(levelOneManifest, levelOneManifestPublisher);
+    levelOneManifest.Installers[0].Dependencies.Add(Dependency(DependencyType::Package, levelTwoManifest.Id, "1.0.0"));
+    index.AddManifest(levelOneManifest, GetPathFromManifest(levelOneManifest));
+
+    // All of these depend on the same package, which is only looked up once.
+    CreateFakeManifest(topLevelManifest, "TopLevelManifest");
+    topLevelManifest.Installers[0].Dependencies.Add(Dependency(DependencyType::Package, levelOneManifest.Id, "1.0.0"));
+
+    CreateFakeManifest(missingNodeManifest, "MissingNodeManifest");
+    missingNodeManifest.Installers[0].Dependencies.Add(Dependency(DependencyType::Package, levelOneManifest.Id, "1.0.0"));
+    missingNodeManifest.Installers[0].Dependencies.Add(Dependency(DependencyType::Package, "Not.In.Index", "1.0.0"));
+
+    CreateFakeManifest(minVersionManifest, "MinVersionManifest");
+    minVersionManifest.Installers[0].Dependencies.Add(Dependency(DependencyType::Package, levelOneManifest.Id, "2.0.0"));
+
+    auto results = PackageDependenciesValidation::ValidateManifestDependencies(&index, { topLevelManifest, missingNodeManifest, minVersionManifest });
+
+    REQUIRE(results.size() == 3);
+    REQUIRE(results[0].empty());
+    REQUIRE(results[1].size() == 1);
+    REQUIRE(results[1][0].Message.find("Not.In.Index") != std::string::npos);
+    REQUIRE(results[2].size() == 1);
+    REQUIRE(results[2][0].Message.find(ManifestError::NoSuitableMinVersion) != std::string::npos);
+}
+
 TEST_CASE("SQLiteIndex_ValidateManifestWithDependenciesHasLoops", "[sqliteindex][V1_4]")
 {
     TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
@@ -1539,6 +1690,46 @@ TEST_CASE("SQLiteIndex_PrepareForPackaging", "[sqliteindex]")
     index.AddManifest(manifestFile, manifestPath);
 
     index.PrepareForPackaging();
+
+    {
+        Connection connection = Connection::Create(tempFile, Connection::OpenDisposition::ReadOnly);
+        REQUIRE(connection.GetPageSize() == 8192);
+
+        // The statistics for the query planner are published with the index.
+        Statement select = Statement::Create(connection, "SELECT count(*) FROM sqlite_stat1");
+        REQUIRE(select.Step());
+        REQUIRE(select.GetColumn<int>(0) > 0);
+    }
+}
+
+TEST_CASE("SQLiteIndex_PrepareForPackaging_BuildWriteMode", "[sqliteindex]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    TestDataFile manifestFile{ "Manifest-Good.yaml" };
+    std::filesystem::path manifestPath{ "microsoft/msixsdk/microsoft.msixsdk-1.7.32.yaml" };
+    std::filesystem::path walPath = tempFile.GetPath();
+    walPath += "-wal";
+
+    {
+        SQLiteIndex index = CreateTestIndex(tempFile);
+        index.SetWriteMode(SQLiteIndex::WriteMode::Build);
+
+        index.AddManifest(manifestFile, manifestPath);
+        REQUIRE(std::filesystem::exists(walPath));
+
+        index.PrepareForPackaging();
+        REQUIRE_FALSE(std::filesystem::exists(walPath));
+    }
+
+    // The published file does not use a write ahead log, so it can be read as immutable.
+    SQLiteIndex index = SQLiteIndex::Open(tempFile, SQLiteIndex::OpenDisposition::Immutable);
+
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Exact, "microsoft.msixsdk");
+
+    REQUIRE(index.Search(request).Matches.size() == 1);
 }
 
 TEST_CASE("SQLiteIndex_Search_IdExactMatch", "[sqliteindex]")
@@ -1878,6 +2069,176 @@ TEST_CASE("SQLiteIndex_SearchResultsTableSearches", "[sqliteindex][V1_0]")
             search.SearchOnField(filter);
         }
     }
+
+    // The searches are held until now, and run as one statement
+    (void)search.GetSearchResults();
+}
+
+TEST_CASE("SQLiteIndex_SearchResultsTable_DirectMatchesTable", "[sqliteindex][V1_0]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    {
+        (void)SearchTestSetup(tempFile, {
+            { "Id1", "Name1", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path1" },
+            { "Id2", "Name2", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path2" },
+            { "Other", "Name", "Id", "Version", "Channel", { "Tag" }, { "Command" }, "Path3" },
+            { "Unrelated", "Unrelated", "Unrelated", "Version", "Channel", { "Tag" }, { "Command" }, "Path4" },
+            }, Schema::Version{ 1, 0 });
+    }
+
+    Connection connection = Connection::Create(tempFile, Connection::OpenDisposition::ReadOnly);
+
+    auto performSearches = [](Schema::V1_0::SearchResultsTable& search)
+    {
+        search.SearchOnField({ PackageMatchField::Id, MatchType::CaseInsensitive, "id1"s });
+        search.SearchOnField({ PackageMatchField::Moniker, MatchType::Substring, "id"s });
+        search.SearchOnField({ PackageMatchField::Id, MatchType::Substring, "id"s });
+        search.SearchOnField({ PackageMatchField::Name, MatchType::Substring, "name"s });
+        search.RemoveDuplicateManifestRows();
+    };
+
+    // Without a filter, the results are read directly from the searches.
+    Schema::V1_0::SearchResultsTable direct(connection);
+    performSearches(direct);
+    auto directResults = direct.GetSearchResults();
+
+    // A filter that keeps every result requires the table.
+    Schema::V1_0::SearchResultsTable table(connection);
+    performSearches(table);
+    table.PrepareToFilter();
+    table.FilterOnField({ PackageMatchField::Tag, MatchType::Exact, "Tag"s });
+    table.CompleteFilter();
+    auto tableResults = table.GetSearchResults();
+
+    REQUIRE(directResults.Matches.size() == 3);
+    REQUIRE(directResults.Matches.size() == tableResults.Matches.size());
+
+    for (size_t i = 0; i < directResults.Matches.size(); ++i)
+    {
+        REQUIRE(directResults.Matches[i].first == tableResults.Matches[i].first);
+        REQUIRE(directResults.Matches[i].second.Field == tableResults.Matches[i].second.Field);
+        REQUIRE(directResults.Matches[i].second.Type == tableResults.Matches[i].second.Type);
+        REQUIRE(directResults.Matches[i].second.Value == tableResults.Matches[i].second.Value);
+    }
+
+    REQUIRE(directResults.Matches[0].second.Type == MatchType::CaseInsensitive);
+    REQUIRE(directResults.Matches[1].second.Field == PackageMatchField::Moniker);
+    REQUIRE(directResults.Matches[2].second.Field == PackageMatchField::Id);
+}
+
+TEST_CASE("SQLiteIndex_SearchCursor", "[sqliteindex]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = SearchTestSetup(tempFile, {
+        { "Id1", "Name1", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path1" },
+        { "Id2", "Name2", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path2" },
+        { "Id3", "Name3", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path3" },
+        { "Id4", "Name4", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path4" },
+        { "Id5", "Name5", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path5" },
+        });
+
+    auto readInPages = [&](const SearchRequest& request)
+    {
+        auto cursor = index.OpenSearch(request);
+        std::vector<SQLiteIndex::IdType> ids;
+
+        auto page = cursor.GetNext(2);
+        REQUIRE(page.Matches.size() == 2);
+        REQUIRE(page.Truncated);
+        for (const auto& match : page.Matches) { ids.emplace_back(match.first); }
+
+        page = cursor.GetNext(2);
+        REQUIRE(page.Matches.size() == 2);
+        REQUIRE(page.Truncated);
+        for (const auto& match : page.Matches) { ids.emplace_back(match.first); }
+
+        page = cursor.GetNext(2);
+        REQUIRE(page.Matches.size() == 1);
+        REQUIRE(!page.Truncated);
+        for (const auto& match : page.Matches) { ids.emplace_back(match.first); }
+
+        page = cursor.GetNext(2);
+        REQUIRE(page.Matches.empty());
+        REQUIRE(!page.Truncated);
+
+        auto results = index.Search(request);
+        REQUIRE(results.Matches.size() == ids.size());
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            REQUIRE(results.Matches[i].first == ids[i]);
+        }
+    };
+
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Substring, "id");
+    readInPages(request);
+
+    readInPages({});
+}
+
+TEST_CASE("SQLiteIndex_SearchCursor_MaximumResults", "[sqliteindex]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = SearchTestSetup(tempFile, {
+        { "Id1", "Name1", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path1" },
+        { "Id2", "Name2", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path2" },
+        { "Id3", "Name3", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path3" },
+        { "Id4", "Name4", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path4" },
+        });
+
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Substring, "id");
+    request.MaximumResults = 3;
+
+    // The cursor stops at the maximum, and reports that there were more
+    auto cursor = index.OpenSearch(request);
+
+    auto page = cursor.GetNext(2);
+    REQUIRE(page.Matches.size() == 2);
+    REQUIRE(page.Truncated);
+
+    page = cursor.GetNext(2);
+    REQUIRE(page.Matches.size() == 1);
+    REQUIRE(page.Truncated);
+
+    page = cursor.GetNext(2);
+    REQUIRE(page.Matches.empty());
+    REQUIRE(page.Truncated);
+
+    auto results = index.Search(request);
+    REQUIRE(results.Matches.size() == 3);
+    REQUIRE(results.Truncated);
+}
+
+TEST_CASE("SQLiteIndex_SearchCursor_UpdatesRequest", "[sqliteindex]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = SearchTestSetup(tempFile, {
+        { "Id1", "Name1", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path1", { "PFN1" }, { "PC1" } },
+        { "Id2", "Name2", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path2", { "PFN2" }, { "PC2" } },
+        });
+
+    Schema::Version testVersion = TestPrepareForRead(index);
+
+    // The cursor goes through the same version specific changes to the request as Search, such as folding product codes
+    SearchRequest request;
+    request.Inclusions.emplace_back(PackageMatchField::ProductCode, MatchType::Exact, "pc2");
+
+    auto page = index.OpenSearch(request).GetNext(0);
+    REQUIRE(page.Matches.size() == index.Search(request).Matches.size());
+
+    if (ArePackageFamilyNameAndProductCodeSupported(index, testVersion))
+    {
+        REQUIRE(page.Matches.size() == 1);
+    }
 }
 
 TEST_CASE("SQLiteIndex_Search_EmptySearch", "[sqliteindex]")
@@ -2192,6 +2553,36 @@ TEST_CASE("SQLiteIndex_Search_InclusionOnly", "[sqliteindex]")
     REQUIRE(results.Matches.size() == 2);
 }
 
+TEST_CASE("SQLiteIndex_Search_InclusionsRankedByMatchType", "[sqliteindex]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = SearchTestSetup(tempFile, {
+        { "Nope", "Name", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path1" },
+        { "Id2", "Na", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path2" },
+        { "Id3", "No", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path3" },
+        });
+
+    TestPrepareForRead(index);
+
+    SearchRequest request;
+    request.Inclusions.emplace_back(PackageMatchField::Name, MatchType::Substring, "N");
+    request.Inclusions.emplace_back(PackageMatchField::Id, MatchType::Exact, "Id3");
+
+    auto results = index.Search(request);
+    REQUIRE(results.Matches.size() == 3);
+    REQUIRE(GetIdStringById(index, results.Matches[0].first) == "Id3");
+    REQUIRE(results.Matches[0].second.Type == MatchType::Exact);
+
+    request.MaximumResults = 1;
+
+    results = index.Search(request);
+    REQUIRE(results.Matches.size() == 1);
+    REQUIRE(results.Truncated);
+    REQUIRE(GetIdStringById(index, results.Matches[0].first) == "Id3");
+}
+
 TEST_CASE("SQLiteIndex_Search_InclusionAndFilter", "[sqliteindex]")
 {
     TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
@@ -2546,6 +2937,46 @@ TEST_CASE("SQLiteIndex_CheckConsistency_Failure", "[sqliteindex][V1_1]")
     }
 }
 
+TEST_CASE("SQLiteIndex_GetPropertiesByManifestIds", "[sqliteindex]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = SearchTestSetup(tempFile, {
+        { "Id1", "Name1", "Moniker", "1.0", "", { "Tag" }, { "Command" }, "Path1" },
+        { "Id2", "Name2", "Moniker", "2.0", "Beta", { "Tag" }, { "Command" }, "Path2" },
+        { "Id3", "Name3", "Moniker", "3.0", "", { "Tag" }, { "Command" }, "Path3" },
+        });
+
+    TestPrepareForRead(index);
+
+    SearchRequest request;
+    auto results = index.Search(request);
+    REQUIRE(results.Matches.size() == 3);
+
+    std::vector<SQLiteIndex::IdType> manifestIds;
+    for (const auto& match : results.Matches)
+    {
+        manifestIds.emplace_back(index.GetManifestIdByKey(match.first, "", "").value());
+    }
+
+    // An id that does not refer to a manifest is not included.
+    manifestIds.emplace_back(0xFFFFFFFF);
+
+    auto properties = index.GetPropertiesByManifestIds(manifestIds);
+    REQUIRE(properties.size() == 3);
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        const auto& manifestProperties = properties.at(manifestIds[i]);
+
+        for (auto property : { PackageVersionProperty::Id, PackageVersionProperty::Name, PackageVersionProperty::Version, PackageVersionProperty::Channel })
+        {
+            REQUIRE(manifestProperties.at(property) == index.GetPropertyByManifestId(manifestIds[i], property).value());
+        }
+    }
+}
+
 TEST_CASE("SQLiteIndex_GetMultiProperty_PackageFamilyName", "[sqliteindex]")
 {
     TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
@@ -2606,32 +3037,78 @@ TEST_CASE("SQLiteIndex_GetMultiProperty_ProductCode", "[sqliteindex]")
     }
 }
 
-TEST_CASE("SQLiteIndex_ManifestMetadata", "[sqliteindex]")
+TEST_CASE("SQLiteIndex_GetMultiPropertyById", "[sqliteindex]")
 {
     TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
     INFO("Using temporary file named: " << tempFile.GetPath());
 
     SQLiteIndex index = SearchTestSetup(tempFile, {
-        { "Id1", "Name1", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path1", {}, { "PC1", "PC2" } },
-        { "Id2", "Name2", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path2", { "PFN1", "PFN2" }, {} },
+        { "Id1", "Name1", "Moniker", "1.0", "", { "Tag" }, { "Command" }, "Path1", { "PFN1" }, { "PC1" } },
+        { "Id1", "Name1", "Moniker", "2.0", "", { "Tag" }, { "Command" }, "Path2", { "PFN2", "PFN3" }, {} },
+        { "Id2", "Name2", "Moniker", "1.0", "", { "Tag" }, { "Command" }, "Path3", { "PFN4" }, { "PC4" } },
         });
 
     Schema::Version testVersion = TestPrepareForRead(index);
 
     SearchRequest request;
+    request.Filters.emplace_back(PackageMatchField::Id, MatchType::Exact, "Id1");
 
     auto results = index.Search(request);
-    REQUIRE(results.Matches.size() == 2);
+    REQUIRE(results.Matches.size() == 1);
 
-    for (const auto [id, match] : results.Matches)
+    SQLiteIndex::IdType id = results.Matches[0].first;
+    auto props = index.GetMultiPropertyById(id, PackageVersionMultiProperty::PackageFamilyName);
+
+    if (ArePackageFamilyNameAndProductCodeSupported(index, testVersion))
     {
-        REQUIRE(index.GetMetadataByManifestId(id).empty());
-    }
+        // The values must match those from the per manifest lookup for every version.
+        size_t expectedCount = 0;
+        for (const auto& key : index.GetVersionKeysById(id))
+        {
+            SQLiteIndex::IdType manifestId = index.GetManifestIdByKey(id, key.GetVersion().ToString(), key.GetChannel().ToString()).value();
+            for (const auto& value : index.GetMultiPropertyByManifestId(manifestId, PackageVersionMultiProperty::PackageFamilyName))
+            {
+                REQUIRE(std::find(props.begin(), props.end(), std::make_pair(manifestId, value)) != props.end());
+                ++expectedCount;
+            }
+        }
 
-    auto manifestId1 = results.Matches[0].first;
-    auto manifestId2 = results.Matches[1].first;
+        REQUIRE(expectedCount == 3);
+        REQUIRE(props.size() == expectedCount);
+        REQUIRE(index.GetMultiPropertyById(id, PackageVersionMultiProperty::ProductCode).size() == 1);
+    }
+    else
+    {
+        REQUIRE(props.empty());
+    }
+}
 
-    std::string metadataValue = "data about data";
+TEST_CASE("SQLiteIndex_ManifestMetadata", "[sqliteindex]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = SearchTestSetup(tempFile, {
+        { "Id1", "Name1", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path1", {}, { "PC1", "PC2" } },
+        { "Id2", "Name2", "Moniker", "Version", "Channel", { "Tag" }, { "Command" }, "Path2", { "PFN1", "PFN2" }, {} },
+        });
+
+    Schema::Version testVersion = TestPrepareForRead(index);
+
+    SearchRequest request;
+
+    auto results = index.Search(request);
+    REQUIRE(results.Matches.size() == 2);
+
+    for (const auto [id, match] : results.Matches)
+    {
+        REQUIRE(index.GetMetadataByManifestId(id).empty());
+    }
+
+    auto manifestId1 = results.Matches[0].first;
+    auto manifestId2 = results.Matches[1].first;
+
+    std::string metadataValue = "data about data";
 
     index.SetMetadataByManifestId(manifestId1, PackageVersionMetadata::InstalledType, metadataValue);
 
@@ -2795,3 +3272,763 @@ TEST_CASE("SQLiteIndex_ManifestHash_Missing", "[sqliteindex]")
 
     REQUIRE(!hashResult);
 }
+
+namespace
+{
+    Manifest CreateTrigramTestManifest(std::string id, std::string name, std::string moniker, std::vector<string_t> tags, std::vector<string_t> commands)
+    {
+        Manifest manifest;
+        manifest.Installers.push_back({});
+        manifest.Id = std::move(id);
+        manifest.DefaultLocalization.Add<Localization::PackageName>(std::move(name));
+        manifest.Moniker = std::move(moniker);
+        manifest.Version = "1.0.0";
+        manifest.DefaultLocalization.Add<Localization::Tags>(std::move(tags));
+        manifest.Installers[0].Commands = std::move(commands);
+        return manifest;
+    }
+
+    std::set<SQLite::rowid_t> SearchForSubstring(const SQLiteIndex& index, std::string_view value, MatchType type = MatchType::Substring)
+    {
+        SearchRequest request;
+        request.Query = RequestMatch(type, value);
+
+        std::set<SQLite::rowid_t> result;
+        for (const auto& match : index.Search(request).Matches)
+        {
+            result.emplace(match.first);
+        }
+
+        return result;
+    }
+}
+
+TEST_CASE("SQLiteIndex_TrigramSearch", "[sqliteindex][V1_5]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = CreateTestIndex(tempFile, Schema::Version{ 1, 5 });
+
+    index.AddManifest(CreateTrigramTestManifest("Contoso.WidgetMaker", "Widget Maker", "wm", { "gadget", "tool" }, { "widg" }), "path1");
+    index.AddManifest(CreateTrigramTestManifest("Fabrikam.Gizmo", "Gizmo Studio", "gizmo", { "widgets" }, { "gz" }), "path2");
+    index.AddManifest(CreateTrigramTestManifest("Other.Thing", u8"Thing \u00C6sir", "thing", { "100%" }, { "th" }), "path3");
+
+    std::vector<std::pair<std::string_view, MatchType>> queries{
+        { "widget", MatchType::Substring },
+        { "WIDGET", MatchType::Substring },
+        { "gizmo studio", MatchType::Substring },
+        { "zzz", MatchType::Substring },
+        { "wm", MatchType::Substring },
+        { "0%", MatchType::Substring },
+        { "00%", MatchType::Substring },
+        { u8"\u00E6sir", MatchType::Substring },
+        { "fabri", MatchType::StartsWith },
+        { "abri", MatchType::StartsWith },
+    };
+
+    std::vector<std::set<SQLite::rowid_t>> expected;
+    for (const auto& query : queries)
+    {
+        expected.emplace_back(SearchForSubstring(index, query.first, query.second));
+    }
+
+    REQUIRE(expected[0].size() == 2);
+    REQUIRE(expected[3].empty());
+
+    index.PrepareForPackaging();
+
+    {
+        Connection connection = Connection::Create(tempFile, Connection::OpenDisposition::ReadOnly);
+        REQUIRE(Schema::V1_5::TrigramTable::IsPopulated(connection));
+    }
+
+    REQUIRE(index.CheckConsistency(true));
+
+    // The same results should come back through the trigrams as from the full scan.
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        INFO(queries[i].first);
+        REQUIRE(SearchForSubstring(index, queries[i].first, queries[i].second) == expected[i]);
+    }
+
+    // Changing the index after packaging drops the trigrams, rather than leaving them out of date.
+    index.AddManifest(CreateTrigramTestManifest("Another.Widget", "Another", "another", {}, {}), "path4");
+
+    {
+        Connection connection = Connection::Create(tempFile, Connection::OpenDisposition::ReadOnly);
+        REQUIRE(!Schema::V1_5::TrigramTable::IsPopulated(connection));
+    }
+
+    REQUIRE(SearchForSubstring(index, "widget").size() == 3);
+}
+
+TEST_CASE("TrigramTable_GetQueryTrigrams", "[sqliteindex][V1_5]")
+{
+    REQUIRE(Schema::V1_5::TrigramTable::GetQueryTrigrams("ab").empty());
+    REQUIRE(Schema::V1_5::TrigramTable::GetQueryTrigrams(u8"\u00E6sir").empty());
+    REQUIRE(Schema::V1_5::TrigramTable::GetQueryTrigrams("ABCD") == std::vector<std::string>{ "abc", "bcd" });
+    REQUIRE(Schema::V1_5::TrigramTable::GetQueryTrigrams("aaaa") == std::vector<std::string>{ "aaa" });
+
+    auto trigrams = Schema::V1_5::TrigramTable::GetQueryTrigrams("abcdefghijklmnop");
+    REQUIRE(trigrams.size() == 8);
+    REQUIRE(trigrams.front() == "abc");
+    REQUIRE(trigrams.back() == "nop");
+}
+
+TEST_CASE("SQLiteIndex_FuzzySearch", "[sqliteindex][V1_5]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = CreateTestIndex(tempFile, Schema::Version{ 1, 5 });
+
+    index.AddManifest(CreateTrigramTestManifest("Contoso.WidgetMaker", "Widget Maker", "widgetmaker", {}, {}), "path1");
+    index.AddManifest(CreateTrigramTestManifest("Contoso.WidgetMakers", "Widget Makers", "widgetmakers", {}, {}), "path2");
+    index.AddManifest(CreateTrigramTestManifest("Contoso.WidgetTool", "Widget Tool", "widgettool", {}, {}), "path3");
+    index.AddManifest(CreateTrigramTestManifest("Fabrikam.Studio", "Visual Studio Code", "vscode", {}, {}), "path4");
+
+    // Fuzzy matching needs the trigram table, so nothing is found before packaging.
+    REQUIRE(SearchForSubstring(index, "Widget Makr", MatchType::Fuzzy).empty());
+
+    index.PrepareForPackaging();
+
+    SECTION("Ranked by distance")
+    {
+        SearchRequest request;
+        request.Query = RequestMatch(MatchType::Fuzzy, "widget MAKR");
+
+        auto results = index.Search(request);
+        REQUIRE(results.Matches.size() == 2);
+        REQUIRE(results.Matches[0].second.Value == "Widget Maker");
+        REQUIRE(results.Matches[0].second.Type == MatchType::Fuzzy);
+        REQUIRE(results.Matches[1].second.Value == "Widget Makers");
+    }
+    SECTION("Moniker")
+    {
+        REQUIRE(SearchForSubstring(index, "vscod", MatchType::Fuzzy).size() == 1);
+    }
+    SECTION("Substring")
+    {
+        REQUIRE(SearchForSubstring(index, "stdio", MatchType::FuzzySubstring).size() == 1);
+        REQUIRE(SearchForSubstring(index, "stdio", MatchType::Fuzzy).empty());
+        REQUIRE(SearchForSubstring(index, "widgt", MatchType::FuzzySubstring).size() == 3);
+    }
+    SECTION("Filter")
+    {
+        SearchRequest request;
+        request.Query = RequestMatch(MatchType::Substring, "widget");
+        request.Filters.emplace_back(PackageMatchField::Name, MatchType::Fuzzy, "Widget Makr");
+
+        REQUIRE(index.Search(request).Matches.size() == 2);
+    }
+    SECTION("Exact then fuzzy inclusions")
+    {
+        // The exact search is held to run with the others; it must not be run against the fuzzy value rows.
+        SearchRequest request;
+        request.Inclusions.emplace_back(PackageMatchField::Id, MatchType::Exact, "Fabrikam.Studio");
+        request.Inclusions.emplace_back(PackageMatchField::Name, MatchType::Fuzzy, "Widget Makr");
+
+        auto results = index.Search(request);
+        REQUIRE(results.Matches.size() == 3);
+        REQUIRE(results.Matches[0].second.Field == PackageMatchField::Id);
+        REQUIRE(results.Matches[0].second.Value == "Fabrikam.Studio");
+        REQUIRE(results.Matches[1].second.Value == "Widget Maker");
+        REQUIRE(results.Matches[2].second.Value == "Widget Makers");
+    }
+    SECTION("Exact then fuzzy filters")
+    {
+        SearchRequest request;
+        request.Query = RequestMatch(MatchType::Substring, "widget");
+        request.Filters.emplace_back(PackageMatchField::Id, MatchType::Exact, "Contoso.WidgetMakers");
+        request.Filters.emplace_back(PackageMatchField::Name, MatchType::Fuzzy, "Widget Makr");
+
+        REQUIRE(index.Search(request).Matches.size() == 1);
+    }
+}
+
+TEST_CASE("SQLiteIndex_FuzzyMaximumDistance", "[sqliteindex][V1_5]")
+{
+    REQUIRE(Schema::V1_5::SearchResultsTable::GetFuzzyMaximumDistance("abc") == 0);
+    REQUIRE(Schema::V1_5::SearchResultsTable::GetFuzzyMaximumDistance("abcd") == 1);
+    REQUIRE(Schema::V1_5::SearchResultsTable::GetFuzzyMaximumDistance("abcdefgh") == 2);
+    REQUIRE(Schema::V1_5::SearchResultsTable::GetFuzzyMaximumDistance("abcdefghijklmnopqrstuvwxyz") == 3);
+}
+
+// This skipped test case compares substring search latency on a packaged index between 1.4,
+// which scans every value with LIKE, and 1.5, which narrows the values through the trigram table.
+TEST_CASE("SQLiteIndex_Benchmark_TrigramSearch", "[.]")
+{
+    auto measure = [](Schema::Version version)
+    {
+        TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+        SQLiteIndex index = CreateTestIndex(tempFile, version);
+
+        std::vector<std::pair<Manifest, std::filesystem::path>> manifests;
+        for (size_t i = 0; i < 20000; ++i)
+        {
+            Manifest manifest;
+            CreateFakeManifest(manifest, "Publisher" + std::to_string(i));
+            std::filesystem::path relativePath = GetPathFromManifest(manifest);
+            manifests.emplace_back(std::move(manifest), std::move(relativePath));
+        }
+
+        index.AddManifests(manifests);
+        index.PrepareForPackaging();
+
+        for (std::string_view query : { "publisher1234", "sher19", "idnotfound" })
+        {
+            auto start = std::chrono::steady_clock::now();
+            auto results = SearchForSubstring(index, query);
+            auto end = std::chrono::steady_clock::now();
+
+            WARN(version << " [" << query << "]: " << results.size() << " results in " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << "us");
+        }
+    };
+
+    measure(Schema::Version{ 1, 4 });
+    measure(Schema::Version{ 1, 5 });
+}
+
+// This skipped test case compares the latency of the first and second search after opening a packaged index,
+// between the standard read path and the memory mapped immutable open. Each open is a new connection, so its
+// page cache starts out cold; the OS file cache is warm after the first open though, as it cannot be cleared here.
+TEST_CASE("SQLiteIndex_Benchmark_ImmutableOpen", "[.]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    {
+        SQLiteIndex index = CreateTestIndex(tempFile, Schema::Version::Latest());
+
+        std::vector<std::pair<Manifest, std::filesystem::path>> manifests;
+        for (size_t i = 0; i < 10000; ++i)
+        {
+            Manifest manifest;
+            CreateFakeManifest(manifest, "Publisher" + std::to_string(i));
+            std::filesystem::path relativePath = GetPathFromManifest(manifest);
+            manifests.emplace_back(std::move(manifest), std::move(relativePath));
+        }
+
+        index.AddManifests(manifests);
+        index.PrepareForPackaging();
+    }
+
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Substring, "Publisher123");
+
+    auto measure = [&](SQLiteIndex::OpenDisposition disposition, std::string_view name)
+    {
+        auto start = std::chrono::steady_clock::now();
+        SQLiteIndex index = SQLiteIndex::Open(tempFile, disposition);
+        auto firstResults = index.Search(request);
+        auto first = std::chrono::steady_clock::now();
+        auto secondResults = index.Search(request);
+        auto second = std::chrono::steady_clock::now();
+
+        REQUIRE(firstResults.Matches.size() == secondResults.Matches.size());
+
+        WARN(name << ": open and first search " << std::chrono::duration_cast<std::chrono::microseconds>(first - start).count() <<
+            "us, second search " << std::chrono::duration_cast<std::chrono::microseconds>(second - first).count() << "us");
+    };
+
+    for (int i = 0; i < 3; ++i)
+    {
+        measure(SQLiteIndex::OpenDisposition::Read, "Read");
+        measure(SQLiteIndex::OpenDisposition::Immutable, "Immutable (memory mapped)");
+    }
+}
+
+TEST_CASE("SQLiteIndex_LatestManifestTable", "[sqliteindex][V1_6]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = SearchTestSetup(tempFile, {
+        { "Id1", "Name", "Moniker", "1.0", "", {}, {}, "Path1" },
+        { "Id1", "Name", "Moniker", "1.10", "", {}, {}, "Path2" },
+        { "Id1", "Name", "Moniker", "1.9", "", {}, {}, "Path3" },
+        { "Id2", "Name", "Moniker", "2.0", "", {}, {}, "Path4" },
+        { "Id2", "Name", "Moniker", "3.0", "beta", {}, {}, "Path5" },
+        }, Schema::Version{ 1, 6 });
+
+    SearchRequest request;
+    auto results = index.Search(request);
+    REQUIRE(results.Matches.size() == 2);
+
+    std::vector<std::optional<SQLiteIndex::IdType>> expected;
+    for (const auto& match : results.Matches)
+    {
+        expected.emplace_back(index.GetManifestIdByKey(match.first, "", ""));
+    }
+
+    REQUIRE(GetPropertyStringByKey(index, results.Matches[0].first, PackageVersionProperty::Version, "", "") == "1.10");
+    REQUIRE(GetPropertyStringByKey(index, results.Matches[1].first, PackageVersionProperty::Version, "", "") == "2.0");
+
+    index.PrepareForPackaging();
+
+    {
+        Connection connection = Connection::Create(tempFile, Connection::OpenDisposition::ReadOnly);
+        REQUIRE(Schema::V1_6::LatestManifestTable::IsPopulated(connection));
+        REQUIRE(Schema::V1_6::LatestManifestTable::GetManifestId(connection, results.Matches[0].first) == expected[0]);
+    }
+
+    REQUIRE(index.CheckConsistency(true));
+
+    // The table gives the same answer as sorting the versions.
+    for (size_t i = 0; i < results.Matches.size(); ++i)
+    {
+        REQUIRE(index.GetManifestIdByKey(results.Matches[i].first, "", "") == expected[i]);
+    }
+
+    // Lookups of a specific version or channel do not use the table.
+    REQUIRE(GetPropertyStringByKey(index, results.Matches[1].first, PackageVersionProperty::Version, "", "beta") == "3.0");
+
+    // Changing the index after packaging drops the latest manifests, rather than leaving them out of date.
+    Manifest manifest;
+    manifest.Id = "Id1";
+    manifest.DefaultLocalization.Add<Localization::PackageName>("Name");
+    manifest.Moniker = "Moniker";
+    manifest.Version = "1.11";
+    manifest.Installers.push_back({});
+    index.AddManifest(manifest, "Path6");
+
+    {
+        Connection connection = Connection::Create(tempFile, Connection::OpenDisposition::ReadOnly);
+        REQUIRE(!Schema::V1_6::LatestManifestTable::IsPopulated(connection));
+    }
+
+    REQUIRE(GetPropertyStringByKey(index, results.Matches[0].first, PackageVersionProperty::Version, "", "") == "1.11");
+}
+
+TEST_CASE("SQLiteIndex_GetLatestManifestIdsByIds", "[sqliteindex][V1_6]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = SearchTestSetup(tempFile, {
+        { "Id1", "Name", "Moniker", "1.0", "", {}, {}, "Path1" },
+        { "Id1", "Name", "Moniker", "1.10", "", {}, {}, "Path2" },
+        { "Id2", "Name", "Moniker", "2.0", "", {}, {}, "Path3" },
+        { "Id2", "Name", "Moniker", "3.0", "beta", {}, {}, "Path4" },
+        { "Id3", "Name", "Moniker", "1.0", "", {}, {}, "Path5" },
+        }, Schema::Version{ 1, 6 });
+
+    SECTION("Without latest manifests")
+    {
+    }
+    SECTION("With latest manifests")
+    {
+        index.PrepareForPackaging();
+    }
+
+    SearchRequest request;
+    auto results = index.Search(request);
+    REQUIRE(results.Matches.size() == 3);
+
+    std::vector<SQLiteIndex::IdType> ids;
+    for (const auto& match : results.Matches)
+    {
+        ids.emplace_back(match.first);
+    }
+
+    // An id that does not exist is not included.
+    ids.emplace_back(0xFFFFFFFF);
+
+    auto latestManifestIds = index.GetLatestManifestIdsByIds(ids);
+    REQUIRE(latestManifestIds.size() == 3);
+
+    for (const auto& match : results.Matches)
+    {
+        REQUIRE(latestManifestIds.at(match.first) == index.GetManifestIdByKey(match.first, "", "").value());
+    }
+}
+
+TEST_CASE("SQLiteIndex_ManifestContent", "[sqliteindex][V1_6]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = SearchTestSetup(tempFile, {
+        { "Id1", "Name", "Moniker", "1.0", "", {}, {}, "Path1" },
+        { "Id2", "Name", "Moniker", "2.0", "", {}, {}, "Path2" },
+        }, Schema::Version{ 1, 6 });
+
+    SearchRequest request;
+    auto results = index.Search(request);
+    REQUIRE(results.Matches.size() == 2);
+
+    SQLiteIndex::IdType manifestId1 = index.GetManifestIdByKey(results.Matches[0].first, "", "").value();
+    SQLiteIndex::IdType manifestId2 = index.GetManifestIdByKey(results.Matches[1].first, "", "").value();
+
+    // No content is embedded until it is set.
+    REQUIRE(!index.GetManifestContentByManifestId(manifestId1));
+
+    std::string content = "PackageIdentifier: Id1\nPackageVersion: 1.0\nPackageName: Name\nManifestType: singleton\nManifestVersion: 1.0.0\n";
+    index.SetManifestContentByManifestId(manifestId1, content);
+
+    auto embedded = index.GetManifestContentByManifestId(manifestId1);
+    REQUIRE(embedded);
+    REQUIRE(embedded.value() == content);
+    REQUIRE(!index.GetManifestContentByManifestId(manifestId2));
+
+    // Setting the content again replaces it.
+    index.SetManifestContentByManifestId(manifestId1, "");
+    REQUIRE(index.GetManifestContentByManifestId(manifestId1) == std::string{});
+
+    // Removing the manifest removes its content.
+    index.SetManifestContentByManifestId(manifestId2, content);
+    index.RemoveManifestById(manifestId2);
+    REQUIRE(!index.GetManifestContentByManifestId(manifestId2));
+}
+
+TEST_CASE("SQLiteIndex_RelativePathColumn", "[sqliteindex][V1_7]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = SearchTestSetup(tempFile, {
+        { "Id1", "Name", "Moniker", "1.0", "", {}, {}, "manifests/i/Id1/1.0/Id1.yaml" },
+        { "Id2", "Name", "Moniker", "2.0", "", {}, {}, "manifests/i/Id2/2.0/Id2.yaml" },
+        }, Schema::Version{ 1, 7 });
+
+    SearchRequest request;
+    auto results = index.Search(request);
+    REQUIRE(results.Matches.size() == 2);
+
+    // Older versions read the same paths from the path parts, so the index remains readable by them.
+    Schema::Version testVersion = TestPrepareForRead(index);
+    INFO("Reading as version " << testVersion);
+
+    REQUIRE(GetPropertyStringByKey(index, results.Matches[0].first, PackageVersionProperty::RelativePath, "", "") == "manifests/i/Id1/1.0/Id1.yaml");
+    REQUIRE(GetPropertyStringByKey(index, results.Matches[1].first, PackageVersionProperty::RelativePath, "", "") == "manifests/i/Id2/2.0/Id2.yaml");
+
+    // Moving the manifest updates the path stored with it.
+    Manifest manifest;
+    manifest.Id = "Id1";
+    manifest.DefaultLocalization.Add<Localization::PackageName>("Name");
+    manifest.Moniker = "Moniker";
+    manifest.Version = "1.0";
+    manifest.Installers.push_back({});
+    REQUIRE(index.UpdateManifest(manifest, "manifests/i/Id1/1.0/Moved.yaml"));
+
+    REQUIRE(GetPropertyStringByKey(index, results.Matches[0].first, PackageVersionProperty::RelativePath, "", "") == "manifests/i/Id1/1.0/Moved.yaml");
+}
+
+TEST_CASE("SQLiteIndex_IndexSnapshot", "[sqliteindex]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    {
+        SQLiteIndex index = SearchTestSetup(tempFile, {
+            { "Id.One", "Name", "Moniker", "1.0", "", {}, {}, "path/1" },
+            { "Id.One", "Name", "Moniker", "2.0", "", {}, {}, "path/2" },
+            { "id.one.lower", "Other Name", "moniker", "1.0", "", {}, {}, "path/3" },
+            { "Id.Two", "Stra\xC3\x9F" "e", "", "1.0", "", {}, {}, "path/4" },
+            { "Different", "NAME", "Mon", "1.0", "", {}, {}, "path/5" },
+            });
+    }
+
+    SQLiteIndex expectedIndex = SQLiteIndex::Open(tempFile, SQLiteIndex::OpenDisposition::Read);
+    SQLiteIndex index = SQLiteIndex::Open(tempFile, SQLiteIndex::OpenDisposition::Immutable);
+
+    std::vector<SearchRequest> requests;
+    auto addRequest = [&](std::vector<PackageMatchFilter> inclusions, std::vector<PackageMatchFilter> filters, size_t maximumResults = 0)
+    {
+        SearchRequest request;
+        request.Inclusions = std::move(inclusions);
+        request.Filters = std::move(filters);
+        request.MaximumResults = maximumResults;
+        requests.emplace_back(std::move(request));
+    };
+
+    addRequest({ PackageMatchFilter(PackageMatchField::Id, MatchType::Exact, "Id.One") }, {});
+    addRequest({ PackageMatchFilter(PackageMatchField::Id, MatchType::CaseInsensitive, "ID.ONE") }, {});
+    addRequest({ PackageMatchFilter(PackageMatchField::Id, MatchType::StartsWith, "id.") }, {});
+    addRequest({ PackageMatchFilter(PackageMatchField::Id, MatchType::StartsWith, "id.") }, {}, 2);
+    addRequest({ PackageMatchFilter(PackageMatchField::Name, MatchType::CaseInsensitive, "name") }, {});
+    addRequest({ PackageMatchFilter(PackageMatchField::Name, MatchType::CaseInsensitive, "STRA\xC3\x9F" "E") }, {});
+    addRequest({ PackageMatchFilter(PackageMatchField::Name, MatchType::StartsWith, "strass") }, {});
+    addRequest({ PackageMatchFilter(PackageMatchField::Moniker, MatchType::StartsWith, "mon") }, {});
+    addRequest({
+        PackageMatchFilter(PackageMatchField::Moniker, MatchType::Exact, "Mon"),
+        PackageMatchFilter(PackageMatchField::Name, MatchType::StartsWith, "Other"),
+        PackageMatchFilter(PackageMatchField::Id, MatchType::StartsWith, "ID"),
+        }, {});
+    addRequest({}, { PackageMatchFilter(PackageMatchField::Moniker, MatchType::CaseInsensitive, "MONIKER") });
+    addRequest({}, { PackageMatchFilter(PackageMatchField::Id, MatchType::Exact, "Missing") });
+
+    // The snapshot is only built after a number of searches, so repeat them until it must have been.
+    for (size_t i = 0; i < 4; ++i)
+    {
+        for (const auto& request : requests)
+        {
+            INFO(request.ToString());
+
+            auto expected = expectedIndex.Search(request);
+            auto actual = index.Search(request);
+
+            REQUIRE(actual.Truncated == expected.Truncated);
+            REQUIRE(actual.Matches.size() == expected.Matches.size());
+            for (size_t j = 0; j < expected.Matches.size(); ++j)
+            {
+                REQUIRE(actual.Matches[j].first == expected.Matches[j].first);
+                REQUIRE(actual.Matches[j].second.Field == expected.Matches[j].second.Field);
+                REQUIRE(actual.Matches[j].second.Type == expected.Matches[j].second.Type);
+                REQUIRE(actual.Matches[j].second.Value == expected.Matches[j].second.Value);
+            }
+        }
+    }
+}
+
+TEST_CASE("SQLiteIndex_FoldedKeys", "[sqliteindex][V1_8]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = SearchTestSetup(tempFile, {
+        { "Id_One", "Name", "Moniker", "1.0", "", {}, {}, "path/1" },
+        { "IdXOne", "Name", "MONIKER", "1.0", "", {}, {}, "path/2" },
+        { "Id.Two", "Name", "Stra\xC3\x9F" "e", "1.0", "", {}, {}, "path/3" },
+        }, Schema::Version{ 1, 8 });
+
+    auto search = [&](PackageMatchField field, MatchType type, std::string_view value)
+    {
+        SearchRequest request;
+        request.Inclusions.emplace_back(field, type, value);
+        return index.Search(request).Matches.size();
+    };
+
+    auto requireResults = [&]()
+    {
+        REQUIRE(search(PackageMatchField::Id, MatchType::CaseInsensitive, "ID_ONE") == 1);
+        REQUIRE(search(PackageMatchField::Id, MatchType::StartsWith, "id_") == 1);
+        REQUIRE(search(PackageMatchField::Id, MatchType::StartsWith, "ID") == 3);
+        REQUIRE(search(PackageMatchField::Id, MatchType::StartsWith, "Id.Two.") == 0);
+        REQUIRE(search(PackageMatchField::Moniker, MatchType::CaseInsensitive, "moniker") == 2);
+        REQUIRE(search(PackageMatchField::Moniker, MatchType::StartsWith, "STRA\xC3\x9F") == 1);
+        REQUIRE(search(PackageMatchField::Moniker, MatchType::StartsWith, "strass") == 0);
+    };
+
+    // The keys are only used once the index is packaged, and give the same results as without them.
+    requireResults();
+
+    index.PrepareForPackaging();
+    REQUIRE(index.CheckConsistency(true));
+
+    Schema::Version testVersion = TestPrepareForRead(index);
+    INFO("Reading as version " << testVersion);
+
+    requireResults();
+}
+
+TEST_CASE("SQLiteIndex_InstallerSummary", "[sqliteindex][V1_9]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = SQLiteIndex::CreateNew(tempFile, Schema::Version{ 1, 9 });
+
+    Manifest manifest;
+    manifest.Id = "Foo";
+    manifest.DefaultLocalization.Add<Localization::PackageName>("Name");
+    manifest.Version = "1.0";
+    manifest.Installers.resize(3);
+    manifest.Installers[0].Arch = Architecture::X64;
+    manifest.Installers[0].InstallerType = InstallerTypeEnum::Msi;
+    manifest.Installers[0].Scope = ScopeEnum::Machine;
+    manifest.Installers[0].MinOSVersion = "10.0.17763.0";
+    manifest.Installers[0].Markets.AllowedMarkets = { "US", "GB" };
+    manifest.Installers[1] = manifest.Installers[0];
+    manifest.Installers[1].Locale = "fr-FR";
+    manifest.Installers[2].Arch = Architecture::Arm64;
+    manifest.Installers[2].InstallerType = InstallerTypeEnum::Msix;
+    manifest.Installers[2].Markets.ExcludedMarkets = { "CN" };
+    index.AddManifest(manifest, "path");
+
+    auto results = index.Search({});
+    REQUIRE(results.Matches.size() == 1);
+    SQLite::rowid_t manifestId = results.Matches[0].first;
+
+    auto summary = index.GetPropertyByManifestId(manifestId, PackageVersionProperty::InstallerSummary);
+    REQUIRE(summary);
+
+    // Installers that differ only in values outside of the summary are written once.
+    auto installers = ParseInstallerSummary(summary.value());
+    REQUIRE(installers.size() == 2);
+    REQUIRE(installers[0].Arch == Architecture::X64);
+    REQUIRE(installers[0].InstallerType == InstallerTypeEnum::Msi);
+    REQUIRE(installers[0].Scope == ScopeEnum::Machine);
+    REQUIRE(installers[0].MinOSVersion == "10.0.17763.0");
+    REQUIRE(installers[0].Markets.AllowedMarkets == std::vector<string_t>{ "US", "GB" });
+    REQUIRE(installers[0].Markets.ExcludedMarkets.empty());
+    REQUIRE(installers[1].Arch == Architecture::Arm64);
+    REQUIRE(installers[1].InstallerType == InstallerTypeEnum::Msix);
+    REQUIRE(installers[1].Scope == ScopeEnum::Unknown);
+    REQUIRE(installers[1].MinOSVersion.empty());
+    REQUIRE(installers[1].Markets.ExcludedMarkets == std::vector<string_t>{ "CN" });
+
+    // A change to the installers alone is an update to the index.
+    manifest.Installers.resize(1);
+    REQUIRE(index.UpdateManifest(manifest, "path"));
+    REQUIRE(ParseInstallerSummary(index.GetPropertyByManifestId(manifestId, PackageVersionProperty::InstallerSummary).value()).size() == 1);
+    REQUIRE(!index.UpdateManifest(manifest, "path"));
+    REQUIRE(index.CheckConsistency(true));
+
+    Schema::Version testVersion = TestPrepareForRead(index);
+    INFO("Reading as version " << testVersion);
+
+    summary = index.GetPropertyByManifestId(manifestId, PackageVersionProperty::InstallerSummary);
+    REQUIRE(summary.has_value() == (testVersion == Schema::Version{ 1, 9 }));
+}
+
+TEST_CASE("SQLiteIndex_InstallerSummary_NotValid", "[sqliteindex][V1_9]")
+{
+    REQUIRE(ParseInstallerSummary("").empty());
+    REQUIRE(ParseInstallerSummary("X64|msi|machine").empty());
+    REQUIRE(ParseInstallerSummary("X64|msi|machine||;X86").empty());
+}
+
+TEST_CASE("SQLiteIndex_SystemReferenceFilter", "[sqliteindex][V1_9]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SQLiteIndex index = SearchTestSetup(tempFile, {
+        { "Id1", "Name One", "Publisher One", "Moniker", "1.0", "", {}, {}, "path/1", { "PFN1" }, { "PC1" } },
+        { "Id2", "Name Two", "Publisher Two", "Moniker", "1.0", "", {}, {}, "path/2", { "PFN2" }, { "PC2" } },
+        }, Schema::Version{ 1, 9 });
+
+    auto search = [&](std::vector<PackageMatchFilter> inclusions, std::vector<PackageMatchFilter> filters = {})
+    {
+        SearchRequest request;
+        request.Inclusions = std::move(inclusions);
+        request.Filters = std::move(filters);
+        return index.Search(request).Matches.size();
+    };
+
+    auto requireResults = [&]()
+    {
+        REQUIRE(search({ PackageMatchFilter(PackageMatchField::ProductCode, MatchType::Exact, "pc1") }) == 1);
+        REQUIRE(search({ PackageMatchFilter(PackageMatchField::PackageFamilyName, MatchType::Exact, "PFN2") }) == 1);
+        REQUIRE(search({ PackageMatchFilter(PackageMatchField::NormalizedNameAndPublisher, MatchType::Exact, "Name One", "Publisher One") }) == 1);
+        REQUIRE(search({ PackageMatchFilter(PackageMatchField::NormalizedNameAndPublisher, MatchType::Exact, "Name One", "Publisher Two") }) == 0);
+        REQUIRE(search({ PackageMatchFilter(PackageMatchField::ProductCode, MatchType::Exact, "PC3") }) == 0);
+        REQUIRE(search({ PackageMatchFilter(PackageMatchField::ProductCode, MatchType::Exact, "PC3"), PackageMatchFilter(PackageMatchField::ProductCode, MatchType::Exact, "PC2") }) == 1);
+
+        // With every inclusion ruled out, the filters alone must not produce results.
+        REQUIRE(search({ PackageMatchFilter(PackageMatchField::ProductCode, MatchType::Exact, "PC3") }, { PackageMatchFilter(PackageMatchField::Moniker, MatchType::Exact, "Moniker") }) == 0);
+    };
+
+    requireResults();
+
+    index.PrepareForPackaging();
+    REQUIRE(index.CheckConsistency(true));
+
+    Schema::Version testVersion = TestPrepareForRead(index);
+    INFO("Reading as version " << testVersion);
+
+    requireResults();
+}
+
+TEST_CASE("SQLiteIndex_SystemReferenceFilter_Serialize", "[sqliteindex][V1_9]")
+{
+    using Schema::V1_9::SystemReferenceFilter;
+
+    SystemReferenceFilter filter{ 100 };
+    for (int i = 0; i < 100; ++i)
+    {
+        filter.Add(SystemReferenceFilter::CreateKey(PackageMatchField::ProductCode, std::to_string(i)));
+    }
+
+    SystemReferenceFilter readFilter{ filter.Serialize() };
+
+    size_t falsePositives = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        REQUIRE(readFilter.MayContain(SystemReferenceFilter::CreateKey(PackageMatchField::ProductCode, std::to_string(i))));
+
+        if (readFilter.MayContain(SystemReferenceFilter::CreateKey(PackageMatchField::PackageFamilyName, std::to_string(i))))
+        {
+            ++falsePositives;
+        }
+    }
+
+    REQUIRE(falsePositives < 10);
+    REQUIRE_THROWS_HR(SystemReferenceFilter{ SQLite::blob_t(8) }, E_NOT_SUFFICIENT_BUFFER);
+}
+
+TEST_CASE("SQLiteIndex_DiffIndexes", "[sqliteindex]")
+{
+    TempFile oldFile{ "repolibtest_tempdb"s, ".db"s };
+    TempFile newFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary files named: " << oldFile.GetPath() << " and " << newFile.GetPath());
+
+    uint8_t data[4] = { 1, 2, 3, 4 };
+    SHA256::HashBuffer hash = SHA256::ComputeHash(data, sizeof(data));
+    uint8_t otherData[4] = { 5, 6, 7, 8 };
+    SHA256::HashBuffer otherHash = SHA256::ComputeHash(otherData, sizeof(otherData));
+
+    Manifest removed;
+    CreateFakeManifest(removed, "Removed");
+    removed.StreamSha256 = hash;
+
+    Manifest unchanged;
+    CreateFakeManifest(unchanged, "Unchanged");
+    unchanged.StreamSha256 = hash;
+
+    Manifest updated;
+    CreateFakeManifest(updated, "Updated");
+    updated.StreamSha256 = hash;
+
+    Manifest added;
+    CreateFakeManifest(added, "Added");
+    added.StreamSha256 = hash;
+
+    SQLiteIndex oldIndex = SQLiteIndex::CreateNew(oldFile, Schema::Version::Latest());
+    oldIndex.AddManifest(removed, "removed");
+    oldIndex.AddManifest(unchanged, "unchanged");
+    oldIndex.AddManifest(updated, "updated");
+
+    SQLiteIndex newIndex = SQLiteIndex::CreateNew(newFile, Schema::Version::Latest());
+    newIndex.AddManifest(unchanged, "unchanged");
+    updated.StreamSha256 = otherHash;
+    newIndex.AddManifest(updated, "updated");
+    newIndex.AddManifest(added, "added");
+
+    std::vector<SQLiteIndexChange> changes = DiffIndexes(oldIndex, newIndex);
+    REQUIRE(changes.size() == 3);
+
+    // Removals are first, followed by the changes in key order.
+    REQUIRE(changes[0].ChangeType == SQLiteIndexChange::Type::Removed);
+    REQUIRE(changes[0].Id == removed.Id);
+    REQUIRE(changes[0].RelativePath == "removed");
+    REQUIRE(changes[1].ChangeType == SQLiteIndexChange::Type::Added);
+    REQUIRE(changes[1].Id == added.Id);
+    REQUIRE(changes[1].Version == added.Version);
+    REQUIRE(changes[1].Channel == added.Channel);
+    REQUIRE(changes[2].ChangeType == SQLiteIndexChange::Type::Updated);
+    REQUIRE(changes[2].Id == updated.Id);
+    REQUIRE(changes[2].ManifestSHA256Hash == SHA256::ConvertToString(otherHash));
+
+    std::vector<SQLiteIndexChange> roundTrip = DeserializeIndexChanges(SerializeIndexChanges(changes));
+    REQUIRE(roundTrip.size() == changes.size());
+    for (size_t i = 0; i < changes.size(); ++i)
+    {
+        REQUIRE(roundTrip[i].ChangeType == changes[i].ChangeType);
+        REQUIRE(roundTrip[i].Id == changes[i].Id);
+        REQUIRE(roundTrip[i].Version == changes[i].Version);
+        REQUIRE(roundTrip[i].Channel == changes[i].Channel);
+        REQUIRE(roundTrip[i].RelativePath == changes[i].RelativePath);
+        REQUIRE(roundTrip[i].ManifestSHA256Hash == changes[i].ManifestSHA256Hash);
+    }
+
+    // A removal does not need the manifest file.
+    ApplyIndexChanges(oldIndex, { changes[0] }, {});
+    REQUIRE(!oldIndex.GetManifestIdByManifest(removed));
+    REQUIRE(oldIndex.GetManifestIdByManifest(unchanged));
+
+    REQUIRE_THROWS_HR(DeserializeIndexChanges(R"([{ "Type": "Moved", "Id": "A", "Version": "1.0", "Channel": "" }])"), E_INVALIDARG);
+    REQUIRE_THROWS_HR(DeserializeIndexChanges("{}"), E_INVALIDARG);
+}
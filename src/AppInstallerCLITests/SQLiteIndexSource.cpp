@@ -2,8 +2,12 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "TestCommon.h"
+#include <Microsoft/CompletionIndex.h>
+#include <Microsoft/ManifestCache.h>
 #include <Microsoft/SQLiteIndexSource.h>
+#include <Microsoft/ShardedIndexSource.h>
 #include <winget/ManifestYamlParser.h>
+#include <winget/MemoryTrim.h>
 
 using namespace std::string_literals;
 using namespace TestCommon;
@@ -53,6 +57,34 @@ TEST_CASE("SQLiteIndexSource_Search_IdExactMatch", "[sqliteindexsource]")
     REQUIRE(results.Matches[0].MatchCriteria.Value == manifest.Id);
 }
 
+TEST_CASE("SQLiteIndexSource_Search_AfterMemoryTrim", "[sqliteindexsource]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    SourceDetails details;
+    Manifest manifest;
+    std::string relativePath;
+    std::shared_ptr<SQLiteIndexSource> source = SimpleTestSetup(tempFile, details, manifest, relativePath);
+
+    static size_t s_trimCount = 0;
+    static std::once_flag s_registerOnce;
+    std::call_once(s_registerOnce, []() { AppInstaller::Memory::RegisterTrimFunction([]() { ++s_trimCount; }); });
+
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Exact, manifest.Id);
+    REQUIRE(source->Search(request).Matches.size() == 1);
+
+    size_t trimCount = s_trimCount;
+    AppInstaller::Memory::Trim();
+    REQUIRE(s_trimCount == trimCount + 1);
+
+    // The page cache of the index connection was released, and is read again
+    auto results = source->Search(request);
+    REQUIRE(results.Matches.size() == 1);
+    REQUIRE(results.Matches[0].Package->GetLatestAvailableVersion()->GetManifest().Id == manifest.Id);
+}
+
 TEST_CASE("SQLiteIndexSource_Search_NoMatch", "[sqliteindexsource]")
 {
     TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
@@ -194,3 +226,266 @@ TEST_CASE("SQLiteIndexSource_IsSame", "[sqliteindexsource]")
 
     REQUIRE(result1.Matches[0].Package->IsSame(result2.Matches[0].Package.get()));
 }
+
+static std::string GetManifestCacheTestContents()
+{
+    return R"(PackageIdentifier: Foo.Bar
+PackageVersion: 1.0.0
+PackageName: Bar
+Publisher: Foo
+License: Foo
+ShortDescription: Foo
+Installers:
+  - Architecture: x64
+    InstallerType: exe
+    InstallerUrl: https://example.com/foo.exe
+    InstallerSha256: 011048877dfaef109801b3f3ab2b60afc74f3fc4f7b3430e0c897f5da1df84b6
+ManifestType: singleton
+ManifestVersion: 1.0.0
+)";
+}
+
+TEST_CASE("SQLiteIndexWriteableSource_AddRemove", "[sqliteindexsource]")
+{
+    SourceDetails details;
+    details.Identifier = "*WriteableTest";
+    auto source = std::make_shared<SQLiteIndexWriteableSource>(details, SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET, Schema::Version::Latest()));
+
+    Manifest manifest = YamlParser::Create(GetManifestCacheTestContents());
+    std::filesystem::path relativePath = manifest.Id + '.' + manifest.Version;
+
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Exact, manifest.Id);
+
+    REQUIRE(source->Search(request).Matches.empty());
+
+    // A version that is added and removed before a search is never seen
+    source->AddPackageVersion(manifest, relativePath);
+    source->RemovePackageVersion(manifest, relativePath);
+    REQUIRE(source->Search(request).Matches.empty());
+
+    source->AddPackageVersion(manifest, relativePath);
+    REQUIRE(source->Search(request).Matches.size() == 1);
+
+    // Adding the same version again requires it to be removed as many times
+    source->AddPackageVersion(manifest, relativePath);
+    source->RemovePackageVersion(manifest, relativePath);
+    REQUIRE(source->Search(request).Matches.size() == 1);
+
+    source->RemovePackageVersion(manifest, relativePath);
+    REQUIRE(source->Search(request).Matches.empty());
+}
+
+TEST_CASE("ManifestCache_MemoryOnly", "[sqliteindexsource][manifestcache]")
+{
+    std::string contents = GetManifestCacheTestContents();
+    AppInstaller::Utility::SHA256::HashBuffer hash = AppInstaller::Utility::SHA256::ComputeHash(contents);
+
+    ManifestCache cache;
+    REQUIRE(!cache.Get(hash));
+
+    cache.Add(hash, YamlParser::Create(contents), contents);
+
+    auto cached = cache.Get(hash);
+    REQUIRE(cached);
+    REQUIRE(cached->Id == "Foo.Bar");
+}
+
+TEST_CASE("ManifestCache_OnDisk", "[sqliteindexsource][manifestcache]")
+{
+    TempDirectory directory{ "ManifestCache" };
+
+    std::string contents = GetManifestCacheTestContents();
+    AppInstaller::Utility::SHA256::HashBuffer hash = AppInstaller::Utility::SHA256::ComputeHash(contents);
+
+    {
+        ManifestCache cache{ directory.GetPath() };
+        cache.Add(hash, YamlParser::Create(contents), contents);
+    }
+
+    // A new cache reads the entry written by the previous one
+    {
+        ManifestCache cache{ directory.GetPath() };
+        auto cached = cache.Get(hash);
+        REQUIRE(cached);
+        REQUIRE(cached->Version == "1.0.0");
+    }
+
+    // An entry that no longer has its hash is not used
+    {
+        std::ofstream stream{ directory.GetPath() / (AppInstaller::Utility::SHA256::ConvertToString(hash) + ".yaml"), std::ios_base::app };
+        stream << "# changed\n";
+    }
+
+    ManifestCache cache{ directory.GetPath() };
+    REQUIRE(!cache.Get(hash));
+}
+
+TEST_CASE("ManifestCache_ReleaseMemory", "[sqliteindexsource][manifestcache]")
+{
+    TempDirectory directory{ "ManifestCache" };
+
+    std::string contents = GetManifestCacheTestContents();
+    AppInstaller::Utility::SHA256::HashBuffer hash = AppInstaller::Utility::SHA256::ComputeHash(contents);
+
+    ManifestCache memoryCache;
+    memoryCache.Add(hash, YamlParser::Create(contents));
+    memoryCache.ReleaseMemory();
+    REQUIRE(!memoryCache.Get(hash));
+
+    // An entry on disk is read again
+    ManifestCache diskCache{ directory.GetPath() };
+    diskCache.Add(hash, YamlParser::Create(contents), contents);
+    diskCache.ReleaseMemory();
+    auto cached = diskCache.Get(hash);
+    REQUIRE(cached);
+    REQUIRE(cached->Id == "Foo.Bar");
+}
+
+TEST_CASE("CompletionIndex_GetValues", "[sqliteindexsource][completionindex]")
+{
+    TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    {
+        SourceDetails details;
+        Manifest manifest;
+        std::string relativePath;
+        std::ignore = SimpleTestSetup(tempFile, details, manifest, relativePath);
+    }
+
+    TempDirectory directory{ "CompletionIndex" };
+    std::filesystem::path completionIndexPath = directory.GetPath() / "completion.idx";
+
+    auto ids = CompletionIndex::GetValues(completionIndexPath, tempFile, SQLiteIndex::OpenDisposition::Read, { PackageMatchField::Id }, "Microsoft.");
+    REQUIRE(ids.size() == 1);
+    REQUIRE(ids[0] == "microsoft.msixsdk");
+    REQUIRE(std::filesystem::exists(completionIndexPath));
+
+    SECTION("From the completion index")
+    {
+        auto monikers = CompletionIndex::GetValues(completionIndexPath, tempFile, SQLiteIndex::OpenDisposition::Read, { PackageMatchField::Moniker }, "MSIX");
+        REQUIRE(monikers.size() == 1);
+        REQUIRE(monikers[0] == "msixsdk");
+
+        REQUIRE(CompletionIndex::GetValues(completionIndexPath, tempFile, SQLiteIndex::OpenDisposition::Read, { PackageMatchField::Id }, "msixsdk").empty());
+        REQUIRE(CompletionIndex::GetValues(completionIndexPath, tempFile, SQLiteIndex::OpenDisposition::Read, { PackageMatchField::Id }, {}).size() == 1);
+    }
+    SECTION("Out of date")
+    {
+        {
+            std::ofstream stream{ completionIndexPath, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary };
+            stream << "Not a completion index";
+        }
+
+        auto rebuilt = CompletionIndex::GetValues(completionIndexPath, tempFile, SQLiteIndex::OpenDisposition::Read, { PackageMatchField::Id }, "microsoft");
+        REQUIRE(rebuilt.size() == 1);
+        REQUIRE(rebuilt[0] == "microsoft.msixsdk");
+        REQUIRE(CompletionIndex::GetValues(completionIndexPath, tempFile, SQLiteIndex::OpenDisposition::Read, { PackageMatchField::Id }, "other").empty());
+    }
+}
+
+TEST_CASE("ShardedIndexSource_Search", "[sqliteindexsource]")
+{
+    TempFile shardFile0{ "repolibtest_tempdb"s, ".db"s };
+    TempFile shardFile1{ "repolibtest_tempdb"s, ".db"s };
+
+    std::vector<SQLiteIndex> shards;
+    shards.emplace_back(SQLiteIndex::CreateNew(shardFile0, Schema::Version::Latest()));
+    shards.emplace_back(SQLiteIndex::CreateNew(shardFile1, Schema::Version::Latest()));
+
+    std::vector<std::string> ids = { "Contoso.Alpha", "Contoso.Beta", "Contoso.Gamma", "Contoso.Delta", "Contoso.Epsilon" };
+    std::set<uint32_t> usedShards;
+
+    for (const auto& id : ids)
+    {
+        Manifest manifest;
+        manifest.Id = id;
+        manifest.DefaultLocalization.Add<Localization::PackageName>(id + " Name");
+        manifest.Version = "1.0";
+
+        uint32_t shard = GetShardForPackageId(id, 2);
+        REQUIRE(shard == GetShardForPackageId(AppInstaller::Utility::ToLower(id), 2));
+        usedShards.insert(shard);
+        shards[shard].AddManifest(manifest, id);
+    }
+
+    // The ids must be spread over both shards for the search across them to be tested.
+    REQUIRE(usedShards.size() == 2);
+
+    SourceDetails details;
+    details.Name = "TestName";
+    details.Type = "TestType";
+    details.Identifier = "*ShardedIndexSource";
+
+    auto source = std::make_shared<ShardedIndexSource>(details, std::move(shards));
+
+    SECTION("Everything")
+    {
+        SearchRequest request;
+        REQUIRE(source->GetShardsForRequest(request).size() == 2);
+
+        auto results = source->Search(request);
+        REQUIRE(results.Matches.size() == ids.size());
+        REQUIRE(results.Matches[0].Package->GetSource().GetIdentifier() == details.Identifier);
+    }
+    SECTION("Query")
+    {
+        SearchRequest request;
+        request.Query = RequestMatch(MatchType::Substring, "Contoso");
+        request.MaximumResults = 3;
+
+        auto results = source->Search(request);
+        REQUIRE(results.Matches.size() == 3);
+        REQUIRE(results.Truncated);
+    }
+    SECTION("Id filter")
+    {
+        SearchRequest request;
+        request.Query = RequestMatch(MatchType::Substring, "Contoso");
+        request.Filters.emplace_back(PackageMatchField::Id, MatchType::CaseInsensitive, "contoso.gamma"s);
+
+        auto shardsForRequest = source->GetShardsForRequest(request);
+        REQUIRE(shardsForRequest.size() == 1);
+        REQUIRE(shardsForRequest[0] == GetShardForPackageId("Contoso.Gamma", 2));
+
+        auto results = source->Search(request);
+        REQUIRE(results.Matches.size() == 1);
+        REQUIRE(results.Matches[0].Package->GetProperty(PackageProperty::Id).get() == "Contoso.Gamma");
+    }
+    SECTION("Id inclusions")
+    {
+        SearchRequest request;
+        request.Inclusions.emplace_back(PackageMatchField::Id, MatchType::Exact, "Contoso.Alpha"s);
+        request.Inclusions.emplace_back(PackageMatchField::Id, MatchType::Exact, "Contoso.Beta"s);
+
+        auto results = source->Search(request);
+        REQUIRE(results.Matches.size() == 2);
+
+        // Packages from different shards are never the same, even with the same rowid.
+        REQUIRE(!results.Matches[0].Package->IsSame(results.Matches[1].Package.get()));
+    }
+}
+
+TEST_CASE("ShardedIndexSource_Manifest", "[sqliteindexsource]")
+{
+    TempFile manifestFile{ "repolibtest_shards"s, ".json"s };
+
+    auto writeManifest = [&](std::string_view content)
+    {
+        std::ofstream stream{ manifestFile.GetPath(), std::ios_base::out | std::ios_base::trunc | std::ios_base::binary };
+        stream << content;
+    };
+
+    writeManifest(R"({ "Version": 1, "Shards": [ "index.0.db", "index.1.db" ] })");
+    REQUIRE(ReadShardedIndexManifest(manifestFile) == std::vector<std::string>{ "index.0.db", "index.1.db" });
+
+    writeManifest(R"({ "Version": 1, "Shards": [ "..\\index.0.db" ] })");
+    REQUIRE_THROWS_HR(ReadShardedIndexManifest(manifestFile), APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE);
+
+    writeManifest(R"({ "Version": 2, "Shards": [ "index.0.db" ] })");
+    REQUIRE_THROWS_HR(ReadShardedIndexManifest(manifestFile), APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE);
+
+    writeManifest(R"({ "Version": 1, "Shards": [] })");
+    REQUIRE_THROWS_HR(ReadShardedIndexManifest(manifestFile), APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE);
+}
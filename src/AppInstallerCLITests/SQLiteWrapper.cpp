@@ -4,6 +4,9 @@
 #include "TestCommon.h"
 #include <SQLiteWrapper.h>
 #include <SQLiteStatementBuilder.h>
+#include <SQLiteTempTable.h>
+#include <winget/ThreadGlobals.h>
+#include <winget/Timing.h>
 
 using namespace AppInstaller::Repository::SQLite;
 using namespace std::string_literals;
@@ -136,6 +139,41 @@ TEST_CASE("SQLiteWrapperFileCreateAndReopen", "[sqlitewrapper]")
     }
 }
 
+TEST_CASE("SQLiteWrapper_JournalMode", "[sqlitewrapper]")
+{
+    TestCommon::TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+
+    int firstVal = 1;
+    std::string secondVal = "test";
+
+    {
+        Connection connection = Connection::Create(tempFile, Connection::OpenDisposition::Create);
+        REQUIRE(connection.SetJournalMode(Connection::JournalMode::Wal) == Connection::JournalMode::Wal);
+        connection.SetSynchronous(Connection::Synchronous::Normal);
+        connection.SetCacheSize(8 * 1024);
+
+        CreateSimpleTestTable(connection);
+        InsertIntoSimpleTestTable(connection, firstVal, secondVal);
+    }
+
+    // Write ahead logging is stored in the file, unlike the other modes
+    {
+        Connection connection = Connection::Create(tempFile, Connection::OpenDisposition::ReadWrite);
+        SelectFromSimpleTestTableOnlyOneRow(connection, firstVal, secondVal);
+
+        Statement journalMode = Statement::Create(connection, "PRAGMA journal_mode");
+        REQUIRE(journalMode.Step());
+        REQUIRE(journalMode.GetColumn<std::string>(0) == "wal");
+
+        REQUIRE(connection.SetJournalMode(Connection::JournalMode::Delete) == Connection::JournalMode::Delete);
+    }
+
+    // An in memory database only supports its own mode
+    Connection memoryConnection = Connection::Create(SQLITE_MEMORY_DB_CONNECTION_TARGET, Connection::OpenDisposition::Create);
+    REQUIRE(memoryConnection.SetJournalMode(Connection::JournalMode::Wal) == Connection::JournalMode::Memory);
+}
+
 TEST_CASE("SQLiteWrapperSavepointRollback", "[sqlitewrapper]")
 {
     Connection connection = Connection::Create(SQLITE_MEMORY_DB_CONNECTION_TARGET, Connection::OpenDisposition::Create);
@@ -260,6 +298,181 @@ TEST_CASE("SQLiteWrapperSavepointReuse", "[sqlitewrapper]")
     }
 }
 
+TEST_CASE("SQLiteWrapper_StatementCacheReuse", "[sqlitewrapper]")
+{
+    Connection connection = Connection::Create(SQLITE_MEMORY_DB_CONNECTION_TARGET, Connection::OpenDisposition::Create);
+
+    CreateSimpleTestTable(connection);
+
+    int firstVal = 1;
+    std::string secondVal = "test";
+
+    InsertIntoSimpleTestTable(connection, firstVal, secondVal);
+
+    std::string selectSQL = "select second from simpletest where first = ?";
+    sqlite3_stmt* firstHandle = nullptr;
+
+    {
+        Statement select = Statement::Create(connection, selectSQL);
+        firstHandle = select;
+        select.Bind(1, firstVal);
+
+        REQUIRE(select.Step());
+        REQUIRE(select.GetColumn<std::string>(0) == secondVal);
+        // Leave the statement with a row pending; the cache must reset it.
+    }
+
+    {
+        // Still in use statements are not handed out twice.
+        Statement select = Statement::Create(connection, selectSQL);
+        Statement other = Statement::Create(connection, selectSQL);
+
+        REQUIRE(static_cast<sqlite3_stmt*>(select) == firstHandle);
+        REQUIRE(static_cast<sqlite3_stmt*>(other) != firstHandle);
+
+        // The bindings of the reused statement are cleared, so nothing matches the null parameter.
+        REQUIRE(select.GetState() == Statement::State::Prepared);
+        REQUIRE_FALSE(select.Step());
+
+        other.Bind(1, firstVal);
+        REQUIRE(other.Step());
+    }
+}
+
+struct TestTempTable : public TempTable
+{
+    TestTempTable(const Connection& connection) : TempTable(connection, "test"), m_connection(connection)
+    {
+        if (!IsReused())
+        {
+            Builder::StatementBuilder builder;
+            builder.CreateTable(GetQualifiedName()).Columns({ Builder::ColumnBuilder(s_firstColumn, Builder::Type::Int) });
+            builder.Execute(m_connection);
+
+            InitDropStatement(m_connection);
+        }
+    }
+
+    using TempTable::IsReused;
+
+    std::string GetName() const { return std::string{ GetQualifiedName().Table }; }
+
+    void Insert(int value)
+    {
+        Builder::StatementBuilder builder;
+        builder.InsertInto(GetQualifiedName()).Columns({ s_firstColumn }).Values(value);
+        builder.Execute(m_connection);
+    }
+
+    int GetRowCount() const
+    {
+        Builder::StatementBuilder builder;
+        builder.Select(Builder::RowCount).From(GetQualifiedName());
+        Statement select = builder.Prepare(m_connection);
+        REQUIRE(select.Step());
+        return select.GetColumn<int>(0);
+    }
+
+private:
+    const Connection& m_connection;
+};
+
+TEST_CASE("SQLiteWrapper_TempTableReuse", "[sqlitewrapper]")
+{
+    Connection connection = Connection::Create(SQLITE_MEMORY_DB_CONNECTION_TARGET, Connection::OpenDisposition::Create);
+    connection.SetTempStore(Connection::TempStore::Memory);
+
+    std::string firstName;
+
+    {
+        TestTempTable table{ connection };
+        REQUIRE_FALSE(table.IsReused());
+        firstName = table.GetName();
+
+        table.Insert(1);
+        table.Insert(2);
+        REQUIRE(table.GetRowCount() == 2);
+    }
+
+    {
+        // The table is handed out again, emptied, while one still in use is not.
+        TestTempTable table{ connection };
+        TestTempTable other{ connection };
+
+        REQUIRE(table.IsReused());
+        REQUIRE(table.GetName() == firstName);
+        REQUIRE(table.GetRowCount() == 0);
+
+        REQUIRE_FALSE(other.IsReused());
+        REQUIRE(other.GetName() != firstName);
+    }
+}
+
+TEST_CASE("SQLiteWrapper_CancellationInterruptsStatement", "[sqlitewrapper]")
+{
+    using namespace AppInstaller::ThreadLocalStorage;
+
+    Connection connection = Connection::Create(SQLITE_MEMORY_DB_CONNECTION_TARGET, Connection::OpenDisposition::Create);
+
+    // Far more work than the test could wait for, were it not interrupted.
+    std::string_view longRunningSQL = "WITH RECURSIVE counter(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM counter WHERE x < 10000000000) SELECT COUNT(*) FROM counter";
+
+    SECTION("Check scope")
+    {
+        bool cancelled = true;
+        CancellationCheckScope scope{ [&]() { return cancelled; } };
+
+        Statement statement = Statement::Create(connection, longRunningSQL);
+        REQUIRE_THROWS_HR(statement.Step(), E_ABORT);
+
+        // Once no longer cancelled, statements run to completion again.
+        cancelled = false;
+        Statement shortStatement = Statement::Create(connection, "SELECT 1");
+        REQUIRE(shortStatement.Step());
+    }
+    SECTION("Thread globals")
+    {
+        ThreadGlobals parent;
+        ThreadGlobals child{ parent, ThreadGlobals::create_sub_thread_globals_t{} };
+        auto previous = child.SetForCurrentThread();
+
+        parent.Cancel();
+        REQUIRE(child.IsCancelled());
+        REQUIRE(IsCurrentThreadCancelled());
+
+        Statement statement = Statement::Create(connection, longRunningSQL);
+        REQUIRE_THROWS_HR(statement.Step(), E_ABORT);
+    }
+    SECTION("Not interrupted when it must not fail")
+    {
+        CancellationCheckScope scope{ []() { return true; } };
+
+        Statement statement = Statement::Create(connection, "WITH RECURSIVE counter(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM counter WHERE x < 100000) SELECT COUNT(*) FROM counter");
+        REQUIRE(statement.Step(true));
+        REQUIRE(statement.GetColumn<int>(0) == 100000);
+    }
+}
+
+TEST_CASE("SQLiteWrapper_ResourceUsage", "[sqlitewrapper]")
+{
+    AppInstaller::Timing::EnableUsage();
+
+    Connection connection = Connection::Create(SQLITE_MEMORY_DB_CONNECTION_TARGET, Connection::OpenDisposition::Create);
+    Statement statement = Statement::Create(connection, "WITH RECURSIVE counter(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM counter WHERE x < 3) SELECT x FROM counter");
+
+    AppInstaller::Timing::ResourceUsage before = AppInstaller::Timing::GetUsage();
+
+    // Three rows and the completion, then a single row after the reset.
+    while (statement.Step()) {}
+    statement.Reset();
+    REQUIRE(statement.Step());
+
+    AppInstaller::Timing::ResourceUsage after = AppInstaller::Timing::GetUsage();
+    REQUIRE(after.SqlExecutions - before.SqlExecutions == 2);
+    REQUIRE(after.SqlSteps - before.SqlSteps == 5);
+    REQUIRE(after.SqlStepTime >= before.SqlStepTime);
+}
+
 TEST_CASE("SQLiteWrapper_EscapeStringForLike", "[sqlitewrapper]")
 {
     std::string escape(EscapeCharForLike);
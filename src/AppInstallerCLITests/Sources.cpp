@@ -507,6 +507,60 @@ TEST_CASE("RepoSources_UpdateSourceRetries", "[sources]")
     REQUIRE(updateCalledOnFactoryAgain);
 }
 
+TEST_CASE("RepoSources_UpdateConcurrently", "[sources]")
+{
+    using namespace std::chrono_literals;
+
+    SetSetting(Stream::UserSources, s_ThreeSources);
+    SetSetting(Stream::SourcesMetadata, s_ThreeSourcesMetadata);
+    TestHook_ClearSourceFactoryOverrides();
+
+    std::atomic<size_t> updateCount = 0;
+    const char* suffix[3] = { "", "2", "3" };
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        TestSourceFactory factory{ SourcesTestSource::Create };
+        factory.OnUpdate = [&updateCount, fail = (i == 1)](const SourceDetails&)
+        {
+            ++updateCount;
+            THROW_HR_IF(E_ACCESSDENIED, fail);
+        };
+        TestHook_SetSourceFactoryOverride("testType"s + suffix[i], factory);
+    }
+
+    // The completions are called from the update threads, so they are only counted there.
+    ProgressCallback progress[3];
+    std::atomic<size_t> completeCount = 0;
+    std::atomic<size_t> succeededCount = 0;
+    auto now = std::chrono::system_clock::now();
+
+    Source source{ ""sv };
+    std::vector<SourceDetails> failed = source.UpdateConcurrently(
+        [&](const SourceDetails& details) -> IProgressCallback& { return progress[details.Name == "testName" ? 0 : details.Name.back() - '1']; },
+        [&](const SourceDetails&, bool updated)
+        {
+            ++completeCount;
+            if (updated)
+            {
+                ++succeededCount;
+            }
+        });
+
+    REQUIRE(updateCount == 3);
+    REQUIRE(completeCount == 3);
+    REQUIRE(succeededCount == 2);
+    REQUIRE(failed.size() == 1);
+    REQUIRE(failed[0].Name == "testName2");
+
+    // Only the sources that updated have their metadata saved.
+    std::vector<SourceDetails> sources = GetSources();
+    REQUIRE(sources.size() == 3);
+    REQUIRE((now - sources[0].LastUpdateTime) < 1s);
+    REQUIRE(sources[1].LastUpdateTime == ConvertUnixEpochToSystemClock(1));
+    REQUIRE((now - sources[2].LastUpdateTime) < 1s);
+}
+
 TEST_CASE("RepoSources_RemoveSource", "[sources]")
 {
     SetSetting(Stream::UserSources, s_EmptySources);
@@ -594,6 +648,125 @@ TEST_CASE("RepoSources_UpdateOnOpen", "[sources]")
     REQUIRE(sources[0].LastUpdateTime != ConvertUnixEpochToSystemClock(0));
 }
 
+TEST_CASE("RepoSources_UpdateOnOpen_InBackground", "[sources]")
+{
+    TestHook_ClearSourceFactoryOverrides();
+
+    std::string name = "testName";
+    std::string type = "testType";
+
+    bool updateCalledOnFactory = false;
+    TestSourceFactory factory{ SourcesTestSource::Create };
+    factory.OnUpdate = [&](const SourceDetails&) { updateCalledOnFactory = true; };
+    TestHook_SetSourceFactoryOverride(type, factory);
+
+    std::vector<std::string> backgroundUpdates;
+    Source::SetBackgroundUpdateHandler([&](const SourceDetails& details) { backgroundUpdates.emplace_back(details.Name); });
+    auto resetHandler = wil::scope_exit([]() { Source::SetBackgroundUpdateHandler({}); });
+
+    // The source has been updated before, but not within the update interval.
+    SetSetting(Stream::UserSources, s_SingleSource);
+    SetSetting(Stream::SourcesMetadata, s_SingleSourceMetadata);
+
+    ProgressCallback progress;
+    auto source = OpenSource(name, progress);
+
+    REQUIRE(source);
+    REQUIRE(!updateCalledOnFactory);
+    REQUIRE(backgroundUpdates.size() == 1);
+    REQUIRE(backgroundUpdates[0] == name);
+
+    std::vector<SourceDetails> sources = GetSources();
+    REQUIRE(sources[0].Name == name);
+    REQUIRE(ConvertSystemClockToUnixEpoch(sources[0].LastUpdateTime) == 100);
+}
+
+TEST_CASE("RepoSources_UpdateOnOpen_InBackground_InProcess", "[sources]")
+{
+    TestHook_ClearSourceFactoryOverrides();
+
+    std::string name = "testName";
+    std::string type = "testType";
+
+    // The update is slow enough that it is still running when the open returns.
+    std::atomic_bool updateCalledOnFactory = false;
+    TestSourceFactory factory{ SourcesTestSource::Create };
+    factory.OnUpdate = [&](const SourceDetails&)
+    {
+        std::this_thread::sleep_for(500ms);
+        updateCalledOnFactory = true;
+    };
+    TestHook_SetSourceFactoryOverride(type, factory);
+
+    // Without a handler, the update runs on the thread pool of this process.
+    Source::SetBackgroundUpdateHandler({});
+
+    SetSetting(Stream::UserSources, s_SingleSource);
+    SetSetting(Stream::SourcesMetadata, s_SingleSourceMetadata);
+
+    ProgressCallback progress;
+    auto source = OpenSource(name, progress);
+    REQUIRE(source);
+
+    // Waiting for the background updates returns only once the update has finished and saved its metadata.
+    Source::WaitForBackgroundUpdates();
+    REQUIRE(updateCalledOnFactory);
+
+    std::vector<SourceDetails> sources = GetSources();
+    REQUIRE(sources[0].Name == name);
+    REQUIRE(ConvertSystemClockToUnixEpoch(sources[0].LastUpdateTime) != 100);
+}
+
+TEST_CASE("RepoSources_RunBackgroundUpdate_HoldsClaim", "[sources]")
+{
+    TestHook_ClearSourceFactoryOverrides();
+
+    std::string name = "testName";
+    std::string type = "testType";
+
+    std::vector<std::string> backgroundUpdates;
+    Source::SetBackgroundUpdateHandler([&](const SourceDetails& details) { backgroundUpdates.emplace_back(details.Name); });
+    auto resetHandler = wil::scope_exit([]() { Source::SetBackgroundUpdateHandler({}); });
+
+    // While the update runs, other processes neither start another one nor run the one they started.
+    size_t updates = 0;
+    std::vector<SourceDetails> nestedFailures;
+    TestSourceFactory factory{ SourcesTestSource::Create };
+    factory.OnUpdate = [&](const SourceDetails&)
+    {
+        if (++updates == 1)
+        {
+            ProgressCallback nestedProgress;
+            REQUIRE(OpenSource(name, nestedProgress));
+            nestedFailures = Source{ name }.RunBackgroundUpdate(nestedProgress);
+        }
+    };
+    TestHook_SetSourceFactoryOverride(type, factory);
+
+    // The source has been updated before, but not within the update interval.
+    SetSetting(Stream::UserSources, s_SingleSource);
+    SetSetting(Stream::SourcesMetadata, s_SingleSourceMetadata);
+
+    // Opening the source hands the update to the handler, which leaves the claim for the process it starts.
+    ProgressCallback progress;
+    REQUIRE(OpenSource(name, progress));
+    REQUIRE(backgroundUpdates.size() == 1);
+    REQUIRE(updates == 0);
+
+    REQUIRE(Source{ name }.RunBackgroundUpdate(progress).empty());
+    REQUIRE(updates == 1);
+    REQUIRE(nestedFailures.empty());
+    REQUIRE(backgroundUpdates.size() == 1);
+
+    std::vector<SourceDetails> sources = GetSources();
+    REQUIRE(sources[0].Name == name);
+    REQUIRE(ConvertSystemClockToUnixEpoch(sources[0].LastUpdateTime) > 100);
+
+    // Once the source is up to date, a background update that started late has nothing to do.
+    REQUIRE(Source{ name }.RunBackgroundUpdate(progress).empty());
+    REQUIRE(updates == 1);
+}
+
 TEST_CASE("RepoSources_DropSourceByName", "[sources]")
 {
     SetSetting(Stream::UserSources, s_ThreeSources);
@@ -621,6 +794,41 @@ TEST_CASE("RepoSources_DropSourceByName", "[sources]")
     }
 }
 
+TEST_CASE("RepoSources_MetadataWrittenCompact", "[sources]")
+{
+    SetSetting(Stream::UserSources, s_ThreeSources);
+    SetSetting(Stream::SourcesMetadata, s_ThreeSourcesMetadata);
+
+    // Dropping a source rewrites the metadata that was read as YAML, into a stream of its own
+    DropSource("testName");
+
+    auto metadataStream = Stream{ Stream::SourcesMetadataCompact }.Get();
+    REQUIRE(metadataStream);
+    std::string metadata = ReadEntireStream(*metadataStream);
+    REQUIRE(metadata.compare(0, 7, "#WGSM1 ") == 0);
+
+    // The YAML is left for earlier versions to read
+    auto yamlStream = Stream{ Stream::SourcesMetadata }.Get();
+    REQUIRE(yamlStream);
+    REQUIRE(ReadEntireStream(*yamlStream) == s_ThreeSourcesMetadata);
+
+    std::vector<SourceDetails> sources = GetSources();
+    REQUIRE(sources.size() == 2);
+    REQUIRE(sources[0].LastUpdateTime == ConvertUnixEpochToSystemClock(1));
+    REQUIRE(sources[1].LastUpdateTime == ConvertUnixEpochToSystemClock(2));
+
+    // An earlier version writing the YAML afterward makes it the metadata that is read
+    REQUIRE(Stream{ Stream::SourcesMetadata }.Set(s_SingleSourceMetadata));
+    sources = GetSources();
+    REQUIRE(sources.size() == 2);
+    REQUIRE(sources[0].LastUpdateTime == ConvertUnixEpochToSystemClock(0));
+
+    // Truncated compact metadata is invalid
+    REQUIRE(Stream{ Stream::SourcesMetadata }.Set(s_ThreeSourcesMetadata));
+    REQUIRE(Stream{ Stream::SourcesMetadataCompact }.Set(metadata.substr(0, metadata.size() - 1)));
+    REQUIRE_THROWS_HR(GetSources(), APPINSTALLER_CLI_ERROR_SOURCES_INVALID);
+}
+
 TEST_CASE("RepoSources_DropAllSources", "[sources]")
 {
     SetSetting(Stream::UserSources, s_ThreeSources);
@@ -1080,6 +1288,64 @@ TEST_CASE("RepoSources_OpenMultipleWithTotalFailure", "[sources]")
     REQUIRE_THROWS_HR(OpenSource("", progress), APPINSTALLER_CLI_ERROR_FAILED_TO_OPEN_ALL_SOURCES);
 }
 
+TEST_CASE("RepoSources_SearchResultsRemembered", "[sources]")
+{
+    std::atomic<size_t> searchCount = 0;
+
+    TestHook_ClearSourceFactoryOverrides();
+    TestSourceFactory factory{ [&](const SourceDetails& details)
+        {
+            auto result = std::shared_ptr<TestSource>(new TestSource(details));
+            result->SearchFunction = [&](const SearchRequest&) { ++searchCount; return SearchResult{}; };
+            return result;
+        } };
+    TestHook_SetSourceFactoryOverride("testType", factory);
+
+    SetSetting(Stream::UserSources, s_TwoSource_AggregateSourceTest);
+
+    ProgressCallback progress;
+    auto source = OpenSource("", progress);
+
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Substring, "test");
+
+    source.Search(request);
+    REQUIRE(searchCount == 2);
+
+    // The same request, even from a copy of the source, is not searched again
+    Source copy = source;
+    copy.Search(request);
+    REQUIRE(searchCount == 2);
+
+    // Values that would read the same when joined together must still be different requests
+    SearchRequest separate;
+    separate.Inclusions.emplace_back(PackageMatchField::Id, MatchType::Exact, "a'[Exact] Include:Id='b");
+    SearchRequest joined;
+    joined.Inclusions.emplace_back(PackageMatchField::Id, MatchType::Exact, "a");
+    joined.Inclusions.emplace_back(PackageMatchField::Id, MatchType::Exact, "b");
+
+    source.Search(separate);
+    REQUIRE(searchCount == 4);
+    source.Search(joined);
+    REQUIRE(searchCount == 6);
+
+    // Stopping at a unique id match can return fewer results, so it is a different request
+    SearchRequest stopAtUniqueIdMatch = request;
+    stopAtUniqueIdMatch.StopAtUniqueIdMatch = true;
+
+    source.Search(stopAtUniqueIdMatch);
+    REQUIRE(searchCount == 8);
+    source.Search(stopAtUniqueIdMatch);
+    REQUIRE(searchCount == 8);
+    source.Search(request);
+    REQUIRE(searchCount == 8);
+
+    // A write forgets everything
+    Source::InvalidateSearchResults();
+    source.Search(request);
+    REQUIRE(searchCount == 10);
+}
+
 TEST_CASE("RepoSources_UpdateSettingsDuringAction_SourcesUpdate", "[sources]")
 {
     SetSetting(Stream::UserSources, s_SingleSource);
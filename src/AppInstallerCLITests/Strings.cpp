@@ -40,6 +40,23 @@ TEST_CASE("UTF8Substring", "[strings]")
     REQUIRE(UTF8Substring(s, 1, 8) == "s like \xf0\x9f\x8c\x8a");
 }
 
+TEST_CASE("IsASCII", "[strings]")
+{
+    REQUIRE(IsASCII(""));
+    REQUIRE(IsASCII("a"));
+    REQUIRE(IsASCII("Long enough to be checked a word at a time\r\n"));
+    REQUIRE_FALSE(IsASCII("K\xC3\xA4se")); // "Käse"
+    REQUIRE_FALSE(IsASCII("Long enough to be checked a word at a time\xE2\x80\xA6")); // Ends with "…"
+
+    REQUIRE(IsPrintableASCII(""));
+    REQUIRE(IsPrintableASCII(" a b c "));
+    REQUIRE(IsPrintableASCII("Long enough to be checked a word at a time ~"));
+    REQUIRE_FALSE(IsPrintableASCII("Long enough to be checked\ta word at a time"));
+    REQUIRE_FALSE(IsPrintableASCII("Long enough to be checked a word at a time\r\n"));
+    REQUIRE_FALSE(IsPrintableASCII("Delete\x7F in the first word"));
+    REQUIRE_FALSE(IsPrintableASCII("K\xC3\xA4se"));
+}
+
 TEST_CASE("UTF8ColumnWidth", "[strings]")
 {
     REQUIRE(UTF8ColumnWidth("") == 0);
@@ -52,6 +69,9 @@ TEST_CASE("UTF8ColumnWidth", "[strings]")
     REQUIRE(UTF8ColumnWidth("\xf0\x9d\x85\xa0\xf0\x9d\x85\xa0") == 2); // [8th note][8th note]
     REQUIRE(UTF8ColumnWidth("\xe6\xb5\x8b\xe8\xaf\x95") == 4); // 测试
     REQUIRE(UTF8ColumnWidth("te\xe6\xb5\x8bs\xe8\xaf\x95t") == 8); // te测s试t
+    REQUIRE(UTF8ColumnWidth("Package.Identifier \xe6\xb5\x8b\xe8\xaf\x95") == 23); // Package.Identifier 测试
+    REQUIRE(UTF8ColumnWidth("Package.Identifier\xCC\xB2") == 18); // Combining low line on the last ASCII character
+    REQUIRE(UTF8ColumnWidth("tab\tseparated") == 13);
 }
 
 TEST_CASE("UTF8TrimRightToColumnWidth", "[strings]")
@@ -69,6 +89,17 @@ TEST_CASE("UTF8TrimRightToColumnWidth", "[strings]")
     REQUIRE((UTF8TrimRightToColumnWidth(s, 4, actualWidth) == "te\xe6\xb5\x8b" && actualWidth == 4));
     REQUIRE((UTF8TrimRightToColumnWidth(s, 8, actualWidth) == "te\xe6\xb5\x8bs\xe8\xaf\x95t" && actualWidth == 8));
     REQUIRE((UTF8TrimRightToColumnWidth(s, 10, actualWidth) == "te\xe6\xb5\x8bs\xe8\xaf\x95t" && actualWidth == 8));
+
+    // A long ASCII start before other characters
+    std::string longPrefix = "Package.Identifier \xe6\xb5\x8b\xe8\xaf\x95";
+    REQUIRE((UTF8TrimRightToColumnWidth(longPrefix, 7, actualWidth) == "Package" && actualWidth == 7));
+    REQUIRE((UTF8TrimRightToColumnWidth(longPrefix, 20, actualWidth) == "Package.Identifier " && actualWidth == 19));
+    REQUIRE((UTF8TrimRightToColumnWidth(longPrefix, 21, actualWidth) == "Package.Identifier \xe6\xb5\x8b" && actualWidth == 21));
+
+    // The last ASCII character is kept together with the combining mark that follows it
+    std::string combining = "Package.Identifier\xCC\xB2";
+    REQUIRE((UTF8TrimRightToColumnWidth(combining, 17, actualWidth) == "Package.Identifie" && actualWidth == 17));
+    REQUIRE((UTF8TrimRightToColumnWidth(combining, 18, actualWidth) == combining && actualWidth == 18));
 }
 
 TEST_CASE("Normalize", "[strings]")
@@ -128,12 +159,107 @@ TEST_CASE("CaseInsensitiveStartsWith", "[strings]")
     REQUIRE(!CaseInsensitiveStartsWith(" starts", "starts"));
 }
 
+TEST_CASE("CaseInsensitiveEquals", "[strings]")
+{
+    REQUIRE(CaseInsensitiveEquals("", ""));
+    REQUIRE(CaseInsensitiveEquals("Equals", "eQUALS"));
+    REQUIRE(CaseInsensitiveEquals("Microsoft.WindowsTerminal", "microsoft.windowsterminal"));
+    REQUIRE(CaseInsensitiveEquals("@[Z]`{a}", "@[z]`{A}"));
+
+    REQUIRE(!CaseInsensitiveEquals("Equals", "Equal"));
+    REQUIRE(!CaseInsensitiveEquals("Microsoft.WindowsTerminal", "Microsoft.WindowsTerminaI"));
+    // Only ASCII letters differ by 0x20 between the cases
+    REQUIRE(!CaseInsensitiveEquals("@[", "`{"));
+    REQUIRE(!CaseInsensitiveEquals("12345678@", "12345678`"));
+}
+
+TEST_CASE("ToLower", "[strings]")
+{
+    REQUIRE(ToLower("") == "");
+    REQUIRE(ToLower("Microsoft.WindowsTerminal @[Z]`{a}") == "microsoft.windowsterminal @[z]`{a}");
+    REQUIRE(ToLower("K\xC3\x84SE") == "k\xC3\x84se"); // Only ASCII is changed
+
+    std::string buffer;
+    std::string_view lower = "already.lower.case";
+    REQUIRE(ToLower(lower, buffer).data() == lower.data());
+    REQUIRE(buffer.empty());
+
+    std::string_view mixed = "Mixed.Case.Value";
+    std::string_view result = ToLower(mixed, buffer);
+    REQUIRE(result == "mixed.case.value");
+    REQUIRE(result.data() == buffer.data());
+}
+
 TEST_CASE("FoldCase", "[strings]")
 {
     REQUIRE(FoldCase(""sv) == FoldCase(""sv));
     REQUIRE(FoldCase("foldcase"sv) == FoldCase("FOLDCASE"sv));
     REQUIRE(FoldCase(u8"f\xF6ldcase"sv) == FoldCase(u8"F\xD6LDCASE"sv));
     REQUIRE(FoldCase(u8"foldc\x430se"sv) == FoldCase(u8"FOLDC\x410SE"sv));
+    REQUIRE(FoldCase("FoldCase.With.ASCII.123"sv) == "foldcase.with.ascii.123");
+
+    std::string buffer;
+    std::string_view folded = "already.folded";
+    REQUIRE(FoldCase(folded, buffer).data() == folded.data());
+
+    REQUIRE(FoldCase("Not.Folded"sv, buffer) == "not.folded");
+    REQUIRE(FoldCase(u8"f\xF6ldcase"sv, buffer) == FoldCase(u8"F\xD6LDCASE"sv));
+}
+
+TEST_CASE("FoldCaseByCodePoint", "[strings]")
+{
+    REQUIRE(FoldCaseByCodePoint(""sv).empty());
+    REQUIRE(FoldCaseByCodePoint("FoldCase.With.ASCII.123"sv) == "foldcase.with.ascii.123");
+    REQUIRE(FoldCaseByCodePoint("F\xC3\x96LDC\xD0\x90SE"sv) == "f\xC3\xB6ldc\xD0\xB0se");
+
+    // The sharp s stays a single code point, where full folding expands it
+    REQUIRE(FoldCaseByCodePoint("Stra\xC3\x9F" "e"sv) == "stra\xC3\x9F" "e");
+    REQUIRE(FoldCase("Stra\xC3\x9F" "e"sv) == "strasse");
+}
+
+TEST_CASE("ICUCaseInsensitiveEquals", "[strings]")
+{
+    REQUIRE(ICUCaseInsensitiveEquals("Equals", "eQUALS"));
+    REQUIRE(ICUCaseInsensitiveEquals(u8"f\xF6ldcase", u8"F\xD6LDCASE"));
+    REQUIRE(ICUCaseInsensitiveEquals(u8"\x212A", "k")); // Kelvin sign folds to ASCII
+    REQUIRE(!ICUCaseInsensitiveEquals("Equals", "Equal"));
+}
+
+TEST_CASE("BoundedEditDistance", "[strings]")
+{
+    REQUIRE(BoundedEditDistance("", "", 2) == 0);
+    REQUIRE(BoundedEditDistance("kitten", "kitten", 2) == 0);
+    REQUIRE(BoundedEditDistance("kitten", "sitten", 2) == 1);
+    REQUIRE(BoundedEditDistance("kitten", "sitting", 3) == 3);
+    REQUIRE(BoundedEditDistance("sitting", "kitten", 3) == 3);
+    REQUIRE(BoundedEditDistance("kitten", "sitting", 2) == 3);
+    REQUIRE(BoundedEditDistance("abc", "", 5) == 3);
+    REQUIRE(BoundedEditDistance("", "abc", 1) == 2);
+    REQUIRE(BoundedEditDistance("abcdefgh", "abdcefgh", 2) == 2);
+
+    // Longer than a machine word
+    std::string longValue(100, 'a');
+    std::string longOther = longValue;
+    longOther[50] = 'b';
+    longOther.push_back('c');
+    REQUIRE(BoundedEditDistance(longValue, longOther, 3) == 2);
+    REQUIRE(BoundedEditDistance(longValue, longOther, 1) == 2);
+}
+
+TEST_CASE("BoundedSubstringEditDistance", "[strings]")
+{
+    REQUIRE(BoundedSubstringEditDistance("visual studio code", "", 2) == 0);
+    REQUIRE(BoundedSubstringEditDistance("visual studio code", "studio", 2) == 0);
+    REQUIRE(BoundedSubstringEditDistance("visual studio code", "stuido", 2) == 2);
+    REQUIRE(BoundedSubstringEditDistance("visual studio code", "studo", 2) == 1);
+    REQUIRE(BoundedSubstringEditDistance("visual studio code", "xyz", 1) == 2);
+    REQUIRE(BoundedSubstringEditDistance("", "abc", 5) == 3);
+    REQUIRE(BoundedSubstringEditDistance("ab", "abc", 5) == 1);
+
+    // Longer than a machine word
+    std::string longValue = std::string(80, 'x') + "needle" + std::string(80, 'y');
+    std::string longPattern = std::string(30, 'x') + "neddle" + std::string(30, 'y');
+    REQUIRE(BoundedSubstringEditDistance(longValue, longPattern, 3) == 1);
 }
 
 TEST_CASE("ExpandEnvironmentVariables", "[strings]")
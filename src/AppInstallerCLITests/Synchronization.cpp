@@ -27,6 +27,33 @@ TEST_CASE("CPRWL_MultipleReaders", "[CrossProcessReaderWriteLock]")
     REQUIRE(signal.wait(1000));
 }
 
+TEST_CASE("CPRWL_MaximumReaders", "[CrossProcessReaderWriteLock]")
+{
+    std::string name = "AppInstCPRWLTests";
+    size_t readerCount = CrossProcessReaderWriteLock::GetMaximumReaderCount();
+
+    // All of the readers hold the lock until every one of them has acquired it
+    std::atomic<size_t> acquiredCount = 0;
+    wil::unique_event allAcquired;
+    allAcquired.create(wil::EventOptions::ManualReset);
+
+    for (size_t i = 0; i < readerCount; ++i)
+    {
+        std::thread readerThread([&name, &acquiredCount, &allAcquired, readerCount]() {
+            CrossProcessReaderWriteLock readerLock = CrossProcessReaderWriteLock::LockShared(name);
+            if (++acquiredCount == readerCount)
+            {
+                allAcquired.SetEvent();
+            }
+            allAcquired.wait(5000);
+            });
+        // In the event of bugs, we don't want to block the test waiting forever
+        readerThread.detach();
+    }
+
+    REQUIRE(allAcquired.wait(5000));
+}
+
 TEST_CASE("CPRWL_WriterBlocksReader", "[CrossProcessReaderWriteLock]")
 {
     std::string name = "AppInstCPRWLTests";
@@ -123,3 +150,113 @@ TEST_CASE("CPRWL_CancelEndsWait", "[CrossProcessReaderWriteLock]")
     // Upon release of the writer, the other thread should signal
     REQUIRE(signal.wait(1000));
 }
+
+TEST_CASE("CPRWL_TimeoutEndsWait", "[CrossProcessReaderWriteLock]")
+{
+    std::string name = "AppInstCPRWLTests";
+
+    CrossProcessReaderWriteLock mainThreadLock = CrossProcessReaderWriteLock::LockShared(name);
+
+    bool acquired = true;
+    std::thread otherThread([&name, &acquired]() {
+        CrossProcessReaderWriteLock otherThreadLock = CrossProcessReaderWriteLock::LockExclusive(name, 100ms);
+        acquired = static_cast<bool>(otherThreadLock);
+        });
+
+    otherThread.join();
+    REQUIRE(!acquired);
+}
+
+TEST_CASE("RunConcurrently_CallsEachIndexOnce", "[RunConcurrently]")
+{
+    constexpr size_t s_count = 100;
+    std::vector<std::atomic<int>> calls(s_count);
+
+    RunConcurrently(s_count, [&](size_t i) { ++calls[i]; });
+
+    for (const auto& call : calls)
+    {
+        REQUIRE(call == 1);
+    }
+}
+
+TEST_CASE("RunConcurrently_RethrowsLowestIndex", "[RunConcurrently]")
+{
+    std::atomic<size_t> completed = 0;
+
+    REQUIRE_THROWS_HR(RunConcurrently(10, [&](size_t i)
+        {
+            if (i == 3)
+            {
+                THROW_HR(E_INVALIDARG);
+            }
+            else if (i == 7)
+            {
+                THROW_HR(E_ABORT);
+            }
+
+            ++completed;
+        }), E_INVALIDARG);
+
+    // The work for the other indices is not abandoned
+    REQUIRE(completed == 8);
+}
+
+TEST_CASE("RunConcurrently_Nested", "[RunConcurrently]")
+{
+    // More outer calls than there are threads in the pool, each of which waits on calls of its own
+    size_t outerCount = 4 * std::max(1u, std::thread::hardware_concurrency());
+    constexpr size_t s_innerCount = 8;
+    std::atomic<size_t> calls = 0;
+
+    RunConcurrently(outerCount, [&](size_t)
+        {
+            RunConcurrently(s_innerCount, [&](size_t) { ++calls; });
+        });
+
+    REQUIRE(calls == outerCount * s_innerCount);
+}
+
+TEST_CASE("SubmitWork_RunsOnEachLane", "[RunConcurrently]")
+{
+    for (auto lane : { WorkLane::Cpu, WorkLane::Io })
+    {
+        std::promise<std::thread::id> ranOn;
+        auto result = ranOn.get_future();
+
+        SubmitWork(lane, [&]() { ranOn.set_value(std::this_thread::get_id()); });
+
+        REQUIRE(result.wait_for(10s) == std::future_status::ready);
+        REQUIRE(result.get() != std::this_thread::get_id());
+    }
+}
+
+TEST_CASE("CrossProcessClaim_OneClaimPerPeriod", "[CrossProcessClaim]")
+{
+    std::string name = "AppInstCPCTest_OneClaimPerPeriod";
+
+    CrossProcessClaim first = CrossProcessClaim::TryClaim(name, 1h);
+    REQUIRE(first);
+
+    // While the first is held, the work cannot be claimed again
+    CrossProcessClaim second = CrossProcessClaim::TryClaim(name, 1h);
+    REQUIRE(!second);
+
+    // A claim that is older than the period does not prevent another
+    CrossProcessClaim third = CrossProcessClaim::TryClaim(name, 0ms);
+    REQUIRE(third);
+}
+
+TEST_CASE("CrossProcessClaim_Abandon", "[CrossProcessClaim]")
+{
+    std::string name = "AppInstCPCTest_Abandon";
+
+    CrossProcessClaim first = CrossProcessClaim::TryClaim(name, 1h);
+    REQUIRE(first);
+
+    first.Abandon();
+    REQUIRE(!first);
+
+    CrossProcessClaim second = CrossProcessClaim::TryClaim(name, 1h);
+    REQUIRE(second);
+}
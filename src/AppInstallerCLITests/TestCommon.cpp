@@ -6,6 +6,13 @@
 #include "winget/GroupPolicy.h"
 #include "winget/UserSettings.h"
 
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <numeric>
+#include <optional>
+
 namespace TestCommon
 {
     namespace
@@ -36,6 +43,57 @@ namespace TestCommon
 
         static std::filesystem::path s_TestDataFileBasePath{};
 
+        struct BenchmarkResult
+        {
+            size_t Iterations = 0;
+            size_t ItemCount = 0;
+            double MinimumMicroseconds = 0;
+            double MedianMicroseconds = 0;
+            double MeanMicroseconds = 0;
+        };
+
+        static std::optional<std::filesystem::path> s_BenchmarkOutputPath;
+        static std::map<std::string, BenchmarkResult> s_BenchmarkResults;
+
+        // The names are all chosen by the benchmarks themselves, so only the characters that JSON requires are escaped.
+        std::string EscapeForJson(std::string_view value)
+        {
+            std::string result;
+            for (char c : value)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    result += '\\';
+                }
+                result += c;
+            }
+            return result;
+        }
+
+        void WriteBenchmarkResults(const std::filesystem::path& path)
+        {
+            std::ofstream stream{ path, std::ios_base::out | std::ios_base::trunc };
+            stream << std::fixed << std::setprecision(3);
+            stream << "{\n  \"formatVersion\": 1,\n  \"benchmarks\": {";
+
+            bool first = true;
+            for (const auto& [name, result] : s_BenchmarkResults)
+            {
+                double itemsPerSecond = result.MedianMicroseconds > 0 ? (result.ItemCount * 1000000.0 / result.MedianMicroseconds) : 0;
+
+                stream << (first ? "\n" : ",\n") << "    \"" << EscapeForJson(name) << "\": { " <<
+                    "\"iterations\": " << result.Iterations << ", " <<
+                    "\"items\": " << result.ItemCount << ", " <<
+                    "\"minimumMicroseconds\": " << result.MinimumMicroseconds << ", " <<
+                    "\"medianMicroseconds\": " << result.MedianMicroseconds << ", " <<
+                    "\"meanMicroseconds\": " << result.MeanMicroseconds << ", " <<
+                    "\"itemsPerSecond\": " << itemsPerSecond << " }";
+                first = false;
+            }
+
+            stream << "\n  }\n}\n";
+        }
+
         bool CleanVolatileTestRoot(HKEY root)
         {
             THROW_IF_WIN32_ERROR(RegDeleteTreeW(root, nullptr));
@@ -134,6 +192,47 @@ namespace TestCommon
         s_TestDataFileBasePath = path;
     }
 
+    void BenchmarkResults::SetOutputPath(const std::filesystem::path& path)
+    {
+        s_BenchmarkOutputPath = path;
+    }
+
+    void BenchmarkResults::Measure(std::string_view name, size_t iterations, size_t itemCount, const std::function<void()>& function)
+    {
+        THROW_HR_IF(E_INVALIDARG, iterations == 0);
+
+        function();
+
+        std::vector<double> durations;
+        durations.reserve(iterations);
+
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            function();
+            auto end = std::chrono::steady_clock::now();
+            durations.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+        }
+
+        std::sort(durations.begin(), durations.end());
+
+        BenchmarkResult result;
+        result.Iterations = iterations;
+        result.ItemCount = itemCount;
+        result.MinimumMicroseconds = durations.front();
+        result.MedianMicroseconds = durations[durations.size() / 2];
+        result.MeanMicroseconds = std::accumulate(durations.begin(), durations.end(), 0.0) / durations.size();
+
+        WARN(name << ": median " << result.MedianMicroseconds << "us, minimum " << result.MinimumMicroseconds << "us, mean " << result.MeanMicroseconds << "us over " << iterations << " iterations of " << itemCount << " items");
+
+        s_BenchmarkResults[std::string{ name }] = result;
+
+        if (s_BenchmarkOutputPath)
+        {
+            WriteBenchmarkResults(s_BenchmarkOutputPath.value());
+        }
+    }
+
     void TestProgress::OnProgress(uint64_t current, uint64_t maximum, AppInstaller::ProgressType type)
     {
         if (m_OnProgress)
@@ -202,9 +301,14 @@ namespace TestCommon
 
     TestUserSettings::TestUserSettings(bool keepFileSettings)
     {
-        if (!keepFileSettings)
+        // Validate the file settings now, so that those that are set are not replaced when they are read.
+        if (keepFileSettings)
+        {
+            ValidateAll();
+        }
+        else
         {
-            m_settings.clear();
+            ResetToDefaults();
         }
 
         AppInstaller::Settings::SetUserSettingsOverride(this);
@@ -68,6 +68,18 @@ namespace TestCommon
         std::filesystem::path m_path;
     };
 
+    // Measures the benchmark test cases and collects their results.
+    // When an output path is set, all results so far are written to it as JSON after each measurement;
+    // the output is ordered by benchmark name so that files from different runs can be compared directly.
+    struct BenchmarkResults
+    {
+        static void SetOutputPath(const std::filesystem::path& path);
+
+        // Runs the function once to warm up, then the given number of times while measuring it.
+        // The item count is the amount of work done by each run, to report throughput.
+        static void Measure(std::string_view name, size_t iterations, size_t itemCount, const std::function<void()>& function);
+    };
+
     // Matcher that lets us verify wil::ResultExceptions have a specific HR.
     struct ResultExceptionHRMatcher : public Catch::MatcherBase<wil::ResultException>
     {
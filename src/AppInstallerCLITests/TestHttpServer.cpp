@@ -0,0 +1,279 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestHttpServer.h"
+#include <AppInstallerStrings.h>
+
+using namespace AppInstaller::Utility;
+
+namespace TestCommon
+{
+    namespace
+    {
+        bool SendAll(SOCKET connection, const char* data, size_t size)
+        {
+            while (size > 0)
+            {
+                int sent = send(connection, data, static_cast<int>(std::min<size_t>(size, INT_MAX)), 0);
+                if (sent <= 0)
+                {
+                    return false;
+                }
+
+                data += sent;
+                size -= static_cast<size_t>(sent);
+            }
+
+            return true;
+        }
+
+        // Parses a Range header of the form "bytes=<first>-[<last>]" into [begin, end) of the body.
+        bool ParseRange(const std::string& range, size_t bodySize, size_t& begin, size_t& end)
+        {
+            constexpr std::string_view s_prefix = "bytes=";
+            size_t dash = range.find('-');
+            if (!CaseInsensitiveStartsWith(range, s_prefix) || dash == std::string::npos)
+            {
+                return false;
+            }
+
+            try
+            {
+                begin = std::stoull(range.substr(s_prefix.size(), dash - s_prefix.size()));
+                std::string last = range.substr(dash + 1);
+                end = (last.empty() ? bodySize : std::min<size_t>(bodySize, std::stoull(last) + 1));
+            }
+            catch (...)
+            {
+                return false;
+            }
+
+            return begin < end;
+        }
+    }
+
+    TestHttpServer::TestHttpServer()
+    {
+        WSADATA data{};
+        THROW_IF_WIN32_ERROR(WSAStartup(MAKEWORD(2, 2), &data));
+
+        m_listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        THROW_LAST_ERROR_IF(m_listener == INVALID_SOCKET);
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        THROW_LAST_ERROR_IF(bind(m_listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == SOCKET_ERROR);
+        THROW_LAST_ERROR_IF(listen(m_listener, SOMAXCONN) == SOCKET_ERROR);
+
+        int addressSize = sizeof(address);
+        THROW_LAST_ERROR_IF(getsockname(m_listener, reinterpret_cast<sockaddr*>(&address), &addressSize) == SOCKET_ERROR);
+        m_port = ntohs(address.sin_port);
+
+        m_acceptThread = std::thread([this]() { AcceptConnections(); });
+    }
+
+    TestHttpServer::~TestHttpServer()
+    {
+        // Closing the listener ends the accept loop; shutting down the open connections ends any that wait on the client.
+        closesocket(m_listener);
+        m_acceptThread.join();
+
+        std::vector<std::thread> connectionThreads;
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+            for (SOCKET connection : m_openConnections)
+            {
+                shutdown(connection, SD_BOTH);
+            }
+
+            connectionThreads = std::move(m_connectionThreads);
+        }
+
+        for (auto& thread : connectionThreads)
+        {
+            thread.join();
+        }
+
+        WSACleanup();
+    }
+
+    void TestHttpServer::SetContent(const std::string& path, Content content)
+    {
+        std::lock_guard<std::mutex> lock{ m_lock };
+        m_content[path] = std::move(content);
+    }
+
+    std::string TestHttpServer::GetUrl(const std::string& path) const
+    {
+        return "http://127.0.0.1:" + std::to_string(m_port) + path;
+    }
+
+    std::vector<TestHttpServer::Request> TestHttpServer::GetRequests() const
+    {
+        std::lock_guard<std::mutex> lock{ m_lock };
+        return m_requests;
+    }
+
+    void TestHttpServer::AcceptConnections()
+    {
+        for (;;)
+        {
+            SOCKET connection = accept(m_listener, nullptr, nullptr);
+            if (connection == INVALID_SOCKET)
+            {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock{ m_lock };
+            m_openConnections.insert(connection);
+            m_connectionThreads.emplace_back([this, connection]() { ServeConnection(connection); });
+        }
+    }
+
+    void TestHttpServer::ServeConnection(SOCKET connection)
+    {
+        auto closeConnection = wil::scope_exit([&]()
+            {
+                {
+                    std::lock_guard<std::mutex> lock{ m_lock };
+                    m_openConnections.erase(connection);
+                }
+
+                closesocket(connection);
+            });
+
+        std::string requestText;
+        while (requestText.find("\r\n\r\n") == std::string::npos)
+        {
+            char buffer[4096];
+            int received = recv(connection, buffer, sizeof(buffer), 0);
+            if (received <= 0)
+            {
+                return;
+            }
+
+            requestText.append(buffer, static_cast<size_t>(received));
+        }
+
+        // The request line is "<method> <path> <version>", followed by a header on each line.
+        std::istringstream lines{ requestText.substr(0, requestText.find("\r\n\r\n")) };
+        std::string line;
+        std::getline(lines, line);
+
+        Request request;
+        size_t pathStart = line.find(' ');
+        size_t pathEnd = (pathStart == std::string::npos ? std::string::npos : line.find(' ', pathStart + 1));
+        if (pathEnd == std::string::npos)
+        {
+            return;
+        }
+
+        request.Path = line.substr(pathStart + 1, pathEnd - pathStart - 1);
+
+        while (std::getline(lines, line))
+        {
+            size_t colon = line.find(':');
+            if (colon == std::string::npos)
+            {
+                continue;
+            }
+
+            std::string name = line.substr(0, colon);
+            std::string value = Trim(line.substr(colon + 1));
+
+            if (CaseInsensitiveEquals(name, "Range"))
+            {
+                request.Range = value;
+            }
+            else if (CaseInsensitiveEquals(name, "If-Range"))
+            {
+                request.IfRange = value;
+            }
+        }
+
+        Content content;
+        bool found = false;
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+            m_requests.emplace_back(request);
+
+            auto itr = m_content.find(request.Path);
+            if (itr != m_content.end())
+            {
+                content = itr->second;
+                found = true;
+            }
+        }
+
+        if (!found)
+        {
+            constexpr std::string_view s_notFound = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+            SendAll(connection, s_notFound.data(), s_notFound.size());
+            return;
+        }
+
+        size_t begin = 0;
+        size_t end = content.Body.size();
+        bool sendRange = !request.Range.empty() && content.SupportsRange &&
+            (request.IfRange.empty() || request.IfRange == content.ETag || request.IfRange == content.LastModified) &&
+            ParseRange(request.Range, content.Body.size(), begin, end);
+
+        if (!sendRange)
+        {
+            begin = 0;
+            end = content.Body.size();
+        }
+
+        std::ostringstream headers;
+        if (sendRange)
+        {
+            headers << "HTTP/1.1 206 Partial Content\r\n";
+            headers << "Content-Range: bytes " << begin << '-' << (end - 1) << '/' << content.Body.size() << "\r\n";
+        }
+        else
+        {
+            headers << "HTTP/1.1 200 OK\r\n";
+        }
+
+        headers << "Content-Length: " << (end - begin) << "\r\n";
+        headers << "Content-Type: application/octet-stream\r\n";
+        if (content.SupportsRange)
+        {
+            headers << "Accept-Ranges: bytes\r\n";
+        }
+        if (!content.ETag.empty())
+        {
+            headers << "ETag: " << content.ETag << "\r\n";
+        }
+        if (!content.LastModified.empty())
+        {
+            headers << "Last-Modified: " << content.LastModified << "\r\n";
+        }
+        // Keep the responses out of the WinINet cache, as the same url may return different content during a test.
+        headers << "Cache-Control: no-store\r\n";
+        headers << "Connection: close\r\n\r\n";
+
+        std::string headerText = headers.str();
+        if (!SendAll(connection, headerText.data(), headerText.size()))
+        {
+            return;
+        }
+
+        for (size_t offset = begin; offset < end; offset += content.PartSize)
+        {
+            if (content.BeforeSend && !content.BeforeSend(offset))
+            {
+                return;
+            }
+
+            if (!SendAll(connection, content.Body.data() + offset, std::min(content.PartSize, end - offset)))
+            {
+                return;
+            }
+        }
+
+        shutdown(connection, SD_SEND);
+    }
+}
@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace TestCommon
+{
+    // A minimal HTTP/1.1 server on the loopback interface, so that downloads can be tested without the network.
+    // Every connection is served on its own thread, and is closed after one response.
+    struct TestHttpServer
+    {
+        // What the server returns for a path.
+        struct Content
+        {
+            std::string Body;
+            // Sent in the ETag and Last-Modified headers if not empty; If-Range is compared with them.
+            std::string ETag;
+            std::string LastModified;
+            // Whether a Range header is answered with that range; if not, the entire body is returned.
+            bool SupportsRange = true;
+            // The size of the parts that the body is sent in.
+            size_t PartSize = 64 * 1024;
+            // Called on the connection thread before each part of the body is sent, with the offset of the part in the body.
+            // Returning false closes the connection without sending the rest.
+            std::function<bool(size_t offset)> BeforeSend;
+        };
+
+        // A request that the server received.
+        struct Request
+        {
+            std::string Path;
+            // The values of the Range and If-Range headers; empty if they were not sent.
+            std::string Range;
+            std::string IfRange;
+        };
+
+        TestHttpServer();
+        ~TestHttpServer();
+
+        TestHttpServer(const TestHttpServer&) = delete;
+        TestHttpServer& operator=(const TestHttpServer&) = delete;
+
+        // Sets what is returned for the path, which starts with a '/'.
+        void SetContent(const std::string& path, Content content);
+
+        // Gets the url of the path.
+        std::string GetUrl(const std::string& path) const;
+
+        // Gets the requests received so far, in the order that they arrived.
+        std::vector<Request> GetRequests() const;
+
+    private:
+        void AcceptConnections();
+        void ServeConnection(SOCKET connection);
+
+        SOCKET m_listener = INVALID_SOCKET;
+        unsigned short m_port = 0;
+        std::thread m_acceptThread;
+
+        mutable std::mutex m_lock;
+        std::map<std::string, Content> m_content;
+        std::vector<Request> m_requests;
+        std::set<SOCKET> m_openConnections;
+        std::vector<std::thread> m_connectionThreads;
+    };
+}
@@ -9,13 +9,28 @@ using namespace AppInstaller::Settings;
 
 namespace TestCommon
 {
+    namespace
+    {
+        // The compact source metadata is only read along with the YAML metadata it was written after;
+        // the tests that set the YAML metadata expect it to be what is read, even if it is the same as before.
+        void RemoveCompactSourcesMetadataFor(const AppInstaller::Settings::StreamDefinition& stream)
+        {
+            if (stream.Name == Stream::SourcesMetadata.Name)
+            {
+                Stream{ Stream::SourcesMetadataCompact }.Remove();
+            }
+        }
+    }
+
     void SetSetting(const AppInstaller::Settings::StreamDefinition& stream, std::string_view value)
     {
+        RemoveCompactSourcesMetadataFor(stream);
         REQUIRE(Stream{ stream }.Set(value));
     }
 
     void RemoveSetting(const AppInstaller::Settings::StreamDefinition& stream)
     {
+        RemoveCompactSourcesMetadataFor(stream);
         Stream{ stream }.Remove();
     }
 
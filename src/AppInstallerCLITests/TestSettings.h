@@ -20,6 +20,11 @@ namespace TestCommon
     const std::wstring AllowedSourcesPolicyValueName = L"EnableAllowedSources";
 
     const std::wstring SourceUpdateIntervalPolicyValueName = L"SourceAutoUpdateIntervalInMinutes";
+    const std::wstring InstallerCacheLocationPolicyValueName = L"InstallerCacheLocation";
+    const std::wstring InstallerCacheMaximumSizePolicyValueName = L"InstallerCacheMaximumSizeInMB";
+    const std::wstring MaximumConcurrentDownloadsPolicyValueName = L"MaximumConcurrentDownloads";
+    const std::wstring DownloadBandwidthLimitPolicyValueName = L"DownloadBandwidthLimitInKBps";
+    const std::wstring BackgroundDownloadsPolicyValueName = L"BackgroundDownloads";
 
     const std::wstring AdditionalSourcesPolicyKeyName = L"AdditionalSources";
     const std::wstring AllowedSourcesPolicyKeyName = L"AllowedSources";
@@ -281,6 +281,77 @@ TEST_CASE("SettingAutoUpdateIntervalInMinutes", "[settings]")
     }
 }
 
+TEST_CASE("SettingNetworkDownloadSegments", "[settings]")
+{
+    DeleteUserSettingsFiles();
+
+    SECTION("Default value")
+    {
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkDownloadSegments>() == 4);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Valid value")
+    {
+        std::string_view json = R"({ "network": { "downloadSegments": 1 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkDownloadSegments>() == 1);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Invalid value 0")
+    {
+        std::string_view json = R"({ "network": { "downloadSegments": 0 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkDownloadSegments>() == 4);
+        REQUIRE(userSettingTest.GetWarnings().size() == 1);
+    }
+    SECTION("Invalid value too large")
+    {
+        std::string_view json = R"({ "network": { "downloadSegments": 64 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkDownloadSegments>() == 4);
+        REQUIRE(userSettingTest.GetWarnings().size() == 1);
+    }
+}
+
+TEST_CASE("SettingNetworkDownloadAhead", "[settings]")
+{
+    DeleteUserSettingsFiles();
+
+    SECTION("Default value")
+    {
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkDownloadAhead>() == 1);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Disabled")
+    {
+        std::string_view json = R"({ "network": { "downloadAhead": 0 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkDownloadAhead>() == 0);
+        REQUIRE(userSettingTest.GetWarnings().size() == 0);
+    }
+    SECTION("Invalid value too large")
+    {
+        std::string_view json = R"({ "network": { "downloadAhead": 20 } })";
+        SetSetting(Stream::PrimaryUserSettings, json);
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::NetworkDownloadAhead>() == 1);
+        REQUIRE(userSettingTest.GetWarnings().size() == 1);
+    }
+}
+
 TEST_CASE("SettingsExperimentalCmd", "[settings]")
 {
     DeleteUserSettingsFiles();
@@ -335,3 +406,29 @@ TEST_CASE("SettingsExperimentalCmd", "[settings]")
         REQUIRE(userSettingTest.GetWarnings().size() == 0);
     }
 }
+
+TEST_CASE("SettingsValidatedWhenRead", "[settings]")
+{
+    DeleteUserSettingsFiles();
+
+    std::string_view json = R"({ "visual": { "progressBar": "fake" }, "experimentalFeatures": { "experimentalCmd": true } })";
+    SetSetting(Stream::PrimaryUserSettings, json);
+
+    SECTION("Warnings without reading")
+    {
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.GetWarnings().size() == 1);
+        REQUIRE(userSettingTest.Get<Setting::ProgressBarVisualStyle>() == VisualStyle::Accent);
+        REQUIRE(userSettingTest.Get<Setting::EFExperimentalCmd>());
+    }
+    SECTION("Warnings after reading")
+    {
+        UserSettingsTest userSettingTest;
+
+        REQUIRE(userSettingTest.Get<Setting::EFExperimentalCmd>());
+        REQUIRE(userSettingTest.Get<Setting::ProgressBarVisualStyle>() == VisualStyle::Accent);
+        REQUIRE(userSettingTest.Get<Setting::ProgressBarVisualStyle>() == VisualStyle::Accent);
+        REQUIRE(userSettingTest.GetWarnings().size() == 1);
+    }
+}
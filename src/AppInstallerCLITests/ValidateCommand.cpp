@@ -0,0 +1,123 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include "TestSettings.h"
+#include "Commands/ValidateCommand.h"
+#include <json.h>
+
+using namespace std::string_literals;
+using namespace TestCommon;
+using namespace AppInstaller::CLI;
+
+namespace
+{
+    std::vector<Json::Value> ParseJsonLines(const std::string& output)
+    {
+        std::vector<Json::Value> result;
+        std::istringstream stream{ output };
+        std::string line;
+
+        while (std::getline(stream, line))
+        {
+            Json::Value value;
+            Json::CharReaderBuilder builder;
+            std::string errors;
+            std::istringstream lineStream{ line };
+            REQUIRE(Json::parseFromStream(builder, lineStream, &value, &errors));
+            result.emplace_back(std::move(value));
+        }
+
+        return result;
+    }
+}
+
+TEST_CASE("ValidateCommandRecursive", "[ValidateCommand]")
+{
+    TempDirectory tempDirectory{ "ValidateCommandTest" };
+    std::filesystem::path good = tempDirectory.GetPath() / "good" / "1.0";
+    std::filesystem::path bad = tempDirectory.GetPath() / "bad" / "1.0";
+    std::filesystem::create_directories(good);
+    std::filesystem::create_directories(bad);
+    std::filesystem::copy(TestDataFile("MultiFileManifestV1").GetPath(), good);
+    std::filesystem::copy_file(TestDataFile("Manifest-Bad-ArchInvalid.yaml").GetPath(), bad / "Manifest-Bad-ArchInvalid.yaml");
+
+    std::ostringstream validateOutput;
+    Execution::Context context{ validateOutput, std::cin };
+    context.Args.AddArg(Execution::Args::Type::ValidateManifest, tempDirectory.GetPath().u8string());
+    context.Args.AddArg(Execution::Args::Type::ValidateRecurse);
+    ValidateCommand validateCommand({});
+
+    validateCommand.Execute(context);
+
+    REQUIRE(context.IsTerminated());
+    REQUIRE(context.GetTerminationHR() == APPINSTALLER_CLI_ERROR_MANIFEST_VALIDATION_FAILURE);
+
+    // Each manifest directory is one line, and the manifests are not merged with each other
+    auto results = ParseJsonLines(validateOutput.str());
+    REQUIRE(results.size() == 2);
+
+    const Json::Value& badResult = (results[0]["path"].asString() == bad.u8string() ? results[0] : results[1]);
+    REQUIRE(badResult["path"].asString() == bad.u8string());
+    REQUIRE(badResult["result"].asString() == "Failure");
+    REQUIRE(badResult["hresult"].asInt() == APPINSTALLER_CLI_ERROR_MANIFEST_VALIDATION_FAILURE);
+    REQUIRE(!badResult["message"].asString().empty());
+}
+
+TEST_CASE("ValidateCommandMultiplePaths_Dependencies", "[ValidateCommand][dependencies]")
+{
+    TestUserSettings settings;
+    settings.Set<AppInstaller::Settings::Setting::EFDependencies>({ true });
+
+    std::filesystem::path good = TestDataFile("Manifest-Good-AllDependencyTypes.yaml").GetPath();
+    std::filesystem::path bad = TestDataFile("Manifest-Bad-ArchInvalid.yaml").GetPath();
+
+    std::ostringstream validateOutput;
+    Execution::Context context{ validateOutput, std::cin };
+    context.Args.AddArg(Execution::Args::Type::ValidateManifest, good.u8string());
+    context.Args.AddArg(Execution::Args::Type::ValidateManifest, bad.u8string());
+    ValidateCommand validateCommand({});
+
+    validateCommand.Execute(context);
+    INFO(validateOutput.str());
+
+    auto results = ParseJsonLines(validateOutput.str());
+    REQUIRE(results.size() == 2);
+
+    const Json::Value& goodResult = (results[0]["path"].asString() == good.u8string() ? results[0] : results[1]);
+    const Json::Value& badResult = (results[0]["path"].asString() == good.u8string() ? results[1] : results[0]);
+
+    // Each manifest reports the dependencies of its own installers, as a single manifest does
+    REQUIRE(goodResult["result"].asString() == "Success");
+    const Json::Value& dependencies = goodResult["dependencies"];
+    REQUIRE(dependencies["WindowsFeatures"].size() == 2);
+    REQUIRE(dependencies["WindowsLibraries"][0].asString() == "WindowsLibrariesDep");
+    REQUIRE(dependencies["ExternalDependencies"][0].asString() == "ExternalDep");
+
+    const Json::Value& packages = dependencies["PackageDependencies"];
+    REQUIRE(packages.size() == 2);
+    const Json::Value& dep1 = (packages[0]["PackageIdentifier"].asString() == "Package.Dep1-x64" ? packages[0] : packages[1]);
+    const Json::Value& dep2 = (packages[0]["PackageIdentifier"].asString() == "Package.Dep1-x64" ? packages[1] : packages[0]);
+    REQUIRE(dep1["MinimumVersion"].asString() == "1.0");
+    REQUIRE(dep2["PackageIdentifier"].asString() == "Package.Dep2-x64");
+    REQUIRE(!dep2.isMember("MinimumVersion"));
+
+    REQUIRE(badResult["result"].asString() == "Failure");
+    REQUIRE(!badResult.isMember("dependencies"));
+}
+
+TEST_CASE("ValidateCommandMultiplePaths_Missing", "[ValidateCommand]")
+{
+    TempDirectory tempDirectory{ "ValidateCommandTest" };
+
+    std::ostringstream validateOutput;
+    Execution::Context context{ validateOutput, std::cin };
+    context.Args.AddArg(Execution::Args::Type::ValidateManifest, TestDataFile("Manifest-Bad-ArchInvalid.yaml").GetPath().u8string());
+    context.Args.AddArg(Execution::Args::Type::ValidateManifest, (tempDirectory.GetPath() / "missing.yaml").u8string());
+    ValidateCommand validateCommand({});
+
+    validateCommand.Execute(context);
+
+    REQUIRE(context.IsTerminated());
+    REQUIRE(context.GetTerminationHR() == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND));
+}
@@ -87,6 +87,8 @@ void RequireLessThan(std::string_view a, std::string_view b)
     REQUIRE_FALSE(vA >= vB);
     REQUIRE_FALSE(vA == vB);
     REQUIRE(vA != vB);
+
+    REQUIRE(vA.GetSortKey() < vB.GetSortKey());
 }
 
 void RequireEqual(std::string_view a, std::string_view b)
@@ -98,6 +100,8 @@ void RequireEqual(std::string_view a, std::string_view b)
     REQUIRE_FALSE(vA != vB);
     REQUIRE(vA <= vB);
     REQUIRE(vA >= vB);
+
+    REQUIRE(vA.GetSortKey() == vB.GetSortKey());
     REQUIRE_FALSE(vA < vB);
     REQUIRE_FALSE(vA > vB);
 }
@@ -115,6 +119,37 @@ TEST_CASE("VersionCompare", "[versions]")
     RequireEqual("1.0", "1.0.0");
 }
 
+TEST_CASE("VersionSortKey", "[versions]")
+{
+    RequireLessThan("1.0", "1.0.a");
+    RequireLessThan("1.1a", "1.1");
+    RequireLessThan("1.alpha", "1.beta");
+    RequireLessThan("1.a", "1.ab");
+    RequireLessThan("255", "256");
+    RequireLessThan("65535", "65536");
+    RequireLessThan("4294967296", "18446744073709551615");
+    RequireLessThan("", "0.1");
+    RequireLessThan("unknown", "");
+    RequireLessThan("", "latest");
+
+    RequireEqual("", "0.0");
+    RequireEqual("1.2-beta", "1.2-beta.0");
+
+    // Compare every pair against the part by part comparison.
+    std::vector<std::string> versions{ "", "0", "1", "1.0.1", "1.0-preview", "1.1", "1.1a", "1.1b", "1.a", "2", "10", "300.0.1", "unknown", "latest", "v1", "1.2.3.4.5" };
+    for (const auto& a : versions)
+    {
+        for (const auto& b : versions)
+        {
+            INFO(a << " | " << b);
+            Version vA{ a };
+            Version vB{ b };
+            REQUIRE((vA < vB) == (vA.GetSortKey() < vB.GetSortKey()));
+            REQUIRE((vA == vB) == (vA.GetSortKey() == vB.GetSortKey()));
+        }
+    }
+}
+
 TEST_CASE("VersionAndChannelSort", "[versions]")
 {
     std::vector<VersionAndChannel> sortedList =
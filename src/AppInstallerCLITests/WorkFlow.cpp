@@ -23,6 +23,7 @@
 #include <Workflows/ShellExecuteInstallerHandler.h>
 #include <Workflows/WorkflowBase.h>
 #include <Public/winget/RepositorySource.h>
+#include <Commands/CacheCommand.h>
 #include <Commands/ExportCommand.h>
 #include <Commands/ImportCommand.h>
 #include <Commands/InstallCommand.h>
@@ -35,7 +36,9 @@
 #include <winget/LocIndependent.h>
 #include <winget/ManifestYamlParser.h>
 #include <Resources.h>
+#include <StructuredOutput.h>
 #include <AppInstallerFileLogger.h>
+#include <Commands/RootCommand.h>
 #include <Commands/ValidateCommand.h>
 #include <winget/Settings.h>
 
@@ -111,6 +114,23 @@ namespace
         {
             SearchResult result;
 
+            // Search for each inclusion on its own, reporting the inclusion as the match criteria
+            if (!request.Query && request.Inclusions.size() > 1)
+            {
+                for (const auto& inclusion : request.Inclusions)
+                {
+                    SearchRequest singleRequest = request;
+                    singleRequest.Inclusions = { inclusion };
+
+                    for (auto& match : Search(singleRequest).Matches)
+                    {
+                        result.Matches.emplace_back(std::move(match.Package), inclusion);
+                    }
+                }
+
+                return result;
+            }
+
             std::string input;
 
             if (request.Query)
@@ -572,6 +592,10 @@ void OverrideForMSIX(TestContext& context)
 
         file.close();
     } });
+
+    context.Override({ StageMsixInstaller, [](TestContext&)
+    {
+    } });
 }
 
 void OverrideForMSIXUninstall(TestContext& context)
@@ -830,6 +854,39 @@ TEST_CASE("MsixInstallFlow_StreamingFlow", "[InstallFlow][workflow]")
     REQUIRE(uri.SchemeName() == L"https");
 }
 
+TEST_CASE("MsixInstallFlow_StagingFlow", "[InstallFlow][workflow]")
+{
+    TestCommon::TempFile installResultPath("TestMsixInstalled.txt");
+
+    TestCommon::TestUserSettings testSettings;
+    testSettings.Set<Setting::EFStreamingMsix>(true);
+
+    std::ostringstream installOutput;
+    TestContext context{ installOutput, std::cin };
+    auto previousThreadGlobals = context.SetForCurrentThread();
+    OverrideForMSIX(context);
+    OverrideForCheckExistingInstaller(context);
+    context.Override({ StageMsixAndComputeHash, [](TestContext& context)
+    {
+        const auto& installer = context.Get<Execution::Data::Installer>().value();
+        context.Add<Data::HashPair>({ installer.Sha256, installer.Sha256 });
+    } });
+    context.Args.AddArg(Execution::Args::Type::Manifest, TestDataFile("InstallFlowTest_Msix_DownloadFlow.yaml").GetPath().u8string());
+
+    InstallCommand install({});
+    install.Execute(context);
+    INFO(installOutput.str());
+
+    // Verify the package is installed from its url rather than a downloaded file.
+    REQUIRE(std::filesystem::exists(installResultPath.GetPath()));
+    std::ifstream installResultFile(installResultPath.GetPath());
+    REQUIRE(installResultFile.is_open());
+    std::string installResultStr;
+    std::getline(installResultFile, installResultStr);
+    Uri uri = Uri(ConvertToUTF16(installResultStr));
+    REQUIRE(uri.SchemeName() == L"https");
+}
+
 TEST_CASE("MsiInstallFlow_DirectMsi", "[InstallFlow][workflow]")
 {
     TestCommon::TempFile installResultPath("TestMsiInstalled.txt");
@@ -1562,6 +1619,104 @@ TEST_CASE("UpdateFlow_UpdateAllApplicable", "[UpdateFlow][workflow]")
     REQUIRE(std::filesystem::exists(updateMSStoreResultPath.GetPath()));
 }
 
+TEST_CASE("UpdateFlow_UpgradeSummary", "[UpdateFlow][workflow]")
+{
+    std::ostringstream updateOutput;
+    TestContext context{ updateOutput, std::cin };
+    auto previousThreadGlobals = context.SetForCurrentThread();
+    OverrideForCompositeInstalledSource(context);
+    context.Args.AddArg(Execution::Args::Type::UpgradeSummary);
+
+    UpgradeCommand update({});
+    update.Execute(context);
+    INFO(updateOutput.str());
+
+    REQUIRE(context.GetTerminationHR() == S_OK);
+
+    // Only the ids are listed, not the table.
+    std::string output = updateOutput.str();
+    REQUIRE(output.find("AppInstallerCliTest.TestExeInstaller") != std::string::npos);
+    REQUIRE(output.find("AppInstallerCliTest.TestMsixInstaller") != std::string::npos);
+    REQUIRE(output.find(Resource::LocString(Resource::String::SearchName).get()) == std::string::npos);
+    REQUIRE(output.find(Resource::LocString(Resource::String::AvailableUpgrades).get()) != std::string::npos);
+}
+
+TEST_CASE("UpdateFlow_UpgradeSummaryWithQuery", "[UpdateFlow][workflow]")
+{
+    std::ostringstream updateOutput;
+    TestContext context{ updateOutput, std::cin };
+    context.Args.AddArg(Execution::Args::Type::Query, "AppInstallerCliTest.TestExeInstaller"sv);
+    context.Args.AddArg(Execution::Args::Type::UpgradeSummary);
+
+    UpgradeCommand update({});
+    REQUIRE_THROWS(update.ValidateArguments(context.Args));
+}
+
+TEST_CASE("UpdateFlow_ListOutputJson", "[UpdateFlow][workflow]")
+{
+    std::ostringstream updateOutput;
+    TestContext context{ updateOutput, std::cin };
+    auto previousThreadGlobals = context.SetForCurrentThread();
+    OverrideForCompositeInstalledSource(context);
+    context.Args.AddArg(Execution::Args::Type::OutputFormat, "json"sv);
+
+    UpgradeCommand update({});
+    update.ValidateArguments(context.Args);
+    update.Execute(context);
+    INFO(updateOutput.str());
+
+    REQUIRE(context.GetTerminationHR() == S_OK);
+
+    // The output is only the JSON array, without the table or the upgrade count.
+    Json::Value root;
+    std::string errors;
+    std::string output = updateOutput.str();
+    std::unique_ptr<Json::CharReader> reader{ Json::CharReaderBuilder{}.newCharReader() };
+    REQUIRE(reader->parse(output.data(), output.data() + output.size(), &root, &errors));
+    REQUIRE(root.isArray());
+
+    bool foundExe = false;
+    for (const auto& entry : root)
+    {
+        REQUIRE(entry.isMember("Available"));
+        REQUIRE(entry.isMember("Source"));
+        foundExe = foundExe || entry["Id"].asString() == "AppInstallerCliTest.TestExeInstaller";
+    }
+    REQUIRE(foundExe);
+}
+
+TEST_CASE("UpdateFlow_OutputFormatValidation", "[UpdateFlow][workflow]")
+{
+    std::ostringstream updateOutput;
+    TestContext context{ updateOutput, std::cin };
+
+    SECTION("Unknown format")
+    {
+        context.Args.AddArg(Execution::Args::Type::OutputFormat, "xml"sv);
+    }
+    SECTION("Not listing")
+    {
+        context.Args.AddArg(Execution::Args::Type::Query, "AppInstallerCliTest.TestExeInstaller"sv);
+        context.Args.AddArg(Execution::Args::Type::OutputFormat, "json"sv);
+    }
+
+    UpgradeCommand update({});
+    REQUIRE_THROWS(update.ValidateArguments(context.Args));
+}
+
+TEST_CASE("StructuredOutput_Csv", "[workflow]")
+{
+    std::ostringstream output;
+    TestContext context{ output, std::cin };
+
+    Execution::StructuredOutput<3> csv(context.Reporter, Execution::OutputFormat::Csv, { "Name"sv, "Id"sv, "Version"sv });
+    csv.OutputLine({ "Plain"s, "Publisher.Plain"s, "1.0"s });
+    csv.OutputLine({ "Has, \"quotes\""s, "Publisher.Quoted"s, "2.0"s });
+    csv.Complete();
+
+    REQUIRE(output.str() == "Name,Id,Version\nPlain,Publisher.Plain,1.0\n\"Has, \"\"quotes\"\"\",Publisher.Quoted,2.0\n");
+}
+
 TEST_CASE("UpdateFlow_UpgradeWithDuplicateUpgradeItemsFound", "[UpdateFlow][workflow]")
 {
     TestCommon::TempFile updateExeResultPath("TestExeInstalled.txt");
@@ -1819,6 +1974,66 @@ TEST_CASE("UninstallFlow_UninstallExeNotFound", "[UninstallFlow][workflow]")
     REQUIRE(context.GetTerminationHR() == APPINSTALLER_CLI_ERROR_NO_APPLICATIONS_FOUND);
 }
 
+TEST_CASE("UninstallFlow_UninstallMultiple", "[UninstallFlow][workflow]")
+{
+    TestCommon::TempFile uninstallExeResultPath("TestExeUninstalled.txt");
+    TestCommon::TempFile uninstallMsixResultPath("TestMsixUninstalled.txt");
+
+    std::ostringstream uninstallOutput;
+    TestContext context{ uninstallOutput, std::cin };
+    auto previousThreadGlobals = context.SetForCurrentThread();
+    OverrideForCompositeInstalledSource(context);
+    OverrideForExeUninstall(context);
+    OverrideForMSIXUninstall(context);
+    context.Args.AddArg(Execution::Args::Type::Query, "AppInstallerCliTest.TestMsixInstaller"sv);
+    context.Args.AddArg(Execution::Args::Type::Query, "AppInstallerCliTest.TestExeInstaller"sv);
+    context.Args.AddArg(Execution::Args::Type::Silent);
+
+    UninstallCommand uninstall({});
+    uninstall.Execute(context);
+    INFO(uninstallOutput.str());
+
+    REQUIRE_FALSE(context.IsTerminated());
+
+    // Verify both uninstallers are called, each with the arguments passed to the command.
+    REQUIRE(std::filesystem::exists(uninstallExeResultPath.GetPath()));
+    std::ifstream uninstallExeResultFile(uninstallExeResultPath.GetPath());
+    REQUIRE(uninstallExeResultFile.is_open());
+    std::string uninstallExeResultStr;
+    std::getline(uninstallExeResultFile, uninstallExeResultStr);
+    REQUIRE(uninstallExeResultStr.find("/silence") != std::string::npos);
+
+    REQUIRE(std::filesystem::exists(uninstallMsixResultPath.GetPath()));
+    std::ifstream uninstallMsixResultFile(uninstallMsixResultPath.GetPath());
+    REQUIRE(uninstallMsixResultFile.is_open());
+    std::string uninstallMsixResultStr;
+    std::getline(uninstallMsixResultFile, uninstallMsixResultStr);
+    REQUIRE(uninstallMsixResultStr.find("20477fca-282d-49fb-b03e-371dca074f0f_8wekyb3d8bbwe") != std::string::npos);
+}
+
+TEST_CASE("UninstallFlow_UninstallMultipleWithMissing", "[UninstallFlow][workflow]")
+{
+    TestCommon::TempFile uninstallResultPath("TestExeUninstalled.txt");
+
+    std::ostringstream uninstallOutput;
+    TestContext context{ uninstallOutput, std::cin };
+    auto previousThreadGlobals = context.SetForCurrentThread();
+    OverrideForCompositeInstalledSource(context);
+    OverrideForExeUninstall(context);
+    context.Args.AddArg(Execution::Args::Type::Query, "AppInstallerCliTest.MissingApp"sv);
+    context.Args.AddArg(Execution::Args::Type::Query, "AppInstallerCliTest.TestExeInstaller"sv);
+    context.Args.AddArg(Execution::Args::Type::Silent);
+
+    UninstallCommand uninstall({});
+    uninstall.Execute(context);
+    INFO(uninstallOutput.str());
+
+    // Verify the package that was found is still uninstalled.
+    REQUIRE(std::filesystem::exists(uninstallResultPath.GetPath()));
+    REQUIRE(uninstallOutput.str().find(Resource::LocString(Resource::String::NoInstalledPackageFound).get()) != std::string::npos);
+    REQUIRE_TERMINATED_WITH(context, APPINSTALLER_CLI_ERROR_MULTIPLE_UNINSTALL_FAILED);
+}
+
 TEST_CASE("ExportFlow_ExportAll", "[ExportFlow][workflow]")
 {
     TestCommon::TempFile exportResultPath("TestExport.json");
@@ -1912,6 +2127,176 @@ TEST_CASE("ImportFlow_Successful", "[ImportFlow][workflow]")
     REQUIRE(std::filesystem::exists(msixInstallResultPath.GetPath()));
 }
 
+TEST_CASE("ImportFlow_ConcurrentMsixReportedInOrder", "[ImportFlow][workflow]")
+{
+    TestCommon::TempFile exeInstallResultPath("TestExeInstalled.txt");
+    TestCommon::TempFile msixInstallResultPath("TestMsixInstalled.txt");
+
+    std::ostringstream importOutput;
+    TestContext context{ importOutput, std::cin };
+    auto previousThreadGlobals = context.SetForCurrentThread();
+    OverrideForImportSource(context);
+    OverrideForMSIX(context);
+    OverrideForShellExecute(context);
+    context.Args.AddArg(Execution::Args::Type::ImportFile, TestDataFile("ImportFile-Good.json").GetPath().string());
+
+    ImportCommand importCommand({});
+    importCommand.Execute(context);
+    INFO(importOutput.str());
+
+    REQUIRE(std::filesystem::exists(exeInstallResultPath.GetPath()));
+    REQUIRE(std::filesystem::exists(msixInstallResultPath.GetPath()));
+
+    // The MSIX package is installed in the background, but its output still follows the package before it
+    std::string output = importOutput.str();
+    size_t exePosition = output.find("AppInstallerCliTest.TestExeInstaller");
+    size_t msixPosition = output.find("AppInstallerCliTest.TestMsixInstaller");
+    REQUIRE(exePosition != std::string::npos);
+    REQUIRE(msixPosition != std::string::npos);
+    REQUIRE(exePosition < output.find("(2/2)"));
+    REQUIRE(output.find("(2/2)") < msixPosition);
+}
+
+void AddPackageToInstall(TestContext& context, std::string_view id, InstallerTypeEnum installerType)
+{
+    Manifest manifest;
+    manifest.Id = id;
+    manifest.Version = "1.0";
+
+    ManifestInstaller installer;
+    installer.InstallerType = installerType;
+
+    auto packageContext = context.CreateSubContext();
+    packageContext->Add<Execution::Data::Manifest>(std::move(manifest));
+    packageContext->Add<Execution::Data::Installer>(std::move(installer));
+    context.Get<Execution::Data::PackagesToInstall>().emplace_back(std::move(packageContext));
+}
+
+TEST_CASE("InstallMultiplePackages_ConcurrentFailureDoesNotStopOthers", "[InstallFlow][workflow]")
+{
+    std::ostringstream installOutput;
+    TestContext context{ installOutput, std::cin };
+    auto previousThreadGlobals = context.SetForCurrentThread();
+
+    context.Add<Execution::Data::PackagesToInstall>({});
+    AddPackageToInstall(context, "Package.First", InstallerTypeEnum::MSStore);
+    AddPackageToInstall(context, "Package.Fails", InstallerTypeEnum::MSStore);
+    AddPackageToInstall(context, "Package.Last", InstallerTypeEnum::MSStore);
+
+    std::mutex eventsLock;
+    std::vector<std::string> executed;
+    std::vector<std::string> completed;
+
+    context.Override({ DownloadInstaller, [](TestContext&)
+    {
+    } });
+
+    context.Override({ ExecutePackageInstaller, [&](TestContext& context)
+    {
+        std::string id = context.Get<Execution::Data::Manifest>().Id;
+        {
+            std::lock_guard<std::mutex> lock{ eventsLock };
+            executed.emplace_back(id);
+        }
+
+        if (id == "Package.Fails")
+        {
+            AICLI_TERMINATE_CONTEXT(APPINSTALLER_CLI_ERROR_INSTALL_BLOCKED_BY_POLICY);
+        }
+    }, 3 });
+
+    context.Override({ CompletePackageInstall, [&](TestContext& context)
+    {
+        std::lock_guard<std::mutex> lock{ eventsLock };
+        completed.emplace_back(context.Get<Execution::Data::Manifest>().Id);
+    }, 2 });
+
+    // There is no option to stop at the first failure; the rest of the packages are still installed and the failure is reported at the end
+    context << InstallMultiplePackages(Resource::String::InstallAndUpgradeCommandsReportDependencies, APPINSTALLER_CLI_ERROR_IMPORT_INSTALL_FAILED, {}, false, true);
+    INFO(installOutput.str());
+
+    REQUIRE(context.IsTerminated());
+    REQUIRE(context.GetTerminationHR() == APPINSTALLER_CLI_ERROR_IMPORT_INSTALL_FAILED);
+
+    std::sort(executed.begin(), executed.end());
+    REQUIRE(executed == std::vector<std::string>{ "Package.Fails", "Package.First", "Package.Last" });
+
+    // The packages that succeeded are completed in their order, and the one that failed is not
+    REQUIRE(completed == std::vector<std::string>{ "Package.First", "Package.Last" });
+
+    // The results are reported in the order of the packages, including that of the one that failed
+    std::string output = installOutput.str();
+    REQUIRE(output.find("(2/3)") < output.find("Package.Fails"));
+    REQUIRE(output.find("Package.Fails") < output.find("(3/3)"));
+}
+
+TEST_CASE("InstallMultiplePackages_ConcurrentWaitsForEarlierLevels", "[InstallFlow][workflow]")
+{
+    using namespace std::chrono_literals;
+
+    std::ostringstream installOutput;
+    TestContext context{ installOutput, std::cin };
+    auto previousThreadGlobals = context.SetForCurrentThread();
+
+    // The first two packages are the dependencies of the last one
+    context.Add<Execution::Data::PackagesToInstall>({});
+    AddPackageToInstall(context, "Package.DependencyA", InstallerTypeEnum::MSStore);
+    AddPackageToInstall(context, "Package.DependencyB", InstallerTypeEnum::MSStore);
+    AddPackageToInstall(context, "Package.Dependent", InstallerTypeEnum::MSStore);
+    context.Add<Execution::Data::PackagesToInstallLevels>({ 0, 0, 1 });
+
+    std::mutex eventsLock;
+    std::condition_variable eventsChanged;
+    std::vector<std::string> events;
+    bool firstLevelRanTogether = false;
+
+    auto hasEvent = [&](const std::string& event)
+        {
+            return std::find(events.begin(), events.end(), event) != events.end();
+        };
+
+    context.Override({ DownloadInstaller, [](TestContext&)
+    {
+    } });
+
+    context.Override({ ExecutePackageInstaller, [&](TestContext& context)
+    {
+        std::string id = context.Get<Execution::Data::Manifest>().Id;
+        std::unique_lock<std::mutex> lock{ eventsLock };
+        events.emplace_back("Execute " + id);
+        eventsChanged.notify_all();
+
+        // The packages of a level are installed at the same time, so the first one can see the second start
+        if (id == "Package.DependencyA")
+        {
+            firstLevelRanTogether = eventsChanged.wait_for(lock, 10s, [&]() { return hasEvent("Execute Package.DependencyB"); });
+        }
+    }, 3 });
+
+    context.Override({ CompletePackageInstall, [&](TestContext& context)
+    {
+        std::lock_guard<std::mutex> lock{ eventsLock };
+        events.emplace_back("Complete " + context.Get<Execution::Data::Manifest>().Id);
+    }, 3 });
+
+    context << InstallMultiplePackages(Resource::String::InstallAndUpgradeCommandsReportDependencies, APPINSTALLER_CLI_ERROR_INSTALL_DEPENDENCIES, {}, false, true);
+    INFO(installOutput.str());
+
+    REQUIRE_FALSE(context.IsTerminated());
+    REQUIRE(firstLevelRanTogether);
+
+    // The dependent package is not started until both of its dependencies are completed
+    auto position = [&](const std::string& event)
+        {
+            return std::find(events.begin(), events.end(), event) - events.begin();
+        };
+
+    REQUIRE(events.size() == 6);
+    REQUIRE(position("Complete Package.DependencyA") < position("Execute Package.Dependent"));
+    REQUIRE(position("Complete Package.DependencyB") < position("Execute Package.Dependent"));
+    REQUIRE(position("Execute Package.Dependent") < position("Complete Package.Dependent"));
+}
+
 TEST_CASE("ImportFlow_PackageAlreadyInstalled", "[ImportFlow][workflow]")
 {
     TestCommon::TempFile exeInstallResultPath("TestExeInstalled.txt");
@@ -2011,6 +2396,52 @@ TEST_CASE("ImportFlow_IgnoreMissingPackage", "[ImportFlow][workflow]")
     REQUIRE(importOutput.str().find(Resource::LocString(Resource::String::ImportSearchFailed).get()) != std::string::npos);
 }
 
+TEST_CASE("ImportFlow_Stream_Successful", "[ImportFlow][workflow]")
+{
+    TestCommon::TempFile exeInstallResultPath("TestExeInstalled.txt");
+    TestCommon::TempFile msixInstallResultPath("TestMsixInstalled.txt");
+
+    std::ostringstream importOutput;
+    TestContext context{ importOutput, std::cin };
+    auto previousThreadGlobals = context.SetForCurrentThread();
+    OverrideForImportSource(context);
+    OverrideForMSIX(context);
+    OverrideForShellExecute(context);
+    context.Args.AddArg(Execution::Args::Type::ImportFile, TestDataFile("ImportFile-Good.json").GetPath().string());
+    context.Args.AddArg(Execution::Args::Type::ImportStream);
+
+    ImportCommand importCommand({});
+    importCommand.Execute(context);
+    INFO(importOutput.str());
+
+    // Verify all packages were installed
+    REQUIRE(!context.IsTerminated());
+    REQUIRE(std::filesystem::exists(exeInstallResultPath.GetPath()));
+    REQUIRE(std::filesystem::exists(msixInstallResultPath.GetPath()));
+}
+
+TEST_CASE("ImportFlow_Stream_MissingPackage", "[ImportFlow][workflow]")
+{
+    TestCommon::TempFile exeInstallResultPath("TestExeInstalled.txt");
+
+    std::ostringstream importOutput;
+    TestContext context{ importOutput, std::cin };
+    auto previousThreadGlobals = context.SetForCurrentThread();
+    OverrideForImportSource(context);
+    OverrideForShellExecute(context);
+    context.Args.AddArg(Execution::Args::Type::ImportFile, TestDataFile("ImportFile-Bad-UnknownPackage.json").GetPath().string());
+    context.Args.AddArg(Execution::Args::Type::ImportStream);
+
+    ImportCommand importCommand({});
+    importCommand.Execute(context);
+    INFO(importOutput.str());
+
+    // The package that was available is installed before the import fails for the missing one.
+    REQUIRE(std::filesystem::exists(exeInstallResultPath.GetPath()));
+    REQUIRE(importOutput.str().find(Resource::LocString(Resource::String::ImportSearchFailed).get()) != std::string::npos);
+    REQUIRE_TERMINATED_WITH(context, APPINSTALLER_CLI_ERROR_NOT_ALL_PACKAGES_FOUND);
+}
+
 TEST_CASE("ImportFlow_MissingVersion", "[ImportFlow][workflow]")
 {
     TestCommon::TempFile exeInstallResultPath("TestExeInstalled.txt");
@@ -2603,3 +3034,272 @@ TEST_CASE("AdminSetting_LocalManifestFiles", "[LocalManifests][workflow]")
         REQUIRE_THROWS(installCommand3.ValidateArguments(args3));
     }
 }
+
+TEST_CASE("CacheFlow_WarmRequiresFeature", "[CacheFlow][workflow]")
+{
+    TestUserSettings settings;
+
+    SECTION("Disabled")
+    {
+        settings.Set<AppInstaller::Settings::Setting::EFCacheCommand>({ false });
+
+        RootCommand root;
+        Invocation inv{ std::vector<std::string>{ "cache", "warm" } };
+        REQUIRE_THROWS_AS(root.FindSubCommand(inv), CommandException);
+    }
+    SECTION("Enabled")
+    {
+        settings.Set<AppInstaller::Settings::Setting::EFCacheCommand>({ true });
+
+        RootCommand root;
+        Invocation inv{ std::vector<std::string>{ "cache", "warm" } };
+        auto cache = root.FindSubCommand(inv);
+        REQUIRE(cache);
+        REQUIRE(cache->Name() == "cache");
+
+        auto warm = cache->FindSubCommand(inv);
+        REQUIRE(warm);
+        REQUIRE(warm->Name() == "warm");
+    }
+}
+
+TEST_CASE("CacheFlow_Warm", "[CacheFlow][workflow]")
+{
+    TestUserSettings settings;
+    settings.Set<AppInstaller::Settings::Setting::EFCacheCommand>({ true });
+
+    std::ostringstream warmOutput;
+    TestContext context{ warmOutput, std::cin };
+    auto previousThreadGlobals = context.SetForCurrentThread();
+    OverrideForCompositeInstalledSource(context);
+    context.Override({ Workflow::GetSourceList, [](TestContext& context)
+    {
+        context.Add<Execution::Data::SourceList>({});
+    } });
+    context.Override({ Workflow::UpdateSources, [](TestContext&) {}, 1 });
+
+    CacheWarmCommand warm({});
+    warm.Execute(context);
+    INFO(warmOutput.str());
+
+    REQUIRE(context.GetTerminationHR() == S_OK);
+
+    // Installs nothing, and reports the upgrades whose manifests it retrieved.
+    std::string output = warmOutput.str();
+    REQUIRE(output.find(Resource::LocString(Resource::String::CacheWarmUpgradeManifests).get()) != std::string::npos);
+    REQUIRE(output.find(Resource::LocString(Resource::String::Done).get()) != std::string::npos);
+    REQUIRE(output.find(Resource::LocString(Resource::String::InstallFlowInstallSuccess).get()) == std::string::npos);
+}
+
+namespace
+{
+    using namespace std::chrono_literals;
+
+    std::atomic<int> s_taskGraphArrivals = 0;
+
+    // Waits for the other task that should be running alongside this one.
+    bool WaitForOtherTaskGraphTask()
+    {
+        ++s_taskGraphArrivals;
+        auto timeout = std::chrono::steady_clock::now() + 10s;
+        while (s_taskGraphArrivals < 2 && std::chrono::steady_clock::now() < timeout)
+        {
+            std::this_thread::sleep_for(1ms);
+        }
+        return s_taskGraphArrivals >= 2;
+    }
+
+    void TaskGraphWritePath(Execution::Context& context)
+    {
+        bool concurrent = WaitForOtherTaskGraphTask();
+        context.Add<Execution::Data::InstallerPath>(context.Get<Execution::Data::InstallerArgs>() + (concurrent ? "_path" : "_alone"));
+    }
+
+    void TaskGraphWriteLog(Execution::Context& context)
+    {
+        bool concurrent = WaitForOtherTaskGraphTask();
+        context.Add<Execution::Data::LogPath>(context.Get<Execution::Data::InstallerArgs>() + (concurrent ? "_log" : "_alone"));
+    }
+
+    void TaskGraphCombine(Execution::Context& context)
+    {
+        context.Add<Execution::Data::UninstallString>(
+            context.Get<Execution::Data::InstallerPath>().u8string() + "|" + context.Get<Execution::Data::LogPath>().u8string());
+    }
+
+    void TaskGraphTerminate(Execution::Context& context)
+    {
+        AICLI_TERMINATE_CONTEXT(E_ABORT);
+    }
+
+    void TaskGraphThrow(Execution::Context&)
+    {
+        THROW_HR(E_ACCESSDENIED);
+    }
+
+    std::atomic<bool> s_taskGraphSignal = false;
+
+    // Waits for TaskGraphSignal, which only runs once a task that finishes quickly is done.
+    void TaskGraphWaitForSignal(Execution::Context& context)
+    {
+        auto timeout = std::chrono::steady_clock::now() + 10s;
+        while (!s_taskGraphSignal && std::chrono::steady_clock::now() < timeout)
+        {
+            std::this_thread::sleep_for(1ms);
+        }
+        context.Add<Execution::Data::LogPath>(s_taskGraphSignal ? "signaled"s : "timed out"s);
+    }
+
+    void TaskGraphSignal(Execution::Context& context)
+    {
+        s_taskGraphSignal = true;
+        context.Add<Execution::Data::UninstallString>(context.Get<Execution::Data::InstallerPath>().u8string());
+    }
+
+    std::atomic<bool> s_taskGraphCancelled = false;
+
+    // Runs until its context is cancelled, giving up after a while.
+    void TaskGraphRunUntilCancelled(Execution::Context& context)
+    {
+        auto timeout = std::chrono::steady_clock::now() + 10s;
+        while (!context.IsTerminated() && std::chrono::steady_clock::now() < timeout)
+        {
+            std::this_thread::sleep_for(1ms);
+        }
+        s_taskGraphCancelled = context.IsTerminated();
+    }
+
+    void TaskGraphFail(Execution::Context& context)
+    {
+        // Give the other task time to start.
+        std::this_thread::sleep_for(50ms);
+        AICLI_TERMINATE_CONTEXT(E_FAIL);
+    }
+}
+
+TEST_CASE("TaskGraph_IndependentTasksRunConcurrently", "[workflow]")
+{
+    s_taskGraphArrivals = 0;
+
+    std::ostringstream output;
+    TestContext context{ output, std::cin };
+    context.Add<Execution::Data::InstallerArgs>("test"s);
+
+    TaskGraph graph;
+    graph.Add(TaskGraphWritePath, { Execution::Data::InstallerArgs }, { Execution::Data::InstallerPath });
+    graph.Add(TaskGraphWriteLog, { Execution::Data::InstallerArgs }, { Execution::Data::LogPath });
+    graph.Add(TaskGraphCombine, { Execution::Data::InstallerPath, Execution::Data::LogPath }, { Execution::Data::UninstallString });
+
+    context << graph;
+
+    REQUIRE_FALSE(context.IsTerminated());
+    REQUIRE(context.Get<Execution::Data::UninstallString>() == "test_path|test_log");
+}
+
+TEST_CASE("TaskGraph_Dependencies", "[workflow]")
+{
+    TaskGraph graph;
+    graph.Add(TaskGraphWritePath, { Execution::Data::InstallerArgs }, { Execution::Data::InstallerPath });
+    graph.Add(TaskGraphWriteLog, { Execution::Data::InstallerArgs }, { Execution::Data::LogPath });
+    graph.Add(TaskGraphCombine, { Execution::Data::InstallerPath, Execution::Data::LogPath }, { Execution::Data::UninstallString });
+    // Writes what the first task reads, so it must wait for that task to have read it.
+    graph.Add(TaskGraphTerminate, {}, { Execution::Data::InstallerArgs });
+
+    REQUIRE(graph.GetDependencies(0).empty());
+    REQUIRE(graph.GetDependencies(1).empty());
+    REQUIRE(graph.GetDependencies(2) == std::vector<size_t>{ 0, 1 });
+    REQUIRE(graph.GetDependencies(3) == std::vector<size_t>{ 0, 1 });
+}
+
+TEST_CASE("TaskGraph_TaskStartsWhenItsDependenciesAreDone", "[workflow]")
+{
+    s_taskGraphArrivals = 2;
+    s_taskGraphSignal = false;
+
+    std::ostringstream output;
+    TestContext context{ output, std::cin };
+    context.Add<Execution::Data::InstallerArgs>("test"s);
+
+    // The signal only depends on the quick task, so it runs while the waiting task is still running rather than after it.
+    TaskGraph graph;
+    graph.Add(TaskGraphWaitForSignal, {}, { Execution::Data::LogPath });
+    graph.Add(TaskGraphWritePath, { Execution::Data::InstallerArgs }, { Execution::Data::InstallerPath }, AppInstaller::Synchronization::WorkLane::Cpu);
+    graph.Add(TaskGraphSignal, { Execution::Data::InstallerPath }, { Execution::Data::UninstallString });
+
+    context << graph;
+
+    REQUIRE_FALSE(context.IsTerminated());
+    REQUIRE(context.Get<Execution::Data::LogPath>() == "signaled");
+    REQUIRE(context.Get<Execution::Data::UninstallString>() == "test_path");
+}
+
+TEST_CASE("TaskGraph_TerminationStopsLaterTasks", "[workflow]")
+{
+    s_taskGraphArrivals = 2;
+
+    std::ostringstream output;
+    TestContext context{ output, std::cin };
+    context.Add<Execution::Data::InstallerArgs>("test"s);
+
+    TaskGraph graph;
+    graph.Add(TaskGraphWritePath, { Execution::Data::InstallerArgs }, { Execution::Data::InstallerPath });
+    graph.Add(TaskGraphTerminate, {}, { Execution::Data::LogPath });
+    graph.Add(TaskGraphCombine, { Execution::Data::InstallerPath, Execution::Data::LogPath }, { Execution::Data::UninstallString });
+
+    context << graph;
+
+    REQUIRE(context.IsTerminated());
+    REQUIRE(context.GetTerminationHR() == E_ABORT);
+    REQUIRE_FALSE(context.Contains(Execution::Data::UninstallString));
+}
+
+TEST_CASE("TaskGraph_TerminationCancelsRunningTasks", "[workflow]")
+{
+    s_taskGraphCancelled = false;
+
+    std::ostringstream output;
+    TestContext context{ output, std::cin };
+
+    TaskGraph graph;
+    graph.Add(TaskGraphRunUntilCancelled, {}, { Execution::Data::LogPath });
+    graph.Add(TaskGraphFail, {}, { Execution::Data::InstallerPath });
+
+    auto start = std::chrono::steady_clock::now();
+    context << graph;
+
+    // The failure is the one reported, rather than the cancellation that it caused.
+    REQUIRE(context.IsTerminated());
+    REQUIRE(context.GetTerminationHR() == E_FAIL);
+    REQUIRE(s_taskGraphCancelled);
+    REQUIRE(std::chrono::steady_clock::now() - start < 10s);
+    REQUIRE_FALSE(context.Contains(Execution::Data::LogPath));
+}
+
+TEST_CASE("TaskGraph_ExceptionIsRethrown", "[workflow]")
+{
+    s_taskGraphArrivals = 2;
+
+    std::ostringstream output;
+    TestContext context{ output, std::cin };
+    context.Add<Execution::Data::InstallerArgs>("test"s);
+
+    SECTION("Concurrent")
+    {
+        TaskGraph graph;
+        graph.Add(TaskGraphWritePath, { Execution::Data::InstallerArgs }, { Execution::Data::InstallerPath });
+        graph.Add(TaskGraphThrow, {}, { Execution::Data::LogPath });
+        graph.Add(TaskGraphCombine, { Execution::Data::InstallerPath, Execution::Data::LogPath }, { Execution::Data::UninstallString });
+
+        REQUIRE_THROWS_HR(context << graph, E_ACCESSDENIED);
+        REQUIRE_FALSE(context.Contains(Execution::Data::UninstallString));
+    }
+    SECTION("Alone")
+    {
+        TaskGraph graph;
+        graph.Add(TaskGraphThrow, {}, { Execution::Data::LogPath });
+        graph.Add(TaskGraphCombine, { Execution::Data::InstallerPath, Execution::Data::LogPath }, { Execution::Data::UninstallString });
+
+        REQUIRE_THROWS_HR(context << graph, E_ACCESSDENIED);
+        REQUIRE_FALSE(context.Contains(Execution::Data::UninstallString));
+    }
+}
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "TestCommon.h"
+#include <AppInstallerErrors.h>
 #include <AppInstallerSHA256.h>
 #include <winget/ManifestYamlParser.h>
 #include <winget/Yaml.h>
@@ -129,6 +130,105 @@ TEST_CASE("ReadPreviewGoodManifestAndVerifyContents", "[ManifestValidation]")
     REQUIRE(std::equal(manifestHash.begin(), manifestHash.end(), manifest.StreamSha256.begin()));
 }
 
+TEST_CASE("YamlNode_MappingOrderedByKey", "[ManifestValidation]")
+{
+    Node root = Load(std::string{ "Beta: 1\nAlpha: 2\nGamma:\n  - x\n  - y\nDuplicate: a\nDuplicate: b\n" });
+    REQUIRE(root.IsMap());
+
+    std::vector<std::string> keys;
+    for (const auto& entry : root.Mapping())
+    {
+        keys.emplace_back(entry.first.as<std::string>());
+    }
+
+    REQUIRE(keys == std::vector<std::string>{ "Alpha", "Beta", "Duplicate", "Duplicate", "Gamma" });
+    REQUIRE(root["Alpha"].as<int>() == 2);
+    REQUIRE(root["Beta"].as<int>() == 1);
+    REQUIRE(root["Gamma"].size() == 2);
+    REQUIRE(root["Gamma"][1].as<std::string>() == "y");
+    REQUIRE(!root["Missing"]);
+    REQUIRE_THROWS_HR(root["Duplicate"], APPINSTALLER_CLI_ERROR_YAML_DUPLICATE_MAPPING_KEY);
+}
+
+TEST_CASE("YamlLoad_StringView", "[ManifestValidation]")
+{
+    // The input is parsed in place, so loading from a view of part of a buffer must only see that part
+    std::string buffer = "Key: Value\nOther: 1";
+    Node root = Load(std::string_view{ buffer }.substr(0, 10));
+    REQUIRE(root["Key"].as<std::string>() == "Value");
+    REQUIRE(!root["Other"]);
+
+    REQUIRE(!Load(std::string_view{}).IsDefined());
+}
+
+TEST_CASE("YamlLoad_DepthLimit", "[ManifestValidation]")
+{
+    LoadLimits limits;
+    limits.MaximumDepth = 8;
+
+    REQUIRE(Load(std::string(8, '[') + std::string(8, ']'), limits).IsSequence());
+    REQUIRE_THROWS_HR(Load(std::string(9, '[') + std::string(9, ']'), limits), APPINSTALLER_CLI_ERROR_YAML_LIMIT_EXCEEDED);
+    REQUIRE_THROWS_HR(Load(std::string(1000, '[') + std::string(1000, ']')), APPINSTALLER_CLI_ERROR_YAML_LIMIT_EXCEEDED);
+}
+
+TEST_CASE("YamlLoad_NodeCountLimit", "[ManifestValidation]")
+{
+    LoadLimits limits;
+    limits.MaximumNodeCount = 4;
+
+    REQUIRE(Load(std::string{ "[a, b, c]" }, limits).size() == 3);
+    REQUIRE_THROWS_HR(Load(std::string{ "[a, b, c, d]" }, limits), APPINSTALLER_CLI_ERROR_YAML_LIMIT_EXCEEDED);
+}
+
+TEST_CASE("YamlLoad_AliasExpansionLimit", "[ManifestValidation]")
+{
+    LoadLimits limits;
+    limits.MaximumAliasExpansions = 2;
+
+    Node root = Load(std::string{ "a: &x [1, 2]\nb: *x\nc: *x\n" }, limits);
+    REQUIRE(root["c"][1].as<int>() == 2);
+    REQUIRE_THROWS_HR(Load(std::string{ "a: &x [1, 2]\nb: *x\nc: *x\nd: *x\n" }, limits), APPINSTALLER_CLI_ERROR_YAML_LIMIT_EXCEEDED);
+
+    // Each level doubles the size of the expanded document
+    std::string laughs = "l0: &l0 [lol, lol]\n";
+    for (int i = 1; i <= 40; ++i)
+    {
+        laughs += "l" + std::to_string(i) + ": &l" + std::to_string(i) + " [*l" + std::to_string(i - 1) + ", *l" + std::to_string(i - 1) + "]\n";
+    }
+    REQUIRE_THROWS_HR(Load(laughs), APPINSTALLER_CLI_ERROR_YAML_LIMIT_EXCEEDED);
+
+    // An anchored sequence can contain an alias to itself
+    REQUIRE_THROWS_HR(Load(std::string{ "&x [*x]" }), APPINSTALLER_CLI_ERROR_YAML_LIMIT_EXCEEDED);
+}
+
+TEST_CASE("YamlLoad_Aliases", "[ManifestValidation]")
+{
+    // An alias is a copy of the anchored node, including where it was read from
+    Node root = Load(std::string{ "a: &x\n  b: [1, &y 2]\nc: *x\nd: *y\n" });
+    REQUIRE(root["c"]["b"][1].as<int>() == 2);
+    REQUIRE(root["c"].Mark().line == root["a"].Mark().line);
+    REQUIRE(root["c"]["b"].Mark().line == 2);
+    REQUIRE(root["d"].as<int>() == 2);
+
+    // Libyaml does not allow an anchor to be used again, or an alias before its anchor
+    REQUIRE_THROWS_HR(Load(std::string{ "a: &x 1\nb: &x 2\n" }), APPINSTALLER_CLI_ERROR_LIBYAML_ERROR);
+    REQUIRE_THROWS_HR(Load(std::string{ "a: *x\nb: &x 1\n" }), APPINSTALLER_CLI_ERROR_LIBYAML_ERROR);
+
+    // A mapping key must be a scalar, even through an alias
+    REQUIRE_THROWS_HR(Load(std::string{ "a: &x [1]\n? *x\n: 2\n" }), APPINSTALLER_CLI_ERROR_YAML_INVALID_MAPPING_KEY);
+}
+
+TEST_CASE("YamlLoad_ErrorAfterRoot", "[ManifestValidation]")
+{
+    // The document is parsed to its end, so input after the root node is still checked
+    REQUIRE_THROWS_HR(Load(std::string{ "[a, b]\n@\n" }), APPINSTALLER_CLI_ERROR_LIBYAML_ERROR);
+
+    // Only the first document is loaded
+    Node root = Load(std::string{ "a: 1\n---\nb: 2\n" });
+    REQUIRE(root["a"].as<int>() == 1);
+    REQUIRE(!root["b"]);
+}
+
 TEST_CASE("ReadGoodManifestWithSpaces", "[ManifestValidation]")
 {
     Manifest manifest = YamlParser::CreateFromPath(TestDataFile("Manifest-Good-Spaces.yaml"));
@@ -624,6 +724,37 @@ TEST_CASE("ValidateV1_1GoodManifestAndVerifyContents", "[ManifestValidation]")
     VerifyV1ManifestContent(mergedManifest, false, ManifestVer{ s_ManifestVersionV1_1 });
 }
 
+TEST_CASE("ValidateManifest_ConcurrentSchemaValidation", "[ManifestValidation]")
+{
+    ManifestValidateOption validateOption;
+    validateOption.SchemaValidationOnly = true;
+    TempDirectory multiFileDirectory{ "MultiFileManifest" };
+    CopyTestDataFilesToFolder({
+        "ManifestV1_1-MultiFile-Version.yaml",
+        "ManifestV1_1-MultiFile-Installer.yaml",
+        "ManifestV1_1-MultiFile-DefaultLocale.yaml",
+        "ManifestV1_1-MultiFile-Locale.yaml" }, multiFileDirectory);
+
+    // The compiled schemas are shared by every validation in the process
+    std::vector<std::future<bool>> validations;
+    for (size_t i = 0; i < 8; ++i)
+    {
+        validations.emplace_back(std::async(std::launch::async, [&]()
+            {
+                for (size_t j = 0; j < 5; ++j)
+                {
+                    (void)YamlParser::CreateFromPath(multiFileDirectory, validateOption);
+                }
+                return true;
+            }));
+    }
+
+    for (auto& validation : validations)
+    {
+        REQUIRE(validation.get());
+    }
+}
+
 YamlManifestInfo CreateYamlManifestInfo(std::string testDataFile)
 {
     YamlManifestInfo result;
@@ -113,6 +113,14 @@ int main(int argc, char** argv)
         {
             keepSQLLogging = true;
         }
+        else if ("-benchout"s == argv[i])
+        {
+            ++i;
+            if (i < argc)
+            {
+                TestCommon::BenchmarkResults::SetOutputPath(argv[i]);
+            }
+        }
         else
         {
             args.push_back(argv[i]);
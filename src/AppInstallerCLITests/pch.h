@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 #pragma once
 #define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
 #include <Windows.h>
 #include <WinInet.h>
 #include <shellapi.h>
@@ -16,6 +16,7 @@ namespace AppInstaller::Settings
     namespace
     {
         constexpr std::string_view s_AdminSettingsYaml_LocalManifestFiles = "LocalManifestFiles"sv;
+        constexpr std::string_view s_AdminSettingsYaml_InstallerCache = "InstallerCache"sv;
 
         // Attempts to read a single scalar value from the node.
         template<typename Value>
@@ -36,6 +37,7 @@ namespace AppInstaller::Settings
         struct AdminSettingValues
         {
             bool LocalManifestFiles = false;
+            bool InstallerCache = false;
         };
 
         struct AdminSettingsInternal
@@ -68,6 +70,9 @@ namespace AppInstaller::Settings
                 case AdminSetting::LocalManifestFiles:
                     m_settingValues.LocalManifestFiles = enabled;
                     break;
+                case AdminSetting::InstallerCache:
+                    m_settingValues.InstallerCache = enabled;
+                    break;
                 default:
                     return;
                 }
@@ -90,6 +95,8 @@ namespace AppInstaller::Settings
             {
             case AdminSetting::LocalManifestFiles:
                 return m_settingValues.LocalManifestFiles;
+            case AdminSetting::InstallerCache:
+                return m_settingValues.InstallerCache;
             default:
                 return false;
             }
@@ -130,6 +137,7 @@ namespace AppInstaller::Settings
             }
 
             TryReadScalar<bool>(document, s_AdminSettingsYaml_LocalManifestFiles, m_settingValues.LocalManifestFiles);
+            TryReadScalar<bool>(document, s_AdminSettingsYaml_InstallerCache, m_settingValues.InstallerCache);
         }
 
         bool AdminSettingsInternal::SaveAdminSettings()
@@ -137,6 +145,7 @@ namespace AppInstaller::Settings
             YAML::Emitter out;
             out << YAML::BeginMap;
             out << YAML::Key << s_AdminSettingsYaml_LocalManifestFiles << YAML::Value << m_settingValues.LocalManifestFiles;
+            out << YAML::Key << s_AdminSettingsYaml_InstallerCache << YAML::Value << m_settingValues.InstallerCache;
             out << YAML::EndMap;
 
             return m_settingStream.Set(out.str());
@@ -151,6 +160,10 @@ namespace AppInstaller::Settings
         {
             result = AdminSetting::LocalManifestFiles;
         }
+        else if (Utility::CaseInsensitiveEquals(s_AdminSettingsYaml_InstallerCache, in))
+        {
+            result = AdminSetting::InstallerCache;
+        }
 
         return result;
     }
@@ -161,6 +174,8 @@ namespace AppInstaller::Settings
         {
         case AdminSetting::LocalManifestFiles:
             return s_AdminSettingsYaml_LocalManifestFiles;
+        case AdminSetting::InstallerCache:
+            return s_AdminSettingsYaml_InstallerCache;
         default:
             return "Unknown"sv;
         }
@@ -0,0 +1,169 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Public/winget/AllocationTracking.h"
+#include "Public/AppInstallerTelemetry.h"
+
+using namespace std::string_view_literals;
+
+namespace AppInstaller::Memory
+{
+#if WINGET_ALLOCATION_TRACKING_ENABLED
+    namespace
+    {
+        constexpr size_t c_subsystemCount = static_cast<size_t>(AllocationSubsystem::Max);
+
+        struct SubsystemCounters
+        {
+            std::atomic<uint64_t> Allocations;
+            std::atomic<uint64_t> Frees;
+            std::atomic<int64_t> LiveBytes;
+            std::atomic<int64_t> PeakLiveBytes;
+        };
+
+        // Zero initialized rather than constructed, so that the allocations made before the dynamic initialization
+        // of this binary are counted too.
+        std::array<SubsystemCounters, c_subsystemCount> s_counters;
+
+        thread_local AllocationSubsystem t_subsystem = AllocationSubsystem::Other;
+
+        void AddAllocation(AllocationSubsystem subsystem, int64_t bytes)
+        {
+            SubsystemCounters& counters = s_counters[static_cast<size_t>(subsystem)];
+
+            if (bytes < 0)
+            {
+                ++counters.Frees;
+                counters.LiveBytes += bytes;
+                return;
+            }
+
+            ++counters.Allocations;
+            int64_t live = (counters.LiveBytes += bytes);
+            int64_t peak = counters.PeakLiveBytes.load(std::memory_order_relaxed);
+            while (live > peak && !counters.PeakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+        }
+    }
+
+    // Placed before each allocation; its alignment keeps the one that operator new guarantees.
+    struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) AllocationHeader
+    {
+        size_t Size;
+        AllocationSubsystem Subsystem;
+    };
+
+    AllocationScope::AllocationScope(AllocationSubsystem subsystem) : m_previous(std::exchange(t_subsystem, subsystem)) {}
+
+    AllocationScope::~AllocationScope()
+    {
+        t_subsystem = m_previous;
+    }
+#endif
+
+    std::string_view ToString(AllocationSubsystem subsystem)
+    {
+        switch (subsystem)
+        {
+        case AllocationSubsystem::Other: return "Other"sv;
+        case AllocationSubsystem::SQLite: return "SQLite"sv;
+        case AllocationSubsystem::Yaml: return "Yaml"sv;
+        case AllocationSubsystem::RestJson: return "RestJson"sv;
+        case AllocationSubsystem::CompositeSearch: return "CompositeSearch"sv;
+        case AllocationSubsystem::WinRT: return "WinRT"sv;
+        default: return "Unknown"sv;
+        }
+    }
+
+    std::vector<AllocationCounts> GetAllocationCounts()
+    {
+        std::vector<AllocationCounts> result;
+
+#if WINGET_ALLOCATION_TRACKING_ENABLED
+        for (size_t i = 0; i < c_subsystemCount; ++i)
+        {
+            const SubsystemCounters& counters = s_counters[i];
+            uint64_t allocations = counters.Allocations.load();
+            if (allocations != 0)
+            {
+                result.emplace_back(AllocationCounts{ static_cast<AllocationSubsystem>(i), allocations, counters.Frees.load(),
+                    counters.LiveBytes.load(), counters.PeakLiveBytes.load() });
+            }
+        }
+#endif
+
+        return result;
+    }
+
+    void TraceAllocationCounts()
+    {
+        if (!IsAllocationTrackingEnabled() || !TraceLoggingProviderEnabled(g_hTraceProvider, WINEVENT_LEVEL_VERBOSE, 0))
+        {
+            return;
+        }
+
+        for (const auto& counts : GetAllocationCounts())
+        {
+            std::string_view name = ToString(counts.Subsystem);
+
+            TraceLoggingWriteActivity(g_hTraceProvider,
+                "AllocationCounts",
+                Logging::Telemetry().GetActivityId(),
+                nullptr,
+                TraceLoggingCountedString(name.data(), static_cast<ULONG>(name.size()), "Subsystem"),
+                TraceLoggingUInt64(counts.Allocations, "Allocations"),
+                TraceLoggingUInt64(counts.Frees, "Frees"),
+                TraceLoggingInt64(counts.LiveBytes, "LiveBytes"),
+                TraceLoggingInt64(counts.PeakLiveBytes, "PeakLiveBytes"),
+                TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE));
+        }
+    }
+
+#if WINGET_ALLOCATION_TRACKING_ENABLED
+    void RecordExternalAllocation(AllocationSubsystem subsystem, int64_t bytes)
+    {
+        AddAllocation(subsystem, bytes);
+    }
+#else
+    void RecordExternalAllocation(AllocationSubsystem, int64_t) {}
+#endif
+}
+
+#if WINGET_ALLOCATION_TRACKING_ENABLED
+// The replacements are linked into each binary that uses the tracking; the other forms of operator new and delete
+// in the runtime library call these, except for the aligned ones, which are not counted.
+void* operator new(size_t size)
+{
+    using namespace AppInstaller::Memory;
+
+    if (size > SIZE_MAX - sizeof(AllocationHeader))
+    {
+        throw std::bad_alloc{};
+    }
+
+    auto header = static_cast<AllocationHeader*>(std::malloc(sizeof(AllocationHeader) + size));
+    if (!header)
+    {
+        throw std::bad_alloc{};
+    }
+
+    header->Size = size;
+    header->Subsystem = t_subsystem;
+    AddAllocation(header->Subsystem, static_cast<int64_t>(size));
+
+    return header + 1;
+}
+
+void operator delete(void* pointer) noexcept
+{
+    using namespace AppInstaller::Memory;
+
+    if (!pointer)
+    {
+        return;
+    }
+
+    AllocationHeader* header = static_cast<AllocationHeader*>(pointer) - 1;
+    AddAllocation(header->Subsystem, -static_cast<int64_t>(header->Size));
+    std::free(header);
+}
+#endif
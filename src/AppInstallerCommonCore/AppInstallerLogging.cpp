@@ -109,7 +109,8 @@ namespace AppInstaller::Logging
     {
         return (!m_loggers.empty() &&
                 (m_enabledChannels & ConvertChannelToBitmask(channel)) != 0 &&
-                (AsNum(level) >= AsNum(m_enabledLevel)));
+                (AsNum(level) >= AsNum(m_enabledLevel)) &&
+                std::any_of(m_loggers.begin(), m_loggers.end(), [](const auto& logger) { return logger->IsActive(); }));
     }
 
     void DiagnosticLogger::Write(Channel channel, Level level, std::string_view message)
@@ -120,7 +121,10 @@ namespace AppInstaller::Logging
         {
             for (auto& logger : m_loggers)
             {
-                logger->Write(channel, level, message);
+                if (logger->IsActive())
+                {
+                    logger->Write(channel, level, message);
+                }
             }
         }
     }
@@ -133,7 +137,10 @@ namespace AppInstaller::Logging
         {
             for (auto& logger : m_loggers)
             {
-                logger->WriteDirect(message);
+                if (logger->IsActive())
+                {
+                    logger->WriteDirect(message);
+                }
             }
         }
     }
@@ -18,6 +18,136 @@ namespace AppInstaller::Utility
 
     namespace
     {
+        // Counts the bytes at the start of the string that pass the check, which is given a word of bytes at a time for the bulk of the string.
+        // The checks use the usual bit tricks to test all of the bytes in a word at once, rather than per byte branches.
+        template <typename WordCheck, typename ByteCheck>
+        size_t CountLeadingBytesThatPass(std::string_view input, WordCheck&& wordCheck, ByteCheck&& byteCheck)
+        {
+            const char* begin = input.data();
+            const char* current = begin;
+            const char* end = current + input.size();
+
+            for (; static_cast<size_t>(end - current) >= sizeof(uint64_t); current += sizeof(uint64_t))
+            {
+                uint64_t word;
+                memcpy(&word, current, sizeof(word));
+                if (!wordCheck(word))
+                {
+                    break;
+                }
+            }
+
+            // Either the tail of the string, or the word that failed to find the exact byte
+            for (; current < end; ++current)
+            {
+                if (!byteCheck(static_cast<unsigned char>(*current)))
+                {
+                    break;
+                }
+            }
+
+            return static_cast<size_t>(current - begin);
+        }
+
+        template <typename WordCheck, typename ByteCheck>
+        bool AllBytesPass(std::string_view input, WordCheck&& wordCheck, ByteCheck&& byteCheck)
+        {
+            return CountLeadingBytesThatPass(input, std::forward<WordCheck>(wordCheck), std::forward<ByteCheck>(byteCheck)) == input.size();
+        }
+
+        constexpr uint64_t s_EachByte = 0x0101010101010101ull;
+        constexpr uint64_t s_EachByteHighBit = 0x8080808080808080ull;
+
+        // Determines if no byte in the word is below the value; only valid when no byte has its high bit set.
+        constexpr bool NoByteBelow(uint64_t word, uint8_t value)
+        {
+            return ((word - (s_EachByte * value)) & ~word & s_EachByteHighBit) == 0;
+        }
+
+        // Determines if no byte in the word is equal to the value.
+        constexpr bool NoByteEqual(uint64_t word, uint8_t value)
+        {
+            uint64_t matched = word ^ (s_EachByte * value);
+            return ((matched - s_EachByte) & ~matched & s_EachByteHighBit) == 0;
+        }
+
+        constexpr bool IsPrintableASCIIWord(uint64_t word)
+        {
+            return (word & s_EachByteHighBit) == 0 && NoByteBelow(word, 0x20) && NoByteEqual(word, 0x7F);
+        }
+
+        constexpr bool IsPrintableASCIIByte(unsigned char c)
+        {
+            return c >= 0x20 && c < 0x7F;
+        }
+
+        // Lower cases the ASCII letters in the word, leaving every other byte as it is.
+        constexpr uint64_t ToLowerASCIIWord(uint64_t word)
+        {
+            // With the high bits cleared, adding to each byte cannot carry into the next one.
+            uint64_t heptets = word & ~s_EachByteHighBit;
+            uint64_t atLeastA = heptets + (s_EachByte * (0x80 - 'A'));
+            uint64_t aboveZ = heptets + (s_EachByte * (0x80 - 'Z' - 1));
+            uint64_t isUpper = atLeastA & ~aboveZ & ~word & s_EachByteHighBit;
+
+            // The high bit moved down to 0x20 is the difference between the cases.
+            return word | (isUpper >> 2);
+        }
+
+        constexpr char ToLowerASCII(char c)
+        {
+            return (c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c);
+        }
+
+        constexpr bool HasNoUpperASCIIWord(uint64_t word)
+        {
+            return ToLowerASCIIWord(word) == word;
+        }
+
+        constexpr bool IsNotUpperASCII(unsigned char c)
+        {
+            return c < 'A' || c > 'Z';
+        }
+
+        constexpr bool IsFoldedASCIIWord(uint64_t word)
+        {
+            return (word & s_EachByteHighBit) == 0 && HasNoUpperASCIIWord(word);
+        }
+
+        constexpr bool IsFoldedASCIIByte(unsigned char c)
+        {
+            return c < 0x80 && IsNotUpperASCII(c);
+        }
+
+        // Writes the input to the output with the ASCII letters lower cased; the output must be at least as long as the input.
+        void ToLowerASCII(std::string_view input, char* output)
+        {
+            const char* current = input.data();
+            const char* end = current + input.size();
+
+            for (; static_cast<size_t>(end - current) >= sizeof(uint64_t); current += sizeof(uint64_t), output += sizeof(uint64_t))
+            {
+                uint64_t word;
+                memcpy(&word, current, sizeof(word));
+                word = ToLowerASCIIWord(word);
+                memcpy(output, &word, sizeof(word));
+            }
+
+            for (; current < end; ++current, ++output)
+            {
+                *output = ToLowerASCII(*current);
+            }
+        }
+
+        // Gets the length of the start of the string that is printable ASCII, with each byte being exactly one column wide,
+        // and that can be measured without considering the rest of the string.
+        // The last printable character before anything else is left out, as it could start a grapheme cluster with what follows (ex. a combining mark).
+        size_t GetSingleColumnPrefixLength(std::string_view input)
+        {
+            size_t result = CountLeadingBytesThatPass(input, IsPrintableASCIIWord, IsPrintableASCIIByte);
+            return (result == input.size() || result == 0 ? result : result - 1);
+        }
+
         // Contains the ICU objects necessary to do break iteration.
         struct ICUBreakIterator
         {
@@ -96,7 +226,36 @@ namespace AppInstaller::Utility
 
     bool CaseInsensitiveEquals(std::string_view a, std::string_view b)
     {
-        return ToLower(a) == ToLower(b);
+        if (a.length() != b.length())
+        {
+            return false;
+        }
+
+        const char* currentA = a.data();
+        const char* currentB = b.data();
+        const char* endA = currentA + a.length();
+
+        for (; static_cast<size_t>(endA - currentA) >= sizeof(uint64_t); currentA += sizeof(uint64_t), currentB += sizeof(uint64_t))
+        {
+            uint64_t wordA;
+            uint64_t wordB;
+            memcpy(&wordA, currentA, sizeof(wordA));
+            memcpy(&wordB, currentB, sizeof(wordB));
+            if (wordA != wordB && ToLowerASCIIWord(wordA) != ToLowerASCIIWord(wordB))
+            {
+                return false;
+            }
+        }
+
+        for (; currentA < endA; ++currentA, ++currentB)
+        {
+            if (ToLowerASCII(*currentA) != ToLowerASCII(*currentB))
+            {
+                return false;
+            }
+        }
+
+        return true;
     }
 
     bool CaseInsensitiveStartsWith(std::string_view a, std::string_view b)
@@ -106,6 +265,12 @@ namespace AppInstaller::Utility
 
     bool ICUCaseInsensitiveEquals(std::string_view a, std::string_view b)
     {
+        // ASCII folds to its lower case, so only values with other characters need ICU
+        if (IsASCII(a) && IsASCII(b))
+        {
+            return CaseInsensitiveEquals(a, b);
+        }
+
         return FoldCase(a) == FoldCase(b);
     }
 
@@ -114,6 +279,134 @@ namespace AppInstaller::Utility
         return a.length() >= b.length() && ICUCaseInsensitiveEquals(a.substr(0, b.length()), b);
     }
 
+    namespace
+    {
+        // Computes the edit distance of the pattern against the text, or against the best substring of the text.
+        // Patterns that fit in a machine word use Myers' bit-parallel algorithm (as formulated by Hyyro), which
+        // advances a whole column of the distance matrix with a handful of word operations per text byte.
+        size_t EditDistanceInternal(std::string_view text, std::string_view pattern, size_t maxDistance, bool substring)
+        {
+            constexpr size_t wordBits = std::numeric_limits<uint64_t>::digits;
+
+            const size_t m = pattern.size();
+            size_t best = (substring ? m : m + text.size());
+
+            if (m == 0 || (!substring && text.empty()))
+            {
+                return std::min(best, maxDistance + 1);
+            }
+
+            if (m <= wordBits)
+            {
+                std::array<uint64_t, 256> peq{};
+                for (size_t i = 0; i < m; ++i)
+                {
+                    peq[static_cast<unsigned char>(pattern[i])] |= (uint64_t{ 1 } << i);
+                }
+
+                const uint64_t high = uint64_t{ 1 } << (m - 1);
+                uint64_t pv = ~uint64_t{ 0 };
+                uint64_t mv = 0;
+                size_t score = m;
+                best = m;
+
+                for (char c : text)
+                {
+                    uint64_t eq = peq[static_cast<unsigned char>(c)];
+                    uint64_t xv = eq | mv;
+                    uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+                    uint64_t ph = mv | ~(xh | pv);
+                    uint64_t mh = pv & xh;
+
+                    if (ph & high)
+                    {
+                        ++score;
+                    }
+                    else if (mh & high)
+                    {
+                        --score;
+                    }
+
+                    // Matching a substring may start anywhere in the text, so the top row is all zeros rather than increasing.
+                    ph = (ph << 1) | (substring ? 0 : 1);
+                    mh <<= 1;
+                    pv = mh | ~(xv | ph);
+                    mv = ph & xv;
+
+                    if (substring)
+                    {
+                        best = std::min(best, score);
+                        if (best == 0)
+                        {
+                            break;
+                        }
+                    }
+                }
+
+                if (!substring)
+                {
+                    best = score;
+                }
+            }
+            else
+            {
+                // Long patterns are rare enough to use the plain dynamic programming over two rows.
+                std::vector<size_t> previous(m + 1);
+                std::vector<size_t> current(m + 1);
+
+                for (size_t i = 0; i <= m; ++i)
+                {
+                    previous[i] = i;
+                }
+
+                best = m;
+
+                for (size_t j = 0; j < text.size(); ++j)
+                {
+                    current[0] = (substring ? 0 : j + 1);
+
+                    for (size_t i = 1; i <= m; ++i)
+                    {
+                        size_t substitution = previous[i - 1] + (pattern[i - 1] == text[j] ? 0 : 1);
+                        current[i] = std::min({ substitution, previous[i] + 1, current[i - 1] + 1 });
+                    }
+
+                    std::swap(previous, current);
+
+                    if (substring)
+                    {
+                        best = std::min(best, previous[m]);
+                    }
+                }
+
+                if (!substring)
+                {
+                    best = previous[m];
+                }
+            }
+
+            return std::min(best, maxDistance + 1);
+        }
+    }
+
+    size_t BoundedEditDistance(std::string_view a, std::string_view b, size_t maxDistance)
+    {
+        // The distance is at least the difference in length, so avoid the comparison entirely when that is too far.
+        size_t lengthDifference = (a.size() > b.size() ? a.size() - b.size() : b.size() - a.size());
+        if (lengthDifference > maxDistance)
+        {
+            return maxDistance + 1;
+        }
+
+        // The distance is symmetric, so use the shorter string as the pattern to keep it within a word when possible.
+        return (a.size() < b.size() ? EditDistanceInternal(b, a, maxDistance, false) : EditDistanceInternal(a, b, maxDistance, false));
+    }
+
+    size_t BoundedSubstringEditDistance(std::string_view value, std::string_view pattern, size_t maxDistance)
+    {
+        return EditDistanceInternal(value, pattern, maxDistance, true);
+    }
+
     std::string ConvertToUTF8(std::wstring_view input)
     {
         if (input.empty())
@@ -168,11 +461,30 @@ namespace AppInstaller::Utility
         return numGraphemeClusters;
     }
 
+    bool IsASCII(std::string_view input)
+    {
+        return AllBytesPass(input,
+            [](uint64_t word) { return (word & s_EachByteHighBit) == 0; },
+            [](unsigned char c) { return c < 0x80; });
+    }
+
+    bool IsPrintableASCII(std::string_view input)
+    {
+        return AllBytesPass(input, IsPrintableASCIIWord, IsPrintableASCIIByte);
+    }
+
     size_t UTF8ColumnWidth(const NormalizedUTF8<NormalizationC>& input)
     {
-        ICUBreakIterator itr{ input, UBRK_CHARACTER };
+        size_t prefixLength = GetSingleColumnPrefixLength(input);
+        if (prefixLength == input.length())
+        {
+            return prefixLength;
+        }
 
-        size_t columnWidth = 0;
+        // Only the part after the single column prefix needs ICU
+        ICUBreakIterator itr{ std::string_view{ input }.substr(prefixLength), UBRK_CHARACTER };
+
+        size_t columnWidth = prefixLength;
         UChar32 currentCP = 0;
 
         currentCP = itr.CurrentCodePoint();
@@ -215,9 +527,17 @@ namespace AppInstaller::Utility
 
     std::string UTF8TrimRightToColumnWidth(const NormalizedUTF8<NormalizationC>& input, size_t expectedWidth, size_t& actualWidth)
     {
-        ICUBreakIterator itr{ input, UBRK_CHARACTER };
+        size_t prefixLength = GetSingleColumnPrefixLength(input);
+        if (prefixLength == input.length() || expectedWidth <= prefixLength)
+        {
+            actualWidth = std::min(prefixLength, expectedWidth);
+            return input.substr(0, actualWidth);
+        }
+
+        // Only the part after the single column prefix needs ICU
+        ICUBreakIterator itr{ std::string_view{ input }.substr(prefixLength), UBRK_CHARACTER };
 
-        size_t columnWidth = 0;
+        size_t columnWidth = prefixLength;
         UChar32 currentCP = 0;
         int32_t currentBrk = 0;
         int32_t nextBrk = 0;
@@ -244,7 +564,7 @@ namespace AppInstaller::Utility
 
         actualWidth = columnWidth;
 
-        return input.substr(0, currentBrk);
+        return input.substr(0, prefixLength + currentBrk);
     }
 
     std::string Normalize(std::string_view input, NORM_FORM form)
@@ -254,6 +574,11 @@ namespace AppInstaller::Utility
             return {};
         }
 
+        if (IsASCII(input))
+        {
+            return std::string{ input };
+        }
+
         return ConvertToUTF8(Normalize(ConvertToUTF16(input), form));
     }
 
@@ -292,12 +617,23 @@ namespace AppInstaller::Utility
 
     std::string ToLower(std::string_view in)
     {
-        std::string result(in);
-        std::transform(result.begin(), result.end(), result.begin(),
-            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        std::string result(in.size(), '\0');
+        ToLowerASCII(in, result.data());
         return result;
     }
 
+    std::string_view ToLower(std::string_view in, std::string& buffer)
+    {
+        if (AllBytesPass(in, HasNoUpperASCIIWord, IsNotUpperASCII))
+        {
+            return in;
+        }
+
+        buffer.resize(in.size());
+        ToLowerASCII(in, buffer.data());
+        return buffer;
+    }
+
     std::wstring ToLower(std::wstring_view in)
     {
         std::wstring result(in);
@@ -313,6 +649,12 @@ namespace AppInstaller::Utility
             return {};
         }
 
+        // Folding ASCII is the same as lower casing it
+        if (IsASCII(input))
+        {
+            return ToLower(input);
+        }
+
         wil::unique_any<UCaseMap*, decltype(ucasemap_close), &ucasemap_close> caseMap;
         UErrorCode errorCode = UErrorCode::U_ZERO_ERROR;
         caseMap.reset(ucasemap_open(nullptr, U_FOLD_CASE_DEFAULT, &errorCode));
@@ -348,6 +690,17 @@ namespace AppInstaller::Utility
         return result;
     }
 
+    std::string_view FoldCase(std::string_view input, std::string& buffer)
+    {
+        if (AllBytesPass(input, IsFoldedASCIIWord, IsFoldedASCIIByte))
+        {
+            return input;
+        }
+
+        buffer = FoldCase(input);
+        return buffer;
+    }
+
     NormalizedString FoldCase(const NormalizedString& input)
     {
         NormalizedString result;
@@ -355,6 +708,41 @@ namespace AppInstaller::Utility
         return result;
     }
 
+    std::string FoldCaseByCodePoint(std::string_view input)
+    {
+        if (IsASCII(input))
+        {
+            return ToLower(input);
+        }
+
+        std::wstring utf16 = ConvertToUTF16(input);
+        std::wstring result;
+        result.reserve(utf16.size());
+
+        for (size_t i = 0; i < utf16.size(); ++i)
+        {
+            UChar32 c = utf16[i];
+            if (U16_IS_LEAD(c) && i + 1 < utf16.size() && U16_IS_TRAIL(utf16[i + 1]))
+            {
+                c = U16_GET_SUPPLEMENTARY(c, utf16[++i]);
+            }
+
+            c = u_foldCase(c, U_FOLD_CASE_DEFAULT);
+
+            if (c > 0xFFFF)
+            {
+                result.push_back(static_cast<wchar_t>(U16_LEAD(c)));
+                result.push_back(static_cast<wchar_t>(U16_TRAIL(c)));
+            }
+            else
+            {
+                result.push_back(static_cast<wchar_t>(c));
+            }
+        }
+
+        return ConvertToUTF8(result);
+    }
+
     bool IsEmptyOrWhitespace(std::string_view str)
     {
         if (str.empty())
@@ -683,6 +683,138 @@ namespace AppInstaller::Logging
         }
     }
 
+    void TelemetryTraceLogger::LogCompressedRestResponse(std::string_view encoding, uint64_t compressedBytes, uint64_t decompressedBytes) const noexcept
+    {
+        if (IsTelemetryEnabled())
+        {
+            AICLI_TraceLoggingWriteActivity(
+                "CompressedRestResponse",
+                TraceLoggingUInt32(m_subExecutionId, "SubExecutionId"),
+                AICLI_TraceLoggingStringView(encoding, "Encoding"),
+                TraceLoggingUInt64(compressedBytes, "CompressedBytes"),
+                TraceLoggingUInt64(decompressedBytes, "DecompressedBytes"),
+                TelemetryPrivacyDataTag(PDT_ProductAndServicePerformance),
+                TraceLoggingKeyword(MICROSOFT_KEYWORD_MEASURES));
+
+            m_summary.RestCompressedBytes += compressedBytes;
+            m_summary.RestDecompressedBytes += decompressedBytes;
+        }
+
+        AICLI_LOG(Repo, Verbose, << "Received " << compressedBytes << " bytes of " << encoding << " encoded response for " << decompressedBytes << " bytes of content");
+    }
+
+    void TelemetryTraceLogger::LogSourceOpen(std::string_view sourceIdentifier, std::string_view sourceType, std::chrono::milliseconds duration, bool updated) const noexcept
+    {
+        if (IsTelemetryEnabled())
+        {
+            AICLI_TraceLoggingWriteActivity(
+                "SourceOpen",
+                TraceLoggingUInt32(m_subExecutionId, "SubExecutionId"),
+                AICLI_TraceLoggingStringView(sourceIdentifier, "SourceIdentifier"),
+                AICLI_TraceLoggingStringView(sourceType, "SourceType"),
+                TraceLoggingInt64(duration.count(), "DurationInMilliseconds"),
+                TraceLoggingBool(updated, "Updated"),
+                TelemetryPrivacyDataTag(PDT_ProductAndServicePerformance),
+                TraceLoggingKeyword(MICROSOFT_KEYWORD_MEASURES));
+        }
+
+        AICLI_LOG(Repo, Verbose, << "Opened source " << sourceIdentifier << " in " << duration.count() << "ms" << (updated ? " after updating it" : ""));
+    }
+
+    void TelemetryTraceLogger::LogSourceUpdate(
+        std::string_view sourceIdentifier,
+        std::string_view sourceType,
+        bool isBackground,
+        bool succeeded,
+        std::chrono::milliseconds duration,
+        uint64_t bytesReceived) const noexcept
+    {
+        if (IsTelemetryEnabled())
+        {
+            AICLI_TraceLoggingWriteActivity(
+                "SourceUpdate",
+                TraceLoggingUInt32(m_subExecutionId, "SubExecutionId"),
+                AICLI_TraceLoggingStringView(sourceIdentifier, "SourceIdentifier"),
+                AICLI_TraceLoggingStringView(sourceType, "SourceType"),
+                TraceLoggingBool(isBackground, "IsBackground"),
+                TraceLoggingBool(succeeded, "Succeeded"),
+                TraceLoggingInt64(duration.count(), "DurationInMilliseconds"),
+                TraceLoggingUInt64(bytesReceived, "BytesReceived"),
+                TelemetryPrivacyDataTag(PDT_ProductAndServicePerformance),
+                TraceLoggingKeyword(MICROSOFT_KEYWORD_MEASURES));
+        }
+
+        AICLI_LOG(Repo, Verbose, << "Update of source " << sourceIdentifier << (succeeded ? " succeeded" : " failed") << " in " << duration.count() << "ms, receiving " << bytesReceived << " bytes");
+    }
+
+    void TelemetryTraceLogger::LogSourceSearch(std::string_view sourceIdentifier, std::chrono::milliseconds duration, uint64_t resultCount) const noexcept
+    {
+        if (IsTelemetryEnabled())
+        {
+            AICLI_TraceLoggingWriteActivity(
+                "SourceSearch",
+                TraceLoggingUInt32(m_subExecutionId, "SubExecutionId"),
+                AICLI_TraceLoggingStringView(sourceIdentifier, "SourceIdentifier"),
+                TraceLoggingInt64(duration.count(), "DurationInMilliseconds"),
+                TraceLoggingUInt64(resultCount, "ResultCount"),
+                TelemetryPrivacyDataTag(PDT_ProductAndServicePerformance),
+                TraceLoggingKeyword(MICROSOFT_KEYWORD_MEASURES));
+        }
+    }
+
+    void TelemetryTraceLogger::LogRestRequest() const noexcept
+    {
+        if (IsTelemetryEnabled())
+        {
+            ++m_summary.RestRequestCount;
+        }
+    }
+
+    void TelemetryTraceLogger::LogManifestCacheResult(bool hit) const noexcept
+    {
+        if (IsTelemetryEnabled())
+        {
+            ++(hit ? m_summary.ManifestCacheHits : m_summary.ManifestCacheMisses);
+        }
+    }
+
+    void TelemetryTraceLogger::LogDownloadConcurrencyChange(uint32_t previousLimit, uint32_t newLimit, uint64_t bytesPerSecond, uint32_t activeDownloads, uint32_t activeHosts) const noexcept
+    {
+        if (IsTelemetryEnabled())
+        {
+            AICLI_TraceLoggingWriteActivity(
+                "DownloadConcurrencyChange",
+                TraceLoggingUInt32(m_subExecutionId, "SubExecutionId"),
+                TraceLoggingUInt32(previousLimit, "PreviousLimit"),
+                TraceLoggingUInt32(newLimit, "NewLimit"),
+                TraceLoggingUInt64(bytesPerSecond, "BytesPerSecond"),
+                TraceLoggingUInt32(activeDownloads, "ActiveDownloads"),
+                TraceLoggingUInt32(activeHosts, "ActiveHosts"),
+                TelemetryPrivacyDataTag(PDT_ProductAndServicePerformance),
+                TraceLoggingKeyword(MICROSOFT_KEYWORD_MEASURES));
+        }
+
+        AICLI_LOG(Core, Info, << "Download concurrency changed from " << previousLimit << " to " << newLimit << " at " << bytesPerSecond <<
+            " bytes per second with " << activeDownloads << " downloads from " << activeHosts << " hosts");
+    }
+
+    void TelemetryTraceLogger::LogMemoryTrim(size_t trimFunctionCount, uint64_t workingSetBefore, uint64_t workingSetAfter) const noexcept
+    {
+        if (IsTelemetryEnabled())
+        {
+            AICLI_TraceLoggingWriteActivity(
+                "MemoryTrim",
+                TraceLoggingUInt32(m_subExecutionId, "SubExecutionId"),
+                TraceLoggingUInt64(static_cast<uint64_t>(trimFunctionCount), "TrimFunctionCount"),
+                TraceLoggingUInt64(workingSetBefore, "WorkingSetBefore"),
+                TraceLoggingUInt64(workingSetAfter, "WorkingSetAfter"),
+                TelemetryPrivacyDataTag(PDT_ProductAndServicePerformance),
+                TraceLoggingKeyword(MICROSOFT_KEYWORD_MEASURES));
+        }
+
+        AICLI_LOG(Core, Info, << "Memory trimmed by " << trimFunctionCount << " functions; working set went from " << workingSetBefore << " to " << workingSetAfter << " bytes");
+    }
+
     TelemetryTraceLogger::~TelemetryTraceLogger()
     {
         if (IsTelemetryEnabled())
@@ -754,6 +886,11 @@ namespace AppInstaller::Logging
                 AICLI_TraceLoggingStringView(m_summary.ARPPublisher, "ARPPublisher"),
                 AICLI_TraceLoggingStringView(m_summary.DOUrl, "DOUrl"),
                 TraceLoggingHResult(m_summary.DOHResult, "DOHResult"),
+                TraceLoggingUInt64(m_summary.RestCompressedBytes, "RestCompressedBytes"),
+                TraceLoggingUInt64(m_summary.RestDecompressedBytes, "RestDecompressedBytes"),
+                TraceLoggingUInt64(m_summary.RestRequestCount, "RestRequestCount"),
+                TraceLoggingUInt64(m_summary.ManifestCacheHits, "ManifestCacheHits"),
+                TraceLoggingUInt64(m_summary.ManifestCacheMisses, "ManifestCacheMisses"),
                 TelemetryPrivacyDataTag(PDT_ProductAndServicePerformance | PDT_ProductAndServiceUsage | PDT_SoftwareSetupAndInventory),
                 TraceLoggingKeyword(MICROSOFT_KEYWORD_MEASURES));
         }
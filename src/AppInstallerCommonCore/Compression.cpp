@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Public/winget/Compression.h"
+
+#include <compressapi.h>
+
+
+namespace AppInstaller::Compression
+{
+    namespace
+    {
+        using unique_compressor = wil::unique_any<COMPRESSOR_HANDLE, decltype(&::CloseCompressor), ::CloseCompressor>;
+        using unique_decompressor = wil::unique_any<DECOMPRESSOR_HANDLE, decltype(&::CloseDecompressor), ::CloseDecompressor>;
+    }
+
+    std::vector<uint8_t> Compress(std::string_view text)
+    {
+        if (text.empty())
+        {
+            return {};
+        }
+
+        unique_compressor compressor;
+        THROW_IF_WIN32_BOOL_FALSE(::CreateCompressor(COMPRESS_ALGORITHM_MSZIP, nullptr, &compressor));
+
+        // The buffer mode used here records the uncompressed size, which lets Decompress size its output.
+        SIZE_T compressedSize = 0;
+        if (!::Compress(compressor.get(), text.data(), text.size(), nullptr, 0, &compressedSize))
+        {
+            DWORD error = GetLastError();
+            THROW_WIN32_IF(error, error != ERROR_INSUFFICIENT_BUFFER);
+        }
+
+        std::vector<uint8_t> result(compressedSize);
+        THROW_IF_WIN32_BOOL_FALSE(::Compress(compressor.get(), text.data(), text.size(), result.data(), result.size(), &compressedSize));
+        result.resize(compressedSize);
+
+        return result;
+    }
+
+    std::string Decompress(const std::vector<uint8_t>& compressed)
+    {
+        if (compressed.empty())
+        {
+            return {};
+        }
+
+        unique_decompressor decompressor;
+        THROW_IF_WIN32_BOOL_FALSE(::CreateDecompressor(COMPRESS_ALGORITHM_MSZIP, nullptr, &decompressor));
+
+        SIZE_T decompressedSize = 0;
+        if (!::Decompress(decompressor.get(), compressed.data(), compressed.size(), nullptr, 0, &decompressedSize))
+        {
+            DWORD error = GetLastError();
+            THROW_WIN32_IF(error, error != ERROR_INSUFFICIENT_BUFFER);
+        }
+
+        std::string result(decompressedSize, '\0');
+        THROW_IF_WIN32_BOOL_FALSE(::Decompress(decompressor.get(), compressed.data(), compressed.size(), result.data(), result.size(), &decompressedSize));
+        result.resize(decompressedSize);
+
+        return result;
+    }
+}
@@ -22,6 +22,9 @@ namespace AppInstaller::Utility
 #define DO_E_BLOCKED_BY_POWER_STATE             HRESULT(0x80D03804L)    // DO core paused the job due to detection of power state change into non-AC mode
 #define DO_E_BLOCKED_BY_NO_NETWORK              HRESULT(0x80D03805L)    // DO core paused the job due to loss of network connectivity
 
+        // Progress is driven by the status callback; the status is only read directly when no callback arrives in this time.
+        constexpr std::chrono::seconds s_statusWatchdogInterval = std::chrono::seconds(30);
+
         // Represents a download work item for Delivery Optimization.
         struct Download
         {
@@ -167,6 +170,12 @@ namespace AppInstaller::Utility
                 THROW_IF_FAILED(m_download->Start(&emptyRanges));
             }
 
+            // A paused download is continued by calling Start again.
+            void Pause()
+            {
+                THROW_IF_FAILED(m_download->Pause());
+            }
+
             // Returns true if Abort was successful; false if not.
             bool Cancel()
             {
@@ -249,7 +258,7 @@ namespace AppInstaller::Utility
             }
 
             // Returns true on successful completion, false on cancellation, and throws on an error.
-            bool Wait()
+            bool Wait(Download& download)
             {
                 std::unique_lock<std::mutex> lock(m_statusMutex);
 
@@ -260,16 +269,25 @@ namespace AppInstaller::Utility
 
                 while (!m_progress.IsCancelled())
                 {
-                    if (!transferChange)
+                    auto now = std::chrono::steady_clock::now();
+                    if (!transferChange && now >= timeoutTime)
                     {
-                        if (m_statusCV.wait_until(lock, timeoutTime) == std::cv_status::timeout)
-                        {
-                            THROW_HR(DO_E_DOWNLOAD_NO_PROGRESS);
-                        }
+                        THROW_HR(DO_E_DOWNLOAD_NO_PROGRESS);
                     }
-                    else
+
+                    auto waitUntil = now + s_statusWatchdogInterval;
+                    if (!transferChange && timeoutTime < waitUntil)
                     {
-                        m_statusCV.wait(lock);
+                        waitUntil = timeoutTime;
+                    }
+
+                    if (m_statusCV.wait_until(lock, waitUntil) == std::cv_status::timeout && !m_progress.IsCancelled())
+                    {
+                        // No callback arrived; read the status in case one was missed.
+                        lock.unlock();
+                        DO_DOWNLOAD_STATUS status = download.Status();
+                        lock.lock();
+                        m_currentStatus = status;
                     }
 
                     // Since we just finished a wait, check for cancellation before handling anything else
@@ -310,6 +328,25 @@ namespace AppInstaller::Utility
                         {
                             transferChange = true;
                         }
+
+                        if (m_progress.IsPauseRequested())
+                        {
+                            AICLI_LOG(Core, Info, << "Pausing DeliveryOptimization download at " << m_currentStatus.BytesTransferred << " bytes");
+
+                            lock.unlock();
+                            download.Pause();
+                            m_progress.WaitWhilePaused();
+                            if (!m_progress.IsCancelled())
+                            {
+                                download.Start();
+                            }
+                            lock.lock();
+
+                            // The time spent paused does not count toward the progress timeout.
+                            timeoutTime = std::chrono::steady_clock::now() + Settings::User().Get<Settings::Setting::NetworkDOProgressTimeoutInSeconds>();
+                            initialTransferAmount.reset();
+                            transferChange = false;
+                        }
                         break;
 
                         // These are considered to be 'done'
@@ -360,7 +397,8 @@ namespace AppInstaller::Utility
         THROW_IF_FAILED(DeliveryOptimization::DODownloadStatusCallback::Create(progress, &callback));
 
         download.Uri(url);
-        download.ForegroundPriority(true);
+        // In the background, the download follows the background bandwidth limits of Delivery Optimization.
+        download.ForegroundPriority(!Settings::User().Get<Settings::Setting::NetworkBackgroundDownloads>());
         download.LocalPath(dest);
         download.CallbackInterface(callback.get());
 
@@ -395,7 +433,7 @@ namespace AppInstaller::Utility
         }
 
         // Wait returns true for success, false for cancellation, and throws on error.
-        if (callback->Wait())
+        if (callback->Wait(download))
         {
             // Finalize is required to flush the data and change the file name.
             download.Finalize();
@@ -403,8 +441,7 @@ namespace AppInstaller::Utility
 
             if (computeHash)
             {
-                std::ifstream inStream{ dest, std::ifstream::binary };
-                return SHA256::ComputeHash(inStream);
+                return SHA256::ComputeHashFromFile(dest);
             }
         }
 
@@ -4,6 +4,7 @@
 #include "Public/winget/Debugging.h"
 #include "Public/AppInstallerRuntime.h"
 #include "Public/AppInstallerDateTime.h"
+#include "Public/AppInstallerFileLogger.h"
 
 namespace AppInstaller::Debugging
 {
@@ -12,6 +13,9 @@ namespace AppInstaller::Debugging
         constexpr std::string_view c_minidumpPrefix = "Minidump";
         constexpr std::string_view c_minidumpExtension = ".mdmp";
 
+        // How long a crash waits for the pending log records to be written.
+        constexpr std::chrono::milliseconds c_logFlushTimeout = std::chrono::milliseconds(500);
+
         struct SelfInitiatedMinidumpHelper
         {
             SelfInitiatedMinidumpHelper() : m_keepFile(false)
@@ -54,6 +58,8 @@ namespace AppInstaller::Debugging
                     Instance().m_keepFile = true;
                 }).join();
 
+                Logging::FileLogger::FlushAll(c_logFlushTimeout);
+
                 return EXCEPTION_CONTINUE_SEARCH;
             }
 
@@ -89,46 +89,97 @@ namespace AppInstaller::Manifest
     void DependencyGraph::CheckForLoopsAndGetOrder()
     {
         m_installationOrder = std::vector<Dependency>();
-        std::set<Dependency> visited;
-        m_HasLoop = HasLoopDFS(visited, m_root);
-    }
+        m_HasLoop = false;
 
-    std::vector<Dependency> DependencyGraph::GetInstallationOrder()
-    {
-        return m_installationOrder;
-    }
+        // A single depth first search from the root, visiting each node once. Reaching a node that is still on the
+        // current path closes a loop; the search continues past it to have a complete order at the end.
+        // A node is added to the order once all of its adjacents have been, so they come before it.
+        enum class VisitState
+        {
+            OnPath,
+            Done,
+        };
 
-    // TODO make this function iterative
-    bool DependencyGraph::HasLoopDFS(std::set<Dependency> visited, const Dependency& node)
-    {
-        bool loop = false;
+        struct PathEntry
+        {
+            const Dependency* Node;
+            std::set<Dependency>::const_iterator Current;
+            std::set<Dependency>::const_iterator End;
+        };
+
+        std::map<Dependency, VisitState> states;
+        std::vector<PathEntry> path;
 
-        visited.insert(node);
-        auto lAdjacents = m_adjacents.at(node);
-        for (const auto& adjacent : m_adjacents.at(node))
+        auto enterNode = [&](const Dependency& node)
         {
-            auto search = visited.find(adjacent);
-            if (search == visited.end()) // if not found
+            auto itr = m_adjacents.find(node);
+            states.emplace(itr->first, VisitState::OnPath);
+            path.push_back({ &itr->first, itr->second.cbegin(), itr->second.cend() });
+        };
+
+        enterNode(m_root);
+
+        while (!path.empty())
+        {
+            PathEntry& entry = path.back();
+
+            if (entry.Current == entry.End)
             {
-                if (HasLoopDFS(visited, adjacent))
-                {
-                    loop = true;
-                    // didn't break the loop to have a complete order at the end (even if a loop exists)
-                }
+                states[*entry.Node] = VisitState::Done;
+                m_installationOrder.push_back(*entry.Node);
+                path.pop_back();
+                continue;
+            }
+
+            const Dependency& adjacent = *entry.Current;
+            ++entry.Current;
+
+            auto state = states.find(adjacent);
+            if (state == states.end())
+            {
+                enterNode(adjacent);
             }
-            else
+            else if (state->second == VisitState::OnPath)
             {
-                loop = true;
-                // didn't break the loop to have a complete order at the end (even if a loop exists)
+                m_HasLoop = true;
             }
         }
 
-        // Adding to have an order even if a loop is present
-        if (std::find(m_installationOrder.begin(), m_installationOrder.end(), node) == m_installationOrder.end())
+        // The order has the adjacents of a node before it, except for those that close a loop,
+        // so the level of a node is one more than the highest level of the adjacents already placed.
+        m_installationLevels = std::vector<std::vector<Dependency>>();
+        std::map<Dependency, size_t> levels;
+
+        for (const auto& node : m_installationOrder)
         {
-            m_installationOrder.push_back(node);
+            size_t level = 0;
+            for (const auto& adjacent : m_adjacents.at(node))
+            {
+                auto search = levels.find(adjacent);
+                if (search != levels.end())
+                {
+                    level = std::max(level, search->second + 1);
+                }
+            }
+
+            levels.emplace(node, level);
+
+            if (level >= m_installationLevels.size())
+            {
+                m_installationLevels.resize(level + 1);
+            }
+
+            m_installationLevels[level].push_back(node);
         }
+    }
 
-        return loop;
+    std::vector<Dependency> DependencyGraph::GetInstallationOrder()
+    {
+        return m_installationOrder;
+    }
+
+    std::vector<std::vector<Dependency>> DependencyGraph::GetInstallationLevels()
+    {
+        return m_installationLevels;
     }
 }
\ No newline at end of file
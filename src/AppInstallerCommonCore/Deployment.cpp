@@ -66,6 +66,25 @@ namespace AppInstaller::Deployment
 
             return S_OK;
         }
+
+        // Registers the staged package; returns true if the registration was deferred because the package is in use.
+        bool RegisterPackageByFullName(PackageManager& packageManager, const std::wstring& packageFullName, IProgressCallback& callback)
+        {
+            size_t id = GetDeploymentOperationId();
+            AICLI_LOG(Core, Info, << "Starting RegisterPackageByFullNameAsync operation #" << id << ": " << Utility::ConvertToUTF8(packageFullName));
+
+            IAsyncOperationWithProgress<DeploymentResult, DeploymentProgress> registerOperation =
+                packageManager.RegisterPackageByFullNameAsync(packageFullName, nullptr, DeploymentOptions::None);
+            HRESULT hr = WaitForDeployment(registerOperation, id, callback, false);
+
+            if (hr == HRESULT_FROM_WIN32(ERROR_PACKAGES_IN_USE))
+            {
+                return true;
+            }
+
+            THROW_IF_FAILED(hr);
+            return false;
+        }
     }
 
     void AddPackage(
@@ -168,25 +187,42 @@ namespace AppInstaller::Deployment
             WaitForDeployment(stageOperation, id, callback);
         }
 
-        bool registrationDeferred = false;
+        bool registrationDeferred = RegisterPackageByFullName(packageManager, packageFullName, callback);
 
-        {
-            size_t id = GetDeploymentOperationId();
-            AICLI_LOG(Core, Info, << "Starting RegisterPackageByFullNameAsync operation #" << id << ": " << Utility::ConvertToUTF8(packageFullName));
+        removePackage.release();
+        return registrationDeferred;
+    }
 
-            IAsyncOperationWithProgress<DeploymentResult, DeploymentProgress> registerOperation =
-                packageManager.RegisterPackageByFullNameAsync(packageFullName, nullptr, DeploymentOptions::None);
-            HRESULT hr = WaitForDeployment(registerOperation, id, callback, false);
+    void StagePackage(
+        const std::string& uri,
+        IProgressCallback& callback)
+    {
+        size_t id = GetDeploymentOperationId();
+        AICLI_LOG(Core, Info, << "Starting StagePackageAsync operation #" << id << ": " << uri);
 
-            if (hr == HRESULT_FROM_WIN32(ERROR_PACKAGES_IN_USE))
-            {
-                registrationDeferred = true;
-            }
-            else
+        PackageManager packageManager;
+        Uri uriObject(Utility::ConvertToUTF16(uri));
+        IAsyncOperationWithProgress<DeploymentResult, DeploymentProgress> stageOperation = packageManager.StagePackageAsync(uriObject, nullptr);
+
+        WaitForDeployment(stageOperation, id, callback);
+    }
+
+    bool RegisterStagedPackage(
+        const std::string& uri,
+        IProgressCallback& callback)
+    {
+        PackageManager packageManager;
+
+        std::wstring packageFullName = Msix::MsixInfo{ uri }.GetPackageFullNameWide();
+        auto removePackage = wil::scope_exit([&]() {
+            try
             {
-                THROW_IF_FAILED(hr);
+                RemovePackage(Utility::ConvertToUTF8(packageFullName), callback);
             }
-        }
+            CATCH_LOG();
+        });
+
+        bool registrationDeferred = RegisterPackageByFullName(packageManager, packageFullName, callback);
 
         removePackage.release();
         return registrationDeferred;
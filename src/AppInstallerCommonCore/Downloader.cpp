@@ -10,142 +10,1625 @@
 #include "Public/AppInstallerLogging.h"
 #include "Public/AppInstallerTelemetry.h"
 #include "Public/winget/UserSettings.h"
+#include "Public/winget/ThreadGlobals.h"
+#include "Public/winget/BandwidthSchedule.h"
+#include "Public/winget/Timing.h"
 #include "DODownloader.h"
 
+#include <thread>
+
 using namespace AppInstaller::Runtime;
 using namespace AppInstaller::Settings;
+using namespace AppInstaller::ThreadLocalStorage;
+using namespace std::chrono_literals;
+
+namespace AppInstaller::Utility
+{
+    namespace
+    {
+        // Counts a request for the resources report.
+        void RecordHttpRequest(const std::string& url)
+        {
+            if (Timing::IsUsageEnabled())
+            {
+                Timing::RecordHttpRequest(url);
+            }
+        }
+
+        // Counts the bytes of a completed download for the resources report.
+        void RecordDownload(DownloadType type, uint64_t bytes)
+        {
+            if (!Timing::IsUsageEnabled())
+            {
+                return;
+            }
+
+            std::string_view name;
+            switch (type)
+            {
+            case DownloadType::Index: name = "Index"; break;
+            case DownloadType::Manifest: name = "Manifest"; break;
+            case DownloadType::WinGetUtil: name = "WinGetUtil"; break;
+            case DownloadType::Installer: name = "Installer"; break;
+            default: name = "Unknown"; break;
+            }
+
+            Timing::RecordDownload(name, bytes);
+        }
+
+        // The number of times an interrupted download is continued with a range request before failing.
+        constexpr int MaxResumeCount = 3;
+
+        // The suffix of the file next to a partially downloaded file that records how to continue it.
+        constexpr std::wstring_view s_PartialDownloadSuffix = L".partial";
+
+        // The state needed to continue an interrupted download where it left off.
+        struct ResumeState
+        {
+            // The strong ETag or Last-Modified value of the content, sent as If-Range when continuing.
+            std::string Validator;
+
+            // The number of bytes already written to the destination and added to the hash.
+            LONGLONG BytesDownloaded = 0;
+
+            // The size of the entire content, if provided by the server.
+            LONGLONG ContentLength = 0;
+
+            // Empties the destination, so that content which changed since the download began can be written from the start.
+            // If not set, such a download fails instead.
+            std::function<void()> Restart;
+
+            bool CanResume() const { return BytesDownloaded > 0 && !Validator.empty(); }
+        };
+
+        std::filesystem::path GetPartialDownloadRecordPath(const std::filesystem::path& dest)
+        {
+            std::filesystem::path result = dest;
+            result += s_PartialDownloadSuffix;
+            return result;
+        }
+
+        // Records a partial download so that a later download to the same path can continue it.
+        void WritePartialDownloadRecord(const std::filesystem::path& dest, const std::string& url, const ResumeState& state)
+        {
+            try
+            {
+                std::ofstream record{ GetPartialDownloadRecordPath(dest), std::ofstream::trunc };
+                record << url << '\n' << state.Validator << '\n' << state.BytesDownloaded << '\n' << state.ContentLength << '\n';
+            }
+            CATCH_LOG();
+        }
+
+        // Reads the partial download record for the destination, if it is for the same url and matches the file on disk.
+        std::optional<ResumeState> ReadPartialDownloadRecord(const std::filesystem::path& dest, const std::string& url)
+        {
+            std::ifstream record{ GetPartialDownloadRecordPath(dest) };
+            if (!record)
+            {
+                return {};
+            }
+
+            std::string recordUrl;
+            ResumeState state;
+            if (!std::getline(record, recordUrl) || !std::getline(record, state.Validator) || !(record >> state.BytesDownloaded >> state.ContentLength))
+            {
+                return {};
+            }
+
+            std::error_code ec;
+            auto fileSize = std::filesystem::file_size(dest, ec);
+            if (recordUrl != url || !state.CanResume() || ec || static_cast<LONGLONG>(fileSize) != state.BytesDownloaded)
+            {
+                return {};
+            }
+
+            return state;
+        }
+
+        void RemovePartialDownloadRecord(const std::filesystem::path& dest)
+        {
+            std::error_code ec;
+            std::filesystem::remove(GetPartialDownloadRecordPath(dest), ec);
+        }
+
+        std::optional<std::string> QueryHeader(HINTERNET request, DWORD query)
+        {
+            DWORD size = 0;
+            if (HttpQueryInfoA(request, query, nullptr, &size, nullptr) || GetLastError() != ERROR_INSUFFICIENT_BUFFER || size == 0)
+            {
+                return {};
+            }
+
+            std::string result(size, '\0');
+            if (!HttpQueryInfoA(request, query, result.data(), &size, nullptr))
+            {
+                return {};
+            }
+
+            result.resize(size);
+            return result;
+        }
+
+        wil::unique_hinternet OpenInternetSession()
+        {
+            wil::unique_hinternet session(InternetOpenA(
+                "winget-cli",
+                INTERNET_OPEN_TYPE_PRECONFIG,
+                NULL,
+                NULL,
+                0));
+            THROW_LAST_ERROR_IF_NULL_MSG(session, "InternetOpen() failed.");
+            return session;
+        }
+
+        // Gets the session shared by the downloads of this process. Connections to a server are kept alive by the session
+        // and reused by later downloads, and concurrent requests to an HTTP/2 server are multiplexed over one connection.
+        // Segmented downloads open their own session, as their point is to spread the content over several connections.
+        HINTERNET GetSharedInternetSession()
+        {
+            // Intentionally never closed, as the process may be unloading by the time a static would be destroyed.
+            static HINTERNET s_session = []()
+            {
+                wil::unique_hinternet session = OpenInternetSession();
+
+                DWORD protocols = HTTP_PROTOCOL_FLAG_HTTP2;
+                if (!InternetSetOptionA(session.get(), INTERNET_OPTION_ENABLE_HTTP_PROTOCOL, &protocols, sizeof(protocols)))
+                {
+                    AICLI_LOG(Core, Info, << "HTTP/2 is not available for downloads: " << GetLastError());
+                }
+
+                return session.release();
+            }();
+
+            return s_session;
+        }
+
+        // Gets the value that identifies this version of the content for an If-Range request.
+        std::string GetValidator(HINTERNET request)
+        {
+            // Weak entity tags cannot be used with If-Range.
+            std::optional<std::string> etag = QueryHeader(request, HTTP_QUERY_ETAG);
+            if (etag && !etag->empty() && !CaseInsensitiveStartsWith(etag.value(), "W/"))
+            {
+                return std::move(etag).value();
+            }
+
+            return QueryHeader(request, HTTP_QUERY_LAST_MODIFIED).value_or("");
+        }
+
+        // Whether downloads should yield to the work of the user, as configured.
+        bool IsBackgroundDownload()
+        {
+            return User().Get<Setting::NetworkBackgroundDownloads>();
+        }
+
+        // Puts the current thread in background mode while it exists, which lowers its CPU, I/O and memory priority.
+        struct BackgroundThreadScope
+        {
+            BackgroundThreadScope(bool background)
+            {
+                // Beginning fails if the thread is already in background mode, in which case it is left to the one that put it there.
+                m_active = background && SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+            }
+
+            BackgroundThreadScope(const BackgroundThreadScope&) = delete;
+            BackgroundThreadScope& operator=(const BackgroundThreadScope&) = delete;
+
+            ~BackgroundThreadScope()
+            {
+                if (m_active)
+                {
+                    LOG_IF_WIN32_BOOL_FALSE(SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END));
+                }
+            }
+
+        private:
+            bool m_active = false;
+        };
+
+        // Gives the file a low I/O priority when downloads are in the background.
+        void SetDownloadFileIoPriority(HANDLE file, bool background)
+        {
+            if (background)
+            {
+                FILE_IO_PRIORITY_HINT_INFO priorityHint{};
+                priorityHint.PriorityHint = IoPriorityHintLow;
+                LOG_IF_WIN32_BOOL_FALSE(SetFileInformationByHandle(file, FileIoPriorityHintInfo, &priorityHint, sizeof(priorityHint)));
+            }
+        }
+
+        // Limits the combined rate of all downloads in the process to the configured bandwidth.
+        // Each receiver reports what it has received, and is delayed until the bytes fit within the limit.
+        struct BandwidthLimiter
+        {
+            // Reads the configured limit; a limit of 0 does not delay anything.
+            BandwidthLimiter() : m_bytesPerSecond(static_cast<uint64_t>(User().Get<Setting::NetworkDownloadBandwidthLimitInKBps>()) * 1024) {}
+
+            // Waits until the bytes received fit within the limit, returning early if cancelled.
+            void OnBytesReceived(uint64_t count, const std::function<bool()>& isCancelled) const
+            {
+                // Every download in the process shares the limit.
+                static BandwidthSchedule s_schedule;
+
+                auto now = BandwidthSchedule::clock::now();
+                auto allowedAt = s_schedule.Schedule(count, m_bytesPerSecond, now);
+
+                while (now < allowedAt && !isCancelled())
+                {
+                    std::this_thread::sleep_for(std::min<BandwidthSchedule::clock::duration>(allowedAt - now, 100ms));
+                    now = BandwidthSchedule::clock::now();
+                }
+            }
+
+        private:
+            uint64_t m_bytesPerSecond;
+        };
+
+        // Passes the chunks received from the network to a hashing stage and a writing stage on their own threads,
+        // so that receiving, hashing and writing overlap and the throughput is that of the slowest of them.
+        struct DownloadPipeline
+        {
+            // Enough chunks for each stage to work on one while the receiver fills the next.
+            static constexpr size_t ChunkCount = 3;
+            static constexpr DWORD ChunkSize = 1024 * 1024; // 1MB
+
+            DownloadPipeline(std::ostream& dest, SHA256* hashEngine) : m_dest(dest), m_hashEngine(hashEngine), m_background(IsBackgroundDownload())
+            {
+                for (auto& chunk : m_chunks)
+                {
+                    chunk.Data = std::make_unique<BYTE[]>(ChunkSize);
+                }
+
+                if (m_hashEngine)
+                {
+                    m_hashThread = std::thread([this]()
+                        {
+                            BackgroundThreadScope backgroundScope{ m_background };
+                            RunStage(m_hashedCount, m_hashedBytes, [this](const Chunk& chunk)
+                                {
+                                    m_hashEngine->Add(chunk.Data.get(), chunk.Size);
+                                });
+                        });
+                }
+
+                m_writeThread = std::thread([this]()
+                    {
+                        BackgroundThreadScope backgroundScope{ m_background };
+                        RunStage(m_writtenCount, m_writtenBytes, [this](const Chunk& chunk)
+                            {
+                                m_dest.write(reinterpret_cast<const char*>(chunk.Data.get()), chunk.Size);
+                                THROW_HR_IF(E_FAIL, !m_dest);
+                            });
+                    });
+            }
+
+            DownloadPipeline(const DownloadPipeline&) = delete;
+            DownloadPipeline& operator=(const DownloadPipeline&) = delete;
+
+            ~DownloadPipeline()
+            {
+                Stop();
+            }
+
+            // Waits for a chunk that every stage is done with, and returns its buffer to be filled.
+            BYTE* AcquireChunk()
+            {
+                std::unique_lock<std::mutex> lock{ m_lock };
+                auto start = std::chrono::steady_clock::now();
+                m_changed.wait(lock, [this]() { return m_failure || m_receivedCount - GetSlowestCount() < ChunkCount; });
+                m_receiveWaitTime += std::chrono::steady_clock::now() - start;
+
+                ThrowIfFailed();
+                return m_chunks[m_receivedCount % ChunkCount].Data.get();
+            }
+
+            // Passes the chunk returned by the last AcquireChunk to the stages.
+            void SubmitChunk(DWORD size)
+            {
+                {
+                    std::lock_guard<std::mutex> lock{ m_lock };
+                    m_chunks[m_receivedCount % ChunkCount].Size = size;
+                    ++m_receivedCount;
+                    m_receivedBytes += size;
+                }
+
+                m_changed.notify_all();
+            }
+
+            // Waits for the stages to process every submitted chunk, and throws if any of them failed.
+            void Finish()
+            {
+                Stop();
+
+                std::lock_guard<std::mutex> lock{ m_lock };
+                ThrowIfFailed();
+            }
+
+            // Waits for the stages to process every submitted chunk, or to fail.
+            void Stop()
+            {
+                {
+                    std::lock_guard<std::mutex> lock{ m_lock };
+                    if (m_stopped)
+                    {
+                        return;
+                    }
+
+                    m_stopped = true;
+                }
+
+                m_changed.notify_all();
+
+                if (m_hashThread.joinable())
+                {
+                    m_hashThread.join();
+                }
+
+                if (m_writeThread.joinable())
+                {
+                    m_writeThread.join();
+                }
+
+                AICLI_LOG(Core, Verbose, << "Download pipeline received " << m_receivedBytes << " bytes, hashed " << m_hashedBytes << " bytes, and wrote " << m_writtenBytes <<
+                    " bytes; receiving waited " << std::chrono::duration_cast<std::chrono::milliseconds>(m_receiveWaitTime).count() << "ms for the other stages");
+            }
+
+            // Whether a hashing or writing stage failed, which leaves the hash and the written bytes out of step.
+            bool Failed() const
+            {
+                std::lock_guard<std::mutex> lock{ m_lock };
+                return static_cast<bool>(m_failure);
+            }
+
+            // Gets the number of bytes submitted to the stages.
+            LONGLONG GetReceivedBytes() const
+            {
+                std::lock_guard<std::mutex> lock{ m_lock };
+                return m_receivedBytes;
+            }
+
+            // Gets the number of bytes that have been both hashed and written.
+            LONGLONG GetCompletedBytes() const
+            {
+                std::lock_guard<std::mutex> lock{ m_lock };
+                return m_hashEngine ? std::min(m_hashedBytes, m_writtenBytes) : m_writtenBytes;
+            }
+
+        private:
+            struct Chunk
+            {
+                std::unique_ptr<BYTE[]> Data;
+                DWORD Size = 0;
+            };
+
+            size_t GetSlowestCount() const
+            {
+                return m_hashEngine ? std::min(m_hashedCount, m_writtenCount) : m_writtenCount;
+            }
+
+            void ThrowIfFailed() const
+            {
+                if (m_failure)
+                {
+                    std::rethrow_exception(m_failure);
+                }
+            }
+
+            // Processes the chunks in order until the pipeline is stopped and every submitted chunk is processed.
+            template <typename Process>
+            void RunStage(size_t& processedCount, LONGLONG& processedBytes, Process process)
+            {
+                try
+                {
+                    for (;;)
+                    {
+                        const Chunk* chunk = nullptr;
+                        {
+                            std::unique_lock<std::mutex> lock{ m_lock };
+                            m_changed.wait(lock, [&]() { return m_failure || processedCount < m_receivedCount || m_stopped; });
+
+                            if (m_failure || processedCount == m_receivedCount)
+                            {
+                                return;
+                            }
+
+                            chunk = &m_chunks[processedCount % ChunkCount];
+                        }
+
+                        // The receiver does not reuse the chunk until every stage has moved past it, so it is used without the lock.
+                        process(*chunk);
+
+                        {
+                            std::lock_guard<std::mutex> lock{ m_lock };
+                            ++processedCount;
+                            processedBytes += chunk->Size;
+                        }
+
+                        m_changed.notify_all();
+                    }
+                }
+                catch (...)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock{ m_lock };
+                        m_failure = std::current_exception();
+                    }
+
+                    m_changed.notify_all();
+                }
+            }
+
+            std::ostream& m_dest;
+            SHA256* m_hashEngine;
+            bool m_background;
+            std::array<Chunk, ChunkCount> m_chunks;
+
+            mutable std::mutex m_lock;
+            std::condition_variable m_changed;
+            size_t m_receivedCount = 0;
+            size_t m_hashedCount = 0;
+            size_t m_writtenCount = 0;
+            LONGLONG m_receivedBytes = 0;
+            LONGLONG m_hashedBytes = 0;
+            LONGLONG m_writtenBytes = 0;
+            std::chrono::steady_clock::duration m_receiveWaitTime{};
+            bool m_stopped = false;
+            std::exception_ptr m_failure;
+
+            std::thread m_hashThread;
+            std::thread m_writeThread;
+        };
+
+        // How an attempt to download the remaining content ended.
+        enum class DownloadAttemptResult
+        {
+            Completed,
+            Cancelled,
+            // Stopped between chunks, with the connection closed, so that the download can be paused and continued later.
+            Paused,
+        };
+
+        // Requests the content that has not been downloaded yet and appends it to the destination, updating the state as it goes.
+        DownloadAttemptResult WinINetDownloadRemaining(
+            HINTERNET session,
+            const std::string& url,
+            std::ostream& dest,
+            IProgressCallback& progress,
+            SHA256* hashEngine,
+            ResumeState& state)
+        {
+            // For AICLI_LOG usages with string literals.
+            #pragma warning(push)
+            #pragma warning(disable:26449)
+
+            std::string headers;
+            if (state.CanResume())
+            {
+                AICLI_LOG(Core, Info, << "Continuing download at byte " << state.BytesDownloaded);
+                headers = "Range: bytes=" + std::to_string(state.BytesDownloaded) + "-\r\nIf-Range: " + state.Validator + "\r\n";
+            }
+
+            RecordHttpRequest(url);
+            wil::unique_hinternet urlFile(InternetOpenUrlA(
+                session,
+                url.c_str(),
+                headers.empty() ? NULL : headers.c_str(),
+                static_cast<DWORD>(headers.size()),
+                INTERNET_FLAG_IGNORE_REDIRECT_TO_HTTPS, // This allows http->https redirection
+                0));
+            THROW_LAST_ERROR_IF_NULL_MSG(urlFile, "InternetOpenUrl() failed.");
+
+            // Check http return status
+            DWORD requestStatus = 0;
+            DWORD cbRequestStatus = sizeof(requestStatus);
+
+            THROW_LAST_ERROR_IF_MSG(!HttpQueryInfoA(urlFile.get(),
+                HTTP_QUERY_STATUS_CODE | HTTP_QUERY_FLAG_NUMBER,
+                &requestStatus,
+                &cbRequestStatus,
+                nullptr), "Query download request status failed.");
+
+            // The number of bytes at the start of the response that were already written.
+            LONGLONG bytesToSkip = 0;
+
+            // Whether the response is the entire content, to be written from the start.
+            bool isNewContent = false;
+
+            if (state.CanResume() && requestStatus == HTTP_STATUS_PARTIAL_CONTENT)
+            {
+                AICLI_LOG(Core, Verbose, << "Download request returned the remaining content.");
+            }
+            else if (state.CanResume() && requestStatus == HTTP_STATUS_OK && GetValidator(urlFile.get()) == state.Validator)
+            {
+                // The server does not support ranges, but the content is the same; skip over what is already written.
+                AICLI_LOG(Core, Info, << "Server returned the entire content; skipping the downloaded bytes.");
+                bytesToSkip = state.BytesDownloaded;
+            }
+            else if (state.CanResume() && requestStatus == HTTP_STATUS_OK)
+            {
+                // The content changed since the download started, so the downloaded bytes cannot be used.
+                state.Validator.clear();
+                THROW_HR_IF_MSG(APPINSTALLER_CLI_ERROR_DOWNLOAD_FAILED, !state.Restart, "Download content changed while continuing the download.");
+
+                AICLI_LOG(Core, Info, << "Download content changed since the download began; starting it over.");
+                state.Restart();
+                state.BytesDownloaded = 0;
+                if (hashEngine)
+                {
+                    *hashEngine = SHA256{};
+                }
+
+                isNewContent = true;
+            }
+            else if (requestStatus != HTTP_STATUS_OK)
+            {
+                AICLI_LOG(Core, Error, << "Download request failed. Returned status: " << requestStatus);
+                THROW_HR_MSG(MAKE_HRESULT(SEVERITY_ERROR, FACILITY_HTTP, requestStatus), "Download request status is not success.");
+            }
+            else
+            {
+                AICLI_LOG(Core, Verbose, << "Download request status success.");
+                isNewContent = true;
+            }
+
+            if (isNewContent)
+            {
+                // Get content length. Don't fail the download if failed.
+                LONGLONG contentLength = 0;
+                DWORD cbContentLength = sizeof(contentLength);
+
+                HttpQueryInfoA(
+                    urlFile.get(),
+                    HTTP_QUERY_CONTENT_LENGTH | HTTP_QUERY_FLAG_NUMBER64,
+                    &contentLength,
+                    &cbContentLength,
+                    nullptr);
+                AICLI_LOG(Core, Verbose, << "Download size: " << contentLength);
+
+                state.ContentLength = contentLength;
+                state.Validator = GetValidator(urlFile.get());
+            }
+
+            DownloadPipeline pipeline{ dest, hashEngine };
+            const BandwidthLimiter bandwidthLimiter;
+            const LONGLONG startingBytes = state.BytesDownloaded;
+
+            // However this attempt ends, only the bytes that were both hashed and written count as downloaded.
+            auto updateState = wil::scope_exit([&]()
+                {
+                    pipeline.Stop();
+                    state.BytesDownloaded = startingBytes + pipeline.GetCompletedBytes();
+
+                    if (pipeline.Failed())
+                    {
+                        // The hash and the destination may be out of step, so the download cannot be continued.
+                        state.Validator.clear();
+                    }
+                });
+
+            BOOL readSuccess = true;
+            DWORD bytesRead = 0;
+
+            do
+            {
+                if (progress.IsCancelled())
+                {
+                    AICLI_LOG(Core, Info, << "Download cancelled.");
+                    return DownloadAttemptResult::Cancelled;
+                }
+
+                // Only a download that the server can continue with a range is paused; otherwise it would start over.
+                if (bytesToSkip == 0 && !state.Validator.empty() && pipeline.GetReceivedBytes() > 0 && progress.IsPauseRequested())
+                {
+                    AICLI_LOG(Core, Info, << "Download paused after " << startingBytes + pipeline.GetReceivedBytes() << " bytes.");
+                    pipeline.Finish();
+                    return DownloadAttemptResult::Paused;
+                }
+
+                BYTE* buffer = pipeline.AcquireChunk();
+                readSuccess = InternetReadFile(urlFile.get(), buffer, DownloadPipeline::ChunkSize, &bytesRead);
+
+                THROW_LAST_ERROR_IF_MSG(!readSuccess, "InternetReadFile() failed.");
+                AddBytesReceived(bytesRead);
+                bandwidthLimiter.OnBytesReceived(bytesRead, [&]() { return progress.IsCancelled(); });
+
+                DWORD newBytesCount = bytesRead;
+
+                if (bytesToSkip > 0)
+                {
+                    DWORD skipped = static_cast<DWORD>(std::min<LONGLONG>(bytesToSkip, newBytesCount));
+                    bytesToSkip -= skipped;
+                    newBytesCount -= skipped;
+                    memmove(buffer, buffer + skipped, newBytesCount);
+                }
+
+                if (newBytesCount != 0)
+                {
+                    pipeline.SubmitChunk(newBytesCount);
+
+                    // Progress is reported as the bytes received, as the other stages are at most a few chunks behind.
+                    progress.OnProgress(startingBytes + pipeline.GetReceivedBytes(), state.ContentLength, ProgressType::Bytes);
+                }
+
+            } while (bytesRead != 0);
+
+            pipeline.Finish();
+
+            #pragma warning(pop)
+
+            return DownloadAttemptResult::Completed;
+        }
+
+        // Segmented downloads are only used for content at least this large, as smaller downloads gain little from them.
+        constexpr LONGLONG s_MinimumSegmentedDownloadSize = 16 * 1024 * 1024; // 16MB
+
+        // Information about content that can be downloaded in ranges.
+        struct RangeSupport
+        {
+            LONGLONG ContentLength = 0;
+            std::string Validator;
+        };
+
+        // Determines whether the server returns ranges of the content by requesting its first byte.
+        std::optional<RangeSupport> GetRangeSupport(HINTERNET session, const std::string& url)
+        {
+            static constexpr std::string_view s_rangeHeader = "Range: bytes=0-0\r\n";
+
+            RecordHttpRequest(url);
+            wil::unique_hinternet urlFile(InternetOpenUrlA(
+                session,
+                url.c_str(),
+                s_rangeHeader.data(),
+                static_cast<DWORD>(s_rangeHeader.size()),
+                INTERNET_FLAG_IGNORE_REDIRECT_TO_HTTPS, // This allows http->https redirection
+                0));
+            THROW_LAST_ERROR_IF_NULL_MSG(urlFile, "InternetOpenUrl() failed.");
+
+            DWORD requestStatus = 0;
+            DWORD cbRequestStatus = sizeof(requestStatus);
+
+            THROW_LAST_ERROR_IF_MSG(!HttpQueryInfoA(urlFile.get(),
+                HTTP_QUERY_STATUS_CODE | HTTP_QUERY_FLAG_NUMBER,
+                &requestStatus,
+                &cbRequestStatus,
+                nullptr), "Query download request status failed.");
+
+            if (requestStatus != HTTP_STATUS_PARTIAL_CONTENT)
+            {
+                AICLI_LOG(Core, Verbose, << "Server does not support range requests. Returned status: " << requestStatus);
+                return {};
+            }
+
+            // Content-Range is of the form "bytes 0-0/<length>", where the length may be '*' if it is unknown.
+            std::optional<std::string> contentRange = QueryHeader(urlFile.get(), HTTP_QUERY_CONTENT_RANGE);
+            size_t lengthStart = contentRange ? contentRange->rfind('/') : std::string::npos;
+            if (lengthStart == std::string::npos)
+            {
+                return {};
+            }
+
+            RangeSupport result;
+            try
+            {
+                result.ContentLength = std::stoll(contentRange->substr(lengthStart + 1));
+            }
+            catch (...)
+            {
+                return {};
+            }
+
+            result.Validator = GetValidator(urlFile.get());
+            return result;
+        }
+
+        // Downloads the bytes in [offset, end) of the content and writes them at the same offset in the file.
+        // The offset is moved past the bytes written, so a segment that is stopped can be continued from it.
+        void DownloadSegment(
+            HINTERNET session,
+            const std::string& url,
+            const std::string& validator,
+            HANDLE file,
+            LONGLONG& offset,
+            LONGLONG end,
+            std::atomic<LONGLONG>& bytesDownloaded,
+            const std::atomic_bool& stopped,
+            const BandwidthLimiter& bandwidthLimiter)
+        {
+            std::string headers = "Range: bytes=" + std::to_string(offset) + "-" + std::to_string(end - 1) + "\r\n";
+            if (!validator.empty())
+            {
+                // The server responds with the entire content if it changed, which is rejected below.
+                headers += "If-Range: " + validator + "\r\n";
+            }
+
+            RecordHttpRequest(url);
+            wil::unique_hinternet urlFile(InternetOpenUrlA(
+                session,
+                url.c_str(),
+                headers.c_str(),
+                static_cast<DWORD>(headers.size()),
+                INTERNET_FLAG_IGNORE_REDIRECT_TO_HTTPS, // This allows http->https redirection
+                0));
+            THROW_LAST_ERROR_IF_NULL_MSG(urlFile, "InternetOpenUrl() failed.");
+
+            DWORD requestStatus = 0;
+            DWORD cbRequestStatus = sizeof(requestStatus);
+
+            THROW_LAST_ERROR_IF_MSG(!HttpQueryInfoA(urlFile.get(),
+                HTTP_QUERY_STATUS_CODE | HTTP_QUERY_FLAG_NUMBER,
+                &requestStatus,
+                &cbRequestStatus,
+                nullptr), "Query download request status failed.");
+
+            THROW_HR_IF_MSG(APPINSTALLER_CLI_ERROR_DOWNLOAD_FAILED, requestStatus != HTTP_STATUS_PARTIAL_CONTENT,
+                "Segment request returned status %u", requestStatus);
+
+            const int bufferSize = 256 * 1024; // 256KB
+            auto buffer = std::make_unique<BYTE[]>(bufferSize);
+
+            DWORD bytesRead = 0;
+
+            do
+            {
+                if (stopped)
+                {
+                    return;
+                }
+
+                THROW_LAST_ERROR_IF_MSG(!InternetReadFile(urlFile.get(), buffer.get(), bufferSize, &bytesRead), "InternetReadFile() failed.");
+                THROW_HR_IF(APPINSTALLER_CLI_ERROR_DOWNLOAD_SIZE_MISMATCH, offset + bytesRead > end);
+
+                OVERLAPPED overlapped{};
+                overlapped.Offset = static_cast<DWORD>(offset);
+                overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+                DWORD bytesWritten = 0;
+                THROW_LAST_ERROR_IF(!WriteFile(file, buffer.get(), bytesRead, &bytesWritten, &overlapped));
+
+                offset += bytesRead;
+                bytesDownloaded += bytesRead;
+                AddBytesReceived(bytesRead);
+                bandwidthLimiter.OnBytesReceived(bytesRead, [&]() { return stopped.load(); });
+
+            } while (bytesRead != 0);
+
+            THROW_HR_IF(APPINSTALLER_CLI_ERROR_DOWNLOAD_SIZE_MISMATCH, offset != end);
+        }
+
+        // Adds the bytes in [begin, end) of the file to the hash.
+        void HashFileRange(HANDLE file, LONGLONG begin, LONGLONG end, SHA256& hashEngine)
+        {
+            const DWORD bufferSize = 1024 * 1024; // 1MB
+            auto buffer = std::make_unique<BYTE[]>(bufferSize);
+
+            for (LONGLONG offset = begin; offset < end;)
+            {
+                OVERLAPPED overlapped{};
+                overlapped.Offset = static_cast<DWORD>(offset);
+                overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+                DWORD bytesRead = 0;
+                THROW_LAST_ERROR_IF(!ReadFile(file, buffer.get(), static_cast<DWORD>(std::min<LONGLONG>(bufferSize, end - offset)), &bytesRead, &overlapped));
+                THROW_HR_IF(E_UNEXPECTED, bytesRead == 0);
+
+                hashEngine.Add(buffer.get(), bytesRead);
+                offset += bytesRead;
+            }
+        }
+
+        // Downloads the content in concurrent ranges into the file at dest, which must already exist.
+        // Returns false without changing the file if the content should be downloaded as a single stream instead.
+        bool WinINetSegmentedDownload(
+            const std::string& url,
+            const std::filesystem::path& dest,
+            IProgressCallback& progress,
+            bool computeHash,
+            uint32_t segmentCount,
+            std::optional<std::vector<BYTE>>& result)
+        {
+            wil::unique_hinternet session = OpenInternetSession();
+
+            std::optional<RangeSupport> rangeSupport = GetRangeSupport(session.get(), url);
+            if (!rangeSupport || rangeSupport->ContentLength < s_MinimumSegmentedDownloadSize)
+            {
+                return false;
+            }
+
+            const LONGLONG contentLength = rangeSupport->ContentLength;
+            const LONGLONG segmentSize = (contentLength + segmentCount - 1) / segmentCount;
+            AICLI_LOG(Core, Info, << "Downloading " << contentLength << " bytes in " << segmentCount << " segments");
+
+            // The file is opened rather than created so that the mark of the web already applied to it is kept.
+            wil::unique_hfile file{ CreateFileW(dest.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+            THROW_LAST_ERROR_IF(!file);
+
+            const bool background = IsBackgroundDownload();
+            SetDownloadFileIoPriority(file.get(), background);
+
+            LARGE_INTEGER fileSize{};
+            fileSize.QuadPart = contentLength;
+            THROW_LAST_ERROR_IF(!SetFilePointerEx(file.get(), fileSize, nullptr, FILE_BEGIN));
+            THROW_LAST_ERROR_IF(!SetEndOfFile(file.get()));
+
+            std::atomic<LONGLONG> bytesDownloaded = 0;
+            std::atomic_bool stopped = false;
+            std::vector<std::pair<LONGLONG, LONGLONG>> ranges;
+            // The offset that each segment has been written up to.
+            std::vector<LONGLONG> offsets;
+            std::vector<std::future<void>> segments;
+
+            // Stop and wait for the remaining segments on any exit, as they use the session and file.
+            auto stopSegments = wil::scope_exit([&]()
+                {
+                    stopped = true;
+                    for (auto& segment : segments)
+                    {
+                        if (segment.valid())
+                        {
+                            segment.wait();
+                        }
+                    }
+                });
+
+            ThreadGlobals* parentThreadGlobals = ThreadGlobals::GetForCurrentThread();
+            const BandwidthLimiter bandwidthLimiter;
+
+            for (LONGLONG begin = 0; begin < contentLength; begin += segmentSize)
+            {
+                ranges.emplace_back(begin, std::min(contentLength, begin + segmentSize));
+                offsets.emplace_back(begin);
+            }
+
+            // The hash is computed over the segments in order as each one completes, while the later ones are still downloading.
+            SHA256 hashEngine;
+            size_t hashedSegments = 0;
+
+            // Each pass starts the segments that are not complete; a pass ends early when the download is paused, and the
+            // segments then continue from their offsets, so that no connection is held open while paused.
+            while (hashedSegments < ranges.size())
+            {
+                stopped = false;
+                segments.clear();
+                segments.resize(ranges.size());
+
+                for (size_t i = hashedSegments; i < ranges.size(); ++i)
+                {
+                    if (offsets[i] == ranges[i].second)
+                    {
+                        continue;
+                    }
+
+                    std::shared_ptr<ThreadGlobals> threadGlobals;
+                    if (parentThreadGlobals)
+                    {
+                        threadGlobals = std::make_shared<ThreadGlobals>(*parentThreadGlobals, ThreadGlobals::create_sub_thread_globals_t{});
+                    }
+
+                    segments[i] = std::async(std::launch::async, [&, i, threadGlobals]()
+                        {
+                            std::unique_ptr<PreviousThreadGlobals> previousThreadGlobals;
+                            if (threadGlobals)
+                            {
+                                previousThreadGlobals = threadGlobals->SetForCurrentThread();
+                            }
+
+                            BackgroundThreadScope backgroundScope{ background };
+                            DownloadSegment(session.get(), url, rangeSupport->Validator, file.get(), offsets[i], ranges[i].second, bytesDownloaded, stopped, bandwidthLimiter);
+                        });
+                }
+
+                bool paused = false;
+
+                for (size_t i = hashedSegments; i < ranges.size(); ++i)
+                {
+                    if (segments[i].valid())
+                    {
+                        while (segments[i].wait_for(100ms) != std::future_status::ready)
+                        {
+                            progress.OnProgress(bytesDownloaded, contentLength, ProgressType::Bytes);
+
+                            if (progress.IsCancelled())
+                            {
+                                stopped = true;
+                            }
+                            else if (!paused && progress.IsPauseRequested())
+                            {
+                                AICLI_LOG(Core, Info, << "Download paused after " << bytesDownloaded << " bytes.");
+                                paused = true;
+                                stopped = true;
+                            }
+                        }
+
+                        segments[i].get();
+                    }
+
+                    if (progress.IsCancelled())
+                    {
+                        AICLI_LOG(Core, Info, << "Download cancelled.");
+                        result = std::nullopt;
+                        return true;
+                    }
+
+                    if (i == hashedSegments && offsets[i] == ranges[i].second)
+                    {
+                        if (computeHash)
+                        {
+                            HashFileRange(file.get(), ranges[i].first, ranges[i].second, hashEngine);
+                        }
+
+                        ++hashedSegments;
+                    }
+                }
+
+                if (paused)
+                {
+                    progress.WaitWhilePaused();
+
+                    if (progress.IsCancelled())
+                    {
+                        AICLI_LOG(Core, Info, << "Download cancelled while paused.");
+                        result = std::nullopt;
+                        return true;
+                    }
+                }
+            }
+
+            progress.OnProgress(contentLength, contentLength, ProgressType::Bytes);
+
+            result = std::vector<BYTE>{};
+            if (computeHash)
+            {
+                result = hashEngine.Get();
+                AICLI_LOG(Core, Info, << "Download hash: " << SHA256::ConvertToString(result.value()));
+            }
+
+            AICLI_LOG(Core, Info, << "Download completed.");
+            return true;
+        }
+    }
+
+    std::optional<std::vector<BYTE>> WinINetDownloadToStream(
+        const std::string& url,
+        std::ostream& dest,
+        IProgressCallback& progress,
+        bool computeHash,
+        SHA256* hashEngine = nullptr,
+        ResumeState* resumeState = nullptr)
+    {
+        // For AICLI_LOG usages with string literals.
+        #pragma warning(push)
+        #pragma warning(disable:26449)
+
+        AICLI_LOG(Core, Info, << "WinINet downloading from url: " << url);
+
+        BackgroundThreadScope backgroundScope{ IsBackgroundDownload() };
+
+        HINTERNET session = GetSharedInternetSession();
+
+        // Setup hash engine; the caller provides one that already holds the downloaded bytes when continuing a download.
+        SHA256 localHashEngine;
+        if (!hashEngine)
+        {
+            hashEngine = &localHashEngine;
+        }
+
+        ResumeState localResumeState;
+        ResumeState& state = resumeState ? *resumeState : localResumeState;
+
+        // An interrupted download is continued from where it stopped, so that the hash engine never needs to read back the bytes already written.
+        for (int resumeCount = 0; ; ++resumeCount)
+        {
+            try
+            {
+                // Nothing is open between requests, so the download can pause here as well as between chunks.
+                if (progress.IsPauseRequested())
+                {
+                    progress.WaitWhilePaused();
+
+                    if (progress.IsCancelled())
+                    {
+                        AICLI_LOG(Core, Info, << "Download cancelled while paused.");
+                        return {};
+                    }
+                }
+
+                DownloadAttemptResult attempt = WinINetDownloadRemaining(session, url, dest, progress, computeHash ? hashEngine : nullptr, state);
+                if (attempt == DownloadAttemptResult::Cancelled)
+                {
+                    return {};
+                }
+                else if (attempt == DownloadAttemptResult::Paused)
+                {
+                    // A pause is not an interruption, so it does not count against the attempts to continue.
+                    dest.flush();
+                    --resumeCount;
+                    continue;
+                }
+
+                break;
+            }
+            catch (...)
+            {
+                if (resumeCount >= MaxResumeCount || !state.CanResume() || progress.IsCancelled())
+                {
+                    throw;
+                }
+
+                LOG_CAUGHT_EXCEPTION_MSG("Download interrupted after %lld bytes; continuing it", state.BytesDownloaded);
+                Sleep(500 * (resumeCount + 1));
+            }
+        }
+
+        dest.flush();
+
+        // Check download size matches if content length is provided in response header
+        if (state.ContentLength > 0)
+        {
+            THROW_HR_IF(APPINSTALLER_CLI_ERROR_DOWNLOAD_SIZE_MISMATCH, state.BytesDownloaded != state.ContentLength);
+        }
+
+        std::vector<BYTE> result;
+        if (computeHash)
+        {
+            result = hashEngine->Get();
+            AICLI_LOG(Core, Info, << "Download hash: " << SHA256::ConvertToString(result));
+        }
+
+        AICLI_LOG(Core, Info, << "Download completed.");
+
+        #pragma warning(pop)
+
+        return result;
+    }
+
+    std::optional<std::vector<BYTE>> DownloadToFile(
+        const std::string& url,
+        const std::filesystem::path& dest,
+        DownloadType type,
+        IProgressCallback& progress,
+        bool computeHash,
+        std::optional<DownloadInfo> info)
+    {
+        AICLI_LOG(Core, Info, << "Downloading to path: " << dest);
+
+        // Covers the hashing and writing done on this thread, as well as the receiving.
+        BackgroundThreadScope backgroundScope{ IsBackgroundDownload() };
+
+        std::filesystem::create_directories(dest.parent_path());
+
+        // A download that was interrupted in a previous run is continued with WinINet rather than starting over.
+        std::optional<ResumeState> partialDownload = ReadPartialDownloadRecord(dest, url);
+        if (!partialDownload)
+        {
+            RemovePartialDownloadRecord(dest);
+        }
+
+        // Only Installers should be downloaded with DO currently, as:
+        //  - Index :: Constantly changing blob at same location is not what DO is for
+        //  - Manifest :: DO overhead is not needed for small files
+        //  - WinGetUtil :: Intentionally not using DO at this time
+        if (type == DownloadType::Installer && !partialDownload)
+        {
+            // Determine whether to try DO first or not, as this is the only choice currently supported.
+            InstallerDownloader setting = User().Get<Setting::NetworkDownloader>();
+
+            if (setting == InstallerDownloader::Default ||
+                setting == InstallerDownloader::DeliveryOptimization)
+            {
+                try
+                {
+                    auto result = DODownload(url, dest, progress, computeHash, info);
+                    // Since we cannot pre-apply to the file with DO, post-apply the MotW to the file.
+                    // Only do so if the file exists, because cancellation will not throw here.
+                    if (std::filesystem::exists(dest))
+                    {
+                        ApplyMotwIfApplicable(dest, URLZONE_INTERNET);
+                    }
+                    return result;
+                }
+                catch (const wil::ResultException& re)
+                {
+                    // Fall back to WinINet below unless the specific error is not one that should be ignored.
+                    // We need to be careful not to bypass metered networks or other reasons that might
+                    // intentionally cause the download to be blocked.
+                    HRESULT hr = re.GetErrorCode();
+                    if (IsDOErrorFatal(hr))
+                    {
+                        throw;
+                    }
+                    else
+                    {
+                        // Send telemetry so that we can understand the reasons for DO failing
+                        Logging::Telemetry().LogNonFatalDOError(url, hr);
+                    }
+                }
+
+                // If we reach this point, we are intending to fall through to WinINet.
+                // Remove any file that may have been placed in the target location.
+                if (std::filesystem::exists(dest))
+                {
+                    std::filesystem::remove(dest);
+                }
+            }
+        }
+
+        if (type == DownloadType::Installer && !partialDownload)
+        {
+            uint32_t segmentCount = User().Get<Setting::NetworkDownloadSegments>();
+
+            if (segmentCount > 1)
+            {
+                std::ofstream emptyDestFile(dest);
+                emptyDestFile.close();
+                ApplyMotwIfApplicable(dest, URLZONE_INTERNET);
+
+                try
+                {
+                    std::optional<std::vector<BYTE>> result;
+                    if (WinINetSegmentedDownload(url, dest, progress, computeHash, segmentCount, result))
+                    {
+                        return result;
+                    }
+                }
+                catch (...)
+                {
+                    if (progress.IsCancelled())
+                    {
+                        throw;
+                    }
+
+                    // Fall back to a single stream below, which starts over with an empty file.
+                    LOG_CAUGHT_EXCEPTION_MSG("Segmented download failed; downloading as a single stream");
+                }
+            }
+        }
+
+        SHA256 hashEngine;
+        ResumeState state;
+
+        if (partialDownload)
+        {
+            AICLI_LOG(Core, Info, << "Continuing partial download of " << partialDownload->BytesDownloaded << " bytes");
+            state = std::move(partialDownload).value();
+
+            // The hash state cannot be saved between runs, so the bytes already on disk are hashed once here.
+            if (computeHash)
+            {
+                std::ifstream existingFile(dest, std::ifstream::binary);
+                const size_t bufferSize = 1024 * 1024; // 1MB
+                auto buffer = std::make_unique<uint8_t[]>(bufferSize);
+
+                while (existingFile)
+                {
+                    existingFile.read(reinterpret_cast<char*>(buffer.get()), bufferSize);
+                    hashEngine.Add(buffer.get(), static_cast<size_t>(existingFile.gcount()));
+                }
+            }
+        }
+        else
+        {
+            std::ofstream emptyDestFile(dest);
+            emptyDestFile.close();
+            ApplyMotwIfApplicable(dest, URLZONE_INTERNET);
+        }
+
+        // Use std::ofstream::app to append to previous empty file so that it will not
+        // create a new file and clear motw.
+        std::ofstream outfile(dest, std::ofstream::binary | std::ofstream::app);
+
+        // Resizing rather than recreating the file keeps its motw.
+        state.Restart = [&]()
+            {
+                outfile.close();
+                std::filesystem::resize_file(dest, 0);
+                outfile.open(dest, std::ofstream::binary | std::ofstream::app);
+                THROW_HR_IF(E_FAIL, !outfile);
+            };
+
+        try
+        {
+            auto result = WinINetDownloadToStream(url, outfile, progress, computeHash, &hashEngine, &state);
+
+            if (result)
+            {
+                RemovePartialDownloadRecord(dest);
+            }
+            else if (state.CanResume())
+            {
+                WritePartialDownloadRecord(dest, url, state);
+            }
 
-namespace AppInstaller::Utility
-{
-    std::optional<std::vector<BYTE>> WinINetDownloadToStream(
-        const std::string& url,
-        std::ostream& dest,
-        IProgressCallback& progress,
-        bool computeHash)
-    {
-        // For AICLI_LOG usages with string literals.
-        #pragma warning(push)
-        #pragma warning(disable:26449)
+            return result;
+        }
+        catch (...)
+        {
+            outfile.close();
 
-        AICLI_LOG(Core, Info, << "WinINet downloading from url: " << url);
+            if (state.CanResume())
+            {
+                WritePartialDownloadRecord(dest, url, state);
+            }
+            else
+            {
+                RemovePartialDownloadRecord(dest);
+            }
 
-        wil::unique_hinternet session(InternetOpenA(
-            "winget-cli",
-            INTERNET_OPEN_TYPE_PRECONFIG,
-            NULL,
-            NULL,
-            0));
-        THROW_LAST_ERROR_IF_NULL_MSG(session, "InternetOpen() failed.");
+            throw;
+        }
+    }
 
-        wil::unique_hinternet urlFile(InternetOpenUrlA(
-            session.get(),
-            url.c_str(),
-            NULL,
-            0,
-            INTERNET_FLAG_IGNORE_REDIRECT_TO_HTTPS, // This allows http->https redirection
-            0));
-        THROW_LAST_ERROR_IF_NULL_MSG(urlFile, "InternetOpenUrl() failed.");
+    namespace
+    {
+        // A request that arrived while a download of the same content was in progress, and is waiting for its result.
+        struct InFlightDownloadWaiter
+        {
+            // Held while the progress is forwarded, so that the waiter can be sure it is not called once it stops waiting.
+            std::mutex ProgressLock;
+            IProgressSink* Progress = nullptr;
+            // The file to place a copy of the downloaded file in; empty for a download to a stream.
+            std::filesystem::path Destination;
+            // Set once the content has been placed in the destination.
+            bool HasContent = false;
+        };
 
-        // Check http return status
-        DWORD requestStatus = 0;
-        DWORD cbRequestStatus = sizeof(requestStatus);
+        // A download that concurrent requests for the same content share, rather than each downloading it themselves.
+        struct InFlightDownload
+        {
+            std::condition_variable Completed;
+            bool IsComplete = false;
+            std::optional<std::vector<BYTE>> Result;
+            std::exception_ptr Exception;
+            // The content, for a download to a stream.
+            std::string Content;
+            std::vector<std::shared_ptr<InFlightDownloadWaiter>> Waiters;
+        };
 
-        THROW_LAST_ERROR_IF_MSG(!HttpQueryInfoA(urlFile.get(),
-            HTTP_QUERY_STATUS_CODE | HTTP_QUERY_FLAG_NUMBER,
-            &requestStatus,
-            &cbRequestStatus,
-            nullptr), "Query download request status failed.");
+        struct InFlightDownloads
+        {
+            std::mutex Lock;
+            std::map<std::string, std::shared_ptr<InFlightDownload>> Downloads;
+        };
+
+        InFlightDownloads& GetInFlightDownloads()
+        {
+            static InFlightDownloads s_inFlightDownloads;
+            return s_inFlightDownloads;
+        }
 
-        if (requestStatus != HTTP_STATUS_OK)
+        // Requests only share a download when they would have made the same one themselves.
+        std::string GetInFlightDownloadKey(const std::string& url, DownloadType type, bool computeHash, bool toStream)
         {
-            AICLI_LOG(Core, Error, << "Download request failed. Returned status: " << requestStatus);
-            THROW_HR_MSG(MAKE_HRESULT(SEVERITY_ERROR, FACILITY_HTTP, requestStatus), "Download request status is not success.");
+            std::ostringstream stream;
+            stream << static_cast<int>(type) << (computeHash ? "h" : "-") << (toStream ? "s" : "f") << '|' << url;
+            return stream.str();
         }
 
-        AICLI_LOG(Core, Verbose, << "Download request status success.");
+        // Forwards the progress of the download to the requests waiting on it, along with the one making it.
+        struct InFlightDownloadProgress : public IProgressCallback
+        {
+            InFlightDownloadProgress(IProgressCallback& progress, std::mutex& lock, InFlightDownload& download) :
+                m_progress(progress), m_lock(lock), m_download(download) {}
 
-        // Get content length. Don't fail the download if failed.
-        LONGLONG contentLength = 0;
-        DWORD cbContentLength = sizeof(contentLength);
+            void OnProgress(uint64_t current, uint64_t maximum, ProgressType type) override
+            {
+                m_progress.OnProgress(current, maximum, type);
 
-        HttpQueryInfoA(
-            urlFile.get(),
-            HTTP_QUERY_CONTENT_LENGTH | HTTP_QUERY_FLAG_NUMBER64,
-            &contentLength,
-            &cbContentLength,
-            nullptr);
-        AICLI_LOG(Core, Verbose, << "Download size: " << contentLength);
+                // The sinks are called without holding the lock, as one that blocks would otherwise hold up every other download.
+                std::vector<std::shared_ptr<InFlightDownloadWaiter>> waiters;
+                {
+                    std::lock_guard<std::mutex> lock{ m_lock };
+                    waiters = m_download.Waiters;
+                }
 
-        // Setup hash engine
-        SHA256 hashEngine;
+                for (const auto& waiter : waiters)
+                {
+                    std::lock_guard<std::mutex> progressLock{ waiter->ProgressLock };
+                    if (waiter->Progress)
+                    {
+                        waiter->Progress->OnProgress(current, maximum, type);
+                    }
+                }
+            }
 
-        const int bufferSize = 1024 * 1024; // 1MB
-        auto buffer = std::make_unique<BYTE[]>(bufferSize);
+            void BeginProgress() override { m_progress.BeginProgress(); }
 
-        BOOL readSuccess = true;
-        DWORD bytesRead = 0;
-        LONGLONG bytesDownloaded = 0;
+            void EndProgress(bool hideProgressWhenDone) override { m_progress.EndProgress(hideProgressWhenDone); }
 
-        do
-        {
-            if (progress.IsCancelled())
+            bool IsPauseRequested() override { return m_progress.IsPauseRequested(); }
+
+            void WaitWhilePaused() override { m_progress.WaitWhilePaused(); }
+
+            bool IsCancelled() override { return m_progress.IsCancelled(); }
+
+            [[nodiscard]] CancelFunctionRemoval SetCancellationFunction(std::function<void()>&& f) override
             {
-                AICLI_LOG(Core, Info, << "Download cancelled.");
-                return {};
+                return m_progress.SetCancellationFunction(std::move(f));
             }
 
-            readSuccess = InternetReadFile(urlFile.get(), buffer.get(), bufferSize, &bytesRead);
+        private:
+            IProgressCallback& m_progress;
+            std::mutex& m_lock;
+            InFlightDownload& m_download;
+        };
 
-            THROW_LAST_ERROR_IF_MSG(!readSuccess, "InternetReadFile() failed.");
+        // Writes to another stream buffer, keeping a copy of everything written.
+        struct CapturingStreamBuffer : public std::streambuf
+        {
+            CapturingStreamBuffer(std::streambuf* target, std::string& capture) : m_target(target), m_capture(capture) {}
 
-            if (computeHash)
+        protected:
+            int_type overflow(int_type c) override
             {
-                hashEngine.Add(buffer.get(), bytesRead);
+                if (traits_type::eq_int_type(c, traits_type::eof()))
+                {
+                    return traits_type::not_eof(c);
+                }
+
+                m_capture.push_back(traits_type::to_char_type(c));
+                return m_target->sputc(traits_type::to_char_type(c));
             }
 
-            dest.write((char*)buffer.get(), bytesRead);
+            std::streamsize xsputn(const char* s, std::streamsize count) override
+            {
+                m_capture.append(s, static_cast<size_t>(count));
+                return m_target->sputn(s, count);
+            }
+
+            int sync() override
+            {
+                return m_target->pubsync();
+            }
+
+        private:
+            std::streambuf* m_target;
+            std::string& m_capture;
+        };
 
-            bytesDownloaded += bytesRead;
+        // Appends everything written to a string.
+        struct StringStreamBuffer : public std::streambuf
+        {
+            StringStreamBuffer(std::string& target) : m_target(target) {}
 
-            if (bytesRead != 0)
+        protected:
+            int_type overflow(int_type c) override
             {
-                progress.OnProgress(bytesDownloaded, contentLength, ProgressType::Bytes);
+                if (!traits_type::eq_int_type(c, traits_type::eof()))
+                {
+                    m_target.push_back(traits_type::to_char_type(c));
+                }
+
+                return traits_type::not_eof(c);
             }
 
-        } while (bytesRead != 0);
+            std::streamsize xsputn(const char* s, std::streamsize count) override
+            {
+                m_target.append(s, static_cast<size_t>(count));
+                return count;
+            }
 
-        dest.flush();
+        private:
+            std::string& m_target;
+        };
 
-        // Check download size matches if content length is provided in response header
-        if (contentLength > 0)
+        // Copies the downloaded file for a waiting request; the copy keeps the mark of the web of the original.
+        bool CopyDownloadedFile(const std::filesystem::path& source, const std::filesystem::path& dest)
         {
-            THROW_HR_IF(APPINSTALLER_CLI_ERROR_DOWNLOAD_SIZE_MISMATCH, bytesDownloaded != contentLength);
+            if (source == dest)
+            {
+                return true;
+            }
+
+            std::error_code error;
+            std::filesystem::create_directories(dest.parent_path(), error);
+
+            if (!CopyFileW(source.c_str(), dest.c_str(), FALSE))
+            {
+                LOG_LAST_ERROR_MSG("Failed to copy shared download to %ls", dest.c_str());
+                return false;
+            }
+
+            RemovePartialDownloadRecord(dest);
+            return true;
         }
 
-        std::vector<BYTE> result;
-        if (computeHash)
+        // Makes the download for the given key, or waits for the one in progress and takes its result.
+        //   download: Makes the download, reporting its progress to the given callback.
+        //   share: Called for each waiting request before the download is complete, with the file it wants the content in.
+        //   take: Called by a waiting request to take the content from the completed download.
+        std::optional<std::vector<BYTE>> DownloadOnce(
+            const std::string& key,
+            IProgressCallback& progress,
+            const std::filesystem::path& destination,
+            const std::function<std::optional<std::vector<BYTE>>(InFlightDownload&, IProgressCallback&)>& download,
+            const std::function<bool(InFlightDownload&, const std::filesystem::path&)>& share,
+            const std::function<void(InFlightDownload&)>& take)
         {
-            result = hashEngine.Get();
-            AICLI_LOG(Core, Info, << "Download hash: " << SHA256::ConvertToString(result));
-        }
+            InFlightDownloads& inFlightDownloads = GetInFlightDownloads();
 
-        AICLI_LOG(Core, Info, << "Download completed.");
+            for (;;)
+            {
+                std::unique_lock<std::mutex> lock{ inFlightDownloads.Lock };
 
-        #pragma warning(pop)
+                auto itr = inFlightDownloads.Downloads.find(key);
+                if (itr != inFlightDownloads.Downloads.end())
+                {
+                    std::shared_ptr<InFlightDownload> inFlight = itr->second;
+                    auto waiter = std::make_shared<InFlightDownloadWaiter>();
+                    waiter->Progress = &progress;
+                    waiter->Destination = destination;
+                    inFlight->Waiters.emplace_back(waiter);
 
-        return result;
+                    AICLI_LOG(Core, Info, << "Waiting for the download of the same content already in progress");
+
+                    while (!inFlight->IsComplete && !progress.IsCancelled())
+                    {
+                        inFlight->Completed.wait_for(lock, 100ms);
+                    }
+
+                    auto& waiters = inFlight->Waiters;
+                    waiters.erase(std::remove(waiters.begin(), waiters.end(), waiter), waiters.end());
+
+                    // Once complete, the result of the download no longer changes, so it can be read without the lock.
+                    bool isComplete = inFlight->IsComplete;
+                    lock.unlock();
+
+                    {
+                        // The progress may still be forwarded from a copy of the waiters taken before it was removed.
+                        std::lock_guard<std::mutex> progressLock{ waiter->ProgressLock };
+                        waiter->Progress = nullptr;
+                    }
+
+                    if (!isComplete)
+                    {
+                        AICLI_LOG(Core, Info, << "Download cancelled while waiting");
+                        return {};
+                    }
+
+                    if (inFlight->Exception)
+                    {
+                        std::rethrow_exception(inFlight->Exception);
+                    }
+
+                    if (inFlight->Result && waiter->HasContent)
+                    {
+                        take(*inFlight);
+                        return inFlight->Result;
+                    }
+
+                    // The download was cancelled by the one making it, or its content could not be shared; make our own.
+                    continue;
+                }
+
+                auto inFlight = std::make_shared<InFlightDownload>();
+                inFlightDownloads.Downloads.emplace(key, inFlight);
+                lock.unlock();
+
+                std::optional<std::vector<BYTE>> result;
+                std::exception_ptr exception;
+
+                try
+                {
+                    InFlightDownloadProgress sharedProgress{ progress, inFlightDownloads.Lock, *inFlight };
+                    result = download(*inFlight, sharedProgress);
+                }
+                catch (...)
+                {
+                    exception = std::current_exception();
+                }
+
+                // No more requests can wait on the download once it is removed, so the content is shared with the ones that are.
+                std::vector<std::shared_ptr<InFlightDownloadWaiter>> waiters;
+                lock.lock();
+                inFlightDownloads.Downloads.erase(key);
+                waiters = inFlight->Waiters;
+                lock.unlock();
+
+                if (result)
+                {
+                    for (const auto& waiter : waiters)
+                    {
+                        waiter->HasContent = waiter->Destination.empty() || share(*inFlight, waiter->Destination);
+                    }
+                }
+
+                lock.lock();
+                inFlight->Result = result;
+                // A cancellation of this request's download is not shared, as the waiting requests were not cancelled.
+                inFlight->Exception = (exception && !progress.IsCancelled()) ? exception : nullptr;
+                inFlight->IsComplete = true;
+                lock.unlock();
+                inFlight->Completed.notify_all();
+
+                if (exception)
+                {
+                    std::rethrow_exception(exception);
+                }
+
+                return result;
+            }
+        }
     }
 
     std::optional<std::vector<BYTE>> DownloadToStream(
         const std::string& url,
         std::ostream& dest,
-        DownloadType,
+        DownloadType type,
+        IProgressCallback& progress,
+        bool computeHash,
+        std::optional<DownloadInfo>)
+    {
+        THROW_HR_IF(E_INVALIDARG, url.empty());
+
+        // Installers are not held in memory to be shared, as they can be large.
+        if (type == DownloadType::Installer)
+        {
+            auto start = dest.tellp();
+            auto result = WinINetDownloadToStream(url, dest, progress, computeHash);
+
+            auto end = dest.tellp();
+            if (result && start != std::ostream::pos_type{ -1 } && end != std::ostream::pos_type{ -1 })
+            {
+                RecordDownload(type, static_cast<uint64_t>(end - start));
+            }
+
+            return result;
+        }
+
+        return DownloadOnce(GetInFlightDownloadKey(url, type, computeHash, true), progress, {},
+            [&](InFlightDownload& inFlight, IProgressCallback& sharedProgress)
+            {
+                CapturingStreamBuffer capture{ dest.rdbuf(), inFlight.Content };
+                std::ostream captureStream{ &capture };
+                auto result = WinINetDownloadToStream(url, captureStream, sharedProgress, computeHash);
+                dest.flush();
+
+                if (result)
+                {
+                    RecordDownload(type, inFlight.Content.size());
+                }
+
+                return result;
+            },
+            [](InFlightDownload&, const std::filesystem::path&) { return true; },
+            [&](InFlightDownload& inFlight)
+            {
+                dest.write(inFlight.Content.data(), static_cast<std::streamsize>(inFlight.Content.size()));
+                dest.flush();
+            });
+    }
+
+    std::optional<std::vector<BYTE>> DownloadToString(
+        const std::string& url,
+        std::string& dest,
+        DownloadType type,
         IProgressCallback& progress,
         bool computeHash,
         std::optional<DownloadInfo>)
     {
         THROW_HR_IF(E_INVALIDARG, url.empty());
-        return WinINetDownloadToStream(url, dest, progress, computeHash);
+
+        // Shares the downloads made to a stream, as the content held for them is the same.
+        return DownloadOnce(GetInFlightDownloadKey(url, type, computeHash, true), progress, {},
+            [&](InFlightDownload& inFlight, IProgressCallback& sharedProgress)
+            {
+                // The received data is written straight into the shared content, rather than through another stream.
+                StringStreamBuffer buffer{ inFlight.Content };
+                std::ostream stream{ &buffer };
+                auto result = WinINetDownloadToStream(url, stream, sharedProgress, computeHash);
+
+                if (result)
+                {
+                    RecordDownload(type, inFlight.Content.size());
+                    dest = inFlight.Content;
+                }
+
+                return result;
+            },
+            [](InFlightDownload&, const std::filesystem::path&) { return true; },
+            [&](InFlightDownload& inFlight)
+            {
+                dest = inFlight.Content;
+            });
     }
 
     std::optional<std::vector<BYTE>> Download(
@@ -157,69 +1640,89 @@ namespace AppInstaller::Utility
         std::optional<DownloadInfo> info)
     {
         THROW_HR_IF(E_INVALIDARG, url.empty());
-        THROW_HR_IF(E_INVALIDARG, dest.empty());
-
-        AICLI_LOG(Core, Info, << "Downloading to path: " << dest);
-
-        std::filesystem::create_directories(dest.parent_path());
 
-        // Only Installers should be downloaded with DO currently, as:
-        //  - Index :: Constantly changing blob at same location is not what DO is for
-        //  - Manifest :: DO overhead is not needed for small files
-        //  - WinGetUtil :: Intentionally not using DO at this time
-        if (type == DownloadType::Installer)
-        {
-            // Determine whether to try DO first or not, as this is the only choice currently supported.
-            InstallerDownloader setting = User().Get<Setting::NetworkDownloader>();
+        Timing::Span span{ Timing::Phase::Download };
+        THROW_HR_IF(E_INVALIDARG, dest.empty());
 
-            if (setting == InstallerDownloader::Default ||
-                setting == InstallerDownloader::DeliveryOptimization)
+        return DownloadOnce(GetInFlightDownloadKey(url, type, computeHash, false), progress, dest,
+            [&](InFlightDownload&, IProgressCallback& sharedProgress)
             {
-                try
-                {
-                    auto result = DODownload(url, dest, progress, computeHash, info);
-                    // Since we cannot pre-apply to the file with DO, post-apply the MotW to the file.
-                    // Only do so if the file exists, because cancellation will not throw here.
-                    if (std::filesystem::exists(dest))
-                    {
-                        ApplyMotwIfApplicable(dest, URLZONE_INTERNET);
-                    }
-                    return result;
-                }
-                catch (const wil::ResultException& re)
+                auto result = DownloadToFile(url, dest, type, sharedProgress, computeHash, info);
+
+                if (result && Timing::IsUsageEnabled())
                 {
-                    // Fall back to WinINet below unless the specific error is not one that should be ignored.
-                    // We need to be careful not to bypass metered networks or other reasons that might
-                    // intentionally cause the download to be blocked.
-                    HRESULT hr = re.GetErrorCode();
-                    if (IsDOErrorFatal(hr))
-                    {
-                        throw;
-                    }
-                    else
+                    std::error_code error;
+                    uint64_t size = std::filesystem::file_size(dest, error);
+                    if (!error)
                     {
-                        // Send telemetry so that we can understand the reasons for DO failing
-                        Logging::Telemetry().LogNonFatalDOError(url, hr);
+                        RecordDownload(type, size);
                     }
                 }
 
-                // If we reach this point, we are intending to fall through to WinINet.
-                // Remove any file that may have been placed in the target location.
-                if (std::filesystem::exists(dest))
-                {
-                    std::filesystem::remove(dest);
-                }
-            }
-        }
+                return result;
+            },
+            [&](InFlightDownload&, const std::filesystem::path& waiterDest)
+            {
+                return CopyDownloadedFile(dest, waiterDest);
+            },
+            [](InFlightDownload&) {});
+    }
 
-        std::ofstream emptyDestFile(dest);
-        emptyDestFile.close();
-        ApplyMotwIfApplicable(dest, URLZONE_INTERNET);
+    namespace
+    {
+        std::atomic<uint64_t> s_bytesReceived = 0;
+    }
 
-        // Use std::ofstream::app to append to previous empty file so that it will not
-        // create a new file and clear motw.
-        std::ofstream outfile(dest, std::ofstream::binary | std::ofstream::app);
-        return WinINetDownloadToStream(url, outfile, progress, computeHash);
+    uint64_t GetBytesReceived()
+    {
+        return s_bytesReceived.load();
+    }
+
+    void AddBytesReceived(uint64_t count)
+    {
+        s_bytesReceived += count;
+    }
+
+    bool HasPartialDownload(const std::filesystem::path& dest)
+    {
+        return std::filesystem::exists(GetPartialDownloadRecordPath(dest));
+    }
+
+    std::string GetContentValidator(const std::string& url)
+    {
+        AICLI_LOG(Core, Verbose, << "Getting content validator for " << url);
+
+        // Only the first byte is requested, so that a server that ignores HEAD semantics still sends almost nothing.
+        static constexpr std::string_view s_rangeHeader = "Range: bytes=0-0\r\n";
+
+        RecordHttpRequest(url);
+        wil::unique_hinternet urlFile(InternetOpenUrlA(
+            GetSharedInternetSession(),
+            url.c_str(),
+            s_rangeHeader.data(),
+            static_cast<DWORD>(s_rangeHeader.size()),
+            INTERNET_FLAG_IGNORE_REDIRECT_TO_HTTPS, // This allows http->https redirection
+            0));
+        THROW_LAST_ERROR_IF_NULL_MSG(urlFile, "InternetOpenUrl() failed.");
+
+        DWORD requestStatus = 0;
+        DWORD cbRequestStatus = sizeof(requestStatus);
+
+        THROW_LAST_ERROR_IF_MSG(!HttpQueryInfoA(urlFile.get(),
+            HTTP_QUERY_STATUS_CODE | HTTP_QUERY_FLAG_NUMBER,
+            &requestStatus,
+            &cbRequestStatus,
+            nullptr), "Query request status failed.");
+
+        if (requestStatus != HTTP_STATUS_OK && requestStatus != HTTP_STATUS_PARTIAL_CONTENT)
+        {
+            AICLI_LOG(Core, Info, << "Content validator request failed. Returned status: " << requestStatus);
+            return {};
+        }
+
+        std::string result = GetValidator(urlFile.get());
+        AICLI_LOG(Core, Verbose, << "Content validator: " << result);
+        return result;
     }
 
     using namespace std::string_view_literals;
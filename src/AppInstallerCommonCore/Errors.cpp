@@ -160,6 +160,12 @@ namespace AppInstaller
                 return "Header size exceeds the allowable limit of 1024 characters. Please reduce the size and try again.";
             case APPINSTALLER_CLI_ERROR_MSI_INSTALL_FAILED:
                 return "Running MSI install failed";
+            case APPINSTALLER_CLI_ERROR_SOURCE_SEARCH_TIMEOUT:
+                return "The source did not complete the search in the allowed time";
+            case APPINSTALLER_CLI_ERROR_MULTIPLE_UNINSTALL_FAILED:
+                return "Uninstalling multiple packages completed with failures";
+            case APPINSTALLER_CLI_ERROR_YAML_LIMIT_EXCEEDED:
+                return "The YAML document exceeds the limits for loading it";
             case APPINSTALLER_CLI_ERROR_INSTALL_PACKAGE_IN_USE:
                 return "Application is currently running.Exit the application then try again.";
             case APPINSTALLER_CLI_ERROR_INSTALL_INSTALL_IN_PROGRESS:
@@ -42,6 +42,12 @@ namespace AppInstaller::Settings
                 return userSettings.Get<Setting::EFDependencies>();
             case ExperimentalFeature::Feature::DirectMSI:
                 return userSettings.Get<Setting::EFDirectMSI>();
+            case ExperimentalFeature::Feature::StreamingMsix:
+                return userSettings.Get<Setting::EFStreamingMsix>();
+            case ExperimentalFeature::Feature::ExtractSourceUpdates:
+                return userSettings.Get<Setting::EFExtractSourceUpdates>();
+            case ExperimentalFeature::Feature::CacheCommand:
+                return userSettings.Get<Setting::EFCacheCommand>();
             default:
                 THROW_HR(E_UNEXPECTED);
             }
@@ -73,6 +79,12 @@ namespace AppInstaller::Settings
             return ExperimentalFeature{ "Show Dependencies Information", "dependencies", "https://aka.ms/winget-settings", Feature::Dependencies };
         case Feature::DirectMSI:
             return ExperimentalFeature{ "Direct MSI Installation", "directMSI", "https://aka.ms/winget-settings", Feature::DirectMSI };
+        case Feature::StreamingMsix:
+            return ExperimentalFeature{ "Streaming MSIX Installation", "streamingMsix", "https://aka.ms/winget-settings", Feature::StreamingMsix };
+        case Feature::ExtractSourceUpdates:
+            return ExperimentalFeature{ "Extract Source Updates", "extractSourceUpdates", "https://aka.ms/winget-settings", Feature::ExtractSourceUpdates };
+        case Feature::CacheCommand:
+            return ExperimentalFeature{ "Cache Command", "cacheCommand", "https://aka.ms/winget-settings", Feature::CacheCommand };
         default:
             THROW_HR(E_UNEXPECTED);
         }
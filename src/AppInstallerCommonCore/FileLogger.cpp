@@ -16,6 +16,279 @@ namespace AppInstaller::Logging
     static constexpr std::string_view s_fileLoggerDefaultFilePrefix = "WinGet"sv;
     static constexpr std::string_view s_fileLoggerDefaultFileExt = ".log"sv;
 
+    // The longest that destroying a logger waits for its remaining records to be written.
+    static constexpr std::chrono::milliseconds s_fileLoggerStopTimeout = 1s;
+
+    // Log files older than this are removed by the cleanup.
+    static constexpr auto s_fileLoggerCleanupAge = 7 * 24h;
+    // The cleanup runs at most once in this interval, across all processes using the log location.
+    static constexpr auto s_fileLoggerCleanupInterval = 24h;
+    // The file whose last write time records when the cleanup last ran.
+    static constexpr std::wstring_view s_fileLoggerCleanupMarker = L"WinGet-cleanup.marker"sv;
+
+    namespace
+    {
+        // Claims the cleanup of the log location for this process if it has not run within the interval.
+        bool TryClaimCleanup(const std::filesystem::path& filePath)
+        {
+            std::filesystem::path markerPath = filePath / s_fileLoggerCleanupMarker;
+
+            // Not sharing the marker serializes the processes that start at the same time; only one of them sees it as stale.
+            wil::unique_hfile marker{ CreateFileW(markerPath.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) };
+            if (!marker)
+            {
+                return false;
+            }
+
+            bool existed = (GetLastError() == ERROR_ALREADY_EXISTS);
+
+            FILETIME now{};
+            GetSystemTimeAsFileTime(&now);
+
+            if (existed)
+            {
+                FILETIME lastWrite{};
+                if (GetFileTime(marker.get(), nullptr, nullptr, &lastWrite))
+                {
+                    auto elapsed = std::chrono::duration<int64_t, std::ratio<1, 10'000'000>>{
+                        static_cast<int64_t>(ULARGE_INTEGER{ now.dwLowDateTime, now.dwHighDateTime }.QuadPart - ULARGE_INTEGER{ lastWrite.dwLowDateTime, lastWrite.dwHighDateTime }.QuadPart) };
+
+                    if (elapsed >= 0s && elapsed < s_fileLoggerCleanupInterval)
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            return SetFileTime(marker.get(), nullptr, nullptr, &now) != FALSE;
+        }
+    }
+
+    // Writes the records of a file logger to its file on a background thread.
+    // Records are passed through a bounded ring buffer that any number of threads can add to without taking a lock,
+    // and which only the background thread removes from. Each slot holds the position that it is next valid for:
+    // a writer may fill a slot when its sequence equals the position being added, and the background thread may
+    // write it out when its sequence is one past the position being removed.
+    // The state is shared with the background thread, so that it stays valid if the thread outlives the logger.
+    struct FileLogger::Writer : public std::enable_shared_from_this<Writer>
+    {
+        // Must be a power of 2.
+        static constexpr size_t Capacity = 1024;
+
+        Writer(const std::filesystem::path& filePath) :
+            m_slots(std::make_unique<Slot[]>(Capacity)), m_wake(wil::EventOptions::None), m_stopped(wil::EventOptions::ManualReset)
+        {
+            for (size_t i = 0; i < Capacity; ++i)
+            {
+                m_slots[i].Sequence.store(i, std::memory_order_relaxed);
+            }
+
+            m_stream.open(filePath);
+        }
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        static std::shared_ptr<Writer> Create(const std::filesystem::path& filePath)
+        {
+            auto result = std::make_shared<Writer>(filePath);
+
+            std::thread([writer = result]() { writer->Run(); }).detach();
+
+            std::lock_guard<std::mutex> lock{ s_writersLock };
+            s_writers.emplace_back(result);
+
+            return result;
+        }
+
+        // Gets the writers that have not been stopped, or nothing if the list is in use by another thread.
+        static std::vector<std::shared_ptr<Writer>> GetAll() noexcept try
+        {
+            std::vector<std::shared_ptr<Writer>> result;
+
+            std::unique_lock<std::mutex> lock{ s_writersLock, std::try_to_lock };
+            if (lock)
+            {
+                for (const auto& writer : s_writers)
+                {
+                    if (auto strong = writer.lock())
+                    {
+                        result.emplace_back(std::move(strong));
+                    }
+                }
+            }
+
+            return result;
+        }
+        catch (...)
+        {
+            return {};
+        }
+
+        // Adds a record to be written, waiting for room if the buffer is full.
+        void Add(std::string_view record)
+        {
+            size_t position = m_addPosition.load(std::memory_order_relaxed);
+
+            for (;;)
+            {
+                Slot& slot = m_slots[position & (Capacity - 1)];
+                size_t sequence = slot.Sequence.load(std::memory_order_acquire);
+                auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+
+                if (difference == 0)
+                {
+                    if (m_addPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        // Assigning reuses the memory of the previous record in the slot.
+                        slot.Record.assign(record);
+                        slot.Sequence.store(position + 1, std::memory_order_release);
+                        break;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    // The buffer is full; let the background thread make room.
+                    Wake(true);
+                    std::this_thread::yield();
+                    position = m_addPosition.load(std::memory_order_relaxed);
+                }
+                else
+                {
+                    // Another thread took this position.
+                    position = m_addPosition.load(std::memory_order_relaxed);
+                }
+            }
+
+            Wake(false);
+        }
+
+        // Waits for the records added so far to be written, for at most the given time.
+        void Flush(std::chrono::milliseconds timeout)
+        {
+            size_t target = m_addPosition.load(std::memory_order_acquire);
+            auto end = std::chrono::steady_clock::now() + timeout;
+
+            while (m_writtenPosition.load(std::memory_order_acquire) < target &&
+                WaitForSingleObject(m_stopped.get(), 0) != WAIT_OBJECT_0 &&
+                std::chrono::steady_clock::now() < end)
+            {
+                Wake(true);
+                Sleep(1);
+            }
+        }
+
+        // Stops the background thread after it writes the remaining records, waiting for it for at most the given time.
+        void Stop(std::chrono::milliseconds timeout)
+        {
+            {
+                std::lock_guard<std::mutex> lock{ s_writersLock };
+                s_writers.erase(std::remove_if(s_writers.begin(), s_writers.end(),
+                    [this](const std::weak_ptr<Writer>& writer) { auto strong = writer.lock(); return !strong || strong.get() == this; }),
+                    s_writers.end());
+            }
+
+            m_stopping.store(true);
+            Wake(true);
+            WaitForSingleObject(m_stopped.get(), static_cast<DWORD>(timeout.count()));
+        }
+
+    private:
+        struct Slot
+        {
+            std::atomic<size_t> Sequence;
+            std::string Record;
+        };
+
+        // Wakes the background thread if it is waiting for records, or regardless if forced.
+        void Wake(bool force)
+        {
+            // Pairs with the fence in Run, so that either the background thread sees the new record or it is seen to be waiting.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (m_waiting.exchange(false) || force)
+            {
+                m_wake.SetEvent();
+            }
+        }
+
+        bool HasRecord() const
+        {
+            return m_slots[m_writePosition & (Capacity - 1)].Sequence.load(std::memory_order_acquire) == m_writePosition + 1;
+        }
+
+        // Writes the records available in the buffer, and flushes the file once for all of them.
+        void WriteRecords() noexcept try
+        {
+            bool wroteRecord = false;
+
+            while (HasRecord())
+            {
+                Slot& slot = m_slots[m_writePosition & (Capacity - 1)];
+                m_stream << slot.Record << '\n';
+                slot.Sequence.store(m_writePosition + Capacity, std::memory_order_release);
+
+                ++m_writePosition;
+                wroteRecord = true;
+            }
+
+            if (wroteRecord)
+            {
+                m_stream.flush();
+                m_writtenPosition.store(m_writePosition, std::memory_order_release);
+            }
+        }
+        catch (...)
+        {
+            // Just eat any exceptions here; better than losing logs
+        }
+
+        void Run()
+        {
+            auto setStopped = wil::scope_exit([this]() { m_stopped.SetEvent(); });
+
+            for (;;)
+            {
+                WriteRecords();
+
+                if (m_stopping.load())
+                {
+                    // Records added before stopping are written before the thread exits.
+                    WriteRecords();
+                    return;
+                }
+
+                m_waiting.store(true);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                if (!HasRecord() && !m_stopping.load())
+                {
+                    m_wake.wait();
+                }
+
+                m_waiting.store(false);
+            }
+        }
+
+        std::unique_ptr<Slot[]> m_slots;
+        std::atomic<size_t> m_addPosition = 0;
+        std::atomic<size_t> m_writtenPosition = 0;
+        std::atomic_bool m_waiting = false;
+        std::atomic_bool m_stopping = false;
+        wil::unique_event m_wake;
+        wil::unique_event m_stopped;
+
+        // Only used by the background thread.
+        size_t m_writePosition = 0;
+        std::ofstream m_stream;
+
+        static std::mutex s_writersLock;
+        static std::vector<std::weak_ptr<Writer>> s_writers;
+    };
+
+    std::mutex FileLogger::Writer::s_writersLock;
+    std::vector<std::weak_ptr<FileLogger::Writer>> FileLogger::Writer::s_writers;
+
     FileLogger::FileLogger() : FileLogger(s_fileLoggerDefaultFilePrefix) {}
 
     FileLogger::FileLogger(const std::filesystem::path& filePath)
@@ -23,7 +296,7 @@ namespace AppInstaller::Logging
         m_name = GetNameForPath(filePath);
         m_filePath = filePath;
 
-        m_stream.open(m_filePath);
+        m_writer = Writer::Create(m_filePath);
     }
 
     FileLogger::FileLogger(const std::string_view fileNamePrefix)
@@ -32,12 +305,15 @@ namespace AppInstaller::Logging
         m_filePath = Runtime::GetPathTo(Runtime::PathName::DefaultLogLocation);
         m_filePath /= fileNamePrefix.data() + ('-' + Utility::GetCurrentTimeForFilename() + s_fileLoggerDefaultFileExt.data());
 
-        m_stream.open(m_filePath);
+        m_writer = Writer::Create(m_filePath);
     }
 
     FileLogger::~FileLogger()
     {
-        m_stream.flush();
+        if (m_writer)
+        {
+            m_writer->Stop(s_fileLoggerStopTimeout);
+        }
     }
 
     std::string FileLogger::GetNameForPath(const std::filesystem::path& filePath)
@@ -56,6 +332,11 @@ namespace AppInstaller::Logging
         return s_fileLoggerDefaultFileExt;
     }
 
+    const std::filesystem::path& FileLogger::GetFilePath() const
+    {
+        return m_filePath;
+    }
+
     std::string FileLogger::GetName() const
     {
         return m_name;
@@ -66,7 +347,7 @@ namespace AppInstaller::Logging
         // Send to a string first to create a single block to write to a file.
         std::stringstream strstr;
         strstr << std::chrono::system_clock::now() << " [" << std::setw(GetMaxChannelNameLength()) << std::left << std::setfill(' ') << GetChannelName(channel) << "] " << message;
-        m_stream << strstr.str() << std::endl;
+        m_writer->Add(strstr.str());
     }
     catch (...)
     {
@@ -75,7 +356,7 @@ namespace AppInstaller::Logging
 
     void FileLogger::WriteDirect(std::string_view message) noexcept try
     {
-        m_stream << message << std::endl;
+        m_writer->Add(message);
     }
     catch (...)
     {
@@ -88,13 +369,22 @@ namespace AppInstaller::Logging
             {
                 try
                 {
+                    // Walking a location with many logs is not worth doing on every start.
+                    if (!TryClaimCleanup(filePath))
+                    {
+                        return;
+                    }
+
+                    // Keep the I/O of the cleanup from competing with the command being run.
+                    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+
                     auto now = std::filesystem::file_time_type::clock::now();
 
                     // Remove all files that are older than 7 days from the standard log location.
                     for (auto& file : std::filesystem::directory_iterator{ filePath })
                     {
                         if (file.is_regular_file() &&
-                            now - file.last_write_time() > (7 * 24h))
+                            now - file.last_write_time() > s_fileLoggerCleanupAge)
                         {
                             std::filesystem::remove(file.path());
                         }
@@ -104,4 +394,16 @@ namespace AppInstaller::Logging
                 catch (...) {}
             }).detach();
     }
+
+    void FileLogger::FlushAll(std::chrono::milliseconds timeout) noexcept try
+    {
+        for (const auto& writer : Writer::GetAll())
+        {
+            writer->Flush(timeout);
+        }
+    }
+    catch (...)
+    {
+        // Just eat any exceptions here; better than losing logs
+    }
 }
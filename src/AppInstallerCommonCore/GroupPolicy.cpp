@@ -10,9 +10,89 @@ namespace AppInstaller::Settings
 {
     namespace
     {
+        constexpr std::string_view s_PoliciesKeyPath = "Software\\Policies\\Microsoft\\Windows\\AppInstaller"sv;
+
+        // Changes anywhere under this key are watched, as the policies key itself may not exist yet.
+        constexpr std::wstring_view s_WatchedKeyPath = L"Software\\Policies"sv;
+
+        // Holds the policies as read from the registry, and reads them again when the registry changes.
+        // Each snapshot is immutable, so reading the current one is a single atomic load. Replaced snapshots
+        // are kept, as callers may still hold references into them; policy changes are rare enough for this.
+        struct GroupPolicySnapshots
+        {
+            GroupPolicySnapshots()
+            {
+                // Start watching before the first read so that a change in between is not missed.
+                StartWatching();
+                Refresh();
+            }
+
+            const GroupPolicy& Current() const
+            {
+                return *m_current.load(std::memory_order_acquire);
+            }
+
+        private:
+            void StartWatching() try
+            {
+                HKEY watchedKey = nullptr;
+                THROW_IF_WIN32_ERROR(RegOpenKeyExW(HKEY_LOCAL_MACHINE, s_WatchedKeyPath.data(), 0, KEY_NOTIFY, &watchedKey));
+                m_watchedKey.reset(watchedKey);
+
+                m_changed.create(wil::EventOptions::None);
+                m_wait.reset(CreateThreadpoolWait(&GroupPolicySnapshots::OnChanged, this, nullptr));
+                THROW_LAST_ERROR_IF_NULL(m_wait.get());
+
+                ArmWatch();
+            }
+            catch (...)
+            {
+                // Without the watch, the policies read at startup are used for the life of the process.
+                LOG_CAUGHT_EXCEPTION_MSG("Failed to watch for group policy changes");
+                m_wait.reset();
+            }
+
+            void ArmWatch()
+            {
+                THROW_IF_WIN32_ERROR(RegNotifyChangeKeyValue(m_watchedKey.get(), TRUE,
+                    REG_NOTIFY_CHANGE_NAME | REG_NOTIFY_CHANGE_LAST_SET | REG_NOTIFY_THREAD_AGNOSTIC, m_changed.get(), TRUE));
+                SetThreadpoolWait(m_wait.get(), m_changed.get(), nullptr);
+            }
+
+            static void CALLBACK OnChanged(PTP_CALLBACK_INSTANCE, PVOID context, PTP_WAIT, TP_WAIT_RESULT) try
+            {
+                auto snapshots = static_cast<GroupPolicySnapshots*>(context);
+
+                // Rearm first so that a change made while reading is not missed.
+                snapshots->ArmWatch();
+
+                AICLI_LOG(Core, Info, << "Group policy changed; reading it again");
+                snapshots->Refresh();
+            }
+            CATCH_LOG();
+
+            void Refresh()
+            {
+                auto snapshot = std::make_unique<GroupPolicy>(Registry::Key::OpenIfExists(HKEY_LOCAL_MACHINE, s_PoliciesKeyPath));
+
+                std::lock_guard<std::mutex> lock{ m_snapshotsLock };
+                m_current.store(snapshot.get(), std::memory_order_release);
+                m_snapshots.emplace_back(std::move(snapshot));
+            }
+
+            std::atomic<const GroupPolicy*> m_current = nullptr;
+            std::mutex m_snapshotsLock;
+            std::vector<std::unique_ptr<GroupPolicy>> m_snapshots;
+
+            wil::unique_hkey m_watchedKey;
+            wil::unique_event m_changed;
+            // Declared last so that it is the first destroyed, which waits for any running callback.
+            wil::unique_threadpool_wait m_wait;
+        };
+
         const GroupPolicy& InstanceInternal(std::optional<GroupPolicy*> overridePolicy = {})
         {
-            const static GroupPolicy s_groupPolicy{ Registry::Key::OpenIfExists(HKEY_LOCAL_MACHINE, "Software\\Policies\\Microsoft\\Windows\\AppInstaller") };
+            static GroupPolicySnapshots s_groupPolicy;
             static GroupPolicy* s_override = nullptr;
 
             if (overridePolicy.has_value())
@@ -20,7 +100,7 @@ namespace AppInstaller::Settings
                 s_override = overridePolicy.value();
             }
 
-            return (s_override ? *s_override : s_groupPolicy);
+            return (s_override ? *s_override : s_groupPolicy.Current());
         }
 
         template<Registry::Value::Type T>
@@ -211,6 +291,60 @@ namespace AppInstaller::Settings
             return GetRegistryValue<Mapping::ValueType>(policiesKey, Mapping::ValueName);
         }
 
+        std::optional<std::string> ValuePolicyMapping<ValuePolicy::InstallerCacheLocation>::ReadAndValidate(const Registry::Key& policiesKey)
+        {
+            using Mapping = ValuePolicyMapping<ValuePolicy::InstallerCacheLocation>;
+            auto location = GetRegistryValue<Mapping::ValueType>(policiesKey, Mapping::ValueName);
+            if (!location || location->empty())
+            {
+                return std::nullopt;
+            }
+
+            return location;
+        }
+
+        std::optional<uint32_t> ValuePolicyMapping<ValuePolicy::InstallerCacheMaximumSizeInMB>::ReadAndValidate(const Registry::Key& policiesKey)
+        {
+            using Mapping = ValuePolicyMapping<ValuePolicy::InstallerCacheMaximumSizeInMB>;
+            auto size = GetRegistryValue<Mapping::ValueType>(policiesKey, Mapping::ValueName);
+            if (!size || *size == 0)
+            {
+                return std::nullopt;
+            }
+
+            return size;
+        }
+
+        std::optional<uint32_t> ValuePolicyMapping<ValuePolicy::MaximumConcurrentDownloads>::ReadAndValidate(const Registry::Key& policiesKey)
+        {
+            using Mapping = ValuePolicyMapping<ValuePolicy::MaximumConcurrentDownloads>;
+            auto count = GetRegistryValue<Mapping::ValueType>(policiesKey, Mapping::ValueName);
+            if (!count || *count == 0)
+            {
+                return std::nullopt;
+            }
+
+            return count;
+        }
+
+        std::optional<uint32_t> ValuePolicyMapping<ValuePolicy::DownloadBandwidthLimitInKBps>::ReadAndValidate(const Registry::Key& policiesKey)
+        {
+            using Mapping = ValuePolicyMapping<ValuePolicy::DownloadBandwidthLimitInKBps>;
+            return GetRegistryValue<Mapping::ValueType>(policiesKey, Mapping::ValueName);
+        }
+
+        std::optional<bool> ValuePolicyMapping<ValuePolicy::BackgroundDownloads>::ReadAndValidate(const Registry::Key& policiesKey)
+        {
+            using Mapping = ValuePolicyMapping<ValuePolicy::BackgroundDownloads>;
+            auto value = GetRegistryValue<Mapping::ValueType>(policiesKey, Mapping::ValueName);
+            if (!value)
+            {
+                return std::nullopt;
+            }
+
+            return *value != 0;
+        }
+
         std::optional<SourceFromPolicy> ValuePolicyMapping<ValuePolicy::AdditionalSources>::ReadAndValidateItem(const Registry::Value& item)
         {
             return ReadSourceFromRegistryValue(item);
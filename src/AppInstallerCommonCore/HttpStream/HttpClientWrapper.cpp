@@ -2,7 +2,9 @@
 // Licensed under the MIT License.
 
 #include "pch.h"
+#include "Public/AppInstallerDownloader.h"
 #include "Public/AppInstallerStrings.h"
+#include "Public/winget/Timing.h"
 #include "HttpClientWrapper.h"
 
 using namespace winrt::Windows::Foundation;
@@ -18,7 +20,19 @@ using namespace winrt::Windows::Web::Http::Filters;
 // The HRESULTs will be mapped to UI error code by the appropriate component
 namespace AppInstaller::Utility::HttpStream
 {
-    std::future<std::shared_ptr<HttpClientWrapper>> HttpClientWrapper::CreateAsync(const Uri& uri)
+    namespace
+    {
+        // Counts a request for the resources report.
+        void RecordHttpRequest(const Uri& uri)
+        {
+            if (Timing::IsUsageEnabled())
+            {
+                Timing::RecordHttpRequest(Utility::ConvertToUTF8(uri.AbsoluteUri()));
+            }
+        }
+    }
+
+    std::future<std::shared_ptr<HttpClientWrapper>> HttpClientWrapper::CreateAsync(const Uri& uri, UINT32 initialContentSize)
     {
         std::shared_ptr<HttpClientWrapper> instance = std::make_shared<HttpClientWrapper>();
 
@@ -33,16 +47,70 @@ namespace AppInstaller::Utility::HttpStream
         instance->m_httpClient.DefaultRequestHeaders().Connection().Clear();
         instance->m_httpClient.DefaultRequestHeaders().Append(L"Connection", L"Keep-Alive");
 
-        co_await instance->PopulateInfoAsync();
+        if (initialContentSize == 0 || !co_await instance->PopulateInfoFromRangeAsync(initialContentSize))
+        {
+            co_await instance->PopulateInfoAsync();
+        }
 
         co_return instance;
     }
 
+    // This function requests the last bytes of the file, which is where a package keeps its central directory,
+    // and takes the size of the file from the Content-Range of the response. This saves the round trip of a head request.
+    std::future<bool> HttpClientWrapper::PopulateInfoFromRangeAsync(UINT32 initialContentSize)
+    {
+        HttpRequestMessage request(HttpMethod::Get(), m_requestUri);
+        request.Headers().Append(L"Range", L"bytes=-" + std::to_wstring(initialContentSize));
+
+        RecordHttpRequest(m_requestUri);
+        HttpResponseMessage response = co_await m_httpClient.SendRequestAsync(request, HttpCompletionOption::ResponseHeadersRead);
+        HttpContentHeaderCollection contentHeaders = response.Content().Headers();
+
+        // format: bytes a-b/x where x is either a number or *
+        std::wstring contentRange = contentHeaders.HasKey(L"Content-Range") ? std::wstring{ contentHeaders.Lookup(L"Content-Range") } : std::wstring{};
+        size_t rangeStart = contentRange.find(L' ');
+        size_t lengthStart = contentRange.find(L'/');
+
+        if (response.StatusCode() != HttpStatusCode::PartialContent || rangeStart == std::wstring::npos || lengthStart == std::wstring::npos ||
+            !std::iswdigit(contentRange[rangeStart + 1]) || lengthStart + 1 >= contentRange.size() || !std::iswdigit(contentRange[lengthStart + 1]))
+        {
+            // The body is not read, so that a server that ignored the range does not send the entire file.
+            response.Close();
+            co_return false;
+        }
+
+        m_sizeInBytes = std::stoull(contentRange.substr(lengthStart + 1));
+        ULONG64 position = std::stoull(contentRange.substr(rangeStart + 1));
+
+        m_redirectUri = response.RequestMessage().RequestUri();
+
+        m_contentType = contentHeaders.HasKey(L"Content-Type") ?
+            contentHeaders.Lookup(L"Content-Type")
+            : L"";
+
+        if (response.Headers().HasKey(L"ETag"))
+        {
+            m_etagHeader = response.Headers().Lookup(L"ETag");
+        }
+
+        if (contentHeaders.HasKey(L"Last-Modified"))
+        {
+            m_lastModifiedHeader = contentHeaders.Lookup(L"Last-Modified");
+        }
+
+        IBuffer result = co_await response.Content().ReadAsBufferAsync();
+        Utility::AddBytesReceived(result.Length());
+        m_initialContent = { position, result };
+
+        co_return true;
+    }
+
     // this function will issue a HEAD request to determine the size of the file and the redirect URI
     std::future<void> HttpClientWrapper::PopulateInfoAsync()
     {
         HttpRequestMessage request(HttpMethod::Head(), m_requestUri);
 
+        RecordHttpRequest(m_requestUri);
         HttpResponseMessage response = co_await m_httpClient.SendRequestAsync(request, HttpCompletionOption::ResponseHeadersRead);
 
         THROW_HR_IF(
@@ -101,6 +169,7 @@ namespace AppInstaller::Utility::HttpStream
             request.Headers().Append(L"If-Unmodified-Since", m_lastModifiedHeader);
         }
 
+        RecordHttpRequest(m_requestUri);
         HttpResponseMessage response = co_await m_httpClient.SendRequestAsync(request, HttpCompletionOption::ResponseHeadersRead);
         HttpContentHeaderCollection contentHeaders = response.Content().Headers();
 
@@ -136,7 +205,9 @@ namespace AppInstaller::Utility::HttpStream
             m_sizeInBytes = (length == L"*") ? 0 : std::stoll(length);
         }
 
-        co_return co_await response.Content().ReadAsBufferAsync();
+        IBuffer result = co_await response.Content().ReadAsBufferAsync();
+        Utility::AddBytesReceived(result.Length());
+        co_return result;
     }
 
     std::future<IBuffer> HttpClientWrapper::DownloadRangeAsync(
@@ -6,12 +6,20 @@
 
 namespace AppInstaller::Utility::HttpStream
 {
-    // Wrapper around HTTP client. When created, an object of this class will send a HTTP 
-    // head request to determine the size of the data source.
+    // Wrapper around HTTP client. When created, an object of this class will request the end of the data source
+    // to determine its size, and send a HTTP head request instead if the server does not return the range.
     class HttpClientWrapper
     {
     public:
-        static std::future<std::shared_ptr<HttpClientWrapper>> CreateAsync(const winrt::Windows::Foundation::Uri& uri);
+        // The content at the end of the data source that was received while determining its size.
+        struct InitialContent
+        {
+            ULONG64 Position = 0;
+            winrt::Windows::Storage::Streams::IBuffer Buffer = nullptr;
+        };
+
+        // If initialContentSize is zero, only a head request is sent to determine the size.
+        static std::future<std::shared_ptr<HttpClientWrapper>> CreateAsync(const winrt::Windows::Foundation::Uri& uri, UINT32 initialContentSize = 0);
 
         std::future<winrt::Windows::Storage::Streams::IBuffer> DownloadRangeAsync(
             const ULONG64 startPosition,
@@ -33,6 +41,12 @@ namespace AppInstaller::Utility::HttpStream
             return m_contentType;
         }
 
+        // Gets the initial content, which is no longer held by this object afterwards.
+        InitialContent TakeInitialContent()
+        {
+            return std::exchange(m_initialContent, {});
+        }
+
     private:
         winrt::Windows::Web::Http::HttpClient m_httpClient;
         winrt::Windows::Foundation::Uri m_requestUri = nullptr;
@@ -41,6 +55,10 @@ namespace AppInstaller::Utility::HttpStream
         unsigned long long m_sizeInBytes = 0;
         std::wstring m_etagHeader;
         std::wstring m_lastModifiedHeader;
+        InitialContent m_initialContent;
+
+        // Returns false if the server did not return the requested range.
+        std::future<bool> PopulateInfoFromRangeAsync(UINT32 initialContentSize);
 
         std::future<void> PopulateInfoAsync();
 
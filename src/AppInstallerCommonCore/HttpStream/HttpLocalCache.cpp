@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "pch.h"
+#include "Public/AppInstallerLogging.h"
 #include "HttpLocalCache.h"
 
 using namespace Windows::Storage::Streams;
@@ -13,14 +14,60 @@ using namespace winrt::Windows::Security::Cryptography;
 // The HRESULTs will be mapped to UI error code by the appropriate component
 namespace AppInstaller::Utility::HttpStream
 {
+    HttpLocalCache::HttpLocalCache(UINT32 pageSize, ULONG64 maximumSizeInBytes) :
+        m_pageSize(pageSize)
+    {
+        if (m_pageSize == 0U)
+        {
+            THROW_HR(E_INVALIDARG);
+        }
+
+        m_maximumPages = static_cast<UINT32>(std::clamp<ULONG64>(maximumSizeInBytes / m_pageSize, 1U, std::numeric_limits<UINT32>::max()));
+    }
+
+    HttpLocalCache::~HttpLocalCache()
+    {
+        // The prefetch uses the HttpClientWrapper, which the owning stream releases after the cache.
+        if (m_prefetch.Buffer.valid())
+        {
+            m_prefetch.Buffer.wait();
+        }
+    }
+
+    void HttpLocalCache::AddContent(const ULONG64 position, const IBuffer& buffer, const ULONG64 fileSize)
+    {
+        ULONG64 endPosition;
+        winrt::check_hresult(ULong64Add(position, buffer.Length(), &endPosition));
+
+        // The first page starting in the content; the last page may end with the file rather than a page boundary
+        ULONG64 firstPageOffset = ((position + m_pageSize - 1) / m_pageSize) * m_pageSize;
+        if (firstPageOffset >= endPosition)
+        {
+            return;
+        }
+
+        ULONG64 lastPageEnd = (endPosition == fileSize) ? endPosition : (endPosition / m_pageSize) * m_pageSize;
+        if (lastPageEnd <= firstPageOffset)
+        {
+            return;
+        }
+
+        // Conversion is safe as both are within the buffer, whose size is a UINT32.
+        IBuffer pages = CreateTrimmedBuffer(buffer, static_cast<UINT32>(firstPageOffset - position), static_cast<UINT32>(lastPageEnd - firstPageOffset));
+        SaveBufferToCache(pages, firstPageOffset);
+        VacateStaleEntriesFromCache();
+    }
+
     std::future<IBuffer> HttpLocalCache::ReadFromCacheAndDownloadIfNecessaryAsync(
         const ULONG64 requestedPosition,
         const UINT32 requestedSize,
         HttpClientWrapper* httpClientWrapper,
         InputStreamOptions httpInputStreamOptions)
     {
-        // Increment cache access counter user for implementing LRU replacement
-        m_accessCounter++;
+        ULONG64 readAheadEndPosition = UpdateReadAhead(requestedPosition, requestedSize, httpClientWrapper->GetFullFileSize());
+
+        // Pages prefetched for a previous read are saved first, so that they are not downloaded again
+        co_await CompletePrefetchAsync(requestedPosition, requestedSize);
 
         // Find all the pages for the given request, and the pages that are missing
         std::vector<ULONG64> allPages;
@@ -36,11 +83,19 @@ namespace AppInstaller::Utility::HttpStream
         // At this point, everything should be in the cache
         IBuffer constructedBuffer = {};
 
-        for (UINT32 i = 0; i < allPages.size(); i++)
+        if (allPages.size() == 1)
         {
-            UINT64 pageOffset = allPages[i];
-            IBuffer cachedPageBuffer = ReadPageFromCache(pageOffset);
-            constructedBuffer = ConcatenateBuffers(constructedBuffer, cachedPageBuffer);
+            constructedBuffer = ReadPageFromCache(allPages[0]);
+        }
+        else
+        {
+            // Write all of the pages at once rather than concatenating them, which would copy the buffer for every page
+            DataWriter writer;
+            for (UINT64 pageOffset : allPages)
+            {
+                writer.WriteBuffer(ReadPageFromCache(pageOffset));
+            }
+            constructedBuffer = writer.DetachBuffer();
         }
 
         // trim buffer to match requested range
@@ -50,11 +105,88 @@ namespace AppInstaller::Utility::HttpStream
             requestedSize,
             allPages);
 
+        // Fetch the pages that a sequential read will want next while the consumer processes this one
+        ULONG64 nextPageOffset;
+        winrt::check_hresult(ULong64Add(allPages.back(), m_pageSize, &nextPageOffset));
+        StartPrefetch(nextPageOffset, readAheadEndPosition, httpClientWrapper, httpInputStreamOptions);
+
         VacateStaleEntriesFromCache();
 
         co_return requestedBuffer;
     }
 
+    std::future<void> HttpLocalCache::DownloadRangesAsync(const std::vector<ByteRange> ranges, HttpClientWrapper* httpClientWrapper)
+    {
+        ULONG64 fileSize = httpClientWrapper->GetFullFileSize();
+
+        std::set<ULONG64> missingPages;
+        for (const ByteRange& range : ranges)
+        {
+            ULONG64 endPosition;
+            winrt::check_hresult(ULong64Add(range.Position, range.Size, &endPosition));
+            endPosition = std::min(endPosition, fileSize);
+
+            for (ULONG64 pageOffset = (range.Position / m_pageSize) * m_pageSize; pageOffset < endPosition; pageOffset += m_pageSize)
+            {
+                if (m_localCache.find(pageOffset) == m_localCache.end())
+                {
+                    missingPages.insert(pageOffset);
+                }
+            }
+        }
+
+        if (missingPages.size() > m_maximumPages / 2U)
+        {
+            AICLI_LOG(Core, Verbose, << "Not downloading " << missingPages.size() << " pages of ranges ahead of their reads");
+            co_return;
+        }
+
+        // Pages in small gaps are downloaded again even if cached, which costs less than another request
+        std::vector<ULONG64> plannedPages;
+        for (ULONG64 pageOffset : missingPages)
+        {
+            if (!plannedPages.empty() && pageOffset - plannedPages.back() <= (MaximumCoalescedGapPages + 1ULL) * m_pageSize)
+            {
+                for (ULONG64 gapOffset = plannedPages.back() + m_pageSize; gapOffset < pageOffset; gapOffset += m_pageSize)
+                {
+                    plannedPages.push_back(gapOffset);
+                }
+            }
+
+            plannedPages.push_back(pageOffset);
+        }
+
+        co_await DownloadAndSaveToCacheAysnc(plannedPages, httpClientWrapper, InputStreamOptions::None);
+
+        VacateStaleEntriesFromCache();
+    }
+
+    // Reads that continue where the previous one ended double the pages that are read ahead of them, so that sequential
+    // reads of large parts of a package (like the block map or payload files) need fewer requests. Any other read is
+    // assumed to be a seek to a small structure (like the central directory or the signature) and stops reading ahead.
+    ULONG64 HttpLocalCache::UpdateReadAhead(const ULONG64 requestedPosition, const UINT32 requestedSize, const ULONG64 fileSize)
+    {
+        if (requestedPosition != 0U && requestedPosition == m_nextSequentialPosition)
+        {
+            // The read ahead is limited to part of the cache so that it cannot evict pages that are still being read
+            UINT32 maximumReadAheadPages = std::min(MaximumReadAheadPages, m_maximumPages / 4U);
+            m_readAheadPages = std::min(std::max(m_readAheadPages * 2U, 1U), maximumReadAheadPages);
+        }
+        else
+        {
+            m_readAheadPages = 0U;
+        }
+
+        winrt::check_hresult(ULong64Add(requestedPosition, requestedSize, &m_nextSequentialPosition));
+
+        ULONG64 readAheadSize;
+        ULONG64 readAheadEndPosition;
+        winrt::check_hresult(ULong64Mult(m_readAheadPages, m_pageSize, &readAheadSize));
+        winrt::check_hresult(ULong64Add(m_nextSequentialPosition, readAheadSize, &readAheadEndPosition));
+
+        return std::min(readAheadEndPosition, fileSize);
+    }
+
     void HttpLocalCache::FindCachePages(
         ULONG64 requestedPosition,
         UINT32 requestedSize,
@@ -64,7 +196,7 @@ namespace AppInstaller::Utility::HttpStream
         ULONG64 requestedEndPosition;
         ULONG64 currentPageOffset;
         winrt::check_hresult(ULong64Add(requestedPosition, requestedSize, &requestedEndPosition));
-        winrt::check_hresult(ULong64Mult((requestedPosition / PAGE_SIZE), PAGE_SIZE, &currentPageOffset));
+        winrt::check_hresult(ULong64Mult((requestedPosition / m_pageSize), m_pageSize, &currentPageOffset));
 
         // There's always at least one page for the range
         do
@@ -76,13 +208,82 @@ namespace AppInstaller::Utility::HttpStream
                 unsatisfiablePages.push_back(currentPageOffset);
             }
 
-            winrt::check_hresult(ULong64Add(currentPageOffset, PAGE_SIZE, &currentPageOffset));
+            winrt::check_hresult(ULong64Add(currentPageOffset, m_pageSize, &currentPageOffset));
 
         } while (currentPageOffset < requestedEndPosition);
     }
 
+    // Starts downloading the missing pages from firstPageOffset up to endPosition in the background; the download
+    // stops at the first page that is already cached. Only one prefetch is outstanding at a time.
+    void HttpLocalCache::StartPrefetch(
+        const ULONG64 firstPageOffset,
+        const ULONG64 endPosition,
+        HttpClientWrapper* httpClientWrapper,
+        const InputStreamOptions httpInputStreamOptions)
+    {
+        if (m_prefetch.Buffer.valid())
+        {
+            return;
+        }
+
+        ULONG64 prefetchPosition = firstPageOffset;
+        while (prefetchPosition < endPosition && m_localCache.find(prefetchPosition) != m_localCache.end())
+        {
+            winrt::check_hresult(ULong64Add(prefetchPosition, m_pageSize, &prefetchPosition));
+        }
+
+        ULONG64 prefetchEndPosition = prefetchPosition;
+        while (prefetchEndPosition < endPosition && m_localCache.find(prefetchEndPosition) == m_localCache.end())
+        {
+            winrt::check_hresult(ULong64Add(prefetchEndPosition, m_pageSize, &prefetchEndPosition));
+        }
+
+        prefetchEndPosition = std::min(prefetchEndPosition, endPosition);
+        if (prefetchEndPosition <= prefetchPosition)
+        {
+            return;
+        }
+
+        UINT32 prefetchSize;
+        winrt::check_hresult(ULongLongToUInt(prefetchEndPosition - prefetchPosition, &prefetchSize));
+
+        m_prefetch.Position = prefetchPosition;
+        m_prefetch.EndPosition = prefetchEndPosition;
+        m_prefetch.Buffer = httpClientWrapper->DownloadRangeAsync(prefetchPosition, prefetchSize, httpInputStreamOptions);
+    }
+
+    // Saves the outstanding prefetch to the cache if it has completed, or waits for it if the requested range needs its pages.
+    // A failed prefetch is only logged, since the pages will be downloaded again if they are read.
+    std::future<void> HttpLocalCache::CompletePrefetchAsync(const ULONG64 requestedPosition, const UINT32 requestedSize)
+    {
+        if (!m_prefetch.Buffer.valid())
+        {
+            co_return;
+        }
+
+        bool overlapsRequest = requestedPosition < m_prefetch.EndPosition && m_prefetch.Position < requestedPosition + requestedSize;
+        if (!overlapsRequest && m_prefetch.Buffer.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            co_return;
+        }
+
+        ULONG64 prefetchPosition = m_prefetch.Position;
+        std::future<IBuffer> prefetchBuffer = std::move(m_prefetch.Buffer);
+        m_prefetch = {};
+
+        try
+        {
+            IBuffer buffer = co_await std::move(prefetchBuffer);
+            SaveBufferToCache(buffer, prefetchPosition);
+        }
+        catch (...)
+        {
+            AICLI_LOG(Core, Warning, << "Prefetch of " << prefetchPosition << " failed: " << wil::ResultFromCaughtException());
+        }
+    }
+
     // Breaks the provided buffer into smaller buffers and saves them to the cache at the corresponding 
-    // page offset position, starting at firstPageOffset. The smaller buffers are all PAGE_SIZE bytes,
+    // page offset position, starting at firstPageOffset. The smaller buffers are all page size bytes,
     // except for the one corresponding to the last page in the file
     void HttpLocalCache::SaveBufferToCache(const IBuffer& buffer, const ULONG64 firstPageOffset)
     {
@@ -93,33 +294,45 @@ namespace AppInstaller::Utility::HttpStream
         while (remainingBufferSize > 0)
         {
             // Extract the sub-buffer
-            UINT32 currentPageSize = std::min(remainingBufferSize, PAGE_SIZE);
+            UINT32 currentPageSize = std::min(remainingBufferSize, m_pageSize);
             IBuffer currentPageBuffer = CreateTrimmedBuffer(buffer, currentBufferIndex, currentPageSize);
 
             // Add it to the cache
-            CachedPage currentPage;
-            currentPage.lastAccessCounter = m_accessCounter;
-            currentPage.buffer = currentPageBuffer;
-            m_localCache[currentPageOffset] = currentPage;
+            auto [pageIter, inserted] = m_localCache.try_emplace(currentPageOffset);
+            if (inserted)
+            {
+                m_lruPages.push_front(currentPageOffset);
+                pageIter->second.lruPosition = m_lruPages.begin();
+            }
+            else
+            {
+                TouchPage(pageIter->second);
+            }
+            pageIter->second.buffer = currentPageBuffer;
 
             // update loop vars
             winrt::check_hresult(UInt32Sub(remainingBufferSize, currentPageSize, &remainingBufferSize));
             winrt::check_hresult(UInt32Add(currentBufferIndex, currentPageSize, &currentBufferIndex));
-            winrt::check_hresult(ULong64Add(currentPageOffset, PAGE_SIZE, &currentPageOffset));
+            winrt::check_hresult(ULong64Add(currentPageOffset, m_pageSize, &currentPageOffset));
         }
     }
 
     IBuffer HttpLocalCache::ReadPageFromCache(const ULONG64 pageOffset)
     {
-        if (!(m_localCache.find(pageOffset) != m_localCache.end()))
+        auto pageIter = m_localCache.find(pageOffset);
+        if (pageIter == m_localCache.end())
         {
             THROW_HR(E_INVALIDARG);
         }
 
-        CachedPage& page = m_localCache[pageOffset];
-        page.lastAccessCounter = m_accessCounter;
+        TouchPage(pageIter->second);
+
+        return pageIter->second.buffer;
+    }
 
-        return page.buffer;
+    void HttpLocalCache::TouchPage(CachedPage& page)
+    {
+        m_lruPages.splice(m_lruPages.begin(), m_lruPages, page.lruPosition);
     }
 
     // Trims a buffer that was constructed (by fetching pages from cache and downloading missing pages)
@@ -143,72 +356,61 @@ namespace AppInstaller::Utility::HttpStream
         return requestedBuffer;
     }
 
-    // Downloads a chunk of the file, saves it to the cache, and returns the corresponding buffer
-    // If the requested size is 0, this method returns an empty buffer without making HTTP calls
+    // Downloads the missing pages of the file and saves them to the cache.
+    // Each run of adjacent missing pages is downloaded with a single range request, while pages that are
+    // already cached between the runs are not downloaded again. If there are no missing pages, this method
+    // returns without making HTTP calls.
     std::future<void> HttpLocalCache::DownloadAndSaveToCacheAysnc(
         const std::vector<ULONG64> unsatisfiablePages,
         HttpClientWrapper* httpClientWrapper,
         InputStreamOptions httpInputStreamOptions)
     {
-        // Determine the download job
-        // To make things easy, we will download the contiguous range that includes all the unsatisfiable ranges.
-        // Note that in theory, this may include cached pages. However, this situation is rarely expected to happen,
-        // if at all. The package reader usually reads things in chunks of 64 KB or less, so, we should expect to 
-        // always have up to two satisfiable and unsatisfiable pages in total.
         UINT64 fileSize = httpClientWrapper->GetFullFileSize();
-        ULONG64 downloadJobStartPosition = 0U;
-        ULONG64 downloadJobEndPosition = 0U;
-        ULONG64 downloadJobSize = 0U;
-        if (unsatisfiablePages.size() > 0U)
+
+        for (size_t runStart = 0; runStart < unsatisfiablePages.size();)
         {
-            downloadJobStartPosition = unsatisfiablePages[0];
-            ULONG64 lastUnsatisfiableJob = unsatisfiablePages[unsatisfiablePages.size() - 1];
-            winrt::check_hresult(ULong64Add(lastUnsatisfiableJob, PAGE_SIZE, &downloadJobEndPosition));
+            size_t runEnd = runStart + 1;
+            while (runEnd < unsatisfiablePages.size() && unsatisfiablePages[runEnd] == unsatisfiablePages[runEnd - 1] + m_pageSize)
+            {
+                runEnd++;
+            }
+
+            ULONG64 downloadJobStartPosition = unsatisfiablePages[runStart];
+            ULONG64 downloadJobEndPosition = 0U;
+            ULONG64 downloadJobSize = 0U;
+            winrt::check_hresult(ULong64Add(unsatisfiablePages[runEnd - 1], m_pageSize, &downloadJobEndPosition));
 
             // make sure to not overflow file size
             downloadJobEndPosition = std::min(downloadJobEndPosition, fileSize);
-            winrt::check_hresult(ULong64Sub(downloadJobEndPosition, downloadJobStartPosition, &downloadJobSize));
-        }
+            if (downloadJobEndPosition > downloadJobStartPosition)
+            {
+                winrt::check_hresult(ULong64Sub(downloadJobEndPosition, downloadJobStartPosition, &downloadJobSize));
+            }
 
-        if (downloadJobSize != 0U)
-        {
-            // start download job
-            IBuffer downloadedBuffer = co_await httpClientWrapper->DownloadRangeAsync(
-                downloadJobStartPosition,
-                (UINT32)downloadJobSize,
-                httpInputStreamOptions);
+            if (downloadJobSize != 0U)
+            {
+                UINT32 downloadJobSize32;
+                winrt::check_hresult(ULongLongToUInt(downloadJobSize, &downloadJobSize32));
+
+                // start download job
+                IBuffer downloadedBuffer = co_await httpClientWrapper->DownloadRangeAsync(
+                    downloadJobStartPosition,
+                    downloadJobSize32,
+                    httpInputStreamOptions);
+
+                SaveBufferToCache(downloadedBuffer, downloadJobStartPosition);
+            }
 
-            SaveBufferToCache(downloadedBuffer, downloadJobStartPosition);
+            runStart = runEnd;
         }
     }
 
     void HttpLocalCache::VacateStaleEntriesFromCache()
     {
-        // Copy page offsets into vector and sort by the access counter
-        std::vector<std::pair<UINT64, int>> orderedPageOffsets;
-        for (auto pageIter = m_localCache.begin(); pageIter != m_localCache.end(); pageIter++)
+        while (m_localCache.size() > m_maximumPages)
         {
-            orderedPageOffsets.push_back(std::pair<UINT64, int>(pageIter->first, pageIter->second.lastAccessCounter));
-        }
-
-        // Compare function to sort by access counter
-        auto cmp = [](std::pair<UINT64, int> const & a, std::pair<UINT64, int> const & b)
-        {
-            return a.second != b.second ? a.second < b.second : a.first < b.first;
-        };
-
-        std::sort(orderedPageOffsets.begin(), orderedPageOffsets.end(), cmp);
-
-        for (auto pageIter = orderedPageOffsets.begin(); pageIter != orderedPageOffsets.end(); pageIter++)
-        {
-            if (m_localCache.size() > MAX_PAGES)
-            {
-                m_localCache.erase(pageIter->first);
-            }
-            else
-            {
-                break;
-            }
+            m_localCache.erase(m_lruPages.back());
+            m_lruPages.pop_back();
         }
     }
 
@@ -231,13 +433,4 @@ namespace AppInstaller::Utility::HttpStream
             { byteBuffer + trimStartIndex, byteBuffer + trimStartIndex + size });
 
         return trimmedBuffer;
-    }
-
-    IBuffer HttpLocalCache::ConcatenateBuffers(const IBuffer& buffer1, const IBuffer& buffer2)
-    {
-        DataWriter writer;
-        writer.WriteBuffer(buffer1);
-        writer.WriteBuffer(buffer2);
-        return writer.DetachBuffer();
-    }
-}
\ No newline at end of file
+    }}
\ No newline at end of file
@@ -10,16 +10,47 @@ namespace AppInstaller::Utility::HttpStream
     // Represents an entry in the cache.
     struct CachedPage
     {
-        int lastAccessCounter = 0;
         winrt::Windows::Storage::Streams::IBuffer buffer;
+        // The position of the page in the least recently used order.
+        std::list<ULONG64>::iterator lruPosition;
     };
 
     // A cache used internally by the custom HttpRandomAccessStream to reduce round-trips
     class HttpLocalCache
     {
     public:
-        const UINT32 PAGE_SIZE = 2 << 16;   // each entry in the cache is 64 KB
-        const UINT32 MAX_PAGES = 200;       // cache size capped at 12.5 MB (200 * 64KB)
+        static constexpr UINT32 DefaultPageSize = 2 << 16;                          // each entry in the cache is 64 KB
+        static constexpr ULONG64 DefaultMaximumSizeInBytes = 200 * DefaultPageSize; // cache size capped at 12.5 MB (200 * 64KB)
+
+        // The most pages prefetched ahead of a request that continues the previous one.
+        static constexpr UINT32 MaximumReadAheadPages = 16;
+
+        // The most pages between two ranges that are downloaded so that the ranges are downloaded with a single request.
+        static constexpr UINT32 MaximumCoalescedGapPages = 2;
+
+        // A range of bytes in the file.
+        struct ByteRange
+        {
+            ULONG64 Position = 0;
+            ULONG64 Size = 0;
+        };
+
+        HttpLocalCache(UINT32 pageSize = DefaultPageSize, ULONG64 maximumSizeInBytes = DefaultMaximumSizeInBytes);
+
+        HttpLocalCache(const HttpLocalCache&) = delete;
+        HttpLocalCache& operator=(const HttpLocalCache&) = delete;
+
+        ~HttpLocalCache();
+
+        UINT32 GetPageSize() const { return m_pageSize; }
+        UINT32 GetMaximumPages() const { return m_maximumPages; }
+
+        // Saves the pages contained entirely in content downloaded outside of a read, like the initial content of a file.
+        void AddContent(const ULONG64 position, const winrt::Windows::Storage::Streams::IBuffer& buffer, const ULONG64 fileSize);
+
+        // Downloads the missing pages of all of the ranges, joining those that are close together into a single request.
+        // The ranges are not downloaded if they would take more than half of the cache, as they would evict each other.
+        std::future<void> DownloadRangesAsync(const std::vector<ByteRange> ranges, HttpClientWrapper* httpClientWrapper);
 
         // Returns a buffer matching the requested range by reading the parts of the range that are cached
         // and downloading the rest using the provided httpClientWrapper object
@@ -30,8 +61,26 @@ namespace AppInstaller::Utility::HttpStream
             winrt::Windows::Storage::Streams::InputStreamOptions httpInputStreamOptions);
 
     private:
+        UINT32 m_pageSize;
+        UINT32 m_maximumPages;
         std::map<ULONG64, CachedPage> m_localCache;
-        UINT32 m_accessCounter = 0U;
+
+        // The page offsets in the cache, from the most to the least recently used.
+        std::list<ULONG64> m_lruPages;
+
+        // Sequential reads are detected to grow the number of pages read ahead of them.
+        ULONG64 m_nextSequentialPosition = 0U;
+        UINT32 m_readAheadPages = 0U;
+
+        // A background download of the pages after a sequential read, which is saved to the cache by a later read.
+        struct Prefetch
+        {
+            ULONG64 Position = 0U;
+            ULONG64 EndPosition = 0U;
+            std::future<winrt::Windows::Storage::Streams::IBuffer> Buffer;
+        };
+
+        Prefetch m_prefetch;
 
         // Returns a vector of all pages corresponding to a range, and another (subset)
         // vector of the pages missing from the cache.
@@ -41,10 +90,24 @@ namespace AppInstaller::Utility::HttpStream
             std::vector<ULONG64>& allPages,
             std::vector<ULONG64>& unsatisfiablePages);
 
+        void StartPrefetch(
+            const ULONG64 firstPageOffset,
+            const ULONG64 endPosition,
+            HttpClientWrapper* httpClientWrapper,
+            const winrt::Windows::Storage::Streams::InputStreamOptions httpInputStreamOptions);
+
+        std::future<void> CompletePrefetchAsync(const ULONG64 requestedPosition, const UINT32 requestedSize);
+
+        // Updates the read ahead for a request, returning the position up to which pages should be read ahead.
+        ULONG64 UpdateReadAhead(const ULONG64 requestedPosition, const UINT32 requestedSize, const ULONG64 fileSize);
+
         void SaveBufferToCache(const winrt::Windows::Storage::Streams::IBuffer& buffer, const ULONG64 firstPageOffset);
 
         winrt::Windows::Storage::Streams::IBuffer ReadPageFromCache(const ULONG64 pageOffset);
 
+        // Moves the page to the front of the least recently used order.
+        void TouchPage(CachedPage& page);
+
         void VacateStaleEntriesFromCache();
 
         std::future<void> DownloadAndSaveToCacheAysnc(
@@ -62,9 +125,5 @@ namespace AppInstaller::Utility::HttpStream
             const winrt::Windows::Storage::Streams::IBuffer& originalBuffer,
             UINT32 trimStartIndex,
             UINT32 size);
-
-        winrt::Windows::Storage::Streams::IBuffer ConcatenateBuffers(
-            const winrt::Windows::Storage::Streams::IBuffer& buffer1,
-            const winrt::Windows::Storage::Streams::IBuffer& buffer2);
     };
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "pch.h"
 #include "HttpRandomAccessStream.h"
+#include "Public/winget/MemoryTrim.h"
 
 using namespace winrt::Windows::Foundation;
 using namespace winrt::Windows::Storage::Streams;
@@ -12,18 +13,150 @@ using namespace winrt::Windows::Storage::Streams;
 // The HRESULTs will be mapped to UI error code by the appropriate component
 namespace AppInstaller::Utility::HttpStream
 {
-    IAsyncOperation<IRandomAccessStream> HttpRandomAccessStream::CreateAsync(const Uri& uri)
+    namespace
+    {
+        // The most released streams whose content is kept, and how long it is kept for. Each is bounded by its cache size.
+        constexpr size_t s_MaximumIdleContent = 2;
+        constexpr std::chrono::minutes s_IdleContentLifetime = std::chrono::minutes(5);
+
+        // The http client and cache of a released stream, waiting to be taken by a new stream over the same content.
+        struct IdleContent
+        {
+            std::wstring Key;
+            std::chrono::steady_clock::time_point Released;
+            std::shared_ptr<HttpClientWrapper> HttpHelper;
+            std::unique_ptr<HttpLocalCache> LocalCache;
+        };
+
+        // The content is taken out of the pool by the stream that uses it, so a cache is never shared by two streams at once.
+        class IdleContentPool
+        {
+        public:
+            std::optional<IdleContent> Take(const std::wstring& key)
+            {
+                std::list<IdleContent> expired;
+                std::optional<IdleContent> result;
+
+                {
+                    std::lock_guard<std::mutex> lock{ m_lock };
+                    RemoveExpired(expired);
+
+                    auto itr = std::find_if(m_content.begin(), m_content.end(), [&](const IdleContent& content) { return content.Key == key; });
+                    if (itr != m_content.end())
+                    {
+                        result = std::move(*itr);
+                        m_content.erase(itr);
+                    }
+                }
+
+                return result;
+            }
+
+            void Return(IdleContent&& content)
+            {
+                // Content removed from the pool is destroyed outside of the lock, as a cache waits for its prefetch.
+                std::list<IdleContent> expired;
+
+                std::lock_guard<std::mutex> lock{ m_lock };
+                content.Released = std::chrono::steady_clock::now();
+                m_content.emplace_front(std::move(content));
+
+                while (m_content.size() > s_MaximumIdleContent)
+                {
+                    expired.splice(expired.end(), m_content, std::prev(m_content.end()));
+                }
+
+                RemoveExpired(expired);
+            }
+
+            void Clear()
+            {
+                std::list<IdleContent> released;
+
+                std::lock_guard<std::mutex> lock{ m_lock };
+                released.swap(m_content);
+            }
+
+        private:
+            void RemoveExpired(std::list<IdleContent>& expired)
+            {
+                auto now = std::chrono::steady_clock::now();
+                for (auto itr = m_content.begin(); itr != m_content.end();)
+                {
+                    auto current = itr++;
+                    if (now - current->Released > s_IdleContentLifetime)
+                    {
+                        expired.splice(expired.end(), m_content, current);
+                    }
+                }
+            }
+
+            std::mutex m_lock;
+            std::list<IdleContent> m_content;
+        };
+
+        IdleContentPool& GetIdleContentPool()
+        {
+            // Intentionally never destroyed, as the http clients cannot be released once the process is shutting down.
+            static IdleContentPool* s_pool = []()
+            {
+                Memory::RegisterTrimFunction([]() { GetIdleContentPool().Clear(); });
+                return new IdleContentPool();
+            }();
+            return *s_pool;
+        }
+
+        // The cache is only reused with the same page size and budget that a new stream would create it with.
+        std::wstring GetContentKey(const Uri& uri, UINT32 cachePageSize, ULONG64 cacheSizeInBytes)
+        {
+            return std::to_wstring(cachePageSize) + L'|' + std::to_wstring(cacheSizeInBytes) + L'|' + std::wstring{ uri.AbsoluteUri() };
+        }
+    }
+
+    IAsyncOperation<IRandomAccessStream> HttpRandomAccessStream::CreateAsync(const Uri& uri, UINT32 cachePageSize, ULONG64 cacheSizeInBytes)
     {
         winrt::com_ptr<HttpRandomAccessStream> stream = winrt::make_self<HttpRandomAccessStream>();
+        std::wstring contentKey = GetContentKey(uri, cachePageSize, cacheSizeInBytes);
+
+        std::optional<IdleContent> idleContent = GetIdleContentPool().Take(contentKey);
+        if (idleContent)
+        {
+            stream->m_httpHelper = std::move(idleContent->HttpHelper);
+            stream->m_httpLocalCache = std::move(idleContent->LocalCache);
+        }
+        else
+        {
+            // The first request covers the last two pages, where a package keeps the central directory that is read first.
+            UINT32 initialContentSize = static_cast<UINT32>(std::min<ULONG64>(2ULL * cachePageSize, std::numeric_limits<UINT32>::max()));
+            stream->m_httpHelper = co_await HttpClientWrapper::CreateAsync(uri, initialContentSize);
+            stream->m_httpLocalCache = std::make_unique<HttpLocalCache>(cachePageSize, cacheSizeInBytes);
+
+            HttpClientWrapper::InitialContent initialContent = stream->m_httpHelper->TakeInitialContent();
+            if (initialContent.Buffer)
+            {
+                stream->m_httpLocalCache->AddContent(initialContent.Position, initialContent.Buffer, stream->m_httpHelper->GetFullFileSize());
+            }
+        }
 
-        stream->m_httpHelper = co_await HttpClientWrapper::CreateAsync(uri);
         stream->m_size = stream->m_httpHelper->GetFullFileSize();
-        stream->m_httpLocalCache = std::make_unique<HttpLocalCache>();
+        stream->m_contentKey = std::move(contentKey);
 
         co_return stream.as<IRandomAccessStream>();
 
     }
 
+    HttpRandomAccessStream::~HttpRandomAccessStream()
+    {
+        if (m_httpHelper && m_httpLocalCache)
+        {
+            try
+            {
+                GetIdleContentPool().Return({ std::move(m_contentKey), {}, std::move(m_httpHelper), std::move(m_httpLocalCache) });
+            }
+            CATCH_LOG();
+        }
+    }
+
     uint64_t HttpRandomAccessStream::Size() const
     {
         return m_size;
@@ -86,4 +219,9 @@ namespace AppInstaller::Utility::HttpStream
 
         co_return result;
     }
+
+    std::future<void> HttpRandomAccessStream::PrefetchRangesAsync(const std::vector<HttpLocalCache::ByteRange>& ranges)
+    {
+        return m_httpLocalCache->DownloadRangesAsync(ranges, m_httpHelper.get());
+    }
 }
\ No newline at end of file
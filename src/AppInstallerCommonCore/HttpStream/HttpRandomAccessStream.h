@@ -11,14 +11,22 @@ namespace AppInstaller::Utility::HttpStream
     // range-based fetching. This is intended to be used by AppxPackageReader.
     //
     // Note: If the server doesn't support HTTP ranges, this implementation will throw an exception.
+    //
+    // When a stream is released, its cache and the information from its HEAD request are kept for a while,
+    // so that a later stream over the same uri (as opened by each read of a package) continues from them.
     class HttpRandomAccessStream : public winrt::implements<
         HttpRandomAccessStream,
         winrt::Windows::Storage::Streams::IRandomAccessStream,
         winrt::Windows::Storage::Streams::IInputStream>
     {
     public:
+        // The cache page size and budget default to values suited to the reads made by AppxPackageReader.
         static winrt::Windows::Foundation::IAsyncOperation<winrt::Windows::Storage::Streams::IRandomAccessStream> CreateAsync(
-            const winrt::Windows::Foundation::Uri& uri);
+            const winrt::Windows::Foundation::Uri& uri,
+            UINT32 cachePageSize = HttpLocalCache::DefaultPageSize,
+            ULONG64 cacheSizeInBytes = HttpLocalCache::DefaultMaximumSizeInBytes);
+        ~HttpRandomAccessStream();
+
         uint64_t Size() const;
         void Size(uint64_t value);
         uint64_t Position() const;
@@ -33,9 +41,13 @@ namespace AppInstaller::Utility::HttpStream
             uint32_t count,
             winrt::Windows::Storage::Streams::InputStreamOptions options);
 
+        // Downloads the ranges into the cache ahead of the reads that will want them.
+        std::future<void> PrefetchRangesAsync(const std::vector<HttpLocalCache::ByteRange>& ranges);
+
     private:
         std::shared_ptr<HttpClientWrapper> m_httpHelper;
         std::unique_ptr<HttpLocalCache> m_httpLocalCache;
+        std::wstring m_contentKey;
         unsigned long long m_size = 0;
         unsigned long long m_requestedPosition = 0;
     };
@@ -0,0 +1,181 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Public/winget/InstallerCache.h"
+#include "Public/winget/AdminSettings.h"
+#include "Public/winget/GroupPolicy.h"
+#include "Public/AppInstallerLogging.h"
+#include "Public/AppInstallerRuntime.h"
+#include "Public/AppInstallerStrings.h"
+
+namespace AppInstaller::Utility
+{
+    namespace
+    {
+        // The maximum size of the cache when it is not set by policy.
+        constexpr uint64_t s_DefaultMaximumSizeInMB = 10 * 1024;
+
+        // The suffix of an installer that is being added to the cache.
+        constexpr std::wstring_view s_PendingEntrySuffix = L".pending";
+
+        // Entries are named by the hex string of their hash; anything else in the directory is ignored.
+        bool IsEntryName(const std::filesystem::path& path)
+        {
+            std::wstring name = path.filename().wstring();
+            return name.size() == SHA256::HashBufferSizeInBytes * 2 && std::all_of(name.begin(), name.end(), [](wchar_t c) { return std::iswxdigit(c) != 0; });
+        }
+
+        // Marks the entry as the most recently used.
+        void TouchEntry(const std::filesystem::path& path)
+        {
+            std::error_code ec;
+            std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+        }
+
+        void RemoveFile(const std::filesystem::path& path)
+        {
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+        }
+    }
+
+    InstallerCache::InstallerCache(std::filesystem::path root, uint64_t maximumSizeInBytes) :
+        m_root(std::move(root)), m_maximumSizeInBytes(maximumSizeInBytes) {}
+
+    std::optional<InstallerCache> InstallerCache::GetDefault()
+    {
+        if (!Settings::IsAdminSettingEnabled(Settings::AdminSetting::InstallerCache))
+        {
+            return {};
+        }
+
+        const auto& policies = Settings::GroupPolicies();
+
+        std::filesystem::path root;
+        auto locationPolicy = policies.GetValueRef<Settings::ValuePolicy::InstallerCacheLocation>();
+        if (locationPolicy)
+        {
+            root = ConvertToUTF16(locationPolicy->get());
+        }
+        else
+        {
+            root = Runtime::GetPathTo(Runtime::PathName::InstallerCache);
+        }
+
+        uint64_t maximumSizeInMB = policies.GetValue<Settings::ValuePolicy::InstallerCacheMaximumSizeInMB>().value_or(s_DefaultMaximumSizeInMB);
+
+        return InstallerCache{ std::move(root), maximumSizeInMB * 1024 * 1024 };
+    }
+
+    bool InstallerCache::TryGet(const SHA256::HashBuffer& hash, const std::filesystem::path& target) const
+    {
+        std::filesystem::path entry = GetEntryPath(hash);
+        if (!std::filesystem::exists(entry))
+        {
+            return false;
+        }
+
+        AICLI_LOG(Core, Info, << "Found installer in cache: " << entry);
+        std::filesystem::copy_file(entry, target, std::filesystem::copy_options::overwrite_existing);
+
+        // The copy is verified rather than the entry, so that it cannot change after it is checked.
+        SHA256::HashBuffer copiedHash = SHA256::ComputeHashFromFile(target);
+
+        if (!SHA256::AreEqual(hash, copiedHash))
+        {
+            AICLI_LOG(Core, Warning, << "Cached installer does not match its hash; removing it");
+            RemoveFile(target);
+            RemoveFile(entry);
+            return false;
+        }
+
+        TouchEntry(entry);
+        return true;
+    }
+
+    void InstallerCache::Add(const SHA256::HashBuffer& hash, const std::filesystem::path& source) const
+    {
+        std::filesystem::path entry = GetEntryPath(hash);
+        if (std::filesystem::exists(entry))
+        {
+            TouchEntry(entry);
+            return;
+        }
+
+        std::filesystem::create_directories(m_root);
+
+        // Copy to a name that is not an entry first, so that a partial copy is never found by TryGet.
+        std::filesystem::path pending = entry;
+        pending += L"." + std::to_wstring(GetCurrentProcessId());
+        pending += s_PendingEntrySuffix;
+
+        std::filesystem::copy_file(source, pending, std::filesystem::copy_options::overwrite_existing);
+
+        std::error_code ec;
+        std::filesystem::rename(pending, entry, ec);
+        if (ec)
+        {
+            RemoveFile(pending);
+            THROW_WIN32_MSG(ec.value(), "Failed to add installer to cache");
+        }
+
+        TouchEntry(entry);
+        AICLI_LOG(Core, Info, << "Added installer to cache: " << entry);
+
+        Trim();
+    }
+
+    void InstallerCache::Trim() const
+    {
+        struct Entry
+        {
+            std::filesystem::path Path;
+            std::filesystem::file_time_type LastUsed;
+            uint64_t Size;
+        };
+
+        std::vector<Entry> entries;
+        uint64_t totalSize = 0;
+
+        std::error_code ec;
+        for (const auto& file : std::filesystem::directory_iterator{ m_root, ec })
+        {
+            if (file.is_regular_file(ec) && IsEntryName(file.path()))
+            {
+                Entry entry{ file.path(), file.last_write_time(ec), file.file_size(ec) };
+                if (!ec)
+                {
+                    totalSize += entry.Size;
+                    entries.emplace_back(std::move(entry));
+                }
+            }
+        }
+
+        if (totalSize <= m_maximumSizeInBytes)
+        {
+            return;
+        }
+
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.LastUsed < b.LastUsed; });
+
+        for (const auto& entry : entries)
+        {
+            if (totalSize <= m_maximumSizeInBytes)
+            {
+                break;
+            }
+
+            // An entry in use by another installation cannot be removed; it is skipped until a later trim.
+            if (std::filesystem::remove(entry.Path, ec))
+            {
+                AICLI_LOG(Core, Verbose, << "Removed installer from cache: " << entry.Path);
+                totalSize -= entry.Size;
+            }
+        }
+    }
+
+    std::filesystem::path InstallerCache::GetEntryPath(const SHA256::HashBuffer& hash) const
+    {
+        return m_root / SHA256::ConvertToString(hash);
+    }
+}
@@ -54,6 +54,89 @@ namespace AppInstaller::Locale
                 InterlockedExchangePointer(reinterpret_cast<PVOID*>(&g_bcp47), module);
             }
         }
+
+        GetDistanceOfClosestLanguageInListFunc GetDistanceFunction()
+        {
+            static GetDistanceOfClosestLanguageInListFunc s_func = []() -> GetDistanceOfClosestLanguageInListFunc
+            {
+                // Before new SDK is released, we need to use LoadLibrary/GetProcAddress
+                InitializeBcp47Module();
+
+                if (g_bcp47 == nullptr)
+                {
+                    return nullptr;
+                }
+
+                return (GetDistanceOfClosestLanguageInListFunc)(GetProcAddress(g_bcp47, "GetDistanceOfClosestLanguageInList"));
+            }();
+
+            return s_func;
+        }
+
+        // Holds the distance between each pair of tags that has been compared.
+        // The same few tags (the preferred languages and those of the manifests being considered) are compared
+        // for every installer and localization, so after the first comparison of a pair no conversion or call is needed.
+        struct LanguageDistanceCache
+        {
+            double GetDistance(std::string_view target, std::string_view available, GetDistanceOfClosestLanguageInListFunc func)
+            {
+                {
+                    std::shared_lock<std::shared_mutex> lock{ m_lock };
+
+                    auto targetItr = m_tags.find(target);
+                    auto availableItr = m_tags.find(available);
+                    if (targetItr != m_tags.end() && availableItr != m_tags.end())
+                    {
+                        auto distanceItr = m_distances.find(GetKey(targetItr->second, availableItr->second));
+                        if (distanceItr != m_distances.end())
+                        {
+                            return distanceItr->second;
+                        }
+                    }
+                }
+
+                std::unique_lock<std::shared_mutex> lock{ m_lock };
+
+                const Tag& targetTag = Intern(target);
+                const Tag& availableTag = Intern(available);
+
+                auto [distanceItr, inserted] = m_distances.emplace(GetKey(targetTag, availableTag), 0.0);
+                if (inserted)
+                {
+                    // Do not check HRESULT because the method returns ERROR_NO_MATCH on no match, which is a valid case.
+                    (void)func(targetTag.Value.c_str(), availableTag.Value.c_str(), L';' /* Not used, we compare one at a time */, &distanceItr->second);
+                }
+
+                return distanceItr->second;
+            }
+
+        private:
+            struct Tag
+            {
+                uint32_t Id;
+                std::wstring Value;
+            };
+
+            static uint64_t GetKey(const Tag& target, const Tag& available)
+            {
+                return (static_cast<uint64_t>(target.Id) << 32) | available.Id;
+            }
+
+            const Tag& Intern(std::string_view tag)
+            {
+                auto itr = m_tags.find(tag);
+                if (itr == m_tags.end())
+                {
+                    itr = m_tags.emplace(std::string{ tag }, Tag{ static_cast<uint32_t>(m_tags.size()), Utility::ConvertToUTF16(tag) }).first;
+                }
+
+                return itr->second;
+            }
+
+            std::shared_mutex m_lock;
+            std::map<std::string, Tag, std::less<>> m_tags;
+            std::unordered_map<uint64_t, double> m_distances;
+        };
     }
 
     bool IsWellFormedBcp47Tag(std::string_view bcp47Tag)
@@ -81,43 +164,33 @@ namespace AppInstaller::Locale
 
     double GetDistanceOfLanguage(std::string_view target, std::string_view available)
     {
-        // Before new SDK is released, we need to use LoadLibrary/GetProcAddress
-        InitializeBcp47Module();
-
-        if (g_bcp47 == nullptr)
+        GetDistanceOfClosestLanguageInListFunc func = GetDistanceFunction();
+        if (func == nullptr)
         {
             // Didn't find an implementation. Just return 0 as no match.
             AICLI_LOG(Core, Warning, << "bcp47 module not found.");
             return 0;
         }
 
-        GetDistanceOfClosestLanguageInListFunc func =
-            (GetDistanceOfClosestLanguageInListFunc)(GetProcAddress(g_bcp47, "GetDistanceOfClosestLanguageInList"));
-        if (func != nullptr)
-        {
-            double distance = 0;
-            auto wTarget = Utility::ConvertToUTF16(target);
-            auto wAvailable = Utility::ConvertToUTF16(available);
-
-            // Do not check HRESULT because the method returns ERROR_NO_MATCH on no match, which is a valid case.
-            (void)func(wTarget.c_str(), wAvailable.c_str(), L';' /* Not used, we compare one at a time */, &distance);
-            return distance;
-        }
-
-        // Should not reach here.
-        return 0;
+        static LanguageDistanceCache s_cache;
+        return s_cache.GetDistance(target, available, func);
     }
 
-    std::vector<std::string> GetUserPreferredLanguages()
+    const std::vector<std::string>& GetUserPreferredLanguages()
     {
-        std::vector<std::string> result;
-
-        for (const auto& lang : winrt::Windows::System::UserProfile::GlobalizationPreferences::Languages())
+        static const std::vector<std::string> s_languages = []()
         {
-            result.emplace_back(Utility::ConvertToUTF8(lang));
-        }
+            std::vector<std::string> result;
+
+            for (const auto& lang : winrt::Windows::System::UserProfile::GlobalizationPreferences::Languages())
+            {
+                result.emplace_back(Utility::ConvertToUTF8(lang));
+            }
+
+            return result;
+        }();
 
-        return result;
+        return s_languages;
     }
 
     std::string LocaleIdToBcp47Tag(LCID localeId)
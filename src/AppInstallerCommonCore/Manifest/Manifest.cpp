@@ -12,16 +12,14 @@ namespace AppInstaller::Manifest
         CurrentLocalization = DefaultLocalization;
 
         // Get target locale from Preferred Languages settings if applicable
-        std::vector<std::string> targetLocales;
-        if (locale.empty())
+        std::vector<std::string> requestedLocale;
+        if (!locale.empty())
         {
-            targetLocales = Locale::GetUserPreferredLanguages();
-        }
-        else
-        {
-            targetLocales.emplace_back(locale);
+            requestedLocale.emplace_back(locale);
         }
 
+        const std::vector<std::string>& targetLocales = (locale.empty() ? Locale::GetUserPreferredLanguages() : requestedLocale);
+
         for (auto const& targetLocale : targetLocales)
         {
             const ManifestLocalization* bestLocalization = nullptr;
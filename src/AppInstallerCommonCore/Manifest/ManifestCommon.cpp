@@ -446,49 +446,66 @@ namespace AppInstaller::Manifest
         return set1 == set2;
     }
 
-    std::map<InstallerSwitchType, Utility::NormalizedString> GetDefaultKnownSwitches(InstallerTypeEnum installerType)
+    const std::map<InstallerSwitchType, Utility::NormalizedString>& GetDefaultKnownSwitches(InstallerTypeEnum installerType)
     {
+        using switches_t = std::map<InstallerSwitchType, Utility::NormalizedString>;
+
         switch (installerType)
         {
         case InstallerTypeEnum::Burn:
         case InstallerTypeEnum::Wix:
         case InstallerTypeEnum::Msi:
-            return
+        {
+            static const switches_t s_switches
             {
                 {InstallerSwitchType::Silent, ManifestInstaller::string_t("/quiet")},
                 {InstallerSwitchType::SilentWithProgress, ManifestInstaller::string_t("/passive")},
                 {InstallerSwitchType::Log, ManifestInstaller::string_t("/log \"" + std::string(ARG_TOKEN_LOGPATH) + "\"")},
                 {InstallerSwitchType::InstallLocation, ManifestInstaller::string_t("TARGETDIR=\"" + std::string(ARG_TOKEN_INSTALLPATH) + "\"")}
             };
+            return s_switches;
+        }
         case InstallerTypeEnum::Nullsoft:
-            return
+        {
+            static const switches_t s_switches
             {
                 {InstallerSwitchType::Silent, ManifestInstaller::string_t("/S")},
                 {InstallerSwitchType::SilentWithProgress, ManifestInstaller::string_t("/S")},
                 {InstallerSwitchType::InstallLocation, ManifestInstaller::string_t("/D=" + std::string(ARG_TOKEN_INSTALLPATH))}
             };
+            return s_switches;
+        }
         case InstallerTypeEnum::Inno:
-            return
+        {
+            static const switches_t s_switches
             {
                 {InstallerSwitchType::Silent, ManifestInstaller::string_t("/VERYSILENT")},
                 {InstallerSwitchType::SilentWithProgress, ManifestInstaller::string_t("/SILENT")},
                 {InstallerSwitchType::Log, ManifestInstaller::string_t("/LOG=\"" + std::string(ARG_TOKEN_LOGPATH) + "\"")},
                 {InstallerSwitchType::InstallLocation, ManifestInstaller::string_t("/DIR=\"" + std::string(ARG_TOKEN_INSTALLPATH) + "\"")}
             };
+            return s_switches;
+        }
         default:
-            return {};
+        {
+            static const switches_t s_switches;
+            return s_switches;
+        }
         }
     }
 
-    std::map<DWORD, ExpectedReturnCodeEnum> GetDefaultKnownReturnCodes(InstallerTypeEnum installerType)
+    const std::map<DWORD, ExpectedReturnCodeEnum>& GetDefaultKnownReturnCodes(InstallerTypeEnum installerType)
     {
+        using returnCodes_t = std::map<DWORD, ExpectedReturnCodeEnum>;
+
         switch (installerType)
         {
         case InstallerTypeEnum::Burn:
         case InstallerTypeEnum::Wix:
         case InstallerTypeEnum::Msi:
+        {
             // See https://docs.microsoft.com/windows/win32/msi/error-codes
-            return
+            static const returnCodes_t s_returnCodes
             {
                 { ERROR_INSTALL_ALREADY_RUNNING, ExpectedReturnCodeEnum::InstallInProgress },
                 { ERROR_DISK_FULL, ExpectedReturnCodeEnum::DiskFull },
@@ -499,17 +516,23 @@ namespace AppInstaller::Manifest
                 { ERROR_PRODUCT_VERSION, ExpectedReturnCodeEnum::AlreadyInstalled },
                 { ERROR_INSTALL_REJECTED, ExpectedReturnCodeEnum::BlockedByPolicy },
             };
+            return s_returnCodes;
+        }
         case InstallerTypeEnum::Inno:
+        {
             // See https://jrsoftware.org/ishelp/index.php?topic=setupexitcodes
-            return
+            static const returnCodes_t s_returnCodes
             {
                 { 2, ExpectedReturnCodeEnum::CancelledByUser },
                 { 5, ExpectedReturnCodeEnum::CancelledByUser },
                 { 8, ExpectedReturnCodeEnum::RebootRequiredForInstall },
             };
+            return s_returnCodes;
+        }
         case InstallerTypeEnum::Msix:
+        {
             // See https://docs.microsoft.com/en-us/windows/win32/appxpkg/troubleshooting
-            return
+            static const returnCodes_t s_returnCodes
             {
                 { HRESULT_FROM_WIN32(ERROR_INSTALL_PREREQUISITE_FAILED), ExpectedReturnCodeEnum::MissingDependency },
                 { HRESULT_FROM_WIN32(ERROR_INSTALL_RESOLVE_DEPENDENCY_FAILED), ExpectedReturnCodeEnum::MissingDependency },
@@ -519,8 +542,13 @@ namespace AppInstaller::Manifest
                 { HRESULT_FROM_WIN32(ERROR_PACKAGE_ALREADY_EXISTS), ExpectedReturnCodeEnum::AlreadyInstalled },
                 { HRESULT_FROM_WIN32(ERROR_INSTALL_PACKAGE_DOWNGRADE), ExpectedReturnCodeEnum::Downgrade },
             };
+            return s_returnCodes;
+        }
         default:
-            return {};
+        {
+            static const returnCodes_t s_returnCodes;
+            return s_returnCodes;
+        }
         }
     }
 
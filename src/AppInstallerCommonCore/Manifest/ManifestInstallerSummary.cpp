@@ -0,0 +1,138 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "winget/ManifestInstallerSummary.h"
+
+namespace AppInstaller::Manifest
+{
+    namespace
+    {
+        constexpr char s_InstallerSeparator = ';';
+        constexpr char s_FieldSeparator = '|';
+        constexpr char s_ListSeparator = ',';
+        constexpr size_t s_FieldCount = 6;
+
+        std::vector<std::string_view> SplitView(std::string_view value, char separator)
+        {
+            std::vector<std::string_view> result;
+
+            size_t start = 0;
+            for (size_t pos = value.find(separator); pos != std::string_view::npos; pos = value.find(separator, start))
+            {
+                result.emplace_back(value.substr(start, pos - start));
+                start = pos + 1;
+            }
+
+            result.emplace_back(value.substr(start));
+            return result;
+        }
+
+        void AppendList(std::string& out, const std::vector<string_t>& values)
+        {
+            bool first = true;
+            for (const auto& value : values)
+            {
+                if (!first)
+                {
+                    out += s_ListSeparator;
+                }
+
+                out += value;
+                first = false;
+            }
+        }
+
+        std::vector<string_t> ParseList(std::string_view value)
+        {
+            std::vector<string_t> result;
+
+            if (!value.empty())
+            {
+                for (std::string_view item : SplitView(value, s_ListSeparator))
+                {
+                    result.emplace_back(item);
+                }
+            }
+
+            return result;
+        }
+
+        std::string CreateInstallerEntry(const ManifestInstaller& installer)
+        {
+            std::string result;
+
+            result += Utility::ToString(installer.Arch);
+            result += s_FieldSeparator;
+            result += InstallerTypeToString(installer.InstallerType);
+            result += s_FieldSeparator;
+            result += ScopeToString(installer.Scope);
+            result += s_FieldSeparator;
+            result += installer.MinOSVersion;
+            result += s_FieldSeparator;
+            AppendList(result, installer.Markets.AllowedMarkets);
+            result += s_FieldSeparator;
+            AppendList(result, installer.Markets.ExcludedMarkets);
+
+            return result;
+        }
+    }
+
+    std::string CreateInstallerSummary(const Manifest& manifest)
+    {
+        std::vector<std::string> entries;
+
+        for (const auto& installer : manifest.Installers)
+        {
+            std::string entry = CreateInstallerEntry(installer);
+            if (std::find(entries.begin(), entries.end(), entry) == entries.end())
+            {
+                entries.emplace_back(std::move(entry));
+            }
+        }
+
+        std::string result;
+        for (const auto& entry : entries)
+        {
+            if (!result.empty())
+            {
+                result += s_InstallerSeparator;
+            }
+
+            result += entry;
+        }
+
+        return result;
+    }
+
+    std::vector<ManifestInstaller> ParseInstallerSummary(std::string_view summary)
+    {
+        std::vector<ManifestInstaller> result;
+
+        if (summary.empty())
+        {
+            return result;
+        }
+
+        for (std::string_view entry : SplitView(summary, s_InstallerSeparator))
+        {
+            std::vector<std::string_view> fields = SplitView(entry, s_FieldSeparator);
+            if (fields.size() != s_FieldCount)
+            {
+                AICLI_LOG(Core, Warning, << "Installer summary entry is not valid: " << entry);
+                return {};
+            }
+
+            ManifestInstaller installer;
+            installer.Arch = Utility::ConvertToArchitectureEnum(std::string{ fields[0] });
+            installer.InstallerType = ConvertToInstallerTypeEnum(std::string{ fields[1] });
+            installer.Scope = ConvertToScopeEnum(fields[2]);
+            installer.MinOSVersion = fields[3];
+            installer.Markets.AllowedMarkets = ParseList(fields[4]);
+            installer.Markets.ExcludedMarkets = ParseList(fields[5]);
+
+            result.emplace_back(std::move(installer));
+        }
+
+        return result;
+    }
+}
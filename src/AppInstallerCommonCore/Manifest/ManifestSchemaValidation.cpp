@@ -1,11 +1,13 @@
 // Copyright (c) Microsoft Corporation.
 // Licensed under the MIT License.
 #include "pch.h"
+#include "AppInstallerSynchronization.h"
 #include "winget/Yaml.h"
 #include "winget/JsonSchemaValidation.h"
 #include "winget/ManifestCommon.h"
 #include "winget/ManifestSchemaValidation.h"
 #include "winget/ManifestYamlParser.h"
+#include "YamlSchemaAdapter.h"
 
 #include <ManifestSchema.h>
 
@@ -15,24 +17,19 @@ namespace AppInstaller::Manifest::YamlParser
 
     namespace
     {
-        enum class YamlScalarType
-        {
-            String,
-            Int,
-            Bool
-        };
+        using JsonSchema::Yaml::ScalarType;
 
         // List of fields that use non string scalar types
-        const std::map<std::string_view, YamlScalarType> ManifestFieldTypes=
+        const std::map<std::string_view, ScalarType> ManifestFieldTypes=
         {
-            { "InstallerSuccessCodes"sv, YamlScalarType::Int },
-            { "InstallerAbortsTerminal"sv, YamlScalarType::Bool },
-            { "InstallLocationRequired"sv, YamlScalarType::Bool },
-            { "RequireExplicitUpgrade"sv, YamlScalarType::Bool },
-            { "InstallerReturnCode"sv, YamlScalarType::Int },
+            { "InstallerSuccessCodes"sv, ScalarType::Int },
+            { "InstallerAbortsTerminal"sv, ScalarType::Bool },
+            { "InstallLocationRequired"sv, ScalarType::Bool },
+            { "RequireExplicitUpgrade"sv, ScalarType::Bool },
+            { "InstallerReturnCode"sv, ScalarType::Int },
         };
 
-        YamlScalarType GetManifestScalarValueType(const std::string& key)
+        ScalarType GetManifestScalarValueType(std::string_view key)
         {
             auto iter = ManifestFieldTypes.find(key);
             if (iter != ManifestFieldTypes.end())
@@ -40,144 +37,110 @@ namespace AppInstaller::Manifest::YamlParser
                 return iter->second;
             }
 
-            return YamlScalarType::String;
+            return ScalarType::String;
         }
 
-        Json::Value YamlScalarNodeToJson(const YAML::Node& scalarNode, YamlScalarType scalarType)
+        int GetSchemaResourceId(const ManifestVer& manifestVersion, ManifestTypeEnum manifestType)
         {
-            if (scalarType == YamlScalarType::Int)
+            if (manifestVersion >= ManifestVer{ s_ManifestVersionV1_1 })
             {
-                return Json::Value(scalarNode.as<int>());
+                switch (manifestType)
+                {
+                case AppInstaller::Manifest::ManifestTypeEnum::Singleton:
+                    return IDX_MANIFEST_SCHEMA_V1_1_SINGLETON;
+                case AppInstaller::Manifest::ManifestTypeEnum::Version:
+                    return IDX_MANIFEST_SCHEMA_V1_1_VERSION;
+                case AppInstaller::Manifest::ManifestTypeEnum::Installer:
+                    return IDX_MANIFEST_SCHEMA_V1_1_INSTALLER;
+                case AppInstaller::Manifest::ManifestTypeEnum::DefaultLocale:
+                    return IDX_MANIFEST_SCHEMA_V1_1_DEFAULTLOCALE;
+                case AppInstaller::Manifest::ManifestTypeEnum::Locale:
+                    return IDX_MANIFEST_SCHEMA_V1_1_LOCALE;
+                default:
+                    THROW_HR(HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
+                }
             }
-            else if (scalarType == YamlScalarType::Bool)
+            else if (manifestVersion >= ManifestVer{ s_ManifestVersionV1 })
             {
-                return Json::Value(scalarNode.as<bool>());
+                switch (manifestType)
+                {
+                case AppInstaller::Manifest::ManifestTypeEnum::Singleton:
+                    return IDX_MANIFEST_SCHEMA_V1_SINGLETON;
+                case AppInstaller::Manifest::ManifestTypeEnum::Version:
+                    return IDX_MANIFEST_SCHEMA_V1_VERSION;
+                case AppInstaller::Manifest::ManifestTypeEnum::Installer:
+                    return IDX_MANIFEST_SCHEMA_V1_INSTALLER;
+                case AppInstaller::Manifest::ManifestTypeEnum::DefaultLocale:
+                    return IDX_MANIFEST_SCHEMA_V1_DEFAULTLOCALE;
+                case AppInstaller::Manifest::ManifestTypeEnum::Locale:
+                    return IDX_MANIFEST_SCHEMA_V1_LOCALE;
+                default:
+                    THROW_HR(HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
+                }
             }
             else
             {
-                return Json::Value(scalarNode.as<std::string>());
+                return IDX_MANIFEST_SCHEMA_PREVIEW;
             }
         }
 
-        Json::Value ManifestYamlNodeToJson(const YAML::Node& rootNode, YamlScalarType scalarType = YamlScalarType::String)
+        // Compiled schemas are kept for the lifetime of the process, since every manifest of a version and type is validated against the same schema.
+        // They are never removed, so references to them remain valid.
+        const valijson::Schema& GetCompiledSchema(const ManifestVer& manifestVersion, ManifestTypeEnum manifestType)
         {
-            Json::Value result;
+            static std::mutex s_lock;
+            static std::map<int, std::unique_ptr<valijson::Schema>> s_schemas;
 
-            if (rootNode.IsNull())
-            {
-                result = Json::Value::nullSingleton();
-            }
-            else if (rootNode.IsMap())
-            {
-                for (auto const& keyValuePair : rootNode.Mapping())
-                {
-                    // We only support string type as key in our manifest
-                    auto key = keyValuePair.first.as<std::string>();
-                    result[keyValuePair.first.as<std::string>()] = ManifestYamlNodeToJson(keyValuePair.second, GetManifestScalarValueType(key));
-                }
-            }
-            else if (rootNode.IsSequence())
-            {
-                for (auto const& value : rootNode.Sequence())
-                {
-                    result.append(ManifestYamlNodeToJson(value, scalarType));
-                }
-            }
-            else if (rootNode.IsScalar())
-            {
-                result = YamlScalarNodeToJson(rootNode, scalarType);
-            }
-            else
+            int resourceId = GetSchemaResourceId(manifestVersion, manifestType);
+
+            std::lock_guard<std::mutex> lock{ s_lock };
+
+            auto itr = s_schemas.find(resourceId);
+            if (itr == s_schemas.end())
             {
-                THROW_HR(E_UNEXPECTED);
+                // Copy constructor of valijson::Schema was private
+                auto schema = std::make_unique<valijson::Schema>();
+                JsonSchema::PopulateSchema(LoadSchemaDoc(manifestVersion, manifestType), *schema);
+                itr = s_schemas.emplace(resourceId, std::move(schema)).first;
             }
 
-            return result;
+            return *itr->second;
         }
     }
 
     Json::Value LoadSchemaDoc(const ManifestVer& manifestVersion, ManifestTypeEnum manifestType)
     {
-        std::string schemaStr;
-
-        if (manifestVersion >= ManifestVer{ s_ManifestVersionV1_1 })
-        {
-            switch (manifestType)
-            {
-            case AppInstaller::Manifest::ManifestTypeEnum::Singleton:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_1_SINGLETON), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            case AppInstaller::Manifest::ManifestTypeEnum::Version:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_1_VERSION), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            case AppInstaller::Manifest::ManifestTypeEnum::Installer:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_1_INSTALLER), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            case AppInstaller::Manifest::ManifestTypeEnum::DefaultLocale:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_1_DEFAULTLOCALE), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            case AppInstaller::Manifest::ManifestTypeEnum::Locale:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_1_LOCALE), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            default:
-                THROW_HR(HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
-            }
-        }
-        else if (manifestVersion >= ManifestVer{ s_ManifestVersionV1 })
-        {
-            switch (manifestType)
-            {
-            case AppInstaller::Manifest::ManifestTypeEnum::Singleton:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_SINGLETON), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            case AppInstaller::Manifest::ManifestTypeEnum::Version:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_VERSION), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            case AppInstaller::Manifest::ManifestTypeEnum::Installer:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_INSTALLER), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            case AppInstaller::Manifest::ManifestTypeEnum::DefaultLocale:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_DEFAULTLOCALE), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            case AppInstaller::Manifest::ManifestTypeEnum::Locale:
-                schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_V1_LOCALE), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-                break;
-            default:
-                THROW_HR(HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
-            }
-        }
-        else
-        {
-            schemaStr = JsonSchema::LoadResourceAsString(MAKEINTRESOURCE(IDX_MANIFEST_SCHEMA_PREVIEW), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
-        }
-
-        return JsonSchema::LoadSchemaDoc(schemaStr);
+        return JsonSchema::LoadResourceAsSchemaDoc(MAKEINTRESOURCE(GetSchemaResourceId(manifestVersion, manifestType)), MAKEINTRESOURCE(MANIFESTSCHEMA_RESOURCE_TYPE));
     }
 
     std::vector<ValidationError> ValidateAgainstSchema(const std::vector<YamlManifestInfo>& manifestList, const ManifestVer& manifestVersion)
     {
-        std::vector<ValidationError> errors;
-        // A list of schema validator to avoid multiple loadings of same schema
-        std::map<ManifestTypeEnum, valijson::Schema> schemaList;
+        // The files are validated concurrently, with the results kept in the order of the list.
+        std::vector<std::optional<ValidationError>> results(manifestList.size());
 
-        for (const auto& entry : manifestList)
-        {
-            if (schemaList.find(entry.ManifestType) == schemaList.end())
+        Synchronization::RunConcurrently(manifestList.size(), [&](size_t i)
             {
-                // Copy constructor of valijson::Schema was private
-                valijson::Schema& newSchema = schemaList.emplace(
-                    std::piecewise_construct, std::make_tuple(entry.ManifestType), std::make_tuple()).first->second;
-                Json::Value schemaJson = LoadSchemaDoc(manifestVersion, entry.ManifestType);
-                JsonSchema::PopulateSchema(schemaJson, newSchema);
-            }
+                const auto& entry = manifestList[i];
+                const auto& schema = GetCompiledSchema(manifestVersion, entry.ManifestType);
+                valijson::ValidationResults validationResults;
 
-            const auto& schema = schemaList.find(entry.ManifestType)->second;
-            Json::Value manifestJson = ManifestYamlNodeToJson(entry.Root);
-            valijson::ValidationResults results;
+                // The YAML is validated directly, rather than after converting it to json
+                valijson::Validator schemaValidator;
+                JsonSchema::Yaml::YamlAdapter manifestAdapter(entry.Root, GetManifestScalarValueType);
 
-            if (!JsonSchema::Validate(schema, manifestJson, results))
+                if (!schemaValidator.validate(schema, manifestAdapter, &validationResults))
+                {
+                    results[i] = ValidationError::MessageWithFile(JsonSchema::GetErrorStringFromResults(validationResults), entry.FileName);
+                }
+            });
+
+        std::vector<ValidationError> errors;
+
+        for (auto& result : results)
+        {
+            if (result)
             {
-                errors.emplace_back(ValidationError::MessageWithFile(JsonSchema::GetErrorStringFromResults(results), entry.FileName));
+                errors.emplace_back(std::move(result.value()));
             }
         }
 
@@ -500,9 +500,31 @@ namespace AppInstaller::Manifest
         return result;
     }
 
+    ManifestYamlPopulator::FieldProcessInfoTable::FieldProcessInfoTable(std::vector<FieldProcessInfo>&& fields) :
+        m_fields(std::move(fields))
+    {
+        // The views reference the names held by m_fields, which is not modified after this.
+        m_index.reserve(m_fields.size());
+        for (size_t i = 0; i < m_fields.size(); ++i)
+        {
+            m_index.emplace(m_fields[i].LowerName, i);
+        }
+    }
+
+    std::optional<size_t> ManifestYamlPopulator::FieldProcessInfoTable::Find(std::string_view lowerName) const
+    {
+        auto itr = m_index.find(lowerName);
+        if (itr == m_index.end())
+        {
+            return {};
+        }
+
+        return itr->second;
+    }
+
     ValidationErrors ManifestYamlPopulator::ValidateAndProcessFields(
         const YAML::Node& rootNode,
-        const std::vector<FieldProcessInfo>& fieldInfos)
+        const FieldProcessInfoTable& fieldInfos)
     {
         ValidationErrors resultErrors;
 
@@ -512,8 +534,9 @@ namespace AppInstaller::Manifest
             return resultErrors;
         }
 
-        // Keeps track of already processed fields. Used to check duplicate fields.
-        std::set<std::string> processedFields;
+        // Keeps track of already processed fields by their index. Used to check duplicate fields.
+        std::vector<bool> processedFields(fieldInfos.size());
+        std::string lowerKeyBuffer;
 
         for (auto const& keyValuePair : rootNode.Mapping())
         {
@@ -521,15 +544,11 @@ namespace AppInstaller::Manifest
             const YAML::Node& valueNode = keyValuePair.second;
 
             // We'll do case insensitive search first and validate correct case later.
-            auto fieldIter = std::find_if(fieldInfos.begin(), fieldInfos.end(),
-                [&](auto const& s)
-                {
-                    return Utility::CaseInsensitiveEquals(s.Name, key);
-                });
+            std::optional<size_t> fieldIndex = fieldInfos.Find(Utility::ToLower(key, lowerKeyBuffer));
 
-            if (fieldIter != fieldInfos.end())
+            if (fieldIndex)
             {
-                const FieldProcessInfo& fieldInfo = *fieldIter;
+                const FieldProcessInfo& fieldInfo = fieldInfos[fieldIndex.value()];
 
                 // Make sure the found key is in Pascal Case
                 if (key != fieldInfo.Name)
@@ -538,10 +557,11 @@ namespace AppInstaller::Manifest
                 }
 
                 // Make sure it's not a duplicate key
-                if (!processedFields.insert(fieldInfo.Name).second)
+                if (processedFields[fieldIndex.value()])
                 {
                     resultErrors.emplace_back(ManifestError::FieldDuplicate, fieldInfo.Name, "", m_isMergedManifest ? 0 : keyValuePair.first.Mark().line, m_isMergedManifest ? 0 : keyValuePair.first.Mark().column);
                 }
+                processedFields[fieldIndex.value()] = true;
 
                 if (fieldInfo.RequireVerifiedPublisher)
                 {
@@ -707,16 +727,33 @@ namespace AppInstaller::Manifest
         }
 
         // Populate installers
+        // The defaults for PackageFamilyName, ProductCode, AppsAndFeaturesEntries need to be copied based on InstallerType,
+        // and installer dependencies override the root ones; hold them aside so that copying the defaults for each installer
+        // does not copy values that would only be thrown away.
+        ManifestInstaller& defaultInstaller = manifest.DefaultInstallerInfo;
+        ManifestInstaller::string_t defaultPackageFamilyName = std::move(defaultInstaller.PackageFamilyName);
+        ManifestInstaller::string_t defaultProductCode = std::move(defaultInstaller.ProductCode);
+        std::vector<AppsAndFeaturesEntry> defaultAppsAndFeaturesEntries = std::move(defaultInstaller.AppsAndFeaturesEntries);
+        DependencyList defaultDependencies = std::move(defaultInstaller.Dependencies);
+
+        defaultInstaller.PackageFamilyName.clear();
+        defaultInstaller.ProductCode.clear();
+        defaultInstaller.AppsAndFeaturesEntries.clear();
+        defaultInstaller.Dependencies.Clear();
+
+        auto restoreDefaults = wil::scope_exit([&]()
+            {
+                defaultInstaller.PackageFamilyName = std::move(defaultPackageFamilyName);
+                defaultInstaller.ProductCode = std::move(defaultProductCode);
+                defaultInstaller.AppsAndFeaturesEntries = std::move(defaultAppsAndFeaturesEntries);
+                defaultInstaller.Dependencies = std::move(defaultDependencies);
+            });
+
+        manifest.Installers.reserve(manifest.Installers.size() + m_p_installersNode->size());
+
         for (auto const& entry : m_p_installersNode->Sequence())
         {
-            ManifestInstaller installer = manifest.DefaultInstallerInfo;
-
-            // Clear these defaults as PackageFamilyName, ProductCode, AppsAndFeaturesEntries need to be copied based on InstallerType
-            installer.PackageFamilyName.clear();
-            installer.ProductCode.clear();
-            installer.AppsAndFeaturesEntries.clear();
-            // Clear dependencies as installer overrides root dependencies
-            installer.Dependencies.Clear();
+            ManifestInstaller installer = defaultInstaller;
 
             m_p_installer = &installer;
             auto errors = ValidateAndProcessFields(entry, InstallerFieldInfos);
@@ -725,37 +762,33 @@ namespace AppInstaller::Manifest
             // Copy in system reference strings from the root if not set in the installer and appropriate
             if (installer.PackageFamilyName.empty() && DoesInstallerTypeUsePackageFamilyName(installer.InstallerType))
             {
-                installer.PackageFamilyName = manifest.DefaultInstallerInfo.PackageFamilyName;
+                installer.PackageFamilyName = defaultPackageFamilyName;
             }
 
             if (installer.ProductCode.empty() && DoesInstallerTypeUseProductCode(installer.InstallerType))
             {
-                installer.ProductCode = manifest.DefaultInstallerInfo.ProductCode;
+                installer.ProductCode = defaultProductCode;
             }
 
             if (installer.AppsAndFeaturesEntries.empty() && DoesInstallerTypeWriteAppsAndFeaturesEntry(installer.InstallerType))
             {
-                installer.AppsAndFeaturesEntries = manifest.DefaultInstallerInfo.AppsAndFeaturesEntries;
+                installer.AppsAndFeaturesEntries = defaultAppsAndFeaturesEntries;
             }
 
             // If there are no dependencies on installer use default ones
             if (!installer.Dependencies.HasAny())
             {
-                installer.Dependencies = manifest.DefaultInstallerInfo.Dependencies;
+                installer.Dependencies = defaultDependencies;
             }
 
             // Populate installer default switches if not exists
-            auto defaultSwitches = GetDefaultKnownSwitches(installer.InstallerType);
-            for (auto const& defaultSwitch : defaultSwitches)
+            for (auto const& defaultSwitch : GetDefaultKnownSwitches(installer.InstallerType))
             {
-                if (installer.Switches.find(defaultSwitch.first) == installer.Switches.end())
-                {
-                    installer.Switches[defaultSwitch.first] = defaultSwitch.second;
-                }
+                installer.Switches.try_emplace(defaultSwitch.first, defaultSwitch.second);
             }
 
             // Populate installer default return codes if not present in ExpectedReturnCodes and InstallerSuccessCodes
-            auto defaultReturnCodes = GetDefaultKnownReturnCodes(installer.InstallerType);
+            const auto& defaultReturnCodes = GetDefaultKnownReturnCodes(installer.InstallerType);
             for (auto const& defaultReturnCode : defaultReturnCodes)
             {
                 if (installer.ExpectedReturnCodes.find(defaultReturnCode.first) == installer.ExpectedReturnCodes.end() &&
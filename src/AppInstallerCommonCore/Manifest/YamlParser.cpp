@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "AppInstallerSHA256.h"
+#include "AppInstallerSynchronization.h"
+#include "winget/AllocationTracking.h"
 #include "winget/Yaml.h"
 #include "winget/ManifestSchemaValidation.h"
 #include "winget/ManifestYamlPopulator.h"
@@ -329,12 +331,12 @@ namespace AppInstaller::Manifest::YamlParser
             MergeOneManifestToMultiFileManifest(defaultLocaleManifest, result);
 
             // Copy additional locale manifests
-            YAML::Node localizations{ YAML::Node::Type::Sequence, "", YAML::Mark() };
+            YAML::Node localizations{ YAML::Node::Type::Sequence, YAML::Mark() };
             for (const auto& entry : input)
             {
                 if (entry.ManifestType == ManifestTypeEnum::Locale)
                 {
-                    YAML::Node localization{ YAML::Node::Type::Mapping, "", YAML::Mark() };
+                    YAML::Node localization{ YAML::Node::Type::Mapping, YAML::Mark() };
                     MergeOneManifestToMultiFileManifest(entry.Root, localization);
                     localizations.AddSequenceNode(std::move(localization));
                 }
@@ -342,7 +344,7 @@ namespace AppInstaller::Manifest::YamlParser
 
             if (localizations.size() > 0)
             {
-                YAML::Node key{ YAML::Node::Type::Scalar, "", YAML::Mark() };
+                YAML::Node key{ YAML::Node::Type::Scalar, YAML::Mark() };
                 key.SetScalar("Localization");
                 result.AddMappingNode(std::move(key), std::move(localizations));
             }
@@ -466,15 +468,20 @@ namespace AppInstaller::Manifest::YamlParser
         {
             if (std::filesystem::is_directory(inputPath))
             {
+                std::vector<std::filesystem::path> files;
                 for (const auto& file : std::filesystem::directory_iterator(inputPath))
                 {
                     THROW_HR_IF_MSG(HRESULT_FROM_WIN32(ERROR_DIRECTORY_NOT_SUPPORTED), std::filesystem::is_directory(file.path()), "Subdirectory not supported in manifest path");
-
-                    YamlManifestInfo doc;
-                    doc.Root = YAML::Load(file.path());
-                    doc.FileName = file.path().filename().u8string();
-                    docList.emplace_back(std::move(doc));
+                    files.emplace_back(file.path());
                 }
+
+                // The files are independent until they are merged, so they are loaded concurrently into their place in the list.
+                docList.resize(files.size());
+                Synchronization::RunConcurrently(files.size(), [&](size_t i)
+                    {
+                        docList[i].Root = YAML::Load(files[i]);
+                        docList[i].FileName = files[i].filename().u8string();
+                    });
             }
             else
             {
@@ -518,6 +525,8 @@ namespace AppInstaller::Manifest::YamlParser
         ManifestValidateOption validateOption,
         const std::filesystem::path& mergedManifestPath)
     {
+        Memory::AllocationScope allocationScope{ Memory::AllocationSubsystem::Yaml };
+
         Manifest manifest;
         std::vector<ValidationError> errors;
 
@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Public/winget/MemoryTrim.h"
+#include "Public/AppInstallerLogging.h"
+#include "Public/AppInstallerTelemetry.h"
+
+#include <Psapi.h>
+
+namespace AppInstaller::Memory
+{
+    namespace
+    {
+        std::mutex s_TrimFunctionsLock;
+        std::vector<std::function<void()>> s_TrimFunctions;
+
+        // The times, as steady clock ticks, of the latest activity and of the latest trim.
+        std::atomic<std::chrono::steady_clock::rep> s_LastActivity = 0;
+        std::atomic<std::chrono::steady_clock::rep> s_LastTrim = 0;
+
+        std::chrono::milliseconds s_IdlePeriod{};
+
+        std::chrono::steady_clock::rep Now()
+        {
+            return std::chrono::steady_clock::now().time_since_epoch().count();
+        }
+
+        uint64_t GetWorkingSetSize()
+        {
+            PROCESS_MEMORY_COUNTERS counters{};
+            counters.cb = sizeof(counters);
+            return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.WorkingSetSize : 0;
+        }
+
+        void CALLBACK IdleTrimCallback(PTP_CALLBACK_INSTANCE, PVOID, PTP_TIMER)
+        {
+            try
+            {
+                auto lastActivity = s_LastActivity.load();
+                auto idleFor = std::chrono::steady_clock::duration{ Now() - lastActivity };
+
+                // Only trim once per idle period; nothing was recreated since the last trim without activity
+                if (idleFor >= s_IdlePeriod && s_LastTrim.load() <= lastActivity)
+                {
+                    s_LastTrim = Now();
+                    AICLI_LOG(Core, Info, << "Trimming memory after being idle for " << std::chrono::duration_cast<std::chrono::seconds>(idleFor).count() << " seconds");
+                    Trim();
+                }
+            }
+            CATCH_LOG();
+        }
+    }
+
+    void RegisterTrimFunction(std::function<void()> trimFunction)
+    {
+        std::lock_guard<std::mutex> lock{ s_TrimFunctionsLock };
+        s_TrimFunctions.emplace_back(std::move(trimFunction));
+    }
+
+    void Trim()
+    {
+        std::vector<std::function<void()>> trimFunctions;
+        {
+            std::lock_guard<std::mutex> lock{ s_TrimFunctionsLock };
+            trimFunctions = s_TrimFunctions;
+        }
+
+        uint64_t workingSetBefore = GetWorkingSetSize();
+
+        for (const auto& trimFunction : trimFunctions)
+        {
+            try
+            {
+                trimFunction();
+            }
+            CATCH_LOG();
+        }
+
+        // The result is the largest free block, which is not needed
+        HeapCompact(GetProcessHeap(), 0);
+        LOG_IF_WIN32_BOOL_FALSE(SetProcessWorkingSetSizeEx(GetCurrentProcess(), static_cast<SIZE_T>(-1), static_cast<SIZE_T>(-1), 0));
+
+        Logging::Telemetry().LogMemoryTrim(trimFunctions.size(), workingSetBefore, GetWorkingSetSize());
+    }
+
+    void NotifyActivity()
+    {
+        s_LastActivity = Now();
+    }
+
+    void EnableIdleTrim(std::chrono::milliseconds idlePeriod)
+    {
+        static std::once_flag s_enableOnce;
+        std::call_once(s_enableOnce, [&]()
+            {
+                s_IdlePeriod = idlePeriod;
+                NotifyActivity();
+
+                // Intentionally never closed, as the process may be unloading by the time a static would be destroyed.
+                PTP_TIMER timer = CreateThreadpoolTimer(IdleTrimCallback, nullptr, nullptr);
+                THROW_LAST_ERROR_IF_NULL(timer);
+
+                // The timer checks a few times per period, so that the trim follows the idle period closely
+                auto checkInterval = std::max<std::chrono::milliseconds>(idlePeriod / 4, std::chrono::seconds(1));
+                ULARGE_INTEGER dueTime;
+                dueTime.QuadPart = static_cast<ULONGLONG>(-static_cast<LONGLONG>(std::chrono::duration_cast<std::chrono::nanoseconds>(checkInterval).count() / 100));
+                FILETIME dueFileTime{ dueTime.LowPart, dueTime.HighPart };
+
+                SetThreadpoolTimer(timer, &dueFileTime, static_cast<DWORD>(checkInterval.count()), 1000);
+            });
+    }
+}
@@ -5,12 +5,14 @@
 #include "HttpStream/HttpRandomAccessStream.h"
 #include "Public/AppInstallerDownloader.h"
 #include "Public/AppInstallerLogging.h"
+#include "Public/AppInstallerSHA256.h"
 #include "Public/AppInstallerStrings.h"
 
 
 using namespace winrt::Windows::Storage::Streams;
 using namespace Microsoft::WRL;
 using namespace AppInstaller::Utility::HttpStream;
+using namespace std::string_view_literals;
 
 namespace AppInstaller::Msix
 {
@@ -117,6 +119,303 @@ namespace AppInstaller::Msix
 
             WriteStreamToFile(stream.Get(), size, target, progress);
         }
+
+        // The size of the blocks in the block map of a package; only the last block of a file may be smaller.
+        constexpr UINT64 s_BlockMapBlockSize = 64 * 1024;
+
+        // Reads exactly the given number of bytes from the stream.
+        void ReadStreamFully(IStream* stream, byte* buffer, ULONG size)
+        {
+            ULONG totalBytesRead = 0;
+            while (totalBytesRead < size)
+            {
+                ULONG bytesRead = 0;
+                HRESULT hr = stream->Read(buffer + totalBytesRead, size - totalBytesRead, &bytesRead);
+                if (!bytesRead)
+                {
+                    THROW_IF_FAILED(hr);
+                    THROW_WIN32(ERROR_HANDLE_EOF);
+                }
+
+                totalBytesRead += bytesRead;
+            }
+        }
+
+        // Gets the hashes of the blocks of the file from the block map.
+        std::vector<Utility::SHA256::HashBuffer> GetBlockHashes(IAppxBlockMapFile* blockMapFile)
+        {
+            std::vector<Utility::SHA256::HashBuffer> result;
+
+            ComPtr<IAppxBlockMapBlocksEnumerator> blocks;
+            THROW_IF_FAILED(blockMapFile->GetBlocks(&blocks));
+
+            BOOL hasCurrent = FALSE;
+            THROW_IF_FAILED(blocks->GetHasCurrent(&hasCurrent));
+            while (hasCurrent)
+            {
+                ComPtr<IAppxBlockMapBlock> block;
+                THROW_IF_FAILED(blocks->GetCurrent(&block));
+
+                UINT32 hashSize = 0;
+                wil::unique_cotaskmem_ptr<BYTE> hash;
+                THROW_IF_FAILED(block->GetHash(&hashSize, wil::out_param(hash)));
+                result.emplace_back(hash.get(), hash.get() + hashSize);
+
+                THROW_IF_FAILED(blocks->MoveNext(&hasCurrent));
+            }
+
+            return result;
+        }
+
+        // Gets a stream over the package at the given uri; a remote package is read with ranged requests.
+        // If requested, the http stream underneath the stream of a remote package is also returned.
+        ComPtr<IStream> GetStreamFromUri(std::string_view uriStr, winrt::com_ptr<HttpRandomAccessStream>* httpStream = nullptr)
+        {
+            ComPtr<IStream> result;
+
+            if (Utility::IsUrlRemote(uriStr))
+            {
+                // Get an IStream from the input uri.
+                winrt::Windows::Foundation::Uri uri(Utility::ConvertToUTF16(uriStr));
+                IRandomAccessStream randomAccessStream = HttpRandomAccessStream::CreateAsync(uri).get();
+
+                if (httpStream)
+                {
+                    httpStream->copy_from(winrt::get_self<HttpRandomAccessStream>(randomAccessStream));
+                }
+
+                ::IUnknown* rasAsIUnknown = (::IUnknown*)winrt::get_abi(randomAccessStream);
+                THROW_IF_FAILED(CreateStreamOverRandomAccessStream(
+                    rasAsIUnknown,
+                    IID_PPV_ARGS(result.ReleaseAndGetAddressOf())));
+            }
+            else
+            {
+                std::filesystem::path path(Utility::ConvertToUTF16(uriStr));
+                THROW_IF_FAILED(SHCreateStreamOnFileEx(path.c_str(),
+                    STGM_READ | STGM_SHARE_DENY_WRITE | STGM_FAILIFTHERE, 0, FALSE, nullptr, &result));
+            }
+
+            return result;
+        }
+
+        // Zip format constants used to locate the signature entry.
+        constexpr std::string_view s_SignatureFileName = "AppxSignature.p7x"sv;
+        constexpr UINT32 s_ZipEndOfCentralDirectorySignature = 0x06054b50;
+        constexpr UINT32 s_Zip64EndOfCentralDirectoryLocatorSignature = 0x07064b50;
+        constexpr UINT32 s_Zip64EndOfCentralDirectorySignature = 0x06064b50;
+        constexpr UINT32 s_ZipCentralDirectoryHeaderSignature = 0x02014b50;
+        constexpr UINT32 s_ZipLocalFileHeaderSignature = 0x04034b50;
+        constexpr UINT16 s_Zip64ExtraFieldId = 0x0001;
+        constexpr UINT16 s_ZipMethodStored = 0;
+        constexpr size_t s_ZipEndOfCentralDirectorySize = 22;
+        constexpr size_t s_Zip64EndOfCentralDirectoryLocatorSize = 20;
+        constexpr size_t s_Zip64EndOfCentralDirectorySize = 56;
+        constexpr size_t s_ZipCentralDirectoryHeaderSize = 46;
+        constexpr size_t s_ZipLocalFileHeaderSize = 30;
+        constexpr size_t s_ZipMaximumCommentSize = 0xFFFF;
+
+        // The central directory of a package lists every file, but a larger one is not expected.
+        constexpr UINT64 s_ZipMaximumCentralDirectorySize = 64 * 1024 * 1024;
+
+        template <typename T>
+        T ReadLittleEndian(const std::vector<byte>& buffer, size_t offset)
+        {
+            THROW_HR_IF(APPX_E_CORRUPT_CONTENT, offset + sizeof(T) > buffer.size());
+            T result;
+            memcpy(&result, buffer.data() + offset, sizeof(T));
+            return result;
+        }
+
+        std::vector<byte> ReadStreamAt(IStream* stream, UINT64 position, UINT64 size)
+        {
+            THROW_HR_IF(E_UNEXPECTED, size > std::numeric_limits<ULONG>::max());
+
+            LARGE_INTEGER seekPosition;
+            seekPosition.QuadPart = static_cast<LONGLONG>(position);
+            THROW_IF_FAILED(stream->Seek(seekPosition, STREAM_SEEK_SET, nullptr));
+
+            std::vector<byte> result(static_cast<size_t>(size));
+            ULONG totalBytesRead = 0;
+
+            while (totalBytesRead < result.size())
+            {
+                ULONG bytesRead = 0;
+                THROW_IF_FAILED(stream->Read(result.data() + totalBytesRead, static_cast<ULONG>(result.size()) - totalBytesRead, &bytesRead));
+                THROW_HR_IF(APPX_E_CORRUPT_CONTENT, bytesRead == 0);
+                totalBytesRead += bytesRead;
+            }
+
+            return result;
+        }
+
+        // An entry in the central directory of a zip file.
+        struct ZipEntry
+        {
+            std::string Name;
+            UINT16 Method = 0;
+            UINT64 CompressedSize = 0;
+            UINT64 UncompressedSize = 0;
+            UINT64 LocalHeaderPosition = 0;
+        };
+
+        UINT64 GetStreamSize(IStream* stream)
+        {
+            STATSTG stat = { 0 };
+            THROW_IF_FAILED(stream->Stat(&stat, STATFLAG_NONAME));
+            return stat.cbSize.QuadPart;
+        }
+
+        // Reads the entries of the zip file by parsing its end of central directory record and central directory.
+        std::vector<ZipEntry> ReadZipEntries(IStream* stream, UINT64 streamSize)
+        {
+            THROW_HR_IF(APPX_E_CORRUPT_CONTENT, streamSize < s_ZipEndOfCentralDirectorySize);
+
+            // The end of central directory record is followed by a comment of at most 64 KB
+            UINT64 tailSize = std::min<UINT64>(streamSize, s_ZipEndOfCentralDirectorySize + s_ZipMaximumCommentSize);
+            UINT64 tailPosition = streamSize - tailSize;
+            std::vector<byte> tail = ReadStreamAt(stream, tailPosition, tailSize);
+
+            std::optional<size_t> endOfCentralDirectory;
+            for (size_t i = tail.size() - s_ZipEndOfCentralDirectorySize + 1; i > 0; --i)
+            {
+                if (ReadLittleEndian<UINT32>(tail, i - 1) == s_ZipEndOfCentralDirectorySignature)
+                {
+                    endOfCentralDirectory = i - 1;
+                    break;
+                }
+            }
+            THROW_HR_IF(APPX_E_CORRUPT_CONTENT, !endOfCentralDirectory);
+
+            UINT64 entryCount = ReadLittleEndian<UINT16>(tail, endOfCentralDirectory.value() + 10);
+            UINT64 centralDirectorySize = ReadLittleEndian<UINT32>(tail, endOfCentralDirectory.value() + 12);
+            UINT64 centralDirectoryPosition = ReadLittleEndian<UINT32>(tail, endOfCentralDirectory.value() + 16);
+
+            // Packages larger than 4 GB store the real values in the zip64 end of central directory record
+            if (entryCount == 0xFFFF || centralDirectorySize == 0xFFFFFFFF || centralDirectoryPosition == 0xFFFFFFFF)
+            {
+                THROW_HR_IF(APPX_E_CORRUPT_CONTENT, endOfCentralDirectory.value() < s_Zip64EndOfCentralDirectoryLocatorSize);
+                size_t locator = endOfCentralDirectory.value() - s_Zip64EndOfCentralDirectoryLocatorSize;
+                THROW_HR_IF(APPX_E_CORRUPT_CONTENT, ReadLittleEndian<UINT32>(tail, locator) != s_Zip64EndOfCentralDirectoryLocatorSignature);
+
+                UINT64 zip64EndOfCentralDirectoryPosition = ReadLittleEndian<UINT64>(tail, locator + 8);
+                std::vector<byte> zip64EndOfCentralDirectory = ReadStreamAt(stream, zip64EndOfCentralDirectoryPosition, s_Zip64EndOfCentralDirectorySize);
+                THROW_HR_IF(APPX_E_CORRUPT_CONTENT, ReadLittleEndian<UINT32>(zip64EndOfCentralDirectory, 0) != s_Zip64EndOfCentralDirectorySignature);
+
+                entryCount = ReadLittleEndian<UINT64>(zip64EndOfCentralDirectory, 32);
+                centralDirectorySize = ReadLittleEndian<UINT64>(zip64EndOfCentralDirectory, 40);
+                centralDirectoryPosition = ReadLittleEndian<UINT64>(zip64EndOfCentralDirectory, 48);
+            }
+
+            THROW_HR_IF(APPX_E_CORRUPT_CONTENT, centralDirectorySize > s_ZipMaximumCentralDirectorySize || centralDirectoryPosition + centralDirectorySize > streamSize);
+            std::vector<byte> centralDirectory = ReadStreamAt(stream, centralDirectoryPosition, centralDirectorySize);
+
+            std::vector<ZipEntry> result;
+            size_t offset = 0;
+            for (UINT64 i = 0; i < entryCount; ++i)
+            {
+                THROW_HR_IF(APPX_E_CORRUPT_CONTENT, ReadLittleEndian<UINT32>(centralDirectory, offset) != s_ZipCentralDirectoryHeaderSignature);
+
+                ZipEntry entry;
+                entry.Method = ReadLittleEndian<UINT16>(centralDirectory, offset + 10);
+                entry.CompressedSize = ReadLittleEndian<UINT32>(centralDirectory, offset + 20);
+                entry.UncompressedSize = ReadLittleEndian<UINT32>(centralDirectory, offset + 24);
+                UINT16 nameLength = ReadLittleEndian<UINT16>(centralDirectory, offset + 28);
+                UINT16 extraLength = ReadLittleEndian<UINT16>(centralDirectory, offset + 30);
+                UINT16 commentLength = ReadLittleEndian<UINT16>(centralDirectory, offset + 32);
+                entry.LocalHeaderPosition = ReadLittleEndian<UINT32>(centralDirectory, offset + 42);
+
+                size_t nameOffset = offset + s_ZipCentralDirectoryHeaderSize;
+                THROW_HR_IF(APPX_E_CORRUPT_CONTENT, nameOffset + nameLength + extraLength > centralDirectory.size());
+                entry.Name.assign(reinterpret_cast<const char*>(centralDirectory.data() + nameOffset), nameLength);
+
+                // The zip64 extra field holds, in order, each of these values that did not fit
+                size_t extraOffset = nameOffset + nameLength;
+                size_t extraEnd = extraOffset + extraLength;
+                while (extraOffset + 4 <= extraEnd)
+                {
+                    UINT16 extraId = ReadLittleEndian<UINT16>(centralDirectory, extraOffset);
+                    UINT16 extraSize = ReadLittleEndian<UINT16>(centralDirectory, extraOffset + 2);
+                    size_t valueOffset = extraOffset + 4;
+
+                    if (extraId == s_Zip64ExtraFieldId)
+                    {
+                        for (UINT64* value : { &entry.UncompressedSize, &entry.CompressedSize, &entry.LocalHeaderPosition })
+                        {
+                            if (*value == 0xFFFFFFFF)
+                            {
+                                *value = ReadLittleEndian<UINT64>(centralDirectory, valueOffset);
+                                valueOffset += sizeof(UINT64);
+                            }
+                        }
+                    }
+
+                    extraOffset += 4 + static_cast<size_t>(extraSize);
+                }
+
+                result.emplace_back(std::move(entry));
+                offset = nameOffset + nameLength + extraLength + commentLength;
+            }
+
+            return result;
+        }
+
+        // Reads the signature entry by parsing the zip structures directly. Returns an empty value if the package does not
+        // have a signature stored without compression, in which case the package reader should be used instead.
+        std::optional<std::vector<byte>> ReadSignatureFromZip(IStream* stream)
+        {
+            UINT64 streamSize = GetStreamSize(stream);
+            std::vector<ZipEntry> entries = ReadZipEntries(stream, streamSize);
+
+            auto signature = std::find_if(entries.begin(), entries.end(), [](const ZipEntry& entry) { return entry.Name == s_SignatureFileName; });
+            if (signature == entries.end() || signature->Method != s_ZipMethodStored)
+            {
+                return {};
+            }
+
+            THROW_HR_IF(APPX_E_CORRUPT_CONTENT, signature->CompressedSize != signature->UncompressedSize);
+
+            std::vector<byte> localHeader = ReadStreamAt(stream, signature->LocalHeaderPosition, s_ZipLocalFileHeaderSize);
+            THROW_HR_IF(APPX_E_CORRUPT_CONTENT, ReadLittleEndian<UINT32>(localHeader, 0) != s_ZipLocalFileHeaderSignature);
+
+            UINT64 dataPosition = signature->LocalHeaderPosition + s_ZipLocalFileHeaderSize +
+                ReadLittleEndian<UINT16>(localHeader, 26) + ReadLittleEndian<UINT16>(localHeader, 28);
+            THROW_HR_IF(APPX_E_CORRUPT_CONTENT, dataPosition + signature->CompressedSize > streamSize);
+
+            return ReadStreamAt(stream, dataPosition, signature->CompressedSize);
+        }
+
+        // The files that the package and bundle readers read when they are created, or when the package information is requested.
+        constexpr std::array<std::string_view, 6> s_FootprintFileNames
+        {
+            "AppxManifest.xml"sv,
+            "AppxBlockMap.xml"sv,
+            "AppxSignature.p7x"sv,
+            "[Content_Types].xml"sv,
+            "AppxMetadata/AppxBundleManifest.xml"sv,
+            "AppxMetadata/CodeIntegrity.cat"sv,
+        };
+
+        // Downloads the footprint files of a remote package before the package reader asks for them, so that its many
+        // small reads around the file are served from the cache instead of each missing page becoming its own request.
+        void PrefetchFootprintFiles(IStream* stream, HttpRandomAccessStream& httpStream)
+        {
+            UINT64 streamSize = GetStreamSize(stream);
+            std::vector<ZipEntry> entries = ReadZipEntries(stream, streamSize);
+
+            std::vector<HttpLocalCache::ByteRange> ranges;
+            for (const ZipEntry& entry : entries)
+            {
+                if (std::find(s_FootprintFileNames.begin(), s_FootprintFileNames.end(), entry.Name) != s_FootprintFileNames.end())
+                {
+                    // The local header repeats the name, and usually the extra field, ahead of the data
+                    UINT64 size = s_ZipLocalFileHeaderSize + entry.Name.size() + entry.CompressedSize;
+                    ranges.push_back({ entry.LocalHeaderPosition, std::min(size, streamSize - std::min(streamSize, entry.LocalHeaderPosition)) });
+                }
+            }
+
+            httpStream.PrefetchRangesAsync(ranges).get();
+        }
     }
 
     bool GetBundleReader(
@@ -278,24 +577,65 @@ namespace AppInstaller::Msix
         return { result };
     }
 
-    MsixInfo::MsixInfo(std::string_view uriStr)
+    std::vector<byte> GetPackageSignature(std::string_view uriStr)
     {
-        if (Utility::IsUrlRemote(uriStr))
+        ComPtr<IStream> stream = GetStreamFromUri(uriStr);
+
+        std::optional<std::vector<byte>> signature = ReadSignatureFromZip(stream.Get());
+        if (signature)
         {
-            // Get an IStream from the input uri and try to create package or bundler reader.
-            winrt::Windows::Foundation::Uri uri(Utility::ConvertToUTF16(uriStr));
-            IRandomAccessStream randomAccessStream = HttpRandomAccessStream::CreateAsync(uri).get();
+            return std::move(signature).value();
+        }
 
-            ::IUnknown* rasAsIUnknown = (::IUnknown*)winrt::get_abi(randomAccessStream);
-            THROW_IF_FAILED(CreateStreamOverRandomAccessStream(
-                rasAsIUnknown,
-                IID_PPV_ARGS(m_stream.ReleaseAndGetAddressOf())));
+        AICLI_LOG(Core, Info, << "Signature is not stored uncompressed in the package, using the package reader");
+        return MsixInfo{ uriStr }.GetSignature();
+    }
+
+    bool IsPackageSignatureTrusted(const std::filesystem::path& packagePath)
+    {
+        WINTRUST_FILE_INFO fileInfo = {};
+        fileInfo.cbStruct = sizeof(fileInfo);
+        fileInfo.pcwszFilePath = packagePath.c_str();
+
+        WINTRUST_DATA trustData = {};
+        trustData.cbStruct = sizeof(trustData);
+        trustData.dwUIChoice = WTD_UI_NONE;
+        trustData.fdwRevocationChecks = WTD_REVOKE_NONE;
+        trustData.dwUnionChoice = WTD_CHOICE_FILE;
+        trustData.pFile = &fileInfo;
+        trustData.dwStateAction = WTD_STATEACTION_VERIFY;
+        // Background updates should not wait on fetching revocation data that is not already cached.
+        trustData.dwProvFlags = WTD_CACHE_ONLY_URL_RETRIEVAL;
+
+        GUID action = WINTRUST_ACTION_GENERIC_VERIFY_V2;
+        HRESULT hr = static_cast<HRESULT>(WinVerifyTrust(static_cast<HWND>(INVALID_HANDLE_VALUE), &action, &trustData));
+
+        trustData.dwStateAction = WTD_STATEACTION_CLOSE;
+        WinVerifyTrust(static_cast<HWND>(INVALID_HANDLE_VALUE), &action, &trustData);
+
+        if (FAILED(hr))
+        {
+            AICLI_LOG(Core, Error, << "Package signature is not trusted: 0x" << Logging::SetHRFormat << hr << " for " << packagePath.u8string());
+            return false;
         }
-        else
+
+        return true;
+    }
+
+    MsixInfo::MsixInfo(std::string_view uriStr)
+    {
+        // Get an IStream from the input uri and try to create package or bundler reader.
+        winrt::com_ptr<HttpRandomAccessStream> httpStream;
+        m_stream = GetStreamFromUri(uriStr, &httpStream);
+
+        if (httpStream)
         {
-            std::filesystem::path path(Utility::ConvertToUTF16(uriStr));
-            THROW_IF_FAILED(SHCreateStreamOnFileEx(path.c_str(),
-                STGM_READ | STGM_SHARE_DENY_WRITE | STGM_FAILIFTHERE, 0, FALSE, nullptr, &m_stream));
+            // The readers work without the prefetch, just with more requests
+            try
+            {
+                PrefetchFootprintFiles(m_stream.Get(), *httpStream);
+            }
+            CATCH_LOG();
         }
 
         if (GetBundleReader(m_stream.Get(), &m_bundleReader))
@@ -416,6 +756,153 @@ namespace AppInstaller::Msix
         WriteAppxFileToFile(appxFile.Get(), target, progress);
     }
 
+    bool MsixInfo::UpdateFile(std::string_view packageFile, const std::filesystem::path& target, IProgressCallback& progress)
+    {
+        // Work on a copy, so that the existing file is left as it was if the update fails.
+        std::filesystem::path tempFile = target;
+        tempFile += ".updt";
+        auto removeTempFile = wil::scope_exit([&]() { std::error_code error; std::filesystem::remove(tempFile, error); });
+
+        if (!UpdateFile(packageFile, target, tempFile, progress))
+        {
+            return false;
+        }
+
+        // An unchanged file is left in place.
+        if (!std::filesystem::exists(tempFile))
+        {
+            return true;
+        }
+
+        std::filesystem::path backupFile = target;
+        backupFile += ".bkup";
+        if (std::filesystem::exists(backupFile))
+        {
+            std::filesystem::remove(backupFile);
+        }
+        std::filesystem::rename(target, backupFile);
+        std::filesystem::rename(tempFile, target);
+
+        return true;
+    }
+
+    bool MsixInfo::UpdateFile(std::string_view packageFile, const std::filesystem::path& existing, const std::filesystem::path& destination, IProgressCallback& progress)
+    {
+        std::error_code removeError;
+        std::filesystem::remove(destination, removeError);
+
+        if (m_isBundle || !std::filesystem::exists(existing))
+        {
+            return false;
+        }
+
+        std::wstring fileUTF16 = Utility::ConvertToUTF16(packageFile);
+
+        ComPtr<IAppxBlockMapReader> blockMap;
+        THROW_IF_FAILED(m_packageReader->GetBlockMap(&blockMap));
+
+        ComPtr<IAppxBlockMapFile> blockMapFile;
+        THROW_IF_FAILED(blockMap->GetFile(fileUTF16.c_str(), &blockMapFile));
+
+        UINT64 size = 0;
+        THROW_IF_FAILED(blockMapFile->GetUncompressedSize(&size));
+
+        std::vector<Utility::SHA256::HashBuffer> blockHashes = GetBlockHashes(blockMapFile.Get());
+        THROW_HR_IF(APPX_E_CORRUPT_CONTENT, blockHashes.size() != (size + s_BlockMapBlockSize - 1) / s_BlockMapBlockSize);
+
+        std::vector<byte> buffer(s_BlockMapBlockSize);
+        std::vector<size_t> changedBlocks;
+
+        {
+            std::ifstream file(existing, std::ios_base::binary | std::ios_base::in);
+
+            for (size_t i = 0; i < blockHashes.size(); ++i)
+            {
+                size_t blockSize = static_cast<size_t>(std::min(s_BlockMapBlockSize, size - i * s_BlockMapBlockSize));
+                file.read(reinterpret_cast<char*>(buffer.data()), blockSize);
+
+                if (static_cast<size_t>(file.gcount()) != blockSize ||
+                    !Utility::SHA256::AreEqual(blockHashes[i], Utility::SHA256::ComputeHash(buffer.data(), static_cast<std::uint32_t>(blockSize))))
+                {
+                    changedBlocks.emplace_back(i);
+                    file.clear();
+                }
+            }
+        }
+
+        // With most of the blocks changed, reading the whole file is no worse.
+        if (changedBlocks.size() * 2 > blockHashes.size())
+        {
+            AICLI_LOG(Core, Info, << "Most of the " << blockHashes.size() << " blocks of " << packageFile << " changed, so it will be written in full");
+            return false;
+        }
+
+        if (changedBlocks.empty() && std::filesystem::file_size(existing) == size)
+        {
+            AICLI_LOG(Core, Info, << "None of the " << blockHashes.size() << " blocks of " << packageFile << " changed");
+            return true;
+        }
+
+        std::filesystem::copy_file(existing, destination, std::filesystem::copy_options::overwrite_existing);
+        auto removeDestination = wil::scope_exit([&]() { std::error_code error; std::filesystem::remove(destination, error); });
+
+        AICLI_LOG(Core, Info, << "Updating " << changedBlocks.size() << " of the " << blockHashes.size() << " blocks of " << packageFile);
+
+        ComPtr<IAppxFile> appxFile;
+        THROW_IF_FAILED(m_packageReader->GetPayloadFile(fileUTF16.c_str(), &appxFile));
+
+        ComPtr<IStream> stream;
+        THROW_IF_FAILED(appxFile->GetStream(&stream));
+
+        {
+            std::fstream file(destination, std::ios_base::binary | std::ios_base::in | std::ios_base::out);
+
+            for (size_t changed = 0; changed < changedBlocks.size(); ++changed)
+            {
+                if (progress.IsCancelled())
+                {
+                    return false;
+                }
+
+                size_t i = changedBlocks[changed];
+                UINT64 offset = i * s_BlockMapBlockSize;
+                ULONG blockSize = static_cast<ULONG>(std::min(s_BlockMapBlockSize, size - offset));
+
+                LARGE_INTEGER seek{};
+                seek.QuadPart = static_cast<LONGLONG>(offset);
+                THROW_IF_FAILED(stream->Seek(seek, STREAM_SEEK_SET, nullptr));
+                ReadStreamFully(stream.Get(), buffer.data(), blockSize);
+
+                THROW_HR_IF(APPX_E_BLOCK_HASH_INVALID, !Utility::SHA256::AreEqual(blockHashes[i], Utility::SHA256::ComputeHash(buffer.data(), blockSize)));
+
+                file.seekp(static_cast<std::streamoff>(offset));
+                file.write(reinterpret_cast<const char*>(buffer.data()), blockSize);
+
+                progress.OnProgress(changed + 1, changedBlocks.size(), ProgressType::Percent);
+            }
+
+            THROW_HR_IF(E_FAIL, !file);
+        }
+
+        std::filesystem::resize_file(destination, size);
+
+        removeDestination.release();
+        return true;
+    }
+
+    bool MsixInfo::ContainsFile(std::string_view packageFile)
+    {
+        if (m_isBundle)
+        {
+            return false;
+        }
+
+        std::wstring fileUTF16 = Utility::ConvertToUTF16(packageFile);
+
+        ComPtr<IAppxFile> appxFile;
+        return SUCCEEDED(m_packageReader->GetPayloadFile(fileUTF16.c_str(), &appxFile));
+    }
+
     void MsixInfo::WriteManifestToFile(const std::filesystem::path& target, IProgressCallback& progress)
     {
         ComPtr<IAppxFile> appxFile;
@@ -2,14 +2,297 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "Public/winget/NameNormalization.h"
+#include "Public/AppInstallerErrors.h"
+#include "Public/AppInstallerLogging.h"
 #include "Public/AppInstallerStrings.h"
 #include "Public/winget/Regex.h"
 
+#include <unordered_map>
+#include <variant>
+
 
 namespace AppInstaller::Utility
 {
     namespace
     {
+        // Quick checks of whether a regular expression could match a value at all; when one returns false,
+        // running the expression is certain to leave the value unchanged. Checks involving letters or character
+        // classes only rule out ASCII values, as case insensitive matching and the Unicode classes reach beyond
+        // what a simple scan can see.
+        using MayMatchFunction = bool(*)(std::wstring_view value);
+
+        // A regular expression along with the check that allows it to be skipped.
+        struct FilteredExpression
+        {
+            const Regex::Expression* Expression;
+            MayMatchFunction MayMatch;
+        };
+
+        bool IsASCII(std::wstring_view value)
+        {
+            return std::all_of(value.begin(), value.end(), [](wchar_t c) { return c < 0x80; });
+        }
+
+        bool IsASCIILetter(wchar_t c)
+        {
+            return (c >= L'A' && c <= L'Z') || (c >= L'a' && c <= L'z');
+        }
+
+        bool IsASCIIDigit(wchar_t c)
+        {
+            return (c >= L'0' && c <= L'9');
+        }
+
+        bool ContainsAnyOf(std::wstring_view value, std::wstring_view chars)
+        {
+            return value.find_first_of(chars) != std::wstring_view::npos;
+        }
+
+        bool Contains(std::wstring_view value, std::wstring_view text)
+        {
+            return value.find(text) != std::wstring_view::npos;
+        }
+
+        bool MayContainDigit(std::wstring_view value)
+        {
+            return !IsASCII(value) || std::any_of(value.begin(), value.end(), IsASCIIDigit);
+        }
+
+        // The text must be lower case ASCII.
+        bool MayContainCaseInsensitive(std::wstring_view value, std::wstring_view text)
+        {
+            if (!IsASCII(value))
+            {
+                return true;
+            }
+
+            std::wstring lower{ value };
+            std::transform(lower.begin(), lower.end(), lower.begin(), [](wchar_t c) { return (c >= L'A' && c <= L'Z') ? static_cast<wchar_t>(c - L'A' + L'a') : c; });
+            return Contains(lower, text);
+        }
+
+        bool MayContainNonLetter(std::wstring_view value)
+        {
+            return !IsASCII(value) || !std::all_of(value.begin(), value.end(), IsASCIILetter);
+        }
+
+        // Reads the code point at the index, advancing it past the code point.
+        UChar32 NextCodePoint(std::wstring_view value, size_t& index)
+        {
+            UChar32 result = value[index++];
+            if (U16_IS_LEAD(result) && index < value.length() && U16_IS_TRAIL(value[index]))
+            {
+                result = U16_GET_SUPPLEMENTARY(result, value[index++]);
+            }
+            return result;
+        }
+
+        // Reads the code point before the index, moving the index back to its start.
+        UChar32 PreviousCodePoint(std::wstring_view value, size_t& index)
+        {
+            UChar32 result = value[--index];
+            if (U16_IS_TRAIL(result) && index > 0 && U16_IS_LEAD(value[index - 1]))
+            {
+                result = U16_GET_SUPPLEMENTARY(value[--index], result);
+            }
+            return result;
+        }
+
+        // The code points matched by a case insensitive regular expression of the form [^...], for the expressions
+        // that match nothing more than a single character class. The set is built the way ICU builds it for the
+        // expression, by closing the inner set over case and then complementing it, so it matches exactly the same
+        // code points; but a value is classified in a single pass without running the regular expression engine.
+        class NegatedCharacterSet
+        {
+        public:
+            NegatedCharacterSet(std::wstring_view innerPattern)
+            {
+                UErrorCode uec = U_ZERO_ERROR;
+                m_set.reset(uset_openPatternOptions(reinterpret_cast<const UChar*>(innerPattern.data()), static_cast<int32_t>(innerPattern.length()), USET_CASE_INSENSITIVE, &uec));
+
+                if (U_FAILURE(uec))
+                {
+                    AICLI_LOG(Core, Error, << "uset_openPatternOptions failed with error [" << uec << "] for pattern " << ConvertToUTF8(innerPattern));
+                    THROW_HR(APPINSTALLER_CLI_ERROR_ICU_REGEX_ERROR);
+                }
+
+                uset_complement(m_set.get());
+                uset_freeze(m_set.get());
+
+                for (UChar32 c = 0; c < static_cast<UChar32>(m_ascii.size()); ++c)
+                {
+                    m_ascii[c] = uset_contains(m_set.get(), c) != 0;
+                }
+            }
+
+            bool Contains(UChar32 c) const
+            {
+                return (c >= 0 && c < static_cast<UChar32>(m_ascii.size())) ? m_ascii[c] : (uset_contains(m_set.get(), c) != 0);
+            }
+
+            // Removes all code points in the set from the value; returns true if any were removed.
+            bool RemoveAll(std::wstring& value) const
+            {
+                std::wstring output;
+                output.reserve(value.length());
+
+                for (size_t i = 0; i < value.length();)
+                {
+                    size_t start = i;
+                    if (!Contains(NextCodePoint(value, i)))
+                    {
+                        output.append(value, start, i - start);
+                    }
+                }
+
+                bool result = (output.length() != value.length());
+                value = std::move(output);
+                return result;
+            }
+
+            // Removes the run of code points in the set from the start of the value, as "^[^...]+" would.
+            bool TrimStart(std::wstring& value) const
+            {
+                size_t end = 0;
+                for (size_t i = 0; i < value.length() && Contains(NextCodePoint(value, i));)
+                {
+                    end = i;
+                }
+
+                value.erase(0, end);
+                return end != 0;
+            }
+
+            // Removes the run of code points in the set from the end of the value, as "[^...]+$" would.
+            // Line terminators are always in the set, so the run reaches the end even where "$" would match before one.
+            bool TrimEnd(std::wstring& value) const
+            {
+                size_t start = value.length();
+                for (size_t i = value.length(); i > 0 && Contains(PreviousCodePoint(value, i));)
+                {
+                    start = i;
+                }
+
+                bool result = (start != value.length());
+                value.erase(start);
+                return result;
+            }
+
+            // For each section of the value, invoke the given functor in the same manner as Regex::Expression::ForEach;
+            // every code point in the set is a match of its own.
+            template <typename Function>
+            void ForEach(std::wstring_view value, Function&& f) const
+            {
+                size_t unmatchedStart = 0;
+
+                for (size_t i = 0; i < value.length();)
+                {
+                    size_t start = i;
+                    if (Contains(NextCodePoint(value, i)))
+                    {
+                        if (start > unmatchedStart && !f(false, value.substr(unmatchedStart, start - unmatchedStart)))
+                        {
+                            return;
+                        }
+
+                        if (!f(true, value.substr(start, i - start)))
+                        {
+                            return;
+                        }
+
+                        unmatchedStart = i;
+                    }
+                }
+
+                if (value.length() > unmatchedStart)
+                {
+                    f(false, value.substr(unmatchedStart));
+                }
+            }
+
+        private:
+            wil::unique_any<USet*, decltype(uset_close), &uset_close> m_set;
+            std::array<bool, 128> m_ascii{};
+        };
+
+        // Trims a character set from one end of the value, in place of a regular expression anchored to that end.
+        struct CharacterSetTrim
+        {
+            const NegatedCharacterSet* Set;
+            bool FromStart;
+        };
+
+        // A removal made repeatedly while normalizing.
+        using Removal = std::variant<FilteredExpression, CharacterSetTrim>;
+
+        // Remembers the results of another normalizer, as the same names are normalized many times over
+        // while correlating packages. Normalization itself is done outside of the lock.
+        class CachingNameNormalizer : public details::INameNormalizer
+        {
+            // Bounds the memory used; the cache is simply emptied when full.
+            static constexpr size_t s_MaximumCacheEntries = 4096;
+
+            static std::string CreateKey(std::string_view name, std::string_view publisher)
+            {
+                std::string result = std::to_string(name.size());
+                result += ':';
+                result += name;
+                result += publisher;
+                return result;
+            }
+
+            template <typename Value, typename Factory>
+            Value GetOrAdd(std::unordered_map<std::string, Value>& cache, std::string&& key, Factory&& factory) const
+            {
+                {
+                    std::lock_guard<std::mutex> lock{ m_lock };
+                    auto itr = cache.find(key);
+                    if (itr != cache.end())
+                    {
+                        return itr->second;
+                    }
+                }
+
+                Value result = factory();
+
+                std::lock_guard<std::mutex> lock{ m_lock };
+                if (cache.size() >= s_MaximumCacheEntries)
+                {
+                    cache.clear();
+                }
+                cache.emplace(std::move(key), result);
+
+                return result;
+            }
+
+        public:
+            CachingNameNormalizer(std::unique_ptr<details::INameNormalizer>&& normalizer) : m_normalizer(std::move(normalizer))
+            {
+            }
+
+            NormalizedName Normalize(std::string_view name, std::string_view publisher) const override
+            {
+                return GetOrAdd(m_normalized, CreateKey(name, publisher), [&]() { return m_normalizer->Normalize(name, publisher); });
+            }
+
+            NormalizedName NormalizeName(std::string_view name) const override
+            {
+                return GetOrAdd(m_normalizedNames, std::string{ name }, [&]() { return m_normalizer->NormalizeName(name); });
+            }
+
+            std::string NormalizePublisher(std::string_view publisher) const override
+            {
+                return GetOrAdd(m_normalizedPublishers, std::string{ publisher }, [&]() { return m_normalizer->NormalizePublisher(publisher); });
+            }
+
+        private:
+            std::unique_ptr<details::INameNormalizer> m_normalizer;
+            mutable std::mutex m_lock;
+            mutable std::unordered_map<std::string, NormalizedName> m_normalized;
+            mutable std::unordered_map<std::string, NormalizedName> m_normalizedNames;
+            mutable std::unordered_map<std::string, std::string> m_normalizedPublishers;
+        };
+
         struct InterimNameNormalizationResult
         {
             std::wstring Name;
@@ -80,11 +363,28 @@ namespace AppInstaller::Utility
                 return result;
             }
 
+            // Removes all matches from the input string, if the expression could match it.
+            static bool Remove(const FilteredExpression& re, std::wstring& input)
+            {
+                return re.MayMatch(input) && Remove(*re.Expression, input);
+            }
+
+            static bool Remove(const CharacterSetTrim& trim, std::wstring& input)
+            {
+                return trim.FromStart ? trim.Set->TrimStart(input) : trim.Set->TrimEnd(input);
+            }
+
             // Removes the architecture and returns the value, if any
             Architecture RemoveArchitecture(std::wstring& value) const
             {
                 Architecture result = Architecture::Unknown;
 
+                // Every architecture expression requires a digit
+                if (!MayContainDigit(value))
+                {
+                    return result;
+                }
+
                 // Must detect this first because "32/64 bit" is a superstring of "64 bit"
                 if (Remove(Architecture32Or64Bit, value))
                 {
@@ -103,14 +403,14 @@ namespace AppInstaller::Utility
                 return result;
             }
 
-            // Removes all matches for the given regular expressions
-            static bool RemoveAll(const std::vector<Regex::Expression*>& regexes, std::wstring& value)
+            // Removes all matches for the given removals
+            static bool RemoveAll(const std::vector<Removal>& removals, std::wstring& value)
             {
                 bool result = false;
 
-                for (const auto& re : regexes)
+                for (const auto& removal : removals)
                 {
-                    result = Remove(*re, value) || result;
+                    result = std::visit([&](const auto& r) { return Remove(r, value); }, removal) || result;
                 }
 
                 return result;
@@ -122,6 +422,12 @@ namespace AppInstaller::Utility
                 bool localeFound = false;
                 std::wstring result;
 
+                // Every locale contains a dash
+                if (!Contains(value, L"-"))
+                {
+                    return result;
+                }
+
                 std::wstring newValue;
                 auto newValueInserter = std::back_inserter(newValue);
 
@@ -180,13 +486,13 @@ namespace AppInstaller::Utility
                 return result;
             }
 
-            // Splits the string based on the regex matches, excluding empty/whitespace strings
+            // Splits the string on the code points in the set, excluding empty/whitespace strings
             // and any values found in the exclusions.
-            static std::vector<std::wstring> Split(const Regex::Expression& re, const std::wstring& value, const std::vector<std::wstring>& exclusions, bool stopOnExclusion = false)
+            static std::vector<std::wstring> Split(const NegatedCharacterSet& separators, const std::wstring& value, const std::vector<std::wstring>& exclusions, bool stopOnExclusion = false)
             {
                 std::vector<std::wstring> result;
 
-                re.ForEach(value,
+                separators.ForEach(value,
                     [&](bool, std::wstring_view text)
                     {
                         if (IsEmptyOrWhitespace(text))
@@ -245,7 +551,6 @@ namespace AppInstaller::Utility
             // Extract KB numbers from their parens to preserve them
             Regex::Expression KBNumbers{ R"(\((KB\d+)\))", reOptions };
 
-            Regex::Expression NonLettersAndDigits{ R"([^\p{L}\p{Nd}])", reOptions };
             Regex::Expression URIProtocol{ R"((?<!\p{L})(?:http[s]?|ftp):\/\/)", reOptions }; // remove protocol from URIs
 
             Regex::Expression VersionDelimited{ R"(((?<!\p{L})(?:V|VER|VERSI(?:O|Ó)N|VERSÃO|VERSIE|WERSJA|BUILD|RELEASE|RC|SP)\P{L}?)?\p{Nd}+([\p{Po}\p{Pd}\p{Pc}]\p{Nd}?(RC|B|A|R|SP|K)?\p{Nd}+)+([\p{Po}\p{Pd}\p{Pc}]?[\p{L}\p{Nd}]+)*)", reOptions };
@@ -253,12 +558,9 @@ namespace AppInstaller::Utility
             Regex::Expression VersionLetter{ R"((?<!\p{L})(?:(?:V|VER|VERSI(?:O|Ó)N|VERSÃO|VERSIE|WERSJA|BUILD|RELEASE|RC|SP)\P{L})?\p{Lu}\p{Nd}+(?:[\p{Po}\p{Pd}\p{Pc}]\p{Nd}+)+)", reOptions };
             Regex::Expression NonNestedBracket{ R"(\([^\(\)]*\)|\[[^\[\]]*\])", reOptions }; // remove things in parentheses, if there aren't parentheses nested inside
             Regex::Expression BracketEnclosed{ R"((?:\p{Ps}.*\p{Pe}|".*"))", reOptions }; // Impossible to properly handle nested parens with regex
-            Regex::Expression LeadingSymbols{ R"(^[^\p{L}\p{Nd}]+)", reOptions }; // remove symbols at the beginning
-            Regex::Expression TrailingNonLetters{ R"(\P{L}+$)", reOptions }; // remove non-letters at the end
             Regex::Expression PrefixParens{ R"(^\(.*?\))", reOptions }; // remove things in parentheses at the front of program names
             Regex::Expression EmptyParens{ R"((\(\s*\)|\[\s*\]|"\s*"))", reOptions }; // remove appearances of (), [], and "", with any number of spaces within
             Regex::Expression EN{ R"(\sEN\s*$)", reOptions }; // remove appearances of EN (represents English language) at the ends of program names
-            Regex::Expression TrailingSymbols{ R"([^\p{L}\p{Nd}]+$)", reOptions }; // remove all non-letter/numbers at the end
             Regex::Expression FilePath{ R"(((INSTALLED\sAT|IN)\s)?[CDEF]:\\(.+?\\)*[^\s]*\\?)", reOptions }; // remove file paths
             Regex::Expression FilePathGHS{ R"(\(CHANGE #\d{1,2} TO [CDEF]:\\(.+?\\)*[^\s]*\\?\))", reOptions }; // remove file paths in certain Green Hills Software program names
             Regex::Expression FilePathParens{ R"(\([CDEF]:\\(.+?\\)*[^\s]*\\?\))", reOptions }; // remove file paths within parentheses
@@ -266,41 +568,55 @@ namespace AppInstaller::Utility
             Regex::Expression Roblox{ R"((?<=^ROBLOX\s(PLAYER|STUDIO))(\sFOR\s.*))", reOptions }; // for Roblox programs
             Regex::Expression Bomgar{ R"((?<=^BOMGAR\s(JUMP CLIENT|(ACCESS|REPRESENTATIVE) CONSOLE|BUTTON)|^EMBEDDED CALLBACK)(\s.*))", reOptions }; // for Bomgar programs
             Regex::Expression AcronymSeparators{ R"((?:(?<=^\p{L})|(?<=\P{L}\p{L}))(\.|\/)(?=\p{L}(?:\P{L}|$)))", reOptions };
-            Regex::Expression NonLetters{ R"((?<=^|\s)[^\p{L}]+(?=\s|$))", reOptions }; // remove all non-letters not attached to 
-            Regex::Expression ProgramNameSplit{ R"([^\p{L}\p{Nd}\+\&])", reOptions }; // used to separate 'words' in program names
-            Regex::Expression PublisherNameSplit{ R"([^\p{L}\p{Nd}])", reOptions }; // used to separate 'words' in publisher names
-
-            const std::vector<Regex::Expression*> ProgramNameRegexes
-            {
-                &Roblox,
-                &Bomgar,
-                &PrefixParens,
-                &EmptyParens,
-                &FilePathGHS,
-                &FilePathParens,
-                &FilePathQuotes,
-                &FilePath,
-                &VersionLetter,
-                &VersionDelimited,
-                &Version,
-                &EN,
-                &NonNestedBracket,
-                &BracketEnclosed,
-                &URIProtocol,
-                &LeadingSymbols,
-                &TrailingSymbols
+            Regex::Expression NonLetterWords{ R"((?<=^|\s)[^\p{L}]+(?=\s|$))", reOptions }; // remove all non-letters not attached to 
+
+            // Character sets, for the expressions that would only match a single character class.
+            NegatedCharacterSet NonLettersAndDigits{ LR"([\p{L}\p{Nd}])" }; // [^\p{L}\p{Nd}]; also used to separate 'words' in publisher names
+            NegatedCharacterSet NonLetters{ LR"([\p{L}])" }; // \P{L}
+            NegatedCharacterSet ProgramNameSplit{ LR"([\p{L}\p{Nd}\+\&])" }; // [^\p{L}\p{Nd}\+\&]; used to separate 'words' in program names
+
+            static bool MayHaveRoblox(std::wstring_view value) { return MayContainCaseInsensitive(value, L"roblox"); }
+            static bool MayHaveBomgar(std::wstring_view value) { return MayContainCaseInsensitive(value, L"bomgar") || MayContainCaseInsensitive(value, L"embedded callback"); }
+            static bool MayHavePrefixParens(std::wstring_view value) { return !value.empty() && value[0] == L'('; }
+            static bool MayHaveEmptyParens(std::wstring_view value) { return ContainsAnyOf(value, L"([\""); }
+            static bool MayHaveFilePath(std::wstring_view value) { return Contains(value, L":\\"); }
+            static bool MayHaveEN(std::wstring_view value) { return MayContainCaseInsensitive(value, L"en"); }
+            static bool MayHaveNonNestedBracket(std::wstring_view value) { return ContainsAnyOf(value, L"(["); }
+            static bool MayHaveBracketEnclosed(std::wstring_view value) { return !IsASCII(value) || ContainsAnyOf(value, L"([{\""); }
+            static bool MayHaveURIProtocol(std::wstring_view value) { return Contains(value, L"://"); }
+            static bool MayHaveAcronymSeparators(std::wstring_view value) { return ContainsAnyOf(value, L"./"); }
+
+            const std::vector<Removal> ProgramNameRemovals
+            {
+                FilteredExpression{ &Roblox, MayHaveRoblox },
+                FilteredExpression{ &Bomgar, MayHaveBomgar },
+                FilteredExpression{ &PrefixParens, MayHavePrefixParens },
+                FilteredExpression{ &EmptyParens, MayHaveEmptyParens },
+                FilteredExpression{ &FilePathGHS, MayHaveFilePath },
+                FilteredExpression{ &FilePathParens, MayHaveFilePath },
+                FilteredExpression{ &FilePathQuotes, MayHaveFilePath },
+                FilteredExpression{ &FilePath, MayHaveFilePath },
+                FilteredExpression{ &VersionLetter, MayContainDigit },
+                FilteredExpression{ &VersionDelimited, MayContainDigit },
+                FilteredExpression{ &Version, MayContainDigit },
+                FilteredExpression{ &EN, MayHaveEN },
+                FilteredExpression{ &NonNestedBracket, MayHaveNonNestedBracket },
+                FilteredExpression{ &BracketEnclosed, MayHaveBracketEnclosed },
+                FilteredExpression{ &URIProtocol, MayHaveURIProtocol },
+                CharacterSetTrim{ &NonLettersAndDigits, true }, // remove symbols at the beginning
+                CharacterSetTrim{ &NonLettersAndDigits, false } // remove all non-letter/numbers at the end
             };
 
-            const std::vector<Regex::Expression*> PublisherNameRegexes
+            const std::vector<Removal> PublisherNameRemovals
             {
-                &VersionDelimited,
-                &Version,
-                &NonNestedBracket,
-                &BracketEnclosed,
-                &URIProtocol,
-                &NonLetters,
-                &TrailingNonLetters,
-                &AcronymSeparators
+                FilteredExpression{ &VersionDelimited, MayContainDigit },
+                FilteredExpression{ &Version, MayContainDigit },
+                FilteredExpression{ &NonNestedBracket, MayHaveNonNestedBracket },
+                FilteredExpression{ &BracketEnclosed, MayHaveBracketEnclosed },
+                FilteredExpression{ &URIProtocol, MayHaveURIProtocol },
+                FilteredExpression{ &NonLetterWords, MayContainNonLetter },
+                CharacterSetTrim{ &NonLetters, false }, // remove non-letters at the end
+                FilteredExpression{ &AcronymSeparators, MayHaveAcronymSeparators }
             };
 
             // Add values here but use Locales in code.
@@ -362,7 +678,7 @@ namespace AppInstaller::Utility
                 while (Unwrap(result.Name)); // remove wrappers
 
                 // handle (large majority of) SAP Business Object programs
-                if (SAPPackage.IsMatch(result.Name))
+                if (Contains(result.Name, L"-") && SAPPackage.IsMatch(result.Name))
                 {
                     return result;
                 }
@@ -371,16 +687,19 @@ namespace AppInstaller::Utility
                 result.Locale = RemoveLocale(result.Name);
 
                 // Extract KB numbers from their parens and preserve them
-                result.Name = KBNumbers.Replace(result.Name, L"$1");
+                if (Contains(result.Name, L"(") && MayContainDigit(result.Name))
+                {
+                    result.Name = KBNumbers.Replace(result.Name, L"$1");
+                }
 
                 // Repeatedly remove matches for the regexes to create the minimum name
-                while (RemoveAll(ProgramNameRegexes, result.Name));
+                while (RemoveAll(ProgramNameRemovals, result.Name));
 
                 auto tokens = Split(ProgramNameSplit, result.Name, LegalEntitySuffixes);
                 result.Name = Join(tokens);
 
                 // Drop all undesired characters
-                Remove(NonLettersAndDigits, result.Name);
+                NonLettersAndDigits.RemoveAll(result.Name);
 
                 return result;
             }
@@ -392,13 +711,13 @@ namespace AppInstaller::Utility
                 result.Publisher = PrepareForValidation(publisher);
                 while (Unwrap(result.Publisher)); // remove wrappers
 
-                while (RemoveAll(PublisherNameRegexes, result.Publisher));
+                while (RemoveAll(PublisherNameRemovals, result.Publisher));
 
-                auto tokens = Split(PublisherNameSplit, result.Publisher, LegalEntitySuffixes, true);
+                auto tokens = Split(NonLettersAndDigits, result.Publisher, LegalEntitySuffixes, true);
                 result.Publisher = Join(tokens);
 
                 // Drop all undesired characters
-                Remove(NonLettersAndDigits, result.Publisher);
+                NonLettersAndDigits.RemoveAll(result.Publisher);
 
                 return result;
             }
@@ -448,13 +767,25 @@ namespace AppInstaller::Utility
         switch (version)
         {
         case AppInstaller::Utility::NormalizationVersion::Initial:
-            m_normalizer = std::make_unique<NormalizationInitial>();
+            m_normalizer = std::make_unique<CachingNameNormalizer>(std::make_unique<NormalizationInitial>());
             break;
         default:
             THROW_HR(E_INVALIDARG);
         }
     }
 
+    std::string_view GetNormalizationRulesIdentifier(NormalizationVersion version)
+    {
+        switch (version)
+        {
+        case AppInstaller::Utility::NormalizationVersion::Initial:
+            // Bump this whenever a change to NormalizationInitial alters its output.
+            return "Initial.1";
+        default:
+            THROW_HR(E_INVALIDARG);
+        }
+    }
+
     NormalizedName NameNormalizer::Normalize(std::string_view name, std::string_view publisher) const
     {
         return m_normalizer->Normalize(name, publisher);
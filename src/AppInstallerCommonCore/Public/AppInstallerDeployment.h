@@ -25,6 +25,19 @@ namespace AppInstaller::Deployment
         bool skipSmartScreen,
         IProgressCallback& callback);
 
+    // Calls winrt::Windows::Management::Deployment::PackageManager::StagePackageAsync, which downloads and
+    // extracts the package without registering it for the user.
+    void StagePackage(
+        const std::string& uri,
+        IProgressCallback& callback);
+
+    // Calls winrt::Windows::Management::Deployment::PackageManager::RegisterPackageByFullNameAsync for the package
+    // at uri, which must already be staged. If the registration fails, the package is not left on the system.
+    // Returns true if the registration was deferred because the package is in use; false if not.
+    bool RegisterStagedPackage(
+        const std::string& uri,
+        IProgressCallback& callback);
+
     // Calls winrt::Windows::Management::Deployment::PackageManager::RemovePackageAsync
     void RemovePackage(
         std::string_view packageFullName,
@@ -44,6 +44,19 @@ namespace AppInstaller::Utility
         bool computeHash = false,
         std::optional<DownloadInfo> info = {});
 
+    // Downloads a file from the given URL into memory, writing the received data directly into the string.
+    //   url: The url to be downloaded from. http->https redirection is allowed.
+    //   dest: The string to hold the content; it is only replaced once the download succeeds.
+    //   computeHash: Optional. Indicates if SHA256 hash should be calculated when downloading.
+    //   downloadIdentifier: Optional. Currently only used by DO to identify the download.
+    std::optional<std::vector<BYTE>> DownloadToString(
+        const std::string& url,
+        std::string& dest,
+        DownloadType type,
+        IProgressCallback& progress,
+        bool computeHash = false,
+        std::optional<DownloadInfo> info = {});
+
     // Downloads a file from the given URL and places it in the given location.
     //   url: The url to be downloaded from. http->https redirection is allowed.
     //   dest: The path to local file to be downloaded to.
@@ -57,6 +70,21 @@ namespace AppInstaller::Utility
         bool computeHash = false,
         std::optional<DownloadInfo> info = {});
 
+    // Gets the number of bytes received over the network by downloads and remote package reads in this process.
+    // The difference between two calls is the number received in between, while nothing else downloads concurrently.
+    uint64_t GetBytesReceived();
+
+    // Adds to the number of bytes received; for use by the code that receives them.
+    void AddBytesReceived(uint64_t count);
+
+    // Determines if a previous download to the given location was interrupted and can be continued by downloading the same url again.
+    bool HasPartialDownload(const std::filesystem::path& dest);
+
+    // Gets a value that changes whenever the content at the given url does, without downloading the content.
+    // This is the strong entity tag of the content if the server gives one, otherwise its last modified time.
+    // Returns an empty string if the server gives neither, in which case nothing can be known about the content.
+    std::string GetContentValidator(const std::string& url);
+
     // Determines if the given url is a remote location.
     bool IsUrlRemote(std::string_view url);
 
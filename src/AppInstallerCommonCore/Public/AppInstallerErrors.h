@@ -93,6 +93,9 @@
 #define APPINSTALLER_CLI_ERROR_DEPENDENCIES_VALIDATION_FAILED     ((HRESULT)0x8A15004C)
 #define APPINSTALLER_CLI_ERROR_MISSING_PACKAGE                  ((HRESULT)0x8A15004D)
 #define APPINSTALLER_CLI_ERROR_INVALID_TABLE_COLUMN                  ((HRESULT)0x8A15004E)
+#define APPINSTALLER_CLI_ERROR_SOURCE_SEARCH_TIMEOUT            ((HRESULT)0x8A15004F)
+#define APPINSTALLER_CLI_ERROR_MULTIPLE_UNINSTALL_FAILED        ((HRESULT)0x8A150050)
+#define APPINSTALLER_CLI_ERROR_YAML_LIMIT_EXCEEDED              ((HRESULT)0x8A150051)
 
 #define APPINSTALLER_CLI_ERROR_INSTALL_PACKAGE_IN_USE           ((HRESULT)0x8A150101)
 #define APPINSTALLER_CLI_ERROR_INSTALL_INSTALL_IN_PROGRESS      ((HRESULT)0x8A150102)
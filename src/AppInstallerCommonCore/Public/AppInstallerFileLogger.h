@@ -3,14 +3,17 @@
 #pragma once
 #include <AppInstallerLogging.h>
 
+#include <chrono>
 #include <filesystem>
-#include <fstream>
+#include <memory>
 #include <string>
 #include <string_view>
 
 namespace AppInstaller::Logging
 {
     // Logs to a file.
+    // Records are formatted on the calling thread and written to the file by a background thread,
+    // so that logging does not wait on the file system.
     struct FileLogger : public ILogger
     {
         FileLogger();
@@ -30,6 +33,9 @@ namespace AppInstaller::Logging
         static std::string_view DefaultPrefix();
         static std::string_view DefaultExt();
 
+        // Gets the path of the file that is logged to.
+        const std::filesystem::path& GetFilePath() const;
+
         // ILogger
         std::string GetName() const override;
 
@@ -40,9 +46,15 @@ namespace AppInstaller::Logging
         // Starts a background task to clean up old log files.
         static void BeginCleanup(const std::filesystem::path& filePath);
 
+        // Waits for the records written so far to all file loggers to be written to their files, for at most the given time.
+        // This is safe to call from a crash handler.
+        static void FlushAll(std::chrono::milliseconds timeout) noexcept;
+
     private:
+        struct Writer;
+
         std::string m_name;
         std::filesystem::path m_filePath;
-        std::ofstream m_stream;
+        std::shared_ptr<Writer> m_writer;
     };
 }
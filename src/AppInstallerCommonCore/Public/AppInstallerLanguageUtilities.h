@@ -127,7 +127,61 @@ namespace AppInstaller
             return std::get<Variant::Index(E)>(GetVariant(E));
         }
 
+        // Copies the value for the given enum from another map, or removes it if the other map does not contain it.
+        // Throws if the value is of a type that cannot be copied.
+        void CopyFrom(const EnumBasedVariantMap& other, Enum e)
+        {
+            auto itr = other.m_data.find(e);
+            if (itr == other.m_data.end())
+            {
+                m_data.erase(e);
+            }
+            else
+            {
+                CopyAlternative(m_data[e], itr->second);
+            }
+        }
+
+        // Moves the value for the given enum from another map, or removes it if the other map does not contain it.
+        void MoveFrom(EnumBasedVariantMap& other, Enum e)
+        {
+            auto itr = other.m_data.find(e);
+            if (itr == other.m_data.end())
+            {
+                m_data.erase(e);
+            }
+            else
+            {
+                m_data[e] = std::move(itr->second);
+                other.m_data.erase(itr);
+            }
+        }
+
     private:
+        // Copies the alternative held by source; some alternatives cannot be copied, so the variant as a whole cannot be.
+        template <size_t I = 0>
+        static void CopyAlternative(typename Variant::variant_t& dest, const typename Variant::variant_t& source)
+        {
+            if constexpr (I < std::variant_size_v<typename Variant::variant_t>)
+            {
+                if (source.index() == I)
+                {
+                    if constexpr (std::is_copy_constructible_v<std::variant_alternative_t<I, typename Variant::variant_t>>)
+                    {
+                        dest.template emplace<I>(std::get<I>(source));
+                    }
+                    else
+                    {
+                        THROW_HR_MSG(E_NOT_VALID_STATE, "Value %zu cannot be copied", I);
+                    }
+                }
+                else
+                {
+                    CopyAlternative<I + 1>(dest, source);
+                }
+            }
+        }
+
         typename Variant::variant_t& GetVariant(Enum e)
         {
             auto itr = m_data.find(e);
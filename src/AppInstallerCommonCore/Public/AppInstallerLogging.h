@@ -5,7 +5,9 @@
 #include <chrono>
 #include <filesystem>
 #include <memory>
+#include <ostream>
 #include <sstream>
+#include <streambuf>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -85,6 +87,10 @@ namespace AppInstaller::Logging
 
         // Informs the logger of the given log with the intention that no buffering occurs (in winget code).
         virtual void WriteDirect(std::string_view message) noexcept = 0;
+
+        // Gets a value indicating whether the logger currently sends logs anywhere.
+        // Logs are not formatted at all while no logger is active.
+        virtual bool IsActive() const noexcept { return true; }
     };
 
     // This type contains the set of loggers that diagnostic logging will be sent to.
@@ -134,7 +140,7 @@ namespace AppInstaller::Logging
         // For example; SetLevel(Verbose) will enable all logs.
         void SetLevel(Level level);
 
-        // Checks whether a given channel and level are enabled.
+        // Checks whether a given channel and level are enabled, and that a logger is active to receive them.
         bool IsEnabled(Channel channel, Level level) const;
 
         // Writes a log line, if the given channel and level are enabled.
@@ -167,9 +173,62 @@ namespace AppInstaller::Logging
     // Calls the various stream format functions to produce an 8 character hexadecimal output.
     std::ostream& SetHRFormat(std::ostream& out);
 
+    // A stream buffer that holds a log message in a fixed buffer, so that most messages are formatted without allocating.
+    // Longer messages move to an allocated string as they outgrow the buffer.
+    struct LoggingStreamBuffer : public std::streambuf
+    {
+        LoggingStreamBuffer()
+        {
+            setp(m_buffer, m_buffer + sizeof(m_buffer));
+        }
+
+        LoggingStreamBuffer(const LoggingStreamBuffer&) = delete;
+        LoggingStreamBuffer& operator=(const LoggingStreamBuffer&) = delete;
+
+        // The view is valid until more is written to the buffer.
+        std::string_view view()
+        {
+            if (m_overflow.empty())
+            {
+                return { pbase(), static_cast<size_t>(pptr() - pbase()) };
+            }
+
+            MoveToOverflow();
+            return m_overflow;
+        }
+
+    protected:
+        int_type overflow(int_type ch) override
+        {
+            MoveToOverflow();
+
+            if (!traits_type::eq_int_type(ch, traits_type::eof()))
+            {
+                m_overflow.push_back(traits_type::to_char_type(ch));
+            }
+
+            return traits_type::not_eof(ch);
+        }
+
+    private:
+        void MoveToOverflow()
+        {
+            m_overflow.append(pbase(), pptr());
+            setp(m_buffer, m_buffer + sizeof(m_buffer));
+        }
+
+        char m_buffer[512];
+        std::string m_overflow;
+    };
+
     // This type allows us to override the default behavior of output operators for logging.
     struct LoggingStream
     {
+        LoggingStream() : m_out(&m_buffer) {}
+
+        LoggingStream(const LoggingStream&) = delete;
+        LoggingStream& operator=(const LoggingStream&) = delete;
+
         // Force use of the UTF-8 string from a file path.
         // This should not be necessary when we move to C++20 and convert to using u8string.
         friend AppInstaller::Logging::LoggingStream& operator<<(AppInstaller::Logging::LoggingStream& out, const std::filesystem::path& path)
@@ -187,10 +246,12 @@ namespace AppInstaller::Logging
             return out;
         }
 
-        std::string str() const { return m_out.str(); }
+        // The view is valid until more is written to the stream.
+        std::string_view str() { return m_buffer.view(); }
 
     private:
-        std::stringstream m_out;
+        LoggingStreamBuffer m_buffer;
+        std::ostream m_out;
     };
 }
 
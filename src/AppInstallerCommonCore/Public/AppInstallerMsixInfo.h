@@ -42,6 +42,15 @@ namespace AppInstaller::Msix
     // Gets the package location from the given full name.
     std::optional<std::filesystem::path> GetPackageLocationFromFullName(std::string_view fullName);
 
+    // Gets the full content of AppxSignature.p7x from the package or bundle at the given uri.
+    // Only the zip central directory and the signature entry are read, so for a remote package this
+    // does not download the block map and manifest as creating a package reader would.
+    std::vector<byte> GetPackageSignature(std::string_view uriStr);
+
+    // Determines whether the signature of the package or bundle at the given local path is valid and chains to a
+    // trusted root. The signature covers the block map, which the package reader checks the files against as they are read.
+    bool IsPackageSignatureTrusted(const std::filesystem::path& packagePath);
+
     // MsixInfo class handles all appx/msix related query.
     struct MsixInfo
     {
@@ -73,6 +82,19 @@ namespace AppInstaller::Msix
         // Writes the package file to the given path.
         void WriteToFile(std::string_view packageFile, const std::filesystem::path& target, IProgressCallback& progress);
 
+        // Updates the file at the given path, which holds another version of the package file, to the one in the package.
+        // Only the blocks whose hashes differ from those in the block map are read from the package, and each of them is
+        // verified against the block map. Returns false if the file should be written in full instead, as when it has little
+        // in common with the one in the package.
+        bool UpdateFile(std::string_view packageFile, const std::filesystem::path& target, IProgressCallback& progress);
+
+        // As UpdateFile, but writes the updated file to the destination, leaving the existing file as it was, so that
+        // it can be moved over the existing file later. When none of the blocks changed, the destination is not written.
+        bool UpdateFile(std::string_view packageFile, const std::filesystem::path& existing, const std::filesystem::path& destination, IProgressCallback& progress);
+
+        // Gets a value indicating whether the package contains the given payload file.
+        bool ContainsFile(std::string_view packageFile);
+
         // Writes the package's manifest to the given path.
         void WriteManifestToFile(const std::filesystem::path& target, IProgressCallback& progress);
 
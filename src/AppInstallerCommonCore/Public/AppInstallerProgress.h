@@ -40,6 +40,13 @@ namespace AppInstaller
 
         // Called as progress ends.
         virtual void EndProgress(bool hideProgressWhenDone) = 0;
+
+        // Called by work that can stop at a safe point and later continue from it, such as a download between chunks.
+        // Returns true if the work should release what it holds open there and call WaitWhilePaused.
+        virtual bool IsPauseRequested() { return false; }
+
+        // Blocks until the paused work can continue.
+        virtual void WaitWhilePaused() {}
     };
 
     // Callback interface given to the worker to report to.
@@ -88,6 +95,21 @@ namespace AppInstaller
             }
         };
 
+        bool IsPauseRequested() override
+        {
+            IProgressSink* sink = GetSink();
+            return sink && !m_cancelled.load() && sink->IsPauseRequested();
+        }
+
+        void WaitWhilePaused() override
+        {
+            IProgressSink* sink = GetSink();
+            if (sink)
+            {
+                sink->WaitWhilePaused();
+            }
+        }
+
         bool IsCancelled() override
         {
             return m_cancelled.load();
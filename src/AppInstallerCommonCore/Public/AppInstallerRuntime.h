@@ -46,6 +46,8 @@ namespace AppInstaller::Runtime
         SecureSettings,
         // The value of %USERPROFILE%.
         UserProfile,
+        // The default location of the machine wide installer cache.
+        InstallerCache,
     };
 
     // Gets the path to the requested location.
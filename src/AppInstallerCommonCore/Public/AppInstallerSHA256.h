@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 #pragma once
 
+#include <filesystem>
 #include <memory>
 #include <string>
 #include <vector>
@@ -53,6 +54,9 @@ namespace AppInstaller::Utility {
         // Computes the hash from a given stream.
         static HashBuffer ComputeHash(std::istream& in);
 
+        // Computes the hash of the given file by mapping it into memory.
+        static HashBuffer ComputeHashFromFile(const std::filesystem::path& path);
+
         static std::string ConvertToString(const HashBuffer& hashBuffer);
 
         static HashBuffer ConvertToBytes(const std::string& hashStr);
@@ -86,6 +86,12 @@ namespace AppInstaller::Utility
     // Determines if string a starts with string b, using ICU for case folding.
     bool ICUCaseInsensitiveStartsWith(std::string_view a, std::string_view b);
 
+    // Determines if the string contains only ASCII characters, which all normalization forms leave unchanged.
+    bool IsASCII(std::string_view input);
+
+    // Determines if the string contains only printable ASCII characters, each of which is one column of terminal output.
+    bool IsPrintableASCII(std::string_view input);
+
     // Returns the number of grapheme clusters (characters) in an UTF8-encoded string.
     size_t UTF8Length(std::string_view input);
 
@@ -102,6 +108,10 @@ namespace AppInstaller::Utility
     // Get the lower case version of the given std::string
     std::string ToLower(std::string_view in);
 
+    // Get the lower case version of the given string, which is the input itself if it has no upper case characters.
+    // Otherwise the result is written to the buffer and the returned view references it.
+    std::string_view ToLower(std::string_view in, std::string& buffer);
+
     // Get the lower case version of the given std::wstring
     std::wstring ToLower(std::wstring_view in);
 
@@ -109,10 +119,26 @@ namespace AppInstaller::Utility
     // See https://unicode-org.github.io/icu/userguide/transforms/casemappings.html#case-folding
     std::string FoldCase(std::string_view input);
 
+    // Folds the case of the given string, which is the input itself if it is ASCII with no upper case characters.
+    // Otherwise the result is written to the buffer and the returned view references it.
+    std::string_view FoldCase(std::string_view input, std::string& buffer);
+
     // Folds the case of the given NormalizedString, returning it as also Normalized
     // See https://unicode-org.github.io/icu/userguide/transforms/casemappings.html#case-folding
     NormalizedString FoldCase(const NormalizedString& input);
 
+    // Folds the case of each code point of the given string on its own, with the simple folding that SQLite's ICU LIKE uses.
+    // Unlike FoldCase, a code point is never expanded to many (such as the sharp s to "ss"), so the matches of LIKE can be reproduced.
+    std::string FoldCaseByCodePoint(std::string_view input);
+
+    // Gets the edit (Levenshtein) distance between the two strings, comparing them byte by byte.
+    // Any distance above maxDistance is reported as maxDistance + 1.
+    size_t BoundedEditDistance(std::string_view a, std::string_view b, size_t maxDistance);
+
+    // Gets the lowest edit distance between the pattern and any substring of the value, comparing them byte by byte.
+    // Any distance above maxDistance is reported as maxDistance + 1.
+    size_t BoundedSubstringEditDistance(std::string_view value, std::string_view pattern, size_t maxDistance);
+
     // Checks if the input string is empty or whitespace
     bool IsEmptyOrWhitespace(std::string_view str);
     bool IsEmptyOrWhitespace(std::wstring_view str);
@@ -6,6 +6,7 @@
 #include <wil/resource.h>
 
 #include <chrono>
+#include <functional>
 #include <string_view>
 #include <vector>
 
@@ -16,9 +17,10 @@ namespace AppInstaller::Synchronization
 {
     // A fairly simple cross process (same session) reader-writer lock.
     // The primary purpose is for sources to control access to their backing stores.
+    // It is built from named mutexes so that the lock held by a process that exits is released by the system.
     // Due to this design goal, these limitations exist:
     // - Starves new readers when a writer comes in.
-    // - Readers are limited to an arbitrarily chosen limit.
+    // - Concurrent readers are limited to GetMaximumReaderCount(), the most that a single wait can cover.
     // - Not re-entrant (although repeated read locking will work, it will consume additional slots).
     // - No upgrade from reader to writer.
     //      In order to change from reader/write, one must release and reacquire the lock:
@@ -50,9 +52,63 @@ namespace AppInstaller::Synchronization
 
         void Release();
 
+        // Gets the number of readers that can hold the lock at the same time.
+        static size_t GetMaximumReaderCount();
+
     private:
         static CrossProcessReaderWriteLock Lock(bool shared, std::string_view name, std::chrono::milliseconds timeout, IProgressCallback* progress);
 
         std::vector<wil::unique_mutex> m_mutexesHeld;
     };
+
+    // A claim on some work, shared by the processes of the session, that lasts for a period after it is made.
+    // The claim is a tick count in a small named shared memory section that is set with a compare-exchange,
+    // so a process never waits on another to find out whether it should do the work.
+    // The section only exists while a process has it open, so claims only coordinate processes that are running at the same time.
+    struct CrossProcessClaim
+    {
+        // Create an unclaimed object.
+        CrossProcessClaim() = default;
+
+        CrossProcessClaim(const CrossProcessClaim&) = delete;
+        CrossProcessClaim& operator=(const CrossProcessClaim&) = delete;
+
+        CrossProcessClaim(CrossProcessClaim&&) = default;
+        CrossProcessClaim& operator=(CrossProcessClaim&&) = default;
+
+        // Attempts to claim the named work. Fails only if another claim on it was made within the period;
+        // when the claims cannot be shared at all, the work is claimed so that it is still done.
+        static CrossProcessClaim TryClaim(std::string_view name, std::chrono::milliseconds period);
+
+        // Gives up the claim, if it has not been replaced, so that another process can take the work.
+        void Abandon();
+
+        operator bool() const { return m_claimed; }
+
+    private:
+        bool m_claimed = false;
+        int64_t m_claimTime = 0;
+        wil::unique_handle m_section;
+        wil::unique_mapview_ptr<LONG64> m_view;
+    };
+
+    // The kinds of work run on the process-wide thread pool; each has threads of its own, so that one kind does not hold up the other.
+    enum class WorkLane
+    {
+        // Work that keeps a processor busy, which runs on no more threads than there are processors.
+        Cpu,
+        // Work that spends most of its time waiting, such as on the network.
+        Io,
+    };
+
+    // Queues the work to run on the given lane of the process-wide thread pool.
+    // Anything thrown by the work is logged and otherwise ignored.
+    void SubmitWork(WorkLane lane, std::function<void()> work);
+
+    // Gets the callback environment of the given lane, for thread pool objects that are created directly.
+    PTP_CALLBACK_ENVIRON GetWorkLaneEnvironment(WorkLane lane);
+
+    // Calls func for each index in [0, count) on the caller and on the Cpu lane of the thread pool, with sub globals of the caller's thread globals.
+    // Returns once every call has completed; if any call throws, the exception for the lowest index is rethrown.
+    void RunConcurrently(size_t count, const std::function<void(size_t)>& func);
 }
@@ -4,6 +4,7 @@
 #include <AppInstallerLanguageUtilities.h>
 #include <wil/result_macros.h>
 
+#include <chrono>
 #include <string_view>
 #include <vector>
 #include <cguid.h>
@@ -122,6 +123,17 @@ namespace AppInstaller::Logging
         // LogNonFatalDOError
         std::string DOUrl;
         HRESULT DOHResult = S_OK;
+
+        // LogCompressedRestResponse; these are totals over all of the responses.
+        UINT64 RestCompressedBytes = 0;
+        UINT64 RestDecompressedBytes = 0;
+
+        // LogRestRequest
+        UINT64 RestRequestCount = 0;
+
+        // LogManifestCacheResult
+        UINT64 ManifestCacheHits = 0;
+        UINT64 ManifestCacheMisses = 0;
     };
 
     // This type contains the registration lifetime of the telemetry trace logging provider.
@@ -252,6 +264,30 @@ namespace AppInstaller::Logging
 
         void LogNonFatalDOError(std::string_view url, HRESULT hr) const noexcept;
 
+        // Logs the size of a compressed response from a REST source, as received and after decompression.
+        void LogCompressedRestResponse(std::string_view encoding, uint64_t compressedBytes, uint64_t decompressedBytes) const noexcept;
+
+        // Logs the time taken to open a source, and whether it was updated before being opened.
+        void LogSourceOpen(std::string_view sourceIdentifier, std::string_view sourceType, std::chrono::milliseconds duration, bool updated) const noexcept;
+
+        // Logs an attempt to update a source, with the bytes received over the network while it ran.
+        void LogSourceUpdate(std::string_view sourceIdentifier, std::string_view sourceType, bool isBackground, bool succeeded, std::chrono::milliseconds duration, uint64_t bytesReceived) const noexcept;
+
+        // Logs the time taken by the search of a single source within a composite search.
+        void LogSourceSearch(std::string_view sourceIdentifier, std::chrono::milliseconds duration, uint64_t resultCount) const noexcept;
+
+        // Counts a request sent to a REST source; the count is reported in the summary.
+        void LogRestRequest() const noexcept;
+
+        // Counts a lookup in the manifest cache; the hits and misses are reported in the summary.
+        void LogManifestCacheResult(bool hit) const noexcept;
+
+        // Logs a change to the number of downloads that may run at once, with the measurements that it was based on.
+        void LogDownloadConcurrencyChange(uint32_t previousLimit, uint32_t newLimit, uint64_t bytesPerSecond, uint32_t activeDownloads, uint32_t activeHosts) const noexcept;
+
+        // Logs a trim of the memory of the process, with its working set before and after.
+        void LogMemoryTrim(size_t trimFunctionCount, uint64_t workingSetBefore, uint64_t workingSetAfter) const noexcept;
+
     protected:
         bool IsTelemetryEnabled() const noexcept;
 
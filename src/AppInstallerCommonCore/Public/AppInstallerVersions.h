@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation.
 // Licensed under the MIT License.
 #pragma once
+#include <cstdint>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -58,6 +59,14 @@ namespace AppInstaller::Utility
         // Returns a Version that will return true for IsUnknown
         static Version CreateUnknown();
 
+        // Gets a binary key for the version that orders and compares equal exactly as the Version does,
+        // when compared byte by byte (memcmp, or as a SQLite blob), with a shorter key that is a prefix being less.
+        // The key is laid out as a type byte (Unknown, known, Latest), then for each part:
+        //  a marker byte, the integer as a length byte followed by its big-endian significant bytes,
+        //  and the supplemental value, with an empty one sorting after any other.
+        // A final byte ends the parts so that versions with fewer parts sort first.
+        std::vector<uint8_t> GetSortKey() const;
+
         // An individual version part in between split characters.
         struct Part
         {
@@ -109,7 +118,7 @@ namespace AppInstaller::Utility
     //  2.0, "alpha"
     struct VersionAndChannel
     {
-        VersionAndChannel() = default;
+        VersionAndChannel() : m_versionSortKey(m_version.GetSortKey()) {}
         VersionAndChannel(Version&& version, Channel&& channel);
 
         const Version& GetVersion() const { return m_version; }
@@ -117,6 +126,7 @@ namespace AppInstaller::Utility
 
         std::string ToString() const;
 
+        // Compares the channels, then the sort keys of the versions rather than their parts.
         bool operator<(const VersionAndChannel& other) const;
 
         // A convenience function to make more semantic sense at call sites over the somewhat awkward less than ordering.
@@ -125,5 +135,6 @@ namespace AppInstaller::Utility
     private:
         Version m_version;
         Channel m_channel;
+        std::vector<uint8_t> m_versionSortKey;
     };
 }
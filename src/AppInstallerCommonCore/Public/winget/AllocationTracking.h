@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Enable this, or define it to 1 for the build, to replace the global operator new and delete of each binary that uses
+// the tracking, so that allocations are counted by the subsystem that made them. It adds a header to every allocation.
+#ifndef WINGET_ALLOCATION_TRACKING_ENABLED
+#define WINGET_ALLOCATION_TRACKING_ENABLED 0
+#endif
+
+namespace AppInstaller::Memory
+{
+    // The subsystems that allocations are counted for.
+    enum class AllocationSubsystem
+    {
+        // Allocations made outside of the scope of any other subsystem.
+        Other,
+        SQLite,
+        Yaml,
+        RestJson,
+        CompositeSearch,
+        WinRT,
+        Max
+    };
+
+    // Gets the name of the subsystem.
+    std::string_view ToString(AllocationSubsystem subsystem);
+
+    // The allocations counted for a subsystem.
+    struct AllocationCounts
+    {
+        Memory::AllocationSubsystem Subsystem;
+        uint64_t Allocations;
+        uint64_t Frees;
+        int64_t LiveBytes;
+        int64_t PeakLiveBytes;
+    };
+
+    // Determines if allocations are being tracked by this binary.
+    constexpr bool IsAllocationTrackingEnabled() { return WINGET_ALLOCATION_TRACKING_ENABLED != 0; }
+
+    // Gets the counts of the subsystems that have allocated, in subsystem order; empty when tracking is not enabled.
+    std::vector<AllocationCounts> GetAllocationCounts();
+
+    // Writes the counts as trace events; for long lived processes, a series of them shows which subsystem keeps growing.
+    void TraceAllocationCounts();
+
+    // Counts memory that a subsystem allocates without operator new, such as from the allocator of SQLite.
+    // The memory is freed by recording it again with the size negated.
+    void RecordExternalAllocation(AllocationSubsystem subsystem, int64_t bytes);
+
+    // Counts the allocations made by this thread against the subsystem, until it is destroyed.
+    // The innermost scope wins, so a subsystem that calls into another counts only what it allocates itself.
+    // Frees are counted against the subsystem that made the allocation, whichever scope they happen in.
+    struct AllocationScope
+    {
+#if WINGET_ALLOCATION_TRACKING_ENABLED
+        explicit AllocationScope(AllocationSubsystem subsystem);
+
+        ~AllocationScope();
+
+    private:
+        AllocationSubsystem m_previous;
+#else
+        explicit AllocationScope(AllocationSubsystem) {}
+#endif
+
+    public:
+        AllocationScope(const AllocationScope&) = delete;
+        AllocationScope& operator=(const AllocationScope&) = delete;
+
+        AllocationScope(AllocationScope&&) = delete;
+        AllocationScope& operator=(AllocationScope&&) = delete;
+    };
+}
@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace AppInstaller::Utility
+{
+    // Schedules the bytes that any number of receivers get, one after another, so that together they stay within a rate.
+    // Each receiver is told when it may continue. Bytes may arrive up to the burst ahead of the rate, so that a slow start
+    // does not go unused and short reads are not each delayed; time that passes unused is not saved up.
+    struct BandwidthSchedule
+    {
+        using clock = std::chrono::steady_clock;
+
+        static constexpr std::chrono::milliseconds AllowedBurst{ 500 };
+
+        BandwidthSchedule() = default;
+
+        BandwidthSchedule(const BandwidthSchedule&) = delete;
+        BandwidthSchedule& operator=(const BandwidthSchedule&) = delete;
+
+        // Schedules the bytes received after those received before them, and returns when the receiver may continue.
+        // A rate of 0 is unlimited; the bytes are not scheduled, and the receiver continues at once.
+        clock::time_point Schedule(uint64_t count, uint64_t bytesPerSecond, clock::time_point now = clock::now())
+        {
+            if (!bytesPerSecond || !count)
+            {
+                return now;
+            }
+
+            std::lock_guard<std::mutex> lock{ m_lock };
+            m_nextAvailable = std::max(m_nextAvailable, now) + std::chrono::microseconds(count * 1000000 / bytesPerSecond);
+            return std::max(now, m_nextAvailable - AllowedBurst);
+        }
+
+    private:
+        std::mutex m_lock;
+        clock::time_point m_nextAvailable;
+    };
+}
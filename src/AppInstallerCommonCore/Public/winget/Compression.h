@@ -0,0 +1,17 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace AppInstaller::Compression
+{
+    // Compresses the text with the system compression API (MSZIP), for storage that Decompress can read back.
+    std::vector<uint8_t> Compress(std::string_view text);
+
+    // Decompresses data produced by Compress.
+    std::string Decompress(const std::vector<uint8_t>& compressed);
+}
@@ -27,16 +27,18 @@ namespace AppInstaller::Manifest
 
         std::vector<Dependency> GetInstallationOrder();
 
-    private:
-        // TODO make this function iterative
-        bool HasLoopDFS(std::set<Dependency> visited, const Dependency& node);
+        // Gets the installation order split in levels. The nodes of a level only depend on nodes of earlier levels,
+        // so they can be installed in any order, or at the same time, once the earlier levels are installed.
+        std::vector<std::vector<Dependency>> GetInstallationLevels();
 
+    private:
         const Dependency& m_root;
         std::map<Dependency, std::set<Dependency>> m_adjacents;
         std::function<const DependencyList(const Dependency&)> getDependencies;
         bool m_HasLoop = false;
         bool m_rootDependencyEvaluated = false;
         std::vector<Dependency> m_installationOrder;
+        std::vector<std::vector<Dependency>> m_installationLevels;
         std::vector<Dependency> m_toCheck;
     };
 }
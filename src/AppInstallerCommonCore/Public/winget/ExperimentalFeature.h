@@ -23,6 +23,9 @@ namespace AppInstaller::Settings
             Dependencies = 0x1,
             // Before making DirectMSI non-experimental, it should be part of manifest validation.
             DirectMSI = 0x2,
+            StreamingMsix = 0x4,
+            ExtractSourceUpdates = 0x8,
+            CacheCommand = 0x10,
             Max, // This MUST always be after all experimental features
 
             // Features listed after Max will not be shown with the features command
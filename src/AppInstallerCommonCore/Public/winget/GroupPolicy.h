@@ -21,6 +21,11 @@ namespace AppInstaller::Settings
         SourceAutoUpdateIntervalInMinutes,
         AdditionalSources,
         AllowedSources,
+        InstallerCacheLocation,
+        InstallerCacheMaximumSizeInMB,
+        MaximumConcurrentDownloads,
+        DownloadBandwidthLimitInKBps,
+        BackgroundDownloads,
         Max,
     };
 
@@ -140,6 +145,11 @@ namespace AppInstaller::Settings
 
         POLICY_MAPPING_LIST_SPECIALIZATION(ValuePolicy::AdditionalSources, SourceFromPolicy, "AdditionalSources"sv);
         POLICY_MAPPING_LIST_SPECIALIZATION(ValuePolicy::AllowedSources, SourceFromPolicy, "AllowedSources"sv);
+        POLICY_MAPPING_VALUE_SPECIALIZATION(ValuePolicy::InstallerCacheLocation, std::string, "InstallerCacheLocation"sv, Registry::Value::Type::String);
+        POLICY_MAPPING_VALUE_SPECIALIZATION(ValuePolicy::InstallerCacheMaximumSizeInMB, uint32_t, "InstallerCacheMaximumSizeInMB"sv, Registry::Value::Type::DWord);
+        POLICY_MAPPING_VALUE_SPECIALIZATION(ValuePolicy::MaximumConcurrentDownloads, uint32_t, "MaximumConcurrentDownloads"sv, Registry::Value::Type::DWord);
+        POLICY_MAPPING_VALUE_SPECIALIZATION(ValuePolicy::DownloadBandwidthLimitInKBps, uint32_t, "DownloadBandwidthLimitInKBps"sv, Registry::Value::Type::DWord);
+        POLICY_MAPPING_VALUE_SPECIALIZATION(ValuePolicy::BackgroundDownloads, bool, "BackgroundDownloads"sv, Registry::Value::Type::DWord);
     }
 
     // Representation of the policies read from the registry.
@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <AppInstallerSHA256.h>
+
+#include <filesystem>
+#include <optional>
+
+namespace AppInstaller::Utility
+{
+    // A machine wide cache of installers, keyed by their SHA256 hash.
+    // The least recently used installers are removed when the cache grows beyond its maximum size.
+    struct InstallerCache
+    {
+        InstallerCache(std::filesystem::path root, uint64_t maximumSizeInBytes);
+
+        // Gets the installer cache if it is enabled by the InstallerCache admin setting.
+        // The location and maximum size may be set by Group Policy.
+        static std::optional<InstallerCache> GetDefault();
+
+        // Copies the cached installer with the given hash to the target path.
+        // Returns false if there is no such installer, or if the copied file does not have the hash.
+        bool TryGet(const SHA256::HashBuffer& hash, const std::filesystem::path& target) const;
+
+        // Adds the installer at the given path, which must have the given hash, to the cache.
+        void Add(const SHA256::HashBuffer& hash, const std::filesystem::path& source) const;
+
+        // Removes the least recently used installers until the cache is within its maximum size.
+        void Trim() const;
+
+        const std::filesystem::path& GetRoot() const { return m_root; }
+
+    private:
+        std::filesystem::path GetEntryPath(const SHA256::HashBuffer& hash) const;
+
+        std::filesystem::path m_root;
+        uint64_t m_maximumSizeInBytes;
+    };
+}
@@ -15,10 +15,12 @@ namespace AppInstaller::Locale
 
     // Get a score of language distance between target and available. The return value range is 0 to 1.
     // With 1 meaning perfect match and 0 meaning no match.
+    // The score for each pair of tags is computed once per process.
     double GetDistanceOfLanguage(std::string_view target, std::string_view available);
 
     // Get the list of user Preferred Languages from settings. Returns an empty vector in rare cases of failure.
-    std::vector<std::string> GetUserPreferredLanguages();
+    // The list is read once per process.
+    const std::vector<std::string>& GetUserPreferredLanguages();
 
     // Get the bcp47 tag from a locale id. Returns empty string if conversion can not be performed.
     std::string LocaleIdToBcp47Tag(LCID localeId);
@@ -263,8 +263,10 @@ bool HasExtension(std::string_view extension) const;
     bool IsInstallerTypeCompatible(InstallerTypeEnum type1, InstallerTypeEnum type2);
 
     // Get a list of default switches for known installer types
-    std::map<InstallerSwitchType, Utility::NormalizedString> GetDefaultKnownSwitches(InstallerTypeEnum installerType);
+    // The lists are created once and shared by every caller.
+    const std::map<InstallerSwitchType, Utility::NormalizedString>& GetDefaultKnownSwitches(InstallerTypeEnum installerType);
 
     // Get a list of default return codes for known installer types
-    std::map<DWORD, ExpectedReturnCodeEnum> GetDefaultKnownReturnCodes(InstallerTypeEnum installerType);
+    // The lists are created once and shared by every caller.
+    const std::map<DWORD, ExpectedReturnCodeEnum>& GetDefaultKnownReturnCodes(InstallerTypeEnum installerType);
 }
\ No newline at end of file
@@ -0,0 +1,23 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <winget/Manifest.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace AppInstaller::Manifest
+{
+    // A compact description of the installers of a manifest, holding only the values needed to determine
+    // whether any of them can apply to this system: architecture, installer type, scope, minimum OS version
+    // and markets. It is stored alongside the manifest so that applicability can be checked without it.
+    //
+    // Each installer is written as `arch|type|scope|minOSVersion|allowedMarkets|excludedMarkets`, with the
+    // markets separated by ',' and the installers by ';'. Installers with identical values are written once.
+    std::string CreateInstallerSummary(const Manifest& manifest);
+
+    // Reads a summary created by CreateInstallerSummary back into installers that have only the summarized values set.
+    // Returns an empty result if the summary is empty or cannot be read, in which case the manifest itself must be used.
+    std::vector<ManifestInstaller> ParseInstallerSummary(std::string_view summary);
+}
@@ -1,10 +1,15 @@
 // Copyright (c) Microsoft Corporation.
 // Licensed under the MIT License.
 #pragma once
+#include <AppInstallerStrings.h>
 #include <winget/Manifest.h>
 #include <winget/ManifestValidation.h>
 #include <winget/Yaml.h>
 
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+
 namespace AppInstaller::Manifest
 {
     struct ManifestYamlPopulator
@@ -24,23 +29,49 @@ namespace AppInstaller::Manifest
         struct FieldProcessInfo
         {
             FieldProcessInfo(std::string name, std::function<std::vector<ValidationError>(const YAML::Node&)> func, bool requireVerifiedPublisher = false) :
-                Name(std::move(name)), ProcessFunc(func), RequireVerifiedPublisher(requireVerifiedPublisher) {}
+                Name(std::move(name)), LowerName(Utility::ToLower(Name)), ProcessFunc(func), RequireVerifiedPublisher(requireVerifiedPublisher) {}
 
             std::string Name;
+            // Fields are matched case insensitively, so the lower case name is kept to match against.
+            std::string LowerName;
             std::function<std::vector<ValidationError>(const YAML::Node&)> ProcessFunc;
             bool RequireVerifiedPublisher = false;
         };
 
-        std::vector<FieldProcessInfo> RootFieldInfos;
-        std::vector<FieldProcessInfo> InstallerFieldInfos;
-        std::vector<FieldProcessInfo> SwitchesFieldInfos;
-        std::vector<FieldProcessInfo> ExpectedReturnCodesFieldInfos;
-        std::vector<FieldProcessInfo> DependenciesFieldInfos;
-        std::vector<FieldProcessInfo> PackageDependenciesFieldInfos;
-        std::vector<FieldProcessInfo> LocalizationFieldInfos;
-        std::vector<FieldProcessInfo> AgreementFieldInfos;
-        std::vector<FieldProcessInfo> MarketsFieldInfos;
-        std::vector<FieldProcessInfo> AppsAndFeaturesEntryFieldInfos;
+        // The fields for a node, indexed by their lower case name so that each key is a single lookup.
+        struct FieldProcessInfoTable
+        {
+            FieldProcessInfoTable() = default;
+            FieldProcessInfoTable(std::vector<FieldProcessInfo>&& fields);
+
+            // The index references the names in the fields, so the table is only moved.
+            FieldProcessInfoTable(const FieldProcessInfoTable&) = delete;
+            FieldProcessInfoTable& operator=(const FieldProcessInfoTable&) = delete;
+
+            FieldProcessInfoTable(FieldProcessInfoTable&&) = default;
+            FieldProcessInfoTable& operator=(FieldProcessInfoTable&&) = default;
+
+            // Gets the index of the field with the given lower case name, or nullopt if there is none.
+            std::optional<size_t> Find(std::string_view lowerName) const;
+
+            const FieldProcessInfo& operator[](size_t index) const { return m_fields[index]; }
+            size_t size() const { return m_fields.size(); }
+
+        private:
+            std::vector<FieldProcessInfo> m_fields;
+            std::unordered_map<std::string_view, size_t> m_index;
+        };
+
+        FieldProcessInfoTable RootFieldInfos;
+        FieldProcessInfoTable InstallerFieldInfos;
+        FieldProcessInfoTable SwitchesFieldInfos;
+        FieldProcessInfoTable ExpectedReturnCodesFieldInfos;
+        FieldProcessInfoTable DependenciesFieldInfos;
+        FieldProcessInfoTable PackageDependenciesFieldInfos;
+        FieldProcessInfoTable LocalizationFieldInfos;
+        FieldProcessInfoTable AgreementFieldInfos;
+        FieldProcessInfoTable MarketsFieldInfos;
+        FieldProcessInfoTable AppsAndFeaturesEntryFieldInfos;
 
         // These pointers are referenced in the processing functions in manifest field process info table.
         AppInstaller::Manifest::Manifest* m_p_manifest = nullptr;
@@ -75,7 +106,7 @@ namespace AppInstaller::Manifest
         // pair ourselves. This also helps with generating aggregated error rather than throwing on first failure.
         std::vector<ValidationError> ValidateAndProcessFields(
             const YAML::Node& rootNode,
-            const std::vector<FieldProcessInfo>& fieldInfos);
+            const FieldProcessInfoTable& fieldInfos);
 
         void ProcessDependenciesNode(DependencyType type, const YAML::Node& rootNode);
         std::vector<ValidationError> ProcessPackageDependenciesNode(const YAML::Node& rootNode);
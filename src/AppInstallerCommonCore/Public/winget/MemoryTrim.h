@@ -0,0 +1,23 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <chrono>
+#include <functional>
+
+namespace AppInstaller::Memory
+{
+    // Registers a function that releases memory which is only kept to make later work faster, such as caches.
+    // Whatever it releases must be recreated on demand, and it may be called while other threads use it.
+    // The functions are called each time the process trims its memory, and are never unregistered.
+    void RegisterTrimFunction(std::function<void()> trimFunction);
+
+    // Calls the registered functions, then returns freed heap memory and the working set of the process to the system.
+    void Trim();
+
+    // Records that the process is doing work, which delays the next idle trim.
+    void NotifyActivity();
+
+    // Trims the memory of the process once it has been idle for the given period, and again after each later period
+    // of work followed by the same idle period. Intended for long lived processes like the COM server.
+    void EnableIdleTrim(std::chrono::milliseconds idlePeriod);
+}
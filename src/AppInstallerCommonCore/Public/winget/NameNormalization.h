@@ -15,6 +15,10 @@ namespace AppInstaller::Utility
         Initial,
     };
 
+    // Gets a value that identifies the rules used by the given normalization version.
+    // This changes whenever the output of that version changes, so that persisted normalized values can be invalidated.
+    std::string_view GetNormalizationRulesIdentifier(NormalizationVersion version);
+
     struct NameNormalizer;
 
     // A package publisher and name that has been normalized, allowing direct
@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <wil/resource.h>
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace AppInstaller
+{
+    // Gathers progress updates from the thread doing the work, for another thread to deliver to a listener
+    // that may be slow or remote.
+    // Updates that change the state of the operation are always delivered, in order. Other updates are delivered
+    // at most once per interval, and only the latest is kept until then, so a listener that falls behind only
+    // misses intermediate values.
+    template <typename T>
+    struct ProgressCoalescer
+    {
+        using clock = std::chrono::steady_clock;
+
+        explicit ProgressCoalescer(clock::duration minimumInterval) : m_minimumInterval(minimumInterval) {}
+
+        ProgressCoalescer(const ProgressCoalescer&) = delete;
+        ProgressCoalescer& operator=(const ProgressCoalescer&) = delete;
+
+        // Adds an update, and signals the event.
+        // A transition replaces any update that is still waiting behind the interval, as it is newer.
+        void Post(T value, bool isTransition)
+        {
+            {
+                std::lock_guard<std::mutex> lock{ m_lock };
+                if (isTransition)
+                {
+                    m_latest.reset();
+                    m_transitions.emplace_back(std::move(value));
+                }
+                else
+                {
+                    m_latest = std::move(value);
+                }
+            }
+
+            m_event.SetEvent();
+        }
+
+        // Signaled when an update has been posted.
+        HANDLE GetEvent() const { return m_event.get(); }
+
+        // Takes the updates that should be delivered now.
+        std::vector<T> TakeUpdates(clock::time_point now = clock::now())
+        {
+            std::vector<T> result;
+
+            std::lock_guard<std::mutex> lock{ m_lock };
+            while (!m_transitions.empty())
+            {
+                result.emplace_back(std::move(m_transitions.front()));
+                m_transitions.pop_front();
+            }
+
+            if (m_latest && (!result.empty() || !m_lastDelivery || now - *m_lastDelivery >= m_minimumInterval))
+            {
+                // A transition is being delivered anyway, so any later update can follow it.
+                result.emplace_back(std::move(m_latest.value()));
+                m_latest.reset();
+            }
+
+            if (!result.empty())
+            {
+                m_lastDelivery = now;
+            }
+
+            return result;
+        }
+
+        // Gets the time until an update that is being held back should be delivered, if there is one.
+        std::optional<clock::duration> GetTimeUntilNextUpdate(clock::time_point now = clock::now()) const
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+            if (!m_latest || !m_lastDelivery)
+            {
+                return {};
+            }
+
+            auto due = *m_lastDelivery + m_minimumInterval;
+            return (due > now ? due - now : clock::duration::zero());
+        }
+
+    private:
+        clock::duration m_minimumInterval;
+        wil::unique_event m_event{ wil::EventOptions::None };
+        mutable std::mutex m_lock;
+        std::deque<T> m_transitions;
+        std::optional<T> m_latest;
+        std::optional<clock::time_point> m_lastDelivery;
+    };
+}
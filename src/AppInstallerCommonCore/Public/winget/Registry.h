@@ -62,12 +62,14 @@ namespace AppInstaller::Registry
 
     struct Key;
     struct ValueList;
+    struct ValueSet;
 
     // A registry value.
     struct Value
     {
         friend Key;
         friend ValueList;
+        friend ValueSet;
 
         // The type of data stored in the Value.
         enum class Type : DWORD
@@ -177,6 +179,43 @@ namespace AppInstaller::Registry
         wil::shared_hkey m_key;
     };
 
+    // All of the values of a key, read in a single sweep over them into one buffer.
+    // Looking up a number of values this way takes one registry call per value in the key,
+    // rather than the several calls per name that Key::operator[] needs to size its buffer.
+    struct ValueSet
+    {
+        friend Key;
+
+        ValueSet() = default;
+
+        // Gets the value with the given name; names are compared case insensitively, as the registry does.
+        std::optional<Value> operator[](std::string_view name) const;
+        std::optional<Value> operator[](std::wstring_view name) const;
+
+        // The number of values that were read.
+        size_t size() const { return m_entries.size(); }
+        bool empty() const { return m_entries.empty(); }
+
+    private:
+        struct Entry
+        {
+            size_t NameOffset;
+            size_t NameLength;
+            DWORD Type;
+            size_t DataOffset;
+            size_t DataLength;
+        };
+
+        // Replaces the contents with the values of the key, reusing the buffers already allocated.
+        void Read(const wil::shared_hkey& key);
+
+        const Entry* Find(std::wstring_view name) const;
+
+        std::wstring m_names;
+        std::vector<BYTE> m_data;
+        std::vector<Entry> m_entries;
+    };
+
     // A registry key.
     struct Key
     {
@@ -198,6 +237,9 @@ namespace AppInstaller::Registry
             // Opens the subkey.
             Key Open() const;
 
+            // Gets the last write time of the subkey, as reported during enumeration.
+            FILETIME LastWriteTime() const { return m_lastWriteTime; }
+
             operator bool() const { return m_parentKey.operator bool(); }
 
         private:
@@ -213,6 +255,7 @@ namespace AppInstaller::Registry
             wil::shared_hkey m_parentKey;
             REGSAM m_access = KEY_READ;
             std::wstring m_subKeyName;
+            FILETIME m_lastWriteTime{};
         };
 
         struct const_iterator
@@ -250,6 +293,12 @@ namespace AppInstaller::Registry
 
         ValueList Values() const;
 
+        // Reads all of the values of the key at once.
+        ValueSet ReadValues() const;
+
+        // Reads all of the values of the key into the given set, reusing its buffers.
+        void ReadValues(ValueSet& values) const;
+
         operator bool() const { return m_key.operator bool(); }
 
         // Open a Key; will return an empty Key if the subkey does not exist.
@@ -68,8 +68,10 @@ namespace AppInstaller::Settings
 
         // The set of sources as defined by the user.
         constexpr static StreamDefinition UserSources{ Type::Secure, "user_sources"sv };
-        // The metadata about all sources.
+        // The metadata about all sources, as YAML; still written by earlier versions.
         constexpr static StreamDefinition SourcesMetadata{ Type::Standard, "sources_metadata"sv };
+        // The metadata about all sources, in a compact form.
+        constexpr static StreamDefinition SourcesMetadataCompact{ Type::Standard, "sources_metadata_compact"sv };
         // The primary user settings file.
         constexpr static StreamDefinition PrimaryUserSettings{ Type::UserFile, "settings.json"sv };
         // The backup user settings file.
@@ -2,6 +2,9 @@
 
 #include <AppInstallerLogging.h>
 #include <AppInstallerTelemetry.h>
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <mutex>
 
 namespace AppInstaller::ThreadLocalStorage
@@ -15,6 +18,7 @@ namespace AppInstaller::ThreadLocalStorage
         ~ThreadGlobals() = default;
 
         // Request that a sub ThreadGlobals be constructed from the given parent.
+        // Sub globals share the loggers of their parent, and only create the telemetry logger for their own activity when it is first used.
         struct create_sub_thread_globals_t {};
         ThreadGlobals(ThreadGlobals& parent, create_sub_thread_globals_t);
 
@@ -29,15 +33,57 @@ namespace AppInstaller::ThreadLocalStorage
         // Return Globals for Current Thread
         static ThreadGlobals* GetForCurrentThread();
 
+        // Cancels the work done with these globals, including that done with any sub globals created from them.
+        // Long running operations, like queries, check this to stop early.
+        void Cancel();
+
+        // Determines whether the work done with these globals, or with their parent, has been cancelled.
+        bool IsCancelled() const;
+
     private:
 
+        // The cancellation of one set of globals, which also reflects that of the globals it was created from.
+        struct CancellationState
+        {
+            std::atomic<bool> Cancelled{ false };
+            std::shared_ptr<const CancellationState> Parent;
+        };
+
         void Initialize();
 
+        // Gets the telemetry logger, creating that of sub globals if it has not been yet.
+        std::shared_ptr<AppInstaller::Logging::TelemetryTraceLogger> GetTelemetryLoggerPtr();
+
         std::shared_ptr<AppInstaller::Logging::DiagnosticLogger> m_pDiagnosticLogger;
-        std::unique_ptr<AppInstaller::Logging::TelemetryTraceLogger> m_pTelemetryLogger;
+        std::shared_ptr<AppInstaller::Logging::TelemetryTraceLogger> m_pTelemetryLogger;
         std::once_flag m_loggerInitOnceFlag;
+        // For sub globals, the logger that their telemetry logger is created from.
+        std::shared_ptr<AppInstaller::Logging::TelemetryTraceLogger> m_pParentTelemetryLogger;
+        std::once_flag m_subTelemetryLoggerInitOnceFlag;
+        // Shared, so that it outlives these globals for any sub globals that do.
+        std::shared_ptr<CancellationState> m_cancellation = std::make_shared<CancellationState>();
+    };
+
+    // Sets the function that reports whether the work on the current thread has been cancelled, for as long as the object lives.
+    // For threads that do not have globals of their own to cancel, such as those of the COM thread pool.
+    struct CancellationCheckScope
+    {
+        CancellationCheckScope(std::function<bool()> isCancelled);
+        ~CancellationCheckScope();
+
+        CancellationCheckScope(const CancellationCheckScope&) = delete;
+        CancellationCheckScope& operator=(const CancellationCheckScope&) = delete;
+
+    private:
+        friend bool IsCurrentThreadCancelled();
+
+        std::function<bool()> m_isCancelled;
+        CancellationCheckScope* m_previous;
     };
 
+    // Determines whether the work on the current thread has been cancelled, through either its globals or a CancellationCheckScope.
+    bool IsCurrentThreadCancelled();
+
     struct PreviousThreadGlobals
     {
         ~PreviousThreadGlobals();
@@ -0,0 +1,152 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace AppInstaller::Timing
+{
+    // The phases of an operation whose time is measured.
+    enum class Phase
+    {
+        SourceOpen,
+        SourceUpdate,
+        InstalledIndexBuild,
+        CompositeCorrelation,
+        ManifestFetch,
+        Download,
+        Hash,
+        Install,
+        Max
+    };
+
+    // Gets the name of the phase.
+    std::string_view ToString(Phase phase);
+
+    // The steps of starting the CLI process, in the order that they complete.
+    enum class StartupStep
+    {
+        CoreMainEntered,
+        ApartmentInitialized,
+        ContextCreated,
+        LoggingInitialized,
+        TelemetryInitialized,
+        CommandFound,
+        ArgumentsValidated,
+        CommandExecuted,
+        Max
+    };
+
+    // Gets the name of the startup step.
+    std::string_view ToString(StartupStep step);
+
+    // Records that the startup step has completed; recording it again replaces the time.
+    // Steps are only recorded by the main thread of the CLI.
+    void RecordStartupStep(StartupStep step);
+
+    // The time at which a startup step completed.
+    struct StartupStepTime
+    {
+        Timing::StartupStep Step;
+        std::chrono::microseconds SinceProcessCreation;
+    };
+
+    // Gets the startup steps that have been recorded, in step order.
+    // The time is measured from the creation of the process, so the first step includes loading the binaries.
+    std::vector<StartupStepTime> GetStartupSteps();
+
+    // The time spent in a phase by this process.
+    struct PhaseTotal
+    {
+        Timing::Phase Phase;
+        std::chrono::microseconds Duration;
+        uint64_t Count;
+    };
+
+    // Enables adding the time of every span to the totals for its phase.
+    void EnableTotals();
+
+    // Gets the totals of the phases that have been measured at least once, in phase order.
+    // Spans on concurrent threads are all added to the total, so it can be longer than the operation took.
+    std::vector<PhaseTotal> GetTotals();
+
+    // Enables counting the resources used by this process, for the report written at the end of a command.
+    // Like the totals, the counts are for the whole process rather than for a thread.
+    void EnableUsage();
+
+    // Determines if the resources used are being counted; the callers check it before gathering what they record.
+    bool IsUsageEnabled();
+
+    // Records the time taken by a workflow task, including the tasks that it ran.
+    void RecordWorkflowTask(std::string_view name, std::chrono::microseconds duration);
+
+    // Records a step of a SQL statement; the first step after the statement is prepared or reset is an execution of it.
+    void RecordSqlStep(bool isExecution, std::chrono::steady_clock::duration duration);
+
+    // Records the bytes of a completed download, by the type of the download.
+    void RecordDownload(std::string_view type, uint64_t bytes);
+
+    // Records a request sent to the host of the url.
+    void RecordHttpRequest(std::string_view url);
+
+    // Records a lookup in the named cache.
+    void RecordCacheLookup(std::string_view cache, bool hit);
+
+    // The resources used by this process while usage was being counted.
+    struct ResourceUsage
+    {
+        struct WorkflowTaskTotal
+        {
+            std::string Name;
+            std::chrono::microseconds Duration{};
+            uint64_t Count = 0;
+        };
+
+        struct CacheLookups
+        {
+            uint64_t Hits = 0;
+            uint64_t Misses = 0;
+        };
+
+        // The workflow tasks, longest first; tasks are named by their type, or by their address when they are functions.
+        std::vector<WorkflowTaskTotal> WorkflowTasks;
+
+        uint64_t SqlExecutions = 0;
+        uint64_t SqlSteps = 0;
+        std::chrono::microseconds SqlStepTime{};
+
+        std::map<std::string, uint64_t> DownloadedBytes;
+        std::map<std::string, uint64_t> HttpRequests;
+        std::map<std::string, CacheLookups> Caches;
+
+        uint64_t PeakWorkingSetBytes = 0;
+    };
+
+    // Gets the resources used so far.
+    ResourceUsage GetUsage();
+
+    // Measures the time spent in a phase, from construction to destruction.
+    // Spans are written as trace events, and added to the totals when they are enabled; when neither
+    // is listening, a span does not even read the clock.
+    struct Span
+    {
+        explicit Span(Phase phase);
+
+        ~Span();
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+        Span(Span&&) = delete;
+        Span& operator=(Span&&) = delete;
+
+    private:
+        Phase m_phase;
+        bool m_enabled;
+        std::chrono::steady_clock::time_point m_start;
+    };
+}
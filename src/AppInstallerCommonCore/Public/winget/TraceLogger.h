@@ -23,5 +23,8 @@ namespace AppInstaller::Logging
         void Write(Channel channel, Level, std::string_view message) noexcept override;
 
         void WriteDirect(std::string_view message) noexcept override;
+
+        // Only active while a trace session is listening to the provider.
+        bool IsActive() const noexcept override;
     };
 }
@@ -5,8 +5,11 @@
 #include "winget/GroupPolicy.h"
 #include "winget/Resources.h"
 
+#include <bitset>
 #include <filesystem>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <type_traits>
@@ -82,6 +85,14 @@ namespace AppInstaller::Settings
         InstallLocaleRequirement,
         EFDirectMSI,
         EnableSelfInitiatedMinidump,
+        NetworkSearchTimeoutInSeconds,
+        NetworkDownloadSegments,
+        EFStreamingMsix,
+        NetworkDownloadAhead,
+        NetworkDownloadBandwidthLimitInKBps,
+        NetworkBackgroundDownloads,
+        EFExtractSourceUpdates,
+        EFCacheCommand,
         Max
     };
 
@@ -131,6 +142,14 @@ namespace AppInstaller::Settings
         SETTINGMAPPING_SPECIALIZATION(Setting::InstallLocaleRequirement, std::vector<std::string>, std::vector<std::string>, {}, ".installBehavior.requirements.locale"sv);
         SETTINGMAPPING_SPECIALIZATION(Setting::EFDirectMSI, bool, bool, false, ".experimentalFeatures.directMSI"sv);
         SETTINGMAPPING_SPECIALIZATION(Setting::EnableSelfInitiatedMinidump, bool, bool, false, ".debugging.enableSelfInitiatedMinidump"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::NetworkSearchTimeoutInSeconds, uint32_t, std::chrono::seconds, 60s, ".network.searchTimeoutInSeconds"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::NetworkDownloadSegments, uint32_t, uint32_t, 4, ".network.downloadSegments"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::EFStreamingMsix, bool, bool, false, ".experimentalFeatures.streamingMsix"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::NetworkDownloadAhead, uint32_t, uint32_t, 1, ".network.downloadAhead"sv);
+        SETTINGMAPPING_SPECIALIZATION_POLICY(Setting::NetworkDownloadBandwidthLimitInKBps, uint32_t, uint32_t, 0, ".network.downloadBandwidthLimitInKBps"sv, ValuePolicy::DownloadBandwidthLimitInKBps);
+        SETTINGMAPPING_SPECIALIZATION_POLICY(Setting::NetworkBackgroundDownloads, bool, bool, false, ".network.backgroundDownloads"sv, ValuePolicy::BackgroundDownloads);
+        SETTINGMAPPING_SPECIALIZATION(Setting::EFExtractSourceUpdates, bool, bool, false, ".experimentalFeatures.extractSourceUpdates"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::EFCacheCommand, bool, bool, false, ".experimentalFeatures.cacheCommand"sv);
 
         // Used to deduce the SettingVariant type; making a variant that includes std::monostate and all SettingMapping types.
         template <size_t... I>
@@ -144,6 +163,8 @@ namespace AppInstaller::Settings
     }
 
     // Representation of the parsed settings file.
+    // The file is parsed when this is created, but each setting is only validated when it is first read,
+    // so that a process that reads few settings does not pay for validating all of them.
     struct UserSettings
     {
         // Jsoncpp doesn't provide line number and column for an individual Json::Value node.
@@ -160,10 +181,16 @@ namespace AppInstaller::Settings
             bool IsFieldWarning = true;
         };
 
+        // Gets the current settings. Once settings are reloaded, this returns the new snapshot; references to
+        // earlier snapshots remain valid for the lifetime of the process.
         static UserSettings const& Instance();
 
         static std::filesystem::path SettingsFilePath();
 
+        // Starts watching the settings files, replacing the current settings with a new snapshot whenever they change.
+        // This is for long lived processes, which would otherwise keep the settings that they started with.
+        static void ReloadOnFileChange();
+
         UserSettings(const UserSettings&) = delete;
         UserSettings& operator=(const UserSettings&) = delete;
 
@@ -171,7 +198,9 @@ namespace AppInstaller::Settings
         UserSettings& operator=(UserSettings&&) = delete;
 
         UserSettingsType GetType() const { return m_type; }
-        std::vector<Warning> const& GetWarnings() const { return m_warnings; }
+
+        // Validates all of the settings to find any warnings about them.
+        std::vector<Warning> const& GetWarnings() const;
 
         void PrepareToShellExecuteFile() const;
 
@@ -179,22 +208,39 @@ namespace AppInstaller::Settings
         template <Setting S>
         typename details::SettingMapping<S>::value_t Get() const
         {
-            auto itr = m_settings.find(S);
-            if (itr == m_settings.end())
+            const details::SettingVariant* value = GetValidated(S);
+            if (!value)
             {
                 return details::SettingMapping<S>::DefaultValue;
             }
 
-            return std::get<details::SettingIndex(S)>(itr->second);
+            return std::get<details::SettingIndex(S)>(*value);
         }
 
     protected:
         UserSettingsType m_type = UserSettingsType::Default;
-        std::vector<Warning> m_warnings;
-        std::map<Setting, details::SettingVariant> m_settings;
+        mutable std::vector<Warning> m_warnings;
+        mutable std::map<Setting, details::SettingVariant> m_settings;
 
         UserSettings();
-        ~UserSettings() = default;
+        ~UserSettings();
+
+        // Validates the setting if it has not been yet, returning its value or null if it has the default value.
+        const details::SettingVariant* GetValidated(Setting setting) const;
+
+        // Validates all of the settings that have not been yet.
+        void ValidateAll() const;
+
+        // Discards the settings read from the file, leaving all of them with their default values.
+        void ResetToDefaults();
+
+    private:
+        struct ParsedFile;
+
+        // The parsed settings file, which is released once every setting has been validated.
+        mutable std::unique_ptr<ParsedFile> m_parsedFile;
+        mutable std::bitset<static_cast<size_t>(Setting::Max)> m_validated;
+        mutable std::recursive_mutex m_lock;
     };
 
     const UserSettings* TryGetUser();
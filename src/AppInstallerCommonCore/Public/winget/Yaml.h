@@ -3,6 +3,7 @@
 #pragma once
 #include <AppInstallerSHA256.h>
 
+#include <algorithm>
 #include <fstream>
 #include <map>
 #include <memory>
@@ -10,6 +11,7 @@
 #include <stack>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <vector>
 
 
@@ -73,11 +75,14 @@ namespace AppInstaller::YAML
         };
 
         Node() : m_type(Type::Invalid) {}
-        Node(Type type, std::string tag, const Mark& mark);
+        Node(Type type, const Mark& mark);
 
         // Sets the scalar value of the node.
         void SetScalar(std::string value);
 
+        // Reserves room for the given number of child nodes in a sequence or mapping.
+        void Reserve(size_t count);
+
         // Adds a child node to the sequence.
         template <typename... Args>
         Node& AddSequenceNode(Args&&... args)
@@ -87,11 +92,19 @@ namespace AppInstaller::YAML
         }
 
         // Adds a child node to the mapping.
+        // The returned reference is only valid until the next child is added.
         template <typename... Args>
         Node& AddMappingNode(Node&& key, Args&&... args)
         {
             Require(Type::Mapping);
-            return m_mapping->emplace(std::move(key), Node(std::forward<Args>(args)...))->second;
+            key.Require(Type::Scalar);
+
+            // The children are kept ordered by key, with duplicate keys in the order they were added
+            auto position = std::upper_bound(m_mapping->begin(), m_mapping->end(), key.m_scalar,
+                [](const std::string& value, const std::pair<Node, Node>& entry) { return value < entry.first.m_scalar; });
+
+            return m_mapping->emplace(position, std::piecewise_construct,
+                std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...))->second;
         }
 
         bool IsDefined() const { return m_type != Type::Invalid; }
@@ -130,11 +143,18 @@ namespace AppInstaller::YAML
         // Gets the nodes in the sequence.
         const std::vector<Node>& Sequence() const;
 
-        // Gets the nodes in the mapping.
-        const std::multimap<Node, Node>& Mapping() const;
+        // Gets the nodes in the mapping, ordered by key.
+        const std::vector<std::pair<Node, Node>>& Mapping() const;
 
     private:
-        Node(std::string_view key) : m_type(Type::Scalar), m_scalar(key) {}
+        // Finds the entries in the mapping with the given key.
+        template <typename MappingType>
+        static auto FindMappingEntries(MappingType& mapping, std::string_view key)
+        {
+            return std::make_pair(
+                std::lower_bound(mapping.begin(), mapping.end(), key, [](const std::pair<Node, Node>& entry, std::string_view value) { return entry.first.m_scalar < value; }),
+                std::upper_bound(mapping.begin(), mapping.end(), key, [](std::string_view value, const std::pair<Node, Node>& entry) { return value < entry.first.m_scalar; }));
+        }
 
         // Require certain node types to; throwing if the requirement is not met.
         void Require(Type type) const;
@@ -146,18 +166,33 @@ namespace AppInstaller::YAML
         bool as_dispatch(bool*) const;
 
         Type m_type;
-        std::string m_tag;
         YAML::Mark m_mark;
         std::string m_scalar;
+        // The children are held contiguously, as the nodes of a document are small and mostly read in order
         std::optional<std::vector<Node>> m_sequence;
-        std::optional<std::multimap<Node, Node>> m_mapping;
+        std::optional<std::vector<std::pair<Node, Node>>> m_mapping;
+    };
+
+    // Limits on the document built by Load, so that the cost of loading any input is bounded.
+    // Aliases are expanded into copies of the anchored node, so without these a small input can build an arbitrarily large document.
+    struct LoadLimits
+    {
+        // The maximum nesting depth of sequences and mappings; the root node is at depth 1.
+        size_t MaximumDepth = 128;
+
+        // The maximum number of nodes in the loaded document, counting every copy made by alias expansion.
+        size_t MaximumNodeCount = 500000;
+
+        // The maximum number of aliases that are expanded.
+        size_t MaximumAliasExpansions = 1000;
     };
 
     // Loads from the input; returns the root node of the first document.
-    Node Load(std::string_view input);
-    Node Load(const std::string& input);
-    Node Load(const std::filesystem::path& input);
-    Node Load(const std::filesystem::path& input, Utility::SHA256::HashBuffer& hashOut);
+    // Throws APPINSTALLER_CLI_ERROR_YAML_LIMIT_EXCEEDED if the document exceeds the given limits.
+    Node Load(std::string_view input, const LoadLimits& limits = {});
+    Node Load(const std::string& input, const LoadLimits& limits = {});
+    Node Load(const std::filesystem::path& input, const LoadLimits& limits = {});
+    Node Load(const std::filesystem::path& input, Utility::SHA256::HashBuffer& hashOut, const LoadLimits& limits = {});
 
     // Any emitter event.
     // Not using enum class to enable existing code to function.
@@ -258,6 +258,94 @@ namespace AppInstaller::Registry
 
     ValueList::ValueList(wil::shared_hkey key) : m_key(key) {}
 
+    std::optional<Value> ValueSet::operator[](std::string_view name) const
+    {
+        return operator[](std::wstring_view{ Utility::ConvertToUTF16(name) });
+    }
+
+    std::optional<Value> ValueSet::operator[](std::wstring_view name) const
+    {
+        const Entry* entry = Find(name);
+        if (!entry)
+        {
+            return {};
+        }
+
+        auto dataBegin = m_data.begin() + entry->DataOffset;
+        return Value{ entry->Type, std::vector<BYTE>(dataBegin, dataBegin + entry->DataLength) };
+    }
+
+    void ValueSet::Read(const wil::shared_hkey& key)
+    {
+        m_names.clear();
+        m_data.clear();
+        m_entries.clear();
+
+        if (!key)
+        {
+            return;
+        }
+
+        DWORD valueCount = 0;
+        DWORD maxNameLength = 0;
+        DWORD maxDataSize = 0;
+        THROW_IF_WIN32_ERROR(RegQueryInfoKeyW(key.get(), nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &valueCount, &maxNameLength, &maxDataSize, nullptr, nullptr));
+
+        m_entries.reserve(valueCount);
+
+        // The maximum name length does not include the null terminator.
+        // Always provide at least a byte of data space, as a null data pointer only queries the size.
+        std::wstring valueName(static_cast<size_t>(maxNameLength) + 1, L'\0');
+        size_t dataSpace = std::max<size_t>(maxDataSize, 1);
+
+        for (DWORD index = 0;;)
+        {
+            size_t dataOffset = m_data.size();
+            m_data.resize(dataOffset + dataSpace);
+
+            DWORD nameLength = wil::safe_cast<DWORD>(valueName.size());
+            DWORD dataSize = wil::safe_cast<DWORD>(dataSpace);
+            DWORD type = REG_NONE;
+            LSTATUS status = RegEnumValueW(key.get(), index, &valueName[0], &nameLength, nullptr, &type, m_data.data() + dataOffset, &dataSize);
+
+            if (status == ERROR_NO_MORE_ITEMS)
+            {
+                m_data.resize(dataOffset);
+                break;
+            }
+            else if (status == ERROR_MORE_DATA)
+            {
+                // A value was written since the key was queried; grow the buffers and read this value again.
+                m_data.resize(dataOffset);
+                THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_MORE_DATA), valueName.size() >= 32768 && dataSize <= dataSpace);
+                valueName.resize(std::min<size_t>(valueName.size() * 2, 32768));
+                dataSpace = std::max<size_t>(dataSpace, dataSize);
+                continue;
+            }
+
+            THROW_IF_WIN32_ERROR(status);
+
+            m_data.resize(dataOffset + dataSize);
+            m_entries.emplace_back(Entry{ m_names.size(), nameLength, type, dataOffset, dataSize });
+            m_names.append(valueName.data(), nameLength);
+            ++index;
+        }
+    }
+
+    const ValueSet::Entry* ValueSet::Find(std::wstring_view name) const
+    {
+        for (const Entry& entry : m_entries)
+        {
+            if (entry.NameLength == name.length() &&
+                CompareStringOrdinal(m_names.data() + entry.NameOffset, wil::safe_cast<int>(entry.NameLength), name.data(), wil::safe_cast<int>(name.length()), TRUE) == CSTR_EQUAL)
+            {
+                return &entry;
+            }
+        }
+
+        return nullptr;
+    }
+
     Key::Key(HKEY key)
     {
         Initialize(key, {}, 0, KEY_READ, false);
@@ -297,7 +385,7 @@ namespace AppInstaller::Registry
         while (m_subKeyName.size() < 4096)
         {
             charCount = wil::safe_cast<DWORD>(m_subKeyName.size());
-            status = RegEnumKeyExW(m_parentKey.get(), index, &m_subKeyName[0], &charCount, nullptr, nullptr, nullptr, nullptr);
+            status = RegEnumKeyExW(m_parentKey.get(), index, &m_subKeyName[0], &charCount, nullptr, nullptr, nullptr, &m_lastWriteTime);
 
             if (status == ERROR_MORE_DATA)
             {
@@ -427,6 +515,18 @@ namespace AppInstaller::Registry
         return { m_key };
     }
 
+    ValueSet Key::ReadValues() const
+    {
+        ValueSet result;
+        result.Read(m_key);
+        return result;
+    }
+
+    void Key::ReadValues(ValueSet& values) const
+    {
+        values.Read(m_key);
+    }
+
     Key Key::OpenIfExists(HKEY key, std::string_view subKey, DWORD options, REGSAM access)
     {
         return OpenIfExists(key, Utility::ConvertToUTF16(subKey), options, access);
@@ -22,6 +22,7 @@ namespace AppInstaller::Runtime
         constexpr std::string_view s_SecureSettings_Base = "Microsoft/WinGet"sv;
         constexpr std::string_view s_SecureSettings_UserRelative = "settings"sv;
         constexpr std::string_view s_SecureSettings_Relative_Unpackaged = "win"sv;
+        constexpr std::string_view s_InstallerCache_Relative = "InstallerCache"sv;
 #ifndef WINGET_DISABLE_FOR_FUZZING
         constexpr std::string_view s_SecureSettings_Relative_Packaged = "pkg"sv;
 #endif
@@ -53,29 +54,41 @@ namespace AppInstaller::Runtime
         }
 
         // Gets the package name; only succeeds if running in a packaged context.
-        std::string GetPackageName()
+        // The identity of the process does not change, so it is only read once.
+        const std::string& GetPackageName()
         {
-            std::unique_ptr<byte[]> buffer = GetPACKAGE_ID();
-            if (!buffer)
+            static std::string s_packageName = []()
             {
-                return {};
-            }
+                std::unique_ptr<byte[]> buffer = GetPACKAGE_ID();
+                if (!buffer)
+                {
+                    return std::string{};
+                }
 
-            PACKAGE_ID* packageId = reinterpret_cast<PACKAGE_ID*>(buffer.get());
-            return Utility::ConvertToUTF8(packageId->name);
+                PACKAGE_ID* packageId = reinterpret_cast<PACKAGE_ID*>(buffer.get());
+                return Utility::ConvertToUTF8(packageId->name);
+            }();
+
+            return s_packageName;
         }
 
         // Gets the package version; only succeeds if running in a packaged context.
-        std::optional<PACKAGE_VERSION> GetPACKAGE_VERSION()
+        // The identity of the process does not change, so it is only read once.
+        const std::optional<PACKAGE_VERSION>& GetPACKAGE_VERSION()
         {
-            std::unique_ptr<byte[]> buffer = GetPACKAGE_ID();
-            if (!buffer)
+            static std::optional<PACKAGE_VERSION> s_packageVersion = []() -> std::optional<PACKAGE_VERSION>
             {
-                return {};
-            }
+                std::unique_ptr<byte[]> buffer = GetPACKAGE_ID();
+                if (!buffer)
+                {
+                    return {};
+                }
+
+                PACKAGE_ID* packageId = reinterpret_cast<PACKAGE_ID*>(buffer.get());
+                return packageId->version;
+            }();
 
-            PACKAGE_ID* packageId = reinterpret_cast<PACKAGE_ID*>(buffer.get());
-            return packageId->version;
+            return s_packageVersion;
         }
 
 #ifndef AICLI_DISABLE_TEST_HOOKS
@@ -234,126 +247,189 @@ namespace AppInstaller::Runtime
     }
 #endif
 
-    std::filesystem::path GetPathTo(PathName path)
+    namespace
     {
-        std::filesystem::path result;
-        bool create = true;
+        // A computed path, and whether its directory should be created when it is requested.
+        struct ComputedPath
+        {
+            std::filesystem::path Path;
+            bool Create = true;
+        };
 
-#ifndef WINGET_DISABLE_FOR_FUZZING
-        if (IsRunningInPackagedContext())
+        // Computes the path to the requested location, which does not change for the lifetime of the process.
+        ComputedPath ComputePathTo(PathName path)
         {
-            auto appStorage = winrt::Windows::Storage::ApplicationData::Current();
+            std::filesystem::path result;
+            bool create = true;
 
-            switch (path)
-            {
-            case PathName::Temp:
+#ifndef WINGET_DISABLE_FOR_FUZZING
+            if (IsRunningInPackagedContext())
             {
-                result = GetPathToUserTemp();
-                result /= s_DefaultTempDirectory;
-            }
-                break;
-            case PathName::LocalState:
-            case PathName::UserFileSettings:
-                result.assign(appStorage.LocalFolder().Path().c_str());
-                break;
-            case PathName::DefaultLogLocation:
-            case PathName::DefaultLogLocationForDisplay:
-                // To enable UIF collection through Feedback hub, we must put our logs here.
-                result.assign(appStorage.LocalFolder().Path().c_str());
-                result /= WINGET_DEFAULT_LOG_DIRECTORY;
-
-                if (path == PathName::DefaultLogLocationForDisplay)
+                auto appStorage = winrt::Windows::Storage::ApplicationData::Current();
+
+                switch (path)
                 {
-                    std::filesystem::path localAppData = GetKnownFolderPath(FOLDERID_LocalAppData);
+                case PathName::Temp:
+                {
+                    result = GetPathToUserTemp();
+                    result /= s_DefaultTempDirectory;
+                }
+                    break;
+                case PathName::LocalState:
+                case PathName::UserFileSettings:
+                    result.assign(appStorage.LocalFolder().Path().c_str());
+                    break;
+                case PathName::DefaultLogLocation:
+                case PathName::DefaultLogLocationForDisplay:
+                    // To enable UIF collection through Feedback hub, we must put our logs here.
+                    result.assign(appStorage.LocalFolder().Path().c_str());
+                    result /= WINGET_DEFAULT_LOG_DIRECTORY;
+
+                    if (path == PathName::DefaultLogLocationForDisplay)
+                    {
+                        std::filesystem::path localAppData = GetKnownFolderPath(FOLDERID_LocalAppData);
 
-                    auto ladItr = localAppData.begin();
-                    auto resultItr = result.begin();
+                        auto ladItr = localAppData.begin();
+                        auto resultItr = result.begin();
 
-                    while (ladItr != localAppData.end() && resultItr != result.end())
-                    {
-                        if (*ladItr != *resultItr)
+                        while (ladItr != localAppData.end() && resultItr != result.end())
                         {
-                            break;
-                        }
+                            if (*ladItr != *resultItr)
+                            {
+                                break;
+                            }
 
-                        ++ladItr;
-                        ++resultItr;
-                    }
+                            ++ladItr;
+                            ++resultItr;
+                        }
 
-                    if (ladItr == localAppData.end())
-                    {
-                        localAppData.assign("%LOCALAPPDATA%");
-                        
-                        for (;resultItr != result.end(); ++resultItr)
+                        if (ladItr == localAppData.end())
                         {
-                            localAppData /= *resultItr;
-                        }
+                            localAppData.assign("%LOCALAPPDATA%");
+                        
+                            for (;resultItr != result.end(); ++resultItr)
+                            {
+                                localAppData /= *resultItr;
+                            }
 
-                        result = std::move(localAppData);
+                            result = std::move(localAppData);
+                        }
                     }
+                    break;
+                case PathName::StandardSettings:
+                    create = false;
+                    break;
+                case PathName::SecureSettings:
+                    result = GetKnownFolderPath(FOLDERID_ProgramData);
+                    result /= s_SecureSettings_Base;
+                    result /= GetUserSID();
+                    result /= s_SecureSettings_UserRelative;
+                    result /= s_SecureSettings_Relative_Packaged;
+                    result /= GetPackageName();
+                    create = false;
+                    break;
+                case PathName::UserProfile:
+                    result = GetKnownFolderPath(FOLDERID_Profile);
+                    create = false;
+                    break;
+                case PathName::InstallerCache:
+                    result = GetKnownFolderPath(FOLDERID_ProgramData);
+                    result /= s_SecureSettings_Base;
+                    result /= s_InstallerCache_Relative;
+                    break;
+                default:
+                    THROW_HR(E_UNEXPECTED);
                 }
-                break;
-            case PathName::StandardSettings:
-                create = false;
-                break;
-            case PathName::SecureSettings:
-                result = GetKnownFolderPath(FOLDERID_ProgramData);
-                result /= s_SecureSettings_Base;
-                result /= GetUserSID();
-                result /= s_SecureSettings_UserRelative;
-                result /= s_SecureSettings_Relative_Packaged;
-                result /= GetPackageName();
-                create = false;
-                break;
-            case PathName::UserProfile:
-                result = GetKnownFolderPath(FOLDERID_Profile);
-                create = false;
-                break;
-            default:
-                THROW_HR(E_UNEXPECTED);
             }
-        }
-        else
+            else
 #endif
-        {
-            switch (path)
-            {
-            case PathName::Temp:
-            case PathName::DefaultLogLocation:
             {
-                result = GetPathToUserTemp();
-                result /= s_DefaultTempDirectory;
+                switch (path)
+                {
+                case PathName::Temp:
+                case PathName::DefaultLogLocation:
+                {
+                    result = GetPathToUserTemp();
+                    result /= s_DefaultTempDirectory;
+                }
+                    break;
+                case PathName::DefaultLogLocationForDisplay:
+                    result.assign("%TEMP%");
+                    result /= s_DefaultTempDirectory;
+                    create = false;
+                    break;
+                case PathName::LocalState:
+                    result = GetPathToAppDataDir(s_AppDataDir_State);
+                    break;
+                case PathName::StandardSettings:
+                case PathName::UserFileSettings:
+                    result = GetPathToAppDataDir(s_AppDataDir_Settings);
+                    break;
+                case PathName::SecureSettings:
+                    result = GetKnownFolderPath(FOLDERID_ProgramData);
+                    result /= s_SecureSettings_Base;
+                    result /= GetUserSID();
+                    result /= s_SecureSettings_UserRelative;
+                    result /= s_SecureSettings_Relative_Unpackaged;
+                    create = false;
+                    break;
+                case PathName::UserProfile:
+                    result = GetKnownFolderPath(FOLDERID_Profile);
+                    create = false;
+                    break;
+                case PathName::InstallerCache:
+                    result = GetKnownFolderPath(FOLDERID_ProgramData);
+                    result /= s_SecureSettings_Base;
+                    result /= s_InstallerCache_Relative;
+                    break;
+                default:
+                    THROW_HR(E_UNEXPECTED);
+                }
             }
-                break;
-            case PathName::DefaultLogLocationForDisplay:
-                result.assign("%TEMP%");
-                result /= s_DefaultTempDirectory;
-                create = false;
-                break;
-            case PathName::LocalState:
-                result = GetPathToAppDataDir(s_AppDataDir_State);
-                break;
-            case PathName::StandardSettings:
-            case PathName::UserFileSettings:
-                result = GetPathToAppDataDir(s_AppDataDir_Settings);
-                break;
-            case PathName::SecureSettings:
-                result = GetKnownFolderPath(FOLDERID_ProgramData);
-                result /= s_SecureSettings_Base;
-                result /= GetUserSID();
-                result /= s_SecureSettings_UserRelative;
-                result /= s_SecureSettings_Relative_Unpackaged;
-                create = false;
-                break;
-            case PathName::UserProfile:
-                result = GetKnownFolderPath(FOLDERID_Profile);
-                create = false;
-                break;
-            default:
-                THROW_HR(E_UNEXPECTED);
+
+            return { std::move(result), create };
+        }
+
+        // Computing a path can activate WinRT objects and make several system calls, so each is only computed once.
+        struct PathCache
+        {
+            wil::srwlock Lock;
+            std::map<PathName, ComputedPath> Paths;
+        };
+
+        PathCache& GetPathCache()
+        {
+            static PathCache s_instance;
+            return s_instance;
+        }
+    }
+
+    std::filesystem::path GetPathTo(PathName path)
+    {
+        PathCache& cache = GetPathCache();
+        std::optional<ComputedPath> computed;
+
+        {
+            auto lock = cache.Lock.lock_shared();
+            auto itr = cache.Paths.find(path);
+            if (itr != cache.Paths.end())
+            {
+                computed = itr->second;
             }
         }
 
+        if (!computed)
+        {
+            // Computed outside of the lock; should two threads both do so, the results are the same.
+            ComputedPath newPath = ComputePathTo(path);
+
+            auto lock = cache.Lock.lock_exclusive();
+            computed = cache.Paths.emplace(path, std::move(newPath)).first->second;
+        }
+
+        std::filesystem::path result = std::move(computed->Path);
+        bool create = computed->Create;
+
 #ifndef AICLI_DISABLE_TEST_HOOKS
         // Override the value after letting the normal code path run
         auto itr = s_Path_TestHook_Overrides.find(path);
@@ -6,51 +6,53 @@
 #include "Public/AppInstallerSHA256.h"
 #include "Public/AppInstallerRuntime.h"
 #include "Public/AppInstallerErrors.h"
+#include "Public/winget/Timing.h"
 
 using namespace AppInstaller::Runtime;
 
 namespace AppInstaller::Utility {
 
+    namespace
+    {
+        // The size of the views of a file that are mapped at once when hashing it.
+        constexpr uint64_t s_FileViewSize = 64 * 1024 * 1024; // 64MB
+
+        // The algorithm provider is opened once and shared, as opening it is far more expensive than hashing small buffers.
+        // Algorithm handles may be used from multiple threads at once.
+        BCRYPT_ALG_HANDLE GetSHA256AlgorithmProvider()
+        {
+            static wil::unique_bcrypt_algorithm s_algHandle = []()
+            {
+                BCRYPT_ALG_HANDLE algHandleT{};
+
+                // Open an algorithm handle
+                THROW_IF_NTSTATUS_FAILED_MSG(BCryptOpenAlgorithmProvider(
+                    &algHandleT,                // Alg Handle pointer
+                    BCRYPT_SHA256_ALGORITHM,    // Cryptographic Algorithm name (null terminated unicode string)
+                    nullptr,                    // Provider name; if null, the default provider is loaded
+                    0),                         // Flags
+                    "failed opening SHA256 algorithm provider");
+
+                return wil::unique_bcrypt_algorithm{ algHandleT };
+            }();
+
+            return s_algHandle.get();
+        }
+    }
+
     struct SHA256Context
     {
-        wil::unique_bcrypt_algorithm algHandle;
         wil::unique_bcrypt_hash hashHandle;
-        DWORD hashLength = 0;
+        DWORD hashLength = SHA256::HashBufferSizeInBytes;
     };
 
     SHA256::SHA256() : context(new SHA256Context{})
     {
-        BCRYPT_ALG_HANDLE algHandleT{};
         BCRYPT_HASH_HANDLE hashHandleT;
-        DWORD resultLength = 0;
-
-        // Open an algorithm handle
-        THROW_IF_NTSTATUS_FAILED_MSG(BCryptOpenAlgorithmProvider(
-            &algHandleT,                // Alg Handle pointer
-            BCRYPT_SHA256_ALGORITHM,    // Cryptographic Algorithm name (null terminated unicode string)
-            nullptr,                    // Provider name; if null, the default provider is loaded
-            0),                         // Flags
-            "failed opening SHA256 algorithm provider");
-        context->algHandle.reset(algHandleT);
-
-        // Obtain the length of the hash
-        THROW_IF_NTSTATUS_FAILED_MSG(BCryptGetProperty(
-            context->algHandle.get(),       // Handle to a CNG object
-            BCRYPT_HASH_LENGTH,             // Property name (null terminated unicode string)
-            (PBYTE) & (context->hashLength),  // Address of the output buffer which receives the property value
-            sizeof(context->hashLength),    // Size of the buffer in bytes
-            &resultLength,                  // Number of bytes that were copied into the buffer
-            0),                             // Flags
-            "failed getting SHA256 hash length");
-        
-        if (resultLength != sizeof(context->hashLength))
-        {
-            THROW_HR_MSG(E_UNEXPECTED, "failed getting SHA256 hash length");
-        }
 
         // Create a hash handle
         THROW_IF_NTSTATUS_FAILED_MSG(BCryptCreateHash(
-            context->algHandle.get(),   // Handle to an algorithm provider
+            GetSHA256AlgorithmProvider(),   // Handle to an algorithm provider
             &hashHandleT,               // A pointer to a hash handle - can be a hash or hmac object
             nullptr,                    // Pointer to the buffer that receives the hash/hmac object
             0,                          // Size of the buffer in bytes
@@ -130,9 +132,20 @@ namespace AppInstaller::Utility {
 
     SHA256::HashBuffer SHA256::ComputeHash(const std::uint8_t* buffer, std::uint32_t cbBuffer)
     {
-        SHA256 hasher;
-        hasher.Add(buffer, cbBuffer);
-        return hasher.Get();
+        HashBuffer result(HashBufferSizeInBytes);
+
+        // Hash in a single call, rather than creating a hash object for data that is all available.
+        THROW_IF_NTSTATUS_FAILED_MSG(BCryptHash(
+            GetSHA256AlgorithmProvider(),   // Handle to an algorithm provider
+            nullptr,                        // A pointer to a key to use for the hash or MAC
+            0,                              // Size of the key in bytes
+            const_cast<PUCHAR>(buffer),     // The data to hash
+            cbBuffer,                       // Size of the data in bytes
+            result.data(),                  // A pointer to a buffer that receives the hash value
+            static_cast<ULONG>(result.size())), // Size of the buffer in bytes
+            "failed computing SHA256 hash");
+
+        return result;
     }
 
     SHA256::HashBuffer SHA256::ComputeHash(std::string_view buffer)
@@ -171,6 +184,43 @@ namespace AppInstaller::Utility {
         }
     }
 
+    SHA256::HashBuffer SHA256::ComputeHashFromFile(const std::filesystem::path& path)
+    {
+        Timing::Span span{ Timing::Phase::Hash };
+        wil::unique_hfile file{ CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr) };
+        THROW_LAST_ERROR_IF(!file);
+
+        LARGE_INTEGER fileSize{};
+        THROW_LAST_ERROR_IF(!GetFileSizeEx(file.get(), &fileSize));
+
+        SHA256 hasher;
+
+        // A mapping cannot be created for an empty file.
+        if (fileSize.QuadPart == 0)
+        {
+            return hasher.Get();
+        }
+
+        // Hashing the mapped file reads it straight from the file cache, without copying it through a stream buffer.
+        wil::unique_handle mapping{ CreateFileMappingW(file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr) };
+        THROW_LAST_ERROR_IF(!mapping);
+
+        const uint64_t size = static_cast<uint64_t>(fileSize.QuadPart);
+
+        for (uint64_t offset = 0; offset < size; offset += s_FileViewSize)
+        {
+            size_t viewSize = static_cast<size_t>(std::min(s_FileViewSize, size - offset));
+
+            wil::unique_mapview_ptr<uint8_t> view{ reinterpret_cast<uint8_t*>(MapViewOfFile(
+                mapping.get(), FILE_MAP_READ, static_cast<DWORD>(offset >> 32), static_cast<DWORD>(offset), viewSize)) };
+            THROW_LAST_ERROR_IF(!view);
+
+            hasher.Add(view.get(), viewSize);
+        }
+
+        return hasher.Get();
+    }
+
     void SHA256::SHA256ContextDeleter::operator()(SHA256Context* context)
     {
         delete context;
@@ -3,6 +3,13 @@
 #include "pch.h"
 #include <AppInstallerSynchronization.h>
 #include <AppInstallerStrings.h>
+#include "Public/winget/ThreadGlobals.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
 
 
 namespace AppInstaller::Synchronization
@@ -10,18 +17,77 @@ namespace AppInstaller::Synchronization
     using namespace std::string_view_literals;
 
     constexpr std::wstring_view s_CrossProcessReaderWriteLock_MutexSuffix = L".mutex"sv;
+    constexpr std::wstring_view s_CrossProcessClaim_SectionSuffix = L".claim"sv;
 
     // A milliseconds version of INFINITE
     constexpr std::chrono::milliseconds s_CrossProcessReaderWriteLock_Infinite = static_cast<std::chrono::milliseconds>(INFINITE);
 
-    // The amount of time that we wait in between checking for cancellation
-    constexpr std::chrono::milliseconds s_CrossProcessReaderWriteLock_WaitLoopTime = 250ms;
+    // The number of reader slots; one less than the wait limit so that a reader can wait on all of them and the cancellation event.
+    constexpr size_t s_CrossProcessReaderWriteLock_MaxReaders = MAXIMUM_WAIT_OBJECTS - 1;
+
+    // The number of reader slots used by earlier releases; readers try these first so that writers from those releases still see them.
+    constexpr size_t s_CrossProcessReaderWriteLock_LegacyMaxReaders = 8;
+
+    static_assert(s_CrossProcessReaderWriteLock_LegacyMaxReaders <= s_CrossProcessReaderWriteLock_MaxReaders);
 
-    // Arbitrary limit that should not ever cause a problem (theoretically 1 per process)
-    constexpr size_t s_CrossProcessReaderWriteLock_MaxReaders = 8;
+    // The most threads for each processor in the Io lane, as its work is mostly waiting.
+    constexpr DWORD s_WorkLane_IoThreadsPerProcessor = 4;
 
     namespace
     {
+        // The threads of a single lane of the process-wide thread pool.
+        struct WorkLanePool
+        {
+            WorkLanePool(DWORD maximumThreads)
+            {
+                m_pool.reset(CreateThreadpool(nullptr));
+                THROW_LAST_ERROR_IF_NULL(m_pool);
+                InitializeThreadpoolEnvironment(&m_environment);
+                SetThreadpoolCallbackPool(&m_environment, m_pool.get());
+
+                SetThreadpoolThreadMaximum(m_pool.get(), maximumThreads);
+                THROW_LAST_ERROR_IF(!SetThreadpoolThreadMinimum(m_pool.get(), 1));
+            }
+
+            TP_CALLBACK_ENVIRON m_environment;
+            wil::unique_any<PTP_POOL, decltype(CloseThreadpool), CloseThreadpool> m_pool;
+        };
+
+        WorkLanePool& GetWorkLanePool(WorkLane lane)
+        {
+            static const DWORD s_processorCount = std::max(1u, std::thread::hardware_concurrency());
+
+            // The pools are never closed, as work can still be queued to them while the process exits.
+            static WorkLanePool* s_cpuPool = new WorkLanePool(s_processorCount);
+            static WorkLanePool* s_ioPool = new WorkLanePool(s_processorCount * s_WorkLane_IoThreadsPerProcessor);
+
+            return (lane == WorkLane::Cpu ? *s_cpuPool : *s_ioPool);
+        }
+
+        void CALLBACK WorkLaneCallback(PTP_CALLBACK_INSTANCE, PVOID context)
+        {
+            std::unique_ptr<std::function<void()>> work{ static_cast<std::function<void()>*>(context) };
+
+            try
+            {
+                (*work)();
+            }
+            CATCH_LOG();
+        }
+    }
+
+    namespace
+    {
+        using Deadline = std::optional<std::chrono::steady_clock::time_point>;
+
+        // The outcome of waiting for a set of handles.
+        enum class WaitResult
+        {
+            Acquired,
+            TimedOut,
+            Cancelled,
+        };
+
         wil::unique_mutex OpenControlMutex(const std::wstring& name)
         {
             std::wstring mutexName = name;
@@ -42,6 +108,70 @@ namespace AppInstaller::Synchronization
             result.create(strstr.str().c_str(), 0, SYNCHRONIZE);
             return result;
         }
+
+        // Gets the reader slot to try on the given attempt; the legacy slots are tried first, starting from the offset.
+        size_t GetReaderSlot(size_t attempt, size_t offset)
+        {
+            if (attempt < s_CrossProcessReaderWriteLock_LegacyMaxReaders)
+            {
+                return (attempt + offset) % s_CrossProcessReaderWriteLock_LegacyMaxReaders;
+            }
+
+            return attempt;
+        }
+
+        DWORD GetMillisecondsToWait(const Deadline& deadline)
+        {
+            if (!deadline)
+            {
+                return INFINITE;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (now >= deadline.value())
+            {
+                // Allow an attempt to acquire with no wait
+                return 0;
+            }
+
+            return static_cast<DWORD>(std::chrono::ceil<std::chrono::milliseconds>(deadline.value() - now).count());
+        }
+
+        // Waits until any one of the handles is acquired, the deadline passes, or the cancel event (if given) is signaled.
+        WaitResult WaitForAny(std::vector<HANDLE> handles, HANDLE cancelEvent, const Deadline& deadline, size_t& acquiredIndex)
+        {
+            DWORD handleCount = static_cast<DWORD>(handles.size());
+            if (cancelEvent)
+            {
+                handles.emplace_back(cancelEvent);
+            }
+            THROW_HR_IF(E_INVALIDARG, handles.size() > MAXIMUM_WAIT_OBJECTS);
+
+            DWORD status = WaitForMultipleObjectsEx(static_cast<DWORD>(handles.size()), handles.data(), FALSE, GetMillisecondsToWait(deadline), FALSE);
+            THROW_LAST_ERROR_IF(status == WAIT_FAILED);
+
+            if (status == WAIT_TIMEOUT)
+            {
+                return WaitResult::TimedOut;
+            }
+            else if (status >= WAIT_OBJECT_0 && status < (WAIT_OBJECT_0 + handleCount))
+            {
+                acquiredIndex = status - WAIT_OBJECT_0;
+                return WaitResult::Acquired;
+            }
+            else if (status >= WAIT_ABANDONED_0 && status < (WAIT_ABANDONED_0 + handleCount))
+            {
+                // The previous owner exited while holding the mutex; it is now ours
+                acquiredIndex = status - WAIT_ABANDONED_0;
+                return WaitResult::Acquired;
+            }
+            else if (cancelEvent && status == (WAIT_OBJECT_0 + handleCount))
+            {
+                return WaitResult::Cancelled;
+            }
+
+            THROW_HR(E_UNEXPECTED);
+        }
     }
 
     CrossProcessReaderWriteLock::~CrossProcessReaderWriteLock()
@@ -88,14 +218,17 @@ namespace AppInstaller::Synchronization
         m_mutexesHeld.clear();
     }
 
+    size_t CrossProcessReaderWriteLock::GetMaximumReaderCount()
+    {
+        return s_CrossProcessReaderWriteLock_MaxReaders;
+    }
+
     CrossProcessReaderWriteLock CrossProcessReaderWriteLock::Lock(
         bool shared,
         std::string_view name,
         std::chrono::milliseconds timeout,
         IProgressCallback* progress)
     {
-        auto start = std::chrono::steady_clock::now();
-
         // Verify inputs
         THROW_HR_IF(E_INVALIDARG, name.find('\\') != std::string::npos);
         THROW_HR_IF(E_INVALIDARG, timeout.count() > INFINITE);
@@ -103,34 +236,51 @@ namespace AppInstaller::Synchronization
         CrossProcessReaderWriteLock result;
         std::wstring wideName = Utility::ConvertToUTF16(name);
 
+        Deadline deadline;
+        if (timeout != s_CrossProcessReaderWriteLock_Infinite)
+        {
+            deadline = std::chrono::steady_clock::now() + timeout;
+        }
+
+        // Cancellation signals an event that is part of every wait, so that it ends the wait immediately
+        wil::unique_event cancelEvent;
+        IProgressCallback::CancelFunctionRemoval cancelFunctionRemoval;
+
+        if (progress)
+        {
+            cancelEvent.create(wil::EventOptions::ManualReset);
+            HANDLE cancelHandle = cancelEvent.get();
+            cancelFunctionRemoval = progress->SetCancellationFunction([cancelHandle]() { SetEvent(cancelHandle); });
+
+            if (progress->IsCancelled())
+            {
+                return result;
+            }
+        }
+
         // Acquire overall control mutex
-        DWORD status = 0;
+        size_t acquiredIndex = 0;
         wil::unique_mutex controlMutex = OpenControlMutex(wideName);
-        auto lock = controlMutex.acquire(&status, static_cast<DWORD>(timeout.count()));
-        THROW_LAST_ERROR_IF(status == WAIT_FAILED);
-
-        if (status == WAIT_TIMEOUT || (progress && progress->IsCancelled()))
+        if (WaitForAny({ controlMutex.get() }, cancelEvent.get(), deadline, acquiredIndex) != WaitResult::Acquired)
         {
             return result;
         }
-
-        // Open all needed access mutexes
-        std::vector<wil::unique_mutex> allAccessMutexes;
-        HANDLE waitHandles[s_CrossProcessReaderWriteLock_MaxReaders]{};
+        wil::mutex_release_scope_exit controlMutexRelease{ controlMutex.get() };
 
         if (shared)
         {
-            // Acquire the first access mutex we can find that is open, or all of them if needed.
+            // Acquire the first access mutex we can find that is open, or wait for any of them if needed.
             // Use the process id as an arbitrary value in an attempt to reduce collisions
             // while still allowing for re-entrance to not be arbitrary.
-            size_t offset = GetProcessId(GetCurrentProcess()) % s_CrossProcessReaderWriteLock_MaxReaders;
+            size_t offset = GetProcessId(GetCurrentProcess()) % s_CrossProcessReaderWriteLock_LegacyMaxReaders;
+
+            std::vector<wil::unique_mutex> allAccessMutexes;
+            std::vector<HANDLE> waitHandles;
 
             for (size_t i = 0; i < s_CrossProcessReaderWriteLock_MaxReaders; ++i)
             {
-                size_t index = (i + offset) % s_CrossProcessReaderWriteLock_MaxReaders;
-
-                wil::unique_mutex current = OpenAccessMutex(wideName, index);
-                status = ::WaitForSingleObjectEx(current.get(), 0, FALSE);
+                wil::unique_mutex current = OpenAccessMutex(wideName, GetReaderSlot(i, offset));
+                DWORD status = ::WaitForSingleObjectEx(current.get(), 0, FALSE);
 
                 if (status == WAIT_OBJECT_0 || status == WAIT_ABANDONED)
                 {
@@ -140,7 +290,7 @@ namespace AppInstaller::Synchronization
                 }
                 else if (status == WAIT_TIMEOUT)
                 {
-                    waitHandles[i] = current.get();
+                    waitHandles.emplace_back(current.get());
                     allAccessMutexes.emplace_back(std::move(current));
                 }
                 else
@@ -148,115 +298,199 @@ namespace AppInstaller::Synchronization
                     THROW_LAST_ERROR();
                 }
             }
+
+            if (WaitForAny(std::move(waitHandles), cancelEvent.get(), deadline, acquiredIndex) == WaitResult::Acquired)
+            {
+                result.m_mutexesHeld.emplace_back(std::move(allAccessMutexes[acquiredIndex]));
+            }
         }
         else
         {
-            // Open all of the access mutexes.
+            // Acquire each of the access mutexes in turn; holding the control mutex keeps new readers out while we wait.
             for (size_t i = 0; i < s_CrossProcessReaderWriteLock_MaxReaders; ++i)
             {
                 wil::unique_mutex current = OpenAccessMutex(wideName, i);
-                waitHandles[i] = current.get();
-                allAccessMutexes.emplace_back(std::move(current));
+
+                if (WaitForAny({ current.get() }, cancelEvent.get(), deadline, acquiredIndex) != WaitResult::Acquired)
+                {
+                    result.Release();
+                    break;
+                }
+
+                result.m_mutexesHeld.emplace_back(std::move(current));
             }
         }
 
-        // Wait for one/all of the mutexes (or cancellation)
-        bool waitAgain = true;
-        while (waitAgain && (!progress || !progress->IsCancelled()))
+        return result;
+    }
+
+    CrossProcessClaim CrossProcessClaim::TryClaim(std::string_view name, std::chrono::milliseconds period)
+    {
+        THROW_HR_IF(E_INVALIDARG, name.find('\\') != std::string::npos);
+
+        CrossProcessClaim result;
+        result.m_claimed = true;
+        result.m_claimTime = static_cast<int64_t>(GetTickCount64());
+
+        std::wstring sectionName = Utility::ConvertToUTF16(name);
+        sectionName += s_CrossProcessClaim_SectionSuffix;
+
+        // A new section is zero filled, which is no claim
+        result.m_section.reset(CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, sizeof(LONG64), sectionName.c_str()));
+        if (!result.m_section)
+        {
+            LOG_LAST_ERROR_MSG("Unable to open claim section; claiming without it");
+            return result;
+        }
+
+        result.m_view.reset(static_cast<LONG64*>(MapViewOfFile(result.m_section.get(), FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, sizeof(LONG64))));
+        if (!result.m_view)
+        {
+            LOG_LAST_ERROR_MSG("Unable to map claim section; claiming without it");
+            result.m_section.reset();
+            return result;
+        }
+
+        LONG64 previous = InterlockedCompareExchange64(result.m_view.get(), 0, 0);
+        if (previous != 0 && result.m_claimTime - previous < period.count())
+        {
+            result.m_claimed = false;
+            return result;
+        }
+
+        // Only one of the processes that saw the same previous claim replaces it
+        if (InterlockedCompareExchange64(result.m_view.get(), result.m_claimTime, previous) != previous)
+        {
+            result.m_claimed = false;
+        }
+
+        return result;
+    }
+
+    void CrossProcessClaim::Abandon()
+    {
+        if (m_claimed && m_view)
+        {
+            InterlockedCompareExchange64(m_view.get(), 0, m_claimTime);
+        }
+
+        m_claimed = false;
+    }
+
+    void SubmitWork(WorkLane lane, std::function<void()> work)
+    {
+        auto context = std::make_unique<std::function<void()>>(std::move(work));
+        THROW_LAST_ERROR_IF(!TrySubmitThreadpoolCallback(WorkLaneCallback, context.get(), GetWorkLaneEnvironment(lane)));
+        context.release();
+    }
+
+    PTP_CALLBACK_ENVIRON GetWorkLaneEnvironment(WorkLane lane)
+    {
+        return &GetWorkLanePool(lane).m_environment;
+    }
+
+    void RunConcurrently(size_t count, const std::function<void(size_t)>& func)
+    {
+        using namespace AppInstaller::ThreadLocalStorage;
+
+        if (count == 0)
+        {
+            return;
+        }
+
+        std::vector<std::exception_ptr> exceptions(count);
+        std::atomic<size_t> nextIndex = 0;
+
+        auto worker = [&]()
         {
-            DWORD millisecondsToWait = 0;
-            if (progress)
+            for (size_t i = nextIndex++; i < count; i = nextIndex++)
             {
-                if (timeout == s_CrossProcessReaderWriteLock_Infinite)
+                try
                 {
-                    millisecondsToWait = static_cast<DWORD>(s_CrossProcessReaderWriteLock_WaitLoopTime.count());
+                    func(i);
                 }
-                else
+                catch (...)
                 {
-                    auto currentDuration = std::chrono::steady_clock::now() - start;
-                    if (currentDuration >= timeout)
-                    {
-                        // Allow an attempt to acquire with no wait
-                        millisecondsToWait = 0;
-                        waitAgain = false;
-                    }
-                    else
-                    {
-                        auto durationToWait = timeout - currentDuration;
-                        if (durationToWait > s_CrossProcessReaderWriteLock_WaitLoopTime)
-                        {
-                            durationToWait = s_CrossProcessReaderWriteLock_WaitLoopTime;
-                        }
-                        else
-                        {
-                            waitAgain = false;
-                        }
-                        millisecondsToWait = static_cast<DWORD>(std::chrono::duration_cast<std::chrono::milliseconds>(durationToWait).count());
-                    }
+                    exceptions[i] = std::current_exception();
                 }
             }
-            else
-            {
-                // If there is no progress, we will do the full wait this time
-                waitAgain = false;
+        };
+
+        // Workers that the pool has not started by the time the caller runs out of indices are not waited for, as the threads of the
+        // pool may all be waiting on calls like this one themselves. This state outlives the call for those workers.
+        struct WorkerState
+        {
+            std::mutex Lock;
+            std::condition_variable Finished;
+            size_t Running = 0;
+            bool Done = false;
+        };
+
+        auto state = std::make_shared<WorkerState>();
 
-                if (timeout == s_CrossProcessReaderWriteLock_Infinite)
+        // The calling thread is one of the workers
+        size_t workerCount = std::min<size_t>(count, std::max(1u, std::thread::hardware_concurrency()));
+        ThreadGlobals* parentThreadGlobals = ThreadGlobals::GetForCurrentThread();
+
+        for (size_t i = 1; i < workerCount; ++i)
+        {
+            try
+            {
+                std::shared_ptr<ThreadGlobals> threadGlobals;
+                if (parentThreadGlobals)
                 {
-                    millisecondsToWait = INFINITE;
+                    threadGlobals = std::make_shared<ThreadGlobals>(*parentThreadGlobals, ThreadGlobals::create_sub_thread_globals_t{});
                 }
-                else
-                {
-                    auto currentDuration = std::chrono::steady_clock::now() - start;
-                    if (currentDuration >= timeout)
-                    {
-                        // Allow an attempt to acquire with no wait
-                        millisecondsToWait = 0;
-                    }
-                    else
+
+                SubmitWork(WorkLane::Cpu, [&worker, state, threadGlobals]()
                     {
-                        millisecondsToWait = static_cast<DWORD>(std::chrono::duration_cast<std::chrono::milliseconds>(timeout - currentDuration).count());
-                    }
-                }
-            }
+                        {
+                            std::lock_guard<std::mutex> lock{ state->Lock };
+                            if (state->Done)
+                            {
+                                return;
+                            }
 
-            status = WaitForMultipleObjectsEx(s_CrossProcessReaderWriteLock_MaxReaders, waitHandles, (shared ? FALSE : TRUE), millisecondsToWait, FALSE);
-            THROW_LAST_ERROR_IF(status == WAIT_FAILED);
+                            ++state->Running;
+                        }
+
+                        {
+                            std::unique_ptr<PreviousThreadGlobals> previousThreadGlobals;
+                            if (threadGlobals)
+                            {
+                                previousThreadGlobals = threadGlobals->SetForCurrentThread();
+                            }
 
-            if (status != WAIT_TIMEOUT)
+                            worker();
+                        }
+
+                        std::lock_guard<std::mutex> lock{ state->Lock };
+                        --state->Running;
+                        state->Finished.notify_all();
+                    });
+            }
+            catch (...)
             {
+                // The caller, and the workers already queued, do the rest of the work
+                LOG_CAUGHT_EXCEPTION();
                 break;
             }
         }
 
-        if (status == WAIT_TIMEOUT || (progress && progress->IsCancelled()))
+        worker();
+
         {
-            return result;
+            std::unique_lock<std::mutex> lock{ state->Lock };
+            state->Done = true;
+            state->Finished.wait(lock, [&]() { return state->Running == 0; });
         }
 
-        if (shared)
+        for (const auto& exception : exceptions)
         {
-            size_t acquiredIndex = 0;
-            if (status >= WAIT_OBJECT_0 && status < (WAIT_OBJECT_0 + s_CrossProcessReaderWriteLock_MaxReaders))
+            if (exception)
             {
-                acquiredIndex = status - WAIT_OBJECT_0;
+                std::rethrow_exception(exception);
             }
-            else if (status >= WAIT_ABANDONED_0 && status < (WAIT_ABANDONED_0 + s_CrossProcessReaderWriteLock_MaxReaders))
-            {
-                acquiredIndex = status - WAIT_ABANDONED_0;
-            }
-            else
-            {
-                THROW_HR(E_UNEXPECTED);
-            }
-
-            // Take the one that was acquired
-            result.m_mutexesHeld.emplace_back(std::move(allAccessMutexes[acquiredIndex]));
         }
-        else
-        {
-            result.m_mutexesHeld = std::move(allAccessMutexes);
-        }
-
-        return result;
     }
 }
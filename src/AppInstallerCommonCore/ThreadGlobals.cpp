@@ -8,11 +8,17 @@ namespace AppInstaller::ThreadLocalStorage
     // Set and return Globals for Current Thread
     static ThreadGlobals* SetOrGetThreadGlobals(bool setThreadGlobals, ThreadGlobals* pThreadGlobals = nullptr);
 
+    // The innermost cancellation check scope of the current thread
+    static thread_local CancellationCheckScope* t_pCancellationCheckScope = nullptr;
+
     ThreadGlobals::ThreadGlobals(ThreadGlobals& parent, create_sub_thread_globals_t)
     {
         parent.Initialize();
         m_pDiagnosticLogger = parent.m_pDiagnosticLogger;
-        m_pTelemetryLogger = parent.m_pTelemetryLogger->CreateSubTraceLogger();
+        // Many sub globals are for short lived work that never writes telemetry, so their own logger,
+        // and the summary event that it writes when destroyed, are left until something uses them.
+        m_pParentTelemetryLogger = parent.GetTelemetryLoggerPtr();
+        m_cancellation->Parent = parent.m_cancellation;
         // Flip the initialization flag
         std::call_once(m_loggerInitOnceFlag, []() {});
     }
@@ -24,7 +30,28 @@ namespace AppInstaller::ThreadLocalStorage
 
     TelemetryTraceLogger& ThreadGlobals::GetTelemetryLogger()
     {
-        return *(m_pTelemetryLogger);
+        return *(GetTelemetryLoggerPtr());
+    }
+
+    std::shared_ptr<TelemetryTraceLogger> ThreadGlobals::GetTelemetryLoggerPtr()
+    {
+        if (m_pParentTelemetryLogger)
+        {
+            std::call_once(m_subTelemetryLoggerInitOnceFlag, [this]()
+                {
+                    try
+                    {
+                        m_pTelemetryLogger = m_pParentTelemetryLogger->CreateSubTraceLogger();
+                    }
+                    catch (...)
+                    {
+                        // Loggers are best effort, so the work is reported with the parent's logger instead
+                        m_pTelemetryLogger = m_pParentTelemetryLogger;
+                    }
+                });
+        }
+
+        return m_pTelemetryLogger;
     }
 
     std::unique_ptr<PreviousThreadGlobals> ThreadGlobals::SetForCurrentThread()
@@ -42,8 +69,8 @@ namespace AppInstaller::ThreadLocalStorage
         {
             std::call_once(m_loggerInitOnceFlag, [this]()
                 {
-                    m_pDiagnosticLogger = std::make_unique<DiagnosticLogger>();
-                    m_pTelemetryLogger = std::make_unique<TelemetryTraceLogger>();
+                    m_pDiagnosticLogger = std::make_shared<DiagnosticLogger>();
+                    m_pTelemetryLogger = std::make_shared<TelemetryTraceLogger>();
 
                     // The above make_unique for TelemetryTraceLogger will either create an object or will throw which is caught below.
                     m_pTelemetryLogger->Initialize();
@@ -62,6 +89,49 @@ namespace AppInstaller::ThreadLocalStorage
         return SetOrGetThreadGlobals(false);
     }
 
+    void ThreadGlobals::Cancel()
+    {
+        m_cancellation->Cancelled = true;
+    }
+
+    bool ThreadGlobals::IsCancelled() const
+    {
+        for (const CancellationState* state = m_cancellation.get(); state; state = state->Parent.get())
+        {
+            if (state->Cancelled)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    CancellationCheckScope::CancellationCheckScope(std::function<bool()> isCancelled) :
+        m_isCancelled(std::move(isCancelled)), m_previous(t_pCancellationCheckScope)
+    {
+        t_pCancellationCheckScope = this;
+    }
+
+    CancellationCheckScope::~CancellationCheckScope()
+    {
+        t_pCancellationCheckScope = m_previous;
+    }
+
+    bool IsCurrentThreadCancelled()
+    {
+        for (const CancellationCheckScope* scope = t_pCancellationCheckScope; scope; scope = scope->m_previous)
+        {
+            if (scope->m_isCancelled && scope->m_isCancelled())
+            {
+                return true;
+            }
+        }
+
+        ThreadGlobals* threadGlobals = ThreadGlobals::GetForCurrentThread();
+        return threadGlobals && threadGlobals->IsCancelled();
+    }
+
     ThreadGlobals* SetOrGetThreadGlobals(bool setThreadGlobals, ThreadGlobals* pThreadGlobals)
     {
         thread_local AppInstaller::ThreadLocalStorage::ThreadGlobals* t_pThreadGlobals = nullptr;
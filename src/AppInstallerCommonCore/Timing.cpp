@@ -0,0 +1,326 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Public/winget/Timing.h"
+#include "Public/AppInstallerStrings.h"
+#include "Public/AppInstallerTelemetry.h"
+
+#include <Psapi.h>
+
+using namespace std::string_view_literals;
+
+namespace AppInstaller::Timing
+{
+    namespace
+    {
+        constexpr size_t c_phaseCount = static_cast<size_t>(Phase::Max);
+
+        struct Totals
+        {
+            std::atomic_bool Enabled = false;
+            std::array<std::atomic<int64_t>, c_phaseCount> Microseconds{};
+            std::array<std::atomic<uint64_t>, c_phaseCount> Counts{};
+        };
+
+        Totals& GetTotalsInstance()
+        {
+            static Totals s_totals;
+            return s_totals;
+        }
+
+        struct Usage
+        {
+            struct TaskTotal
+            {
+                std::chrono::microseconds Duration{};
+                uint64_t Count = 0;
+            };
+
+            std::atomic_bool Enabled = false;
+
+            std::atomic<uint64_t> SqlExecutions = 0;
+            std::atomic<uint64_t> SqlSteps = 0;
+            std::atomic<std::chrono::steady_clock::rep> SqlStepTicks = 0;
+
+            // The named counts are far less frequent than SQL steps, so they share a lock.
+            std::mutex Lock;
+            std::map<std::string, TaskTotal, std::less<>> WorkflowTasks;
+            std::map<std::string, uint64_t, std::less<>> DownloadedBytes;
+            std::map<std::string, uint64_t, std::less<>> HttpRequests;
+            std::map<std::string, ResourceUsage::CacheLookups, std::less<>> Caches;
+        };
+
+        Usage& GetUsageInstance()
+        {
+            static Usage s_usage;
+            return s_usage;
+        }
+
+        template <typename Value>
+        Value& GetEntry(std::map<std::string, Value, std::less<>>& map, std::string_view key)
+        {
+            auto itr = map.find(key);
+            if (itr == map.end())
+            {
+                itr = map.emplace(std::string{ key }, Value{}).first;
+            }
+            return itr->second;
+        }
+
+        // Gets the host, and port if there is one, of the url.
+        std::string GetHost(std::string_view url)
+        {
+            size_t start = url.find("://"sv);
+            start = (start == std::string_view::npos) ? 0 : start + 3;
+
+            std::string_view authority = url.substr(start, url.find_first_of("/?#"sv, start) - start);
+
+            size_t userInfoEnd = authority.rfind('@');
+            if (userInfoEnd != std::string_view::npos)
+            {
+                authority = authority.substr(userInfoEnd + 1);
+            }
+
+            return Utility::ToLower(authority);
+        }
+
+        bool IsTraceEnabled()
+        {
+            return TraceLoggingProviderEnabled(g_hTraceProvider, WINEVENT_LEVEL_VERBOSE, 0);
+        }
+
+        constexpr size_t c_startupStepCount = static_cast<size_t>(StartupStep::Max);
+
+        // The system times, in FILETIME units, at which the steps completed; zero if they have not.
+        // System time is used rather than the steady clock as the creation time of the process is one.
+        std::array<uint64_t, c_startupStepCount>& GetStartupStepTimes()
+        {
+            static std::array<uint64_t, c_startupStepCount> s_times{};
+            return s_times;
+        }
+
+        uint64_t ToUInt64(const FILETIME& fileTime)
+        {
+            return (static_cast<uint64_t>(fileTime.dwHighDateTime) << 32) | fileTime.dwLowDateTime;
+        }
+    }
+
+    std::string_view ToString(Phase phase)
+    {
+        switch (phase)
+        {
+        case Phase::SourceOpen: return "SourceOpen"sv;
+        case Phase::SourceUpdate: return "SourceUpdate"sv;
+        case Phase::InstalledIndexBuild: return "InstalledIndexBuild"sv;
+        case Phase::CompositeCorrelation: return "CompositeCorrelation"sv;
+        case Phase::ManifestFetch: return "ManifestFetch"sv;
+        case Phase::Download: return "Download"sv;
+        case Phase::Hash: return "Hash"sv;
+        case Phase::Install: return "Install"sv;
+        default: return "Unknown"sv;
+        }
+    }
+
+    std::string_view ToString(StartupStep step)
+    {
+        switch (step)
+        {
+        case StartupStep::CoreMainEntered: return "CoreMainEntered"sv;
+        case StartupStep::ApartmentInitialized: return "ApartmentInitialized"sv;
+        case StartupStep::ContextCreated: return "ContextCreated"sv;
+        case StartupStep::LoggingInitialized: return "LoggingInitialized"sv;
+        case StartupStep::TelemetryInitialized: return "TelemetryInitialized"sv;
+        case StartupStep::CommandFound: return "CommandFound"sv;
+        case StartupStep::ArgumentsValidated: return "ArgumentsValidated"sv;
+        case StartupStep::CommandExecuted: return "CommandExecuted"sv;
+        default: return "Unknown"sv;
+        }
+    }
+
+    void RecordStartupStep(StartupStep step)
+    {
+        FILETIME now{};
+        GetSystemTimePreciseAsFileTime(&now);
+        GetStartupStepTimes()[static_cast<size_t>(step)] = ToUInt64(now);
+    }
+
+    std::vector<StartupStepTime> GetStartupSteps()
+    {
+        FILETIME creationTime{}, exitTime{}, kernelTime{}, userTime{};
+        THROW_IF_WIN32_BOOL_FALSE(GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime));
+        uint64_t creation = ToUInt64(creationTime);
+
+        const auto& times = GetStartupStepTimes();
+        std::vector<StartupStepTime> result;
+
+        for (size_t i = 0; i < c_startupStepCount; ++i)
+        {
+            if (times[i] != 0)
+            {
+                // FILETIME units are 100 nanoseconds
+                int64_t sinceCreation = static_cast<int64_t>(times[i] - creation) / 10;
+                result.emplace_back(StartupStepTime{ static_cast<StartupStep>(i), std::chrono::microseconds{ sinceCreation } });
+            }
+        }
+
+        return result;
+    }
+
+    void EnableTotals()
+    {
+        GetTotalsInstance().Enabled = true;
+    }
+
+    std::vector<PhaseTotal> GetTotals()
+    {
+        Totals& totals = GetTotalsInstance();
+        std::vector<PhaseTotal> result;
+
+        for (size_t i = 0; i < c_phaseCount; ++i)
+        {
+            uint64_t count = totals.Counts[i].load();
+            if (count != 0)
+            {
+                result.emplace_back(PhaseTotal{ static_cast<Phase>(i), std::chrono::microseconds{ totals.Microseconds[i].load() }, count });
+            }
+        }
+
+        return result;
+    }
+
+    void EnableUsage()
+    {
+        GetUsageInstance().Enabled = true;
+    }
+
+    bool IsUsageEnabled()
+    {
+        return GetUsageInstance().Enabled.load(std::memory_order_relaxed);
+    }
+
+    void RecordWorkflowTask(std::string_view name, std::chrono::microseconds duration)
+    {
+        Usage& usage = GetUsageInstance();
+        std::lock_guard<std::mutex> lock{ usage.Lock };
+
+        Usage::TaskTotal& total = GetEntry(usage.WorkflowTasks, name);
+        total.Duration += duration;
+        ++total.Count;
+    }
+
+    void RecordSqlStep(bool isExecution, std::chrono::steady_clock::duration duration)
+    {
+        Usage& usage = GetUsageInstance();
+
+        if (isExecution)
+        {
+            ++usage.SqlExecutions;
+        }
+
+        ++usage.SqlSteps;
+        usage.SqlStepTicks += duration.count();
+    }
+
+    void RecordDownload(std::string_view type, uint64_t bytes)
+    {
+        Usage& usage = GetUsageInstance();
+        std::lock_guard<std::mutex> lock{ usage.Lock };
+
+        GetEntry(usage.DownloadedBytes, type) += bytes;
+    }
+
+    void RecordHttpRequest(std::string_view url)
+    {
+        std::string host = GetHost(url);
+
+        Usage& usage = GetUsageInstance();
+        std::lock_guard<std::mutex> lock{ usage.Lock };
+
+        ++GetEntry(usage.HttpRequests, host);
+    }
+
+    void RecordCacheLookup(std::string_view cache, bool hit)
+    {
+        Usage& usage = GetUsageInstance();
+        std::lock_guard<std::mutex> lock{ usage.Lock };
+
+        ResourceUsage::CacheLookups& lookups = GetEntry(usage.Caches, cache);
+        ++(hit ? lookups.Hits : lookups.Misses);
+    }
+
+    ResourceUsage GetUsage()
+    {
+        Usage& usage = GetUsageInstance();
+        ResourceUsage result;
+
+        result.SqlExecutions = usage.SqlExecutions.load();
+        result.SqlSteps = usage.SqlSteps.load();
+        result.SqlStepTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::duration{ usage.SqlStepTicks.load() });
+
+        {
+            std::lock_guard<std::mutex> lock{ usage.Lock };
+
+            for (const auto& task : usage.WorkflowTasks)
+            {
+                result.WorkflowTasks.emplace_back(ResourceUsage::WorkflowTaskTotal{ task.first, task.second.Duration, task.second.Count });
+            }
+
+            result.DownloadedBytes.insert(usage.DownloadedBytes.begin(), usage.DownloadedBytes.end());
+            result.HttpRequests.insert(usage.HttpRequests.begin(), usage.HttpRequests.end());
+            result.Caches.insert(usage.Caches.begin(), usage.Caches.end());
+        }
+
+        std::stable_sort(result.WorkflowTasks.begin(), result.WorkflowTasks.end(),
+            [](const ResourceUsage::WorkflowTaskTotal& a, const ResourceUsage::WorkflowTaskTotal& b) { return a.Duration > b.Duration; });
+
+        PROCESS_MEMORY_COUNTERS counters{};
+        counters.cb = sizeof(counters);
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            result.PeakWorkingSetBytes = counters.PeakWorkingSetSize;
+        }
+
+        return result;
+    }
+
+    Span::Span(Phase phase) : m_phase(phase)
+    {
+        m_enabled = GetTotalsInstance().Enabled.load(std::memory_order_relaxed) || IsTraceEnabled();
+
+        if (m_enabled)
+        {
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    Span::~Span()
+    {
+        if (!m_enabled)
+        {
+            return;
+        }
+
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start);
+
+        Totals& totals = GetTotalsInstance();
+        if (totals.Enabled.load(std::memory_order_relaxed))
+        {
+            size_t index = static_cast<size_t>(m_phase);
+            totals.Microseconds[index] += duration.count();
+            ++totals.Counts[index];
+        }
+
+        if (IsTraceEnabled())
+        {
+            std::string_view name = ToString(m_phase);
+
+            TraceLoggingWriteActivity(g_hTraceProvider,
+                "TimingSpan",
+                Logging::Telemetry().GetActivityId(),
+                nullptr,
+                TraceLoggingCountedString(name.data(), static_cast<ULONG>(name.size()), "Phase"),
+                TraceLoggingInt64(duration.count(), "DurationMicroseconds"),
+                TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE));
+        }
+    }
+}
@@ -41,4 +41,9 @@ namespace AppInstaller::Logging
     {
         return "Trace";
     }
+
+    bool TraceLogger::IsActive() const noexcept
+    {
+        return TraceLoggingProviderEnabled(g_hTraceProvider, 0, 0);
+    }
 }
@@ -11,8 +11,11 @@
 #include "AppInstallerArchitecture.h"
 #include "winget/Locale.h"
 
+#include <thread>
+
 namespace AppInstaller::Settings
 {
+    using namespace std::chrono_literals;
     using namespace std::string_view_literals;
     using namespace Runtime;
     using namespace Utility;
@@ -171,18 +174,39 @@ namespace AppInstaller::Settings
             }
         }
 
+        using ValidateFunction = void(*)(Json::Value&, std::map<Setting, details::SettingVariant>&, std::vector<UserSettings::Warning>&);
+
         template <size_t... S>
-        void ValidateAll(
-            Json::Value& root,
-            std::map<Setting, details::SettingVariant>& settings,
-            std::vector<UserSettings::Warning>& warnings,
-            std::index_sequence<S...>)
+        constexpr std::array<ValidateFunction, sizeof...(S)> GetValidateFunctions(std::index_sequence<S...>)
         {
-            // Use folding to call each setting validate function.
-            (FoldHelper{}, ..., Validate<static_cast<Setting>(S)>(root, settings, warnings));
+            return { Validate<static_cast<Setting>(S)>... };
+        }
+
+        // The validate function of each setting, indexed by the setting.
+        constexpr auto s_validateFunctions = GetValidateFunctions(std::make_index_sequence<static_cast<size_t>(Setting::Max)>());
+
+        // The time to wait after a change to the settings files before reading them, as editors may save them in several steps.
+        constexpr auto s_SettingsReloadDelay = 100ms;
+
+        // The settings that replaced the ones that the process started with, if they have been reloaded.
+        // Replaced settings are never destroyed, as there may still be references to them.
+        std::atomic<UserSettings*> s_reloadedUserSettings{ nullptr };
+
+        bool IsSettingsFileName(std::wstring_view fileName, const std::vector<std::wstring>& settingsFileNames)
+        {
+            return std::any_of(settingsFileNames.begin(), settingsFileNames.end(), [&](const std::wstring& settingsFileName)
+                {
+                    return CompareStringOrdinal(fileName.data(), static_cast<int>(fileName.size()),
+                        settingsFileName.c_str(), static_cast<int>(settingsFileName.size()), TRUE) == CSTR_EQUAL;
+                });
         }
     }
 
+    struct UserSettings::ParsedFile
+    {
+        Json::Value Root;
+    };
+
     namespace details
     {
 #define WINGET_VALIDATE_SIGNATURE(_setting_) \
@@ -229,7 +253,12 @@ namespace AppInstaller::Settings
         WINGET_VALIDATE_PASS_THROUGH(EFDependencies)
         WINGET_VALIDATE_PASS_THROUGH(TelemetryDisable)
         WINGET_VALIDATE_PASS_THROUGH(EFDirectMSI)
+        WINGET_VALIDATE_PASS_THROUGH(EFStreamingMsix)
+        WINGET_VALIDATE_PASS_THROUGH(EFExtractSourceUpdates)
+        WINGET_VALIDATE_PASS_THROUGH(EFCacheCommand)
         WINGET_VALIDATE_PASS_THROUGH(EnableSelfInitiatedMinidump)
+        WINGET_VALIDATE_PASS_THROUGH(NetworkDownloadBandwidthLimitInKBps)
+        WINGET_VALIDATE_PASS_THROUGH(NetworkBackgroundDownloads)
 
         WINGET_VALIDATE_SIGNATURE(InstallArchitecturePreference)
         {
@@ -316,6 +345,35 @@ namespace AppInstaller::Settings
         {
             return std::chrono::seconds(value);
         }
+
+        WINGET_VALIDATE_SIGNATURE(NetworkSearchTimeoutInSeconds)
+        {
+            return std::chrono::seconds(value);
+        }
+
+        WINGET_VALIDATE_SIGNATURE(NetworkDownloadSegments)
+        {
+            static constexpr uint32_t s_maximumDownloadSegments = 16;
+
+            if (value == 0 || value > s_maximumDownloadSegments)
+            {
+                return {};
+            }
+
+            return value;
+        }
+
+        WINGET_VALIDATE_SIGNATURE(NetworkDownloadAhead)
+        {
+            static constexpr uint32_t s_maximumDownloadAhead = 8;
+
+            if (value > s_maximumDownloadAhead)
+            {
+                return {};
+            }
+
+            return value;
+        }
     }
 
 #ifndef AICLI_DISABLE_TEST_HOOKS
@@ -338,6 +396,12 @@ namespace AppInstaller::Settings
             return *s_UserSettings_Override;
         }
 #endif
+        UserSettings* reloaded = s_reloadedUserSettings.load();
+        if (reloaded)
+        {
+            return *reloaded;
+        }
+
         if (!s_userSettingsInitialized)
         {
             s_userSettingsInInitialization = true;
@@ -410,7 +474,9 @@ namespace AppInstaller::Settings
 
         if (!settingsRoot.isNull())
         {
-            ValidateAll(settingsRoot, m_settings, m_warnings, std::make_index_sequence<static_cast<size_t>(Setting::Max)>());
+            // The settings are validated as they are read.
+            m_parsedFile = std::make_unique<ParsedFile>();
+            m_parsedFile->Root = std::move(settingsRoot);
         }
         else
         {
@@ -418,6 +484,122 @@ namespace AppInstaller::Settings
         }
     }
 
+    UserSettings::~UserSettings() = default;
+
+    std::vector<UserSettings::Warning> const& UserSettings::GetWarnings() const
+    {
+        ValidateAll();
+        return m_warnings;
+    }
+
+    const details::SettingVariant* UserSettings::GetValidated(Setting setting) const
+    {
+        std::lock_guard<std::recursive_mutex> lock{ m_lock };
+
+        size_t index = static_cast<size_t>(setting);
+        if (m_parsedFile && !m_validated.test(index))
+        {
+            // Mark the setting first, so that reading it again while it is validated does not recurse.
+            m_validated.set(index);
+            s_validateFunctions[index](m_parsedFile->Root, m_settings, m_warnings);
+
+            if (m_validated.all())
+            {
+                m_parsedFile.reset();
+            }
+        }
+
+        auto itr = m_settings.find(setting);
+        return itr == m_settings.end() ? nullptr : &itr->second;
+    }
+
+    void UserSettings::ValidateAll() const
+    {
+        for (size_t i = 0; i < static_cast<size_t>(Setting::Max); ++i)
+        {
+            std::ignore = GetValidated(static_cast<Setting>(i));
+        }
+    }
+
+    void UserSettings::ResetToDefaults()
+    {
+        std::lock_guard<std::recursive_mutex> lock{ m_lock };
+        m_parsedFile.reset();
+        m_validated.set();
+        m_settings.clear();
+    }
+
+    void UserSettings::ReloadOnFileChange()
+    {
+        static std::once_flag s_watchOnce;
+        std::call_once(s_watchOnce, []()
+            {
+                std::filesystem::path directory = SettingsFilePath().parent_path();
+                std::filesystem::create_directories(directory);
+
+                wil::unique_hfile directoryHandle{ CreateFileW(directory.c_str(), FILE_LIST_DIRECTORY,
+                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr) };
+                THROW_LAST_ERROR_IF(!directoryHandle);
+
+                std::vector<std::wstring> settingsFileNames
+                {
+                    SettingsFilePath().filename().wstring(),
+                    Stream{ Stream::BackupUserSettings }.GetPath().filename().wstring(),
+                };
+
+                std::thread([directoryHandle = std::move(directoryHandle), settingsFileNames = std::move(settingsFileNames)]()
+                    {
+                        // The buffer must be DWORD aligned.
+                        std::vector<DWORD> buffer(16 * 1024);
+
+                        for (;;)
+                        {
+                            DWORD bytesReturned = 0;
+                            if (!ReadDirectoryChangesW(directoryHandle.get(), buffer.data(), static_cast<DWORD>(buffer.size() * sizeof(DWORD)), FALSE,
+                                FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE, &bytesReturned, nullptr, nullptr))
+                            {
+                                AICLI_LOG(Core, Error, << "Stopped watching the settings files: " << GetLastError());
+                                return;
+                            }
+
+                            // No changes are returned when there were too many to hold in the buffer.
+                            bool settingsChanged = (bytesReturned == 0);
+
+                            const BYTE* current = reinterpret_cast<const BYTE*>(buffer.data());
+                            while (!settingsChanged && bytesReturned != 0)
+                            {
+                                const auto* information = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(current);
+                                settingsChanged = IsSettingsFileName({ information->FileName, information->FileNameLength / sizeof(WCHAR) }, settingsFileNames);
+
+                                if (information->NextEntryOffset == 0)
+                                {
+                                    break;
+                                }
+
+                                current += information->NextEntryOffset;
+                            }
+
+                            if (!settingsChanged)
+                            {
+                                continue;
+                            }
+
+                            std::this_thread::sleep_for(s_SettingsReloadDelay);
+
+                            try
+                            {
+                                s_reloadedUserSettings = new UserSettings();
+                                AICLI_LOG(Core, Info, << "Settings reloaded after the settings file changed");
+                            }
+                            catch (...)
+                            {
+                                AICLI_LOG(Core, Error, << "Failed to reload the settings after the settings file changed");
+                            }
+                        }
+                    }).detach();
+            });
+    }
+
     void UserSettings::PrepareToShellExecuteFile() const
     {
         UserSettingsType userSettingType = GetType();
@@ -11,6 +11,22 @@ namespace AppInstaller::Utility
     static constexpr std::string_view s_Version_Part_Latest = "Latest"sv;
     static constexpr std::string_view s_Version_Part_Unknown = "Unknown"sv;
 
+    // The bytes of the sort key; each group must keep its relative order for the keys to sort correctly.
+    static constexpr uint8_t s_SortKey_Unknown = 0x00;
+    static constexpr uint8_t s_SortKey_Known = 0x01;
+    static constexpr uint8_t s_SortKey_Latest = 0x02;
+
+    static constexpr uint8_t s_SortKey_EndOfParts = 0x00;
+    static constexpr uint8_t s_SortKey_Part = 0x01;
+
+    static constexpr uint8_t s_SortKey_OtherPresent = 0x01;
+    static constexpr uint8_t s_SortKey_OtherEmpty = 0x02;
+
+    // Within the supplemental value, a zero byte is escaped so that the terminator sorts before any byte.
+    static constexpr uint8_t s_SortKey_Escape = 0x00;
+    static constexpr uint8_t s_SortKey_EscapedZero = 0xFF;
+    static constexpr uint8_t s_SortKey_EndOfOther = 0x01;
+
     Version::Version(std::string&& version, std::string_view splitChars)
     {
         Assign(std::move(version), splitChars);
@@ -164,6 +180,71 @@ namespace AppInstaller::Utility
         return result;
     }
 
+    std::vector<uint8_t> Version::GetSortKey() const
+    {
+        std::vector<uint8_t> result;
+
+        if (IsLatest())
+        {
+            result.push_back(s_SortKey_Latest);
+            return result;
+        }
+        else if (IsUnknown())
+        {
+            result.push_back(s_SortKey_Unknown);
+            return result;
+        }
+
+        result.push_back(s_SortKey_Known);
+
+        for (const Part& part : m_parts)
+        {
+            result.push_back(s_SortKey_Part);
+
+            // A larger integer always needs at least as many bytes, so the length byte orders them first.
+            uint8_t length = 0;
+            for (uint64_t remaining = part.Integer; remaining != 0; remaining >>= 8)
+            {
+                ++length;
+            }
+
+            result.push_back(length);
+            for (uint8_t i = length; i > 0; --i)
+            {
+                result.push_back(static_cast<uint8_t>(part.Integer >> ((i - 1) * 8)));
+            }
+
+            if (part.Other.empty())
+            {
+                result.push_back(s_SortKey_OtherEmpty);
+            }
+            else
+            {
+                result.push_back(s_SortKey_OtherPresent);
+
+                for (char c : part.Other)
+                {
+                    if (c == 0)
+                    {
+                        result.push_back(s_SortKey_Escape);
+                        result.push_back(s_SortKey_EscapedZero);
+                    }
+                    else
+                    {
+                        result.push_back(static_cast<uint8_t>(c));
+                    }
+                }
+
+                result.push_back(s_SortKey_Escape);
+                result.push_back(s_SortKey_EndOfOther);
+            }
+        }
+
+        result.push_back(s_SortKey_EndOfParts);
+
+        return result;
+    }
+
     Version::Part::Part(const std::string& part)
     {
         const char* begin = part.c_str();
@@ -230,7 +311,7 @@ namespace AppInstaller::Utility
     }
 
     VersionAndChannel::VersionAndChannel(Version&& version, Channel&& channel) : 
-        m_version(std::move(version)), m_channel(std::move(channel)) {}
+        m_version(std::move(version)), m_channel(std::move(channel)), m_versionSortKey(m_version.GetSortKey()) {}
 
     std::string VersionAndChannel::ToString() const
     {
@@ -256,7 +337,7 @@ namespace AppInstaller::Utility
             return false;
         }
         // We intentionally invert the order for version here.
-        else if (other.m_version < m_version)
+        else if (other.m_versionSortKey < m_versionSortKey)
         {
             return true;
         }
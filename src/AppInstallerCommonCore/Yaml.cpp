@@ -3,6 +3,7 @@
 #include <pch.h>
 #include "winget/Yaml.h"
 #include "YamlWrapper.h"
+#include "winget/AllocationTracking.h"
 #include "AppInstallerErrors.h"
 #include "AppInstallerLogging.h"
 #include "AppInstallerStrings.h"
@@ -127,8 +128,8 @@ namespace AppInstaller::YAML
         return m_what.c_str();
     }
 
-    Node::Node(Type type, std::string tag, const YAML::Mark& mark) :
-        m_type(type), m_tag(std::move(tag)), m_mark(mark)
+    Node::Node(Type type, const YAML::Mark& mark) :
+        m_type(type), m_mark(mark)
     {
         if (m_type == Type::Sequence)
         {
@@ -146,6 +147,18 @@ namespace AppInstaller::YAML
         m_scalar = std::move(value);
     }
 
+    void Node::Reserve(size_t count)
+    {
+        if (m_type == Type::Sequence)
+        {
+            m_sequence->reserve(count);
+        }
+        else if (m_type == Type::Mapping)
+        {
+            m_mapping->reserve(count);
+        }
+    }
+
     bool Node::operator<(const Node& other) const
     {
         Require(Type::Scalar);
@@ -156,7 +169,7 @@ namespace AppInstaller::YAML
     Node& Node::operator[](std::string_view key)
     {
         Require(Type::Mapping);
-        auto itrs = m_mapping->equal_range(key);
+        auto itrs = FindMappingEntries(m_mapping.value(), key);
 
         if (itrs.first == itrs.second)
         {
@@ -173,7 +186,7 @@ namespace AppInstaller::YAML
     const Node& Node::operator[](std::string_view key) const
     {
         Require(Type::Mapping);
-        auto itrs = m_mapping->equal_range(key);
+        auto itrs = FindMappingEntries(m_mapping.value(), key);
 
         if (itrs.first == itrs.second)
         {
@@ -222,7 +235,7 @@ namespace AppInstaller::YAML
         return m_sequence.value();
     }
 
-    const std::multimap<Node, Node>& Node::Mapping() const
+    const std::vector<std::pair<Node, Node>>& Node::Mapping() const
     {
         Require(Type::Mapping);
         return m_mapping.value();
@@ -265,56 +278,40 @@ namespace AppInstaller::YAML
         }
     }
 
-    Node Load(std::string_view input)
+    Node Load(std::string_view input, const LoadLimits& limits)
     {
+        Memory::AllocationScope allocationScope{ Memory::AllocationSubsystem::Yaml };
         Wrapper::Parser parser(input);
-        Wrapper::Document document = parser.Load();
-
-        if (document.HasRoot())
-        {
-            return document.GetRoot();
-        }
-        else
-        {
-            return {};
-        }
+        return parser.LoadRoot(limits);
     }
 
-    Node Load(const std::string& input)
+    Node Load(const std::string& input, const LoadLimits& limits)
     {
-        return Load(static_cast<std::string_view>(input));
+        return Load(static_cast<std::string_view>(input), limits);
     }
 
-    Node Load(std::istream& input, Utility::SHA256::HashBuffer* hashOut)
+    Node Load(std::istream& input, Utility::SHA256::HashBuffer* hashOut, const LoadLimits& limits)
     {
+        Memory::AllocationScope allocationScope{ Memory::AllocationSubsystem::Yaml };
         Wrapper::Parser parser(input, hashOut);
-        Wrapper::Document document = parser.Load();
-
-        if (document.HasRoot())
-        {
-            return document.GetRoot();
-        }
-        else
-        {
-            return {};
-        }
+        return parser.LoadRoot(limits);
     }
 
-    Node Load(const std::filesystem::path& input, Utility::SHA256::HashBuffer* hashOut)
+    Node Load(const std::filesystem::path& input, Utility::SHA256::HashBuffer* hashOut, const LoadLimits& limits)
     {
         std::ifstream stream(input, std::ios_base::in | std::ios_base::binary);
         THROW_LAST_ERROR_IF(stream.fail());
-        return Load(stream, hashOut);
+        return Load(stream, hashOut, limits);
     }
 
-    Node Load(const std::filesystem::path& input)
+    Node Load(const std::filesystem::path& input, const LoadLimits& limits)
     {
-        return Load(input, nullptr);
+        return Load(input, nullptr, limits);
     }
 
-    Node Load(const std::filesystem::path& input, Utility::SHA256::HashBuffer& hashOut)
+    Node Load(const std::filesystem::path& input, Utility::SHA256::HashBuffer& hashOut, const LoadLimits& limits)
     {
-        return Load(input, &hashOut);
+        return Load(input, &hashOut, limits);
     }
 
     Emitter::Emitter() :
@@ -0,0 +1,466 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "winget/Yaml.h"
+
+#include <valijson/adapters/adapter.hpp>
+#include <valijson/adapters/basic_adapter.hpp>
+#include <valijson/adapters/frozen_value.hpp>
+#include <valijson/exceptions.hpp>
+
+#include <iterator>
+#include <string>
+#include <string_view>
+
+
+// A valijson adapter over a YAML node tree, so that it can be validated against a schema without converting it to json first.
+// YAML scalars are untyped, so the type that a scalar is read as comes from the key of the mapping that contains it,
+// which is inherited by the values of a sequence.
+namespace AppInstaller::JsonSchema::Yaml
+{
+    // The type that a scalar is read as.
+    enum class ScalarType
+    {
+        String,
+        Int,
+        Bool,
+    };
+
+    // Gets the type of the scalars found under the given mapping key.
+    using ScalarTypeFunction = ScalarType(*)(std::string_view key);
+
+    class YamlAdapter;
+    class YamlArrayValueIterator;
+    class YamlObjectMemberIterator;
+
+    using YamlObjectMember = std::pair<std::string, YamlAdapter>;
+
+    // The node referenced by an adapter, along with how its scalars are typed.
+    struct YamlNodeReference
+    {
+        const YAML::Node* Node = nullptr;
+        ScalarType Type = ScalarType::String;
+        ScalarTypeFunction TypeFunction = nullptr;
+
+        static const YAML::Node& EmptyMapping()
+        {
+            static const YAML::Node s_emptyMapping{ YAML::Node::Type::Mapping, {} };
+            return s_emptyMapping;
+        }
+
+        ScalarType GetTypeForKey(std::string_view key) const
+        {
+            return TypeFunction ? TypeFunction(key) : ScalarType::String;
+        }
+    };
+
+    class YamlArray
+    {
+    public:
+        using const_iterator = YamlArrayValueIterator;
+        using iterator = YamlArrayValueIterator;
+
+        YamlArray(const YamlNodeReference& reference) : m_reference(reference)
+        {
+            if (!reference.Node->IsSequence())
+            {
+                valijson::throwRuntimeError("Value is not an array.");
+            }
+        }
+
+        YamlArrayValueIterator begin() const;
+
+        YamlArrayValueIterator end() const;
+
+        size_t size() const
+        {
+            return m_reference.Node->Sequence().size();
+        }
+
+    private:
+        YamlNodeReference m_reference;
+    };
+
+    class YamlObject
+    {
+    public:
+        using const_iterator = YamlObjectMemberIterator;
+        using iterator = YamlObjectMemberIterator;
+
+        YamlObject(const YamlNodeReference& reference) : m_reference(reference)
+        {
+            if (!reference.Node->IsMap())
+            {
+                valijson::throwRuntimeError("Value is not an object.");
+            }
+        }
+
+        YamlObjectMemberIterator begin() const;
+
+        YamlObjectMemberIterator end() const;
+
+        YamlObjectMemberIterator find(const std::string& propertyName) const;
+
+        size_t size() const
+        {
+            return m_reference.Node->Mapping().size();
+        }
+
+    private:
+        YamlNodeReference m_reference;
+    };
+
+    class YamlFrozenValue : public valijson::adapters::FrozenValue
+    {
+    public:
+        explicit YamlFrozenValue(const YamlNodeReference& reference) :
+            m_node(*reference.Node), m_type(reference.Type), m_typeFunction(reference.TypeFunction) {}
+
+        FrozenValue* clone() const override
+        {
+            return new YamlFrozenValue(YamlNodeReference{ &m_node, m_type, m_typeFunction });
+        }
+
+        bool equalTo(const valijson::adapters::Adapter& other, bool strict) const override;
+
+    private:
+        YAML::Node m_node;
+        ScalarType m_type;
+        ScalarTypeFunction m_typeFunction;
+    };
+
+    class YamlValue
+    {
+    public:
+        YamlValue() : m_reference{ &YamlNodeReference::EmptyMapping() } {}
+
+        YamlValue(const YamlNodeReference& reference) : m_reference(reference) {}
+
+        valijson::adapters::FrozenValue* freeze() const
+        {
+            return new YamlFrozenValue(m_reference);
+        }
+
+        opt::optional<YamlArray> getArrayOptional() const
+        {
+            if (isArray())
+            {
+                return opt::make_optional(YamlArray(m_reference));
+            }
+
+            return {};
+        }
+
+        bool getArraySize(size_t& result) const
+        {
+            if (isArray())
+            {
+                result = Node().Sequence().size();
+                return true;
+            }
+
+            return false;
+        }
+
+        bool getBool(bool& result) const
+        {
+            if (isBool())
+            {
+                result = Node().as<bool>();
+                return true;
+            }
+
+            return false;
+        }
+
+        bool getDouble(double&) const
+        {
+            return false;
+        }
+
+        bool getInteger(int64_t& result) const
+        {
+            if (isInteger())
+            {
+                result = static_cast<int64_t>(Node().as<int>());
+                return true;
+            }
+
+            return false;
+        }
+
+        opt::optional<YamlObject> getObjectOptional() const
+        {
+            if (isObject())
+            {
+                return opt::make_optional(YamlObject(m_reference));
+            }
+
+            return {};
+        }
+
+        bool getObjectSize(size_t& result) const
+        {
+            if (isObject())
+            {
+                result = Node().Mapping().size();
+                return true;
+            }
+
+            return false;
+        }
+
+        bool getString(std::string& result) const
+        {
+            if (isString())
+            {
+                result = Node().as<std::string>();
+                return true;
+            }
+
+            return false;
+        }
+
+        static bool hasStrictTypes()
+        {
+            return true;
+        }
+
+        bool isArray() const
+        {
+            return !isNull() && Node().IsSequence();
+        }
+
+        bool isBool() const
+        {
+            return IsTypedScalar(ScalarType::Bool);
+        }
+
+        bool isDouble() const
+        {
+            return false;
+        }
+
+        bool isInteger() const
+        {
+            return IsTypedScalar(ScalarType::Int);
+        }
+
+        bool isNull() const
+        {
+            // An empty scalar is null, as it is when reading the manifest
+            return Node().IsNull();
+        }
+
+        bool isNumber() const
+        {
+            return isInteger();
+        }
+
+        bool isObject() const
+        {
+            return !isNull() && Node().IsMap();
+        }
+
+        bool isString() const
+        {
+            return IsTypedScalar(ScalarType::String);
+        }
+
+    private:
+        const YAML::Node& Node() const { return *m_reference.Node; }
+
+        bool IsTypedScalar(ScalarType type) const
+        {
+            return !isNull() && Node().IsScalar() && m_reference.Type == type;
+        }
+
+        YamlNodeReference m_reference;
+    };
+
+    class YamlAdapter : public valijson::adapters::BasicAdapter<YamlAdapter, YamlArray, YamlObjectMember, YamlObject, YamlValue>
+    {
+    public:
+        YamlAdapter() : BasicAdapter() {}
+
+        YamlAdapter(const YamlNodeReference& reference) : BasicAdapter(YamlValue{ reference }) {}
+
+        // Creates an adapter for the root node of a document.
+        YamlAdapter(const YAML::Node& root, ScalarTypeFunction typeFunction) :
+            BasicAdapter(YamlValue{ YamlNodeReference{ &root, ScalarType::String, typeFunction } }) {}
+    };
+
+    class YamlArrayValueIterator
+    {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = YamlAdapter;
+        using difference_type = YamlAdapter;
+        using pointer = YamlAdapter*;
+        using reference = YamlAdapter&;
+
+        YamlArrayValueIterator(std::vector<YAML::Node>::const_iterator itr, const YamlNodeReference& parent) :
+            m_itr(itr), m_parent(parent) {}
+
+        YamlAdapter operator*() const
+        {
+            // Values of a sequence are typed as the sequence is
+            return YamlAdapter(YamlNodeReference{ &*m_itr, m_parent.Type, m_parent.TypeFunction });
+        }
+
+        valijson::adapters::DerefProxy<YamlAdapter> operator->() const
+        {
+            return valijson::adapters::DerefProxy<YamlAdapter>(**this);
+        }
+
+        bool operator==(const YamlArrayValueIterator& rhs) const
+        {
+            return m_itr == rhs.m_itr;
+        }
+
+        bool operator!=(const YamlArrayValueIterator& rhs) const
+        {
+            return !(m_itr == rhs.m_itr);
+        }
+
+        YamlArrayValueIterator& operator++()
+        {
+            ++m_itr;
+            return *this;
+        }
+
+        YamlArrayValueIterator operator++(int)
+        {
+            YamlArrayValueIterator result = *this;
+            ++(*this);
+            return result;
+        }
+
+        YamlArrayValueIterator& operator--()
+        {
+            --m_itr;
+            return *this;
+        }
+
+        void advance(std::ptrdiff_t n)
+        {
+            std::advance(m_itr, n);
+        }
+
+    private:
+        std::vector<YAML::Node>::const_iterator m_itr;
+        YamlNodeReference m_parent;
+    };
+
+    class YamlObjectMemberIterator
+    {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = YamlObjectMember;
+        using difference_type = YamlObjectMember;
+        using pointer = YamlObjectMember*;
+        using reference = YamlObjectMember&;
+
+        YamlObjectMemberIterator(std::vector<std::pair<YAML::Node, YAML::Node>>::const_iterator itr, const YamlNodeReference& parent) :
+            m_itr(itr), m_parent(parent) {}
+
+        YamlObjectMember operator*() const
+        {
+            // We only support string type as key in our manifest
+            std::string key = m_itr->first.as<std::string>();
+            ScalarType type = m_parent.GetTypeForKey(key);
+            return YamlObjectMember(std::move(key), YamlAdapter(YamlNodeReference{ &m_itr->second, type, m_parent.TypeFunction }));
+        }
+
+        valijson::adapters::DerefProxy<YamlObjectMember> operator->() const
+        {
+            return valijson::adapters::DerefProxy<YamlObjectMember>(**this);
+        }
+
+        bool operator==(const YamlObjectMemberIterator& rhs) const
+        {
+            return m_itr == rhs.m_itr;
+        }
+
+        bool operator!=(const YamlObjectMemberIterator& rhs) const
+        {
+            return !(m_itr == rhs.m_itr);
+        }
+
+        const YamlObjectMemberIterator& operator++()
+        {
+            ++m_itr;
+            return *this;
+        }
+
+        YamlObjectMemberIterator operator++(int)
+        {
+            YamlObjectMemberIterator result = *this;
+            ++(*this);
+            return result;
+        }
+
+        YamlObjectMemberIterator operator--()
+        {
+            --m_itr;
+            return *this;
+        }
+
+    private:
+        std::vector<std::pair<YAML::Node, YAML::Node>>::const_iterator m_itr;
+        YamlNodeReference m_parent;
+    };
+
+    inline bool YamlFrozenValue::equalTo(const valijson::adapters::Adapter& other, bool strict) const
+    {
+        return YamlAdapter(YamlNodeReference{ &m_node, m_type, m_typeFunction }).equalTo(other, strict);
+    }
+
+    inline YamlArrayValueIterator YamlArray::begin() const
+    {
+        return { m_reference.Node->Sequence().begin(), m_reference };
+    }
+
+    inline YamlArrayValueIterator YamlArray::end() const
+    {
+        return { m_reference.Node->Sequence().end(), m_reference };
+    }
+
+    inline YamlObjectMemberIterator YamlObject::begin() const
+    {
+        return { m_reference.Node->Mapping().begin(), m_reference };
+    }
+
+    inline YamlObjectMemberIterator YamlObject::end() const
+    {
+        return { m_reference.Node->Mapping().end(), m_reference };
+    }
+
+    inline YamlObjectMemberIterator YamlObject::find(const std::string& propertyName) const
+    {
+        const auto& mapping = m_reference.Node->Mapping();
+        for (auto itr = mapping.begin(); itr != mapping.end(); ++itr)
+        {
+            if (itr->first.IsScalar() && itr->first.as<std::string>() == propertyName)
+            {
+                return { itr, m_reference };
+            }
+        }
+
+        return { mapping.end(), m_reference };
+    }
+}
+
+namespace valijson::adapters
+{
+    template<>
+    struct AdapterTraits<AppInstaller::JsonSchema::Yaml::YamlAdapter>
+    {
+        typedef AppInstaller::YAML::Node DocumentType;
+
+        static std::string adapterName()
+        {
+            return "YamlAdapter";
+        }
+    };
+}
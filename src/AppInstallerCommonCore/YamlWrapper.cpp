@@ -11,23 +11,6 @@ namespace AppInstaller::YAML::Wrapper
 {
     namespace
     {
-        Node::Type ConvertNodeType(yaml_node_type_t type)
-        {
-            switch (type)
-            {
-            case YAML_NO_NODE:
-                return Node::Type::None;
-            case YAML_SCALAR_NODE:
-                return Node::Type::Scalar;
-            case YAML_SEQUENCE_NODE:
-                return Node::Type::Sequence;
-            case YAML_MAPPING_NODE:
-                return Node::Type::Mapping;
-            }
-
-            THROW_HR(E_UNEXPECTED);
-        }
-
         Exception::Type ConvertErrorType(yaml_error_type_t type)
         {
             switch (type)
@@ -65,11 +48,6 @@ namespace AppInstaller::YAML::Wrapper
             }
         }
 
-        std::string ConvertScalarToString(yaml_node_t* node)
-        {
-            return ConvertYamlString(node->data.scalar.value, node->data.scalar.length);
-        }
-
         Mark ConvertMark(const yaml_mark_t& mark)
         {
             return { mark.line + 1, mark.column + 1 };
@@ -101,99 +79,6 @@ namespace AppInstaller::YAML::Wrapper
         }
     }
 
-    bool Document::HasRoot()
-    {
-        return yaml_document_get_root_node(&m_document) != nullptr;
-    }
-
-    Node Document::GetRoot()
-    {
-        yaml_node_t* root = yaml_document_get_root_node(&m_document);
-
-        if (!root)
-        {
-            return {};
-        }
-
-        Node result(ConvertNodeType(root->type), ConvertYamlString(root->tag), ConvertMark(root->start_mark));
-
-        struct StackItem
-        {
-            StackItem(yaml_node_t* yn, Node* n) :
-                yamlNode(yn), node(n) {}
-
-            yaml_node_t* yamlNode = nullptr;
-            Node* node = nullptr;
-            size_t childOffset = 0;
-        };
-
-        std::stack<StackItem> resultStack;
-        resultStack.emplace(root, &result);
-
-        while (!resultStack.empty())
-        {
-            StackItem& stackItem = resultStack.top();
-            bool pop = false;
-
-            switch (stackItem.yamlNode->type)
-            {
-            case YAML_NO_NODE:
-                pop = true;
-                break;
-            case YAML_SCALAR_NODE:
-                stackItem.node->SetScalar(ConvertScalarToString(stackItem.yamlNode));
-                pop = true;
-                break;
-            case YAML_SEQUENCE_NODE:
-            {
-                yaml_node_item_t* child = stackItem.yamlNode->data.sequence.items.start + stackItem.childOffset++;
-                if (child < stackItem.yamlNode->data.sequence.items.top)
-                {
-                    yaml_node_t* childYamlNode = GetNode(*child);
-                    Node& childNode = stackItem.node->AddSequenceNode(ConvertNodeType(childYamlNode->type), ConvertYamlString(childYamlNode->tag), ConvertMark(childYamlNode->start_mark));
-                    resultStack.emplace(childYamlNode, &childNode);
-                }
-                else
-                {
-                    // We've reached the end of the sequence
-                    pop = true;
-                }
-                break;
-            }
-            case YAML_MAPPING_NODE:
-            {
-                yaml_node_pair_t* child = stackItem.yamlNode->data.mapping.pairs.start + stackItem.childOffset++;
-                if (child < stackItem.yamlNode->data.mapping.pairs.top)
-                {
-                    yaml_node_t* keyYamlNode = GetNode(child->key);
-                    THROW_HR_IF(APPINSTALLER_CLI_ERROR_YAML_INVALID_MAPPING_KEY, keyYamlNode->type != YAML_SCALAR_NODE);
-
-                    Node keyNode(ConvertNodeType(keyYamlNode->type), ConvertYamlString(keyYamlNode->tag), ConvertMark(keyYamlNode->start_mark));
-                    keyNode.SetScalar(ConvertScalarToString(keyYamlNode));
-
-                    yaml_node_t* valueYamlNode = GetNode(child->value);
-
-                    Node& childNode = stackItem.node->AddMappingNode(std::move(keyNode), ConvertNodeType(valueYamlNode->type), ConvertYamlString(valueYamlNode->tag), ConvertMark(valueYamlNode->start_mark));
-                    resultStack.emplace(valueYamlNode, &childNode);
-                }
-                else
-                {
-                    // We've reached the end of the mapping
-                    pop = true;
-                }
-                break;
-            }
-            }
-
-            if (pop)
-            {
-                resultStack.pop();
-            }
-        }
-
-        return result;
-    }
-
     int Document::AddScalar(std::string_view value)
     {
         int result = yaml_document_add_scalar(&m_document, NULL, reinterpret_cast<const yaml_char_t*>(value.data()), static_cast<int>(value.size()), YAML_ANY_SCALAR_STYLE);
@@ -238,19 +123,20 @@ namespace AppInstaller::YAML::Wrapper
         return result;
     }
 
-    Parser::Parser(std::string_view input) : m_token(true), m_input(input)
+    Parser::Parser(std::string_view input) : m_token(true), m_input(input.data() ? input : std::string_view{ "" })
     {
         THROW_HR_IF(APPINSTALLER_CLI_ERROR_YAML_INIT_FAILED, !yaml_parser_initialize(&m_parser));
 
         PrepareInput();
-        yaml_parser_set_input_string(&m_parser, reinterpret_cast<const unsigned char*>(m_input.c_str()), m_input.size());
+        yaml_parser_set_input_string(&m_parser, reinterpret_cast<const unsigned char*>(m_input.data()), m_input.size());
     }
 
     Parser::Parser(std::istream& input, Utility::SHA256::HashBuffer* hashOut) : m_token(true)
     {
         THROW_HR_IF(APPINSTALLER_CLI_ERROR_YAML_INIT_FAILED, !yaml_parser_initialize(&m_parser));
 
-        m_input = Utility::ReadEntireStream(input);
+        m_inputBuffer = Utility::ReadEntireStream(input);
+        m_input = m_inputBuffer;
 
         if (hashOut)
         {
@@ -258,7 +144,7 @@ namespace AppInstaller::YAML::Wrapper
         }
 
         PrepareInput();
-        yaml_parser_set_input_string(&m_parser, reinterpret_cast<const unsigned char*>(m_input.c_str()), m_input.size());
+        yaml_parser_set_input_string(&m_parser, reinterpret_cast<const unsigned char*>(m_input.data()), m_input.size());
     }
 
     Parser::~Parser()
@@ -269,30 +155,213 @@ namespace AppInstaller::YAML::Wrapper
         }
     }
 
-    Document Parser::Load()
+    Node Parser::LoadRoot(const LoadLimits& limits)
     {
-        Document result;
+        // A sequence or mapping whose end has not been reached yet, with the key of the next value of a mapping.
+        struct PendingNode
+        {
+            PendingNode(Node::Type type, const Mark& mark, std::string anchor) :
+                Value(type, mark), Anchor(std::move(anchor)) {}
+
+            Node Value;
+            std::optional<Node> Key;
+            std::string Anchor;
+            // The nodes in the tree of this node, and the number of sequence and mapping levels in it, as the limits are applied to copies of it.
+            size_t NodeCount = 1;
+            size_t Height = 1;
+        };
 
-        if (!yaml_parser_load(&m_parser, &result))
+        // A node with an anchor, that an alias is expanded into a copy of.
+        struct AnchoredNode
         {
-            Exception::Type type = ConvertErrorType(m_parser.error);
+            Node Value;
+            Mark AnchorMark;
+            size_t NodeCount = 0;
+            size_t Height = 0;
+        };
 
-            switch (type)
+        std::vector<PendingNode> pending;
+        std::map<std::string, AnchoredNode> anchors;
+        size_t nodeCount = 0;
+        size_t aliasExpansions = 0;
+        Node result;
+
+        // Enforces the limits for the nodes being added at the depth of the next node.
+        auto checkLimits = [&](size_t count, size_t height)
+        {
+            nodeCount += count;
+            THROW_HR_IF_MSG(APPINSTALLER_CLI_ERROR_YAML_LIMIT_EXCEEDED, nodeCount > limits.MaximumNodeCount,
+                "YAML document exceeds the maximum node count of %zu", limits.MaximumNodeCount);
+
+            // The root node is at depth 1
+            THROW_HR_IF_MSG(APPINSTALLER_CLI_ERROR_YAML_LIMIT_EXCEEDED, height > 0 && pending.size() + height > limits.MaximumDepth,
+                "YAML document exceeds the maximum depth of %zu", limits.MaximumDepth);
+        };
+
+        // Libyaml rejects an anchor that is used again, rather than replacing it.
+        auto checkAnchor = [&](yaml_char_t* anchor, const yaml_mark_t& mark) -> std::string
+        {
+            if (!anchor)
+            {
+                return {};
+            }
+
+            std::string name = ConvertYamlString(anchor);
+            auto itr = anchors.find(name);
+            if (itr != anchors.end())
             {
-            case Exception::Type::Memory:
-                THROW_EXCEPTION(Exception(type));
-            case Exception::Type::Reader:
-                THROW_EXCEPTION(Exception(type, m_parser.problem, m_parser.problem_offset, m_parser.problem_value));
-            case Exception::Type::Scanner:
-            case Exception::Type::Parser:
-            case Exception::Type::Composer:
-                THROW_EXCEPTION(Exception(type, m_parser.problem, ConvertMark(m_parser.problem_mark), m_parser.context, ConvertMark(m_parser.context_mark)));
+                THROW_EXCEPTION(Exception(Exception::Type::Composer, "second occurrence", ConvertMark(mark), "found duplicate anchor; first occurrence", itr->second.AnchorMark));
+            }
+
+            for (const auto& item : pending)
+            {
+                if (item.Anchor == name)
+                {
+                    THROW_EXCEPTION(Exception(Exception::Type::Composer, "second occurrence", ConvertMark(mark), "found duplicate anchor; first occurrence", item.Value.Mark()));
+                }
+            }
+
+            return name;
+        };
+
+        auto addAnchor = [&](const std::string& anchor, const Node& node, size_t count, size_t height)
+        {
+            if (!anchor.empty())
+            {
+                anchors.emplace(anchor, AnchoredNode{ node, node.Mark(), count, height });
+            }
+        };
+
+        // Adds a node whose tree is complete to the node that contains it, or makes it the root.
+        auto addNode = [&](Node&& node, size_t count, size_t height)
+        {
+            if (pending.empty())
+            {
+                result = std::move(node);
+                return;
+            }
+
+            PendingNode& parent = pending.back();
+            parent.NodeCount += count;
+            parent.Height = std::max(parent.Height, height + 1);
+
+            if (parent.Value.IsSequence())
+            {
+                parent.Value.AddSequenceNode(std::move(node));
+            }
+            else if (!parent.Key)
+            {
+                THROW_HR_IF(APPINSTALLER_CLI_ERROR_YAML_INVALID_MAPPING_KEY, !node.IsScalar());
+                parent.Key = std::move(node);
+            }
+            else
+            {
+                parent.Value.AddMappingNode(std::move(parent.Key.value()), std::move(node));
+                parent.Key.reset();
+            }
+        };
+
+        for (;;)
+        {
+            yaml_event_t event;
+            if (!yaml_parser_parse(&m_parser, &event))
+            {
+                ThrowError();
+            }
+
+            auto deleteEvent = wil::scope_exit([&]() { yaml_event_delete(&event); });
+
+            switch (event.type)
+            {
+            case YAML_STREAM_END_EVENT:
+                // There is no document
+                return {};
+            case YAML_DOCUMENT_END_EVENT:
+                // Only the first document is loaded; the rest of the input is not parsed
+                return result;
+            case YAML_SCALAR_EVENT:
+            {
+                std::string anchor = checkAnchor(event.data.scalar.anchor, event.start_mark);
+                checkLimits(1, 0);
+
+                Node node(Node::Type::Scalar, ConvertMark(event.start_mark));
+                node.SetScalar(ConvertYamlString(event.data.scalar.value, event.data.scalar.length));
+                addAnchor(anchor, node, 1, 0);
+                addNode(std::move(node), 1, 0);
+                break;
+            }
+            case YAML_SEQUENCE_START_EVENT:
+            {
+                std::string anchor = checkAnchor(event.data.sequence_start.anchor, event.start_mark);
+                checkLimits(1, 1);
+                pending.emplace_back(Node::Type::Sequence, ConvertMark(event.start_mark), std::move(anchor));
+                break;
+            }
+            case YAML_MAPPING_START_EVENT:
+            {
+                std::string anchor = checkAnchor(event.data.mapping_start.anchor, event.start_mark);
+                checkLimits(1, 1);
+                pending.emplace_back(Node::Type::Mapping, ConvertMark(event.start_mark), std::move(anchor));
+                break;
+            }
+            case YAML_SEQUENCE_END_EVENT:
+            case YAML_MAPPING_END_EVENT:
+            {
+                PendingNode completed = std::move(pending.back());
+                pending.pop_back();
+                addAnchor(completed.Anchor, completed.Value, completed.NodeCount, completed.Height);
+                addNode(std::move(completed.Value), completed.NodeCount, completed.Height);
+                break;
+            }
+            case YAML_ALIAS_EVENT:
+            {
+                std::string anchor = ConvertYamlString(event.data.alias.anchor);
+
+                // An alias within the node that it refers to would expand into copies of itself without end
+                for (const auto& item : pending)
+                {
+                    THROW_HR_IF_MSG(APPINSTALLER_CLI_ERROR_YAML_LIMIT_EXCEEDED, item.Anchor == anchor,
+                        "YAML document exceeds the maximum depth of %zu", limits.MaximumDepth);
+                }
+
+                auto itr = anchors.find(anchor);
+                if (itr == anchors.end())
+                {
+                    THROW_EXCEPTION(Exception(Exception::Type::Composer, "found undefined alias", ConvertMark(event.start_mark)));
+                }
+
+                THROW_HR_IF_MSG(APPINSTALLER_CLI_ERROR_YAML_LIMIT_EXCEEDED, ++aliasExpansions > limits.MaximumAliasExpansions,
+                    "YAML document exceeds the maximum alias expansions of %zu", limits.MaximumAliasExpansions);
+
+                const AnchoredNode& anchored = itr->second;
+                checkLimits(anchored.NodeCount, anchored.Height);
+                addNode(Node{ anchored.Value }, anchored.NodeCount, anchored.Height);
+                break;
+            }
             default:
-                THROW_EXCEPTION(Exception(type, "An unexpected error type occurred in Parser::Load"));
+                // The stream and document starts carry nothing for the node tree
+                break;
             }
         }
+    }
 
-        return result;
+    void Parser::ThrowError()
+    {
+        Exception::Type type = ConvertErrorType(m_parser.error);
+
+        switch (type)
+        {
+        case Exception::Type::Memory:
+            THROW_EXCEPTION(Exception(type));
+        case Exception::Type::Reader:
+            THROW_EXCEPTION(Exception(type, m_parser.problem, m_parser.problem_offset, m_parser.problem_value));
+        case Exception::Type::Scanner:
+        case Exception::Type::Parser:
+        case Exception::Type::Composer:
+            THROW_EXCEPTION(Exception(type, m_parser.problem, ConvertMark(m_parser.problem_mark), m_parser.context, ConvertMark(m_parser.context_mark)));
+        default:
+            THROW_EXCEPTION(Exception(type, "An unexpected error type occurred in Parser::LoadRoot"));
+        }
     }
 
     void Parser::PrepareInput()
@@ -356,7 +425,8 @@ namespace AppInstaller::YAML::Wrapper
         // Must be ANSI (Windows-1252 assumed), convert to UTF-8
         AICLI_LOG(YAML, Verbose, << "Assuming ANSI Windows-1252");
         std::wstring utf16 = Utility::ConvertToUTF16(m_input, 1252);
-        m_input = Utility::ConvertToUTF8(utf16);
+        m_inputBuffer = Utility::ConvertToUTF8(utf16);
+        m_input = m_inputBuffer;
         yaml_parser_set_encoding(&m_parser, YAML_UTF8_ENCODING);
     }
 
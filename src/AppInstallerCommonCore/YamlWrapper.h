@@ -14,7 +14,7 @@
 namespace AppInstaller::YAML::Wrapper
 {
     // A libyaml yaml_document_t.
-    // A parsed document, created by the Parser.
+    // A document built to be dumped by the Emitter.
     struct Document
     {
         // Initializes the document.
@@ -34,12 +34,6 @@ namespace AppInstaller::YAML::Wrapper
         // it has been handed off to the emitter.
         void Detach() { m_token = false; }
 
-        // Determines whether the document has a root node.
-        bool HasRoot();
-
-        // Gets the root node of the document, if it has one.
-        Node GetRoot();
-
         // Adds a scalar node to the document.
         int AddScalar(std::string_view value);
 
@@ -67,6 +61,7 @@ namespace AppInstaller::YAML::Wrapper
     // The core parser construct for reading bytes directly.
     struct Parser
     {
+        // The input is not copied unless it must be converted, so it must outlive the parser.
         Parser(std::string_view input);
         Parser(std::istream& input, Utility::SHA256::HashBuffer* hashOut = nullptr);
 
@@ -80,16 +75,23 @@ namespace AppInstaller::YAML::Wrapper
 
         yaml_parser_t* operator&() { return &m_parser; }
 
-        // Loads the next document from the input, if one exists.
-        Document Load();
+        // Loads the root node of the first document from the input; the node is not defined if there is no document.
+        // The node tree is built directly from the parser events, rather than from a libyaml document built first.
+        // Throws if building the node tree would exceed the limits.
+        Node LoadRoot(const LoadLimits& limits);
 
     private:
         // Determines the type of encoding in use, transforming the input as necessary.
         void PrepareInput();
 
+        // Throws the error that the parser stopped on.
+        [[noreturn]] void ThrowError();
+
         DestructionToken m_token;
         yaml_parser_t m_parser;
-        std::string m_input;
+        // The input being parsed; it refers to the caller's input unless the parser needed its own copy.
+        std::string_view m_input;
+        std::string m_inputBuffer;
     };
 
     // A libyaml yaml_event_t.
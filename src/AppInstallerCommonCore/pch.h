@@ -13,6 +13,8 @@
 #include <icu.h>
 #include <msi.h>
 #include <DbgHelp.h>
+#include <wintrust.h>
+#include <Softpub.h>
 
 #include "TraceLogging.h"
 
@@ -30,6 +32,7 @@
 #pragma warning( pop )
 
 #include <algorithm>
+#include <array>
 #include <chrono>
 #include <condition_variable>
 #include <cwctype>
@@ -40,16 +43,20 @@
 #include <iomanip>
 #include <iterator>
 #include <limits>
+#include <list>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <ostream>
 #include <regex>
 #include <set>
+#include <shared_mutex>
 #include <string>
 #include <sstream>
 #include <stack>
 #include <string_view>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #pragma warning( push )
@@ -2,11 +2,54 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "CompositeSource.h"
+#include <winget/AllocationTracking.h>
+#include <winget/NameNormalization.h>
+#include <winget/ThreadGlobals.h>
+#include <winget/Timing.h>
+
+#include <future>
 
 namespace AppInstaller::Repository
 {
     using namespace std::string_view_literals;
 
+    // The available sources of a composite whose searches have timed out. Those searches were cancelled, so the state
+    // that they left the sources in is not known; the sources are not searched again by the composite.
+    struct CompositeTimedOutSources
+    {
+        void Add(const Source& source)
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+            m_identifiers.emplace(source.GetIdentifier());
+        }
+
+        // Gets the sources that have not timed out, adding a timeout failure for each of the others.
+        std::vector<Source> Exclude(const std::vector<Source>& sources, std::vector<SearchResult::Failure>& failures) const
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+
+            std::vector<Source> result;
+            for (const auto& source : sources)
+            {
+                if (m_identifiers.count(source.GetIdentifier()))
+                {
+                    AICLI_LOG(Repo, Info, << "Not searching source that timed out before: " << source.GetDetails().Name);
+                    failures.emplace_back(SearchResult::Failure{ source.GetDetails().Name, std::make_exception_ptr(wil::ResultException(APPINSTALLER_CLI_ERROR_SOURCE_SEARCH_TIMEOUT)) });
+                }
+                else
+                {
+                    result.emplace_back(source);
+                }
+            }
+
+            return result;
+        }
+
+    private:
+        mutable std::mutex m_lock;
+        std::set<std::string> m_identifiers;
+    };
+
     namespace
     {
         Utility::VersionAndChannel GetVACFromVersion(IPackageVersion* packageVersion)
@@ -237,6 +280,30 @@ namespace AppInstaller::Repository
                 return {};
             }
 
+            std::vector<PackageVersionKey> GetLatestAvailableVersionKeys(size_t count) const override
+            {
+                if (m_availablePackage)
+                {
+                    std::vector<PackageVersionKey> result = m_availablePackage->GetLatestAvailableVersionKeys(count);
+                    bool mayHaveMore = (result.size() == count);
+                    std::string_view channel = m_installedChannel;
+
+                    result.erase(
+                        std::remove_if(result.begin(), result.end(), [&](const PackageVersionKey& pvk) { return !Utility::ICUCaseInsensitiveEquals(pvk.Channel, channel); }),
+                        result.end());
+
+                    // Versions of other channels were removed, so the rest may be further down the list
+                    if (result.size() < count && mayHaveMore)
+                    {
+                        return IPackage::GetLatestAvailableVersionKeys(count);
+                    }
+
+                    return result;
+                }
+
+                return {};
+            }
+
             std::shared_ptr<IPackageVersion> GetLatestAvailableVersion() const override
             {
                 return GetAvailableVersion({ "", "", m_installedChannel.get() });
@@ -385,6 +452,31 @@ namespace AppInstaller::Repository
                     return Field == other.Field && String1 == other.String1 && String2 == other.String2;
                 }
 
+                PackageMatchField GetField() const { return Field; }
+
+                // Creates a value suitable for correlating in memory rather than through a source search.
+                // The strong match fields are folded and the name and publisher are normalized the same way that the index does on search.
+                SystemReferenceString CreateCorrelationKey(const Utility::NameNormalizer& normalizer) const
+                {
+                    switch (Field)
+                    {
+                    case PackageMatchField::NormalizedNameAndPublisher:
+                    {
+                        Utility::NormalizedName normalized = normalizer.Normalize(Utility::FoldCase(String1), Utility::FoldCase(String2));
+                        return { Field, Utility::LocIndString{ normalized.Name() }, Utility::LocIndString{ normalized.Publisher() } };
+                    }
+
+                    default:
+                        return { Field, Utility::LocIndString{ Utility::FoldCase(String1) } };
+                    }
+                }
+
+                // Creates a value suitable for correlating in memory, where the value is known to be normalized already.
+                SystemReferenceString CreateFoldedCorrelationKey() const
+                {
+                    return { Field, Utility::LocIndString{ Utility::FoldCase(String1) }, Utility::LocIndString{ Utility::FoldCase(String2) } };
+                }
+
                 void AddToFilters(std::vector<PackageMatchFilter>& filters) const
                 {
                     switch (Field)
@@ -436,31 +528,32 @@ namespace AppInstaller::Repository
                 return result;
             }
 
+            // For a given package, prepares the results for all of its available versions.
+            PackageData GetAvailableSystemReferenceStrings(const IPackage* package)
+            {
+                PackageData result;
+                AddAvailableSystemReferenceStrings(package, result);
+                return result;
+            }
+
             // Check for a package already in the result that should have been correlated already.
             // If we find one, see if we should upgrade it's match criteria.
             // If we don't, return package data for further use.
             std::optional<PackageData> CheckForExistingResultFromAvailablePackageMatch(const ResultMatch& availableMatch)
             {
-                for (auto& match : Matches)
+                CompositeResultMatch* match = FindMatch(m_availableIndex, &CompositePackage::GetAvailablePackage, availableMatch.Package.get());
+                if (match)
                 {
-                    const std::shared_ptr<IPackage>& availablePackage = match.Package->GetAvailablePackage();
-                    if (availablePackage && availablePackage->IsSame(availableMatch.Package.get()))
+                    if (ResultMatchComparator{}(availableMatch, *match))
                     {
-                        if (ResultMatchComparator{}(availableMatch, match))
-                        {
-                            match.MatchCriteria = availableMatch.MatchCriteria;
-                        }
-
-                        return {};
+                        match->MatchCriteria = availableMatch.MatchCriteria;
                     }
+
+                    return {};
                 }
 
                 PackageData result;
-                for (auto const& versionKey : availableMatch.Package->GetAvailableVersionKeys())
-                {
-                    auto packageVersion = availableMatch.Package->GetAvailableVersion(versionKey);
-                    AddSystemReferenceStrings(packageVersion.get(), result);
-                }
+                AddAvailableSystemReferenceStrings(availableMatch.Package.get(), result);
                 return result;
             }
 
@@ -469,42 +562,37 @@ namespace AppInstaller::Repository
             // If we don't, return package data for further use.
             std::optional<PackageData> CheckForExistingResultFromTrackingPackageMatch(const ResultMatch& trackingMatch)
             {
-                for (auto& match : Matches)
+                CompositeResultMatch* match = FindMatch(m_trackingIndex, &CompositePackage::GetTrackingPackage, trackingMatch.Package.get());
+                if (match)
                 {
-                    const std::shared_ptr<IPackage>& trackingPackage = match.Package->GetTrackingPackage();
-                    if (trackingPackage && trackingPackage->IsSame(trackingMatch.Package.get()))
+                    if (ResultMatchComparator{}(trackingMatch, *match))
                     {
-                        if (ResultMatchComparator{}(trackingMatch, match))
-                        {
-                            match.MatchCriteria = trackingMatch.MatchCriteria;
-                        }
-
-                        return {};
+                        match->MatchCriteria = trackingMatch.MatchCriteria;
                     }
+
+                    return {};
                 }
 
                 PackageData result;
-                for (auto const& versionKey : trackingMatch.Package->GetAvailableVersionKeys())
-                {
-                    auto packageVersion = trackingMatch.Package->GetAvailableVersion(versionKey);
-                    AddSystemReferenceStrings(packageVersion.get(), result);
-                }
+                AddAvailableSystemReferenceStrings(trackingMatch.Package.get(), result);
                 return result;
             }
 
             // Determines if the results contain the given installed package.
             bool ContainsInstalledPackage(const IPackage* installedPackage)
             {
-                for (auto& match : Matches)
-                {
-                    const std::shared_ptr<IPackage>& matchPackage = match.Package->GetInstalledPackage();
-                    if (matchPackage && matchPackage->IsSame(installedPackage))
-                    {
-                        return true;
-                    }
-                }
+                return FindMatch(m_installedIndex, &CompositePackage::GetInstalledPackage, installedPackage) != nullptr;
+            }
 
-                return false;
+            // Adds a match to the result; its packages must be set beforehand as they are indexed here.
+            void AddMatch(std::shared_ptr<CompositePackage> package, PackageMatchFilter matchCriteria)
+            {
+                size_t position = Matches.size();
+                AddToIndex(m_installedIndex, package->GetInstalledPackage(), position);
+                AddToIndex(m_availableIndex, package->GetAvailablePackage(), position);
+                AddToIndex(m_trackingIndex, package->GetTrackingPackage(), position);
+
+                Matches.emplace_back(std::move(package), std::move(matchCriteria));
             }
 
             // Destructively converts the result to the standard variant.
@@ -527,12 +615,7 @@ namespace AppInstaller::Repository
 
             bool AddFailureIfSourceNotPresent(SearchResult::Failure&& failure)
             {
-                auto itr = std::find_if(Failures.begin(), Failures.end(),
-                    [&failure](const SearchResult::Failure& present) {
-                        return present.SourceName == failure.SourceName;
-                    });
-
-                if (itr == Failures.end())
+                if (m_failedSources.insert(failure.SourceName).second)
                 {
                     Failures.emplace_back(std::move(failure));
                     return true;
@@ -544,6 +627,7 @@ namespace AppInstaller::Repository
             SearchResult SearchAndHandleFailures(const Source& source, const SearchRequest& request)
             {
                 SearchResult result;
+                std::exception_ptr exception;
 
                 try
                 {
@@ -551,9 +635,27 @@ namespace AppInstaller::Repository
                 }
                 catch (...)
                 {
-                    if (AddFailureIfSourceNotPresent({ source.GetDetails().Name, std::current_exception() }))
+                    exception = std::current_exception();
+                }
+
+                return HandleFailures(source, std::move(result), exception);
+            }
+
+            // Records the failures from a search that has already been performed, as SearchAndHandleFailures does.
+            SearchResult HandleFailures(const Source& source, SearchResult result, std::exception_ptr exception)
+            {
+                if (exception)
+                {
+                    if (AddFailureIfSourceNotPresent({ source.GetDetails().Name, exception }))
                     {
-                        LOG_CAUGHT_EXCEPTION();
+                        try
+                        {
+                            std::rethrow_exception(exception);
+                        }
+                        catch (...)
+                        {
+                            LOG_CAUGHT_EXCEPTION();
+                        }
                         AICLI_LOG(Repo, Warning, << "Failed to search source for correlation: " << source.GetDetails().Name);
                     }
                 }
@@ -572,6 +674,46 @@ namespace AppInstaller::Repository
             std::vector<SearchResult::Failure> Failures;
 
         private:
+            // Maps a folded package identifier to the positions in Matches of the packages with that identifier.
+            // Packages from different sources can share an identifier, so IsSame still decides between them.
+            using PackageIndex = std::unordered_map<std::string, std::vector<size_t>>;
+            using PackageGetter = const std::shared_ptr<IPackage>& (CompositePackage::*)();
+
+            static std::string GetIndexKey(const IPackage* package)
+            {
+                return Utility::FoldCase(package->GetProperty(PackageProperty::Id).get());
+            }
+
+            static void AddToIndex(PackageIndex& index, const std::shared_ptr<IPackage>& package, size_t position)
+            {
+                if (package)
+                {
+                    index[GetIndexKey(package.get())].emplace_back(position);
+                }
+            }
+
+            // Finds the match whose package, as returned by the getter, is the same as the given package.
+            CompositeResultMatch* FindMatch(const PackageIndex& index, PackageGetter getter, const IPackage* package)
+            {
+                auto itr = index.find(GetIndexKey(package));
+                if (itr == index.end())
+                {
+                    return nullptr;
+                }
+
+                for (size_t position : itr->second)
+                {
+                    CompositeResultMatch& match = Matches[position];
+                    const std::shared_ptr<IPackage>& matchPackage = ((*match.Package).*getter)();
+                    if (matchPackage && matchPackage->IsSame(package))
+                    {
+                        return &match;
+                    }
+                }
+
+                return nullptr;
+            }
+
             void AddSystemReferenceStrings(IPackageVersion* version, PackageData& data)
             {
                 GetSystemReferenceStrings(
@@ -591,6 +733,41 @@ namespace AppInstaller::Repository
                     data);
             }
 
+            // Adds the system reference strings of every available version, retrieving the values in bulk
+            // rather than creating each version.
+            void AddAvailableSystemReferenceStrings(const IPackage* package, PackageData& data)
+            {
+                auto versionsProperties = package->GetAvailableVersionsMultiProperties({
+                    PackageVersionMultiProperty::PackageFamilyName,
+                    PackageVersionMultiProperty::ProductCode,
+                    PackageVersionMultiProperty::Name,
+                    PackageVersionMultiProperty::Publisher });
+
+                for (auto& versionProperties : versionsProperties)
+                {
+                    for (auto&& string : versionProperties[PackageVersionMultiProperty::PackageFamilyName])
+                    {
+                        data.AddIfNotPresent(SystemReferenceString{ PackageMatchField::PackageFamilyName, std::move(string) });
+                    }
+
+                    for (auto&& string : versionProperties[PackageVersionMultiProperty::ProductCode])
+                    {
+                        data.AddIfNotPresent(SystemReferenceString{ PackageMatchField::ProductCode, std::move(string) });
+                    }
+
+                    auto& names = versionProperties[PackageVersionMultiProperty::Name];
+                    auto& publishers = versionProperties[PackageVersionMultiProperty::Publisher];
+
+                    for (size_t i = 0; i < names.size() && i < publishers.size(); ++i)
+                    {
+                        data.AddIfNotPresent(SystemReferenceString{
+                            PackageMatchField::NormalizedNameAndPublisher,
+                            std::move(names[i]),
+                            std::move(publishers[i]) });
+                    }
+                }
+            }
+
             void GetSystemReferenceStrings(
                 IPackageVersion* installedVersion,
                 PackageVersionMultiProperty prop,
@@ -618,6 +795,11 @@ namespace AppInstaller::Repository
                         std::move(publishers[i]) });
                 }
             }
+
+            PackageIndex m_installedIndex;
+            PackageIndex m_availableIndex;
+            PackageIndex m_trackingIndex;
+            std::unordered_set<std::string> m_failedSources;
         };
 
         std::shared_ptr<IPackage> GetTrackedPackageFromAvailableSource(CompositeResult& result, const Source& source, const Utility::LocIndString& identifier)
@@ -642,9 +824,546 @@ namespace AppInstaller::Repository
 
             return {};
         }
+
+        // Searches a single source as part of a composite search, logging how long it took.
+        SearchResult SearchSourceAndLog(const Source& source, const SearchRequest& request)
+        {
+            auto startTime = std::chrono::steady_clock::now();
+            SearchResult result = source.Search(request);
+
+            Logging::Telemetry().LogSourceSearch(source.GetDetails().Identifier,
+                std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime), result.Matches.size());
+
+            return result;
+        }
+
+        // The outcome of searching a single source as part of a concurrent search.
+        struct SourceSearchOutcome
+        {
+            SearchResult Result;
+            std::exception_ptr Exception;
+        };
+
+        // Searches all of the given sources concurrently, returning the outcomes in the same order as the sources so that
+        // merging them is deterministic. A source that has not completed within the timeout is given a timeout error, and
+        // its search is cancelled and recorded so that the source is not searched again; a timeout of zero waits for all of them.
+        // A search that times out is not waited for, as not every source can stop early (a REST request runs to its own timeout);
+        // it is left to finish on a detached thread that owns everything it uses.
+        std::vector<SourceSearchOutcome> SearchSourcesConcurrently(const std::vector<Source>& sources, const SearchRequest& request, std::chrono::seconds timeout, CompositeTimedOutSources& timedOutSources)
+        {
+            using namespace AppInstaller::ThreadLocalStorage;
+
+            std::vector<SourceSearchOutcome> outcomes(sources.size());
+
+            // A single source has nothing to gain from another thread
+            if (sources.size() == 1)
+            {
+                try
+                {
+                    outcomes[0].Result = SearchSourceAndLog(sources[0], request);
+                }
+                catch (...)
+                {
+                    outcomes[0].Exception = std::current_exception();
+                }
+
+                return outcomes;
+            }
+
+            // The state of one search, shared with its thread so that the thread can outlive this call.
+            struct SourceSearch
+            {
+                SourceSearch(const Source& source, const SearchRequest& request) : SearchedSource(source), Request(request) {}
+
+                Source SearchedSource;
+                SearchRequest Request;
+                std::promise<SearchResult> Promise;
+                // Checked by the long running parts of a search, such as queries, to stop it early.
+                std::atomic<bool> Cancelled = false;
+            };
+
+            std::vector<std::shared_ptr<SourceSearch>> searches;
+            std::vector<std::future<SearchResult>> futures;
+            std::vector<std::thread> threads;
+            searches.reserve(sources.size());
+            futures.reserve(sources.size());
+            threads.reserve(sources.size());
+
+            // Searches that have not completed are cancelled and left to finish on their own.
+            auto cancelAndRelease = wil::scope_exit([&]()
+                {
+                    for (size_t i = 0; i < threads.size(); ++i)
+                    {
+                        searches[i]->Cancelled = true;
+
+                        if (!futures[i].valid() || futures[i].wait_for(std::chrono::seconds::zero()) == std::future_status::ready)
+                        {
+                            threads[i].join();
+                        }
+                        else
+                        {
+                            threads[i].detach();
+                        }
+                    }
+                });
+
+            ThreadGlobals* parentThreadGlobals = ThreadGlobals::GetForCurrentThread();
+
+            for (size_t i = 0; i < sources.size(); ++i)
+            {
+                std::shared_ptr<ThreadGlobals> threadGlobals;
+                if (parentThreadGlobals)
+                {
+                    threadGlobals = std::make_shared<ThreadGlobals>(*parentThreadGlobals, ThreadGlobals::create_sub_thread_globals_t{});
+                }
+
+                auto search = searches.emplace_back(std::make_shared<SourceSearch>(sources[i], request));
+                futures.emplace_back(search->Promise.get_future());
+
+                threads.emplace_back([search, threadGlobals]()
+                    {
+                        std::unique_ptr<PreviousThreadGlobals> previousThreadGlobals;
+                        if (threadGlobals)
+                        {
+                            previousThreadGlobals = threadGlobals->SetForCurrentThread();
+                        }
+
+                        CancellationCheckScope cancellationScope{ [&]() { return search->Cancelled.load(); } };
+
+                        try
+                        {
+                            search->Promise.set_value(SearchSourceAndLog(search->SearchedSource, search->Request));
+                        }
+                        catch (...)
+                        {
+                            search->Promise.set_exception(std::current_exception());
+                        }
+                    });
+            }
+
+            auto deadline = std::chrono::steady_clock::now() + timeout;
+
+            for (size_t i = 0; i < futures.size(); ++i)
+            {
+                if (timeout.count() != 0 && futures[i].wait_until(deadline) != std::future_status::ready)
+                {
+                    AICLI_LOG(Repo, Warning, << "Search did not complete within " << timeout.count() << " seconds for source: " << sources[i].GetDetails().Name);
+                    searches[i]->Cancelled = true;
+                    timedOutSources.Add(sources[i]);
+                    outcomes[i].Exception = std::make_exception_ptr(wil::ResultException(APPINSTALLER_CLI_ERROR_SOURCE_SEARCH_TIMEOUT));
+                    continue;
+                }
+
+                try
+                {
+                    outcomes[i].Result = futures[i].get();
+                }
+                catch (...)
+                {
+                    outcomes[i].Exception = std::current_exception();
+                }
+            }
+
+            return outcomes;
+        }
+
+        // Determines whether the result is a single package that matched exactly on its id.
+        bool IsUniqueIdMatch(const SearchResult& result)
+        {
+            return result.Matches.size() == 1 &&
+                result.Matches[0].MatchCriteria.Field == PackageMatchField::Id &&
+                result.Matches[0].MatchCriteria.Type == MatchType::Exact;
+        }
+
+        // Searches the given sources one at a time in order, stopping after the first with a unique id match.
+        // Returns the outcomes of the sources that were searched, in the same order as the sources.
+        std::vector<SourceSearchOutcome> SearchSourcesUntilUniqueIdMatch(const std::vector<Source>& sources, const SearchRequest& request)
+        {
+            std::vector<SourceSearchOutcome> outcomes;
+
+            for (const auto& source : sources)
+            {
+                SourceSearchOutcome& outcome = outcomes.emplace_back();
+
+                try
+                {
+                    outcome.Result = SearchSourceAndLog(source, request);
+                }
+                catch (...)
+                {
+                    outcome.Exception = std::current_exception();
+                }
+
+                if (!outcome.Exception && IsUniqueIdMatch(outcome.Result))
+                {
+                    AICLI_LOG(Repo, Info, << "Found a unique id match in source [" << source.GetDetails().Name << "], the remaining sources are not searched");
+                    break;
+                }
+            }
+
+            return outcomes;
+        }
+
+        // Searches the available sources as the request asks, returning the outcomes in the same order as the sources.
+        // Fewer outcomes than sources are returned when the search stopped early.
+        std::vector<SourceSearchOutcome> SearchAvailableSources(const std::vector<Source>& sources, const SearchRequest& request, std::chrono::seconds timeout, CompositeTimedOutSources& timedOutSources)
+        {
+            if (request.StopAtUniqueIdMatch)
+            {
+                return SearchSourcesUntilUniqueIdMatch(sources, request);
+            }
+
+            return SearchSourcesConcurrently(sources, request, timeout, timedOutSources);
+        }
+
+        // Gets the timeout to use when searching sources concurrently.
+        std::chrono::seconds GetConcurrentSearchTimeout()
+        {
+            return Settings::User().Get<Settings::Setting::NetworkSearchTimeoutInSeconds>();
+        }
+
+        // The maximum number of values to include in a single batched correlation search.
+        // Keeps an individual request to a reasonable size for sources that send them over the network.
+        constexpr size_t s_BatchedCorrelationMaximumInclusions = 100;
+
+        // An installed package being correlated through batched searches.
+        struct BatchedCorrelationItem
+        {
+            BatchedCorrelationItem(std::shared_ptr<CompositePackage> package, PackageMatchFilter matchCriteria) :
+                Package(std::move(package)), MatchCriteria(std::move(matchCriteria)) {}
+
+            std::shared_ptr<CompositePackage> Package;
+            PackageMatchFilter MatchCriteria;
+
+            std::shared_ptr<IPackageVersion> InstalledVersion;
+            CompositeResult::PackageData Data;
+            std::set<CompositeResult::SystemReferenceString> CorrelationKeys;
+
+            std::optional<size_t> TrackedSourceIndex;
+            std::shared_ptr<IPackage> TrackingPackage;
+            std::chrono::system_clock::time_point TrackingPackageTime;
+            std::shared_ptr<IPackage> AvailablePackage;
+        };
+
+        // The result of a batched search, indexed to allow joining it back to the items that requested it.
+        struct BatchedCorrelationResult
+        {
+            BatchedCorrelationResult(CompositeResult& result, const Utility::NameNormalizer& normalizer, std::vector<ResultMatch>&& matches) :
+                m_matches(std::move(matches))
+            {
+                for (size_t i = 0; i < m_matches.size(); ++i)
+                {
+                    for (const auto& srs : result.GetAvailableSystemReferenceStrings(m_matches[i].Package.get()).SystemReferenceStrings)
+                    {
+                        // Index based sources return the name and publisher already normalized, while others return the original values.
+                        // Keep both forms so that the join does not depend on which one the source provides.
+                        m_index[srs.CreateFoldedCorrelationKey()].insert(i);
+                        m_index[srs.CreateCorrelationKey(normalizer)].insert(i);
+                    }
+                }
+            }
+
+            // Gets the matches that a search for only the given item would have found.
+            std::vector<ResultMatch> GetMatches(const BatchedCorrelationItem& item) const
+            {
+                // The keys are ordered by field, so the first key found for a package is its highest order match.
+                std::map<size_t, const CompositeResult::SystemReferenceString*> found;
+                for (const auto& key : item.CorrelationKeys)
+                {
+                    auto itr = m_index.find(key);
+                    if (itr != m_index.end())
+                    {
+                        for (size_t i : itr->second)
+                        {
+                            found.emplace(i, &key);
+                        }
+                    }
+                }
+
+                std::vector<ResultMatch> result;
+                for (const auto& [i, key] : found)
+                {
+                    std::vector<PackageMatchFilter> filters;
+                    key->AddToFilters(filters);
+                    result.emplace_back(m_matches[i].Package, std::move(filters[0]));
+                }
+
+                SortResultMatches(result);
+                return result;
+            }
+
+            bool empty() const { return m_matches.empty(); }
+
+        private:
+            std::vector<ResultMatch> m_matches;
+            std::map<CompositeResult::SystemReferenceString, std::set<size_t>> m_index;
+        };
+
+        // Searches the source for the system reference strings of all of the given items, splitting into multiple requests as needed.
+        template <typename SearchFunction>
+        std::vector<ResultMatch> SearchBatched(const std::string& sourceIdentifier, const std::vector<BatchedCorrelationItem*>& items, SearchFunction&& search)
+        {
+            std::set<CompositeResult::SystemReferenceString> allStrings;
+            for (const auto* item : items)
+            {
+                allStrings.insert(item->Data.SystemReferenceStrings.begin(), item->Data.SystemReferenceStrings.end());
+            }
+
+            std::vector<ResultMatch> result;
+            SearchRequest batchRequest;
+            size_t batchCount = 0;
+
+            // Maps the source and folded identifier of the packages found to their positions in the result.
+            // Only packages that share both can be the same, so IsSame is only needed between them.
+            std::unordered_map<std::string, std::vector<size_t>> found;
+
+            auto runBatch = [&]()
+            {
+                SearchResult batchResult = search(batchRequest);
+
+                for (auto&& match : batchResult.Matches)
+                {
+                    std::string key = sourceIdentifier;
+                    key += '\0';
+                    key += Utility::FoldCase(match.Package->GetProperty(PackageProperty::Id).get());
+
+                    // Separate batches can find the same package
+                    std::vector<size_t>& positions = found[key];
+                    if (batchCount == 0 ||
+                        std::none_of(positions.begin(), positions.end(), [&](size_t position) { return result[position].Package->IsSame(match.Package.get()); }))
+                    {
+                        positions.emplace_back(result.size());
+                        result.emplace_back(std::move(match));
+                    }
+                }
+
+                batchRequest.Inclusions.clear();
+                ++batchCount;
+            };
+
+            for (const auto& srs : allStrings)
+            {
+                srs.AddToFilters(batchRequest.Inclusions);
+
+                if (batchRequest.Inclusions.size() >= s_BatchedCorrelationMaximumInclusions)
+                {
+                    runBatch();
+                }
+            }
+
+            if (!batchRequest.Inclusions.empty())
+            {
+                runBatch();
+            }
+
+            AICLI_LOG(Repo, Verbose, << "Batched correlation search found " << result.size() << " packages in " << batchCount << " requests");
+
+            return result;
+        }
+
+        // Gets the available packages for all of the given tracked items from their source, through batched searches on the tracked identifiers.
+        void GetTrackedPackagesFromAvailableSource(CompositeResult& result, const Source& source, const std::vector<BatchedCorrelationItem*>& items)
+        {
+            std::map<std::string, std::vector<std::shared_ptr<IPackage>>> packagesById;
+            std::set<std::string> requestedIds;
+            SearchRequest directRequest;
+
+            auto runBatch = [&]()
+            {
+                SearchResult directResult = result.SearchAndHandleFailures(source, directRequest);
+
+                for (auto&& match : directResult.Matches)
+                {
+                    packagesById[Utility::FoldCase(match.Package->GetProperty(PackageProperty::Id))].emplace_back(std::move(match.Package));
+                }
+
+                directRequest.Inclusions.clear();
+            };
+
+            for (const auto* item : items)
+            {
+                Utility::LocIndString identifier = item->TrackingPackage->GetProperty(PackageProperty::Id);
+
+                if (requestedIds.emplace(Utility::FoldCase(identifier)).second)
+                {
+                    directRequest.Inclusions.emplace_back(PackageMatchField::Id, MatchType::CaseInsensitive, identifier.get());
+
+                    if (directRequest.Inclusions.size() >= s_BatchedCorrelationMaximumInclusions)
+                    {
+                        runBatch();
+                    }
+                }
+            }
+
+            if (!directRequest.Inclusions.empty())
+            {
+                runBatch();
+            }
+
+            for (auto* item : items)
+            {
+                Utility::LocIndString identifier = item->TrackingPackage->GetProperty(PackageProperty::Id);
+                auto itr = packagesById.find(Utility::FoldCase(identifier));
+
+                if (itr == packagesById.end())
+                {
+                    AICLI_LOG(Repo, Warning, << "Did not find Id [" << identifier << "] in tracked source: " << source.GetDetails().Name);
+                }
+                else if (itr->second.size() == 1)
+                {
+                    item->AvailablePackage = itr->second[0];
+                }
+                else
+                {
+                    AICLI_LOG(Repo, Warning, << "Found multiple results for Id [" << identifier << "] in tracked source: " << source.GetDetails().Name);
+                }
+            }
+        }
+
+        // Correlates all of the installed packages with the available sources through a small number of batched searches per source,
+        // rather than searching every source for each installed package. The search results are joined back to the installed packages
+        // in memory, following the same rules as the individual correlation in CompositeSource::SearchInstalled.
+        void CorrelateInstalledPackagesBatched(CompositeResult& result, std::vector<BatchedCorrelationItem>& items, const std::vector<Source>& availableSources)
+        {
+            Utility::NameNormalizer normalizer{ Utility::NormalizationVersion::Initial };
+
+            std::vector<BatchedCorrelationItem*> toCorrelate;
+            for (auto& item : items)
+            {
+                item.InstalledVersion = item.Package->GetInstalledVersion();
+                item.Data = result.GetSystemReferenceStrings(item.InstalledVersion.get());
+
+                if (!item.Data.SystemReferenceStrings.empty())
+                {
+                    for (const auto& srs : item.Data.SystemReferenceStrings)
+                    {
+                        item.CorrelationKeys.emplace(srs.CreateCorrelationKey(normalizer));
+                    }
+
+                    toCorrelate.emplace_back(&item);
+                }
+            }
+
+            if (toCorrelate.empty())
+            {
+                return;
+            }
+
+            // Check the tracking catalogs first to see if there is a correlation there.
+            for (size_t sourceIndex = 0; sourceIndex < availableSources.size(); ++sourceIndex)
+            {
+                const Source& source = availableSources[sourceIndex];
+                auto trackingCatalog = source.GetTrackingCatalog();
+
+                BatchedCorrelationResult trackingResult{ result, normalizer,
+                    SearchBatched(source.GetIdentifier(), toCorrelate, [&](const SearchRequest& batchRequest) { return trackingCatalog.Search(batchRequest); }) };
+
+                if (trackingResult.empty())
+                {
+                    continue;
+                }
+
+                for (auto* item : toCorrelate)
+                {
+                    std::vector<ResultMatch> matches = trackingResult.GetMatches(*item);
+
+                    std::shared_ptr<IPackage> candidatePackage = GetMatchingPackage(matches,
+                        [&]() {
+                            AICLI_LOG(Repo, Info,
+                                << "Found multiple matches for installed package [" << item->InstalledVersion->GetProperty(PackageVersionProperty::Id) <<
+                                "] in tracking catalog for source [" << source.GetIdentifier() << "] when searching for [" << item->Data.CreateInclusionsSearchRequest().ToString() << "]");
+                        }, [&] {
+                            AICLI_LOG(Repo, Warning, << "  Appropriate tracking package could not be determined");
+                        });
+
+                    // Determine the candidate package with the latest install time
+                    if (candidatePackage)
+                    {
+                        std::chrono::system_clock::time_point candidateTime = GetLatestTrackingPackageWriteTime(candidatePackage);
+
+                        if (!item->TrackingPackage || candidateTime > item->TrackingPackageTime)
+                        {
+                            item->TrackedSourceIndex = sourceIndex;
+                            item->TrackingPackage = std::move(candidatePackage);
+                            item->TrackingPackageTime = candidateTime;
+                        }
+                    }
+                }
+            }
+
+            // Directly search for the available packages from tracking information.
+            for (size_t sourceIndex = 0; sourceIndex < availableSources.size(); ++sourceIndex)
+            {
+                std::vector<BatchedCorrelationItem*> trackedItems;
+                std::copy_if(toCorrelate.begin(), toCorrelate.end(), std::back_inserter(trackedItems),
+                    [&](const BatchedCorrelationItem* item) { return item->TrackedSourceIndex == sourceIndex; });
+
+                if (!trackedItems.empty())
+                {
+                    GetTrackedPackagesFromAvailableSource(result, availableSources[sourceIndex], trackedItems);
+                }
+            }
+
+            // Search sources for the remaining items; the first source with any matches for an item is the only one used for it.
+            std::vector<BatchedCorrelationItem*> remaining;
+            std::copy_if(toCorrelate.begin(), toCorrelate.end(), std::back_inserter(remaining),
+                [](const BatchedCorrelationItem* item) { return !item->AvailablePackage; });
+
+            for (const auto& source : availableSources)
+            {
+                if (remaining.empty())
+                {
+                    break;
+                }
+
+                // Do not attempt to correlate local packages against this source
+                if (!source.GetDetails().SupportInstalledSearchCorrelation)
+                {
+                    continue;
+                }
+
+                BatchedCorrelationResult availableResult{ result, normalizer,
+                    SearchBatched(source.GetIdentifier(), remaining, [&](const SearchRequest& batchRequest) { return result.SearchAndHandleFailures(source, batchRequest); }) };
+
+                std::vector<BatchedCorrelationItem*> stillRemaining;
+
+                for (auto* item : remaining)
+                {
+                    std::vector<ResultMatch> matches = availableResult.GetMatches(*item);
+
+                    if (matches.empty())
+                    {
+                        stillRemaining.emplace_back(item);
+                        continue;
+                    }
+
+                    item->AvailablePackage = GetMatchingPackage(matches,
+                        [&]() {
+                            AICLI_LOG(Repo, Info,
+                                << "Found multiple matches for installed package [" << item->InstalledVersion->GetProperty(PackageVersionProperty::Id) <<
+                                "] in source [" << source.GetIdentifier() << "] when searching for [" << item->Data.CreateInclusionsSearchRequest().ToString() << "]");
+                        }, [&] {
+                            AICLI_LOG(Repo, Warning, << "  Appropriate available package could not be determined");
+                        });
+                }
+
+                remaining = std::move(stillRemaining);
+            }
+
+            for (auto* item : toCorrelate)
+            {
+                item->Package->SetAvailablePackage(std::move(item->AvailablePackage));
+
+                if (item->TrackedSourceIndex)
+                {
+                    item->Package->SetTracking(availableSources[item->TrackedSourceIndex.value()], std::move(item->TrackingPackage));
+                }
+            }
+        }
     }
 
-    CompositeSource::CompositeSource(std::string identifier)
+    CompositeSource::CompositeSource(std::string identifier) :
+        m_timedOutSources(std::make_shared<CompositeTimedOutSources>())
     {
         m_details.Identifier = std::move(identifier);
     }
@@ -668,6 +1387,8 @@ namespace AppInstaller::Repository
     // will only return results where a match is found in the installed source.
     SearchResult CompositeSource::Search(const SearchRequest& request) const
     {
+        Memory::AllocationScope allocationScope{ Memory::AllocationSubsystem::CompositeSearch };
+
         if (m_installedSource)
         {
             return SearchInstalled(request);
@@ -696,6 +1417,8 @@ namespace AppInstaller::Repository
     //
     // Search flow:
     //  Installed :: Search incoming request
+    //  If the request is for everything, the per result searches below are done once per source with
+    //  all of the results' system references and joined back to the results in memory.
     //  For each result
     //      For each available source
     //          Tracking :: Search system references
@@ -715,8 +1438,16 @@ namespace AppInstaller::Repository
     //          Installed :: Search system references
     SearchResult CompositeSource::SearchInstalled(const SearchRequest& request) const
     {
+        Timing::Span span{ Timing::Phase::CompositeCorrelation };
         CompositeResult result;
 
+        std::vector<SearchResult::Failure> timedOutFailures;
+        std::vector<Source> availableSources = m_timedOutSources->Exclude(m_availableSources, timedOutFailures);
+        for (auto& failure : timedOutFailures)
+        {
+            result.AddFailureIfSourceNotPresent(std::move(failure));
+        }
+
         // If the search behavior is for AllPackages or Installed then the result can contain packages that are
         // only in the Installed source, but do not have an AvailableVersion.
         if (m_searchBehavior == CompositeSearchBehavior::AllPackages || m_searchBehavior == CompositeSearchBehavior::Installed)
@@ -725,6 +1456,27 @@ namespace AppInstaller::Repository
             SearchResult installedResult = m_installedSource.Search(request);
             result.Truncated = installedResult.Truncated;
 
+            // When every installed package is requested, correlate them all at once rather than searching each one individually.
+            if (request.IsForEverything() && installedResult.Matches.size() > 1)
+            {
+                std::vector<BatchedCorrelationItem> items;
+                items.reserve(installedResult.Matches.size());
+
+                for (auto&& match : installedResult.Matches)
+                {
+                    items.emplace_back(std::make_shared<CompositePackage>(std::move(match.Package)), std::move(match.MatchCriteria));
+                }
+
+                CorrelateInstalledPackagesBatched(result, items, availableSources);
+
+                for (auto& item : items)
+                {
+                    result.AddMatch(std::move(item.Package), std::move(item.MatchCriteria));
+                }
+
+                installedResult.Matches.clear();
+            }
+
             for (auto&& match : installedResult.Matches)
             {
                 auto compositePackage = std::make_shared<CompositePackage>(std::move(match.Package));
@@ -745,7 +1497,7 @@ namespace AppInstaller::Repository
                     // Check the tracking catalog first to see if there is a correlation there.
                     // TODO: When the issue with support for multiple available packages is fixed, this should move into
                     //       the below available sources loop as we will check all sources at that point.
-                    for (const auto& source : m_availableSources)
+                    for (const auto& source : availableSources)
                     {
                         auto trackingCatalog = source.GetTrackingCatalog();
                         SearchResult trackingResult = trackingCatalog.Search(systemReferenceSearch);
@@ -782,7 +1534,7 @@ namespace AppInstaller::Repository
                     if (!availablePackage)
                     {
                         // Search sources and add to result
-                        for (const auto& source : m_availableSources)
+                        for (const auto& source : availableSources)
                         {
                             // Do not attempt to correlate local packages against this source
                             if (!source.GetDetails().SupportInstalledSearchCorrelation)
@@ -816,7 +1568,7 @@ namespace AppInstaller::Repository
                 }
 
                 // Move the installed result into the composite result
-                result.Matches.emplace_back(std::move(compositePackage), std::move(match.MatchCriteria));
+                result.AddMatch(std::move(compositePackage), std::move(match.MatchCriteria));
             }
 
             // Optimization for the "everything installed" case, no need to allow for reverse correlations
@@ -826,9 +1578,28 @@ namespace AppInstaller::Repository
             }
         }
 
+        // Do not attempt to correlate local packages against sources that don't support it.
+        auto shouldSearchAvailable = [&](const Source& source)
+        {
+            return m_searchBehavior != CompositeSearchBehavior::Installed || source.GetDetails().SupportInstalledSearchCorrelation;
+        };
+
+        // Send the incoming request to all of the available sources at once; the results are still processed in source order below.
+        std::vector<Source> sourcesToSearch;
+        std::copy_if(availableSources.begin(), availableSources.end(), std::back_inserter(sourcesToSearch), shouldSearchAvailable);
+
+        std::vector<SourceSearchOutcome> availableOutcomes = SearchAvailableSources(sourcesToSearch, request, GetConcurrentSearchTimeout(), *m_timedOutSources);
+        size_t outcomeIndex = 0;
+
         // Search available sources
-        for (const auto& source : m_availableSources)
+        for (const auto& source : availableSources)
         {
+            // The sources after the one that stopped the search are not considered at all.
+            if (outcomeIndex == availableOutcomes.size() && availableOutcomes.size() < sourcesToSearch.size())
+            {
+                break;
+            }
+
             // Search the tracking catalog as it can potentially get better correlations
             auto trackingCatalog = source.GetTrackingCatalog();
             SearchResult trackingResult = trackingCatalog.Search(request);
@@ -871,18 +1642,19 @@ namespace AppInstaller::Repository
 
                         compositePackage->SetTracking(source, std::move(match.Package));
 
-                        result.Matches.emplace_back(std::move(compositePackage), match.MatchCriteria);
+                        result.AddMatch(std::move(compositePackage), match.MatchCriteria);
                     }
                 }
             }
 
             // Do not attempt to correlate local packages against this source.
-            if (m_searchBehavior == CompositeSearchBehavior::Installed && !source.GetDetails().SupportInstalledSearchCorrelation)
+            if (!shouldSearchAvailable(source))
             {
                 continue;
             }
 
-            SearchResult availableResult = result.SearchAndHandleFailures(source, request);
+            SourceSearchOutcome& outcome = availableOutcomes[outcomeIndex++];
+            SearchResult availableResult = result.HandleFailures(source, std::move(outcome.Result), outcome.Exception);
 
             for (auto&& match : availableResult.Matches)
             {
@@ -919,14 +1691,14 @@ namespace AppInstaller::Repository
                     {
                         // TODO: Needs a whole separate change to fix the fact that we don't support multiple available packages and what the different search behaviors mean
                         foundInstalledMatch = true;
-                        result.Matches.emplace_back(std::make_shared<CompositePackage>(std::move(installedPackage), std::move(match.Package)), match.MatchCriteria);
+                        result.AddMatch(std::make_shared<CompositePackage>(std::move(installedPackage), std::move(match.Package)), match.MatchCriteria);
                     }
                 }
 
                 // If there was no correlation for this package, add it without one.
                 if ((m_searchBehavior == CompositeSearchBehavior::AllPackages || m_searchBehavior == CompositeSearchBehavior::AvailablePackages) && !foundInstalledMatch)
                 {
-                    result.Matches.emplace_back(std::make_shared<CompositePackage>(std::shared_ptr<IPackage>{}, std::move(match.Package)), match.MatchCriteria);
+                    result.AddMatch(std::make_shared<CompositePackage>(std::shared_ptr<IPackage>{}, std::move(match.Package)), match.MatchCriteria);
                 }
             }
         }
@@ -943,24 +1715,33 @@ namespace AppInstaller::Repository
     }
 
     // An available search goes through each source, searching individually and then sorting the full result set.
+    // When there are multiple sources they are searched concurrently, but the results are merged in source order.
+    // A request that stops at a unique id match searches them one at a time instead.
     SearchResult CompositeSource::SearchAvailable(const SearchRequest& request) const
     {
         SearchResult result;
 
-        // Search available sources
-        for (const auto& source : m_availableSources)
+        std::vector<Source> availableSources = m_timedOutSources->Exclude(m_availableSources, result.Failures);
+        std::vector<SourceSearchOutcome> outcomes = SearchAvailableSources(availableSources, request, GetConcurrentSearchTimeout(), *m_timedOutSources);
+
+        // Merge the results from the available sources
+        for (size_t i = 0; i < outcomes.size(); ++i)
         {
-            SearchResult oneSourceResult;
+            const Source& source = availableSources[i];
+            SearchResult& oneSourceResult = outcomes[i].Result;
 
-            try
-            {
-                oneSourceResult = source.Search(request);
-            }
-            catch (...)
+            if (outcomes[i].Exception)
             {
-                LOG_CAUGHT_EXCEPTION();
+                try
+                {
+                    std::rethrow_exception(outcomes[i].Exception);
+                }
+                catch (...)
+                {
+                    LOG_CAUGHT_EXCEPTION();
+                }
                 AICLI_LOG(Repo, Warning, << "Failed to search source: " << source.GetDetails().Name);
-                result.Failures.emplace_back(SearchResult::Failure{ source.GetDetails().Name, std::current_exception() });
+                result.Failures.emplace_back(SearchResult::Failure{ source.GetDetails().Name, outcomes[i].Exception });
             }
 
             // Move into the single result
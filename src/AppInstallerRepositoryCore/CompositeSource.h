@@ -5,6 +5,8 @@
 
 namespace AppInstaller::Repository
 {
+    struct CompositeTimedOutSources;
+
     struct CompositeSource : public ISource
     {
         explicit CompositeSource(std::string identifier);
@@ -53,6 +55,8 @@ namespace AppInstaller::Repository
 
         Source m_installedSource;
         std::vector<Source> m_availableSources;
+        // The available sources whose searches have timed out, which are not searched again.
+        std::shared_ptr<CompositeTimedOutSources> m_timedOutSources;
         SourceDetails m_details;
         CompositeSearchBehavior m_searchBehavior;
     };
@@ -46,6 +46,15 @@ namespace AppInstaller::Repository
 
         // Opens the source. This function should throw upon open failure rather than returning an empty pointer.
         virtual std::shared_ptr<ISource> Open(IProgressCallback& progress) = 0;
+
+        // Gets the values of the fields that start with the prefix for completion, without opening the source.
+        // Returns an empty value if this is not supported, in which case the source must be opened and searched.
+        virtual std::optional<std::vector<std::string>> GetCompletionValues(const std::vector<PackageMatchField>& fields, std::string_view prefix)
+        {
+            UNREFERENCED_PARAMETER(fields);
+            UNREFERENCED_PARAMETER(prefix);
+            return {};
+        }
     };
 
     // Internal interface extension to ISource for databases that can be updated after creation, like InstallingPackages
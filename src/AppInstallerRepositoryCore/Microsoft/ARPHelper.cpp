@@ -91,16 +91,16 @@ namespace AppInstaller::Repository::Microsoft
         }
     }
 
-    bool ARPHelper::GetBoolValue(const Registry::Key& arpKey, const std::wstring& name)
+    bool ARPHelper::GetBoolValue(const Registry::ValueSet& arpValues, const std::wstring& name)
     {
-        auto value = arpKey[name];
+        auto value = arpValues[name];
         return (value && value->GetType() == Registry::Value::Type::DWord && value->GetValue<Registry::Value::Type::DWord>());
     }
 
-    std::string ARPHelper::DetermineVersion(const Registry::Key& arpKey) const
+    std::string ARPHelper::DetermineVersion(const Registry::ValueSet& arpValues) const
     {
         // First check DisplayVersion for a complete version string
-        auto displayVersion = arpKey[DisplayVersion];
+        auto displayVersion = arpValues[DisplayVersion];
         if (displayVersion && displayVersion->GetType() == Registry::Value::Type::String)
         {
             std::string result = displayVersion->GetValue<Registry::Value::Type::String>();
@@ -113,8 +113,8 @@ namespace AppInstaller::Repository::Microsoft
         // Next attempt VersionMajor.VersionMinor, then MajorVersion.MinorVersion
         for (const auto& names : { std::make_pair(std::ref(VersionMajor), std::ref(VersionMinor)), std::make_pair(std::ref(MajorVersion), std::ref(MinorVersion)) })
         {
-            auto majorVersion = arpKey[names.first];
-            auto minorVersion = arpKey[names.second];
+            auto majorVersion = arpValues[names.first.get()];
+            auto minorVersion = arpValues[names.second.get()];
             if (majorVersion || minorVersion)
             {
                 uint32_t majorVersionInt = 0;
@@ -140,7 +140,7 @@ namespace AppInstaller::Repository::Microsoft
         }
 
         // Finally attempt to turn the Version DWORD into a version string
-        auto version = arpKey[Version];
+        auto version = arpValues[Version];
         if (version && version->GetType() == Registry::Value::Type::DWord)
         {
             uint32_t versionInt = version->GetValue<Registry::Value::Type::DWord>();
@@ -155,9 +155,9 @@ namespace AppInstaller::Repository::Microsoft
         return Utility::Version::CreateUnknown().ToString();
     }
 
-    void ARPHelper::AddMetadataIfPresent(const Registry::Key& key, const std::wstring& name, SQLiteIndex& index, SQLiteIndex::IdType manifestId, PackageVersionMetadata metadata) const
+    void ARPHelper::AddMetadataIfPresent(const Registry::ValueSet& values, const std::wstring& name, Entry& entry, PackageVersionMetadata metadata) const
     {
-        auto value = key[name];
+        auto value = values[name];
         if (value)
         {
             std::string valueString;
@@ -187,168 +187,419 @@ namespace AppInstaller::Repository::Microsoft
 
             if (!valueString.empty())
             {
-                index.SetMetadataByManifestId(manifestId, metadata, valueString);
+                entry.Metadata.emplace_back(metadata, std::move(valueString));
             }
         }
     }
 
     void ARPHelper::PopulateIndexFromARP(SQLiteIndex& index, Manifest::ScopeEnum scope) const
     {
+        AddEntriesToIndex(index, ReadEntriesFromARP(scope));
+    }
+
+    std::vector<ARPHelper::Entry> ARPHelper::ReadEntriesFromARP(Manifest::ScopeEnum scope) const
+    {
+        std::vector<Entry> result;
+
         for (auto architecture : Utility::GetApplicableArchitectures())
         {
             Registry::Key arpRootKey = GetARPKey(scope, architecture);
 
             if (arpRootKey)
             {
-                PopulateIndexFromKey(index, arpRootKey, Manifest::ScopeToString(scope), Utility::ToString(architecture));
+                std::vector<Entry> entries = ReadEntriesFromKey(arpRootKey, Manifest::ScopeToString(scope), Utility::ToString(architecture));
+                std::move(entries.begin(), entries.end(), std::back_inserter(result));
             }
         }
+
+        return result;
     }
 
-    void ARPHelper::PopulateIndexFromKey(SQLiteIndex& index, const Registry::Key& key, std::string_view scope, std::string_view architecture) const
+    bool ARPHelper::EntryState::operator==(const EntryState& other) const
     {
-        AICLI_LOG(Repo, Info, << "Examining ARP entries for " << scope << " | " << architecture);
+        return Scope == other.Scope && Architecture == other.Architecture && ProductCode == other.ProductCode && LastWriteTime == other.LastWriteTime;
+    }
 
-        for (const auto& arpEntry : key)
+    std::vector<ARPHelper::EntryState> ARPHelper::GetEntryStates(Manifest::ScopeEnum scope) const
+    {
+        std::vector<EntryState> result;
+
+        for (auto architecture : Utility::GetApplicableArchitectures())
         {
-            std::string productCode;
+            Registry::Key arpRootKey = GetARPKey(scope, architecture);
 
-            try
+            if (arpRootKey)
             {
-                productCode = arpEntry.Name();
+                for (const auto& arpEntry : arpRootKey)
+                {
+                    FILETIME lastWriteTime = arpEntry.LastWriteTime();
+
+                    EntryState state;
+                    state.Scope = scope;
+                    state.Architecture = architecture;
+                    state.ProductCode = arpEntry.Name();
+                    state.LastWriteTime = (static_cast<uint64_t>(lastWriteTime.dwHighDateTime) << 32) | lastWriteTime.dwLowDateTime;
+                    result.emplace_back(std::move(state));
+                }
+            }
+        }
 
-                Manifest::Manifest manifest;
-                manifest.DefaultLocalization.Add<Manifest::Localization::Tags>({ "ARP" });
+        return result;
+    }
 
-                // Use the key name as the Id, as it is supposed to be unique.
-                // TODO: We probably want something better here, like constructing the value as
-                //       `Publisher.DisplayName`. We would need to ensure that there are no matches
-                //       against the rest of the data however (might happen if same package is
-                //       installed for multiple architectures/languages).
-                manifest.Id = productCode;
+    std::string ARPHelper::SerializeEntryStates(const std::vector<EntryState>& states)
+    {
+        // One entry per line as scope|architecture|time|product code; the product code goes last as it is free form.
+        std::ostringstream strstr;
 
-                manifest.Installers.emplace_back();
-                // TODO: This likely needs some cleanup applied, as it looks like INNO tends to append an "_is#"
-                //       that might vary across machines/installs. There may be other things we want to clean up as well,
-                //       like trimming spaces at the ends, or removing the version string from the product code
-                //       if it is present.
-                manifest.Installers[0].ProductCode = productCode;
+        for (const auto& state : states)
+        {
+            strstr << Manifest::ScopeToString(state.Scope) << '|' << Utility::ToString(state.Architecture) << '|' << state.LastWriteTime << '|' << state.ProductCode << '\n';
+        }
 
-                Registry::Key arpKey = arpEntry.Open();
+        return strstr.str();
+    }
 
-                // Ignore entries that are listed as SystemComponent
-                if (GetBoolValue(arpKey, SystemComponent))
-                {
-                    AICLI_LOG(Repo, Verbose, << "Skipping " << productCode << " because it is a SystemComponent");
-                    continue;
-                }
+    std::vector<ARPHelper::EntryState> ARPHelper::DeserializeEntryStates(std::string_view states)
+    {
+        std::vector<EntryState> result;
 
-                // If no name is provided, ignore this entry
-                auto displayName = arpKey[DisplayName];
-                if (!displayName || displayName->GetType() != Registry::Value::Type::String)
-                {
-                    AICLI_LOG(Repo, Verbose, << "Skipping " << productCode << " because DisplayName is not a REG_SZ value");
-                    continue;
-                }
-                auto displayNameValue = displayName->GetValue<Registry::Value::Type::String>();
-                manifest.DefaultLocalization.Add<Manifest::Localization::PackageName>(displayNameValue);
-                if (displayNameValue.empty())
-                {
-                    AICLI_LOG(Repo, Verbose, << "Skipping " << productCode << " because DisplayName is empty");
-                    continue;
-                }
+        while (!states.empty())
+        {
+            size_t lineEnd = states.find('\n');
+            std::string_view line = states.substr(0, lineEnd);
+            states = (lineEnd == std::string_view::npos ? std::string_view{} : states.substr(lineEnd + 1));
+
+            size_t scopeEnd = line.find('|');
+            size_t architectureEnd = (scopeEnd == std::string_view::npos ? scopeEnd : line.find('|', scopeEnd + 1));
+            size_t timeEnd = (architectureEnd == std::string_view::npos ? architectureEnd : line.find('|', architectureEnd + 1));
+            THROW_HR_IF(E_UNEXPECTED, timeEnd == std::string_view::npos);
+
+            EntryState state;
+            state.Scope = Manifest::ConvertToScopeEnum(line.substr(0, scopeEnd));
+            state.Architecture = Utility::ConvertToArchitectureEnum(std::string{ line.substr(scopeEnd + 1, architectureEnd - scopeEnd - 1) });
+            state.LastWriteTime = std::stoull(std::string{ line.substr(architectureEnd + 1, timeEnd - architectureEnd - 1) });
+            state.ProductCode = line.substr(timeEnd + 1);
+            result.emplace_back(std::move(state));
+        }
 
-                // If no version can be determined, ignore this entry
-                manifest.Version = DetermineVersion(arpKey);
-                if (manifest.Version.empty())
-                {
-                    AICLI_LOG(Repo, Verbose, << "Skipping " << productCode << " because a version could not be determined");
-                    continue;
-                }
+        return result;
+    }
 
-                auto publisher = arpKey[Publisher];
-                if (publisher && publisher->GetType() == Registry::Value::Type::String)
-                {
-                    manifest.DefaultLocalization.Add<Manifest::Localization::Publisher>(publisher->GetValue<Registry::Value::Type::String>());
-
-                    // If Publisher is set, change the Id using name normalization
-                    // TODO: Figure out how to actually make this work since there are often instances of the same
-                    // data in x64 and x86 entries that will collide.
-                    //auto normalizedName = index.NormalizeName(
-                    //    manifest.DefaultLocalization.Get<Manifest::Localization::PackageName>(),
-                    //    manifest.DefaultLocalization.Get<Manifest::Localization::Publisher>());
-                    //manifest.Id = normalizedName.Publisher() + '.' + normalizedName.Name();
-                }
+    void ARPHelper::UpdateIndexFromARP(SQLiteIndex& index, const std::vector<EntryState>& previous, const std::vector<EntryState>& current) const
+    {
+        // Any product code whose set of entries differs must be rebuilt from all of its current entries,
+        // as duplicates across locations are resolved by the order in which they are added.
+        auto getEntriesByProductCode = [](const std::vector<EntryState>& states)
+        {
+            std::map<std::string, std::vector<const EntryState*>> result;
+            for (const auto& state : states)
+            {
+                result[state.ProductCode].emplace_back(&state);
+            }
+            return result;
+        };
 
-                // TODO: If we want to keep the constructed manifest around to allow for `show` type commands
-                //       against installed packages, we should use URLInfoAbout/HelpLink for the Homepage.
+        auto previousByProductCode = getEntriesByProductCode(previous);
+        auto currentByProductCode = getEntriesByProductCode(current);
 
-                // TODO: Determine the best way to handle duplicates; sometimes the same package will be listed under
-                //       both x64 and x86 locations for ARP.
-                //       For now, we will attempt to insert and catch.
-                std::optional<SQLiteIndex::IdType> manifestIdOpt;
+        auto entriesAreEqual = [](const std::vector<const EntryState*>& a, const std::vector<const EntryState*>& b)
+        {
+            return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const EntryState* x, const EntryState* y) { return *x == *y; });
+        };
 
-                try
-                {
-                    // Use the ProductCode as a unique key for the path
-                    manifestIdOpt = index.AddManifest(manifest, Utility::ConvertToUTF16(manifest.Installers[0].ProductCode));
-                }
-                catch (...)
+        std::vector<std::string> changedProductCodes;
+
+        for (const auto& entries : previousByProductCode)
+        {
+            auto itr = currentByProductCode.find(entries.first);
+            if (itr == currentByProductCode.end() || !entriesAreEqual(entries.second, itr->second))
+            {
+                changedProductCodes.emplace_back(entries.first);
+            }
+        }
+
+        for (const auto& entries : currentByProductCode)
+        {
+            if (previousByProductCode.find(entries.first) == previousByProductCode.end())
+            {
+                changedProductCodes.emplace_back(entries.first);
+            }
+        }
+
+        AICLI_LOG(Repo, Info, << "Updating index for " << changedProductCodes.size() << " changed ARP product codes");
+
+        for (const auto& productCode : changedProductCodes)
+        {
+            SearchRequest request;
+            request.Filters.emplace_back(PackageMatchField::Id, MatchType::Exact, productCode);
+
+            for (const auto& match : index.Search(request).Matches)
+            {
+                for (const auto& versionKey : index.GetVersionKeysById(match.first))
                 {
-                    // Ignore errors if they occur, they are most likely a duplicate value
+                    auto manifestId = index.GetManifestIdByKey(match.first, versionKey.GetVersion().ToString(), versionKey.GetChannel().ToString());
+                    if (manifestId)
+                    {
+                        index.RemoveManifestById(manifestId.value());
+                    }
                 }
+            }
 
-                if (!manifestIdOpt)
+            auto itr = currentByProductCode.find(productCode);
+            if (itr != currentByProductCode.end())
+            {
+                for (const EntryState* state : itr->second)
                 {
-                    AICLI_LOG(Repo, Warning,
-                        << "Ignoring duplicate ARP entry " << scope << '|' << architecture << '|' << productCode << " [" << manifest.DefaultLocalization.Get<Manifest::Localization::PackageName>() << "]");
-                    continue;
+                    Registry::Key arpRootKey = GetARPKey(state->Scope, state->Architecture);
+                    if (arpRootKey)
+                    {
+                        PopulateIndexFromEntry(index, arpRootKey, productCode, Manifest::ScopeToString(state->Scope), Utility::ToString(state->Architecture));
+                    }
                 }
+            }
+        }
+    }
 
-                SQLiteIndex::IdType manifestId = manifestIdOpt.value();
+    void ARPHelper::PopulateIndexFromKey(SQLiteIndex& index, const Registry::Key& key, std::string_view scope, std::string_view architecture) const
+    {
+        AddEntriesToIndex(index, ReadEntriesFromKey(key, scope, architecture));
+    }
 
-                // Pass scope along to metadata.
-                index.SetMetadataByManifestId(manifestId, PackageVersionMetadata::InstalledScope, scope);
+    void ARPHelper::PopulateIndexFromEntry(SQLiteIndex& index, const Registry::Key& key, const std::string& productCode, std::string_view scope, std::string_view architecture) const
+    {
+        std::optional<Entry> entry = ReadEntry(key, productCode, scope, architecture);
+        if (entry)
+        {
+            AddEntryToIndex(index, entry.value());
+        }
+    }
 
-                // TODO: Pass along architecture, although there are cases where it is not clear what architecture the package
-                //       is from it's ARP location, despite it very clearly being a specific architecture. And note that user
-                //       scope does not have separate ARP locations, so every architecture would appear as native.
+    std::vector<ARPHelper::Entry> ARPHelper::ReadEntriesFromKey(const Registry::Key& key, std::string_view scope, std::string_view architecture) const
+    {
+        AICLI_LOG(Repo, Info, << "Examining ARP entries for " << scope << " | " << architecture);
 
-                // Publisher is needed for certain scenarios but we don't store it from the manifest
-                if (manifest.DefaultLocalization.Contains(Manifest::Localization::Publisher))
-                {
-                    index.SetMetadataByManifestId(
-                        manifestId, PackageVersionMetadata::Publisher,
-                        manifest.DefaultLocalization.Get<Manifest::Localization::Publisher>());
-                }
+        std::vector<Entry> result;
 
-                // Pick up InstallLocation when upgrade supports remove/install to enable this location
-                // to survive across the removal.
-                AddMetadataIfPresent(arpKey, InstallLocation, index, manifestId, PackageVersionMetadata::InstalledLocation);
+        for (const auto& arpEntry : key)
+        {
+            std::optional<Entry> entry = ReadEntry(key, arpEntry.Name(), scope, architecture);
+            if (entry)
+            {
+                result.emplace_back(std::move(entry).value());
+            }
+        }
+
+        return result;
+    }
+
+    std::optional<ARPHelper::Entry> ARPHelper::ReadEntry(const Registry::Key& key, const std::string& productCode, std::string_view scope, std::string_view architecture) const
+    {
+        try
+        {
+            Entry entry;
+            entry.Scope = scope;
+            entry.Architecture = architecture;
+
+            Manifest::Manifest& manifest = entry.PackageManifest;
+            manifest.DefaultLocalization.Add<Manifest::Localization::Tags>({ "ARP" });
+
+            // Use the key name as the Id, as it is supposed to be unique.
+            // TODO: We probably want something better here, like constructing the value as
+            //       `Publisher.DisplayName`. We would need to ensure that there are no matches
+            //       against the rest of the data however (might happen if same package is
+            //       installed for multiple architectures/languages).
+            manifest.Id = productCode;
+
+            manifest.Installers.emplace_back();
+            // TODO: This likely needs some cleanup applied, as it looks like INNO tends to append an "_is#"
+            //       that might vary across machines/installs. There may be other things we want to clean up as well,
+            //       like trimming spaces at the ends, or removing the version string from the product code
+            //       if it is present.
+            manifest.Installers[0].ProductCode = productCode;
+
+            std::optional<Registry::Key> arpKeyOpt = key.SubKey(productCode);
+            if (!arpKeyOpt)
+            {
+                AICLI_LOG(Repo, Verbose, << "Skipping " << productCode << " because it no longer exists");
+                return {};
+            }
+
+            // Read all of the values at once rather than looking each of them up by name
+            Registry::ValueSet arpValues = arpKeyOpt->ReadValues();
+
+            // Ignore entries that are listed as SystemComponent
+            if (GetBoolValue(arpValues, SystemComponent))
+            {
+                AICLI_LOG(Repo, Verbose, << "Skipping " << productCode << " because it is a SystemComponent");
+                return {};
+            }
+
+            // If no name is provided, ignore this entry
+            auto displayName = arpValues[DisplayName];
+            if (!displayName || displayName->GetType() != Registry::Value::Type::String)
+            {
+                AICLI_LOG(Repo, Verbose, << "Skipping " << productCode << " because DisplayName is not a REG_SZ value");
+                return {};
+            }
+            auto displayNameValue = displayName->GetValue<Registry::Value::Type::String>();
+            manifest.DefaultLocalization.Add<Manifest::Localization::PackageName>(displayNameValue);
+            if (displayNameValue.empty())
+            {
+                AICLI_LOG(Repo, Verbose, << "Skipping " << productCode << " because DisplayName is empty");
+                return {};
+            }
+
+            // If no version can be determined, ignore this entry
+            manifest.Version = DetermineVersion(arpValues);
+            if (manifest.Version.empty())
+            {
+                AICLI_LOG(Repo, Verbose, << "Skipping " << productCode << " because a version could not be determined");
+                return {};
+            }
+
+            auto publisher = arpValues[Publisher];
+            if (publisher && publisher->GetType() == Registry::Value::Type::String)
+            {
+                manifest.DefaultLocalization.Add<Manifest::Localization::Publisher>(publisher->GetValue<Registry::Value::Type::String>());
+
+                // If Publisher is set, change the Id using name normalization
+                // TODO: Figure out how to actually make this work since there are often instances of the same
+                // data in x64 and x86 entries that will collide.
+                //auto normalizedName = index.NormalizeName(
+                //    manifest.DefaultLocalization.Get<Manifest::Localization::PackageName>(),
+                //    manifest.DefaultLocalization.Get<Manifest::Localization::Publisher>());
+                //manifest.Id = normalizedName.Publisher() + '.' + normalizedName.Name();
+            }
+
+            // TODO: If we want to keep the constructed manifest around to allow for `show` type commands
+            //       against installed packages, we should use URLInfoAbout/HelpLink for the Homepage.
+
+            // Pass scope along to metadata.
+            entry.Metadata.emplace_back(PackageVersionMetadata::InstalledScope, std::string{ scope });
+
+            // TODO: Pass along architecture, although there are cases where it is not clear what architecture the package
+            //       is from it's ARP location, despite it very clearly being a specific architecture. And note that user
+            //       scope does not have separate ARP locations, so every architecture would appear as native.
+
+            // Publisher is needed for certain scenarios but we don't store it from the manifest
+            if (manifest.DefaultLocalization.Contains(Manifest::Localization::Publisher))
+            {
+                entry.Metadata.emplace_back(PackageVersionMetadata::Publisher, manifest.DefaultLocalization.Get<Manifest::Localization::Publisher>());
+            }
+
+            // Pick up InstallLocation when upgrade supports remove/install to enable this location
+            // to survive across the removal.
+            AddMetadataIfPresent(arpValues, InstallLocation, entry, PackageVersionMetadata::InstalledLocation);
+
+            // Pick up UninstallString and QuietUninstallString for uninstall.
+            AddMetadataIfPresent(arpValues, UninstallString, entry, PackageVersionMetadata::StandardUninstallCommand);
+            AddMetadataIfPresent(arpValues, QuietUninstallString, entry, PackageVersionMetadata::SilentUninstallCommand);
+
+            // Pick up Language to enable proper selection of language for upgrade.
+            AddMetadataIfPresent(arpValues, Language, entry, PackageVersionMetadata::InstalledLocale);
+
+            // Pick up WindowsInstaller to determine if this is an MSI install.
+            // TODO: Could also determine Inno (and maybe other types) through detecting other keys here.
+            auto installedType = Manifest::InstallerTypeEnum::Exe;
+
+            if (GetBoolValue(arpValues, WindowsInstaller))
+            {
+                installedType = Manifest::InstallerTypeEnum::Msi;
+            }
+
+            entry.Metadata.emplace_back(PackageVersionMetadata::InstalledType, std::string{ Manifest::InstallerTypeToString(installedType) });
+
+            return entry;
+        }
+        catch (...)
+        {
+            AICLI_LOG(Repo, Warning, << "Failed to read ARP entry, ignoring it: " << scope << '|' << architecture << '|' << productCode);
+            LOG_CAUGHT_EXCEPTION();
+        }
+
+        return {};
+    }
+
+    void ARPHelper::AddEntriesToIndex(SQLiteIndex& index, const std::vector<Entry>& entries) const
+    {
+        for (const auto& entry : entries)
+        {
+            AddEntryToIndex(index, entry);
+        }
+    }
 
-                // Pick up UninstallString and QuietUninstallString for uninstall.
-                AddMetadataIfPresent(arpKey, UninstallString, index, manifestId, PackageVersionMetadata::StandardUninstallCommand);
-                AddMetadataIfPresent(arpKey, QuietUninstallString, index, manifestId, PackageVersionMetadata::SilentUninstallCommand);
+    void ARPHelper::AddMatchingEntriesToIndex(SQLiteIndex& index, std::vector<Entry>& entries, const InstalledSearchFilter& filter) const
+    {
+        // The product code is the path of the entry in the index, so it is what makes a later entry a duplicate
+        std::set<std::string> productCodes;
+        std::vector<Entry> remaining;
+
+        for (auto& entry : entries)
+        {
+            const Manifest::Manifest& manifest = entry.PackageManifest;
 
-                // Pick up Language to enable proper selection of language for upgrade.
-                AddMetadataIfPresent(arpKey, Language, index, manifestId, PackageVersionMetadata::InstalledLocale);
+            if (productCodes.emplace(manifest.Installers[0].ProductCode).second && filter.CouldMatch(manifest))
+            {
+                AddEntryToIndex(index, entry);
+            }
+            else
+            {
+                remaining.emplace_back(std::move(entry));
+            }
+        }
 
-                // Pick up WindowsInstaller to determine if this is an MSI install.
-                // TODO: Could also determine Inno (and maybe other types) through detecting other keys here.
-                auto installedType = Manifest::InstallerTypeEnum::Exe;
+        entries = std::move(remaining);
+    }
 
-                if (GetBoolValue(arpKey, WindowsInstaller))
+    void ARPHelper::AddEntryToIndex(SQLiteIndex& index, const Entry& entry) const
+    {
+        const Manifest::Manifest& manifest = entry.PackageManifest;
+
+        try
+        {
+            // TODO: Determine the best way to handle duplicates; sometimes the same package will be listed under
+            //       both x64 and x86 locations for ARP.
+            //       For now, we will attempt to insert and catch.
+            std::optional<SQLiteIndex::IdType> manifestIdOpt;
+
+            try
+            {
+                // Use the ProductCode as a unique key for the path
+                manifestIdOpt = index.AddManifest(manifest, Utility::ConvertToUTF16(manifest.Installers[0].ProductCode));
+            }
+            catch (...)
+            {
+                // Ignore errors if they occur, they are most likely a duplicate value
+            }
+
+            if (!manifestIdOpt)
+            {
+                AICLI_LOG(Repo, Warning,
+                    << "Ignoring duplicate ARP entry " << entry.Scope << '|' << entry.Architecture << '|' << manifest.Id << " [" << manifest.DefaultLocalization.Get<Manifest::Localization::PackageName>() << "]");
+                return;
+            }
+
+            SQLiteIndex::IdType manifestId = manifestIdOpt.value();
+
+            try
+            {
+                for (const auto& metadata : entry.Metadata)
                 {
-                    installedType = Manifest::InstallerTypeEnum::Msi;
+                    index.SetMetadataByManifestId(manifestId, metadata.first, metadata.second);
                 }
-
-                index.SetMetadataByManifestId(manifestId, PackageVersionMetadata::InstalledType, Manifest::InstallerTypeToString(installedType));
             }
             catch (...)
             {
-                AICLI_LOG(Repo, Warning, << "Failed to read ARP entry, ignoring it: " << scope << '|' << architecture << '|' << productCode);
-                LOG_CAUGHT_EXCEPTION();
+                // Do not leave the entry in the index without its metadata
+                index.RemoveManifestById(manifestId);
+                throw;
             }
         }
+        catch (...)
+        {
+            AICLI_LOG(Repo, Warning, << "Failed to add ARP entry, ignoring it: " << entry.Scope << '|' << entry.Architecture << '|' << manifest.Id);
+            LOG_CAUGHT_EXCEPTION();
+        }
     }
 }
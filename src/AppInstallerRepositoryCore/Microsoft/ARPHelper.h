@@ -1,13 +1,18 @@
 // Copyright (c) Microsoft Corporation.
 // Licensed under the MIT License.
 #pragma once
+#include "Microsoft/InstalledSearchFilter.h"
 #include "Microsoft/SQLiteIndex.h"
 #include <AppInstallerArchitecture.h>
 #include <winget/Registry.h>
 #include <winget/ManifestInstaller.h>
 #include <wil/resource.h>
 
+#include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace AppInstaller::Repository::Microsoft
 {
@@ -52,30 +57,86 @@ namespace AppInstaller::Repository::Microsoft
         // REG_DWORD (bool)
         const std::wstring SystemComponent{ L"SystemComponent" };
 
+        // The data read from an ARP entry, ready to be added to an index.
+        struct Entry
+        {
+            Manifest::Manifest PackageManifest;
+            std::string Scope;
+            std::string Architecture;
+            std::vector<std::pair<PackageVersionMetadata, std::string>> Metadata;
+        };
+
         // Gets the registry key associated with the given scope and architecture on this platform.
         // May return an empty key if there is no valid location (bad combination or not found).
         Registry::Key GetARPKey(Manifest::ScopeEnum scope, Utility::Architecture architecture) const;
 
         // Returns true IFF the value exists and contains a non-zero DWORD.
-        static bool GetBoolValue(const Registry::Key& arpKey, const std::wstring& name);
+        static bool GetBoolValue(const Registry::ValueSet& arpValues, const std::wstring& name);
 
         // Determines the version from an ARP entry.
         // The priority is:
         //  DisplayVersion
         //  Version
         //  MajorVersion, MinorVersion
-        std::string DetermineVersion(const Registry::Key& arpKey) const;
+        std::string DetermineVersion(const Registry::ValueSet& arpValues) const;
 
-        // Reads a value and adds it to the metadata if it exists.
-        void AddMetadataIfPresent(const Registry::Key& key, const std::wstring& name, SQLiteIndex& index, SQLiteIndex::IdType manifestId, PackageVersionMetadata metadata) const;
+        // Reads a value and adds it to the metadata of the entry if it exists.
+        void AddMetadataIfPresent(const Registry::ValueSet& values, const std::wstring& name, Entry& entry, PackageVersionMetadata metadata) const;
 
         // Populates the index with the ARP entries from the given scope (machine/user).
         // Handles all of the architectures for the given scope.
         void PopulateIndexFromARP(SQLiteIndex& index, Manifest::ScopeEnum scope) const;
 
+        // The location and last write time of an ARP entry; allows changes to be detected without reading its values.
+        struct EntryState
+        {
+            Manifest::ScopeEnum Scope = Manifest::ScopeEnum::Unknown;
+            Utility::Architecture Architecture = Utility::Architecture::Unknown;
+            std::string ProductCode;
+            uint64_t LastWriteTime = 0;
+
+            bool operator==(const EntryState& other) const;
+            bool operator!=(const EntryState& other) const { return !operator==(other); }
+        };
+
+        // Gets the state of the ARP entries from the given scope (machine/user), in the order that PopulateIndexFromARP reads them.
+        // The last write time of an entry changes whenever any of its values are written.
+        std::vector<EntryState> GetEntryStates(Manifest::ScopeEnum scope) const;
+
+        // Converts entry states to and from a string for storage.
+        static std::string SerializeEntryStates(const std::vector<EntryState>& states);
+        static std::vector<EntryState> DeserializeEntryStates(std::string_view states);
+
+        // Updates an index that was populated from the previous entries so that it reflects the current entries.
+        // Only the entries for product codes that were added, removed, or written are read from the registry.
+        void UpdateIndexFromARP(SQLiteIndex& index, const std::vector<EntryState>& previous, const std::vector<EntryState>& current) const;
+
         // Populates the index with the ARP entries from the given key.
         // This entry point is primarily to allow unit tests to operate of arbitrary keys;
         // product code should use PopulateIndexFromARP.
         void PopulateIndexFromKey(SQLiteIndex& index, const Registry::Key& key, std::string_view scope, std::string_view architecture) const;
+
+        // Populates the index with the ARP entry named by the product code under the given key.
+        void PopulateIndexFromEntry(SQLiteIndex& index, const Registry::Key& key, const std::string& productCode, std::string_view scope, std::string_view architecture) const;
+
+        // Reads the ARP entries from the given scope (machine/user) without touching an index.
+        // This only reads from the registry, so it can run concurrently with other readers.
+        std::vector<Entry> ReadEntriesFromARP(Manifest::ScopeEnum scope) const;
+
+        // Reads the ARP entries from the given key.
+        std::vector<Entry> ReadEntriesFromKey(const Registry::Key& key, std::string_view scope, std::string_view architecture) const;
+
+        // Reads the ARP entry named by the product code under the given key.
+        // Returns an empty value if the entry should not be in the index.
+        std::optional<Entry> ReadEntry(const Registry::Key& key, const std::string& productCode, std::string_view scope, std::string_view architecture) const;
+
+        // Adds previously read entries to the index, in order; later duplicates of a product code are ignored.
+        void AddEntriesToIndex(SQLiteIndex& index, const std::vector<Entry>& entries) const;
+
+        // Adds the previously read entries that the filter could match to the index, in order, and removes them from the entries
+        // so that the rest can be added later. An entry that does not match still hides the later duplicates of its product code,
+        // as it would in a full index.
+        void AddMatchingEntriesToIndex(SQLiteIndex& index, std::vector<Entry>& entries, const InstalledSearchFilter& filter) const;
+        void AddEntryToIndex(SQLiteIndex& index, const Entry& entry) const;
     };
 }
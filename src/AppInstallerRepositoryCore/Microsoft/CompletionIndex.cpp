@@ -0,0 +1,301 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Microsoft/CompletionIndex.h"
+
+namespace AppInstaller::Repository::Microsoft
+{
+    namespace
+    {
+        // Identifies the file format; contents with another magic value or version are written again.
+        constexpr uint32_t s_CompletionIndexMagic = 0x49434757; // "WGCI"
+        constexpr uint32_t s_CompletionIndexVersion = 2;
+
+        // The fields held by the index, along with the character that marks their values.
+        constexpr std::pair<PackageMatchField, char> s_CompletionIndexFields[] =
+        {
+            { PackageMatchField::Id, 'I' },
+            { PackageMatchField::Name, 'N' },
+            { PackageMatchField::Moniker, 'M' },
+        };
+
+        // The contents start with the header, followed by the entries sorted by key and then the pool that holds their strings.
+        // Each key is the marker of the field followed by the folded value.
+        struct Header
+        {
+            uint32_t Magic;
+            uint32_t Version;
+            // The size and last write time of the index that the file was written for; these are zero in the index itself.
+            uint64_t IndexSize;
+            int64_t IndexWriteTime;
+            uint32_t EntryCount;
+            uint32_t PoolSize;
+        };
+
+        struct Entry
+        {
+            uint32_t KeyOffset;
+            uint32_t KeyLength;
+            uint32_t ValueOffset;
+            uint32_t ValueLength;
+        };
+
+        static_assert(sizeof(Header) == 32);
+        static_assert(sizeof(Entry) == 16);
+
+        char GetFieldMarker(PackageMatchField field)
+        {
+            for (const auto& entry : s_CompletionIndexFields)
+            {
+                if (entry.first == field)
+                {
+                    return entry.second;
+                }
+            }
+
+            THROW_HR(E_UNEXPECTED);
+        }
+
+        // A view of completion index contents, which validates them as it is created.
+        struct CompletionIndexView
+        {
+            CompletionIndexView(const uint8_t* data, size_t size)
+            {
+                THROW_HR_IF(E_NOT_SUFFICIENT_BUFFER, size < sizeof(Header));
+                m_header = reinterpret_cast<const Header*>(data);
+                THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), m_header->Magic != s_CompletionIndexMagic || m_header->Version != s_CompletionIndexVersion);
+                THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), size != sizeof(Header) + static_cast<uint64_t>(m_header->EntryCount) * sizeof(Entry) + m_header->PoolSize);
+
+                m_entries = reinterpret_cast<const Entry*>(data + sizeof(Header));
+                m_pool = reinterpret_cast<const char*>(m_entries + m_header->EntryCount);
+            }
+
+            const Header& GetHeader() const { return *m_header; }
+
+            // Gets the values whose keys start with the given key prefix.
+            void AddValues(std::string_view keyPrefix, std::vector<std::string>& values) const
+            {
+                const Entry* end = m_entries + m_header->EntryCount;
+                const Entry* itr = std::lower_bound(m_entries, end, keyPrefix, [&](const Entry& entry, std::string_view key) { return GetKey(entry) < key; });
+
+                for (; itr != end && GetKey(*itr).substr(0, keyPrefix.size()) == keyPrefix; ++itr)
+                {
+                    values.emplace_back(GetString(itr->ValueOffset, itr->ValueLength));
+                }
+            }
+
+        private:
+            std::string_view GetKey(const Entry& entry) const
+            {
+                return GetString(entry.KeyOffset, entry.KeyLength);
+            }
+
+            std::string_view GetString(uint32_t offset, uint32_t length) const
+            {
+                THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), static_cast<uint64_t>(offset) + length > m_header->PoolSize);
+                return { m_pool + offset, length };
+            }
+
+            const Header* m_header = nullptr;
+            const Entry* m_entries = nullptr;
+            const char* m_pool = nullptr;
+        };
+
+        // Gets the size and last write time of the index, so that a completion index written for another version of it is not used.
+        std::pair<uint64_t, int64_t> GetIndexStamp(const std::filesystem::path& indexPath)
+        {
+            return { std::filesystem::file_size(indexPath), std::filesystem::last_write_time(indexPath).time_since_epoch().count() };
+        }
+
+        void AddValues(const CompletionIndexView& completionIndex, const std::vector<PackageMatchField>& fields, std::string_view prefix, std::vector<std::string>& values)
+        {
+            std::string foldedPrefix = Utility::FoldCase(prefix);
+            for (PackageMatchField field : fields)
+            {
+                completionIndex.AddValues(GetFieldMarker(field) + foldedPrefix, values);
+            }
+        }
+
+        // Reads the values from the completion index file, returning false if it is missing or does not match the index.
+        bool TryAddValuesFromFile(
+            const std::filesystem::path& completionIndexPath,
+            const std::pair<uint64_t, int64_t>& indexStamp,
+            const std::vector<PackageMatchField>& fields,
+            std::string_view prefix,
+            std::vector<std::string>& values)
+        {
+            wil::unique_hfile file{ CreateFileW(completionIndexPath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+            if (!file)
+            {
+                return false;
+            }
+
+            LARGE_INTEGER fileSize{};
+            THROW_LAST_ERROR_IF(!GetFileSizeEx(file.get(), &fileSize));
+            if (static_cast<uint64_t>(fileSize.QuadPart) < sizeof(Header))
+            {
+                return false;
+            }
+
+            wil::unique_handle mapping{ CreateFileMappingW(file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr) };
+            THROW_LAST_ERROR_IF(!mapping);
+
+            wil::unique_mapview_ptr<uint8_t> view{ reinterpret_cast<uint8_t*>(MapViewOfFile(mapping.get(), FILE_MAP_READ, 0, 0, 0)) };
+            THROW_LAST_ERROR_IF(!view);
+
+            CompletionIndexView completionIndex{ view.get(), static_cast<size_t>(fileSize.QuadPart) };
+            const Header& header = completionIndex.GetHeader();
+            if (header.IndexSize != indexStamp.first || header.IndexWriteTime != indexStamp.second)
+            {
+                return false;
+            }
+
+            AddValues(completionIndex, fields, prefix, values);
+            return true;
+        }
+
+        void WriteFile(const std::filesystem::path& completionIndexPath, const SQLite::blob_t& contents)
+        {
+            std::filesystem::create_directories(completionIndexPath.parent_path());
+
+            // Write to a temporary file and move it into place, so that a reader never sees a partial file.
+            std::filesystem::path tempPath = completionIndexPath;
+            tempPath += L"." + std::to_wstring(GetCurrentProcessId()) + L".tmp";
+
+            {
+                std::ofstream stream{ tempPath, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary };
+                stream.write(reinterpret_cast<const char*>(contents.data()), static_cast<std::streamsize>(contents.size()));
+            }
+
+            std::filesystem::rename(tempPath, completionIndexPath);
+        }
+    }
+
+    bool CompletionIndex::SupportsField(PackageMatchField field)
+    {
+        return std::any_of(std::begin(s_CompletionIndexFields), std::end(s_CompletionIndexFields), [&](const auto& entry) { return entry.first == field; });
+    }
+
+    SQLite::blob_t CompletionIndex::Create(const SQLiteIndex& index)
+    {
+        std::vector<std::pair<std::string, std::string>> keysAndValues;
+        for (const auto& field : s_CompletionIndexFields)
+        {
+            // An empty prefix matches every value of the field.
+            SearchRequest request;
+            request.Inclusions.emplace_back(PackageMatchFilter(field.first, MatchType::StartsWith, {}));
+
+            for (auto& match : index.Search(request).Matches)
+            {
+                std::string& value = match.second.Value;
+                if (!value.empty())
+                {
+                    std::string key = field.second + Utility::FoldCase(std::string_view{ value });
+                    keysAndValues.emplace_back(std::move(key), std::move(value));
+                }
+            }
+        }
+
+        std::sort(keysAndValues.begin(), keysAndValues.end());
+        keysAndValues.erase(std::unique(keysAndValues.begin(), keysAndValues.end()), keysAndValues.end());
+
+        std::vector<Entry> entries;
+        entries.reserve(keysAndValues.size());
+        std::string pool;
+
+        for (const auto& keyAndValue : keysAndValues)
+        {
+            Entry entry{};
+            entry.KeyOffset = static_cast<uint32_t>(pool.size());
+            entry.KeyLength = static_cast<uint32_t>(keyAndValue.first.size());
+            pool += keyAndValue.first;
+
+            // Values are often their folded key, in which case the string in the pool is shared.
+            if (keyAndValue.second == std::string_view{ keyAndValue.first }.substr(1))
+            {
+                entry.ValueOffset = entry.KeyOffset + 1;
+            }
+            else
+            {
+                entry.ValueOffset = static_cast<uint32_t>(pool.size());
+                pool += keyAndValue.second;
+            }
+
+            entry.ValueLength = static_cast<uint32_t>(keyAndValue.second.size());
+            entries.emplace_back(entry);
+        }
+
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_FILE_TOO_LARGE), pool.size() > std::numeric_limits<uint32_t>::max());
+
+        Header header{};
+        header.Magic = s_CompletionIndexMagic;
+        header.Version = s_CompletionIndexVersion;
+        header.EntryCount = static_cast<uint32_t>(entries.size());
+        header.PoolSize = static_cast<uint32_t>(pool.size());
+
+        SQLite::blob_t result(sizeof(Header) + entries.size() * sizeof(Entry) + pool.size());
+        uint8_t* current = result.data();
+        memcpy(current, &header, sizeof(Header));
+        current += sizeof(Header);
+
+        if (!entries.empty())
+        {
+            memcpy(current, entries.data(), entries.size() * sizeof(Entry));
+            current += entries.size() * sizeof(Entry);
+            memcpy(current, pool.data(), pool.size());
+        }
+
+        return result;
+    }
+
+    std::vector<std::string> CompletionIndex::GetValues(
+        const std::filesystem::path& completionIndexPath,
+        const std::filesystem::path& indexPath,
+        SQLiteIndex::OpenDisposition indexDisposition,
+        const std::vector<PackageMatchField>& fields,
+        std::string_view prefix)
+    {
+        auto indexStamp = GetIndexStamp(indexPath);
+
+        std::vector<std::string> result;
+        try
+        {
+            if (TryAddValuesFromFile(completionIndexPath, indexStamp, fields, prefix, result))
+            {
+                return result;
+            }
+        }
+        catch (...)
+        {
+            AICLI_LOG(Repo, Info, << "Failed to read the completion index " << completionIndexPath.u8string());
+        }
+
+        // Indexes packaged before the completion index was added do not hold one, so it is created from their values instead.
+        SQLiteIndex index = SQLiteIndex::Open(indexPath.u8string(), indexDisposition);
+        std::optional<SQLite::blob_t> contents = index.GetCompletionIndex();
+        if (!contents)
+        {
+            AICLI_LOG(Repo, Info, << "Creating completion index for " << indexPath.u8string());
+            contents = Create(index);
+        }
+
+        // Validate the contents before writing them, and record the index that they are written for.
+        CompletionIndexView completionIndex{ contents->data(), contents->size() };
+        Header* header = reinterpret_cast<Header*>(contents->data());
+        header->IndexSize = indexStamp.first;
+        header->IndexWriteTime = indexStamp.second;
+
+        try
+        {
+            WriteFile(completionIndexPath, contents.value());
+        }
+        catch (...)
+        {
+            AICLI_LOG(Repo, Info, << "Failed to write the completion index " << completionIndexPath.u8string());
+        }
+
+        result.clear();
+        AddValues(completionIndex, fields, prefix, result);
+        return result;
+    }
+}
@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "Microsoft/SQLiteIndex.h"
+#include <winget/RepositorySearch.h>
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace AppInstaller::Repository::Microsoft
+{
+    // A sorted array of the package identifiers, names and monikers of a pre-indexed source, along with a pool of their strings.
+    // PrepareForPackaging stores it in the index, and it is written to disk next to the index the first time that it is needed.
+    // Completing these values then only needs a binary search of the mapped file, rather than opening the index and the source.
+    // The file records the index that it was written for, and it is written again when that index changes.
+    struct CompletionIndex
+    {
+        // Determines whether the field is one that the completion index holds values for.
+        static bool SupportsField(PackageMatchField field);
+
+        // Creates the contents of a completion index from the values in the index.
+        static SQLite::blob_t Create(const SQLiteIndex& index);
+
+        // Gets the values of the given fields that start with the prefix, ignoring case, in the order of the fields.
+        // If the completion index at the given path is missing or does not match the index, it is written from the index first.
+        static std::vector<std::string> GetValues(
+            const std::filesystem::path& completionIndexPath,
+            const std::filesystem::path& indexPath,
+            SQLiteIndex::OpenDisposition indexDisposition,
+            const std::vector<PackageMatchField>& fields,
+            std::string_view prefix);
+    };
+}
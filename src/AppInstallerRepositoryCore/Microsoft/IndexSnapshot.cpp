@@ -0,0 +1,217 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "IndexSnapshot.h"
+#include "Microsoft/Schema/1_0/SearchResultsTable.h"
+#include <limits>
+
+namespace AppInstaller::Repository::Microsoft
+{
+    namespace
+    {
+        // The fields held by the snapshot; these are the one to one values of each manifest.
+        constexpr PackageMatchField s_IndexSnapshotFields[] = { PackageMatchField::Id, PackageMatchField::Name, PackageMatchField::Moniker };
+
+        bool IsSupportedField(PackageMatchField field)
+        {
+            return std::find(std::begin(s_IndexSnapshotFields), std::end(s_IndexSnapshotFields), field) != std::end(s_IndexSnapshotFields);
+        }
+
+        // The match types performed for the one requested, in the order that the index performs them.
+        std::vector<MatchType> GetMatchTypeOrder(MatchType type)
+        {
+            switch (type)
+            {
+            case MatchType::Exact:
+                return { MatchType::Exact };
+            case MatchType::CaseInsensitive:
+                return { MatchType::CaseInsensitive };
+            case MatchType::StartsWith:
+                return { MatchType::CaseInsensitive, MatchType::StartsWith };
+            default:
+                return {};
+            }
+        }
+
+        bool IsSupportedFilter(const PackageMatchFilter& filter)
+        {
+            return IsSupportedField(filter.Field) && !GetMatchTypeOrder(filter.Type).empty();
+        }
+    }
+
+    IndexSnapshot IndexSnapshot::Create(const GetFieldValues& getFieldValues)
+    {
+        IndexSnapshot result;
+
+        for (PackageMatchField field : s_IndexSnapshotFields)
+        {
+            std::optional<Schema::ISQLiteIndex::FieldValuesResult> values = getFieldValues(field);
+            if (!values)
+            {
+                continue;
+            }
+
+            // An id with many versions has the same value many times, but it only needs to be found once.
+            std::sort(values->begin(), values->end(), [](const auto& a, const auto& b) { return std::tie(a.second, a.first) < std::tie(b.second, b.first); });
+            values->erase(std::unique(values->begin(), values->end()), values->end());
+
+            std::vector<Entry> entries;
+            entries.reserve(values->size());
+
+            for (const auto& [id, value] : *values)
+            {
+                Entry entry{};
+                entry.Id = id;
+                entry.ValueLength = static_cast<uint32_t>(value.size());
+
+                // Sorted values are often repeated by consecutive ids, in which case the strings already in the pool are used.
+                if (!entries.empty() && result.GetValue(entries.back()) == value)
+                {
+                    entry.FoldedOffset = entries.back().FoldedOffset;
+                    entry.FoldedLength = entries.back().FoldedLength;
+                    entry.ValueOffset = entries.back().ValueOffset;
+                }
+                else
+                {
+                    // The index compares case insensitive values with the ICU LIKE, which folds each code point on its own.
+                    std::string folded = Utility::FoldCaseByCodePoint(value);
+                    THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_FILE_TOO_LARGE), result.m_pool.size() + value.size() + folded.size() > std::numeric_limits<uint32_t>::max());
+                    entry.FoldedLength = static_cast<uint32_t>(folded.size());
+
+                    entry.ValueOffset = static_cast<uint32_t>(result.m_pool.size());
+                    result.m_pool += value;
+
+                    // Most values are already folded, in which case the folded string is the value.
+                    if (folded == value)
+                    {
+                        entry.FoldedOffset = entry.ValueOffset;
+                    }
+                    else
+                    {
+                        entry.FoldedOffset = static_cast<uint32_t>(result.m_pool.size());
+                        result.m_pool += folded;
+                    }
+                }
+
+                entries.emplace_back(entry);
+            }
+
+            // The values were sorted as they are, so sort them again by their folded form for the lookups; ties keep their order.
+            std::stable_sort(entries.begin(), entries.end(), [&](const Entry& a, const Entry& b) { return result.GetFolded(a) < result.GetFolded(b); });
+
+            AICLI_LOG(Repo, Verbose, << "Index snapshot holds " << entries.size() << " values of " << ToString(field));
+            result.m_fields.emplace(field, std::move(entries));
+        }
+
+        return result;
+    }
+
+    bool IndexSnapshot::SupportsRequest(const SearchRequest& request)
+    {
+        // The index only starts from the first filter when there are no inclusions; later filters narrow the
+        // results in ways that the snapshot does not copy, so only a lone filter is supported.
+        if (request.Query)
+        {
+            return false;
+        }
+
+        if (!request.Inclusions.empty())
+        {
+            return request.Filters.empty() && std::all_of(request.Inclusions.begin(), request.Inclusions.end(), IsSupportedFilter);
+        }
+
+        return request.Filters.size() == 1 && IsSupportedFilter(request.Filters[0]);
+    }
+
+    bool IndexSnapshot::CanSearch(const SearchRequest& request) const
+    {
+        if (!SupportsRequest(request))
+        {
+            return false;
+        }
+
+        const auto& filters = request.Inclusions.empty() ? request.Filters : request.Inclusions;
+        return std::all_of(filters.begin(), filters.end(), [&](const PackageMatchFilter& filter) { return m_fields.count(filter.Field) != 0; });
+    }
+
+    Schema::ISQLiteIndex::SearchResult IndexSnapshot::Search(const SearchRequest& request) const
+    {
+        THROW_HR_IF(E_INVALIDARG, !CanSearch(request));
+
+        // Each match performed gets the next ordinal, as each search does in the index's results table, and is ranked the same way.
+        std::vector<std::tuple<int64_t, SQLite::rowid_t, PackageMatchFilter>> matches;
+        size_t ordinal = 0;
+
+        for (PackageMatchFilter filter : request.Inclusions.empty() ? request.Filters : request.Inclusions)
+        {
+            for (MatchType match : GetMatchTypeOrder(filter.Type))
+            {
+                filter.Type = match;
+                AddMatches(filter, Schema::V1_0::SearchResultsTable::GetSortValue(filter, ordinal++), matches);
+            }
+        }
+
+        // Keep only the best ranked match of each id, then order the ids by the match that found them.
+        std::stable_sort(matches.begin(), matches.end(), [](const auto& a, const auto& b) { return std::tie(std::get<1>(a), std::get<0>(a)) < std::tie(std::get<1>(b), std::get<0>(b)); });
+        matches.erase(std::unique(matches.begin(), matches.end(), [](const auto& a, const auto& b) { return std::get<1>(a) == std::get<1>(b); }), matches.end());
+        std::stable_sort(matches.begin(), matches.end(), [](const auto& a, const auto& b) { return std::tie(std::get<0>(a), std::get<1>(a)) < std::tie(std::get<0>(b), std::get<1>(b)); });
+
+        Schema::ISQLiteIndex::SearchResult result;
+
+        if (request.MaximumResults && matches.size() > request.MaximumResults)
+        {
+            matches.resize(request.MaximumResults);
+            result.Truncated = true;
+        }
+
+        result.Matches.reserve(matches.size());
+        for (auto& match : matches)
+        {
+            result.Matches.emplace_back(std::get<1>(match), std::move(std::get<2>(match)));
+        }
+
+        return result;
+    }
+
+    std::string_view IndexSnapshot::GetFolded(const Entry& entry) const
+    {
+        return std::string_view{ m_pool }.substr(entry.FoldedOffset, entry.FoldedLength);
+    }
+
+    std::string_view IndexSnapshot::GetValue(const Entry& entry) const
+    {
+        return std::string_view{ m_pool }.substr(entry.ValueOffset, entry.ValueLength);
+    }
+
+    void IndexSnapshot::AddMatches(const PackageMatchFilter& filter, int64_t sortValue, std::vector<std::tuple<int64_t, SQLite::rowid_t, PackageMatchFilter>>& results) const
+    {
+        const std::vector<Entry>& entries = m_fields.at(filter.Field);
+        std::string_view value = filter.Value;
+        std::string folded = Utility::FoldCaseByCodePoint(value);
+
+        auto begin = std::lower_bound(entries.begin(), entries.end(), folded, [&](const Entry& entry, const std::string& key) { return GetFolded(entry) < key; });
+        auto end = begin;
+
+        if (filter.Type == MatchType::StartsWith)
+        {
+            end = std::find_if(begin, entries.end(), [&](const Entry& entry) { return GetFolded(entry).substr(0, folded.size()) != folded; });
+        }
+        else
+        {
+            end = std::upper_bound(begin, entries.end(), folded, [&](const std::string& key, const Entry& entry) { return key < GetFolded(entry); });
+        }
+
+        for (auto itr = begin; itr != end; ++itr)
+        {
+            std::string_view entryValue = GetValue(*itr);
+
+            // The exact comparison is of the bytes of the values, where the others ignore case.
+            if (filter.Type == MatchType::Exact && entryValue != value)
+            {
+                continue;
+            }
+
+            results.emplace_back(sortValue, itr->Id, PackageMatchFilter{ filter.Field, filter.Type, Utility::NormalizedString{ entryValue } });
+        }
+    }
+}
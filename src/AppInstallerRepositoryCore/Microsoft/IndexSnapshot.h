@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "Microsoft/Schema/ISQLiteIndex.h"
+#include <winget/RepositorySearch.h>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace AppInstaller::Repository::Microsoft
+{
+    // An in memory copy of the values of the one to one fields of an immutable index, sorted with a pool of their strings.
+    // It answers the exact, case insensitive and prefix searches on those fields with the same results as the index would,
+    // using binary searches of the sorted values rather than queries; the index is left to answer every other search.
+    struct IndexSnapshot
+    {
+        // Gets all of the values of a field, or nullopt if the index does not search the field by value.
+        using GetFieldValues = std::function<std::optional<Schema::ISQLiteIndex::FieldValuesResult>(PackageMatchField)>;
+
+        // Creates the snapshot from the values of the fields that it supports.
+        static IndexSnapshot Create(const GetFieldValues& getFieldValues);
+
+        // Determines whether the request is one that a snapshot could answer, based on its shape alone.
+        static bool SupportsRequest(const SearchRequest& request);
+
+        // Determines whether this snapshot holds the values needed to answer the request.
+        bool CanSearch(const SearchRequest& request) const;
+
+        // Performs the search; the request must be one that CanSearch returns true for.
+        Schema::ISQLiteIndex::SearchResult Search(const SearchRequest& request) const;
+
+    private:
+        // A value in the pool, along with its folded form.
+        struct Entry
+        {
+            uint32_t FoldedOffset;
+            uint32_t FoldedLength;
+            uint32_t ValueOffset;
+            uint32_t ValueLength;
+            SQLite::rowid_t Id;
+        };
+
+        std::string_view GetFolded(const Entry& entry) const;
+        std::string_view GetValue(const Entry& entry) const;
+
+        // Adds the matches for the filter (with a single match type) to the results, with the given sort value.
+        void AddMatches(const PackageMatchFilter& filter, int64_t sortValue, std::vector<std::tuple<int64_t, SQLite::rowid_t, PackageMatchFilter>>& results) const;
+
+        std::string m_pool;
+        std::map<PackageMatchField, std::vector<Entry>> m_fields;
+    };
+}
@@ -0,0 +1,203 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Microsoft/InstalledSearchFilter.h"
+
+
+namespace AppInstaller::Repository::Microsoft
+{
+    namespace
+    {
+        // The index compares with LIKE, which folds each code point on its own, except for the system reference strings,
+        // which are stored folded as a whole. A value found either way is a substring of the candidate under that folding,
+        // so checking for both covers every match type that is accepted here.
+        bool IsSupportedMatchType(MatchType type)
+        {
+            switch (type)
+            {
+            case MatchType::Exact:
+            case MatchType::CaseInsensitive:
+            case MatchType::StartsWith:
+            case MatchType::Substring:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        bool IsSupportedField(PackageMatchField field)
+        {
+            switch (field)
+            {
+            case PackageMatchField::Id:
+            case PackageMatchField::Name:
+            case PackageMatchField::Moniker:
+            case PackageMatchField::Command:
+            case PackageMatchField::Tag:
+            case PackageMatchField::PackageFamilyName:
+            case PackageMatchField::ProductCode:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        // Calls the function with each of the values of the manifest that the index stores for the field, until it returns true.
+        template <typename Func>
+        bool AnyValue(const Manifest::Manifest& manifest, PackageMatchField field, Func&& func)
+        {
+            switch (field)
+            {
+            case PackageMatchField::Id:
+                return func(manifest.Id);
+            case PackageMatchField::Name:
+                return func(manifest.DefaultLocalization.Get<Manifest::Localization::PackageName>());
+            case PackageMatchField::Moniker:
+                return func(manifest.Moniker);
+            case PackageMatchField::Command:
+                for (const auto& command : manifest.GetAggregatedCommands())
+                {
+                    if (func(command))
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            case PackageMatchField::Tag:
+                for (const auto& tag : manifest.GetAggregatedTags())
+                {
+                    if (func(tag))
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            case PackageMatchField::PackageFamilyName:
+                for (const auto& installer : manifest.Installers)
+                {
+                    if (func(installer.PackageFamilyName))
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            case PackageMatchField::ProductCode:
+                for (const auto& installer : manifest.Installers)
+                {
+                    if (func(installer.ProductCode))
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            default:
+                THROW_HR(E_UNEXPECTED);
+            }
+        }
+    }
+
+    std::optional<InstalledSearchFilter> InstalledSearchFilter::Create(const SearchRequest& request)
+    {
+        if (request.IsForEverything())
+        {
+            return std::nullopt;
+        }
+
+        InstalledSearchFilter result;
+
+        auto makeMatch = [](PackageMatchField field, const RequestMatch& match)
+        {
+            return Match{ field, Utility::FoldCase(static_cast<std::string_view>(match.Value)), Utility::FoldCaseByCodePoint(match.Value) };
+        };
+
+        if (request.Query)
+        {
+            if (!IsSupportedMatchType(request.Query->Type))
+            {
+                return std::nullopt;
+            }
+
+            result.m_anyOf.emplace_back(makeMatch(PackageMatchField::Unknown, request.Query.value()));
+        }
+
+        for (const auto& inclusion : request.Inclusions)
+        {
+            if (!IsSupportedField(inclusion.Field) || !IsSupportedMatchType(inclusion.Type))
+            {
+                return std::nullopt;
+            }
+
+            result.m_anyOf.emplace_back(makeMatch(inclusion.Field, inclusion));
+        }
+
+        for (const auto& filter : request.Filters)
+        {
+            if (!IsSupportedField(filter.Field) || !IsSupportedMatchType(filter.Type))
+            {
+                return std::nullopt;
+            }
+
+            result.m_allOf.emplace_back(makeMatch(filter.Field, filter));
+        }
+
+        return result;
+    }
+
+    bool InstalledSearchFilter::CouldMatch(const Manifest::Manifest& manifest) const
+    {
+        for (const auto& match : m_allOf)
+        {
+            if (!CouldMatch(manifest, match))
+            {
+                return false;
+            }
+        }
+
+        if (m_anyOf.empty())
+        {
+            return true;
+        }
+
+        for (const auto& match : m_anyOf)
+        {
+            if (CouldMatch(manifest, match))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool InstalledSearchFilter::ExaminesField(PackageMatchField field) const
+    {
+        auto examines = [&](const Match& match) { return match.Field == field || match.Field == PackageMatchField::Unknown; };
+        return std::any_of(m_anyOf.begin(), m_anyOf.end(), examines) || std::any_of(m_allOf.begin(), m_allOf.end(), examines);
+    }
+
+    bool InstalledSearchFilter::CouldMatch(const Manifest::Manifest& manifest, const Match& match)
+    {
+        auto check = [&](std::string_view value)
+        {
+            return Utility::FoldCaseByCodePoint(value).find(match.FoldedByCodePointValue) != std::string::npos ||
+                Utility::FoldCase(value).find(match.FoldedValue) != std::string::npos;
+        };
+
+        if (match.Field != PackageMatchField::Unknown)
+        {
+            return AnyValue(manifest, match.Field, check);
+        }
+
+        // The fields that a query searches
+        for (auto field : { PackageMatchField::Id, PackageMatchField::Name, PackageMatchField::Moniker, PackageMatchField::Command,
+            PackageMatchField::Tag, PackageMatchField::PackageFamilyName, PackageMatchField::ProductCode })
+        {
+            if (AnyValue(manifest, field, check))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <winget/Manifest.h>
+#include <winget/RepositorySearch.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace AppInstaller::Repository::Microsoft
+{
+    // A conservative test of whether a search request could find an installed package, made before the package is indexed.
+    // Packages that fail the test can be left out of an index that will only be used to answer the request;
+    // packages that pass it may still not be found by the index.
+    struct InstalledSearchFilter
+    {
+        // Creates the filter for the request.
+        // Returns an empty value if the request cannot be tested ahead of the index, either because it is for everything
+        // or because it uses a field or match type that is not understood here.
+        static std::optional<InstalledSearchFilter> Create(const SearchRequest& request);
+
+        // Determines whether the request could find the package described by the manifest.
+        bool CouldMatch(const Manifest::Manifest& manifest) const;
+
+        // Determines whether the result of CouldMatch can depend on the given field of the manifest.
+        bool ExaminesField(PackageMatchField field) const;
+
+    private:
+        // A value folded both the ways that the index compares values.
+        struct Match
+        {
+            // The field to check; Unknown for the query, which is checked against every field that it searches.
+            PackageMatchField Field;
+            std::string FoldedValue;
+            std::string FoldedByCodePointValue;
+        };
+
+        InstalledSearchFilter() = default;
+
+        static bool CouldMatch(const Manifest::Manifest& manifest, const Match& match);
+
+        // At least one of these must match, unless there are none.
+        std::vector<Match> m_anyOf;
+        // All of these must match.
+        std::vector<Match> m_allOf;
+    };
+}
@@ -0,0 +1,180 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Microsoft/ManifestCache.h"
+#include <AppInstallerRuntime.h>
+#include <winget/MemoryTrim.h>
+#include <winget/ManifestYamlParser.h>
+
+using namespace std::chrono_literals;
+using namespace std::string_view_literals;
+
+namespace AppInstaller::Repository::Microsoft
+{
+    namespace
+    {
+        constexpr std::string_view s_ManifestCacheDirectory = "ManifestCache"sv;
+
+        // The number of parsed manifests kept in memory; the memory cache is emptied when it grows beyond this.
+        constexpr size_t s_MaximumManifestsInMemory = 1000;
+
+        // Entries on disk that have not been used in this long are removed.
+        constexpr auto s_MaximumEntryAge = 24h * 30;
+    }
+
+    ManifestCache::ManifestCache(std::filesystem::path directory) : m_directory(std::move(directory)) {}
+
+    ManifestCache& ManifestCache::GetDefault()
+    {
+        static ManifestCache s_cache{ Runtime::GetPathTo(Runtime::PathName::LocalState) / s_ManifestCacheDirectory };
+        static std::once_flag s_trimOnce;
+        std::call_once(s_trimOnce, []()
+            {
+                s_cache.Trim();
+                Memory::RegisterTrimFunction([]() { s_cache.ReleaseMemory(); });
+            });
+        return s_cache;
+    }
+
+    std::optional<Manifest::Manifest> ManifestCache::Get(const Utility::SHA256::HashBuffer& hash)
+    {
+        std::string key = Utility::SHA256::ConvertToString(hash);
+
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+            auto itr = m_manifests.find(key);
+            if (itr != m_manifests.end())
+            {
+                return itr->second;
+            }
+        }
+
+        if (m_directory.empty())
+        {
+            return {};
+        }
+
+        try
+        {
+            std::filesystem::path entryPath = GetEntryPath(key);
+            std::ifstream stream{ entryPath, std::ios_base::in | std::ios_base::binary };
+            if (!stream)
+            {
+                return {};
+            }
+
+            std::string contents{ std::istreambuf_iterator<char>{ stream }, std::istreambuf_iterator<char>{} };
+            stream.close();
+
+            // The entry is only used if it is still the manifest that the index refers to.
+            if (!Utility::SHA256::AreEqual(hash, Utility::SHA256::ComputeHash(contents)))
+            {
+                AICLI_LOG(Repo, Info, << "Manifest cache entry does not match its hash: " << key);
+                return {};
+            }
+
+            AICLI_LOG(Repo, Verbose, << "Using manifest from cache: " << key);
+            Manifest::Manifest result = Manifest::YamlParser::Create(contents);
+
+            // Mark the entry as used so that it is not trimmed.
+            std::filesystem::last_write_time(entryPath, std::filesystem::file_time_type::clock::now());
+
+            Add(hash, result);
+            return result;
+        }
+        catch (...)
+        {
+            AICLI_LOG(Repo, Info, << "Failed to read manifest cache entry " << key);
+        }
+
+        return {};
+    }
+
+    void ManifestCache::Add(const Utility::SHA256::HashBuffer& hash, const Manifest::Manifest& manifest, std::string_view contents)
+    {
+        std::string key = Utility::SHA256::ConvertToString(hash);
+
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+
+            if (m_manifests.size() >= s_MaximumManifestsInMemory)
+            {
+                m_manifests.clear();
+            }
+
+            m_manifests.insert_or_assign(key, manifest);
+        }
+
+        if (m_directory.empty() || contents.empty())
+        {
+            return;
+        }
+
+        try
+        {
+            std::filesystem::create_directories(m_directory);
+
+            // Write to a temporary file and move it into place, so that a reader never sees a partial entry.
+            std::filesystem::path entryPath = GetEntryPath(key);
+            std::filesystem::path tempPath = entryPath;
+            tempPath += L"." + std::to_wstring(GetCurrentProcessId()) + L"." + std::to_wstring(GetCurrentThreadId()) + L".tmp";
+
+            {
+                std::ofstream stream{ tempPath, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary };
+                stream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+            }
+
+            std::filesystem::rename(tempPath, entryPath);
+        }
+        catch (...)
+        {
+            AICLI_LOG(Repo, Info, << "Failed to write manifest cache entry " << key);
+        }
+    }
+
+    void ManifestCache::Trim() const
+    {
+        if (m_directory.empty())
+        {
+            return;
+        }
+
+        try
+        {
+            if (!std::filesystem::is_directory(m_directory))
+            {
+                return;
+            }
+
+            auto oldest = std::filesystem::file_time_type::clock::now() - s_MaximumEntryAge;
+
+            for (const auto& entry : std::filesystem::directory_iterator{ m_directory })
+            {
+                std::error_code error;
+                if (entry.is_regular_file(error) && entry.last_write_time(error) < oldest && !error)
+                {
+                    std::filesystem::remove(entry.path(), error);
+                }
+            }
+        }
+        catch (...)
+        {
+            AICLI_LOG(Repo, Info, << "Failed to trim the manifest cache");
+        }
+    }
+
+    void ManifestCache::ReleaseMemory()
+    {
+        std::map<std::string, Manifest::Manifest> released;
+
+        std::lock_guard<std::mutex> lock{ m_lock };
+        released.swap(m_manifests);
+    }
+
+    std::filesystem::path ManifestCache::GetEntryPath(const std::string& key) const
+    {
+        std::filesystem::path result = m_directory;
+        result /= key + ".yaml";
+        return result;
+    }
+}
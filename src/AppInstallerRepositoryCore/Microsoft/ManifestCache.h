@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <AppInstallerSHA256.h>
+#include <winget/Manifest.h>
+
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace AppInstaller::Repository::Microsoft
+{
+    // A cache of the manifests of a pre-indexed source, keyed by the SHA256 hash that the index holds for them.
+    // Parsed manifests are kept for the lifetime of the process; the contents of downloaded manifests are also
+    // kept on disk, so that later runs do not download them again while they are unchanged.
+    // Failures to read or write the disk are logged and otherwise ignored, as the cache is only an optimization.
+    struct ManifestCache
+    {
+        // An empty directory keeps the cache in memory only.
+        ManifestCache(std::filesystem::path directory = {});
+
+        ManifestCache(const ManifestCache&) = delete;
+        ManifestCache& operator=(const ManifestCache&) = delete;
+
+        // Gets the cache shared by all sources, which is kept on disk in the local state directory.
+        static ManifestCache& GetDefault();
+
+        // Gets the manifest with the given hash, if it is cached.
+        std::optional<Manifest::Manifest> Get(const Utility::SHA256::HashBuffer& hash);
+
+        // Adds the manifest with the given hash. When contents are given, they are also written to disk.
+        void Add(const Utility::SHA256::HashBuffer& hash, const Manifest::Manifest& manifest, std::string_view contents = {});
+
+        // Removes the entries on disk that have not been used for some time.
+        void Trim() const;
+
+        // Releases the parsed manifests held in memory; those that are on disk are read again when they are next used.
+        void ReleaseMemory();
+
+    private:
+        std::filesystem::path GetEntryPath(const std::string& key) const;
+
+        std::filesystem::path m_directory;
+        std::mutex m_lock;
+        std::map<std::string, Manifest::Manifest> m_manifests;
+    };
+}
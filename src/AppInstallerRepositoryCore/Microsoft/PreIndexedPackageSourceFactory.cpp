@@ -2,8 +2,10 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "Microsoft/PreIndexedPackageSourceFactory.h"
+#include "Microsoft/CompletionIndex.h"
 #include "Microsoft/SQLiteIndex.h"
 #include "Microsoft/SQLiteIndexSource.h"
+#include "Microsoft/ShardedIndexSource.h"
 
 #include <AppInstallerDeployment.h>
 #include <AppInstallerMsixInfo.h>
@@ -18,8 +20,14 @@ namespace AppInstaller::Repository::Microsoft
         static constexpr std::string_view s_PreIndexedPackageSourceFactory_PackageFileName = "source.msix"sv;
         static constexpr std::string_view s_PreIndexedPackageSourceFactory_AppxManifestFileName = "AppxManifest.xml"sv;
         static constexpr std::string_view s_PreIndexedPackageSourceFactory_IndexFileName = "index.db"sv;
+        static constexpr std::string_view s_PreIndexedPackageSourceFactory_ValidatorFileName = "source.validator"sv;
+        static constexpr std::string_view s_PreIndexedPackageSourceFactory_CompletionIndexFileName = "completion.idx"sv;
+        static constexpr std::string_view s_PreIndexedPackageSourceFactory_ExtractedIndexFileName = "extracted.current"sv;
+        static constexpr std::string_view s_PreIndexedPackageSourceFactory_ExtractedIndexDirectory = "Extracted"sv;
+        static constexpr std::string_view s_PreIndexedPackageSourceFactory_ExtractedIndexHashStreamPrefix = "preindexed_extracted_"sv;
         // TODO: This being hard coded to force using the Public directory name is not ideal.
         static constexpr std::string_view s_PreIndexedPackageSourceFactory_IndexFilePath = "Public\\index.db"sv;
+        static constexpr std::string_view s_PreIndexedPackageSourceFactory_IndexDirectory = "Public"sv;
 
         // Construct the package location from the given details.
         // Currently expects that the arg is an https uri pointing to the root of the data.
@@ -49,6 +57,399 @@ namespace AppInstaller::Repository::Microsoft
             return "PreIndexedSourceCPRWL_"s + GetPackageFamilyNameFromDetails(details);
         }
 
+        // Creates a name for the cross process lock that an update of the source holds from start to finish, given the details.
+        // It keeps updates from running at the same time, so that preparing one only needs to keep readers out once it is committed.
+        std::string CreateNameForUpdateLock(const SourceDetails& details)
+        {
+            return "PreIndexedSourceUpdate_"s + GetPackageFamilyNameFromDetails(details);
+        }
+
+        // Constructs the location that we will write files to.
+        std::filesystem::path GetStatePathFromDetails(const SourceDetails& details)
+        {
+            std::filesystem::path result = Runtime::GetPathTo(Runtime::PathName::LocalState);
+            result /= PreIndexedPackageSourceFactory::Type();
+            result /= GetPackageFamilyNameFromDetails(details);
+            return result;
+        }
+
+        // The file holding the validator of the package that the source data was last checked against.
+        // *Should only be used when under the update lock*
+        std::filesystem::path GetValidatorPathFromDetails(const SourceDetails& details)
+        {
+            return GetStatePathFromDetails(details) / s_PreIndexedPackageSourceFactory_ValidatorFileName;
+        }
+
+        // The file holding the completion index built from the source data.
+        // *Should only be used when under a CrossProcessReaderWriteLock*
+        std::filesystem::path GetCompletionIndexPathFromDetails(const SourceDetails& details)
+        {
+            return GetStatePathFromDetails(details) / s_PreIndexedPackageSourceFactory_CompletionIndexFileName;
+        }
+
+        std::string ReadValidator(const SourceDetails& details)
+        {
+            std::ifstream stream{ GetValidatorPathFromDetails(details), std::ios_base::in | std::ios_base::binary };
+            std::string result;
+            std::getline(stream, result);
+            return result;
+        }
+
+        void WriteValidator(const SourceDetails& details, const std::string& validator)
+        {
+            try
+            {
+                std::filesystem::path validatorPath = GetValidatorPathFromDetails(details);
+
+                if (validator.empty())
+                {
+                    std::filesystem::remove(validatorPath);
+                }
+                else
+                {
+                    std::filesystem::create_directories(validatorPath.parent_path());
+                    std::ofstream stream{ validatorPath, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary };
+                    stream << validator;
+                }
+            }
+            CATCH_LOG();
+        }
+
+        // The directory holding a directory for each version of the package that the index was extracted from.
+        std::filesystem::path GetExtractedIndexRootFromDetails(const SourceDetails& details)
+        {
+            return GetStatePathFromDetails(details) / s_PreIndexedPackageSourceFactory_ExtractedIndexDirectory;
+        }
+
+        // Gets the directory of the index that the last update extracted from the package, if it was extracted rather
+        // than registered with the package.
+        // *Should only be called when under a CrossProcessReaderWriteLock*
+        std::optional<std::filesystem::path> GetExtractedIndexDirectory(const SourceDetails& details)
+        {
+            std::ifstream stream{ GetStatePathFromDetails(details) / s_PreIndexedPackageSourceFactory_ExtractedIndexFileName, std::ios_base::in | std::ios_base::binary };
+            std::string name;
+            std::getline(stream, name);
+
+            if (name.empty())
+            {
+                return {};
+            }
+
+            std::filesystem::path result = GetExtractedIndexRootFromDetails(details) / Utility::ConvertToUTF16(name);
+            if (!std::filesystem::exists(result))
+            {
+                AICLI_LOG(Repo, Warning, << "Extracted index directory not found: " << result.u8string());
+                return {};
+            }
+
+            return result;
+        }
+
+        // The name of the secure settings stream holding the hash of the index that the last update extracted. Unlike the
+        // registered package, the extracted files can be written by the user; the hash of a secure stream is kept where the
+        // user cannot write, so the record cannot be changed to match files that were.
+        std::string GetExtractedIndexHashStreamName(const SourceDetails& details)
+        {
+            return std::string{ s_PreIndexedPackageSourceFactory_ExtractedIndexHashStreamPrefix } + GetPackageFamilyNameFromDetails(details);
+        }
+
+        // Computes a hash of the relative path and contents of every file in the extracted index directory.
+        Utility::SHA256::HashBuffer ComputeExtractedIndexHash(const std::filesystem::path& directory)
+        {
+            std::vector<std::filesystem::path> files;
+            for (const auto& entry : std::filesystem::recursive_directory_iterator{ directory })
+            {
+                if (entry.is_regular_file())
+                {
+                    files.emplace_back(std::filesystem::relative(entry.path(), directory));
+                }
+            }
+
+            // The order of a directory iteration is not specified.
+            std::sort(files.begin(), files.end());
+
+            Utility::SHA256 hash;
+            for (const auto& file : files)
+            {
+                // The terminating null separates the path from the hash that follows it.
+                std::string relativePath = file.u8string();
+                hash.Add(reinterpret_cast<const uint8_t*>(relativePath.c_str()), relativePath.size() + 1);
+                hash.Add(Utility::SHA256::ComputeHashFromFile(directory / file));
+            }
+
+            return hash.Get();
+        }
+
+        // Records the name and hash of the extracted index directory that readers are about to use.
+        // *Should only be called when under an exclusive CrossProcessReaderWriteLock*
+        void WriteExtractedIndexHash(const SourceDetails& details, const std::string& name, const Utility::SHA256::HashBuffer& hash)
+        {
+            std::string streamName = GetExtractedIndexHashStreamName(details);
+            Settings::Stream stream{ Settings::StreamDefinition{ Settings::Type::Secure, streamName } };
+            THROW_HR_IF(E_UNEXPECTED, !stream.Set(name + '\n' + Utility::SHA256::ConvertToString(hash)));
+        }
+
+        // Removes the record of the extracted index directory.
+        void RemoveExtractedIndexHash(const SourceDetails& details)
+        {
+            try
+            {
+                std::string streamName = GetExtractedIndexHashStreamName(details);
+                Settings::Stream{ Settings::StreamDefinition{ Settings::Type::Secure, streamName } }.Remove();
+            }
+            CATCH_LOG();
+        }
+
+        // Determines whether the extracted index directory is the one that was recorded, with the same files that it had
+        // when its package signature was verified.
+        // *Should only be called when under a CrossProcessReaderWriteLock*
+        bool VerifyExtractedIndex(const SourceDetails& details, const std::filesystem::path& directory)
+        {
+            try
+            {
+                std::string streamName = GetExtractedIndexHashStreamName(details);
+                Settings::Stream stream{ Settings::StreamDefinition{ Settings::Type::Secure, streamName } };
+
+                // Reading a secure stream fails if it does not match the hash that the user cannot write.
+                auto record = stream.Get();
+                if (!record)
+                {
+                    AICLI_LOG(Repo, Error, << "No record of the extracted index was found");
+                    return false;
+                }
+
+                std::string name;
+                std::string hash;
+                std::getline(*record, name);
+                std::getline(*record, hash);
+
+                if (name != directory.filename().u8string())
+                {
+                    AICLI_LOG(Repo, Error, << "The extracted index is not the one that was recorded: " << name);
+                    return false;
+                }
+
+                if (!Utility::SHA256::AreEqual(Utility::SHA256::ConvertToBytes(hash), ComputeExtractedIndexHash(directory)))
+                {
+                    AICLI_LOG(Repo, Error, << "The files of the extracted index have changed since it was extracted");
+                    return false;
+                }
+
+                return true;
+            }
+            catch (...)
+            {
+                LOG_CAUGHT_EXCEPTION_MSG("Failed to verify the extracted index");
+                return false;
+            }
+        }
+
+        // Sets the directory of the index that readers use, removing the ones of other versions; an empty name goes back
+        // to the index of the registered package.
+        // *Should only be called when under an exclusive CrossProcessReaderWriteLock*
+        void SetExtractedIndexDirectory(const SourceDetails& details, const std::string& name)
+        {
+            std::filesystem::path pointerPath = GetStatePathFromDetails(details) / s_PreIndexedPackageSourceFactory_ExtractedIndexFileName;
+            std::filesystem::path root = GetExtractedIndexRootFromDetails(details);
+
+            if (name.empty())
+            {
+                std::error_code error;
+                std::filesystem::remove(pointerPath, error);
+                std::filesystem::remove_all(root, error);
+                RemoveExtractedIndexHash(details);
+                return;
+            }
+
+            {
+                std::ofstream stream{ pointerPath, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary };
+                stream << name;
+                THROW_HR_IF(E_FAIL, !stream);
+            }
+
+            try
+            {
+                std::filesystem::path current = root / Utility::ConvertToUTF16(name);
+
+                for (const auto& entry : std::filesystem::directory_iterator{ root })
+                {
+                    if (entry.path() != current)
+                    {
+                        std::filesystem::remove_all(entry.path());
+                    }
+                }
+            }
+            CATCH_LOG();
+        }
+
+        // Gets the path of a file in the index directory of the package.
+        std::string GetIndexDirectoryFilePath(std::string_view fileName)
+        {
+            std::string result{ s_PreIndexedPackageSourceFactory_IndexDirectory };
+            result += '\\';
+            result += fileName;
+            return result;
+        }
+
+        // The files of an update that are written next to the ones that readers use, while the readers can still use them.
+        // Committing the update moves the staged files over their targets, which needs the exclusive lock; any that are
+        // not committed are removed.
+        struct StagedFiles
+        {
+            StagedFiles() = default;
+
+            StagedFiles(const StagedFiles&) = delete;
+            StagedFiles& operator=(const StagedFiles&) = delete;
+
+            StagedFiles(StagedFiles&&) = delete;
+            StagedFiles& operator=(StagedFiles&&) = delete;
+
+            ~StagedFiles()
+            {
+                for (const auto& file : m_files)
+                {
+                    std::error_code error;
+                    std::filesystem::remove(file.first, error);
+                }
+            }
+
+            // Gets the path to write the new version of the target to. The staged files are moved in the order they were
+            // staged, so the file that readers look at first should be staged last; one that is not written is skipped.
+            std::filesystem::path Stage(const std::filesystem::path& target)
+            {
+                std::filesystem::path staged = target;
+                staged += ".staged";
+                m_files.emplace_back(staged, target);
+                return staged;
+            }
+
+            // Removes the file when the update is committed, once the staged files are moved.
+            void RemoveOnCommit(const std::filesystem::path& path)
+            {
+                m_removals.emplace_back(path);
+            }
+
+            // *Should only be called when under an exclusive CrossProcessReaderWriteLock*
+            void Commit()
+            {
+                for (const auto& file : m_files)
+                {
+                    if (std::filesystem::exists(file.first))
+                    {
+                        std::filesystem::rename(file.first, file.second);
+                    }
+                }
+                m_files.clear();
+
+                for (const auto& path : m_removals)
+                {
+                    std::error_code error;
+                    std::filesystem::remove(path, error);
+                }
+                m_removals.clear();
+            }
+
+        private:
+            std::vector<std::pair<std::filesystem::path, std::filesystem::path>> m_files;
+            std::vector<std::filesystem::path> m_removals;
+        };
+
+        // Determines whether the directory holds a sharded index rather than a single one.
+        bool IsShardedIndex(const std::filesystem::path& directory)
+        {
+            return std::filesystem::exists(directory / s_ShardedIndexManifestFileName);
+        }
+
+        // Opens the index in the directory, which is either a single index or the shards described by its sharded index manifest.
+        std::shared_ptr<ISource> OpenIndexSource(const SourceDetails& details, const std::filesystem::path& directory, SQLiteIndex::OpenDisposition disposition, Synchronization::CrossProcessReaderWriteLock&& lock)
+        {
+            if (IsShardedIndex(directory))
+            {
+                std::vector<SQLiteIndex> shards;
+                for (const auto& shard : ReadShardedIndexManifest(directory / s_ShardedIndexManifestFileName))
+                {
+                    shards.emplace_back(SQLiteIndex::Open((directory / shard).u8string(), disposition));
+                }
+
+                AICLI_LOG(Repo, Info, << "Opened sharded index with " << shards.size() << " shards for: " << details.Name);
+                return std::make_shared<ShardedIndexSource>(details, std::move(shards), std::move(lock));
+            }
+
+            std::filesystem::path indexPath = directory / s_PreIndexedPackageSourceFactory_IndexFileName;
+            if (!std::filesystem::exists(indexPath))
+            {
+                AICLI_LOG(Repo, Info, << "Data not found at " << indexPath);
+                THROW_HR(APPINSTALLER_CLI_ERROR_SOURCE_DATA_MISSING);
+            }
+
+            SQLiteIndex index = SQLiteIndex::Open(indexPath.u8string(), disposition);
+            return std::make_shared<SQLiteIndexSource>(details, std::move(index), std::move(lock));
+        }
+
+        // Stages the shards described by the sharded index manifest in the package for the directory, updating from the
+        // existing shards so that only the blocks of the shards that changed are read. Shards that are no longer in the
+        // manifest are removed on commit, and the manifest itself is staged last.
+        bool UpdateShardedIndex(Msix::MsixInfo& packageInfo, const std::filesystem::path& directory, StagedFiles& staged, IProgressCallback& progress)
+        {
+            std::filesystem::path manifestPath = directory / s_ShardedIndexManifestFileName;
+            std::filesystem::path newManifestPath = manifestPath;
+            newManifestPath += ".new";
+            auto removeNewManifest = wil::scope_exit([&]() { std::error_code error; std::filesystem::remove(newManifestPath, error); });
+
+            packageInfo.WriteToFile(GetIndexDirectoryFilePath(s_ShardedIndexManifestFileName), newManifestPath, progress);
+            std::vector<std::string> shards = ReadShardedIndexManifest(newManifestPath);
+
+            for (const auto& shard : shards)
+            {
+                std::string packageFile = GetIndexDirectoryFilePath(shard);
+                std::filesystem::path shardPath = directory / shard;
+                std::filesystem::path stagedShardPath = staged.Stage(shardPath);
+
+                bool shardUpdated = false;
+                try
+                {
+                    shardUpdated = packageInfo.UpdateFile(packageFile, shardPath, stagedShardPath, progress);
+                }
+                catch (...)
+                {
+                    LOG_CAUGHT_EXCEPTION_MSG("Failed to update the existing shard %hs, it will be written in full", shard.c_str());
+                }
+
+                if (progress.IsCancelled())
+                {
+                    AICLI_LOG(Repo, Info, << "Cancelling update upon request");
+                    return false;
+                }
+
+                if (!shardUpdated)
+                {
+                    packageInfo.WriteToFile(packageFile, stagedShardPath, progress);
+                }
+            }
+
+            if (std::filesystem::exists(manifestPath))
+            {
+                try
+                {
+                    for (const auto& oldShard : ReadShardedIndexManifest(manifestPath))
+                    {
+                        if (std::find(shards.begin(), shards.end(), oldShard) == shards.end())
+                        {
+                            staged.RemoveOnCommit(directory / oldShard);
+                        }
+                    }
+                }
+                CATCH_LOG();
+            }
+
+            std::filesystem::rename(newManifestPath, staged.Stage(manifestPath));
+
+            // A single index from before the source was sharded is no longer used.
+            staged.RemoveOnCommit(directory / s_PreIndexedPackageSourceFactory_IndexFileName);
+
+            return true;
+        }
+
         // The base class for a package that comes from a preindexed packaged source.
         struct PreIndexedFactoryBase : public ISourceFactory
         {
@@ -90,13 +491,13 @@ namespace AppInstaller::Repository::Microsoft
                 details.Data = Msix::GetPackageFamilyNameFromFullName(fullName);
                 details.Identifier = Msix::GetPackageFamilyNameFromFullName(fullName);
 
-                auto lock = LockExclusive(details, progress);
-                if (!lock)
+                auto updateLock = LockForUpdate(details, progress);
+                if (!updateLock)
                 {
                     return false;
                 }
 
-                return UpdateInternal(packageLocation, packageInfo, details, progress);
+                return UpdateInternal(packageLocation, packageInfo, details, progress, [&]() { return LockExclusive(details, progress); });
             }
 
             bool Update(const SourceDetails& details, IProgressCallback& progress) override final
@@ -109,17 +510,33 @@ namespace AppInstaller::Repository::Microsoft
                 return UpdateBase(details, true, progress);
             }
 
-            virtual bool UpdateInternal(const std::string& packageLocation, Msix::MsixInfo& packageInfo, const SourceDetails& details, IProgressCallback& progress) = 0;
+            // Takes the exclusive lock that keeps readers out of the source; an empty lock means that the update cannot be committed.
+            using CommitLock = std::function<Synchronization::CrossProcessReaderWriteLock()>;
+
+            // Called under the update lock; the update is prepared without keeping readers out of the source, and the
+            // commit lock is only taken for the changes that readers would see.
+            virtual bool UpdateInternal(const std::string& packageLocation, Msix::MsixInfo& packageInfo, const SourceDetails& details, IProgressCallback& progress, const CommitLock& lockForCommit) = 0;
 
             bool Remove(const SourceDetails& details, IProgressCallback& progress) override final
             {
                 THROW_HR_IF(E_INVALIDARG, details.Type != PreIndexedPackageSourceFactory::Type());
+                auto updateLock = LockForUpdate(details, progress);
+                if (!updateLock)
+                {
+                    return false;
+                }
+
                 auto lock = LockExclusive(details, progress);
                 if (!lock)
                 {
                     return false;
                 }
 
+                WriteValidator(details, {});
+
+                std::error_code error;
+                std::filesystem::remove(GetCompletionIndexPathFromDetails(details), error);
+
                 return RemoveInternal(details, progress);
             }
 
@@ -139,11 +556,48 @@ namespace AppInstaller::Repository::Microsoft
                 }
             }
 
+            Synchronization::CrossProcessReaderWriteLock LockForUpdate(const SourceDetails& details, IProgressCallback& progress, bool isBackground = false)
+            {
+                if (isBackground)
+                {
+                    // If this is a background update, don't wait for another update to finish.
+                    return Synchronization::CrossProcessReaderWriteLock::LockExclusive(CreateNameForUpdateLock(details), 0ms);
+                }
+                else
+                {
+                    return Synchronization::CrossProcessReaderWriteLock::LockExclusive(CreateNameForUpdateLock(details), progress);
+                }
+            }
+
             bool UpdateBase(const SourceDetails& details, bool isBackground, IProgressCallback& progress)
             {
                 THROW_HR_IF(E_INVALIDARG, details.Type != PreIndexedPackageSourceFactory::Type());
 
                 std::string packageLocation = GetPackageLocation(details);
+
+                // A request for only the first byte of the package tells whether it changed since it was last checked.
+                std::string validator;
+                if (Utility::IsUrlRemote(packageLocation))
+                {
+                    try
+                    {
+                        validator = Utility::GetContentValidator(packageLocation);
+                    }
+                    CATCH_LOG();
+                }
+
+                auto updateLock = LockForUpdate(details, progress, isBackground);
+                if (!updateLock)
+                {
+                    return false;
+                }
+
+                if (!validator.empty() && validator == ReadValidator(details))
+                {
+                    AICLI_LOG(Repo, Info, << "Remote source package has not changed since it was last checked, no update needed");
+                    return true;
+                }
+
                 Msix::MsixInfo packageInfo(packageLocation);
 
                 // The package should not be a bundle
@@ -159,13 +613,13 @@ namespace AppInstaller::Repository::Microsoft
                     return false;
                 }
 
-                auto lock = LockExclusive(details, progress, isBackground);
-                if (!lock)
+                if (!UpdateInternal(packageLocation, packageInfo, details, progress, [&]() { return LockExclusive(details, progress, isBackground); }))
                 {
                     return false;
                 }
 
-                return UpdateInternal(packageLocation, packageInfo, details, progress);
+                WriteValidator(details, validator);
+                return true;
             }
         };
 
@@ -198,28 +652,74 @@ namespace AppInstaller::Repository::Microsoft
                     return {};
                 }
 
-                auto extension = GetExtensionFromDetails(m_details);
-                if (!extension)
+                // The signature of an extracted index was verified when it was extracted; its files are checked against
+                // the hash recorded then, as the registered package is checked against its signature.
+                std::filesystem::path indexDirectory;
+                if (auto extracted = GetExtractedIndexDirectory(m_details))
                 {
-                    AICLI_LOG(Repo, Info, << "Package not found " << m_details.Data);
-                    THROW_HR(APPINSTALLER_CLI_ERROR_SOURCE_DATA_MISSING);
+                    THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_NEEDS_REMEDIATION), !VerifyExtractedIndex(m_details, extracted.value()));
+                    indexDirectory = std::move(extracted).value();
                 }
+                else
+                {
+                    auto extension = GetExtensionFromDetails(m_details);
+                    if (!extension)
+                    {
+                        AICLI_LOG(Repo, Info, << "Package not found " << m_details.Data);
+                        THROW_HR(APPINSTALLER_CLI_ERROR_SOURCE_DATA_MISSING);
+                    }
 
-                THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_NEEDS_REMEDIATION), !extension->VerifyContentIntegrity(progress));
-
-                // To work around an issue with accessing the public folder, we are temporarily
-                // constructing the location ourself.  This was already the case for the non-packaged
-                // runtime, and we can fix both in the future.  The only problem with this is that
-                // the directory in the extension *must* be Public, rather than one set by the creator.
-                std::filesystem::path indexLocation = extension->GetPackagePath();
-                indexLocation /= s_PreIndexedPackageSourceFactory_IndexFilePath;
+                    THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_NEEDS_REMEDIATION), !extension->VerifyContentIntegrity(progress));
 
-                SQLiteIndex index = SQLiteIndex::Open(indexLocation.u8string(), SQLiteIndex::OpenDisposition::Immutable);
+                    // To work around an issue with accessing the public folder, we are temporarily
+                    // constructing the location ourself.  This was already the case for the non-packaged
+                    // runtime, and we can fix both in the future.  The only problem with this is that
+                    // the directory in the extension *must* be Public, rather than one set by the creator.
+                    indexDirectory = extension->GetPackagePath();
+                    indexDirectory /= s_PreIndexedPackageSourceFactory_IndexDirectory;
+                }
 
                 // We didn't use to store the source identifier, so we compute it here in case it's
                 // missing from the details.
                 m_details.Identifier = GetPackageFamilyNameFromDetails(m_details);
-                return std::make_shared<SQLiteIndexSource>(m_details, std::move(index), std::move(lock));
+                return OpenIndexSource(m_details, indexDirectory, SQLiteIndex::OpenDisposition::Immutable, std::move(lock));
+            }
+
+            std::optional<std::vector<std::string>> GetCompletionValues(const std::vector<PackageMatchField>& fields, std::string_view prefix) override
+            {
+                if (!std::all_of(fields.begin(), fields.end(), CompletionIndex::SupportsField))
+                {
+                    return {};
+                }
+
+                auto lock = Synchronization::CrossProcessReaderWriteLock::LockShared(CreateNameForCPRWL(m_details));
+
+                std::filesystem::path indexDirectory;
+                if (auto extracted = GetExtractedIndexDirectory(m_details))
+                {
+                    indexDirectory = std::move(extracted).value();
+                }
+                else
+                {
+                    auto extension = GetExtensionFromDetails(m_details);
+                    if (!extension)
+                    {
+                        return {};
+                    }
+
+                    indexDirectory = extension->GetPackagePath() / s_PreIndexedPackageSourceFactory_IndexDirectory;
+                }
+
+                // The completion index is built from a single index; a sharded one is left to be searched.
+                if (IsShardedIndex(indexDirectory))
+                {
+                    return {};
+                }
+
+                // The package location cannot be written to, so the completion index is kept in the state location instead.
+                std::filesystem::path indexLocation = indexDirectory / s_PreIndexedPackageSourceFactory_IndexFileName;
+
+                return CompletionIndex::GetValues(GetCompletionIndexPathFromDetails(m_details), indexLocation, SQLiteIndex::OpenDisposition::Immutable, fields, prefix);
             }
 
         private:
@@ -234,12 +734,19 @@ namespace AppInstaller::Repository::Microsoft
                 return std::make_shared<PackagedContextSourceReference>(details);
             }
 
-            bool UpdateInternal(const std::string& packageLocation, Msix::MsixInfo& packageInfo, const SourceDetails& details, IProgressCallback& progress) override
+            bool UpdateInternal(const std::string& packageLocation, Msix::MsixInfo& packageInfo, const SourceDetails& details, IProgressCallback& progress, const CommitLock& lockForCommit) override
             {
                 // Check if the package is newer before calling into deployment.
                 // This can save us a lot of time over letting deployment detect same version.
-                auto extension = GetExtensionFromDetails(details);
-                if (extension)
+                if (auto extracted = GetExtractedIndexDirectory(details))
+                {
+                    if (!packageInfo.IsNewerThan(*extracted / s_PreIndexedPackageSourceFactory_AppxManifestFileName))
+                    {
+                        AICLI_LOG(Repo, Info, << "Remote source data was not newer than the extracted index, no update needed");
+                        return true;
+                    }
+                }
+                else if (auto extension = GetExtensionFromDetails(details))
                 {
                     if (!packageInfo.IsNewerThan(extension->GetPackageVersion()))
                     {
@@ -259,6 +766,7 @@ namespace AppInstaller::Repository::Microsoft
                 bool download = Utility::IsUrlRemote(packageLocation);
                 std::filesystem::path tempFile;
                 winrt::Windows::Foundation::Uri uri = nullptr;
+                bool trusted = WI_IsFlagSet(details.TrustLevel, SourceTrustLevel::Trusted);
 
                 if (download)
                 {
@@ -274,10 +782,56 @@ namespace AppInstaller::Repository::Microsoft
                     uri = winrt::Windows::Foundation::Uri(Utility::ConvertToUTF16(packageLocation));
                 }
 
+                if (Settings::ExperimentalFeature::IsEnabled(Settings::ExperimentalFeature::Feature::ExtractSourceUpdates))
+                {
+                    try
+                    {
+                        bool result = UpdateByExtracting(download ? tempFile : std::filesystem::path{ Utility::ConvertToUTF16(packageLocation) }, details, progress, lockForCommit);
+
+                        if (download)
+                        {
+                            std::error_code error;
+                            std::filesystem::remove(tempFile, error);
+                        }
+
+                        return result;
+                    }
+                    catch (...)
+                    {
+                        LOG_CAUGHT_EXCEPTION_MSG("Failed to extract the index from the source package, it will be registered instead");
+                    }
+                }
+
+                // Staging extracts the package while readers can still use the source, leaving only the registration for
+                // the exclusive lock. Untrusted packages are left to the request to add them, which checks them first.
+                if (trusted)
+                {
+                    try
+                    {
+                        Deployment::StagePackage(download ? tempFile.u8string() : packageLocation, progress);
+                    }
+                    catch (...)
+                    {
+                        LOG_CAUGHT_EXCEPTION_MSG("Failed to stage the source package, it will be staged when it is added");
+                    }
+                }
+
+                if (progress.IsCancelled())
+                {
+                    AICLI_LOG(Repo, Info, << "Cancelling update upon request");
+                    return false;
+                }
+
+                auto lock = lockForCommit();
+                if (!lock)
+                {
+                    return false;
+                }
+
                 Deployment::AddPackage(
                     uri,
                     winrt::Windows::Management::Deployment::DeploymentOptions::None,
-                    WI_IsFlagSet(details.TrustLevel, SourceTrustLevel::Trusted),
+                    trusted,
                     progress);
 
                 if (download)
@@ -308,6 +862,72 @@ namespace AppInstaller::Repository::Microsoft
                     }
                 }
 
+                // Readers use the registered package again rather than an index extracted by an earlier update.
+                SetExtractedIndexDirectory(details, {});
+
+                return true;
+            }
+
+            // Verifies the signature of the package and extracts its index to a directory of its own in the state location,
+            // which readers use instead of the registered package once the update is committed. This avoids the cost of
+            // registering the package when only its index is read.
+            bool UpdateByExtracting(const std::filesystem::path& packagePath, const SourceDetails& details, IProgressCallback& progress, const CommitLock& lockForCommit)
+            {
+                THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE, !Msix::IsPackageSignatureTrusted(packagePath));
+
+                // The package is read again from the verified file, so that the files extracted are the ones the signature covers.
+                Msix::MsixInfo packageInfo(packagePath.u8string());
+                THROW_HR_IF(APPINSTALLER_CLI_ERROR_PACKAGE_IS_BUNDLE, packageInfo.GetIsBundle());
+
+                std::string fullName = packageInfo.GetPackageFullName();
+                THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE,
+                    GetPackageFamilyNameFromDetails(details) != Msix::GetPackageFamilyNameFromFullName(fullName));
+
+                // Each version is extracted side by side with the one that readers use, which is only removed once this one is committed.
+                std::filesystem::path directory = GetExtractedIndexRootFromDetails(details) / Utility::ConvertToUTF16(fullName);
+                std::filesystem::remove_all(directory);
+                std::filesystem::create_directories(directory);
+
+                auto removeDirectory = wil::scope_exit([&]() { std::error_code error; std::filesystem::remove_all(directory, error); });
+
+                if (packageInfo.ContainsFile(GetIndexDirectoryFilePath(s_ShardedIndexManifestFileName)))
+                {
+                    // Nothing else uses the new directory, so the shards can be moved into place as soon as they are written.
+                    StagedFiles staged;
+                    if (!UpdateShardedIndex(packageInfo, directory, staged, progress))
+                    {
+                        return false;
+                    }
+
+                    staged.Commit();
+                }
+                else
+                {
+                    packageInfo.WriteToFile(s_PreIndexedPackageSourceFactory_IndexFilePath, directory / s_PreIndexedPackageSourceFactory_IndexFileName, progress);
+                }
+
+                packageInfo.WriteManifestToFile(directory / s_PreIndexedPackageSourceFactory_AppxManifestFileName, progress);
+
+                // The hash is taken from the files just written, which came from the verified package.
+                Utility::SHA256::HashBuffer hash = ComputeExtractedIndexHash(directory);
+
+                if (progress.IsCancelled())
+                {
+                    AICLI_LOG(Repo, Info, << "Cancelling update upon request");
+                    return false;
+                }
+
+                auto lock = lockForCommit();
+                if (!lock)
+                {
+                    return false;
+                }
+
+                WriteExtractedIndexHash(details, fullName, hash);
+                SetExtractedIndexDirectory(details, fullName);
+                removeDirectory.release();
+
+                AICLI_LOG(Repo, Info, << "Extracted the index from source package: " << fullName);
                 return true;
             }
 
@@ -325,19 +945,12 @@ namespace AppInstaller::Repository::Microsoft
                     Deployment::RemovePackage(*fullName, callback);
                 }
 
+                SetExtractedIndexDirectory(details, {});
+
                 return true;
             }
         };
 
-        // Constructs the location that we will write files to.
-        std::filesystem::path GetStatePathFromDetails(const SourceDetails& details)
-        {
-            std::filesystem::path result = Runtime::GetPathTo(Runtime::PathName::LocalState);
-            result /= PreIndexedPackageSourceFactory::Type();
-            result /= GetPackageFamilyNameFromDetails(details);
-            return result;
-        }
-
         struct DesktopContextSourceReference : public ISourceReference
         {
             DesktopContextSourceReference(const SourceDetails& details) : m_details(details)
@@ -360,21 +973,36 @@ namespace AppInstaller::Repository::Microsoft
                     return {};
                 }
 
-                std::filesystem::path packageLocation = GetStatePathFromDetails(m_details);
-                packageLocation /= s_PreIndexedPackageSourceFactory_IndexFileName;
+                // We didn't use to store the source identifier, so we compute it here in case it's
+                // missing from the details.
+                m_details.Identifier = GetPackageFamilyNameFromDetails(m_details);
+                return OpenIndexSource(m_details, GetStatePathFromDetails(m_details), SQLiteIndex::OpenDisposition::Read, std::move(lock));
+            }
+
+            std::optional<std::vector<std::string>> GetCompletionValues(const std::vector<PackageMatchField>& fields, std::string_view prefix) override
+            {
+                if (!std::all_of(fields.begin(), fields.end(), CompletionIndex::SupportsField))
+                {
+                    return {};
+                }
+
+                auto lock = Synchronization::CrossProcessReaderWriteLock::LockShared(CreateNameForCPRWL(m_details));
 
-                if (!std::filesystem::exists(packageLocation))
+                // The completion index is built from a single index; a sharded one is left to be searched.
+                if (IsShardedIndex(GetStatePathFromDetails(m_details)))
                 {
-                    AICLI_LOG(Repo, Info, << "Data not found at " << packageLocation);
-                    THROW_HR(APPINSTALLER_CLI_ERROR_SOURCE_DATA_MISSING);
+                    return {};
                 }
 
-                SQLiteIndex index = SQLiteIndex::Open(packageLocation.u8string(), SQLiteIndex::OpenDisposition::Read);
+                std::filesystem::path indexLocation = GetStatePathFromDetails(m_details);
+                indexLocation /= s_PreIndexedPackageSourceFactory_IndexFileName;
 
-                // We didn't use to store the source identifier, so we compute it here in case it's
-                // missing from the details.
-                m_details.Identifier = GetPackageFamilyNameFromDetails(m_details);
-                return std::make_shared<SQLiteIndexSource>(m_details, std::move(index), std::move(lock));
+                if (!std::filesystem::exists(indexLocation))
+                {
+                    return {};
+                }
+
+                return CompletionIndex::GetValues(GetCompletionIndexPathFromDetails(m_details), indexLocation, SQLiteIndex::OpenDisposition::Read, fields, prefix);
             }
 
         private:
@@ -389,16 +1017,16 @@ namespace AppInstaller::Repository::Microsoft
                 return std::make_shared<DesktopContextSourceReference>(details);
             }
 
-            bool UpdateInternal(const std::string&, Msix::MsixInfo& packageInfo, const SourceDetails& details, IProgressCallback& progress) override
+            bool UpdateInternal(const std::string&, Msix::MsixInfo& packageInfo, const SourceDetails& details, IProgressCallback& progress, const CommitLock& lockForCommit) override
             {
-                // We will extract the manifest and index files directly to this location
+                // We will extract the manifest and index files next to the existing ones in this location, then move them over
                 std::filesystem::path packageState = GetStatePathFromDetails(details);
                 std::filesystem::create_directories(packageState);
 
                 std::filesystem::path manifestPath = packageState / s_PreIndexedPackageSourceFactory_AppxManifestFileName;
                 std::filesystem::path indexPath = packageState / s_PreIndexedPackageSourceFactory_IndexFileName;
 
-                if (std::filesystem::exists(manifestPath) && std::filesystem::exists(indexPath))
+                if (std::filesystem::exists(manifestPath) && (std::filesystem::exists(indexPath) || IsShardedIndex(packageState)))
                 {
                     // If we already have a manifest, use it to determine if we need to update or not.
                     if (!packageInfo.IsNewerThan(manifestPath))
@@ -408,15 +1036,79 @@ namespace AppInstaller::Repository::Microsoft
                     }
                 }
 
+                StagedFiles staged;
+
+                // Each shard of a sharded index is updated on its own, so nothing is read from the package for the shards that did not change.
+                if (packageInfo.ContainsFile(GetIndexDirectoryFilePath(s_ShardedIndexManifestFileName)))
+                {
+                    if (!UpdateShardedIndex(packageInfo, packageState, staged, progress))
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    std::filesystem::path stagedIndexPath = staged.Stage(indexPath);
+                    bool indexUpdated = false;
+
+                    if (std::filesystem::exists(manifestPath) && std::filesystem::exists(indexPath))
+                    {
+                        // Consecutive versions of the index share most of their blocks, so only read the ones that changed.
+                        try
+                        {
+                            indexUpdated = packageInfo.UpdateFile(s_PreIndexedPackageSourceFactory_IndexFilePath, indexPath, stagedIndexPath, progress);
+                        }
+                        catch (...)
+                        {
+                            LOG_CAUGHT_EXCEPTION_MSG("Failed to update the existing index, it will be written in full");
+                        }
+                    }
+
+                    if (progress.IsCancelled())
+                    {
+                        AICLI_LOG(Repo, Info, << "Cancelling update upon request");
+                        return false;
+                    }
+
+                    if (!indexUpdated)
+                    {
+                        packageInfo.WriteToFile(s_PreIndexedPackageSourceFactory_IndexFilePath, stagedIndexPath, progress);
+                    }
+
+                    // The source is no longer sharded, so the shards are no longer used.
+                    if (IsShardedIndex(packageState))
+                    {
+                        try
+                        {
+                            std::filesystem::path shardManifestPath = packageState / s_ShardedIndexManifestFileName;
+                            std::vector<std::string> shards = ReadShardedIndexManifest(shardManifestPath);
+                            staged.RemoveOnCommit(shardManifestPath);
+
+                            for (const auto& shard : shards)
+                            {
+                                staged.RemoveOnCommit(packageState / shard);
+                            }
+                        }
+                        CATCH_LOG();
+                    }
+                }
+
+                // The manifest is what the next update compares against, so it is moved last.
+                packageInfo.WriteManifestToFile(staged.Stage(manifestPath), progress);
+
                 if (progress.IsCancelled())
                 {
                     AICLI_LOG(Repo, Info, << "Cancelling update upon request");
                     return false;
                 }
 
-                packageInfo.WriteToFile(s_PreIndexedPackageSourceFactory_IndexFilePath, indexPath, progress);
-                packageInfo.WriteManifestToFile(manifestPath, progress);
+                auto lock = lockForCommit();
+                if (!lock)
+                {
+                    return false;
+                }
 
+                staged.Commit();
                 return true;
             }
 
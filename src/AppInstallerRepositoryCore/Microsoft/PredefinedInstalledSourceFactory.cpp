@@ -2,13 +2,24 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "Microsoft/ARPHelper.h"
+#include "Microsoft/InstalledSearchFilter.h"
 #include "Microsoft/PredefinedInstalledSourceFactory.h"
 #include "Microsoft/SQLiteIndex.h"
 #include "Microsoft/SQLiteIndexSource.h"
+#include "Microsoft/Schema/MetadataTable.h"
 #include <winget/ManifestInstaller.h>
 
 #include <winget/Registry.h>
 #include <AppInstallerArchitecture.h>
+#include <AppInstallerRuntime.h>
+#include <AppInstallerSHA256.h>
+#include <winget/Locale.h>
+#include <winget/NameNormalization.h>
+#include <winget/ThreadGlobals.h>
+#include <winget/Timing.h>
+
+#include <future>
+#include <mutex>
 
 using namespace std::string_literals;
 using namespace std::string_view_literals;
@@ -17,17 +28,321 @@ namespace AppInstaller::Repository::Microsoft
 {
     namespace
     {
-        // Populates the index with the entries from MSIX.
-        void PopulateIndexFromMSIX(SQLiteIndex& index)
+        // Bump this whenever the contents of the installed index change for the same machine state.
+        constexpr std::string_view s_InstalledSnapshotFormat = "1"sv;
+        constexpr std::string_view s_InstalledSnapshotDirectory = "InstalledSnapshot"sv;
+        constexpr std::wstring_view s_AppModelPackageRepository = L"Software\\Classes\\Local Settings\\Software\\Microsoft\\Windows\\CurrentVersion\\AppModel\\Repository\\Packages"sv;
+
+        std::string CreateNameForCPRWL(PredefinedInstalledSourceFactory::Filter filter)
+        {
+            return "PredefinedInstalledSnapshotCPRWL_"s + std::string{ PredefinedInstalledSourceFactory::FilterToString(filter) };
+        }
+
+        std::filesystem::path GetSnapshotFilePath(PredefinedInstalledSourceFactory::Filter filter)
+        {
+            std::filesystem::path result = Runtime::GetPathTo(Runtime::PathName::LocalState);
+            result /= s_InstalledSnapshotDirectory;
+            result /= std::string{ PredefinedInstalledSourceFactory::FilterToString(filter) } + ".db";
+            return result;
+        }
+
+        // Describes the installed state covered by a filter.
+        struct InstalledState
+        {
+            // The serialized ARP entry states; empty if ARP is not covered.
+            std::string ARPEntries;
+            // Changes whenever anything other than the ARP entries changes; an index with the same base state
+            // can be brought up to date by only updating the ARP entries.
+            std::string BaseState;
+            // Changes whenever anything covered by the filter changes.
+            std::string Token;
+        };
+
+        // Hashes the names and last write times of the packages registered for the current user.
+        // The AppModel repository gets a subkey per registered package full name, so this changes whenever a
+        // package is added, removed, or updated; enumerating it is far cheaper than going through PackageManager.
+        // Returns an empty value if the repository could not be read, in which case the MSIX state cannot be tracked.
+        std::optional<std::string> GetMSIXState()
+        {
+            Registry::Key packagesKey = Registry::Key::OpenIfExists(HKEY_CURRENT_USER, std::wstring{ s_AppModelPackageRepository });
+            if (!packagesKey)
+            {
+                return std::nullopt;
+            }
+
+            std::ostringstream strstr;
+
+            // The display names are localized, so a change in languages must also rebuild the snapshot.
+            for (const auto& language : Locale::GetUserPreferredLanguages())
+            {
+                strstr << language << '\n';
+            }
+
+            for (const auto& package : packagesKey)
+            {
+                FILETIME lastWriteTime = package.LastWriteTime();
+                strstr << package.Name() << '|' << lastWriteTime.dwHighDateTime << '|' << lastWriteTime.dwLowDateTime << '\n';
+            }
+
+            return Utility::SHA256::ConvertToString(Utility::SHA256::ComputeHash(strstr.str()));
+        }
+
+        bool IncludesARP(PredefinedInstalledSourceFactory::Filter filter)
+        {
+            return filter == PredefinedInstalledSourceFactory::Filter::None || filter == PredefinedInstalledSourceFactory::Filter::ARP;
+        }
+
+        bool IncludesMSIX(PredefinedInstalledSourceFactory::Filter filter)
+        {
+            return filter == PredefinedInstalledSourceFactory::Filter::None || filter == PredefinedInstalledSourceFactory::Filter::MSIX;
+        }
+
+        // Determines the installed state covered by the filter.
+        // Returns an empty value if the state cannot be tracked, in which case no snapshot should be used.
+        std::optional<InstalledState> GetInstalledState(PredefinedInstalledSourceFactory::Filter filter)
+        {
+            try
+            {
+                InstalledState result;
+                std::string msixState;
+
+                if (IncludesARP(filter))
+                {
+                    ARPHelper arpHelper;
+                    std::vector<ARPHelper::EntryState> entries = arpHelper.GetEntryStates(Manifest::ScopeEnum::Machine);
+                    std::vector<ARPHelper::EntryState> userEntries = arpHelper.GetEntryStates(Manifest::ScopeEnum::User);
+                    entries.insert(entries.end(), userEntries.begin(), userEntries.end());
+                    result.ARPEntries = ARPHelper::SerializeEntryStates(entries);
+                }
+
+                if (IncludesMSIX(filter))
+                {
+                    std::optional<std::string> msixStateOpt = GetMSIXState();
+                    if (!msixStateOpt)
+                    {
+                        AICLI_LOG(Repo, Info, << "MSIX state could not be determined; not using an installed snapshot");
+                        return std::nullopt;
+                    }
+                    msixState = std::move(msixStateOpt).value();
+                }
+
+                std::ostringstream strstr;
+                // The index stores the normalized names and publishers of the entries, so the normalization rules are part of the state.
+                strstr << s_InstalledSnapshotFormat << '|' << Schema::Version::Latest() << '|' <<
+                    Utility::GetNormalizationRulesIdentifier(Utility::NormalizationVersion::Initial) << '|' <<
+                    PredefinedInstalledSourceFactory::FilterToString(filter) << '|' << msixState;
+                result.BaseState = strstr.str();
+
+                result.Token = Utility::SHA256::ConvertToString(Utility::SHA256::ComputeHash(result.BaseState + '\n' + result.ARPEntries));
+
+                return result;
+            }
+            CATCH_LOG();
+
+            return std::nullopt;
+        }
+
+        void SetInstalledState(SQLiteIndex& index, const InstalledState& state)
+        {
+            index.SetInstalledStateValue(Schema::s_MetadataValueName_InstalledARPEntries, state.ARPEntries);
+            index.SetInstalledStateValue(Schema::s_MetadataValueName_InstalledBaseState, state.BaseState);
+            index.SetInstalledStateValue(Schema::s_MetadataValueName_InstalledStateToken, state.Token);
+        }
+
+        // Opens the snapshot for the filter if it was built from the given installed state.
+        std::shared_ptr<ISource> TryOpenSnapshot(const SourceDetails& details, PredefinedInstalledSourceFactory::Filter filter, const InstalledState& state)
+        {
+            try
+            {
+                std::filesystem::path snapshotPath = GetSnapshotFilePath(filter);
+
+                auto lock = Synchronization::CrossProcessReaderWriteLock::LockShared(CreateNameForCPRWL(filter));
+
+                if (!std::filesystem::exists(snapshotPath))
+                {
+                    return {};
+                }
+
+                SQLiteIndex index = SQLiteIndex::Open(snapshotPath.u8string(), SQLiteIndex::OpenDisposition::Read);
+
+                if (index.GetVersion() != Schema::Version::Latest() || index.GetInstalledStateValue(Schema::s_MetadataValueName_InstalledStateToken) != state.Token)
+                {
+                    AICLI_LOG(Repo, Info, << "Installed snapshot is out of date");
+                    return {};
+                }
+
+                AICLI_LOG(Repo, Info, << "Using installed snapshot");
+                return std::make_shared<SQLiteIndexSource>(details, std::move(index), std::move(lock), true);
+            }
+            CATCH_LOG();
+
+            return {};
+        }
+
+        // The display names of MSIX packages, keyed by package full name.
+        // A display name is resolved through the resources of its package, which costs far more than reading the identity,
+        // so the names are kept for the life of the process and saved with the installed snapshot. A rebuild of the
+        // snapshot then only resolves the names of the packages that have changed.
+        struct MSIXDisplayNameCache
+        {
+            static MSIXDisplayNameCache& Instance()
+            {
+                static MSIXDisplayNameCache s_instance;
+                return s_instance;
+            }
+
+            // Clears the names if the preferred languages of the user have changed, as the names are localized.
+            void Validate()
+            {
+                std::string languages = GetLanguages();
+
+                std::lock_guard<std::mutex> lock{ m_lock };
+                if (languages != m_languages)
+                {
+                    m_names.clear();
+                    m_languages = std::move(languages);
+                }
+            }
+
+            std::optional<std::string> Find(const std::wstring& fullName)
+            {
+                std::lock_guard<std::mutex> lock{ m_lock };
+                auto itr = m_names.find(fullName);
+                return (itr == m_names.end() ? std::nullopt : std::optional<std::string>{ itr->second });
+            }
+
+            void Add(const std::wstring& fullName, std::string displayName)
+            {
+                std::lock_guard<std::mutex> lock{ m_lock };
+                m_names[fullName] = std::move(displayName);
+            }
+
+            // Serializes the names of the given packages, along with the languages that they were resolved for.
+            std::string Serialize(const std::vector<std::wstring>& fullNames)
+            {
+                std::lock_guard<std::mutex> lock{ m_lock };
+
+                std::ostringstream strstr;
+                strstr << m_languages << '\n';
+
+                for (const auto& fullName : fullNames)
+                {
+                    auto itr = m_names.find(fullName);
+                    if (itr != m_names.end() && itr->second.find_first_of("\t\n") == std::string::npos)
+                    {
+                        strstr << Utility::ConvertToUTF8(fullName) << '\t' << itr->second << '\n';
+                    }
+                }
+
+                return strstr.str();
+            }
+
+            // Adds the serialized names that are not already known, if they were resolved for the current languages.
+            void Load(std::string_view serialized)
+            {
+                Validate();
+
+                std::lock_guard<std::mutex> lock{ m_lock };
+
+                size_t lineEnd = serialized.find('\n');
+                if (lineEnd == std::string_view::npos || serialized.substr(0, lineEnd) != m_languages)
+                {
+                    return;
+                }
+
+                while (lineEnd != std::string_view::npos)
+                {
+                    size_t lineStart = lineEnd + 1;
+                    lineEnd = serialized.find('\n', lineStart);
+                    std::string_view line = serialized.substr(lineStart, lineEnd == std::string_view::npos ? std::string_view::npos : lineEnd - lineStart);
+
+                    size_t separator = line.find('\t');
+                    if (separator != std::string_view::npos)
+                    {
+                        m_names.emplace(Utility::ConvertToUTF16(line.substr(0, separator)), std::string{ line.substr(separator + 1) });
+                    }
+                }
+            }
+
+        private:
+            static std::string GetLanguages()
+            {
+                std::string result;
+                for (const auto& language : Locale::GetUserPreferredLanguages())
+                {
+                    result += language;
+                    result += ';';
+                }
+                return result;
+            }
+
+            std::mutex m_lock;
+            std::string m_languages;
+            std::map<std::wstring, std::string> m_names;
+        };
+
+        // The identity read for an MSIX package, ready to be added to an index once its display name is resolved.
+        struct MSIXEntry
+        {
+            // Has every value but the package name.
+            Manifest::Manifest PackageManifest;
+            std::wstring FullName;
+            // Used as the package name if the display name cannot be resolved.
+            std::string IdentityName;
+            winrt::Windows::ApplicationModel::Package Package{ nullptr };
+        };
+
+        // Gets the display name of the package, resolving it only if it is not already cached.
+        std::string GetDisplayName(const MSIXEntry& entry)
+        {
+            MSIXDisplayNameCache& cache = MSIXDisplayNameCache::Instance();
+
+            std::optional<std::string> cached = cache.Find(entry.FullName);
+            if (cached)
+            {
+                return std::move(cached).value();
+            }
+
+            // Since this will retrieve the localized value, it has a chance to fail.
+            // Rather than completely skip this package in that case, we will simply fall back to using the package name.
+            try
+            {
+                auto displayName = Utility::ConvertToUTF8(entry.Package.DisplayName());
+                if (!displayName.empty())
+                {
+                    cache.Add(entry.FullName, displayName);
+                    return displayName;
+                }
+            }
+            catch (const winrt::hresult_error& hre)
+            {
+                AICLI_LOG(Repo, Info, << "winrt::hresult_error[0x" << Logging::SetHRFormat << hre.code() << ": " <<
+                    Utility::ConvertToUTF8(hre.message()) << "] exception thrown when getting DisplayName for " << entry.PackageManifest.Id);
+            }
+            catch (...)
+            {
+                AICLI_LOG(Repo, Info, << "Unknown exception thrown when getting DisplayName for " << entry.PackageManifest.Id);
+            }
+
+            return entry.IdentityName;
+        }
+
+        // Reads the identities of the entries from MSIX without touching an index.
+        // The display names are resolved as the entries are added to an index, so that those already cached are not resolved again.
+        std::vector<MSIXEntry> ReadEntriesFromMSIX()
         {
             using namespace winrt::Windows::ApplicationModel;
             using namespace winrt::Windows::Management::Deployment;
 
+            MSIXDisplayNameCache::Instance().Validate();
+
             // TODO: Consider if Optional packages should also be enumerated
             PackageManager packageManager;
             auto packages = packageManager.FindPackagesForUserWithPackageTypes({}, PackageTypes::Main);
 
-            // Reuse the same manifest object, as we will be setting the same values every time.
+            std::vector<MSIXEntry> result;
+
+            // Start every entry from the same manifest object, as we will be setting the same values every time.
             Manifest::Manifest manifest;
             // Add one installer for storing the package family name.
             manifest.Installers.emplace_back();
@@ -54,49 +369,368 @@ namespace AppInstaller::Repository::Microsoft
 
                 manifest.Id = familyName;
 
-                bool isPackageNameSet = false;
-                // Attempt to get the DisplayName. Since this will retrieve the localized value, it has a chance to fail.
-                // Rather than completely skip this package in that case, we will simply fall back to using the package name below.
-                try
+                std::ostringstream strstr;
+                auto packageVersion = packageId.Version();
+                strstr << packageVersion.Major << '.' << packageVersion.Minor << '.' << packageVersion.Build << '.' << packageVersion.Revision;
+
+                manifest.Version = strstr.str();
+                
+                manifest.Installers[0].PackageFamilyName = familyName;
+
+                result.emplace_back(MSIXEntry{ manifest, std::wstring{ packageId.FullName() }, Utility::ConvertToUTF8(packageId.Name()), package });
+            }
+
+            return result;
+        }
+
+        // Adds previously read MSIX entries to the index, leaving out those that the filter cannot match if one is given.
+        // The entries that are added are removed, so that the rest can be added later.
+        // A package is first tested without its display name, which is then only resolved if it is added or the filter needs it.
+        void AddEntriesToIndex(SQLiteIndex& index, std::vector<MSIXEntry>& entries, const InstalledSearchFilter* searchFilter = nullptr)
+        {
+            bool filterExaminesName = searchFilter && searchFilter->ExaminesField(PackageMatchField::Name);
+            std::vector<MSIXEntry> remaining;
+
+            for (auto& entry : entries)
+            {
+                bool couldMatch = !searchFilter || searchFilter->CouldMatch(entry.PackageManifest);
+                if (!couldMatch && !filterExaminesName)
+                {
+                    remaining.emplace_back(std::move(entry));
+                    continue;
+                }
+
+                Manifest::Manifest manifest = entry.PackageManifest;
+                manifest.DefaultLocalization.Add<Manifest::Localization::PackageName>(GetDisplayName(entry));
+
+                if (!couldMatch && !searchFilter->CouldMatch(manifest))
                 {
-                    auto displayName = Utility::ConvertToUTF8(package.DisplayName());
-                    if (!displayName.empty())
+                    remaining.emplace_back(std::move(entry));
+                    continue;
+                }
+
+                // Use the full name as a unique key for the path
+                auto manifestId = index.AddManifest(manifest, std::filesystem::path{ entry.FullName });
+
+                index.SetMetadataByManifestId(manifestId, PackageVersionMetadata::InstalledType,
+                    Manifest::InstallerTypeToString(Manifest::InstallerTypeEnum::Msix));
+            }
+
+            entries = std::move(remaining);
+        }
+
+        // Runs the function on a worker thread with its own thread globals.
+        template <typename Func>
+        auto RunOnWorker(Func&& func)
+        {
+            std::shared_ptr<ThreadGlobals> threadGlobals;
+            ThreadGlobals* parentThreadGlobals = ThreadGlobals::GetForCurrentThread();
+            if (parentThreadGlobals)
+            {
+                threadGlobals = std::make_shared<ThreadGlobals>(*parentThreadGlobals, ThreadGlobals::create_sub_thread_globals_t{});
+            }
+
+            return std::async(std::launch::async, [threadGlobals, func = std::forward<Func>(func)]()
+                {
+                    std::unique_ptr<PreviousThreadGlobals> previousThreadGlobals;
+                    if (threadGlobals)
                     {
-                        manifest.DefaultLocalization.Add<Manifest::Localization::PackageName>(displayName);
-                        isPackageNameSet = true;
+                        previousThreadGlobals = threadGlobals->SetForCurrentThread();
                     }
+
+                    return func();
+                });
+        }
+
+        // The installed entries that have been read but not yet added to an index.
+        struct InstalledEntries
+        {
+            // The entries of both scopes, machine first; they are kept together as duplicates are found across scopes.
+            std::vector<ARPHelper::Entry> ARP;
+            std::vector<MSIXEntry> MSIX;
+        };
+
+        // Reads the installed entries covered by the filter without touching an index.
+        InstalledEntries ReadEntries(PredefinedInstalledSourceFactory::Filter filter)
+        {
+            // The producers only read, so they run concurrently.
+            // MSIX stays on this thread, as PackageManager needs the apartment that the caller has set up.
+            ARPHelper arpHelper;
+            std::future<std::vector<ARPHelper::Entry>> machineEntries;
+            std::future<std::vector<ARPHelper::Entry>> userEntries;
+
+            if (IncludesARP(filter))
+            {
+                machineEntries = RunOnWorker([arpHelper]() { return arpHelper.ReadEntriesFromARP(Manifest::ScopeEnum::Machine); });
+                userEntries = RunOnWorker([arpHelper]() { return arpHelper.ReadEntriesFromARP(Manifest::ScopeEnum::User); });
+            }
+
+            InstalledEntries result;
+            if (IncludesMSIX(filter))
+            {
+                result.MSIX = ReadEntriesFromMSIX();
+            }
+
+            if (IncludesARP(filter))
+            {
+                result.ARP = machineEntries.get();
+                std::vector<ARPHelper::Entry> moreEntries = userEntries.get();
+                std::move(moreEntries.begin(), moreEntries.end(), std::back_inserter(result.ARP));
+            }
+
+            return result;
+        }
+
+        // Adds the entries to the index, from this thread alone and in the order that reading sequentially would add them.
+        // If a search filter is given, only the entries that it could match are added, and the rest are left in the entries.
+        void AddEntriesToIndex(SQLiteIndex& index, InstalledEntries& entries, const InstalledSearchFilter* searchFilter = nullptr)
+        {
+            ARPHelper arpHelper;
+
+            if (searchFilter)
+            {
+                arpHelper.AddMatchingEntriesToIndex(index, entries.ARP, *searchFilter);
+            }
+            else
+            {
+                arpHelper.AddEntriesToIndex(index, entries.ARP);
+                entries.ARP.clear();
+            }
+
+            AddEntriesToIndex(index, entries.MSIX, searchFilter);
+        }
+
+        // Populates the index with the installed packages covered by the filter.
+        // Returns the full names of the MSIX packages that were read.
+        std::vector<std::wstring> PopulateIndex(SQLiteIndex& index, PredefinedInstalledSourceFactory::Filter filter)
+        {
+            Timing::Span span{ Timing::Phase::InstalledIndexBuild };
+
+            InstalledEntries entries = ReadEntries(filter);
+
+            std::vector<std::wstring> result;
+            for (const auto& entry : entries.MSIX)
+            {
+                result.emplace_back(entry.FullName);
+            }
+
+            AddEntriesToIndex(index, entries);
+
+            return result;
+        }
+
+        // Adds the MSIX display names saved in the snapshot file to the cache, so that a rebuild does not resolve them again.
+        void LoadMSIXDisplayNames(const std::filesystem::path& filePath)
+        {
+            try
+            {
+                SQLiteIndex index = SQLiteIndex::Open(filePath.u8string(), SQLiteIndex::OpenDisposition::Read);
+
+                std::optional<std::string> displayNames = index.GetInstalledStateValue(Schema::s_MetadataValueName_InstalledMSIXDisplayNames);
+                if (displayNames)
+                {
+                    MSIXDisplayNameCache::Instance().Load(displayNames.value());
+                }
+            }
+            CATCH_LOG();
+        }
+
+        // Attempts to bring the existing snapshot in the given file up to date with the installed state.
+        // Only possible when nothing but the ARP entries has changed, in which case only the changed entries are read.
+        bool TryUpdateSnapshotFile(const std::filesystem::path& filePath, const InstalledState& state)
+        {
+            try
+            {
+                SQLiteIndex index = SQLiteIndex::Open(filePath.u8string(), SQLiteIndex::OpenDisposition::ReadWrite);
+
+                std::optional<std::string> previousEntries = index.GetInstalledStateValue(Schema::s_MetadataValueName_InstalledARPEntries);
+
+                if (index.GetVersion() != Schema::Version::Latest() ||
+                    index.GetInstalledStateValue(Schema::s_MetadataValueName_InstalledBaseState) != state.BaseState ||
+                    !previousEntries)
+                {
+                    return false;
                 }
-                catch (const winrt::hresult_error& hre)
+
+                SQLite::Savepoint savepoint = index.CreateSavepoint("installedsnapshot_update");
+
+                ARPHelper arpHelper;
+                arpHelper.UpdateIndexFromARP(index, ARPHelper::DeserializeEntryStates(previousEntries.value()), ARPHelper::DeserializeEntryStates(state.ARPEntries));
+                SetInstalledState(index, state);
+
+                savepoint.Commit();
+                return true;
+            }
+            CATCH_LOG();
+
+            return false;
+        }
+
+        // Brings the snapshot for the filter up to date with the given installed state.
+        // This is best effort; if another process is using the snapshot it is simply left alone.
+        void TryRefreshSnapshot(PredefinedInstalledSourceFactory::Filter filter, const InstalledState& state)
+        {
+            std::filesystem::path tempPath;
+
+            try
+            {
+                // Do not wait; readers hold the lock for as long as they have the snapshot open.
+                auto lock = Synchronization::CrossProcessReaderWriteLock::LockExclusive(CreateNameForCPRWL(filter), 0ms);
+                if (!lock)
                 {
-                    AICLI_LOG(Repo, Info, << "winrt::hresult_error[0x" << Logging::SetHRFormat << hre.code() << ": " <<
-                        Utility::ConvertToUTF8(hre.message()) << "] exception thrown when getting DisplayName for " << familyName);
+                    AICLI_LOG(Repo, Info, << "Installed snapshot is in use; not refreshing it");
+                    return;
                 }
-                catch (...)
+
+                std::filesystem::path snapshotPath = GetSnapshotFilePath(filter);
+                std::filesystem::create_directories(snapshotPath.parent_path());
+
+                GUID guid;
+                THROW_IF_FAILED(CoCreateGuid(&guid));
+                wchar_t guidString[MAX_PATH];
+                THROW_HR_IF(E_UNEXPECTED, StringFromGUID2(guid, guidString, MAX_PATH) == 0);
+
+                tempPath = snapshotPath;
+                tempPath += guidString;
+
+                // Work on a copy so that the snapshot is replaced only once the new one is complete.
+                bool updated = false;
+                if (std::filesystem::exists(snapshotPath))
                 {
-                    AICLI_LOG(Repo, Info, << "Unknown exception thrown when getting DisplayName for " << familyName);
+                    std::filesystem::copy_file(snapshotPath, tempPath);
+                    updated = TryUpdateSnapshotFile(tempPath, state);
+
+                    if (!updated)
+                    {
+                        if (IncludesMSIX(filter))
+                        {
+                            LoadMSIXDisplayNames(tempPath);
+                        }
+
+                        std::filesystem::remove(tempPath);
+                    }
                 }
 
-                if (!isPackageNameSet)
+                if (updated)
                 {
-                    manifest.DefaultLocalization.Add<Manifest::Localization::PackageName>(Utility::ConvertToUTF8(packageId.Name()));
+                    AICLI_LOG(Repo, Info, << "Updated the installed snapshot");
                 }
+                else
+                {
+                    SQLiteIndex index = SQLiteIndex::CreateNew(tempPath.u8string(), Schema::Version::Latest());
+                    SQLite::Savepoint savepoint = index.CreateSavepoint("installedsnapshot_create");
 
-                std::ostringstream strstr;
-                auto packageVersion = packageId.Version();
-                strstr << packageVersion.Major << '.' << packageVersion.Minor << '.' << packageVersion.Build << '.' << packageVersion.Revision;
+                    std::vector<std::wstring> msixFullNames = PopulateIndex(index, filter);
+                    SetInstalledState(index, state);
 
-                manifest.Version = strstr.str();
-                
-                manifest.Installers[0].PackageFamilyName = familyName;
+                    if (IncludesMSIX(filter))
+                    {
+                        index.SetInstalledStateValue(Schema::s_MetadataValueName_InstalledMSIXDisplayNames, MSIXDisplayNameCache::Instance().Serialize(msixFullNames));
+                    }
 
-                // Use the full name as a unique key for the path
-                auto manifestId = index.AddManifest(manifest, std::filesystem::path{ packageId.FullName().c_str() });
+                    savepoint.Commit();
+                    AICLI_LOG(Repo, Info, << "Created a new installed snapshot");
+                }
 
-                index.SetMetadataByManifestId(manifestId, PackageVersionMetadata::InstalledType, 
-                    Manifest::InstallerTypeToString(Manifest::InstallerTypeEnum::Msix));
+                std::filesystem::rename(tempPath, snapshotPath);
+                tempPath.clear();
+            }
+            CATCH_LOG();
+
+            if (!tempPath.empty())
+            {
+                std::error_code ec;
+                std::filesystem::remove(tempPath, ec);
             }
         }
 
+        // The installed source when there is no up to date snapshot to open.
+        // The entries are read in the background from the time the source is opened, so that the other sources can be opened
+        // in the meantime, and are added to the one index that serves every search. Like a writeable source, the index is brought
+        // up to date by each search: one that is narrow enough only adds the entries that it could match, and any other adds the rest,
+        // refreshing the snapshot in the background for the next process. Since the index only grows, the packages found by
+        // different searches are the same.
+        struct DeferredInstalledSource : public ISource
+        {
+            DeferredInstalledSource(const SourceDetails& details, PredefinedInstalledSourceFactory::Filter filter, std::optional<InstalledState> installedState) :
+                m_details(details), m_filter(filter), m_installedState(std::move(installedState))
+            {
+                m_source = std::make_shared<SQLiteIndexSource>(details, SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET, Schema::Version::Latest()),
+                    Synchronization::CrossProcessReaderWriteLock{}, true);
+
+                m_reading = RunOnWorker([filter]()
+                    {
+                        // PackageManager needs an apartment; join the multithreaded one that the caller is expected to be in.
+                        HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+                        auto uninitialize = wil::scope_exit([hr]() { if (SUCCEEDED(hr)) { CoUninitialize(); } });
+
+                        return ReadEntries(filter);
+                    });
+            }
+
+            const std::string& GetIdentifier() const override { return m_details.Identifier; }
+
+            const SourceDetails& GetDetails() const override { return m_details; }
+
+            SearchResult Search(const SearchRequest& request) const override
+            {
+                std::unique_lock<std::mutex> lock{ m_lock };
+
+                if (m_complete)
+                {
+                    lock.unlock();
+                    return m_source->Search(request);
+                }
+
+                if (m_reading.valid())
+                {
+                    m_entries = m_reading.get();
+                }
+
+                Timing::Span span{ Timing::Phase::InstalledIndexBuild };
+
+                std::optional<InstalledSearchFilter> searchFilter = InstalledSearchFilter::Create(request);
+                if (searchFilter)
+                {
+                    AICLI_LOG(Repo, Info, << "Indexing only the installed packages that could match the request");
+                    AddEntriesToIndex(m_source->GetIndex(), m_entries, &searchFilter.value());
+                }
+                else
+                {
+                    AddEntriesToIndex(m_source->GetIndex(), m_entries);
+                    m_complete = true;
+
+                    if (m_installedState)
+                    {
+                        m_snapshotRefresh = RunOnWorker([filter = m_filter, installedState = m_installedState.value()]()
+                            {
+                                HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+                                auto uninitialize = wil::scope_exit([hr]() { if (SUCCEEDED(hr)) { CoUninitialize(); } });
+
+                                TryRefreshSnapshot(filter, installedState);
+                            });
+                    }
+                }
+
+                // Searching under the lock keeps a narrow search from reading the index while another adds to it.
+                return m_source->Search(request);
+            }
+
+        private:
+            SourceDetails m_details;
+            PredefinedInstalledSourceFactory::Filter m_filter;
+            std::optional<InstalledState> m_installedState;
+            std::shared_ptr<SQLiteIndexSource> m_source;
+
+            mutable std::mutex m_lock;
+            // The last reference to the state of an async call waits for it, so neither outlives the source.
+            mutable std::future<InstalledEntries> m_reading;
+            mutable std::future<void> m_snapshotRefresh;
+            // The entries that have been read but not yet added to the index.
+            mutable InstalledEntries m_entries;
+            mutable bool m_complete = false;
+        };
+
         struct PredefinedInstalledSourceReference : public ISourceReference
         {
             PredefinedInstalledSourceReference(const SourceDetails& details) : m_details(details)
@@ -117,23 +751,21 @@ namespace AppInstaller::Repository::Microsoft
                 PredefinedInstalledSourceFactory::Filter filter = PredefinedInstalledSourceFactory::StringToFilter(m_details.Arg);
                 AICLI_LOG(Repo, Info, << "Creating PredefinedInstalledSource with filter [" << PredefinedInstalledSourceFactory::FilterToString(filter) << ']');
 
-                // Create an in memory index
-                SQLiteIndex index = SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET, Schema::Version::Latest());
+                // Reuse the snapshot from a previous run if nothing has changed since it was built
+                std::optional<InstalledState> installedState = GetInstalledState(filter);
 
-                // Put installed packages into the index
-                if (filter == PredefinedInstalledSourceFactory::Filter::None || filter == PredefinedInstalledSourceFactory::Filter::ARP)
+                if (installedState)
                 {
-                    ARPHelper arpHelper;
-                    arpHelper.PopulateIndexFromARP(index, Manifest::ScopeEnum::Machine);
-                    arpHelper.PopulateIndexFromARP(index, Manifest::ScopeEnum::User);
-                }
+                    std::shared_ptr<ISource> snapshot = TryOpenSnapshot(m_details, filter, installedState.value());
 
-                if (filter == PredefinedInstalledSourceFactory::Filter::None || filter == PredefinedInstalledSourceFactory::Filter::MSIX)
-                {
-                    PopulateIndexFromMSIX(index);
+                    if (snapshot)
+                    {
+                        return snapshot;
+                    }
                 }
 
-                return std::make_shared<SQLiteIndexSource>(m_details, std::move(index), Synchronization::CrossProcessReaderWriteLock{}, true);
+                // Otherwise read the entries while the caller gets on with opening anything else, and index them as they are searched for
+                return std::make_shared<DeferredInstalledSource>(m_details, filter, std::move(installedState));
             }
 
         private:
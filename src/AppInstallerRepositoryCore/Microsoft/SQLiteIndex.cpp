@@ -2,8 +2,16 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "SQLiteIndex.h"
+#include "CompletionIndex.h"
 #include "Schema/MetadataTable.h"
+#include "SQLiteStatementBuilder.h"
+#include <winget/AllocationTracking.h>
+#include <winget/Compression.h>
 #include <winget/ManifestYamlParser.h>
+#include <winget/ThreadGlobals.h>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
 
 namespace AppInstaller::Repository::Microsoft
 {
@@ -23,6 +31,196 @@ namespace AppInstaller::Repository::Microsoft
                 return "Unknown";
             }
         }
+
+        // The number of parsed manifests that each worker may get ahead of the writer by.
+        constexpr size_t s_ManifestParseWindowPerWorker = 64;
+
+        // The page cache sizes for each write mode; the default is that of SQLite.
+        constexpr int64_t s_DefaultCacheSizeKiB = 2000;
+        constexpr int64_t s_BuildCacheSizeKiB = 64 * 1024;
+
+        // The page size of a packaged index; larger than the default of SQLite so that most embedded manifests fit
+        // in a page rather than spilling into overflow pages, with fewer interior pages for each table and index.
+        constexpr int64_t s_PackagedPageSizeBytes = 8192;
+
+        // The number of searches that a snapshot could answer before an immutable index builds one.
+        constexpr size_t s_SnapshotSearchThreshold = 16;
+
+        // Reads results that have already been found, such as those from the snapshot, as if from the index.
+        struct SearchResultCursor : public Schema::ISQLiteIndex::SearchCursor
+        {
+            SearchResultCursor(Schema::ISQLiteIndex::SearchResult&& result) : m_result(std::move(result)) {}
+
+            Schema::ISQLiteIndex::SearchResult GetNext(size_t count) override
+            {
+                Schema::ISQLiteIndex::SearchResult result;
+
+                size_t remaining = m_result.Matches.size() - m_position;
+                size_t toRead = (count ? std::min(count, remaining) : remaining);
+
+                auto begin = m_result.Matches.begin() + m_position;
+                std::move(begin, begin + toRead, std::back_inserter(result.Matches));
+                m_position += toRead;
+
+                result.Truncated = (m_position < m_result.Matches.size() || m_result.Truncated);
+                return result;
+            }
+
+        private:
+            Schema::ISQLiteIndex::SearchResult m_result;
+            size_t m_position = 0;
+        };
+
+        // Parses manifest files on worker threads, so that they can be consumed in input order as they become ready.
+        // Workers stay at most a fixed window ahead of the consumer, to bound the memory held by parsed manifests.
+        struct ManifestParsePipeline
+        {
+            ManifestParsePipeline(const std::vector<std::pair<std::filesystem::path, std::filesystem::path>>& paths, size_t workerCount) :
+                m_paths(paths), m_results(paths.size()), m_window(workerCount * s_ManifestParseWindowPerWorker)
+            {
+                using namespace AppInstaller::ThreadLocalStorage;
+
+                ThreadGlobals* parentThreadGlobals = ThreadGlobals::GetForCurrentThread();
+
+                try
+                {
+                    for (size_t i = 0; i < workerCount; ++i)
+                    {
+                        std::shared_ptr<ThreadGlobals> threadGlobals;
+                        if (parentThreadGlobals)
+                        {
+                            threadGlobals = std::make_shared<ThreadGlobals>(*parentThreadGlobals, ThreadGlobals::create_sub_thread_globals_t{});
+                        }
+
+                        m_workers.emplace_back([this, threadGlobals]()
+                            {
+                                std::unique_ptr<PreviousThreadGlobals> previousThreadGlobals;
+                                if (threadGlobals)
+                                {
+                                    previousThreadGlobals = threadGlobals->SetForCurrentThread();
+                                }
+
+                                Work();
+                            });
+                    }
+                }
+                catch (...)
+                {
+                    Stop();
+                    throw;
+                }
+            }
+
+            ManifestParsePipeline(const ManifestParsePipeline&) = delete;
+            ManifestParsePipeline& operator=(const ManifestParsePipeline&) = delete;
+
+            ManifestParsePipeline(ManifestParsePipeline&&) = delete;
+            ManifestParsePipeline& operator=(ManifestParsePipeline&&) = delete;
+
+            ~ManifestParsePipeline()
+            {
+                Stop();
+            }
+
+            // Waits for the manifest at the given index to be parsed and returns it, rethrowing any parse failure.
+            // Must be called with each index in order.
+            std::pair<Manifest::Manifest, const std::filesystem::path&> Get(size_t index)
+            {
+                Result result;
+
+                {
+                    std::unique_lock<std::mutex> lock{ m_mutex };
+                    m_resultAvailable.wait(lock, [&]() { return m_results[index].Ready; });
+
+                    result = std::move(m_results[index]);
+                    m_consumed = index + 1;
+                }
+                m_workAvailable.notify_all();
+
+                if (result.Exception)
+                {
+                    std::rethrow_exception(result.Exception);
+                }
+
+                return { std::move(result.ParsedManifest), m_paths[index].second };
+            }
+
+        private:
+            // Stops handing out work and waits for the workers to finish the manifests they have already taken.
+            void Stop()
+            {
+                {
+                    std::lock_guard<std::mutex> lock{ m_mutex };
+                    m_cancelled = true;
+                }
+                m_workAvailable.notify_all();
+
+                for (auto& worker : m_workers)
+                {
+                    worker.join();
+                }
+            }
+
+            struct Result
+            {
+                bool Ready = false;
+                Manifest::Manifest ParsedManifest;
+                std::exception_ptr Exception;
+            };
+
+            void Work()
+            {
+                for (;;)
+                {
+                    size_t index = 0;
+
+                    {
+                        std::unique_lock<std::mutex> lock{ m_mutex };
+                        m_workAvailable.wait(lock, [&]() { return m_cancelled || m_next >= m_paths.size() || m_next < m_consumed + m_window; });
+
+                        if (m_cancelled || m_next >= m_paths.size())
+                        {
+                            return;
+                        }
+
+                        index = m_next++;
+                    }
+
+                    Result result;
+                    result.Ready = true;
+
+                    try
+                    {
+                        AICLI_LOG(Repo, Verbose, << "Adding manifest from file [" << m_paths[index].first << "]");
+                        result.ParsedManifest = Manifest::YamlParser::CreateFromPath(m_paths[index].first);
+                    }
+                    catch (...)
+                    {
+                        result.Exception = std::current_exception();
+                    }
+
+                    {
+                        std::lock_guard<std::mutex> lock{ m_mutex };
+                        m_results[index] = std::move(result);
+                    }
+                    m_resultAvailable.notify_all();
+                }
+            }
+
+            const std::vector<std::pair<std::filesystem::path, std::filesystem::path>>& m_paths;
+            std::vector<Result> m_results;
+            size_t m_window;
+
+            std::mutex m_mutex;
+            std::condition_variable m_workAvailable;
+            std::condition_variable m_resultAvailable;
+            size_t m_next = 0;
+            size_t m_consumed = 0;
+            bool m_cancelled = false;
+
+            // Declared last so that every other member is initialized before a worker starts, and outlives it.
+            std::vector<std::thread> m_workers;
+        };
     }
 
     SQLiteIndex SQLiteIndex::CreateNew(const std::string& filePath, Schema::Version version, CreateOptions options)
@@ -99,16 +297,31 @@ namespace AppInstaller::Repository::Microsoft
 
             target += "?immutable=1";
 
-            return { target, SQLite::Connection::OpenDisposition::ReadOnly, SQLite::Connection::OpenFlags::Uri };
+            // As the file cannot change, map all of it. Pages are then read directly from the mapping (and shared across processes
+            // by the OS) rather than each connection copying them into its own page cache with a read call per page.
+            std::error_code fileSizeError;
+            uintmax_t fileSize = std::filesystem::file_size(Utility::ConvertToUTF16(filePath), fileSizeError);
+            int64_t memoryMapSize = fileSizeError ? 0 : static_cast<int64_t>(fileSize);
+
+            SQLiteIndex result{ target, SQLite::Connection::OpenDisposition::ReadOnly, SQLite::Connection::OpenFlags::Uri, memoryMapSize };
+            result.m_snapshotEnabled = true;
+            return result;
         }
         default:
             THROW_HR(E_UNEXPECTED);
         }
     }
 
-    SQLiteIndex::SQLiteIndex(const std::string& target, SQLite::Connection::OpenDisposition disposition, SQLite::Connection::OpenFlags flags) :
+    SQLiteIndex::SQLiteIndex(const std::string& target, SQLite::Connection::OpenDisposition disposition, SQLite::Connection::OpenFlags flags, int64_t memoryMapSize) :
         m_dbconn(SQLite::Connection::Create(target, disposition, flags))
     {
+        if (memoryMapSize)
+        {
+            m_dbconn.SetMemoryMapSize(memoryMapSize);
+        }
+
+        // Search results are held in temp tables, which never need to outlive the connection.
+        m_dbconn.SetTempStore(SQLite::Connection::TempStore::Memory);
         m_dbconn.EnableICU();
         m_version = Schema::Version::GetSchemaVersion(m_dbconn);
         AICLI_LOG(Repo, Info, << "Opened SQLite Index with version [" << m_version << "], last write [" << GetLastWriteTime() << "]");
@@ -119,6 +332,7 @@ namespace AppInstaller::Repository::Microsoft
     SQLiteIndex::SQLiteIndex(const std::string& target, Schema::Version version) :
         m_dbconn(SQLite::Connection::Create(target, SQLite::Connection::OpenDisposition::Create))
     {
+        m_dbconn.SetTempStore(SQLite::Connection::TempStore::Memory);
         m_dbconn.EnableICU();
         m_interface = version.CreateISQLiteIndex();
         m_version = m_interface->GetVersion();
@@ -149,6 +363,68 @@ namespace AppInstaller::Repository::Microsoft
         return AddManifestInternal(manifest, {});
     }
 
+    template <typename GetEntry>
+    std::vector<SQLiteIndex::IdType> SQLiteIndex::AddManifestsInternal(size_t count, GetEntry&& getEntry, const std::function<void(size_t)>& onAdded)
+    {
+        std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
+        AICLI_LOG(Repo, Info, << "Adding " << count << " manifests");
+
+        // A single savepoint for the whole set means only one commit to disk, rather than one per manifest.
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(m_dbconn, "sqliteindex_addmanifests");
+
+        std::vector<IdType> result;
+        result.reserve(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            decltype(auto) entry = getEntry(i);
+            const Manifest::Manifest& manifest = entry.first;
+            const std::filesystem::path& relativePath = entry.second;
+
+            AICLI_LOG(Repo, Verbose, << "Adding manifest for [" << manifest.Id << ", " << manifest.Version << "] at relative path [" << relativePath << "]");
+            result.emplace_back(m_interface->AddManifest(m_dbconn, manifest, relativePath));
+
+            if (onAdded)
+            {
+                onAdded(result.size());
+            }
+        }
+
+        SetLastWriteTime();
+
+        savepoint.Commit();
+
+        return result;
+    }
+
+    std::vector<SQLiteIndex::IdType> SQLiteIndex::AddManifests(
+        const std::vector<std::pair<std::filesystem::path, std::filesystem::path>>& manifestAndRelativePaths,
+        const std::function<void(size_t)>& onAdded)
+    {
+        // Parsing and validating the manifests is much more expensive than adding them, so that work is spread out
+        // while this thread (the only one that can use the connection) does the adding.
+        size_t workerCount = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 2u) - 1, manifestAndRelativePaths.size());
+
+        if (workerCount <= 1)
+        {
+            return AddManifestsInternal(manifestAndRelativePaths.size(), [&](size_t i)
+                {
+                    AICLI_LOG(Repo, Verbose, << "Adding manifest from file [" << manifestAndRelativePaths[i].first << "]");
+                    return std::pair<Manifest::Manifest, const std::filesystem::path&>{ Manifest::YamlParser::CreateFromPath(manifestAndRelativePaths[i].first), manifestAndRelativePaths[i].second };
+                }, onAdded);
+        }
+
+        AICLI_LOG(Repo, Info, << "Parsing " << manifestAndRelativePaths.size() << " manifests with " << workerCount << " workers");
+        ManifestParsePipeline pipeline{ manifestAndRelativePaths, workerCount };
+
+        return AddManifestsInternal(manifestAndRelativePaths.size(), [&](size_t i) { return pipeline.Get(i); }, onAdded);
+    }
+
+    std::vector<SQLiteIndex::IdType> SQLiteIndex::AddManifests(const std::vector<std::pair<Manifest::Manifest, std::filesystem::path>>& manifests)
+    {
+        return AddManifestsInternal(manifests.size(), [&](size_t i) -> const std::pair<Manifest::Manifest, std::filesystem::path>& { return manifests[i]; });
+    }
+
     SQLiteIndex::IdType SQLiteIndex::AddManifestInternal(const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath)
     {
         std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
@@ -241,10 +517,99 @@ namespace AppInstaller::Repository::Microsoft
 
     void SQLiteIndex::PrepareForPackaging()
     {
+        // The completion index is created from searches, which take the interface lock, and before packaging removes the indices that they use.
+        SQLite::blob_t completionIndex = CompletionIndex::Create(*this);
+
         std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
         AICLI_LOG(Repo, Info, << "Preparing index for packaging");
 
+        Schema::MetadataTable::SetNamedValue(m_dbconn, Schema::s_MetadataValueName_CompletionIndex, completionIndex);
+
+        // Leaving write ahead logging also checkpoints the log into the file, before it is vacuumed.
+        SetWriteModeInternal(WriteMode::Default);
+
+        // Takes effect when the interface vacuums the index.
+        m_dbconn.SetPageSize(s_PackagedPageSizeBytes);
+
         m_interface->PrepareForPackaging(m_dbconn);
+
+        // The statistics are stored in the index, so that clients choose their query plans from the published data.
+        SQLite::Builder::StatementBuilder builder;
+        builder.Analyze();
+        builder.Execute(m_dbconn);
+
+        AICLI_LOG(Repo, Info, << "Packaged index uses a page size of " << m_dbconn.GetPageSize());
+    }
+
+    void SQLiteIndex::PrepareForPackaging(const std::filesystem::path& manifestRoot)
+    {
+        {
+            std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
+            AICLI_LOG(Repo, Info, << "Embedding manifests from: " << manifestRoot);
+
+            SQLite::Savepoint savepoint = SQLite::Savepoint::Create(m_dbconn, "SQLiteIndex_EmbedManifests");
+
+            size_t manifestCount = 0;
+            for (const auto& match : m_interface->Search(m_dbconn, {}).Matches)
+            {
+                for (const auto& versionKey : m_interface->GetVersionKeysById(m_dbconn, match.first))
+                {
+                    std::optional<SQLite::rowid_t> manifestId = m_interface->GetManifestIdByKey(m_dbconn, match.first, versionKey.GetVersion().ToString(), versionKey.GetChannel().ToString());
+                    THROW_HR_IF(E_UNEXPECTED, !manifestId);
+
+                    std::optional<std::string> relativePath = m_interface->GetPropertyByManifestId(m_dbconn, manifestId.value(), PackageVersionProperty::RelativePath);
+                    THROW_HR_IF(E_NOT_SET, !relativePath);
+
+                    std::ifstream stream{ manifestRoot / Utility::ConvertToUTF16(relativePath.value()), std::ios_base::in | std::ios_base::binary };
+                    THROW_LAST_ERROR_IF(stream.fail());
+
+                    m_interface->SetManifestContentByManifestId(m_dbconn, manifestId.value(), Compression::Compress(Utility::ReadEntireStream(stream)));
+                    ++manifestCount;
+                }
+            }
+
+            SetLastWriteTime();
+
+            savepoint.Commit();
+
+            AICLI_LOG(Repo, Info, << "Embedded " << manifestCount << " manifests");
+        }
+
+        PrepareForPackaging();
+    }
+
+    void SQLiteIndex::SetWriteMode(WriteMode mode)
+    {
+        std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
+        SetWriteModeInternal(mode);
+    }
+
+    void SQLiteIndex::SetWriteModeInternal(WriteMode mode)
+    {
+        if (mode == m_writeMode)
+        {
+            return;
+        }
+
+        AICLI_LOG(Repo, Info, << "Setting index write mode to " << (mode == WriteMode::Build ? "build" : "default"));
+
+        switch (mode)
+        {
+        case WriteMode::Default:
+            m_dbconn.SetJournalMode(SQLite::Connection::JournalMode::Delete);
+            m_dbconn.SetSynchronous(SQLite::Connection::Synchronous::Full);
+            m_dbconn.SetCacheSize(s_DefaultCacheSizeKiB);
+            break;
+        case WriteMode::Build:
+            m_dbconn.SetJournalMode(SQLite::Connection::JournalMode::Wal);
+            m_dbconn.SetSynchronous(SQLite::Connection::Synchronous::Normal);
+            m_dbconn.SetCacheSize(s_BuildCacheSizeKiB);
+            break;
+        default:
+            THROW_HR(E_UNEXPECTED);
+        }
+
+        m_writeMode = mode;
     }
 
     bool SQLiteIndex::CheckConsistency(bool log) const
@@ -262,29 +627,129 @@ namespace AppInstaller::Repository::Microsoft
     Schema::ISQLiteIndex::SearchResult SQLiteIndex::Search(const SearchRequest& request) const
     {
         std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
+        Memory::AllocationScope allocationScope{ Memory::AllocationSubsystem::SQLite };
         AICLI_LOG(Repo, Verbose, << "Performing search: " << request.ToString());
 
+        std::optional<SearchResult> snapshotResult = TrySearchSnapshot(request);
+        if (snapshotResult)
+        {
+            return std::move(snapshotResult).value();
+        }
+
         return m_interface->Search(m_dbconn, request);
     }
 
+    SQLiteIndex::SearchCursor SQLiteIndex::OpenSearch(const SearchRequest& request) const
+    {
+        std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
+        Memory::AllocationScope allocationScope{ Memory::AllocationSubsystem::SQLite };
+        AICLI_LOG(Repo, Verbose, << "Opening search: " << request.ToString());
+
+        std::optional<SearchResult> snapshotResult = TrySearchSnapshot(request);
+        if (snapshotResult)
+        {
+            return { *m_interfaceLock, std::make_unique<SearchResultCursor>(std::move(snapshotResult).value()), request.MaximumResults };
+        }
+
+        return { *m_interfaceLock, m_interface->OpenSearch(m_dbconn, request), request.MaximumResults };
+    }
+
+    std::optional<SQLiteIndex::SearchResult> SQLiteIndex::TrySearchSnapshot(const SearchRequest& request) const
+    {
+        if (m_snapshotEnabled && IndexSnapshot::SupportsRequest(request))
+        {
+            if (!m_snapshot && ++m_snapshotSearchCount >= s_SnapshotSearchThreshold)
+            {
+                AICLI_LOG(Repo, Info, << "Creating index snapshot after " << m_snapshotSearchCount << " searches");
+                m_snapshot = std::make_unique<IndexSnapshot>(IndexSnapshot::Create([&](PackageMatchField field) { return m_interface->GetAllFieldValues(m_dbconn, field); }));
+            }
+
+            if (m_snapshot && m_snapshot->CanSearch(request))
+            {
+                return m_snapshot->Search(request);
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    SQLiteIndex::SearchCursor::SearchCursor(std::mutex& interfaceLock, std::unique_ptr<Schema::ISQLiteIndex::SearchCursor>&& cursor, size_t maximumResults) :
+        m_interfaceLock(&interfaceLock), m_cursor(std::move(cursor)), m_maximumResults(maximumResults)
+    {
+    }
+
+    SQLiteIndex::SearchCursor::~SearchCursor()
+    {
+        // Releasing the cursor uses the connection, to drop its results table.
+        if (m_cursor)
+        {
+            std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
+            m_cursor.reset();
+        }
+    }
+
+    SQLiteIndex::SearchResult SQLiteIndex::SearchCursor::GetNext(size_t count)
+    {
+        // The statement selects one result more than the maximum to learn whether there are more, which is never returned.
+        if (m_maximumResults)
+        {
+            size_t remaining = m_maximumResults - m_resultsRead;
+            if (!remaining)
+            {
+                SearchResult result;
+                result.Truncated = m_truncated;
+                return result;
+            }
+
+            count = (count ? std::min(count, remaining) : remaining);
+        }
+
+        std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
+        Memory::AllocationScope allocationScope{ Memory::AllocationSubsystem::SQLite };
+
+        SearchResult result = m_cursor->GetNext(count);
+        m_resultsRead += result.Matches.size();
+        m_truncated = result.Truncated;
+
+        return result;
+    }
+
     std::optional<std::string> SQLiteIndex::GetPropertyByManifestId(IdType manifestId, PackageVersionProperty property) const
     {
         std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
         return m_interface->GetPropertyByManifestId(m_dbconn, manifestId, property);
     }
 
+    SQLiteIndex::PropertiesResult SQLiteIndex::GetPropertiesByManifestIds(const std::vector<IdType>& manifestIds) const
+    {
+        std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
+        return m_interface->GetPropertiesByManifestIds(m_dbconn, manifestIds);
+    }
+
     std::vector<std::string> SQLiteIndex::GetMultiPropertyByManifestId(IdType manifestId, PackageVersionMultiProperty property) const
     {
         std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
         return m_interface->GetMultiPropertyByManifestId(m_dbconn, manifestId, property);
     }
 
+    SQLiteIndex::MultiPropertyResult SQLiteIndex::GetMultiPropertyById(IdType id, PackageVersionMultiProperty property) const
+    {
+        std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
+        return m_interface->GetMultiPropertyById(m_dbconn, id, property);
+    }
+
     std::optional<SQLiteIndex::IdType> SQLiteIndex::GetManifestIdByKey(IdType id, std::string_view version, std::string_view channel) const
     {
         std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
         return m_interface->GetManifestIdByKey(m_dbconn, id, version, channel);
     }
 
+    std::map<SQLiteIndex::IdType, SQLiteIndex::IdType> SQLiteIndex::GetLatestManifestIdsByIds(const std::vector<IdType>& ids) const
+    {
+        std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
+        return m_interface->GetLatestManifestIdsByIds(m_dbconn, ids);
+    }
+
     std::optional<SQLiteIndex::IdType> SQLiteIndex::GetManifestIdByManifest(const Manifest::Manifest& manifest) const
     {
         return m_interface->GetManifestIdByManifest(m_dbconn, manifest);
@@ -308,6 +773,31 @@ namespace AppInstaller::Repository::Microsoft
         m_interface->SetMetadataByManifestId(m_dbconn, manifestId, metadata, value);
     }
 
+    std::optional<std::string> SQLiteIndex::GetManifestContentByManifestId(IdType manifestId) const
+    {
+        std::optional<SQLite::blob_t> content;
+
+        {
+            std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
+            content = m_interface->GetManifestContentByManifestId(m_dbconn, manifestId);
+        }
+
+        if (!content)
+        {
+            return {};
+        }
+
+        return Compression::Decompress(content.value());
+    }
+
+    void SQLiteIndex::SetManifestContentByManifestId(IdType manifestId, std::string_view content)
+    {
+        SQLite::blob_t compressed = Compression::Compress(content);
+
+        std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
+        m_interface->SetManifestContentByManifestId(m_dbconn, manifestId, compressed);
+    }
+
     Utility::NormalizedName SQLiteIndex::NormalizeName(std::string_view name, std::string_view publisher) const
     {
         std::lock_guard<std::mutex> lockInterface{ *m_interfaceLock };
@@ -336,4 +826,24 @@ namespace AppInstaller::Repository::Microsoft
         int64_t lastWriteTime = Schema::MetadataTable::GetNamedValue<int64_t>(m_dbconn, Schema::s_MetadataValueName_LastWriteTime);
         return Utility::ConvertUnixEpochToSystemClock(lastWriteTime);
     }
+
+    std::optional<std::string> SQLiteIndex::GetInstalledStateValue(std::string_view name)
+    {
+        return Schema::MetadataTable::TryGetNamedValue<std::string>(m_dbconn, name);
+    }
+
+    void SQLiteIndex::SetInstalledStateValue(std::string_view name, std::string_view value)
+    {
+        Schema::MetadataTable::SetNamedValue(m_dbconn, name, value);
+    }
+
+    std::optional<SQLite::blob_t> SQLiteIndex::GetCompletionIndex()
+    {
+        return Schema::MetadataTable::TryGetNamedValue<SQLite::blob_t>(m_dbconn, Schema::s_MetadataValueName_CompletionIndex);
+    }
+
+    SQLite::Savepoint SQLiteIndex::CreateSavepoint(std::string name)
+    {
+        return SQLite::Savepoint::Create(m_dbconn, std::move(name));
+    }
 }
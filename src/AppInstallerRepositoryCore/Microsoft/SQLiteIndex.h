@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 #pragma once
 #include "SQLiteWrapper.h"
+#include "Microsoft/IndexSnapshot.h"
 #include "Microsoft/Schema/ISQLiteIndex.h"
 #include "Microsoft/Schema/Version.h"
 #include "ISource.h"
@@ -12,6 +13,7 @@
 
 #include <chrono>
 #include <filesystem>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <optional>
@@ -32,10 +34,39 @@ namespace AppInstaller::Repository::Microsoft
 
         // The return type of GetMetadataByManifestId
         using MetadataResult = Schema::ISQLiteIndex::MetadataResult;
+        using PropertiesResult = Schema::ISQLiteIndex::PropertiesResult;
+        using MultiPropertyResult = Schema::ISQLiteIndex::MultiPropertyResult;
 
         // Options for creating a new index.
         using CreateOptions = Schema::ISQLiteIndex::CreateOptions;
 
+        // Reads the results of a search from the index as they are requested.
+        // The index must not be moved or destroyed while the cursor exists, nor modified while it is in use.
+        struct SearchCursor
+        {
+            SearchCursor(std::mutex& interfaceLock, std::unique_ptr<Schema::ISQLiteIndex::SearchCursor>&& cursor, size_t maximumResults);
+
+            SearchCursor(const SearchCursor&) = delete;
+            SearchCursor& operator=(const SearchCursor&) = delete;
+
+            SearchCursor(SearchCursor&&) = default;
+            SearchCursor& operator=(SearchCursor&&) = default;
+
+            ~SearchCursor();
+
+            // Reads up to count more results, or all that remain if count is zero.
+            // The result is marked as truncated if there are more after it; once every result is read, the result is empty.
+            SearchResult GetNext(size_t count);
+
+        private:
+            std::mutex* m_interfaceLock;
+            std::unique_ptr<Schema::ISQLiteIndex::SearchCursor> m_cursor;
+            // Zero is no maximum.
+            size_t m_maximumResults;
+            size_t m_resultsRead = 0;
+            bool m_truncated = false;
+        };
+
         SQLiteIndex(const SQLiteIndex&) = delete;
         SQLiteIndex& operator=(const SQLiteIndex&) = delete;
 
@@ -59,6 +90,20 @@ namespace AppInstaller::Repository::Microsoft
         // Opens an existing index database.
         static SQLiteIndex Open(const std::string& filePath, OpenDisposition disposition);
 
+        // How changes to the index are written to disk.
+        enum class WriteMode
+        {
+            // The SQLite defaults; each committed change is synced to disk.
+            Default,
+            // For building an index to publish; changes go to a write ahead log that is not synced on every commit,
+            // with a larger page cache. A crash can lose the most recent changes, but does not corrupt the index.
+            Build,
+        };
+
+        // Sets how changes to the index are written to disk; must not be called while a savepoint is active.
+        // PrepareForPackaging returns the index to the default mode, so that the published file does not use a write ahead log.
+        void SetWriteMode(WriteMode mode);
+
         // Gets the schema version of the index.
         Schema::Version GetVersion() const { return m_version; }
 
@@ -71,6 +116,19 @@ namespace AppInstaller::Repository::Microsoft
         // Gets the last write time for the index.
         std::chrono::system_clock::time_point GetLastWriteTime();
 
+        // Gets the named value describing the installed state that the index was built from, if present.
+        std::optional<std::string> GetInstalledStateValue(std::string_view name);
+
+        // Sets the named value describing the installed state that the index was built from.
+        void SetInstalledStateValue(std::string_view name, std::string_view value);
+
+        // Gets the completion index that was stored in the index when it was prepared for packaging, if present.
+        std::optional<SQLite::blob_t> GetCompletionIndex();
+
+        // Starts a savepoint that groups all of the following changes until it is committed.
+        // Populating an on disk index is much faster this way, as each change would otherwise be committed individually.
+        SQLite::Savepoint CreateSavepoint(std::string name);
+
         // Adds the manifest at the repository relative path to the index.
         // If the function succeeds, the manifest has been added.
         // Returns the manifest id.
@@ -86,6 +144,20 @@ namespace AppInstaller::Repository::Microsoft
         // Returns the manifest id.
         IdType AddManifest(const Manifest::Manifest& manifest);
 
+        // Adds the manifests at the given paths to the index, with each at its paired repository relative path.
+        // The manifests are parsed on worker threads while the ones already parsed are added, in input order.
+        // All of the manifests are added as a single change; if the function fails, none of them have been added.
+        // If given, onAdded is called with the number of manifests added so far after each one is added.
+        // Returns the manifest ids, in the same order as the input.
+        std::vector<IdType> AddManifests(
+            const std::vector<std::pair<std::filesystem::path, std::filesystem::path>>& manifestAndRelativePaths,
+            const std::function<void(size_t)>& onAdded = {});
+
+        // Adds the manifests to the index, with each at its paired repository relative path.
+        // All of the manifests are added as a single change; if the function fails, none of them have been added.
+        // Returns the manifest ids, in the same order as the input.
+        std::vector<IdType> AddManifests(const std::vector<std::pair<Manifest::Manifest, std::filesystem::path>>& manifests);
+
         // Updates the manifest with matching { Id, Version, Channel } in the index.
         // The return value indicates whether the index was modified by the function.
         bool UpdateManifest(const std::filesystem::path& manifestPath, const std::filesystem::path& relativePath);
@@ -113,6 +185,10 @@ namespace AppInstaller::Repository::Microsoft
         // Removes data that is no longer needed for an index that is to be published.
         void PrepareForPackaging();
 
+        // Embeds every manifest, read from its relative path under manifestRoot, in the index before preparing it for packaging.
+        // Sources can then read the manifests from the index rather than downloading each of them.
+        void PrepareForPackaging(const std::filesystem::path& manifestRoot);
+
         // Checks the consistency of the index to ensure that every referenced row exists.
         // Returns true if index is consistent; false if it is not.
         bool CheckConsistency(bool log = false) const;
@@ -120,16 +196,30 @@ namespace AppInstaller::Repository::Microsoft
         // Performs a search based on the given criteria.
         SearchResult Search(const SearchRequest& request) const;
 
+        // Performs a search based on the given criteria, leaving the results to be read from the cursor as needed.
+        // The cursor reads at most SearchRequest::MaximumResults results, as Search returns, in as many calls as the caller likes.
+        SearchCursor OpenSearch(const SearchRequest& request) const;
+
         // Gets the string for the given property and manifest id, if present.
         std::optional<std::string> GetPropertyByManifestId(IdType manifestId, PackageVersionProperty property) const;
 
+        // Gets the Id, Name, Version and Channel of each of the given manifests in a single query.
+        // Manifests that are not found are not included in the result.
+        PropertiesResult GetPropertiesByManifestIds(const std::vector<IdType>& manifestIds) const;
+
         // Gets the string values for the given property and manifest id, if present.
         std::vector<std::string> GetMultiPropertyByManifestId(IdType manifestId, PackageVersionMultiProperty property) const;
 
+        // Gets the string values for the given property of every manifest with the given id, paired with their manifest id.
+        MultiPropertyResult GetMultiPropertyById(IdType id, PackageVersionMultiProperty property) const;
+
         // Gets the manifest id for the given { id, version, channel }, if present.
         // If version is empty, gets the value for the 'latest' version.
         std::optional<IdType> GetManifestIdByKey(IdType id, std::string_view version, std::string_view channel) const;
 
+        // Gets the manifest id for the 'latest' version of each of the given ids, leaving out ids that have no manifest.
+        std::map<IdType, IdType> GetLatestManifestIdsByIds(const std::vector<IdType>& ids) const;
+
         // Gets the manifest id for the given manifest, if present.
         std::optional<IdType> GetManifestIdByManifest(const Manifest::Manifest& manifest) const;
 
@@ -142,6 +232,12 @@ namespace AppInstaller::Repository::Microsoft
         // Sets the string for the given metadata and manifest id.
         void SetMetadataByManifestId(IdType manifestId, PackageVersionMetadata metadata, std::string_view value);
 
+        // Gets the manifest content embedded in the index for the given manifest id, if present.
+        std::optional<std::string> GetManifestContentByManifestId(IdType manifestId) const;
+
+        // Embeds the manifest content in the index for the given manifest id; it is stored compressed.
+        void SetManifestContentByManifestId(IdType manifestId, std::string_view content);
+
         // Normalizes a name using the internal rules used by the index.
         // Largely a utility function; should not be used to do work on behalf of the index by the caller.
         Utility::NormalizedName NormalizeName(std::string_view name, std::string_view publisher) const;
@@ -151,7 +247,8 @@ namespace AppInstaller::Repository::Microsoft
         std::vector<std::pair<SQLite::rowid_t, Utility::NormalizedString>> GetDependentsById(AppInstaller::Manifest::string_t packageId) const;
     private:
         // Constructor used to open an existing index.
-        SQLiteIndex(const std::string& target, SQLite::Connection::OpenDisposition disposition, SQLite::Connection::OpenFlags flags);
+        // If memoryMapSize is not 0, that much of the file is read through a memory mapping.
+        SQLiteIndex(const std::string& target, SQLite::Connection::OpenDisposition disposition, SQLite::Connection::OpenFlags flags, int64_t memoryMapSize = 0);
 
         // Constructor used to create a new index.
         SQLiteIndex(const std::string& target, Schema::Version version);
@@ -160,12 +257,30 @@ namespace AppInstaller::Repository::Microsoft
         IdType AddManifestInternal(const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath);
         bool UpdateManifestInternal(const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath);
 
+        // Adds count manifests as a single change, where getEntry(i) provides the { manifest, relative path } pair for index i.
+        template <typename GetEntry>
+        std::vector<IdType> AddManifestsInternal(size_t count, GetEntry&& getEntry, const std::function<void(size_t)>& onAdded = {});
+
         // Sets the last write time metadata value in the index.
         void SetLastWriteTime();
 
+        // Applies the given write mode to the connection; the interface lock must be held.
+        void SetWriteModeInternal(WriteMode mode);
+
+        // Performs the search on the snapshot if it can answer it, creating the snapshot once enough searches are performed.
+        // The interface lock must be held.
+        std::optional<SearchResult> TrySearchSnapshot(const SearchRequest& request) const;
+
         SQLite::Connection m_dbconn;
+        WriteMode m_writeMode = WriteMode::Default;
         Schema::Version m_version;
         std::unique_ptr<Schema::ISQLiteIndex> m_interface;
         std::unique_ptr<std::mutex> m_interfaceLock = std::make_unique<std::mutex>();
+
+        // An immutable index answers the searches that it can from a snapshot once enough of them have been performed;
+        // short lived uses never pay to build it. These are protected by the interface lock.
+        bool m_snapshotEnabled = false;
+        mutable size_t m_snapshotSearchCount = 0;
+        mutable std::unique_ptr<IndexSnapshot> m_snapshot;
     };
 }
@@ -0,0 +1,239 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Microsoft/SQLiteIndexDiff.h"
+#include <winget/ManifestYamlParser.h>
+
+#include <json.h>
+
+namespace AppInstaller::Repository::Microsoft
+{
+    namespace
+    {
+        using ManifestKey = std::tuple<std::string, std::string, std::string>;
+
+        struct ManifestValues
+        {
+            std::string RelativePath;
+            std::string ManifestSHA256Hash;
+        };
+
+        // Reads the key and values of every manifest in the index.
+        std::map<ManifestKey, ManifestValues> GetAllManifests(const SQLiteIndex& index)
+        {
+            std::map<ManifestKey, ManifestValues> result;
+
+            for (const auto& match : index.Search({}).Matches)
+            {
+                for (const auto& versionAndChannel : index.GetVersionKeysById(match.first))
+                {
+                    std::optional<SQLiteIndex::IdType> manifestId = index.GetManifestIdByKey(match.first, versionAndChannel.GetVersion().ToString(), versionAndChannel.GetChannel().ToString());
+                    if (!manifestId)
+                    {
+                        continue;
+                    }
+
+                    ManifestKey key{
+                        index.GetPropertyByManifestId(manifestId.value(), PackageVersionProperty::Id).value_or(std::string{}),
+                        index.GetPropertyByManifestId(manifestId.value(), PackageVersionProperty::Version).value_or(std::string{}),
+                        index.GetPropertyByManifestId(manifestId.value(), PackageVersionProperty::Channel).value_or(std::string{}) };
+
+                    ManifestValues values{
+                        index.GetPropertyByManifestId(manifestId.value(), PackageVersionProperty::RelativePath).value_or(std::string{}),
+                        index.GetPropertyByManifestId(manifestId.value(), PackageVersionProperty::ManifestSHA256Hash).value_or(std::string{}) };
+
+                    result.emplace(std::move(key), std::move(values));
+                }
+            }
+
+            return result;
+        }
+
+        SQLiteIndexChange CreateChange(SQLiteIndexChange::Type type, const ManifestKey& key, const ManifestValues& values)
+        {
+            SQLiteIndexChange result;
+            result.ChangeType = type;
+            std::tie(result.Id, result.Version, result.Channel) = key;
+            result.RelativePath = values.RelativePath;
+            result.ManifestSHA256Hash = values.ManifestSHA256Hash;
+            return result;
+        }
+
+        bool IsUpdated(const ManifestValues& oldValues, const ManifestValues& newValues)
+        {
+            if (!oldValues.ManifestSHA256Hash.empty() || !newValues.ManifestSHA256Hash.empty())
+            {
+                return oldValues.ManifestSHA256Hash != newValues.ManifestSHA256Hash;
+            }
+
+            return oldValues.RelativePath != newValues.RelativePath;
+        }
+
+        std::string_view ToString(SQLiteIndexChange::Type type)
+        {
+            switch (type)
+            {
+            case SQLiteIndexChange::Type::Added: return "Added";
+            case SQLiteIndexChange::Type::Updated: return "Updated";
+            case SQLiteIndexChange::Type::Removed: return "Removed";
+            }
+
+            THROW_HR(E_UNEXPECTED);
+        }
+
+        SQLiteIndexChange::Type ParseChangeType(std::string_view value)
+        {
+            if (value == "Added")
+            {
+                return SQLiteIndexChange::Type::Added;
+            }
+            else if (value == "Updated")
+            {
+                return SQLiteIndexChange::Type::Updated;
+            }
+            else if (value == "Removed")
+            {
+                return SQLiteIndexChange::Type::Removed;
+            }
+
+            THROW_HR_MSG(E_INVALIDARG, "Unknown change type: %hs", std::string{ value }.c_str());
+        }
+
+        std::string GetRequiredString(const Json::Value& value, const char* name, bool allowEmpty = false)
+        {
+            const Json::Value& member = value[name];
+            THROW_HR_IF_MSG(E_INVALIDARG, !member.isString(), "Change is missing %hs", name);
+
+            std::string result = member.asString();
+            THROW_HR_IF_MSG(E_INVALIDARG, !allowEmpty && result.empty(), "Change has an empty %hs", name);
+            return result;
+        }
+    }
+
+    std::vector<SQLiteIndexChange> DiffIndexes(const SQLiteIndex& oldIndex, const SQLiteIndex& newIndex)
+    {
+        std::map<ManifestKey, ManifestValues> oldManifests = GetAllManifests(oldIndex);
+        std::map<ManifestKey, ManifestValues> newManifests = GetAllManifests(newIndex);
+
+        std::vector<SQLiteIndexChange> result;
+
+        // Removals come first so that applying the changes in order never needs both an old and a new row for a key.
+        for (const auto& [key, values] : oldManifests)
+        {
+            if (newManifests.find(key) == newManifests.end())
+            {
+                result.emplace_back(CreateChange(SQLiteIndexChange::Type::Removed, key, values));
+            }
+        }
+
+        for (const auto& [key, values] : newManifests)
+        {
+            auto itr = oldManifests.find(key);
+            if (itr == oldManifests.end())
+            {
+                result.emplace_back(CreateChange(SQLiteIndexChange::Type::Added, key, values));
+            }
+            else if (IsUpdated(itr->second, values))
+            {
+                result.emplace_back(CreateChange(SQLiteIndexChange::Type::Updated, key, values));
+            }
+        }
+
+        return result;
+    }
+
+    void ApplyIndexChanges(SQLiteIndex& index, const std::vector<SQLiteIndexChange>& changes, const std::filesystem::path& manifestRoot)
+    {
+        SQLite::Savepoint savepoint = index.CreateSavepoint("sqliteindex_applychanges");
+
+        for (const auto& change : changes)
+        {
+            if (change.ChangeType == SQLiteIndexChange::Type::Removed)
+            {
+                // Removal only uses the { Id, Version, Channel } of the manifest, so there is no need for the file to exist.
+                Manifest::Manifest manifest;
+                manifest.Id = change.Id;
+                manifest.Version = change.Version;
+                manifest.Channel = change.Channel;
+
+                index.RemoveManifest(manifest);
+                continue;
+            }
+
+            std::filesystem::path relativePath = Utility::ConvertToUTF16(change.RelativePath);
+            Manifest::Manifest manifest = Manifest::YamlParser::CreateFromPath(manifestRoot / relativePath);
+
+            THROW_HR_IF_MSG(E_INVALIDARG,
+                !Utility::CaseInsensitiveEquals(manifest.Id, change.Id) || manifest.Version != change.Version || manifest.Channel != change.Channel,
+                "Manifest at %hs does not match the change for %hs", change.RelativePath.c_str(), change.Id.c_str());
+
+            if (change.ChangeType == SQLiteIndexChange::Type::Added)
+            {
+                index.AddManifest(manifest, relativePath);
+            }
+            else
+            {
+                index.UpdateManifest(manifest, relativePath);
+            }
+        }
+
+        savepoint.Commit();
+    }
+
+    std::string SerializeIndexChanges(const std::vector<SQLiteIndexChange>& changes)
+    {
+        Json::Value root{ Json::arrayValue };
+
+        for (const auto& change : changes)
+        {
+            Json::Value value{ Json::objectValue };
+            value["Type"] = std::string{ ToString(change.ChangeType) };
+            value["Id"] = change.Id;
+            value["Version"] = change.Version;
+            value["Channel"] = change.Channel;
+            value["RelativePath"] = change.RelativePath;
+            value["ManifestSHA256Hash"] = change.ManifestSHA256Hash;
+            root.append(std::move(value));
+        }
+
+        Json::StreamWriterBuilder writerBuilder;
+        writerBuilder.settings_["indentation"] = "";
+        return Json::writeString(writerBuilder, root);
+    }
+
+    std::vector<SQLiteIndexChange> DeserializeIndexChanges(std::string_view json)
+    {
+        Json::Value root;
+        Json::CharReaderBuilder builder;
+        const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+
+        std::string error;
+        if (!reader->parse(json.data(), json.data() + json.size(), &root, &error))
+        {
+            AICLI_LOG(Repo, Error, << "Error parsing index changes: " << error);
+            THROW_HR_MSG(E_INVALIDARG, "%hs", error.c_str());
+        }
+
+        THROW_HR_IF_MSG(E_INVALIDARG, !root.isArray(), "Index changes must be an array");
+
+        std::vector<SQLiteIndexChange> result;
+        result.reserve(root.size());
+
+        for (const auto& value : root)
+        {
+            THROW_HR_IF_MSG(E_INVALIDARG, !value.isObject(), "Index change must be an object");
+
+            SQLiteIndexChange change;
+            change.ChangeType = ParseChangeType(GetRequiredString(value, "Type"));
+            change.Id = GetRequiredString(value, "Id");
+            change.Version = GetRequiredString(value, "Version");
+            change.Channel = GetRequiredString(value, "Channel", true);
+            change.RelativePath = GetRequiredString(value, "RelativePath", change.ChangeType == SQLiteIndexChange::Type::Removed);
+            change.ManifestSHA256Hash = value["ManifestSHA256Hash"].isString() ? value["ManifestSHA256Hash"].asString() : std::string{};
+
+            result.emplace_back(std::move(change));
+        }
+
+        return result;
+    }
+}
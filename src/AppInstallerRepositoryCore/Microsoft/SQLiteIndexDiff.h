@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "Microsoft/SQLiteIndex.h"
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace AppInstaller::Repository::Microsoft
+{
+    // A single difference between the manifests of two indexes, keyed by { Id, Version, Channel }.
+    struct SQLiteIndexChange
+    {
+        enum class Type
+        {
+            Added,
+            Updated,
+            Removed,
+        };
+
+        Type ChangeType = Type::Added;
+        std::string Id;
+        std::string Version;
+        std::string Channel;
+
+        // The values from the newer index; for a removed manifest, the values from the older one.
+        std::string RelativePath;
+        std::string ManifestSHA256Hash;
+    };
+
+    // Determines the manifests that were added to, updated in or removed from oldIndex to produce newIndex.
+    // A manifest is updated when its hash differs, or its relative path when neither index holds a hash for it.
+    std::vector<SQLiteIndexChange> DiffIndexes(const SQLiteIndex& oldIndex, const SQLiteIndex& newIndex);
+
+    // Applies the changes to the index as a single change, reading added and updated manifests from their relative path under manifestRoot.
+    void ApplyIndexChanges(SQLiteIndex& index, const std::vector<SQLiteIndexChange>& changes, const std::filesystem::path& manifestRoot);
+
+    // Converts the changes to and from the JSON form used by WinGetUtil.
+    std::string SerializeIndexChanges(const std::vector<SQLiteIndexChange>& changes);
+    std::vector<SQLiteIndexChange> DeserializeIndexChanges(std::string_view json);
+}
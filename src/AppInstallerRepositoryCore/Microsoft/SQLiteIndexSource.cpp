@@ -2,8 +2,10 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "Microsoft/SQLiteIndexSource.h"
+#include "Microsoft/ManifestCache.h"
 #include "Microsoft/PreIndexedPackageSourceFactory.h"
 #include <winget/ManifestYamlParser.h>
+#include <winget/Timing.h>
 
 
 using namespace AppInstaller::Utility;
@@ -13,6 +15,19 @@ namespace AppInstaller::Repository::Microsoft
 {
     namespace
     {
+        // The number of results read from the index at a time by a search.
+        constexpr size_t s_SearchPageSize = 100;
+
+        void LogManifestCacheResult(bool hit)
+        {
+            Logging::Telemetry().LogManifestCacheResult(hit);
+
+            if (Timing::IsUsageEnabled())
+            {
+                Timing::RecordCacheLookup("Manifest", hit);
+            }
+        }
+
         // The base for the package objects.
         struct SourceReference
         {
@@ -37,6 +52,10 @@ namespace AppInstaller::Repository::Microsoft
             PackageVersion(const std::shared_ptr<SQLiteIndexSource>& source, SQLiteIndex::IdType manifestId) :
                 SourceReference(source), m_manifestId(manifestId) {}
 
+            // Creates the version with property values already read from the index.
+            PackageVersion(const std::shared_ptr<SQLiteIndexSource>& source, SQLiteIndex::IdType manifestId, std::map<PackageVersionProperty, std::string>&& properties) :
+                SourceReference(source), m_manifestId(manifestId), m_properties(std::move(properties)) {}
+
             // Inherited via IPackageVersion
             Utility::LocIndString GetProperty(PackageVersionProperty property) const override
             {
@@ -46,10 +65,21 @@ namespace AppInstaller::Repository::Microsoft
                     return LocIndString{ GetReferenceSource()->GetIdentifier() };
                 case PackageVersionProperty::SourceName:
                     return LocIndString{ GetReferenceSource()->GetDetails().Name };
+                case PackageVersionProperty::InstallerSummary:
+                    // Only present in newer indexes; the absence of a summary is not an error.
+                    return LocIndString{ GetReferenceSource()->GetIndex().GetPropertyByManifestId(m_manifestId, property).value_or(std::string{}) };
                 default:
+                {
                     // Values coming from the index will always be localized/independent.
+                    auto itr = m_properties.find(property);
+                    if (itr != m_properties.end())
+                    {
+                        return LocIndString{ itr->second };
+                    }
+
                     return LocIndString{ GetReferenceSource()->GetIndex().GetPropertyByManifestId(m_manifestId, property).value() };
                 }
+                }
             }
 
             std::vector<Utility::LocIndString> GetMultiProperty(PackageVersionMultiProperty property) const override
@@ -67,18 +97,31 @@ namespace AppInstaller::Repository::Microsoft
 
             Manifest::Manifest GetManifest() override
             {
+                Timing::Span span{ Timing::Phase::ManifestFetch };
                 std::shared_ptr<SQLiteIndexSource> source = GetReferenceSource();
 
+                // Manifests may be prefetched concurrently, so the index is only read while holding the lock.
+                std::unique_lock<std::mutex> readLock{ source->GetConcurrentReadLock() };
+
                 std::optional<std::string> relativePathOpt = source->GetIndex().GetPropertyByManifestId(m_manifestId, PackageVersionProperty::RelativePath);
                 THROW_HR_IF(E_NOT_SET, !relativePathOpt);
 
                 std::optional<std::string> manifestHashString = source->GetIndex().GetPropertyByManifestId(m_manifestId, PackageVersionProperty::ManifestSHA256Hash);
+
+                std::optional<std::string> embeddedContent = source->GetIndex().GetManifestContentByManifestId(m_manifestId);
+                readLock.unlock();
+
                 SHA256::HashBuffer manifestSHA256;
                 if (manifestHashString)
                 {
                     manifestSHA256 = SHA256::ConvertToBytes(manifestHashString.value());
                 }
 
+                if (embeddedContent)
+                {
+                    return GetManifestFromEmbeddedContent(embeddedContent.value(), manifestSHA256);
+                }
+
                 return GetManifestFromArgAndRelativePath(source->GetDetails().Arg, relativePathOpt.value(), manifestSHA256);
             }
 
@@ -101,8 +144,48 @@ namespace AppInstaller::Repository::Microsoft
             }
 
         private:
+            // Embedded manifests are read from the index itself, so no request is needed for them.
+            static Manifest::Manifest GetManifestFromEmbeddedContent(const std::string& content, const SHA256::HashBuffer& expectedHash)
+            {
+                ManifestCache& cache = ManifestCache::GetDefault();
+                if (!expectedHash.empty())
+                {
+                    std::optional<Manifest::Manifest> cached = cache.Get(expectedHash);
+                    LogManifestCacheResult(cached.has_value());
+                    if (cached)
+                    {
+                        return std::move(cached).value();
+                    }
+
+                    THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE, !SHA256::AreEqual(expectedHash, SHA256::ComputeHash(content)));
+                }
+
+                AICLI_LOG(Repo, Info, << "Reading manifest embedded in the index");
+                Manifest::Manifest result = Manifest::YamlParser::Create(content);
+
+                // As with local files, the content is already on disk, so it is only kept in memory.
+                if (!expectedHash.empty())
+                {
+                    cache.Add(expectedHash, result);
+                }
+
+                return result;
+            }
+
             static Manifest::Manifest GetManifestFromArgAndRelativePath(const std::string& arg, const std::string& relativePath, const SHA256::HashBuffer& expectedHash)
             {
+                // Manifests are only cached by the hash from the index, as that is what identifies their contents.
+                ManifestCache& cache = ManifestCache::GetDefault();
+                if (!expectedHash.empty())
+                {
+                    std::optional<Manifest::Manifest> cached = cache.Get(expectedHash);
+                    LogManifestCacheResult(cached.has_value());
+                    if (cached)
+                    {
+                        return std::move(cached).value();
+                    }
+                }
+
                 std::string fullPath = arg;
                 if (fullPath.back() != '/')
                 {
@@ -112,7 +195,8 @@ namespace AppInstaller::Repository::Microsoft
 
                 if (Utility::IsUrlRemote(fullPath))
                 {
-                    std::ostringstream manifestStream;
+                    // The content is downloaded straight into this string, which is also what is parsed and cached.
+                    std::string manifestContents;
 
                     AICLI_LOG(Repo, Info, << "Downloading manifest");
                     ProgressCallback emptyCallback;
@@ -123,7 +207,7 @@ namespace AppInstaller::Repository::Microsoft
                         bool success = false;
                         try
                         {
-                            auto downloadHash = Utility::DownloadToStream(fullPath, manifestStream, Utility::DownloadType::Manifest, emptyCallback, !expectedHash.empty());
+                            auto downloadHash = Utility::DownloadToString(fullPath, manifestContents, Utility::DownloadType::Manifest, emptyCallback, !expectedHash.empty());
 
                             if (!expectedHash.empty() &&
                                 (!downloadHash || downloadHash->size() != expectedHash.size() || !std::equal(expectedHash.begin(), expectedHash.end(), downloadHash->begin())))
@@ -152,10 +236,16 @@ namespace AppInstaller::Repository::Microsoft
                         }
                     }
 
-                    std::string manifestContents = manifestStream.str();
                     AICLI_LOG(Repo, Verbose, << "Manifest contents: " << manifestContents);
 
-                    return Manifest::YamlParser::Create(manifestContents);
+                    Manifest::Manifest result = Manifest::YamlParser::Create(manifestContents);
+
+                    if (!expectedHash.empty())
+                    {
+                        cache.Add(expectedHash, result, manifestContents);
+                    }
+
+                    return result;
                 }
                 else
                 {
@@ -168,18 +258,78 @@ namespace AppInstaller::Repository::Microsoft
                         THROW_HR(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE);
                     }
 
+                    // Local files are cheap to read again, so they are only kept in memory.
+                    if (!expectedHash.empty())
+                    {
+                        cache.Add(expectedHash, result);
+                    }
+
                     return result;
                 }
             }
 
             SQLiteIndex::IdType m_manifestId;
+            std::map<PackageVersionProperty, std::string> m_properties;
+        };
+
+        // The latest versions of the packages found by a search, read for all of them when the first one is needed.
+        struct SearchLatestVersions
+        {
+            SearchLatestVersions(std::vector<SQLiteIndex::IdType>&& ids) : m_ids(std::move(ids)) {}
+
+            std::shared_ptr<IPackageVersion> Get(const std::shared_ptr<SQLiteIndexSource>& source, SQLiteIndex::IdType id)
+            {
+                std::lock_guard<std::mutex> lock{ m_mutex };
+
+                if (!m_read)
+                {
+                    // One query finds the latest manifests and another reads their common properties,
+                    // rather than a query for each result and then for each property of it.
+                    const SQLiteIndex& index = source->GetIndex();
+                    std::map<SQLiteIndex::IdType, SQLiteIndex::IdType> latestManifestIds = index.GetLatestManifestIdsByIds(m_ids);
+
+                    std::vector<SQLiteIndex::IdType> manifestIds;
+                    manifestIds.reserve(latestManifestIds.size());
+                    for (const auto& latest : latestManifestIds)
+                    {
+                        manifestIds.emplace_back(latest.second);
+                    }
+
+                    SQLiteIndex::PropertiesResult properties = index.GetPropertiesByManifestIds(manifestIds);
+
+                    for (const auto& latest : latestManifestIds)
+                    {
+                        auto itr = properties.find(latest.second);
+                        if (itr != properties.end())
+                        {
+                            m_versions.emplace(latest.first, std::make_shared<PackageVersion>(source, latest.second, std::move(itr->second)));
+                        }
+                        else
+                        {
+                            m_versions.emplace(latest.first, std::make_shared<PackageVersion>(source, latest.second));
+                        }
+                    }
+
+                    m_ids.clear();
+                    m_read = true;
+                }
+
+                auto itr = m_versions.find(id);
+                return (itr != m_versions.end() ? itr->second : nullptr);
+            }
+
+        private:
+            std::mutex m_mutex;
+            bool m_read = false;
+            std::vector<SQLiteIndex::IdType> m_ids;
+            std::map<SQLiteIndex::IdType, std::shared_ptr<IPackageVersion>> m_versions;
         };
 
         // The base for IPackage implementations here.
         struct PackageBase : public SourceReference
         {
-            PackageBase(const std::shared_ptr<SQLiteIndexSource>& source, SQLiteIndex::IdType idId) :
-                SourceReference(source), m_idId(idId) {}
+            PackageBase(const std::shared_ptr<SQLiteIndexSource>& source, SQLiteIndex::IdType idId, std::shared_ptr<SearchLatestVersions> latestVersions = {}) :
+                SourceReference(source), m_idId(idId), m_latestVersions(std::move(latestVersions)) {}
 
             Utility::LocIndString GetProperty(PackageProperty property) const
             {
@@ -211,6 +361,12 @@ namespace AppInstaller::Repository::Microsoft
             std::shared_ptr<IPackageVersion> GetLatestVersionInternal() const
             {
                 std::shared_ptr<SQLiteIndexSource> source = GetReferenceSource();
+
+                if (m_latestVersions)
+                {
+                    return m_latestVersions->Get(source, m_idId);
+                }
+
                 std::optional<SQLiteIndex::IdType> manifestId = source->GetIndex().GetManifestIdByKey(m_idId, {}, {});
 
                 if (manifestId)
@@ -222,6 +378,10 @@ namespace AppInstaller::Repository::Microsoft
             }
 
             SQLiteIndex::IdType m_idId;
+
+        private:
+            // The latest versions of the results of the search that found the package, if any.
+            std::shared_ptr<SearchLatestVersions> m_latestVersions;
         };
 
         // The IPackage impl for SQLiteIndexSource of Available packages.
@@ -253,6 +413,20 @@ namespace AppInstaller::Repository::Microsoft
                 return result;
             }
 
+            std::vector<PackageVersionKey> GetLatestAvailableVersionKeys(size_t count) const override
+            {
+                std::shared_ptr<SQLiteIndexSource> source = GetReferenceSource();
+                std::vector<Utility::VersionAndChannel> versions = source->GetIndex().GetVersionKeysById(m_idId);
+
+                // The versions can only be ordered once they are all read, but only the keys that are returned need to be made
+                std::vector<PackageVersionKey> result;
+                for (size_t i = 0; i < versions.size() && i < count; ++i)
+                {
+                    result.emplace_back(source->GetIdentifier(), versions[i].GetVersion().ToString(), versions[i].GetChannel().ToString());
+                }
+                return result;
+            }
+
             std::shared_ptr<IPackageVersion> GetLatestAvailableVersion() const override
             {
                 return GetLatestVersionInternal();
@@ -278,6 +452,29 @@ namespace AppInstaller::Repository::Microsoft
                 return {};
             }
 
+            std::vector<MultiProperties> GetAvailableVersionsMultiProperties(const std::vector<PackageVersionMultiProperty>& properties) const override
+            {
+                std::shared_ptr<SQLiteIndexSource> source = GetReferenceSource();
+
+                // One query per property covers every version, rather than one per property per version.
+                std::map<SQLiteIndex::IdType, MultiProperties> byManifest;
+                for (auto property : properties)
+                {
+                    for (auto&& value : source->GetIndex().GetMultiPropertyById(m_idId, property))
+                    {
+                        // Values coming from the index will always be localized/independent.
+                        byManifest[value.first][property].emplace_back(std::move(value.second));
+                    }
+                }
+
+                std::vector<MultiProperties> result;
+                for (auto&& manifest : byManifest)
+                {
+                    result.emplace_back(std::move(manifest.second));
+                }
+                return result;
+            }
+
             bool IsUpdateAvailable() const override
             {
                 return false;
@@ -363,32 +560,61 @@ namespace AppInstaller::Repository::Microsoft
 
     SearchResult SQLiteIndexSource::Search(const SearchRequest& request) const
     {
-        auto indexResults = m_index.Search(request);
+        // The results statement is stepped a page at a time, rather than reading every row before the first package is made.
+        SQLiteIndex::SearchCursor cursor = m_index.OpenSearch(request);
 
         SearchResult result;
         std::shared_ptr<SQLiteIndexSource> sharedThis = NonConstSharedFromThis();
-        for (auto& indexResult : indexResults.Matches)
+
+        for (;;)
         {
-            std::unique_ptr<IPackage> package;
+            auto indexResults = cursor.GetNext(s_SearchPageSize);
+            result.Truncated = indexResults.Truncated;
 
-            if (m_isInstalled)
+            if (indexResults.Matches.empty())
             {
-                package = std::make_unique<InstalledPackage>(sharedThis, indexResult.first);
+                break;
             }
-            else
+
+            // Nearly every caller reads the common properties of the latest version of each result,
+            // so the first one to do so reads them for all of the results in its page.
+            std::vector<SQLiteIndex::IdType> ids;
+            ids.reserve(indexResults.Matches.size());
+            for (const auto& indexResult : indexResults.Matches)
             {
-                package = std::make_unique<AvailablePackage>(sharedThis, indexResult.first);
+                ids.emplace_back(indexResult.first);
             }
 
-            result.Matches.emplace_back(std::move(package), std::move(indexResult.second));
+            auto latestVersions = std::make_shared<SearchLatestVersions>(std::move(ids));
+
+            for (auto& indexResult : indexResults.Matches)
+            {
+                std::unique_ptr<IPackage> package;
+
+                if (m_isInstalled)
+                {
+                    package = std::make_unique<InstalledPackage>(sharedThis, indexResult.first, latestVersions);
+                }
+                else
+                {
+                    package = std::make_unique<AvailablePackage>(sharedThis, indexResult.first, latestVersions);
+                }
+
+                result.Matches.emplace_back(std::move(package), std::move(indexResult.second));
+            }
+
+            if (!indexResults.Truncated)
+            {
+                break;
+            }
         }
-        result.Truncated = indexResults.Truncated;
+
         return result;
     }
 
     bool SQLiteIndexSource::IsSame(const SQLiteIndexSource* other) const
     {
-        return (other && GetIdentifier() == other->GetIdentifier());
+        return (other && GetIdentifier() == other->GetIdentifier() && m_shard == other->m_shard);
     }
 
     std::shared_ptr<SQLiteIndexSource> SQLiteIndexSource::NonConstSharedFromThis() const
@@ -401,13 +627,82 @@ namespace AppInstaller::Repository::Microsoft
     {
     }
 
+    SearchResult SQLiteIndexWriteableSource::Search(const SearchRequest& request) const
+    {
+        ApplyChanges();
+        return SQLiteIndexSource::Search(request);
+    }
+
     void SQLiteIndexWriteableSource::AddPackageVersion(const Manifest::Manifest& manifest, const std::filesystem::path& relativePath)
     {
-        m_index.AddManifest(manifest, relativePath);
+        std::lock_guard<std::mutex> lock{ m_changesLock };
+
+        auto [itr, inserted] = m_packageVersions.try_emplace(relativePath.u8string());
+        if (inserted)
+        {
+            itr->second.Manifest = manifest;
+            itr->second.RelativePath = relativePath;
+        }
+
+        ++itr->second.Count;
+        m_hasChanges = true;
     }
     
-    void SQLiteIndexWriteableSource::RemovePackageVersion(const Manifest::Manifest& manifest, const std::filesystem::path& relativePath)
+    void SQLiteIndexWriteableSource::RemovePackageVersion(const Manifest::Manifest&, const std::filesystem::path& relativePath)
     {
-        m_index.RemoveManifest(manifest, relativePath);
+        std::lock_guard<std::mutex> lock{ m_changesLock };
+
+        auto itr = m_packageVersions.find(relativePath.u8string());
+        if (itr != m_packageVersions.end() && --itr->second.Count == 0)
+        {
+            m_packageVersions.erase(itr);
+            m_hasChanges = true;
+        }
+    }
+
+    void SQLiteIndexWriteableSource::ApplyChanges() const
+    {
+        std::lock_guard<std::mutex> lock{ m_changesLock };
+
+        if (!m_hasChanges)
+        {
+            return;
+        }
+
+        SQLiteIndex& index = const_cast<SQLiteIndex&>(m_index);
+
+        for (auto itr = m_indexedPackageVersions.begin(); itr != m_indexedPackageVersions.end();)
+        {
+            if (m_packageVersions.count(itr->first) == 0)
+            {
+                // A failure to apply one change must not prevent searching the others.
+                try
+                {
+                    index.RemoveManifest(itr->second.Manifest, itr->second.RelativePath);
+                }
+                CATCH_LOG();
+
+                itr = m_indexedPackageVersions.erase(itr);
+            }
+            else
+            {
+                ++itr;
+            }
+        }
+
+        for (const auto& packageVersion : m_packageVersions)
+        {
+            if (m_indexedPackageVersions.count(packageVersion.first) == 0)
+            {
+                try
+                {
+                    index.AddManifest(packageVersion.second.Manifest, packageVersion.second.RelativePath);
+                    m_indexedPackageVersions.emplace(packageVersion);
+                }
+                CATCH_LOG();
+            }
+        }
+
+        m_hasChanges = false;
     }
 }
@@ -6,6 +6,8 @@
 #include <AppInstallerSynchronization.h>
 
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 
 namespace AppInstaller::Repository::Microsoft
@@ -45,18 +47,28 @@ namespace AppInstaller::Repository::Microsoft
         // Determines if the other source refers to the same as this.
         bool IsSame(const SQLiteIndexSource* other) const;
 
+        // Sets which shard of a sharded index this source holds; the shards of a source share its identifier.
+        void SetShard(uint32_t shard) { m_shard = shard; }
+
+        // Gets the lock that serializes the index reads of the calls that may be made concurrently, like getting manifests.
+        std::mutex& GetConcurrentReadLock() const { return m_concurrentReadLock; }
+
     private:
         std::shared_ptr<SQLiteIndexSource> NonConstSharedFromThis() const;
 
         SourceDetails m_details;
         Synchronization::CrossProcessReaderWriteLock m_lock;
         bool m_isInstalled;
+        uint32_t m_shard = 0;
+        mutable std::mutex m_concurrentReadLock;
 
     protected:
         SQLiteIndex m_index;
     };
 
-    // A source that holds a SQLiteIndex and lock.
+    // A source that holds a SQLiteIndex and lock, and whose package versions can be added and removed.
+    // Adding and removing only records the change in memory; the index is brought up to date by the next search,
+    // so that package versions that come and go before anyone searches never touch the index.
     struct SQLiteIndexWriteableSource : public SQLiteIndexSource, public IMutablePackageSource
     {
         SQLiteIndexWriteableSource(
@@ -65,10 +77,33 @@ namespace AppInstaller::Repository::Microsoft
             Synchronization::CrossProcessReaderWriteLock&& lock = {},
             bool isInstalledSource = false);
 
+        // Execute a search on the source.
+        SearchResult Search(const SearchRequest& request) const override;
+
         // Adds a package version to the source.
         void AddPackageVersion(const Manifest::Manifest& manifest, const std::filesystem::path& relativePath);
 
         // Removes a package version from the source.
         void RemovePackageVersion(const Manifest::Manifest& manifest, const std::filesystem::path& relativePath);
+
+    private:
+        // A package version, held until it is written to or removed from the index.
+        struct PackageVersionEntry
+        {
+            Manifest::Manifest Manifest;
+            std::filesystem::path RelativePath;
+            // The number of times that the package version has been added without being removed.
+            size_t Count = 0;
+        };
+
+        // Writes the changes made since the last search to the index.
+        void ApplyChanges() const;
+
+        mutable std::mutex m_changesLock;
+        // The package versions that the source should contain, keyed by their relative path.
+        std::unordered_map<std::string, PackageVersionEntry> m_packageVersions;
+        // The package versions that have been written to the index.
+        mutable std::unordered_map<std::string, PackageVersionEntry> m_indexedPackageVersions;
+        mutable bool m_hasChanges = false;
     };
 }
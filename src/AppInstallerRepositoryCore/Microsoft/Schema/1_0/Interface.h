@@ -23,11 +23,16 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         void PrepareForPackaging(SQLite::Connection& connection) override;
         bool CheckConsistency(const SQLite::Connection& connection, bool log) const override;
         SearchResult Search(const SQLite::Connection& connection, const SearchRequest& request) const override;
+        std::unique_ptr<SearchCursor> OpenSearch(const SQLite::Connection& connection, const SearchRequest& request) const override;
         std::optional<std::string> GetPropertyByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId, PackageVersionProperty property) const override;
+        PropertiesResult GetPropertiesByManifestIds(const SQLite::Connection& connection, const std::vector<SQLite::rowid_t>& manifestIds) const override;
         std::vector<std::string> GetMultiPropertyByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId, PackageVersionMultiProperty property) const override;
+        MultiPropertyResult GetMultiPropertyById(const SQLite::Connection& connection, SQLite::rowid_t id, PackageVersionMultiProperty property) const override;
         std::optional<SQLite::rowid_t> GetManifestIdByKey(const SQLite::Connection& connection, SQLite::rowid_t id, std::string_view version, std::string_view channel) const override;
+        std::map<SQLite::rowid_t, SQLite::rowid_t> GetLatestManifestIdsByIds(const SQLite::Connection& connection, const std::vector<SQLite::rowid_t>& ids) const override;
         std::optional<SQLite::rowid_t> GetManifestIdByManifest(const SQLite::Connection& connection, const Manifest::Manifest& manifest) const override;
         std::vector<Utility::VersionAndChannel> GetVersionKeysById(const SQLite::Connection& connection, SQLite::rowid_t id) const override;
+        std::optional<FieldValuesResult> GetAllFieldValues(const SQLite::Connection& connection, PackageMatchField field) const override;
 
         // Version 1.1
         MetadataResult GetMetadataByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId) const override;
@@ -39,6 +44,10 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         // Version 1.4 Get all the dependencies for a specific manifest.
         std::set<std::pair<SQLite::rowid_t, Utility::NormalizedString>> GetDependenciesByManifestRowId(const SQLite::Connection& connection, SQLite::rowid_t manifestRowId) const override;
         std::vector<std::pair<SQLite::rowid_t, Utility::NormalizedString>> GetDependentsById(const SQLite::Connection& connection, AppInstaller::Manifest::string_t packageId) const override;   
+
+        // Version 1.6
+        std::optional<SQLite::blob_t> GetManifestContentByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId) const override;
+        void SetManifestContentByManifestId(SQLite::Connection& connection, SQLite::rowid_t manifestId, const SQLite::blob_t& content) override;
     
     protected:
         virtual bool NotNeeded(const SQLite::Connection& connection, std::string_view tableName, std::string_view valueName, SQLite::rowid_t id) const;
@@ -52,6 +61,10 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         // Executes all relevant searches for the query.
         virtual void PerformQuerySearch(SearchResultsTable& resultsTable, const RequestMatch& query) const;
 
+        // Opens a cursor over the search results, with the statement selecting at most limit results; zero is no limit.
+        // Both Search and OpenSearch come through here, so later versions override it to update the request first.
+        virtual std::unique_ptr<SearchCursor> OpenSearchWithLimit(const SQLite::Connection& connection, const SearchRequest& request, size_t limit) const;
+
         // Gets a property already knowing that the manifest id is valid.
         virtual std::optional<std::string> GetPropertyByManifestIdInternal(const SQLite::Connection& connection, SQLite::rowid_t manifestId, PackageVersionProperty property) const;
     };
@@ -440,20 +440,34 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
     }
 
     ISQLiteIndex::SearchResult Interface::Search(const SQLite::Connection& connection, const SearchRequest& request) const
+    {
+        return OpenSearch(connection, request)->GetNext(request.MaximumResults);
+    }
+
+    std::unique_ptr<ISQLiteIndex::SearchCursor> Interface::OpenSearch(const SQLite::Connection& connection, const SearchRequest& request) const
+    {
+        // One row more than the maximum is selected to learn whether the results were truncated.
+        // With the limit in the statement, SQLite only keeps the best ranked rows as it sorts, rather than all of them.
+        size_t limit = (request.MaximumResults ? request.MaximumResults + 1 : 0);
+        return OpenSearchWithLimit(connection, request, limit);
+    }
+
+    std::unique_ptr<ISQLiteIndex::SearchCursor> Interface::OpenSearchWithLimit(const SQLite::Connection& connection, const SearchRequest& request, size_t limit) const
     {
         if (request.IsForEverything())
         {
-            std::vector<SQLite::rowid_t> ids = IdTable::GetAllRowIds(connection, request.MaximumResults);
+            // Every id is a wildcard match, so select the same columns as the results table would:
+            //  SELECT rowid, <Id>, <Wildcard>, '' from ids order by id [limit <limit>]
+            SQLite::Builder::StatementBuilder builder;
+            builder.Select().Column(SQLite::RowIDName).Value(PackageMatchField::Id).Value(MatchType::Wildcard).Value(std::string{}).
+                From(IdTable::TableName()).OrderBy(IdTable::ValueName());
 
-            SearchResult result;
-            for (SQLite::rowid_t id : ids)
+            if (limit)
             {
-                result.Matches.emplace_back(std::make_pair(id, PackageMatchFilter(PackageMatchField::Id, MatchType::Wildcard)));
+                builder.Limit(limit);
             }
 
-            result.Truncated = (request.MaximumResults && IdTable::GetCount(connection) > request.MaximumResults);
-
-            return result;
+            return std::make_unique<SearchResultsCursor>(builder.Prepare(connection));
         }
 
         // First phase, create the search results table and populate it with the initial results.
@@ -522,7 +536,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
             resultsTable->CompleteFilter();
         }
 
-        return resultsTable->GetSearchResults(request.MaximumResults);
+        return std::make_unique<SearchResultsCursor>(std::move(resultsTable), limit);
     }
 
     std::optional<std::string> Interface::GetPropertyByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId, PackageVersionProperty property) const
@@ -536,16 +550,54 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         return GetPropertyByManifestIdInternal(connection, manifestId, property);
     }
 
+    ISQLiteIndex::PropertiesResult Interface::GetPropertiesByManifestIds(const SQLite::Connection& connection, const std::vector<SQLite::rowid_t>& manifestIds) const
+    {
+        PropertiesResult result;
+
+        for (auto&& values : ManifestTable::GetValuesByIds<IdTable, NameTable, VersionTable, ChannelTable>(connection, manifestIds))
+        {
+            auto& properties = result[std::get<0>(values)];
+            properties.emplace(PackageVersionProperty::Id, std::move(std::get<1>(values)));
+            properties.emplace(PackageVersionProperty::Name, std::move(std::get<2>(values)));
+            properties.emplace(PackageVersionProperty::Version, std::move(std::get<3>(values)));
+            properties.emplace(PackageVersionProperty::Channel, std::move(std::get<4>(values)));
+        }
+
+        return result;
+    }
+
     std::vector<std::string> Interface::GetMultiPropertyByManifestId(const SQLite::Connection&, SQLite::rowid_t, PackageVersionMultiProperty) const
     {
         return {};
     }
 
+    ISQLiteIndex::MultiPropertyResult Interface::GetMultiPropertyById(const SQLite::Connection&, SQLite::rowid_t, PackageVersionMultiProperty) const
+    {
+        return {};
+    }
+
     std::optional<SQLite::rowid_t> Interface::GetManifestIdByKey(const SQLite::Connection& connection, SQLite::rowid_t id, std::string_view version, std::string_view channel) const
     {
         return StaticGetManifestIdByKey(connection, id, version, channel);
     }
 
+    std::map<SQLite::rowid_t, SQLite::rowid_t> Interface::GetLatestManifestIdsByIds(const SQLite::Connection& connection, const std::vector<SQLite::rowid_t>& ids) const
+    {
+        // Without a record of the latest manifests, each one is found by ordering the versions of its id.
+        std::map<SQLite::rowid_t, SQLite::rowid_t> result;
+
+        for (SQLite::rowid_t id : ids)
+        {
+            std::optional<SQLite::rowid_t> manifestId = GetManifestIdByKey(connection, id, {}, {});
+            if (manifestId)
+            {
+                result.emplace(id, manifestId.value());
+            }
+        }
+
+        return result;
+    }
+
     std::optional<SQLite::rowid_t> Interface::GetManifestIdByManifest(const SQLite::Connection& connection, const Manifest::Manifest& manifest) const
     {
         return GetExistingManifestId(connection, manifest);
@@ -561,6 +613,15 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         return {};
     }
 
+    std::optional<SQLite::blob_t> Interface::GetManifestContentByManifestId(const SQLite::Connection&, SQLite::rowid_t) const
+    {
+        return {};
+    }
+
+    void Interface::SetManifestContentByManifestId(SQLite::Connection&, SQLite::rowid_t, const SQLite::blob_t&)
+    {
+    }
+
     std::vector<Utility::VersionAndChannel> Interface::GetVersionKeysById(const SQLite::Connection& connection, SQLite::rowid_t id) const
     {
         auto versionsAndChannels = ManifestTable::GetAllValuesById<IdTable, VersionTable, ChannelTable>(connection, id);
@@ -577,6 +638,21 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         return result;
     }
 
+    std::optional<ISQLiteIndex::FieldValuesResult> Interface::GetAllFieldValues(const SQLite::Connection& connection, PackageMatchField field) const
+    {
+        switch (field)
+        {
+        case PackageMatchField::Id:
+            return ManifestTable::GetAllIdsAndValues<IdTable, IdTable>(connection);
+        case PackageMatchField::Name:
+            return ManifestTable::GetAllIdsAndValues<IdTable, NameTable>(connection);
+        case PackageMatchField::Moniker:
+            return ManifestTable::GetAllIdsAndValues<IdTable, MonikerTable>(connection);
+        default:
+            return {};
+        }
+    }
+
     ISQLiteIndex::MetadataResult Interface::GetMetadataByManifestId(const SQLite::Connection&, SQLite::rowid_t) const
     {
         return {};
@@ -105,6 +105,52 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
             return result;
         }
 
+        // SELECT [manifest].[rowid], [ids].[id] FROM [manifest]
+        // JOIN [ids] ON [manifest].[id] = [ids].[rowid]
+        // WHERE [manifest].[rowid] IN (?, ...)
+        SQLite::Statement ManifestTableGetValuesByIds_Statement(
+            const SQLite::Connection& connection,
+            size_t count,
+            std::initializer_list<SQLite::Builder::QualifiedColumn> columns)
+        {
+            using QCol = SQLite::Builder::QualifiedColumn;
+
+            SQLite::Builder::StatementBuilder builder;
+            builder.Select().Column(QCol{ s_ManifestTable_Table_Name, SQLite::RowIDName });
+
+            for (const QCol& column : columns)
+            {
+                builder.Column(column);
+            }
+
+            builder.From(s_ManifestTable_Table_Name);
+
+            for (const QCol& column : columns)
+            {
+                builder.Join(column.Table).On(QCol{ s_ManifestTable_Table_Name, column.Column }, QCol{ column.Table, SQLite::RowIDName });
+            }
+
+            builder.Where(QCol{ s_ManifestTable_Table_Name, SQLite::RowIDName }).In(count);
+
+            return builder.Prepare(connection);
+        }
+
+        // SELECT [manifest].[id], [names].[name] FROM [manifest]
+        // JOIN [names] ON [manifest].[name] = [names].[rowid]
+        SQLite::Statement ManifestTableGetAllIdsAndValues_Statement(
+            const SQLite::Connection& connection,
+            std::string_view idColumn,
+            const SQLite::Builder::QualifiedColumn& valueColumn)
+        {
+            using QCol = SQLite::Builder::QualifiedColumn;
+
+            SQLite::Builder::StatementBuilder builder;
+            builder.Select({ QCol{ s_ManifestTable_Table_Name, idColumn }, valueColumn }).From(s_ManifestTable_Table_Name).
+                Join(valueColumn.Table).On(QCol{ s_ManifestTable_Table_Name, valueColumn.Column }, QCol{ valueColumn.Table, SQLite::RowIDName });
+
+            return builder.Prepare(connection);
+        }
+
         SQLite::Statement ManifestTableGetAllValuesByIds_Statement(
             const SQLite::Connection& connection,
             std::initializer_list<SQLite::Builder::QualifiedColumn> valueColumns,
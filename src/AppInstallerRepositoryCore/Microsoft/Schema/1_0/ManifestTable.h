@@ -31,6 +31,22 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
             SQLite::rowid_t id,
             std::initializer_list<SQLite::Builder::QualifiedColumn> columns);
 
+        // The maximum number of manifest rowids bound to a single statement by GetValuesByIds.
+        constexpr size_t ManifestTableMaximumIdsPerStatement = 500;
+
+        // Gets the manifest rowid and the requested values for the manifests with the given rowids.
+        // The rowids must be bound to indices 1 through count.
+        SQLite::Statement ManifestTableGetValuesByIds_Statement(
+            const SQLite::Connection& connection,
+            size_t count,
+            std::initializer_list<SQLite::Builder::QualifiedColumn> columns);
+
+        // Gets the value of the id column and the given value for every manifest.
+        SQLite::Statement ManifestTableGetAllIdsAndValues_Statement(
+            const SQLite::Connection& connection,
+            std::string_view idColumn,
+            const SQLite::Builder::QualifiedColumn& valueColumn);
+
         // Gets all values for rows that match the given ids.
         SQLite::Statement ManifestTableGetAllValuesByIds_Statement(
             const SQLite::Connection& connection,
@@ -129,6 +145,48 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
             return details::ManifestTableGetValuesById_Statement(connection, id, { SQLite::Builder::QualifiedColumn{ Tables::TableName(), Tables::ValueName() }... }).GetRow<Tables::value_t...>();
         }
 
+        // Gets the values requested for each of the manifests with the given rowids, with the manifest rowid first.
+        // Manifests that do not exist are not included, and the results are in no particular order.
+        template <typename... Tables>
+        static std::vector<std::tuple<SQLite::rowid_t, typename Tables::value_t...>> GetValuesByIds(const SQLite::Connection& connection, const std::vector<SQLite::rowid_t>& ids)
+        {
+            std::vector<std::tuple<SQLite::rowid_t, typename Tables::value_t...>> result;
+
+            for (size_t i = 0; i < ids.size(); i += details::ManifestTableMaximumIdsPerStatement)
+            {
+                size_t count = std::min(details::ManifestTableMaximumIdsPerStatement, ids.size() - i);
+                auto stmt = details::ManifestTableGetValuesByIds_Statement(connection, count, { SQLite::Builder::QualifiedColumn{ Tables::TableName(), Tables::ValueName() }... });
+
+                for (size_t j = 0; j < count; ++j)
+                {
+                    stmt.Bind(static_cast<int>(j + 1), ids[i + j]);
+                }
+
+                while (stmt.Step())
+                {
+                    result.emplace_back(stmt.GetRow<SQLite::rowid_t, Tables::value_t...>());
+                }
+            }
+
+            return result;
+        }
+
+        // Gets the id rowid and the value from the given table for every manifest.
+        // An id with more than one manifest appears once for each of them.
+        template <typename IdTable, typename ValueTable>
+        static std::vector<std::pair<SQLite::rowid_t, typename ValueTable::value_t>> GetAllIdsAndValues(const SQLite::Connection& connection)
+        {
+            auto stmt = details::ManifestTableGetAllIdsAndValues_Statement(connection, IdTable::ValueName(), SQLite::Builder::QualifiedColumn{ ValueTable::TableName(), ValueTable::ValueName() });
+
+            std::vector<std::pair<SQLite::rowid_t, typename ValueTable::value_t>> result;
+            while (stmt.Step())
+            {
+                result.emplace_back(stmt.GetColumn<SQLite::rowid_t>(0), stmt.GetColumn<typename ValueTable::value_t>(1));
+            }
+
+            return result;
+        }
+
         // Gets the values for rows that match the given ids.
         template <typename ValueTable, typename... IdTables>
         static std::vector<typename ValueTable::value_t> GetAllValuesByIds(const SQLite::Connection& connection, std::initializer_list<SQLite::rowid_t> ids)
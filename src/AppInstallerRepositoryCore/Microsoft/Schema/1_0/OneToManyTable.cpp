@@ -4,6 +4,7 @@
 #include "Microsoft/Schema/1_0/OneToManyTable.h"
 #include "Microsoft/Schema/1_0/OneToOneTable.h"
 #include "Microsoft/Schema/1_0/ManifestTable.h"
+#include "Microsoft/Schema/1_0/IdTable.h"
 #include "SQLiteStatementBuilder.h"
 
 
@@ -170,6 +171,34 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
             return result;
         }
 
+        std::vector<std::pair<SQLite::rowid_t, std::string>> OneToManyTableGetValuesById(
+            const SQLite::Connection& connection,
+            std::string_view tableName,
+            std::string_view valueName,
+            SQLite::rowid_t id)
+        {
+            using QCol = SQLite::Builder::QualifiedColumn;
+
+            std::vector<std::pair<SQLite::rowid_t, std::string>> result;
+
+            SQLite::Builder::StatementBuilder builder;
+            builder.Select({ QCol("map", s_OneToManyTable_MapTable_ManifestName), QCol(tableName, valueName) }).
+                From({ tableName, s_OneToManyTable_MapTable_Suffix }).As("map").
+                Join(ManifestTable::TableName()).On(QCol("map", s_OneToManyTable_MapTable_ManifestName), QCol(ManifestTable::TableName(), SQLite::RowIDName)).
+                Join(tableName).On(QCol("map", valueName), QCol(tableName, SQLite::RowIDName)).
+                Where(QCol(ManifestTable::TableName(), IdTable::ValueName())).Equals(id).
+                OrderBy(QCol("map", s_OneToManyTable_MapTable_ManifestName));
+
+            SQLite::Statement statement = builder.Prepare(connection);
+
+            while (statement.Step())
+            {
+                result.emplace_back(statement.GetColumn<SQLite::rowid_t>(0), statement.GetColumn<std::string>(1));
+            }
+
+            return result;
+        }
+
         void OneToManyTableEnsureExistsAndInsert(SQLite::Connection& connection,
             std::string_view tableName, std::string_view valueName,
             const std::vector<Utility::NormalizedString>& values, SQLite::rowid_t manifestId)
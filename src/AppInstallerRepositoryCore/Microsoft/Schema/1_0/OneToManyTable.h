@@ -27,6 +27,13 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
             std::string_view valueName,
             SQLite::rowid_t manifestId);
 
+        // Gets the values, paired with their manifest id, of every manifest with the given id.
+        std::vector<std::pair<SQLite::rowid_t, std::string>> OneToManyTableGetValuesById(
+            const SQLite::Connection& connection,
+            std::string_view tableName,
+            std::string_view valueName,
+            SQLite::rowid_t id);
+
         // Ensures that the value exists and inserts mapping entries.
         void OneToManyTableEnsureExistsAndInsert(SQLite::Connection& connection,
             std::string_view tableName, std::string_view valueName, 
@@ -91,6 +98,12 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
             return details::OneToManyTableGetValuesByManifestId(connection, TableInfo::TableName(), TableInfo::ValueName(), manifestId);
         }
 
+        // Gets all values for all manifests with the given id, paired with their manifest id and ordered by it.
+        static std::vector<std::pair<SQLite::rowid_t, std::string>> GetValuesById(const SQLite::Connection& connection, SQLite::rowid_t id)
+        {
+            return details::OneToManyTableGetValuesById(connection, TableInfo::TableName(), TableInfo::ValueName(), id);
+        }
+
         // Ensures that all values exist in the data table, and inserts into the mapping table for the given manifest id.
         static void EnsureExistsAndInsert(SQLite::Connection& connection, const std::vector<Utility::NormalizedString>& values, SQLite::rowid_t manifestId)
         {
@@ -6,6 +6,7 @@
 #include "Microsoft/Schema/ISQLiteIndex.h"
 #include "Public/winget/RepositorySearch.h"
 
+#include <memory>
 #include <optional>
 #include <utility>
 #include <vector>
@@ -24,8 +25,11 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         SearchResultsTable(SearchResultsTable&&) = default;
         SearchResultsTable& operator=(SearchResultsTable&&) = default;
 
+        virtual ~SearchResultsTable() = default;
+
         // Performs the requested search type on the requested field.
-        void SearchOnField(const PackageMatchFilter& filter);
+        // Searches are held until their results are needed, then run together as a single statement.
+        virtual void SearchOnField(const PackageMatchFilter& filter);
 
         // Removes rows with manifest ids whose sort order is below the highest one.
         void RemoveDuplicateManifestRows();
@@ -34,17 +38,35 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
         void PrepareToFilter();
 
         // Performs the requested filter type on the requested field.
-        void FilterOnField(const PackageMatchFilter& filter);
+        virtual void FilterOnField(const PackageMatchFilter& filter);
 
         // Completes a filtering pass, removing filtered rows.
         void CompleteFilter();
 
         // Gets the results from the table.
+        // If only searches have been performed, they are read directly and the table is never created.
         ISQLiteIndex::SearchResult GetSearchResults(size_t limit = 0);
 
+        // Prepares a statement that selects the results, in the same way as GetSearchResults, but at most limit of them; zero is no limit.
+        // The columns are: id, field, match, value.
+        SQLite::Statement PrepareSearchResults(size_t limit = 0);
+
+        // Reads the current row of a statement from PrepareSearchResults.
+        static std::pair<SQLite::rowid_t, PackageMatchFilter> ReadSearchResult(SQLite::Statement& select);
+
+        // Gets the value that the results are ordered by; they are ranked by match type and then field, as the sources that
+        // merge results order them, and the results that rank the same are in the order of the searches that found them.
+        static int64_t GetSortValue(const PackageMatchFilter& filter, size_t searchOrdinal);
+
     protected:
-        // Builds the search statement for the specified field and match type.
-        std::vector<int> BuildSearchStatement(SQLite::Builder::StatementBuilder& builder, PackageMatchField field, MatchType match) const;
+        const SQLite::Connection& GetConnection() const { return m_connection; }
+
+        // Determines if the search can be held to run along with the others.
+        // Searches that depend on state that will not be the same later must return false.
+        virtual bool IsSearchDeferrable(const PackageMatchFilter& filter) const;
+
+        // Builds the search statement for the specified filter.
+        virtual std::vector<int> BuildSearchStatement(SQLite::Builder::StatementBuilder& builder, const PackageMatchFilter& filter) const;
 
         virtual std::vector<int> BuildSearchStatement(
             SQLite::Builder::StatementBuilder& builder,
@@ -58,8 +80,49 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
 
         virtual void BindStatementForMatchType(SQLite::Statement& statement, const PackageMatchFilter& filter, const std::vector<int>& bindIndex);
 
+        // Inserts the results of all pending searches into the table, along with anything that was waiting on them.
+        void RunPendingSearches();
+
     private:
+        // A search that has not been run yet, along with the sort value it was given.
+        struct PendingSearch
+        {
+            PackageMatchFilter Filter;
+            int64_t SortValue;
+        };
+
+        // Creates the table if it has not been already.
+        void EnsureTableCreated();
+
+        // Appends a compound select of the pending searches, with the columns: manifest, field, match, value, sort[, filter].
+        // Returns the bind indices for each of the pending searches.
+        std::vector<std::vector<int>> AppendPendingSearches(SQLite::Builder::StatementBuilder& builder, bool includeFilter) const;
+
+        // Binds the values for each of the pending searches, then clears them.
+        void BindPendingSearches(SQLite::Statement& statement, const std::vector<std::vector<int>>& bindIndices);
+
         const SQLite::Connection& m_connection;
-        int m_sortOrdinalValue = 0;
+        size_t m_searchOrdinal = 0;
+        bool m_tableCreated = false;
+        std::vector<PendingSearch> m_pendingSearches;
+        bool m_removeDuplicatesPending = false;
+    };
+
+    // Reads search results from the index as they are requested.
+    struct SearchResultsCursor : public ISQLiteIndex::SearchCursor
+    {
+        // Reads the results of a table that will not be searched or filtered any further; at most limit of them, where zero is no limit.
+        SearchResultsCursor(std::unique_ptr<SearchResultsTable>&& table, size_t limit = 0);
+
+        // Reads the results of a statement with the same columns as SearchResultsTable::PrepareSearchResults.
+        SearchResultsCursor(SQLite::Statement&& statement);
+
+        ISQLiteIndex::SearchResult GetNext(size_t count) override;
+
+    private:
+        // The table must outlive the statement reading from it.
+        std::unique_ptr<SearchResultsTable> m_table;
+        SQLite::Statement m_statement;
+        bool m_hasRow = false;
     };
 }
@@ -28,14 +28,33 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
 
         constexpr std::string_view s_SearchResultsTable_Index_Suffix = "_i_m"sv;
 
+        // The kind of the temp table in the connection's pool; all schema versions share the same columns.
+        constexpr std::string_view s_SearchResultsTable_TempTableKind = "searchresults"sv;
+
         constexpr std::string_view s_SearchResultsTable_SubSelect_TableAlias = "valueTable"sv;
         constexpr std::string_view s_SearchResultsTable_SubSelect_ManifestAlias = "m"sv;
         constexpr std::string_view s_SearchResultsTable_SubSelect_ValueAlias = "v"sv;
     }
 
     SearchResultsTable::SearchResultsTable(const SQLite::Connection& connection) :
-        m_connection(connection)
+        SQLite::TempTable(connection, s_SearchResultsTable_TempTableKind), m_connection(connection)
     {
+    }
+
+    void SearchResultsTable::EnsureTableCreated()
+    {
+        if (m_tableCreated)
+        {
+            return;
+        }
+
+        if (IsReused())
+        {
+            // The table and its index were created by an earlier search, and emptied when it was done.
+            m_tableCreated = true;
+            return;
+        }
+
         using namespace SQLite::Builder;
 
         {
@@ -46,7 +65,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
             builder.Column(ColumnBuilder(s_SearchResultsTable_MatchField, Type::Int).NotNull());
             builder.Column(ColumnBuilder(s_SearchResultsTable_MatchType, Type::Int).NotNull());
             builder.Column(ColumnBuilder(s_SearchResultsTable_MatchValue, Type::Text).NotNull());
-            builder.Column(ColumnBuilder(s_SearchResultsTable_SortValue, Type::Int).NotNull());
+            builder.Column(ColumnBuilder(s_SearchResultsTable_SortValue, Type::Int64).NotNull());
             builder.Column(ColumnBuilder(s_SearchResultsTable_Filter, Type::Bool).NotNull());
 
             builder.EndColumns();
@@ -67,13 +86,32 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
 
             builder.Execute(m_connection);
         }
+
+        m_tableCreated = true;
     }
 
     void SearchResultsTable::SearchOnField(const PackageMatchFilter& filter)
     {
         using namespace SQLite::Builder;
 
-        int sortOrdinal = m_sortOrdinalValue++;
+        if (IsSearchDeferrable(filter))
+        {
+            // Building the field specific portion is cheap compared to preparing it, and finds unsupported fields now.
+            StatementBuilder probe;
+            if (BuildSearchStatement(probe, filter).empty())
+            {
+                AICLI_LOG(Repo, Verbose, << "PackageMatchField not supported in this version: " << ToString(filter.Field));
+                return;
+            }
+
+            m_pendingSearches.emplace_back(PendingSearch{ filter, GetSortValue(filter, m_searchOrdinal++) });
+            return;
+        }
+
+        // Keep the results in the order that the searches were requested.
+        RunPendingSearches();
+
+        int64_t sortValue = GetSortValue(filter, m_searchOrdinal++);
 
         // Create an insert statement to select values into the table as requested.
         // The goal is a statement like this:
@@ -87,12 +125,12 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
             Value(filter.Field).
             Value(filter.Type).
             Column(QualifiedColumn(s_SearchResultsTable_SubSelect_TableAlias, s_SearchResultsTable_SubSelect_ValueAlias)).
-            Value(sortOrdinal).
+            Value(sortValue).
             Value(false).
         From().BeginParenthetical();
 
         // Add the field specific portion
-        std::vector<int> bindIndex = BuildSearchStatement(builder, filter.Field, filter.Type);
+        std::vector<int> bindIndex = BuildSearchStatement(builder, filter);
 
         if (bindIndex.empty())
         {
@@ -112,6 +150,18 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
     {
         using namespace SQLite::Builder;
 
+        // Reading the results directly already leaves one row per manifest, so wait to see if the table is needed.
+        if (!m_pendingSearches.empty())
+        {
+            m_removeDuplicatesPending = true;
+            return;
+        }
+
+        if (!m_tableCreated)
+        {
+            return;
+        }
+
         // Create a delete statement to leave only one row with a given manifest.
         // This will arbitrarily choose one of the rows if multiple have the same lowest sort order.
         // The goal is a statement like this:
@@ -133,6 +183,8 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
 
     void SearchResultsTable::PrepareToFilter()
     {
+        RunPendingSearches();
+
         // Reset all filter values to unselected
         SQLite::Builder::StatementBuilder builder;
         builder.Update(GetQualifiedName()).Set().Column(s_SearchResultsTable_Filter).Equals(false);
@@ -144,6 +196,8 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
     {
         using namespace SQLite::Builder;
 
+        RunPendingSearches();
+
         // Create an update statement to mark rows that are found by the search.
         // This will arbitrarily choose one of the rows if multiple have the same lowest sort order.
         // The goal is a statement like this:
@@ -157,7 +211,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
             Select(s_SearchResultsTable_SubSelect_ManifestAlias).From().BeginParenthetical();
 
         // Add the field specific portion
-        std::vector<int> bindIndex = BuildSearchStatement(builder, filter.Field, filter.Type);
+        std::vector<int> bindIndex = BuildSearchStatement(builder, filter);
 
         if (bindIndex.empty())
         {
@@ -175,6 +229,8 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
 
     void SearchResultsTable::CompleteFilter()
     {
+        RunPendingSearches();
+
         // Delete all unselected values
         SQLite::Builder::StatementBuilder builder;
         builder.DeleteFrom(GetQualifiedName()).Where(s_SearchResultsTable_Filter).Equals(false);
@@ -184,17 +240,70 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
     }
 
     ISQLiteIndex::SearchResult SearchResultsTable::GetSearchResults(size_t limit)
+    {
+        SQLite::Statement select = PrepareSearchResults();
+
+        ISQLiteIndex::SearchResult result;
+        while (select.Step())
+        {
+            if (limit && result.Matches.size() >= limit)
+            {
+                break;
+            }
+
+            result.Matches.emplace_back(ReadSearchResult(select));
+        }
+
+        result.Truncated = (select.GetState() != SQLite::Statement::State::Completed);
+
+        return result;
+    }
+
+    SQLite::Statement SearchResultsTable::PrepareSearchResults(size_t limit)
     {
         constexpr std::string_view tempTableAlias = "t"sv;
 
         using namespace SQLite::Builder;
         using QCol = QualifiedColumn;
 
+        if (!m_tableCreated && !m_pendingSearches.empty())
+        {
+            // Nothing has needed the table, so select the results straight from the searches.
+            // This is the same as the statement below, with the compound select of the searches in place of the table:
+            //  SELECT m.id, field, match, value, min(sort) from (<searches>) as t join manifest on rowid = manifest group by m.id order by t.sort [limit <limit>]
+            StatementBuilder builder;
+            builder.Select().
+                Column(QCol(ManifestTable::TableName(), IdTable::ValueName())).
+                Column(QCol(tempTableAlias, s_SearchResultsTable_MatchField)).
+                Column(QCol(tempTableAlias, s_SearchResultsTable_MatchType)).
+                Column(QCol(tempTableAlias, s_SearchResultsTable_MatchValue)).
+                Column(Aggregate::Min, QCol(tempTableAlias, s_SearchResultsTable_SortValue)).
+            From().BeginParenthetical();
+
+            std::vector<std::vector<int>> bindIndices = AppendPendingSearches(builder, false);
+
+            builder.EndParenthetical().As(tempTableAlias).
+                Join(ManifestTable::TableName()).On(QCol(tempTableAlias, s_SearchResultsTable_Manifest), QCol(ManifestTable::TableName(), SQLite::RowIDName)).
+                GroupBy(QCol(ManifestTable::TableName(), IdTable::ValueName())).OrderBy(QCol(tempTableAlias, s_SearchResultsTable_SortValue));
+
+            if (limit)
+            {
+                builder.Limit(limit);
+            }
+
+            SQLite::Statement select = builder.Prepare(m_connection);
+            BindPendingSearches(select, bindIndices);
+
+            return select;
+        }
+
+        RunPendingSearches();
+
         // Select all unique ids from the results table, and their highest ordered match.
         // The goal is a statement like this:
-        //  SELECT m.id, field, match, value, min(sort) from <temp> join manifest on rowid = manifest group by m.id order by t.sort
-        // Through the "group by m.id", we will only ever have one row per id, and the "min(sort)" returns us one of the rows that matched
-        // through the earliest search.  We also order by the sort value to have the earliest search matches first in the list
+        //  SELECT m.id, field, match, value, min(sort) from <temp> join manifest on rowid = manifest group by m.id order by t.sort [limit <limit>]
+        // Through the "group by m.id", we will only ever have one row per id, and the "min(sort)" returns us the row with the best ranked match.
+        // We also order by the sort value to have the best matches first in the list, and the limit lets SQLite keep only those as it sorts.
         StatementBuilder builder;
         builder.Select().
             Column(QCol(ManifestTable::TableName(), IdTable::ValueName())).
@@ -206,28 +315,161 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
             Join(ManifestTable::TableName()).On(QCol(tempTableAlias, s_SearchResultsTable_Manifest), QCol(ManifestTable::TableName(), SQLite::RowIDName)).
             GroupBy(QCol(ManifestTable::TableName(), IdTable::ValueName())).OrderBy(QCol(tempTableAlias, s_SearchResultsTable_SortValue));
 
-        SQLite::Statement select = builder.Prepare(m_connection);
+        if (limit)
+        {
+            builder.Limit(limit);
+        }
+
+        return builder.Prepare(m_connection);
+    }
 
+    int64_t SearchResultsTable::GetSortValue(const PackageMatchFilter& filter, size_t searchOrdinal)
+    {
+        // The rank is in the high bits, so that the ordinal only breaks ties between matches of the same rank.
+        constexpr int64_t fieldCount = static_cast<int64_t>(PackageMatchField::Unknown) + 1;
+        int64_t rank = static_cast<int64_t>(filter.Type) * fieldCount + static_cast<int64_t>(filter.Field);
+
+        THROW_HR_IF(E_UNEXPECTED, searchOrdinal > std::numeric_limits<uint32_t>::max());
+        return (rank << 32) | static_cast<int64_t>(searchOrdinal);
+    }
+
+    std::pair<SQLite::rowid_t, PackageMatchFilter> SearchResultsTable::ReadSearchResult(SQLite::Statement& select)
+    {
+        return { select.GetColumn<SQLite::rowid_t>(0),
+            PackageMatchFilter(select.GetColumn<PackageMatchField>(1), select.GetColumn<MatchType>(2), select.GetColumn<std::string>(3)) };
+    }
+
+    bool SearchResultsTable::IsSearchDeferrable(const PackageMatchFilter&) const
+    {
+        return true;
+    }
+
+    void SearchResultsTable::RunPendingSearches()
+    {
+        using namespace SQLite::Builder;
+
+        EnsureTableCreated();
+
+        if (!m_pendingSearches.empty())
+        {
+            // Create an insert statement to select the values of every pending search into the table at once.
+            // The goal is a statement like this:
+            //      INSERT INTO <tempTable>
+            //      SELECT valueTable.m, <field>, <match>, valueTable.v, <sort>, <filter> FROM (<subselect>) AS valueTable
+            //      UNION ALL
+            //      SELECT valueTable.m, <field>, <match>, valueTable.v, <sort>, <filter> FROM (<subselect>) AS valueTable
+            //      ...
+            // Where each subselect is built by the owning table.
+            StatementBuilder builder;
+            builder.InsertInto(GetQualifiedName());
+
+            size_t searchCount = m_pendingSearches.size();
+            std::vector<std::vector<int>> bindIndices = AppendPendingSearches(builder, true);
+
+            SQLite::Statement statement = builder.Prepare(m_connection);
+            BindPendingSearches(statement, bindIndices);
+            statement.Execute();
+            AICLI_LOG(Repo, Verbose, << "Search found " << m_connection.GetChanges() << " rows across " << searchCount << " searches");
+        }
+
+        if (m_removeDuplicatesPending)
+        {
+            m_removeDuplicatesPending = false;
+            RemoveDuplicateManifestRows();
+        }
+    }
+
+    std::vector<std::vector<int>> SearchResultsTable::AppendPendingSearches(SQLite::Builder::StatementBuilder& builder, bool includeFilter) const
+    {
+        using namespace SQLite::Builder;
+
+        std::vector<std::vector<int>> result;
+
+        for (const auto& search : m_pendingSearches)
+        {
+            if (!result.empty())
+            {
+                builder.UnionAll();
+            }
+
+            // The names given to the columns of the first select are those of the compound select.
+            builder.Select().
+                Column(QualifiedColumn(s_SearchResultsTable_SubSelect_TableAlias, s_SearchResultsTable_SubSelect_ManifestAlias)).As(s_SearchResultsTable_Manifest).
+                Value(search.Filter.Field).As(s_SearchResultsTable_MatchField).
+                Value(search.Filter.Type).As(s_SearchResultsTable_MatchType).
+                Column(QualifiedColumn(s_SearchResultsTable_SubSelect_TableAlias, s_SearchResultsTable_SubSelect_ValueAlias)).As(s_SearchResultsTable_MatchValue).
+                Value(search.SortValue).As(s_SearchResultsTable_SortValue);
+
+            if (includeFilter)
+            {
+                builder.Value(false);
+            }
+
+            builder.From().BeginParenthetical();
+
+            // Add the field specific portion; support was checked when the search was added.
+            result.emplace_back(BuildSearchStatement(builder, search.Filter));
+            THROW_HR_IF(E_UNEXPECTED, result.back().empty());
+
+            builder.EndParenthetical().As(s_SearchResultsTable_SubSelect_TableAlias);
+        }
+
+        return result;
+    }
+
+    void SearchResultsTable::BindPendingSearches(SQLite::Statement& statement, const std::vector<std::vector<int>>& bindIndices)
+    {
+        THROW_HR_IF(E_UNEXPECTED, bindIndices.size() != m_pendingSearches.size());
+
+        for (size_t i = 0; i < bindIndices.size(); ++i)
+        {
+            BindStatementForMatchType(statement, m_pendingSearches[i].Filter, bindIndices[i]);
+        }
+
+        m_pendingSearches.clear();
+    }
+
+    SearchResultsCursor::SearchResultsCursor(std::unique_ptr<SearchResultsTable>&& table, size_t limit) :
+        m_table(std::move(table)), m_statement(m_table->PrepareSearchResults(limit))
+    {
+    }
+
+    SearchResultsCursor::SearchResultsCursor(SQLite::Statement&& statement) :
+        m_statement(std::move(statement))
+    {
+    }
+
+    ISQLiteIndex::SearchResult SearchResultsCursor::GetNext(size_t count)
+    {
         ISQLiteIndex::SearchResult result;
-        while (select.Step())
+
+        while (!count || result.Matches.size() < count)
         {
-            if (limit && result.Matches.size() >= limit)
+            // A row may be left over from checking for more results at the end of the previous call.
+            // Stepping a completed statement would start it over, so it is checked first.
+            if (!m_hasRow && (m_statement.GetState() == SQLite::Statement::State::Completed || !m_statement.Step()))
             {
                 break;
             }
 
-            result.Matches.emplace_back(select.GetColumn<SQLite::rowid_t>(0), 
-                PackageMatchFilter(select.GetColumn<PackageMatchField>(1), select.GetColumn<MatchType>(2), select.GetColumn<std::string>(3)));
+            m_hasRow = false;
+            result.Matches.emplace_back(SearchResultsTable::ReadSearchResult(m_statement));
         }
 
-        result.Truncated = (select.GetState() != SQLite::Statement::State::Completed);
+        // Step once more to learn if there are more results, keeping the row for the next call.
+        if (!m_hasRow && m_statement.GetState() != SQLite::Statement::State::Completed)
+        {
+            m_hasRow = m_statement.Step();
+        }
+
+        result.Truncated = m_hasRow;
 
         return result;
     }
 
-    std::vector<int> SearchResultsTable::BuildSearchStatement(SQLite::Builder::StatementBuilder& builder, PackageMatchField field, MatchType match) const
+    std::vector<int> SearchResultsTable::BuildSearchStatement(SQLite::Builder::StatementBuilder& builder, const PackageMatchFilter& filter) const
     {
-        return BuildSearchStatement(builder, field, s_SearchResultsTable_SubSelect_ManifestAlias, s_SearchResultsTable_SubSelect_ValueAlias, MatchUsesLike(match));
+        return BuildSearchStatement(builder, filter.Field, s_SearchResultsTable_SubSelect_ManifestAlias, s_SearchResultsTable_SubSelect_ValueAlias, MatchUsesLike(filter.Type));
     }
 
     std::vector<int> SearchResultsTable::BuildSearchStatement(
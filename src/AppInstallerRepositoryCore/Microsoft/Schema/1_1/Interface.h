@@ -18,8 +18,8 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_1
         void RemoveManifestById(SQLite::Connection& connection, SQLite::rowid_t manifestId) override;
         void PrepareForPackaging(SQLite::Connection& connection) override;
         bool CheckConsistency(const SQLite::Connection& connection, bool log) const override;
-        SearchResult Search(const SQLite::Connection& connection, const SearchRequest& request) const override;
         std::vector<std::string> GetMultiPropertyByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId, PackageVersionMultiProperty property) const override;
+        MultiPropertyResult GetMultiPropertyById(const SQLite::Connection& connection, SQLite::rowid_t id, PackageVersionMultiProperty property) const override;
 
         // Version 1.1
         MetadataResult GetMetadataByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId) const override;
@@ -28,7 +28,8 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_1
     protected:
         std::unique_ptr<V1_0::SearchResultsTable> CreateSearchResultsTable(const SQLite::Connection& connection) const override;
         void PerformQuerySearch(V1_0::SearchResultsTable& resultsTable, const RequestMatch& query) const override;
-        virtual SearchResult SearchInternal(const SQLite::Connection& connection, SearchRequest& request) const;
+        std::unique_ptr<SearchCursor> OpenSearchWithLimit(const SQLite::Connection& connection, const SearchRequest& request, size_t limit) const override;
+        virtual std::unique_ptr<SearchCursor> OpenSearchInternal(const SQLite::Connection& connection, SearchRequest& request, size_t limit) const;
         virtual void PrepareForPackaging(SQLite::Connection& connection, bool vacuum);
     };
 }
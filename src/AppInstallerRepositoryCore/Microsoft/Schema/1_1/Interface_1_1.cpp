@@ -169,12 +169,6 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_1
         return result;
     }
 
-    ISQLiteIndex::SearchResult Interface::Search(const SQLite::Connection& connection, const SearchRequest& request) const
-    {
-        SearchRequest updatedRequest = request;
-        return SearchInternal(connection, updatedRequest);
-    }
-
     std::vector<std::string> Interface::GetMultiPropertyByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId, PackageVersionMultiProperty property) const
     {
         switch (property)
@@ -188,6 +182,19 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_1
         }
     }
 
+    ISQLiteIndex::MultiPropertyResult Interface::GetMultiPropertyById(const SQLite::Connection& connection, SQLite::rowid_t id, PackageVersionMultiProperty property) const
+    {
+        switch (property)
+        {
+        case PackageVersionMultiProperty::PackageFamilyName:
+            return PackageFamilyNameTable::GetValuesById(connection, id);
+        case PackageVersionMultiProperty::ProductCode:
+            return ProductCodeTable::GetValuesById(connection, id);
+        default:
+            return V1_0::Interface::GetMultiPropertyById(connection, id, property);
+        }
+    }
+
     ISQLiteIndex::MetadataResult Interface::GetMetadataByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId) const
     {
         ISQLiteIndex::MetadataResult result;
@@ -233,7 +240,13 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_1
         V1_0::Interface::PerformQuerySearch(resultsTable, query);
     }
 
-    ISQLiteIndex::SearchResult Interface::SearchInternal(const SQLite::Connection& connection, SearchRequest& request) const
+    std::unique_ptr<ISQLiteIndex::SearchCursor> Interface::OpenSearchWithLimit(const SQLite::Connection& connection, const SearchRequest& request, size_t limit) const
+    {
+        SearchRequest updatedRequest = request;
+        return OpenSearchInternal(connection, updatedRequest, limit);
+    }
+
+    std::unique_ptr<ISQLiteIndex::SearchCursor> Interface::OpenSearchInternal(const SQLite::Connection& connection, SearchRequest& request, size_t limit) const
     {
         // Update any system reference strings to be folded
         auto foldIfNeeded = [](PackageMatchFilter& filter)
@@ -255,7 +268,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_1
             foldIfNeeded(filter);
         }
 
-        return V1_0::Interface::Search(connection, request);
+        return V1_0::Interface::OpenSearchWithLimit(connection, request, limit);
     }
 
     void Interface::PrepareForPackaging(SQLite::Connection& connection, bool vacuum)
@@ -20,13 +20,14 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_2
         void RemoveManifestById(SQLite::Connection& connection, SQLite::rowid_t manifestId) override;
         bool CheckConsistency(const SQLite::Connection& connection, bool log) const override;
         std::vector<std::string> GetMultiPropertyByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId, PackageVersionMultiProperty property) const override;
+        MultiPropertyResult GetMultiPropertyById(const SQLite::Connection& connection, SQLite::rowid_t id, PackageVersionMultiProperty property) const override;
 
         // Version 1.2
         Utility::NormalizedName NormalizeName(std::string_view name, std::string_view publisher) const override;
 
     protected:
         std::unique_ptr<V1_0::SearchResultsTable> CreateSearchResultsTable(const SQLite::Connection& connection) const override;
-        SearchResult SearchInternal(const SQLite::Connection& connection, SearchRequest& request) const override;
+        std::unique_ptr<SearchCursor> OpenSearchInternal(const SQLite::Connection& connection, SearchRequest& request, size_t limit) const override;
         void PrepareForPackaging(SQLite::Connection& connection, bool vacuum) override;
 
         // The name normalization utility
@@ -166,6 +166,20 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_2
         }
     }
 
+    ISQLiteIndex::MultiPropertyResult Interface::GetMultiPropertyById(const SQLite::Connection& connection, SQLite::rowid_t id, PackageVersionMultiProperty property) const
+    {
+        switch (property)
+        {
+            // As with GetMultiPropertyByManifestId, these are the normalized values.
+        case PackageVersionMultiProperty::Name:
+            return NormalizedPackageNameTable::GetValuesById(connection, id);
+        case PackageVersionMultiProperty::Publisher:
+            return NormalizedPackagePublisherTable::GetValuesById(connection, id);
+        default:
+            return V1_1::Interface::GetMultiPropertyById(connection, id, property);
+        }
+    }
+
     Utility::NormalizedName Interface::NormalizeName(std::string_view name, std::string_view publisher) const
     {
         return m_normalizer.Normalize(name, publisher);
@@ -176,7 +190,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_2
         return std::make_unique<SearchResultsTable>(connection);
     }
 
-    ISQLiteIndex::SearchResult Interface::SearchInternal(const SQLite::Connection& connection, SearchRequest& request) const
+    std::unique_ptr<ISQLiteIndex::SearchCursor> Interface::OpenSearchInternal(const SQLite::Connection& connection, SearchRequest& request, size_t limit) const
     {
         // Update NormalizedNameAndPublisher with normalization and folding
         auto updateIfNeeded = [&](PackageMatchFilter& filter)
@@ -199,7 +213,7 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_2
             updateIfNeeded(filter);
         }
 
-        return V1_1::Interface::SearchInternal(connection, request);
+        return V1_1::Interface::OpenSearchInternal(connection, request, limit);
     }
 
     void Interface::PrepareForPackaging(SQLite::Connection& connection, bool vacuum)
@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "Microsoft/Schema/1_2/SearchResultsTable.h"
+
+#include <optional>
+#include <vector>
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_5
+{
+    // Table for holding temporary search results.
+    struct SearchResultsTable : public V1_2::SearchResultsTable
+    {
+        // If useTrigrams is true, substring and prefix searches are narrowed through the trigram table,
+        // and fuzzy searches on names and monikers are scored by edit distance against its candidates.
+        SearchResultsTable(const SQLite::Connection& connection, bool useTrigrams) : V1_2::SearchResultsTable(connection), m_useTrigrams(useTrigrams) {}
+
+        SearchResultsTable(const SearchResultsTable&) = delete;
+        SearchResultsTable& operator=(const SearchResultsTable&) = delete;
+
+        SearchResultsTable(SearchResultsTable&&) = default;
+        SearchResultsTable& operator=(SearchResultsTable&&) = default;
+
+        // Fuzzy matches are added in order of their distance, closest first.
+        void SearchOnField(const PackageMatchFilter& filter) override;
+
+        void FilterOnField(const PackageMatchFilter& filter) override;
+
+        // Gets the number of edits allowed for a fuzzy match against the given value.
+        static size_t GetFuzzyMaximumDistance(std::string_view value);
+
+    protected:
+        // The scored value rows are only set while the search runs, so it cannot wait for the others.
+        bool IsSearchDeferrable(const PackageMatchFilter& filter) const override;
+
+        std::vector<int> BuildSearchStatement(SQLite::Builder::StatementBuilder& builder, const PackageMatchFilter& filter) const override;
+
+        std::vector<int> BuildSearchStatement(
+            SQLite::Builder::StatementBuilder& builder,
+            PackageMatchField field,
+            std::string_view manifestAlias,
+            std::string_view valueAlias,
+            bool useLike) const override;
+
+        // Import all overrides of this function
+        using V1_0::SearchResultsTable::BindStatementForMatchType;
+
+        void BindStatementForMatchType(SQLite::Statement& statement, const PackageMatchFilter& filter, const std::vector<int>& bindIndex) override;
+
+    private:
+        // Determines if the filter is matched by scoring the trigram candidates rather than in the statement.
+        bool UsesFuzzyScoring(const PackageMatchFilter& filter) const;
+
+        // Gets the value rows that fuzzily match the filter, grouped by their distance from it in increasing order.
+        std::vector<std::vector<SQLite::rowid_t>> GetFuzzyMatches(const PackageMatchFilter& filter) const;
+
+        // Runs the base search or filter limited to the given value rows, in as many statements as needed to bind them.
+        void SearchOrFilterOnValueIds(const PackageMatchFilter& filter, const std::vector<SQLite::rowid_t>& valueIds, bool isFilter);
+
+        bool m_useTrigrams;
+
+        // Set while a fuzzy search or filter is being built, to the value rows that it should find.
+        std::optional<std::vector<SQLite::rowid_t>> m_fuzzyValueIds;
+    };
+}
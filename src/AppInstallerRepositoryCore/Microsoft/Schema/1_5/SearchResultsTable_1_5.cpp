@@ -0,0 +1,231 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "SearchResultsTable.h"
+
+#include "Microsoft/Schema/1_0/ManifestTable.h"
+#include "Microsoft/Schema/1_0/NameTable.h"
+#include "Microsoft/Schema/1_0/MonikerTable.h"
+#include "Microsoft/Schema/1_5/TrigramTable.h"
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_5
+{
+    namespace
+    {
+        // Shorter values are left to the exact matches; there are too few characters to tell a typo from a different word.
+        constexpr size_t s_FuzzyMinimumLength = 4;
+
+        // One edit is allowed for each of this many bytes in the value, up to the maximum.
+        constexpr size_t s_FuzzyBytesPerEdit = 4;
+        constexpr size_t s_FuzzyMaximumDistance = 3;
+
+        // Keeps the value rows bound to a single statement well below the limit on parameters.
+        constexpr size_t s_FuzzyMaximumValuesPerStatement = 500;
+
+        // The one to one value tables that fuzzy searches are scored against.
+        std::optional<SQLite::Builder::QualifiedColumn> GetFuzzyValueColumn(PackageMatchField field)
+        {
+            switch (field)
+            {
+            case PackageMatchField::Name:
+                return SQLite::Builder::QualifiedColumn{ V1_0::NameTable::TableName(), V1_0::NameTable::ValueName() };
+            case PackageMatchField::Moniker:
+                return SQLite::Builder::QualifiedColumn{ V1_0::MonikerTable::TableName(), V1_0::MonikerTable::ValueName() };
+            default:
+                return std::nullopt;
+            }
+        }
+    }
+
+    void SearchResultsTable::SearchOnField(const PackageMatchFilter& filter)
+    {
+        if (!UsesFuzzyScoring(filter))
+        {
+            V1_2::SearchResultsTable::SearchOnField(filter);
+            return;
+        }
+
+        // Each distance is its own search so that it gets its own sort ordinal, ranking closer matches first.
+        for (const auto& valueIds : GetFuzzyMatches(filter))
+        {
+            SearchOrFilterOnValueIds(filter, valueIds, false);
+        }
+    }
+
+    void SearchResultsTable::FilterOnField(const PackageMatchFilter& filter)
+    {
+        if (!UsesFuzzyScoring(filter))
+        {
+            V1_2::SearchResultsTable::FilterOnField(filter);
+            return;
+        }
+
+        std::vector<SQLite::rowid_t> allValueIds;
+        for (const auto& valueIds : GetFuzzyMatches(filter))
+        {
+            allValueIds.insert(allValueIds.end(), valueIds.begin(), valueIds.end());
+        }
+
+        if (allValueIds.empty())
+        {
+            AICLI_LOG(Repo, Verbose, << "Filter found no fuzzy matches");
+            return;
+        }
+
+        SearchOrFilterOnValueIds(filter, allValueIds, true);
+    }
+
+    size_t SearchResultsTable::GetFuzzyMaximumDistance(std::string_view value)
+    {
+        if (value.size() < s_FuzzyMinimumLength)
+        {
+            return 0;
+        }
+
+        return std::min(value.size() / s_FuzzyBytesPerEdit, s_FuzzyMaximumDistance);
+    }
+
+    bool SearchResultsTable::IsSearchDeferrable(const PackageMatchFilter&) const
+    {
+        return !m_fuzzyValueIds.has_value();
+    }
+
+    std::vector<int> SearchResultsTable::BuildSearchStatement(SQLite::Builder::StatementBuilder& builder, const PackageMatchFilter& filter) const
+    {
+        std::vector<int> result = V1_0::SearchResultsTable::BuildSearchStatement(builder, filter);
+
+        if (!result.empty() && m_useTrigrams &&
+            (filter.Type == MatchType::Substring || filter.Type == MatchType::StartsWith) &&
+            TrigramTable::IsFieldSupported(filter.Field))
+        {
+            // The LIKE is still applied, but only to the values that contain every trigram of the search value.
+            std::vector<std::string> trigrams = TrigramTable::GetQueryTrigrams(filter.Value);
+
+            if (!trigrams.empty())
+            {
+                TrigramTable::AppendFilter(builder, filter.Field, trigrams);
+            }
+        }
+
+        return result;
+    }
+
+    std::vector<int> SearchResultsTable::BuildSearchStatement(
+        SQLite::Builder::StatementBuilder& builder,
+        PackageMatchField field,
+        std::string_view manifestAlias,
+        std::string_view valueAlias,
+        bool useLike) const
+    {
+        auto column = GetFuzzyValueColumn(field);
+
+        if (!m_fuzzyValueIds || !column)
+        {
+            return V1_2::SearchResultsTable::BuildSearchStatement(builder, field, manifestAlias, valueAlias, useLike);
+        }
+
+        using QCol = SQLite::Builder::QualifiedColumn;
+
+        // Build a statement for the already scored values like:
+        //      SELECT manifest.rowid as m, names.name as v from manifest
+        //      join names on manifest.name = names.rowid
+        //      where names.rowid in (<values>)
+        builder.Select().
+            Column(QCol(V1_0::ManifestTable::TableName(), SQLite::RowIDName)).As(manifestAlias).
+            Column(column.value()).As(valueAlias).
+            From(V1_0::ManifestTable::TableName()).
+            Join(column->Table).On(QCol(V1_0::ManifestTable::TableName(), column->Column), QCol(column->Table, SQLite::RowIDName)).
+            Where(QCol(column->Table, SQLite::RowIDName)).In(m_fuzzyValueIds->size());
+
+        std::vector<int> result;
+        for (int i = static_cast<int>(m_fuzzyValueIds->size()) - 1; i >= 0; --i)
+        {
+            result.push_back(builder.GetLastBindIndex() - i);
+        }
+
+        return result;
+    }
+
+    void SearchResultsTable::BindStatementForMatchType(SQLite::Statement& statement, const PackageMatchFilter& filter, const std::vector<int>& bindIndex)
+    {
+        if (!m_fuzzyValueIds)
+        {
+            V1_2::SearchResultsTable::BindStatementForMatchType(statement, filter, bindIndex);
+            return;
+        }
+
+        for (size_t i = 0; i < bindIndex.size(); ++i)
+        {
+            statement.Bind(bindIndex[i], m_fuzzyValueIds.value()[i]);
+        }
+    }
+
+    void SearchResultsTable::SearchOrFilterOnValueIds(const PackageMatchFilter& filter, const std::vector<SQLite::rowid_t>& valueIds, bool isFilter)
+    {
+        // The searches already held must be built and bound as they were queued, not against the fuzzy value rows.
+        RunPendingSearches();
+
+        auto resetFuzzy = wil::scope_exit([&]() { m_fuzzyValueIds.reset(); });
+
+        for (size_t i = 0; i < valueIds.size(); i += s_FuzzyMaximumValuesPerStatement)
+        {
+            auto end = valueIds.begin() + std::min(i + s_FuzzyMaximumValuesPerStatement, valueIds.size());
+            m_fuzzyValueIds.emplace(valueIds.begin() + i, end);
+
+            if (isFilter)
+            {
+                V1_2::SearchResultsTable::FilterOnField(filter);
+            }
+            else
+            {
+                V1_2::SearchResultsTable::SearchOnField(filter);
+            }
+        }
+    }
+
+    bool SearchResultsTable::UsesFuzzyScoring(const PackageMatchFilter& filter) const
+    {
+        return m_useTrigrams &&
+            (filter.Type == MatchType::Fuzzy || filter.Type == MatchType::FuzzySubstring) &&
+            GetFuzzyValueColumn(filter.Field).has_value();
+    }
+
+    std::vector<std::vector<SQLite::rowid_t>> SearchResultsTable::GetFuzzyMatches(const PackageMatchFilter& filter) const
+    {
+        std::string foldedValue = Utility::FoldCase(filter.Value);
+        size_t maxDistance = GetFuzzyMaximumDistance(foldedValue);
+
+        if (maxDistance == 0)
+        {
+            AICLI_LOG(Repo, Verbose, << "Value is too short for fuzzy matching: " << filter.Value);
+            return {};
+        }
+
+        std::vector<std::vector<SQLite::rowid_t>> result(maxDistance + 1);
+        size_t matchCount = 0;
+        std::string foldedBuffer;
+
+        for (const auto& candidate : TrigramTable::GetFuzzyCandidates(GetConnection(), filter.Field, foldedValue, maxDistance))
+        {
+            std::string_view foldedCandidate = Utility::FoldCase(candidate.second, foldedBuffer);
+
+            size_t distance = (filter.Type == MatchType::Fuzzy ?
+                Utility::BoundedEditDistance(foldedCandidate, foldedValue, maxDistance) :
+                Utility::BoundedSubstringEditDistance(foldedCandidate, foldedValue, maxDistance));
+
+            if (distance <= maxDistance)
+            {
+                result[distance].push_back(candidate.first);
+                ++matchCount;
+            }
+        }
+
+        AICLI_LOG(Repo, Verbose, << "Fuzzy scoring kept " << matchCount << " values");
+
+        // Drop the empty distances so that each remaining one is a search with results.
+        result.erase(std::remove_if(result.begin(), result.end(), [](const std::vector<SQLite::rowid_t>& ids) { return ids.empty(); }), result.end());
+
+        return result;
+    }
+}
@@ -0,0 +1,326 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TrigramTable.h"
+
+#include "Microsoft/Schema/1_0/IdTable.h"
+#include "Microsoft/Schema/1_0/NameTable.h"
+#include "Microsoft/Schema/1_0/MonikerTable.h"
+#include "Microsoft/Schema/1_0/TagsTable.h"
+#include "Microsoft/Schema/1_0/CommandsTable.h"
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_5
+{
+    using namespace std::string_view_literals;
+    using namespace SQLite::Builder;
+    using QCol = SQLite::Builder::QualifiedColumn;
+
+    namespace
+    {
+        constexpr std::string_view s_TrigramTable_Table_Name = "trigrams"sv;
+        constexpr std::string_view s_TrigramTable_Index_Name = "trigrams_pkindex"sv;
+        constexpr std::string_view s_TrigramTable_Trigram_Column_Name = "trigram"sv;
+        constexpr std::string_view s_TrigramTable_Field_Column_Name = "field"sv;
+        constexpr std::string_view s_TrigramTable_Value_Column_Name = "value"sv;
+
+        constexpr size_t s_TrigramLength = 3;
+
+        // Beyond this many, more trigrams rarely narrow the candidates enough to pay for another lookup.
+        constexpr size_t s_MaximumQueryTrigrams = 8;
+
+        // Fuzzy candidates need more of them, as a value may be missing several; this keeps the statement to a reasonable size.
+        constexpr size_t s_MaximumFuzzyTrigrams = 64;
+
+        // The value tables that are searched with LIKE, and so benefit from the trigrams.
+        std::optional<QCol> GetValueColumn(PackageMatchField field)
+        {
+            switch (field)
+            {
+            case PackageMatchField::Id:
+                return QCol{ V1_0::IdTable::TableName(), V1_0::IdTable::ValueName() };
+            case PackageMatchField::Name:
+                return QCol{ V1_0::NameTable::TableName(), V1_0::NameTable::ValueName() };
+            case PackageMatchField::Moniker:
+                return QCol{ V1_0::MonikerTable::TableName(), V1_0::MonikerTable::ValueName() };
+            case PackageMatchField::Tag:
+                return QCol{ V1_0::TagsTable::TableName(), V1_0::TagsTable::ValueName() };
+            case PackageMatchField::Command:
+                return QCol{ V1_0::CommandsTable::TableName(), V1_0::CommandsTable::ValueName() };
+            default:
+                return std::nullopt;
+            }
+        }
+
+        constexpr PackageMatchField s_SupportedFields[] = {
+            PackageMatchField::Id,
+            PackageMatchField::Name,
+            PackageMatchField::Moniker,
+            PackageMatchField::Tag,
+            PackageMatchField::Command,
+        };
+
+        bool IsASCII(std::string_view value)
+        {
+            return std::all_of(value.begin(), value.end(), [](char c) { return static_cast<unsigned char>(c) < 0x80; });
+        }
+
+        // Gets the distinct trigrams of the case folded value, in the order that they first appear.
+        // Only sequences of ASCII characters are produced; as UTF-8 encodes every other character with bytes above 0x7F,
+        // these are always whole characters. The LIKE used to confirm matches folds each character on its own, and any
+        // character that folds to ASCII that way also does in the full folding done here, so a value that matches an
+        // ASCII query always contains all of its trigrams.
+        std::vector<std::string> GetFoldedTrigrams(std::string_view value)
+        {
+            std::string foldedBuffer;
+            std::string_view folded = Utility::FoldCase(value, foldedBuffer);
+
+            std::vector<std::string> result;
+            std::set<std::string_view> seen;
+
+            for (size_t i = 0; i + s_TrigramLength <= folded.size(); ++i)
+            {
+                std::string_view trigram{ folded.data() + i, s_TrigramLength };
+                if (IsASCII(trigram) && seen.emplace(trigram).second)
+                {
+                    result.emplace_back(trigram);
+                }
+            }
+
+            return result;
+        }
+
+        // Reduces the trigrams to at most the maximum, spreading the ones kept across the whole value.
+        // This always includes the first and last.
+        std::vector<std::string> SpreadTrigrams(std::vector<std::string>&& trigrams, size_t maximum)
+        {
+            if (trigrams.size() <= maximum)
+            {
+                return std::move(trigrams);
+            }
+
+            std::vector<std::string> result;
+            for (size_t i = 0; i < maximum; ++i)
+            {
+                result.emplace_back(std::move(trigrams[i * (trigrams.size() - 1) / (maximum - 1)]));
+            }
+
+            return result;
+        }
+    }
+
+    std::string_view TrigramTable::TableName()
+    {
+        return s_TrigramTable_Table_Name;
+    }
+
+    void TrigramTable::Create(SQLite::Connection& connection)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "createtrigramtable_v1_5");
+
+        StatementBuilder createTableBuilder;
+        createTableBuilder.CreateTable(s_TrigramTable_Table_Name).Columns({
+            ColumnBuilder(s_TrigramTable_Trigram_Column_Name, Type::Text).NotNull(),
+            ColumnBuilder(s_TrigramTable_Field_Column_Name, Type::Int).NotNull(),
+            ColumnBuilder(s_TrigramTable_Value_Column_Name, Type::RowId).NotNull()
+            });
+
+        createTableBuilder.Execute(connection);
+
+        StatementBuilder pkIndexBuilder;
+        pkIndexBuilder.CreateUniqueIndex(s_TrigramTable_Index_Name).On(s_TrigramTable_Table_Name).
+            Columns({ s_TrigramTable_Trigram_Column_Name, s_TrigramTable_Field_Column_Name, s_TrigramTable_Value_Column_Name });
+
+        pkIndexBuilder.Execute(connection);
+
+        savepoint.Commit();
+    }
+
+    bool TrigramTable::IsPopulated(const SQLite::Connection& connection)
+    {
+        StatementBuilder builder;
+        builder.Select(SQLite::RowIDName).From(s_TrigramTable_Table_Name).Limit(1);
+
+        SQLite::Statement statement = builder.Prepare(connection);
+        return statement.Step();
+    }
+
+    void TrigramTable::Populate(SQLite::Connection& connection)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "populatetrigramtable_v1_5");
+
+        Clear(connection);
+
+        StatementBuilder insertBuilder;
+        insertBuilder.InsertInto(s_TrigramTable_Table_Name).
+            Columns({ s_TrigramTable_Trigram_Column_Name, s_TrigramTable_Field_Column_Name, s_TrigramTable_Value_Column_Name }).
+            Values(Unbound, Unbound, Unbound);
+
+        SQLite::Statement insert = insertBuilder.Prepare(connection);
+        size_t rowCount = 0;
+
+        for (PackageMatchField field : s_SupportedFields)
+        {
+            QCol column = GetValueColumn(field).value();
+
+            StatementBuilder selectBuilder;
+            selectBuilder.Select({ SQLite::RowIDName, column.Column }).From(column.Table);
+
+            SQLite::Statement select = selectBuilder.Prepare(connection);
+
+            while (select.Step())
+            {
+                SQLite::rowid_t valueId = select.GetColumn<SQLite::rowid_t>(0);
+
+                for (const std::string& trigram : GetFoldedTrigrams(select.GetColumn<std::string>(1)))
+                {
+                    insert.Reset();
+                    insert.Bind(1, trigram);
+                    insert.Bind(2, field);
+                    insert.Bind(3, valueId);
+                    insert.Execute();
+                    ++rowCount;
+                }
+            }
+        }
+
+        AICLI_LOG(Repo, Info, << "Added " << rowCount << " rows to the trigram table");
+
+        savepoint.Commit();
+    }
+
+    void TrigramTable::Clear(SQLite::Connection& connection)
+    {
+        StatementBuilder builder;
+        builder.DeleteFrom(s_TrigramTable_Table_Name);
+
+        builder.Execute(connection);
+    }
+
+    std::vector<std::string> TrigramTable::GetQueryTrigrams(std::string_view value)
+    {
+        // A non-ASCII query may match values through folding that the trigrams do not account for, so it takes the full scan.
+        if (!IsASCII(value))
+        {
+            return {};
+        }
+
+        return SpreadTrigrams(GetFoldedTrigrams(value), s_MaximumQueryTrigrams);
+    }
+
+    bool TrigramTable::IsFieldSupported(PackageMatchField field)
+    {
+        return GetValueColumn(field).has_value();
+    }
+
+    void TrigramTable::AppendFilter(SQLite::Builder::StatementBuilder& builder, PackageMatchField field, const std::vector<std::string>& trigrams)
+    {
+        QCol column = GetValueColumn(field).value();
+
+        // Adds a clause like this for each trigram:
+        //      AND tags.rowid IN (SELECT value FROM trigrams WHERE trigram = <trigram> AND field = <field>)
+        for (const std::string& trigram : trigrams)
+        {
+            builder.And(QCol(column.Table, SQLite::RowIDName)).In().BeginParenthetical().
+                Select(s_TrigramTable_Value_Column_Name).From(s_TrigramTable_Table_Name).
+                Where(s_TrigramTable_Trigram_Column_Name).Equals(trigram).And(s_TrigramTable_Field_Column_Name).Equals(field).
+                EndParenthetical();
+        }
+    }
+
+    std::vector<std::pair<SQLite::rowid_t, std::string>> TrigramTable::GetFuzzyCandidates(
+        const SQLite::Connection& connection,
+        PackageMatchField field,
+        std::string_view value,
+        size_t maxDistance)
+    {
+        std::vector<std::string> trigrams = SpreadTrigrams(GetFoldedTrigrams(value), s_MaximumFuzzyTrigrams);
+
+        if (trigrams.empty())
+        {
+            return {};
+        }
+
+        // A single edit changes at most three of the trigrams, so a value within the distance shares all of the others.
+        size_t maxChanged = s_TrigramLength * maxDistance;
+        size_t minimumShared = (trigrams.size() > maxChanged ? trigrams.size() - maxChanged : 1);
+
+        QCol column = GetValueColumn(field).value();
+
+        // Select a row for every trigram that each value shares with the text, like:
+        //      SELECT trigrams.value, names.name FROM trigrams JOIN names ON trigrams.value = names.rowid
+        //      WHERE trigrams.trigram IN (<trigrams>) AND trigrams.field = <field>
+        StatementBuilder builder;
+        builder.Select({ QCol(s_TrigramTable_Table_Name, s_TrigramTable_Value_Column_Name), column }).From(s_TrigramTable_Table_Name).
+            Join(column.Table).On(QCol(s_TrigramTable_Table_Name, s_TrigramTable_Value_Column_Name), QCol(column.Table, SQLite::RowIDName)).
+            Where(QCol(s_TrigramTable_Table_Name, s_TrigramTable_Trigram_Column_Name)).In(trigrams.size()).
+            And(QCol(s_TrigramTable_Table_Name, s_TrigramTable_Field_Column_Name)).Equals(field);
+
+        SQLite::Statement select = builder.Prepare(connection);
+
+        for (size_t i = 0; i < trigrams.size(); ++i)
+        {
+            select.Bind(static_cast<int>(i + 1), trigrams[i]);
+        }
+
+        std::map<SQLite::rowid_t, std::pair<size_t, std::string>> sharedCounts;
+
+        while (select.Step())
+        {
+            auto& entry = sharedCounts[select.GetColumn<SQLite::rowid_t>(0)];
+            if (entry.first++ == 0)
+            {
+                entry.second = select.GetColumn<std::string>(1);
+            }
+        }
+
+        std::vector<std::pair<SQLite::rowid_t, std::string>> result;
+
+        for (auto& entry : sharedCounts)
+        {
+            if (entry.second.first >= minimumShared)
+            {
+                result.emplace_back(entry.first, std::move(entry.second.second));
+            }
+        }
+
+        AICLI_LOG(Repo, Verbose, << "Found " << result.size() << " fuzzy candidates out of " << sharedCounts.size() << " values sharing a trigram");
+
+        return result;
+    }
+
+    bool TrigramTable::CheckConsistency(const SQLite::Connection& connection, bool log)
+    {
+        bool result = true;
+
+        for (PackageMatchField field : s_SupportedFields)
+        {
+            QCol column = GetValueColumn(field).value();
+
+            // Build a select statement to find trigram rows that refer to non-existent values, such as:
+            // Select trigrams.rowid, trigrams.value from trigrams left outer join tags on trigrams.value = tags.rowid where trigrams.field = <field> and tags.tag is NULL
+            StatementBuilder builder;
+            builder.
+                Select({ QCol(s_TrigramTable_Table_Name, SQLite::RowIDName), QCol(s_TrigramTable_Table_Name, s_TrigramTable_Value_Column_Name) }).
+                From(s_TrigramTable_Table_Name).
+                LeftOuterJoin(column.Table).On(QCol(s_TrigramTable_Table_Name, s_TrigramTable_Value_Column_Name), QCol(column.Table, SQLite::RowIDName)).
+                Where(QCol(s_TrigramTable_Table_Name, s_TrigramTable_Field_Column_Name)).Equals(field).And(column).IsNull();
+
+            SQLite::Statement select = builder.Prepare(connection);
+
+            while (select.Step())
+            {
+                result = false;
+
+                if (!log)
+                {
+                    return result;
+                }
+
+                AICLI_LOG(Repo, Info, << "  [INVALID] trigrams [" << select.GetColumn<SQLite::rowid_t>(0) << "] refers to " << column.Table << " [" << select.GetColumn<SQLite::rowid_t>(1) << "]");
+            }
+        }
+
+        return result;
+    }
+}
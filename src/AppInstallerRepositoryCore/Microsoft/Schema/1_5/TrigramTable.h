@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "SQLiteWrapper.h"
+#include "SQLiteStatementBuilder.h"
+#include "Public/winget/RepositorySearch.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_5
+{
+    // A table that maps each three character sequence in the searchable values to the value rows containing it.
+    // This turns substring and prefix searches into indexed lookups rather than a LIKE over every value.
+    // It is only populated when preparing the index for packaging, and is emptied by any change after that.
+    struct TrigramTable
+    {
+        // Get the table name.
+        static std::string_view TableName();
+
+        // Creates the table with named indices.
+        static void Create(SQLite::Connection& connection);
+
+        // Determines if the table has data that can be used for searching.
+        static bool IsPopulated(const SQLite::Connection& connection);
+
+        // Fills the table from the current values of every supported field, replacing any existing data.
+        static void Populate(SQLite::Connection& connection);
+
+        // Removes all data from the table.
+        static void Clear(SQLite::Connection& connection);
+
+        // Gets the sequences that a value must contain in order to contain the given text, case insensitively.
+        // Returns an empty vector if the text cannot be looked up through the table.
+        static std::vector<std::string> GetQueryTrigrams(std::string_view value);
+
+        // Determines if the field has its values in the table.
+        static bool IsFieldSupported(PackageMatchField field);
+
+        // Appends conditions to the builder's where clause that limit the rows of the field's value table to
+        // those containing all of the given trigrams.
+        static void AppendFilter(SQLite::Builder::StatementBuilder& builder, PackageMatchField field, const std::vector<std::string>& trigrams);
+
+        // Gets the values of the field that may be within the given number of edits of the text, case insensitively, along with their row ids.
+        // Every value within that distance is returned, except where the edits could change all of the text's trigrams;
+        // then only values sharing at least one of them are. Returns an empty vector if the text has no trigrams.
+        static std::vector<std::pair<SQLite::rowid_t, std::string>> GetFuzzyCandidates(
+            const SQLite::Connection& connection,
+            PackageMatchField field,
+            std::string_view value,
+            size_t maxDistance);
+
+        // Checks the consistency of the index to ensure that every referenced row exists.
+        // Returns true if index is consistent; false if it is not.
+        static bool CheckConsistency(const SQLite::Connection& connection, bool log);
+    };
+}
@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "Microsoft/Schema/ISQLiteIndex.h"
+#include "Microsoft/Schema/1_5/Interface.h"
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_6
+{
+    // Interface to this schema version exposed through ISQLiteIndex.
+    struct Interface : public V1_5::Interface
+    {
+        Interface(Utility::NormalizationVersion normVersion = Utility::NormalizationVersion::Initial);
+
+        // Version 1.0
+        Schema::Version GetVersion() const override;
+        void CreateTables(SQLite::Connection& connection, CreateOptions options) override;
+        SQLite::rowid_t AddManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath) override;
+        std::pair<bool, SQLite::rowid_t> UpdateManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath) override;
+        void RemoveManifestById(SQLite::Connection& connection, SQLite::rowid_t manifestId) override;
+        bool CheckConsistency(const SQLite::Connection& connection, bool log) const override;
+        void PrepareForPackaging(SQLite::Connection& connection, bool vacuum) override;
+        std::optional<SQLite::rowid_t> GetManifestIdByKey(const SQLite::Connection& connection, SQLite::rowid_t id, std::string_view version, std::string_view channel) const override;
+        std::map<SQLite::rowid_t, SQLite::rowid_t> GetLatestManifestIdsByIds(const SQLite::Connection& connection, const std::vector<SQLite::rowid_t>& ids) const override;
+
+        // Version 1.6
+        std::optional<SQLite::blob_t> GetManifestContentByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId) const override;
+        void SetManifestContentByManifestId(SQLite::Connection& connection, SQLite::rowid_t manifestId, const SQLite::blob_t& content) override;
+    };
+}
@@ -0,0 +1,202 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Microsoft/Schema/1_6/Interface.h"
+
+#include "Microsoft/Schema/1_0/IdTable.h"
+#include "Microsoft/Schema/1_6/LatestManifestTable.h"
+#include "Microsoft/Schema/1_6/ManifestContentTable.h"
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_6
+{
+    namespace
+    {
+        // The latest manifests are only found when packaging; once the manifests change they may no longer be correct.
+        void ClearLatestManifestsIfPopulated(SQLite::Connection& connection)
+        {
+            if (LatestManifestTable::IsPopulated(connection))
+            {
+                AICLI_LOG(Repo, Info, << "Index modified after packaging; clearing latest manifests");
+                LatestManifestTable::Clear(connection);
+            }
+        }
+
+        // Embedded content describes the manifest as it was when embedded, so it must not outlive a change to it.
+        void RemoveManifestContentIfPresent(SQLite::Connection& connection, SQLite::rowid_t manifestId)
+        {
+            if (ManifestContentTable::Exists(connection))
+            {
+                ManifestContentTable::DeleteByManifestId(connection, manifestId);
+            }
+        }
+    }
+
+    Interface::Interface(Utility::NormalizationVersion normVersion) : V1_5::Interface(normVersion)
+    {
+    }
+
+    Schema::Version Interface::GetVersion() const
+    {
+        return { 1, 6 };
+    }
+
+    void Interface::CreateTables(SQLite::Connection& connection, CreateOptions options)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "createtables_v1_6");
+
+        V1_5::Interface::CreateTables(connection, options);
+
+        LatestManifestTable::Create(connection);
+
+        savepoint.Commit();
+    }
+
+    SQLite::rowid_t Interface::AddManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "addmanifest_v1_6");
+
+        SQLite::rowid_t manifestId = V1_5::Interface::AddManifest(connection, manifest, relativePath);
+
+        ClearLatestManifestsIfPopulated(connection);
+
+        savepoint.Commit();
+
+        return manifestId;
+    }
+
+    std::pair<bool, SQLite::rowid_t> Interface::UpdateManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "updatemanifest_v1_6");
+
+        auto result = V1_5::Interface::UpdateManifest(connection, manifest, relativePath);
+
+        if (result.first)
+        {
+            ClearLatestManifestsIfPopulated(connection);
+            RemoveManifestContentIfPresent(connection, result.second);
+        }
+
+        savepoint.Commit();
+
+        return result;
+    }
+
+    void Interface::RemoveManifestById(SQLite::Connection& connection, SQLite::rowid_t manifestId)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "removemanifest_v1_6");
+
+        V1_5::Interface::RemoveManifestById(connection, manifestId);
+
+        ClearLatestManifestsIfPopulated(connection);
+        RemoveManifestContentIfPresent(connection, manifestId);
+
+        savepoint.Commit();
+    }
+
+    bool Interface::CheckConsistency(const SQLite::Connection& connection, bool log) const
+    {
+        bool result = V1_5::Interface::CheckConsistency(connection, log);
+
+        // If the v1.5 index was consistent, or if full logging of inconsistency was requested, check the v1.6 data.
+        if (result || log)
+        {
+            result = LatestManifestTable::CheckConsistency(connection, log) && result;
+        }
+
+        return result;
+    }
+
+    void Interface::PrepareForPackaging(SQLite::Connection& connection, bool vacuum)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "prepareforpackaging_v1_6");
+
+        V1_5::Interface::PrepareForPackaging(connection, false);
+
+        // Find the latest manifests exactly as a lookup without the table would, so that the results do not change.
+        LatestManifestTable::Clear(connection);
+
+        size_t rowCount = 0;
+        for (SQLite::rowid_t id : V1_0::IdTable::GetAllRowIds(connection))
+        {
+            std::optional<SQLite::rowid_t> manifestId = V1_5::Interface::GetManifestIdByKey(connection, id, {}, {});
+            if (manifestId)
+            {
+                LatestManifestTable::SetManifestId(connection, id, manifestId.value());
+                ++rowCount;
+            }
+        }
+
+        AICLI_LOG(Repo, Info, << "Added " << rowCount << " rows to the latest manifest table");
+
+        savepoint.Commit();
+
+        if (vacuum)
+        {
+            // Force the database to actually shrink the file size.
+            // This *must* be done outside of an active transaction.
+            SQLite::Builder::StatementBuilder builder;
+            builder.Vacuum();
+            builder.Execute(connection);
+        }
+    }
+
+    std::optional<SQLite::rowid_t> Interface::GetManifestIdByKey(const SQLite::Connection& connection, SQLite::rowid_t id, std::string_view version, std::string_view channel) const
+    {
+        if (version.empty() && channel.empty())
+        {
+            std::optional<SQLite::rowid_t> result = LatestManifestTable::GetManifestId(connection, id);
+            if (result)
+            {
+                return result;
+            }
+        }
+
+        return V1_5::Interface::GetManifestIdByKey(connection, id, version, channel);
+    }
+
+    std::map<SQLite::rowid_t, SQLite::rowid_t> Interface::GetLatestManifestIdsByIds(const SQLite::Connection& connection, const std::vector<SQLite::rowid_t>& ids) const
+    {
+        std::map<SQLite::rowid_t, SQLite::rowid_t> result = LatestManifestTable::GetManifestIds(connection, ids);
+
+        // Any id not in the table, as when it has been cleared by a change, is looked up by its versions.
+        std::vector<SQLite::rowid_t> remaining;
+        for (SQLite::rowid_t id : ids)
+        {
+            if (result.find(id) == result.end())
+            {
+                remaining.emplace_back(id);
+            }
+        }
+
+        if (!remaining.empty())
+        {
+            result.merge(V1_5::Interface::GetLatestManifestIdsByIds(connection, remaining));
+        }
+
+        return result;
+    }
+
+    std::optional<SQLite::blob_t> Interface::GetManifestContentByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId) const
+    {
+        if (!ManifestContentTable::Exists(connection))
+        {
+            return {};
+        }
+
+        return ManifestContentTable::GetContentByManifestId(connection, manifestId);
+    }
+
+    void Interface::SetManifestContentByManifestId(SQLite::Connection& connection, SQLite::rowid_t manifestId, const SQLite::blob_t& content)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "setmanifestcontent_v1_6");
+
+        if (!ManifestContentTable::Exists(connection))
+        {
+            ManifestContentTable::Create(connection);
+        }
+
+        ManifestContentTable::SetContentByManifestId(connection, manifestId, content);
+
+        savepoint.Commit();
+    }
+}
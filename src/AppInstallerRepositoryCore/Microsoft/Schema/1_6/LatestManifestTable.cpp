@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "LatestManifestTable.h"
+#include "SQLiteStatementBuilder.h"
+
+#include "Microsoft/Schema/1_0/IdTable.h"
+#include "Microsoft/Schema/1_0/ManifestTable.h"
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_6
+{
+    using namespace std::string_view_literals;
+    using namespace SQLite::Builder;
+    using QCol = SQLite::Builder::QualifiedColumn;
+
+    namespace
+    {
+        constexpr std::string_view s_LatestManifestTable_Table_Name = "latest_manifests"sv;
+        constexpr std::string_view s_LatestManifestTable_Manifest_Column_Name = "manifest"sv;
+    }
+
+    std::string_view LatestManifestTable::TableName()
+    {
+        return s_LatestManifestTable_Table_Name;
+    }
+
+    void LatestManifestTable::Create(SQLite::Connection& connection)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "createlatestmanifesttable_v1_6");
+
+        StatementBuilder createTableBuilder;
+        createTableBuilder.CreateTable(s_LatestManifestTable_Table_Name).Columns({
+            IntegerPrimaryKey(),
+            ColumnBuilder(s_LatestManifestTable_Manifest_Column_Name, Type::RowId).NotNull()
+            });
+
+        createTableBuilder.Execute(connection);
+
+        savepoint.Commit();
+    }
+
+    bool LatestManifestTable::IsPopulated(const SQLite::Connection& connection)
+    {
+        StatementBuilder builder;
+        builder.Select(SQLite::RowIDName).From(s_LatestManifestTable_Table_Name).Limit(1);
+
+        SQLite::Statement statement = builder.Prepare(connection);
+        return statement.Step();
+    }
+
+    void LatestManifestTable::SetManifestId(SQLite::Connection& connection, SQLite::rowid_t id, SQLite::rowid_t manifestId)
+    {
+        StatementBuilder builder;
+        builder.InsertInto(s_LatestManifestTable_Table_Name).
+            Columns({ SQLite::RowIDName, s_LatestManifestTable_Manifest_Column_Name }).
+            Values(id, manifestId);
+
+        builder.Execute(connection);
+    }
+
+    std::optional<SQLite::rowid_t> LatestManifestTable::GetManifestId(const SQLite::Connection& connection, SQLite::rowid_t id)
+    {
+        StatementBuilder builder;
+        builder.Select(s_LatestManifestTable_Manifest_Column_Name).From(s_LatestManifestTable_Table_Name).Where(SQLite::RowIDName).Equals(id);
+
+        SQLite::Statement select = builder.Prepare(connection);
+
+        if (select.Step())
+        {
+            return select.GetColumn<SQLite::rowid_t>(0);
+        }
+
+        return {};
+    }
+
+    std::map<SQLite::rowid_t, SQLite::rowid_t> LatestManifestTable::GetManifestIds(const SQLite::Connection& connection, const std::vector<SQLite::rowid_t>& ids)
+    {
+        std::map<SQLite::rowid_t, SQLite::rowid_t> result;
+
+        for (size_t i = 0; i < ids.size(); i += V1_0::details::ManifestTableMaximumIdsPerStatement)
+        {
+            size_t count = std::min(V1_0::details::ManifestTableMaximumIdsPerStatement, ids.size() - i);
+
+            StatementBuilder builder;
+            builder.Select({ SQLite::RowIDName, s_LatestManifestTable_Manifest_Column_Name }).From(s_LatestManifestTable_Table_Name).Where(SQLite::RowIDName).In(count);
+
+            SQLite::Statement select = builder.Prepare(connection);
+
+            for (size_t j = 0; j < count; ++j)
+            {
+                select.Bind(static_cast<int>(j + 1), ids[i + j]);
+            }
+
+            while (select.Step())
+            {
+                result.emplace(select.GetColumn<SQLite::rowid_t>(0), select.GetColumn<SQLite::rowid_t>(1));
+            }
+        }
+
+        return result;
+    }
+
+    void LatestManifestTable::Clear(SQLite::Connection& connection)
+    {
+        StatementBuilder builder;
+        builder.DeleteFrom(s_LatestManifestTable_Table_Name);
+
+        builder.Execute(connection);
+    }
+
+    bool LatestManifestTable::CheckConsistency(const SQLite::Connection& connection, bool log)
+    {
+        bool result = true;
+
+        // Build a select statement to find rows that refer to non-existent ids or manifests, such as:
+        // Select latest_manifests.rowid, latest_manifests.manifest from latest_manifests
+        // left outer join ids on latest_manifests.rowid = ids.rowid left outer join manifest on latest_manifests.manifest = manifest.rowid
+        // where ids.id is NULL or manifest.rowid is NULL
+        StatementBuilder builder;
+        builder.
+            Select({ QCol(s_LatestManifestTable_Table_Name, SQLite::RowIDName), QCol(s_LatestManifestTable_Table_Name, s_LatestManifestTable_Manifest_Column_Name) }).
+            From(s_LatestManifestTable_Table_Name).
+            LeftOuterJoin(V1_0::IdTable::TableName()).On(QCol(s_LatestManifestTable_Table_Name, SQLite::RowIDName), QCol(V1_0::IdTable::TableName(), SQLite::RowIDName)).
+            LeftOuterJoin(V1_0::ManifestTable::TableName()).On(QCol(s_LatestManifestTable_Table_Name, s_LatestManifestTable_Manifest_Column_Name), QCol(V1_0::ManifestTable::TableName(), SQLite::RowIDName)).
+            Where(QCol(V1_0::IdTable::TableName(), V1_0::IdTable::ValueName())).IsNull().
+            Or(QCol(V1_0::ManifestTable::TableName(), SQLite::RowIDName)).IsNull();
+
+        SQLite::Statement select = builder.Prepare(connection);
+
+        while (select.Step())
+        {
+            result = false;
+
+            if (!log)
+            {
+                break;
+            }
+
+            AICLI_LOG(Repo, Info, << "  [INVALID] " << s_LatestManifestTable_Table_Name << " [" << select.GetColumn<SQLite::rowid_t>(0) << "] refers to manifest [" << select.GetColumn<SQLite::rowid_t>(1) << "]");
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "SQLiteWrapper.h"
+
+#include <map>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_6
+{
+    // A table that holds the manifest of the latest version of each package, keyed by the rowid of its id.
+    // This allows the latest version to be found without reading and sorting all of the versions.
+    // It is only populated when preparing the index for packaging, and is emptied by any change after that.
+    struct LatestManifestTable
+    {
+        // Get the table name.
+        static std::string_view TableName();
+
+        // Creates the table.
+        static void Create(SQLite::Connection& connection);
+
+        // Determines if the table has data that can be used for lookups.
+        static bool IsPopulated(const SQLite::Connection& connection);
+
+        // Sets the latest manifest for the given id.
+        static void SetManifestId(SQLite::Connection& connection, SQLite::rowid_t id, SQLite::rowid_t manifestId);
+
+        // Gets the latest manifest for the given id, if present.
+        static std::optional<SQLite::rowid_t> GetManifestId(const SQLite::Connection& connection, SQLite::rowid_t id);
+
+        // Gets the latest manifest for each of the given ids, leaving out those that are not present.
+        static std::map<SQLite::rowid_t, SQLite::rowid_t> GetManifestIds(const SQLite::Connection& connection, const std::vector<SQLite::rowid_t>& ids);
+
+        // Removes all data from the table.
+        static void Clear(SQLite::Connection& connection);
+
+        // Checks the consistency of the index to ensure that every referenced row exists.
+        // Returns true if index is consistent; false if it is not.
+        static bool CheckConsistency(const SQLite::Connection& connection, bool log);
+    };
+}
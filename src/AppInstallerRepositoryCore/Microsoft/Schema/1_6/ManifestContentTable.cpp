@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "ManifestContentTable.h"
+#include "SQLiteStatementBuilder.h"
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_6
+{
+    using namespace SQLite;
+
+    static constexpr std::string_view s_ManifestContentTable_Table_Name = "manifest_content"sv;
+    static constexpr std::string_view s_ManifestContentTable_PrimaryKeyIndex_Name = "manifest_content_pk"sv;
+    static constexpr std::string_view s_ManifestContentTable_Manifest_Column = "manifest"sv;
+    static constexpr std::string_view s_ManifestContentTable_Content_Column = "content"sv;
+
+    bool ManifestContentTable::Exists(const SQLite::Connection& connection)
+    {
+        Builder::StatementBuilder builder;
+        builder.Select(Builder::RowCount).From(Builder::Schema::MainTable).
+            Where(Builder::Schema::TypeColumn).Equals(Builder::Schema::Type_Table).And(Builder::Schema::NameColumn).Equals(s_ManifestContentTable_Table_Name);
+
+        Statement statement = builder.Prepare(connection);
+        THROW_HR_IF(E_UNEXPECTED, !statement.Step());
+        return statement.GetColumn<int64_t>(0) != 0;
+    }
+
+    void ManifestContentTable::Create(SQLite::Connection& connection)
+    {
+        using namespace Builder;
+
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "createmanifestcontent_v1_6");
+
+        StatementBuilder createTableBuilder;
+        createTableBuilder.CreateTable(s_ManifestContentTable_Table_Name).Columns({
+            ColumnBuilder(s_ManifestContentTable_Manifest_Column, Type::Int64).NotNull(),
+            ColumnBuilder(s_ManifestContentTable_Content_Column, Type::Blob)
+            });
+
+        createTableBuilder.Execute(connection);
+
+        StatementBuilder createPKIndexBuilder;
+        createPKIndexBuilder.CreateUniqueIndex(s_ManifestContentTable_PrimaryKeyIndex_Name).On(s_ManifestContentTable_Table_Name).
+            Columns(s_ManifestContentTable_Manifest_Column);
+        createPKIndexBuilder.Execute(connection);
+
+        savepoint.Commit();
+    }
+
+    std::optional<SQLite::blob_t> ManifestContentTable::GetContentByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId)
+    {
+        using namespace Builder;
+
+        StatementBuilder builder;
+        builder.Select(s_ManifestContentTable_Content_Column).From(s_ManifestContentTable_Table_Name).
+            Where(s_ManifestContentTable_Manifest_Column).Equals(manifestId);
+
+        Statement statement = builder.Prepare(connection);
+
+        if (statement.Step())
+        {
+            return statement.GetColumn<blob_t>(0);
+        }
+
+        return {};
+    }
+
+    void ManifestContentTable::SetContentByManifestId(SQLite::Connection& connection, SQLite::rowid_t manifestId, const SQLite::blob_t& content)
+    {
+        using namespace Builder;
+
+        // As with the manifest metadata, UPSERT is not available on all supported versions of Windows.
+        StatementBuilder updateBuilder;
+        updateBuilder.Update(s_ManifestContentTable_Table_Name).Set().Column(s_ManifestContentTable_Content_Column).Equals(content).
+            Where(s_ManifestContentTable_Manifest_Column).Equals(manifestId);
+
+        updateBuilder.Execute(connection);
+
+        // No changes means we need to insert the row
+        if (connection.GetChanges() == 0)
+        {
+            StatementBuilder insertBuilder;
+            insertBuilder.InsertInto(s_ManifestContentTable_Table_Name).
+                Columns({ s_ManifestContentTable_Manifest_Column, s_ManifestContentTable_Content_Column })
+                .Values(manifestId, content);
+
+            insertBuilder.Execute(connection);
+        }
+    }
+
+    void ManifestContentTable::DeleteByManifestId(SQLite::Connection& connection, SQLite::rowid_t manifestId)
+    {
+        using namespace Builder;
+
+        StatementBuilder builder;
+        builder.DeleteFrom(s_ManifestContentTable_Table_Name).Where(s_ManifestContentTable_Manifest_Column).Equals(manifestId);
+        builder.Execute(connection);
+    }
+}
@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "SQLiteWrapper.h"
+
+#include <optional>
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_6
+{
+    // A table for storing the compressed content of individual manifests, so that they can be read without a download.
+    // The table and all content are optional; it is only created when content is embedded while packaging.
+    struct ManifestContentTable
+    {
+        // Determine if the table currently exists in the database.
+        static bool Exists(const SQLite::Connection& connection);
+
+        // Creates the table in the database.
+        static void Create(SQLite::Connection& connection);
+
+        // Gets the content associated with the given manifest, if present.
+        // The table must exist.
+        static std::optional<SQLite::blob_t> GetContentByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId);
+
+        // Sets the content for the given manifest.
+        // The table must exist.
+        static void SetContentByManifestId(SQLite::Connection& connection, SQLite::rowid_t manifestId, const SQLite::blob_t& content);
+
+        // Removes the content for the given manifest.
+        // The table must exist.
+        static void DeleteByManifestId(SQLite::Connection& connection, SQLite::rowid_t manifestId);
+    };
+}
@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Microsoft/Schema/1_7/Interface.h"
+
+#include "Microsoft/Schema/1_0/ManifestTable.h"
+#include "Microsoft/Schema/1_7/RelativePathVirtualTable.h"
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_7
+{
+    namespace
+    {
+        // Joins the parts of the path exactly as they are joined when read back from the path part table.
+        std::string GetRelativePathValue(const std::optional<std::filesystem::path>& relativePath)
+        {
+            std::string result;
+
+            if (relativePath)
+            {
+                for (const auto& part : relativePath.value())
+                {
+                    if (!result.empty())
+                    {
+                        result += '/';
+                    }
+
+                    result += part.u8string();
+                }
+            }
+
+            return result;
+        }
+    }
+
+    Interface::Interface(Utility::NormalizationVersion normVersion) : V1_6::Interface(normVersion)
+    {
+    }
+
+    Schema::Version Interface::GetVersion() const
+    {
+        return { 1, 7 };
+    }
+
+    void Interface::CreateTables(SQLite::Connection& connection, CreateOptions options)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "createtables_v1_7");
+
+        V1_6::Interface::CreateTables(connection, options);
+
+        V1_0::ManifestTable::AddColumn(connection, { RelativePathVirtualTable::ValueName(), RelativePathVirtualTable::SQLiteType() });
+
+        savepoint.Commit();
+    }
+
+    SQLite::rowid_t Interface::AddManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "addmanifest_v1_7");
+
+        SQLite::rowid_t manifestId = V1_6::Interface::AddManifest(connection, manifest, relativePath);
+
+        // Always set the value, even when empty, so that the column is never null.
+        V1_0::ManifestTable::UpdateValueIdById<RelativePathVirtualTable>(connection, manifestId, GetRelativePathValue(relativePath));
+
+        savepoint.Commit();
+
+        return manifestId;
+    }
+
+    std::pair<bool, SQLite::rowid_t> Interface::UpdateManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "updatemanifest_v1_7");
+
+        auto [indexModified, manifestId] = V1_6::Interface::UpdateManifest(connection, manifest, relativePath);
+
+        // The path is only changed if one is provided, as with the path parts.
+        if (relativePath)
+        {
+            std::string newPath = GetRelativePathValue(relativePath);
+            auto [currentPath] = V1_0::ManifestTable::GetIdsById<RelativePathVirtualTable>(connection, manifestId);
+
+            if (currentPath != newPath)
+            {
+                V1_0::ManifestTable::UpdateValueIdById<RelativePathVirtualTable>(connection, manifestId, newPath);
+                indexModified = true;
+            }
+        }
+
+        savepoint.Commit();
+
+        return { indexModified, manifestId };
+    }
+
+    std::optional<std::string> Interface::GetPropertyByManifestIdInternal(const SQLite::Connection& connection, SQLite::rowid_t manifestId, PackageVersionProperty property) const
+    {
+        switch (property)
+        {
+        case AppInstaller::Repository::PackageVersionProperty::RelativePath:
+        {
+            // Pathless manifests have an empty value, and are left to the path parts to resolve as before.
+            std::string relativePath = std::get<0>(V1_0::ManifestTable::GetIdsById<RelativePathVirtualTable>(connection, manifestId));
+            if (!relativePath.empty())
+            {
+                return relativePath;
+            }
+
+            return V1_6::Interface::GetPropertyByManifestIdInternal(connection, manifestId, property);
+        }
+        default:
+            return V1_6::Interface::GetPropertyByManifestIdInternal(connection, manifestId, property);
+        }
+    }
+}
@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "SQLiteStatementBuilder.h"
+
+#include <string_view>
+
+using namespace std::string_view_literals;
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_7
+{
+    // A virtual table used to add a direct column onto the manifest table.
+    // The column holds the whole relative path, so that it is read with the manifest rather than by walking the path parts.
+    struct RelativePathVirtualTable
+    {
+        // The id type (which is actually the value for this virtual table)
+        using id_t = std::string;
+
+        // The name of the column.
+        static constexpr std::string_view ValueName()
+        {
+            return "relativepath"sv;
+        }
+
+        // The name of the column.
+        static constexpr SQLite::Builder::Type SQLiteType()
+        {
+            return SQLite::Builder::Type::Text;
+        }
+    };
+}
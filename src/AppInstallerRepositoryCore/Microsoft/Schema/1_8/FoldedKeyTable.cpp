@@ -0,0 +1,218 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "FoldedKeyTable.h"
+
+#include "Microsoft/Schema/1_0/IdTable.h"
+#include "Microsoft/Schema/1_0/MonikerTable.h"
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_8
+{
+    using namespace std::string_view_literals;
+    using namespace SQLite::Builder;
+    using QCol = SQLite::Builder::QualifiedColumn;
+
+    namespace
+    {
+        constexpr std::string_view s_FoldedKeyTable_Table_Name = "folded_keys"sv;
+        constexpr std::string_view s_FoldedKeyTable_Index_Name = "folded_keys_pkindex"sv;
+        constexpr std::string_view s_FoldedKeyTable_Field_Column_Name = "field"sv;
+        constexpr std::string_view s_FoldedKeyTable_Key_Column_Name = "folded"sv;
+        constexpr std::string_view s_FoldedKeyTable_Value_Column_Name = "value"sv;
+
+        // The value tables that are looked up through their keys.
+        std::optional<QCol> GetValueColumn(PackageMatchField field)
+        {
+            switch (field)
+            {
+            case PackageMatchField::Id:
+                return QCol{ V1_0::IdTable::TableName(), V1_0::IdTable::ValueName() };
+            case PackageMatchField::Moniker:
+                return QCol{ V1_0::MonikerTable::TableName(), V1_0::MonikerTable::ValueName() };
+            default:
+                return std::nullopt;
+            }
+        }
+
+        constexpr PackageMatchField s_SupportedFields[] = {
+            PackageMatchField::Id,
+            PackageMatchField::Moniker,
+        };
+    }
+
+    std::string_view FoldedKeyTable::TableName()
+    {
+        return s_FoldedKeyTable_Table_Name;
+    }
+
+    void FoldedKeyTable::Create(SQLite::Connection& connection)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "createfoldedkeytable_v1_8");
+
+        StatementBuilder createTableBuilder;
+        createTableBuilder.CreateTable(s_FoldedKeyTable_Table_Name).Columns({
+            ColumnBuilder(s_FoldedKeyTable_Field_Column_Name, Type::Int).NotNull(),
+            ColumnBuilder(s_FoldedKeyTable_Key_Column_Name, Type::Text).NotNull(),
+            ColumnBuilder(s_FoldedKeyTable_Value_Column_Name, Type::RowId).NotNull()
+            });
+
+        createTableBuilder.Execute(connection);
+
+        // The key column uses the default collation, so that lookups compare it byte by byte.
+        StatementBuilder pkIndexBuilder;
+        pkIndexBuilder.CreateUniqueIndex(s_FoldedKeyTable_Index_Name).On(s_FoldedKeyTable_Table_Name).
+            Columns({ s_FoldedKeyTable_Field_Column_Name, s_FoldedKeyTable_Key_Column_Name, s_FoldedKeyTable_Value_Column_Name });
+
+        pkIndexBuilder.Execute(connection);
+
+        savepoint.Commit();
+    }
+
+    bool FoldedKeyTable::IsPopulated(const SQLite::Connection& connection)
+    {
+        StatementBuilder builder;
+        builder.Select(SQLite::RowIDName).From(s_FoldedKeyTable_Table_Name).Limit(1);
+
+        SQLite::Statement statement = builder.Prepare(connection);
+        return statement.Step();
+    }
+
+    void FoldedKeyTable::Populate(SQLite::Connection& connection)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "populatefoldedkeytable_v1_8");
+
+        Clear(connection);
+
+        StatementBuilder insertBuilder;
+        insertBuilder.InsertInto(s_FoldedKeyTable_Table_Name).
+            Columns({ s_FoldedKeyTable_Field_Column_Name, s_FoldedKeyTable_Key_Column_Name, s_FoldedKeyTable_Value_Column_Name }).
+            Values(Unbound, Unbound, Unbound);
+
+        SQLite::Statement insert = insertBuilder.Prepare(connection);
+        size_t rowCount = 0;
+
+        for (PackageMatchField field : s_SupportedFields)
+        {
+            QCol column = GetValueColumn(field).value();
+
+            StatementBuilder selectBuilder;
+            selectBuilder.Select({ SQLite::RowIDName, column.Column }).From(column.Table);
+
+            SQLite::Statement select = selectBuilder.Prepare(connection);
+
+            while (select.Step())
+            {
+                insert.Reset();
+                insert.Bind(1, field);
+                insert.Bind(2, GetFoldedKey(select.GetColumn<std::string>(1)));
+                insert.Bind(3, select.GetColumn<SQLite::rowid_t>(0));
+                insert.Execute();
+                ++rowCount;
+            }
+        }
+
+        AICLI_LOG(Repo, Info, << "Added " << rowCount << " rows to the folded key table");
+
+        savepoint.Commit();
+    }
+
+    void FoldedKeyTable::Clear(SQLite::Connection& connection)
+    {
+        StatementBuilder builder;
+        builder.DeleteFrom(s_FoldedKeyTable_Table_Name);
+
+        builder.Execute(connection);
+    }
+
+    bool FoldedKeyTable::IsFieldSupported(PackageMatchField field)
+    {
+        return GetValueColumn(field).has_value();
+    }
+
+    std::string FoldedKeyTable::GetFoldedKey(std::string_view value)
+    {
+        return Utility::FoldCaseByCodePoint(value);
+    }
+
+    std::vector<int> FoldedKeyTable::AppendFilter(SQLite::Builder::StatementBuilder& builder, PackageMatchField field, bool isPrefix)
+    {
+        QCol column = GetValueColumn(field).value();
+
+        // Adds a clause like:
+        //      AND ids.rowid IN (SELECT value FROM folded_keys WHERE field = <field> AND folded >= <key> AND folded < <key + 0xFF>)
+        // OR
+        //      AND ids.rowid IN (SELECT value FROM folded_keys WHERE field = <field> AND folded = <key>)
+        builder.And(QCol(column.Table, SQLite::RowIDName)).In().BeginParenthetical().
+            Select(s_FoldedKeyTable_Value_Column_Name).From(s_FoldedKeyTable_Table_Name).
+            Where(s_FoldedKeyTable_Field_Column_Name).Equals(field).And(s_FoldedKeyTable_Key_Column_Name);
+
+        std::vector<int> result;
+
+        if (isPrefix)
+        {
+            builder.GreaterThanOrEquals(Unbound);
+            result.push_back(builder.GetLastBindIndex());
+            builder.And(s_FoldedKeyTable_Key_Column_Name).LessThan(Unbound);
+            result.push_back(builder.GetLastBindIndex());
+        }
+        else
+        {
+            builder.Equals(Unbound);
+            result.push_back(builder.GetLastBindIndex());
+        }
+
+        builder.EndParenthetical();
+
+        return result;
+    }
+
+    void FoldedKeyTable::BindFilter(SQLite::Statement& statement, const std::vector<int>& bindIndex, std::string_view value, bool isPrefix)
+    {
+        std::string key = GetFoldedKey(value);
+
+        if (isPrefix)
+        {
+            // No byte of UTF-8 is 0xFF, so every key that starts with the prefix sorts below the prefix followed by it,
+            // and every other key that sorts after the prefix also sorts after that.
+            statement.Bind(bindIndex[1], key + '\xFF');
+        }
+
+        statement.Bind(bindIndex[0], key);
+    }
+
+    bool FoldedKeyTable::CheckConsistency(const SQLite::Connection& connection, bool log)
+    {
+        bool result = true;
+
+        for (PackageMatchField field : s_SupportedFields)
+        {
+            QCol column = GetValueColumn(field).value();
+
+            // Build a select statement to find key rows that refer to non-existent values, such as:
+            // Select folded_keys.rowid, folded_keys.value from folded_keys left outer join ids on folded_keys.value = ids.rowid where folded_keys.field = <field> and ids.id is NULL
+            StatementBuilder builder;
+            builder.
+                Select({ QCol(s_FoldedKeyTable_Table_Name, SQLite::RowIDName), QCol(s_FoldedKeyTable_Table_Name, s_FoldedKeyTable_Value_Column_Name) }).
+                From(s_FoldedKeyTable_Table_Name).
+                LeftOuterJoin(column.Table).On(QCol(s_FoldedKeyTable_Table_Name, s_FoldedKeyTable_Value_Column_Name), QCol(column.Table, SQLite::RowIDName)).
+                Where(QCol(s_FoldedKeyTable_Table_Name, s_FoldedKeyTable_Field_Column_Name)).Equals(field).And(column).IsNull();
+
+            SQLite::Statement select = builder.Prepare(connection);
+
+            while (select.Step())
+            {
+                result = false;
+
+                if (!log)
+                {
+                    return result;
+                }
+
+                AICLI_LOG(Repo, Info, << "  [INVALID] folded_keys [" << select.GetColumn<SQLite::rowid_t>(0) << "] refers to " << column.Table << " [" << select.GetColumn<SQLite::rowid_t>(1) << "]");
+            }
+        }
+
+        return result;
+    }
+}
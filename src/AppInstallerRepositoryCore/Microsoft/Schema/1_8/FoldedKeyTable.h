@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "SQLiteWrapper.h"
+#include "SQLiteStatementBuilder.h"
+#include "Public/winget/RepositorySearch.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_8
+{
+    // A table that holds the case folded form of each id and moniker, with an index over them.
+    // Case insensitive and prefix searches then become a range of byte comparisons in the index, rather than a LIKE
+    // that folds every value of the table as it is scanned.
+    // It is only populated when preparing the index for packaging, and is emptied by any change after that.
+    struct FoldedKeyTable
+    {
+        // Get the table name.
+        static std::string_view TableName();
+
+        // Creates the table with named indices.
+        static void Create(SQLite::Connection& connection);
+
+        // Determines if the table has data that can be used for searching.
+        static bool IsPopulated(const SQLite::Connection& connection);
+
+        // Fills the table from the current values of every supported field, replacing any existing data.
+        static void Populate(SQLite::Connection& connection);
+
+        // Removes all data from the table.
+        static void Clear(SQLite::Connection& connection);
+
+        // Determines if the field has its values in the table.
+        static bool IsFieldSupported(PackageMatchField field);
+
+        // Gets the key for the value; each code point is folded on its own, as the LIKE used by searches does.
+        static std::string GetFoldedKey(std::string_view value);
+
+        // Appends a condition to the builder's where clause that limits the rows of the field's value table to those whose
+        // key is equal to, or if isPrefix is true starts with, that of a value. Returns the bind indices for BindFilter.
+        static std::vector<int> AppendFilter(SQLite::Builder::StatementBuilder& builder, PackageMatchField field, bool isPrefix);
+
+        // Binds the value to the indices returned by AppendFilter.
+        static void BindFilter(SQLite::Statement& statement, const std::vector<int>& bindIndex, std::string_view value, bool isPrefix);
+
+        // Checks the consistency of the index to ensure that every referenced row exists.
+        // Returns true if index is consistent; false if it is not.
+        static bool CheckConsistency(const SQLite::Connection& connection, bool log);
+    };
+}
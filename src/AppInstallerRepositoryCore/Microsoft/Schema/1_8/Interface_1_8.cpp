@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Microsoft/Schema/1_8/Interface.h"
+
+#include "Microsoft/Schema/1_5/TrigramTable.h"
+#include "Microsoft/Schema/1_8/FoldedKeyTable.h"
+#include "Microsoft/Schema/1_8/SearchResultsTable.h"
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_8
+{
+    namespace
+    {
+        // The keys are only built when packaging; once the values change they no longer describe them.
+        void ClearFoldedKeysIfPopulated(SQLite::Connection& connection)
+        {
+            if (FoldedKeyTable::IsPopulated(connection))
+            {
+                AICLI_LOG(Repo, Info, << "Index modified after packaging; clearing folded keys");
+                FoldedKeyTable::Clear(connection);
+            }
+        }
+    }
+
+    Interface::Interface(Utility::NormalizationVersion normVersion) : V1_7::Interface(normVersion)
+    {
+    }
+
+    Schema::Version Interface::GetVersion() const
+    {
+        return { 1, 8 };
+    }
+
+    void Interface::CreateTables(SQLite::Connection& connection, CreateOptions options)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "createtables_v1_8");
+
+        V1_7::Interface::CreateTables(connection, options);
+
+        FoldedKeyTable::Create(connection);
+
+        savepoint.Commit();
+    }
+
+    SQLite::rowid_t Interface::AddManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "addmanifest_v1_8");
+
+        SQLite::rowid_t manifestId = V1_7::Interface::AddManifest(connection, manifest, relativePath);
+
+        ClearFoldedKeysIfPopulated(connection);
+
+        savepoint.Commit();
+
+        return manifestId;
+    }
+
+    std::pair<bool, SQLite::rowid_t> Interface::UpdateManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "updatemanifest_v1_8");
+
+        auto result = V1_7::Interface::UpdateManifest(connection, manifest, relativePath);
+
+        if (result.first)
+        {
+            ClearFoldedKeysIfPopulated(connection);
+        }
+
+        savepoint.Commit();
+
+        return result;
+    }
+
+    void Interface::RemoveManifestById(SQLite::Connection& connection, SQLite::rowid_t manifestId)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "removemanifest_v1_8");
+
+        V1_7::Interface::RemoveManifestById(connection, manifestId);
+
+        ClearFoldedKeysIfPopulated(connection);
+
+        savepoint.Commit();
+    }
+
+    bool Interface::CheckConsistency(const SQLite::Connection& connection, bool log) const
+    {
+        bool result = V1_7::Interface::CheckConsistency(connection, log);
+
+        // If the v1.7 index was consistent, or if full logging of inconsistency was requested, check the v1.8 data.
+        if (result || log)
+        {
+            result = FoldedKeyTable::CheckConsistency(connection, log) && result;
+        }
+
+        return result;
+    }
+
+    void Interface::PrepareForPackaging(SQLite::Connection& connection, bool vacuum)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "prepareforpackaging_v1_8");
+
+        V1_7::Interface::PrepareForPackaging(connection, false);
+
+        FoldedKeyTable::Populate(connection);
+
+        savepoint.Commit();
+
+        if (vacuum)
+        {
+            // Force the database to actually shrink the file size.
+            // This *must* be done outside of an active transaction.
+            SQLite::Builder::StatementBuilder builder;
+            builder.Vacuum();
+            builder.Execute(connection);
+        }
+    }
+
+    std::unique_ptr<V1_0::SearchResultsTable> Interface::CreateSearchResultsTable(const SQLite::Connection& connection) const
+    {
+        return std::make_unique<SearchResultsTable>(connection, V1_5::TrigramTable::IsPopulated(connection), FoldedKeyTable::IsPopulated(connection));
+    }
+}
@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "Microsoft/Schema/1_5/SearchResultsTable.h"
+
+#include <vector>
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_8
+{
+    // Table for holding temporary search results.
+    struct SearchResultsTable : public V1_5::SearchResultsTable
+    {
+        // If useFoldedKeys is true, case insensitive and prefix searches on the supported fields find their values through the folded key table.
+        SearchResultsTable(const SQLite::Connection& connection, bool useTrigrams, bool useFoldedKeys) :
+            V1_5::SearchResultsTable(connection, useTrigrams), m_useFoldedKeys(useFoldedKeys) {}
+
+        SearchResultsTable(const SearchResultsTable&) = delete;
+        SearchResultsTable& operator=(const SearchResultsTable&) = delete;
+
+        SearchResultsTable(SearchResultsTable&&) = default;
+        SearchResultsTable& operator=(SearchResultsTable&&) = default;
+
+    protected:
+        std::vector<int> BuildSearchStatement(SQLite::Builder::StatementBuilder& builder, const PackageMatchFilter& filter) const override;
+
+        // Import all overrides of this function
+        using V1_5::SearchResultsTable::BuildSearchStatement;
+        using V1_0::SearchResultsTable::BindStatementForMatchType;
+
+        void BindStatementForMatchType(SQLite::Statement& statement, const PackageMatchFilter& filter, const std::vector<int>& bindIndex) override;
+
+    private:
+        // Determines if the filter finds its values through the folded key table.
+        bool UsesFoldedKeys(const PackageMatchFilter& filter) const;
+
+        bool m_useFoldedKeys;
+    };
+}
@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "SearchResultsTable.h"
+
+#include "Microsoft/Schema/1_8/FoldedKeyTable.h"
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_8
+{
+    std::vector<int> SearchResultsTable::BuildSearchStatement(SQLite::Builder::StatementBuilder& builder, const PackageMatchFilter& filter) const
+    {
+        if (!UsesFoldedKeys(filter))
+        {
+            return V1_5::SearchResultsTable::BuildSearchStatement(builder, filter);
+        }
+
+        // The LIKE is still applied, but only to the values that the key lookup found; the trigrams would not narrow them further.
+        std::vector<int> result = V1_0::SearchResultsTable::BuildSearchStatement(builder, filter);
+
+        if (!result.empty())
+        {
+            std::vector<int> keyIndex = FoldedKeyTable::AppendFilter(builder, filter.Field, filter.Type == MatchType::StartsWith);
+            result.insert(result.end(), keyIndex.begin(), keyIndex.end());
+        }
+
+        return result;
+    }
+
+    void SearchResultsTable::BindStatementForMatchType(SQLite::Statement& statement, const PackageMatchFilter& filter, const std::vector<int>& bindIndex)
+    {
+        V1_5::SearchResultsTable::BindStatementForMatchType(statement, filter, bindIndex);
+
+        if (UsesFoldedKeys(filter))
+        {
+            // The value binding is first, followed by those of the key lookup.
+            bool isPrefix = filter.Type == MatchType::StartsWith;
+            std::vector<int> keyIndex{ bindIndex.end() - (isPrefix ? 2 : 1), bindIndex.end() };
+            FoldedKeyTable::BindFilter(statement, keyIndex, filter.Value, isPrefix);
+        }
+    }
+
+    bool SearchResultsTable::UsesFoldedKeys(const PackageMatchFilter& filter) const
+    {
+        return m_useFoldedKeys &&
+            (filter.Type == MatchType::CaseInsensitive || filter.Type == MatchType::StartsWith) &&
+            FoldedKeyTable::IsFieldSupported(filter.Field);
+    }
+}
@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "InstallerSummaryTable.h"
+#include "SQLiteStatementBuilder.h"
+
+#include "Microsoft/Schema/1_0/ManifestTable.h"
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_9
+{
+    using namespace std::string_view_literals;
+    using namespace SQLite::Builder;
+    using QCol = SQLite::Builder::QualifiedColumn;
+
+    namespace
+    {
+        constexpr std::string_view s_InstallerSummaryTable_Table_Name = "installer_summaries"sv;
+        constexpr std::string_view s_InstallerSummaryTable_Summary_Column_Name = "summary"sv;
+    }
+
+    std::string_view InstallerSummaryTable::TableName()
+    {
+        return s_InstallerSummaryTable_Table_Name;
+    }
+
+    void InstallerSummaryTable::Create(SQLite::Connection& connection)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "createinstallersummarytable_v1_9");
+
+        StatementBuilder createTableBuilder;
+        createTableBuilder.CreateTable(s_InstallerSummaryTable_Table_Name).Columns({
+            IntegerPrimaryKey(),
+            ColumnBuilder(s_InstallerSummaryTable_Summary_Column_Name, Type::Text).NotNull()
+            });
+
+        createTableBuilder.Execute(connection);
+
+        savepoint.Commit();
+    }
+
+    std::optional<std::string> InstallerSummaryTable::GetSummaryByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId)
+    {
+        StatementBuilder builder;
+        builder.Select(s_InstallerSummaryTable_Summary_Column_Name).From(s_InstallerSummaryTable_Table_Name).Where(SQLite::RowIDName).Equals(manifestId);
+
+        SQLite::Statement select = builder.Prepare(connection);
+
+        if (select.Step())
+        {
+            return select.GetColumn<std::string>(0);
+        }
+
+        return {};
+    }
+
+    void InstallerSummaryTable::SetSummaryByManifestId(SQLite::Connection& connection, SQLite::rowid_t manifestId, std::string_view summary)
+    {
+        // As with the manifest metadata, UPSERT is not available on all supported versions of Windows.
+        StatementBuilder updateBuilder;
+        updateBuilder.Update(s_InstallerSummaryTable_Table_Name).Set().Column(s_InstallerSummaryTable_Summary_Column_Name).Equals(summary).
+            Where(SQLite::RowIDName).Equals(manifestId);
+
+        updateBuilder.Execute(connection);
+
+        // No changes means we need to insert the row
+        if (connection.GetChanges() == 0)
+        {
+            StatementBuilder insertBuilder;
+            insertBuilder.InsertInto(s_InstallerSummaryTable_Table_Name).
+                Columns({ SQLite::RowIDName, s_InstallerSummaryTable_Summary_Column_Name }).
+                Values(manifestId, summary);
+
+            insertBuilder.Execute(connection);
+        }
+    }
+
+    void InstallerSummaryTable::DeleteByManifestId(SQLite::Connection& connection, SQLite::rowid_t manifestId)
+    {
+        StatementBuilder builder;
+        builder.DeleteFrom(s_InstallerSummaryTable_Table_Name).Where(SQLite::RowIDName).Equals(manifestId);
+
+        builder.Execute(connection);
+    }
+
+    bool InstallerSummaryTable::CheckConsistency(const SQLite::Connection& connection, bool log)
+    {
+        bool result = true;
+
+        // Build a select statement to find rows that refer to non-existent manifests, such as:
+        // Select installer_summaries.rowid from installer_summaries
+        // left outer join manifest on installer_summaries.rowid = manifest.rowid where manifest.rowid is NULL
+        StatementBuilder builder;
+        builder.
+            Select(QCol(s_InstallerSummaryTable_Table_Name, SQLite::RowIDName)).
+            From(s_InstallerSummaryTable_Table_Name).
+            LeftOuterJoin(V1_0::ManifestTable::TableName()).On(QCol(s_InstallerSummaryTable_Table_Name, SQLite::RowIDName), QCol(V1_0::ManifestTable::TableName(), SQLite::RowIDName)).
+            Where(QCol(V1_0::ManifestTable::TableName(), SQLite::RowIDName)).IsNull();
+
+        SQLite::Statement select = builder.Prepare(connection);
+
+        while (select.Step())
+        {
+            result = false;
+
+            if (!log)
+            {
+                break;
+            }
+
+            AICLI_LOG(Repo, Info, << "  [INVALID] " << s_InstallerSummaryTable_Table_Name << " refers to manifest [" << select.GetColumn<SQLite::rowid_t>(0) << "]");
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "SQLiteWrapper.h"
+
+#include <optional>
+#include <string>
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_9
+{
+    // A table for storing the installer summary of each manifest, keyed by the manifest rowid.
+    // The summary allows the applicability of a manifest to be checked without retrieving it.
+    struct InstallerSummaryTable
+    {
+        // Get the table name.
+        static std::string_view TableName();
+
+        // Creates the table in the database.
+        static void Create(SQLite::Connection& connection);
+
+        // Gets the summary for the given manifest, if present.
+        static std::optional<std::string> GetSummaryByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId);
+
+        // Sets the summary for the given manifest.
+        static void SetSummaryByManifestId(SQLite::Connection& connection, SQLite::rowid_t manifestId, std::string_view summary);
+
+        // Removes the summary for the given manifest.
+        static void DeleteByManifestId(SQLite::Connection& connection, SQLite::rowid_t manifestId);
+
+        // Checks the consistency of the table with the manifest table.
+        static bool CheckConsistency(const SQLite::Connection& connection, bool log);
+    };
+}
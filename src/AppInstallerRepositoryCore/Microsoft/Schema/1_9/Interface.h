@@ -0,0 +1,38 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "Microsoft/Schema/ISQLiteIndex.h"
+#include "Microsoft/Schema/1_8/Interface.h"
+#include "Microsoft/Schema/1_9/SystemReferenceFilterTable.h"
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_9
+{
+    // Interface to this schema version exposed through ISQLiteIndex.
+    struct Interface : public V1_8::Interface
+    {
+        Interface(Utility::NormalizationVersion normVersion = Utility::NormalizationVersion::Initial);
+
+        // Version 1.0
+        Schema::Version GetVersion() const override;
+        void CreateTables(SQLite::Connection& connection, CreateOptions options) override;
+        SQLite::rowid_t AddManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath) override;
+        std::pair<bool, SQLite::rowid_t> UpdateManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath) override;
+        void RemoveManifestById(SQLite::Connection& connection, SQLite::rowid_t manifestId) override;
+        bool CheckConsistency(const SQLite::Connection& connection, bool log) const override;
+        void PrepareForPackaging(SQLite::Connection& connection, bool vacuum) override;
+
+    protected:
+        // Gets a property already knowing that the manifest id is valid.
+        std::optional<std::string> GetPropertyByManifestIdInternal(const SQLite::Connection& connection, SQLite::rowid_t manifestId, PackageVersionProperty property) const override;
+        std::unique_ptr<SearchCursor> OpenSearchInternal(const SQLite::Connection& connection, SearchRequest& request, size_t limit) const override;
+
+    private:
+        // Removes the system reference filter once the index changes, as it may no longer hold every value.
+        void ClearSystemReferenceFilterIfPopulated(SQLite::Connection& connection);
+
+        // Gets the system reference filter of the index, if it has one; it is only read from the index once.
+        const SystemReferenceFilter* GetSystemReferenceFilter(const SQLite::Connection& connection) const;
+
+        mutable std::optional<std::optional<SystemReferenceFilter>> m_systemReferenceFilter;
+    };
+}
@@ -0,0 +1,265 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Microsoft/Schema/1_9/Interface.h"
+
+#include "Microsoft/Schema/1_0/ManifestTable.h"
+#include "Microsoft/Schema/1_2/NormalizedPackageNameTable.h"
+#include "Microsoft/Schema/1_2/NormalizedPackagePublisherTable.h"
+#include "Microsoft/Schema/1_9/InstallerSummaryTable.h"
+#include <winget/ManifestInstallerSummary.h>
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_9
+{
+    namespace
+    {
+        std::vector<SQLite::rowid_t> GetAllManifestIds(const SQLite::Connection& connection)
+        {
+            SQLite::Builder::StatementBuilder builder;
+            builder.Select(SQLite::RowIDName).From(V1_0::ManifestTable::TableName());
+
+            SQLite::Statement select = builder.Prepare(connection);
+
+            std::vector<SQLite::rowid_t> result;
+            while (select.Step())
+            {
+                result.emplace_back(select.GetColumn<SQLite::rowid_t>(0));
+            }
+
+            return result;
+        }
+
+        // The cursor for a search that cannot match anything.
+        struct EmptySearchCursor : public ISQLiteIndex::SearchCursor
+        {
+            ISQLiteIndex::SearchResult GetNext(size_t) override { return {}; }
+        };
+    }
+
+    Interface::Interface(Utility::NormalizationVersion normVersion) : V1_8::Interface(normVersion)
+    {
+    }
+
+    Schema::Version Interface::GetVersion() const
+    {
+        return { 1, 9 };
+    }
+
+    void Interface::CreateTables(SQLite::Connection& connection, CreateOptions options)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "createtables_v1_9");
+
+        V1_8::Interface::CreateTables(connection, options);
+
+        InstallerSummaryTable::Create(connection);
+        SystemReferenceFilterTable::Create(connection);
+
+        savepoint.Commit();
+    }
+
+    SQLite::rowid_t Interface::AddManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "addmanifest_v1_9");
+
+        SQLite::rowid_t manifestId = V1_8::Interface::AddManifest(connection, manifest, relativePath);
+
+        InstallerSummaryTable::SetSummaryByManifestId(connection, manifestId, Manifest::CreateInstallerSummary(manifest));
+        ClearSystemReferenceFilterIfPopulated(connection);
+
+        savepoint.Commit();
+
+        return manifestId;
+    }
+
+    std::pair<bool, SQLite::rowid_t> Interface::UpdateManifest(SQLite::Connection& connection, const Manifest::Manifest& manifest, const std::optional<std::filesystem::path>& relativePath)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "updatemanifest_v1_9");
+
+        auto [indexModified, manifestId] = V1_8::Interface::UpdateManifest(connection, manifest, relativePath);
+
+        // The installers can change without any of the indexed values changing, so the summary is always compared.
+        std::string newSummary = Manifest::CreateInstallerSummary(manifest);
+        std::optional<std::string> currentSummary = InstallerSummaryTable::GetSummaryByManifestId(connection, manifestId);
+
+        if (!currentSummary || currentSummary.value() != newSummary)
+        {
+            InstallerSummaryTable::SetSummaryByManifestId(connection, manifestId, newSummary);
+            indexModified = true;
+        }
+
+        if (indexModified)
+        {
+            ClearSystemReferenceFilterIfPopulated(connection);
+        }
+
+        savepoint.Commit();
+
+        return { indexModified, manifestId };
+    }
+
+    void Interface::RemoveManifestById(SQLite::Connection& connection, SQLite::rowid_t manifestId)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "removemanifest_v1_9");
+
+        V1_8::Interface::RemoveManifestById(connection, manifestId);
+
+        InstallerSummaryTable::DeleteByManifestId(connection, manifestId);
+        ClearSystemReferenceFilterIfPopulated(connection);
+
+        savepoint.Commit();
+    }
+
+    bool Interface::CheckConsistency(const SQLite::Connection& connection, bool log) const
+    {
+        bool result = V1_8::Interface::CheckConsistency(connection, log);
+
+        // If the v1.8 index was consistent, or if full logging of inconsistency was requested, check the v1.9 data.
+        if (result || log)
+        {
+            result = InstallerSummaryTable::CheckConsistency(connection, log) && result;
+        }
+
+        return result;
+    }
+
+    void Interface::PrepareForPackaging(SQLite::Connection& connection, bool vacuum)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "prepareforpackaging_v1_9");
+
+        // The values are read before packaging removes the indices that the reads use.
+        std::vector<std::string> keys;
+        for (SQLite::rowid_t manifestId : GetAllManifestIds(connection))
+        {
+            for (const auto& value : GetMultiPropertyByManifestId(connection, manifestId, PackageVersionMultiProperty::PackageFamilyName))
+            {
+                keys.emplace_back(SystemReferenceFilter::CreateKey(PackageMatchField::PackageFamilyName, value));
+            }
+
+            for (const auto& value : GetMultiPropertyByManifestId(connection, manifestId, PackageVersionMultiProperty::ProductCode))
+            {
+                keys.emplace_back(SystemReferenceFilter::CreateKey(PackageMatchField::ProductCode, value));
+            }
+
+            // A name and publisher search matches a manifest that has both values, so every pair of them is added.
+            std::vector<std::string> publishers = V1_2::NormalizedPackagePublisherTable::GetValuesByManifestId(connection, manifestId);
+            for (const auto& name : V1_2::NormalizedPackageNameTable::GetValuesByManifestId(connection, manifestId))
+            {
+                for (const auto& publisher : publishers)
+                {
+                    keys.emplace_back(SystemReferenceFilter::CreateKey(PackageMatchField::NormalizedNameAndPublisher, name, publisher));
+                }
+            }
+        }
+
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+        SystemReferenceFilter filter{ keys.size() };
+        for (const auto& key : keys)
+        {
+            filter.Add(key);
+        }
+
+        SystemReferenceFilterTable::SetFilter(connection, filter.Serialize());
+        m_systemReferenceFilter.reset();
+
+        AICLI_LOG(Repo, Info, << "Added " << keys.size() << " keys to the system reference filter");
+
+        V1_8::Interface::PrepareForPackaging(connection, false);
+
+        savepoint.Commit();
+
+        if (vacuum)
+        {
+            // Force the database to actually shrink the file size.
+            // This *must* be done outside of an active transaction.
+            SQLite::Builder::StatementBuilder builder;
+            builder.Vacuum();
+            builder.Execute(connection);
+        }
+    }
+
+    std::optional<std::string> Interface::GetPropertyByManifestIdInternal(const SQLite::Connection& connection, SQLite::rowid_t manifestId, PackageVersionProperty property) const
+    {
+        switch (property)
+        {
+        case AppInstaller::Repository::PackageVersionProperty::InstallerSummary:
+            return InstallerSummaryTable::GetSummaryByManifestId(connection, manifestId);
+        default:
+            return V1_8::Interface::GetPropertyByManifestIdInternal(connection, manifestId, property);
+        }
+    }
+
+    std::unique_ptr<ISQLiteIndex::SearchCursor> Interface::OpenSearchInternal(const SQLite::Connection& connection, SearchRequest& request, size_t limit) const
+    {
+        const SystemReferenceFilter* filter = (request.Inclusions.empty() ? nullptr : GetSystemReferenceFilter(connection));
+
+        if (filter)
+        {
+            // The keys are created from the values as the earlier versions transform them for the search.
+            auto isDefinitelyAbsent = [&](const PackageMatchFilter& inclusion)
+            {
+                if (inclusion.Type != MatchType::Exact || !SystemReferenceFilter::IsFieldSupported(inclusion.Field))
+                {
+                    return false;
+                }
+
+                if (inclusion.Field == PackageMatchField::NormalizedNameAndPublisher)
+                {
+                    Utility::NormalizedName normalized = m_normalizer.Normalize(Utility::FoldCase(inclusion.Value), Utility::FoldCase(inclusion.Additional.value()));
+                    return !filter->MayContain(SystemReferenceFilter::CreateKey(inclusion.Field, normalized.Name(), normalized.Publisher()));
+                }
+
+                return !filter->MayContain(SystemReferenceFilter::CreateKey(inclusion.Field, Utility::FoldCase(inclusion.Value)));
+            };
+
+            size_t inclusionCount = request.Inclusions.size();
+            request.Inclusions.erase(std::remove_if(request.Inclusions.begin(), request.Inclusions.end(), isDefinitelyAbsent), request.Inclusions.end());
+
+            if (request.Inclusions.size() != inclusionCount)
+            {
+                AICLI_LOG(Repo, Verbose, << "System reference filter removed " << (inclusionCount - request.Inclusions.size()) << " of " << inclusionCount << " inclusions");
+
+                // Nothing can match once every inclusion is removed; the search would otherwise start from the filters alone.
+                if (request.Inclusions.empty() && !request.Query)
+                {
+                    return std::make_unique<EmptySearchCursor>();
+                }
+            }
+        }
+
+        return V1_8::Interface::OpenSearchInternal(connection, request, limit);
+    }
+
+    void Interface::ClearSystemReferenceFilterIfPopulated(SQLite::Connection& connection)
+    {
+        m_systemReferenceFilter.reset();
+
+        if (SystemReferenceFilterTable::IsPopulated(connection))
+        {
+            AICLI_LOG(Repo, Info, << "Index modified after packaging; clearing system reference filter");
+            SystemReferenceFilterTable::Clear(connection);
+        }
+    }
+
+    const SystemReferenceFilter* Interface::GetSystemReferenceFilter(const SQLite::Connection& connection) const
+    {
+        if (!m_systemReferenceFilter)
+        {
+            m_systemReferenceFilter.emplace();
+
+            std::optional<SQLite::blob_t> data = SystemReferenceFilterTable::GetFilter(connection);
+            if (data)
+            {
+                // A filter that cannot be read is not used, and searches behave as they would without one.
+                try
+                {
+                    m_systemReferenceFilter->emplace(data.value());
+                }
+                CATCH_LOG();
+            }
+        }
+
+        return (m_systemReferenceFilter->has_value() ? &m_systemReferenceFilter->value() : nullptr);
+    }
+}
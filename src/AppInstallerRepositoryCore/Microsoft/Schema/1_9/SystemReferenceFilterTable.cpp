@@ -0,0 +1,218 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "SystemReferenceFilterTable.h"
+#include "SQLiteStatementBuilder.h"
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_9
+{
+    using namespace std::string_view_literals;
+    using namespace SQLite::Builder;
+
+    namespace
+    {
+        constexpr std::string_view s_SystemReferenceFilterTable_Table_Name = "system_reference_filter"sv;
+        constexpr std::string_view s_SystemReferenceFilterTable_Filter_Column_Name = "filter"sv;
+
+        // Identifies the format of the filter; data with another magic value or version is not used.
+        constexpr uint32_t s_SystemReferenceFilterMagic = 0x46524757; // "WGRF"
+        constexpr uint32_t s_SystemReferenceFilterVersion = 1;
+
+        // Ten bits per key and seven hashes give a false positive rate of about one percent.
+        constexpr size_t s_BitsPerKey = 10;
+        constexpr uint32_t s_HashCount = 7;
+
+        struct Header
+        {
+            uint32_t Magic;
+            uint32_t Version;
+            uint32_t HashCount;
+            uint32_t WordCount;
+        };
+
+        static_assert(sizeof(Header) == 16);
+
+        // FNV-1a, which unlike std::hash is stable across builds, so the filter can be read by any client.
+        uint64_t HashKey(std::string_view key)
+        {
+            uint64_t result = 0xcbf29ce484222325ull;
+
+            for (char c : key)
+            {
+                result ^= static_cast<uint8_t>(c);
+                result *= 0x100000001b3ull;
+            }
+
+            return result;
+        }
+
+        // The finalizer of splitmix64, to derive a second, independent hash from the first.
+        uint64_t MixHash(uint64_t value)
+        {
+            value ^= value >> 30;
+            value *= 0xbf58476d1ce4e5b9ull;
+            value ^= value >> 27;
+            value *= 0x94d049bb133111ebull;
+            value ^= value >> 31;
+            return value;
+        }
+
+        // Calls the function with the index of each bit for the key, using double hashing.
+        template <typename Function>
+        void ForEachBit(std::string_view key, uint32_t hashCount, uint64_t bitCount, Function&& function)
+        {
+            uint64_t hash1 = HashKey(key);
+            uint64_t hash2 = MixHash(hash1) | 1;
+
+            for (uint32_t i = 0; i < hashCount; ++i)
+            {
+                if (!function((hash1 + i * hash2) % bitCount))
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    SystemReferenceFilter::SystemReferenceFilter(size_t expectedKeyCount) :
+        m_hashCount(s_HashCount), m_bits((std::max<size_t>(expectedKeyCount, 1) * s_BitsPerKey + 63) / 64)
+    {
+    }
+
+    SystemReferenceFilter::SystemReferenceFilter(const SQLite::blob_t& data)
+    {
+        THROW_HR_IF(E_NOT_SUFFICIENT_BUFFER, data.size() < sizeof(Header));
+
+        Header header;
+        memcpy(&header, data.data(), sizeof(Header));
+
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), header.Magic != s_SystemReferenceFilterMagic || header.Version != s_SystemReferenceFilterVersion);
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), header.HashCount == 0 || header.WordCount == 0);
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), data.size() != sizeof(Header) + static_cast<uint64_t>(header.WordCount) * sizeof(uint64_t));
+
+        m_hashCount = header.HashCount;
+        m_bits.resize(header.WordCount);
+        memcpy(m_bits.data(), data.data() + sizeof(Header), m_bits.size() * sizeof(uint64_t));
+    }
+
+    bool SystemReferenceFilter::IsFieldSupported(PackageMatchField field)
+    {
+        return field == PackageMatchField::PackageFamilyName || field == PackageMatchField::ProductCode || field == PackageMatchField::NormalizedNameAndPublisher;
+    }
+
+    std::string SystemReferenceFilter::CreateKey(PackageMatchField field, std::string_view value, std::string_view additional)
+    {
+        std::string result;
+        result += static_cast<char>(field);
+        result += value;
+
+        if (field == PackageMatchField::NormalizedNameAndPublisher)
+        {
+            result += '\0';
+            result += additional;
+        }
+
+        return result;
+    }
+
+    void SystemReferenceFilter::Add(std::string_view key)
+    {
+        ForEachBit(key, m_hashCount, m_bits.size() * 64, [&](uint64_t bit)
+            {
+                m_bits[bit / 64] |= (1ull << (bit % 64));
+                return true;
+            });
+    }
+
+    bool SystemReferenceFilter::MayContain(std::string_view key) const
+    {
+        bool result = true;
+
+        ForEachBit(key, m_hashCount, m_bits.size() * 64, [&](uint64_t bit)
+            {
+                result = (m_bits[bit / 64] & (1ull << (bit % 64))) != 0;
+                return result;
+            });
+
+        return result;
+    }
+
+    SQLite::blob_t SystemReferenceFilter::Serialize() const
+    {
+        Header header{ s_SystemReferenceFilterMagic, s_SystemReferenceFilterVersion, m_hashCount, static_cast<uint32_t>(m_bits.size()) };
+
+        SQLite::blob_t result(sizeof(Header) + m_bits.size() * sizeof(uint64_t));
+        memcpy(result.data(), &header, sizeof(Header));
+        memcpy(result.data() + sizeof(Header), m_bits.data(), m_bits.size() * sizeof(uint64_t));
+
+        return result;
+    }
+
+    std::string_view SystemReferenceFilterTable::TableName()
+    {
+        return s_SystemReferenceFilterTable_Table_Name;
+    }
+
+    void SystemReferenceFilterTable::Create(SQLite::Connection& connection)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "createsystemreferencefiltertable_v1_9");
+
+        StatementBuilder createTableBuilder;
+        createTableBuilder.CreateTable(s_SystemReferenceFilterTable_Table_Name).Columns({
+            ColumnBuilder(s_SystemReferenceFilterTable_Filter_Column_Name, Type::Blob).NotNull()
+            });
+
+        createTableBuilder.Execute(connection);
+
+        savepoint.Commit();
+    }
+
+    bool SystemReferenceFilterTable::IsPopulated(const SQLite::Connection& connection)
+    {
+        StatementBuilder builder;
+        builder.Select(SQLite::RowIDName).From(s_SystemReferenceFilterTable_Table_Name).Limit(1);
+
+        SQLite::Statement statement = builder.Prepare(connection);
+        return statement.Step();
+    }
+
+    std::optional<SQLite::blob_t> SystemReferenceFilterTable::GetFilter(const SQLite::Connection& connection)
+    {
+        StatementBuilder builder;
+        builder.Select(s_SystemReferenceFilterTable_Filter_Column_Name).From(s_SystemReferenceFilterTable_Table_Name).Limit(1);
+
+        SQLite::Statement statement = builder.Prepare(connection);
+
+        if (statement.Step())
+        {
+            return statement.GetColumn<SQLite::blob_t>(0);
+        }
+
+        return {};
+    }
+
+    void SystemReferenceFilterTable::SetFilter(SQLite::Connection& connection, const SQLite::blob_t& filter)
+    {
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(connection, "setsystemreferencefilter_v1_9");
+
+        Clear(connection);
+
+        StatementBuilder builder;
+        builder.InsertInto(s_SystemReferenceFilterTable_Table_Name).
+            Columns(s_SystemReferenceFilterTable_Filter_Column_Name).
+            Values(filter);
+
+        builder.Execute(connection);
+
+        savepoint.Commit();
+    }
+
+    void SystemReferenceFilterTable::Clear(SQLite::Connection& connection)
+    {
+        StatementBuilder builder;
+        builder.DeleteFrom(s_SystemReferenceFilterTable_Table_Name);
+
+        builder.Execute(connection);
+    }
+}
@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "SQLiteWrapper.h"
+#include "Public/winget/RepositorySearch.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace AppInstaller::Repository::Microsoft::Schema::V1_9
+{
+    // A Bloom filter over the system reference strings of the index, in the form that exact searches compare them:
+    // the folded product codes and package family names, and the normalized name and publisher pairs of each manifest.
+    // A key that the filter does not contain is definitely not in the index, so a search for it can be skipped.
+    struct SystemReferenceFilter
+    {
+        // Creates an empty filter sized for the given number of keys.
+        explicit SystemReferenceFilter(size_t expectedKeyCount);
+
+        // Reads a filter from the data created by Serialize.
+        explicit SystemReferenceFilter(const SQLite::blob_t& data);
+
+        // Determines if exact searches on the field can be checked against the filter.
+        static bool IsFieldSupported(PackageMatchField field);
+
+        // Creates the key for a value of the field; the additional value is only used for the name and publisher.
+        static std::string CreateKey(PackageMatchField field, std::string_view value, std::string_view additional = {});
+
+        // Adds the key to the filter.
+        void Add(std::string_view key);
+
+        // Determines if the key may have been added; false means that it definitely was not.
+        bool MayContain(std::string_view key) const;
+
+        // Gets the data that holds the filter.
+        SQLite::blob_t Serialize() const;
+
+    private:
+        uint32_t m_hashCount = 0;
+        std::vector<uint64_t> m_bits;
+    };
+
+    // A table that holds the system reference filter of the index.
+    // It is only populated when preparing the index for packaging, and is emptied by any change after that.
+    struct SystemReferenceFilterTable
+    {
+        // Get the table name.
+        static std::string_view TableName();
+
+        // Creates the table.
+        static void Create(SQLite::Connection& connection);
+
+        // Determines if the table has a filter.
+        static bool IsPopulated(const SQLite::Connection& connection);
+
+        // Gets the data of the filter, if present.
+        static std::optional<SQLite::blob_t> GetFilter(const SQLite::Connection& connection);
+
+        // Sets the data of the filter, replacing any existing one.
+        static void SetFilter(SQLite::Connection& connection, const SQLite::blob_t& filter);
+
+        // Removes the filter.
+        static void Clear(SQLite::Connection& connection);
+    };
+}
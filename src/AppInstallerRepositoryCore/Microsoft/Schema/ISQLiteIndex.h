@@ -30,9 +30,28 @@ namespace AppInstaller::Repository::Microsoft::Schema
             bool Truncated = false;
         };
 
+        // Reads the results of a search as they are requested, rather than all at once.
+        struct SearchCursor
+        {
+            virtual ~SearchCursor() = default;
+
+            // Reads up to count more results, or all that remain if count is zero.
+            // The result is marked as truncated if there are more after it.
+            virtual SearchResult GetNext(size_t count) = 0;
+        };
+
         // The non-version specific return value of GetMetadataByManifestId.
         using MetadataResult = std::vector<std::pair<PackageVersionMetadata, std::string>>;
 
+        // The properties of a set of manifests, keyed by manifest id.
+        using PropertiesResult = std::map<SQLite::rowid_t, std::map<PackageVersionProperty, std::string>>;
+
+        // The values of a field paired with the rowid of the id that they belong to.
+        using FieldValuesResult = std::vector<std::pair<SQLite::rowid_t, std::string>>;
+
+        // The values of a multi-property for the manifests of a package, each paired with its manifest id and ordered by it.
+        using MultiPropertyResult = std::vector<std::pair<SQLite::rowid_t, std::string>>;
+
         // Version 1.0
 
         // Gets the schema version that this index interface is built for.
@@ -78,22 +97,42 @@ namespace AppInstaller::Repository::Microsoft::Schema
         // Performs a search based on the given criteria.
         virtual SearchResult Search(const SQLite::Connection& connection, const SearchRequest& request) const = 0;
 
+        // Performs a search based on the given criteria, leaving the results to be read from the cursor.
+        // At most one result more than SearchRequest::MaximumResults is read, so that the caller can tell that there are more.
+        // The connection must outlive the cursor, and the index must not be modified while the cursor is in use.
+        virtual std::unique_ptr<SearchCursor> OpenSearch(const SQLite::Connection& connection, const SearchRequest& request) const = 0;
+
         // Gets the string for the given property and manifest id, if present.
         virtual std::optional<std::string> GetPropertyByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId, PackageVersionProperty property) const = 0;
 
+        // Gets the Id, Name, Version and Channel of each of the given manifests in a single query.
+        // Manifests that are not found are not included in the result.
+        virtual PropertiesResult GetPropertiesByManifestIds(const SQLite::Connection& connection, const std::vector<SQLite::rowid_t>& manifestIds) const = 0;
+
         // Gets the string values for the given property and manifest id, if present.
         virtual std::vector<std::string> GetMultiPropertyByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId, PackageVersionMultiProperty property) const = 0;
 
+        // Gets the string values for the given property of every manifest with the given id, in one query.
+        virtual MultiPropertyResult GetMultiPropertyById(const SQLite::Connection& connection, SQLite::rowid_t id, PackageVersionMultiProperty property) const = 0;
+
         // Gets the manifest id for the given { id, version, channel }, if present.
         // If version is empty, gets the value for the 'latest' version.
         virtual std::optional<SQLite::rowid_t> GetManifestIdByKey(const SQLite::Connection& connection, SQLite::rowid_t id, std::string_view version, std::string_view channel) const = 0;
 
+        // Gets the manifest id for the 'latest' version of each of the given ids, as GetManifestIdByKey would with an empty version and channel.
+        // Ids that have no manifest are not included in the result.
+        virtual std::map<SQLite::rowid_t, SQLite::rowid_t> GetLatestManifestIdsByIds(const SQLite::Connection& connection, const std::vector<SQLite::rowid_t>& ids) const = 0;
+
         // Gets the manifest id for the given manifest, if present.
         virtual std::optional<SQLite::rowid_t> GetManifestIdByManifest(const SQLite::Connection& connection, const Manifest::Manifest& manifest) const = 0;
 
         // Gets all versions and channels for the given id.
         virtual std::vector<Utility::VersionAndChannel> GetVersionKeysById(const SQLite::Connection& connection, SQLite::rowid_t id) const = 0;
 
+        // Gets every value of the field along with the id that it belongs to, so that the field can be searched in memory.
+        // Returns nullopt if the field is not one that is searched by exact value in this version.
+        virtual std::optional<FieldValuesResult> GetAllFieldValues(const SQLite::Connection& connection, PackageMatchField field) const = 0;
+
         // Version 1.1
 
         // Gets the string for the given metadata and manifest id, if present.
@@ -110,6 +149,14 @@ namespace AppInstaller::Repository::Microsoft::Schema
         virtual std::set<std::pair<SQLite::rowid_t, Utility::NormalizedString>> GetDependenciesByManifestRowId(const SQLite::Connection& connection, SQLite::rowid_t manifestRowId) const = 0;
 
         virtual std::vector<std::pair<SQLite::rowid_t, Utility::NormalizedString>> GetDependentsById(const SQLite::Connection& connection, AppInstaller::Manifest::string_t packageId) const = 0;
+
+        // Version 1.6
+
+        // Gets the compressed content embedded for the given manifest id, if present.
+        virtual std::optional<SQLite::blob_t> GetManifestContentByManifestId(const SQLite::Connection& connection, SQLite::rowid_t manifestId) const = 0;
+
+        // Embeds the compressed content for the given manifest id.
+        virtual void SetManifestContentByManifestId(SQLite::Connection& connection, SQLite::rowid_t manifestId, const SQLite::blob_t& content) = 0;
     };
 
     DEFINE_ENUM_FLAG_OPERATORS(ISQLiteIndex::CreateOptions);
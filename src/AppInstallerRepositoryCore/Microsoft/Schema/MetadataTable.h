@@ -4,6 +4,7 @@
 #include "SQLiteWrapper.h"
 
 #include <wil/result_macros.h>
+#include <optional>
 #include <string_view>
 
 namespace AppInstaller::Repository::Microsoft::Schema
@@ -16,6 +17,15 @@ namespace AppInstaller::Repository::Microsoft::Schema
     static constexpr std::string_view s_MetadataValueName_MinorVersion = "minorVersion"sv;
     static constexpr std::string_view s_MetadataValueName_LastWriteTime = "lastwritetime"sv;
 
+    // Pre-indexed source completion index, stored when the index is prepared for packaging
+    static constexpr std::string_view s_MetadataValueName_CompletionIndex = "completionIndex"sv;
+
+    // Predefined installed source snapshot
+    static constexpr std::string_view s_MetadataValueName_InstalledStateToken = "installedStateToken"sv;
+    static constexpr std::string_view s_MetadataValueName_InstalledBaseState = "installedBaseState"sv;
+    static constexpr std::string_view s_MetadataValueName_InstalledARPEntries = "installedARPEntries"sv;
+    static constexpr std::string_view s_MetadataValueName_InstalledMSIXDisplayNames = "installedMSIXDisplayNames"sv;
+
     // The metadata table for the index.
     // Contains a fixed-schema set of named values that can be used to determine how to read the rest of the index.
     struct MetadataTable
@@ -30,6 +40,19 @@ namespace AppInstaller::Repository::Microsoft::Schema
             return statement.GetColumn<Value>(0);
         }
 
+        // Gets the named value from the metadata table, interpreting it as the given type.
+        // Returns an empty value if the name is not present.
+        template <typename Value>
+        static std::optional<Value> TryGetNamedValue(SQLite::Connection& connection, std::string_view name)
+        {
+            std::optional<SQLite::Statement> statement = TryGetNamedValueStatement(connection, name);
+            if (!statement)
+            {
+                return std::nullopt;
+            }
+            return statement->GetColumn<Value>(0);
+        }
+
         // Sets the named value into the metadata table.
         template <typename Value>
         static void SetNamedValue(SQLite::Connection& connection, std::string_view name, Value&& v)
@@ -43,6 +66,9 @@ namespace AppInstaller::Repository::Microsoft::Schema
         // Internal function that gets the named value.
         static SQLite::Statement GetNamedValueStatement(SQLite::Connection& connection, std::string_view name);
 
+        // Internal function that gets the named value, if present.
+        static std::optional<SQLite::Statement> TryGetNamedValueStatement(SQLite::Connection& connection, std::string_view name);
+
         // Internal function that sets the named value.
         static SQLite::Statement SetNamedValueStatement(SQLite::Connection& connection, std::string_view name);
     };
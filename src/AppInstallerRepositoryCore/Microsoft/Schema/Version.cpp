@@ -9,6 +9,11 @@
 #include "1_2/Interface.h"
 #include "1_3/Interface.h"
 #include "1_4/Interface.h"
+#include "1_5/Interface.h"
+#include "1_6/Interface.h"
+#include "1_7/Interface.h"
+#include "1_8/Interface.h"
+#include "1_9/Interface.h"
 
 namespace AppInstaller::Repository::Microsoft::Schema
 {
@@ -49,11 +54,31 @@ namespace AppInstaller::Repository::Microsoft::Schema
         {
             return std::make_unique<V1_3::Interface>();
         }
-        else if (*this == Version{ 1, 4 } ||
+        else if (*this == Version{ 1, 4 })
+        {
+            return std::make_unique<V1_4::Interface>();
+        }
+        else if (*this == Version{ 1, 5 })
+        {
+            return std::make_unique<V1_5::Interface>();
+        }
+        else if (*this == Version{ 1, 6 })
+        {
+            return std::make_unique<V1_6::Interface>();
+        }
+        else if (*this == Version{ 1, 7 })
+        {
+            return std::make_unique<V1_7::Interface>();
+        }
+        else if (*this == Version{ 1, 8 })
+        {
+            return std::make_unique<V1_8::Interface>();
+        }
+        else if (*this == Version{ 1, 9 } ||
             this->MajorVersion == 1 ||
             this->IsLatest())
         {
-            return std::make_unique<V1_4::Interface>();
+            return std::make_unique<V1_9::Interface>();
         }
 
         // We do not have the capacity to operate on this schema version
@@ -0,0 +1,213 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Microsoft/ShardedIndexSource.h"
+#include <winget/ThreadGlobals.h>
+
+#include <json.h>
+#include <future>
+#include <numeric>
+
+using namespace std::string_view_literals;
+
+namespace AppInstaller::Repository::Microsoft
+{
+    const std::string_view s_ShardedIndexManifestFileName = "index.shards"sv;
+
+    namespace
+    {
+        constexpr uint32_t s_ShardedIndexManifestVersion = 1;
+
+        // A filter that limits the results to a single id, regardless of case.
+        bool IsIdFilter(const PackageMatchFilter& filter)
+        {
+            return filter.Field == PackageMatchField::Id && (filter.Type == MatchType::Exact || filter.Type == MatchType::CaseInsensitive);
+        }
+
+        // The comparator orders the matches by MatchType first, then Field, as CompositeSource does.
+        struct ResultMatchComparator
+        {
+            bool operator() (const ResultMatch& match1, const ResultMatch& match2) const
+            {
+                if (match1.MatchCriteria.Type != match2.MatchCriteria.Type)
+                {
+                    return match1.MatchCriteria.Type < match2.MatchCriteria.Type;
+                }
+
+                return match1.MatchCriteria.Field < match2.MatchCriteria.Field;
+            }
+        };
+    }
+
+    uint32_t GetShardForPackageId(std::string_view id, uint32_t shardCount)
+    {
+        THROW_HR_IF(E_INVALIDARG, shardCount == 0);
+
+        // FNV-1a, which is stable across platforms and releases, unlike std::hash.
+        uint32_t hash = 2166136261u;
+        for (char c : Utility::FoldCase(id))
+        {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 16777619u;
+        }
+
+        return hash % shardCount;
+    }
+
+    std::vector<std::string> ReadShardedIndexManifest(const std::filesystem::path& manifestPath)
+    {
+        std::ifstream stream{ manifestPath, std::ios_base::in | std::ios_base::binary };
+        THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_MISSING, !stream);
+
+        Json::Value root;
+        Json::CharReaderBuilder builder;
+        std::string error;
+
+        if (!Json::parseFromStream(builder, stream, &root, &error))
+        {
+            AICLI_LOG(Repo, Error, << "Error parsing sharded index manifest: " << error);
+            THROW_HR(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE);
+        }
+
+        THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE, !root.isObject() || !root["Version"].isUInt() || !root["Shards"].isArray());
+        THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE, root["Version"].asUInt() != s_ShardedIndexManifestVersion || root["Shards"].empty());
+
+        std::vector<std::string> result;
+        for (const auto& shard : root["Shards"])
+        {
+            THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE, !shard.isString());
+
+            // The shards must be alongside the manifest.
+            std::string fileName = shard.asString();
+            THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE,
+                fileName.empty() || fileName.find_first_of("/\\:"sv) != std::string::npos || fileName == "." || fileName == "..");
+
+            result.emplace_back(std::move(fileName));
+        }
+
+        return result;
+    }
+
+    ShardedIndexSource::ShardedIndexSource(const SourceDetails& details, std::vector<SQLiteIndex>&& shards, Synchronization::CrossProcessReaderWriteLock&& lock) :
+        m_details(details), m_lock(std::move(lock))
+    {
+        THROW_HR_IF(E_INVALIDARG, shards.empty());
+
+        m_shards.reserve(shards.size());
+        for (size_t i = 0; i < shards.size(); ++i)
+        {
+            auto shard = std::make_shared<SQLiteIndexSource>(m_details, std::move(shards[i]));
+            shard->SetShard(static_cast<uint32_t>(i));
+            m_shards.emplace_back(std::move(shard));
+        }
+    }
+
+    const SourceDetails& ShardedIndexSource::GetDetails() const
+    {
+        return m_details;
+    }
+
+    const std::string& ShardedIndexSource::GetIdentifier() const
+    {
+        return m_details.Identifier;
+    }
+
+    std::vector<size_t> ShardedIndexSource::GetShardsForRequest(const SearchRequest& request) const
+    {
+        uint32_t shardCount = static_cast<uint32_t>(m_shards.size());
+
+        // Filters must all match, so a single id filter limits the results to one shard.
+        auto idFilter = std::find_if(request.Filters.begin(), request.Filters.end(), IsIdFilter);
+        if (idFilter != request.Filters.end())
+        {
+            return { GetShardForPackageId(idFilter->Value, shardCount) };
+        }
+
+        // Without a query, a request for only ids needs only the shards of those ids.
+        if (!request.Query && !request.Inclusions.empty() && std::all_of(request.Inclusions.begin(), request.Inclusions.end(), IsIdFilter))
+        {
+            std::vector<size_t> result;
+            for (const auto& inclusion : request.Inclusions)
+            {
+                result.emplace_back(GetShardForPackageId(inclusion.Value, shardCount));
+            }
+
+            std::sort(result.begin(), result.end());
+            result.erase(std::unique(result.begin(), result.end()), result.end());
+            return result;
+        }
+
+        std::vector<size_t> result(m_shards.size());
+        std::iota(result.begin(), result.end(), 0);
+        return result;
+    }
+
+    SearchResult ShardedIndexSource::Search(const SearchRequest& request) const
+    {
+        using namespace AppInstaller::ThreadLocalStorage;
+
+        std::vector<size_t> shards = GetShardsForRequest(request);
+
+        if (shards.size() == 1)
+        {
+            return m_shards[shards[0]]->Search(request);
+        }
+
+        ThreadGlobals* parentThreadGlobals = ThreadGlobals::GetForCurrentThread();
+
+        std::vector<std::future<SearchResult>> futures;
+        futures.reserve(shards.size());
+
+        for (size_t shard : shards)
+        {
+            futures.emplace_back(std::async(std::launch::async, [this, shard, &request, parentThreadGlobals]()
+                {
+                    std::unique_ptr<ThreadGlobals> threadGlobals;
+                    std::unique_ptr<PreviousThreadGlobals> previousThreadGlobals;
+                    if (parentThreadGlobals)
+                    {
+                        threadGlobals = std::make_unique<ThreadGlobals>(*parentThreadGlobals, ThreadGlobals::create_sub_thread_globals_t{});
+                        previousThreadGlobals = threadGlobals->SetForCurrentThread();
+                    }
+
+                    return m_shards[shard]->Search(request);
+                }));
+        }
+
+        // Every future is waited on before any failure is rethrown, as the searches reference the request.
+        SearchResult result;
+        std::exception_ptr failure;
+
+        for (auto& future : futures)
+        {
+            try
+            {
+                SearchResult shardResult = future.get();
+                result.Truncated = result.Truncated || shardResult.Truncated;
+                std::move(shardResult.Matches.begin(), shardResult.Matches.end(), std::back_inserter(result.Matches));
+            }
+            catch (...)
+            {
+                if (!failure)
+                {
+                    failure = std::current_exception();
+                }
+            }
+        }
+
+        if (failure)
+        {
+            std::rethrow_exception(failure);
+        }
+
+        std::stable_sort(result.Matches.begin(), result.Matches.end(), ResultMatchComparator{});
+
+        if (request.MaximumResults > 0 && result.Matches.size() > request.MaximumResults)
+        {
+            result.Truncated = true;
+            result.Matches.erase(result.Matches.begin() + request.MaximumResults, result.Matches.end());
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "Microsoft/SQLiteIndexSource.h"
+#include "ISource.h"
+#include <AppInstallerSynchronization.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace AppInstaller::Repository::Microsoft
+{
+    // The name of the file that describes the shards of a sharded index.
+    // It is placed alongside the shards, which are each a complete index holding the packages whose id is assigned to it.
+    //  {
+    //      "Version": 1,
+    //      "Shards": [ "index.0.db", "index.1.db", ... ]
+    //  }
+    extern const std::string_view s_ShardedIndexManifestFileName;
+
+    // Gets the shard that the package with the given id is placed in; ids that differ only by case are placed together.
+    // Tools that create sharded indexes must use this to split the packages between the shards.
+    uint32_t GetShardForPackageId(std::string_view id, uint32_t shardCount);
+
+    // Reads the file names of the shards from the manifest file, in shard order.
+    std::vector<std::string> ReadShardedIndexManifest(const std::filesystem::path& manifestPath);
+
+    // A source that holds an index split into shards by package id, each of which is a SQLiteIndexSource.
+    // Searches are performed on the shards concurrently, or only on the shard that can hold the requested id.
+    struct ShardedIndexSource : public ISource
+    {
+        ShardedIndexSource(
+            const SourceDetails& details,
+            std::vector<SQLiteIndex>&& shards,
+            Synchronization::CrossProcessReaderWriteLock&& lock = {});
+
+        ShardedIndexSource(const ShardedIndexSource&) = delete;
+        ShardedIndexSource& operator=(const ShardedIndexSource&) = delete;
+
+        // Get the source's details.
+        const SourceDetails& GetDetails() const override;
+
+        // Gets the source's identifier; shared by all of the shards.
+        const std::string& GetIdentifier() const override;
+
+        // Execute a search on the source.
+        SearchResult Search(const SearchRequest& request) const override;
+
+        // Gets the shards that may hold results for the request.
+        std::vector<size_t> GetShardsForRequest(const SearchRequest& request) const;
+
+    private:
+        SourceDetails m_details;
+        Synchronization::CrossProcessReaderWriteLock m_lock;
+        std::vector<std::shared_ptr<SQLiteIndexSource>> m_shards;
+    };
+}
@@ -108,75 +108,138 @@ namespace AppInstaller::Repository
                 Manifest::ManifestException({ Manifest::ValidationError(error) },
                     APPINSTALLER_CLI_ERROR_DEPENDENCIES_VALIDATION_FAILED));
         }
-    };
-
-    bool PackageDependenciesValidation::ValidateManifestDependencies(SQLiteIndex* index, const Manifest::Manifest manifest)
-    {
-        using namespace Manifest;
 
-        Dependency rootId(DependencyType::Package, manifest.Id, manifest.Version);
-        std::vector<ValidationError> dependenciesError;
-        bool foundErrors = false;
+        // What the index holds for a package that manifests depend on.
+        struct DependencyPackageInfo
+        {
+            bool Found = false;
+            Utility::Version LatestVersion;
+            Manifest::DependencyList Dependencies;
+        };
 
-        DependencyGraph graph(rootId, [&](const Dependency& node) {
+        // Looks up the packages that manifests depend on, keeping the results so that every package is only
+        // looked up once however many of the manifests being validated depend on it.
+        struct DependencyPackageCache
+        {
+            DependencyPackageCache(SQLiteIndex* index) : m_index(index) {}
 
-            DependencyList depList;
-            if (node.Id == rootId.Id)
+            const DependencyPackageInfo& Get(const Manifest::string_t& packageId)
             {
-                return GetDependencies(manifest, DependencyType::Package);
-            }
+                std::string foldedId = Utility::FoldCase(packageId);
 
-            auto packageLatest = GetPackageLatestVersion(index, node.Id);
-            if (!packageLatest.has_value())
-            {
-                std::string error = ManifestError::MissingManifestDependenciesNode;
-                error.append(" ").append(node.Id);
-                dependenciesError.emplace_back(ValidationError(error));
-                foundErrors = true;
-                return depList;
+                auto itr = m_packages.find(foldedId);
+                if (itr == m_packages.end())
+                {
+                    itr = m_packages.emplace(std::move(foldedId), Lookup(packageId)).first;
+                }
+
+                return itr->second;
             }
 
-            if (node.MinVersion > packageLatest.value().second)
+        private:
+            DependencyPackageInfo Lookup(const Manifest::string_t& packageId)
             {
-                std::string error = ManifestError::NoSuitableMinVersion;
-                error.append(" ").append(node.Id);
-                dependenciesError.emplace_back(ValidationError(error));
-                foundErrors = true;
-                return depList;
+                DependencyPackageInfo result;
+
+                auto packageLatest = GetPackageLatestVersion(m_index, packageId);
+                if (!packageLatest.has_value())
+                {
+                    return result;
+                }
+
+                result.Found = true;
+                result.LatestVersion = packageLatest.value().second;
+
+                for (const auto& row : m_index->GetDependenciesByManifestRowId(packageLatest.value().first))
+                {
+                    auto manifestRowId = m_index->GetManifestIdByKey(row.first, "", "");
+                    auto dependencyId = m_index->GetPropertyByManifestId(manifestRowId.value(), PackageVersionProperty::Id);
+                    result.Dependencies.Add(Manifest::Dependency(Manifest::DependencyType::Package, dependencyId.value(), row.second));
+                }
+
+                return result;
             }
 
-            auto packageLatestDependencies = index->GetDependenciesByManifestRowId(packageLatest.value().first);
-            std::for_each(
-                packageLatestDependencies.begin(),
-                packageLatestDependencies.end(),
-                [&](std::pair<SQLite::rowid_t, Utility::NormalizedString> row)
+            SQLiteIndex* m_index;
+            std::map<std::string, DependencyPackageInfo> m_packages;
+        };
+
+        std::vector<Manifest::ValidationError> GetDependenciesErrors(DependencyPackageCache& cache, const Manifest::Manifest& manifest)
+        {
+            using namespace Manifest;
+
+            Dependency rootId(DependencyType::Package, manifest.Id, manifest.Version);
+            std::vector<ValidationError> dependenciesError;
+            bool foundErrors = false;
+
+            DependencyGraph graph(rootId, [&](const Dependency& node) {
+
+                if (node.Id == rootId.Id)
+                {
+                    return GetDependencies(manifest, DependencyType::Package);
+                }
+
+                const DependencyPackageInfo& package = cache.Get(node.Id);
+                if (!package.Found)
+                {
+                    std::string error = ManifestError::MissingManifestDependenciesNode;
+                    error.append(" ").append(node.Id);
+                    dependenciesError.emplace_back(ValidationError(error));
+                    foundErrors = true;
+                    return DependencyList{};
+                }
+
+                if (node.MinVersion > package.LatestVersion)
                 {
-                    auto manifestRowId = index->GetManifestIdByKey(row.first, "", "");
-                    auto packageId = index->GetPropertyByManifestId(manifestRowId.value(), PackageVersionProperty::Id);
-                    Dependency dep(DependencyType::Package, packageId.value(), row.second);
-                    depList.Add(dep);
+                    std::string error = ManifestError::NoSuitableMinVersion;
+                    error.append(" ").append(node.Id);
+                    dependenciesError.emplace_back(ValidationError(error));
+                    foundErrors = true;
+                    return DependencyList{};
+                }
+
+                return package.Dependencies;
                 });
 
-            return depList;
-            });
+            graph.BuildGraph();
 
-        graph.BuildGraph();
+            if (!foundErrors && graph.HasLoop())
+            {
+                std::string error = ManifestError::FoundLoop;
+                dependenciesError.emplace_back(error);
+            }
 
-        if (foundErrors)
-        {
-            THROW_EXCEPTION(ManifestException(std::move(dependenciesError), APPINSTALLER_CLI_ERROR_DEPENDENCIES_VALIDATION_FAILED));
+            return dependenciesError;
         }
+    };
+
+    bool PackageDependenciesValidation::ValidateManifestDependencies(SQLiteIndex* index, const Manifest::Manifest manifest)
+    {
+        DependencyPackageCache cache{ index };
+        auto dependenciesError = GetDependenciesErrors(cache, manifest);
 
-        if (graph.HasLoop())
+        if (!dependenciesError.empty())
         {
-            std::string error = ManifestError::FoundLoop;
-            dependenciesError.emplace_back(error);
-            THROW_EXCEPTION(ManifestException(std::move(dependenciesError), APPINSTALLER_CLI_ERROR_DEPENDENCIES_VALIDATION_FAILED));
+            THROW_EXCEPTION(Manifest::ManifestException(std::move(dependenciesError), APPINSTALLER_CLI_ERROR_DEPENDENCIES_VALIDATION_FAILED));
         }
 
         return true;
     }
 
+    std::vector<std::vector<Manifest::ValidationError>> PackageDependenciesValidation::ValidateManifestDependencies(SQLiteIndex* index, const std::vector<Manifest::Manifest>& manifests)
+    {
+        DependencyPackageCache cache{ index };
+        std::vector<std::vector<Manifest::ValidationError>> result;
+        result.reserve(manifests.size());
+
+        for (const auto& manifest : manifests)
+        {
+            result.emplace_back(GetDependenciesErrors(cache, manifest));
+        }
+
+        return result;
+    }
+
     bool PackageDependenciesValidation::VerifyDependenciesStructureForManifestDelete(SQLiteIndex* index, const Manifest::Manifest manifest)
     {
         auto dependentsSet = index->GetDependentsById(manifest.Id);
@@ -4,8 +4,11 @@
 #include <Microsoft/SQLiteIndex.h>
 #include <AppInstallerVersions.h>
 #include <winget/Manifest.h>
+#include <winget/ManifestValidation.h>
 #include <SQLiteWrapper.h>
 
+#include <vector>
+
 namespace AppInstaller::Repository
 {
     using namespace AppInstaller::Repository::Microsoft;
@@ -15,6 +18,11 @@ namespace AppInstaller::Repository
         // Validate the dependencies of the given manifest.
         static bool ValidateManifestDependencies(SQLiteIndex* index, const Manifest::Manifest manifest);
 
+        // Validate the dependencies of each of the given manifests. Each package that the manifests depend on is only
+        // looked up in the index once for the whole batch, rather than once for every manifest that depends on it.
+        // Returns the errors of each manifest, in the order of the manifests; the errors of a valid manifest are empty.
+        static std::vector<std::vector<Manifest::ValidationError>> ValidateManifestDependencies(SQLiteIndex* index, const std::vector<Manifest::Manifest>& manifests);
+
         static bool VerifyDependenciesStructureForManifestDelete(SQLiteIndex* index, const Manifest::Manifest manifest);
     };
 }
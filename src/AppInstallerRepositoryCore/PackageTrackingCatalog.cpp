@@ -30,6 +30,21 @@ namespace AppInstaller::Repository
             return result;
         }
 
+        SQLiteIndex OpenTrackingIndexForRead(const std::filesystem::path& trackingDB)
+        {
+            try
+            {
+                return SQLiteIndex::Open(trackingDB.u8string(), SQLiteIndex::OpenDisposition::Read);
+            }
+            catch (...)
+            {
+                // A read only connection cannot roll back a transaction left behind by a process that exited while writing.
+                AICLI_LOG(Repo, Warning, << "Failed to open the tracking catalog for read, opening it for read and write instead");
+            }
+
+            return SQLiteIndex::Open(trackingDB.u8string(), SQLiteIndex::OpenDisposition::ReadWrite);
+        }
+
         struct PackageTrackingCatalogSourceReference : public ISourceReference
         {
             PackageTrackingCatalogSourceReference(const SourceDetails& details) : m_details(details) {}
@@ -64,7 +79,8 @@ namespace AppInstaller::Repository
 
                 auto lock = Synchronization::CrossProcessReaderWriteLock::LockShared(lockName);
 
-                SQLiteIndex index = SQLiteIndex::Open(trackingDB.u8string(), SQLiteIndex::OpenDisposition::ReadWrite);
+                // Searches only read from the index; the first write through the catalog opens it again for writing.
+                SQLiteIndex index = OpenTrackingIndexForRead(trackingDB);
 
                 // TODO: Check schema version and upgrade as necessary when there is a relevant new schema.
                 //       Could write this all now but it will be better tested when there is a new schema.
@@ -125,6 +141,25 @@ namespace AppInstaller::Repository
     struct PackageTrackingCatalog::implementation
     {
         std::shared_ptr<Microsoft::SQLiteIndexSource> Source;
+
+        // Gets the index to use for changes, opening it for read and write on first use.
+        SQLiteIndex& GetIndexForWrite()
+        {
+            std::lock_guard<std::mutex> lock{ m_writeIndexLock };
+
+            if (!m_writeIndex)
+            {
+                // The source reference stores the path part for the tracking catalog in the Arg field.
+                std::filesystem::path trackingDB = GetPackageTrackingFilePath(Source->GetDetails().Arg);
+                m_writeIndex.emplace(SQLiteIndex::Open(trackingDB.u8string(), SQLiteIndex::OpenDisposition::ReadWrite));
+            }
+
+            return m_writeIndex.value();
+        }
+
+    private:
+        std::mutex m_writeIndexLock;
+        std::optional<SQLiteIndex> m_writeIndex;
     };
 
     PackageTrackingCatalog::PackageTrackingCatalog() = default;
@@ -218,7 +253,7 @@ namespace AppInstaller::Repository
         UNREFERENCED_PARAMETER(installer);
         UNREFERENCED_PARAMETER(isUpgrade);
 
-        auto& index = m_implementation->Source->GetIndex();
+        auto& index = m_implementation->GetIndexForWrite();
 
         // Check for an existing manifest that matches this one (could be reinstalling)
         auto manifestIdOpt = index.GetManifestIdByManifest(manifest);
@@ -239,6 +274,9 @@ namespace AppInstaller::Repository
         strstr << Utility::GetCurrentUnixEpoch();
         index.SetMetadataByManifestId(manifestId, PackageVersionMetadata::TrackingWriteTime, strstr.str());
 
+        // Searches of composite sources read the tracking catalog
+        Source::InvalidateSearchResults();
+
         std::shared_ptr<Version::implementation> result = std::make_shared<Version::implementation>();
         result->Id = manifestId;
         return { std::move(result) };
@@ -246,26 +284,46 @@ namespace AppInstaller::Repository
 
     void PackageTrackingCatalog::RecordUninstall(const Utility::LocIndString& packageIdentifier)
     {
-        auto& index = m_implementation->Source->GetIndex();
+        RecordUninstalls({ packageIdentifier });
+    }
+
+    void PackageTrackingCatalog::RecordUninstalls(const std::vector<Utility::LocIndString>& packageIdentifiers)
+    {
+        if (packageIdentifiers.empty())
+        {
+            return;
+        }
+
+        auto& index = m_implementation->GetIndexForWrite();
 
-        SearchRequest idSearch;
-        idSearch.Filters.emplace_back(PackageMatchField::Id, MatchType::CaseInsensitive, packageIdentifier.get());
-        auto searchResult = index.Search(idSearch);
+        // Each removal would otherwise be committed, and synced to disk, on its own
+        SQLite::Savepoint savepoint = index.CreateSavepoint("trackingcatalog_recorduninstalls");
 
-        for (const auto& match : searchResult.Matches)
+        for (const auto& packageIdentifier : packageIdentifiers)
         {
-            auto versions = index.GetVersionKeysById(match.first);
+            SearchRequest idSearch;
+            idSearch.Filters.emplace_back(PackageMatchField::Id, MatchType::CaseInsensitive, packageIdentifier.get());
+            auto searchResult = index.Search(idSearch);
 
-            for (const auto& version : versions)
+            for (const auto& match : searchResult.Matches)
             {
-                auto manifestId = index.GetManifestIdByKey(match.first, version.GetVersion().ToString(), version.GetChannel().ToString());
+                auto versions = index.GetVersionKeysById(match.first);
 
-                if (manifestId)
+                for (const auto& version : versions)
                 {
-                    index.RemoveManifestById(manifestId.value());
+                    auto manifestId = index.GetManifestIdByKey(match.first, version.GetVersion().ToString(), version.GetChannel().ToString());
+
+                    if (manifestId)
+                    {
+                        index.RemoveManifestById(manifestId.value());
+                    }
                 }
             }
         }
+
+        savepoint.Commit();
+
+        Source::InvalidateSearchResults();
     }
 
     std::unique_ptr<ISourceFactory> PackageTrackingCatalogSourceFactory::Create()
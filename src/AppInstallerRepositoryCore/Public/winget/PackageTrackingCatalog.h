@@ -64,6 +64,9 @@ namespace AppInstaller::Repository
         // Records an uninstall of the given package.
         void RecordUninstall(const Utility::LocIndString& packageIdentifier);
 
+        // Records an uninstall of each of the given packages, all in a single transaction.
+        void RecordUninstalls(const std::vector<Utility::LocIndString>& packageIdentifiers);
+
     protected:
         // Creates or opens the tracking catalog for the given source.
         static PackageTrackingCatalog CreateForSource(const Source& source);
@@ -115,6 +115,11 @@ namespace AppInstaller::Repository
         // The default of 0 will place no limit.
         size_t MaximumResults{};
 
+        // When set, a composite source searches its available sources one at a time in priority order, and stops at the
+        // first whose only result is an exact match on the package id. For callers that want a single package, where
+        // the results from the other sources could only make the search ambiguous.
+        bool StopAtUniqueIdMatch = false;
+
         // Returns a value indicating whether this request is for all available data.
         bool IsForEverything() const;
 
@@ -134,6 +139,9 @@ namespace AppInstaller::Repository
         RelativePath,
         // Returned in hexadecimal format
         ManifestSHA256Hash,
+        // A compact description of the installers, as created by Manifest::CreateInstallerSummary.
+        // Empty if the source does not have one; the manifest must be used in that case.
+        InstallerSummary,
     };
 
     // A property of a package version that can have multiple values.
@@ -229,6 +237,9 @@ namespace AppInstaller::Repository
     // A package, potentially containing information about it's local state and the available versions.
     struct IPackage
     {
+        // The values of a set of multi-properties for a single package version.
+        using MultiProperties = std::map<PackageVersionMultiProperty, std::vector<Utility::LocIndString>>;
+
         virtual ~IPackage() = default;
 
         // Gets a property of this package.
@@ -242,12 +253,21 @@ namespace AppInstaller::Repository
         //  Ex. { 4, 3, 2, 1 }
         virtual std::vector<PackageVersionKey> GetAvailableVersionKeys() const = 0;
 
+        // Gets no more than the given number of the newest available versions of this package, in the same order as GetAvailableVersionKeys.
+        // The default implementation gets all of the versions; implementations that can stop early should override it.
+        virtual std::vector<PackageVersionKey> GetLatestAvailableVersionKeys(size_t count) const;
+
         // Gets a specific version of this package.
         virtual std::shared_ptr<IPackageVersion> GetLatestAvailableVersion() const = 0;
 
         // Gets a specific version of this package.
         virtual std::shared_ptr<IPackageVersion> GetAvailableVersion(const PackageVersionKey& versionKey) const = 0;
 
+        // Gets the given multi-properties for all available versions of this package, one entry per version.
+        // The order of the versions is not specified. The default implementation visits every available version;
+        // implementations that can retrieve the values in bulk should override it.
+        virtual std::vector<MultiProperties> GetAvailableVersionsMultiProperties(const std::vector<PackageVersionMultiProperty>& properties) const;
+
         // Gets a value indicating whether an available version is newer than the installed version.
         virtual bool IsUpdateAvailable() const = 0;
 
@@ -287,6 +307,20 @@ namespace AppInstaller::Repository
         std::vector<Failure> Failures;
     };
 
+    // The installed packages in a search result that have an upgrade available, without any of their other details.
+    struct UpgradeSummary
+    {
+        // The ids of the packages that have an upgrade available.
+        std::vector<Utility::LocIndString> PackageIds;
+
+        // The number of installed packages that were left out because their version is unknown.
+        size_t UnknownVersionCount = 0;
+    };
+
+    // Summarizes the upgrades available in the result of searching a composite of the installed source and available sources.
+    // Packages with an unknown installed version are counted rather than checked, unless includeUnknown is set.
+    UpgradeSummary GetUpgradeSummary(const SearchResult& result, bool includeUnknown);
+
     struct UnsupportedRequestException : public wil::ResultException
     {
         UnsupportedRequestException() : wil::ResultException(APPINSTALLER_CLI_ERROR_UNSUPPORTED_SOURCE_REQUEST) {}
@@ -7,6 +7,7 @@
 
 #include <chrono>
 #include <filesystem>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
@@ -202,8 +203,18 @@ namespace AppInstaller::Repository
         bool SetCustomHeader(std::optional<std::string> header);
 
         // Execute a search on the source.
+        // An opened source, and a composite of opened sources, remembers its results; an identical request
+        // is answered from them until something that could change them is written.
         SearchResult Search(const SearchRequest& request) const;
 
+        // Forgets the search results remembered by every source in this process.
+        // Called whenever anything that searches read from is written.
+        static void InvalidateSearchResults();
+
+        // Gets the values of the fields that start with the prefix for completion, without opening the source.
+        // Returns an empty value if any of the sources cannot do this, in which case the source must be opened and searched.
+        std::optional<std::vector<std::string>> GetCompletionValues(const std::vector<PackageMatchField>& fields, std::string_view prefix) const;
+
         /* Source agreements */
 
         // Get required agreement fields info.
@@ -234,6 +245,9 @@ namespace AppInstaller::Repository
 
         /* Source operations */
 
+        // Prevents the source from being updated when it is opened, even if it is past its update interval.
+        void DisableBackgroundUpdate();
+
         // Opens the source. This function should throw upon open failure rather than returning an empty pointer.
         std::vector<SourceDetails> Open(IProgressCallback& progress);
 
@@ -243,6 +257,19 @@ namespace AppInstaller::Repository
         // Update Source. Source update command.
         std::vector<SourceDetails> Update(IProgressCallback& progress);
 
+        // Updates the sources concurrently, each reporting to the progress callback that getProgress returns for it.
+        // The callbacks are all retrieved before any update starts and must remain valid until this returns.
+        // onComplete is called from the thread of each update as it completes, with whether it succeeded.
+        // The metadata of the updated sources is saved once every update has completed. Returns the sources that failed.
+        std::vector<SourceDetails> UpdateConcurrently(
+            const std::function<IProgressCallback&(const SourceDetails&)>& getProgress,
+            const std::function<void(const SourceDetails&, bool)>& onComplete = {});
+
+        // Runs an update that Open handed to the background update handler, in the process that the handler started.
+        // Each source is only updated if it is still past its update interval and no other process is updating it; the claim
+        // on its update is held until the update is done. Returns the sources that failed.
+        std::vector<SourceDetails> RunBackgroundUpdate(IProgressCallback& progress);
+
         // Remove source. Source remove command.
         bool Remove(IProgressCallback& progress);
 
@@ -252,16 +279,34 @@ namespace AppInstaller::Repository
         // Drop source. Source reset command.
         static bool DropSource(std::string_view name);
 
+        // Sets the function that runs the updates that Open starts for sources that are past their update interval.
+        // Such a source is opened with the data that it has, rather than waiting for the update. Without a handler,
+        // the update runs on the thread pool of this process; a process that will soon exit can hand it to another process instead,
+        // which runs it with RunBackgroundUpdate.
+        static void SetBackgroundUpdateHandler(std::function<void(const SourceDetails&)> handler);
+
+        // Waits for the background updates running in this process to finish, so that none is cut off partway by the
+        // process exiting. Updates started while waiting are waited for as well.
+        static void WaitForBackgroundUpdates();
+
         // Get a list of all available SourceDetails.
         static std::vector<SourceDetails> GetCurrentSources();
 
     private:
+        struct SearchCache;
+
+        // Creates a search cache whose results are released when the process trims its memory.
+        static std::shared_ptr<SearchCache> CreateSearchCache();
+
         void InitializeSourceReference(std::string_view name);
 
         std::vector<std::shared_ptr<ISourceReference>> m_sourceReferences;
         std::shared_ptr<ISource> m_source;
+        // Shared by the copies of an opened source; empty if the results are not remembered.
+        std::shared_ptr<SearchCache> m_searchCache;
         bool m_isSourceToBeAdded = false;
         bool m_isComposite = false;
+        bool m_isBackgroundUpdateDisabled = false;
         mutable PackageTrackingCatalog m_trackingCatalog;
     };
 }
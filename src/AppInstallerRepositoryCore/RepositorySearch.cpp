@@ -30,6 +30,40 @@ namespace AppInstaller::Repository
         }
     }
 
+    std::vector<PackageVersionKey> IPackage::GetLatestAvailableVersionKeys(size_t count) const
+    {
+        std::vector<PackageVersionKey> result = GetAvailableVersionKeys();
+
+        if (result.size() > count)
+        {
+            result.erase(result.begin() + count, result.end());
+        }
+
+        return result;
+    }
+
+    std::vector<IPackage::MultiProperties> IPackage::GetAvailableVersionsMultiProperties(const std::vector<PackageVersionMultiProperty>& properties) const
+    {
+        std::vector<MultiProperties> result;
+
+        for (auto const& versionKey : GetAvailableVersionKeys())
+        {
+            auto packageVersion = GetAvailableVersion(versionKey);
+            if (!packageVersion)
+            {
+                continue;
+            }
+
+            MultiProperties& versionProperties = result.emplace_back();
+            for (auto property : properties)
+            {
+                versionProperties[property] = packageVersion->GetMultiProperty(property);
+            }
+        }
+
+        return result;
+    }
+
     bool SearchRequest::IsForEverything() const
     {
         return (!Query.has_value() && Inclusions.empty() && Filters.empty());
@@ -64,6 +98,11 @@ namespace AppInstaller::Repository
             result << " Filter:" << Repository::ToString(filter.Field) << "='" << filter.Value << "'[" << Repository::ToString(filter.Type) << "]";
         }
 
+        if (StopAtUniqueIdMatch)
+        {
+            result << " [StopAtUniqueIdMatch]";
+        }
+
         if (MaximumResults)
         {
             result << " Limit:" << MaximumResults;
@@ -211,4 +250,31 @@ namespace AppInstaller::Repository
 
         return PackageMatchField::Unknown;
     }
+
+    UpgradeSummary GetUpgradeSummary(const SearchResult& result, bool includeUnknown)
+    {
+        UpgradeSummary summary;
+
+        for (const auto& match : result.Matches)
+        {
+            auto installedVersion = match.Package->GetInstalledVersion();
+            if (!installedVersion)
+            {
+                continue;
+            }
+
+            if (!includeUnknown && Utility::Version(installedVersion->GetProperty(PackageVersionProperty::Version)).IsUnknown())
+            {
+                ++summary.UnknownVersionCount;
+                continue;
+            }
+
+            if (match.Package->IsUpdateAvailable())
+            {
+                summary.PackageIds.emplace_back(match.Package->GetProperty(PackageProperty::Id));
+            }
+        }
+
+        return summary;
+    }
 }
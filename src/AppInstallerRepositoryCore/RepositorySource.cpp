@@ -16,7 +16,14 @@
 #include "Microsoft/ConfigurableTestSourceFactory.h"
 #endif
 
+#include <AppInstallerSHA256.h>
+#include <AppInstallerSynchronization.h>
 #include <winget/GroupPolicy.h>
+#include <winget/MemoryTrim.h>
+#include <winget/ThreadGlobals.h>
+#include <winget/Timing.h>
+
+#include <future>
 
 using namespace AppInstaller::Settings;
 using namespace std::chrono_literals;
@@ -29,6 +36,84 @@ namespace AppInstaller::Repository
         static std::map<std::string, std::function<std::unique_ptr<ISourceFactory>()>> s_Sources_TestHook_SourceFactories;
 #endif
 
+        // The handler for updates that Open defers; when none is set, they run on the thread pool of this process.
+        static std::function<void(const SourceDetails&)> s_BackgroundUpdateHandler;
+
+        // The number of updates running on the thread pool of this process, so that they can be waited for before it exits.
+        struct BackgroundUpdates
+        {
+            std::mutex Lock;
+            std::condition_variable Changed;
+            size_t Running = 0;
+        };
+
+        BackgroundUpdates& GetBackgroundUpdates()
+        {
+            // Never destroyed, as an update may still be finishing while the process exits.
+            static BackgroundUpdates* s_updates = new BackgroundUpdates();
+            return *s_updates;
+        }
+
+        // Changes whenever a write may change the results of searches made before it.
+        static std::atomic<uint64_t> s_SearchResultsGeneration = 0;
+
+        // The most search results that a source remembers; all are forgotten when more are needed.
+        constexpr size_t s_SearchCacheCapacity = 64;
+
+        void AppendSearchCacheKeyValue(std::string& key, std::string_view value)
+        {
+            // The length prefix keeps values containing separators from being confused for others.
+            key += std::to_string(value.length());
+            key += ':';
+            key += value;
+        }
+
+        void AppendSearchCacheKeyMatch(std::string& key, char kind, const RequestMatch& match)
+        {
+            key += kind;
+            key += std::to_string(static_cast<int>(match.Type));
+            AppendSearchCacheKeyValue(key, match.Value);
+
+            if (match.Additional)
+            {
+                key += '+';
+                AppendSearchCacheKeyValue(key, match.Additional.value());
+            }
+        }
+
+        // Gets a string that is the same for two requests exactly when they are the same.
+        std::string GetSearchCacheKey(const SearchRequest& request)
+        {
+            std::string result;
+
+            if (request.Query)
+            {
+                AppendSearchCacheKeyMatch(result, 'Q', request.Query.value());
+            }
+
+            for (const auto& inclusion : request.Inclusions)
+            {
+                AppendSearchCacheKeyMatch(result, 'I', inclusion);
+                result += std::to_string(static_cast<int>(inclusion.Field));
+            }
+
+            for (const auto& filter : request.Filters)
+            {
+                AppendSearchCacheKeyMatch(result, 'F', filter);
+                result += std::to_string(static_cast<int>(filter.Field));
+            }
+
+            result += 'L';
+            result += std::to_string(request.MaximumResults);
+
+            if (request.StopAtUniqueIdMatch)
+            {
+                result += 'U';
+            }
+
+            return result;
+        }
+
         std::shared_ptr<ISourceReference> CreateSourceFromDetails(const SourceDetails& details)
         {
             return ISourceFactory::GetForType(details.Type)->Create(details);
@@ -37,9 +122,23 @@ namespace AppInstaller::Repository
         template <typename MemberFunc>
         bool AddOrUpdateFromDetails(SourceDetails& details, MemberFunc member, IProgressCallback& progress)
         {
+            Timing::Span span{ Timing::Phase::SourceUpdate };
             bool result = false;
             auto factory = ISourceFactory::GetForType(details.Type);
 
+            auto startTime = std::chrono::steady_clock::now();
+            uint64_t startBytesReceived = Utility::GetBytesReceived();
+            auto logUpdate = wil::scope_exit([&]()
+                {
+                    Logging::Telemetry().LogSourceUpdate(
+                        details.Identifier,
+                        details.Type,
+                        member == &ISourceFactory::BackgroundUpdate,
+                        result,
+                        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime),
+                        Utility::GetBytesReceived() - startBytesReceived);
+                });
+
             // Attempt; if it fails, wait a short time and retry.
             try
             {
@@ -79,6 +178,19 @@ namespace AppInstaller::Repository
             return AddOrUpdateFromDetails(details, &ISourceFactory::BackgroundUpdate, progress);
         }
 
+        // Opens the source reference, logging how long it took.
+        std::shared_ptr<ISource> OpenSourceReference(ISourceReference& sourceReference, bool updated, IProgressCallback& progress)
+        {
+            auto startTime = std::chrono::steady_clock::now();
+            std::shared_ptr<ISource> result = sourceReference.Open(progress);
+
+            const auto& details = sourceReference.GetDetails();
+            Logging::Telemetry().LogSourceOpen(details.Identifier, details.Type,
+                std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime), updated);
+
+            return result;
+        }
+
         bool RemoveSourceFromDetails(const SourceDetails& details, IProgressCallback& progress)
         {
             auto factory = ISourceFactory::GetForType(details.Type);
@@ -91,6 +203,147 @@ namespace AppInstaller::Repository
             return (origin == SourceOrigin::Default || origin == SourceOrigin::GroupPolicy || origin == SourceOrigin::User);
         }
 
+        // Updates the source and records the time of the update, returning false if it failed.
+        bool UpdateSourceAndSaveMetadata(SourceDetails& details, SourceList& sourceList, IProgressCallback& progress)
+        {
+            try
+            {
+                // TODO: Consider adding a context callback to indicate we are doing the same action
+                // to avoid the progress bar fill up multiple times.
+                if (BackgroundUpdateSourceFromDetails(details, progress))
+                {
+                    auto detailsInternal = sourceList.GetSource(details.Name);
+                    if (detailsInternal)
+                    {
+                        detailsInternal->LastUpdateTime = details.LastUpdateTime;
+                        sourceList.SaveMetadata(*detailsInternal);
+                    }
+
+                    return true;
+                }
+
+                AICLI_LOG(Repo, Error, << "Failed to update source: " << details.Name);
+            }
+            catch (...)
+            {
+                LOG_CAUGHT_EXCEPTION();
+                AICLI_LOG(Repo, Warning, << "Failed to update source: " << details.Name);
+            }
+
+            return false;
+        }
+
+        // Updates the source from the source reference without saving its metadata, returning false if it failed.
+        bool UpdateSourceReference(ISourceReference& sourceReference, IProgressCallback& progress)
+        {
+            THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), !ContainsAvailablePackagesInternal(sourceReference.GetDetails().Origin));
+
+            auto& details = sourceReference.GetDetails();
+            AICLI_LOG(Repo, Info, << "Named source to be updated, found: " << details.Name);
+
+            try
+            {
+                if (UpdateSourceFromDetails(details, progress))
+                {
+                    return true;
+                }
+
+                AICLI_LOG(Repo, Error, << "Failed to update source: " << details.Name);
+            }
+            catch (...)
+            {
+                LOG_CAUGHT_EXCEPTION();
+                AICLI_LOG(Repo, Error, << "Failed to update source: " << details.Name);
+            }
+
+            return false;
+        }
+
+        // Records the time of the update of each of the updated sources, all from one source list.
+        void SaveUpdatedMetadata(const std::vector<const SourceDetails*>& updated)
+        {
+            if (updated.empty())
+            {
+                return;
+            }
+
+            SourceList sourceList;
+            for (const SourceDetails* details : updated)
+            {
+                auto detailsInternal = sourceList.GetSource(details->Name);
+                if (detailsInternal)
+                {
+                    detailsInternal->LastUpdateTime = details->LastUpdateTime;
+                    sourceList.SaveMetadata(*detailsInternal);
+                }
+            }
+        }
+
+        // Claims the background update of the source among the processes that are running, for the auto update interval.
+        // Concurrent invocations that all find the source out of date then leave the update, and the metadata write, to one of them.
+        Synchronization::CrossProcessClaim TryClaimBackgroundUpdate(const SourceDetails& details)
+        {
+            std::string claimName = "WinGetSourceUpdate_" + Utility::SHA256::ConvertToString(Utility::SHA256::ComputeHash(details.Name));
+            return Synchronization::CrossProcessClaim::TryClaim(claimName, User().Get<Setting::AutoUpdateTimeInMinutes>());
+        }
+
+        // Starts an update of the source that the current open does not wait for.
+        void StartBackgroundUpdate(const SourceDetails& details, Synchronization::CrossProcessClaim&& claim)
+        {
+            AICLI_LOG(Repo, Info, << "Updating source in the background: " << details.Name);
+
+            if (s_BackgroundUpdateHandler)
+            {
+                // The claim is released for the process that the handler starts, which takes it for the whole of its update.
+                claim.Abandon();
+                s_BackgroundUpdateHandler(details);
+                return;
+            }
+
+            // The update takes the source's lock exclusively, so it replaces the data once this process is done reading it.
+            // The claim is held until the update is done, and given up if it fails so that another process can try.
+            BackgroundUpdates& updates = GetBackgroundUpdates();
+            auto sharedClaim = std::make_shared<Synchronization::CrossProcessClaim>(std::move(claim));
+
+            auto finishUpdate = [&updates]()
+            {
+                {
+                    std::lock_guard<std::mutex> lock{ updates.Lock };
+                    --updates.Running;
+                }
+
+                updates.Changed.notify_all();
+            };
+
+            {
+                std::lock_guard<std::mutex> lock{ updates.Lock };
+                ++updates.Running;
+            }
+
+            auto finishIfNotSubmitted = wil::scope_exit(finishUpdate);
+
+            Synchronization::SubmitWork(Synchronization::WorkLane::Io, [details, sharedClaim, finishUpdate]()
+                {
+                    auto finish = wil::scope_exit(finishUpdate);
+
+                    bool updated = false;
+                    try
+                    {
+                        SourceList sourceList;
+                        ProgressCallback progress;
+                        updated = UpdateSourceAndSaveMetadata(details, sourceList, progress);
+                    }
+                    CATCH_LOG();
+
+                    if (!updated)
+                    {
+                        sharedClaim->Abandon();
+                    }
+                });
+
+            finishIfNotSubmitted.release();
+        }
+
         // Determines whether (and logs why) a source should be updated before it is opened.
         bool ShouldUpdateBeforeOpen(const SourceDetails& details)
         {
@@ -150,7 +403,7 @@ namespace AppInstaller::Repository
         }
 
         // Carries the exception from an OpenSource call and presents it back at search time.
-        struct OpenExceptionProxy : public ISource, std::enable_shared_from_this<OpenExceptionProxy>
+        struct OpenExceptionProxy : public ISource
         {
             OpenExceptionProxy(const SourceDetails& details, std::exception_ptr exception) :
                 m_details(details), m_exception(std::move(exception)) {}
@@ -236,6 +489,45 @@ namespace AppInstaller::Repository
         }
     }
 
+    // The remembered results of a source, for the generation that they were searched in.
+    struct Source::SearchCache
+    {
+        std::mutex Lock;
+        uint64_t Generation = 0;
+        std::map<std::string, SearchResult> Results;
+    };
+
+    std::shared_ptr<Source::SearchCache> Source::CreateSearchCache()
+    {
+        static std::mutex s_cachesLock;
+        static std::vector<std::weak_ptr<SearchCache>> s_caches;
+        static std::once_flag s_registerOnce;
+
+        std::call_once(s_registerOnce, []()
+            {
+                Memory::RegisterTrimFunction([]()
+                    {
+                        std::lock_guard<std::mutex> cachesLock{ s_cachesLock };
+                        for (const auto& weakCache : s_caches)
+                        {
+                            if (auto cache = weakCache.lock())
+                            {
+                                std::lock_guard<std::mutex> lock{ cache->Lock };
+                                cache->Results.clear();
+                            }
+                        }
+                    });
+            });
+
+        auto result = std::make_shared<SearchCache>();
+
+        std::lock_guard<std::mutex> cachesLock{ s_cachesLock };
+        s_caches.erase(std::remove_if(s_caches.begin(), s_caches.end(), [](const auto& weakCache) { return weakCache.expired(); }), s_caches.end());
+        s_caches.emplace_back(result);
+
+        return result;
+    }
+
     Source::Source() {}
 
     Source::Source(std::string_view name)
@@ -295,6 +587,12 @@ namespace AppInstaller::Repository
 
         m_source = compositeSource;
         m_isComposite = true;
+
+        // The composite only reads from the sources, so it can remember its results when they can
+        if (installedSource.m_searchCache && availableSource.m_searchCache)
+        {
+            m_searchCache = CreateSearchCache();
+        }
     }
 
     Source::Source(std::shared_ptr<ISource> source) : m_source(std::move(source)) {}
@@ -408,10 +706,88 @@ namespace AppInstaller::Repository
         return m_sourceReferences[0]->SetCustomHeader(header);
     }
 
+    std::optional<std::vector<std::string>> Source::GetCompletionValues(const std::vector<PackageMatchField>& fields, std::string_view prefix) const
+    {
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), m_sourceReferences.empty());
+
+        std::vector<std::string> result;
+        std::set<std::string> added;
+
+        for (const auto& sourceReference : m_sourceReferences)
+        {
+            std::optional<std::vector<std::string>> values = sourceReference->GetCompletionValues(fields, prefix);
+            if (!values)
+            {
+                AICLI_LOG(Repo, Verbose, << "Completion values not available without opening source: " << sourceReference->GetDetails().Name);
+                return {};
+            }
+
+            for (auto& value : values.value())
+            {
+                if (added.insert(value).second)
+                {
+                    result.emplace_back(std::move(value));
+                }
+            }
+        }
+
+        return result;
+    }
+
     SearchResult Source::Search(const SearchRequest& request) const
     {
         THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), !m_source);
-        return m_source->Search(request);
+
+        if (!m_searchCache)
+        {
+            return m_source->Search(request);
+        }
+
+        std::string key = GetSearchCacheKey(request);
+        uint64_t generation = s_SearchResultsGeneration.load();
+
+        {
+            std::lock_guard<std::mutex> lock{ m_searchCache->Lock };
+
+            if (m_searchCache->Generation != generation)
+            {
+                m_searchCache->Results.clear();
+                m_searchCache->Generation = generation;
+            }
+
+            auto itr = m_searchCache->Results.find(key);
+            if (itr != m_searchCache->Results.end())
+            {
+                AICLI_LOG(Repo, Verbose, << "Using the remembered results of search: " << request.ToString());
+                return itr->second;
+            }
+        }
+
+        SearchResult result = m_source->Search(request);
+
+        // A search that failed on some source may succeed if it is tried again
+        if (result.Failures.empty())
+        {
+            std::lock_guard<std::mutex> lock{ m_searchCache->Lock };
+
+            // Results searched while something was written are not known to be current
+            if (m_searchCache->Generation == generation)
+            {
+                if (m_searchCache->Results.size() >= s_SearchCacheCapacity)
+                {
+                    m_searchCache->Results.clear();
+                }
+
+                m_searchCache->Results.emplace(std::move(key), result);
+            }
+        }
+
+        return result;
+    }
+
+    void Source::InvalidateSearchResults()
+    {
+        ++s_SearchResultsGeneration;
     }
 
     ImplicitAgreementFieldEnum Source::GetAgreementFieldsFromSourceInformation() const
@@ -469,6 +845,7 @@ namespace AppInstaller::Repository
         auto writableSource = std::dynamic_pointer_cast<IMutablePackageSource>(m_source);
         THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), !writableSource);
         writableSource->AddPackageVersion(manifest, relativePath);
+        InvalidateSearchResults();
     }
 
     void Source::RemovePackageVersion(const Manifest::Manifest& manifest, const std::filesystem::path& relativePath)
@@ -477,12 +854,19 @@ namespace AppInstaller::Repository
         auto writableSource = std::dynamic_pointer_cast<IMutablePackageSource>(m_source);
         THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), !writableSource);
         writableSource->RemovePackageVersion(manifest, relativePath);
+        InvalidateSearchResults();
+    }
+
+    void Source::DisableBackgroundUpdate()
+    {
+        m_isBackgroundUpdateDisabled = true;
     }
 
     std::vector<SourceDetails> Source::Open(IProgressCallback& progress)
     {
         THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), m_isSourceToBeAdded || m_sourceReferences.empty());
 
+        Timing::Span span{ Timing::Phase::SourceOpen };
         std::vector<SourceDetails> result;
 
         if (!m_source)
@@ -490,31 +874,39 @@ namespace AppInstaller::Repository
             SourceList sourceList;
 
             // Check for updates before opening.
-            for (auto& sourceReference : m_sourceReferences)
+            std::vector<bool> updated(m_sourceReferences.size());
+            for (size_t i = 0; i < m_sourceReferences.size(); ++i)
             {
-                auto& details = sourceReference->GetDetails();
-                if (ShouldUpdateBeforeOpen(details))
+                auto& details = m_sourceReferences[i]->GetDetails();
+                if (!m_isBackgroundUpdateDisabled && ShouldUpdateBeforeOpen(details))
                 {
-                    try
+                    // A source that has been updated before is opened with the data that it has, so that the command does not wait for the update.
+                    // A source that never has been must be updated first, as it has no data to open.
+                    if (details.LastUpdateTime != Utility::ConvertUnixEpochToSystemClock(0))
                     {
-                        // TODO: Consider adding a context callback to indicate we are doing the same action
-                        // to avoid the progress bar fill up multiple times.
-                        if (BackgroundUpdateSourceFromDetails(details, progress))
+                        try
                         {
-                            auto detailsInternal = sourceList.GetSource(details.Name);
-                            detailsInternal->LastUpdateTime = details.LastUpdateTime;
-                            sourceList.SaveMetadata(*detailsInternal);
+                            Synchronization::CrossProcessClaim claim = TryClaimBackgroundUpdate(details);
+                            if (!claim)
+                            {
+                                AICLI_LOG(Repo, Info, << "Source is already being updated by another process: " << details.Name);
+                                continue;
+                            }
+
+                            StartBackgroundUpdate(details, std::move(claim));
+                            continue;
                         }
-                        else
+                        catch (...)
                         {
-                            AICLI_LOG(Repo, Error, << "Failed to update source: " << details.Name);
-                            result.emplace_back(details);
+                            LOG_CAUGHT_EXCEPTION();
+                            AICLI_LOG(Repo, Warning, << "Failed to start background update of source: " << details.Name);
                         }
                     }
-                    catch (...)
+
+                    updated[i] = true;
+
+                    if (!UpdateSourceAndSaveMetadata(details, sourceList, progress))
                     {
-                        LOG_CAUGHT_EXCEPTION();
-                        AICLI_LOG(Repo, Warning, << "Failed to update source: " << details.Name);
                         result.emplace_back(details);
                     }
                 }
@@ -524,16 +916,64 @@ namespace AppInstaller::Repository
             {
                 AICLI_LOG(Repo, Info, << "Multiple sources available, creating aggregated source.");
                 auto aggregatedSource = std::make_shared<CompositeSource>("*DefaultSource");
+
+                // The sources are opened concurrently. Each has a progress of its own, as they would interleave their reports,
+                // while the caller cancelling the open cancels all of them.
+                std::vector<std::unique_ptr<ProgressCallback>> openProgress;
+                for (size_t i = 0; i < m_sourceReferences.size(); ++i)
+                {
+                    openProgress.emplace_back(std::make_unique<ProgressCallback>());
+                }
+
+                auto cancelOpens = progress.SetCancellationFunction([&]()
+                    {
+                        for (auto& callback : openProgress)
+                        {
+                            callback->Cancel();
+                        }
+                    });
+
+                ThreadGlobals* parentThreadGlobals = ThreadGlobals::GetForCurrentThread();
+                std::vector<std::future<std::shared_ptr<ISource>>> opens;
+
+                for (size_t i = 0; i < m_sourceReferences.size(); ++i)
+                {
+                    std::shared_ptr<ThreadGlobals> threadGlobals;
+                    if (parentThreadGlobals)
+                    {
+                        threadGlobals = std::make_shared<ThreadGlobals>(*parentThreadGlobals, ThreadGlobals::create_sub_thread_globals_t{});
+                    }
+
+                    opens.emplace_back(std::async(std::launch::async, [sourceReference = m_sourceReferences[i], wasUpdated = static_cast<bool>(updated[i]), progress = openProgress[i].get(), threadGlobals]()
+                        {
+                            std::unique_ptr<PreviousThreadGlobals> previousThreadGlobals;
+                            if (threadGlobals)
+                            {
+                                previousThreadGlobals = threadGlobals->SetForCurrentThread();
+                            }
+
+                            return OpenSourceReference(*sourceReference, wasUpdated, *progress);
+                        }));
+                }
+
+                if (progress.IsCancelled())
+                {
+                    for (auto& callback : openProgress)
+                    {
+                        callback->Cancel();
+                    }
+                }
+
                 std::vector<std::shared_ptr<OpenExceptionProxy>> openExceptionProxies;
 
-                for (auto& sourceReference : m_sourceReferences)
+                for (size_t i = 0; i < opens.size(); ++i)
                 {
+                    auto& sourceReference = m_sourceReferences[i];
                     AICLI_LOG(Repo, Info, << "Adding to aggregated source: " << sourceReference->GetDetails().Name);
 
                     try
-
                     {
-                        aggregatedSource->AddAvailableSource(sourceReference->Open(progress));
+                        aggregatedSource->AddAvailableSource(opens[i].get());
                     }
                     catch (...)
                     {
@@ -556,8 +996,10 @@ namespace AppInstaller::Repository
             }
             else
             {
-                m_source = m_sourceReferences[0]->Open(progress);
+                m_source = OpenSourceReference(*m_sourceReferences[0], updated[0], progress);
             }
+
+            m_searchCache = CreateSearchCache();
         }
 
         return result;
@@ -603,40 +1045,127 @@ namespace AppInstaller::Repository
     {
         THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), m_isSourceToBeAdded || m_source || m_sourceReferences.empty());
 
+        std::vector<const SourceDetails*> updated;
+        std::vector<SourceDetails> result;
+
+        for (auto& sourceReference : m_sourceReferences)
+        {
+            // TODO: Consider adding a context callback to indicate we are doing the same action
+            // to avoid the progress bar fill up multiple times.
+            if (UpdateSourceReference(*sourceReference, progress))
+            {
+                updated.emplace_back(&sourceReference->GetDetails());
+            }
+            else
+            {
+                result.emplace_back(sourceReference->GetDetails());
+            }
+        }
+
+        SaveUpdatedMetadata(updated);
+
+        return result;
+    }
+
+    std::vector<SourceDetails> Source::RunBackgroundUpdate(IProgressCallback& progress)
+    {
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), m_isSourceToBeAdded || m_source || m_sourceReferences.empty());
+
         SourceList sourceList;
         std::vector<SourceDetails> result;
 
+        for (auto& sourceReference : m_sourceReferences)
+        {
+            SourceDetails details = sourceReference->GetDetails();
+
+            // Another process may have updated the source since this update was started.
+            if (!ShouldUpdateBeforeOpen(details))
+            {
+                AICLI_LOG(Repo, Info, << "Source no longer needs a background update: " << details.Name);
+                continue;
+            }
+
+            Synchronization::CrossProcessClaim claim = TryClaimBackgroundUpdate(details);
+            if (!claim)
+            {
+                AICLI_LOG(Repo, Info, << "Source is already being updated by another process: " << details.Name);
+                continue;
+            }
+
+            if (!UpdateSourceAndSaveMetadata(details, sourceList, progress))
+            {
+                claim.Abandon();
+                result.emplace_back(std::move(details));
+            }
+        }
+
+        return result;
+    }
+
+    std::vector<SourceDetails> Source::UpdateConcurrently(
+        const std::function<IProgressCallback&(const SourceDetails&)>& getProgress,
+        const std::function<void(const SourceDetails&, bool)>& onComplete)
+    {
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), m_isSourceToBeAdded || m_source || m_sourceReferences.empty());
+
         for (auto& sourceReference : m_sourceReferences)
         {
             THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), !ContainsAvailablePackagesInternal(sourceReference->GetDetails().Origin));
+        }
 
-            auto& details = sourceReference->GetDetails();
-            AICLI_LOG(Repo, Info, << "Named source to be updated, found: " << details.Name);
+        std::vector<IProgressCallback*> progressCallbacks;
+        for (auto& sourceReference : m_sourceReferences)
+        {
+            progressCallbacks.emplace_back(&getProgress(sourceReference->GetDetails()));
+        }
 
-            try
+        ThreadGlobals* parentThreadGlobals = ThreadGlobals::GetForCurrentThread();
+        std::vector<std::future<bool>> updates;
+
+        for (size_t i = 0; i < m_sourceReferences.size(); ++i)
+        {
+            std::shared_ptr<ThreadGlobals> threadGlobals;
+            if (parentThreadGlobals)
             {
-                // TODO: Consider adding a context callback to indicate we are doing the same action
-                // to avoid the progress bar fill up multiple times.
-                if (UpdateSourceFromDetails(details, progress))
-                {
-                    auto detailsInternal = sourceList.GetSource(details.Name);
-                    detailsInternal->LastUpdateTime = details.LastUpdateTime;
-                    sourceList.SaveMetadata(*detailsInternal);
-                }
-                else
+                threadGlobals = std::make_shared<ThreadGlobals>(*parentThreadGlobals, ThreadGlobals::create_sub_thread_globals_t{});
+            }
+
+            updates.emplace_back(std::async(std::launch::async, [sourceReference = m_sourceReferences[i], progress = progressCallbacks[i], threadGlobals, &onComplete]()
                 {
-                    AICLI_LOG(Repo, Error, << "Failed to update source: " << details.Name);
-                    result.emplace_back(details);
-                }
+                    std::unique_ptr<PreviousThreadGlobals> previousThreadGlobals;
+                    if (threadGlobals)
+                    {
+                        previousThreadGlobals = threadGlobals->SetForCurrentThread();
+                    }
+
+                    bool updated = UpdateSourceReference(*sourceReference, *progress);
+                    if (onComplete)
+                    {
+                        onComplete(sourceReference->GetDetails(), updated);
+                    }
+
+                    return updated;
+                }));
+        }
+
+        // Every update is waited for before the metadata is written, so that the writes are not interleaved with them.
+        std::vector<const SourceDetails*> updated;
+        std::vector<SourceDetails> result;
+
+        for (size_t i = 0; i < updates.size(); ++i)
+        {
+            if (updates[i].get())
+            {
+                updated.emplace_back(&m_sourceReferences[i]->GetDetails());
             }
-            catch (...)
+            else
             {
-                LOG_CAUGHT_EXCEPTION();
-                AICLI_LOG(Repo, Error, << "Failed to update source: " << details.Name);
-                result.emplace_back(details);
+                result.emplace_back(m_sourceReferences[i]->GetDetails());
             }
         }
 
+        SaveUpdatedMetadata(updated);
+
         return result;
     }
 
@@ -682,6 +1211,23 @@ namespace AppInstaller::Repository
         return result;
     }
 
+    void Source::SetBackgroundUpdateHandler(std::function<void(const SourceDetails&)> handler)
+    {
+        s_BackgroundUpdateHandler = std::move(handler);
+    }
+
+    void Source::WaitForBackgroundUpdates()
+    {
+        BackgroundUpdates& updates = GetBackgroundUpdates();
+        std::unique_lock<std::mutex> lock{ updates.Lock };
+
+        if (updates.Running)
+        {
+            AICLI_LOG(Repo, Info, << "Waiting for " << updates.Running << " background source updates to finish");
+            updates.Changed.wait(lock, [&]() { return updates.Running == 0; });
+        }
+    }
+
     bool Source::DropSource(std::string_view name)
     {
         if (name.empty())
@@ -4,11 +4,13 @@
 #include "RestClient.h"
 #include "Rest/Schema/1_0/Interface.h"
 #include "Rest/Schema/1_1/Interface.h"
+#include "Rest/Schema/1_2/Interface.h"
 #include "Rest/Schema/HttpClientHelper.h"
 #include "Rest/Schema/InformationResponseDeserializer.h"
 #include "Rest/Schema/JsonHelper.h"
 #include "Rest/Schema/CommonRestConstants.h"
 #include "Rest/Schema/RestHelper.h"
+#include <winget/AllocationTracking.h>
 
 using namespace AppInstaller::Repository::Rest::Schema;
 using namespace AppInstaller::Repository::Rest::Schema::V1_0;
@@ -17,7 +19,7 @@ using namespace AppInstaller::Utility;
 namespace AppInstaller::Repository::Rest
 {
     // Supported versions
-    std::set<Version> WingetSupportedContracts = { Version_1_0_0, Version_1_1_0 };
+    std::set<Version> WingetSupportedContracts = { Version_1_0_0, Version_1_1_0, Version_1_2_0 };
 
     constexpr std::string_view WindowsPackageManagerHeader = "Windows-Package-Manager"sv;
     constexpr size_t WindowsPackageManagerHeaderMaxLength = 1024;
@@ -46,12 +48,25 @@ namespace AppInstaller::Repository::Rest
 
     std::optional<Manifest::Manifest> RestClient::GetManifestByVersion(const std::string& packageId, const std::string& version, const std::string& channel) const
     {
+        Memory::AllocationScope allocationScope{ Memory::AllocationSubsystem::RestJson };
         return m_interface->GetManifestByVersion(packageId, version, channel);
     }
 
-    IRestClient::SearchResult RestClient::Search(const SearchRequest& request) const
+    bool RestClient::SupportsManifestBatch() const
     {
-        return m_interface->Search(request);
+        return m_interface->SupportsManifestBatch();
+    }
+
+    std::vector<std::optional<Manifest::Manifest>> RestClient::GetManifestsByVersion(const std::vector<IRestClient::ManifestKey>& keys) const
+    {
+        Memory::AllocationScope allocationScope{ Memory::AllocationSubsystem::RestJson };
+        return m_interface->GetManifestsByVersion(keys);
+    }
+
+    IRestClient::SearchResult RestClient::Search(const SearchRequest& request, bool deferVersions) const
+    {
+        Memory::AllocationScope allocationScope{ Memory::AllocationSubsystem::RestJson };
+        return m_interface->Search(request, deferVersions);
     }
 
     std::string RestClient::GetSourceIdentifier() const
@@ -120,15 +135,20 @@ namespace AppInstaller::Repository::Rest
         const std::string& api,
         const std::unordered_map<utility::string_t, utility::string_t>& additionalHeaders,
         const IRestClient::Information& information,
-        const Version& version)
+        const Version& version,
+        const HttpClientHelper& helper)
     {
         if (version == Version_1_0_0)
         {
-            return std::make_unique<Schema::V1_0::Interface>(api);
+            return std::make_unique<Schema::V1_0::Interface>(api, helper);
         }
         else if (version == Version_1_1_0)
         {
-            return std::make_unique<Schema::V1_1::Interface>(api, information, additionalHeaders);
+            return std::make_unique<Schema::V1_1::Interface>(api, information, additionalHeaders, helper);
+        }
+        else if (version == Version_1_2_0)
+        {
+            return std::make_unique<Schema::V1_2::Interface>(api, information, additionalHeaders, helper);
         }
 
         THROW_HR(APPINSTALLER_CLI_ERROR_RESTSOURCE_INVALID_VERSION);
@@ -141,11 +161,21 @@ namespace AppInstaller::Repository::Rest
 
         auto headers = GetHeaders(customHeader);
 
-        IRestClient::Information information = GetInformation(restEndpoint, headers, helper);
+        // The responses are cached on disk, so that opening the source again and getting the same manifests again
+        // can be served locally or with a conditional request.
+        std::shared_ptr<HttpResponseCache> responseCache = HttpResponseCache::GetDefault();
+
+        HttpClientHelper informationHelper = helper;
+        informationHelper.SetResponseCache(responseCache);
+
+        IRestClient::Information information = GetInformation(restEndpoint, headers, informationHelper);
         std::optional<Version> latestCommonVersion = GetLatestCommonVersion(information.ServerSupportedVersions, WingetSupportedContracts);
         THROW_HR_IF(APPINSTALLER_CLI_ERROR_UNSUPPORTED_RESTSOURCE, !latestCommonVersion);
 
-        std::unique_ptr<Schema::IRestClient> supportedInterface = GetSupportedInterface(utility::conversions::to_utf8string(restEndpoint), headers, information, latestCommonVersion.value());
+        HttpClientHelper interfaceHelper;
+        interfaceHelper.SetResponseCache(responseCache);
+
+        std::unique_ptr<Schema::IRestClient> supportedInterface = GetSupportedInterface(utility::conversions::to_utf8string(restEndpoint), headers, information, latestCommonVersion.value(), interfaceHelper);
         return RestClient{ std::move(supportedInterface), information.SourceIdentifier };
     }
 }
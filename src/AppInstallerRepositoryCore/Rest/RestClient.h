@@ -19,10 +19,15 @@ namespace AppInstaller::Repository::Rest
         RestClient& operator=(RestClient&&) = default;
 
         // Performs a search based on the given criteria.
-        Schema::IRestClient::SearchResult Search(const SearchRequest& request) const;
+        Schema::IRestClient::SearchResult Search(const SearchRequest& request, bool deferVersions = false) const;
 
         std::optional<Manifest::Manifest> GetManifestByVersion(const std::string& packageId, const std::string& version, const std::string& channel) const;
 
+        // Gets whether GetManifestsByVersion retrieves the manifests with a single request rather than one request per manifest.
+        bool SupportsManifestBatch() const;
+
+        std::vector<std::optional<Manifest::Manifest>> GetManifestsByVersion(const std::vector<Schema::IRestClient::ManifestKey>& keys) const;
+
         std::string GetSourceIdentifier() const;
 
         Schema::IRestClient::Information GetSourceInformation() const;
@@ -31,7 +36,7 @@ namespace AppInstaller::Repository::Rest
 
         static Schema::IRestClient::Information GetInformation(const utility::string_t& restApi, const std::unordered_map<utility::string_t, utility::string_t>& additionalHeaders, const Schema::HttpClientHelper& httpClientHelper);
 
-        static std::unique_ptr<Schema::IRestClient> GetSupportedInterface(const std::string& restApi, const std::unordered_map<utility::string_t, utility::string_t>& additionalHeaders, const Schema::IRestClient::Information& information, const AppInstaller::Utility::Version& version);
+        static std::unique_ptr<Schema::IRestClient> GetSupportedInterface(const std::string& restApi, const std::unordered_map<utility::string_t, utility::string_t>& additionalHeaders, const Schema::IRestClient::Information& information, const AppInstaller::Utility::Version& version, const Schema::HttpClientHelper& helper = {});
 
         static RestClient Create(const std::string& restApi, std::optional<std::string> customHeader, const Schema::HttpClientHelper& helper = {});
     private:
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "RestSource.h"
+#include <winget/Timing.h>
 
 using namespace AppInstaller::Utility;
 
@@ -29,11 +30,30 @@ namespace AppInstaller::Repository::Rest
             std::weak_ptr<RestSource> m_source;
         };
 
+        struct AvailablePackage;
+
+        // The packages from a single search, which get the manifests for their latest versions with a single request
+        // the first time that any of them needs a manifest.
+        struct ManifestBatch
+        {
+            void Add(const std::shared_ptr<AvailablePackage>& package)
+            {
+                m_packages.emplace_back(package);
+            }
+
+            // Gets the manifests for the latest version of every package that does not already have it; only done once.
+            void Prefetch(const RestClient& restClient);
+
+        private:
+            std::once_flag m_prefetched;
+            std::vector<std::weak_ptr<AvailablePackage>> m_packages;
+        };
+
         // The IPackage implementation for Available packages from RestSource.
         struct AvailablePackage : public std::enable_shared_from_this<AvailablePackage>, public SourceReference, public IPackage
         {
-            AvailablePackage(const std::shared_ptr<RestSource>& source, IRestClient::Package&& package) :
-                SourceReference(source), m_package(std::move(package))
+            AvailablePackage(const std::shared_ptr<RestSource>& source, IRestClient::Package&& package, std::shared_ptr<ManifestBatch> manifestBatch = {}) :
+                SourceReference(source), m_package(std::move(package)), m_manifestBatch(std::move(manifestBatch))
             {
                 SortVersionsInternal();
             }
@@ -61,6 +81,7 @@ namespace AppInstaller::Repository::Rest
             {
                 std::shared_ptr<const RestSource> source = GetReferenceSource();
                 std::scoped_lock versionsLock{ m_packageVersionsLock };
+                EnsureAllVersionsInternal();
 
                 std::vector<PackageVersionKey> result;
                 for (const auto& versionInfo : m_package.Versions)
@@ -72,6 +93,23 @@ namespace AppInstaller::Repository::Rest
                 return result;
             }
 
+            std::vector<PackageVersionKey> GetLatestAvailableVersionKeys(size_t count) const override
+            {
+                std::shared_ptr<const RestSource> source = GetReferenceSource();
+                std::scoped_lock versionsLock{ m_packageVersionsLock };
+                EnsureAllVersionsInternal();
+
+                std::vector<PackageVersionKey> result;
+                for (size_t i = 0; i < m_package.Versions.size() && i < count; ++i)
+                {
+                    const auto& versionInfo = m_package.Versions[i];
+                    result.emplace_back(
+                        source->GetIdentifier(), versionInfo.VersionAndChannel.GetVersion().ToString(), versionInfo.VersionAndChannel.GetChannel().ToString());
+                }
+
+                return result;
+            }
+
             std::shared_ptr<IPackageVersion> GetLatestAvailableVersion() const override
             {
                 std::scoped_lock versionsLock{ m_packageVersionsLock };
@@ -114,6 +152,8 @@ namespace AppInstaller::Repository::Rest
                 if (versionInfo.VersionAndChannel.GetVersion().IsUnknown() && !versionInfo.Manifest)
                 {
                     std::scoped_lock versionsLock{ m_packageVersionsLock };
+                    EnsureAllVersionsInternal();
+
                     if (m_package.Versions.size() == 1 && m_package.Versions[0].VersionAndChannel.GetVersion().IsUnknown() && !m_package.Versions[0].Manifest)
                     {
                         SearchRequest request;
@@ -153,6 +193,63 @@ namespace AppInstaller::Repository::Rest
                 return false;
             }
 
+            // When the package shares a manifest batch with the other packages from its search, gets the manifests for
+            // all of them and updates the calling version if its manifest was included.
+            bool HandleManifestBatch(IRestClient::VersionInfo& versionInfo)
+            {
+                if (!m_manifestBatch || versionInfo.Manifest)
+                {
+                    return false;
+                }
+
+                m_manifestBatch->Prefetch(GetReferenceSource()->GetRestClient());
+
+                std::string version = versionInfo.VersionAndChannel.GetVersion().ToString();
+                std::string channel = versionInfo.VersionAndChannel.GetChannel().ToString();
+
+                std::scoped_lock versionsLock{ m_packageVersionsLock };
+                for (const auto& available : m_package.Versions)
+                {
+                    if (available.Manifest &&
+                        available.VersionAndChannel.GetVersion().ToString() == version &&
+                        available.VersionAndChannel.GetChannel().ToString() == channel)
+                    {
+                        versionInfo.Manifest = available.Manifest;
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            // Gets the key of the latest version if its manifest has not been retrieved yet.
+            std::optional<IRestClient::ManifestKey> GetLatestVersionManifestKey() const
+            {
+                std::scoped_lock versionsLock{ m_packageVersionsLock };
+
+                if (m_package.Versions.empty() || m_package.Versions.front().Manifest || m_package.Versions.front().VersionAndChannel.GetVersion().IsUnknown())
+                {
+                    return {};
+                }
+
+                const auto& latest = m_package.Versions.front().VersionAndChannel;
+                return IRestClient::ManifestKey{ m_package.PackageInformation.PackageIdentifier, latest.GetVersion().ToString(), latest.GetChannel().ToString() };
+            }
+
+            void SetManifest(const IRestClient::ManifestKey& key, Manifest::Manifest&& manifest)
+            {
+                std::scoped_lock versionsLock{ m_packageVersionsLock };
+                for (auto& available : m_package.Versions)
+                {
+                    if (available.VersionAndChannel.GetVersion().ToString() == key.Version &&
+                        available.VersionAndChannel.GetChannel().ToString() == key.Channel)
+                    {
+                        available.Manifest = std::move(manifest);
+                        return;
+                    }
+                }
+            }
+
         private:
             std::shared_ptr<AvailablePackage> NonConstSharedFromThis() const
             {
@@ -162,8 +259,37 @@ namespace AppInstaller::Repository::Rest
             // Must hold m_packageVersionsLock while calling this
             std::shared_ptr<IPackageVersion> GetLatestVersionInternal() const;
 
+            // Deserializes the versions that were deferred by the search, keeping any manifests already retrieved.
             // Must hold m_packageVersionsLock while calling this
-            void SortVersionsInternal()
+            void EnsureAllVersionsInternal() const
+            {
+                if (!m_package.DeferredVersions)
+                {
+                    return;
+                }
+
+                std::vector<IRestClient::VersionInfo> versions = m_package.DeferredVersions();
+                m_package.DeferredVersions = nullptr;
+
+                for (auto& version : versions)
+                {
+                    for (auto& existing : m_package.Versions)
+                    {
+                        if (existing.Manifest &&
+                            existing.VersionAndChannel.GetVersion().ToString() == version.VersionAndChannel.GetVersion().ToString() &&
+                            existing.VersionAndChannel.GetChannel().ToString() == version.VersionAndChannel.GetChannel().ToString())
+                        {
+                            version.Manifest = std::move(existing.Manifest);
+                        }
+                    }
+                }
+
+                m_package.Versions = std::move(versions);
+                SortVersionsInternal();
+            }
+
+            // Must hold m_packageVersionsLock while calling this
+            void SortVersionsInternal() const
             {
                 std::sort(m_package.Versions.begin(), m_package.Versions.end(),
                     [](const IRestClient::VersionInfo& a, const IRestClient::VersionInfo& b)
@@ -172,11 +298,58 @@ namespace AppInstaller::Repository::Rest
                     });
             }
 
-            IRestClient::Package m_package;
+            // Mutable so that the deferred versions can be deserialized on first use.
+            mutable IRestClient::Package m_package;
             // Protects access to m_package.Versions
             mutable std::mutex m_packageVersionsLock;
+            std::shared_ptr<ManifestBatch> m_manifestBatch;
         };
 
+        void ManifestBatch::Prefetch(const RestClient& restClient)
+        {
+            std::call_once(m_prefetched, [&]()
+                {
+                    std::vector<std::shared_ptr<AvailablePackage>> packages;
+                    std::vector<IRestClient::ManifestKey> keys;
+
+                    for (const auto& weakPackage : m_packages)
+                    {
+                        std::shared_ptr<AvailablePackage> package = weakPackage.lock();
+                        std::optional<IRestClient::ManifestKey> key = package ? package->GetLatestVersionManifestKey() : std::nullopt;
+
+                        if (key)
+                        {
+                            packages.emplace_back(std::move(package));
+                            keys.emplace_back(std::move(key).value());
+                        }
+                    }
+
+                    if (keys.size() < 2)
+                    {
+                        return;
+                    }
+
+                    try
+                    {
+                        std::vector<std::optional<Manifest::Manifest>> manifests = restClient.GetManifestsByVersion(keys);
+
+                        for (size_t i = 0; i < packages.size() && i < manifests.size(); ++i)
+                        {
+                            if (manifests[i])
+                            {
+                                packages[i]->SetManifest(keys[i], std::move(manifests[i]).value());
+                            }
+                        }
+                    }
+                    catch (...)
+                    {
+                        // Any manifest that was not retrieved is requested individually.
+                        LOG_CAUGHT_EXCEPTION();
+                        AICLI_LOG(Repo, Warning, << "Failed to get the manifests for " << keys.size() << " packages in a batch");
+                    }
+                });
+        }
+
         // The IPackageVersion impl for RestSource.
         struct PackageVersion : public SourceReference, public IPackageVersion
         {
@@ -260,6 +433,7 @@ namespace AppInstaller::Repository::Rest
 
             Manifest::Manifest GetManifest() override
             {
+                Timing::Span span{ Timing::Phase::ManifestFetch };
                 AICLI_LOG(Repo, Verbose, << "Getting manifest");
 
                 if (m_versionInfo.Manifest)
@@ -273,8 +447,13 @@ namespace AppInstaller::Repository::Rest
                     return m_versionInfo.Manifest.value();
                 }
 
-                std::optional<Manifest::Manifest> manifest = GetReferenceSource()->GetRestClient().GetManifestByVersion(
-                    m_package->PackageInfo().PackageIdentifier, m_versionInfo.VersionAndChannel.GetVersion().ToString(), m_versionInfo.VersionAndChannel.GetChannel().ToString());
+                if (m_package->HandleManifestBatch(m_versionInfo))
+                {
+                    return m_versionInfo.Manifest.value();
+                }
+
+                IRestClient::ManifestKey key{ m_package->PackageInfo().PackageIdentifier, m_versionInfo.VersionAndChannel.GetVersion().ToString(), m_versionInfo.VersionAndChannel.GetChannel().ToString() };
+                std::optional<Manifest::Manifest> manifest = GetReferenceSource()->GetRestClient().GetManifestByVersion(key.PackageIdentifier, key.Version, key.Channel);
 
                 if (!manifest)
                 {
@@ -282,6 +461,9 @@ namespace AppInstaller::Repository::Rest
                     return {};
                 }
                 
+                // Keep the manifest in the package as well, so that later versions created from it (as after a prefetch) have it.
+                m_package->SetManifest(key, Manifest::Manifest{ manifest.value() });
+
                 m_versionInfo.Manifest = std::move(manifest.value());
                 return m_versionInfo.Manifest.value();
             }
@@ -331,6 +513,12 @@ namespace AppInstaller::Repository::Rest
                 return {};
             }
 
+            // Only the latest version is available without deserializing the others.
+            if (!versionKey.Version.empty() || !versionKey.Channel.empty())
+            {
+                EnsureAllVersionsInternal();
+            }
+
             std::shared_ptr<IPackageVersion> packageVersion;
             if (!versionKey.Version.empty() && !versionKey.Channel.empty())
             {
@@ -402,13 +590,27 @@ namespace AppInstaller::Repository::Rest
 
     SearchResult RestSource::Search(const SearchRequest& request) const
     {
-        IRestClient::SearchResult results = m_restClient.Search(request);
+        // Most packages from a search are only shown with their latest version, so the others are only deserialized when needed.
+        IRestClient::SearchResult results = m_restClient.Search(request, true);
         SearchResult searchResult;
 
+        // When a search returns many packages, such as when correlating the installed packages for an upgrade,
+        // their manifests are retrieved together rather than with one request per package.
+        std::shared_ptr<ManifestBatch> manifestBatch;
+        if (results.Matches.size() > 1 && m_restClient.SupportsManifestBatch())
+        {
+            manifestBatch = std::make_shared<ManifestBatch>();
+        }
+
         std::shared_ptr<RestSource> sharedThis = NonConstSharedFromThis();
         for (auto& result : results.Matches)
         {
-            std::shared_ptr<IPackage> package = std::make_shared<AvailablePackage>(sharedThis, std::move(result));
+            std::shared_ptr<AvailablePackage> package = std::make_shared<AvailablePackage>(sharedThis, std::move(result), manifestBatch);
+
+            if (manifestBatch)
+            {
+                manifestBatch->Add(package);
+            }
 
             // TODO: Improve to use Package match filter to return relevant search results.
             PackageMatchFilter packageFilter{ {}, {}, {} };
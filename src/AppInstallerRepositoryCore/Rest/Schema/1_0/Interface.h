@@ -20,29 +20,36 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0
 
         Utility::Version GetVersion() const override;
         IRestClient::Information GetSourceInformation() const override;
-        IRestClient::SearchResult Search(const SearchRequest& request) const override;
+        using IRestClient::Search;
+        IRestClient::SearchResult Search(const SearchRequest& request, bool deferVersions) const override;
         std::optional<Manifest::Manifest> GetManifestByVersion(const std::string& packageId, const std::string& version, const std::string& channel) const override;
         std::vector<Manifest::Manifest> GetManifests(const std::string& packageId, const std::map<std::string_view, std::string>& params = {}) const override;
+        bool SupportsManifestBatch() const override;
+        std::vector<std::optional<Manifest::Manifest>> GetManifestsByVersion(const std::vector<ManifestKey>& keys) const override;
 
     protected:
         bool MeetsOptimizedSearchCriteria(const SearchRequest& request) const;
         IRestClient::SearchResult OptimizedSearch(const SearchRequest& request) const;
-        IRestClient::SearchResult SearchInternal(const SearchRequest& request) const;
+        IRestClient::SearchResult SearchInternal(const SearchRequest& request, bool deferVersions) const;
 
         // Check query params against source information and update if necessary.
         virtual std::map<std::string_view, std::string> GetValidatedQueryParams(const std::map<std::string_view, std::string>& params) const;
 
         // Check search request against source information and get json search body.
-        virtual web::json::value GetValidatedSearchBody(const SearchRequest& searchRequest) const;
+        // Returns empty if nothing that the request selects can be asked of the rest source, so no package can match.
+        virtual std::optional<web::json::value> GetValidatedSearchBody(const SearchRequest& searchRequest) const;
 
-        virtual SearchResult GetSearchResult(const web::json::value& searchResponseObject) const;
+        virtual SearchResult GetSearchResult(const std::shared_ptr<const web::json::value>& searchResponseObject, bool deferVersions) const;
         virtual std::vector<Manifest::Manifest> GetParsedManifests(const web::json::value& manifestsResponseObject) const;
 
+        // Throws if any of the received manifests fails validation.
+        void ValidateReceivedManifests(const std::vector<Manifest::Manifest>& manifests) const;
+
         std::unordered_map<utility::string_t, utility::string_t> m_requiredRestApiHeaders;
+        std::string m_restApiUri;
+        HttpClientHelper m_httpClientHelper;
 
     private:
-        std::string m_restApiUri;
         utility::string_t m_searchEndpoint;
-        HttpClientHelper m_httpClientHelper;
     };
 }
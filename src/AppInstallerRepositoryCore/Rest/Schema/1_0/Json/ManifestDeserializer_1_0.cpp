@@ -143,7 +143,7 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0::Json
                 return {};
             }
 
-            const web::json::array versionNodes = versions.value().get();
+            const web::json::array& versionNodes = versions.value().get();
             for (auto& versionItem : versionNodes)
             {
                 Manifest::Manifest manifest;
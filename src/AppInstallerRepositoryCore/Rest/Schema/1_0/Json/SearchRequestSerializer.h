@@ -11,6 +11,10 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0::Json
     {
         web::json::value Serialize(const SearchRequest& searchRequest) const;
 
+        // Determines whether the serialized request still selects packages. A request that selects by a query
+        // or inclusions, none of which can be serialized, would otherwise be sent as a request for its filters alone.
+        bool CanSelectPackages(const SearchRequest& searchRequest) const;
+
     protected:
         std::optional<web::json::value> SerializeSearchRequest(const SearchRequest& searchRequest) const;
 
@@ -55,6 +55,22 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0::Json
         return result.value();
     }
 
+    bool SearchRequestSerializer::CanSelectPackages(const SearchRequest& searchRequest) const
+    {
+        if (!searchRequest.Query && searchRequest.Inclusions.empty())
+        {
+            return true;
+        }
+
+        if (searchRequest.Query && ConvertMatchTypeToString(searchRequest.Query->Type))
+        {
+            return true;
+        }
+
+        return std::any_of(searchRequest.Inclusions.begin(), searchRequest.Inclusions.end(),
+            [&](const PackageMatchFilter& inclusion) { return ConvertPackageMatchFieldToString(inclusion.Field) && ConvertMatchTypeToString(inclusion.Type); });
+    }
+
     std::optional<web::json::value> SearchRequestSerializer::SerializeSearchRequest(const SearchRequest& searchRequest) const
     {
         try
@@ -12,7 +12,12 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0::Json
         // Gets the search result for given version
         IRestClient::SearchResult Deserialize(const web::json::value& searchResultJsonObject) const;
 
+        // Gets the search result, deserializing only the latest version of each package now.
+        // The json object is kept alive until the remaining versions of every package are deserialized or released.
+        IRestClient::SearchResult DeserializeWithDeferredVersions(std::shared_ptr<const web::json::value> searchResultJsonObject) const;
+
     protected:
-        virtual std::optional<IRestClient::SearchResult> DeserializeSearchResult(const web::json::value& searchResultJsonObject) const;
+        virtual std::optional<IRestClient::SearchResult> DeserializeSearchResult(
+            const web::json::value& searchResultJsonObject, const std::shared_ptr<const web::json::value>& deferredVersionsOwner = {}) const;
     };
 }
@@ -20,6 +20,76 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0::Json
         constexpr std::string_view Versions = "Versions"sv;
         constexpr std::string_view PackageVersion = "PackageVersion"sv;
         constexpr std::string_view Channel = "Channel"sv;
+
+        std::optional<AppInstaller::Utility::VersionAndChannel> DeserializeVersionAndChannel(const web::json::value& versionItem, const std::string& packageId)
+        {
+            std::optional<std::string> version = JsonHelper::GetRawStringValueFromJsonNode(versionItem, JsonHelper::GetUtilityString(PackageVersion));
+            if (!JsonHelper::IsValidNonEmptyStringValue(version))
+            {
+                AICLI_LOG(Repo, Error, << "Received incomplete package version in package: " << packageId);
+                return {};
+            }
+
+            std::string channel = JsonHelper::GetRawStringValueFromJsonNode(versionItem, JsonHelper::GetUtilityString(Channel)).value_or("");
+            return AppInstaller::Utility::VersionAndChannel{ std::move(version.value()), std::move(channel) };
+        }
+
+        IRestClient::VersionInfo DeserializeVersionInfo(const web::json::value& versionItem, AppInstaller::Utility::VersionAndChannel&& versionAndChannel)
+        {
+            std::vector<std::string> packageFamilyNames = RestHelper::GetUniqueItems(JsonHelper::GetRawStringArrayFromJsonNode(versionItem, JsonHelper::GetUtilityString(PackageFamilyNames)));
+            std::vector<std::string> productCodes = RestHelper::GetUniqueItems(JsonHelper::GetRawStringArrayFromJsonNode(versionItem, JsonHelper::GetUtilityString(ProductCodes)));
+
+            return IRestClient::VersionInfo{ std::move(versionAndChannel), {}, std::move(packageFamilyNames), std::move(productCodes) };
+        }
+
+        std::optional<std::vector<IRestClient::VersionInfo>> DeserializeVersions(const web::json::array& versionItems, const std::string& packageId)
+        {
+            std::vector<IRestClient::VersionInfo> versionList;
+
+            for (auto& versionItem : versionItems)
+            {
+                std::optional<AppInstaller::Utility::VersionAndChannel> versionAndChannel = DeserializeVersionAndChannel(versionItem, packageId);
+                if (!versionAndChannel)
+                {
+                    return {};
+                }
+
+                versionList.emplace_back(DeserializeVersionInfo(versionItem, std::move(versionAndChannel).value()));
+            }
+
+            return versionList;
+        }
+
+        // Deserializes only the version that sorts first, which is the latest; the other versions are checked for
+        // their version and channel so that the search fails on bad data just as it does when deserializing all of them.
+        std::optional<std::vector<IRestClient::VersionInfo>> DeserializeLatestVersion(const web::json::array& versionItems, const std::string& packageId)
+        {
+            const web::json::value* latestItem = nullptr;
+            std::optional<AppInstaller::Utility::VersionAndChannel> latest;
+
+            for (auto& versionItem : versionItems)
+            {
+                std::optional<AppInstaller::Utility::VersionAndChannel> versionAndChannel = DeserializeVersionAndChannel(versionItem, packageId);
+                if (!versionAndChannel)
+                {
+                    return {};
+                }
+
+                if (!latest || versionAndChannel.value() < latest.value())
+                {
+                    latest = std::move(versionAndChannel);
+                    latestItem = &versionItem;
+                }
+            }
+
+            std::vector<IRestClient::VersionInfo> versionList;
+            if (latestItem)
+            {
+                versionList.emplace_back(DeserializeVersionInfo(*latestItem, std::move(latest).value()));
+            }
+
+            return versionList;
+        }
     }
 
     IRestClient::SearchResult SearchResponseDeserializer::Deserialize(const web::json::value& searchResponseObject) const
@@ -31,7 +101,19 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0::Json
         return response.value();
     }
 
-    std::optional<IRestClient::SearchResult> SearchResponseDeserializer::DeserializeSearchResult(const web::json::value& searchResponseObject) const
+    IRestClient::SearchResult SearchResponseDeserializer::DeserializeWithDeferredVersions(std::shared_ptr<const web::json::value> searchResponseObject) const
+    {
+        THROW_HR_IF(E_INVALIDARG, !searchResponseObject);
+
+        std::optional<IRestClient::SearchResult> response = DeserializeSearchResult(*searchResponseObject, searchResponseObject);
+
+        THROW_HR_IF(APPINSTALLER_CLI_ERROR_RESTSOURCE_INVALID_DATA, !response);
+
+        return response.value();
+    }
+
+    std::optional<IRestClient::SearchResult> SearchResponseDeserializer::DeserializeSearchResult(
+        const web::json::value& searchResponseObject, const std::shared_ptr<const web::json::value>& deferredVersionsOwner) const
     {
         // Make search result from json output.
         if (searchResponseObject.is_null())
@@ -67,22 +149,16 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0::Json
 
                 if (versionValue)
                 {
-                    for (auto& versionItem : versionValue.value().get())
+                    std::optional<std::vector<IRestClient::VersionInfo>> versions = deferredVersionsOwner ?
+                        DeserializeLatestVersion(versionValue.value().get(), packageId.value()) :
+                        DeserializeVersions(versionValue.value().get(), packageId.value());
+
+                    if (!versions)
                     {
-                        std::optional<std::string> version = JsonHelper::GetRawStringValueFromJsonNode(versionItem, JsonHelper::GetUtilityString(PackageVersion));
-                        if (!JsonHelper::IsValidNonEmptyStringValue(version))
-                        {
-                            AICLI_LOG(Repo, Error, << "Received incomplete package version in package: " << packageId.value());
-                            return {};
-                        }
-
-                        std::string channel = JsonHelper::GetRawStringValueFromJsonNode(versionItem, JsonHelper::GetUtilityString(Channel)).value_or("");
-                        std::vector<std::string> packageFamilyNames = RestHelper::GetUniqueItems(JsonHelper::GetRawStringArrayFromJsonNode(versionItem, JsonHelper::GetUtilityString(PackageFamilyNames)));
-                        std::vector<std::string> productCodes = RestHelper::GetUniqueItems(JsonHelper::GetRawStringArrayFromJsonNode(versionItem, JsonHelper::GetUtilityString(ProductCodes)));
-
-                        versionList.emplace_back(IRestClient::VersionInfo{
-                                AppInstaller::Utility::VersionAndChannel{std::move(version.value()), std::move(channel)}, {}, std::move(packageFamilyNames), std::move(productCodes)});
+                        return {};
                     }
+
+                    versionList = std::move(versions).value();
                 }
 
                 if (versionList.size() == 0)
@@ -94,6 +170,17 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0::Json
                 IRestClient::PackageInfo packageInfo{
                         std::move(packageId.value()), std::move(packageName.value()), std::move(publisher.value()) };
                 IRestClient::Package package{ std::move(packageInfo), std::move(versionList) };
+
+                if (deferredVersionsOwner)
+                {
+                    package.DeferredVersions = [owner = deferredVersionsOwner, versionItems = &versionValue.value().get(), packageId = package.PackageInformation.PackageIdentifier]()
+                    {
+                        std::optional<std::vector<IRestClient::VersionInfo>> versions = DeserializeVersions(*versionItems, packageId);
+                        THROW_HR_IF(APPINSTALLER_CLI_ERROR_RESTSOURCE_INVALID_DATA, !versions);
+                        return std::move(versions).value();
+                    };
+                }
+
                 result.Matches.emplace_back(std::move(package));
             }
 
@@ -59,7 +59,7 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0
         return {};
     }
 
-    IRestClient::SearchResult Interface::Search(const SearchRequest& request) const
+    IRestClient::SearchResult Interface::Search(const SearchRequest& request, bool deferVersions) const
     {
         // Optimization
         if (MeetsOptimizedSearchCriteria(request))
@@ -67,28 +67,65 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0
             return OptimizedSearch(request);
         }
 
-        return SearchInternal(request);
+        return SearchInternal(request, deferVersions);
     }
 
-    IRestClient::SearchResult Interface::SearchInternal(const SearchRequest& request) const
+    IRestClient::SearchResult Interface::SearchInternal(const SearchRequest& request, bool deferVersions) const
     {
         SearchResult results;
         utility::string_t continuationToken;
         std::unordered_map<utility::string_t, utility::string_t> searchHeaders = m_requiredRestApiHeaders;
-        do
+        std::optional<web::json::value> validatedSearchBody = GetValidatedSearchBody(request);
+
+        if (!validatedSearchBody)
         {
-            if (!continuationToken.empty())
+            AICLI_LOG(Repo, Info, << "Search request selects only by fields the rest source cannot search; not sending it");
+            return results;
+        }
+
+        const web::json::value& searchBody = validatedSearchBody.value();
+
+        // The request for the next page is sent as soon as its continuation token is known, rather than after
+        // the current page has been deserialized, so that there is always one page in flight.
+        std::optional<pplx::task<web::http::http_response>> pendingPage = m_httpClientHelper.Post(m_searchEndpoint, searchBody, searchHeaders);
+
+        auto waitForAbandonedPage = wil::scope_exit([&]()
             {
-                AICLI_LOG(Repo, Verbose, << "Received continuation token. Retrieving more results.");
-                searchHeaders.insert_or_assign(JsonHelper::GetUtilityString(ContinuationToken), continuationToken);
-            }
+                if (pendingPage)
+                {
+                    // The task must be observed even though its result is no longer needed.
+                    try
+                    {
+                        pendingPage->wait();
+                    }
+                    catch (...) {}
+                }
+            });
+
+        while (pendingPage)
+        {
+            pplx::task<web::http::http_response> currentPage = std::move(pendingPage).value();
+            pendingPage.reset();
 
-            std::optional<web::json::value> jsonObject = m_httpClientHelper.HandlePost(m_searchEndpoint, GetValidatedSearchBody(request), searchHeaders);
+            std::optional<web::json::value> jsonObject = m_httpClientHelper.HandleResponse(currentPage);
 
             utility::string_t ct;
             if (jsonObject)
             {
-                SearchResult currentResult = GetSearchResult(jsonObject.value());
+                ct = RestHelper::GetContinuationToken(jsonObject.value()).value_or(L"");
+
+                // Every item in the page becomes a match, so the page size tells whether the next page will be needed.
+                std::optional<std::reference_wrapper<const web::json::array>> dataArray = JsonHelper::GetRawJsonArrayFromJsonNode(jsonObject.value(), JsonHelper::GetUtilityString(Data));
+                size_t pageSize = dataArray ? dataArray.value().get().size() : 0;
+
+                if (!ct.empty() && (!request.MaximumResults || results.Matches.size() + pageSize < request.MaximumResults))
+                {
+                    AICLI_LOG(Repo, Verbose, << "Received continuation token. Retrieving more results.");
+                    searchHeaders.insert_or_assign(JsonHelper::GetUtilityString(ContinuationToken), ct);
+                    pendingPage = m_httpClientHelper.Post(m_searchEndpoint, searchBody, searchHeaders);
+                }
+
+                SearchResult currentResult = GetSearchResult(std::make_shared<const web::json::value>(std::move(jsonObject).value()), deferVersions);
 
                 size_t insertElements = !request.MaximumResults ? currentResult.Matches.size() :
                     std::min(currentResult.Matches.size(), request.MaximumResults - results.Matches.size());
@@ -99,12 +136,10 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0
                 }
 
                 std::move(currentResult.Matches.begin(), std::next(currentResult.Matches.begin(), insertElements), std::inserter(results.Matches, results.Matches.end()));
-                ct = RestHelper::GetContinuationToken(jsonObject.value()).value_or(L"");
             }
 
             continuationToken = ct;
-
-        } while (!continuationToken.empty() && (!request.MaximumResults || results.Matches.size() < request.MaximumResults));
+        }
 
         if (!continuationToken.empty())
         {
@@ -228,10 +263,32 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0
         }
 
         // Parse json and return Manifests
-        std::vector<Manifest::Manifest> manifests = GetParsedManifests(jsonObject.value());
+        results = GetParsedManifests(jsonObject.value());
+        ValidateReceivedManifests(results);
+
+        return results;
+    }
 
-        // Manifest validation
-        for (auto& manifestItem : manifests)
+    bool Interface::SupportsManifestBatch() const
+    {
+        return false;
+    }
+
+    std::vector<std::optional<Manifest::Manifest>> Interface::GetManifestsByVersion(const std::vector<ManifestKey>& keys) const
+    {
+        std::vector<std::optional<Manifest::Manifest>> results;
+
+        for (const auto& key : keys)
+        {
+            results.emplace_back(GetManifestByVersion(key.PackageIdentifier, key.Version, key.Channel));
+        }
+
+        return results;
+    }
+
+    void Interface::ValidateReceivedManifests(const std::vector<Manifest::Manifest>& manifests) const
+    {
+        for (const auto& manifestItem : manifests)
         {
             std::vector<AppInstaller::Manifest::ValidationError> validationErrors =
                 AppInstaller::Manifest::ValidateManifest(manifestItem, false);
@@ -247,11 +304,7 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0
             }
 
             THROW_HR_IF(APPINSTALLER_CLI_ERROR_RESTSOURCE_INVALID_DATA, errors > 0);
-
-            results.emplace_back(manifestItem);
         }
-
-        return results;
     }
 
     std::map<std::string_view, std::string> Interface::GetValidatedQueryParams(const std::map<std::string_view, std::string>& params) const
@@ -259,16 +312,28 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0
         return params;
     }
 
-    web::json::value Interface::GetValidatedSearchBody(const SearchRequest& searchRequest) const
+    std::optional<web::json::value> Interface::GetValidatedSearchBody(const SearchRequest& searchRequest) const
     {
         SearchRequestSerializer serializer;
+
+        if (!serializer.CanSelectPackages(searchRequest))
+        {
+            return {};
+        }
+
         return serializer.Serialize(searchRequest);
     }
 
-    IRestClient::SearchResult Interface::GetSearchResult(const web::json::value& searchResponseObject) const
+    IRestClient::SearchResult Interface::GetSearchResult(const std::shared_ptr<const web::json::value>& searchResponseObject, bool deferVersions) const
     {
         SearchResponseDeserializer searchResponseDeserializer;
-        return searchResponseDeserializer.Deserialize(searchResponseObject);
+
+        if (deferVersions)
+        {
+            return searchResponseDeserializer.DeserializeWithDeferredVersions(searchResponseObject);
+        }
+
+        return searchResponseDeserializer.Deserialize(*searchResponseObject);
     }
 
     std::vector<Manifest::Manifest> Interface::GetParsedManifests(const web::json::value& manifestsResponseObject) const
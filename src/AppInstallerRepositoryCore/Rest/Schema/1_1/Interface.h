@@ -24,9 +24,9 @@ namespace AppInstaller::Repository::Rest::Schema::V1_1
         std::map<std::string_view, std::string> GetValidatedQueryParams(const std::map<std::string_view, std::string>& params) const override;
 
         // Check search request against source information and get json search body.
-        web::json::value GetValidatedSearchBody(const SearchRequest& searchRequest) const override;
+        std::optional<web::json::value> GetValidatedSearchBody(const SearchRequest& searchRequest) const override;
 
-        SearchResult GetSearchResult(const web::json::value& searchResponseObject) const override;
+        SearchResult GetSearchResult(const std::shared_ptr<const web::json::value>& searchResponseObject, bool deferVersions) const override;
         std::vector<Manifest::Manifest> GetParsedManifests(const web::json::value& manifestsResponseObject) const override;
 
         PackageMatchField ConvertStringToPackageMatchField(std::string_view field) const;
@@ -82,7 +82,7 @@ namespace AppInstaller::Repository::Rest::Schema::V1_1
         return result;
     }
 
-    web::json::value Interface::GetValidatedSearchBody(const SearchRequest& searchRequest) const
+    std::optional<web::json::value> Interface::GetValidatedSearchBody(const SearchRequest& searchRequest) const
     {
         SearchRequest resultSearchRequest = searchRequest;
 
@@ -131,17 +131,24 @@ namespace AppInstaller::Repository::Rest::Schema::V1_1
         }
 
         SearchRequestSerializer serializer;
+
+        // Removing the unsupported inclusions must not widen the request into one for its filters alone.
+        if (!serializer.CanSelectPackages(resultSearchRequest))
+        {
+            return {};
+        }
+
         return serializer.Serialize(resultSearchRequest);
     }
 
-    IRestClient::SearchResult Interface::GetSearchResult(const web::json::value& searchResponseObject) const
+    IRestClient::SearchResult Interface::GetSearchResult(const std::shared_ptr<const web::json::value>& searchResponseObject, bool deferVersions) const
     {
-        IRestClient::SearchResult result = V1_0::Interface::GetSearchResult(searchResponseObject);
+        IRestClient::SearchResult result = V1_0::Interface::GetSearchResult(searchResponseObject, deferVersions);
 
         if (result.Matches.size() == 0)
         {
-            auto requiredPackageMatchFields = JsonHelper::GetRawStringArrayFromJsonNode(searchResponseObject, JsonHelper::GetUtilityString(RequiredPackageMatchFields));
-            auto unsupportedPackageMatchFields = JsonHelper::GetRawStringArrayFromJsonNode(searchResponseObject, JsonHelper::GetUtilityString(UnsupportedPackageMatchFields));
+            auto requiredPackageMatchFields = JsonHelper::GetRawStringArrayFromJsonNode(*searchResponseObject, JsonHelper::GetUtilityString(RequiredPackageMatchFields));
+            auto unsupportedPackageMatchFields = JsonHelper::GetRawStringArrayFromJsonNode(*searchResponseObject, JsonHelper::GetUtilityString(UnsupportedPackageMatchFields));
 
             if (requiredPackageMatchFields.size() != 0 || unsupportedPackageMatchFields.size() != 0)
             {
@@ -0,0 +1,140 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Rest/Schema/1_2/Interface.h"
+#include "Rest/Schema/IRestClient.h"
+#include "Rest/Schema/HttpClientHelper.h"
+#include "Rest/Schema/JsonHelper.h"
+#include "Rest/Schema/RestHelper.h"
+#include "Rest/Schema/CommonRestConstants.h"
+
+using namespace std::string_view_literals;
+
+namespace AppInstaller::Repository::Rest::Schema::V1_2
+{
+    namespace
+    {
+        // The capability advertised in the information response by servers that support the batch endpoint.
+        constexpr std::string_view ManifestBatchCapability = "ManifestBatch"sv;
+
+        // Batch endpoint and request constants
+        constexpr std::string_view ManifestBatchPostEndpoint = "/packageManifestsBatch"sv;
+        constexpr std::string_view Manifests = "Manifests"sv;
+        constexpr std::string_view PackageIdentifier = "PackageIdentifier"sv;
+        constexpr std::string_view PackageVersion = "PackageVersion"sv;
+        constexpr std::string_view Channel = "Channel"sv;
+
+        // The maximum number of manifests requested at once.
+        constexpr size_t MaximumManifestBatchSize = 100;
+
+        web::json::value GetManifestBatchBody(const std::vector<IRestClient::ManifestKey>& keys, size_t begin, size_t end)
+        {
+            web::json::value manifests = web::json::value::array();
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                const auto& key = keys[i];
+
+                web::json::value manifest = web::json::value::object();
+                manifest[JsonHelper::GetUtilityString(PackageIdentifier)] = web::json::value::string(JsonHelper::GetUtilityString(key.PackageIdentifier));
+                manifest[JsonHelper::GetUtilityString(PackageVersion)] = web::json::value::string(JsonHelper::GetUtilityString(key.Version));
+
+                if (!key.Channel.empty())
+                {
+                    manifest[JsonHelper::GetUtilityString(Channel)] = web::json::value::string(JsonHelper::GetUtilityString(key.Channel));
+                }
+
+                manifests[i - begin] = std::move(manifest);
+            }
+
+            web::json::value body = web::json::value::object();
+            body[JsonHelper::GetUtilityString(Manifests)] = std::move(manifests);
+            return body;
+        }
+    }
+
+    Interface::Interface(
+        const std::string& restApi,
+        IRestClient::Information information,
+        const std::unordered_map<utility::string_t, utility::string_t>& additionalHeaders,
+        const HttpClientHelper& httpClientHelper) : V1_1::Interface(restApi, information, additionalHeaders, httpClientHelper)
+    {
+        m_requiredRestApiHeaders[JsonHelper::GetUtilityString(ContractVersion)] = JsonHelper::GetUtilityString(Version_1_2_0.ToString());
+
+        m_supportsManifestBatch = std::any_of(information.ServerCapabilities.begin(), information.ServerCapabilities.end(),
+            [](const std::string& capability) { return Utility::CaseInsensitiveEquals(capability, ManifestBatchCapability); });
+    }
+
+    Utility::Version Interface::GetVersion() const
+    {
+        return Version_1_2_0;
+    }
+
+    bool Interface::SupportsManifestBatch() const
+    {
+        return m_supportsManifestBatch;
+    }
+
+    std::vector<std::optional<Manifest::Manifest>> Interface::GetManifestsByVersion(const std::vector<ManifestKey>& keys) const
+    {
+        if (!m_supportsManifestBatch)
+        {
+            return V1_1::Interface::GetManifestsByVersion(keys);
+        }
+
+        std::vector<std::optional<Manifest::Manifest>> results(keys.size());
+
+        for (size_t begin = 0; begin < keys.size(); begin += MaximumManifestBatchSize)
+        {
+            GetManifestBatch(keys, begin, std::min(keys.size(), begin + MaximumManifestBatchSize), results);
+        }
+
+        return results;
+    }
+
+    void Interface::GetManifestBatch(const std::vector<ManifestKey>& keys, size_t begin, size_t end, std::vector<std::optional<Manifest::Manifest>>& results) const
+    {
+        utility::string_t endpoint = RestHelper::AppendPathToUri(JsonHelper::GetUtilityString(m_restApiUri), JsonHelper::GetUtilityString(ManifestBatchPostEndpoint));
+        endpoint = RestHelper::AppendQueryParamsToUri(endpoint, GetValidatedQueryParams({}));
+
+        AICLI_LOG(Repo, Verbose, << "Requesting a batch of " << (end - begin) << " manifests");
+        std::optional<web::json::value> jsonObject = m_httpClientHelper.HandlePost(endpoint, GetManifestBatchBody(keys, begin, end), m_requiredRestApiHeaders);
+
+        if (!jsonObject)
+        {
+            AICLI_LOG(Repo, Verbose, << "No results were returned by the rest source for the manifest batch");
+            return;
+        }
+
+        std::optional<std::reference_wrapper<const web::json::array>> packages = JsonHelper::GetRawJsonArrayFromJsonNode(jsonObject.value(), JsonHelper::GetUtilityString(Data));
+        if (!packages)
+        {
+            return;
+        }
+
+        for (const auto& package : packages.value().get())
+        {
+            // Each item is the data of a package manifest response, so it is deserialized the same way.
+            web::json::value packageResponse = web::json::value::object();
+            packageResponse[JsonHelper::GetUtilityString(Data)] = package;
+
+            std::vector<Manifest::Manifest> manifests = GetParsedManifests(packageResponse);
+            ValidateReceivedManifests(manifests);
+
+            for (auto& manifest : manifests)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    if (!results[i] &&
+                        Utility::CaseInsensitiveEquals(manifest.Id, keys[i].PackageIdentifier) &&
+                        Utility::CaseInsensitiveEquals(manifest.Version, keys[i].Version) &&
+                        Utility::CaseInsensitiveEquals(manifest.Channel, keys[i].Channel))
+                    {
+                        results[i] = std::move(manifest);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
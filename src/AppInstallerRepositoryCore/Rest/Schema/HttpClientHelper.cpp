@@ -2,17 +2,139 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "HttpClientHelper.h"
+#include <winget/Timing.h>
+
+#include <istream>
+#include <mutex>
+#include <streambuf>
+#include <winhttp.h>
 
 namespace AppInstaller::Repository::Rest::Schema
 {
+    namespace
+    {
+        // Reads from a string in place, so that it can be parsed as a stream without being copied.
+        struct StringViewStreamBuffer : public std::streambuf
+        {
+            StringViewStreamBuffer(std::string& value)
+            {
+                setg(value.data(), value.data(), value.data() + value.size());
+            }
+        };
+
+        void RecordResponseCacheLookup(bool hit)
+        {
+            if (Timing::IsUsageEnabled())
+            {
+                Timing::RecordCacheLookup("RestResponse", hit);
+            }
+        }
+
+        // Determines if the charset of the content type is one that is read as UTF-8; JSON is UTF-8 when none is given.
+        bool IsUTF8Charset(const utility::string_t& contentType)
+        {
+            std::string lowerContentType = Utility::ToLower(utility::conversions::to_utf8string(contentType));
+
+            size_t charsetPosition = lowerContentType.find("charset=");
+            if (charsetPosition == std::string::npos)
+            {
+                return true;
+            }
+
+            std::string charset = lowerContentType.substr(charsetPosition + 8);
+            charset = charset.substr(0, charset.find(';'));
+            Utility::Trim(charset);
+
+            if (charset.size() >= 2 && charset.front() == '"' && charset.back() == '"')
+            {
+                charset = charset.substr(1, charset.size() - 2);
+            }
+
+            return charset == "utf-8" || charset == "us-ascii" || charset == "ascii";
+        }
+
+        // Holds the clients for the lifetime of the process, so that the WinHTTP session and connections
+        // (along with their TLS and proxy negotiation) of a client are reused by every request to the same server.
+        struct ClientPool
+        {
+            web::http::client::http_client GetClient(const web::uri& authority, const std::optional<std::shared_ptr<web::http::http_pipeline_stage>>& stage)
+            {
+                // Clients with a different handler stage must not be shared, as the stage is part of the client's pipeline.
+                Key key{ authority.to_string(), stage ? stage->get() : nullptr };
+
+                std::lock_guard<std::mutex> lock{ m_mutex };
+
+                auto itr = m_clients.find(key);
+                if (itr == m_clients.end())
+                {
+                    web::http::client::http_client_config config;
+                    config.set_nativesessionhandle_options(EnableDecompression);
+
+                    web::http::client::http_client client{ authority, config };
+
+                    if (stage)
+                    {
+                        client.add_handler(stage.value());
+                    }
+
+                    itr = m_clients.emplace(std::move(key), std::move(client)).first;
+                }
+
+                return itr->second;
+            }
+
+        private:
+            using Key = std::pair<utility::string_t, const web::http::http_pipeline_stage*>;
+
+            // Has WinHTTP send Accept-Encoding for gzip and deflate, and decompress the responses as they are read.
+            // The built in compression of cpprestsdk is not used, as it is excluded from the build along with zlib.
+            static void EnableDecompression(web::http::client::native_handle session)
+            {
+                DWORD decompression = WINHTTP_DECOMPRESSION_FLAG_ALL;
+                if (!WinHttpSetOption(session, WINHTTP_OPTION_DECOMPRESSION, &decompression, sizeof(decompression)))
+                {
+                    AICLI_LOG(Repo, Info, << "Response decompression could not be enabled: " << GetLastError());
+                }
+            }
+
+            std::mutex m_mutex;
+            std::map<Key, web::http::client::http_client> m_clients;
+        };
+
+        // Runs the continuations of the requests on the Io lane of the process-wide thread pool, rather than on threads of their own.
+        struct WorkLaneScheduler : public pplx::scheduler_interface
+        {
+            void schedule(pplx::TaskProc_t proc, void* param) override
+            {
+                Synchronization::SubmitWork(Synchronization::WorkLane::Io, [proc, param]() { proc(param); });
+            }
+        };
+
+        ClientPool& GetClientPool()
+        {
+            // A client is needed before any request is sent, so the scheduler is in place for the tasks of every request.
+            static std::once_flag s_schedulerOnce;
+            std::call_once(s_schedulerOnce, []() { pplx::set_ambient_scheduler(std::make_shared<WorkLaneScheduler>()); });
+
+            static ClientPool s_pool;
+            return s_pool;
+        }
+    }
+
     HttpClientHelper::HttpClientHelper(std::optional<std::shared_ptr<web::http::http_pipeline_stage>> stage) : m_defaultRequestHandlerStage(stage) {}
 
+    void HttpClientHelper::SetResponseCache(std::shared_ptr<HttpResponseCache> responseCache)
+    {
+        m_responseCache = std::move(responseCache);
+    }
+
     pplx::task<web::http::http_response> HttpClientHelper::Post(
         const utility::string_t& uri, const web::json::value& body, const std::unordered_map<utility::string_t, utility::string_t>& headers) const
     {
         AICLI_LOG(Repo, Info, << "Sending http POST request to: " << utility::conversions::to_utf8string(uri));
         web::http::client::http_client client = GetClient(uri);
         web::http::http_request request{ web::http::methods::POST };
+        request.set_request_uri(web::uri{ uri }.resource());
         request.headers().set_content_type(web::http::details::mime_types::application_json);
         request.set_body(body.serialize());
 
@@ -24,12 +146,24 @@ namespace AppInstaller::Repository::Rest::Schema
 
         AICLI_LOG(Repo, Verbose, << "Http POST request details:\n" << utility::conversions::to_utf8string(request.to_string()));
 
+        Logging::Telemetry().LogRestRequest();
+        if (Timing::IsUsageEnabled())
+        {
+            Timing::RecordHttpRequest(utility::conversions::to_utf8string(uri));
+        }
+
         return client.request(request);
     }
 
     std::optional<web::json::value> HttpClientHelper::HandlePost(
         const utility::string_t& uri, const web::json::value& body, const std::unordered_map<utility::string_t, utility::string_t>& headers) const
     {
+        if (m_responseCache)
+        {
+            return HandleWithResponseCache(HttpResponseCache::GetKey(web::http::methods::POST, uri, headers, &body), headers,
+                [&](const Headers& requestHeaders) { return Post(uri, body, requestHeaders); });
+        }
+
         web::http::http_response httpResponse;
         HttpClientHelper::Post(uri, body, headers).then([&httpResponse](const web::http::http_response& response)
             {
@@ -45,6 +179,7 @@ namespace AppInstaller::Repository::Rest::Schema
         AICLI_LOG(Repo, Info, << "Sending http GET request to: " << utility::conversions::to_utf8string(uri));
         web::http::client::http_client client = GetClient(uri);
         web::http::http_request request{ web::http::methods::GET };
+        request.set_request_uri(web::uri{ uri }.resource());
         request.headers().set_content_type(web::http::details::mime_types::application_json);
 
         // Add headers
@@ -55,12 +190,24 @@ namespace AppInstaller::Repository::Rest::Schema
 
         AICLI_LOG(Repo, Verbose, << "Http GET request details:\n" << utility::conversions::to_utf8string(request.to_string()));
 
+        Logging::Telemetry().LogRestRequest();
+        if (Timing::IsUsageEnabled())
+        {
+            Timing::RecordHttpRequest(utility::conversions::to_utf8string(uri));
+        }
+
         return client.request(request);
     }
 
     std::optional<web::json::value> HttpClientHelper::HandleGet(
         const utility::string_t& uri, const std::unordered_map<utility::string_t, utility::string_t>& headers) const
     {
+        if (m_responseCache)
+        {
+            return HandleWithResponseCache(HttpResponseCache::GetKey(web::http::methods::GET, uri, headers), headers,
+                [&](const Headers& requestHeaders) { return Get(uri, requestHeaders); });
+        }
+
         web::http::http_response httpResponse;
         Get(uri, headers).then([&httpResponse](const web::http::http_response& response)
             {
@@ -70,17 +217,55 @@ namespace AppInstaller::Repository::Rest::Schema
         return ValidateAndExtractResponse(httpResponse);
     }
 
-    web::http::client::http_client HttpClientHelper::GetClient(const utility::string_t& uri) const
+    std::optional<web::json::value> HttpClientHelper::HandleResponse(const pplx::task<web::http::http_response>& pendingResponse) const
+    {
+        return ValidateAndExtractResponse(pendingResponse.get());
+    }
+
+    std::optional<web::json::value> HttpClientHelper::HandleWithResponseCache(
+        const std::string& key, const Headers& headers, const std::function<pplx::task<web::http::http_response>(const Headers&)>& send) const
     {
-        web::http::client::http_client client{ uri };
+        std::optional<HttpResponseCache::Entry> entry = m_responseCache->Get(key);
+        if (entry && entry->IsFresh())
+        {
+            AICLI_LOG(Repo, Verbose, << "Using fresh cached response");
+            RecordResponseCacheLookup(true);
+            return std::move(entry->Body);
+        }
 
-        // Add default custom handlers if any.
-        if (m_defaultRequestHandlerStage)
+        Headers requestHeaders = headers;
+        if (entry)
         {
-            client.add_handler(m_defaultRequestHandlerStage.value());
+            entry->AddConditionalHeaders(requestHeaders);
         }
 
-        return client;
+        web::http::http_response response = send(requestHeaders).get();
+
+        // A response that is revalidated by the server is a hit, as its body is not sent again.
+        bool notModified = entry && response.status_code() == web::http::status_codes::NotModified;
+        RecordResponseCacheLookup(notModified);
+
+        if (notModified)
+        {
+            AICLI_LOG(Repo, Info, << "Response status: " << response.status_code() << "; using cached response");
+            m_responseCache->Refresh(key, entry.value(), response);
+            return std::move(entry->Body);
+        }
+
+        std::optional<web::json::value> result = ValidateAndExtractResponse(response);
+
+        if (result && response.status_code() == web::http::status_codes::OK)
+        {
+            m_responseCache->Store(key, response, result.value());
+        }
+
+        return result;
+    }
+
+    web::http::client::http_client HttpClientHelper::GetClient(const utility::string_t& uri) const
+    {
+        // The client is for the server only; the requests carry the path and query of the uri.
+        return GetClientPool().GetClient(web::uri{ uri }.authority(), m_defaultRequestHandlerStage);
     }
 
     std::optional<web::json::value> HttpClientHelper::ValidateAndExtractResponse(const web::http::http_response& response) const
@@ -124,6 +309,31 @@ namespace AppInstaller::Repository::Rest::Schema
         THROW_HR_IF(APPINSTALLER_CLI_ERROR_RESTSOURCE_UNSUPPORTED_MIME_TYPE,
             !contentType._Starts_with(web::http::details::mime_types::application_json));
 
-        return response.extract_json().get();
+        // The body has been decompressed by now; the sizes can only be compared when the headers describing the original are still present.
+        utility::string_t contentEncoding;
+        if (response.headers().match(web::http::header_names::content_encoding, contentEncoding) && response.headers().has(web::http::header_names::content_length))
+        {
+            response.content_ready().wait();
+            Logging::Telemetry().LogCompressedRestResponse(
+                utility::conversions::to_utf8string(contentEncoding),
+                static_cast<uint64_t>(response.headers().content_length()),
+                static_cast<uint64_t>(response.body().streambuf().in_avail()));
+        }
+
+        if (!IsUTF8Charset(contentType))
+        {
+            return response.extract_json().get();
+        }
+
+        // Extracting the JSON converts the whole body to UTF-16 before parsing it; the UTF-8 parser only converts the strings within it.
+        std::string body = response.extract_utf8string(true).get();
+        if (body.empty())
+        {
+            return web::json::value{};
+        }
+
+        StringViewStreamBuffer buffer{ body };
+        std::istream stream{ &buffer };
+        return web::json::value::parse(stream);
     }
 }
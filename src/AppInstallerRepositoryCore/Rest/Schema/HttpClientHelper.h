@@ -3,7 +3,10 @@
 #pragma once
 #include <cpprest/http_client.h>
 #include <cpprest/json.h>
+#include "Rest/Schema/HttpResponseCache.h"
 
+#include <functional>
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -13,6 +16,9 @@ namespace AppInstaller::Repository::Rest::Schema
     {
         HttpClientHelper(std::optional<std::shared_ptr<web::http::http_pipeline_stage>> = {});
 
+        // Serves HandleGet and HandlePost from the cache when it can, and stores their responses in it.
+        void SetResponseCache(std::shared_ptr<HttpResponseCache> responseCache);
+
         pplx::task<web::http::http_response> Post(const utility::string_t& uri, const web::json::value& body, const std::unordered_map<utility::string_t, utility::string_t> &headers = {}) const;
 
         std::optional<web::json::value> HandlePost(const utility::string_t& uri, const web::json::value& body, const std::unordered_map<utility::string_t, utility::string_t>& headers = {}) const;
@@ -20,6 +26,9 @@ namespace AppInstaller::Repository::Rest::Schema
         pplx::task<web::http::http_response> Get(const utility::string_t& uri, const std::unordered_map<utility::string_t, utility::string_t>& headers = {}) const;
 
         std::optional<web::json::value> HandleGet(const utility::string_t& uri, const std::unordered_map<utility::string_t, utility::string_t>& headers = {}) const;
+
+        // Waits for a request started with Post or Get, then handles the response the same way as HandlePost and HandleGet.
+        std::optional<web::json::value> HandleResponse(const pplx::task<web::http::http_response>& pendingResponse) const;
     
     protected:
         std::optional<web::json::value> ValidateAndExtractResponse(const web::http::http_response& response) const;
@@ -29,6 +38,10 @@ namespace AppInstaller::Repository::Rest::Schema
     private:
         web::http::client::http_client GetClient(const utility::string_t& uri) const;
 
+        using Headers = std::unordered_map<utility::string_t, utility::string_t>;
+        std::optional<web::json::value> HandleWithResponseCache(const std::string& key, const Headers& headers, const std::function<pplx::task<web::http::http_response>(const Headers&)>& send) const;
+
         std::optional<std::shared_ptr<web::http::http_pipeline_stage>> m_defaultRequestHandlerStage;
+        std::shared_ptr<HttpResponseCache> m_responseCache;
     };
 }
@@ -0,0 +1,344 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "HttpResponseCache.h"
+#include "Rest/Schema/JsonHelper.h"
+#include <AppInstallerRuntime.h>
+#include <AppInstallerSHA256.h>
+#include <AppInstallerStrings.h>
+
+using namespace std::string_view_literals;
+
+namespace AppInstaller::Repository::Rest::Schema
+{
+    namespace
+    {
+        constexpr std::string_view s_ResponseCacheDirectory = "RestResponseCache"sv;
+        constexpr std::wstring_view s_EntryExtension = L".json"sv;
+
+        // Entries not used for this long are removed regardless of the size of the cache.
+        constexpr auto s_MaximumUnusedAge = std::chrono::hours{ 24 * 30 };
+
+        // The cache is trimmed on the first write and then after this many more, so that every write does not read the whole directory.
+        constexpr size_t s_WritesPerTrim = 100;
+
+        // Entry file properties
+        constexpr std::string_view s_ETag = "ETag"sv;
+        constexpr std::string_view s_LastModified = "LastModified"sv;
+        constexpr std::string_view s_FreshUntil = "FreshUntil"sv;
+        constexpr std::string_view s_Body = "Body"sv;
+
+        struct CacheControl
+        {
+            bool NoStore = false;
+            std::chrono::seconds MaxAge{ 0 };
+        };
+
+        // Reads the directives of the Cache-Control header that matter to a private cache.
+        CacheControl GetCacheControl(const web::http::http_headers& headers)
+        {
+            CacheControl result;
+
+            utility::string_t value;
+            if (!headers.match(web::http::header_names::cache_control, value))
+            {
+                return result;
+            }
+
+            std::istringstream directives{ Utility::ToLower(utility::conversions::to_utf8string(value)) };
+            std::string directive;
+            bool noCache = false;
+            while (std::getline(directives, directive, ','))
+            {
+                Utility::Trim(directive);
+
+                if (directive == "no-store")
+                {
+                    result.NoStore = true;
+                }
+                else if (directive == "no-cache")
+                {
+                    noCache = true;
+                }
+                else if (directive.rfind("max-age=", 0) == 0)
+                {
+                    try
+                    {
+                        result.MaxAge = std::chrono::seconds{ std::stoll(directive.substr(8)) };
+                    }
+                    catch (...)
+                    {
+                        AICLI_LOG(Repo, Verbose, << "Ignoring invalid Cache-Control directive: " << directive);
+                    }
+                }
+            }
+
+            // The entry may be stored, but must be revalidated every time.
+            if (noCache)
+            {
+                result.MaxAge = std::chrono::seconds{ 0 };
+            }
+
+            return result;
+        }
+
+        std::chrono::system_clock::time_point GetFreshUntil(const web::http::http_response& response)
+        {
+            return std::chrono::system_clock::now() + GetCacheControl(response.headers()).MaxAge;
+        }
+
+        utility::string_t GetHeader(const web::http::http_response& response, const utility::string_t& name)
+        {
+            utility::string_t result;
+            response.headers().match(name, result);
+            return result;
+        }
+
+        // Marks the entry as the most recently used.
+        void TouchEntry(const std::filesystem::path& path)
+        {
+            std::error_code ec;
+            std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+        }
+    }
+
+    bool HttpResponseCache::Entry::IsFresh() const
+    {
+        return std::chrono::system_clock::now() < FreshUntil;
+    }
+
+    void HttpResponseCache::Entry::AddConditionalHeaders(std::unordered_map<utility::string_t, utility::string_t>& headers) const
+    {
+        if (!ETag.empty())
+        {
+            headers.insert_or_assign(web::http::header_names::if_none_match, ETag);
+        }
+
+        if (!LastModified.empty())
+        {
+            headers.insert_or_assign(web::http::header_names::if_modified_since, LastModified);
+        }
+    }
+
+    HttpResponseCache::HttpResponseCache(std::filesystem::path directory, uint64_t maximumSizeInBytes) :
+        m_directory(std::move(directory)), m_maximumSizeInBytes(maximumSizeInBytes) {}
+
+    std::shared_ptr<HttpResponseCache> HttpResponseCache::GetDefault()
+    {
+        static std::shared_ptr<HttpResponseCache> s_cache = std::make_shared<HttpResponseCache>(Runtime::GetPathTo(Runtime::PathName::LocalState) / s_ResponseCacheDirectory);
+        return s_cache;
+    }
+
+    std::string HttpResponseCache::GetKey(
+        const web::http::method& method,
+        const utility::string_t& uri,
+        const std::unordered_map<utility::string_t, utility::string_t>& headers,
+        const web::json::value* body)
+    {
+        std::map<utility::string_t, utility::string_t> sortedHeaders{ headers.begin(), headers.end() };
+
+        utility::string_t request = method + L'\n' + uri + L'\n';
+        for (const auto& header : sortedHeaders)
+        {
+            request += header.first + L':' + header.second + L'\n';
+        }
+
+        if (body)
+        {
+            request += body->serialize();
+        }
+
+        return Utility::SHA256::ConvertToString(Utility::SHA256::ComputeHash(utility::conversions::to_utf8string(request)));
+    }
+
+    std::optional<HttpResponseCache::Entry> HttpResponseCache::Get(const std::string& key) const
+    {
+        try
+        {
+            std::filesystem::path entryPath = GetEntryPath(key);
+            std::ifstream stream{ entryPath, std::ios_base::in | std::ios_base::binary };
+            if (!stream)
+            {
+                return {};
+            }
+
+            // Parse the UTF-8 directly, rather than converting the whole file to UTF-16 first.
+            web::json::value entryObject = web::json::value::parse(stream);
+
+            Entry result;
+            result.ETag = JsonHelper::GetUtilityString(JsonHelper::GetRawStringValueFromJsonNode(entryObject, JsonHelper::GetUtilityString(s_ETag)).value_or(""));
+            result.LastModified = JsonHelper::GetUtilityString(JsonHelper::GetRawStringValueFromJsonNode(entryObject, JsonHelper::GetUtilityString(s_LastModified)).value_or(""));
+            result.FreshUntil = std::chrono::system_clock::from_time_t(static_cast<time_t>(entryObject.at(JsonHelper::GetUtilityString(s_FreshUntil)).as_number().to_int64()));
+            result.Body = entryObject.at(JsonHelper::GetUtilityString(s_Body));
+
+            stream.close();
+            TouchEntry(entryPath);
+
+            return result;
+        }
+        catch (...)
+        {
+            AICLI_LOG(Repo, Info, << "Failed to read response cache entry " << key);
+        }
+
+        return {};
+    }
+
+    void HttpResponseCache::Store(const std::string& key, const web::http::http_response& response, const web::json::value& body) const
+    {
+        CacheControl cacheControl = GetCacheControl(response.headers());
+        if (cacheControl.NoStore)
+        {
+            return;
+        }
+
+        Entry entry;
+        entry.Body = body;
+        entry.ETag = GetHeader(response, web::http::header_names::etag);
+        entry.LastModified = GetHeader(response, web::http::header_names::last_modified);
+        entry.FreshUntil = std::chrono::system_clock::now() + cacheControl.MaxAge;
+
+        // Without a validator or any freshness, the entry could never be used.
+        if (entry.ETag.empty() && entry.LastModified.empty() && cacheControl.MaxAge.count() <= 0)
+        {
+            return;
+        }
+
+        Write(key, entry);
+    }
+
+    void HttpResponseCache::Refresh(const std::string& key, Entry& entry, const web::http::http_response& notModified) const
+    {
+        // A not modified response may carry updated validators.
+        utility::string_t etag = GetHeader(notModified, web::http::header_names::etag);
+        if (!etag.empty())
+        {
+            entry.ETag = std::move(etag);
+        }
+
+        utility::string_t lastModified = GetHeader(notModified, web::http::header_names::last_modified);
+        if (!lastModified.empty())
+        {
+            entry.LastModified = std::move(lastModified);
+        }
+
+        entry.FreshUntil = GetFreshUntil(notModified);
+
+        Write(key, entry);
+    }
+
+    std::filesystem::path HttpResponseCache::GetEntryPath(const std::string& key) const
+    {
+        std::filesystem::path result = m_directory;
+        result /= Utility::ConvertToUTF16(key);
+        result += s_EntryExtension;
+        return result;
+    }
+
+    void HttpResponseCache::Trim() const
+    {
+        try
+        {
+            struct TrimEntry
+            {
+                std::filesystem::path Path;
+                std::filesystem::file_time_type LastUsed;
+                uint64_t Size;
+            };
+
+            std::vector<TrimEntry> entries;
+            uint64_t totalSize = 0;
+            auto unusedSince = std::filesystem::file_time_type::clock::now() - s_MaximumUnusedAge;
+
+            std::error_code ec;
+            for (const auto& file : std::filesystem::directory_iterator{ m_directory, ec })
+            {
+                if (!file.is_regular_file(ec) || file.path().extension() != s_EntryExtension)
+                {
+                    continue;
+                }
+
+                TrimEntry entry{ file.path(), file.last_write_time(ec), file.file_size(ec) };
+                if (ec)
+                {
+                    continue;
+                }
+
+                if (entry.LastUsed < unusedSince)
+                {
+                    if (std::filesystem::remove(entry.Path, ec))
+                    {
+                        AICLI_LOG(Repo, Verbose, << "Removed unused response cache entry: " << entry.Path);
+                    }
+
+                    continue;
+                }
+
+                totalSize += entry.Size;
+                entries.emplace_back(std::move(entry));
+            }
+
+            if (totalSize <= m_maximumSizeInBytes)
+            {
+                return;
+            }
+
+            std::sort(entries.begin(), entries.end(), [](const TrimEntry& a, const TrimEntry& b) { return a.LastUsed < b.LastUsed; });
+
+            for (const auto& entry : entries)
+            {
+                if (totalSize <= m_maximumSizeInBytes)
+                {
+                    break;
+                }
+
+                // An entry being read by another process may not be removable; it is left for a later trim.
+                if (std::filesystem::remove(entry.Path, ec))
+                {
+                    totalSize -= entry.Size;
+                }
+            }
+
+            AICLI_LOG(Repo, Verbose, << "Trimmed response cache to " << totalSize << " bytes");
+        }
+        catch (...)
+        {
+            AICLI_LOG(Repo, Info, << "Failed to trim response cache");
+        }
+    }
+
+    void HttpResponseCache::Write(const std::string& key, const Entry& entry) const
+    {
+        try
+        {
+            web::json::value entryObject;
+            entryObject[JsonHelper::GetUtilityString(s_ETag)] = web::json::value::string(entry.ETag);
+            entryObject[JsonHelper::GetUtilityString(s_LastModified)] = web::json::value::string(entry.LastModified);
+            entryObject[JsonHelper::GetUtilityString(s_FreshUntil)] = web::json::value::number(static_cast<int64_t>(std::chrono::system_clock::to_time_t(entry.FreshUntil)));
+            entryObject[JsonHelper::GetUtilityString(s_Body)] = entry.Body;
+
+            std::filesystem::create_directories(m_directory);
+
+            // Write to a temporary file and move it into place, so that a reader never sees a partial entry.
+            std::filesystem::path entryPath = GetEntryPath(key);
+            std::filesystem::path tempPath = entryPath;
+            tempPath += L"." + std::to_wstring(GetCurrentProcessId()) + L"." + std::to_wstring(GetCurrentThreadId()) + L".tmp";
+
+            {
+                std::ofstream stream{ tempPath, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary };
+                entryObject.serialize(stream);
+            }
+
+            std::filesystem::rename(tempPath, entryPath);
+        }
+        catch (...)
+        {
+            AICLI_LOG(Repo, Info, << "Failed to write response cache entry " << key);
+        }
+
+        if (m_writeCount++ % s_WritesPerTrim == 0)
+        {
+            Trim();
+        }
+    }
+}
@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <cpprest/http_msg.h>
+#include <cpprest/json.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace AppInstaller::Repository::Rest::Schema
+{
+    // An on disk cache of the JSON responses from REST sources.
+    // Entries are stored when the server gives a validator (ETag or Last-Modified) or a max-age, and are served
+    // without a request while fresh; once stale, they are revalidated with a conditional request.
+    // Failures to read or write the cache are logged and otherwise ignored, as the cache is only an optimization.
+    // Entries that have not been used for some time, and then the least recently used ones, are removed to keep the cache within its maximum size.
+    struct HttpResponseCache
+    {
+        // The maximum size of the cache when none is given.
+        static constexpr uint64_t DefaultMaximumSizeInBytes = 100 * 1024 * 1024;
+
+        HttpResponseCache(std::filesystem::path directory, uint64_t maximumSizeInBytes = DefaultMaximumSizeInBytes);
+
+        // Gets the cache in the local state directory, which is shared by all REST sources.
+        static std::shared_ptr<HttpResponseCache> GetDefault();
+
+        // A cached response.
+        struct Entry
+        {
+            web::json::value Body;
+            utility::string_t ETag;
+            utility::string_t LastModified;
+            // The entry can be used without revalidation until this time.
+            std::chrono::system_clock::time_point FreshUntil;
+
+            bool IsFresh() const;
+
+            // Adds the headers that make a request conditional on the entry having changed.
+            void AddConditionalHeaders(std::unordered_map<utility::string_t, utility::string_t>& headers) const;
+        };
+
+        // Gets the key for a request; the headers are included as they can change the response.
+        static std::string GetKey(
+            const web::http::method& method,
+            const utility::string_t& uri,
+            const std::unordered_map<utility::string_t, utility::string_t>& headers,
+            const web::json::value* body = nullptr);
+
+        // Gets the entry for the key, if there is one.
+        std::optional<Entry> Get(const std::string& key) const;
+
+        // Stores a successful response, if the server allows it to be and it can be revalidated or is fresh for some time.
+        void Store(const std::string& key, const web::http::http_response& response, const web::json::value& body) const;
+
+        // Updates the entry from a not modified response to revalidating it.
+        void Refresh(const std::string& key, Entry& entry, const web::http::http_response& notModified) const;
+
+        // Removes the entries that have not been used recently, then the least recently used ones until the cache is within its maximum size.
+        // This is done automatically as entries are written, but not on every write.
+        void Trim() const;
+
+    private:
+        std::filesystem::path GetEntryPath(const std::string& key) const;
+        void Write(const std::string& key, const Entry& entry) const;
+
+        std::filesystem::path m_directory;
+        uint64_t m_maximumSizeInBytes;
+        mutable std::atomic<size_t> m_writeCount{ 0 };
+    };
+}
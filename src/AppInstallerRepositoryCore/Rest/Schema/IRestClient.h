@@ -3,6 +3,7 @@
 #pragma once
 #include "Microsoft/Schema/Version.h"
 #include <AppInstallerVersions.h>
+#include <functional>
 #include <vector>
 
 namespace AppInstaller::Repository::Rest::Schema
@@ -39,6 +40,9 @@ namespace AppInstaller::Repository::Rest::Schema
         PackageInfo PackageInformation;
         std::vector<VersionInfo> Versions;
 
+        // When set, Versions only contains the latest version and this deserializes all of them.
+        std::function<std::vector<VersionInfo>()> DeferredVersions;
+
         Package(PackageInfo packageInfo, std::vector<VersionInfo> versions)
         : PackageInformation(std::move(packageInfo)), Versions(std::move(versions)) {}
     };
@@ -67,12 +71,24 @@ namespace AppInstaller::Repository::Rest::Schema
         std::vector<std::string> RequiredPackageMatchFields;
         std::vector<std::string> UnsupportedQueryParameters;
         std::vector<std::string> RequiredQueryParameters;
+        std::vector<std::string> ServerCapabilities;
 
         Information() {}
         Information(std::string sourceId, std::vector<std::string> versions)
             : SourceIdentifier(std::move(sourceId)), ServerSupportedVersions(std::move(versions)) {}
     };
 
+    // Identifies a single manifest in a batched manifest request.
+    struct ManifestKey
+    {
+        std::string PackageIdentifier;
+        std::string Version;
+        std::string Channel;
+
+        ManifestKey(std::string packageIdentifier, std::string version, std::string channel)
+            : PackageIdentifier(std::move(packageIdentifier)), Version(std::move(version)), Channel(std::move(channel)) {}
+    };
+
     // Get interface version.
     virtual Utility::Version GetVersion() const = 0;
 
@@ -80,12 +96,22 @@ namespace AppInstaller::Repository::Rest::Schema
     virtual Information GetSourceInformation() const = 0;
 
     // Performs a search based on the given criteria.
-    virtual SearchResult Search(const SearchRequest& request) const = 0;
+    SearchResult Search(const SearchRequest& request) const { return Search(request, false); }
+
+    // Performs a search based on the given criteria.
+    // When deferVersions is set, only the latest version of each package is deserialized up front; see Package::DeferredVersions.
+    virtual SearchResult Search(const SearchRequest& request, bool deferVersions) const = 0;
 
     // Gets the manifest for given version
     virtual std::optional<Manifest::Manifest> GetManifestByVersion(const std::string& packageId, const std::string& version, const std::string& channel) const = 0;
     
     // Gets the manifests for given query parameters
     virtual std::vector<Manifest::Manifest> GetManifests(const std::string& packageId, const std::map<std::string_view, std::string>& params = {}) const = 0;
+
+    // Gets whether the manifests for many versions can be retrieved with a single request.
+    virtual bool SupportsManifestBatch() const = 0;
+
+    // Gets the manifests for the given versions; the result has an entry for each key, empty if the manifest was not found.
+    virtual std::vector<std::optional<Manifest::Manifest>> GetManifestsByVersion(const std::vector<ManifestKey>& keys) const = 0;
     };
 }
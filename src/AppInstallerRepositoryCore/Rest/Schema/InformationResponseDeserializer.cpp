@@ -25,6 +25,7 @@ namespace AppInstaller::Repository::Rest::Schema
         constexpr std::string_view RequiredPackageMatchFields = "RequiredPackageMatchFields"sv;
         constexpr std::string_view UnsupportedQueryParameters = "UnsupportedQueryParameters"sv;
         constexpr std::string_view RequiredQueryParameters = "RequiredQueryParameters"sv;
+        constexpr std::string_view ServerCapabilities = "ServerCapabilities"sv;
     }
 
     IRestClient::Information InformationResponseDeserializer::Deserialize(const web::json::value& dataObject) const
@@ -122,6 +123,7 @@ namespace AppInstaller::Repository::Rest::Schema
             info.UnsupportedPackageMatchFields = JsonHelper::GetRawStringArrayFromJsonNode(dataValue, JsonHelper::GetUtilityString(UnsupportedPackageMatchFields));
             info.RequiredQueryParameters = JsonHelper::GetRawStringArrayFromJsonNode(dataValue, JsonHelper::GetUtilityString(RequiredQueryParameters));
             info.UnsupportedQueryParameters = JsonHelper::GetRawStringArrayFromJsonNode(dataValue, JsonHelper::GetUtilityString(UnsupportedQueryParameters));
+            info.ServerCapabilities = JsonHelper::GetRawStringArrayFromJsonNode(dataValue, JsonHelper::GetUtilityString(ServerCapabilities));
 
             return info;
         }
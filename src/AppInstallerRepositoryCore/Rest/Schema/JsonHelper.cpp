@@ -7,17 +7,31 @@ namespace AppInstaller::Repository::Rest::Schema
 {
     utility::string_t JsonHelper::GetUtilityString(std::string_view nodeName)
     {
-        return utility::conversions::to_string_t(nodeName.data());
+        // The node names are ASCII, which can be widened directly rather than going through a full conversion.
+        if (std::all_of(nodeName.begin(), nodeName.end(), [](char c) { return static_cast<unsigned char>(c) < 0x80; }))
+        {
+            return utility::string_t(nodeName.begin(), nodeName.end());
+        }
+
+        return utility::conversions::to_string_t(std::string{ nodeName });
     }
 
     std::optional<std::reference_wrapper<const web::json::value>> JsonHelper::GetJsonValueFromNode(const web::json::value& node, const utility::string_t& keyName)
     {
-        if (node.is_null() || !node.has_field(keyName))
+        if (!node.is_object())
+        {
+            return {};
+        }
+
+        // Find the field with a single lookup rather than checking for it and then getting it.
+        const web::json::object& object = node.as_object();
+        auto itr = object.find(keyName);
+        if (itr == object.end())
         {
             return {};
         }
-        
-        return node.at(keyName);
+
+        return itr->second;
     }
 
     std::optional<std::string> JsonHelper::GetRawStringValueFromJsonValue(const web::json::value& value)
@@ -109,6 +123,7 @@ namespace AppInstaller::Repository::Rest::Schema
             return result;
         }
 
+        result.reserve(arrayValue.value().get().size());
         for (auto& value : arrayValue.value().get())
         {
             std::optional<std::string> item = JsonHelper::GetRawStringValueFromJsonValue(value);
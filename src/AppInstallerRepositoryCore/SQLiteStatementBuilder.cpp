@@ -325,6 +325,18 @@ namespace AppInstaller::Repository::SQLite::Builder
         return *this;
     }
 
+    StatementBuilder& StatementBuilder::GreaterThanOrEquals(details::unbound_t)
+    {
+        AppendOpAndBinder(Op::GreaterThanOrEquals);
+        return *this;
+    }
+
+    StatementBuilder& StatementBuilder::LessThan(details::unbound_t)
+    {
+        AppendOpAndBinder(Op::LessThan);
+        return *this;
+    }
+
     StatementBuilder& StatementBuilder::LiteralColumn(std::string_view value)
     {
         if (m_needsComma)
@@ -448,6 +460,12 @@ namespace AppInstaller::Repository::SQLite::Builder
         return *this;
     }
 
+    StatementBuilder& StatementBuilder::UnionAll()
+    {
+        m_stream << " UNION ALL ";
+        return *this;
+    }
+
     StatementBuilder& StatementBuilder::GroupBy(std::string_view column)
     {
         OutputColumns(m_stream, " GROUP BY ", column);
@@ -784,6 +802,12 @@ namespace AppInstaller::Repository::SQLite::Builder
         return *this;
     }
 
+    StatementBuilder& StatementBuilder::Analyze()
+    {
+        m_stream << "ANALYZE";
+        return *this;
+    }
+
     StatementBuilder& StatementBuilder::BeginParenthetical()
     {
         m_stream << '(';
@@ -827,6 +851,12 @@ namespace AppInstaller::Repository::SQLite::Builder
         case Op::Like:
             m_stream << " LIKE ?";
             break;
+        case Op::GreaterThanOrEquals:
+            m_stream << " >= ?";
+            break;
+        case Op::LessThan:
+            m_stream << " < ?";
+            break;
         case Op::Escape:
             m_stream << " ESCAPE ?";
             break;
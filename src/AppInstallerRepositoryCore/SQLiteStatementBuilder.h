@@ -243,6 +243,10 @@ namespace AppInstaller::Repository::SQLite::Builder
         StatementBuilder& LikeWithEscape(std::string_view value);
         StatementBuilder& Like(details::unbound_t);
 
+        // Ordered comparisons, which use the collation of the column; with the default, text is compared byte by byte.
+        StatementBuilder& GreaterThanOrEquals(details::unbound_t);
+        StatementBuilder& LessThan(details::unbound_t);
+
         StatementBuilder& LiteralColumn(std::string_view value);
 
         StatementBuilder& Escape(std::string_view escapeChar);
@@ -288,6 +292,9 @@ namespace AppInstaller::Repository::SQLite::Builder
         // Limits the result set to the given number of rows.
         StatementBuilder& Limit(size_t rowCount);
 
+        // Combines the rows of the previous select with those of the one that follows, keeping duplicates.
+        StatementBuilder& UnionAll();
+
         // Begin an insert statement for the given table.
         // The initializer_list form enables the table name to be constructed from multiple parts.
         StatementBuilder& InsertInto(std::string_view table);
@@ -391,6 +398,9 @@ namespace AppInstaller::Repository::SQLite::Builder
         // Output the set portion of an update statement.
         StatementBuilder& Vacuum();
 
+        // Gathers the statistics that the query planner uses to choose between indices.
+        StatementBuilder& Analyze();
+
         // General purpose functions to begin and end a parenthetical expression.
         StatementBuilder& BeginParenthetical();
         StatementBuilder& EndParenthetical();
@@ -413,6 +423,8 @@ namespace AppInstaller::Repository::SQLite::Builder
         {
             Equals,
             Like,
+            GreaterThanOrEquals,
+            LessThan,
             Escape,
             Literal,
         };
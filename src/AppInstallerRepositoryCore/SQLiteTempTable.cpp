@@ -8,19 +8,94 @@ namespace AppInstaller::Repository::SQLite
 {
     using namespace std::string_view_literals;
 
-    TempTable::TempTable()
+    namespace
     {
-        GUID tempName;
-        THROW_IF_FAILED(CoCreateGuid(&tempName));
+        std::string CreateTempTableName()
+        {
+            GUID tempName;
+            THROW_IF_FAILED(CoCreateGuid(&tempName));
+
+            wchar_t guidAsString[MAX_PATH];
+            THROW_HR_IF(E_UNEXPECTED, StringFromGUID2(tempName, guidAsString, MAX_PATH) == 0);
+
+            return Utility::ConvertToUTF8(guidAsString);
+        }
+    }
+
+    namespace details
+    {
+        std::string TempTablePool::Acquire(std::string_view kind)
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+
+            for (auto itr = m_idle.begin(); itr != m_idle.end(); ++itr)
+            {
+                if (itr->first == kind)
+                {
+                    std::string result = std::move(itr->second);
+                    m_idle.erase(itr);
+                    return result;
+                }
+            }
+
+            return {};
+        }
+
+        bool TempTablePool::Release(std::string_view kind, const std::string& name)
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+
+            if (m_idle.size() >= m_capacity)
+            {
+                return false;
+            }
+
+            m_idle.emplace_back(kind, name);
+            return true;
+        }
+    }
+
+    TempTable::TempTable() : m_name(CreateTempTableName())
+    {
+    }
 
-        wchar_t guidAsString[MAX_PATH];
-        THROW_HR_IF(E_UNEXPECTED, StringFromGUID2(tempName, guidAsString, MAX_PATH) == 0);
+    TempTable::TempTable(const Connection& connection, std::string_view kind) :
+        m_kind(kind), m_pool(connection.m_tempTablePool)
+    {
+        if (m_pool)
+        {
+            m_name = m_pool->Acquire(m_kind);
+        }
 
-        m_name = Utility::ConvertToUTF8(guidAsString);
+        if (m_name.empty())
+        {
+            m_name = CreateTempTableName();
+        }
+        else
+        {
+            m_reused = true;
+            InitDropStatement(connection);
+        }
     }
 
     TempTable::~TempTable()
     {
+        if (m_clearTableStatement)
+        {
+            try
+            {
+                m_clearTableStatement.Execute();
+                // The statement must not still be in use by this table once another can take it.
+                m_clearTableStatement = Statement{};
+
+                if (m_pool->Release(m_kind, m_name))
+                {
+                    return;
+                }
+            }
+            CATCH_LOG();
+        }
+
         if (m_dropTableStatement)
         {
             m_dropTableStatement.Execute();
@@ -34,9 +109,19 @@ namespace AppInstaller::Repository::SQLite
 
     void TempTable::InitDropStatement(const Connection& connection)
     {
-        Builder::StatementBuilder builder;
-        builder.DropTable(m_name);
-        
-        m_dropTableStatement = builder.Prepare(connection);
+        {
+            Builder::StatementBuilder builder;
+            builder.DropTable(m_name);
+
+            m_dropTableStatement = builder.Prepare(connection);
+        }
+
+        if (m_pool)
+        {
+            Builder::StatementBuilder builder;
+            builder.DeleteFrom(GetQualifiedName());
+
+            m_clearTableStatement = builder.Prepare(connection);
+        }
     }
 }
@@ -4,14 +4,51 @@
 #include "SQLiteWrapper.h"
 #include "SQLiteStatementBuilder.h"
 
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace AppInstaller::Repository::SQLite
 {
+    namespace details
+    {
+        // Holds emptied temp tables that are no longer in use so that they can be handed out again.
+        // Reusing a table avoids the schema changes of creating and dropping it, and keeps the text of the statements
+        // that use it the same so that they are found in the statement cache.
+        struct TempTablePool
+        {
+            TempTablePool(size_t capacity) : m_capacity(capacity) {}
+
+            TempTablePool(const TempTablePool&) = delete;
+            TempTablePool& operator=(const TempTablePool&) = delete;
+
+            // Takes the name of an idle table of the given kind out of the pool; returns an empty string if there is none.
+            std::string Acquire(std::string_view kind);
+
+            // Makes the emptied table available for reuse.
+            // Returns false if the pool is full, in which case the table should be dropped instead.
+            bool Release(std::string_view kind, const std::string& name);
+
+        private:
+            std::mutex m_lock;
+            size_t m_capacity;
+            // Pairs of kind and table name.
+            std::vector<std::pair<std::string, std::string>> m_idle;
+        };
+    }
+
     // The base for a class that represents a temp table.
     struct TempTable
     {
+        // Creates a table that is dropped when it is no longer needed.
         TempTable();
 
+        // Takes a table of the given kind from the connection's pool if one is available; all tables of a kind must have the same schema.
+        // When no longer needed, the table is emptied and returned to the pool rather than dropped.
+        TempTable(const Connection& connection, std::string_view kind);
+
         ~TempTable();
 
         TempTable(const TempTable&) = delete;
@@ -24,12 +61,19 @@ namespace AppInstaller::Repository::SQLite
         // Gets the qualified name of the temp table.
         Builder::QualifiedTable GetQualifiedName() const;
 
+        // Determines if the table was taken from the pool, and so already exists and does not need to be created.
+        bool IsReused() const { return m_reused; }
+
         // Prepares the drop table statement for use in destructor.
         // It needs to be run by the derived class after the table is actually created.
         void InitDropStatement(const Connection& connection);
 
     private:
         std::string m_name;
+        std::string m_kind;
+        std::shared_ptr<details::TempTablePool> m_pool;
+        bool m_reused = false;
         Statement m_dropTableStatement;
+        Statement m_clearTableStatement;
     };
 }
@@ -2,10 +2,20 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "SQLiteWrapper.h"
+#include "SQLiteTempTable.h"
 #include "ICU/SQLiteICU.h"
 
 #include <wil/result_macros.h>
 
+#include <winget/AllocationTracking.h>
+#include <winget/MemoryTrim.h>
+#include <winget/ThreadGlobals.h>
+#include <winget/Timing.h>
+
+#include <list>
+#include <mutex>
+#include <set>
+
 using namespace std::string_view_literals;
 
 // Enable this to have all Statement constructions output the associated query plan.
@@ -41,10 +51,248 @@ namespace AppInstaller::Repository::SQLite
             static std::atomic_size_t statementId(0);
             return ++statementId;
         }
+
+        // The number of idle prepared statements kept per connection.
+        constexpr size_t s_StatementCacheCapacity = 128;
+
+        // The number of idle temp tables kept per connection.
+        constexpr size_t s_TempTablePoolCapacity = 8;
+
+        // The open connections, whose page caches are released when the process trims its memory.
+        struct OpenConnections
+        {
+            std::mutex Lock;
+            std::set<sqlite3*> Connections;
+        };
+
+        OpenConnections& GetOpenConnections()
+        {
+            // Intentionally never destroyed, as connections held by other statics may be closed after it would be.
+            static OpenConnections* s_openConnections = []()
+            {
+                // Connections are opened with SQLITE_OPEN_FULLMUTEX, so this is safe while they are in use.
+                Memory::RegisterTrimFunction([]()
+                    {
+                        OpenConnections& openConnections = GetOpenConnections();
+                        std::lock_guard<std::mutex> lock{ openConnections.Lock };
+                        for (sqlite3* connection : openConnections.Connections)
+                        {
+                            sqlite3_db_release_memory(connection);
+                        }
+                    });
+
+                return new OpenConnections();
+            }();
+
+            return *s_openConnections;
+        }
+
+        // The number of virtual machine instructions between checks for the cancellation of the work on the current thread.
+        constexpr int s_CancellationCheckInstructions = 10000;
+
+        // Set while a statement that must not fail is evaluated, so that it is never interrupted.
+        thread_local bool t_isUninterruptible = false;
+
+        // Interrupts the statement being evaluated on the current thread once its work has been cancelled.
+        int CancellationProgressHandler(void*) noexcept try
+        {
+            return (!t_isUninterruptible && ThreadLocalStorage::IsCurrentThreadCancelled()) ? 1 : 0;
+        }
+        catch (...)
+        {
+            return 0;
+        }
+
+        void AddOpenConnection(sqlite3* connection)
+        {
+            OpenConnections& openConnections = GetOpenConnections();
+            std::lock_guard<std::mutex> lock{ openConnections.Lock };
+            openConnections.Connections.insert(connection);
+        }
+
+        void RemoveOpenConnection(sqlite3* connection)
+        {
+            OpenConnections& openConnections = GetOpenConnections();
+            std::lock_guard<std::mutex> lock{ openConnections.Lock };
+            openConnections.Connections.erase(connection);
+        }
+
+        // The values are as SQLite returns them from the pragma.
+        std::string_view ToString(Connection::JournalMode mode)
+        {
+            switch (mode)
+            {
+            case Connection::JournalMode::Delete: return "delete"sv;
+            case Connection::JournalMode::Truncate: return "truncate"sv;
+            case Connection::JournalMode::Persist: return "persist"sv;
+            case Connection::JournalMode::Memory: return "memory"sv;
+            case Connection::JournalMode::Wal: return "wal"sv;
+            case Connection::JournalMode::Off: return "off"sv;
+            }
+
+            THROW_HR(E_UNEXPECTED);
+        }
+
+        std::string_view ToString(Connection::Synchronous synchronous)
+        {
+            switch (synchronous)
+            {
+            case Connection::Synchronous::Off: return "OFF"sv;
+            case Connection::Synchronous::Normal: return "NORMAL"sv;
+            case Connection::Synchronous::Full: return "FULL"sv;
+            case Connection::Synchronous::Extra: return "EXTRA"sv;
+            }
+
+            THROW_HR(E_UNEXPECTED);
+        }
+
+        std::string_view ToString(Connection::TempStore tempStore)
+        {
+            switch (tempStore)
+            {
+            case Connection::TempStore::Default: return "DEFAULT"sv;
+            case Connection::TempStore::File: return "FILE"sv;
+            case Connection::TempStore::Memory: return "MEMORY"sv;
+            }
+
+            THROW_HR(E_UNEXPECTED);
+        }
+
+#if WINGET_SQLITE_STATEMENT_PROFILE_ENABLED
+        // One in this many statements is profiled.
+        constexpr size_t s_StatementProfileSampleRate = 16;
+#endif
+
+#if WINGET_ALLOCATION_TRACKING_ENABLED
+        // SQLite allocates with its own allocator rather than operator new, so it is wrapped to count that memory.
+        sqlite3_mem_methods s_DefaultMemMethods{};
+
+        void RecordSQLiteAllocation(void* allocation, bool isFree)
+        {
+            int64_t size = s_DefaultMemMethods.xSize(allocation);
+            Memory::RecordExternalAllocation(Memory::AllocationSubsystem::SQLite, isFree ? -size : size);
+        }
+
+        void* TrackedMalloc(int size)
+        {
+            void* result = s_DefaultMemMethods.xMalloc(size);
+            if (result)
+            {
+                RecordSQLiteAllocation(result, false);
+            }
+            return result;
+        }
+
+        void TrackedFree(void* allocation)
+        {
+            if (allocation)
+            {
+                RecordSQLiteAllocation(allocation, true);
+            }
+            s_DefaultMemMethods.xFree(allocation);
+        }
+
+        void* TrackedRealloc(void* allocation, int size)
+        {
+            int64_t previousSize = allocation ? s_DefaultMemMethods.xSize(allocation) : 0;
+            void* result = s_DefaultMemMethods.xRealloc(allocation, size);
+
+            // A failed reallocation leaves the original allocation as it was.
+            if (result)
+            {
+                if (allocation)
+                {
+                    Memory::RecordExternalAllocation(Memory::AllocationSubsystem::SQLite, -previousSize);
+                }
+                RecordSQLiteAllocation(result, false);
+            }
+            return result;
+        }
+
+        // The allocator can only be replaced before SQLite is initialized, which the first connection does.
+        void EnsureSQLiteAllocationsTracked()
+        {
+            static std::once_flag s_once;
+            std::call_once(s_once, []()
+                {
+                    sqlite3_config(SQLITE_CONFIG_GETMALLOC, &s_DefaultMemMethods);
+
+                    sqlite3_mem_methods tracked = s_DefaultMemMethods;
+                    tracked.xMalloc = TrackedMalloc;
+                    tracked.xFree = TrackedFree;
+                    tracked.xRealloc = TrackedRealloc;
+
+                    int result = sqlite3_config(SQLITE_CONFIG_MALLOC, &tracked);
+                    if (result != SQLITE_OK)
+                    {
+                        AICLI_LOG(SQL, Warning, << "SQLite allocations are not tracked, as its allocator could not be replaced: " << result);
+                    }
+                });
+        }
+#endif
     }
 
     namespace details
     {
+        struct StatementCache
+        {
+            StatementCache(size_t capacity) : m_capacity(capacity) {}
+
+            StatementCache(const StatementCache&) = delete;
+            StatementCache& operator=(const StatementCache&) = delete;
+
+            ~StatementCache()
+            {
+                for (auto& entry : m_idle)
+                {
+                    sqlite3_finalize(entry.second);
+                }
+            }
+
+            // Takes an idle statement for the given SQL out of the cache; returns null if there is none.
+            sqlite3_stmt* Acquire(std::string_view sql)
+            {
+                std::lock_guard<std::mutex> lock{ m_lock };
+
+                // Most recently used entries are at the front.
+                for (auto itr = m_idle.begin(); itr != m_idle.end(); ++itr)
+                {
+                    if (itr->first == sql)
+                    {
+                        sqlite3_stmt* result = itr->second;
+                        m_idle.erase(itr);
+                        return result;
+                    }
+                }
+
+                return nullptr;
+            }
+
+            // Resets the statement and makes it available for reuse, finalizing the least recently used when over capacity.
+            void Release(std::string&& sql, sqlite3_stmt* stmt)
+            {
+                // Ignore return values; an error here is the error from the last step, which has already been reported.
+                // Resetting also ends any read transaction the statement is holding open.
+                sqlite3_reset(stmt);
+                sqlite3_clear_bindings(stmt);
+
+                std::lock_guard<std::mutex> lock{ m_lock };
+
+                m_idle.emplace_front(std::move(sql), stmt);
+
+                while (m_idle.size() > m_capacity)
+                {
+                    sqlite3_finalize(m_idle.back().second);
+                    m_idle.pop_back();
+                }
+            }
+
+        private:
+            std::mutex m_lock;
+            size_t m_capacity;
+            std::list<std::pair<std::string, sqlite3_stmt*>> m_idle;
+        };
+
         void ParameterSpecificsImpl<nullptr_t>::Bind(sqlite3_stmt* stmt, int index, nullptr_t)
         {
             THROW_IF_SQLITE_FAILED(sqlite3_bind_null(stmt, index));
@@ -136,7 +384,40 @@ namespace AppInstaller::Repository::SQLite
         AICLI_LOG(SQL, Info, << "Opening SQLite connection: '" << target << "' [" << std::hex << static_cast<int>(disposition) << ", " << std::hex << static_cast<int>(flags) << "]");
         // Always force connection serialization until we determine that there are situations where it is not needed
         int resultingFlags = static_cast<int>(disposition) | static_cast<int>(flags) | SQLITE_OPEN_FULLMUTEX;
+#if WINGET_ALLOCATION_TRACKING_ENABLED
+        EnsureSQLiteAllocationsTracked();
+#endif
+        Memory::AllocationScope allocationScope{ Memory::AllocationSubsystem::SQLite };
         THROW_IF_SQLITE_FAILED(sqlite3_open_v2(target.c_str(), &m_dbconn, resultingFlags, nullptr));
+        m_statementCache = std::make_shared<details::StatementCache>(s_StatementCacheCapacity);
+        m_tempTablePool = std::make_shared<details::TempTablePool>(s_TempTablePoolCapacity);
+        sqlite3_progress_handler(m_dbconn.get(), s_CancellationCheckInstructions, CancellationProgressHandler, nullptr);
+        AddOpenConnection(m_dbconn.get());
+    }
+
+    Connection& Connection::operator=(Connection&& other)
+    {
+        if (this != &other)
+        {
+            if (m_dbconn)
+            {
+                RemoveOpenConnection(m_dbconn.get());
+            }
+
+            m_statementCache = std::move(other.m_statementCache);
+            m_tempTablePool = std::move(other.m_tempTablePool);
+            m_dbconn = std::move(other.m_dbconn);
+        }
+
+        return *this;
+    }
+
+    Connection::~Connection()
+    {
+        if (m_dbconn)
+        {
+            RemoveOpenConnection(m_dbconn.get());
+        }
     }
 
     Connection Connection::Create(const std::string& target, OpenDisposition disposition, OpenFlags flags)
@@ -164,9 +445,104 @@ namespace AppInstaller::Repository::SQLite
         return sqlite3_changes(m_dbconn.get());
     }
 
+    int64_t Connection::SetMemoryMapSize(int64_t size)
+    {
+        // Pragma values cannot be bound as parameters.
+        Statement statement = Statement::Create(*this, "PRAGMA mmap_size = " + std::to_string(size));
+
+        int64_t result = 0;
+        if (statement.Step())
+        {
+            result = statement.GetColumn<int64_t>(0);
+        }
+
+        AICLI_LOG(SQL, Verbose, << "Memory map size requested " << size << ", set to " << result);
+        return result;
+    }
+
+    Connection::JournalMode Connection::SetJournalMode(JournalMode mode)
+    {
+        // Pragma values cannot be bound as parameters.
+        Statement statement = Statement::Create(*this, "PRAGMA journal_mode = " + std::string{ ToString(mode) });
+
+        JournalMode result = mode;
+        if (statement.Step())
+        {
+            std::string resultString = statement.GetColumn<std::string>(0);
+            for (JournalMode value : { JournalMode::Delete, JournalMode::Truncate, JournalMode::Persist, JournalMode::Memory, JournalMode::Wal, JournalMode::Off })
+            {
+                if (resultString == ToString(value))
+                {
+                    result = value;
+                }
+            }
+        }
+
+        AICLI_LOG(SQL, Verbose, << "Journal mode requested " << ToString(mode) << ", set to " << ToString(result));
+        return result;
+    }
+
+    void Connection::SetSynchronous(Synchronous synchronous)
+    {
+        Statement statement = Statement::Create(*this, "PRAGMA synchronous = " + std::string{ ToString(synchronous) });
+        statement.Execute();
+    }
+
+    void Connection::SetCacheSize(int64_t kibibytes)
+    {
+        // A negative value sets the size in kibibytes rather than in pages.
+        Statement statement = Statement::Create(*this, "PRAGMA cache_size = " + std::to_string(-kibibytes));
+        statement.Execute();
+    }
+
+    void Connection::SetTempStore(TempStore tempStore)
+    {
+        Statement statement = Statement::Create(*this, "PRAGMA temp_store = " + std::string{ ToString(tempStore) });
+        statement.Execute();
+    }
+
+    void Connection::SetPageSize(int64_t bytes)
+    {
+        THROW_HR_IF(E_INVALIDARG, bytes < 512 || bytes > 65536 || (bytes & (bytes - 1)) != 0);
+
+        Statement statement = Statement::Create(*this, "PRAGMA page_size = " + std::to_string(bytes));
+        statement.Execute();
+    }
+
+    int64_t Connection::GetPageSize()
+    {
+        Statement statement = Statement::Create(*this, "PRAGMA page_size");
+        THROW_HR_IF(E_UNEXPECTED, !statement.Step());
+        return statement.GetColumn<int64_t>(0);
+    }
+
     Statement::Statement(const Connection& connection, std::string_view sql)
     {
+        Memory::AllocationScope allocationScope{ Memory::AllocationSubsystem::SQLite };
         m_id = GetNextStatementId();
+        m_cache = connection.m_statementCache;
+        m_verboseLogging = Logging::Log().IsEnabled(Logging::Channel::SQL, Logging::Level::Verbose);
+#if WINGET_SQLITE_STATEMENT_PROFILE_ENABLED
+        m_profile = (m_id % s_StatementProfileSampleRate) == 0;
+        if (m_profile && m_sql.empty())
+        {
+            m_sql = sql;
+        }
+#endif
+
+        if (m_cache)
+        {
+            m_sql = sql;
+
+            sqlite3_stmt* cached = m_cache->Acquire(sql);
+            if (cached)
+            {
+                AICLI_LOG(SQL, Verbose, << "Reusing prepared statement #" << m_id << ": " << sql);
+                m_stmt.reset(cached);
+                return;
+            }
+        }
+
         AICLI_LOG(SQL, Verbose, << "Preparing statement #" << m_id << ": " << sql);
         // SQL string size should include the null terminator (https://www.sqlite.org/c3ref/prepare.html)
         assert(sql.data()[sql.size()] == '\0');
@@ -231,27 +607,128 @@ namespace AppInstaller::Repository::SQLite
         return { connection, sql };
     }
 
+    Statement& Statement::operator=(Statement&& other)
+    {
+        if (this != &other)
+        {
+            ReturnToCache();
+
+            m_id = other.m_id;
+            m_stmt = std::move(other.m_stmt);
+            m_state = other.m_state;
+            m_cache = std::move(other.m_cache);
+            m_sql = std::move(other.m_sql);
+            m_verboseLogging = other.m_verboseLogging;
+#if WINGET_SQLITE_STATEMENT_PROFILE_ENABLED
+            m_profile = std::exchange(other.m_profile, false);
+            m_bindCount = other.m_bindCount;
+            m_stepCount = other.m_stepCount;
+            m_stepTime = other.m_stepTime;
+#endif
+        }
+
+        return *this;
+    }
+
+    Statement::~Statement()
+    {
+        ReturnToCache();
+    }
+
+    void Statement::ReturnToCache()
+    {
+#if WINGET_SQLITE_STATEMENT_PROFILE_ENABLED
+        LogProfile();
+#endif
+
+        if (m_cache && m_stmt)
+        {
+            sqlite3_stmt* stmt = m_stmt.release();
+
+            try
+            {
+                m_cache->Release(std::move(m_sql), stmt);
+            }
+            catch (...)
+            {
+                sqlite3_finalize(stmt);
+            }
+        }
+
+        m_cache.reset();
+    }
+
+#if WINGET_SQLITE_STATEMENT_PROFILE_ENABLED
+    void Statement::LogProfile()
+    {
+        if (m_profile && m_stmt)
+        {
+            AICLI_LOG(SQL, Info, << "Statement profile #" << m_id << ": binds " << m_bindCount << ", steps " << m_stepCount << ", step time " <<
+                std::chrono::duration_cast<std::chrono::microseconds>(m_stepTime).count() << "us: " << m_sql);
+        }
+
+        m_profile = false;
+    }
+#endif
+
     bool Statement::Step(bool failFastOnError)
     {
-        AICLI_LOG(SQL, Verbose, << "Stepping statement #" << m_id);
+        if (m_verboseLogging)
+        {
+            AICLI_LOG(SQL, Verbose, << "Stepping statement #" << m_id);
+        }
+
+        bool wasUninterruptible = std::exchange(t_isUninterruptible, t_isUninterruptible || failFastOnError);
+        auto restoreUninterruptible = wil::scope_exit([&]() { t_isUninterruptible = wasUninterruptible; });
+
+        // The resources report counts every step, unlike the profile, which samples statements.
+        bool countUsage = Timing::IsUsageEnabled();
+
+#if WINGET_SQLITE_STATEMENT_PROFILE_ENABLED
+        auto stepStart = (m_profile || countUsage) ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+        int result = sqlite3_step(m_stmt.get());
+        if (m_profile)
+        {
+            ++m_stepCount;
+            m_stepTime += std::chrono::steady_clock::now() - stepStart;
+        }
+#else
+        auto stepStart = countUsage ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
         int result = sqlite3_step(m_stmt.get());
+#endif
+
+        if (countUsage)
+        {
+            Timing::RecordSqlStep(m_state == State::Prepared, std::chrono::steady_clock::now() - stepStart);
+        }
 
         if (result == SQLITE_ROW)
         {
-            AICLI_LOG(SQL, Verbose, << "Statement #" << m_id << " has data");
+            if (m_verboseLogging)
+            {
+                AICLI_LOG(SQL, Verbose, << "Statement #" << m_id << " has data");
+            }
             m_state = State::HasRow;
             return true;
         }
         else if (result == SQLITE_DONE)
         {
-            AICLI_LOG(SQL, Verbose, << "Statement #" << m_id << " has completed");
+            if (m_verboseLogging)
+            {
+                AICLI_LOG(SQL, Verbose, << "Statement #" << m_id << " has completed");
+            }
             m_state = State::Completed;
             return false;
         }
         else
         {
             m_state = State::Error;
-            if (failFastOnError)
+            if (result == SQLITE_INTERRUPT)
+            {
+                AICLI_LOG(SQL, Info, << "Statement #" << m_id << " was interrupted as its work was cancelled");
+                THROW_HR(E_ABORT);
+            }
+            else if (failFastOnError)
             {
                 FAIL_FAST_MSG("Critical SQL statement failed");
             }
@@ -275,7 +752,10 @@ namespace AppInstaller::Repository::SQLite
 
     void Statement::Reset()
     {
-        AICLI_LOG(SQL, Verbose, << "Reset statement #" << m_id);
+        if (m_verboseLogging)
+        {
+            AICLI_LOG(SQL, Verbose, << "Reset statement #" << m_id);
+        }
         // Ignore return value from reset, as if it is an error, it was the error from the last call to step.
         sqlite3_reset(m_stmt.get());
         m_state = State::Prepared;
@@ -8,6 +8,7 @@
 #include <AppInstallerLogging.h>
 #include <AppInstallerLanguageUtilities.h>
 
+#include <memory>
 #include <string>
 #include <string_view>
 #include <tuple>
@@ -17,6 +18,13 @@
 
 #define SQLITE_MEMORY_DB_CONNECTION_TARGET ":memory:"
 
+// Enable this to have a sample of statements log their SQL, bind count, step count, and time spent stepping when they are done.
+#define WINGET_SQLITE_STATEMENT_PROFILE_ENABLED 0
+
+#if WINGET_SQLITE_STATEMENT_PROFILE_ENABLED
+#include <chrono>
+#endif
+
 using namespace std::string_view_literals;
 
 namespace AppInstaller::Repository::SQLite
@@ -32,6 +40,12 @@ namespace AppInstaller::Repository::SQLite
 
     namespace details
     {
+        // Holds prepared statements that are not in use so that they can be handed out again.
+        struct StatementCache;
+
+        // Holds temp tables that are not in use so that they can be handed out again.
+        struct TempTablePool;
+
         template <typename T, typename = void>
         struct ParameterSpecificsImpl
         {
@@ -133,6 +147,9 @@ namespace AppInstaller::Repository::SQLite
     // The connection to a database.
     struct Connection
     {
+        friend struct Statement;
+        friend struct TempTable;
+
         // The disposition for opening a database connection.
         enum class OpenDisposition : int
         {
@@ -153,6 +170,35 @@ namespace AppInstaller::Repository::SQLite
             Uri = SQLITE_OPEN_URI,
         };
 
+        // The journal mode of a database connection; see the journal_mode pragma.
+        enum class JournalMode
+        {
+            Delete,
+            Truncate,
+            Persist,
+            Memory,
+            // Write ahead logging; unlike the others, this mode is stored in the database file.
+            Wal,
+            Off,
+        };
+
+        // How often the database file is synced to disk; see the synchronous pragma.
+        enum class Synchronous
+        {
+            Off,
+            Normal,
+            Full,
+            Extra,
+        };
+
+        // Where temporary tables and indices are stored; see the temp_store pragma.
+        enum class TempStore
+        {
+            Default,
+            File,
+            Memory,
+        };
+
         static Connection Create(const std::string& target, OpenDisposition disposition, OpenFlags flags = OpenFlags::None);
 
         Connection() = default;
@@ -161,9 +207,9 @@ namespace AppInstaller::Repository::SQLite
         Connection& operator=(const Connection&) = delete;
 
         Connection(Connection&& other) = default;
-        Connection& operator=(Connection&& other) = default;
+        Connection& operator=(Connection&& other);
 
-        ~Connection() = default;
+        ~Connection();
 
         // Enables the ICU integrations on this connection.
         void EnableICU();
@@ -174,12 +220,39 @@ namespace AppInstaller::Repository::SQLite
         // Gets the count of changed rows for the last executed statement.
         int GetChanges() const;
 
+        // Sets the maximum number of bytes of the database file that will be read through a memory mapping rather than copied into the page cache.
+        // Returns the size actually in effect, as SQLite limits it to its compile time maximum (it may be 0 if memory mapping is not supported).
+        int64_t SetMemoryMapSize(int64_t size);
+
+        // Sets the journal mode of the connection; this cannot be changed to or from Wal within a transaction.
+        // Returns the mode actually in effect, as SQLite keeps the current mode if the requested one is not available.
+        JournalMode SetJournalMode(JournalMode mode);
+
+        // Sets how often the database file is synced to disk.
+        void SetSynchronous(Synchronous synchronous);
+
+        // Sets the maximum size of the page cache of the connection, in kibibytes.
+        void SetCacheSize(int64_t kibibytes);
+
+        // Sets where temporary tables and indices are stored.
+        void SetTempStore(TempStore tempStore);
+
+        // Sets the size of the pages of the database, in bytes; it must be a power of two between 512 and 65536.
+        // An existing database only changes to the new size when it is vacuumed, and not while it uses a write ahead log.
+        void SetPageSize(int64_t bytes);
+
+        // Gets the size of the pages of the database, in bytes.
+        int64_t GetPageSize();
+
         operator sqlite3* () const { return m_dbconn.get(); }
 
     private:
         Connection(const std::string& target, OpenDisposition disposition, OpenFlags flags);
 
         wil::unique_any<sqlite3*, decltype(sqlite3_close_v2), sqlite3_close_v2> m_dbconn;
+        // Destroyed before the connection is closed; statements still in use keep it alive and return to it when they are done.
+        std::shared_ptr<details::StatementCache> m_statementCache;
+        std::shared_ptr<details::TempTablePool> m_tempTablePool;
     };
 
     // A SQL statement.
@@ -195,7 +268,10 @@ namespace AppInstaller::Repository::SQLite
         Statement& operator=(const Statement&) = delete;
 
         Statement(Statement&& other) = default;
-        Statement& operator=(Statement&& other) = default;
+        Statement& operator=(Statement&& other);
+
+        // Returns the prepared statement to the connection's cache, rather than finalizing it.
+        ~Statement();
 
         operator sqlite3_stmt* () const { return m_stmt.get(); }
 
@@ -220,7 +296,13 @@ namespace AppInstaller::Repository::SQLite
         template <typename Value>
         void Bind(int index, Value&& v)
         {
-            AICLI_LOG(SQL, Verbose, << "Binding statement #" << m_id << ": " << index << " => " << details::ParameterSpecifics<Value>::ToLog(std::forward<Value>(v)));
+            if (m_verboseLogging)
+            {
+                AICLI_LOG(SQL, Verbose, << "Binding statement #" << m_id << ": " << index << " => " << details::ParameterSpecifics<Value>::ToLog(v));
+            }
+#if WINGET_SQLITE_STATEMENT_PROFILE_ENABLED
+            ++m_bindCount;
+#endif
             details::ParameterSpecifics<Value>::Bind(m_stmt.get(), index, std::forward<Value>(v));
         }
 
@@ -275,9 +357,24 @@ namespace AppInstaller::Repository::SQLite
             return std::make_tuple(details::ParameterSpecifics<Values>::GetColumn(m_stmt.get(), I)...);
         }
 
+        // Hands the prepared statement back to the cache, if it came from a connection that has one.
+        void ReturnToCache();
+
         size_t m_id = 0;
         wil::unique_any<sqlite3_stmt*, decltype(sqlite3_finalize), sqlite3_finalize> m_stmt;
         State m_state = State::Prepared;
+        std::shared_ptr<details::StatementCache> m_cache;
+        std::string m_sql;
+        // Determined once at creation, so that the per bind and step logging costs a single branch when it is off.
+        bool m_verboseLogging = false;
+#if WINGET_SQLITE_STATEMENT_PROFILE_ENABLED
+        void LogProfile();
+
+        bool m_profile = false;
+        size_t m_bindCount = 0;
+        size_t m_stepCount = 0;
+        std::chrono::steady_clock::duration m_stepTime{};
+#endif
     };
 
     // A SQLite savepoint.
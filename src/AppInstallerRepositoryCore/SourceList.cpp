@@ -27,6 +27,18 @@ namespace AppInstaller::Repository
         constexpr std::string_view s_MetadataYaml_Source_AcceptedAgreementsIdentifier = "AcceptedAgreementsIdentifier"sv;
         constexpr std::string_view s_MetadataYaml_Source_AcceptedAgreementFields = "AcceptedAgreementFields"sv;
 
+        // The metadata is rewritten whenever a source is updated, so it is stored in a compact form rather than YAML.
+        // It has a stream of its own, as earlier versions fail to read anything but YAML from the metadata stream.
+        // The header line holds the hash of the YAML metadata that was read along with it; if an earlier version has
+        // written the YAML since, it no longer matches, and the YAML is read instead.
+        // After the header, each source is a line of: LastUpdate AcceptedAgreementFields AcceptedAgreementsIdentifier Name
+        // The strings are written as their byte count, a colon, then the bytes.
+        // Only text is written, as the settings stream may be stored as a string.
+        constexpr std::string_view s_MetadataCompact_Header = "#WGSM1 "sv;
+
+        // The hash of the YAML metadata when there is none.
+        constexpr std::string_view s_MetadataYaml_AbsentHash = "-"sv;
+
         constexpr std::string_view s_Source_WingetCommunityDefault_Name = "winget"sv;
         constexpr std::string_view s_Source_WingetCommunityDefault_Arg = "https://winget.azureedge.net/cache"sv;
         constexpr std::string_view s_Source_WingetCommunityDefault_Data = "Microsoft.Winget.Source_8wekyb3d8bbwe"sv;
@@ -60,6 +72,116 @@ namespace AppInstaller::Repository
             return true;
         }
 
+        void AppendCompact(std::string& out, int64_t value)
+        {
+            out.append(std::to_string(value));
+            out.push_back(' ');
+        }
+
+        void AppendCompact(std::string& out, std::string_view value)
+        {
+            out.append(std::to_string(value.size()));
+            out.push_back(':');
+            out.append(value);
+        }
+
+        bool ReadCompact(std::string_view& in, int64_t& value)
+        {
+            size_t end = in.find(' ');
+            if (end == std::string_view::npos || end == 0)
+            {
+                return false;
+            }
+
+            try
+            {
+                size_t parsed = 0;
+                value = std::stoll(std::string{ in.substr(0, end) }, &parsed);
+                if (parsed != end)
+                {
+                    return false;
+                }
+            }
+            catch (...)
+            {
+                return false;
+            }
+
+            in.remove_prefix(end + 1);
+            return true;
+        }
+
+        bool ReadCompact(std::string_view& in, std::string& value)
+        {
+            size_t end = in.find(':');
+            if (end == std::string_view::npos || end == 0 || end > 9)
+            {
+                return false;
+            }
+
+            size_t size = 0;
+            for (char c : in.substr(0, end))
+            {
+                if (c < '0' || c > '9')
+                {
+                    return false;
+                }
+                size = size * 10 + (c - '0');
+            }
+
+            in.remove_prefix(end + 1);
+            if (in.size() < size)
+            {
+                return false;
+            }
+
+            value = in.substr(0, size);
+            in.remove_prefix(size);
+            return true;
+        }
+
+        // Attempts to read the source metadata from its compact form.
+        // Results are all or nothing; if any failures occur, no details are returned.
+        bool TryReadCompactMetadata(std::string_view settingName, std::string_view settingValue, std::vector<SourceDetailsInternal>& sourceDetails)
+        {
+            std::string_view in = settingValue;
+            size_t headerEnd = in.find('\n');
+            if (in.compare(0, s_MetadataCompact_Header.size(), s_MetadataCompact_Header) != 0 || headerEnd == std::string_view::npos)
+            {
+                AICLI_LOG(Repo, Error, << "Setting '" << settingName << "' did not contain the expected header:\n" << settingValue);
+                return false;
+            }
+
+            in.remove_prefix(headerEnd + 1);
+            std::vector<SourceDetailsInternal> result;
+
+            while (!in.empty())
+            {
+                SourceDetailsInternal details;
+                details.Origin = SourceOrigin::Metadata;
+
+                int64_t lastUpdateInEpoch = 0;
+                int64_t acceptedAgreementFields = 0;
+                if (!ReadCompact(in, lastUpdateInEpoch) ||
+                    !ReadCompact(in, acceptedAgreementFields) ||
+                    !ReadCompact(in, details.AcceptedAgreementsIdentifier) ||
+                    !ReadCompact(in, details.Name) ||
+                    in.empty() || in[0] != '\n')
+                {
+                    AICLI_LOG(Repo, Error, << "Setting '" << settingName << "' did not contain the expected format:\n" << settingValue);
+                    return false;
+                }
+
+                in.remove_prefix(1);
+                details.LastUpdateTime = Utility::ConvertUnixEpochToSystemClock(lastUpdateInEpoch);
+                details.AcceptedAgreementFields = static_cast<int>(acceptedAgreementFields);
+                result.emplace_back(std::move(details));
+            }
+
+            sourceDetails = std::move(result);
+            return true;
+        }
+
         // Attempts to read the source details from the given stream.
         // Results are all or nothing; if any failures occur, no details are returned.
         bool TryReadSourceDetails(
@@ -295,7 +417,8 @@ namespace AppInstaller::Repository
         THROW_HR(E_UNEXPECTED);
     }
 
-    SourceList::SourceList() : m_userSourcesStream(Stream::UserSources), m_metadataStream(Stream::SourcesMetadata)
+    SourceList::SourceList() :
+        m_userSourcesStream(Stream::UserSources), m_metadataStream(Stream::SourcesMetadata), m_compactMetadataStream(Stream::SourcesMetadataCompact)
     {
         OverwriteSourceList();
         OverwriteMetadata();
@@ -486,6 +609,7 @@ namespace AppInstaller::Repository
     {
         Stream{ Stream::UserSources }.Remove();
         Stream{ Stream::SourcesMetadata }.Remove();
+        Stream{ Stream::SourcesMetadataCompact }.Remove();
     }
 
     void SourceList::OverwriteSourceList()
@@ -630,15 +754,59 @@ namespace AppInstaller::Repository
         THROW_HR(E_UNEXPECTED);
     }
 
+    std::string SourceList::GetYamlMetadataHash()
+    {
+        auto metadataStream = m_metadataStream.Get();
+        if (!metadataStream)
+        {
+            return std::string{ s_MetadataYaml_AbsentHash };
+        }
+
+        return Utility::SHA256::ConvertToString(Utility::SHA256::ComputeHash(Utility::ReadEntireStream(*metadataStream)));
+    }
+
     std::vector<SourceDetailsInternal> SourceList::GetMetadata()
     {
-        return GetSourcesFromSetting(
-            m_metadataStream,
-            s_MetadataYaml_Sources,
+        std::vector<SourceDetailsInternal> result;
+
+        auto metadataStream = m_metadataStream.Get();
+        std::string metadataValue;
+        if (metadataStream)
+        {
+            metadataValue = Utility::ReadEntireStream(*metadataStream);
+            m_yamlMetadataHash = Utility::SHA256::ConvertToString(Utility::SHA256::ComputeHash(metadataValue));
+        }
+        else
+        {
+            m_yamlMetadataHash = s_MetadataYaml_AbsentHash;
+        }
+
+        auto compactMetadataStream = m_compactMetadataStream.Get();
+        if (compactMetadataStream)
+        {
+            std::string compactValue = Utility::ReadEntireStream(*compactMetadataStream);
+            std::string expectedHeader = std::string{ s_MetadataCompact_Header } + m_yamlMetadataHash + '\n';
+
+            if (compactValue.compare(0, expectedHeader.size(), expectedHeader) == 0)
+            {
+                THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCES_INVALID, !TryReadCompactMetadata(m_compactMetadataStream.GetName(), compactValue, result));
+                return result;
+            }
+
+            AICLI_LOG(Repo, Info, << "Source metadata was written by an earlier version since the compact form was; reading it instead");
+        }
+
+        if (!metadataStream)
+        {
+            return {};
+        }
+
+        std::string_view name = m_metadataStream.GetName();
+        std::istringstream yamlStream{ metadataValue };
+        THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCES_INVALID, !TryReadSourceDetails(name, yamlStream, s_MetadataYaml_Sources,
             [&](SourceDetailsInternal& details, const std::string& settingValue, const YAML::Node& source)
             {
                 details.Origin = SourceOrigin::Metadata;
-                std::string_view name = m_metadataStream.GetName();
                 if (!TryReadScalar(name, settingValue, source, s_MetadataYaml_Source_Name, details.Name)) { return false; }
                 int64_t lastUpdateInEpoch{};
                 if (!TryReadScalar(name, settingValue, source, s_MetadataYaml_Source_LastUpdate, lastUpdateInEpoch)) { return false; }
@@ -646,30 +814,33 @@ namespace AppInstaller::Repository
                 TryReadScalar(name, settingValue, source, s_MetadataYaml_Source_AcceptedAgreementsIdentifier, details.AcceptedAgreementsIdentifier, false);
                 TryReadScalar(name, settingValue, source, s_MetadataYaml_Source_AcceptedAgreementFields, details.AcceptedAgreementFields, false);
                 return true;
-            });
+            }, result));
+
+        return result;
     }
 
     bool SourceList::SetMetadata(const std::vector<SourceDetailsInternal>& sources)
     {
-        YAML::Emitter out;
-        out << YAML::BeginMap;
-        out << YAML::Key << s_MetadataYaml_Sources;
-        out << YAML::BeginSeq;
+        // If an earlier version has written the YAML since it was read, the compact form would hide that write
+        if (GetYamlMetadataHash() != m_yamlMetadataHash)
+        {
+            return false;
+        }
+
+        std::string out{ s_MetadataCompact_Header };
+        out.append(m_yamlMetadataHash);
+        out.push_back('\n');
 
         for (const auto& details : sources)
         {
-            out << YAML::BeginMap;
-            out << YAML::Key << s_MetadataYaml_Source_Name << YAML::Value << details.Name;
-            out << YAML::Key << s_MetadataYaml_Source_LastUpdate << YAML::Value << Utility::ConvertSystemClockToUnixEpoch(details.LastUpdateTime);
-            out << YAML::Key << s_MetadataYaml_Source_AcceptedAgreementsIdentifier << YAML::Value << details.AcceptedAgreementsIdentifier;
-            out << YAML::Key << s_MetadataYaml_Source_AcceptedAgreementFields << YAML::Value << details.AcceptedAgreementFields;
-            out << YAML::EndMap;
+            AppendCompact(out, Utility::ConvertSystemClockToUnixEpoch(details.LastUpdateTime));
+            AppendCompact(out, static_cast<int64_t>(details.AcceptedAgreementFields));
+            AppendCompact(out, details.AcceptedAgreementsIdentifier);
+            AppendCompact(out, details.Name);
+            out.push_back('\n');
         }
 
-        out << YAML::EndSeq;
-        out << YAML::EndMap;
-
-        return m_metadataStream.Set(out.str());
+        return m_compactMetadataStream.Set(out);
     }
 
     void SourceList::SaveMetadataInternal(const SourceDetailsInternal& detailsRef, bool remove)
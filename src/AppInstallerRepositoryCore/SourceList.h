@@ -90,8 +90,14 @@ namespace AppInstaller::Repository
         // If remove is true, the given source is being removed.
         void SaveMetadataInternal(const SourceDetailsInternal& details, bool remove = false);
 
+        // Gets the hash that identifies the current content of the YAML metadata stream.
+        std::string GetYamlMetadataHash();
+
         std::vector<SourceDetailsInternal> m_sourceList;
         Settings::Stream m_userSourcesStream;
         Settings::Stream m_metadataStream;
+        Settings::Stream m_compactMetadataStream;
+        // The hash of the YAML metadata when the metadata was last read.
+        std::string m_yamlMetadataHash;
     };
 }
@@ -18,6 +18,7 @@ namespace IndexCreationTool
             string rootDir = string.Empty;
             string appxManifestPath = string.Empty;
             string certPath = string.Empty;
+            bool embedManifests = false;
 
             for (int i = 0; i < args.Length; i++)
             {
@@ -33,11 +34,15 @@ namespace IndexCreationTool
                 {
                     certPath = args[i];
                 }
+                else if (args[i] == "-e")
+                {
+                    embedManifests = true;
+                }
             }
 
             if (string.IsNullOrEmpty(rootDir))
             {
-                Console.WriteLine("Usage: IndexCreationTool.exe -d <Path to search for yaml> [-m <appxmanifest for index package> [-c <cert for signing index package>]]");
+                Console.WriteLine("Usage: IndexCreationTool.exe -d <Path to search for yaml> [-m <appxmanifest for index package> [-c <cert for signing index package>]] [-e]");
                 return;
             }
 
@@ -50,11 +55,16 @@ namespace IndexCreationTool
 
                 using (var indexHelper = WinGetUtilWrapper.Create(IndexName))
                 {
-                    foreach (string file in Directory.EnumerateFiles(rootDir, "*.yaml", SearchOption.AllDirectories))
+                    indexHelper.AddManifestsFromDirectory(rootDir);
+
+                    if (embedManifests)
+                    {
+                        indexHelper.PrepareForPackagingWithManifests(rootDir);
+                    }
+                    else
                     {
-                        indexHelper.AddManifest(file, Path.GetRelativePath(rootDir, file));
+                        indexHelper.PrepareForPackaging();
                     }
-                    indexHelper.PrepareForPackaging();
                 }
 
                 if (!string.IsNullOrEmpty(appxManifestPath))
@@ -18,6 +18,8 @@ namespace IndexCreationTool
 
         private const uint LatestVersion = unchecked((uint)-1);
 
+        private const uint ProgressInterval = 1000;
+
         private IntPtr indexHandle;
 
         /// <summary>
@@ -91,6 +93,63 @@ namespace IndexCreationTool
             }
         }
 
+        /// <summary>
+        /// Adds manifests to index as a single change.
+        /// </summary>
+        /// <param name="manifestPaths">Manifests to add.</param>
+        /// <param name="relativePaths">Paths of the manifests in the repository, in the same order as manifestPaths.</param>
+        public void AddManifests(string[] manifestPaths, string[] relativePaths)
+        {
+            try
+            {
+                Console.WriteLine($"Adding {manifestPaths.Length} manifests on index file.");
+                WinGetSQLiteIndexAddManifests(this.indexHandle, manifestPaths, relativePaths, (uint)manifestPaths.Length);
+                return;
+            }
+            catch (Exception e)
+            {
+                Console.WriteLine($"Error to add manifests. {Environment.NewLine}{e.ToString()}");
+                throw;
+            }
+        }
+
+        /// <summary>
+        /// Adds every manifest under the root to the index as a single change.
+        /// The manifests are found and read by the native side, rather than making a call for each one.
+        /// </summary>
+        /// <param name="manifestRoot">Directory to search for yaml; each manifest is added at its path relative to it.</param>
+        /// <returns>The number of manifests added.</returns>
+        public uint AddManifestsFromDirectory(string manifestRoot)
+        {
+            try
+            {
+                Console.WriteLine($"Adding manifests under {manifestRoot} on index file.");
+
+                ManifestResultCallback callback = (IntPtr context, uint inputIndex, int result, bool succeeded, string message) =>
+                {
+                    if (!succeeded)
+                    {
+                        Console.WriteLine($"Error to add manifest {message}. HRESULT 0x{result:X8}");
+                    }
+                    else if ((inputIndex + 1) % ProgressInterval == 0)
+                    {
+                        Console.WriteLine($"Added {inputIndex + 1} manifests.");
+                    }
+                };
+
+                WinGetSQLiteIndexAddManifestsFromDirectory(this.indexHandle, manifestRoot, callback, IntPtr.Zero, out uint manifestsAdded);
+                GC.KeepAlive(callback);
+
+                Console.WriteLine($"Added {manifestsAdded} manifests.");
+                return manifestsAdded;
+            }
+            catch (Exception e)
+            {
+                Console.WriteLine($"Error to add manifests under {manifestRoot}. {Environment.NewLine}{e.ToString()}");
+                throw;
+            }
+        }
+
         /// <summary>
         /// Updates manifest in the index.
         /// </summary>
@@ -164,6 +223,63 @@ namespace IndexCreationTool
             }
         }
 
+        /// <summary>
+        /// Wrapper for WinGetSQLiteIndexPrepareForPackagingWithManifests.
+        /// </summary>
+        /// <param name="manifestRoot">The directory that the relative paths of the manifests are under.</param>
+        public void PrepareForPackagingWithManifests(string manifestRoot)
+        {
+            try
+            {
+                WinGetSQLiteIndexPrepareForPackagingWithManifests(this.indexHandle, manifestRoot);
+                return;
+            }
+            catch (Exception e)
+            {
+                Console.WriteLine($"Error to prepare for packaging with manifests. {Environment.NewLine}{e.ToString()}");
+                throw;
+            }
+        }
+
+        /// <summary>
+        /// Wrapper for WinGetSQLiteIndexDiff.
+        /// </summary>
+        /// <param name="oldFilePath">The file path of the older index.</param>
+        /// <param name="newFilePath">The file path of the newer index.</param>
+        /// <returns>The changes, as JSON, that turn the older index into the newer one.</returns>
+        public static string Diff(string oldFilePath, string newFilePath)
+        {
+            try
+            {
+                WinGetSQLiteIndexDiff(oldFilePath, newFilePath, out string changes);
+                return changes;
+            }
+            catch (Exception e)
+            {
+                Console.WriteLine($"Error to diff indexes. {Environment.NewLine}{e.ToString()}");
+                throw;
+            }
+        }
+
+        /// <summary>
+        /// Wrapper for WinGetSQLiteIndexApplyChanges.
+        /// </summary>
+        /// <param name="changes">The changes, as JSON, in the form returned by Diff.</param>
+        /// <param name="manifestRoot">The directory that the relative paths of the manifests are under.</param>
+        public void ApplyChanges(string changes, string manifestRoot)
+        {
+            try
+            {
+                WinGetSQLiteIndexApplyChanges(this.indexHandle, changes, manifestRoot);
+                return;
+            }
+            catch (Exception e)
+            {
+                Console.WriteLine($"Error to apply changes. {Environment.NewLine}{e.ToString()}");
+                throw;
+            }
+        }
+
         /// <summary>
         /// Dispose method.
         /// </summary>
@@ -188,6 +304,22 @@ namespace IndexCreationTool
             }
         }
 
+        /// <summary>
+        /// Receives the result for a manifest from the batch functions.
+        /// </summary>
+        /// <param name="context">Context given to the batch function.</param>
+        /// <param name="inputIndex">Index of the manifest.</param>
+        /// <param name="result">HRESULT for the manifest.</param>
+        /// <param name="succeeded">Whether the manifest succeeded.</param>
+        /// <param name="message">The message for the manifest, if any.</param>
+        [UnmanagedFunctionPointer(CallingConvention.StdCall, CharSet = CharSet.Unicode)]
+        private delegate void ManifestResultCallback(
+            IntPtr context,
+            uint inputIndex,
+            int result,
+            [MarshalAs(UnmanagedType.Bool)] bool succeeded,
+            string message);
+
         /// <summary>
         /// Creates a new index file at filePath with the given version.
         /// </summary>
@@ -227,6 +359,35 @@ namespace IndexCreationTool
         [DllImport(DllName, CallingConvention = CallingConvention.StdCall, CharSet = CharSet.Unicode, PreserveSig = false)]
         private static extern IntPtr WinGetSQLiteIndexAddManifest(IntPtr index, string manifestPath, string relativePath);
 
+        /// <summary>
+        /// Adds the manifests at the repository relative paths to the index as a single change.
+        /// If the function succeeds, all of the manifests have been added.
+        /// </summary>
+        /// <param name="index">Handle of the index.</param>
+        /// <param name="manifestPaths">Manifests to add.</param>
+        /// <param name="relativePaths">Paths of the manifests in the container.</param>
+        /// <param name="count">Number of manifests.</param>
+        /// <returns>HRESULT.</returns>
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall, CharSet = CharSet.Unicode, PreserveSig = false)]
+        private static extern IntPtr WinGetSQLiteIndexAddManifests(IntPtr index, string[] manifestPaths, string[] relativePaths, uint count);
+
+        /// <summary>
+        /// Adds every *.yaml file under the root to the index as a single change, each at its path relative to the root.
+        /// </summary>
+        /// <param name="index">Handle of the index.</param>
+        /// <param name="manifestRoot">Directory to search for yaml.</param>
+        /// <param name="callback">Called as each manifest is added, and for the one that failed.</param>
+        /// <param name="context">Context passed to the callback.</param>
+        /// <param name="manifestsAdded">Out number of manifests added.</param>
+        /// <returns>HRESULT.</returns>
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall, CharSet = CharSet.Unicode, PreserveSig = false)]
+        private static extern IntPtr WinGetSQLiteIndexAddManifestsFromDirectory(
+            IntPtr index,
+            string manifestRoot,
+            ManifestResultCallback callback,
+            IntPtr context,
+            out uint manifestsAdded);
+
         /// <summary>
         /// Updates the manifest at the repository relative path in the index.
         /// The out value indicates whether the index was modified by the function.
@@ -260,5 +421,34 @@ namespace IndexCreationTool
         /// <returns>HRESULT.</returns>
         [DllImport(DllName, CallingConvention = CallingConvention.StdCall, CharSet = CharSet.Unicode, PreserveSig = false)]
         private static extern IntPtr WinGetSQLiteIndexPrepareForPackaging(IntPtr index);
+
+        /// <summary>
+        /// Embeds the manifests in the index, then removes data that is no longer needed for an index that is to be published.
+        /// </summary>
+        /// <param name="index">Index handle.</param>
+        /// <param name="manifestRoot">The directory that the relative paths of the manifests are under.</param>
+        /// <returns>HRESULT.</returns>
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall, CharSet = CharSet.Unicode, PreserveSig = false)]
+        private static extern IntPtr WinGetSQLiteIndexPrepareForPackagingWithManifests(IntPtr index, string manifestRoot);
+
+        /// <summary>
+        /// Compares the manifests of two indexes and returns the changes that turn the older index into the newer one.
+        /// </summary>
+        /// <param name="oldFilePath">The file path of the older index.</param>
+        /// <param name="newFilePath">The file path of the newer index.</param>
+        /// <param name="changes">Out changes, as JSON.</param>
+        /// <returns>HRESULT.</returns>
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall, CharSet = CharSet.Unicode, PreserveSig = false)]
+        private static extern IntPtr WinGetSQLiteIndexDiff(string oldFilePath, string newFilePath, [MarshalAs(UnmanagedType.BStr)] out string changes);
+
+        /// <summary>
+        /// Applies changes in the form returned by WinGetSQLiteIndexDiff to the index as a single change.
+        /// </summary>
+        /// <param name="index">Index handle.</param>
+        /// <param name="changes">The changes, as JSON.</param>
+        /// <param name="manifestRoot">The directory that the relative paths of the manifests are under.</param>
+        /// <returns>HRESULT.</returns>
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall, CharSet = CharSet.Unicode, PreserveSig = false)]
+        private static extern IntPtr WinGetSQLiteIndexApplyChanges(IntPtr index, string changes, string manifestRoot);
     }
 }
\ No newline at end of file
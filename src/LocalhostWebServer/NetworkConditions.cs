@@ -0,0 +1,148 @@
+﻿// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+namespace LocalhostWebServer
+{
+    using System;
+    using System.Diagnostics;
+    using System.IO;
+    using System.Threading;
+    using System.Threading.Tasks;
+    using Microsoft.AspNetCore.Builder;
+    using Microsoft.AspNetCore.Http;
+    using Microsoft.AspNetCore.Http.Features;
+    using Microsoft.Net.Http.Headers;
+
+    /// <summary>
+    /// Middleware that simulates the latency, bandwidth, failures and Range support of a remote server.
+    /// </summary>
+    public static class NetworkConditions
+    {
+        private static readonly object FailureLock = new object();
+        private static Random failureRandom;
+
+        /// <summary>
+        /// Adds the network conditions of the options to the pipeline.
+        /// </summary>
+        /// <param name="app">The application builder.</param>
+        /// <param name="options">The options.</param>
+        public static void UseNetworkConditions(this IApplicationBuilder app, RestSourceOptions options)
+        {
+            failureRandom = new Random(options.FailureSeed);
+
+            app.Use(async (context, next) =>
+            {
+                if (!options.RangeSupported)
+                {
+                    context.Request.Headers.Remove(HeaderNames.Range);
+                    context.Request.Headers.Remove(HeaderNames.IfRange);
+                }
+
+                if (options.LatencyMilliseconds > 0)
+                {
+                    await Task.Delay(options.LatencyMilliseconds, context.RequestAborted);
+                }
+
+                if (options.FailureRate > 0 &&
+                    context.Request.Path.StartsWithSegments(RestSourceEmulator.RequestPath) &&
+                    ShouldFail(options.FailureRate))
+                {
+                    context.Response.StatusCode = options.FailureStatusCode;
+                    return;
+                }
+
+                if (options.BandwidthBytesPerSecond <= 0)
+                {
+                    await next();
+                    return;
+                }
+
+                // Replacing the body feature rather than the body stream also throttles the static files, which are sent through SendFileAsync.
+                var original = context.Features.Get<IHttpResponseBodyFeature>();
+                var throttled = new StreamResponseBodyFeature(new ThrottledStream(original.Stream, options.BandwidthBytesPerSecond), original);
+                context.Features.Set<IHttpResponseBodyFeature>(throttled);
+
+                try
+                {
+                    await next();
+                    await throttled.CompleteAsync();
+                }
+                finally
+                {
+                    context.Features.Set(original);
+                }
+            });
+        }
+
+        private static bool ShouldFail(double failureRate)
+        {
+            lock (FailureLock)
+            {
+                return failureRandom.NextDouble() < failureRate;
+            }
+        }
+
+        /// <summary>
+        /// Write-only stream that holds the writes to its inner stream to a number of bytes per second.
+        /// </summary>
+        private class ThrottledStream : Stream
+        {
+            private const int ChunkSize = 16 * 1024;
+
+            private readonly Stream inner;
+            private readonly long bytesPerSecond;
+            private readonly Stopwatch stopwatch = Stopwatch.StartNew();
+            private long written;
+
+            public ThrottledStream(Stream inner, long bytesPerSecond)
+            {
+                this.inner = inner;
+                this.bytesPerSecond = bytesPerSecond;
+            }
+
+            public override bool CanRead => false;
+
+            public override bool CanSeek => false;
+
+            public override bool CanWrite => true;
+
+            public override long Length => throw new NotSupportedException();
+
+            public override long Position { get => throw new NotSupportedException(); set => throw new NotSupportedException(); }
+
+            public override void Flush() => this.inner.Flush();
+
+            public override Task FlushAsync(CancellationToken cancellationToken) => this.inner.FlushAsync(cancellationToken);
+
+            public override int Read(byte[] buffer, int offset, int count) => throw new NotSupportedException();
+
+            public override long Seek(long offset, SeekOrigin origin) => throw new NotSupportedException();
+
+            public override void SetLength(long value) => throw new NotSupportedException();
+
+            public override void Write(byte[] buffer, int offset, int count) => this.WriteAsync(buffer, offset, count).GetAwaiter().GetResult();
+
+            public override async Task WriteAsync(byte[] buffer, int offset, int count, CancellationToken cancellationToken)
+            {
+                while (count > 0)
+                {
+                    int chunk = Math.Min(count, ChunkSize);
+                    await this.inner.WriteAsync(buffer, offset, chunk, cancellationToken);
+                    await this.inner.FlushAsync(cancellationToken);
+
+                    this.written += chunk;
+                    offset += chunk;
+                    count -= chunk;
+
+                    // Wait until the bytes written so far are due at the configured rate.
+                    var due = TimeSpan.FromSeconds((double)this.written / this.bytesPerSecond);
+                    var ahead = due - this.stopwatch.Elapsed;
+                    if (ahead > TimeSpan.Zero)
+                    {
+                        await Task.Delay(ahead, cancellationToken);
+                    }
+                }
+            }
+        }
+    }
+}
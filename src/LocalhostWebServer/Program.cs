@@ -22,13 +22,16 @@ namespace LocalhostWebServer
             Startup.CertPath = config.GetValue<string>("CertPath");
             Startup.CertPassword = config.GetValue<string>("CertPassword");
             Startup.Port = config.GetValue<Int32>("Port", 5001);
+            Startup.RestSource = RestSourceOptions.FromConfiguration(config);
             
             if (string.IsNullOrEmpty(Startup.StaticFileRoot) || 
                 string.IsNullOrEmpty(Startup.CertPath) || 
                 string.IsNullOrEmpty(Startup.CertPassword))
             {
                 Console.WriteLine("Usage: LocalhostWebServer.exe StaticFileRoot=<Path to Serve Static Root Directory> " +
-                    "CertPath=<Path to HTTPS Developer Certificate> CertPassword=<Certificate Password> <Port=Port Number>");
+                    "CertPath=<Path to HTTPS Developer Certificate> CertPassword=<Certificate Password> <Port=Port Number> " +
+                    "<RestCatalogSize=Number of Packages> <RestPageSize=Search Page Size> <RestLatencyMs=Milliseconds> " +
+                    "<BandwidthBytesPerSecond=Bytes> <RestFailureRate=0 to 1> <RangeSupported=true|false>");
                 return;
             }
 
@@ -0,0 +1,270 @@
+﻿// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+namespace LocalhostWebServer
+{
+    using System;
+    using System.Collections.Generic;
+    using System.Globalization;
+    using System.Linq;
+    using System.Text.Json;
+    using System.Threading.Tasks;
+    using Microsoft.AspNetCore.Builder;
+    using Microsoft.AspNetCore.Http;
+    using Microsoft.AspNetCore.Routing;
+    using Microsoft.Net.Http.Headers;
+
+    /// <summary>
+    /// Serves the winget REST source contract 1.0 and 1.1 over a synthetic catalog of packages.
+    /// Package i has the identifier RestSourceEmulator.Package{i:D6} and versions 1.0.0 onwards.
+    /// </summary>
+    public static class RestSourceEmulator
+    {
+        public const string RequestPath = "/api";
+        public const string SourceIdentifier = "RestSourceEmulator";
+        public const string PackageIdentifierPrefix = "RestSourceEmulator.Package";
+
+        private const string ContinuationTokenHeader = "ContinuationToken";
+
+        private static readonly string[] SupportedVersions = { "1.0.0", "1.1.0" };
+
+        /// <summary>
+        /// Maps the information, manifestSearch and packageManifests endpoints.
+        /// </summary>
+        /// <param name="endpoints">The endpoint route builder.</param>
+        /// <param name="options">The options.</param>
+        public static void MapRestSource(this IEndpointRouteBuilder endpoints, RestSourceOptions options)
+        {
+            endpoints.MapGet(RequestPath + "/information", context => WriteCacheableAsync(context, options,
+                new
+                {
+                    Data = new
+                    {
+                        SourceIdentifier,
+                        ServerSupportedVersions = SupportedVersions,
+                    },
+                }));
+
+            endpoints.MapPost(RequestPath + "/manifestSearch", context => SearchAsync(context, options));
+
+            endpoints.MapGet(RequestPath + "/packageManifests/{id}", context =>
+            {
+                string id = (string)context.Request.RouteValues["id"];
+                int index = GetPackageIndex(id, options);
+                if (index < 0)
+                {
+                    context.Response.StatusCode = StatusCodes.Status204NoContent;
+                    return Task.CompletedTask;
+                }
+
+                IEnumerable<string> versions = GetVersions(options);
+                string requestedVersion = context.Request.Query["Version"];
+                if (!string.IsNullOrEmpty(requestedVersion))
+                {
+                    versions = versions.Where(v => v == requestedVersion);
+                }
+
+                var manifests = versions.Select(v => CreateManifestVersion(index, v, options)).ToList();
+                if (manifests.Count == 0)
+                {
+                    context.Response.StatusCode = StatusCodes.Status204NoContent;
+                    return Task.CompletedTask;
+                }
+
+                return WriteCacheableAsync(context, options,
+                    new
+                    {
+                        Data = new
+                        {
+                            PackageIdentifier = GetPackageIdentifier(index),
+                            Versions = manifests,
+                        },
+                    });
+            });
+        }
+
+        private static async Task SearchAsync(HttpContext context, RestSourceOptions options)
+        {
+            using JsonDocument request = await JsonDocument.ParseAsync(context.Request.Body, default, context.RequestAborted);
+            JsonElement root = request.RootElement;
+
+            var query = root.TryGetProperty("Query", out JsonElement queryElement) ? queryElement : (JsonElement?)null;
+            var inclusions = GetArray(root, "Inclusions");
+            var filters = GetArray(root, "Filters");
+            int maximumResults = root.TryGetProperty("MaximumResults", out JsonElement maximum) && maximum.TryGetInt32(out int value) ? value : 0;
+
+            IEnumerable<int> matches = Enumerable.Range(0, options.CatalogSize).Where(i =>
+                (query == null || Matches(i, query.Value)) &&
+                (inclusions.Count == 0 || inclusions.Any(f => MatchesFilter(i, f))) &&
+                filters.All(f => MatchesFilter(i, f)));
+
+            if (maximumResults > 0)
+            {
+                matches = matches.Take(maximumResults);
+            }
+
+            // The continuation token is the position of the first match of the page.
+            int start = 0;
+            if (context.Request.Headers.TryGetValue(ContinuationTokenHeader, out var token))
+            {
+                int.TryParse(token, NumberStyles.None, CultureInfo.InvariantCulture, out start);
+            }
+
+            var page = matches.Skip(start).Take(options.PageSize + 1).ToList();
+            if (page.Count == 0)
+            {
+                context.Response.StatusCode = StatusCodes.Status204NoContent;
+                return;
+            }
+
+            var versions = GetVersions(options).Reverse().Select(v => new { PackageVersion = v }).ToList();
+            var data = page.Take(options.PageSize).Select(i => new
+            {
+                PackageIdentifier = GetPackageIdentifier(i),
+                PackageName = GetPackageName(i),
+                Publisher = GetPublisher(i),
+                Versions = versions,
+            });
+
+            context.Response.ContentType = "application/json";
+            if (page.Count > options.PageSize)
+            {
+                await JsonSerializer.SerializeAsync(context.Response.Body, new { Data = data, ContinuationToken = (start + options.PageSize).ToString(CultureInfo.InvariantCulture) });
+            }
+            else
+            {
+                await JsonSerializer.SerializeAsync(context.Response.Body, new { Data = data });
+            }
+        }
+
+        private static List<JsonElement> GetArray(JsonElement root, string name)
+        {
+            return root.TryGetProperty(name, out JsonElement array) && array.ValueKind == JsonValueKind.Array ? array.EnumerateArray().ToList() : new List<JsonElement>();
+        }
+
+        private static bool Matches(int index, JsonElement requestMatch)
+        {
+            return Matches(GetPackageIdentifier(index), requestMatch) ||
+                Matches(GetPackageName(index), requestMatch) ||
+                Matches(GetMoniker(index), requestMatch);
+        }
+
+        private static bool MatchesFilter(int index, JsonElement filter)
+        {
+            if (!filter.TryGetProperty("RequestMatch", out JsonElement requestMatch))
+            {
+                return false;
+            }
+
+            switch (filter.TryGetProperty("PackageMatchField", out JsonElement field) ? field.GetString() : null)
+            {
+                case "PackageIdentifier":
+                    return Matches(GetPackageIdentifier(index), requestMatch);
+                case "PackageName":
+                    return Matches(GetPackageName(index), requestMatch);
+                case "Moniker":
+                    return Matches(GetMoniker(index), requestMatch);
+                default:
+                    return false;
+            }
+        }
+
+        private static bool Matches(string value, JsonElement requestMatch)
+        {
+            string keyword = requestMatch.TryGetProperty("KeyWord", out JsonElement k) ? k.GetString() ?? string.Empty : string.Empty;
+            string matchType = requestMatch.TryGetProperty("MatchType", out JsonElement m) ? m.GetString() : null;
+
+            switch (matchType)
+            {
+                case "Exact":
+                    return string.Equals(value, keyword, StringComparison.Ordinal);
+                case "CaseInsensitive":
+                    return string.Equals(value, keyword, StringComparison.OrdinalIgnoreCase);
+                case "StartsWith":
+                    return value.StartsWith(keyword, StringComparison.OrdinalIgnoreCase);
+                default:
+                    return value.Contains(keyword, StringComparison.OrdinalIgnoreCase);
+            }
+        }
+
+        private static async Task WriteCacheableAsync(HttpContext context, RestSourceOptions options, object body)
+        {
+            byte[] content = JsonSerializer.SerializeToUtf8Bytes(body);
+            string etag = "\"" + Convert.ToHexString(System.Security.Cryptography.SHA256.HashData(content), 0, 8) + "\"";
+
+            context.Response.Headers[HeaderNames.ETag] = etag;
+            if (options.CacheMaxAgeSeconds > 0)
+            {
+                context.Response.Headers[HeaderNames.CacheControl] = "private, max-age=" + options.CacheMaxAgeSeconds.ToString(CultureInfo.InvariantCulture);
+            }
+
+            if (context.Request.Headers[HeaderNames.IfNoneMatch] == etag)
+            {
+                context.Response.StatusCode = StatusCodes.Status304NotModified;
+                return;
+            }
+
+            context.Response.ContentType = "application/json";
+            await context.Response.Body.WriteAsync(content, context.RequestAborted);
+        }
+
+        private static object CreateManifestVersion(int index, string version, RestSourceOptions options)
+        {
+            return new
+            {
+                PackageVersion = version,
+                DefaultLocale = new
+                {
+                    PackageLocale = "en-US",
+                    Publisher = GetPublisher(index),
+                    PackageName = GetPackageName(index),
+                    License = "Test",
+                    ShortDescription = "Synthetic package " + index.ToString(CultureInfo.InvariantCulture) + " of the REST source emulator.",
+                    Moniker = GetMoniker(index),
+                },
+                Installers = new[]
+                {
+                    new
+                    {
+                        InstallerIdentifier = GetPackageIdentifier(index) + "_" + version,
+                        InstallerSha256 = options.InstallerSha256,
+                        InstallerUrl = options.InstallerUrl,
+                        Architecture = "x64",
+                        InstallerType = "exe",
+                        InstallerSwitches = new
+                        {
+                            Silent = "/silent",
+                            SilentWithProgress = "/silentwithprogress",
+                        },
+                    },
+                },
+            };
+        }
+
+        private static IEnumerable<string> GetVersions(RestSourceOptions options)
+        {
+            return Enumerable.Range(0, options.VersionsPerPackage).Select(v => "1.0." + v.ToString(CultureInfo.InvariantCulture));
+        }
+
+        private static int GetPackageIndex(string id, RestSourceOptions options)
+        {
+            if (id != null &&
+                id.StartsWith(PackageIdentifierPrefix, StringComparison.OrdinalIgnoreCase) &&
+                int.TryParse(id.AsSpan(PackageIdentifierPrefix.Length), NumberStyles.None, CultureInfo.InvariantCulture, out int index) &&
+                index < options.CatalogSize)
+            {
+                return index;
+            }
+
+            return -1;
+        }
+
+        private static string GetPackageIdentifier(int index) => PackageIdentifierPrefix + index.ToString("D6", CultureInfo.InvariantCulture);
+
+        private static string GetPackageName(int index) => "Emulated Package " + index.ToString(CultureInfo.InvariantCulture);
+
+        private static string GetPublisher(int index) => "Emulated Publisher " + (index % 100).ToString(CultureInfo.InvariantCulture);
+
+        private static string GetMoniker(int index) => "emulated" + index.ToString(CultureInfo.InvariantCulture);
+    }
+}
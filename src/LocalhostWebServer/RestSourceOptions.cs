@@ -0,0 +1,107 @@
+﻿// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+namespace LocalhostWebServer
+{
+    using Microsoft.Extensions.Configuration;
+
+    /// <summary>
+    /// The settings of the REST source emulator and of the network conditions that the server simulates.
+    /// </summary>
+    public class RestSourceOptions
+    {
+        /// <summary>
+        /// Gets or sets the number of packages in the synthetic catalog. The REST source is not served when zero.
+        /// </summary>
+        public int CatalogSize { get; set; }
+
+        /// <summary>
+        /// Gets or sets the number of versions of each package in the synthetic catalog.
+        /// </summary>
+        public int VersionsPerPackage { get; set; } = 3;
+
+        /// <summary>
+        /// Gets or sets the number of packages returned in each page of search results.
+        /// </summary>
+        public int PageSize { get; set; } = 100;
+
+        /// <summary>
+        /// Gets or sets the delay added before every response, in milliseconds.
+        /// </summary>
+        public int LatencyMilliseconds { get; set; }
+
+        /// <summary>
+        /// Gets or sets the rate at which response bodies are written, in bytes per second. Unlimited when zero.
+        /// </summary>
+        public long BandwidthBytesPerSecond { get; set; }
+
+        /// <summary>
+        /// Gets or sets the fraction of REST requests, between 0 and 1, that fail with FailureStatusCode.
+        /// </summary>
+        public double FailureRate { get; set; }
+
+        /// <summary>
+        /// Gets or sets the status code of the injected failures.
+        /// </summary>
+        public int FailureStatusCode { get; set; } = 503;
+
+        /// <summary>
+        /// Gets or sets the seed of the failure injection, so that a run can be repeated.
+        /// </summary>
+        public int FailureSeed { get; set; }
+
+        /// <summary>
+        /// Gets or sets whether static files are served for Range requests; when false the whole file is always sent.
+        /// </summary>
+        public bool RangeSupported { get; set; } = true;
+
+        /// <summary>
+        /// Gets or sets the max-age of the Cache-Control header of the information and manifest responses. No header is sent when zero.
+        /// </summary>
+        public int CacheMaxAgeSeconds { get; set; }
+
+        /// <summary>
+        /// Gets or sets the installer url of every synthetic manifest.
+        /// </summary>
+        public string InstallerUrl { get; set; } = "https://localhost:5001/TestKit/AppInstallerTestExeInstaller/AppInstallerTestExeInstaller.exe";
+
+        /// <summary>
+        /// Gets or sets the installer hash of every synthetic manifest.
+        /// </summary>
+        public string InstallerSha256 { get; set; } = new string('0', 64);
+
+        /// <summary>
+        /// Reads the options from the Rest* command line settings.
+        /// </summary>
+        /// <param name="config">The configuration to read.</param>
+        /// <returns>The options.</returns>
+        public static RestSourceOptions FromConfiguration(IConfiguration config)
+        {
+            var result = new RestSourceOptions();
+            result.CatalogSize = config.GetValue("RestCatalogSize", result.CatalogSize);
+            result.VersionsPerPackage = config.GetValue("RestVersionsPerPackage", result.VersionsPerPackage);
+            result.PageSize = config.GetValue("RestPageSize", result.PageSize);
+            result.LatencyMilliseconds = config.GetValue("RestLatencyMs", result.LatencyMilliseconds);
+            result.BandwidthBytesPerSecond = config.GetValue("BandwidthBytesPerSecond", result.BandwidthBytesPerSecond);
+            result.FailureRate = config.GetValue("RestFailureRate", result.FailureRate);
+            result.FailureStatusCode = config.GetValue("RestFailureStatusCode", result.FailureStatusCode);
+            result.FailureSeed = config.GetValue("RestFailureSeed", result.FailureSeed);
+            result.RangeSupported = config.GetValue("RangeSupported", result.RangeSupported);
+            result.CacheMaxAgeSeconds = config.GetValue("RestCacheMaxAgeSeconds", result.CacheMaxAgeSeconds);
+            result.InstallerUrl = config.GetValue("RestInstallerUrl", result.InstallerUrl);
+            result.InstallerSha256 = config.GetValue("RestInstallerSha256", result.InstallerSha256);
+
+            if (result.VersionsPerPackage < 1)
+            {
+                result.VersionsPerPackage = 1;
+            }
+
+            if (result.PageSize < 1)
+            {
+                result.PageSize = 1;
+            }
+
+            return result;
+        }
+    }
+}
@@ -9,6 +9,8 @@
     Path to HTTPS Development Certificate File (pfx)
 .PARAMETER CertPassword
     Secure Password for HTTPS Certificate
+.PARAMETER RestCatalogSize
+    The number of packages served by the REST source emulator; it is not served when zero
 #>
 
 param(
@@ -22,10 +24,13 @@ param(
     [string]$CertPath,
 
     [Parameter(Mandatory=$true)]
-    [string]$CertPassword
+    [string]$CertPassword,
+
+    [Parameter(Mandatory=$false)]
+    [int]$RestCatalogSize = 0
 )
 
 cd $BuildRoot
 
-Start-Process -FilePath "LocalhostWebServer.exe" -ArgumentList "StaticFileRoot=$StaticFileRoot CertPath=$CertPath CertPassword=$CertPassword" 
+Start-Process -FilePath "LocalhostWebServer.exe" -ArgumentList "StaticFileRoot=$StaticFileRoot CertPath=$CertPath CertPassword=$CertPassword RestCatalogSize=$RestCatalogSize" 
 
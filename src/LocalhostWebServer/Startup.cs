@@ -23,6 +23,8 @@ namespace LocalhostWebServer
 
         public static int Port { get; set; }
 
+        public static RestSourceOptions RestSource { get; set; } = new RestSourceOptions();
+
         public Startup(IConfiguration configuration)
         {
             Configuration = configuration;
@@ -44,6 +46,8 @@ namespace LocalhostWebServer
 
             app.UseHttpsRedirection();
 
+            app.UseNetworkConditions(RestSource);
+
             //Add .yaml and .msix mappings
             var provider = new FileExtensionContentTypeProvider();
             provider.Mappings[".yaml"] = "application/x-yaml";
@@ -75,6 +79,11 @@ namespace LocalhostWebServer
             app.UseEndpoints(endpoints =>
             {
                 endpoints.MapDefaultControllerRoute();
+
+                if (RestSource.CatalogSize > 0)
+                {
+                    endpoints.MapRestSource(RestSource);
+                }
             });
         }
     }
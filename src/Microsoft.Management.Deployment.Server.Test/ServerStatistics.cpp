@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include <windows.h>
+#include <psapi.h>
+#include <tlhelp32.h>
+#include <cstdint>
+#include <ContextOrchestratorLock.h>
+
+namespace
+{
+    // Counts the threads of this process; the thread pools of the orchestrator queues grow and shrink with the load.
+    uint64_t GetProcessThreadCount()
+    {
+        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+        if (snapshot == INVALID_HANDLE_VALUE)
+        {
+            return 0;
+        }
+
+        DWORD processId = GetCurrentProcessId();
+        uint64_t result = 0;
+
+        THREADENTRY32 entry{};
+        entry.dwSize = sizeof(entry);
+        for (BOOL found = Thread32First(snapshot, &entry); found; found = Thread32Next(snapshot, &entry))
+        {
+            if (entry.th32OwnerProcessID == processId)
+            {
+                ++result;
+            }
+        }
+
+        CloseHandle(snapshot);
+        return result;
+    }
+}
+
+// The layout must match ServerStatistics in the packaged tests, which read it while they drive load against the server.
+struct WinGetServerTestStatistics
+{
+    uint64_t ThreadCount;
+    uint64_t WorkingSetBytes;
+    uint64_t LockAcquisitions;
+    uint64_t ContendedLockAcquisitions;
+    uint64_t LockWaitMicroseconds;
+    uint64_t MaximumLockWaitMicroseconds;
+};
+
+extern "C" HRESULT __stdcall WinGetServerTestGetStatistics(WinGetServerTestStatistics* statistics) noexcept
+{
+    if (!statistics)
+    {
+        return E_POINTER;
+    }
+
+    *statistics = {};
+    statistics->ThreadCount = GetProcessThreadCount();
+
+    PROCESS_MEMORY_COUNTERS memoryCounters{};
+    memoryCounters.cb = sizeof(memoryCounters);
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters)))
+    {
+        statistics->WorkingSetBytes = memoryCounters.WorkingSetSize;
+    }
+
+    AppInstaller::CLI::Execution::OrchestratorLockStatistics lockStatistics = AppInstaller::CLI::Execution::GetOrchestratorLockStatistics();
+    statistics->LockAcquisitions = lockStatistics.Acquisitions;
+    statistics->ContendedLockAcquisitions = lockStatistics.ContendedAcquisitions;
+    statistics->LockWaitMicroseconds = static_cast<uint64_t>(lockStatistics.TotalWait.count());
+    statistics->MaximumLockWaitMicroseconds = static_cast<uint64_t>(lockStatistics.MaximumWait.count());
+
+    return S_OK;
+}
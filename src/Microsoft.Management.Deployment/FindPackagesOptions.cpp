@@ -29,6 +29,14 @@ namespace winrt::Microsoft::Management::Deployment::implementation
     {
         m_resultLimit = value;
     }
+    winrt::Microsoft::Management::Deployment::PackageProjectionFields FindPackagesOptions::ProjectionFields()
+    {
+        return m_projectionFields;
+    }
+    void FindPackagesOptions::ProjectionFields(winrt::Microsoft::Management::Deployment::PackageProjectionFields const& value)
+    {
+        m_projectionFields = value;
+    }
 
     CoCreatableMicrosoftManagementDeploymentClass(FindPackagesOptions);
 }
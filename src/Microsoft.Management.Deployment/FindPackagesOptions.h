@@ -18,10 +18,13 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         winrt::Windows::Foundation::Collections::IVector<winrt::Microsoft::Management::Deployment::PackageMatchFilter> Filters();
         uint32_t ResultLimit();
         void ResultLimit(uint32_t value);
+        winrt::Microsoft::Management::Deployment::PackageProjectionFields ProjectionFields();
+        void ProjectionFields(winrt::Microsoft::Management::Deployment::PackageProjectionFields const& value);
 
 #if !defined(INCLUDE_ONLY_INTERFACE_METHODS)
     private:
         uint32_t m_resultLimit = 0;
+        winrt::Microsoft::Management::Deployment::PackageProjectionFields m_projectionFields = winrt::Microsoft::Management::Deployment::PackageProjectionFields::None;
         Windows::Foundation::Collections::IVector<Microsoft::Management::Deployment::PackageMatchFilter> m_selectors{ 
             winrt::single_threaded_vector<winrt::Microsoft::Management::Deployment::PackageMatchFilter>() };
         Windows::Foundation::Collections::IVector<Microsoft::Management::Deployment::PackageMatchFilter> m_filters{ 
@@ -1,8 +1,12 @@
 // Copyright (c) Microsoft Corporation.
 // Licensed under the MIT License.
 #include "pch.h"
+#include <winget/RepositorySource.h>
 #include "FindPackagesResult.h"
 #include "FindPackagesResult.g.cpp"
+#include "MatchResult.h"
+#include "CatalogPackage.h"
+#include "PackageMatchFilter.h"
 #include <wil\cppwinrt_wrl.h>
 
 namespace winrt::Microsoft::Management::Deployment::implementation
@@ -13,19 +17,125 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         Windows::Foundation::Collections::IVector<Microsoft::Management::Deployment::MatchResult> matches)
     {
         m_status = status;
-        m_matches = matches;
+        m_matches.assign(begin(matches), end(matches));
         m_wasLimitExceeded = wasLimitExceeded;
     }
+    void FindPackagesResult::Initialize(
+        bool wasLimitExceeded,
+        ::AppInstaller::Repository::Source source,
+        std::vector<::AppInstaller::Repository::ResultMatch> matches,
+        winrt::Microsoft::Management::Deployment::PackageProjectionFields projectionFields)
+    {
+        m_status = winrt::Microsoft::Management::Deployment::FindPackagesResultStatus::Ok;
+        m_source = std::move(source);
+        m_searchMatches = std::move(matches);
+        m_matches.resize(m_searchMatches.size(), nullptr);
+        m_wasLimitExceeded = wasLimitExceeded;
+        m_projectionFields = projectionFields;
+    }
     winrt::Microsoft::Management::Deployment::FindPackagesResultStatus FindPackagesResult::Status()
     {
         return m_status;
     }
     winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::MatchResult> FindPackagesResult::Matches()
     {
-        return m_matches.GetView();
+        return GetMatches(0, MatchCount());
     }
     bool FindPackagesResult::WasLimitExceeded()
     {
         return m_wasLimitExceeded;
     }
+    uint32_t FindPackagesResult::MatchCount()
+    {
+        return static_cast<uint32_t>(m_matches.size());
+    }
+    winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::MatchResult> FindPackagesResult::GetMatches(uint32_t startIndex, uint32_t count)
+    {
+        std::vector<winrt::Microsoft::Management::Deployment::MatchResult> page;
+
+        std::lock_guard<std::mutex> lock{ m_matchesLock };
+        size_t start = std::min<size_t>(startIndex, m_matches.size());
+        size_t end = start + std::min<size_t>(count, m_matches.size() - start);
+        page.reserve(end - start);
+
+        for (size_t i = start; i < end; ++i)
+        {
+            page.emplace_back(GetMatch(i));
+        }
+
+        return winrt::single_threaded_vector<winrt::Microsoft::Management::Deployment::MatchResult>(std::move(page)).GetView();
+    }
+    com_array<winrt::Microsoft::Management::Deployment::PackageProjection> FindPackagesResult::GetProjections(uint32_t startIndex, uint32_t count)
+    {
+        using ProjectionFields = winrt::Microsoft::Management::Deployment::PackageProjectionFields;
+
+        // Only the results of a successful search keep their packages.
+        size_t start = std::min<size_t>(startIndex, m_searchMatches.size());
+        size_t end = start + std::min<size_t>(count, m_searchMatches.size() - start);
+        std::vector<winrt::Microsoft::Management::Deployment::PackageProjection> projections(end - start);
+
+        for (size_t i = start; i < end; ++i)
+        {
+            const auto& package = m_searchMatches[i].Package;
+            auto& projection = projections[i - start];
+
+            if (WI_IsFlagSet(m_projectionFields, ProjectionFields::Id))
+            {
+                projection.Id = winrt::to_hstring(package->GetProperty(::AppInstaller::Repository::PackageProperty::Id).get());
+            }
+
+            if (WI_IsFlagSet(m_projectionFields, ProjectionFields::Name))
+            {
+                projection.Name = winrt::to_hstring(package->GetProperty(::AppInstaller::Repository::PackageProperty::Name));
+            }
+
+            if (WI_IsFlagSet(m_projectionFields, ProjectionFields::InstalledVersion))
+            {
+                auto installedVersion = package->GetInstalledVersion();
+                if (installedVersion)
+                {
+                    projection.InstalledVersion = winrt::to_hstring(installedVersion->GetProperty(::AppInstaller::Repository::PackageVersionProperty::Version).get());
+                }
+            }
+
+            if (WI_IsFlagSet(m_projectionFields, ProjectionFields::DefaultInstallVersion))
+            {
+                auto latestVersion = package->GetLatestAvailableVersion();
+                if (latestVersion)
+                {
+                    projection.DefaultInstallVersion = winrt::to_hstring(latestVersion->GetProperty(::AppInstaller::Repository::PackageVersionProperty::Version).get());
+                }
+            }
+
+            if (WI_IsFlagSet(m_projectionFields, ProjectionFields::IsUpdateAvailable))
+            {
+                projection.IsUpdateAvailable = package->IsUpdateAvailable();
+            }
+        }
+
+        return com_array<winrt::Microsoft::Management::Deployment::PackageProjection>(projections);
+    }
+    winrt::Microsoft::Management::Deployment::MatchResult FindPackagesResult::GetMatch(size_t index)
+    {
+        if (!m_matches[index])
+        {
+            const auto& match = m_searchMatches[index];
+
+            auto catalogPackage = winrt::make_self<wil::details::module_count_wrapper<
+                winrt::Microsoft::Management::Deployment::implementation::CatalogPackage>>();
+            catalogPackage->Initialize(m_source, match.Package);
+
+            auto packageMatchFilter = winrt::make_self<wil::details::module_count_wrapper<
+                winrt::Microsoft::Management::Deployment::implementation::PackageMatchFilter>>();
+            packageMatchFilter->Initialize(match.MatchCriteria);
+
+            auto matchResult = winrt::make_self<wil::details::module_count_wrapper<
+                winrt::Microsoft::Management::Deployment::implementation::MatchResult>>();
+            matchResult->Initialize(*catalogPackage, *packageMatchFilter);
+
+            m_matches[index] = *matchResult;
+        }
+
+        return m_matches[index];
+    }
 }
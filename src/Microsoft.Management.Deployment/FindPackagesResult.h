@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 #pragma once
 #include "FindPackagesResult.g.h"
+#include <mutex>
+#include <vector>
 
 namespace winrt::Microsoft::Management::Deployment::implementation
 {
@@ -14,18 +16,34 @@ namespace winrt::Microsoft::Management::Deployment::implementation
             winrt::Microsoft::Management::Deployment::FindPackagesResultStatus errorCode,
             bool wasLimitExceeded, 
             Windows::Foundation::Collections::IVector<winrt::Microsoft::Management::Deployment::MatchResult> matches);
+
+        // The objects for the matches are only created as they are retrieved.
+        void Initialize(
+            bool wasLimitExceeded,
+            ::AppInstaller::Repository::Source source,
+            std::vector<::AppInstaller::Repository::ResultMatch> matches,
+            winrt::Microsoft::Management::Deployment::PackageProjectionFields projectionFields);
 #endif
 
         winrt::Microsoft::Management::Deployment::FindPackagesResultStatus Status();
         winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::MatchResult> Matches();
         bool WasLimitExceeded();
+        uint32_t MatchCount();
+        winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::MatchResult> GetMatches(uint32_t startIndex, uint32_t count);
+        com_array<winrt::Microsoft::Management::Deployment::PackageProjection> GetProjections(uint32_t startIndex, uint32_t count);
 
 #if !defined(INCLUDE_ONLY_INTERFACE_METHODS)
     private:
+        // Gets the object for the match at the index, creating it if needed; the lock must be held.
+        winrt::Microsoft::Management::Deployment::MatchResult GetMatch(size_t index);
+
         winrt::Microsoft::Management::Deployment::FindPackagesResultStatus m_status = winrt::Microsoft::Management::Deployment::FindPackagesResultStatus::Ok;
-        Windows::Foundation::Collections::IVector<winrt::Microsoft::Management::Deployment::MatchResult> m_matches{ 
-            winrt::single_threaded_vector<winrt::Microsoft::Management::Deployment::MatchResult>() };
+        ::AppInstaller::Repository::Source m_source;
+        std::vector<::AppInstaller::Repository::ResultMatch> m_searchMatches;
+        std::vector<winrt::Microsoft::Management::Deployment::MatchResult> m_matches;
         bool m_wasLimitExceeded = false;
+        winrt::Microsoft::Management::Deployment::PackageProjectionFields m_projectionFields = winrt::Microsoft::Management::Deployment::PackageProjectionFields::None;
+        std::mutex m_matchesLock;
 #endif
     };
 }
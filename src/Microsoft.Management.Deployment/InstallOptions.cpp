@@ -104,6 +104,14 @@ namespace winrt::Microsoft::Management::Deployment::implementation
     {
         return m_allowedArchitectures;
     }
+    winrt::Microsoft::Management::Deployment::PackageInstallPriority InstallOptions::PackageInstallPriority()
+    {
+        return m_packageInstallPriority;
+    }
+    void InstallOptions::PackageInstallPriority(winrt::Microsoft::Management::Deployment::PackageInstallPriority const& value)
+    {
+        m_packageInstallPriority = value;
+    }
 
     CoCreatableMicrosoftManagementDeploymentClass(InstallOptions);
 }
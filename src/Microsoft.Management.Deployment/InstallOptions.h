@@ -33,6 +33,8 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         hstring AdditionalPackageCatalogArguments();
         void AdditionalPackageCatalogArguments(hstring const& value);
         winrt::Windows::Foundation::Collections::IVector<winrt::Windows::System::ProcessorArchitecture> AllowedArchitectures();
+        winrt::Microsoft::Management::Deployment::PackageInstallPriority PackageInstallPriority();
+        void PackageInstallPriority(winrt::Microsoft::Management::Deployment::PackageInstallPriority const& value);
 
 #if !defined(INCLUDE_ONLY_INTERFACE_METHODS)
     private:
@@ -47,6 +49,7 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         std::wstring m_additionalPackageCatalogArguments = L"";
         Windows::Foundation::Collections::IVector<Windows::System::ProcessorArchitecture> m_allowedArchitectures{
             winrt::single_threaded_vector<winrt::Windows::System::ProcessorArchitecture>() };
+        winrt::Microsoft::Management::Deployment::PackageInstallPriority m_packageInstallPriority = winrt::Microsoft::Management::Deployment::PackageInstallPriority::Normal;
 #endif
     };
 }
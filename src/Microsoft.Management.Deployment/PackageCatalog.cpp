@@ -11,6 +11,7 @@
 #include "FindPackagesResult.h"
 #include "MatchResult.h"
 #include "CatalogPackage.h"
+#include "UpgradeSummary.h"
 #include "Commands/RootCommand.h"
 #include "ExecutionContext.h"
 #pragma warning( push )
@@ -21,7 +22,10 @@
 #include "PackageMatchFilter.h"
 #pragma warning( pop )
 #include "Microsoft/PredefinedInstalledSourceFactory.h"
+#include <winget/AllocationTracking.h>
 #include <winget/GroupPolicy.h>
+#include <winget/MemoryTrim.h>
+#include <winget/ThreadGlobals.h>
 #include <AppInstallerErrors.h>
 
 namespace winrt::Microsoft::Management::Deployment::implementation
@@ -47,7 +51,31 @@ namespace winrt::Microsoft::Management::Deployment::implementation
     }
     winrt::Windows::Foundation::IAsyncOperation<winrt::Microsoft::Management::Deployment::FindPackagesResult> PackageCatalog::FindPackagesAsync(winrt::Microsoft::Management::Deployment::FindPackagesOptions options)
     {
-        co_return FindPackages(options);
+        auto strongThis = get_strong();
+        auto cancellationToken{ co_await winrt::get_cancellation_token() };
+        // Searching reads the catalog's index or queries its server, so it must not hold up the calling thread.
+        co_await winrt::resume_background();
+
+        if (cancellationToken())
+        {
+            throw winrt::hresult_canceled();
+        }
+
+        // A cancellation while searching interrupts the queries of the search, rather than waiting for them to finish.
+        ::AppInstaller::ThreadLocalStorage::CancellationCheckScope cancellationCheckScope{ [&]() { return static_cast<bool>(cancellationToken()); } };
+
+        // Nothing is awaited from here on, so the scope stays on this thread; the subsystems that the search calls into
+        // count their own allocations, leaving the objects returned to the caller here.
+        ::AppInstaller::Memory::AllocationScope allocationScope{ ::AppInstaller::Memory::AllocationSubsystem::WinRT };
+        auto result = FindPackages(options);
+        ::AppInstaller::Memory::TraceAllocationCounts();
+
+        if (cancellationToken())
+        {
+            throw winrt::hresult_canceled();
+        }
+
+        co_return result;
     }
 
     HRESULT PopulateSearchRequestFromVector(
@@ -121,6 +149,8 @@ namespace winrt::Microsoft::Management::Deployment::implementation
 
     winrt::Microsoft::Management::Deployment::FindPackagesResult PackageCatalog::FindPackages(winrt::Microsoft::Management::Deployment::FindPackagesOptions const& options)
     {
+        ::AppInstaller::Memory::NotifyActivity();
+
         winrt::Microsoft::Management::Deployment::FindPackagesResultStatus::Ok;
         bool isTruncated = false;
         Windows::Foundation::Collections::IVector<Microsoft::Management::Deployment::MatchResult> matches{ winrt::single_threaded_vector<Microsoft::Management::Deployment::MatchResult>() };
@@ -147,28 +177,42 @@ namespace winrt::Microsoft::Management::Deployment::implementation
                 std::rethrow_exception(searchResult.Failures[0].Exception);
             }
 
-            // Build the result object from the searchResult
-            for (size_t i = 0; i < searchResult.Matches.size(); ++i)
-            {
-                auto match = searchResult.Matches[i];
-                auto catalogPackage = winrt::make_self<wil::details::module_count_wrapper<
-                    winrt::Microsoft::Management::Deployment::implementation::CatalogPackage>>();
-                catalogPackage->Initialize(m_source, match.Package);
+            // The result object creates the objects for the matches as the caller retrieves them, so that a caller
+            // that only wants the first few does not wait for (or marshal) all of them.
+            auto findPackagesResult = winrt::make_self<wil::details::module_count_wrapper<
+                winrt::Microsoft::Management::Deployment::implementation::FindPackagesResult>>();
+            findPackagesResult->Initialize(searchResult.Truncated, m_source, std::move(searchResult.Matches), options.ProjectionFields());
+            return *findPackagesResult;
+        }
+        WINGET_CATCH_STORE(hr, APPINSTALLER_CLI_ERROR_COMMAND_FAILED);
 
-                auto packageMatchFilter = winrt::make_self<wil::details::module_count_wrapper<
-                    winrt::Microsoft::Management::Deployment::implementation::PackageMatchFilter>>();
-                packageMatchFilter->Initialize(match.MatchCriteria);
+        return GetFindPackagesResult(hr, isTruncated, matches);
+    }
 
-                auto matchResult = winrt::make_self<wil::details::module_count_wrapper<
-                    winrt::Microsoft::Management::Deployment::implementation::MatchResult>>();
-                matchResult->Initialize(*catalogPackage, *packageMatchFilter);
+    winrt::Windows::Foundation::IAsyncOperation<winrt::Microsoft::Management::Deployment::UpgradeSummary> PackageCatalog::GetUpgradeSummaryAsync(bool includeUnknown)
+    {
+        auto strongThis = get_strong();
+        auto cancellationToken{ co_await winrt::get_cancellation_token() };
+        // Correlating the installed packages reads the catalogs, so it must not hold up the calling thread.
+        co_await winrt::resume_background();
 
-                matches.Append(*matchResult);
-            }
-            isTruncated = searchResult.Truncated;
+        if (cancellationToken())
+        {
+            throw winrt::hresult_canceled();
         }
-        WINGET_CATCH_STORE(hr, APPINSTALLER_CLI_ERROR_COMMAND_FAILED);
 
-        return GetFindPackagesResult(hr, isTruncated, matches);
+        // An empty request returns every installed package, correlated with the available catalogs.
+        auto searchResult = m_source.Search({});
+        if (!searchResult.Failures.empty())
+        {
+            std::rethrow_exception(searchResult.Failures[0].Exception);
+        }
+
+        auto summary = ::AppInstaller::Repository::GetUpgradeSummary(searchResult, includeUnknown);
+
+        auto upgradeSummary = winrt::make_self<wil::details::module_count_wrapper<
+            winrt::Microsoft::Management::Deployment::implementation::UpgradeSummary>>();
+        upgradeSummary->Initialize(summary);
+        co_return *upgradeSummary;
     }
 }
@@ -10,13 +10,129 @@
 #include "Workflows/WorkflowBase.h"
 #include "Converters.h"
 #include "Microsoft/PredefinedInstalledSourceFactory.h"
+#include "Microsoft/PredefinedWriteableSourceFactory.h"
 #include <wil\cppwinrt_wrl.h>
 #include <winget/GroupPolicy.h>
+#include <winget/MemoryTrim.h>
+#include <winget/UserSettings.h>
 #include <AppInstallerErrors.h>
 #include <Helpers.h>
+#include <chrono>
+#include <map>
+#include <mutex>
 
 namespace winrt::Microsoft::Management::Deployment::implementation
 {
+    namespace
+    {
+        using namespace std::chrono_literals;
+
+        // How long the installed packages are kept; they can change outside of this process.
+        constexpr std::chrono::steady_clock::duration s_InstalledSourceLifetime = 1min;
+
+        // Keeps the sources that have been opened, so that connecting to the same catalog again shares the opened source
+        // rather than reading its index again, or for the installed catalog, enumerating the installed packages again.
+        // A kept source holds its index open for reading, which an update of the source waits for, so remote sources
+        // are only kept for the auto update interval.
+        struct OpenedSourceCache
+        {
+            static OpenedSourceCache& Instance()
+            {
+                static OpenedSourceCache s_instance;
+                return s_instance;
+            }
+
+            ::AppInstaller::Repository::Source Open(const ::AppInstaller::Repository::Source& sourceReference, ::AppInstaller::IProgressCallback& progress, bool canBeKept)
+            {
+                const auto& details = sourceReference.GetDetails();
+                bool isInstalled = (details.Type == ::AppInstaller::Repository::Microsoft::PredefinedInstalledSourceFactory::Type());
+
+                // The writeable sources record the state of this process, so they are never shared.
+                if (!canBeKept || details.Type == ::AppInstaller::Repository::Microsoft::PredefinedWriteableSourceFactory::Type())
+                {
+                    auto source = sourceReference;
+                    source.Open(progress);
+                    return source;
+                }
+
+                std::string key = details.Type + '|' + details.Arg + '|' + details.Name;
+                auto now = std::chrono::steady_clock::now();
+
+                {
+                    std::lock_guard<std::mutex> lock{ m_lock };
+                    auto itr = m_sources.find(key);
+                    if (itr != m_sources.end() && now < itr->second.Expiry)
+                    {
+                        return itr->second.OpenedSource;
+                    }
+                }
+
+                // Opened without holding the lock, so that a slow source does not hold up connecting to the others.
+                auto source = sourceReference;
+                source.Open(progress);
+
+                std::chrono::steady_clock::duration lifetime = isInstalled ? s_InstalledSourceLifetime :
+                    std::chrono::steady_clock::duration{ ::AppInstaller::Settings::User().Get<::AppInstaller::Settings::Setting::AutoUpdateTimeInMinutes>() };
+
+                std::lock_guard<std::mutex> lock{ m_lock };
+                m_sources[key] = { source, now + lifetime };
+                return source;
+            }
+
+            void DropInstalled()
+            {
+                std::lock_guard<std::mutex> lock{ m_lock };
+                for (auto itr = m_sources.begin(); itr != m_sources.end();)
+                {
+                    if (itr->second.OpenedSource.GetDetails().Type == ::AppInstaller::Repository::Microsoft::PredefinedInstalledSourceFactory::Type())
+                    {
+                        itr = m_sources.erase(itr);
+                    }
+                    else
+                    {
+                        ++itr;
+                    }
+                }
+            }
+
+        private:
+            struct Entry
+            {
+                ::AppInstaller::Repository::Source OpenedSource;
+                std::chrono::steady_clock::time_point Expiry;
+            };
+
+            std::mutex m_lock;
+            std::map<std::string, Entry> m_sources;
+        };
+
+        // Reports the progress of opening a catalog as the fraction of it that is done.
+        struct ConnectProgressSink : public ::AppInstaller::IProgressSink
+        {
+            ConnectProgressSink(std::function<void(double)> report) : m_report(std::move(report)) {}
+
+            void OnProgress(uint64_t current, uint64_t maximum, ::AppInstaller::ProgressType type) override
+            {
+                if (type != ::AppInstaller::ProgressType::None && maximum != 0)
+                {
+                    m_report(static_cast<double>(std::min(current, maximum)) / static_cast<double>(maximum));
+                }
+            }
+
+            void BeginProgress() override {}
+
+            void EndProgress(bool) override {}
+
+        private:
+            std::function<void(double)> m_report;
+        };
+    }
+
+    void DropKeptInstalledSources()
+    {
+        OpenedSourceCache::Instance().DropInstalled();
+    }
+
     void PackageCatalogReference::Initialize(winrt::Microsoft::Management::Deployment::PackageCatalogInfo packageCatalogInfo, ::AppInstaller::Repository::Source sourceReference)
     {
         m_info = packageCatalogInfo;
@@ -36,7 +152,28 @@ namespace winrt::Microsoft::Management::Deployment::implementation
     }
     winrt::Windows::Foundation::IAsyncOperation<winrt::Microsoft::Management::Deployment::ConnectResult> PackageCatalogReference::ConnectAsync()
     {
-        co_return Connect();
+        auto strongThis = get_strong();
+        auto cancellationToken{ co_await winrt::get_cancellation_token() };
+        // Opening a catalog can download it, so it must not hold up the calling thread.
+        co_await winrt::resume_background();
+
+        ::AppInstaller::ProgressCallback progress;
+        cancellationToken.callback([&progress]() { progress.Cancel(); });
+
+        co_return Connect(progress);
+    }
+    winrt::Windows::Foundation::IAsyncOperationWithProgress<winrt::Microsoft::Management::Deployment::ConnectResult, double> PackageCatalogReference::ConnectWithProgressAsync()
+    {
+        auto strongThis = get_strong();
+        auto report_progress{ co_await winrt::get_progress_token() };
+        auto cancellationToken{ co_await winrt::get_cancellation_token() };
+        co_await winrt::resume_background();
+
+        ConnectProgressSink sink{ [&report_progress](double progress) { report_progress(progress); } };
+        ::AppInstaller::ProgressCallback progress{ &sink };
+        cancellationToken.callback([&progress]() { progress.Cancel(); });
+
+        co_return Connect(progress);
     }
     winrt::Microsoft::Management::Deployment::ConnectResult GetConnectCatalogErrorResult()
     {
@@ -46,6 +183,13 @@ namespace winrt::Microsoft::Management::Deployment::implementation
     }
     winrt::Microsoft::Management::Deployment::ConnectResult PackageCatalogReference::Connect()
     {
+        ::AppInstaller::ProgressCallback progress;
+        return Connect(progress);
+    }
+    winrt::Microsoft::Management::Deployment::ConnectResult PackageCatalogReference::Connect(::AppInstaller::IProgressCallback& progress)
+    {
+        ::AppInstaller::Memory::NotifyActivity();
+
         try
         {
             if (FAILED(EnsureComCallerHasCapability(Capability::PackageQuery)))
@@ -54,7 +198,6 @@ namespace winrt::Microsoft::Management::Deployment::implementation
                 return GetConnectCatalogErrorResult();
             }
 
-            ::AppInstaller::ProgressCallback progress;
             ::AppInstaller::Repository::Source source;
             if (m_compositePackageCatalogOptions)
             {
@@ -64,9 +207,7 @@ namespace winrt::Microsoft::Management::Deployment::implementation
                 {
                     auto catalog = m_compositePackageCatalogOptions.Catalogs().GetAt(i);
                     winrt::Microsoft::Management::Deployment::implementation::PackageCatalogReference* catalogImpl = get_self<winrt::Microsoft::Management::Deployment::implementation::PackageCatalogReference>(catalog);
-                    auto copy = catalogImpl->m_sourceReference;
-                    copy.Open(progress);
-                    remoteSources.emplace_back(std::move(copy));
+                    remoteSources.emplace_back(OpenedSourceCache::Instance().Open(catalogImpl->m_sourceReference, progress, !catalogImpl->m_additionalPackageCatalogArguments.has_value()));
                 }
 
                 // Create the aggregated source.
@@ -78,15 +219,14 @@ namespace winrt::Microsoft::Management::Deployment::implementation
                 // Check if search behavior indicates that the caller does not want to do local correlation.
                 if (m_compositePackageCatalogOptions.CompositeSearchBehavior() != Microsoft::Management::Deployment::CompositeSearchBehavior::RemotePackagesFromRemoteCatalogs)
                 {
-                    ::AppInstaller::Repository::Source installedSource = ::AppInstaller::Repository::Source{ ::AppInstaller::Repository::PredefinedSource::Installed };
-                    installedSource.Open(progress);
+                    ::AppInstaller::Repository::Source installedSource = OpenedSourceCache::Instance().Open(
+                        ::AppInstaller::Repository::Source{ ::AppInstaller::Repository::PredefinedSource::Installed }, progress, true);
                     source = ::AppInstaller::Repository::Source{ installedSource, source, searchBehavior };
                 }
             }
             else
             {
-                source = m_sourceReference;
-                source.Open(progress);
+                source = OpenedSourceCache::Instance().Open(m_sourceReference, progress, !m_additionalPackageCatalogArguments.has_value());
             }
 
             if (!source)
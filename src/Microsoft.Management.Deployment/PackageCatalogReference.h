@@ -6,6 +6,11 @@
 
 namespace winrt::Microsoft::Management::Deployment::implementation
 {
+#if !defined(INCLUDE_ONLY_INTERFACE_METHODS)
+    // Drops the installed catalogs that connections share, as the installed packages have changed.
+    void DropKeptInstalledSources();
+#endif
+
     struct PackageCatalogReference : PackageCatalogReferenceT<PackageCatalogReference>
     {
         PackageCatalogReference() = default;
@@ -19,11 +24,14 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         winrt::Microsoft::Management::Deployment::PackageCatalogInfo Info();
         winrt::Windows::Foundation::IAsyncOperation<winrt::Microsoft::Management::Deployment::ConnectResult> ConnectAsync();
         winrt::Microsoft::Management::Deployment::ConnectResult Connect();
+        winrt::Windows::Foundation::IAsyncOperationWithProgress<winrt::Microsoft::Management::Deployment::ConnectResult, double> ConnectWithProgressAsync();
         hstring AdditionalPackageCatalogArguments();
         void AdditionalPackageCatalogArguments(hstring const& value);
 
 #if !defined(INCLUDE_ONLY_INTERFACE_METHODS)
     private:
+        winrt::Microsoft::Management::Deployment::ConnectResult Connect(::AppInstaller::IProgressCallback& progress);
+
         winrt::Microsoft::Management::Deployment::CreateCompositePackageCatalogOptions m_compositePackageCatalogOptions{ nullptr };
         winrt::Microsoft::Management::Deployment::PackageCatalogInfo m_info{ nullptr };
         ::AppInstaller::Repository::Source m_sourceReference;
@@ -12,6 +12,8 @@
 #include "Commands/COMInstallCommand.h"
 #include <AppInstallerTelemetry.h>
 #include <AppInstallerErrors.h>
+#include <winget/MemoryTrim.h>
+#include <winget/ProgressCoalescer.h>
 #pragma warning( push )
 #pragma warning ( disable : 4467 6388)
 // 6388 Allow CreateInstance.
@@ -36,6 +38,13 @@ using namespace ::AppInstaller::CLI::Execution;
 
 namespace winrt::Microsoft::Management::Deployment::implementation
 {
+    namespace
+    {
+        // The most often that progress within a state is reported to a caller of an install operation.
+        // Each report is a call into the caller's process, so a fast download would otherwise make thousands of them.
+        constexpr auto s_MinimumProgressReportInterval = 100ms;
+    }
+
     winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::PackageCatalogReference> PackageManager::GetPackageCatalogs()
     {
         Windows::Foundation::Collections::IVector<Microsoft::Management::Deployment::PackageCatalogReference> catalogs{ winrt::single_threaded_vector<Microsoft::Management::Deployment::PackageCatalogReference>() };
@@ -347,15 +356,14 @@ namespace winrt::Microsoft::Management::Deployment::implementation
 
     std::shared_ptr<Execution::OrchestratorQueueItem> GetExistingQueueItemForPackage(winrt::Microsoft::Management::Deployment::CatalogPackage package, winrt::Microsoft::Management::Deployment::PackageCatalogInfo catalogInfo)
     {
+        // Only the id is needed to find the item, so none of the context that an install needs is created.
         std::shared_ptr<Execution::OrchestratorQueueItem> queueItem = nullptr;
-        std::unique_ptr<COMContext> context = std::make_unique<COMContext>();
         if (catalogInfo)
         {
             // If the caller has passed in the catalog they expect the package to have come from, then only look for an install from that catalog.
             // Fail if they've used a catalog that doesn't have an Id. This can currently happen for Info objects that come from PackageCatalogReference objects for REST catalogs.
             THROW_HR_IF(APPINSTALLER_CLI_ERROR_INVALID_CL_ARGUMENTS, catalogInfo.Id().empty());
-            auto searchItem = Execution::OrchestratorQueueItemFactory::CreateItemForInstall(std::wstring{ package.Id() }, std::wstring{ catalogInfo.Id() }, std::move(context));
-            queueItem = Execution::ContextOrchestrator::Instance().GetQueueItem(searchItem->GetId());
+            queueItem = Execution::ContextOrchestrator::Instance().GetQueueItem(Execution::OrchestratorQueueItemId(std::wstring{ package.Id() }, std::wstring{ catalogInfo.Id() }));
             return queueItem;
         }
 
@@ -365,8 +373,7 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         Microsoft::Management::Deployment::PackageVersionInfo installedVersionInfo = package.InstalledVersion();
         if (installedVersionInfo)
         {
-            auto searchItem = Execution::OrchestratorQueueItemFactory::CreateItemForInstall(std::wstring{ package.Id() }, std::wstring{ installedVersionInfo.PackageCatalog().Info().Id() }, std::move(context));
-            queueItem = Execution::ContextOrchestrator::Instance().GetQueueItem(searchItem->GetId());
+            queueItem = Execution::ContextOrchestrator::Instance().GetQueueItem(Execution::OrchestratorQueueItemId(std::wstring{ package.Id() }, std::wstring{ installedVersionInfo.PackageCatalog().Info().Id() }));
             if (queueItem)
             {
                 return queueItem;
@@ -377,8 +384,7 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         Microsoft::Management::Deployment::PackageVersionInfo defaultInstallVersionInfo = package.DefaultInstallVersion();
         if (defaultInstallVersionInfo)
         {
-            auto searchItem = Execution::OrchestratorQueueItemFactory::CreateItemForInstall(std::wstring{ package.Id() }, std::wstring{ defaultInstallVersionInfo.PackageCatalog().Info().Id() }, std::move(context));
-            queueItem = Execution::ContextOrchestrator::Instance().GetQueueItem(searchItem->GetId());
+            queueItem = Execution::ContextOrchestrator::Instance().GetQueueItem(Execution::OrchestratorQueueItemId(std::wstring{ package.Id() }, std::wstring{ defaultInstallVersionInfo.PackageCatalog().Info().Id() }));
             if (queueItem)
             {
                 return queueItem;
@@ -388,8 +394,7 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         // Finally check all catalogs in AvailableVersions.
         for (Microsoft::Management::Deployment::PackageVersionId versionId : package.AvailableVersions())
         {
-            auto searchItem = Execution::OrchestratorQueueItemFactory::CreateItemForInstall(std::wstring{ package.Id() }, std::wstring{ package.GetPackageVersionInfo(versionId).PackageCatalog().Info().Id() }, std::move(context));
-            queueItem = Execution::ContextOrchestrator::Instance().GetQueueItem(searchItem->GetId());
+            queueItem = Execution::ContextOrchestrator::Instance().GetQueueItem(Execution::OrchestratorQueueItemId(std::wstring{ package.Id() }, std::wstring{ package.GetPackageVersionInfo(versionId).PackageCatalog().Info().Id() }));
             if (queueItem)
             {
                 return queueItem;
@@ -397,12 +402,265 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         }
         return nullptr;
     }
+    Execution::OrchestratorQueueItemPriority GetOrchestratorQueueItemPriority(winrt::Microsoft::Management::Deployment::PackageInstallPriority priority)
+    {
+        switch (priority)
+        {
+        case winrt::Microsoft::Management::Deployment::PackageInstallPriority::High:
+            return Execution::OrchestratorQueueItemPriority::High;
+        case winrt::Microsoft::Management::Deployment::PackageInstallPriority::Low:
+            return Execution::OrchestratorQueueItemPriority::Low;
+        case winrt::Microsoft::Management::Deployment::PackageInstallPriority::Normal:
+        default:
+            return Execution::OrchestratorQueueItemPriority::Normal;
+        }
+    }
+    std::shared_ptr<Execution::OrchestratorQueueItem> EnqueueInstall(
+        winrt::Microsoft::Management::Deployment::CatalogPackage package,
+        winrt::Microsoft::Management::Deployment::InstallOptions options,
+        const std::wstring& callerProcessInfoString,
+        DWORD callerProcessId)
+    {
+        Microsoft::Management::Deployment::PackageVersionInfo packageVersionInfo = GetPackageVersionInfo(package, options);
+        std::unique_ptr<COMContext> comContext = CreateContextFromInstallOptions(package, options, callerProcessInfoString);
+        std::shared_ptr<Execution::OrchestratorQueueItem> queueItem = Execution::OrchestratorQueueItemFactory::CreateItemForInstall(std::wstring{ package.Id() }, std::wstring{ packageVersionInfo.PackageCatalog().Info().Id() }, std::move(comContext));
+        queueItem->SetCallerProcessId(callerProcessId);
+        if (options)
+        {
+            queueItem->SetPriority(GetOrchestratorQueueItemPriority(options.PackageInstallPriority()));
+        }
+        Execution::ContextOrchestrator::Instance().EnqueueAndRunItem(queueItem);
+        return queueItem;
+    }
+
+    // Gets the fraction of the install of a package that is complete, counting the download and install as half each.
+    double GetPackageCompletion(const winrt::Microsoft::Management::Deployment::InstallProgress& progress)
+    {
+        switch (progress.State)
+        {
+        case PackageInstallProgressState::Queued:
+            return 0;
+        case PackageInstallProgressState::Downloading:
+            return progress.DownloadProgress / 2;
+        case PackageInstallProgressState::Installing:
+            return 0.5 + progress.InstallationProgress / 2;
+        default:
+            return 1;
+        }
+    }
+
+    // The state of an install of several packages, shared with the progress callbacks of their contexts.
+    struct InstallPackagesState
+    {
+        struct PackageState
+        {
+            std::shared_ptr<Execution::OrchestratorQueueItem> QueueItem;
+            winrt::Microsoft::Management::Deployment::InstallProgress Progress{ PackageInstallProgressState::Queued, 0, 0, 0, 0 };
+            std::optional<winrt::Microsoft::Management::Deployment::InstallResult> Result;
+        };
+
+        InstallPackagesState(size_t packageCount) : Packages(packageCount) {}
+
+        // Posts the progress of a package, with the progress of the whole operation.
+        _Requires_lock_held_(Lock)
+        void PostProgress(UINT32 index, bool isTransition)
+        {
+            const UINT32 packageCount = static_cast<UINT32>(Packages.size());
+
+            double completion = 0;
+            for (const auto& package : Packages)
+            {
+                completion += (package.Result ? 1 : GetPackageCompletion(package.Progress));
+            }
+
+            Progress.Post({ index, Packages[index].Progress, CompletedCount, packageCount, completion / packageCount }, isTransition);
+        }
+
+        std::mutex Lock;
+        std::vector<PackageState> Packages;
+        UINT32 CompletedCount = 0;
+        ::AppInstaller::ProgressCoalescer<winrt::Microsoft::Management::Deployment::InstallPackagesProgress> Progress{ s_MinimumProgressReportInterval };
+    };
+
+    winrt::Windows::Foundation::IAsyncOperationWithProgress<winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::InstallResult>, winrt::Microsoft::Management::Deployment::InstallPackagesProgress> GetInstallPackagesOperation(
+        std::vector<winrt::Microsoft::Management::Deployment::CatalogPackage> packages,
+        winrt::Microsoft::Management::Deployment::InstallOptions options,
+        std::wstring callerProcessInfoString,
+        DWORD callerProcessId)
+    {
+        hstring correlationData = (options) ? options.CorrelationData() : L"";
+        const UINT32 packageCount = static_cast<UINT32>(packages.size());
+        auto state = std::make_shared<InstallPackagesState>(packageCount);
+
+        auto report_progress{ co_await winrt::get_progress_token() };
+        auto cancellationToken{ co_await winrt::get_cancellation_token() };
+        // co_await does not guarantee that it's on a background thread, so do so explicitly.
+        co_await winrt::resume_background();
+
+        // Queue every package up front, so that the orchestrator can download later packages while earlier ones install.
+        for (UINT32 i = 0; i < packageCount; ++i)
+        {
+            winrt::hresult hr = S_OK;
+            try
+            {
+                auto queueItem = EnqueueInstall(packages[i], options, callerProcessInfoString, callerProcessId);
+
+                queueItem->GetContext().AddProgressCallbackFunction([state, i](
+                    ReportType reportType,
+                    uint64_t current,
+                    uint64_t maximum,
+                    ::AppInstaller::ProgressType progressType,
+                    ::Workflow::ExecutionStage executionPhase)
+                    {
+                        std::optional<winrt::Microsoft::Management::Deployment::InstallProgress> progress = GetProgress(reportType, current, maximum, progressType, executionPhase);
+                        if (progress.has_value())
+                        {
+                            std::lock_guard<std::mutex> lock{ state->Lock };
+                            auto& package = state->Packages[i];
+                            bool isTransition = reportType != ReportType::Progressing || package.Progress.State != progress->State;
+                            package.Progress = progress.value();
+                            state->PostProgress(i, isTransition);
+                        }
+                    });
+
+                std::lock_guard<std::mutex> lock{ state->Lock };
+                state->Packages[i].QueueItem = std::move(queueItem);
+            }
+            WINGET_CATCH_STORE(hr, APPINSTALLER_CLI_ERROR_COMMAND_FAILED);
+
+            std::lock_guard<std::mutex> lock{ state->Lock };
+            if (FAILED(hr))
+            {
+                // A package that cannot be queued fails by itself.
+                state->Packages[i].Result = GetInstallResult(::Workflow::ExecutionStage::Initial, hr, correlationData, false);
+                ++state->CompletedCount;
+            }
+
+            state->PostProgress(i, true);
+        }
+
+        // The cancellation of the AsyncOperation on the client cancels every package that can still be.
+        std::weak_ptr<InstallPackagesState> weakState = state;
+        cancellationToken.callback([weakState]()
+            {
+                auto strongState = weakState.lock();
+                if (strongState)
+                {
+                    std::vector<std::shared_ptr<Execution::OrchestratorQueueItem>> queueItems;
+                    {
+                        std::lock_guard<std::mutex> lock{ strongState->Lock };
+                        for (const auto& package : strongState->Packages)
+                        {
+                            if (package.QueueItem && !package.Result)
+                            {
+                                queueItems.emplace_back(package.QueueItem);
+                            }
+                        }
+                    }
+
+                    for (const auto& queueItem : queueItems)
+                    {
+                        Execution::ContextOrchestrator::Instance().CancelQueueItem(*queueItem);
+                    }
+                }
+            });
+
+        // Wait for each package in turn to complete, reporting progress for all of them as it comes.
+        // Waiting for both on the same thread ensures that progress is never reported after the async operation itself has completed.
+        for (UINT32 waitIndex = 0; waitIndex < packageCount; ++waitIndex)
+        {
+            std::shared_ptr<Execution::OrchestratorQueueItem> queueItem;
+            {
+                std::lock_guard<std::mutex> lock{ state->Lock };
+                if (state->Packages[waitIndex].Result)
+                {
+                    continue;
+                }
+
+                queueItem = state->Packages[waitIndex].QueueItem;
+            }
+
+            HANDLE operationEvents[2];
+            operationEvents[0] = state->Progress.GetEvent();
+            operationEvents[1] = queueItem->GetCompletedEvent().get();
+
+            bool completionEventFired = false;
+            while (!completionEventFired)
+            {
+                // Progress that is held back to the report interval is reported when the wait times out.
+                auto timeUntilNextUpdate = state->Progress.GetTimeUntilNextUpdate();
+                DWORD timeout = timeUntilNextUpdate ?
+                    static_cast<DWORD>(std::chrono::duration_cast<std::chrono::milliseconds>(*timeUntilNextUpdate).count()) : INFINITE;
+
+                DWORD dwEvent = WaitForMultipleObjects(
+                    _countof(operationEvents) /* number of events */,
+                    operationEvents /* event array */,
+                    FALSE /* bWaitAll, FALSE to wake on any event */,
+                    timeout /* wait until package completion, or held back progress is due */);
+
+                switch (dwEvent)
+                {
+                case WAIT_OBJECT_0 + 0:
+                case WAIT_TIMEOUT:
+                    for (const auto& progress : state->Progress.TakeUpdates())
+                    {
+                        report_progress(progress);
+                    }
+                    break;
+
+                case WAIT_OBJECT_0 + 1:
+                    completionEventFired = true;
+                    break;
+
+                default:
+                    THROW_LAST_ERROR();
+                }
+            }
+
+            // Later packages may have completed first; record them all, so that the count of completed packages is right.
+            std::lock_guard<std::mutex> lock{ state->Lock };
+            for (UINT32 i = waitIndex; i < packageCount; ++i)
+            {
+                auto& package = state->Packages[i];
+                if (!package.Result && WaitForSingleObject(package.QueueItem->GetCompletedEvent().get(), 0) == WAIT_OBJECT_0)
+                {
+                    auto& context = package.QueueItem->GetContext();
+                    package.Result = GetInstallResult(context.GetExecutionStage(), context.GetTerminationHR(), correlationData, false);
+                    package.Progress.State = PackageInstallProgressState::Finished;
+                    ++state->CompletedCount;
+                    state->PostProgress(i, true);
+                }
+            }
+        }
+
+        // Report the completion of the packages that finished last.
+        for (const auto& progress : state->Progress.TakeUpdates())
+        {
+            report_progress(progress);
+        }
+
+        // Later connections must see the packages that this installed.
+        DropKeptInstalledSources();
+
+        std::vector<winrt::Microsoft::Management::Deployment::InstallResult> results;
+        {
+            std::lock_guard<std::mutex> lock{ state->Lock };
+            for (const auto& package : state->Packages)
+            {
+                results.emplace_back(package.Result.value());
+            }
+        }
+
+        co_return winrt::single_threaded_vector(std::move(results)).GetView();
+    }
+
     winrt::Windows::Foundation::IAsyncOperationWithProgress<winrt::Microsoft::Management::Deployment::InstallResult, winrt::Microsoft::Management::Deployment::InstallProgress> GetInstallOperation(
         bool canCancelQueueItem,
         std::shared_ptr<Execution::OrchestratorQueueItem> queueItemParam,
         winrt::Microsoft::Management::Deployment::CatalogPackage package = nullptr,
         winrt::Microsoft::Management::Deployment::InstallOptions options = nullptr,
-        std::wstring callerProcessInfoString = {})
+        std::wstring callerProcessInfoString = {},
+        DWORD callerProcessId = 0)
     {
         winrt::hresult terminationHR = S_OK;
         hstring correlationData = (options) ? options.CorrelationData() : L"";
@@ -420,10 +678,7 @@ namespace winrt::Microsoft::Management::Deployment::implementation
 
             if (queueItem == nullptr)
             {
-                Microsoft::Management::Deployment::PackageVersionInfo packageVersionInfo = GetPackageVersionInfo(package, options);
-                std::unique_ptr<COMContext> comContext = CreateContextFromInstallOptions(package, options, callerProcessInfoString);
-                queueItem = Execution::OrchestratorQueueItemFactory::CreateItemForInstall(std::wstring{ package.Id() }, std::wstring{ packageVersionInfo.PackageCatalog().Info().Id() }, std::move(comContext));
-                Execution::ContextOrchestrator::Instance().EnqueueAndRunItem(queueItem);
+                queueItem = EnqueueInstall(package, options, callerProcessInfoString, callerProcessId);
 
                 InstallProgress queuedProgress{ PackageInstallProgressState::Queued, 0, 0, 0 };
                 report_progress(queuedProgress);
@@ -433,10 +688,10 @@ namespace winrt::Microsoft::Management::Deployment::implementation
                 correlationData = hstring(queueItem->GetContext().GetCorrelationJson());
             }
 
-            wil::unique_event progressEvent{ wil::EventOptions::None };
+            ::AppInstaller::ProgressCoalescer<winrt::Microsoft::Management::Deployment::InstallProgress> installProgress{ s_MinimumProgressReportInterval };
+            std::optional<PackageInstallProgressState> lastProgressState;
 
-            std::atomic<winrt::Microsoft::Management::Deployment::InstallProgress> installProgress;
-            queueItem->GetContext().AddProgressCallbackFunction([&installProgress, &progressEvent](
+            queueItem->GetContext().AddProgressCallbackFunction([&installProgress, &lastProgressState](
                 ReportType reportType,
                 uint64_t current,
                 uint64_t maximum,
@@ -446,8 +701,10 @@ namespace winrt::Microsoft::Management::Deployment::implementation
                     std::optional<winrt::Microsoft::Management::Deployment::InstallProgress> installProgressOptional = GetProgress(reportType, current, maximum, progressType, executionPhase);
                     if (installProgressOptional.has_value())
                     {
-                        installProgress = installProgressOptional.value();
-                        progressEvent.SetEvent();
+                        // Changes of state, and the start and end of progress, are always reported; progress within a state may be dropped.
+                        bool isTransition = reportType != ReportType::Progressing || lastProgressState != installProgressOptional->State;
+                        lastProgressState = installProgressOptional->State;
+                        installProgress.Post(installProgressOptional.value(), isTransition);
                     }
                     return;
                 }
@@ -470,26 +727,33 @@ namespace winrt::Microsoft::Management::Deployment::implementation
             // Waiting for both on the same thread ensures that progress is never reported after the async operation itself has completed.
             bool completionEventFired = false;
             HANDLE operationEvents[2];
-            operationEvents[0] = progressEvent.get();
+            operationEvents[0] = installProgress.GetEvent();
             operationEvents[1] = queueItem->GetCompletedEvent().get();
             while (!completionEventFired)
             {
+                // Progress that is held back to the report interval is reported when the wait times out.
+                auto timeUntilNextUpdate = installProgress.GetTimeUntilNextUpdate();
+                DWORD timeout = timeUntilNextUpdate ?
+                    static_cast<DWORD>(std::chrono::duration_cast<std::chrono::milliseconds>(*timeUntilNextUpdate).count()) : INFINITE;
+
                 DWORD dwEvent = WaitForMultipleObjects(
                     _countof(operationEvents) /* number of events */,
                     operationEvents /* event array */,
                     FALSE /* bWaitAll, FALSE to wake on any event */,
-                    INFINITE /* wait until operation completion */);
+                    timeout /* wait until operation completion, or held back progress is due */);
 
                 switch (dwEvent)
                 {
-                    // operationEvents[0] was signaled, progress
+                    // operationEvents[0] was signaled, progress; or held back progress is due
                 case WAIT_OBJECT_0 + 0:
+                case WAIT_TIMEOUT:
                     // The report_progress call will hang when making callbacks to suspended processes so it's important that this is now on a background thread.
-                    // Progress events are not queued - some will be missed if multiple progress events are fired from the ComContext to the callback 
-                    // while the report_progress call is hung\in progress.
-                    // Duplicate progress events can be fired if another progress event comes from the ComContext to the callback after the listener
-                    // has been awaked, but before it has gotten the installProgress.
-                    report_progress(installProgress);
+                    // Progress within a state is coalesced while the report_progress call is hung\in progress, and only the latest is reported after it,
+                    // but changes of state are all reported in order.
+                    for (const auto& progress : installProgress.TakeUpdates())
+                    {
+                        report_progress(progress);
+                    }
                     break;
 
                     // operationEvents[1] was signaled, operation completed
@@ -508,6 +772,9 @@ namespace winrt::Microsoft::Management::Deployment::implementation
                 // The install command has finished, check for success/failure and how far it got.
                 terminationHR = queueItem->GetContext().GetTerminationHR();
                 executionStage = queueItem->GetContext().GetExecutionStage();
+
+                // Later connections must see the package that this installed.
+                DropKeptInstalledSources();
             }
         }
         WINGET_CATCH_STORE(terminationHR, APPINSTALLER_CLI_ERROR_COMMAND_FAILED);
@@ -530,6 +797,8 @@ namespace winrt::Microsoft::Management::Deployment::implementation
 
     winrt::Windows::Foundation::IAsyncOperationWithProgress<winrt::Microsoft::Management::Deployment::InstallResult, winrt::Microsoft::Management::Deployment::InstallProgress> PackageManager::InstallPackageAsync(winrt::Microsoft::Management::Deployment::CatalogPackage package, winrt::Microsoft::Management::Deployment::InstallOptions options)
     {
+        ::AppInstaller::Memory::NotifyActivity();
+
         hstring correlationData = (options) ? options.CorrelationData() : L"";
 
         // options and catalog can both be null, package must be set.
@@ -537,11 +806,13 @@ namespace winrt::Microsoft::Management::Deployment::implementation
 
         HRESULT hr = S_OK;
         std::wstring callerProcessInfoString;
+        DWORD callerProcessId = 0;
         try
         {
             // Check for permissions and get caller info for telemetry.
             // This must be done before any co_awaits since it requires info from the rpc caller thread.
-            auto [hrGetCallerId, callerProcessId] = GetCallerProcessId();
+            HRESULT hrGetCallerId = S_OK;
+            std::tie(hrGetCallerId, callerProcessId) = GetCallerProcessId();
             WINGET_RETURN_INSTALL_RESULT_HR_IF_FAILED(hrGetCallerId);
             WINGET_RETURN_INSTALL_RESULT_HR_IF_FAILED(EnsureProcessHasCapability(Capability::PackageManagement, callerProcessId));
             callerProcessInfoString = TryGetCallerProcessInfo(callerProcessId);
@@ -549,7 +820,7 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         WINGET_CATCH_STORE(hr, APPINSTALLER_CLI_ERROR_COMMAND_FAILED);
         WINGET_RETURN_INSTALL_RESULT_HR_IF_FAILED(hr);
 
-        return GetInstallOperation(true /*canCancelQueueItem*/, nullptr /*queueItem*/, package, options, std::move(callerProcessInfoString));
+        return GetInstallOperation(true /*canCancelQueueItem*/, nullptr /*queueItem*/, package, options, std::move(callerProcessInfoString), callerProcessId);
     }
 
     winrt::Windows::Foundation::IAsyncOperationWithProgress<winrt::Microsoft::Management::Deployment::InstallResult, winrt::Microsoft::Management::Deployment::InstallProgress> PackageManager::GetInstallProgress(winrt::Microsoft::Management::Deployment::CatalogPackage package, winrt::Microsoft::Management::Deployment::PackageCatalogInfo catalogInfo)
@@ -585,5 +856,35 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         return GetInstallOperation(canCancelQueueItem, std::move(queueItem));
     }
 
+    winrt::Windows::Foundation::IAsyncOperationWithProgress<winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::InstallResult>, winrt::Microsoft::Management::Deployment::InstallPackagesProgress>
+        PackageManager::InstallPackagesAsync(winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::CatalogPackage> packages, winrt::Microsoft::Management::Deployment::InstallOptions options)
+    {
+        // options can be null, packages must be set and none of them null.
+        if (!packages)
+        {
+            throw hresult_invalid_argument();
+        }
+
+        std::vector<winrt::Microsoft::Management::Deployment::CatalogPackage> packageList;
+        for (const auto& package : packages)
+        {
+            if (!package)
+            {
+                throw hresult_invalid_argument();
+            }
+
+            packageList.emplace_back(package);
+        }
+
+        // Check for permissions and get caller info for telemetry.
+        // This must be done before any co_awaits since it requires info from the rpc caller thread.
+        auto [hrGetCallerId, callerProcessId] = GetCallerProcessId();
+        THROW_IF_FAILED(hrGetCallerId);
+        THROW_IF_FAILED(EnsureProcessHasCapability(Capability::PackageManagement, callerProcessId));
+        std::wstring callerProcessInfoString = TryGetCallerProcessInfo(callerProcessId);
+
+        return GetInstallPackagesOperation(std::move(packageList), options, std::move(callerProcessInfoString), callerProcessId);
+    }
+
     CoCreatableMicrosoftManagementDeploymentClass(PackageManager);
 }
@@ -24,6 +24,9 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         //Contract 2.0
         winrt::Windows::Foundation::IAsyncOperationWithProgress<winrt::Microsoft::Management::Deployment::InstallResult, winrt::Microsoft::Management::Deployment::InstallProgress> 
             GetInstallProgress(winrt::Microsoft::Management::Deployment::CatalogPackage package, winrt::Microsoft::Management::Deployment::PackageCatalogInfo catalogInfo);
+        //Contract 4.0
+        winrt::Windows::Foundation::IAsyncOperationWithProgress<winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::InstallResult>, winrt::Microsoft::Management::Deployment::InstallPackagesProgress>
+            InstallPackagesAsync(winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::CatalogPackage> packages, winrt::Microsoft::Management::Deployment::InstallOptions options);
     };
 }
 
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include <winget/RepositorySearch.h>
+#include "UpgradeSummary.h"
+#include "UpgradeSummary.g.cpp"
+
+namespace winrt::Microsoft::Management::Deployment::implementation
+{
+    void UpgradeSummary::Initialize(const ::AppInstaller::Repository::UpgradeSummary& summary)
+    {
+        for (const auto& packageId : summary.PackageIds)
+        {
+            m_packageIds.Append(winrt::to_hstring(packageId.get()));
+        }
+
+        m_unknownVersionCount = static_cast<uint32_t>(summary.UnknownVersionCount);
+    }
+    winrt::Windows::Foundation::Collections::IVectorView<hstring> UpgradeSummary::PackageIds()
+    {
+        return m_packageIds.GetView();
+    }
+    uint32_t UpgradeSummary::UnknownVersionCount()
+    {
+        return m_unknownVersionCount;
+    }
+}
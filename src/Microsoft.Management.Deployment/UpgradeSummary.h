@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "UpgradeSummary.g.h"
+
+namespace winrt::Microsoft::Management::Deployment::implementation
+{
+    struct UpgradeSummary : UpgradeSummaryT<UpgradeSummary>
+    {
+        UpgradeSummary() = default;
+
+#if !defined(INCLUDE_ONLY_INTERFACE_METHODS)
+        void Initialize(const ::AppInstaller::Repository::UpgradeSummary& summary);
+#endif
+
+        winrt::Windows::Foundation::Collections::IVectorView<hstring> PackageIds();
+        uint32_t UnknownVersionCount();
+
+#if !defined(INCLUDE_ONLY_INTERFACE_METHODS)
+    private:
+        winrt::Windows::Foundation::Collections::IVector<hstring> m_packageIds{ winrt::single_threaded_vector<hstring>() };
+        uint32_t m_unknownVersionCount = 0;
+#endif
+    };
+}
@@ -39,5 +39,56 @@ namespace PackagedUnitTests
             PackageCatalogReference catalogRef = packageManager.GetPredefinedPackageCatalog(PredefinedPackageCatalog.MicrosoftStore);
             Assert.IsTrue(catalogRef.Info.Name.Equals("msstore"));
         }
+
+        [TestMethod]
+        public void FindPackagesGetMatchesBounds()
+        {
+            PackageManager packageManager = new PackageManager();
+            PackageCatalogReference catalogRef = packageManager.GetPredefinedPackageCatalog(PredefinedPackageCatalog.OpenWindowsCatalog);
+            ConnectResult connectResult = catalogRef.Connect();
+            Assert.AreEqual(ConnectResultStatus.Ok, connectResult.Status);
+
+            FindPackagesOptions options = new FindPackagesOptions();
+            options.Selectors.Add(new PackageMatchFilter()
+            {
+                Field = PackageMatchField.Id,
+                Option = PackageFieldMatchOption.StartsWithCaseInsensitive,
+                Value = "Microsoft.",
+            });
+            options.ResultLimit = 10;
+
+            FindPackagesResult findResult = connectResult.PackageCatalog.FindPackages(options);
+            Assert.AreEqual(FindPackagesResultStatus.Ok, findResult.Status);
+
+            uint matchCount = findResult.MatchCount;
+            Assert.IsTrue(matchCount >= 4);
+            Assert.AreEqual((int)matchCount, findResult.Matches.Count);
+
+            // A page that starts at or past the end is empty, rather than an error.
+            Assert.AreEqual(0, findResult.GetMatches(matchCount, 5).Count);
+            Assert.AreEqual(0, findResult.GetMatches(matchCount + 10, 5).Count);
+            Assert.AreEqual(0, findResult.GetProjections(matchCount + 10, 5).Length);
+
+            // A count of zero gets nothing.
+            Assert.AreEqual(0, findResult.GetMatches(0, 0).Count);
+            Assert.AreEqual(0, findResult.GetProjections(0, 0).Length);
+
+            // A page that runs past the end gets the results that remain.
+            Assert.AreEqual(1, findResult.GetMatches(matchCount - 1, 10).Count);
+
+            // Overlapping pages agree on the results they share, and agree with Matches.
+            IReadOnlyList<MatchResult> firstPage = findResult.GetMatches(0, 4);
+            IReadOnlyList<MatchResult> secondPage = findResult.GetMatches(2, 4);
+            Assert.AreEqual(4, firstPage.Count);
+            Assert.AreEqual(4, secondPage.Count);
+            Assert.AreEqual(firstPage[2].CatalogPackage.Id, secondPage[0].CatalogPackage.Id);
+            Assert.AreEqual(firstPage[3].CatalogPackage.Id, secondPage[1].CatalogPackage.Id);
+
+            IReadOnlyList<MatchResult> allMatches = findResult.Matches;
+            for (int i = 0; i < secondPage.Count; ++i)
+            {
+                Assert.AreEqual(allMatches[i + 2].CatalogPackage.Id, secondPage[i].CatalogPackage.Id);
+            }
+        }
     }
 }
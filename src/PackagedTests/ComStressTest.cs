@@ -0,0 +1,291 @@
+﻿// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Runtime.InteropServices;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.Management.Deployment;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace PackagedUnitTests
+{
+    /// <summary>
+    /// Drives concurrent clients against the server to measure it under load, rather than to check its behavior.
+    /// Each client has its own PackageManager and issues Connect, FindPackages, and InstallPackageAsync followed by
+    /// GetInstallProgress, in turn, at the configured rate against the catalog named by StressCatalogName.
+    /// The installs are dry runs: each is cancelled as soon as it reports that it is queued or downloading.
+    /// The test is skipped unless StressClientCount is set in the run settings.
+    /// </summary>
+    [TestClass]
+    public class ComStressTests
+    {
+        private const string ClientCountParameter = "StressClientCount";
+        private const string RequestsPerSecondParameter = "StressRequestsPerSecond";
+        private const string DurationSecondsParameter = "StressDurationSeconds";
+        private const string CatalogNameParameter = "StressCatalogName";
+        private const string PackageIdPrefixParameter = "StressPackageIdPrefix";
+
+        private const string ConnectOperation = "Connect";
+        private const string FindPackagesOperation = "FindPackages";
+        private const string InstallOperation = "InstallPackageAsync";
+        private const string GetInstallProgressOperation = "GetInstallProgress";
+
+        private static readonly TimeSpan SampleInterval = TimeSpan.FromSeconds(1);
+
+        public TestContext TestContext { get; set; }
+
+        [TestMethod]
+        [TestCategory("Stress")]
+        public async Task ConcurrentClients()
+        {
+            int clientCount = this.GetParameter(ClientCountParameter, 0);
+            if (clientCount <= 0)
+            {
+                Assert.Inconclusive($"Set {ClientCountParameter} in the run settings to run the stress test.");
+            }
+
+            double requestsPerSecond = this.GetParameter(RequestsPerSecondParameter, 2);
+            TimeSpan duration = TimeSpan.FromSeconds(this.GetParameter(DurationSecondsParameter, 60));
+            string catalogName = this.GetParameter(CatalogNameParameter, "TestSource");
+            string packageIdPrefix = this.GetParameter(PackageIdPrefixParameter, "PerfTest.Package");
+
+            var latencies = new ConcurrentDictionary<string, ConcurrentBag<double>>();
+            var failures = new ConcurrentBag<string>();
+            var samples = new List<Sample>();
+
+            ServerStatistics initial = GetServerStatistics();
+            Stopwatch elapsed = Stopwatch.StartNew();
+
+            using (var cancellation = new CancellationTokenSource(duration))
+            {
+                Task sampler = Task.Run(async () =>
+                {
+                    while (!cancellation.IsCancellationRequested)
+                    {
+                        samples.Add(new Sample() { Elapsed = elapsed.Elapsed, Statistics = GetServerStatistics() });
+                        await Task.Delay(SampleInterval);
+                    }
+                });
+
+                Task[] clients = Enumerable.Range(0, clientCount).Select(i => Task.Run(() => RunClient(i, catalogName, packageIdPrefix, requestsPerSecond, latencies, failures, cancellation.Token))).ToArray();
+
+                await Task.WhenAll(clients);
+                await sampler;
+            }
+
+            ServerStatistics final = GetServerStatistics();
+
+            this.TestContext.WriteLine($"{clientCount} clients at {requestsPerSecond} requests per second each, for {elapsed.Elapsed.TotalSeconds:F1} seconds against {catalogName}");
+
+            foreach (var operation in latencies.OrderBy(o => o.Key))
+            {
+                List<double> sorted = operation.Value.OrderBy(v => v).ToList();
+                this.TestContext.WriteLine($"{operation.Key}: count {sorted.Count}, p50 {GetPercentile(sorted, 0.5):F1} ms, p99 {GetPercentile(sorted, 0.99):F1} ms, max {sorted.Last():F1} ms");
+            }
+
+            ulong acquisitions = final.LockAcquisitions - initial.LockAcquisitions;
+            ulong contended = final.ContendedLockAcquisitions - initial.ContendedLockAcquisitions;
+            this.TestContext.WriteLine($"Orchestrator locks: {acquisitions} acquisitions, {contended} contended, {(final.LockWaitMicroseconds - initial.LockWaitMicroseconds) / 1000.0:F1} ms waiting, longest wait {final.MaximumLockWaitMicroseconds / 1000.0:F1} ms");
+
+            this.TestContext.WriteLine("Seconds, Threads, WorkingSetMB, LockWaitMs");
+            foreach (var sample in samples)
+            {
+                ServerStatistics statistics = sample.Statistics;
+                this.TestContext.WriteLine($"{sample.Elapsed.TotalSeconds:F0}, {statistics.ThreadCount}, {statistics.WorkingSetBytes / (1024.0 * 1024.0):F1}, {(statistics.LockWaitMicroseconds - initial.LockWaitMicroseconds) / 1000.0:F1}");
+            }
+
+            if (!failures.IsEmpty)
+            {
+                Assert.Fail($"{failures.Count} requests failed; the first was: {failures.First()}");
+            }
+        }
+
+        private static void RunClient(int clientIndex, string catalogName, string packageIdPrefix, double requestsPerSecond, ConcurrentDictionary<string, ConcurrentBag<double>> latencies, ConcurrentBag<string> failures, CancellationToken cancellationToken)
+        {
+            var packageManager = new PackageManager();
+            PackageCatalogReference catalogReference = packageManager.GetPackageCatalogByName(catalogName);
+            if (catalogReference == null)
+            {
+                failures.Add($"Client {clientIndex} did not find the catalog {catalogName}");
+                return;
+            }
+
+            var random = new Random(clientIndex);
+            PackageCatalog catalog = null;
+            IReadOnlyList<MatchResult> matches = null;
+
+            // The requests are scheduled from the start rather than from the end of the last one,
+            // so that a slow server falls behind the rate instead of lowering it.
+            TimeSpan interval = TimeSpan.FromSeconds(1 / requestsPerSecond);
+            Stopwatch schedule = Stopwatch.StartNew();
+
+            for (long request = 0; !cancellationToken.IsCancellationRequested; ++request)
+            {
+                TimeSpan wait = TimeSpan.FromTicks(interval.Ticks * request) - schedule.Elapsed;
+                if (wait > TimeSpan.Zero && cancellationToken.WaitHandle.WaitOne(wait))
+                {
+                    break;
+                }
+
+                try
+                {
+                    switch (request % 3)
+                    {
+                        case 0:
+                            ConnectResult connectResult = Measure(latencies, ConnectOperation, () => catalogReference.Connect());
+                            if (connectResult.Status != ConnectResultStatus.Ok)
+                            {
+                                failures.Add($"Connect returned {connectResult.Status}");
+                                break;
+                            }
+
+                            catalog = connectResult.PackageCatalog;
+                            break;
+
+                        case 1:
+                            if (catalog == null)
+                            {
+                                break;
+                            }
+
+                            var options = new FindPackagesOptions();
+                            options.Selectors.Add(new PackageMatchFilter()
+                            {
+                                Field = PackageMatchField.Id,
+                                Option = PackageFieldMatchOption.StartsWithCaseInsensitive,
+                                Value = packageIdPrefix + random.Next(10),
+                            });
+                            options.ResultLimit = 10;
+
+                            FindPackagesResult findResult = Measure(latencies, FindPackagesOperation, () => catalog.FindPackages(options));
+                            if (findResult.Status != FindPackagesResultStatus.Ok)
+                            {
+                                failures.Add($"FindPackages returned {findResult.Status}");
+                                break;
+                            }
+
+                            matches = findResult.Matches;
+                            break;
+
+                        case 2:
+                            if (matches == null || matches.Count == 0)
+                            {
+                                break;
+                            }
+
+                            DryRunInstall(packageManager, catalog.Info, matches[random.Next(matches.Count)].CatalogPackage, latencies);
+                            break;
+                    }
+                }
+                catch (Exception e)
+                {
+                    failures.Add($"Client {clientIndex} request {request}: {e}");
+                }
+            }
+        }
+
+        private static void DryRunInstall(PackageManager packageManager, PackageCatalogInfo catalogInfo, CatalogPackage package, ConcurrentDictionary<string, ConcurrentBag<double>> latencies)
+        {
+            var queued = new ManualResetEventSlim();
+            Stopwatch stopwatch = Stopwatch.StartNew();
+
+            var operation = packageManager.InstallPackageAsync(package, new InstallOptions());
+            operation.Progress = (_, progress) =>
+            {
+                if (progress.State == PackageInstallProgressState.Queued || progress.State == PackageInstallProgressState.Downloading)
+                {
+                    queued.Set();
+                }
+            };
+
+            // The latency of an install is the time until the server reports that it has taken it.
+            if (!queued.Wait(TimeSpan.FromSeconds(30)))
+            {
+                operation.Cancel();
+                throw new TimeoutException($"The install of {package.Id} did not report progress");
+            }
+
+            AddLatency(latencies, InstallOperation, stopwatch.Elapsed);
+
+            Measure(latencies, GetInstallProgressOperation, () => packageManager.GetInstallProgress(package, catalogInfo));
+
+            operation.Cancel();
+
+            try
+            {
+                operation.AsTask().Wait();
+            }
+            catch (AggregateException e) when (e.InnerException is OperationCanceledException)
+            {
+            }
+        }
+
+        private static T Measure<T>(ConcurrentDictionary<string, ConcurrentBag<double>> latencies, string operation, Func<T> function)
+        {
+            Stopwatch stopwatch = Stopwatch.StartNew();
+            T result = function();
+            AddLatency(latencies, operation, stopwatch.Elapsed);
+            return result;
+        }
+
+        private static void AddLatency(ConcurrentDictionary<string, ConcurrentBag<double>> latencies, string operation, TimeSpan latency)
+        {
+            latencies.GetOrAdd(operation, _ => new ConcurrentBag<double>()).Add(latency.TotalMilliseconds);
+        }
+
+        private static double GetPercentile(List<double> sorted, double percentile)
+        {
+            int index = (int)Math.Ceiling(percentile * sorted.Count) - 1;
+            return sorted[Math.Max(0, Math.Min(index, sorted.Count - 1))];
+        }
+
+        private static ServerStatistics GetServerStatistics()
+        {
+            Marshal.ThrowExceptionForHR(NativeMethods.WinGetServerTestGetStatistics(out ServerStatistics statistics));
+            return statistics;
+        }
+
+        private T GetParameter<T>(string name, T defaultValue)
+        {
+            if (this.TestContext.Properties.Contains(name) && this.TestContext.Properties[name] is string value && !string.IsNullOrEmpty(value))
+            {
+                return (T)Convert.ChangeType(value, typeof(T));
+            }
+
+            return defaultValue;
+        }
+
+        /// <summary>
+        /// The statistics of the server, which runs in this process from the test server library.
+        /// The layout must match WinGetServerTestStatistics in that library.
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        private struct ServerStatistics
+        {
+            public ulong ThreadCount;
+            public ulong WorkingSetBytes;
+            public ulong LockAcquisitions;
+            public ulong ContendedLockAcquisitions;
+            public ulong LockWaitMicroseconds;
+            public ulong MaximumLockWaitMicroseconds;
+        }
+
+        private class Sample
+        {
+            public TimeSpan Elapsed { get; set; }
+
+            public ServerStatistics Statistics { get; set; }
+        }
+
+        private static class NativeMethods
+        {
+            [DllImport("Microsoft.Management.Deployment.dll")]
+            public static extern int WinGetServerTestGetStatistics(out ServerStatistics statistics);
+        }
+    }
+}
@@ -0,0 +1,173 @@
+﻿// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.Management.Deployment;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using Windows.Foundation;
+
+namespace PackagedUnitTests
+{
+    /// <summary>
+    /// Installs sets of packages with InstallPackagesAsync from the catalog named by InstallCatalogName,
+    /// which is the test source that the end to end tests set up.
+    /// The tests are skipped if that catalog is not configured.
+    /// </summary>
+    [TestClass]
+    public class InstallPackagesTests
+    {
+        private const string CatalogNameParameter = "InstallCatalogName";
+
+        private const string ExeInstallerId = "AppInstallerTest.TestExeInstaller";
+        private const string ExampleInstallerId = "AppInstallerTest.TestExampleInstaller";
+        private const string HashMismatchInstallerId = "AppInstallerTest.TestExeSha256Mismatch";
+
+        public TestContext TestContext { get; set; }
+
+        [TestMethod]
+        public async Task InstallPackagesAllSucceed()
+        {
+            PackageManager packageManager = new PackageManager();
+            PackageCatalog catalog = this.ConnectCatalog(packageManager);
+            List<CatalogPackage> packages = new List<CatalogPackage>() { FindPackage(catalog, ExeInstallerId), FindPackage(catalog, ExampleInstallerId) };
+
+            var progressReports = new ConcurrentQueue<InstallPackagesProgress>();
+            var operation = packageManager.InstallPackagesAsync(packages, this.CreateInstallOptions());
+            operation.Progress = (_, progress) => progressReports.Enqueue(progress);
+
+            IReadOnlyList<InstallResult> results = await operation;
+
+            Assert.AreEqual(packages.Count, results.Count);
+            foreach (InstallResult result in results)
+            {
+                Assert.AreEqual(InstallResultStatus.Ok, result.Status);
+            }
+
+            // Every report is for one of the packages, and the last says that all of them are done.
+            Assert.IsFalse(progressReports.IsEmpty);
+            foreach (InstallPackagesProgress progress in progressReports)
+            {
+                Assert.AreEqual((uint)packages.Count, progress.PackageCount);
+                Assert.IsTrue(progress.PackageIndex < packages.Count);
+            }
+
+            InstallPackagesProgress last = progressReports.Last();
+            Assert.AreEqual((uint)packages.Count, last.CompletedPackageCount);
+            Assert.AreEqual(1.0, last.Progress, 0.001);
+        }
+
+        [TestMethod]
+        public async Task InstallPackagesPartialFailure()
+        {
+            PackageManager packageManager = new PackageManager();
+            PackageCatalog catalog = this.ConnectCatalog(packageManager);
+
+            // The package that fails comes first, so that the one after it shows that the failure did not stop the others.
+            List<CatalogPackage> packages = new List<CatalogPackage>() { FindPackage(catalog, HashMismatchInstallerId), FindPackage(catalog, ExeInstallerId) };
+
+            IReadOnlyList<InstallResult> results = await packageManager.InstallPackagesAsync(packages, this.CreateInstallOptions());
+
+            Assert.AreEqual(packages.Count, results.Count);
+            Assert.AreEqual(InstallResultStatus.DownloadError, results[0].Status);
+            Assert.AreNotEqual(0, results[0].ExtendedErrorCode.HResult);
+            Assert.AreEqual(InstallResultStatus.Ok, results[1].Status);
+        }
+
+        [TestMethod]
+        public async Task InstallPackagesCancel()
+        {
+            PackageManager packageManager = new PackageManager();
+            PackageCatalog catalog = this.ConnectCatalog(packageManager);
+            List<CatalogPackage> packages = new List<CatalogPackage>() { FindPackage(catalog, ExeInstallerId), FindPackage(catalog, ExampleInstallerId) };
+
+            var queued = new ManualResetEventSlim();
+            var operation = packageManager.InstallPackagesAsync(packages, this.CreateInstallOptions());
+            operation.Progress = (_, progress) =>
+            {
+                if (progress.PackageProgress.State == PackageInstallProgressState.Queued || progress.PackageProgress.State == PackageInstallProgressState.Downloading)
+                {
+                    queued.Set();
+                }
+            };
+
+            Assert.IsTrue(queued.Wait(TimeSpan.FromSeconds(30)), "The packages did not report progress");
+            operation.Cancel();
+
+            bool cancelled = false;
+            try
+            {
+                await operation;
+            }
+            catch (OperationCanceledException)
+            {
+                cancelled = true;
+            }
+
+            Assert.IsTrue(cancelled);
+            Assert.AreEqual(AsyncStatus.Canceled, operation.Status);
+
+            // The server is left able to install the same packages again.
+            IReadOnlyList<InstallResult> results = await packageManager.InstallPackagesAsync(packages, this.CreateInstallOptions());
+            Assert.AreEqual(packages.Count, results.Count);
+            foreach (InstallResult result in results)
+            {
+                Assert.AreEqual(InstallResultStatus.Ok, result.Status);
+            }
+        }
+
+        private static CatalogPackage FindPackage(PackageCatalog catalog, string id)
+        {
+            FindPackagesOptions options = new FindPackagesOptions();
+            options.Filters.Add(new PackageMatchFilter()
+            {
+                Field = PackageMatchField.Id,
+                Option = PackageFieldMatchOption.Equals,
+                Value = id,
+            });
+
+            FindPackagesResult findResult = catalog.FindPackages(options);
+            Assert.AreEqual(FindPackagesResultStatus.Ok, findResult.Status);
+            Assert.AreEqual(1, findResult.Matches.Count, $"Did not find the package {id}");
+            return findResult.Matches[0].CatalogPackage;
+        }
+
+        private PackageCatalog ConnectCatalog(PackageManager packageManager)
+        {
+            string catalogName = this.GetCatalogName();
+            PackageCatalogReference catalogReference = packageManager.GetPackageCatalogByName(catalogName);
+            if (catalogReference == null)
+            {
+                Assert.Inconclusive($"Add the catalog {catalogName}, or set {CatalogNameParameter} in the run settings, to run the install tests.");
+            }
+
+            ConnectResult connectResult = catalogReference.Connect();
+            Assert.AreEqual(ConnectResultStatus.Ok, connectResult.Status);
+            return connectResult.PackageCatalog;
+        }
+
+        private InstallOptions CreateInstallOptions()
+        {
+            return new InstallOptions()
+            {
+                PackageInstallMode = PackageInstallMode.Silent,
+                PreferredInstallLocation = Path.Combine(Path.GetTempPath(), Path.GetRandomFileName()),
+            };
+        }
+
+        private string GetCatalogName()
+        {
+            if (this.TestContext.Properties.Contains(CatalogNameParameter) && this.TestContext.Properties[CatalogNameParameter] is string value && !string.IsNullOrEmpty(value))
+            {
+                return value;
+            }
+
+            return "TestSource";
+        }
+    }
+}
@@ -39,5 +39,8 @@ int __stdcall wWinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPWSTR, _In_ int
     }
     CATCH_RETURN()
 
+    // Work that outlived the last client, such as a source update, is finished before the server exits.
+    RETURN_IF_FAILED(WindowsPackageManagerServerShutdown());
+
     return 0;
 }
@@ -9,6 +9,8 @@
 #include <AppInstallerStrings.h>
 #include <AppInstallerTelemetry.h>
 #include <Microsoft/SQLiteIndex.h>
+#include <Microsoft/SQLiteIndexDiff.h>
+#include <Microsoft/ShardedIndexSource.h>
 #include <winget/ManifestYamlParser.h>
 #include <PackageDependenciesValidation.h>
 #include <winget/ThreadGlobals.h>
@@ -18,6 +20,67 @@ using namespace AppInstaller::Manifest;
 using namespace AppInstaller::Repository;
 using namespace AppInstaller::Repository::Microsoft;
 
+namespace
+{
+    ManifestValidateOption GetManifestValidateOption(WinGetValidateManifestOption option)
+    {
+        ManifestValidateOption validateOption;
+        validateOption.FullValidation = true;
+        validateOption.ThrowOnWarning = true;
+        validateOption.SchemaValidationOnly = WI_IsFlagSet(option, WinGetValidateManifestOption::SchemaValidationOnly);
+        validateOption.ErrorOnVerifiedPublisherFields = WI_IsFlagSet(option, WinGetValidateManifestOption::ErrorOnVerifiedPublisherFields);
+        return validateOption;
+    }
+
+    // Runs work(i) for each i below count on worker threads, which log through the thread globals of the calling thread.
+    // The work must not throw.
+    template <typename Work>
+    void RunOnWorkers(UINT32 count, Work&& work)
+    {
+        using namespace AppInstaller::ThreadLocalStorage;
+
+        std::atomic<UINT32> next = 0;
+        auto run = [&]()
+        {
+            for (UINT32 i = next++; i < count; i = next++)
+            {
+                work(i);
+            }
+        };
+
+        size_t workerCount = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), count);
+        if (workerCount <= 1)
+        {
+            run();
+            return;
+        }
+
+        ThreadGlobals* parentThreadGlobals = ThreadGlobals::GetForCurrentThread();
+        std::vector<std::thread> workers;
+        auto joinWorkers = wil::scope_exit([&]() { for (auto& worker : workers) { worker.join(); } });
+
+        for (size_t i = 0; i < workerCount; ++i)
+        {
+            std::shared_ptr<ThreadGlobals> threadGlobals;
+            if (parentThreadGlobals)
+            {
+                threadGlobals = std::make_shared<ThreadGlobals>(*parentThreadGlobals, ThreadGlobals::create_sub_thread_globals_t{});
+            }
+
+            workers.emplace_back([&run, threadGlobals]()
+                {
+                    std::unique_ptr<PreviousThreadGlobals> previousThreadGlobals;
+                    if (threadGlobals)
+                    {
+                        previousThreadGlobals = threadGlobals->SetForCurrentThread();
+                    }
+
+                    run();
+                });
+        }
+    }
+}
+
 extern "C"
 {
     WINGET_UTIL_API WinGetLoggingInit(WINGET_STRING logPath) try
@@ -76,6 +139,7 @@ extern "C"
         Schema::Version internalVersion{ majorVersion, minorVersion };
 
         std::unique_ptr<SQLiteIndex> result = std::make_unique<SQLiteIndex>(SQLiteIndex::CreateNew(filePathUtf8, internalVersion));
+        result->SetWriteMode(SQLiteIndex::WriteMode::Build);
 
         *index = static_cast<WINGET_SQLITE_INDEX_HANDLE>(result.release());
 
@@ -92,6 +156,7 @@ extern "C"
         std::string filePathUtf8 = ConvertToUTF8(filePath);
 
         std::unique_ptr<SQLiteIndex> result = std::make_unique<SQLiteIndex>(SQLiteIndex::Open(filePathUtf8, SQLiteIndex::OpenDisposition::ReadWrite));
+        result->SetWriteMode(SQLiteIndex::WriteMode::Build);
 
         *index = static_cast<WINGET_SQLITE_INDEX_HANDLE>(result.release());
 
@@ -103,6 +168,16 @@ extern "C"
     {
         std::unique_ptr<SQLiteIndex> toClose(reinterpret_cast<SQLiteIndex*>(index));
 
+        // Leave the file without a write ahead log even if it was not prepared for packaging.
+        if (toClose)
+        {
+            try
+            {
+                toClose->SetWriteMode(SQLiteIndex::WriteMode::Default);
+            }
+            CATCH_LOG();
+        }
+
         return S_OK;
     }
     CATCH_RETURN()
@@ -121,6 +196,95 @@ extern "C"
     }
     CATCH_RETURN()
 
+    WINGET_UTIL_API WinGetSQLiteIndexAddManifests(
+        WINGET_SQLITE_INDEX_HANDLE index,
+        const WINGET_STRING* manifestPaths,
+        const WINGET_STRING* relativePaths,
+        UINT32 count) try
+    {
+        THROW_HR_IF(E_INVALIDARG, !index);
+        THROW_HR_IF(E_INVALIDARG, count && (!manifestPaths || !relativePaths));
+
+        std::vector<std::pair<std::filesystem::path, std::filesystem::path>> paths;
+        paths.reserve(count);
+
+        for (UINT32 i = 0; i < count; ++i)
+        {
+            THROW_HR_IF(E_INVALIDARG, !manifestPaths[i]);
+            THROW_HR_IF(E_INVALIDARG, !relativePaths[i]);
+
+            paths.emplace_back(manifestPaths[i], relativePaths[i]);
+        }
+
+        reinterpret_cast<SQLiteIndex*>(index)->AddManifests(paths);
+
+        return S_OK;
+    }
+    CATCH_RETURN()
+
+    WINGET_UTIL_API WinGetSQLiteIndexAddManifestsFromDirectory(
+        WINGET_SQLITE_INDEX_HANDLE index,
+        WINGET_STRING manifestRoot,
+        WINGET_MANIFEST_RESULT_CALLBACK callback,
+        void* context,
+        UINT32* manifestsAdded) try
+    {
+        THROW_HR_IF(E_INVALIDARG, !index);
+        THROW_HR_IF(E_INVALIDARG, !manifestRoot);
+
+        if (manifestsAdded)
+        {
+            *manifestsAdded = 0;
+        }
+
+        std::filesystem::path root = manifestRoot;
+        std::vector<std::pair<std::filesystem::path, std::filesystem::path>> paths;
+
+        for (const auto& entry : std::filesystem::recursive_directory_iterator{ root })
+        {
+            if (entry.is_regular_file() && CaseInsensitiveEquals(entry.path().extension().u8string(), ".yaml"))
+            {
+                paths.emplace_back(entry.path(), std::filesystem::relative(entry.path(), root));
+            }
+        }
+
+        THROW_HR_IF(E_INVALIDARG, paths.size() > std::numeric_limits<UINT32>::max());
+
+        size_t added = 0;
+        auto onAdded = [&](size_t count)
+        {
+            added = count;
+            if (callback)
+            {
+                callback(context, static_cast<UINT32>(count - 1), S_OK, TRUE, paths[count - 1].second.c_str());
+            }
+        };
+
+        try
+        {
+            reinterpret_cast<SQLiteIndex*>(index)->AddManifests(paths, onAdded);
+        }
+        catch (...)
+        {
+            // The manifests are added in order, so the one that failed is the one after those that were added.
+            HRESULT hr = wil::ResultFromCaughtException();
+            if (callback && added < paths.size())
+            {
+                callback(context, static_cast<UINT32>(added), hr, FALSE, paths[added].second.c_str());
+            }
+
+            return hr;
+        }
+
+        if (manifestsAdded)
+        {
+            *manifestsAdded = static_cast<UINT32>(added);
+        }
+
+        return S_OK;
+    }
+    CATCH_RETURN()
+
     WINGET_UTIL_API WinGetSQLiteIndexUpdateManifest(
         WINGET_SQLITE_INDEX_HANDLE index,
         WINGET_STRING manifestPath,
@@ -166,6 +330,69 @@ extern "C"
     }
     CATCH_RETURN()
 
+    WINGET_UTIL_API WinGetSQLiteIndexPrepareForPackagingWithManifests(
+        WINGET_SQLITE_INDEX_HANDLE index,
+        WINGET_STRING manifestRoot) try
+    {
+        THROW_HR_IF(E_INVALIDARG, !index);
+        THROW_HR_IF(E_INVALIDARG, !manifestRoot);
+
+        reinterpret_cast<SQLiteIndex*>(index)->PrepareForPackaging(manifestRoot);
+
+        return S_OK;
+    }
+    CATCH_RETURN()
+
+    WINGET_UTIL_API WinGetSQLiteIndexDiff(
+        WINGET_STRING oldFilePath,
+        WINGET_STRING newFilePath,
+        WINGET_STRING_OUT* changes) try
+    {
+        THROW_HR_IF(E_INVALIDARG, !oldFilePath);
+        THROW_HR_IF(E_INVALIDARG, !newFilePath);
+        THROW_HR_IF(E_INVALIDARG, !changes);
+
+        SQLiteIndex oldIndex = SQLiteIndex::Open(ConvertToUTF8(oldFilePath), SQLiteIndex::OpenDisposition::Read);
+        SQLiteIndex newIndex = SQLiteIndex::Open(ConvertToUTF8(newFilePath), SQLiteIndex::OpenDisposition::Read);
+
+        std::string result = SerializeIndexChanges(DiffIndexes(oldIndex, newIndex));
+        *changes = ::SysAllocString(ConvertToUTF16(result).c_str());
+        THROW_IF_NULL_ALLOC(*changes);
+
+        return S_OK;
+    }
+    CATCH_RETURN()
+
+    WINGET_UTIL_API WinGetSQLiteIndexApplyChanges(
+        WINGET_SQLITE_INDEX_HANDLE index,
+        WINGET_STRING changes,
+        WINGET_STRING manifestRoot) try
+    {
+        THROW_HR_IF(E_INVALIDARG, !index);
+        THROW_HR_IF(E_INVALIDARG, !changes);
+        THROW_HR_IF(E_INVALIDARG, !manifestRoot);
+
+        ApplyIndexChanges(*reinterpret_cast<SQLiteIndex*>(index), DeserializeIndexChanges(ConvertToUTF8(changes)), manifestRoot);
+
+        return S_OK;
+    }
+    CATCH_RETURN()
+
+    WINGET_UTIL_API WinGetSQLiteIndexGetShardForPackageId(
+        WINGET_STRING packageId,
+        UINT32 shardCount,
+        UINT32* shard) try
+    {
+        THROW_HR_IF(E_INVALIDARG, !packageId);
+        THROW_HR_IF(E_INVALIDARG, !shardCount);
+        THROW_HR_IF(E_INVALIDARG, !shard);
+
+        *shard = GetShardForPackageId(ConvertToUTF8(packageId), shardCount);
+
+        return S_OK;
+    }
+    CATCH_RETURN()
+
     WINGET_UTIL_API WinGetSQLiteIndexCheckConsistency(
         WINGET_SQLITE_INDEX_HANDLE index,
         BOOL* succeeded) try
@@ -224,13 +451,7 @@ extern "C"
 
         try
         {
-            ManifestValidateOption validateOption;
-            validateOption.FullValidation = true;
-            validateOption.ThrowOnWarning = true;
-            validateOption.SchemaValidationOnly = WI_IsFlagSet(option, WinGetValidateManifestOption::SchemaValidationOnly);
-            validateOption.ErrorOnVerifiedPublisherFields = WI_IsFlagSet(option, WinGetValidateManifestOption::ErrorOnVerifiedPublisherFields);
-
-            (void)YamlParser::CreateFromPath(inputPath, validateOption, mergedManifestPath ? mergedManifestPath : L"");
+            (void)YamlParser::CreateFromPath(inputPath, GetManifestValidateOption(option), mergedManifestPath ? mergedManifestPath : L"");
 
             *succeeded = TRUE;
         }
@@ -247,6 +468,55 @@ extern "C"
     }
     CATCH_RETURN()
 
+    WINGET_UTIL_API WinGetValidateManifestsV2(
+        const WINGET_STRING* inputPaths,
+        UINT32 count,
+        WinGetValidateManifestOption option,
+        WINGET_MANIFEST_RESULT_CALLBACK callback,
+        void* context) try
+    {
+        THROW_HR_IF(E_INVALIDARG, count && (!inputPaths || !callback));
+
+        for (UINT32 i = 0; i < count; ++i)
+        {
+            THROW_HR_IF(E_INVALIDARG, !inputPaths[i]);
+        }
+
+        ManifestValidateOption validateOption = GetManifestValidateOption(option);
+        std::mutex callbackLock;
+
+        auto report = [&](UINT32 i, HRESULT hr, bool succeeded, const std::string& message)
+        {
+            std::wstring messageWide = ConvertToUTF16(message);
+            std::lock_guard<std::mutex> lock{ callbackLock };
+            callback(context, i, hr, succeeded ? TRUE : FALSE, messageWide.empty() ? nullptr : messageWide.c_str());
+        };
+
+        RunOnWorkers(count, [&](UINT32 i)
+            {
+                try
+                {
+                    try
+                    {
+                        (void)YamlParser::CreateFromPath(inputPaths[i], validateOption);
+                        report(i, S_OK, true, {});
+                    }
+                    catch (const ManifestException& e)
+                    {
+                        report(i, S_OK, e.IsWarningOnly(), e.GetManifestErrorMessage());
+                    }
+                    catch (...)
+                    {
+                        report(i, wil::ResultFromCaughtException(), false, {});
+                    }
+                }
+                CATCH_LOG();
+            });
+
+        return S_OK;
+    }
+    CATCH_RETURN()
+
     WINGET_UTIL_API WinGetValidateManifestDependencies(
         WINGET_STRING inputPath,
         BOOL* succeeded,
@@ -289,6 +559,66 @@ extern "C"
     }
     CATCH_RETURN()
 
+    WINGET_UTIL_API WinGetValidateManifestDependenciesBatch(
+        const WINGET_STRING* inputPaths,
+        UINT32 count,
+        BOOL* succeeded,
+        WINGET_STRING_OUT* message,
+        WINGET_SQLITE_INDEX_HANDLE index) try
+    {
+        THROW_HR_IF(E_INVALIDARG, count && (!inputPaths || !succeeded));
+        THROW_HR_IF(E_INVALIDARG, !index);
+
+        for (UINT32 i = 0; i < count; ++i)
+        {
+            THROW_HR_IF(E_INVALIDARG, !inputPaths[i]);
+        }
+
+        auto setResult = [&](UINT32 i, bool result, const std::string& errorMessage)
+        {
+            succeeded[i] = (result ? TRUE : FALSE);
+            if (message)
+            {
+                message[i] = (errorMessage.empty() ? nullptr : ::SysAllocString(ConvertToUTF16(errorMessage).c_str()));
+            }
+        };
+
+        // Manifests that fail to load are reported as they are, and the rest have their dependencies validated together.
+        std::vector<Manifest> manifests;
+        std::vector<UINT32> manifestIndices;
+
+        for (UINT32 i = 0; i < count; ++i)
+        {
+            try
+            {
+                manifests.emplace_back(YamlParser::CreateFromPath(inputPaths[i]));
+                manifestIndices.emplace_back(i);
+            }
+            catch (const ManifestException& e)
+            {
+                setResult(i, e.IsWarningOnly(), e.GetManifestErrorMessage());
+            }
+        }
+
+        auto errors = PackageDependenciesValidation::ValidateManifestDependencies(reinterpret_cast<SQLiteIndex*>(index), manifests);
+
+        for (size_t i = 0; i < errors.size(); ++i)
+        {
+            if (errors[i].empty())
+            {
+                setResult(manifestIndices[i], true, {});
+            }
+            else
+            {
+                ManifestException e{ std::move(errors[i]), APPINSTALLER_CLI_ERROR_DEPENDENCIES_VALIDATION_FAILED };
+                setResult(manifestIndices[i], false, e.GetManifestErrorMessage());
+            }
+        }
+
+        return S_OK;
+    }
+    CATCH_RETURN()
+
     WINGET_UTIL_API WinGetDownload(
         WINGET_STRING url,
         WINGET_STRING filePath,
@@ -32,6 +32,16 @@ extern "C"
 
     DEFINE_ENUM_FLAG_OPERATORS(WinGetValidateManifestOption);
 
+    // Called by the batch functions with the result for the item at inputIndex. The calls are made one at a time, but
+    // not necessarily in input order or on the calling thread. The message is null if there is nothing to report,
+    // and is only valid for the duration of the call.
+    typedef void (__stdcall *WINGET_MANIFEST_RESULT_CALLBACK)(
+        void* context,
+        UINT32 inputIndex,
+        HRESULT result,
+        BOOL succeeded,
+        WINGET_STRING message);
+
     // Initializes the logging infrastructure.
     WINGET_UTIL_API WinGetLoggingInit(
         WINGET_STRING logPath);
@@ -64,6 +74,26 @@ extern "C"
         WINGET_STRING manifestPath, 
         WINGET_STRING relativePath);
 
+    // Adds the manifests at the repository relative paths to the index, where manifestPaths[i] is placed at relativePaths[i].
+    // All of the manifests are added as a single change; if the function fails, none of them have been added.
+    // This is much faster than calling WinGetSQLiteIndexAddManifest for each manifest when building an index.
+    WINGET_UTIL_API WinGetSQLiteIndexAddManifests(
+        WINGET_SQLITE_INDEX_HANDLE index,
+        const WINGET_STRING* manifestPaths,
+        const WINGET_STRING* relativePaths,
+        UINT32 count);
+
+    // Adds every *.yaml file under the root to the index, each at its path relative to the root.
+    // All of the manifests are added as a single change, as with WinGetSQLiteIndexAddManifests.
+    // The optional callback is called as each manifest is added, in the order they were found, and then for the
+    // manifest that failed, if any; inputIndex counts the manifests found so far and the message is its relative path.
+    WINGET_UTIL_API WinGetSQLiteIndexAddManifestsFromDirectory(
+        WINGET_SQLITE_INDEX_HANDLE index,
+        WINGET_STRING manifestRoot,
+        WINGET_MANIFEST_RESULT_CALLBACK callback,
+        void* context,
+        UINT32* manifestsAdded);
+
     // Updates the manifest with matching { Id, Version, Channel } in the index.
     // The return value indicates whether the index was modified by the function.
     WINGET_UTIL_API WinGetSQLiteIndexUpdateManifest(
@@ -83,6 +113,34 @@ extern "C"
     WINGET_UTIL_API WinGetSQLiteIndexPrepareForPackaging(
         WINGET_SQLITE_INDEX_HANDLE index);
 
+    // Embeds every manifest in the index, reading each from its relative path under the root, then prepares the index for packaging.
+    // Sources that use the published index then read manifests from it rather than downloading them.
+    WINGET_UTIL_API WinGetSQLiteIndexPrepareForPackagingWithManifests(
+        WINGET_SQLITE_INDEX_HANDLE index,
+        WINGET_STRING manifestRoot);
+
+    // Compares the manifests of two indexes by { Id, Version, Channel } and returns the changes that turn the old index into the new one.
+    // The changes are a JSON array of objects with Type (Added, Updated or Removed), Id, Version, Channel, RelativePath and ManifestSHA256Hash.
+    // The returned string must be freed with SysFreeString.
+    WINGET_UTIL_API WinGetSQLiteIndexDiff(
+        WINGET_STRING oldFilePath,
+        WINGET_STRING newFilePath,
+        WINGET_STRING_OUT* changes);
+
+    // Applies changes in the form returned by WinGetSQLiteIndexDiff to the index, reading added and updated manifests from their relative path under the root.
+    // All of the changes are applied as a single change; if the function fails, none of them have been applied.
+    WINGET_UTIL_API WinGetSQLiteIndexApplyChanges(
+        WINGET_SQLITE_INDEX_HANDLE index,
+        WINGET_STRING changes,
+        WINGET_STRING manifestRoot);
+
+    // Gets the shard of a sharded index that the package with the given id must be added to.
+    // A sharded index is a set of indexes, described by an index.shards file alongside them, that each hold the packages assigned to them.
+    WINGET_UTIL_API WinGetSQLiteIndexGetShardForPackageId(
+        WINGET_STRING packageId,
+        UINT32 shardCount,
+        UINT32* shard);
+
     // Checks the index for consistency, ensuring that at a minimum all referenced rows actually exist.
     WINGET_UTIL_API WinGetSQLiteIndexCheckConsistency(
         WINGET_SQLITE_INDEX_HANDLE index,
@@ -106,6 +164,16 @@ extern "C"
         WINGET_STRING mergedManifestPath,
         WinGetValidateManifestOption option);
 
+    // Validates the manifests at the given paths as WinGetValidateManifestV2 does, spreading them across worker threads.
+    // The callback receives the result for each: succeeded and the message are those of WinGetValidateManifestV2, and
+    // a failure to read a manifest is reported through result rather than failing the whole batch.
+    WINGET_UTIL_API WinGetValidateManifestsV2(
+        const WINGET_STRING* inputPaths,
+        UINT32 count,
+        WinGetValidateManifestOption option,
+        WINGET_MANIFEST_RESULT_CALLBACK callback,
+        void* context);
+
     // Validates a given manifest with dependencies. Returns a bool for validation result and
     // a string representing validation errors if validation failed.
     // If mergedManifestPath is provided, this method will write a merged manifest
@@ -117,6 +185,17 @@ extern "C"
         WINGET_SQLITE_INDEX_HANDLE index,
         WinGetValidateManifestDependenciesOption dependenciesValidationOption);
 
+    // Validates the dependencies of the manifests at the given paths, where succeeded[i] and message[i] are the results for inputPaths[i].
+    // Each package that the manifests depend on is only looked up in the index once for the whole batch,
+    // so this is much faster than calling WinGetValidateManifestDependencies for each manifest.
+    // The message array is optional; each of its strings must be freed with SysFreeString.
+    WINGET_UTIL_API WinGetValidateManifestDependenciesBatch(
+        const WINGET_STRING* inputPaths,
+        UINT32 count,
+        BOOL* succeeded,
+        WINGET_STRING_OUT* message,
+        WINGET_SQLITE_INDEX_HANDLE index);
+
     // Downloads a file to the given path, returning the SHA 256 hash of the file.
     WINGET_UTIL_API WinGetDownload(
         WINGET_STRING url,
@@ -12,7 +12,9 @@
 #pragma warning( pop )
 
 #include <algorithm>
+#include <atomic>
 #include <filesystem>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
@@ -56,6 +56,32 @@ namespace Microsoft.WinGetUtil.Helpers
             return (succeeded, failureOrWarningMessage);
         }
 
+        /// <summary>
+        /// Validates the manifests are compliant, in a single call that spreads them across native worker threads.
+        /// </summary>
+        /// <param name="manifestPaths">Manifest paths.</param>
+        /// <param name="option">Desired validate manifest option.</param>
+        /// <returns>Results from manifest validation, in the same order as the paths.</returns>
+        public static (bool isValid, string message)[] ValidateManifests(
+            string[] manifestPaths,
+            ValidateManifestOption option = ValidateManifestOption.Default)
+        {
+            var results = new (bool isValid, string message)[manifestPaths.Length];
+
+            ManifestResultCallback callback = (IntPtr context, uint inputIndex, int result, bool succeeded, string message) =>
+            {
+                // A manifest that could not be read is reported as failing validation with the reason.
+                results[inputIndex] = result < 0 ?
+                    (false, Marshal.GetExceptionForHR(result).Message) :
+                    (succeeded, message);
+            };
+
+            WinGetValidateManifestsV2(manifestPaths, (uint)manifestPaths.Length, option, callback, IntPtr.Zero);
+            GC.KeepAlive(callback);
+
+            return results;
+        }
+
         /// <summary>
         /// Validates a given manifest. Returns a bool for validation result and
         /// a string representing validation errors if validation failed.
@@ -73,5 +99,38 @@ namespace Microsoft.WinGetUtil.Helpers
             [MarshalAs(UnmanagedType.BStr)] out string failureMessage,
             string mergedManifestPath,
             ValidateManifestOption option);
+
+        /// <summary>
+        /// Validates the given manifests, calling back with the result for each.
+        /// </summary>
+        /// <param name="manifestPaths">Paths to manifest files.</param>
+        /// <param name="count">Number of manifests.</param>
+        /// <param name="option">Validate manifest option.</param>
+        /// <param name="callback">Called with the result for each manifest, one at a time.</param>
+        /// <param name="context">Context passed to the callback.</param>
+        /// <returns>HRESULT.</returns>
+        [DllImport("WinGetUtil.dll", CallingConvention = CallingConvention.StdCall, CharSet = CharSet.Unicode, PreserveSig = false)]
+        private static extern IntPtr WinGetValidateManifestsV2(
+            string[] manifestPaths,
+            uint count,
+            ValidateManifestOption option,
+            ManifestResultCallback callback,
+            IntPtr context);
+
+        /// <summary>
+        /// Receives the result for a manifest from the batch functions.
+        /// </summary>
+        /// <param name="context">Context given to the batch function.</param>
+        /// <param name="inputIndex">Index of the manifest.</param>
+        /// <param name="result">HRESULT for the manifest.</param>
+        /// <param name="succeeded">Whether the manifest succeeded.</param>
+        /// <param name="message">The message for the manifest, if any.</param>
+        [UnmanagedFunctionPointer(CallingConvention.StdCall, CharSet = CharSet.Unicode)]
+        private delegate void ManifestResultCallback(
+            IntPtr context,
+            uint inputIndex,
+            int result,
+            [MarshalAs(UnmanagedType.Bool)] bool succeeded,
+            string message);
     }
 }
@@ -1,19 +1,118 @@
 // Copyright (c) Microsoft Corporation.
 // Licensed under the MIT License.
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
 #include <string>
+#include <string_view>
 #include <winget/ManifestYamlParser.h>
 
+namespace
+{
+    // The budgets for a single test case, set from the command line; zero is unlimited.
+    // libFuzzer ignores flags starting with "--", leaving them for the fuzz target.
+    constexpr std::string_view c_timeBudgetFlag = "--time_budget_ms=";
+    constexpr std::string_view c_allocationBudgetFlag = "--allocation_budget_mb=";
+
+    size_t s_timeBudgetMilliseconds = 0;
+    size_t s_allocationBudgetBytes = 0;
+
+    // The bytes allocated by the running test case.
+    std::atomic<bool> s_trackAllocations = false;
+    std::atomic<size_t> s_allocatedBytes = 0;
+
+    bool TryGetFlagValue(std::string_view arg, std::string_view flag, size_t& value)
+    {
+        if (arg.substr(0, flag.size()) != flag)
+        {
+            return false;
+        }
+
+        value = std::strtoull(std::string{ arg.substr(flag.size()) }.c_str(), nullptr, 10);
+        return true;
+    }
+
+    // Aborts so that the fuzzer reports the input as a failure and keeps it.
+    [[noreturn]] void FailBudget(const char* budget, size_t used, size_t limit)
+    {
+        s_trackAllocations = false;
+        std::fprintf(stderr, "==WinGetYamlFuzzing== test case exceeded the %s budget: %zu > %zu\n", budget, used, limit);
+        std::abort();
+    }
+}
+
+// Replaces the global allocation functions to count the bytes allocated by each test case.
+// libFuzzer's own -malloc_limit_mb relies on sanitizer hooks that are not available on Windows.
+void* operator new(size_t size)
+{
+    if (s_trackAllocations)
+    {
+        size_t allocated = (s_allocatedBytes += size);
+        if (s_allocationBudgetBytes && allocated > s_allocationBudgetBytes)
+        {
+            FailBudget("allocation", allocated, s_allocationBudgetBytes);
+        }
+    }
+
+    void* result = std::malloc(size ? size : 1);
+    if (!result)
+    {
+        throw std::bad_alloc{};
+    }
+
+    return result;
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+extern "C" int LLVMFuzzerInitialize(int* argc, char*** argv)
+{
+    for (int i = 1; i < *argc; ++i)
+    {
+        std::string_view arg = (*argv)[i];
+        size_t value = 0;
+
+        if (TryGetFlagValue(arg, c_timeBudgetFlag, value))
+        {
+            s_timeBudgetMilliseconds = value;
+        }
+        else if (TryGetFlagValue(arg, c_allocationBudgetFlag, value))
+        {
+            s_allocationBudgetBytes = value * 1024 * 1024;
+        }
+    }
+
+    return 0;
+}
+
 extern "C" int LLVMFuzzerTestOneInput(const uint8_t * data, size_t size)
 {
     std::string input{ reinterpret_cast<const char*>(data), size };
 
+    s_allocatedBytes = 0;
+    s_trackAllocations = true;
+    auto start = std::chrono::steady_clock::now();
+
     try
     {
         AppInstaller::Manifest::Manifest manifest = AppInstaller::Manifest::YamlParser::Create(input);
     }
     catch (...) {}
 
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    s_trackAllocations = false;
+
+    if (s_timeBudgetMilliseconds && static_cast<size_t>(elapsed.count()) > s_timeBudgetMilliseconds)
+    {
+        FailBudget("time", static_cast<size_t>(elapsed.count()), s_timeBudgetMilliseconds);
+    }
+
     return 0;
 }
 
@@ -30,6 +129,8 @@ int main(int argc, char** argv)
         return 1;
     }
 
+    LLVMFuzzerInitialize(&argc, &argv);
+
     std::filesystem::path corpus = argv[argc - 1];
 
     if (std::filesystem::is_directory(corpus))
@@ -23,4 +23,7 @@ extern "C"
 
     // Unregisters the server module class factories.
     WINDOWS_PACKAGE_MANAGER_API WindowsPackageManagerServerModuleUnregister();
+
+    // Finishes the work of the server before it exits.
+    WINDOWS_PACKAGE_MANAGER_API WindowsPackageManagerServerShutdown();
 }
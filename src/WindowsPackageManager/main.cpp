@@ -50,4 +50,11 @@ extern "C"
         RETURN_HR(::Microsoft::WRL::Module<::Microsoft::WRL::ModuleType::OutOfProc>::GetModule().UnregisterObjects());
     }
     CATCH_RETURN();
+
+    WINDOWS_PACKAGE_MANAGER_API WindowsPackageManagerServerShutdown() try
+    {
+        AppInstaller::CLI::ServerShutdown();
+        return S_OK;
+    }
+    CATCH_RETURN();
 }
@@ -0,0 +1,112 @@
+<#
+.SYNOPSIS
+    Measures the startup of winget over a number of runs.
+.DESCRIPTION
+    Runs winget with the hidden --startup-trace argument the given number of times, collects the
+    time at which each step of startup completed in every run, and writes the distribution of each
+    step as JSON. When a baseline from a previous run of this script is given, the medians are
+    compared against it.
+.PARAMETER WinGet
+    The winget executable to measure. If not provided, the one on the path is used.
+.PARAMETER Arguments
+    The arguments to run winget with.
+.PARAMETER Runs
+    The number of times to run winget.
+.PARAMETER OutputPath
+    The file path to write the results to.
+.PARAMETER BaselinePath
+    The results of a previous run of this script to compare against.
+#>
+param(
+    [Parameter(Mandatory=$false)]
+    [string]$WinGet = "winget.exe",
+
+    [Parameter(Mandatory=$false)]
+    [string[]]$Arguments = @("--version"),
+
+    [Parameter(Mandatory=$false)]
+    [int]$Runs = 20,
+
+    [Parameter(Mandatory=$true)]
+    [string]$OutputPath,
+
+    [Parameter(Mandatory=$false)]
+    [string]$BaselinePath
+)
+
+function Get-Percentile([double[]]$Sorted, [double]$Percentile)
+{
+    $Local:Index = [Math]::Min($Sorted.Count - 1, [Math]::Floor($Sorted.Count * $Percentile))
+    return $Sorted[$Local:Index]
+}
+
+$Local:TraceFile = Join-Path ([System.IO.Path]::GetTempPath()) "winget-startup-trace.json"
+$Local:Samples = [ordered]@{}
+
+for ($Local:Run = 0; $Local:Run -lt $Runs; ++$Local:Run)
+{
+    Remove-Item $Local:TraceFile -ErrorAction SilentlyContinue
+
+    & $WinGet @Arguments --startup-trace $Local:TraceFile | Out-Null
+
+    if (-not (Test-Path $Local:TraceFile))
+    {
+        Write-Error "Run $Local:Run did not write a startup trace"
+        exit 1
+    }
+
+    $Local:Trace = Get-Content $Local:TraceFile -Raw | ConvertFrom-Json
+    foreach ($Local:Step in $Local:Trace.stepMicroseconds.PSObject.Properties)
+    {
+        if (-not $Local:Samples.Contains($Local:Step.Name))
+        {
+            $Local:Samples[$Local:Step.Name] = [System.Collections.Generic.List[double]]::new()
+        }
+
+        $Local:Samples[$Local:Step.Name].Add($Local:Step.Value)
+    }
+}
+
+Remove-Item $Local:TraceFile -ErrorAction SilentlyContinue
+
+$Local:Steps = [ordered]@{}
+foreach ($Local:Name in $Local:Samples.Keys)
+{
+    [double[]]$Local:Sorted = $Local:Samples[$Local:Name] | Sort-Object
+    $Local:Steps[$Local:Name] = [ordered]@{
+        runs = $Local:Sorted.Count
+        minimumMicroseconds = $Local:Sorted[0]
+        medianMicroseconds = Get-Percentile $Local:Sorted 0.5
+        p90Microseconds = Get-Percentile $Local:Sorted 0.9
+        maximumMicroseconds = $Local:Sorted[-1]
+    }
+}
+
+$Local:Results = [ordered]@{
+    formatVersion = 1
+    arguments = $Arguments -join " "
+    steps = $Local:Steps
+}
+
+$Local:Results | ConvertTo-Json -Depth 4 | Set-Content $OutputPath
+
+if ($BaselinePath)
+{
+    $Local:Baseline = Get-Content $BaselinePath -Raw | ConvertFrom-Json
+
+    foreach ($Local:Name in $Local:Steps.Keys)
+    {
+        $Local:Current = $Local:Steps[$Local:Name].medianMicroseconds
+        $Local:Previous = $Local:Baseline.steps.$Local:Name.medianMicroseconds
+
+        if ($null -eq $Local:Previous)
+        {
+            Write-Host ("{0,-24} {1,10:N0} us (not in baseline)" -f $Local:Name, $Local:Current)
+        }
+        else
+        {
+            $Local:Change = if ($Local:Previous -gt 0) { ($Local:Current - $Local:Previous) * 100 / $Local:Previous } else { 0 }
+            Write-Host ("{0,-24} {1,10:N0} us {2,10:N0} us {3,7:+0.0;-0.0}%" -f $Local:Name, $Local:Previous, $Local:Current, $Local:Change)
+        }
+    }
+}